@@ -0,0 +1,252 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include <windows.h>
+#include <tchar.h>
+
+#include <condition_variable>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Poco/Process.h>
+
+#include "BenchmarkWorkloadSharedLib/BenchmarkWorkloadSharedLib.hpp"
+
+namespace wl = BenchmarkWorkloadSharedLib;
+
+namespace
+{
+	const std::wstring HugeDll = L"huge_dll";
+	const std::wstring Loop = L"loop";
+	const std::wstring Children = L"children";
+	const std::wstring Child = L"child";
+	const std::wstring Reload = L"reload";
+	const std::wstring Threads = L"threads";
+	// Exit at once: the run measures the startup of OpenCppCoverage.
+	const std::wstring Startup = L"startup";
+
+	const size_t DefaultLoopIterationCount = 100;
+	const size_t DefaultChildCount = 500;
+	const size_t DefaultReloadCount = 100;
+	const size_t DefaultThreadCount = 64;
+
+	// 100k distinct lines.
+	const size_t LoopFunctionCount = 100000 / wl::LinesByFunction;
+	const size_t ReloadFunctionCount = 100;
+	const size_t ConcurrentChildCount = 50;
+
+	//-------------------------------------------------------------------------
+	class SharedLib
+	{
+	public:
+		//---------------------------------------------------------------------
+		SharedLib() : module_{LoadLibraryW(L"BenchmarkWorkloadSharedLib.dll")}
+		{
+			if (!module_)
+				throw std::runtime_error("Cannot load BenchmarkWorkloadSharedLib.dll.");
+			getFunctionCount_ = reinterpret_cast<wl::GetFunctionCountFct>(
+			    GetProcAddress(module_, wl::GetFunctionCountName));
+			runFunctions_ = reinterpret_cast<wl::RunFunctionsFct>(GetProcAddress(module_, wl::RunFunctionsName));
+			if (!getFunctionCount_ || !runFunctions_)
+			{
+				FreeLibrary(module_);
+				throw std::runtime_error("Invalid BenchmarkWorkloadSharedLib.dll.");
+			}
+		}
+
+		//---------------------------------------------------------------------
+		~SharedLib()
+		{
+			FreeLibrary(module_);
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetFunctionCount() const
+		{
+			return getFunctionCount_();
+		}
+
+		//---------------------------------------------------------------------
+		unsigned int RunFunctions(size_t first, size_t count, unsigned int value) const
+		{
+			return runFunctions_(first, count, value);
+		}
+
+	private:
+		SharedLib(const SharedLib&) = delete;
+		SharedLib& operator=(const SharedLib&) = delete;
+
+		HMODULE module_;
+		wl::GetFunctionCountFct getFunctionCount_;
+		wl::RunFunctionsFct runFunctions_;
+	};
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path GetExecutablePath()
+	{
+		std::vector<wchar_t> path(MAX_PATH);
+
+		while (GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size())) == path.size())
+			path.resize(path.size() * 2);
+		return path.data();
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunHugeDll()
+	{
+		SharedLib sharedLib;
+
+		return sharedLib.RunFunctions(0, sharedLib.GetFunctionCount(), 0);
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunLoop(size_t iterationCount)
+	{
+		SharedLib sharedLib;
+		unsigned int value = 0;
+
+		for (size_t i = 0; i < iterationCount; ++i)
+			value = sharedLib.RunFunctions(0, LoopFunctionCount, value);
+		return value;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunChildren(size_t childCount)
+	{
+		auto executablePath = GetExecutablePath().string();
+		const std::vector<std::string> arguments{"child"};
+
+		for (size_t i = 0; i < childCount; i += ConcurrentChildCount)
+		{
+			std::vector<Poco::ProcessHandle> handles;
+
+			for (size_t j = i; j < childCount && j < i + ConcurrentChildCount; ++j)
+				handles.push_back(Poco::Process::launch(executablePath, arguments));
+			for (const auto& handle : handles)
+				handle.wait();
+		}
+		return static_cast<unsigned int>(childCount);
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunChild()
+	{
+		unsigned int value = GetCurrentProcessId();
+
+		for (int i = 0; i < 10; ++i)
+			value = value * 31 + i;
+		return value;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunReload(size_t reloadCount)
+	{
+		unsigned int value = 0;
+
+		for (size_t i = 0; i < reloadCount; ++i)
+		{
+			SharedLib sharedLib;
+			value = sharedLib.RunFunctions(0, ReloadFunctionCount, value);
+		}
+		return value;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunThreads(size_t threadCount)
+	{
+		SharedLib sharedLib;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool isStarted = false;
+		std::vector<std::thread> threads;
+
+		// All the threads hit the same lines for the first time together.
+		for (size_t i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([&, i]() {
+				{
+					std::unique_lock<std::mutex> lock{mutex};
+					condition.wait(lock, [&]() { return isStarted; });
+				}
+				sharedLib.RunFunctions(0, LoopFunctionCount, static_cast<unsigned int>(i));
+			});
+		}
+		{
+			std::lock_guard<std::mutex> lock{mutex};
+			isStarted = true;
+		}
+		condition.notify_all();
+		for (auto& thread : threads)
+			thread.join();
+		return static_cast<unsigned int>(threadCount);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t GetCount(int argc, _TCHAR* argv[], size_t defaultCount)
+	{
+		return (argc > 2) ? std::stoul(argv[2]) : defaultCount;
+	}
+}
+
+//-----------------------------------------------------------------------------
+int _tmain(int argc, _TCHAR* argv[])
+{
+	if (argc < 2)
+	{
+		std::wcerr << L"Usage: BenchmarkWorkload huge_dll|loop|children|reload|threads|startup [count]" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		std::wstring type = argv[1];
+		unsigned int result = 0;
+
+		if (type == HugeDll)
+			result = RunHugeDll();
+		else if (type == Loop)
+			result = RunLoop(GetCount(argc, argv, DefaultLoopIterationCount));
+		else if (type == Children)
+			result = RunChildren(GetCount(argc, argv, DefaultChildCount));
+		else if (type == Child)
+			result = RunChild();
+		else if (type == Reload)
+			result = RunReload(GetCount(argc, argv, DefaultReloadCount));
+		else if (type == Threads)
+			result = RunThreads(GetCount(argc, argv, DefaultThreadCount));
+		else if (type == Startup)
+			result = 0;
+		else
+		{
+			std::wcerr << L"Unsupported type:" << type << std::endl;
+			return 1;
+		}
+		if (type != Child)
+			std::wcout << type << L": " << result << std::endl;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,106 @@
+# OpenCppCoverage is an open source code coverage for C++.
+# Copyright (C) 2017 OpenCppCoverage
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Run the scenarios of BenchmarkWorkload under OpenCppCoverage and write the
+# wall time, the debug events, the breakpoints and the memory of each run to
+# a JSON file. AdditionalArguments are passed to OpenCppCoverage, for example
+# to compare the breakpoint engines on the same load. The startup scenario
+# exits at once and is run StartupRunCount times: its wall time is the mean
+# startup and shutdown time of OpenCppCoverage.
+#
+# .\RunBenchmarks.ps1 -OpenCppCoverage x64\Release\OpenCppCoverage.exe `
+#                     -Workload x64\Release\BenchmarkWorkload.exe
+param(
+	[Parameter(Mandatory = $true)][string]$OpenCppCoverage,
+	[Parameter(Mandatory = $true)][string]$Workload,
+	[string]$Output = "BenchmarkResults.json",
+	[string[]]$Scenarios = @("huge_dll", "loop", "children", "reload", "threads", "startup"),
+	[int]$StartupRunCount = 20,
+	[string[]]$AdditionalArguments = @()
+)
+
+$ErrorActionPreference = "Stop"
+
+$Workload = (Resolve-Path $Workload).Path
+$workloadFolder = Split-Path $Workload
+$temporaryFolder = Join-Path ([System.IO.Path]::GetTempPath()) ("BenchmarkWorkload-" + [guid]::NewGuid())
+New-Item -ItemType Directory -Path $temporaryFolder | Out-Null
+
+$results = @()
+try
+{
+	foreach ($scenario in $Scenarios)
+	{
+		$perfStatsPath = Join-Path $temporaryFolder "$scenario.json"
+		$coveragePath = Join-Path $temporaryFolder "$scenario.cov"
+		$arguments = @("--quiet", "--modules", $workloadFolder,
+		               "--export_type", "binary:$coveragePath",
+		               "--perf_stats", $perfStatsPath) + $AdditionalArguments
+		if ($scenario -eq "children")
+		{
+			$arguments += "--cover_children"
+		}
+		$arguments += @("--", $Workload, $scenario)
+
+		$runCount = 1
+		if ($scenario -eq "startup")
+		{
+			$runCount = $StartupRunCount
+		}
+
+		$stopwatch = [System.Diagnostics.Stopwatch]::StartNew()
+		for ($i = 0; $i -lt $runCount; ++$i)
+		{
+			& $OpenCppCoverage @arguments | Out-Null
+		}
+		$exitCode = $LASTEXITCODE
+		$stopwatch.Stop()
+		$wallSeconds = $stopwatch.Elapsed.TotalSeconds / $runCount
+
+		$perfStats = Get-Content $perfStatsPath -Raw | ConvertFrom-Json
+		$counters = $perfStats.counters
+		$debugEventCount = 0
+		foreach ($counter in $counters.PSObject.Properties)
+		{
+			if ($counter.Name.StartsWith("Debug events: "))
+			{
+				$debugEventCount += $counter.Value
+			}
+		}
+
+		$results += [ordered]@{
+			scenario = $scenario
+			exitCode = $exitCode
+			runCount = $runCount
+			wallSeconds = $wallSeconds
+			debugEvents = $debugEventCount
+			breakpointsArmed = $counters."Breakpoints armed"
+			breakpointsHit = $counters."Breakpoints hit"
+			peakWorkingSetBytes = $counters."Peak working set bytes"
+			peakCommitBytes = $counters."Peak commit bytes"
+			perfStats = $perfStats
+		}
+		Write-Host ("{0}: {1:N2} s, {2} debug events, exit code {3}" -f
+		            $scenario, $wallSeconds, $debugEventCount, $exitCode)
+	}
+}
+finally
+{
+	Remove-Item -Recurse -Force $temporaryFolder
+}
+
+ConvertTo-Json -Depth 8 @{ benchmarks = $results } | Set-Content $Output
+Write-Host "Results written to $Output"
@@ -0,0 +1,36 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstddef>
+
+// The library is loaded with LoadLibrary to be reloaded: the functions are
+// exported without decoration and found with GetProcAddress.
+namespace BenchmarkWorkloadSharedLib
+{
+	// Number of source lines of each generated function.
+	const size_t LinesByFunction = 10;
+
+	using GetFunctionCountFct = size_t (*)();
+	const char GetFunctionCountName[] = "GetFunctionCount";
+
+	// Call the generated functions [first, first + count) and return a value
+	// depending on all of them.
+	using RunFunctionsFct = unsigned int (*)(size_t first, size_t count, unsigned int value);
+	const char RunFunctionsName[] = "RunFunctions";
+}
@@ -0,0 +1,66 @@
+# OpenCppCoverage is an open source code coverage for C++.
+# Copyright (C) 2017 OpenCppCoverage
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generate the functions of BenchmarkWorkloadSharedLib: FunctionCount
+# functions of 10 lines each, which gives a module with a huge PDB.
+# The file is written only when FunctionCount changes to keep incremental
+# builds fast.
+param(
+	[Parameter(Mandatory = $true)][string]$Output,
+	[int]$FunctionCount = 50000
+)
+
+$Output = $ExecutionContext.SessionState.Path.GetUnresolvedProviderPathFromPSPath($Output)
+$header = "// Generated by GenerateFunctions.ps1 with $FunctionCount functions."
+if ((Test-Path $Output) -and ((Get-Content $Output -TotalCount 1) -eq $header))
+{
+	exit 0
+}
+
+$builder = New-Object System.Text.StringBuilder
+[void]$builder.AppendLine($header)
+[void]$builder.AppendLine('#include "GeneratedFunctions.hpp"')
+[void]$builder.AppendLine('')
+[void]$builder.AppendLine('namespace BenchmarkWorkloadSharedLib')
+[void]$builder.AppendLine('{')
+[void]$builder.AppendLine("`tnamespace")
+[void]$builder.AppendLine("`t{")
+for ($i = 0; $i -lt $FunctionCount; ++$i)
+{
+	[void]$builder.AppendLine("`t`tunsigned int Function$i(unsigned int value)")
+	[void]$builder.AppendLine("`t`t{")
+	[void]$builder.AppendLine("`t`t`tvalue += $i;")
+	[void]$builder.AppendLine("`t`t`tif (value % 3 == 0)")
+	[void]$builder.AppendLine("`t`t`t`tvalue /= 3;")
+	[void]$builder.AppendLine("`t`t`telse")
+	[void]$builder.AppendLine("`t`t`t`tvalue *= 7;")
+	[void]$builder.AppendLine("`t`t`tvalue ^= $($i % 251);")
+	[void]$builder.AppendLine("`t`t`treturn value;")
+	[void]$builder.AppendLine("`t`t}")
+}
+[void]$builder.AppendLine("`t}")
+[void]$builder.AppendLine('')
+[void]$builder.AppendLine("`textern const GeneratedFunction GeneratedFunctions[] = {")
+for ($i = 0; $i -lt $FunctionCount; ++$i)
+{
+	[void]$builder.AppendLine("`t`tFunction$i,")
+}
+[void]$builder.AppendLine("`t};")
+[void]$builder.AppendLine("`textern const size_t GeneratedFunctionCount = $FunctionCount;")
+[void]$builder.AppendLine('}')
+
+New-Item -ItemType Directory -Force -Path (Split-Path $Output) | Out-Null
+[System.IO.File]::WriteAllText($Output, $builder.ToString())
@@ -0,0 +1,245 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Agent.hpp"
+
+#include <winternl.h>
+#include <intrin.h>
+#include <algorithm>
+#include <cstring>
+
+#include "AgentSharedData.hpp"
+
+namespace CoverageAgent
+{
+	namespace
+	{
+		// See LdrRegisterDllNotification documentation.
+		const ULONG LdrDllNotificationReasonLoaded = 1;
+		const ULONG LdrDllNotificationReasonUnloaded = 2;
+
+		struct LdrDllNotificationData
+		{
+			ULONG Flags;
+			PCUNICODE_STRING FullDllName;
+			PCUNICODE_STRING BaseDllName;
+			PVOID DllBase;
+			ULONG SizeOfImage;
+		};
+
+		using LdrDllNotificationFunction =
+		    VOID(CALLBACK*)(ULONG, const LdrDllNotificationData*, PVOID);
+		using LdrRegisterDllNotificationFunction =
+		    LONG(NTAPI*)(ULONG, LdrDllNotificationFunction, PVOID, PVOID*);
+		using LdrUnregisterDllNotificationFunction = LONG(NTAPI*)(PVOID);
+
+		//---------------------------------------------------------------------
+		struct AgentState
+		{
+			HANDLE hFileMapping = nullptr;
+			SharedHeader* header = nullptr;
+			HANDLE hModuleEvent = nullptr;
+			HANDLE hModuleHandledEvent = nullptr;
+			HANDLE hHostProcess = nullptr;
+			PVOID exceptionHandler = nullptr;
+			PVOID dllNotificationCookie = nullptr;
+		};
+
+		AgentState state;
+
+		//---------------------------------------------------------------------
+		FARPROC GetNtDllFunction(const char* name)
+		{
+			auto hNtDll = GetModuleHandleW(L"ntdll.dll");
+			return hNtDll ? GetProcAddress(hNtDll, name) : nullptr;
+		}
+
+		//---------------------------------------------------------------------
+		LONG CALLBACK OnException(EXCEPTION_POINTERS* exceptionPointers)
+		{
+			const auto* exceptionRecord = exceptionPointers->ExceptionRecord;
+
+			if (exceptionRecord->ExceptionCode != EXCEPTION_BREAKPOINT)
+				return EXCEPTION_CONTINUE_SEARCH;
+
+			auto& header = *state.header;
+			auto* entries = GetPatchEntries(header);
+			auto address =
+			    reinterpret_cast<uint64_t>(exceptionRecord->ExceptionAddress);
+			auto slot = FindSlot(entries, header.patchCapacity_, address);
+
+			// Not one of our breakpoints (DebugBreak, assert...).
+			if (slot < 0)
+				return EXCEPTION_CONTINUE_SEARCH;
+
+			// Several threads can reach the same breakpoint before it is
+			// removed: restoring the instruction twice is harmless.
+			auto hProcess = GetCurrentProcess();
+			auto instruction = entries[slot].originalInstruction_;
+			if (!WriteProcessMemory(hProcess,
+			                        exceptionRecord->ExceptionAddress,
+			                        &instruction,
+			                        sizeof(instruction),
+			                        nullptr))
+			{
+				return EXCEPTION_CONTINUE_SEARCH;
+			}
+			FlushInstructionCache(
+			    hProcess, exceptionRecord->ExceptionAddress, sizeof(instruction));
+
+			auto* hitBitmap = GetHitBitmap(header);
+			if (!_interlockedbittestandset(&hitBitmap[slot / 32],
+			                               static_cast<LONG>(slot % 32)))
+			{
+				InterlockedIncrement(&header.hitCount_);
+			}
+
+#ifdef _WIN64
+			exceptionPointers->ContextRecord->Rip = address;
+#else
+			exceptionPointers->ContextRecord->Eip = static_cast<DWORD>(address);
+#endif
+			return EXCEPTION_CONTINUE_EXECUTION;
+		}
+
+		//---------------------------------------------------------------------
+		VOID CALLBACK OnDllNotification(ULONG reason,
+		                                const LdrDllNotificationData* data,
+		                                PVOID)
+		{
+			auto& header = *state.header;
+
+			if (reason == LdrDllNotificationReasonLoaded)
+				header.notification_ = ModuleNotification::Loaded;
+			else if (reason == LdrDllNotificationReasonUnloaded)
+				header.notification_ = ModuleNotification::Unloaded;
+			else
+				return;
+
+			header.moduleBase_ = reinterpret_cast<uint64_t>(data->DllBase);
+			header.moduleSize_ = data->SizeOfImage;
+
+			const auto* fullDllName = data->FullDllName;
+			auto length = std::min<size_t>(
+			    fullDllName->Length / sizeof(wchar_t), ModulePathSize - 1);
+			std::memcpy(header.modulePath_,
+			            fullDllName->Buffer,
+			            length * sizeof(wchar_t));
+			header.modulePath_[length] = L'\0';
+
+			// The loader lock is held so the module cannot run before
+			// OpenCppCoverage has set its breakpoints.
+			HANDLE handles[] = {state.hModuleHandledEvent, state.hHostProcess};
+			SetEvent(state.hModuleEvent);
+			WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+			header.notification_ = ModuleNotification::None;
+		}
+
+		//---------------------------------------------------------------------
+		bool Initialize()
+		{
+			auto processId = GetCurrentProcessId();
+
+			state.hFileMapping = OpenFileMappingW(
+			    FILE_MAP_ALL_ACCESS,
+			    FALSE,
+			    GetObjectName(SharedMemoryPrefix, processId).c_str());
+			if (!state.hFileMapping)
+				return false;
+
+			state.header = static_cast<SharedHeader*>(
+			    MapViewOfFile(state.hFileMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+			if (!state.header || state.header->version_ != SharedDataVersion)
+				return false;
+
+			state.hModuleEvent = OpenEventW(
+			    EVENT_MODIFY_STATE,
+			    FALSE,
+			    GetObjectName(ModuleEventPrefix, processId).c_str());
+			state.hModuleHandledEvent = OpenEventW(
+			    SYNCHRONIZE,
+			    FALSE,
+			    GetObjectName(ModuleHandledEventPrefix, processId).c_str());
+			state.hHostProcess =
+			    OpenProcess(SYNCHRONIZE, FALSE, state.header->hostProcessId_);
+			if (!state.hModuleEvent || !state.hModuleHandledEvent ||
+			    !state.hHostProcess)
+			{
+				return false;
+			}
+
+			state.exceptionHandler =
+			    AddVectoredExceptionHandler(1, OnException);
+			if (!state.exceptionHandler)
+				return false;
+
+			auto registerDllNotification =
+			    reinterpret_cast<LdrRegisterDllNotificationFunction>(
+			        GetNtDllFunction("LdrRegisterDllNotification"));
+			return registerDllNotification &&
+			       registerDllNotification(0,
+			                               OnDllNotification,
+			                               nullptr,
+			                               &state.dllNotificationCookie) == 0;
+		}
+
+		//---------------------------------------------------------------------
+		void CloseHandleIfNeeded(HANDLE& handle)
+		{
+			if (handle)
+				CloseHandle(handle);
+			handle = nullptr;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool Start()
+	{
+		if (Initialize())
+			return true;
+		Stop();
+		return false;
+	}
+
+	//-------------------------------------------------------------------------
+	void Stop()
+	{
+		if (state.dllNotificationCookie)
+		{
+			auto unregisterDllNotification =
+			    reinterpret_cast<LdrUnregisterDllNotificationFunction>(
+			        GetNtDllFunction("LdrUnregisterDllNotification"));
+			if (unregisterDllNotification)
+				unregisterDllNotification(state.dllNotificationCookie);
+			state.dllNotificationCookie = nullptr;
+		}
+		if (state.exceptionHandler)
+		{
+			RemoveVectoredExceptionHandler(state.exceptionHandler);
+			state.exceptionHandler = nullptr;
+		}
+		CloseHandleIfNeeded(state.hHostProcess);
+		CloseHandleIfNeeded(state.hModuleHandledEvent);
+		CloseHandleIfNeeded(state.hModuleEvent);
+		if (state.header)
+		{
+			UnmapViewOfFile(state.header);
+			state.header = nullptr;
+		}
+		CloseHandleIfNeeded(state.hFileMapping);
+	}
+}
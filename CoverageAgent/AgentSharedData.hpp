@@ -0,0 +1,129 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Windows.h>
+#include <cstdint>
+#include <string>
+
+// Layout of the memory shared between OpenCppCoverage and CoverageAgent.dll.
+// This header is included by both sides and must not depend on anything else.
+namespace CoverageAgent
+{
+	const wchar_t SharedMemoryPrefix[] = L"Local\\OpenCppCoverageAgent_";
+	const wchar_t ModuleEventPrefix[] = L"Local\\OpenCppCoverageAgentModule_";
+	const wchar_t ModuleHandledEventPrefix[] =
+	    L"Local\\OpenCppCoverageAgentModuleHandled_";
+
+	const uint32_t SharedDataVersion = 1;
+	const size_t ModulePathSize = 4096;
+
+	const uint64_t EmptyPatchAddress = 0;
+	const uint64_t RemovedPatchAddress = 1;
+
+	enum class ModuleNotification : uint32_t
+	{
+		None,
+		Loaded,
+		Unloaded
+	};
+
+	//-------------------------------------------------------------------------
+	struct PatchEntry
+	{
+		// Written last by the host, read by the exception handler.
+		volatile uint64_t address_;
+		uint8_t originalInstruction_;
+	};
+
+	//-------------------------------------------------------------------------
+	struct SharedHeader
+	{
+		uint32_t version_;
+		uint32_t hostProcessId_;
+		uint32_t patchCapacity_; // Power of 2
+		volatile LONG hitCount_;
+
+		// Module notification filled by the agent while the loader waits for
+		// the host to set (or forget) the breakpoints of this module.
+		ModuleNotification notification_;
+		uint64_t moduleBase_;
+		uint64_t moduleSize_;
+		wchar_t modulePath_[ModulePathSize];
+	};
+
+	// Shared memory is: SharedHeader | PatchEntry[patchCapacity_] | hit bitmap
+	// The hit bitmap has one bit per patch entry slot.
+
+	//-------------------------------------------------------------------------
+	inline std::wstring GetObjectName(const wchar_t* prefix, DWORD processId)
+	{
+		return prefix + std::to_wstring(processId);
+	}
+
+	//-------------------------------------------------------------------------
+	inline size_t GetHitBitmapSize(uint32_t patchCapacity)
+	{
+		return (patchCapacity + 31) / 32 * sizeof(LONG);
+	}
+
+	//-------------------------------------------------------------------------
+	inline size_t GetSharedMemorySize(uint32_t patchCapacity)
+	{
+		return sizeof(SharedHeader) + patchCapacity * sizeof(PatchEntry) +
+		       GetHitBitmapSize(patchCapacity);
+	}
+
+	//-------------------------------------------------------------------------
+	inline PatchEntry* GetPatchEntries(SharedHeader& header)
+	{
+		return reinterpret_cast<PatchEntry*>(&header + 1);
+	}
+
+	//-------------------------------------------------------------------------
+	inline volatile LONG* GetHitBitmap(SharedHeader& header)
+	{
+		return reinterpret_cast<volatile LONG*>(GetPatchEntries(header) +
+		                                        header.patchCapacity_);
+	}
+
+	//-------------------------------------------------------------------------
+	inline uint32_t GetFirstSlot(uint64_t address, uint32_t patchCapacity)
+	{
+		// Fibonacci hashing: instructions are not aligned so low bits matter.
+		auto hash = address * 0x9E3779B97F4A7C15ull;
+		return static_cast<uint32_t>(hash >> 32) & (patchCapacity - 1);
+	}
+
+	//-------------------------------------------------------------------------
+	template <typename T_Entries>
+	int64_t FindSlot(T_Entries* entries, uint32_t patchCapacity, uint64_t address)
+	{
+		auto slot = GetFirstSlot(address, patchCapacity);
+
+		for (uint32_t i = 0; i < patchCapacity; ++i)
+		{
+			auto value = entries[slot].address_;
+			if (value == address)
+				return slot;
+			if (value == EmptyPatchAddress)
+				return -1;
+			slot = (slot + 1) & (patchCapacity - 1);
+		}
+		return -1;
+	}
+}
@@ -0,0 +1,130 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <ostream>
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		//---------------------------------------------------------------------
+		void WriteJsonString(std::ostream& ostr, const std::string& value)
+		{
+			ostr << '"';
+			for (auto c : value)
+			{
+				if (c == '"' || c == '\\')
+					ostr << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					ostr << ' ';
+				else
+					ostr << c;
+			}
+			ostr << '"';
+		}
+
+		//---------------------------------------------------------------------
+		double GetItemsPerSecond(const Benchmark::Result& result)
+		{
+			std::chrono::duration<double> seconds = result.medianTime_;
+
+			return (seconds.count() > 0) ? result.itemCount_ / seconds.count() : 0;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void Benchmark::Add(const std::string& name, Factory factory)
+	{
+		factories_.emplace_back(name, std::move(factory));
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Benchmark::Result> Benchmark::Run(
+	    const std::string& filter,
+	    size_t iterationCount,
+	    std::ostream* progress) const
+	{
+		std::vector<Result> results;
+
+		for (const auto& [name, factory] : factories_)
+		{
+			if (name.find(filter) == std::string::npos)
+				continue;
+			if (progress)
+				*progress << name << "..." << std::flush;
+
+			auto iteration = factory();
+			std::vector<Clock::duration> times;
+			uint64_t itemCount = 0;
+
+			// The first iteration warms up the caches and is not timed.
+			iteration();
+			for (size_t i = 0; i < iterationCount; ++i)
+			{
+				auto start = Clock::now();
+				itemCount = iteration();
+				times.push_back(Clock::now() - start);
+			}
+
+			Result result{name, iterationCount, itemCount, {}, {}, {}};
+			if (!times.empty())
+			{
+				result.meanTime_ = std::accumulate(times.begin(), times.end(), Clock::duration::zero()) /
+				                   static_cast<Clock::rep>(times.size());
+				auto middle = times.begin() + times.size() / 2;
+				std::nth_element(times.begin(), middle, times.end());
+				result.medianTime_ = *middle;
+				result.minTime_ = *std::min_element(times.begin(), times.end());
+			}
+			if (progress)
+			{
+				*progress << " " << std::fixed << std::setprecision(2)
+				          << Milliseconds{result.medianTime_}.count() << " ms" << std::endl;
+			}
+			results.push_back(std::move(result));
+		}
+		return results;
+	}
+
+	//-------------------------------------------------------------------------
+	void Benchmark::WriteJson(const std::vector<Result>& results, std::ostream& ostr)
+	{
+		ostr << "{\n  \"benchmarks\": [";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+
+			ostr << (i ? ",\n" : "\n") << "    {\"name\": ";
+			WriteJsonString(ostr, result.name_);
+			ostr << ", \"iterations\": " << result.iterationCount_
+			     << ", \"items\": " << result.itemCount_
+			     << ", \"minMs\": " << Milliseconds{result.minTime_}.count()
+			     << ", \"medianMs\": " << Milliseconds{result.medianTime_}.count()
+			     << ", \"meanMs\": " << Milliseconds{result.meanTime_}.count()
+			     << ", \"itemsPerSecond\": " << static_cast<uint64_t>(GetItemsPerSecond(result)) << "}";
+		}
+		ostr << "\n  ]\n}\n";
+	}
+}
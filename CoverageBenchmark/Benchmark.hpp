@@ -0,0 +1,66 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace CoverageBenchmark
+{
+	// Run the registered benchmarks and write their timings as JSON, to
+	// compare the results before and after a change.
+	class Benchmark
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		// Run one iteration and return the number of items processed.
+		using Iteration = std::function<uint64_t()>;
+		// Build the data of the benchmark, which is not timed, and return the
+		// iteration to time.
+		using Factory = std::function<Iteration()>;
+
+		struct Result
+		{
+			std::string name_;
+			size_t iterationCount_;
+			uint64_t itemCount_; // By iteration.
+			Clock::duration minTime_;
+			Clock::duration medianTime_;
+			Clock::duration meanTime_;
+		};
+
+		Benchmark() = default;
+
+		void Add(const std::string& name, Factory);
+
+		// Run the benchmarks whose name contains filter.
+		std::vector<Result> Run(const std::string& filter, size_t iterationCount, std::ostream* progress) const;
+
+		static void WriteJson(const std::vector<Result>&, std::ostream&);
+
+	private:
+		Benchmark(const Benchmark&) = delete;
+		Benchmark& operator=(const Benchmark&) = delete;
+
+		std::vector<std::pair<std::string, Factory>> factories_;
+	};
+}
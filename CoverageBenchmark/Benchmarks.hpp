@@ -0,0 +1,38 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+namespace CoverageBenchmark
+{
+	class Benchmark;
+	class Scalability;
+	struct Scale;
+
+	void AddCppCoverageBenchmarks(Benchmark&, const Scale&);
+	void AddFileFilterBenchmarks(Benchmark&, const Scale&);
+	void AddExporterBenchmarks(Benchmark&, const Scale&);
+
+	// Read the debug information of these modules, see GeneratePdbWorkload.ps1.
+	void AddPdbBenchmarks(Benchmark&, const std::vector<std::filesystem::path>& modulePaths);
+
+	// Lines from 10k to maxLineCount, processes and modules from 10 to 10k.
+	void AddScalabilityChecks(Scalability&, size_t maxLineCount);
+}
@@ -0,0 +1,143 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <boost/program_options.hpp>
+
+#include "Benchmark.hpp"
+#include "Benchmarks.hpp"
+#include "DataGenerator.hpp"
+#include "Scalability.hpp"
+
+namespace po = boost::program_options;
+namespace cb = CoverageBenchmark;
+
+namespace
+{
+	const char* HelpOption = "help";
+	const char* OutputOption = "output";
+	const char* FilterOption = "filter";
+	const char* IterationsOption = "iterations";
+	const char* SmallOption = "small";
+	const char* PdbModuleOption = "pdb_module";
+	const char* ScalabilityOption = "scalability";
+
+	// 1M lines in 100k files of 100 modules.
+	const cb::Scale DefaultScale{100, 100000, 1000000};
+	const cb::Scale SmallScale{10, 10000, 100000};
+	const size_t MaxScalabilityLineCount = 10000000;
+	const size_t SmallMaxScalabilityLineCount = 1000000;
+
+	//---------------------------------------------------------------------
+	// Return false when an operation does not scale.
+	bool RunScalabilityChecks(const po::variables_map& variablesMap)
+	{
+		cb::Scalability scalability;
+		auto maxLineCount = variablesMap.count(SmallOption) ? SmallMaxScalabilityLineCount : MaxScalabilityLineCount;
+
+		cb::AddScalabilityChecks(scalability, maxLineCount);
+
+		auto results = scalability.Run(
+		    variablesMap[FilterOption].as<std::string>(),
+		    variablesMap[IterationsOption].as<size_t>(),
+		    &std::cerr);
+
+		if (variablesMap.count(OutputOption))
+		{
+			std::ofstream ofs{variablesMap[OutputOption].as<std::string>()};
+
+			cb::Scalability::WriteJson(results, ofs);
+		}
+		else
+			cb::Scalability::WriteJson(results, std::cout);
+		return std::all_of(results.begin(), results.end(), [](const auto& result) {
+			return result.isWithinBound_;
+		});
+	}
+}
+
+//-----------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+	try
+	{
+		po::options_description description{"Usage: CoverageBenchmark [options]"};
+		po::variables_map variablesMap;
+
+		description.add_options()
+			(HelpOption, "Show this help message.")
+			(OutputOption, po::value<std::string>(), "Write the results in this JSON file instead of the standard output.")
+			(FilterOption, po::value<std::string>()->default_value(""), "Run only the benchmarks whose name contains this text.")
+			(IterationsOption, po::value<size_t>()->default_value(5), "Number of timed iterations of each benchmark.")
+			(SmallOption, "Use 100k lines in 10k files instead of 1M lines in 100k files.")
+			(PdbModuleOption, po::value<std::vector<std::string>>(), "Benchmark reading the debug information of this module. Can have multiple occurrences.")
+			(ScalabilityOption, "Instead of the benchmarks, time the operations at sizes growing by 10 and fail when "
+			                    "the time grows faster than their complexity. --small stops at 1M lines instead of 10M.");
+		po::store(po::parse_command_line(argc, argv, description), variablesMap);
+		po::notify(variablesMap);
+
+		if (variablesMap.count(HelpOption))
+		{
+			std::cout << description << std::endl;
+			return 0;
+		}
+
+		if (variablesMap.count(ScalabilityOption))
+			return RunScalabilityChecks(variablesMap) ? 0 : 1;
+
+		const auto& scale = variablesMap.count(SmallOption) ? SmallScale : DefaultScale;
+		cb::Benchmark benchmark;
+
+		cb::AddCppCoverageBenchmarks(benchmark, scale);
+		cb::AddFileFilterBenchmarks(benchmark, scale);
+		cb::AddExporterBenchmarks(benchmark, scale);
+		if (variablesMap.count(PdbModuleOption))
+		{
+			const auto& modules = variablesMap[PdbModuleOption].as<std::vector<std::string>>();
+
+			cb::AddPdbBenchmarks(benchmark, {modules.begin(), modules.end()});
+		}
+
+		auto results = benchmark.Run(
+		    variablesMap[FilterOption].as<std::string>(),
+		    variablesMap[IterationsOption].as<size_t>(),
+		    &std::cerr);
+
+		if (variablesMap.count(OutputOption))
+		{
+			std::ofstream ofs{variablesMap[OutputOption].as<std::string>()};
+
+			cb::Benchmark::WriteJson(results, ofs);
+		}
+		else
+			cb::Benchmark::WriteJson(results, std::cout);
+		return 0;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "Error: " << e.what() << std::endl;
+	}
+	catch (...)
+	{
+		std::cerr << "Unknown error" << std::endl;
+	}
+	return 1;
+}
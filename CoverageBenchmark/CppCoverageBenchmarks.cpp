@@ -0,0 +1,145 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+
+#include <memory>
+
+#include "CppCoverage/Address.hpp"
+#include "CppCoverage/CoverageDataMerger.hpp"
+#include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/ExecutedAddressManager.hpp"
+#include "CppCoverage/Patterns.hpp"
+#include "CppCoverage/WildcardCoverageFilter.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+#include "Benchmark.hpp"
+#include "DataGenerator.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		const uintptr_t BaseOfImage = 0x10000000;
+		const uintptr_t InstructionSize = 4;
+
+		//---------------------------------------------------------------------
+		cov::Address GetAddress(size_t lineIndex)
+		{
+			return cov::Address{nullptr, reinterpret_cast<void*>(BaseOfImage + lineIndex * InstructionSize)};
+		}
+
+		//---------------------------------------------------------------------
+		std::unique_ptr<cov::ExecutedAddressManager> CreateExecutedAddressManager(
+		    const std::vector<std::wstring>& paths,
+		    const Scale& scale)
+		{
+			auto manager = std::make_unique<cov::ExecutedAddressManager>();
+			auto linesByFile = scale.lineCount_ / paths.size();
+
+			manager->AddModule(DataGenerator::GetModulePath(0), reinterpret_cast<void*>(BaseOfImage));
+			manager->ReserveAddresses(nullptr, scale.lineCount_);
+			for (size_t i = 0; i < scale.lineCount_; ++i)
+			{
+				const auto& path = paths[(i / linesByFile) % paths.size()];
+				auto line = static_cast<unsigned int>(i % linesByFile) + 1;
+
+				manager->RegisterAddress(GetAddress(i), path, line, 0xCC);
+			}
+			return manager;
+		}
+
+		//---------------------------------------------------------------------
+		void AddExecutedAddressManagerBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("ExecutedAddressManager.RegisterAddress", [scale]() {
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(scale.fileCount_));
+
+				return [paths, scale]() {
+					CreateExecutedAddressManager(*paths, scale);
+					return uint64_t{scale.lineCount_};
+				};
+			});
+
+			benchmark.Add("ExecutedAddressManager.MarkAddressAsExecuted", [scale]() {
+				auto paths = DataGenerator::GeneratePaths(scale.fileCount_);
+				std::shared_ptr<cov::ExecutedAddressManager> manager = CreateExecutedAddressManager(paths, scale);
+
+				// The addresses stay registered to hit them at each iteration.
+				manager->KeepExecutedAddresses();
+				return [manager, scale]() {
+					for (size_t i = 0; i < scale.lineCount_; ++i)
+						manager->MarkAddressAsExecuted(GetAddress(i));
+					return uint64_t{scale.lineCount_};
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddWildcardCoverageFilterBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("WildcardCoverageFilter.IsSourceFileSelected", [scale]() {
+				cov::Patterns modulePatterns;
+				cov::Patterns sourcePatterns;
+
+				modulePatterns.AddSelectedPatterns(L"*");
+				sourcePatterns.AddSelectedPatterns(L"C:\\Dev\\Component1*");
+				sourcePatterns.AddSelectedPatterns(L"*\\Src\\Folder4*");
+				sourcePatterns.AddExcludedPatterns(L"*\\Folder42\\*");
+				sourcePatterns.AddExcludedPatterns(L"*Test*");
+
+				auto filter = std::make_shared<cov::WildcardCoverageFilter>(
+				    cov::CoverageFilterSettings{modulePatterns, sourcePatterns});
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(scale.fileCount_));
+
+				return [filter, paths]() {
+					for (const auto& path : *paths)
+						filter->IsSourceFileSelected(path);
+					return uint64_t{paths->size()};
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoverageDataMergerBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("CoverageDataMerger.Merge", [scale]() {
+				const size_t runCount = 4;
+				auto coverageDatas = std::make_shared<std::vector<Plugin::CoverageData>>();
+
+				for (unsigned int seed = 0; seed < runCount; ++seed)
+					coverageDatas->push_back(DataGenerator{seed}.GenerateCoverageData(scale, 0.5));
+				return [coverageDatas, scale]() {
+					cov::CoverageDataMerger{}.Merge(*coverageDatas);
+					return uint64_t{scale.lineCount_ * coverageDatas->size()};
+				};
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AddCppCoverageBenchmarks(Benchmark& benchmark, const Scale& scale)
+	{
+		AddExecutedAddressManagerBenchmarks(benchmark, scale);
+		AddWildcardCoverageFilterBenchmarks(benchmark, scale);
+		AddCoverageDataMergerBenchmarks(benchmark, scale);
+	}
+}
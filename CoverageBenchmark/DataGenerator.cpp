@@ -0,0 +1,93 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "DataGenerator.hpp"
+
+#include <algorithm>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		const size_t ComponentCount = 50;
+		const size_t FolderCount = 100;
+	}
+
+	//-------------------------------------------------------------------------
+	DataGenerator::DataGenerator(unsigned int seed) : generator_{seed}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::wstring> DataGenerator::GeneratePaths(size_t count)
+	{
+		std::vector<std::wstring> paths;
+
+		paths.reserve(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			paths.push_back(L"C:\\Dev\\Component" + std::to_wstring(i % ComponentCount) +
+			                L"\\Src\\Folder" + std::to_wstring((i / ComponentCount) % FolderCount) +
+			                L"\\File" + std::to_wstring(i) + L".cpp");
+		}
+		return paths;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring DataGenerator::GetModulePath(size_t moduleIndex)
+	{
+		return L"C:\\Dev\\Bin\\Module" + std::to_wstring(moduleIndex) + L".dll";
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData DataGenerator::GenerateCoverageData(const Scale& scale, double executedRatio)
+	{
+		Plugin::CoverageData coverageData{L"Benchmark", 0};
+		std::bernoulli_distribution isExecuted{executedRatio};
+		std::uniform_int_distribution<unsigned int> lineGap{1, 4};
+		auto paths = GeneratePaths(scale.fileCount_);
+		auto moduleCount = (std::max)(scale.moduleCount_, size_t{1});
+		auto linesByFile = scale.lineCount_ / (std::max)(scale.fileCount_, size_t{1});
+
+		coverageData.ReserveModules(moduleCount);
+		for (size_t moduleIndex = 0; moduleIndex < moduleCount; ++moduleIndex)
+		{
+			auto& module = coverageData.AddModule(GetModulePath(moduleIndex));
+
+			module.ReserveFiles(paths.size() / moduleCount + 1);
+			for (size_t fileIndex = moduleIndex; fileIndex < paths.size(); fileIndex += moduleCount)
+			{
+				auto& file = module.AddFile(paths[fileIndex]);
+				unsigned int line = 0;
+
+				file.ReserveLines(linesByFile);
+				for (size_t i = 0; i < linesByFile; ++i)
+				{
+					line += lineGap(generator_);
+					auto hasBeenExecuted = isExecuted(generator_);
+					file.AddLine(line, hasBeenExecuted, hasBeenExecuted ? 1 : 0);
+				}
+			}
+		}
+		return coverageData;
+	}
+}
@@ -0,0 +1,59 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CoverageBenchmark
+{
+	struct Scale
+	{
+		size_t moduleCount_;
+		size_t fileCount_; // Total for all the modules.
+		size_t lineCount_; // Total for all the files.
+	};
+
+	// Synthetic data with the shape of the coverage of a large code base. The
+	// same seed always generates the same data.
+	class DataGenerator
+	{
+	public:
+		explicit DataGenerator(unsigned int seed);
+
+		// Unique paths like C:\Dev\Component3\Src\Folder12\File1234.cpp.
+		static std::vector<std::wstring> GeneratePaths(size_t count);
+		static std::wstring GetModulePath(size_t moduleIndex);
+
+		// The files are spread over the modules and each line is executed with
+		// the probability executedRatio.
+		Plugin::CoverageData GenerateCoverageData(const Scale&, double executedRatio);
+
+	private:
+		DataGenerator(const DataGenerator&) = delete;
+		DataGenerator& operator=(const DataGenerator&) = delete;
+
+		std::default_random_engine generator_;
+	};
+}
@@ -0,0 +1,108 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+
+#include <memory>
+#include <sstream>
+
+#include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Exporter/CoberturaExporter.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+#include "Benchmark.hpp"
+#include "DataGenerator.hpp"
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::shared_ptr<Plugin::CoverageData> CreateCoverageData(const Scale& scale)
+		{
+			return std::make_shared<Plugin::CoverageData>(DataGenerator{0}.GenerateCoverageData(scale, 0.5));
+		}
+
+		//---------------------------------------------------------------------
+		void AddSerializerBenchmark(
+		    Benchmark& benchmark,
+		    const std::string& name,
+		    Exporter::CoverageDataSerializer::Version version,
+		    const Scale& scale)
+		{
+			benchmark.Add(name, [version, scale]() {
+				auto coverageData = CreateCoverageData(scale);
+
+				return [coverageData, version, scale]() {
+					std::ostringstream ostr;
+
+					Exporter::CoverageDataSerializer{version}.Serialize(*coverageData, ostr);
+					return uint64_t{scale.lineCount_};
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddBinaryBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			using Version = Exporter::CoverageDataSerializer::Version;
+
+			AddSerializerBenchmark(benchmark, "CoverageDataSerializer.SerializeV1", Version::V1, scale);
+			AddSerializerBenchmark(benchmark, "CoverageDataSerializer.SerializeV2", Version::V2, scale);
+			AddSerializerBenchmark(
+			    benchmark, "CoverageDataSerializer.SerializeV2Compressed", Version::V2Compressed, scale);
+
+			benchmark.Add("CoverageDataDeserializer.Deserialize", [scale]() {
+				std::ostringstream ostr;
+
+				Exporter::CoverageDataSerializer{}.Serialize(*CreateCoverageData(scale), ostr);
+				auto content = std::make_shared<std::string>(ostr.str());
+				return [content, scale]() {
+					std::istringstream istr{*content};
+
+					Exporter::CoverageDataDeserializer{}.Deserialize(istr, "Invalid benchmark data");
+					return uint64_t{scale.lineCount_};
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoberturaBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("CoberturaExporter.Export", [scale]() {
+				auto coverageData = CreateCoverageData(scale);
+
+				return [coverageData, scale]() {
+					std::ostringstream ostr;
+
+					Exporter::CoberturaExporter{}.Export(*coverageData, ostr);
+					return uint64_t{scale.lineCount_};
+				};
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AddExporterBenchmarks(Benchmark& benchmark, const Scale& scale)
+	{
+		AddBinaryBenchmarks(benchmark, scale);
+		AddCoberturaBenchmarks(benchmark, scale);
+	}
+}
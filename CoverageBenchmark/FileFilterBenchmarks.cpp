@@ -0,0 +1,137 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <boost/optional.hpp>
+
+#include "FileFilter/File.hpp"
+#include "FileFilter/LineFilter.hpp"
+#include "FileFilter/PathMatcher.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "Benchmark.hpp"
+#include "DataGenerator.hpp"
+
+namespace fs = std::filesystem;
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		// The files are read from the disk: use fewer and longer files.
+		const size_t LineFilterFileRatio = 100;
+
+		//---------------------------------------------------------------------
+		struct SourceFiles
+		{
+			SourceFiles() : folder_{TestHelper::TemporaryPathOption::CreateAsFolder}
+			{
+			}
+
+			TestHelper::TemporaryPath folder_;
+			std::vector<fs::path> paths_;
+			size_t linesByFile_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		std::shared_ptr<SourceFiles> CreateSourceFiles(const Scale& scale)
+		{
+			auto sourceFiles = std::make_shared<SourceFiles>();
+			auto fileCount = (std::max)(scale.fileCount_ / LineFilterFileRatio, size_t{1});
+
+			sourceFiles->linesByFile_ = scale.lineCount_ / fileCount;
+			for (size_t i = 0; i < fileCount; ++i)
+			{
+				auto path = sourceFiles->folder_.GetPath() / ("File" + std::to_string(i) + ".cpp");
+				std::ofstream ofs{path};
+
+				for (size_t line = 1; line <= sourceFiles->linesByFile_; ++line)
+				{
+					if (line % 10 == 0)
+						ofs << "\tassert(value" << line << ");\n";
+					else if (line % 17 == 0)
+						ofs << "\tLOG_INFO << value" << line << ";\n";
+					else
+						ofs << "\tvalue += " << line << ";\n";
+				}
+				sourceFiles->paths_.push_back(path);
+			}
+			return sourceFiles;
+		}
+
+		//---------------------------------------------------------------------
+		void AddLineFilterBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("LineFilter.IsLineSelected", [scale]() {
+				auto sourceFiles = CreateSourceFiles(scale);
+
+				// A new filter reads and filters the files at each iteration.
+				return [sourceFiles]() {
+					FileFilter::LineFilter lineFilter{{L".*assert.*", L".*LOG_.*"}, false};
+
+					for (const auto& path : sourceFiles->paths_)
+					{
+						for (size_t line = 1; line <= sourceFiles->linesByFile_; ++line)
+							lineFilter.IsLineSelected(path, static_cast<int>(line));
+					}
+					return uint64_t{sourceFiles->paths_.size() * sourceFiles->linesByFile_};
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddPathMatcherBenchmarks(Benchmark& benchmark, const Scale& scale)
+		{
+			benchmark.Add("PathMatcher.Match", [scale]() {
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(scale.fileCount_));
+				auto diffPaths = std::make_shared<std::vector<fs::path>>();
+				const std::wstring root = L"C:\\Dev\\";
+
+				// The paths of a diff are relative to the root of the repository.
+				for (const auto& path : *paths)
+					diffPaths->push_back(path.substr(root.size()));
+
+				// The construction of the matcher is included in the iteration.
+				return [paths, diffPaths]() {
+					std::vector<FileFilter::File> files;
+
+					files.reserve(diffPaths->size());
+					for (const auto& diffPath : *diffPaths)
+						files.emplace_back(diffPath);
+
+					FileFilter::PathMatcher pathMatcher{std::move(files), boost::none};
+					for (const auto& path : *paths)
+						pathMatcher.Match(path);
+					return uint64_t{paths->size()};
+				};
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AddFileFilterBenchmarks(Benchmark& benchmark, const Scale& scale)
+	{
+		AddLineFilterBenchmarks(benchmark, scale);
+		AddPathMatcherBenchmarks(benchmark, scale);
+	}
+}
@@ -0,0 +1,168 @@
+# OpenCppCoverage is an open source code coverage for C++.
+# Copyright (C) 2017 OpenCppCoverage
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+# Generate a DLL with a large PDB for the PDB benchmarks of CoverageBenchmark:
+#   CoverageBenchmark --pdb_module <OutputFolder>\PdbWorkload.dll
+# FileCount files of FunctionCount functions of LineCount lines, each file
+# instantiating a class template TemplateCount times. Size selects a preset
+# giving a PDB of about this size: 10MB, 100MB or 1GB. With FastLink, the
+# DLL is linked with /DEBUG:FASTLINK and its debug information stays in the
+# object files.
+# Must be run from a Visual Studio developer command prompt: cl and link
+# are the ones of the target architecture.
+param(
+	[Parameter(Mandatory = $true)][string]$OutputFolder,
+	[ValidateSet('', '10MB', '100MB', '1GB')][string]$Size = '',
+	[int]$FileCount = 100,
+	[int]$FunctionCount = 100,
+	[int]$TemplateCount = 10,
+	[int]$LineCount = 10,
+	[switch]$FastLink
+)
+
+$ErrorActionPreference = 'Stop'
+
+switch ($Size)
+{
+	'10MB' { $FileCount = 100; $FunctionCount = 100; $TemplateCount = 10 }
+	'100MB' { $FileCount = 1000; $FunctionCount = 100; $TemplateCount = 10 }
+	'1GB' { $FileCount = 5000; $FunctionCount = 200; $TemplateCount = 20 }
+}
+
+$OutputFolder = $ExecutionContext.SessionState.Path.GetUnresolvedProviderPathFromPSPath($OutputFolder)
+$sourceFolder = Join-Path $OutputFolder 'Src'
+$objectFolder = Join-Path $OutputFolder 'Obj'
+New-Item -ItemType Directory -Force -Path $sourceFolder | Out-Null
+New-Item -ItemType Directory -Force -Path $objectFolder | Out-Null
+
+#------------------------------------------------------------------------------
+function Write-Source([string]$path, [System.Text.StringBuilder]$builder)
+{
+	$content = $builder.ToString()
+	# Keep the files unchanged to keep incremental builds fast.
+	if ((Test-Path $path) -and ([System.IO.File]::ReadAllText($path) -eq $content))
+	{
+		return
+	}
+	[System.IO.File]::WriteAllText($path, $content)
+}
+
+#------------------------------------------------------------------------------
+function Write-Template()
+{
+	$builder = New-Object System.Text.StringBuilder
+	[void]$builder.AppendLine('#pragma once')
+	[void]$builder.AppendLine('')
+	[void]$builder.AppendLine('template <int N>')
+	[void]$builder.AppendLine('struct PdbWorkloadTemplate')
+	[void]$builder.AppendLine('{')
+	[void]$builder.AppendLine("`tstatic unsigned int Run(unsigned int value)")
+	[void]$builder.AppendLine("`t{")
+	for ($line = 0; $line -lt $LineCount; ++$line)
+	{
+		[void]$builder.AppendLine("`t`tvalue = (value ^ N) * $($line + 3);")
+	}
+	[void]$builder.AppendLine("`t`treturn value;")
+	[void]$builder.AppendLine("`t}")
+	[void]$builder.AppendLine('};')
+	Write-Source (Join-Path $sourceFolder 'PdbWorkloadTemplate.hpp') $builder
+}
+
+#------------------------------------------------------------------------------
+function Write-File([int]$file)
+{
+	$builder = New-Object System.Text.StringBuilder
+	[void]$builder.AppendLine('#include "PdbWorkloadTemplate.hpp"')
+	[void]$builder.AppendLine('')
+	[void]$builder.AppendLine("namespace File$file")
+	[void]$builder.AppendLine('{')
+	for ($function = 0; $function -lt $FunctionCount; ++$function)
+	{
+		[void]$builder.AppendLine("`tunsigned int Function$function(unsigned int value)")
+		[void]$builder.AppendLine("`t{")
+		for ($line = 0; $line -lt $LineCount; ++$line)
+		{
+			[void]$builder.AppendLine("`t`tvalue = value % 5 ? value * $($line + 7) : value + $function;")
+		}
+		[void]$builder.AppendLine("`t`treturn value;")
+		[void]$builder.AppendLine("`t}")
+	}
+	[void]$builder.AppendLine('}')
+	[void]$builder.AppendLine('')
+	[void]$builder.AppendLine("unsigned int RunFile$file(unsigned int value)")
+	[void]$builder.AppendLine('{')
+	for ($function = 0; $function -lt $FunctionCount; ++$function)
+	{
+		[void]$builder.AppendLine("`tvalue = File$file::Function$function(value);")
+	}
+	for ($template = 0; $template -lt $TemplateCount; ++$template)
+	{
+		# Distinct instantiations by file, as the templates of a real code base.
+		[void]$builder.AppendLine("`tvalue = PdbWorkloadTemplate<$($file * $TemplateCount + $template)>::Run(value);")
+	}
+	[void]$builder.AppendLine("`treturn value;")
+	[void]$builder.AppendLine('}')
+	Write-Source (Join-Path $sourceFolder "File$file.cpp") $builder
+}
+
+#------------------------------------------------------------------------------
+function Write-Main()
+{
+	$builder = New-Object System.Text.StringBuilder
+	for ($file = 0; $file -lt $FileCount; ++$file)
+	{
+		[void]$builder.AppendLine("unsigned int RunFile$file(unsigned int);")
+	}
+	[void]$builder.AppendLine('')
+	[void]$builder.AppendLine('extern "C" __declspec(dllexport) unsigned int RunPdbWorkload(unsigned int value)')
+	[void]$builder.AppendLine('{')
+	for ($file = 0; $file -lt $FileCount; ++$file)
+	{
+		[void]$builder.AppendLine("`tvalue = RunFile$file(value);")
+	}
+	[void]$builder.AppendLine("`treturn value;")
+	[void]$builder.AppendLine('}')
+	Write-Source (Join-Path $sourceFolder 'PdbWorkload.cpp') $builder
+}
+
+Write-Host "Generating $FileCount files of $FunctionCount functions of $LineCount lines and $TemplateCount template instantiations."
+Write-Template
+for ($file = 0; $file -lt $FileCount; ++$file)
+{
+	Write-File $file
+}
+Write-Main
+
+$sources = Get-ChildItem -Path $sourceFolder -Filter '*.cpp' | ForEach-Object { $_.FullName }
+$responseFile = Join-Path $OutputFolder 'Sources.rsp'
+[System.IO.File]::WriteAllLines($responseFile, $sources)
+
+# /Od keeps one line table entry by source line.
+& cl /nologo /c /Zi /Od /EHsc /MP "/Fo$objectFolder\" "/Fd$objectFolder\Compile.pdb" "@$responseFile"
+if ($LASTEXITCODE -ne 0)
+{
+	throw "cl failed with exit code $LASTEXITCODE"
+}
+
+$debug = if ($FastLink) { '/DEBUG:FASTLINK' } else { '/DEBUG:FULL' }
+& link /nologo /DLL /INCREMENTAL:NO $debug "/OUT:$OutputFolder\PdbWorkload.dll" "/PDB:$OutputFolder\PdbWorkload.pdb" "$objectFolder\*.obj"
+if ($LASTEXITCODE -ne 0)
+{
+	throw "link failed with exit code $LASTEXITCODE"
+}
+
+$pdbSize = (Get-Item (Join-Path $OutputFolder 'PdbWorkload.pdb')).Length
+Write-Host ("PdbWorkload.pdb: {0:N0} MB" -f ($pdbSize / 1MB))
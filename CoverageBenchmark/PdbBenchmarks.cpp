@@ -0,0 +1,189 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+
+#include <memory>
+#include <boost/optional.hpp>
+
+#include <Windows.h>
+
+#include "CppCoverage/BreakPoint.hpp"
+#include "CppCoverage/CoverageFilterManager.hpp"
+#include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/CoverageLevel.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+#include "CppCoverage/DebugInformationEnumerator.hpp"
+#include "CppCoverage/ExecutedAddressManager.hpp"
+#include "CppCoverage/FilterAssistant.hpp"
+#include "CppCoverage/IFileSystem.hpp"
+#include "CppCoverage/MonitoredLineRegister.hpp"
+#include "CppCoverage/Patterns.hpp"
+#include "CppCoverage/PdbCache.hpp"
+#include "CppCoverage/UnifiedDiffSettings.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "Benchmark.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = std::filesystem;
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class LineCounter : public cov::IDebugInformationHandler
+		{
+		public:
+			bool IsSourceFileSelected(const fs::path&) override
+			{
+				return true;
+			}
+
+			void OnSourceFile(const fs::path&, const std::vector<Line>& lines) override
+			{
+				lineCount_ += lines.size();
+			}
+
+			uint64_t GetLineCount() const
+			{
+				return lineCount_;
+			}
+
+		private:
+			uint64_t lineCount_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		// The suggested filters are not benchmarked.
+		class NoFileSystem : public cov::IFileSystem
+		{
+		public:
+			boost::optional<fs::file_time_type>
+			GetLastWriteTime(const fs::path&) const override
+			{
+				return boost::none;
+			}
+		};
+
+		//---------------------------------------------------------------------
+		uint64_t Enumerate(const fs::path& modulePath,
+		                   std::shared_ptr<const cov::PdbCache> pdbCache,
+		                   bool useNativePdbReader)
+		{
+			cov::DebugInformationEnumerator enumerator{{}, pdbCache, useNativePdbReader};
+			LineCounter lineCounter;
+
+			if (!enumerator.Enumerate(modulePath, lineCounter))
+				THROW(L"Cannot read the debug information of " << modulePath.wstring());
+			return lineCounter.GetLineCount();
+		}
+
+		//---------------------------------------------------------------------
+		struct LoadedModule
+		{
+			explicit LoadedModule(const fs::path& path)
+			    : module_{LoadLibraryExW(path.c_str(), nullptr, DONT_RESOLVE_DLL_REFERENCES)}
+			{
+				if (!module_)
+					THROW(L"Cannot load " << path.wstring());
+			}
+
+			~LoadedModule()
+			{
+				FreeLibrary(module_);
+			}
+
+			const HMODULE module_;
+
+		private:
+			LoadedModule(const LoadedModule&) = delete;
+			LoadedModule& operator=(const LoadedModule&) = delete;
+		};
+
+		//---------------------------------------------------------------------
+		// The module is loaded in this process without running its code: the
+		// breakpoints are deferred so the instructions are only read.
+		uint64_t RegisterLineToMonitor(const fs::path& modulePath, HMODULE module)
+		{
+			cov::Patterns modulePatterns;
+			cov::Patterns sourcePatterns;
+
+			modulePatterns.AddSelectedPatterns(L"*");
+			sourcePatterns.AddSelectedPatterns(L"*");
+			cov::MonitoredLineRegister monitoredLineRegister{
+			    std::make_shared<cov::BreakPoint>(),
+			    std::make_shared<cov::ExecutedAddressManager>(),
+			    std::make_shared<cov::CoverageFilterManager>(
+			        cov::CoverageFilterSettings{modulePatterns, sourcePatterns},
+			        std::vector<cov::UnifiedDiffSettings>{},
+			        std::vector<std::wstring>{},
+			        false),
+			    std::make_unique<cov::DebugInformationEnumerator>(
+			        std::vector<cov::SubstitutePdbSourcePath>{}),
+			    std::make_shared<cov::FilterAssistant>(std::make_shared<NoFileSystem>()),
+			    false,
+			    false,
+			    false,
+			    nullptr,
+			    cov::CoverageLevel::Line};
+
+			monitoredLineRegister.SetBreakPointsDeferred(true);
+			if (!monitoredLineRegister.RegisterLineToMonitor(modulePath, GetCurrentProcess(), module))
+				THROW(L"Cannot register the lines of " << modulePath.wstring());
+			return monitoredLineRegister.GetLastRegistrationStatistics().selectedLineCount_;
+		}
+
+		//---------------------------------------------------------------------
+		void AddModuleBenchmarks(Benchmark& benchmark, const fs::path& modulePath)
+		{
+			auto suffix = "/" + modulePath.filename().string();
+
+			benchmark.Add("DebugInformationEnumerator.Enumerate.Dia" + suffix, [modulePath]() {
+				return [modulePath]() { return Enumerate(modulePath, nullptr, false); };
+			});
+			benchmark.Add("DebugInformationEnumerator.Enumerate.NativePdbReader" + suffix, [modulePath]() {
+				return [modulePath]() { return Enumerate(modulePath, nullptr, true); };
+			});
+			benchmark.Add("DebugInformationEnumerator.Enumerate.PdbCache" + suffix, [modulePath]() {
+				auto folder = std::make_shared<TestHelper::TemporaryPath>(
+				    TestHelper::TemporaryPathOption::CreateAsFolder);
+				auto pdbCache = std::make_shared<const cov::PdbCache>(folder->GetPath());
+
+				// Fill the cache: the iterations only read it.
+				Enumerate(modulePath, pdbCache, false);
+				return [modulePath, folder, pdbCache]() { return Enumerate(modulePath, pdbCache, false); };
+			});
+			benchmark.Add("MonitoredLineRegister.RegisterLineToMonitor" + suffix, [modulePath]() {
+				auto loadedModule = std::make_shared<LoadedModule>(modulePath);
+
+				return [modulePath, loadedModule]() {
+					return RegisterLineToMonitor(modulePath, loadedModule->module_);
+				};
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AddPdbBenchmarks(Benchmark& benchmark, const std::vector<fs::path>& modulePaths)
+	{
+		for (const auto& modulePath : modulePaths)
+			AddModuleBenchmarks(benchmark, modulePath);
+	}
+}
@@ -0,0 +1,159 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Scalability.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		//---------------------------------------------------------------------
+		double GetCost(Scalability::Complexity complexity, size_t size)
+		{
+			auto n = static_cast<double>(size);
+
+			if (complexity == Scalability::Complexity::LinearLogarithmic)
+				return n * std::log2((std::max)(n, 2.0));
+			return n;
+		}
+
+		//---------------------------------------------------------------------
+		const char* ToString(Scalability::Complexity complexity)
+		{
+			return complexity == Scalability::Complexity::Linear ? "O(n)" : "O(n log n)";
+		}
+
+		//---------------------------------------------------------------------
+		Scalability::Clock::duration MeasureMinTime(
+		    const Scalability::Factory& factory,
+		    size_t size,
+		    size_t iterationCount)
+		{
+			auto minTime = Scalability::Clock::duration::max();
+
+			for (size_t i = 0; i < (std::max)(iterationCount, size_t{1}); ++i)
+			{
+				auto operation = factory(size);
+				auto start = Scalability::Clock::now();
+
+				operation();
+				minTime = (std::min)(minTime, Scalability::Clock::now() - start);
+			}
+			return minTime;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const double Scalability::Tolerance = 3.0;
+	const Scalability::Clock::duration Scalability::MinComparedTime = std::chrono::milliseconds{1};
+
+	//-------------------------------------------------------------------------
+	void Scalability::Add(
+	    const std::string& name,
+	    Complexity complexity,
+	    size_t minSize,
+	    size_t maxSize,
+	    Factory factory)
+	{
+		checks_.push_back({name, complexity, (std::max)(minSize, size_t{1}), maxSize, std::move(factory)});
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Scalability::Result> Scalability::Run(
+	    const std::string& filter,
+	    size_t iterationCount,
+	    std::ostream* progress) const
+	{
+		std::vector<Result> results;
+
+		for (const auto& check : checks_)
+		{
+			if (check.name_.find(filter) == std::string::npos)
+				continue;
+			if (progress)
+				*progress << check.name_ << " " << ToString(check.complexity_) << std::endl;
+
+			Result result{check.name_, check.complexity_, {}, 0, true};
+			for (auto size = check.minSize_; size <= check.maxSize_; size *= 10)
+			{
+				Measure measure{size, MeasureMinTime(check.factory_, size, iterationCount)};
+
+				if (!result.measures_.empty())
+				{
+					const auto& previous = result.measures_.back();
+
+					if (previous.minTime_ >= MinComparedTime)
+					{
+						auto timeGrowth = Milliseconds{measure.minTime_}.count() / Milliseconds{previous.minTime_}.count();
+						auto allowedGrowth = GetCost(check.complexity_, size) / GetCost(check.complexity_, previous.size_);
+						auto growthRatio = timeGrowth / allowedGrowth;
+
+						result.maxGrowthRatio_ = (std::max)(result.maxGrowthRatio_, growthRatio);
+						if (growthRatio > Tolerance)
+							result.isWithinBound_ = false;
+					}
+				}
+				if (progress)
+				{
+					*progress << "  " << size << ": " << std::fixed << std::setprecision(2)
+					          << Milliseconds{measure.minTime_}.count() << " ms" << std::endl;
+				}
+				result.measures_.push_back(measure);
+			}
+			if (progress && !result.isWithinBound_)
+			{
+				*progress << "  FAILED: the time grows " << result.maxGrowthRatio_ << " times faster than "
+				          << ToString(check.complexity_) << std::endl;
+			}
+			results.push_back(std::move(result));
+		}
+		return results;
+	}
+
+	//-------------------------------------------------------------------------
+	void Scalability::WriteJson(const std::vector<Result>& results, std::ostream& ostr)
+	{
+		// The names of the checks are identifiers: they are not escaped.
+		ostr << "{\n  \"scalability\": [";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+
+			ostr << (i ? ",\n" : "\n") << "    {\"name\": \"" << result.name_ << "\""
+			     << ", \"complexity\": \"" << ToString(result.complexity_) << "\""
+			     << ", \"maxGrowthRatio\": " << result.maxGrowthRatio_
+			     << ", \"isWithinBound\": " << (result.isWithinBound_ ? "true" : "false")
+			     << ", \"measures\": [";
+			for (size_t j = 0; j < result.measures_.size(); ++j)
+			{
+				const auto& measure = result.measures_[j];
+
+				ostr << (j ? ", " : "") << "{\"size\": " << measure.size_
+				     << ", \"minMs\": " << Milliseconds{measure.minTime_}.count() << "}";
+			}
+			ostr << "]}";
+		}
+		ostr << "\n  ]\n}\n";
+	}
+}
@@ -0,0 +1,96 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "Benchmark.hpp"
+
+namespace CoverageBenchmark
+{
+	// Time operations at sizes growing by a factor of 10 and fail when the
+	// time grows faster than the complexity of the operation allows. A change
+	// making an operation quadratic is caught even when the benchmarks, which
+	// use a single size, only get slower.
+	class Scalability
+	{
+	public:
+		using Clock = Benchmark::Clock;
+
+		enum class Complexity
+		{
+			Linear,
+			LinearLogarithmic
+		};
+
+		// Build the data of size, which is not timed, and return the operation
+		// to time. The factory is called for each iteration so the operation
+		// can consume its data.
+		using Factory = std::function<std::function<void()>(size_t size)>;
+
+		struct Measure
+		{
+			size_t size_;
+			Clock::duration minTime_;
+		};
+
+		struct Result
+		{
+			std::string name_;
+			Complexity complexity_;
+			std::vector<Measure> measures_;
+			// Largest ratio between the growth of the time and the growth
+			// allowed by the complexity, for two consecutive sizes.
+			double maxGrowthRatio_;
+			bool isWithinBound_;
+		};
+
+		// The cache misses grow with the size: the time can grow faster than
+		// the complexity by this factor. A quadratic operation grows 10 times faster.
+		static const double Tolerance;
+		// Shorter times are mostly noise and are not compared.
+		static const Clock::duration MinComparedTime;
+
+		Scalability() = default;
+
+		// sizes are minSize, 10 * minSize... up to maxSize.
+		void Add(const std::string& name, Complexity, size_t minSize, size_t maxSize, Factory);
+
+		// Run the checks whose name contains filter.
+		std::vector<Result> Run(const std::string& filter, size_t iterationCount, std::ostream* progress) const;
+
+		static void WriteJson(const std::vector<Result>&, std::ostream&);
+
+	private:
+		Scalability(const Scalability&) = delete;
+		Scalability& operator=(const Scalability&) = delete;
+
+		struct Check
+		{
+			std::string name_;
+			Complexity complexity_;
+			size_t minSize_;
+			size_t maxSize_;
+			Factory factory_;
+		};
+
+		std::vector<Check> checks_;
+	};
+}
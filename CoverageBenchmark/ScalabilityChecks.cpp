@@ -0,0 +1,214 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Benchmarks.hpp"
+
+#include <memory>
+#include <boost/optional.hpp>
+
+#include "CppCoverage/Address.hpp"
+#include "CppCoverage/CoverageDataMerger.hpp"
+#include "CppCoverage/ExecutedAddressManager.hpp"
+
+#include "FileFilter/File.hpp"
+#include "FileFilter/PathMatcher.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "DataGenerator.hpp"
+#include "Scalability.hpp"
+
+namespace cov = CppCoverage;
+namespace fs = std::filesystem;
+
+namespace CoverageBenchmark
+{
+	namespace
+	{
+		using Complexity = Scalability::Complexity;
+
+		const uintptr_t BaseOfImage = 0x10000000;
+		// Room for the addresses of the modules with few lines.
+		const uintptr_t ModuleSize = 0x1000;
+		const uintptr_t InstructionSize = 4;
+		const size_t LinesByFile = 100;
+		const size_t MaxObjectCount = 10000;
+
+		//---------------------------------------------------------------------
+		void* GetBaseOfImage(size_t moduleIndex)
+		{
+			return reinterpret_cast<void*>(BaseOfImage + moduleIndex * ModuleSize);
+		}
+
+		//---------------------------------------------------------------------
+		cov::Address GetAddress(HANDLE hProcess, void* baseOfImage, size_t lineIndex)
+		{
+			return cov::Address{hProcess, static_cast<char*>(baseOfImage) + lineIndex * InstructionSize};
+		}
+
+		//---------------------------------------------------------------------
+		// The lines are spread over the files by LinesByFile.
+		void RegisterModule(
+		    cov::ExecutedAddressManager& manager,
+		    HANDLE hProcess,
+		    size_t moduleIndex,
+		    const std::vector<std::wstring>& paths,
+		    size_t lineCount)
+		{
+			auto baseOfImage = GetBaseOfImage(moduleIndex);
+
+			manager.AddModule(DataGenerator::GetModulePath(moduleIndex), baseOfImage);
+			manager.ReserveAddresses(hProcess, lineCount);
+			for (size_t i = 0; i < lineCount; ++i)
+			{
+				const auto& path = paths[(i / LinesByFile) % paths.size()];
+				auto line = static_cast<unsigned int>(i % LinesByFile) + 1;
+
+				manager.RegisterAddress(GetAddress(hProcess, baseOfImage, i), path, line, 0xCC);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddExecutedAddressManagerChecks(Scalability& scalability, size_t maxLineCount)
+		{
+			scalability.Add("ExecutedAddressManager.CreateCoverageData", Complexity::LinearLogarithmic,
+			    10000, maxLineCount, [](size_t lineCount) {
+				auto paths = std::make_shared<std::vector<std::wstring>>(
+				    DataGenerator::GeneratePaths(lineCount / LinesByFile));
+
+				return [paths, lineCount]() {
+					cov::ExecutedAddressManager manager;
+
+					RegisterModule(manager, nullptr, 0, *paths, lineCount);
+					for (size_t i = 0; i < lineCount; i += 2)
+						manager.MarkAddressAsExecuted(GetAddress(nullptr, GetBaseOfImage(0), i));
+					manager.CreateCoverageData(L"", 0);
+				};
+			});
+
+			// Each unload must not scan the addresses of the other modules.
+			scalability.Add("ExecutedAddressManager.OnUnloadModule", Complexity::LinearLogarithmic,
+			    10, MaxObjectCount, [](size_t moduleCount) {
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(moduleCount));
+
+				return [paths, moduleCount]() {
+					cov::ExecutedAddressManager manager;
+
+					for (size_t i = 0; i < moduleCount; ++i)
+						RegisterModule(manager, nullptr, i, { (*paths)[i] }, LinesByFile);
+					for (size_t i = 0; i < moduleCount; ++i)
+						manager.OnUnloadModule(nullptr, GetBaseOfImage(i));
+				};
+			});
+
+			// The children of a test runner load the same module.
+			scalability.Add("ExecutedAddressManager.OnExitProcess", Complexity::LinearLogarithmic,
+			    10, MaxObjectCount, [](size_t processCount) {
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(1));
+
+				return [paths, processCount]() {
+					cov::ExecutedAddressManager manager;
+
+					for (size_t i = 0; i < processCount; ++i)
+					{
+						auto hProcess = reinterpret_cast<HANDLE>(i + 1);
+
+						RegisterModule(manager, hProcess, 0, *paths, LinesByFile);
+						manager.MarkAddressAsExecuted(GetAddress(hProcess, GetBaseOfImage(0), i % LinesByFile));
+						manager.OnExitProcess(hProcess);
+					}
+					manager.CreateCoverageData(L"", 0);
+				};
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoverageDataMergerChecks(Scalability& scalability)
+		{
+			// The processes have the same files.
+			scalability.Add("CoverageDataMerger.Merge", Complexity::Linear,
+			    10, MaxObjectCount, [](size_t processCount) {
+				auto coverageDatas = std::make_shared<std::vector<Plugin::CoverageData>>();
+				auto paths = DataGenerator::GeneratePaths(10);
+
+				for (size_t i = 0; i < processCount; ++i)
+				{
+					auto& coverageData = coverageDatas->emplace_back(L"", 0);
+					auto& module = coverageData.AddModule(DataGenerator::GetModulePath(0));
+
+					for (const auto& path : paths)
+					{
+						auto& file = module.AddFile(path);
+
+						for (unsigned int line = 1; line <= 10; ++line)
+							file.AddLine(line, (line + i) % 2 == 0);
+					}
+				}
+				return [coverageDatas]() { cov::CoverageDataMerger{}.Merge(*coverageDatas); };
+			});
+
+			// Each module has the same file.
+			scalability.Add("CoverageDataMerger.MergeFileCoverage", Complexity::Linear,
+			    10, MaxObjectCount, [](size_t moduleCount) {
+				auto coverageData = std::make_shared<Plugin::CoverageData>(L"", 0);
+				auto path = DataGenerator::GeneratePaths(1).front();
+
+				for (size_t i = 0; i < moduleCount; ++i)
+				{
+					auto& file = coverageData->AddModule(DataGenerator::GetModulePath(i)).AddFile(path);
+
+					for (unsigned int line = 1; line <= LinesByFile; ++line)
+						file.AddLine(line, (line + i) % 2 == 0);
+				}
+				return [coverageData]() { cov::CoverageDataMerger{}.MergeFileCoverage(*coverageData); };
+			});
+		}
+
+		//---------------------------------------------------------------------
+		void AddPathMatcherChecks(Scalability& scalability, size_t maxLineCount)
+		{
+			// The construction of the matcher normalizes the paths.
+			scalability.Add("PathMatcher.Match", Complexity::LinearLogarithmic,
+			    1000, maxLineCount / LinesByFile, [](size_t fileCount) {
+				auto paths = std::make_shared<std::vector<std::wstring>>(DataGenerator::GeneratePaths(fileCount));
+				const std::wstring root = L"C:\\Dev\\";
+
+				return [paths, root]() {
+					std::vector<FileFilter::File> files;
+
+					files.reserve(paths->size());
+					for (const auto& path : *paths)
+						files.emplace_back(fs::path{path.substr(root.size())});
+
+					FileFilter::PathMatcher pathMatcher{std::move(files), boost::none};
+					for (const auto& path : *paths)
+						pathMatcher.Match(path);
+				};
+			});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AddScalabilityChecks(Scalability& scalability, size_t maxLineCount)
+	{
+		AddExecutedAddressManagerChecks(scalability, maxLineCount);
+		AddCoverageDataMergerChecks(scalability);
+		AddPathMatcherChecks(scalability, maxLineCount);
+	}
+}
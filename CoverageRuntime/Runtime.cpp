@@ -0,0 +1,134 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Runtime.hpp"
+
+#include <cstring>
+#include <cwchar>
+
+#include "RuntimeSharedData.hpp"
+
+namespace CoverageRuntime
+{
+	namespace
+	{
+		// Several instrumented processes can exit at the same time.
+		const int MaxOpenAttempts = 1000;
+		const DWORD OpenRetryDelayMs = 10;
+
+		// Large enough for long paths. It is static as the callback can run
+		// with a small stack.
+		wchar_t countersPath[32768];
+
+		//---------------------------------------------------------------------
+		const CountersHeader* FindCounters(HMODULE module)
+		{
+			auto base = reinterpret_cast<const BYTE*>(module);
+			auto dosHeader = reinterpret_cast<const IMAGE_DOS_HEADER*>(base);
+			auto ntHeaders = reinterpret_cast<const IMAGE_NT_HEADERS*>(base + dosHeader->e_lfanew);
+			auto section = IMAGE_FIRST_SECTION(ntHeaders);
+
+			for (WORD i = 0; i < ntHeaders->FileHeader.NumberOfSections; ++i, ++section)
+			{
+				if (std::strncmp(reinterpret_cast<const char*>(section->Name),
+				                 CountersSectionName,
+				                 IMAGE_SIZEOF_SHORT_NAME) == 0)
+				{
+					auto header = reinterpret_cast<const CountersHeader*>(base + section->VirtualAddress);
+
+					if (header->version_ == CountersVersion && header->counterSize_ == sizeof(uintptr_t))
+						return header;
+				}
+			}
+			return nullptr;
+		}
+
+		//---------------------------------------------------------------------
+		HANDLE OpenCountersFile(HMODULE module)
+		{
+			auto maxSize = static_cast<DWORD>(_countof(countersPath) - _countof(CountersExtension));
+			auto size = GetModuleFileNameW(module, countersPath, maxSize);
+
+			if (!size || size == maxSize)
+				return INVALID_HANDLE_VALUE;
+			wcscpy_s(countersPath + size, _countof(countersPath) - size, CountersExtension);
+
+			for (int i = 0; i < MaxOpenAttempts; ++i)
+			{
+				auto file = CreateFileW(countersPath, GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+				                        OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+				if (file != INVALID_HANDLE_VALUE || GetLastError() != ERROR_SHARING_VIOLATION)
+					return file;
+				Sleep(OpenRetryDelayMs);
+			}
+			return INVALID_HANDLE_VALUE;
+		}
+
+		//---------------------------------------------------------------------
+		// The counters of the previous runs are in the file when its size
+		// matches.
+		void SaveCounters(HANDLE file, const CountersHeader& header)
+		{
+			const auto* counters = reinterpret_cast<const uintptr_t*>(&header + 1);
+			auto size = static_cast<DWORD>(header.counterCount_ * sizeof(uintptr_t));
+			auto heap = GetProcessHeap();
+			auto buffer = static_cast<uintptr_t*>(HeapAlloc(heap, HEAP_ZERO_MEMORY, size ? size : 1));
+
+			if (!buffer)
+				return;
+
+			LARGE_INTEGER fileSize;
+			DWORD readSize = 0;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart != size ||
+			    !ReadFile(file, buffer, size, &readSize, nullptr) || readSize != size)
+			{
+				std::memset(buffer, 0, size);
+			}
+			for (uint32_t i = 0; i < header.counterCount_; ++i)
+				buffer[i] += counters[i];
+
+			DWORD writtenSize = 0;
+			if (SetFilePointer(file, 0, nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER &&
+			    WriteFile(file, buffer, size, &writtenSize, nullptr))
+			{
+				SetEndOfFile(file);
+			}
+			HeapFree(heap, 0, buffer);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+extern "C" void NTAPI OpenCppCoverageTlsCallback(PVOID module, DWORD reason, PVOID)
+{
+	using namespace CoverageRuntime;
+
+	if (reason != DLL_PROCESS_DETACH)
+		return;
+
+	const auto* header = FindCounters(static_cast<HMODULE>(module));
+	if (!header)
+		return;
+
+	auto file = OpenCountersFile(static_cast<HMODULE>(module));
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		SaveCounters(file, *header);
+		CloseHandle(file);
+	}
+}
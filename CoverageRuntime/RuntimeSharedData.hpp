@@ -0,0 +1,47 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+
+// Layout of the counters written by OpenCppCoverage in an instrumented image
+// and saved by CoverageRuntime.dll when the image is unloaded.
+// This header is included by both sides and must not depend on anything else.
+namespace CoverageRuntime
+{
+	const char RuntimeFilename[] = "CoverageRuntime.dll";
+	const char TlsCallbackName[] = "OpenCppCoverageTlsCallback";
+	const char CountersSectionName[] = ".covcnt";
+	// The counters are saved in <module path><CountersExtension>.
+	const wchar_t CountersExtension[] = L".counters";
+
+	const uint32_t CountersVersion = 1;
+
+	//-------------------------------------------------------------------------
+	struct CountersHeader
+	{
+		uint32_t version_;
+		// sizeof(uintptr_t) of the image.
+		uint32_t counterSize_;
+		uint32_t counterCount_;
+		uint32_t padding_;
+	};
+
+	// The counter section is: CountersHeader | counters[counterCount_]
+	static_assert(sizeof(CountersHeader) % sizeof(uint64_t) == 0,
+	              "The counters must be aligned.");
+}
@@ -0,0 +1,280 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "AdaptiveArming.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const auto SmallWindow = std::chrono::milliseconds{100};
+		const size_t SmallWindowsBySecond = 10;
+		// A function hit once by window is not a trap storm.
+		const size_t MinHotHitCount = 2;
+
+		//---------------------------------------------------------------------
+		AdaptiveArming::Clock::duration ComputeWindow(size_t maxTrapsPerSecond)
+		{
+			// A budget lower than one trap by window cannot be respected.
+			if (maxTrapsPerSecond < SmallWindowsBySecond)
+				return std::chrono::seconds{1};
+			return SmallWindow;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetBudgetByWindow(size_t maxTrapsPerSecond)
+		{
+			if (maxTrapsPerSecond < SmallWindowsBySecond)
+				return maxTrapsPerSecond;
+			return maxTrapsPerSecond / SmallWindowsBySecond;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	AdaptiveArming::AdaptiveArming(size_t maxTrapsPerSecond, Clock::time_point start)
+	    : window_{ComputeWindow(maxTrapsPerSecond)},
+	      budgetByWindow_{GetBudgetByWindow(maxTrapsPerSecond)},
+	      start_{start},
+	      hotFunctionCount_{0},
+	      blockCount_{0}
+	{
+		if (!maxTrapsPerSecond)
+			THROW("The number of traps by second must be greater than 0.");
+	}
+
+	//-------------------------------------------------------------------------
+	void AdaptiveArming::AddFunctions(HANDLE hProcess,
+	                                  void* baseOfImage,
+	                                  const std::map<DWORD64, uint64_t>& functionRanges)
+	{
+		if (functionRanges.empty())
+			return;
+
+		auto it = processes_.find(hProcess);
+		if (it == processes_.end())
+			it = processes_.emplace(hProcess, Process{start_, 0, {}, {}, {}}).first;
+		for (const auto& pair : functionRanges)
+			it->second.functions_.emplace(pair.first, Function{pair.second, baseOfImage, 0, false});
+	}
+
+	//-------------------------------------------------------------------------
+	void AdaptiveArming::AddArmedAddresses(HANDLE hProcess, const std::vector<Address>& addresses)
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it == processes_.end())
+			return;
+
+		// Only the addresses of the functions can be monitored by basic block
+		// and they are removed with their function.
+		auto& process = it->second;
+		for (const auto& address : addresses)
+		{
+			auto addressValue = reinterpret_cast<DWORD64>(address.GetValue());
+			auto function = process.functions_.upper_bound(addressValue);
+			if (function != process.functions_.begin() &&
+			    addressValue < std::prev(function)->first + std::prev(function)->second.length_)
+				process.armedAddresses_.insert(addressValue);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<DWORD64>
+	AdaptiveArming::GetArmedAddresses(HANDLE hProcess, DWORD64 address, uint64_t length) const
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it == processes_.end())
+			return {};
+
+		const auto& armedAddresses = it->second.armedAddresses_;
+		return {armedAddresses.lower_bound(address), armedAddresses.lower_bound(address + length)};
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<AdaptiveArming::HotFunction>
+	AdaptiveArming::OnHit(const Address& address, Clock::time_point now)
+	{
+		auto processIt = processes_.find(address.GetProcessHandle());
+
+		if (processIt == processes_.end())
+			return {};
+
+		auto& process = processIt->second;
+		// The budget was respected during the previous window.
+		if (now - process.windowStart_ >= window_)
+			StartWindow(process, now);
+
+		auto addressValue = reinterpret_cast<DWORD64>(address.GetValue());
+		process.armedAddresses_.erase(addressValue);
+		auto it = process.functions_.upper_bound(addressValue);
+		if (it != process.functions_.begin())
+		{
+			--it;
+			auto& function = it->second;
+			if (!function.isHot_ && addressValue < it->first + function.length_)
+			{
+				if (!function.windowHitCount_++)
+					process.windowFunctions_.push_back(it->first);
+			}
+		}
+
+		// A storm is handled as soon as the budget is exceeded.
+		if (++process.windowHitCount_ <= budgetByWindow_)
+			return {};
+
+		auto hitCount = process.windowHitCount_;
+		auto hitCounts = StartWindow(process, now);
+
+		// The hottest functions are coarsened first.
+		std::stable_sort(hitCounts.begin(), hitCounts.end(), [](const auto& first, const auto& second) {
+			return first.first > second.first;
+		});
+
+		std::vector<HotFunction> hotFunctions;
+		for (const auto& pair : hitCounts)
+		{
+			if (hitCount <= budgetByWindow_ || pair.first < MinHotHitCount)
+				break;
+			auto& function = process.functions_.at(pair.second);
+			function.isHot_ = true;
+			hotFunctions.push_back({processIt->first, pair.second, function.length_});
+			hitCount -= pair.first;
+		}
+		hotFunctionCount_ += hotFunctions.size();
+		return hotFunctions;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::pair<size_t, DWORD64>>
+	AdaptiveArming::StartWindow(Process& process, Clock::time_point now)
+	{
+		std::vector<std::pair<size_t, DWORD64>> hitCounts;
+
+		for (auto functionAddress : process.windowFunctions_)
+		{
+			auto it = process.functions_.find(functionAddress);
+			if (it != process.functions_.end())
+			{
+				hitCounts.emplace_back(it->second.windowHitCount_, functionAddress);
+				it->second.windowHitCount_ = 0;
+			}
+		}
+		process.windowFunctions_.clear();
+		process.windowHitCount_ = 0;
+		process.windowStart_ = now;
+		return hitCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	void AdaptiveArming::AddBlock(const Address& monitor, std::vector<DWORD64>&& addresses)
+	{
+		if (addresses.empty())
+			return;
+
+		auto processIt = processes_.find(monitor.GetProcessHandle());
+		if (processIt != processes_.end())
+		{
+			for (auto addressValue : addresses)
+				processIt->second.armedAddresses_.erase(addressValue);
+		}
+		++blockCount_;
+		blocks_[monitor] = std::move(addresses);
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<DWORD64> AdaptiveArming::TakeBlock(const Address& monitor)
+	{
+		auto it = blocks_.find(monitor);
+
+		if (it == blocks_.end())
+			return {};
+		auto addresses = std::move(it->second);
+		blocks_.erase(it);
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	void AdaptiveArming::OnUnloadModule(HANDLE hProcess, void* baseOfImage)
+	{
+		auto processIt = processes_.find(hProcess);
+
+		if (processIt == processes_.end())
+			return;
+
+		auto& functions = processIt->second.functions_;
+		// The blocks are inside the functions of their module.
+		for (auto it = blocks_.begin(); it != blocks_.end();)
+		{
+			auto function = functions.upper_bound(reinterpret_cast<DWORD64>(it->first.GetValue()));
+			if (it->first.GetProcessHandle() == hProcess && function != functions.begin() &&
+			    std::prev(function)->second.baseOfImage_ == baseOfImage)
+				it = blocks_.erase(it);
+			else
+				++it;
+		}
+
+		auto& armedAddresses = processIt->second.armedAddresses_;
+		for (auto it = functions.begin(); it != functions.end();)
+		{
+			if (it->second.baseOfImage_ == baseOfImage)
+			{
+				armedAddresses.erase(armedAddresses.lower_bound(it->first),
+				                     armedAddresses.lower_bound(it->first + it->second.length_));
+				it = functions.erase(it);
+			}
+			else
+				++it;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void AdaptiveArming::OnExitProcess(HANDLE hProcess)
+	{
+		processes_.erase(hProcess);
+		for (auto it = blocks_.begin(); it != blocks_.end();)
+		{
+			if (it->first.GetProcessHandle() == hProcess)
+				it = blocks_.erase(it);
+			else
+				++it;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	AdaptiveArming::Clock::duration AdaptiveArming::GetWindow() const
+	{
+		return window_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t AdaptiveArming::GetHotFunctionCount() const
+	{
+		return hotFunctionCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t AdaptiveArming::GetBlockCount() const
+	{
+		return blockCount_;
+	}
+}
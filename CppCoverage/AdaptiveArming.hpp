@@ -0,0 +1,108 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Find the functions whose breakpoints are hit too often. The hits are
+	// counted by process and by window: when more than
+	// maxTrapsPerSecond * window breakpoints of a process are hit, the
+	// functions with the most hits in the window become hot until the other
+	// hits fit in the budget. The remaining
+	// lines of a hot function can then be monitored by basic block: only
+	// the first armed address of a block keeps its breakpoint and the other
+	// armed addresses of the block are executed when it is hit.
+	class CPPCOVERAGE_DLL AdaptiveArming
+	{
+	  public:
+		using Clock = std::chrono::steady_clock;
+
+		AdaptiveArming(size_t maxTrapsPerSecond, Clock::time_point start);
+
+		struct HotFunction
+		{
+			HANDLE hProcess_;
+			DWORD64 address_;
+			uint64_t length_;
+		};
+
+		// functionRanges is the length of each function by address.
+		void AddFunctions(HANDLE hProcess,
+		                  void* baseOfImage,
+		                  const std::map<DWORD64, uint64_t>& functionRanges);
+
+		// The registered addresses whose breakpoint is set. An address is
+		// not armed anymore once hit or added to a block.
+		void AddArmedAddresses(HANDLE hProcess, const std::vector<Address>& addresses);
+		std::vector<DWORD64> GetArmedAddresses(HANDLE hProcess, DWORD64 address, uint64_t length) const;
+
+		// Return the functions which become hot, in the process of the
+		// address. A function is hot only once.
+		std::vector<HotFunction> OnHit(const Address&, Clock::time_point now);
+
+		// The addresses are executed when monitor is hit.
+		void AddBlock(const Address& monitor, std::vector<DWORD64>&& addresses);
+		std::vector<DWORD64> TakeBlock(const Address& monitor);
+
+		void OnUnloadModule(HANDLE hProcess, void* baseOfImage);
+		void OnExitProcess(HANDLE hProcess);
+
+		Clock::duration GetWindow() const;
+		size_t GetHotFunctionCount() const;
+		size_t GetBlockCount() const;
+
+	  private:
+		AdaptiveArming(const AdaptiveArming&) = delete;
+		AdaptiveArming& operator=(const AdaptiveArming&) = delete;
+
+		struct Function
+		{
+			uint64_t length_;
+			void* baseOfImage_;
+			size_t windowHitCount_;
+			bool isHot_;
+		};
+
+		struct Process
+		{
+			Clock::time_point windowStart_;
+			size_t windowHitCount_;
+			std::map<DWORD64, Function> functions_;
+			std::vector<DWORD64> windowFunctions_;
+			std::set<DWORD64> armedAddresses_;
+		};
+
+		// Return the hit count of the functions hit during the window.
+		std::vector<std::pair<size_t, DWORD64>> StartWindow(Process&, Clock::time_point now);
+
+		const Clock::duration window_;
+		const size_t budgetByWindow_;
+		const Clock::time_point start_;
+		std::map<HANDLE, Process> processes_;
+		std::map<Address, std::vector<DWORD64>> blocks_;
+		size_t hotFunctionCount_;
+		size_t blockCount_;
+	};
+}
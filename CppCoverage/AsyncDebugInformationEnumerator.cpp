@@ -0,0 +1,257 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "AsyncDebugInformationEnumerator.hpp"
+
+#include <algorithm>
+
+#include "Tools/Log.hpp"
+
+#include "TraceRecorder.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class SourceFileRecorder : public IDebugInformationHandler
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit SourceFileRecorder(std::vector<AsyncDebugInformationEnumerator::SourceFile>& sourceFiles)
+				: sourceFiles_{sourceFiles}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool IsSourceFileSelected(const std::filesystem::path&) override
+			{
+				return true;
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFile(const std::filesystem::path& path, const std::vector<Line>& lines) override
+			{
+				sourceFiles_.push_back({path, lines, checksum_});
+				checksum_ = {};
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFileChecksum(const std::filesystem::path&,
+			                          const Tools::SourceChecksum& checksum) override
+			{
+				checksum_ = checksum;
+			}
+
+		private:
+			std::vector<AsyncDebugInformationEnumerator::SourceFile>& sourceFiles_;
+			// The checksum of the next source file.
+			Tools::SourceChecksum checksum_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	bool AsyncDebugInformationEnumerator::EnumeratedModule::Replay(
+		IDebugInformationHandler& handler) const
+	{
+		if (error_)
+			std::rethrow_exception(error_);
+
+		for (const auto& sourceFile : sourceFiles_)
+		{
+			if (handler.IsSourceFileSelected(sourceFile.path_))
+			{
+				if (sourceFile.checksum_.type_ != Tools::SourceChecksum::Type::None)
+					handler.OnSourceFileChecksum(sourceFile.path_, sourceFile.checksum_);
+				handler.OnSourceFile(sourceFile.path_, sourceFile.lines_);
+			}
+		}
+		return isEnumerated_;
+	}
+
+	//-------------------------------------------------------------------------
+	AsyncDebugInformationEnumerator::AsyncDebugInformationEnumerator(
+		const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths,
+		std::shared_ptr<const PdbCache> pdbCache,
+		bool useNativePdbReader,
+		std::shared_ptr<SymbolPrefetcher> symbolPrefetcher,
+		std::shared_ptr<TraceRecorder> traceRecorder)
+		: debugInformationEnumerator_{substitutePdbSourcePaths,
+		                              std::move(pdbCache),
+		                              useNativePdbReader,
+		                              std::move(symbolPrefetcher)}
+		, traceRecorder_{std::move(traceRecorder)}
+		, currentProcess_{nullptr}
+		, currentBaseOfImage_{nullptr}
+		, isEnumerating_{false}
+		, isCurrentModuleCanceled_{false}
+		, isStopped_{false}
+	{
+		thread_ = std::thread{[this]() { EnumerateModules(); }};
+	}
+
+	//-------------------------------------------------------------------------
+	AsyncDebugInformationEnumerator::~AsyncDebugInformationEnumerator()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			isStopped_ = true;
+		}
+		condition_.notify_all();
+		thread_.join();
+	}
+
+	//-------------------------------------------------------------------------
+	void AsyncDebugInformationEnumerator::Enumerate(
+		HANDLE hProcess,
+		void* baseOfImage,
+		const std::filesystem::path& path)
+	{
+		EnumeratedModule module;
+
+		module.hProcess_ = hProcess;
+		module.baseOfImage_ = baseOfImage;
+		module.path_ = path;
+		module.loadTime_ = Clock::now();
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			pendingModules_.push_back(std::move(module));
+		}
+		condition_.notify_all();
+	}
+
+	//-------------------------------------------------------------------------
+	template <typename Predicate>
+	void AsyncDebugInformationEnumerator::Cancel(Predicate isCanceled)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		pendingModules_.erase(std::remove_if(pendingModules_.begin(), pendingModules_.end(), isCanceled),
+			pendingModules_.end());
+		enumeratedModules_.erase(std::remove_if(enumeratedModules_.begin(), enumeratedModules_.end(), isCanceled),
+			enumeratedModules_.end());
+
+		EnumeratedModule currentModule;
+		currentModule.hProcess_ = currentProcess_;
+		currentModule.baseOfImage_ = currentBaseOfImage_;
+		if (isEnumerating_ && isCanceled(currentModule))
+			isCurrentModuleCanceled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	void AsyncDebugInformationEnumerator::Cancel(HANDLE hProcess)
+	{
+		Cancel([=](const EnumeratedModule& module) { return module.hProcess_ == hProcess; });
+	}
+
+	//-------------------------------------------------------------------------
+	void AsyncDebugInformationEnumerator::Cancel(HANDLE hProcess, void* baseOfImage)
+	{
+		Cancel([=](const EnumeratedModule& module) {
+			return module.hProcess_ == hProcess && module.baseOfImage_ == baseOfImage;
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<AsyncDebugInformationEnumerator::EnumeratedModule>
+	AsyncDebugInformationEnumerator::TakeEnumeratedModules()
+	{
+		std::vector<EnumeratedModule> modules;
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		modules.swap(enumeratedModules_);
+		return modules;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<AsyncDebugInformationEnumerator::EnumeratedModule>
+	AsyncDebugInformationEnumerator::WaitForEnumeratedModules()
+	{
+		std::vector<EnumeratedModule> modules;
+		std::unique_lock<std::mutex> lock{mutex_};
+
+		condition_.wait(lock, [this]() { return pendingModules_.empty() && !isEnumerating_; });
+		modules.swap(enumeratedModules_);
+		return modules;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<AsyncDebugInformationEnumerator::EnumeratedModule>
+	AsyncDebugInformationEnumerator::WaitForEnumeratedModules(Clock::duration timeout)
+	{
+		std::vector<EnumeratedModule> modules;
+		std::unique_lock<std::mutex> lock{mutex_};
+
+		condition_.wait_for(lock, timeout, [this]() { return pendingModules_.empty() && !isEnumerating_; });
+		modules.swap(enumeratedModules_);
+		return modules;
+	}
+
+	//-------------------------------------------------------------------------
+	void AsyncDebugInformationEnumerator::EnumerateModule(
+		DebugInformationEnumerator& debugInformationEnumerator,
+		EnumeratedModule& module)
+	{
+		try
+		{
+			SourceFileRecorder sourceFileRecorder{module.sourceFiles_};
+			module.isEnumerated_ = debugInformationEnumerator.Enumerate(module.path_, sourceFileRecorder);
+		}
+		catch (...)
+		{
+			module.error_ = std::current_exception();
+		}
+		LOG_DEBUG << L"Debug information of " << module.path_.wstring() << L" enumerated.";
+	}
+
+	//-------------------------------------------------------------------------
+	void AsyncDebugInformationEnumerator::EnumerateModules()
+	{
+		if (traceRecorder_)
+			traceRecorder_->SetThreadName("Debug information reader");
+		for (;;)
+		{
+			EnumeratedModule module;
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				condition_.wait(lock, [this]() { return isStopped_ || !pendingModules_.empty(); });
+				if (isStopped_)
+					return;
+				module = std::move(pendingModules_.front());
+				pendingModules_.pop_front();
+				currentProcess_ = module.hProcess_;
+				currentBaseOfImage_ = module.baseOfImage_;
+				isEnumerating_ = true;
+				isCurrentModuleCanceled_ = false;
+			}
+
+			{
+				TraceRecorder::ScopedSpan span{
+				    traceRecorder_.get(), "Debug information read", "debug information", module.path_.wstring()};
+				EnumerateModule(debugInformationEnumerator_, module);
+			}
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				isEnumerating_ = false;
+				if (!isCurrentModuleCanceled_)
+					enumeratedModules_.push_back(std::move(module));
+			}
+			condition_.notify_all();
+		}
+	}
+}
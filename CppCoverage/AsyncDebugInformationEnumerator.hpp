@@ -0,0 +1,115 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+#include "DebugInformationEnumerator.hpp"
+
+namespace CppCoverage
+{
+	class TraceRecorder;
+
+	// Read the debug information of the modules from a background thread:
+	// the debug loop does not wait for DIA. All the source files are
+	// recorded and the handler selects them when the module is replayed on
+	// the debug loop thread.
+	class CPPCOVERAGE_DLL AsyncDebugInformationEnumerator
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct SourceFile
+		{
+			std::filesystem::path path_;
+			std::vector<IDebugInformationHandler::Line> lines_;
+			Tools::SourceChecksum checksum_;
+		};
+
+		struct EnumeratedModule
+		{
+			// Call the handler as DebugInformationEnumerator::Enumerate does
+			// and rethrow the error of the enumeration.
+			bool Replay(IDebugInformationHandler&) const;
+
+			HANDLE hProcess_ = nullptr;
+			void* baseOfImage_ = nullptr;
+			std::filesystem::path path_;
+			Clock::time_point loadTime_;
+			bool isEnumerated_ = false;
+			std::vector<SourceFile> sourceFiles_;
+			std::exception_ptr error_;
+		};
+
+		explicit AsyncDebugInformationEnumerator(
+		    const std::vector<SubstitutePdbSourcePath>&,
+		    std::shared_ptr<const PdbCache> = nullptr,
+		    bool useNativePdbReader = false,
+		    std::shared_ptr<SymbolPrefetcher> = nullptr,
+		    std::shared_ptr<TraceRecorder> = nullptr);
+		// Wait for the module currently enumerated: the pending ones are dropped.
+		~AsyncDebugInformationEnumerator();
+
+		void Enumerate(HANDLE hProcess, void* baseOfImage, const std::filesystem::path&);
+
+		// The modules of an exited process or an unloaded module are dropped.
+		void Cancel(HANDLE hProcess);
+		void Cancel(HANDLE hProcess, void* baseOfImage);
+
+		// Return the modules already enumerated without waiting.
+		std::vector<EnumeratedModule> TakeEnumeratedModules();
+		// Wait until all the modules are enumerated.
+		std::vector<EnumeratedModule> WaitForEnumeratedModules();
+		// Wait at most timeout and return the modules already enumerated.
+		std::vector<EnumeratedModule> WaitForEnumeratedModules(Clock::duration timeout);
+
+		// Enumerate module.path_ on the calling thread.
+		static void EnumerateModule(DebugInformationEnumerator&, EnumeratedModule&);
+
+	private:
+		AsyncDebugInformationEnumerator(const AsyncDebugInformationEnumerator&) = delete;
+		AsyncDebugInformationEnumerator& operator=(const AsyncDebugInformationEnumerator&) = delete;
+
+		template <typename Predicate>
+		void Cancel(Predicate);
+		void EnumerateModules();
+
+		DebugInformationEnumerator debugInformationEnumerator_;
+		const std::shared_ptr<TraceRecorder> traceRecorder_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::deque<EnumeratedModule> pendingModules_;
+		std::vector<EnumeratedModule> enumeratedModules_;
+		HANDLE currentProcess_;
+		void* currentBaseOfImage_;
+		bool isEnumerating_;
+		bool isCurrentModuleCanceled_;
+		bool isStopped_;
+		std::thread thread_;
+	};
+}
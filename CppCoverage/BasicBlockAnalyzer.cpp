@@ -0,0 +1,205 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "BasicBlockAnalyzer.hpp"
+
+#include <algorithm>
+
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	BasicBlockAnalyzer::BasicBlockAnalyzer(
+		const std::vector<unsigned char>& code,
+		uint64_t startAddress,
+		bool is64Bits)
+		: startAddress_{ startAddress }
+		, isAnalyzed_{ false }
+	{
+		isAnalyzed_ = Analyze(code, is64Bits);
+		if (!isAnalyzed_)
+		{
+			instructionStarts_.clear();
+			leaders_.clear();
+			jumpTargets_.clear();
+			basicBlocks_.clear();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool BasicBlockAnalyzer::Analyze(const std::vector<unsigned char>& code, bool is64Bits)
+	{
+		auto endAddress = startAddress_ + code.size();
+		std::vector<uint64_t> targets;
+		std::vector<Instruction> instructions;
+		size_t offset = 0;
+
+		leaders_.push_back(startAddress_);
+		while (offset < code.size())
+		{
+			auto address = startAddress_ + offset;
+			auto instruction = DecodeInstruction(
+				&code[offset], code.size() - offset, address, is64Bits);
+
+			if (!instruction || instruction->flow_ == InstructionFlow::IndirectJump)
+				return false;
+
+			instructionStarts_.push_back(address);
+			offset += instruction->length_;
+			instructions.push_back(
+			    {address, startAddress_ + offset, instruction->flow_, instruction->target_});
+
+			const auto& target = instruction->target_;
+			if (target && *target >= startAddress_ && *target < endAddress)
+				targets.push_back(*target);
+
+			// A call can throw an exception so the next instruction may never run.
+			if (instruction->flow_ != InstructionFlow::Sequential)
+				leaders_.push_back(startAddress_ + offset);
+		}
+
+		for (auto target : targets)
+		{
+			// Jump in the middle of an instruction.
+			if (!IsInstructionStart(target))
+				return false;
+			leaders_.push_back(target);
+		}
+		std::sort(leaders_.begin(), leaders_.end());
+		leaders_.erase(std::unique(leaders_.begin(), leaders_.end()), leaders_.end());
+		std::sort(targets.begin(), targets.end());
+		targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+		jumpTargets_ = std::move(targets);
+		ComputeBasicBlocks(instructions, endAddress);
+
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void BasicBlockAnalyzer::ComputeBasicBlocks(
+		const std::vector<Instruction>& instructions,
+		uint64_t endAddress)
+	{
+		// The leader after the last instruction does not start a block.
+		for (auto leader : leaders_)
+		{
+			if (leader < endAddress)
+				basicBlocks_.push_back({ leader, {}, false });
+		}
+
+		size_t index = 0;
+		for (const auto& instruction : instructions)
+		{
+			auto nextAddress = instruction.nextAddress_;
+			if (index + 1 < basicBlocks_.size() && basicBlocks_[index + 1].address_ == instruction.address_)
+				++index;
+
+			auto isLastInstruction = nextAddress == endAddress ||
+			                         (index + 1 < basicBlocks_.size() &&
+			                          basicBlocks_[index + 1].address_ == nextAddress);
+			if (!isLastInstruction)
+				continue;
+
+			auto& basicBlock = basicBlocks_[index];
+			auto addNextBlock = [&]() {
+				if (nextAddress < endAddress)
+					basicBlock.successors_.push_back(index + 1);
+				else
+					basicBlock.isExit_ = true;
+			};
+			auto addTargetBlock = [&]() {
+				boost::optional<size_t> targetIndex;
+				if (instruction.target_)
+					targetIndex = FindBasicBlock(*instruction.target_);
+				if (targetIndex)
+					basicBlock.successors_.push_back(*targetIndex);
+				else
+					basicBlock.isExit_ = true;
+			};
+
+			switch (instruction.flow_)
+			{
+				case InstructionFlow::Sequential:
+					addNextBlock();
+					break;
+				case InstructionFlow::ConditionalJump:
+					addNextBlock();
+					addTargetBlock();
+					break;
+				case InstructionFlow::Jump:
+					addTargetBlock();
+					break;
+				case InstructionFlow::Call:
+					addNextBlock();
+					basicBlock.isExit_ = true;
+					break;
+				default:
+					basicBlock.isExit_ = true;
+					break;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool BasicBlockAnalyzer::IsAnalyzed() const
+	{
+		return isAnalyzed_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool BasicBlockAnalyzer::IsInSameBasicBlock(uint64_t first, uint64_t second) const
+	{
+		if (!isAnalyzed_ || first >= second)
+			return false;
+		if (!IsInstructionStart(first) || !IsInstructionStart(second))
+			return false;
+
+		auto it = std::upper_bound(leaders_.begin(), leaders_.end(), first);
+
+		return it == leaders_.end() || *it > second;
+	}
+
+	//-------------------------------------------------------------------------
+	bool BasicBlockAnalyzer::IsInstructionStart(uint64_t address) const
+	{
+		return std::binary_search(instructionStarts_.begin(), instructionStarts_.end(), address);
+	}
+
+	//-------------------------------------------------------------------------
+	bool BasicBlockAnalyzer::IsJumpTarget(uint64_t address) const
+	{
+		return std::binary_search(jumpTargets_.begin(), jumpTargets_.end(), address);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<BasicBlockAnalyzer::BasicBlock>& BasicBlockAnalyzer::GetBasicBlocks() const
+	{
+		return basicBlocks_;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> BasicBlockAnalyzer::FindBasicBlock(uint64_t address) const
+	{
+		if (!IsInstructionStart(address))
+			return boost::none;
+
+		auto it = std::upper_bound(basicBlocks_.begin(), basicBlocks_.end(), address,
+			[](uint64_t value, const BasicBlock& basicBlock) { return value < basicBlock.address_; });
+
+		return static_cast<size_t>(it - basicBlocks_.begin()) - 1;
+	}
+}
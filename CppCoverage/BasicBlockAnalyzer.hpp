@@ -0,0 +1,85 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+#include "InstructionDecoder.hpp"
+
+namespace CppCoverage
+{
+	class CPPCOVERAGE_DLL BasicBlockAnalyzer
+	{
+	public:
+		BasicBlockAnalyzer(
+			const std::vector<unsigned char>& code,
+			uint64_t startAddress,
+			bool is64Bits);
+
+		// Return false if the code cannot be fully decoded or contains
+		// jumps with unknown targets.
+		bool IsAnalyzed() const;
+
+		// Return true if running the instruction at first always leads to run the
+		// instruction at second without any jump, call or jump target in between.
+		bool IsInSameBasicBlock(uint64_t first, uint64_t second) const;
+		bool IsInstructionStart(uint64_t) const;
+		// Return true if a jump of the function goes to the address.
+		bool IsJumpTarget(uint64_t) const;
+
+		struct BasicBlock
+		{
+			uint64_t address_;
+			// Indexes of the basic blocks which can run next.
+			std::vector<size_t> successors_;
+			// True if the function can be left from the end of the block: a
+			// return, a jump outside of the function or a call which can throw.
+			bool isExit_;
+		};
+
+		// The first basic block is the function entry. Empty if the code is
+		// not analyzed.
+		const std::vector<BasicBlock>& GetBasicBlocks() const;
+		// Index of the basic block of the instruction at address.
+		boost::optional<size_t> FindBasicBlock(uint64_t address) const;
+
+	private:
+		BasicBlockAnalyzer(const BasicBlockAnalyzer&) = delete;
+		BasicBlockAnalyzer& operator=(const BasicBlockAnalyzer&) = delete;
+
+		struct Instruction
+		{
+			uint64_t address_;
+			uint64_t nextAddress_;
+			InstructionFlow flow_;
+			boost::optional<uint64_t> target_;
+		};
+
+		bool Analyze(const std::vector<unsigned char>& code, bool is64Bits);
+		void ComputeBasicBlocks(const std::vector<Instruction>&, uint64_t endAddress);
+
+		const uint64_t startAddress_;
+		std::vector<uint64_t> instructionStarts_;
+		std::vector<uint64_t> leaders_;
+		std::vector<uint64_t> jumpTargets_;
+		std::vector<BasicBlock> basicBlocks_;
+		bool isAnalyzed_;
+	};
+}
@@ -19,6 +19,8 @@
 
 #include "CppCoverageException.hpp"
 #include "Address.hpp"
+#include "EtwProvider.hpp"
+#include "LiveCounters.hpp"
 
 #include "Tools/Log.hpp"
 #include "Tools/ProcessMemory.hpp"
@@ -27,12 +29,77 @@ namespace CppCoverage
 {
 	using Addresses = std::vector<DWORD64>;
 	using AddressesIt = Addresses::const_iterator;
+	using InstructionsIt = BreakPoint::InstructionCollection::const_iterator;
+
+	namespace
+	{
+		const DWORD64 LegacyRangeSize = 4096;
+
+		//---------------------------------------------------------------------
+		DWORD64 GetSystemPageSize()
+		{
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			return systemInfo.dwPageSize;
+		}
+
+		//---------------------------------------------------------------------
+		// Number of system calls done before addresses were deduplicated
+		// and batched by pages: one read, one write and one flush by range
+		// of 4096 bytes and one write and one flush for each duplicate.
+		size_t ComputeLegacySystemCallCount(const Addresses& sortedAddresses,
+		                                    bool writeBreakPoints)
+		{
+			if (sortedAddresses.empty())
+				return 0;
+
+			size_t rangeCount = 1;
+			size_t duplicateCount = 0;
+			auto beginRange = sortedAddresses.front();
+
+			for (size_t i = 1; i < sortedAddresses.size(); ++i)
+			{
+				if (sortedAddresses[i] == sortedAddresses[i - 1])
+					++duplicateCount;
+				if (sortedAddresses[i] - beginRange > LegacyRangeSize)
+				{
+					++rangeCount;
+					beginRange = sortedAddresses[i];
+				}
+			}
+
+			if (!writeBreakPoints)
+				return rangeCount;
+			return rangeCount * 3 + duplicateCount * 2;
+		}
+
+		//---------------------------------------------------------------------
+		// The breakpoints between the restored addresses are kept as the
+		// whole range is written.
+		void RestoreInstructionsRange(HANDLE hProcess,
+		                              InstructionsIt begin,
+		                              InstructionsIt end)
+		{
+			auto firstValue = begin->second;
+			auto memorySpaceSize =
+			    (end - 1)->second - firstValue + sizeof(BreakPoint::breakPointInstruction);
+			auto firstAddress = reinterpret_cast<void*>(firstValue);
+			auto buffer = Tools::ReadProcessMemory(
+			    hProcess, firstAddress, static_cast<size_t>(memorySpaceSize));
+
+			for (auto it = begin; it < end; ++it)
+				buffer[static_cast<size_t>(it->second - firstValue)] = it->first;
+			Tools::WriteProcessMemory(
+			    hProcess, firstAddress, &buffer[0], buffer.size(), false);
+		}
+	}
 
 	//-------------------------------------------------------------------------
 	void SetBreakPointsRange(HANDLE hProcess,
 	                         AddressesIt begin,
 	                         AddressesIt end,
-	                         BreakPoint::InstructionCollection& oldInstructions)
+	                         BreakPoint::InstructionCollection& oldInstructions,
+	                         bool writeBreakPoints)
 	{
 		if (begin == end)
 			return;
@@ -51,35 +118,185 @@ namespace CppCoverage
 			buffer[index] = BreakPoint::breakPointInstruction;
 			oldInstructions.emplace_back(oldInstruction, *it);
 		}
-		Tools::WriteProcessMemory(
-		    hProcess, firstAddress, &buffer[0], buffer.size());
+		if (writeBreakPoints)
+		{
+			Tools::WriteProcessMemory(
+			    hProcess, firstAddress, &buffer[0], buffer.size(), false);
+		}
 	}
 
 	const unsigned char BreakPoint::breakPointInstruction = 0xCC;
 
+	//-------------------------------------------------------------------------
+	BreakPoint::BreakPoint()
+	    : pageSize_{GetSystemPageSize()},
+	      systemCallCount_{0},
+	      savedSystemCallCount_{0},
+	      armedBreakPointCount_{0},
+	      processingTime_{std::chrono::steady_clock::duration::zero()}
+	{
+	}
+
 	//-------------------------------------------------------------------------
 	BreakPoint::InstructionCollection
-	BreakPoint::SetBreakPoints(HANDLE hProcess, Addresses&& addresses) const
+	BreakPoint::SetBreakPoints(HANDLE hProcess, Addresses&& addresses)
+	{
+		return ProcessBreakPoints(hProcess, std::move(addresses), true);
+	}
+
+	//-------------------------------------------------------------------------
+	BreakPoint::InstructionCollection
+	BreakPoint::ReadInstructions(HANDLE hProcess, Addresses&& addresses)
+	{
+		return ProcessBreakPoints(hProcess, std::move(addresses), false);
+	}
+
+	//-------------------------------------------------------------------------
+	BreakPoint::InstructionCollection
+	BreakPoint::ProcessBreakPoints(HANDLE hProcess,
+	                               Addresses&& addresses,
+	                               bool writeBreakPoints)
 	{
 		InstructionCollection oldInstructions;
+		auto start = std::chrono::steady_clock::now();
 
 		std::sort(addresses.begin(), addresses.end());
-		auto beginRange = addresses.cbegin();
+		auto legacySystemCallCount =
+		    ComputeLegacySystemCallCount(addresses, writeBreakPoints);
+		addresses.erase(std::unique(addresses.begin(), addresses.end()),
+		                addresses.end());
+		if (addresses.empty())
+			return oldInstructions;
 
-		for (auto it = beginRange; it < addresses.cend(); ++it)
+		// One read and one write by run of contiguous pages.
+		size_t systemCallCount = 0;
+		auto beginRange = addresses.cbegin();
+		for (auto it = beginRange + 1; it < addresses.cend(); ++it)
 		{
-			if (*it - *beginRange > 4096)
+			if (GetPageAddress(*it) - GetPageAddress(*(it - 1)) > pageSize_)
 			{
-				SetBreakPointsRange(hProcess, beginRange, it, oldInstructions);
+				SetBreakPointsRange(hProcess, beginRange, it, oldInstructions, writeBreakPoints);
+				systemCallCount += writeBreakPoints ? 2 : 1;
 				beginRange = it;
 			}
 		}
 		SetBreakPointsRange(
-		    hProcess, beginRange, addresses.end(), oldInstructions);
+		    hProcess, beginRange, addresses.cend(), oldInstructions, writeBreakPoints);
+		systemCallCount += writeBreakPoints ? 2 : 1;
 
+		if (writeBreakPoints)
+		{
+			auto firstAddress = addresses.front();
+			auto size = addresses.back() - firstAddress +
+			            sizeof(breakPointInstruction);
+			if (!FlushInstructionCache(hProcess,
+			                           reinterpret_cast<void*>(firstAddress),
+			                           static_cast<SIZE_T>(size)))
+			{
+				THROW_LAST_ERROR("Cannot flush instruction cache", GetLastError());
+			}
+			++systemCallCount;
+		}
+
+		systemCallCount_ += systemCallCount;
+		if (legacySystemCallCount > systemCallCount)
+			savedSystemCallCount_ += legacySystemCallCount - systemCallCount;
+		auto processingTime = std::chrono::steady_clock::now() - start;
+		if (writeBreakPoints)
+		{
+			armedBreakPointCount_ += addresses.size();
+			EtwProvider::OnBreakPointsWritten(hProcess, addresses.size(), processingTime);
+			if (liveCounters_)
+				liveCounters_->AddArmedBreakPoints(addresses.size());
+		}
+		processingTime_ += processingTime;
 		return oldInstructions;
 	}
 
+	//-------------------------------------------------------------------------
+	void BreakPoint::RemoveBreakPoints(HANDLE hProcess,
+	                                   InstructionCollection&& oldInstructions)
+	{
+		auto start = std::chrono::steady_clock::now();
+		auto isAddressLess = [](const auto& a, const auto& b) { return a.second < b.second; };
+		auto isAddressEqual = [](const auto& a, const auto& b) { return a.second == b.second; };
+
+		std::sort(oldInstructions.begin(), oldInstructions.end(), isAddressLess);
+		oldInstructions.erase(
+		    std::unique(oldInstructions.begin(), oldInstructions.end(), isAddressEqual),
+		    oldInstructions.end());
+		if (oldInstructions.empty())
+			return;
+
+		// One read and one write by run of contiguous pages.
+		size_t systemCallCount = 0;
+		auto beginRange = oldInstructions.cbegin();
+		for (auto it = beginRange + 1; it < oldInstructions.cend(); ++it)
+		{
+			if (GetPageAddress(it->second) - GetPageAddress((it - 1)->second) > pageSize_)
+			{
+				RestoreInstructionsRange(hProcess, beginRange, it);
+				systemCallCount += 2;
+				beginRange = it;
+			}
+		}
+		RestoreInstructionsRange(hProcess, beginRange, oldInstructions.cend());
+		systemCallCount += 2;
+
+		auto firstAddress = oldInstructions.front().second;
+		auto size = oldInstructions.back().second - firstAddress + sizeof(breakPointInstruction);
+		if (!FlushInstructionCache(hProcess,
+		                           reinterpret_cast<void*>(firstAddress),
+		                           static_cast<SIZE_T>(size)))
+		{
+			THROW_LAST_ERROR("Cannot flush instruction cache", GetLastError());
+		}
+		++systemCallCount;
+
+		// RemoveBreakPoint writes and flushes each address.
+		auto legacySystemCallCount = oldInstructions.size() * 2;
+		systemCallCount_ += systemCallCount;
+		if (legacySystemCallCount > systemCallCount)
+			savedSystemCallCount_ += legacySystemCallCount - systemCallCount;
+		processingTime_ += std::chrono::steady_clock::now() - start;
+	}
+
+	//-------------------------------------------------------------------------
+	DWORD64 BreakPoint::GetPageAddress(DWORD64 address) const
+	{
+		return address & ~(pageSize_ - 1);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t BreakPoint::GetSystemCallCount() const
+	{
+		return systemCallCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t BreakPoint::GetSavedSystemCallCount() const
+	{
+		return savedSystemCallCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t BreakPoint::GetArmedBreakPointCount() const
+	{
+		return armedBreakPointCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::chrono::steady_clock::duration BreakPoint::GetProcessingTime() const
+	{
+		return processingTime_;
+	}
+
+	//-------------------------------------------------------------------------
+	void BreakPoint::SetLiveCounters(std::shared_ptr<LiveCounters> liveCounters)
+	{
+		liveCounters_ = std::move(liveCounters);
+	}
+
 	//-------------------------------------------------------------------------
 	void BreakPoint::RemoveBreakPoint(const Address& address,
 	                                  unsigned char oldInstruction) const
@@ -91,10 +308,27 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	void BreakPoint::AdjustEipAfterBreakPointRemoval(HANDLE hThread) const
+	void BreakPoint::AdjustEipAfterBreakPointRemoval(HANDLE hProcess, HANDLE hThread)
 	{
+#ifdef _WIN64
+		if (IsWow64Process(hProcess))
+		{
+			WOW64_CONTEXT wow64Context;
+			wow64Context.ContextFlags = WOW64_CONTEXT_CONTROL;
+			if (!Wow64GetThreadContext(hThread, &wow64Context))
+				THROW_LAST_ERROR("Error in Wow64GetThreadContext", GetLastError());
+
+			--wow64Context.Eip; // Move back one byte
+			if (!Wow64SetThreadContext(hThread, &wow64Context))
+				THROW_LAST_ERROR("Error in Wow64SetThreadContext", GetLastError());
+			return;
+		}
+#else
+		(void)hProcess;
+#endif
 		CONTEXT lcContext;
-		lcContext.ContextFlags = CONTEXT_ALL;
+		// Only the instruction pointer is needed: avoid transferring the full context.
+		lcContext.ContextFlags = CONTEXT_CONTROL;
 		if (!GetThreadContext(hThread, &lcContext))
 			THROW_LAST_ERROR("Error in GetThreadContext", GetLastError());
 
@@ -106,4 +340,25 @@ namespace CppCoverage
 		if (!SetThreadContext(hThread, &lcContext))
 			THROW_LAST_ERROR("Error in SetThreadContext", GetLastError());
 	}
+
+	//-------------------------------------------------------------------------
+	void BreakPoint::OnExitProcess(HANDLE hProcess)
+	{
+		isWow64ByProcess_.erase(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	bool BreakPoint::IsWow64Process(HANDLE hProcess)
+	{
+		auto it = isWow64ByProcess_.find(hProcess);
+
+		if (it == isWow64ByProcess_.end())
+		{
+			BOOL isWow64 = FALSE;
+			if (!::IsWow64Process(hProcess, &isWow64))
+				THROW_LAST_ERROR("Error in IsWow64Process", GetLastError());
+			it = isWow64ByProcess_.emplace(hProcess, isWow64 != FALSE).first;
+		}
+		return it->second;
+	}
 }
@@ -17,16 +17,20 @@
 #pragma once
 
 #include <Windows.h>
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 #include "CppCoverageExport.hpp"
 
 namespace CppCoverage
 {
 	class Address;
+	class LiveCounters;
 
 	class CPPCOVERAGE_DLL BreakPoint
 	{
 	  public:
-		BreakPoint() = default;
+		BreakPoint();
 
 		static const unsigned char breakPointInstruction;
 
@@ -36,13 +40,56 @@ namespace CppCoverage
 		using InstructionCollection =
 		    std::vector<std::pair<unsigned char, DWORD64>>;
 
+		// Duplicated addresses are ignored. Addresses on contiguous pages are
+		// read and written at once and the instruction cache is flushed once.
 		InstructionCollection
-		SetBreakPoints(HANDLE hProcess, std::vector<DWORD64>&& addresses) const;
+		SetBreakPoints(HANDLE hProcess, std::vector<DWORD64>&& addresses);
 
-		void AdjustEipAfterBreakPointRemoval(HANDLE hThread) const;
+		// Same as SetBreakPoints but the process memory is not modified.
+		InstructionCollection
+		ReadInstructions(HANDLE hProcess, std::vector<DWORD64>&& addresses);
+
+		// Restore the instructions returned by SetBreakPoints. Addresses on
+		// contiguous pages are restored at once like SetBreakPoints.
+		void RemoveBreakPoints(HANDLE hProcess, InstructionCollection&& oldInstructions);
+
+		// The 32 bits context of the thread is used for a WOW64 process.
+		void AdjustEipAfterBreakPointRemoval(HANDLE hProcess, HANDLE hThread);
+		void OnExitProcess(HANDLE hProcess);
+
+		// Number of system calls done by SetBreakPoints, ReadInstructions and
+		// RemoveBreakPoints.
+		size_t GetSystemCallCount() const;
+
+		// Estimation of the system calls saved compared to setting
+		// breakpoints by ranges of 4096 bytes without deduplication and to
+		// removing them one by one.
+		size_t GetSavedSystemCallCount() const;
+
+		// Number of breakpoints written by SetBreakPoints and time spent
+		// by SetBreakPoints and ReadInstructions.
+		size_t GetArmedBreakPointCount() const;
+		std::chrono::steady_clock::duration GetProcessingTime() const;
+
+		// Add the breakpoints written by SetBreakPoints to liveCounters.
+		void SetLiveCounters(std::shared_ptr<LiveCounters>);
 
 	  private:
 		BreakPoint(const BreakPoint&) = delete;
 		BreakPoint& operator=(const BreakPoint&) = delete;
+
+		InstructionCollection ProcessBreakPoints(HANDLE hProcess,
+		                                         std::vector<DWORD64>&& addresses,
+		                                         bool writeBreakPoints);
+		DWORD64 GetPageAddress(DWORD64 address) const;
+		bool IsWow64Process(HANDLE hProcess);
+
+		const DWORD64 pageSize_;
+		size_t systemCallCount_;
+		size_t savedSystemCallCount_;
+		size_t armedBreakPointCount_;
+		std::chrono::steady_clock::duration processingTime_;
+		std::shared_ptr<LiveCounters> liveCounters_;
+		std::unordered_map<HANDLE, bool> isWow64ByProcess_;
 	};
 }
@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "ChildProcessFilter.hpp"
+
+#include <algorithm>
+
+#include "Tools/Log.hpp"
+
+#include "Patterns.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::vector<Wildcards> BuildWildcards(
+			const Patterns::T_Patterns& patterns,
+			bool isRegexCaseSensitiv)
+		{
+			std::vector<Wildcards> wildcardsCollection;
+
+			for (const auto& pattern : patterns)
+				wildcardsCollection.emplace_back(pattern, isRegexCaseSensitiv);
+			return wildcardsCollection;
+		}
+
+		//---------------------------------------------------------------------
+		bool MatchAny(
+			const std::wstring& str,
+			const std::vector<Wildcards>& wildcardsCollection)
+		{
+			return std::any_of(wildcardsCollection.begin(), wildcardsCollection.end(),
+				[&](const auto& wildcards) { return wildcards.Match(str); });
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	ChildProcessFilter::ChildProcessFilter(const Patterns& patterns)
+		: selectedWildcards_{BuildWildcards(patterns.GetSelectedPatterns(), patterns.IsRegexCaseSensitiv())}
+		, excludedWildcards_{BuildWildcards(patterns.GetExcludedPatterns(), patterns.IsRegexCaseSensitiv())}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool ChildProcessFilter::IsChildSelected(const std::wstring& filename) const
+	{
+		bool isSelected = MatchAny(filename, selectedWildcards_) &&
+			!MatchAny(filename, excludedWildcards_);
+
+		if (isSelected)
+			LOG_INFO << L"Child process: " << filename << L" is selected.";
+		else
+			LOG_INFO << L"Child process: " << filename << L" is skipped and detached.";
+		return isSelected;
+	}
+}
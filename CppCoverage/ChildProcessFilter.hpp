@@ -0,0 +1,45 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+#include "Wildcards.hpp"
+
+namespace CppCoverage
+{
+	class Patterns;
+
+	// Select the children processes to cover from the path of their executable.
+	class CPPCOVERAGE_DLL ChildProcessFilter
+	{
+	public:
+		explicit ChildProcessFilter(const Patterns&);
+
+		bool IsChildSelected(const std::wstring& filename) const;
+
+	private:
+		ChildProcessFilter(const ChildProcessFilter&) = delete;
+		ChildProcessFilter& operator=(const ChildProcessFilter&) = delete;
+
+		std::vector<Wildcards> selectedWildcards_;
+		std::vector<Wildcards> excludedWildcards_;
+	};
+}
@@ -17,8 +17,16 @@
 #include "stdafx.h"
 #include "CodeCoverageRunner.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <sstream>
+#include <Psapi.h>
+#include <TlHelp32.h>
+#include <DbgHelp.h>
 #include <boost/optional.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include "tools/Log.hpp"
 
@@ -36,18 +44,376 @@
 #include "MonitoredLineRegister.hpp"
 #include "FilterAssistant.hpp"
 #include "FileSystem.hpp"
+#include "Process.hpp"
+#include "InProcessAgent.hpp"
+#include "HitSampler.hpp"
+#include "AdaptiveArming.hpp"
+#include "BasicBlockAnalyzer.hpp"
+#include "SaturationDetector.hpp"
+#include "ChildProcessFilter.hpp"
+#include "DebugEventsRecorder.hpp"
+#include "DebugEventsReplayer.hpp"
+#include "DebugStringWriter.hpp"
+#include "AsyncDebugInformationEnumerator.hpp"
+#include "DebugInformationCache.hpp"
+#include "ModuleLoadHistory.hpp"
+#include "SymbolPrefetcher.hpp"
+#include "CoverageRegion.hpp"
+#include "TestImpactIndex.hpp"
+#include "CoverageJournal.hpp"
+#include "CoverageSummary.hpp"
+#include "ICoverageSource.hpp"
+#include "PerformanceStatistics.hpp"
+#include "TraceRecorder.hpp"
+#include "EtwProvider.hpp"
+#include "LiveCounters.hpp"
+#include "FuzzingBitmap.hpp"
+#include "IntelPtCollector.hpp"
+#include "TrampolineInstrumentation.hpp"
+#include "EtwSampler.hpp"
+#include "SampledAddressMapper.hpp"
+#include "ICoverageObserver.hpp"
+#include "PdbReference.hpp"
 
 #include "Tools/WarningManager.hpp"
 #include "Tools/Tool.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/ProcessMemory.hpp"
 
 namespace CppCoverage
 {
+	namespace
+	{
+		const wchar_t* NoDebugHeapVariable = L"_NO_DEBUG_HEAP";
+		const std::chrono::seconds ProgressNotificationPeriod{1};
+		const std::chrono::seconds TrampolineCountersReadPeriod{1};
+		// Wait for the samples taken before an unload or an exit.
+		const std::chrono::milliseconds SampleFlushTimeout{500};
+
+		//---------------------------------------------------------------------
+		// A process started by a debugger uses the debug heap which makes the
+		// allocations much slower. A value set by the user is kept.
+		bool DisableDebugHeap(StartInfo& startInfo)
+		{
+			if (GetEnvironmentVariableW(NoDebugHeapVariable, nullptr, 0))
+				return false;
+			startInfo.AddEnvironmentVariable(NoDebugHeapVariable, L"1");
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		void AddDebuggerStatistics(PerformanceStatistics& performanceStatistics,
+		                           const DebugEventStatistics& statistics,
+		                           size_t armedBreakPointCount,
+		                           std::chrono::steady_clock::duration breakPointProcessingTime)
+		{
+			const std::pair<DWORD, const char*> debugEventNames[] = {
+				{EXCEPTION_DEBUG_EVENT, "exception"},
+				{CREATE_THREAD_DEBUG_EVENT, "create thread"},
+				{CREATE_PROCESS_DEBUG_EVENT, "create process"},
+				{EXIT_THREAD_DEBUG_EVENT, "exit thread"},
+				{EXIT_PROCESS_DEBUG_EVENT, "exit process"},
+				{LOAD_DLL_DEBUG_EVENT, "load dll"},
+				{UNLOAD_DLL_DEBUG_EVENT, "unload dll"},
+				{OUTPUT_DEBUG_STRING_EVENT, "output debug string"},
+				{RIP_EVENT, "rip"}};
+			auto handlingTime = statistics.GetHandlingTime();
+
+			performanceStatistics.AddPhase("Debug loop: waiting for events",
+			                               statistics.GetElapsedTime() - handlingTime);
+			performanceStatistics.AddPhase("Debug loop: handling events", handlingTime);
+			performanceStatistics.AddPhase("Breakpoint writes", breakPointProcessingTime);
+			auto getEventName = [&](DWORD debugEventCode, bool isBreakPoint) -> std::string {
+				if (isBreakPoint)
+					return "breakpoint";
+				for (const auto& debugEventName : debugEventNames)
+				{
+					if (debugEventName.first == debugEventCode)
+						return debugEventName.second;
+				}
+				return "unknown";
+			};
+			for (const auto& debugEventName : debugEventNames)
+			{
+				auto eventCount = statistics.GetEventCount(debugEventName.first);
+
+				performanceStatistics.AddCounter(
+				    PerformanceStatistics::DebugEventsCounterPrefix + debugEventName.second, eventCount);
+				if (eventCount)
+				{
+					performanceStatistics.AddDebuggeeStall(
+					    {debugEventName.second, L"", statistics.GetHandlingTime(debugEventName.first), eventCount});
+				}
+			}
+			for (const auto& dllLoadTime : statistics.GetDllLoadTimes())
+			{
+				performanceStatistics.AddDebuggeeStall(
+				    {getEventName(LOAD_DLL_DEBUG_EVENT, false), dllLoadTime.first,
+				     dllLoadTime.second.first, dllLoadTime.second.second});
+			}
+			for (const auto& stall : statistics.GetLongestStalls())
+			{
+				performanceStatistics.AddLongestDebuggeeStall(
+				    {getEventName(stall.debugEventCode_, stall.isBreakPoint_), stall.modulePath_, stall.time_, 1});
+			}
+			const auto& histogram = statistics.GetBreakPointHistogram();
+			performanceStatistics.AddBreakPointStallHistogram({histogram.begin(), histogram.end()});
+			performanceStatistics.AddCounter(PerformanceStatistics::ArmedBreakPointsCounter, armedBreakPointCount);
+			performanceStatistics.AddCounter(PerformanceStatistics::HitBreakPointsCounter, statistics.GetBreakPointCount());
+		}
+
+		//---------------------------------------------------------------------
+		uintmax_t GetPdbSize(const std::filesystem::path& modulePath)
+		{
+			std::error_code error;
+			auto pdbReference = PdbReference::Read(modulePath);
+			auto pdbPath = std::filesystem::path{modulePath}.replace_extension(L".pdb");
+
+			if (pdbReference && std::filesystem::is_regular_file(pdbReference->pdbPath_, error))
+				pdbPath = pdbReference->pdbPath_;
+			auto size = std::filesystem::file_size(pdbPath, error);
+			return error ? 0 : size;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<HANDLE> SuspendThreads(DWORD processId)
+		{
+			auto hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPTHREAD, 0);
+			if (hSnapshot == INVALID_HANDLE_VALUE)
+				THROW_LAST_ERROR("Error in CreateToolhelp32Snapshot:", GetLastError());
+			Tools::ScopedAction closeSnapshot{[=]() { CloseHandle(hSnapshot); }};
+
+			std::vector<HANDLE> threads;
+			THREADENTRY32 threadEntry{};
+			threadEntry.dwSize = sizeof(threadEntry);
+			for (auto hasThread = Thread32First(hSnapshot, &threadEntry); hasThread;
+			     hasThread = Thread32Next(hSnapshot, &threadEntry))
+			{
+				if (threadEntry.th32OwnerProcessID != processId)
+					continue;
+				auto hThread = OpenThread(THREAD_SUSPEND_RESUME, FALSE, threadEntry.th32ThreadID);
+				if (!hThread)
+					continue; // The thread has already exited.
+				if (SuspendThread(hThread) == static_cast<DWORD>(-1))
+					CloseHandle(hThread);
+				else
+					threads.push_back(hThread);
+			}
+			return threads;
+		}
+
+		//---------------------------------------------------------------------
+		void ResumeThreads(const std::vector<HANDLE>& threads)
+		{
+			for (auto hThread : threads)
+			{
+				if (ResumeThread(hThread) == static_cast<DWORD>(-1))
+					LOG_ERROR << L"Cannot resume thread: " << GetLastError();
+				CloseHandle(hThread);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Return the static imports found in the folder of the executable:
+		// the system modules are usually not covered.
+		std::vector<std::filesystem::path>
+		GetLocalStaticImports(const std::filesystem::path& path)
+		{
+			std::vector<std::filesystem::path> imports;
+			auto hModule = LoadLibraryExW(path.c_str(), nullptr, LOAD_LIBRARY_AS_IMAGE_RESOURCE);
+
+			if (!hModule)
+				return imports;
+			Tools::ScopedAction freeLibrary{[=]() { FreeLibrary(hModule); }};
+
+			// The low bits of the handle tell how the module is mapped.
+			auto base = reinterpret_cast<char*>(
+			    reinterpret_cast<uintptr_t>(hModule) & ~static_cast<uintptr_t>(3));
+			ULONG size = 0;
+			auto descriptor = static_cast<const IMAGE_IMPORT_DESCRIPTOR*>(ImageDirectoryEntryToDataEx(
+			    base, TRUE, IMAGE_DIRECTORY_ENTRY_IMPORT, &size, nullptr));
+
+			for (; descriptor && descriptor->Name; ++descriptor)
+			{
+				auto importPath = path.parent_path() / (base + descriptor->Name);
+				std::error_code error;
+				if (std::filesystem::is_regular_file(importPath, error))
+					imports.push_back(importPath);
+			}
+			return imports;
+		}
+
+		//---------------------------------------------------------------------
+		// Return the local static imports of the executable and their own
+		// local static imports: the loader maps all of them before the entry
+		// point. The direct imports come first.
+		std::vector<std::filesystem::path>
+		GetLocalStaticImportGraph(const std::filesystem::path& path)
+		{
+			std::vector<std::filesystem::path> imports;
+			std::set<std::wstring> modules{boost::to_lower_copy(path.wstring())};
+			auto addImports = [&](std::filesystem::path modulePath) {
+				for (auto& importPath : GetLocalStaticImports(modulePath))
+				{
+					if (modules.insert(boost::to_lower_copy(importPath.wstring())).second)
+						imports.push_back(std::move(importPath));
+				}
+			};
+
+			addImports(path);
+			for (size_t i = 0; i < imports.size(); ++i)
+				addImports(imports[i]);
+			return imports;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename PrefetchedModules>
+		boost::optional<AsyncDebugInformationEnumerator::EnumeratedModule>
+		TakePrefetchedModule(PrefetchedModules& prefetchedModules,
+		                     const std::filesystem::path& path)
+		{
+			for (auto it = prefetchedModules.begin(); it != prefetchedModules.end(); ++it)
+			{
+				std::error_code error;
+				if (std::filesystem::equivalent(it->first, path, error))
+				{
+					auto modules = it->second->WaitForEnumeratedModules();
+					prefetchedModules.erase(it);
+					if (modules.empty())
+						return boost::none;
+					return std::move(modules.front());
+				}
+			}
+			return boost::none;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<HMODULE> GetProcessModules(HANDLE hProcess)
+		{
+			std::vector<HMODULE> modules(1024);
+			DWORD neededSize = 0;
+
+			for (;;)
+			{
+				auto size = static_cast<DWORD>(modules.size() * sizeof(HMODULE));
+				if (!EnumProcessModules(hProcess, &modules[0], size, &neededSize))
+					THROW_LAST_ERROR("Error in EnumProcessModules:", GetLastError());
+				if (neededSize <= size)
+					break;
+				modules.resize(neededSize / sizeof(HMODULE));
+			}
+			modules.resize(neededSize / sizeof(HMODULE));
+
+			return modules;
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetModuleFilename(HANDLE hProcess, HMODULE hModule)
+		{
+			std::vector<wchar_t> filename(PathBufferSize);
+
+			if (!GetModuleFileNameExW(hProcess,
+			                          hModule,
+			                          &filename[0],
+			                          static_cast<DWORD>(filename.size())))
+			{
+				THROW_LAST_ERROR("Error in GetModuleFileNameEx:", GetLastError());
+			}
+			return &filename[0];
+		}
+
+		//---------------------------------------------------------------------
+		void MarkAddressesAsExecuted(ExecutedAddressManager& executedAddressManager,
+		                             HANDLE hProcess,
+		                             const std::vector<DWORD64>& addresses)
+		{
+			for (auto address : addresses)
+			{
+				executedAddressManager.MarkAddressAsExecuted(
+				    Address{hProcess, reinterpret_cast<void*>(address)});
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// The addresses already executed are skipped.
+		void RemoveBreakPoints(BreakPoint& breakPoint,
+		                       const ExecutedAddressManager& executedAddressManager,
+		                       const std::vector<Address>& addresses)
+		{
+			std::map<HANDLE, BreakPoint::InstructionCollection> oldInstructionsByProcess;
+
+			for (const auto& address : addresses)
+			{
+				auto oldInstruction = executedAddressManager.GetInstructionToRestore(address);
+				if (oldInstruction)
+				{
+					oldInstructionsByProcess[address.GetProcessHandle()].emplace_back(
+					    *oldInstruction, reinterpret_cast<DWORD64>(address.GetValue()));
+				}
+			}
+			for (auto& pair : oldInstructionsByProcess)
+				breakPoint.RemoveBreakPoints(pair.first, std::move(pair.second));
+		}
+
+		//---------------------------------------------------------------------
+		void MarkHitCountsAsExecuted(
+		    ExecutedAddressManager& executedAddressManager,
+		    LiveCounters* liveCounters,
+		    const std::vector<TrampolineInstrumentation::HitCount>& hitCounts)
+		{
+			auto executedLineCount = executedAddressManager.GetExecutedLineCount();
+
+			for (const auto& hitCount : hitCounts)
+				executedAddressManager.MarkAddressTotalHitCount(hitCount.address_, hitCount.totalCount_);
+			if (liveCounters)
+				liveCounters->AddExecutedLines(executedAddressManager.GetExecutedLineCount() - executedLineCount);
+		}
+
+		//---------------------------------------------------------------------
+		// modules is ordered by process and base of image.
+		template <typename Modules>
+		auto GetProcessModules(Modules& modules, HANDLE hProcess)
+		{
+			auto lastBaseOfImage = reinterpret_cast<void*>((std::numeric_limits<uintptr_t>::max)());
+
+			return std::make_pair(modules.lower_bound({hProcess, nullptr}),
+			                      modules.upper_bound({hProcess, lastBaseOfImage}));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// The structures of a run grow until its end: they are measured at the end
+	// of the run and after the creation of the coverage data.
+	struct CodeCoverageRunner::MemoryTrackers
+	{
+		//---------------------------------------------------------------------
+		explicit MemoryTrackers(PerformanceStatistics* statistics)
+			: executedAddresses_{statistics, "Executed addresses"}
+			, lineTables_{statistics, "Line tables"}
+			, filterCaches_{statistics, "Filter caches"}
+		{
+		}
+
+		PerformanceStatistics::MemoryTracker executedAddresses_;
+		PerformanceStatistics::MemoryTracker lineTables_;
+		PerformanceStatistics::MemoryTracker filterCaches_;
+	};
+
 	//-------------------------------------------------------------------------
 	CodeCoverageRunner::CodeCoverageRunner(
 	    std::shared_ptr<Tools::WarningManager> warningManager)
 	    : warningManager_{warningManager},
+	      isRootProcessCreated_{false},
+	      coverChildren_{false},
+	      isReplaying_{false},
+	      mappedSampleCount_{0},
+	      isCoverageSampled_{false},
 	      filterAssistant_{
-	          std::make_shared<FilterAssistant>(std::make_shared<FileSystem>())}
+	          std::make_shared<FilterAssistant>(std::make_shared<FileSystem>())},
+	      moduleTimeBudget_{0},
+	      coverageJournalPeriod_{0},
+	      loadedModuleCount_{0},
+	      monitoredModuleCount_{0}
 	{
 		executedAddressManager_ = std::make_shared<ExecutedAddressManager>();
 		exceptionHandler_ = std::make_unique<ExceptionHandler>();
@@ -62,6 +428,43 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	Plugin::CoverageData CodeCoverageRunner::RunCoverage(
 		const RunCoverageSettings& settings)
+	{
+		auto exitCode = RunProgram(settings);
+		const auto& path = settings.GetStartInfo().GetPath();
+		PerformanceStatistics::ScopedPhase phase{performanceStatistics_.get(), "Coverage data creation"};
+
+		auto coverageData = executedAddressManager_->TakeCoverageData(path.filename().wstring(), exitCode);
+		coverageData.SetSampled(isCoverageSampled_);
+		UpdateMemoryUsages();
+		return coverageData;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageSummary CodeCoverageRunner::RunCoverageSummary(
+		const RunCoverageSettings& settings)
+	{
+		auto exitCode = RunProgram(settings);
+		const auto& path = settings.GetStartInfo().GetPath();
+		PerformanceStatistics::ScopedPhase phase{performanceStatistics_.get(), "Coverage summary creation"};
+
+		return executedAddressManager_->CreateCoverageSummary(path.filename().wstring(), exitCode);
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageSummary CodeCoverageRunner::RunCoverage(
+		const RunCoverageSettings& settings,
+		const std::function<void(const ICoverageSource&)>& writeCoverage)
+	{
+		auto exitCode = RunProgram(settings);
+		auto name = settings.GetStartInfo().GetPath().filename().wstring();
+		PerformanceStatistics::ScopedPhase phase{performanceStatistics_.get(), "Coverage data writing"};
+
+		writeCoverage(*executedAddressManager_->CreateCoverageSource(name, exitCode, isCoverageSampled_));
+		return executedAddressManager_->CreateCoverageSummary(name, exitCode);
+	}
+
+	//-------------------------------------------------------------------------
+	int CodeCoverageRunner::RunProgram(const RunCoverageSettings& settings)
 	{
 		Debugger debugger{ settings.GetCoverChildren(), settings.GetContinueAfterCppException(), settings.GetStopOnAssert()};
 
@@ -69,18 +472,385 @@ namespace CppCoverage
 			settings.GetCoverageFilterSettings(),
 			settings.GetUnifiedDiffSettings(), 
 			settings.GetExcludedLineRegexes(),
-			settings.GetOptimizedBuildSupport());
+			settings.GetOptimizedBuildSupport(),
+			settings.GetExclusionMarkers(),
+			settings.GetSourceFileCache());
 
 		monitoredLineRegister_ = std::make_unique<MonitoredLineRegister>(
 		    breakpoint_,
 		    executedAddressManager_,
 		    coverageFilterManager_,
-		    std::make_unique<DebugInformationEnumerator>(settings.GetSubstitutePdbSourcePaths()),
-			filterAssistant_);
+		    std::make_unique<DebugInformationEnumerator>(
+		        settings.GetSubstitutePdbSourcePaths(), settings.GetPdbCache(),
+		        settings.GetNativePdbReader(), settings.GetSymbolPrefetcher()),
+			filterAssistant_,
+			settings.GetBasicBlockBreakPoints(),
+			settings.GetDominatorBreakPoints(),
+			settings.GetLazyBreakPoints(),
+			settings.GetPageGuardBreakPoints(),
+			settings.GetCoverageBaseline(),
+			settings.GetCoverageLevel());
+		traceRecorder_ = settings.GetTraceRecorder();
+		monitoredLineRegister_->SetTraceRecorder(traceRecorder_);
+		monitoredLineRegister_->SetSourceFileCache(settings.GetSourceFileCache());
+		monitoredLineRegister_->SetIdenticalModulesMerged(settings.GetIdenticalModulesMerged());
+		debugger.SetTraceRecorder(traceRecorder_);
+		liveCounters_ = settings.GetLiveCounters();
+		debugger.SetLiveCounters(liveCounters_);
+		if (settings.GetPerformanceStatistics())
+			debugger.EnableDllLoadStallsByModule();
+		breakpoint_->SetLiveCounters(liveCounters_);
+
+		coverageRegion_.reset();
+		if (settings.GetCoverageRegionMarkers())
+		{
+			coverageRegion_ = std::make_unique<CoverageRegion>();
+			monitoredLineRegister_->EnableArmedBreakPointsTracking();
+			monitoredLineRegister_->SetBreakPointsDeferred(true);
+		}
+
+		intelPtCollector_.reset();
+		if (settings.GetIntelPt())
+		{
+			if (IntelPtCollector::IsSupported())
+			{
+				intelPtCollector_ = std::make_unique<IntelPtCollector>();
+				monitoredLineRegister_->EnableArmedBreakPointsTracking();
+				monitoredLineRegister_->SetBreakPointsDeferred(true);
+				// The trace is decoded on timer.
+				debugger.SetTimerPeriod(std::chrono::seconds{1});
+			}
+			else
+				LOG_WARNING << L"Intel Processor Trace is not available: breakpoints are used.";
+		}
+
+		trampolineInstrumentation_.reset();
+		if (settings.GetTrampolines())
+		{
+			trampolineInstrumentation_ = std::make_unique<TrampolineInstrumentation>();
+			monitoredLineRegister_->EnableArmedBreakPointsTracking();
+			monitoredLineRegister_->EnableFunctionRangesTracking();
+			monitoredLineRegister_->SetBreakPointsDeferred(true);
+			// The counters are read on timer.
+			nextTrampolineCountersRead_ = std::chrono::steady_clock::now() + TrampolineCountersReadPeriod;
+			debugger.SetTimerPeriod(TrampolineCountersReadPeriod);
+		}
+
+		etwSampler_.reset();
+		sampledAddressMapper_.reset();
+		mappedSampleCount_ = 0;
+		isCoverageSampled_ = false;
+		if (settings.GetEtwSampling())
+		{
+			etwSampler_ = std::make_unique<EtwSampler>();
+			if (etwSampler_->Start())
+			{
+				sampledAddressMapper_ = std::make_unique<SampledAddressMapper>();
+				isCoverageSampled_ = true;
+				monitoredLineRegister_->EnableArmedBreakPointsTracking();
+				monitoredLineRegister_->EnableFunctionRangesTracking();
+				monitoredLineRegister_->SetBreakPointsDeferred(true);
+				// The samples are mapped to the lines on timer.
+				debugger.SetTimerPeriod(std::chrono::seconds{1});
+			}
+			else
+			{
+				LOG_WARNING << L"ETW sampling is not available: breakpoints are used.";
+				etwSampler_.reset();
+			}
+		}
+
+		fuzzingBitmap_.reset();
+		if (settings.GetFuzzing())
+			fuzzingBitmap_ = std::make_unique<FuzzingBitmap>();
+
+		testImpactIndex_ = settings.GetTestImpactIndex();
+		testHitAddresses_.clear();
+		if (testImpactIndex_)
+			executedAddressManager_->EnableLinesRecording();
+
+		coverageObserver_ = settings.GetCoverageObserver();
+		loadedModuleCount_ = 0;
+		monitoredModuleCount_ = 0;
+		// The periods set below are not longer.
+		if (coverageObserver_)
+		{
+			nextProgressNotification_ = std::chrono::steady_clock::now() + ProgressNotificationPeriod;
+			debugger.SetTimerPeriod(ProgressNotificationPeriod);
+		}
+
+		coverageJournal_.reset();
+		if (settings.GetCoverageJournalPath())
+		{
+			coverageJournal_ = std::make_unique<CoverageJournal>(
+			    *settings.GetCoverageJournalPath(),
+			    settings.GetStartInfo().GetPath().filename().wstring());
+			executedAddressManager_->EnableJournal();
+			coverageJournalPeriod_ = std::chrono::seconds{settings.GetCoverageJournalSeconds()};
+			nextCoverageJournalSnapshot_ = std::chrono::steady_clock::now() + coverageJournalPeriod_;
+			// The periods set below are not longer.
+			debugger.SetTimerPeriod(std::chrono::seconds{1});
+		}
+
+		hitSampler_.reset();
+		if (settings.GetSamplingTrapsPerSecond())
+		{
+			hitSampler_ = std::make_unique<HitSampler>(
+			    settings.GetSamplingTrapsPerSecond(), HitSampler::Clock::now());
+			debugger.SetTimerPeriod(
+			    std::chrono::duration_cast<std::chrono::milliseconds>(
+			        hitSampler_->GetWindow()));
+		}
+
+		adaptiveArming_.reset();
+		if (settings.GetAdaptiveArmingTrapsPerSecond())
+		{
+			adaptiveArming_ = std::make_unique<AdaptiveArming>(
+			    settings.GetAdaptiveArmingTrapsPerSecond(), AdaptiveArming::Clock::now());
+			monitoredLineRegister_->EnableFunctionRangesTracking();
+		}
+
+		saturationDetector_.reset();
+		if (settings.GetAutoDetachSeconds())
+		{
+			saturationDetector_ = std::make_unique<SaturationDetector>(
+			    std::chrono::seconds{settings.GetAutoDetachSeconds()});
+			// Check the processes which do not report debug events anymore.
+			debugger.SetTimerPeriod(std::chrono::seconds{1});
+		}
+
+		createAsyncDebugInformationEnumerator_ = [&settings]() {
+			return std::make_unique<AsyncDebugInformationEnumerator>(
+			    settings.GetSubstitutePdbSourcePaths(), settings.GetPdbCache(),
+			    settings.GetNativePdbReader(), settings.GetSymbolPrefetcher(),
+			    settings.GetTraceRecorder());
+		};
+		symbolPrefetcher_ = settings.GetSymbolPrefetcher();
+		moduleTimeBudget_ = std::chrono::milliseconds{settings.GetModuleTimeBudgetMilliseconds()};
+		deferredModules_.clear();
+		parkedThreads_.clear();
+		replayedModules_.clear();
+		asyncDebugInformationEnumerator_.reset();
+		if (settings.GetAsyncModules())
+			asyncDebugInformationEnumerator_ = createAsyncDebugInformationEnumerator_();
+		// The enumerated modules are registered on timer.
+		if ((asyncDebugInformationEnumerator_ || moduleTimeBudget_.count()) &&
+		    !hitSampler_ && !saturationDetector_)
+			debugger.SetTimerPeriod(std::chrono::milliseconds{100});
+
+		childProcessFilter_.reset();
+		if (settings.GetChildPatterns())
+			childProcessFilter_ = std::make_unique<ChildProcessFilter>(*settings.GetChildPatterns());
+		isRootProcessCreated_ = false;
+		unselectedChildren_.clear();
+		coverChildren_ = settings.GetCoverChildren();
+
+		debugStringWriter_.reset();
+		if (settings.GetDebugStringsPath())
+			debugStringWriter_ = std::make_unique<DebugStringWriter>(*settings.GetDebugStringsPath());
+
+		// Only count the debug strings when nothing reads them.
+		auto debugStringMode = settings.GetDebugStringMode();
+		if (debugStringMode == DebugStringMode::Read &&
+		    !debugStringWriter_ && !coverageRegion_ && !testImpactIndex_ && !fuzzingBitmap_)
+		{
+			debugStringMode = DebugStringMode::Count;
+		}
+		debugger.SetDebugStringMode(debugStringMode);
+
+		// These modes set again the breakpoints already hit or sample the
+		// lines many times.
+		if (hitSampler_ || coverageRegion_ || testImpactIndex_ || fuzzingBitmap_ || etwSampler_ ||
+		    trampolineInstrumentation_)
+			executedAddressManager_->KeepExecutedAddresses();
+		if (settings.GetEagerLineDisarm())
+			executedAddressManager_->EnableEagerLineDisarm();
+		executedAddressManager_->SetMemoryBudget(settings.GetMemoryBudgetBytes());
 
 		const auto& startInfo = settings.GetStartInfo();
-		int exitCode = debugger.Debug(startInfo, *this);
-		const auto& path = startInfo.GetPath();
+		int exitCode = 0;
+		auto isDebugHeapDisabled = false;
+		performanceStatistics_ = settings.GetPerformanceStatistics();
+		auto armedBreakPointCount = breakpoint_->GetArmedBreakPointCount();
+		auto breakPointProcessingTime = breakpoint_->GetProcessingTime();
+		prefetchedModules_.clear();
+		knownModules_.clear();
+		debugInformationCache_ = settings.GetDebugInformationCache();
+		moduleLoadHistory_.reset();
+		if (settings.GetModuleLoadHistoryCache() && !settings.GetAttachProcessId())
+		{
+			moduleLoadHistory_ = std::make_unique<ModuleLoadHistory>(
+			    settings.GetModuleLoadHistoryCache(), startInfo.GetPath());
+		}
+		if (!settings.GetAttachProcessId())
+			PrefetchDebugInformation(startInfo.GetPath(), true);
+		runStart_ = std::chrono::steady_clock::now();
+		isReplaying_ = settings.GetReplayDebugEventsPath() != nullptr;
+		if (settings.GetInProcessAgent())
+			exitCode = RunWithInProcessAgent(startInfo);
+		else if (isReplaying_)
+		{
+			DebugEventsReplayer replayer{*settings.GetReplayDebugEventsPath()};
+			exitCode = replayer.Replay(*this);
+		}
+		else if (settings.GetAttachProcessId())
+			exitCode = debugger.Attach(settings.GetAttachProcessId(), *this);
+		else
+		{
+			auto debuggeeStartInfo = startInfo;
+			if (!settings.GetDebugHeap())
+				isDebugHeapDisabled = DisableDebugHeap(debuggeeStartInfo);
+			if (fuzzingBitmap_)
+			{
+				debuggeeStartInfo.AddEnvironmentVariable(
+				    FuzzingBitmapFormat::SectionVariable,
+				    fuzzingBitmap_->GetPublishedSectionName());
+			}
+			if (settings.GetRecordDebugEventsPath())
+			{
+				DebugEventsRecorder recorder{*this, *settings.GetRecordDebugEventsPath()};
+				exitCode = debugger.Debug(debuggeeStartInfo, recorder);
+				LOG_INFO << L"Debug events: " << recorder.GetEventCount() << L" written to "
+				         << settings.GetRecordDebugEventsPath()->wstring() << L".";
+			}
+			else
+				exitCode = debugger.Debug(debuggeeStartInfo, *this);
+		}
+		NotifyProgress();
+		// The modules not registered yet are dropped.
+		asyncDebugInformationEnumerator_.reset();
+		deferredModules_.clear();
+		prefetchedModules_.clear();
+		createAsyncDebugInformationEnumerator_ = nullptr;
+		symbolPrefetcher_.reset();
+		debugInformationCache_.reset();
+		if (moduleLoadHistory_)
+		{
+			moduleLoadHistory_->Write();
+			moduleLoadHistory_.reset();
+		}
+		if (!settings.GetInProcessAgent() && !isReplaying_)
+		{
+			std::wostringstream ostr;
+			ostr << debugger.GetStatistics();
+			ostr << L", debug heap " << (isDebugHeapDisabled ? L"disabled" : L"not disabled");
+			LOG_INFO << ostr.str();
+			if (performanceStatistics_)
+			{
+				AddDebuggerStatistics(*performanceStatistics_,
+				                      debugger.GetStatistics(),
+				                      breakpoint_->GetArmedBreakPointCount() - armedBreakPointCount,
+				                      breakpoint_->GetProcessingTime() - breakPointProcessingTime);
+			}
+		}
+		if (performanceStatistics_)
+		{
+			for (const auto& hitBreakPointCount : executedAddressManager_->GetHitBreakPointCounts())
+				performanceStatistics_->AddHitBreakPointCount(hitBreakPointCount.first, hitBreakPointCount.second);
+			if (!memoryTrackers_)
+				memoryTrackers_ = std::make_unique<MemoryTrackers>(performanceStatistics_.get());
+			UpdateMemoryUsages();
+		}
+		if (settings.GetLazyBreakPoints())
+		{
+			LOG_INFO << L"Lazy breakpoints: "
+			         << monitoredLineRegister_->GetArmedLazyFunctionCount()
+			         << L" functions armed out of "
+			         << monitoredLineRegister_->GetLazyFunctionCount() << L".";
+		}
+		if (settings.GetPageGuardBreakPoints())
+		{
+			auto guardedPageCount = monitoredLineRegister_->GetGuardedPageCount();
+			auto armedPageCount = monitoredLineRegister_->GetArmedGuardedPageCount();
+			LOG_INFO << L"Page guard breakpoints: " << armedPageCount
+			         << L" pages armed, " << guardedPageCount - armedPageCount
+			         << L" pages skipped.";
+		}
+		if (hitSampler_)
+		{
+			LOG_INFO << L"Sampling: " << hitSampler_->GetArmedCount()
+			         << L" breakpoints re-armed, "
+			         << hitSampler_->GetSampledHitCount() << L" sampled hits.";
+		}
+		if (adaptiveArming_)
+		{
+			LOG_INFO << L"Adaptive arming: " << adaptiveArming_->GetHotFunctionCount()
+			         << L" functions monitored by basic block, "
+			         << adaptiveArming_->GetBlockCount() << L" blocks.";
+		}
+		if (coverageRegion_)
+		{
+			LOG_INFO << L"Coverage region markers: "
+			         << coverageRegion_->GetRegionCount() << L" regions.";
+		}
+		if (intelPtCollector_)
+		{
+			LOG_INFO << L"Intel Processor Trace: " << intelPtCollector_->GetDecodedSize()
+			         << L" bytes decoded, " << intelPtCollector_->GetErrorCount()
+			         << L" decoding errors.";
+			intelPtCollector_.reset();
+		}
+		if (trampolineInstrumentation_)
+		{
+			LOG_INFO << L"Trampolines: "
+			         << trampolineInstrumentation_->GetInstrumentedAddressCount()
+			         << L" addresses instrumented, "
+			         << trampolineInstrumentation_->GetBreakPointAddressCount()
+			         << L" breakpoints.";
+			trampolineInstrumentation_.reset();
+		}
+		if (etwSampler_)
+		{
+			LOG_INFO << L"ETW sampling: " << etwSampler_->GetSampleCount()
+			         << L" samples, " << mappedSampleCount_ << L" in the selected lines, "
+			         << etwSampler_->GetLostEventCount() << L" events lost.";
+			etwSampler_.reset();
+			sampledAddressMapper_.reset();
+		}
+		if (fuzzingBitmap_)
+		{
+			const auto& header = fuzzingBitmap_->GetHeader();
+			LOG_INFO << L"Fuzzing: " << header.iterationCount_ << L" iterations, "
+			         << header.epochCount_ << L" epochs.";
+			fuzzingBitmap_.reset();
+		}
+		if (debugStringWriter_)
+		{
+			LOG_INFO << L"Debug strings: " << debugStringWriter_->GetStringCount()
+			         << L" written to " << settings.GetDebugStringsPath()->wstring() << L".";
+			debugStringWriter_.reset();
+		}
+		if (coverageJournal_)
+		{
+			coverageJournal_->Append(executedAddressManager_->TakeJournalLines());
+			coverageJournal_->AppendExitCode(exitCode);
+			LOG_INFO << L"Coverage journal: " << coverageJournal_->GetSnapshotCount()
+			         << L" snapshots written to " << settings.GetCoverageJournalPath()->wstring() << L".";
+			coverageJournal_.reset();
+		}
+		if (testImpactIndex_)
+		{
+			LOG_INFO << L"Test impact index: " << testImpactIndex_->GetTestCount()
+			         << L" tests.";
+		}
+		if (settings.GetCoverageLevel() == CoverageLevel::Function)
+		{
+			LOG_INFO << L"Function coverage: "
+			         << monitoredLineRegister_->GetMonitoredFunctionCount()
+			         << L" functions monitored.";
+		}
+		LOG_INFO << L"Already executed addresses skipped: "
+		         << monitoredLineRegister_->GetSkippedAddressCount() << L".";
+		LOG_INFO << L"Module loads reusing the selected lines: "
+		         << monitoredLineRegister_->GetReplayedModuleCount() << L".";
+		if (settings.GetCoverageBaseline())
+		{
+			LOG_INFO << L"Module loads covered by the baseline: "
+			         << monitoredLineRegister_->GetBaselineCoveredModuleCount() << L".";
+		}
+		LOG_INFO << L"Breakpoint writes: " << breakpoint_->GetSystemCallCount()
+		         << L" system calls (" << breakpoint_->GetSavedSystemCallCount()
+		         << L" saved).";
 
 		auto warningMessageLines = coverageFilterManager_->ComputeWarningMessageLines(
 			settings.GetMaxUnmatchPathsForWarning());
@@ -89,7 +859,7 @@ namespace CppCoverage
 		auto filterAdviceMessage = filterAssistant_->GetAdviceMessage();
 		if (filterAdviceMessage)
 			warningManager_->AddWarning(*filterAdviceMessage);
-		return executedAddressManager_->CreateCoverageData(path.filename().wstring(), exitCode);
+		return exitCode;
 	}
 
 	//-------------------------------------------------------------------------
@@ -97,15 +867,253 @@ namespace CppCoverage
 	{
 		auto hProcess = processDebugInfo.hProcess;
 		auto lpBaseOfImage = processDebugInfo.lpBaseOfImage;
+		auto filename = ComputeModuleFilename(processDebugInfo.hFile);
+		auto isChild = isRootProcessCreated_;
 
-		LoadModule(hProcess, processDebugInfo.hFile, lpBaseOfImage);
+		if (!isChild && performanceStatistics_)
+			performanceStatistics_->AddPhase("Process start", std::chrono::steady_clock::now() - runStart_);
+
+		isRootProcessCreated_ = true;
+		// No module of an unselected child is registered: the process is
+		// detached before it runs. The children of an attached process are
+		// always debugged.
+		if (isChild && (!coverChildren_ ||
+		                (childProcessFilter_ && !childProcessFilter_->IsChildSelected(filename))))
+		{
+			unselectedChildren_.insert(hProcess);
+			return;
+		}
+		if (intelPtCollector_)
+			intelPtCollector_->StartProcessTrace(hProcess);
+		if (etwSampler_)
+			etwSampler_->AddProcess(hProcess);
+		// The imports are prefetched while the executable is registered.
+		PrefetchDebugInformation(filename, false);
+		LoadModule(hProcess, filename, lpBaseOfImage);
 	}
 	
 	//-------------------------------------------------------------------------
 	void CodeCoverageRunner::OnExitProcess(HANDLE hProcess, HANDLE, const EXIT_PROCESS_DEBUG_INFO&)
 	{
+		RemoveProcess(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::PrepareDetach(HANDLE hProcess)
+	{
+		if (unselectedChildren_.count(hProcess))
+			return true;
+		// A parked thread waits for the registration of its module.
+		auto parkedThreads = GetProcessModules(parkedThreads_, hProcess);
+		if (!saturationDetector_ || parkedThreads.first != parkedThreads.second)
+			return false;
+
+		auto armedAddressCount = executedAddressManager_->GetArmedAddressCount(hProcess);
+		if (!saturationDetector_->IsSaturated(
+		        hProcess, armedAddressCount, SaturationDetector::Clock::now()))
+		{
+			return false;
+		}
+
+		RemoveDisarmedBreakPoints(hProcess);
+		RemoveBreakPoints(*breakpoint_, *executedAddressManager_,
+		                  executedAddressManager_->GetArmedAddresses(hProcess));
+		LOG_WARNING << L"Detach from process " << GetProcessId(hProcess) << L" ("
+		            << armedAddressCount << L" breakpoints not hit): "
+		            << L"modules loaded later are not covered.";
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnDetachProcess(HANDLE hProcess)
+	{
+		RemoveProcess(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::RemoveProcess(HANDLE hProcess)
+	{
+		if (intelPtCollector_)
+		{
+			MarkTracedAddressesAsExecuted(intelPtCollector_->Collect(hProcess));
+			intelPtCollector_->OnExitProcess(hProcess);
+		}
+		if (trampolineInstrumentation_)
+		{
+			MarkHitCountsAsExecuted(*executedAddressManager_,
+			                        liveCounters_.get(),
+			                        trampolineInstrumentation_->OnExitProcess(hProcess));
+		}
+		if (etwSampler_)
+		{
+			etwSampler_->Flush(SampleFlushTimeout);
+			MarkSamplesAsExecuted();
+			etwSampler_->RemoveProcess(hProcess);
+			sampledAddressMapper_->OnExitProcess(hProcess);
+		}
 		exceptionHandler_->OnExitProcess(hProcess);
+		breakpoint_->OnExitProcess(hProcess);
 		executedAddressManager_->OnExitProcess(hProcess);
+		monitoredLineRegister_->OnExitProcess(hProcess);
+		if (hitSampler_)
+			hitSampler_->OnExitProcess(hProcess);
+		if (adaptiveArming_)
+			adaptiveArming_->OnExitProcess(hProcess);
+		if (coverageRegion_)
+			coverageRegion_->OnExitProcess(hProcess);
+		if (fuzzingBitmap_)
+			fuzzingBitmap_->OnExitProcess(hProcess);
+		testHitAddresses_.erase(hProcess);
+		if (saturationDetector_)
+			saturationDetector_->OnExitProcess(hProcess);
+		unselectedChildren_.erase(hProcess);
+		// The parked threads do not run anymore.
+		auto parkedThreads = GetProcessModules(parkedThreads_, hProcess);
+		parkedThreads_.erase(parkedThreads.first, parkedThreads.second);
+		auto replayedModules = GetProcessModules(replayedModules_, hProcess);
+		replayedModules_.erase(replayedModules.first, replayedModules.second);
+		if (asyncDebugInformationEnumerator_)
+			asyncDebugInformationEnumerator_->Cancel(hProcess);
+		for (auto& deferredModule : deferredModules_)
+			deferredModule->Cancel(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::MarkTracedAddressesAsExecuted(const std::vector<Address>& addresses)
+	{
+		auto executedLineCount = executedAddressManager_->GetExecutedLineCount();
+
+		// No breakpoint was written for these addresses.
+		for (const auto& address : addresses)
+			executedAddressManager_->MarkAddressAsExecuted(address);
+		if (liveCounters_)
+			liveCounters_->AddExecutedLines(executedAddressManager_->GetExecutedLineCount() - executedLineCount);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::MarkSamplesAsExecuted()
+	{
+		auto executedLineCount = executedAddressManager_->GetExecutedLineCount();
+
+		for (const auto& sample : etwSampler_->TakeSamples())
+		{
+			auto address = sampledAddressMapper_->Find(sample.hProcess_, sample.instructionPointer_);
+			if (address)
+			{
+				executedAddressManager_->MarkAddressAsExecuted(
+				    Address{sample.hProcess_, reinterpret_cast<void*>(*address)}, sample.count_);
+				mappedSampleCount_ += sample.count_;
+			}
+		}
+		if (liveCounters_)
+			liveCounters_->AddExecutedLines(executedAddressManager_->GetExecutedLineCount() - executedLineCount);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::PrefetchDebugInformation(
+	    const std::filesystem::path& program,
+	    bool prefetchProgram)
+	{
+		if (debugInformationCache_)
+			return;
+
+		std::error_code error;
+		auto path = std::filesystem::absolute(program, error);
+
+		if (error || !std::filesystem::is_regular_file(path, error))
+			return;
+
+		// The lines are recorded by RVA: they do not depend on the load address.
+		auto modulePaths = GetLocalStaticImportGraph(path);
+		if (prefetchProgram)
+			modulePaths.insert(modulePaths.begin(), path);
+		// The modules of the previous run are enumerated first, in the order
+		// they are needed, including the ones loaded dynamically.
+		if (prefetchProgram && moduleLoadHistory_)
+		{
+			auto historyPaths = moduleLoadHistory_->GetPrefetchOrder();
+			modulePaths.insert(modulePaths.begin(), historyPaths.begin(), historyPaths.end());
+		}
+
+		std::vector<std::filesystem::path> selectedModulePaths;
+		for (const auto& modulePath : modulePaths)
+		{
+			// A module already loaded or prefetched reuses its DIA session
+			// or its registered lines.
+			if (knownModules_.insert(boost::to_lower_copy(modulePath.wstring())).second &&
+			    coverageFilterManager_->IsModuleSelected(modulePath.wstring()))
+				selectedModulePaths.push_back(modulePath);
+		}
+
+		// All the PDBs are downloaded while the first ones are loaded.
+		if (symbolPrefetcher_)
+			symbolPrefetcher_->Prefetch(selectedModulePaths);
+		for (const auto& modulePath : selectedModulePaths)
+		{
+			auto enumerator = createAsyncDebugInformationEnumerator_();
+			enumerator->Enumerate(nullptr, nullptr, modulePath);
+			prefetchedModules_.emplace_back(modulePath, std::move(enumerator));
+			LOG_DEBUG << L"Prefetch debug information of " << modulePath.wstring();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CodeCoverageRunner::RegisterEnumeratedModules(AsyncDebugInformationEnumerator& enumerator)
+	{
+		auto modules = enumerator.TakeEnumeratedModules();
+
+		for (const auto& module : modules)
+		{
+			// Resumed last, after the other threads, even when the registration fails.
+			auto isThreadParked = IsThreadParked(module.hProcess_, module.baseOfImage_);
+			Tools::ScopedAction resumeParkedThread{
+			    [&]() { ResumeParkedThread(module.hProcess_, module.baseOfImage_); }};
+			// The process is running: its threads must not execute the code
+			// while the breakpoints are written.
+			// A replayed process is this process: its threads do not run the module.
+			auto threads = isReplaying_ ? std::vector<HANDLE>{}
+			                            : SuspendThreads(GetProcessId(module.hProcess_));
+			Tools::ScopedAction resumeThreads{[&]() { ResumeThreads(threads); }};
+
+			auto isSelected = MeasureModuleRegistration(module.path_, [&]() {
+				return monitoredLineRegister_->RegisterLineToMonitor(module);
+			});
+			if (adaptiveArming_)
+			{
+				adaptiveArming_->AddFunctions(
+				    module.hProcess_, module.baseOfImage_, monitoredLineRegister_->TakeFunctionRanges());
+				adaptiveArming_->AddArmedAddresses(
+				    module.hProcess_,
+				    executedAddressManager_->GetArmedAddresses(module.hProcess_, module.baseOfImage_));
+			}
+			OnModuleRegistered(module.path_, isSelected);
+
+			auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+			    AsyncDebugInformationEnumerator::Clock::now() - module.loadTime_);
+			if (isThreadParked)
+			{
+				LOG_INFO << module.path_.wstring() << L" registered " << delay.count()
+				         << L" ms after its load while its loading thread was suspended.";
+			}
+			else
+			{
+				LOG_INFO << module.path_.wstring() << L" registered " << delay.count()
+				         << L" ms after its load: the code executed before, such as "
+				         << L"DllMain and static initializers, is not covered.";
+			}
+		}
+		return modules.size();
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::RegisterDeferredModules()
+	{
+		// Each deferred enumerator has a single module.
+		deferredModules_.erase(
+		    std::remove_if(deferredModules_.begin(),
+		                   deferredModules_.end(),
+		                   [this](const auto& enumerator) { return RegisterEnumeratedModules(*enumerator) != 0; }),
+		    deferredModules_.end());
 	}
 
 	//-------------------------------------------------------------------------
@@ -114,7 +1122,75 @@ namespace CppCoverage
 		HANDLE hThread, 
 		const LOAD_DLL_DEBUG_INFO& dllDebugInfo)
 	{
-		LoadModule(hProcess, dllDebugInfo.hFile, dllDebugInfo.lpBaseOfDll);
+		if (unselectedChildren_.count(hProcess))
+			return;
+
+		std::pair<HANDLE, void*> module{hProcess, dllDebugInfo.lpBaseOfDll};
+		// The event of a parked thread is reported again once its module is registered.
+		if (replayedModules_.erase(module))
+			return;
+		if (!LoadModule(hProcess, dllDebugInfo.hFile, dllDebugInfo.lpBaseOfDll))
+			parkedThreads_[module] = ParkedThread{hThread, false};
+	}
+
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::PostponeLoadDll(
+		HANDLE hProcess,
+		HANDLE hThread,
+		const LOAD_DLL_DEBUG_INFO& dllDebugInfo)
+	{
+		// The loader lock is held by the thread: DllMain and the static
+		// initializers of the module run once it is registered.
+		auto it = parkedThreads_.find({hProcess, dllDebugInfo.lpBaseOfDll});
+		if (it == parkedThreads_.end())
+			return false;
+		if (SuspendThread(hThread) == static_cast<DWORD>(-1))
+		{
+			LOG_WARNING << L"Cannot suspend the thread loading a module: " << GetLastError();
+			parkedThreads_.erase(it);
+			return false;
+		}
+		it->second.isSuspended_ = true;
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::CancelPostponeLoadDll(
+		HANDLE hProcess,
+		HANDLE hThread,
+		const LOAD_DLL_DEBUG_INFO& dllDebugInfo)
+	{
+		// The thread runs the module before its registration and its load is
+		// not reported again.
+		auto it = parkedThreads_.find({hProcess, dllDebugInfo.lpBaseOfDll});
+		if (it != parkedThreads_.end())
+			it->second.isSuspended_ = false;
+		if (ResumeThread(hThread) == static_cast<DWORD>(-1))
+			LOG_ERROR << L"Cannot resume the thread loading a module: " << GetLastError();
+	}
+
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::IsThreadParked(HANDLE hProcess, void* baseOfImage) const
+	{
+		auto it = parkedThreads_.find({hProcess, baseOfImage});
+		return it != parkedThreads_.end() && it->second.isSuspended_;
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::ResumeParkedThread(HANDLE hProcess, void* baseOfImage)
+	{
+		auto it = parkedThreads_.find({hProcess, baseOfImage});
+		if (it == parkedThreads_.end())
+			return;
+
+		auto parkedThread = it->second;
+		parkedThreads_.erase(it);
+		if (!parkedThread.isSuspended_)
+			return;
+		if (ResumeThread(parkedThread.hThread_) == static_cast<DWORD>(-1))
+			LOG_ERROR << L"Cannot resume the thread loading a module: " << GetLastError();
+		else
+			replayedModules_.insert({hProcess, baseOfImage});
 	}
 	
 	//-------------------------------------------------------------------------
@@ -123,7 +1199,33 @@ namespace CppCoverage
 		HANDLE hThread,
 		const UNLOAD_DLL_DEBUG_INFO& unloadDllDebugInfo)
 	{
+		if (intelPtCollector_)
+		{
+			MarkTracedAddressesAsExecuted(intelPtCollector_->Collect(hProcess));
+			intelPtCollector_->OnUnloadModule(hProcess);
+		}
+		if (trampolineInstrumentation_)
+		{
+			MarkHitCountsAsExecuted(
+			    *executedAddressManager_,
+			    liveCounters_.get(),
+			    trampolineInstrumentation_->OnUnloadModule(hProcess, unloadDllDebugInfo.lpBaseOfDll));
+		}
+		if (etwSampler_)
+		{
+			etwSampler_->Flush(SampleFlushTimeout);
+			MarkSamplesAsExecuted();
+			sampledAddressMapper_->OnUnloadModule(hProcess, unloadDllDebugInfo.lpBaseOfDll);
+		}
+		if (adaptiveArming_)
+			adaptiveArming_->OnUnloadModule(hProcess, unloadDllDebugInfo.lpBaseOfDll);
 		executedAddressManager_->OnUnloadModule(hProcess, unloadDllDebugInfo.lpBaseOfDll);
+		monitoredLineRegister_->OnUnloadModule(hProcess, unloadDllDebugInfo.lpBaseOfDll);
+		replayedModules_.erase({hProcess, unloadDllDebugInfo.lpBaseOfDll});
+		if (asyncDebugInformationEnumerator_)
+			asyncDebugInformationEnumerator_->Cancel(hProcess, unloadDllDebugInfo.lpBaseOfDll);
+		for (auto& deferredModule : deferredModules_)
+			deferredModule->Cancel(hProcess, unloadDllDebugInfo.lpBaseOfDll);
 	}
 
 	//-------------------------------------------------------------------------
@@ -132,6 +1234,23 @@ namespace CppCoverage
 		HANDLE hThread, 
 		const EXCEPTION_DEBUG_INFO& exceptionDebugInfo)
 	{
+		// Breakpoints are by far the most frequent events: do not build
+		// the error message stream for them.
+		if (exceptionDebugInfo.dwFirstChance)
+		{
+			auto status = exceptionHandler_->HandleFirstChanceException(hProcess, exceptionDebugInfo);
+
+			if (status != CppCoverage::ExceptionHandlerStatus::BreakPoint)
+			{
+				if (OnGuardPageViolation(exceptionDebugInfo, hProcess))
+					return IDebugEventsHandler::ExceptionType::BreakPoint;
+				return IDebugEventsHandler::ExceptionType::NotHandled;
+			}
+			if (OnBreakPoint(exceptionDebugInfo, hProcess, hThread))
+				return IDebugEventsHandler::ExceptionType::BreakPoint;
+			return IDebugEventsHandler::ExceptionType::InvalidBreakPoint;
+		}
+
 		std::wostringstream ostr;
 		
 		auto status = exceptionHandler_->HandleException(hProcess, exceptionDebugInfo, ostr);
@@ -174,12 +1293,44 @@ namespace CppCoverage
 		const auto& exceptionRecord = exceptionDebugInfo.ExceptionRecord;
 		auto addressValue = exceptionRecord.ExceptionAddress;
 		Address address{ hProcess, addressValue };
+		EtwProvider::OnBreakPointHit(hProcess, addressValue);
+		// A disarmed address can be the one hit.
+		RemoveDisarmedBreakPoints(hProcess);
+		auto isLazyFunctionEntry = monitoredLineRegister_->OnLazyFunctionEntry(address);
+		auto executedLineCount = executedAddressManager_->GetExecutedLineCount();
 		auto oldInstruction = executedAddressManager_->MarkAddressAsExecuted(address);
 
 		if (oldInstruction)
 		{
 			breakpoint_->RemoveBreakPoint(address, *oldInstruction);
-			breakpoint_->AdjustEipAfterBreakPointRemoval(hThread);
+			if (liveCounters_)
+			{
+				liveCounters_->AddHitBreakPoint();
+				liveCounters_->AddExecutedLines(executedAddressManager_->GetExecutedLineCount() - executedLineCount);
+			}
+			if (hitSampler_)
+				hitSampler_->OnHit(address);
+			if (adaptiveArming_)
+			{
+				MarkBlockAsExecuted(address);
+				for (const auto& hotFunction : adaptiveArming_->OnHit(address, AdaptiveArming::Clock::now()))
+				{
+					MonitorByBasicBlock(
+					    hotFunction.hProcess_, hotFunction.address_, hotFunction.length_);
+				}
+			}
+			if (coverageRegion_)
+				coverageRegion_->OnHit(address);
+			if (fuzzingBitmap_)
+				fuzzingBitmap_->OnHit(address);
+			if (testImpactIndex_)
+				testHitAddresses_[hProcess].push_back(reinterpret_cast<DWORD64>(addressValue));
+		}
+		// The breakpoint was hit by another thread before it was removed.
+		if (oldInstruction || isLazyFunctionEntry ||
+		    executedAddressManager_->IsAddressReleased(address))
+		{
+			breakpoint_->AdjustEipAfterBreakPointRemoval(hProcess, hThread);
 			return true;
 		}
 
@@ -187,20 +1338,535 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	void CodeCoverageRunner::LoadModule(HANDLE hProcess,
+	// The addresses disarmed by the previous breakpoints are removed at once.
+	void CodeCoverageRunner::RemoveDisarmedBreakPoints(HANDLE hProcess)
+	{
+		auto disarmedAddresses = executedAddressManager_->TakeDisarmedAddresses(hProcess);
+
+		if (!disarmedAddresses.empty())
+			breakpoint_->RemoveBreakPoints(hProcess, std::move(disarmedAddresses));
+	}
+
+	//-------------------------------------------------------------------------
+	// Only the first armed address of each basic block of the function keeps
+	// its breakpoint: the other armed addresses of the block are executed
+	// when it is hit.
+	void CodeCoverageRunner::MonitorByBasicBlock(
+	    HANDLE hProcess,
+	    DWORD64 functionAddress,
+	    uint64_t functionLength)
+	{
+		std::vector<std::pair<DWORD64, unsigned char>> armedAddresses;
+
+		// The armed addresses are sorted.
+		for (auto addressValue : adaptiveArming_->GetArmedAddresses(hProcess, functionAddress, functionLength))
+		{
+			auto oldInstruction = executedAddressManager_->GetInstructionToRestore(
+			    Address{hProcess, reinterpret_cast<void*>(addressValue)});
+
+			if (oldInstruction)
+				armedAddresses.emplace_back(addressValue, *oldInstruction);
+		}
+		if (armedAddresses.size() < 2)
+			return;
+
+		// The code is decoded with the instructions replaced by the breakpoints.
+		auto code = Tools::ReadProcessMemory(hProcess,
+		                                     reinterpret_cast<void*>(functionAddress),
+		                                     static_cast<size_t>(functionLength));
+		for (const auto& pair : armedAddresses)
+			code[static_cast<size_t>(pair.first - functionAddress)] = pair.second;
+		BasicBlockAnalyzer analyzer{code, functionAddress, Process::Is64Bits(hProcess)};
+		if (!analyzer.IsAnalyzed())
+			return;
+
+		BreakPoint::InstructionCollection oldInstructions;
+		auto it = armedAddresses.begin();
+		while (it != armedAddresses.end())
+		{
+			auto monitor = it->first;
+			std::vector<DWORD64> addresses;
+
+			for (++it; it != armedAddresses.end() && analyzer.IsInSameBasicBlock(monitor, it->first); ++it)
+			{
+				oldInstructions.emplace_back(it->second, it->first);
+				addresses.push_back(it->first);
+			}
+			adaptiveArming_->AddBlock(Address{hProcess, reinterpret_cast<void*>(monitor)},
+			                          std::move(addresses));
+		}
+		if (!oldInstructions.empty())
+			breakpoint_->RemoveBreakPoints(hProcess, std::move(oldInstructions));
+	}
+
+	//-------------------------------------------------------------------------
+	// No breakpoint was written for these addresses anymore.
+	void CodeCoverageRunner::MarkBlockAsExecuted(const Address& monitor)
+	{
+		auto executedLineCount = executedAddressManager_->GetExecutedLineCount();
+
+		for (auto addressValue : adaptiveArming_->TakeBlock(monitor))
+		{
+			executedAddressManager_->MarkAddressAsExecuted(
+			    Address{monitor.GetProcessHandle(), reinterpret_cast<void*>(addressValue)});
+		}
+		if (liveCounters_)
+			liveCounters_->AddExecutedLines(executedAddressManager_->GetExecutedLineCount() - executedLineCount);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnTimer()
+	{
+		if (intelPtCollector_)
+			MarkTracedAddressesAsExecuted(intelPtCollector_->CollectAll());
+		if (etwSampler_)
+			MarkSamplesAsExecuted();
+		if (trampolineInstrumentation_ && std::chrono::steady_clock::now() >= nextTrampolineCountersRead_)
+		{
+			MarkHitCountsAsExecuted(*executedAddressManager_,
+			                        liveCounters_.get(),
+			                        trampolineInstrumentation_->CollectAll());
+			nextTrampolineCountersRead_ = std::chrono::steady_clock::now() + TrampolineCountersReadPeriod;
+		}
+		if (coverageObserver_ && std::chrono::steady_clock::now() >= nextProgressNotification_)
+		{
+			NotifyProgress();
+			nextProgressNotification_ = std::chrono::steady_clock::now() + ProgressNotificationPeriod;
+		}
+		if (coverageJournal_ && std::chrono::steady_clock::now() >= nextCoverageJournalSnapshot_)
+		{
+			coverageJournal_->Append(executedAddressManager_->TakeJournalLines());
+			nextCoverageJournalSnapshot_ = std::chrono::steady_clock::now() + coverageJournalPeriod_;
+		}
+		if (asyncDebugInformationEnumerator_)
+			RegisterEnumeratedModules(*asyncDebugInformationEnumerator_);
+		RegisterDeferredModules();
+		if (!hitSampler_)
+			return;
+
+		auto plan = hitSampler_->ComputePlan(HitSampler::Clock::now());
+
+		RemoveBreakPoints(*breakpoint_, *executedAddressManager_, plan.addressesToDisarm_);
+
+		// Addresses of unloaded modules are not registered anymore.
+		std::map<HANDLE, std::vector<DWORD64>> addressesByProcess;
+		for (const auto& address : plan.addressesToArm_)
+		{
+			if (executedAddressManager_->GetInstructionToRestore(address))
+			{
+				addressesByProcess[address.GetProcessHandle()].push_back(
+				    reinterpret_cast<DWORD64>(address.GetValue()));
+			}
+			else
+				hitSampler_->Remove(address);
+		}
+		for (auto& pair : addressesByProcess)
+			breakpoint_->SetBreakPoints(pair.first, std::move(pair.second));
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnOutputDebugString(
+		HANDLE hProcess,
+		HANDLE,
+		const std::wstring& debugString)
+	{
+		if (debugStringWriter_)
+			debugStringWriter_->Write(GetProcessId(hProcess), debugString);
+		if (coverageRegion_)
+			OnCoverageRegionMarker(debugString);
+		if (testImpactIndex_)
+			OnTestEndMarker(debugString);
+		if (fuzzingBitmap_)
+			OnFuzzingMarker(debugString);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnCoverageRegionMarker(const std::wstring& debugString)
+	{
+		switch (CoverageRegion::ParseMarker(debugString))
+		{
+			case CoverageRegion::Marker::Begin:
+			{
+				LOG_DEBUG << L"Begin of coverage region.";
+				for (const auto& pair : coverageRegion_->Begin())
+					SetRegisteredBreakPoints(pair.first, pair.second);
+				monitoredLineRegister_->SetBreakPointsDeferred(false);
+				break;
+			}
+			case CoverageRegion::Marker::End:
+			{
+				LOG_DEBUG << L"End of coverage region.";
+				RemoveBreakPoints(*breakpoint_, *executedAddressManager_, coverageRegion_->End());
+				monitoredLineRegister_->SetBreakPointsDeferred(true);
+				break;
+			}
+			case CoverageRegion::Marker::None:
+				break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnTestEndMarker(const std::wstring& debugString)
+	{
+		auto testName = TestImpactIndex::ParseTestEndMarker(debugString);
+
+		if (!testName)
+			return;
+		LOG_DEBUG << L"End of test: " << *testName;
+		testImpactIndex_->AddTest(*testName, executedAddressManager_->TakeRecordedLines());
+
+		// Only the breakpoints hit by the test are set again so the cost of
+		// a test is proportional to the number of lines it executes.
+		for (const auto& pair : testHitAddresses_)
+			SetRegisteredBreakPoints(pair.first, pair.second);
+		testHitAddresses_.clear();
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnFuzzingMarker(const std::wstring& debugString)
+	{
+		switch (FuzzingBitmap::ParseMarker(debugString))
+		{
+			case FuzzingBitmap::Marker::Iteration:
+				fuzzingBitmap_->OnIterationEnd();
+				break;
+			case FuzzingBitmap::Marker::Epoch:
+			{
+				LOG_DEBUG << L"New fuzzing epoch.";
+				for (const auto& pair : fuzzingBitmap_->OnEpoch())
+					SetRegisteredBreakPoints(pair.first, pair.second);
+				break;
+			}
+			case FuzzingBitmap::Marker::None:
+				break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::SetRegisteredBreakPoints(
+		HANDLE hProcess,
+		const std::vector<DWORD64>& addressValues)
+	{
+		// Addresses of unloaded modules are not registered anymore.
+		std::vector<DWORD64> addresses;
+		for (auto addressValue : addressValues)
+		{
+			Address address{hProcess, reinterpret_cast<void*>(addressValue)};
+			if (executedAddressManager_->GetInstructionToRestore(address))
+				addresses.push_back(addressValue);
+		}
+		breakpoint_->SetBreakPoints(hProcess, std::move(addresses));
+	}
+
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::OnGuardPageViolation(
+		const EXCEPTION_DEBUG_INFO& exceptionDebugInfo,
+		HANDLE hProcess)
+	{
+		const auto& exceptionRecord = exceptionDebugInfo.ExceptionRecord;
+
+		if (exceptionRecord.ExceptionCode != STATUS_GUARD_PAGE_VIOLATION ||
+			exceptionRecord.NumberParameters < 2)
+		{
+			return false;
+		}
+
+		// ExceptionInformation[1] is the accessed address.
+		return monitoredLineRegister_->OnGuardPageViolation(
+			hProcess, exceptionRecord.ExceptionInformation[1]);
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring CodeCoverageRunner::ComputeModuleFilename(HANDLE hFile)
+	{
+		PerformanceStatistics::ScopedPhase phase{
+		    performanceStatistics_.get(), "Module filename resolution", false};
+
+		return handleInformation_.ComputeFilename(hFile);
+	}
+
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::LoadModule(HANDLE hProcess,
 	                                    HANDLE hFile,
 	                                    void* baseOfImage)
 	{
-		HandleInformation handleInformation;
+		return LoadModule(hProcess, ComputeModuleFilename(hFile), baseOfImage);
+	}
 
-		std::wstring filename = handleInformation.ComputeFilename(hFile);
+	//-------------------------------------------------------------------------
+	bool CodeCoverageRunner::LoadModule(HANDLE hProcess,
+	                                    const std::wstring& filename,
+	                                    void* baseOfImage)
+	{
+		// Includes the debug information read synchronously, the filters and the breakpoints.
+		PerformanceStatistics::ScopedPhase phase{performanceStatistics_.get(), "Module registration"};
 
+		EtwProvider::OnModuleLoadStart(filename);
+		if (liveCounters_)
+			liveCounters_->AddLoadedModule();
+		++loadedModuleCount_;
+		knownModules_.insert(boost::to_lower_copy(filename));
 		auto isSelected = coverageFilterManager_->IsModuleSelected(filename);
+		auto loadStart = std::chrono::steady_clock::now();
+		Tools::ScopedAction onModuleLoadStop{[&]() {
+			EtwProvider::OnModuleLoadStop(filename, isSelected);
+			if (moduleLoadHistory_ && isSelected)
+			{
+				using std::chrono::duration_cast;
+				using std::chrono::milliseconds;
+				moduleLoadHistory_->AddLoadedModule(
+				    filename,
+				    duration_cast<milliseconds>(loadStart - runStart_),
+				    duration_cast<milliseconds>(std::chrono::steady_clock::now() - loadStart));
+			}
+		}};
 		if (isSelected)
 		{
-			isSelected = monitoredLineRegister_->RegisterLineToMonitor(
-			    filename, hProcess, baseOfImage);
+			auto prefetchedModule = TakePrefetchedModule(prefetchedModules_, filename);
+			if (monitoredLineRegister_->RegisterBaselineCoveredModule(filename, hProcess, baseOfImage))
+			{
+				LOG_INFO << filename
+				         << L" is skipped as the coverage baseline executes all its lines.";
+			}
+			else if (debugInformationCache_)
+			{
+				auto module = debugInformationCache_->GetModule(filename);
+				isSelected = MeasureModuleRegistration(filename, [&]() {
+					return monitoredLineRegister_->RegisterLineToMonitor(
+					    *module, filename, hProcess, baseOfImage);
+				});
+			}
+			else if (prefetchedModule)
+			{
+				prefetchedModule->path_ = filename;
+				prefetchedModule->hProcess_ = hProcess;
+				prefetchedModule->baseOfImage_ = baseOfImage;
+				isSelected = MeasureModuleRegistration(filename, [&]() {
+					return monitoredLineRegister_->RegisterLineToMonitor(*prefetchedModule);
+				});
+			}
+			else if (asyncDebugInformationEnumerator_)
+			{
+				// The module is registered by RegisterEnumeratedModules.
+				asyncDebugInformationEnumerator_->Enumerate(hProcess, baseOfImage, filename);
+				return false;
+			}
+			else if (moduleTimeBudget_.count())
+			{
+				auto enumerator = createAsyncDebugInformationEnumerator_();
+				enumerator->Enumerate(hProcess, baseOfImage, filename);
+				auto modules = enumerator->WaitForEnumeratedModules(moduleTimeBudget_);
+				if (modules.empty())
+				{
+					// The module is registered by RegisterDeferredModules.
+					LOG_WARNING << filename << L" exceeds the time budget of "
+					            << moduleTimeBudget_.count()
+					            << L" ms to read its debug information.";
+					deferredModules_.push_back(std::move(enumerator));
+					return false;
+				}
+				isSelected = MeasureModuleRegistration(filename, [&]() {
+					return monitoredLineRegister_->RegisterLineToMonitor(modules.front());
+				});
+			}
+			else
+			{
+				isSelected = MeasureModuleRegistration(filename, [&]() {
+					return monitoredLineRegister_->RegisterLineToMonitor(
+					    filename, hProcess, baseOfImage);
+				});
+			}
+			if (coverageRegion_ || intelPtCollector_ || trampolineInstrumentation_ || etwSampler_)
+			{
+				std::vector<DWORD64> addresses;
+				for (const auto& value : monitoredLineRegister_->TakeArmedBreakPoints())
+					addresses.push_back(value.second);
+				if (coverageRegion_)
+					coverageRegion_->AddAddresses(hProcess, addresses);
+				else if (trampolineInstrumentation_)
+				{
+					SetRegisteredBreakPoints(
+					    hProcess,
+					    trampolineInstrumentation_->Instrument(
+					        hProcess,
+					        baseOfImage,
+					        monitoredLineRegister_->TakeFunctionRanges(),
+					        std::move(addresses)));
+				}
+				// No breakpoint is set: the lines are sampled.
+				else if (etwSampler_)
+				{
+					sampledAddressMapper_->AddModule(
+					    hProcess, baseOfImage, monitoredLineRegister_->TakeFunctionRanges(), std::move(addresses));
+				}
+				// The breakpoints are set when the process is not traced.
+				else if (!intelPtCollector_->AddAddresses(hProcess, addresses))
+					SetRegisteredBreakPoints(hProcess, addresses);
+			}
+			if (adaptiveArming_)
+			{
+				adaptiveArming_->AddFunctions(
+				    hProcess, baseOfImage, monitoredLineRegister_->TakeFunctionRanges());
+				adaptiveArming_->AddArmedAddresses(
+				    hProcess, executedAddressManager_->GetArmedAddresses(hProcess, baseOfImage));
+			}
+		}
+		OnModuleRegistered(filename, isSelected);
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::OnModuleRegistered(const std::filesystem::path& modulePath, bool isSelected)
+	{
+		filterAssistant_->OnNewModule(modulePath.wstring(), isSelected);
+		if (isSelected)
+			++monitoredModuleCount_;
+		if (coverageObserver_)
+			coverageObserver_->OnModuleLoaded(modulePath, isSelected);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::NotifyProgress()
+	{
+		if (!coverageObserver_)
+			return;
+
+		CoverageProgress progress;
+		progress.loadedModuleCount_ = loadedModuleCount_;
+		progress.monitoredModuleCount_ = monitoredModuleCount_;
+		progress.executedLineCount_ = executedAddressManager_->GetExecutedLineCount();
+		progress.elapsedTime_ = std::chrono::steady_clock::now() - runStart_;
+		coverageObserver_->OnProgress(progress);
+	}
+
+	//-------------------------------------------------------------------------
+	void CodeCoverageRunner::UpdateMemoryUsages()
+	{
+		if (!memoryTrackers_)
+			return;
+		memoryTrackers_->executedAddresses_.Update(executedAddressManager_->GetMemoryUsage());
+		if (monitoredLineRegister_)
+			memoryTrackers_->lineTables_.Update(monitoredLineRegister_->GetMemoryUsage());
+		if (coverageFilterManager_)
+			memoryTrackers_->filterCaches_.Update(coverageFilterManager_->GetMemoryUsage());
+	}
+
+	//-------------------------------------------------------------------------
+	template <typename RegisterModule>
+	bool CodeCoverageRunner::MeasureModuleRegistration(
+	    const std::filesystem::path& modulePath,
+	    RegisterModule registerModule)
+	{
+		TraceRecorder::ScopedSpan span{traceRecorder_.get(), "Module registration", "module", modulePath.wstring()};
+
+		if (!performanceStatistics_)
+			return registerModule();
+
+		auto start = std::chrono::steady_clock::now();
+		auto armedBreakPointCount = breakpoint_->GetArmedBreakPointCount();
+		auto writtenBytes = Tools::GetWrittenProcessMemoryBytes();
+		auto isSelected = registerModule();
+		auto registrationTime = std::chrono::steady_clock::now() - start;
+		const auto& registrationStatistics = monitoredLineRegister_->GetLastRegistrationStatistics();
+		PerformanceStatistics::ModuleCost moduleCost{};
+
+		moduleCost.path_ = modulePath.wstring();
+		moduleCost.pdbSize_ = GetPdbSize(modulePath);
+		moduleCost.registrationTime_ = registrationTime;
+		moduleCost.debugInformationTime_ = registrationStatistics.enumerationTime_;
+		moduleCost.sourceFileCount_ = registrationStatistics.sourceFileCount_;
+		moduleCost.selectedSourceFileCount_ = registrationStatistics.selectedSourceFileCount_;
+		moduleCost.lineCount_ = registrationStatistics.lineCount_;
+		moduleCost.selectedLineCount_ = registrationStatistics.selectedLineCount_;
+		moduleCost.armedBreakPointCount_ = breakpoint_->GetArmedBreakPointCount() - armedBreakPointCount;
+		moduleCost.writtenBytes_ = Tools::GetWrittenProcessMemoryBytes() - writtenBytes;
+		performanceStatistics_->AddModuleCost(moduleCost);
+		return isSelected;
+	}
+
+	//-------------------------------------------------------------------------
+	int CodeCoverageRunner::RunWithInProcessAgent(const StartInfo& startInfo)
+	{
+		Process process{startInfo};
+		process.Start(CREATE_SUSPENDED);
+
+		const auto& processInformation = process.GetProcessInformation();
+		auto hProcess = processInformation.hProcess;
+
+		try
+		{
+#ifdef _WIN64
+			// The agent and the module enumeration need the process bitness.
+			BOOL isWow64 = FALSE;
+			if (IsWow64Process(hProcess, &isWow64) && isWow64)
+				THROW(L"The in-process agent cannot cover a 32 bits process with the 64 bits version.");
+#endif
+			InProcessAgent agent{hProcess,
+			                     processInformation.dwProcessId,
+			                     InProcessAgent::DefaultPatchCapacity};
+			auto agentPath =
+			    Tools::GetExecutableFolder() / InProcessAgent::AgentFilename;
+
+			// Loading the agent also initializes the process and maps the
+			// static dependencies: register them before the main thread runs.
+			agent.Inject(agentPath);
+			monitoredLineRegister_->EnableArmedBreakPointsTracking();
+
+			for (auto hModule : GetProcessModules(hProcess))
+			{
+				auto filename = GetModuleFilename(hProcess, hModule);
+				if (!boost::algorithm::iends_with(
+				        filename, L"\\" + InProcessAgent::AgentFilename))
+				{
+					LoadModule(hProcess, filename, hModule);
+					agent.AddBreakPoints(
+					    monitoredLineRegister_->TakeArmedBreakPoints());
+				}
+			}
+
+			if (ResumeThread(processInformation.hThread) ==
+			    static_cast<DWORD>(-1))
+				THROW_LAST_ERROR("Error in ResumeThread:", GetLastError());
+
+			while (auto moduleEvent = agent.WaitForModuleEvent())
+			{
+				auto baseOfImage = moduleEvent->baseOfImage_;
+				if (moduleEvent->isLoaded_)
+				{
+					LoadModule(
+					    hProcess, moduleEvent->path_.wstring(), baseOfImage);
+					agent.AddBreakPoints(
+					    monitoredLineRegister_->TakeArmedBreakPoints());
+				}
+				else
+				{
+					auto begin = reinterpret_cast<DWORD64>(baseOfImage);
+					MarkAddressesAsExecuted(
+					    *executedAddressManager_,
+					    hProcess,
+					    agent.RemoveBreakPoints(begin, begin + moduleEvent->size_));
+					executedAddressManager_->OnUnloadModule(hProcess,
+					                                        baseOfImage);
+				}
+				agent.OnModuleEventHandled();
+			}
+
+			MarkAddressesAsExecuted(*executedAddressManager_,
+			                        hProcess,
+			                        agent.GetExecutedAddresses());
+			LOG_INFO << L"In-process agent handled "
+			         << agent.GetExecutedAddressCount() << L" breakpoints.";
+			executedAddressManager_->OnExitProcess(hProcess);
+		}
+		catch (...)
+		{
+			TerminateProcess(hProcess, static_cast<UINT>(-1));
+			throw;
 		}
-		filterAssistant_->OnNewModule(filename, isSelected);
+
+		DWORD exitCode = 0;
+		if (!GetExitCodeProcess(hProcess, &exitCode))
+			THROW_LAST_ERROR("Error in GetExitCodeProcess:", GetLastError());
+		return static_cast<int>(exitCode);
 	}
 }
@@ -16,11 +16,19 @@
 
 #pragma once
 
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <set>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "Plugin/Exporter/CoverageData.hpp"
 #include "IDebugEventsHandler.hpp"
 #include "CppCoverageExport.hpp"
+#include "HandleInformation.hpp"
 
 namespace Tools
 {
@@ -29,6 +37,7 @@ namespace Tools
 
 namespace CppCoverage
 {
+	class Address;
 	class StartInfo;
 	class RunCoverageSettings;
 	class DebugInformationEventHandler;
@@ -39,6 +48,29 @@ namespace CppCoverage
 	class UnifiedDiffSettings;
 	class MonitoredLineRegister;
 	class FilterAssistant;
+	class HitSampler;
+	class AdaptiveArming;
+	class CoverageRegion;
+	class FuzzingBitmap;
+	class IntelPtCollector;
+	class TrampolineInstrumentation;
+	class EtwSampler;
+	class SampledAddressMapper;
+	class TestImpactIndex;
+	class SaturationDetector;
+	class ChildProcessFilter;
+	class DebugStringWriter;
+	class AsyncDebugInformationEnumerator;
+	class DebugInformationCache;
+	class ModuleLoadHistory;
+	class SymbolPrefetcher;
+	class CoverageJournal;
+	class CoverageSummary;
+	class PerformanceStatistics;
+	class TraceRecorder;
+	class LiveCounters;
+	class ICoverageObserver;
+	class ICoverageSource;
 
 	class CPPCOVERAGE_DLL CodeCoverageRunner : private IDebugEventsHandler
 	{
@@ -47,20 +79,62 @@ namespace CppCoverage
 		~CodeCoverageRunner();
 
 		Plugin::CoverageData RunCoverage(const RunCoverageSettings&);
+		// Same as RunCoverage but only the line counts are computed.
+		CoverageSummary RunCoverageSummary(const RunCoverageSettings&);
+		// Same as RunCoverageSummary but writeCoverage also reads the lines
+		// from the collected coverage without creating the coverage data.
+		CoverageSummary RunCoverage(const RunCoverageSettings&,
+		                            const std::function<void(const ICoverageSource&)>& writeCoverage);
 
 	private:
 		virtual void OnCreateProcess(const CREATE_PROCESS_DEBUG_INFO&) override;
 		virtual void OnExitProcess(HANDLE hProcess, HANDLE hThread, const EXIT_PROCESS_DEBUG_INFO&) override;
 		virtual void OnLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
+		virtual bool PostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
+		virtual void CancelPostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
 		virtual void OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&) override;
 		virtual ExceptionType OnException(HANDLE hProcess, HANDLE hThread, const EXCEPTION_DEBUG_INFO&) override;
+		virtual void OnTimer() override;
+		virtual void OnOutputDebugString(HANDLE hProcess, HANDLE hThread, const std::wstring&) override;
+		virtual bool PrepareDetach(HANDLE hProcess) override;
+		virtual void OnDetachProcess(HANDLE hProcess) override;
 
 	private:
 		CodeCoverageRunner(const CodeCoverageRunner&) = delete;
 		CodeCoverageRunner& operator=(const CodeCoverageRunner&) = delete;
 
-		void LoadModule(HANDLE hProcess, HANDLE hFile, void* baseOfImage);
+		int RunProgram(const RunCoverageSettings&);
+		std::wstring ComputeModuleFilename(HANDLE hFile);
+		// Return false when the module is registered later by RegisterEnumeratedModules.
+		bool LoadModule(HANDLE hProcess, HANDLE hFile, void* baseOfImage);
+		bool LoadModule(HANDLE hProcess,
+		                const std::wstring& filename,
+		                void* baseOfImage);
+		// Call registerModule and record the cost of the module for --perf_stats.
+		template <typename RegisterModule>
+		bool MeasureModuleRegistration(const std::filesystem::path& modulePath, RegisterModule);
+		int RunWithInProcessAgent(const StartInfo&);
 		bool OnBreakPoint(const EXCEPTION_DEBUG_INFO&, HANDLE hProcess, HANDLE hThread);
+		void RemoveDisarmedBreakPoints(HANDLE hProcess);
+		void MonitorByBasicBlock(HANDLE hProcess, DWORD64 functionAddress, uint64_t functionLength);
+		void MarkBlockAsExecuted(const Address& monitor);
+		bool OnGuardPageViolation(const EXCEPTION_DEBUG_INFO&, HANDLE hProcess);
+		void OnCoverageRegionMarker(const std::wstring& debugString);
+		void OnTestEndMarker(const std::wstring& debugString);
+		void OnFuzzingMarker(const std::wstring& debugString);
+		void SetRegisteredBreakPoints(HANDLE hProcess, const std::vector<DWORD64>&);
+		void RemoveProcess(HANDLE hProcess);
+		void MarkTracedAddressesAsExecuted(const std::vector<Address>&);
+		void MarkSamplesAsExecuted();
+		size_t RegisterEnumeratedModules(AsyncDebugInformationEnumerator&);
+		bool IsThreadParked(HANDLE hProcess, void* baseOfImage) const;
+		void ResumeParkedThread(HANDLE hProcess, void* baseOfImage);
+		void RegisterDeferredModules();
+		void PrefetchDebugInformation(const std::filesystem::path& program,
+		                              bool prefetchProgram);
+		void UpdateMemoryUsages();
+		void OnModuleRegistered(const std::filesystem::path&, bool isSelected);
+		void NotifyProgress();
 
 	private:
 		std::shared_ptr<BreakPoint> breakpoint_;
@@ -70,6 +144,64 @@ namespace CppCoverage
 		std::unique_ptr<ExceptionHandler> exceptionHandler_;
 		std::shared_ptr<Tools::WarningManager> warningManager_;
 		std::shared_ptr<FilterAssistant> filterAssistant_;
+		std::unique_ptr<HitSampler> hitSampler_;
+		std::unique_ptr<AdaptiveArming> adaptiveArming_;
+		std::unique_ptr<CoverageRegion> coverageRegion_;
+		std::unique_ptr<FuzzingBitmap> fuzzingBitmap_;
+		std::unique_ptr<IntelPtCollector> intelPtCollector_;
+		std::unique_ptr<TrampolineInstrumentation> trampolineInstrumentation_;
+		std::unique_ptr<EtwSampler> etwSampler_;
+		std::unique_ptr<SampledAddressMapper> sampledAddressMapper_;
+		uint64_t mappedSampleCount_;
+		bool isCoverageSampled_;
+		std::shared_ptr<TestImpactIndex> testImpactIndex_;
+		std::map<HANDLE, std::vector<DWORD64>> testHitAddresses_;
+		std::unique_ptr<SaturationDetector> saturationDetector_;
+		std::unique_ptr<ChildProcessFilter> childProcessFilter_;
+		bool isRootProcessCreated_;
+		bool coverChildren_;
+		std::set<HANDLE> unselectedChildren_;
+		std::unique_ptr<DebugStringWriter> debugStringWriter_;
+		bool isReplaying_;
+		std::unique_ptr<AsyncDebugInformationEnumerator> asyncDebugInformationEnumerator_;
+		// One enumerator by module to read the debug information in parallel.
+		std::vector<std::pair<std::filesystem::path, std::unique_ptr<AsyncDebugInformationEnumerator>>>
+		    prefetchedModules_;
+		// The lowercase paths of the modules loaded or prefetched.
+		std::set<std::wstring> knownModules_;
+		std::function<std::unique_ptr<AsyncDebugInformationEnumerator>()>
+		    createAsyncDebugInformationEnumerator_;
+		std::shared_ptr<SymbolPrefetcher> symbolPrefetcher_;
+		std::chrono::milliseconds moduleTimeBudget_;
+		// One enumerator by module which exceeded moduleTimeBudget_.
+		std::vector<std::unique_ptr<AsyncDebugInformationEnumerator>> deferredModules_;
+		struct ParkedThread
+		{
+			HANDLE hThread_;
+			bool isSuspended_;
+		};
+		// The threads loading a module registered later, by process and base of image.
+		std::map<std::pair<HANDLE, void*>, ParkedThread> parkedThreads_;
+		// The modules registered while their thread was parked: their load is reported again.
+		std::set<std::pair<HANDLE, void*>> replayedModules_;
+		std::shared_ptr<DebugInformationCache> debugInformationCache_;
+		// The modules of the previous run are prefetched, the ones of this run are saved.
+		std::unique_ptr<ModuleLoadHistory> moduleLoadHistory_;
+		HandleInformation handleInformation_;
+		std::unique_ptr<CoverageJournal> coverageJournal_;
+		std::chrono::steady_clock::duration coverageJournalPeriod_;
+		std::chrono::steady_clock::time_point nextCoverageJournalSnapshot_;
+		std::shared_ptr<PerformanceStatistics> performanceStatistics_;
+		struct MemoryTrackers;
+		std::unique_ptr<MemoryTrackers> memoryTrackers_;
+		std::shared_ptr<TraceRecorder> traceRecorder_;
+		std::shared_ptr<LiveCounters> liveCounters_;
+		std::shared_ptr<ICoverageObserver> coverageObserver_;
+		size_t loadedModuleCount_;
+		size_t monitoredModuleCount_;
+		std::chrono::steady_clock::time_point nextProgressNotification_;
+		std::chrono::steady_clock::time_point nextTrampolineCountersRead_;
+		std::chrono::steady_clock::time_point runStart_;
 	};
 }
 
@@ -0,0 +1,117 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageBaseline.hpp"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	CoverageBaseline::CoverageBaseline(
+	    const std::vector<Plugin::CoverageData>& coverageDatas)
+	    : executedLineCount_{0}
+	{
+		std::map<std::filesystem::path, ExecutedLinesByFile> allLinesByModule;
+		// boost::none when the coverages of the module have different identities.
+		std::map<std::filesystem::path, boost::optional<std::wstring>> identities;
+
+		for (const auto& coverageData : coverageDatas)
+		{
+			for (const auto& module : coverageData.GetModules())
+			{
+				auto& files = modules_[module->GetPath()];
+				auto& allLines = allLinesByModule[module->GetPath()];
+				auto identity = identities.emplace(module->GetPath(), module->GetIdentity()).first;
+
+				if (identity->second != module->GetIdentity())
+					identity->second = boost::none;
+				for (const auto& file : module->GetFiles())
+				{
+					auto& lines = files[file->GetPath()];
+					auto& fileLines = allLines[file->GetPath()];
+
+					for (const auto& line : file->GetLines())
+					{
+						fileLines.insert(line.GetLineNumber());
+						if (line.HasBeenExecuted() &&
+						    lines.insert(line.GetLineNumber()).second)
+						{
+							++executedLineCount_;
+						}
+					}
+				}
+			}
+		}
+
+		for (const auto& pair : identities)
+		{
+			const auto& modulePath = pair.first;
+			const auto& identity = pair.second;
+			const auto& allLines = allLinesByModule[modulePath];
+			const auto& executedLines = modules_[modulePath];
+			auto isCovered = std::all_of(allLines.begin(), allLines.end(), [&](const auto& file) {
+				return file.second.size() == executedLines.at(file.first).size();
+			});
+			auto hasLines = std::any_of(allLines.begin(), allLines.end(), [](const auto& file) {
+				return !file.second.empty();
+			});
+
+			if (identity && !identity->empty() && isCovered && hasLines)
+				coveredModuleIdentities_.emplace(modulePath, *identity);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageBaseline::IsLineExecuted(
+	    const std::filesystem::path& modulePath,
+	    const std::filesystem::path& filePath,
+	    unsigned int lineNumber) const
+	{
+		auto itModule = modules_.find(modulePath);
+
+		if (itModule == modules_.end())
+			return false;
+
+		const auto& files = itModule->second;
+		auto itFile = files.find(filePath);
+
+		return itFile != files.end() && itFile->second.count(lineNumber) != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageBaseline::IsModuleCovered(
+	    const std::filesystem::path& modulePath,
+	    const std::wstring& identity) const
+	{
+		auto it = coveredModuleIdentities_.find(modulePath);
+
+		return it != coveredModuleIdentities_.end() && it->second == identity;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CoverageBaseline::GetExecutedLineCount() const
+	{
+		return executedLineCount_;
+	}
+}
@@ -0,0 +1,60 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	// Lines already executed in previous coverage results.
+	class CPPCOVERAGE_DLL CoverageBaseline
+	{
+	  public:
+		explicit CoverageBaseline(const std::vector<Plugin::CoverageData>&);
+
+		bool IsLineExecuted(const std::filesystem::path& modulePath,
+		                    const std::filesystem::path& filePath,
+		                    unsigned int lineNumber) const;
+		size_t GetExecutedLineCount() const;
+		// True when all the lines of the module are executed and when all the
+		// coverages of the module have this identity.
+		bool IsModuleCovered(const std::filesystem::path& modulePath,
+		                     const std::wstring& identity) const;
+
+	  private:
+		CoverageBaseline(const CoverageBaseline&) = delete;
+		CoverageBaseline& operator=(const CoverageBaseline&) = delete;
+
+		using ExecutedLinesByFile =
+		    std::map<std::filesystem::path, std::set<unsigned int>>;
+
+		std::map<std::filesystem::path, ExecutedLinesByFile> modules_;
+		std::map<std::filesystem::path, std::wstring> coveredModuleIdentities_;
+		size_t executedLineCount_;
+	};
+}
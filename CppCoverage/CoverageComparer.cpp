@@ -0,0 +1,229 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageComparer.hpp"
+
+#include <bitset>
+#include <fstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "Tools/PathTable.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace fs = std::filesystem;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const std::string Header = "OpenCppCoverage coverage comparison 1";
+		const size_t BitsByWord = 64;
+
+		// Bit n is set when the line n is executed.
+		using Bitmap = std::vector<uint64_t>;
+
+		//---------------------------------------------------------------------
+		// A path can appear several times when the coverage is not merged.
+		template <typename Child>
+		struct AlignedChildren
+		{
+			fs::path path_;
+			std::vector<const Child*> first_;
+			std::vector<const Child*> second_;
+		};
+
+		//---------------------------------------------------------------------
+		// The children are sorted by path.
+		template <typename Child>
+		std::vector<AlignedChildren<Child>> AlignChildren(
+		    const std::vector<const std::vector<std::unique_ptr<Child>>*>& firstCollections,
+		    const std::vector<const std::vector<std::unique_ptr<Child>>*>& secondCollections)
+		{
+			Tools::PathTable pathTable;
+			std::vector<AlignedChildren<Child>> childrenById;
+			auto add = [&](const auto& collections, auto member) {
+				for (const auto* collection : collections)
+				{
+					for (const auto& child : *collection)
+					{
+						auto id = pathTable.Intern(child->GetPath());
+						if (id == childrenById.size())
+							childrenById.push_back({child->GetPath(), {}, {}});
+						(childrenById[id].*member).push_back(child.get());
+					}
+				}
+			};
+			add(firstCollections, &AlignedChildren<Child>::first_);
+			add(secondCollections, &AlignedChildren<Child>::second_);
+
+			std::vector<AlignedChildren<Child>> children;
+			for (auto id : pathTable.GetSortedIds())
+				children.push_back(std::move(childrenById[id]));
+			return children;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<const Plugin::ModuleCoverage::T_FileCoverageCollection*>
+		GetFileCollections(const std::vector<const Plugin::ModuleCoverage*>& modules)
+		{
+			std::vector<const Plugin::ModuleCoverage::T_FileCoverageCollection*> collections;
+
+			for (const auto* module : modules)
+				collections.push_back(&module->GetFiles());
+			return collections;
+		}
+
+		//---------------------------------------------------------------------
+		Bitmap CreateBitmap(const std::vector<const Plugin::FileCoverage*>& files)
+		{
+			Bitmap bitmap;
+
+			for (const auto* file : files)
+			{
+				for (const auto& line : file->GetLines())
+				{
+					if (!line.HasBeenExecuted())
+						continue;
+					auto lineNumber = line.GetLineNumber();
+					auto index = lineNumber / BitsByWord;
+					if (index >= bitmap.size())
+						bitmap.resize(index + 1);
+					bitmap[index] |= uint64_t{1} << (lineNumber % BitsByWord);
+				}
+			}
+			return bitmap;
+		}
+
+		//---------------------------------------------------------------------
+		void AddLines(uint64_t bits, size_t wordIndex, std::vector<unsigned int>& lines)
+		{
+			for (size_t bit = 0; bits; ++bit, bits >>= 1)
+			{
+				if (bits & 1)
+					lines.push_back(static_cast<unsigned int>(wordIndex * BitsByWord + bit));
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// 64 lines are compared at once and the words without difference
+		// are skipped.
+		void CompareBitmaps(Bitmap& first,
+		                    Bitmap& second,
+		                    CoverageComparer::FileComparison& fileComparison,
+		                    size_t& commonLineCount)
+		{
+			auto wordCount = (std::max)(first.size(), second.size());
+			first.resize(wordCount);
+			second.resize(wordCount);
+
+			for (size_t i = 0; i < wordCount; ++i)
+			{
+				commonLineCount += std::bitset<BitsByWord>{first[i] & second[i]}.count();
+
+				auto difference = first[i] ^ second[i];
+				if (!difference)
+					continue;
+				AddLines(difference & second[i], i, fileComparison.newlyCoveredLines_);
+				AddLines(difference & first[i], i, fileComparison.newlyUncoveredLines_);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Write "+ 3-5 9" for the lines 3, 4, 5 and 9.
+		void WriteLines(std::ostream& ostr, char prefix, const std::vector<unsigned int>& lines)
+		{
+			if (lines.empty())
+				return;
+
+			ostr << prefix;
+			for (size_t i = 0; i < lines.size();)
+			{
+				auto last = i;
+				while (last + 1 < lines.size() && lines[last + 1] == lines[last] + 1)
+					++last;
+				ostr << ' ' << lines[i];
+				if (last != i)
+					ostr << '-' << lines[last];
+				i = last + 1;
+			}
+			ostr << '\n';
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageComparer::Comparison CoverageComparer::Compare(
+	    const Plugin::CoverageData& first,
+	    const Plugin::CoverageData& second) const
+	{
+		Comparison comparison;
+
+		for (const auto& module : AlignChildren<Plugin::ModuleCoverage>({&first.GetModules()},
+		                                                                 {&second.GetModules()}))
+		{
+			for (const auto& file : AlignChildren<Plugin::FileCoverage>(
+			         GetFileCollections(module.first_), GetFileCollections(module.second_)))
+			{
+				FileComparison fileComparison;
+				auto firstBitmap = CreateBitmap(file.first_);
+				auto secondBitmap = CreateBitmap(file.second_);
+
+				CompareBitmaps(firstBitmap, secondBitmap, fileComparison, comparison.commonLineCount_);
+				if (fileComparison.newlyCoveredLines_.empty() &&
+				    fileComparison.newlyUncoveredLines_.empty())
+					continue;
+
+				fileComparison.modulePath_ = module.path_;
+				fileComparison.filePath_ = file.path_;
+				comparison.newlyCoveredLineCount_ += fileComparison.newlyCoveredLines_.size();
+				comparison.newlyUncoveredLineCount_ += fileComparison.newlyUncoveredLines_.size();
+				comparison.files_.push_back(std::move(fileComparison));
+			}
+		}
+		return comparison;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageComparer::Write(const Comparison& comparison, const fs::path& path) const
+	{
+		std::ofstream ofs{path, std::ios::binary};
+
+		if (!ofs)
+			THROW(L"Cannot write " << path.wstring());
+		ofs << Header << '\n';
+
+		const fs::path* modulePath = nullptr;
+		for (const auto& file : comparison.files_)
+		{
+			if (!modulePath || *modulePath != file.modulePath_)
+			{
+				modulePath = &file.modulePath_;
+				ofs << "M " << modulePath->u8string() << '\n';
+			}
+			ofs << "F " << file.filePath_.u8string() << '\n';
+			WriteLines(ofs, '+', file.newlyCoveredLines_);
+			WriteLines(ofs, '-', file.newlyUncoveredLines_);
+		}
+		ofs.flush();
+		if (!ofs)
+			THROW(L"Error while writing " << path.wstring());
+	}
+}
@@ -0,0 +1,71 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	// Compare the executed lines of two coverages: what the second one
+	// covers that the first one does not and the reverse. Modules and files
+	// are aligned by path like CoverageDataMerger.
+	class CPPCOVERAGE_DLL CoverageComparer
+	{
+	  public:
+		struct FileComparison
+		{
+			std::filesystem::path modulePath_;
+			std::filesystem::path filePath_;
+			// Executed by the second coverage only.
+			std::vector<unsigned int> newlyCoveredLines_;
+			// Executed by the first coverage only.
+			std::vector<unsigned int> newlyUncoveredLines_;
+		};
+
+		struct Comparison
+		{
+			// Only the files with a difference, sorted by module and file.
+			std::vector<FileComparison> files_;
+			size_t newlyCoveredLineCount_ = 0;
+			size_t newlyUncoveredLineCount_ = 0;
+			// Executed by both coverages.
+			size_t commonLineCount_ = 0;
+		};
+
+		CoverageComparer() = default;
+
+		Comparison Compare(const Plugin::CoverageData& first,
+		                   const Plugin::CoverageData& second) const;
+
+		// One "M <module>" line by module, one "F <file>" line by file then
+		// "+" and "-" lines with the newly covered and uncovered lines, for
+		// example "+ 3-5 9".
+		void Write(const Comparison&, const std::filesystem::path&) const;
+
+	  private:
+		CoverageComparer(const CoverageComparer&) = delete;
+		CoverageComparer& operator=(const CoverageComparer&) = delete;
+	};
+}
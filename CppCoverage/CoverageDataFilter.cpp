@@ -0,0 +1,118 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataFilter.hpp"
+
+#include <vector>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "FileFilter/ModuleInfo.hpp"
+#include "FileFilter/FileInfo.hpp"
+#include "FileFilter/LineInfo.hpp"
+
+#include "ICoverageFilterManager.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	CoverageDataFilter::CoverageDataFilter(ICoverageFilterManager& coverageFilterManager)
+		: coverageFilterManager_{ coverageFilterManager }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageDataFilter::IsModuleSelected(const std::filesystem::path& modulePath) const
+	{
+		return coverageFilterManager_.IsModuleSelected(modulePath.wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageDataFilter::Filter(const Plugin::CoverageData& coverageData)
+	{
+		Plugin::CoverageData filteredCoverageData{ coverageData.GetName(), coverageData.GetExitCode() };
+		filteredCoverageData.SetSampled(coverageData.IsSampled());
+		std::vector<std::wstring> selectedFiles;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			if (IsModuleSelected(module->GetPath()))
+			{
+				for (const auto& file : module->GetFiles())
+				{
+					if (coverageFilterManager_.IsSourceFileSelected(file->GetPath().wstring()))
+						selectedFiles.push_back(file->GetPath().wstring());
+				}
+			}
+		}
+		coverageFilterManager_.PrefetchSourceFiles(selectedFiles);
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			if (!IsModuleSelected(module->GetPath()))
+				continue;
+
+			// The module is added with its first selected file.
+			Plugin::ModuleCoverage* filteredModule = nullptr;
+			FileFilter::ModuleInfo moduleInfo{ nullptr, module->GetPath(), nullptr };
+
+			for (const auto& file : module->GetFiles())
+			{
+				if (!coverageFilterManager_.IsSourceFileSelected(file->GetPath().wstring()))
+					continue;
+
+				const auto& lines = file->GetLines();
+				std::vector<FileFilter::LineInfo> lineInfos;
+
+				// The addresses are not recorded: only the filters using the
+				// line numbers can be applied.
+				lineInfos.reserve(lines.size());
+				for (const auto& line : lines)
+					lineInfos.emplace_back(static_cast<int>(line.GetLineNumber()), 0, 0);
+
+				FileFilter::FileInfo fileInfo{ file->GetPath(), std::move(lineInfos) };
+				auto selectedLines = coverageFilterManager_.SelectLines(moduleInfo, fileInfo);
+				std::vector<Plugin::LineCoverage> filteredLines;
+
+				for (size_t i = 0; i < lines.size(); ++i)
+				{
+					if (selectedLines[i])
+						filteredLines.push_back(lines[i]);
+				}
+				if (filteredLines.empty())
+					continue;
+
+				if (!filteredModule)
+				{
+					filteredModule = &filteredCoverageData.AddModule(module->GetPath());
+					filteredModule->SetIdentity(module->GetIdentity());
+				}
+				auto& filteredFile = filteredModule->AddFile(file->GetPath());
+
+				// The lines are shared when they are all selected.
+				if (filteredLines.size() == lines.size())
+					filteredFile = *file;
+				else
+					filteredFile.SetLines(std::move(filteredLines));
+			}
+		}
+		return filteredCoverageData;
+	}
+}
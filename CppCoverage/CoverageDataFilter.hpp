@@ -0,0 +1,50 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	class ICoverageFilterManager;
+
+	// Apply the filters of a run to coverage data already recorded, for
+	// example with other --sources. The release filter is not supported as
+	// it requires the process.
+	class CPPCOVERAGE_DLL CoverageDataFilter
+	{
+	public:
+		explicit CoverageDataFilter(ICoverageFilterManager&);
+
+		bool IsModuleSelected(const std::filesystem::path&) const;
+		// The modules and the files without selected lines are removed.
+		Plugin::CoverageData Filter(const Plugin::CoverageData&);
+
+	private:
+		CoverageDataFilter(const CoverageDataFilter&) = delete;
+		CoverageDataFilter& operator=(const CoverageDataFilter&) = delete;
+
+		ICoverageFilterManager& coverageFilterManager_;
+	};
+}
@@ -17,6 +17,7 @@
 #include "stdafx.h"
 #include "CoverageDataMerger.hpp"
 
+#include <algorithm>
 #include <functional>
 
 #include "Plugin/Exporter/CoverageData.hpp"
@@ -24,17 +25,24 @@
 #include "Plugin/Exporter/FileCoverage.hpp"
 #include "Plugin/Exporter/LineCoverage.hpp"
 
+#include "Tools/PathTable.hpp"
+#include "Tools/ThreadPool.hpp"
+
 namespace fs = std::filesystem;
 
 namespace CppCoverage
 {
 	namespace
 	{
+		const size_t MinModuleCountByWorker = 2;
+		const size_t MinFileCountByWorker = 64;
+
 		//---------------------------------------------------------------------
 		Plugin::CoverageData CreateCoverageData(const std::vector<Plugin::CoverageData>& coverageDataCollection)
 		{
 			std::wstring name;
 			int lastNotZeroExitCode = 0;
+			bool isSampled = false;
 
 			for (const auto& coverageData : coverageDataCollection)
 			{
@@ -42,60 +50,112 @@ namespace CppCoverage
 				auto exitCode = coverageData.GetExitCode();
 				if (exitCode)
 					lastNotZeroExitCode = exitCode;
+				isSampled = isSampled || coverageData.IsSampled();
 			}
 
-			return Plugin::CoverageData{ name, lastNotZeroExitCode };
+			Plugin::CoverageData coverageData{ name, lastNotZeroExitCode };
+			coverageData.SetSampled(isSampled);
+			return coverageData;
 		}
 		
 		//---------------------------------------------------------------------
-		template <typename Object, typename Key, typename Child>
-		std::map<Key, std::vector<Child*>> GroupChildrenByKey(
+		template <typename Child>
+		using ChildrenByPath = std::vector<std::pair<fs::path, std::vector<Child*>>>;
+
+		//---------------------------------------------------------------------
+		// The groups are sorted by path.
+		template <typename Object, typename Child>
+		ChildrenByPath<Child> GroupChildrenByPath(
 			const std::vector<Object>& collection,
 			const std::function<const std::vector<std::unique_ptr<Child>>& (const Object&)>& getChildren,
-			const std::function<const Key& (const Child&)>& getKey)
-		{			
-			std::map<Key, std::vector<Child*>> childrenByKey;
+			const std::function<const fs::path& (const Child&)>& getPath)
+		{
+			Tools::PathTable pathTable;
+			std::vector<std::vector<Child*>> childrenById;
 
 			for (const auto& object : collection)
-			{					
+			{
 				for (const auto& child : getChildren(object))
 				{
-					const auto& key = getKey(*child);
+					auto id = pathTable.Intern(getPath(*child));
 
-					childrenByKey[key].push_back(child.get());
+					if (id == childrenById.size())
+						childrenById.emplace_back();
+					childrenById[id].push_back(child.get());
 				}
 			}
 
-			return childrenByKey;
+			ChildrenByPath<Child> childrenByPath;
+			for (auto id : pathTable.GetSortedIds())
+				childrenByPath.emplace_back(pathTable.GetPath(id), std::move(childrenById[id]));
+			return childrenByPath;
 		}
 		
 		//---------------------------------------------------------------------
+		Plugin::LineCoverage MergeLine(
+			const Plugin::LineCoverage& destinationLine,
+			const Plugin::LineCoverage& sourceLine)
+		{
+			if (!sourceLine.HasBeenExecuted())
+				return destinationLine;
+
+			// The first hits of different runs cannot be ordered:
+			// keep the ones of the first run.
+			const auto& firstHitLine =
+			    destinationLine.GetFirstHitOrder() ? destinationLine : sourceLine;
+			return Plugin::LineCoverage{destinationLine.GetLineNumber(),
+			                            true,
+			                            destinationLine.GetHitCount() + sourceLine.GetHitCount(),
+			                            firstHitLine.GetFirstHitOrder(),
+			                            firstHitLine.GetFirstHitTime()};
+		}
+
+		//---------------------------------------------------------------------
+		// Both files have their lines sorted: they are merged in a single pass.
 		void AddFileCoverageTo(
 			const Plugin::FileCoverage* sourceFile,
 			Plugin::FileCoverage* destinationFile)
 		{
 			if (sourceFile && destinationFile)
 			{
-				for (const auto& line : sourceFile->GetLines())
-				{
-					auto lineNumber = line.GetLineNumber();
-					auto hasBeenExecuted = line.HasBeenExecuted();
+				const auto& sourceLines = sourceFile->GetLines();
+				const auto& destinationLines = destinationFile->GetLines();
+				std::vector<Plugin::LineCoverage> lines;
+				auto sourceIt = sourceLines.begin();
+				auto destinationIt = destinationLines.begin();
 
-					if (!(*destinationFile)[lineNumber])
-						destinationFile->AddLine(lineNumber, hasBeenExecuted);
-					else if (hasBeenExecuted)
-						destinationFile->UpdateLine(lineNumber, true);
+				lines.reserve((std::max)(sourceLines.size(), destinationLines.size()));
+				while (sourceIt != sourceLines.end() || destinationIt != destinationLines.end())
+				{
+					if (destinationIt == destinationLines.end() ||
+					    (sourceIt != sourceLines.end() &&
+					     sourceIt->GetLineNumber() < destinationIt->GetLineNumber()))
+					{
+						lines.push_back(*sourceIt++);
+					}
+					else if (sourceIt == sourceLines.end() ||
+					         destinationIt->GetLineNumber() < sourceIt->GetLineNumber())
+					{
+						lines.push_back(*destinationIt++);
+					}
+					else
+						lines.push_back(MergeLine(*destinationIt++, *sourceIt++));
 				}
+				destinationFile->SetLines(std::move(lines));
 			}
 		}
 
 		//---------------------------------------------------------------------
+		// files is not empty.
 		void FillFiles(
 			Plugin::FileCoverage& file,
 			const std::vector<Plugin::FileCoverage*>& files)
 		{
-			for (const auto& f : files)
-				AddFileCoverageTo(f, &file);
+			// The lines of the first file are shared and copied only when
+			// another file is merged.
+			file = *files.front();
+			for (size_t i = 1; i < files.size(); ++i)
+				AddFileCoverageTo(files[i], &file);
 		}
 
 		//---------------------------------------------------------------------
@@ -103,8 +163,8 @@ namespace CppCoverage
 			Plugin::ModuleCoverage& module,
 			const std::vector<Plugin::ModuleCoverage*>& modules)
 		{
-			std::map<fs::path, std::vector<Plugin::FileCoverage*>> filesByPath =
-				GroupChildrenByKey<Plugin::ModuleCoverage*, fs::path, Plugin::FileCoverage>(
+			auto filesByPath =
+				GroupChildrenByPath<Plugin::ModuleCoverage*, Plugin::FileCoverage>(
 				modules,
 				[](const Plugin::ModuleCoverage* m) -> const Plugin::ModuleCoverage::T_FileCoverageCollection&{ return m->GetFiles(); },
 				[](const Plugin::FileCoverage& file) -> const fs::path&{ return file.GetPath(); });
@@ -114,6 +174,89 @@ namespace CppCoverage
 				auto& file = module.AddFile(pair.first);
 				FillFiles(file, pair.second);
 			}
+			// The last coverage is the most recent build of the module.
+			for (const auto* mergedModule : modules)
+			{
+				if (!mergedModule->GetIdentity().empty())
+					module.SetIdentity(mergedModule->GetIdentity());
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// True when the paths are sorted and unique, as after a merge.
+		template <typename Object>
+		bool IsSortedByPath(const std::vector<std::unique_ptr<Object>>& objects)
+		{
+			return std::adjacent_find(objects.begin(), objects.end(),
+				[](const auto& object1, const auto& object2) {
+					return !(object1->GetPath() < object2->GetPath());
+				}) == objects.end();
+		}
+
+		//---------------------------------------------------------------------
+		bool IsMerged(const Plugin::CoverageData& coverageData)
+		{
+			const auto& modules = coverageData.GetModules();
+
+			return IsSortedByPath(modules) &&
+				std::all_of(modules.begin(), modules.end(), [](const auto& module) {
+					return IsSortedByPath(module->GetFiles());
+				});
+		}
+
+		//-------------------------------------------------------------------------
+		std::vector<std::vector<Plugin::FileCoverage*>>
+		GroupFileCoveragesByPath(const Plugin::CoverageData& coverageData)
+		{
+			Tools::PathTable pathTable;
+			std::vector<std::vector<Plugin::FileCoverage*>> fileCoveragesById;
+
+			for (const auto& module : coverageData.GetModules())
+			{
+				for (const auto& file : module->GetFiles())
+				{
+					auto id = pathTable.Intern(file->GetPath());
+
+					if (id == fileCoveragesById.size())
+						fileCoveragesById.emplace_back();
+					fileCoveragesById[id].push_back(file.get());
+				}
+			}
+			return fileCoveragesById;
+		}
+
+		//-------------------------------------------------------------------------
+		// The files with the same path can share their lines: they still share
+		// them after.
+		void RemoveFirstHits(const std::vector<Plugin::FileCoverage*>& fileCoverages)
+		{
+			std::vector<std::pair<const std::vector<Plugin::LineCoverage>*, Plugin::FileCoverage*>> updatedFiles;
+
+			for (auto* fileCoverage : fileCoverages)
+			{
+				const auto& lines = fileCoverage->GetLines();
+				auto it = std::find_if(updatedFiles.begin(), updatedFiles.end(), [&](const auto& updatedFile) {
+					return updatedFile.first == &lines;
+				});
+
+				if (it != updatedFiles.end())
+				{
+					*fileCoverage = *it->second;
+					continue;
+				}
+				updatedFiles.emplace_back(&lines, fileCoverage);
+				if (std::none_of(lines.begin(), lines.end(), [](const auto& line) { return line.GetFirstHitOrder(); }))
+					continue;
+
+				std::vector<Plugin::LineCoverage> linesWithoutFirstHits;
+				linesWithoutFirstHits.reserve(lines.size());
+				for (const auto& line : lines)
+				{
+					linesWithoutFirstHits.emplace_back(
+					    line.GetLineNumber(), line.HasBeenExecuted(), line.GetHitCount());
+				}
+				fileCoverage->SetLines(std::move(linesWithoutFirstHits));
+			}
 		}
 
 		//-------------------------------------------------------------------------
@@ -128,6 +271,7 @@ namespace CppCoverage
 				for (const auto* fileCoverage : mutableFileCoverages)
 					AddFileCoverageTo(fileCoverage, fileCoverageSum);
 
+				// The files share the lines of the sum.
 				for (auto* fileCoverage : mutableFileCoverages)
 					*fileCoverage = *fileCoverageSum;
 			}
@@ -140,37 +284,69 @@ namespace CppCoverage
 	{
 		auto coverageData = CreateCoverageData(coverageDataCollection);
 
-		std::map<fs::path, std::vector<Plugin::ModuleCoverage*>> modulesByPath =
-			GroupChildrenByKey<Plugin::CoverageData, fs::path, Plugin::ModuleCoverage>(
+		auto modulesByPath =
+			GroupChildrenByPath<Plugin::CoverageData, Plugin::ModuleCoverage>(
 				coverageDataCollection,
 				[](const Plugin::CoverageData& data) -> const Plugin::CoverageData::T_ModuleCoverageCollection& { return data.GetModules(); },
 				[](const Plugin::ModuleCoverage& module) -> const fs::path& { return module.GetPath(); });
 		
+		// The modules are added in order and then filled in parallel.
+		std::vector<Plugin::ModuleCoverage*> modules;
+		coverageData.ReserveModules(modulesByPath.size());
 		for (const auto& pair : modulesByPath)
-		{
-			auto& module = coverageData.AddModule(pair.first);
-			FillModule(module, pair.second);
-		}
+			modules.push_back(&coverageData.AddModule(pair.first));
+		Tools::ParallelFor(modules.size(), MinModuleCountByWorker, [&](size_t i) {
+			FillModule(*modules[i], modulesByPath[i].second);
+		});
 		
 		return coverageData;
 	}
 
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageDataMerger::Merge(
+		std::vector<Plugin::CoverageData>&& coverageDataCollection) const
+	{
+		if (coverageDataCollection.size() == 1 && IsMerged(coverageDataCollection.front()))
+			return std::move(coverageDataCollection.front());
+
+		const auto& constCoverageDataCollection = coverageDataCollection;
+		return Merge(constCoverageDataCollection);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataMerger::MergeInto(
+		Plugin::CoverageData& sum,
+		Plugin::CoverageData&& coverageData) const
+	{
+		std::vector<Plugin::CoverageData> coverageDataCollection;
+
+		coverageDataCollection.push_back(std::move(sum));
+		coverageDataCollection.push_back(std::move(coverageData));
+
+		// Each call walks all the modules and files of the sum: only the
+		// lines of the files in one of them are not copied but shared.
+		const auto& constCoverageDataCollection = coverageDataCollection;
+		sum = Merge(constCoverageDataCollection);
+	}
+
 	//-------------------------------------------------------------------------
 	void CoverageDataMerger::MergeFileCoverage(Plugin::CoverageData& coverageData) const
 	{
-		std::map<std::filesystem::path, std::vector<Plugin::FileCoverage*>> fileCoveragesByPath;
+		auto fileCoveragesById = GroupFileCoveragesByPath(coverageData);
 
-		for (const auto& module : coverageData.GetModules())
-		{
-			for (const auto& file : module->GetFiles())
-				fileCoveragesByPath[file->GetPath()].push_back(file.get());
-		}
+		// Files with different paths do not share their lines.
+		Tools::ParallelFor(fileCoveragesById.size(), MinFileCountByWorker, [&](size_t i) {
+			MergeFileCoverages(fileCoveragesById[i]);
+		});
+	}
 
-		for (const auto& fileCoverageByPath : fileCoveragesByPath)
-		{
-			const auto& fileCoverages = fileCoverageByPath.second;
+	//-------------------------------------------------------------------------
+	void CoverageDataMerger::RemoveFirstHits(Plugin::CoverageData& coverageData) const
+	{
+		auto fileCoveragesById = GroupFileCoveragesByPath(coverageData);
 
-			MergeFileCoverages(fileCoverages);
-		}
+		Tools::ParallelFor(fileCoveragesById.size(), MinFileCountByWorker, [&](size_t i) {
+			RemoveFirstHits(fileCoveragesById[i]);
+		});
 	}
 }
@@ -31,7 +31,15 @@ namespace CppCoverage
 		CoverageDataMerger() = default;
 		
 		Plugin::CoverageData Merge(const std::vector<Plugin::CoverageData>&) const;
+		// A single coverage data already merged is returned without copy.
+		Plugin::CoverageData Merge(std::vector<Plugin::CoverageData>&&) const;
+		// Same result as Merge({ sum, coverageData }) without keeping all the
+		// inputs alive: fold the coverage data one by one to bound the memory.
+		void MergeInto(Plugin::CoverageData& sum, Plugin::CoverageData&& coverageData) const;
 		void MergeFileCoverage(Plugin::CoverageData&) const;
+		// The first hits depend on the scheduling of the threads of the
+		// program: they are removed from the deterministic exports.
+		void RemoveFirstHits(Plugin::CoverageData&) const;
 
 	private:
 		CoverageDataMerger(const CoverageDataMerger&) = delete;
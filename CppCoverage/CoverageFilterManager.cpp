@@ -25,6 +25,8 @@
 #include "FileFilter/LineInfo.hpp"
 #include "FileFilter/ReleaseCoverageFilter.hpp"
 
+#include "Tools/MemoryUsage.hpp"
+
 namespace CppCoverage
 {
 	//-------------------------------------------------------------------------
@@ -32,10 +34,12 @@ namespace CppCoverage
 		const CoverageFilterSettings& settings,
 		const std::vector<UnifiedDiffSettings>& unifiedDiffSettingsCollection,
 		const std::vector<std::wstring>& excludedLineRegexes,
-		bool useReleaseCoverageFilter)
+		bool useReleaseCoverageFilter,
+		const FileFilter::ExclusionMarkers& exclusionMarkers,
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
 		: wildcardCoverageFilter_{ settings }
 		, unifiedDiffCoverageFilterManager_{ unifiedDiffSettingsCollection }
-		, lineFilter_{ excludedLineRegexes }
+		, lineFilter_{ excludedLineRegexes, true, exclusionMarkers, sourceFileCache }
 		, optionalReleaseCoverageFilter_{ useReleaseCoverageFilter ?
 			std::make_unique<FileFilter::ReleaseCoverageFilter>() : nullptr }		
 	{
@@ -47,16 +51,26 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	bool CoverageFilterManager::IsModuleSelected(const std::wstring& filename) const
 	{
-		return wildcardCoverageFilter_.IsModuleSelected(filename);
+		auto it = selectedModules_.find(filename);
+		if (it == selectedModules_.end())
+		{
+			auto isSelected = wildcardCoverageFilter_.IsModuleSelected(filename);
+			it = selectedModules_.emplace(filename, isSelected).first;
+		}
+		return it->second;
 	}
 
 	//-------------------------------------------------------------------------
 	bool CoverageFilterManager::IsSourceFileSelected(const std::wstring& filename)
 	{
-		if (!wildcardCoverageFilter_.IsSourceFileSelected(filename))
-			return false;
-
-		return unifiedDiffCoverageFilterManager_.IsSourceFileSelected(filename);
+		auto it = selectedSourceFiles_.find(filename);
+		if (it == selectedSourceFiles_.end())
+		{
+			auto isSelected = wildcardCoverageFilter_.IsSourceFileSelected(filename) &&
+				unifiedDiffCoverageFilterManager_.IsSourceFileSelected(filename);
+			it = selectedSourceFiles_.emplace(filename, isSelected).first;
+		}
+		return it->second;
 	}
 
 	//-------------------------------------------------------------------------
@@ -77,9 +91,60 @@ namespace CppCoverage
 		return unifiedDiffCoverageFilterManager_.IsLineSelected(fileInfo, lineInfo);
 	}
 
+	//-------------------------------------------------------------------------
+	std::vector<bool> CoverageFilterManager::SelectLines(
+		const FileFilter::ModuleInfo& moduleInfo,
+		const FileFilter::FileInfo& fileInfo)
+	{
+		const auto& lineInfos = fileInfo.lineInfoColllection_;
+		std::vector<bool> selectedLines(lineInfos.size(), true);
+
+		// Each filter only sees the lines the previous ones selected, as with
+		// IsLineSelected.
+		if (optionalReleaseCoverageFilter_)
+		{
+			for (size_t i = 0; i < lineInfos.size(); ++i)
+				selectedLines[i] = optionalReleaseCoverageFilter_->IsLineSelected(moduleInfo, fileInfo, lineInfos[i]);
+		}
+		lineFilter_.SelectLines(fileInfo, selectedLines);
+		unifiedDiffCoverageFilterManager_.SelectLines(fileInfo, selectedLines);
+
+		return selectedLines;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageFilterManager::PrefetchSourceFiles(const std::vector<std::wstring>& filenames)
+	{
+		lineFilter_.Prefetch(filenames);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::set<int>> CoverageFilterManager::GetSelectedLineNumbers(
+		const std::wstring& filename)
+	{
+		// The release filter needs all the lines of the file.
+		if (optionalReleaseCoverageFilter_)
+			return boost::none;
+
+		return unifiedDiffCoverageFilterManager_.GetSelectedLines(filename);
+	}
+
 	//-------------------------------------------------------------------------
 	std::vector<std::wstring> CoverageFilterManager::ComputeWarningMessageLines(size_t maxUnmatchPaths) const
 	{
 		return unifiedDiffCoverageFilterManager_.ComputeWarningMessageLines(maxUnmatchPaths);
 	}
+
+	//-------------------------------------------------------------------------
+	uint64_t CoverageFilterManager::GetMemoryUsage() const
+	{
+		uint64_t bytes = Tools::GetHashNodesSize(selectedModules_) +
+		                 Tools::GetHashNodesSize(selectedSourceFiles_);
+
+		for (const auto& pair : selectedModules_)
+			bytes += Tools::GetAllocatedSize(pair.first);
+		for (const auto& pair : selectedSourceFiles_)
+			bytes += Tools::GetAllocatedSize(pair.first);
+		return bytes;
+	}
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <memory>
+#include <unordered_map>
 
 #include "CppCoverageExport.hpp"
 #include "WildcardCoverageFilter.hpp"
@@ -41,7 +42,9 @@ namespace CppCoverage
 			const CoverageFilterSettings&,
 			const std::vector<UnifiedDiffSettings>&,
 			const std::vector<std::wstring>& excludedLineRegexes,
-			bool useReleaseCoverageFilter);
+			bool useReleaseCoverageFilter,
+			const FileFilter::ExclusionMarkers& = {},
+			std::shared_ptr<Tools::SourceFileCache> = nullptr);
 
 		~CoverageFilterManager();
 
@@ -51,9 +54,17 @@ namespace CppCoverage
 			const FileFilter::ModuleInfo&,
 			const FileFilter::FileInfo&,
 			const FileFilter::LineInfo&) override;
+		std::vector<bool> SelectLines(
+			const FileFilter::ModuleInfo&,
+			const FileFilter::FileInfo&) override;
+		void PrefetchSourceFiles(const std::vector<std::wstring>&) override;
+		boost::optional<std::set<int>> GetSelectedLineNumbers(const std::wstring& filename) override;
 
 		std::vector<std::wstring> ComputeWarningMessageLines(size_t maxUnmatchPaths) const;
 
+		// Estimated bytes of the modules and source files already filtered.
+		uint64_t GetMemoryUsage() const;
+
 	private:
 		CoverageFilterManager(const CoverageFilterManager&) = delete;
 		CoverageFilterManager& operator=(const CoverageFilterManager&) = delete;
@@ -63,5 +74,10 @@ namespace CppCoverage
 		FileFilter::LineFilter lineFilter_;
 
 		const std::unique_ptr<FileFilter::ReleaseCoverageFilter> optionalReleaseCoverageFilter_;
+
+		// The same modules are loaded by each process and the same headers
+		// are shared by most of the modules: the filters are applied once by path.
+		mutable std::unordered_map<std::wstring, bool> selectedModules_;
+		std::unordered_map<std::wstring, bool> selectedSourceFiles_;
 	};
 }
@@ -0,0 +1,371 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "CoverageJournal.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <set>
+#include <vector>
+
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+#include "CoverageJournalFormat.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		namespace Format = CoverageJournalFormat;
+
+		// A new bitmap is started after this number of lines without code.
+		const unsigned int MaxLineGap = 64;
+
+		//---------------------------------------------------------------------
+		uint32_t ToUInt32(size_t value)
+		{
+			if (value > (std::numeric_limits<uint32_t>::max)())
+				THROW(L"The coverage journal is too big.");
+			return static_cast<uint32_t>(value);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void AppendValue(std::string& data, const T& value)
+		{
+			data.append(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		T GetValue(const std::string& data, size_t offset)
+		{
+			T value;
+
+			if (offset + sizeof(value) > data.size())
+				THROW(L"Invalid coverage journal record.");
+			std::memcpy(&value, data.data() + offset, sizeof(value));
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		bool ReadValue(std::istream& istr, T& value)
+		{
+			return static_cast<bool>(istr.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		}
+
+		//---------------------------------------------------------------------
+		// Call function(first, last) for each range of lines without long gap.
+		template <typename Function>
+		void ForEachLineRange(const std::set<unsigned int>& lines, Function function)
+		{
+			auto first = lines.begin();
+
+			while (first != lines.end())
+			{
+				auto last = first;
+				for (auto next = std::next(last); next != lines.end() && *next - *last <= MaxLineGap; ++next)
+					last = next;
+				function(first, std::next(last));
+				first = std::next(last);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		struct ReplayedFile
+		{
+			uint32_t moduleId_;
+			std::filesystem::path path_;
+			std::map<unsigned int, bool> lines_;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename Function>
+		void ForEachLine(const std::string& data, Function function)
+		{
+			auto linesHeader = GetValue<Format::LinesHeader>(data, 0);
+
+			if (data.size() - sizeof(linesHeader) != (static_cast<size_t>(linesHeader.lineCount_) + 7) / 8)
+				THROW(L"Invalid coverage journal lines.");
+			for (uint32_t i = 0; i < linesHeader.lineCount_; ++i)
+			{
+				if (data[sizeof(linesHeader) + i / 8] & (1 << (i % 8)))
+					function(linesHeader.fileId_, linesHeader.firstLine_ + i);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		ReplayedFile& GetReplayedFile(std::vector<ReplayedFile>& files, uint32_t fileId)
+		{
+			if (fileId >= files.size())
+				THROW(L"Invalid coverage journal file id: " << fileId);
+			return files[fileId];
+		}
+
+		//---------------------------------------------------------------------
+		Plugin::CoverageData CreateCoverageData(
+			const std::wstring& name,
+			int exitCode,
+			const std::vector<std::wstring>& modules,
+			const std::vector<ReplayedFile>& files)
+		{
+			// Sorted like ExecutedAddressManager sorts the modules and the files.
+			std::map<std::wstring, std::vector<const ReplayedFile*>> filesByModule;
+			for (const auto& file : files)
+				filesByModule[modules.at(file.moduleId_)].push_back(&file);
+
+			Plugin::CoverageData coverageData{ name, exitCode };
+			coverageData.ReserveModules(filesByModule.size());
+			for (auto& pair : filesByModule)
+			{
+				auto& module = coverageData.AddModule(pair.first);
+				auto& moduleFiles = pair.second;
+
+				std::sort(moduleFiles.begin(), moduleFiles.end(), [](const auto* file1, const auto* file2) {
+					return file1->path_ < file2->path_;
+				});
+				module.ReserveFiles(moduleFiles.size());
+				for (const auto* file : moduleFiles)
+				{
+					std::vector<Plugin::LineCoverage> lines;
+
+					lines.reserve(file->lines_.size());
+					for (const auto& line : file->lines_)
+						lines.emplace_back(line.first, line.second);
+					module.AddFile(file->path_).SetLines(std::move(lines));
+				}
+			}
+			return coverageData;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageJournal::CoverageJournal(
+		const std::filesystem::path& path,
+		const std::wstring& name)
+		: snapshotCount_{0}
+	{
+		Tools::CreateParentFolderIfNeeded(path);
+		ofs_.open(path, std::ios::binary | std::ios::trunc);
+		if (!ofs_)
+			THROW(L"Cannot open coverage journal: " << path.wstring());
+
+		Format::Header header;
+		std::memcpy(header.magic_, Format::Magic, sizeof(header.magic_));
+		header.version_ = Format::Version;
+		ofs_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		WriteRecord(Format::RecordType::Name, Tools::ToUtf8String(name));
+		Flush();
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageJournal::~CoverageJournal() = default;
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::Append(const ExecutedAddressManager::JournalLines& journalLines)
+	{
+		// The lines are registered before they are executed.
+		AppendLines(Format::RecordType::Lines, journalLines.registeredLines_);
+		AppendLines(Format::RecordType::ExecutedLines, journalLines.executedLines_);
+		Flush();
+		++snapshotCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::AppendExitCode(int exitCode)
+	{
+		std::string data;
+
+		AppendValue(data, static_cast<int32_t>(exitCode));
+		WriteRecord(Format::RecordType::ExitCode, data);
+		Flush();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CoverageJournal::GetSnapshotCount() const
+	{
+		return snapshotCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageJournal::IsJournal(const std::filesystem::path& path)
+	{
+		std::ifstream ifs{path, std::ios::binary};
+		Format::Header header;
+
+		return ReadValue(ifs, header) &&
+		       !std::memcmp(header.magic_, Format::Magic, sizeof(header.magic_));
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageJournal::Replay(const std::filesystem::path& path)
+	{
+		std::ifstream ifs{path, std::ios::binary};
+		Format::Header header;
+
+		if (!ifs)
+			THROW(L"Cannot open coverage journal: " << path.wstring());
+		if (!ReadValue(ifs, header) ||
+		    std::memcmp(header.magic_, Format::Magic, sizeof(header.magic_)) ||
+		    header.version_ != Format::Version)
+			THROW(L"Invalid coverage journal: " << path.wstring());
+
+		std::wstring name;
+		int exitCode = 0;
+		std::vector<std::wstring> modules;
+		std::vector<ReplayedFile> files;
+		Format::RecordHeader recordHeader;
+		std::string data;
+		const auto fileSize = std::filesystem::file_size(path);
+
+		while (ReadValue(ifs, recordHeader))
+		{
+			// The size of a torn record can be anything.
+			if (recordHeader.size_ > fileSize - static_cast<uint64_t>(ifs.tellg()))
+				break;
+			data.resize(recordHeader.size_);
+			if (!ifs.read(&data[0], data.size()))
+				break;
+
+			switch (recordHeader.type_)
+			{
+			case Format::RecordType::Name:
+				name = Tools::Utf8ToWString(data);
+				break;
+			case Format::RecordType::Module:
+				if (GetValue<uint32_t>(data, 0) != modules.size())
+					THROW(L"Invalid coverage journal module id.");
+				modules.push_back(Tools::Utf8ToWString(data.substr(sizeof(uint32_t))));
+				break;
+			case Format::RecordType::File:
+			{
+				auto moduleId = GetValue<uint32_t>(data, sizeof(uint32_t));
+
+				if (GetValue<uint32_t>(data, 0) != files.size() || moduleId >= modules.size())
+					THROW(L"Invalid coverage journal file id.");
+				files.push_back({moduleId, Tools::Utf8ToWString(data.substr(2 * sizeof(uint32_t))), {}});
+				break;
+			}
+			case Format::RecordType::Lines:
+				ForEachLine(data, [&](uint32_t fileId, unsigned int line) {
+					GetReplayedFile(files, fileId).lines_.emplace(line, false);
+				});
+				break;
+			case Format::RecordType::ExecutedLines:
+				ForEachLine(data, [&](uint32_t fileId, unsigned int line) {
+					GetReplayedFile(files, fileId).lines_[line] = true;
+				});
+				break;
+			case Format::RecordType::ExitCode:
+				exitCode = GetValue<int32_t>(data, 0);
+				break;
+			default:
+				THROW(L"Invalid coverage journal record type.");
+			}
+		}
+		return CreateCoverageData(name, exitCode, modules, files);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::AppendLines(
+		Format::RecordType recordType,
+		const ExecutedAddressManager::LinesByModule& linesByModule)
+	{
+		for (const auto& module : linesByModule)
+		{
+			for (const auto& file : module.second)
+			{
+				auto fileId = GetFileId(module.first, file.first);
+
+				ForEachLineRange(file.second, [&](auto first, auto last) {
+					Format::LinesHeader linesHeader{fileId, *first, *std::prev(last) - *first + 1};
+					std::string data;
+
+					AppendValue(data, linesHeader);
+					data.resize(sizeof(linesHeader) + (linesHeader.lineCount_ + 7) / 8);
+					for (auto it = first; it != last; ++it)
+					{
+						auto i = *it - linesHeader.firstLine_;
+						auto& byte = data[sizeof(linesHeader) + i / 8];
+						byte = static_cast<char>(byte | (1 << (i % 8)));
+					}
+					WriteRecord(recordType, data);
+				});
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	uint32_t CoverageJournal::GetFileId(
+		const std::wstring& modulePath,
+		const std::wstring& filePath)
+	{
+		auto itModule = moduleIds_.find(modulePath);
+
+		if (itModule == moduleIds_.end())
+		{
+			std::string data;
+			auto moduleId = ToUInt32(moduleIds_.size());
+
+			AppendValue(data, moduleId);
+			data += Tools::ToUtf8String(modulePath);
+			WriteRecord(Format::RecordType::Module, data);
+			itModule = moduleIds_.emplace(modulePath, moduleId).first;
+		}
+
+		auto key = std::make_pair(itModule->second, filePath);
+		auto itFile = fileIds_.find(key);
+
+		if (itFile == fileIds_.end())
+		{
+			std::string data;
+			auto fileId = ToUInt32(fileIds_.size());
+
+			AppendValue(data, fileId);
+			AppendValue(data, itModule->second);
+			data += Tools::ToUtf8String(filePath);
+			WriteRecord(Format::RecordType::File, data);
+			itFile = fileIds_.emplace(key, fileId).first;
+		}
+		return itFile->second;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::WriteRecord(Format::RecordType recordType, const std::string& data)
+	{
+		Format::RecordHeader recordHeader{recordType, ToUInt32(data.size())};
+
+		ofs_.write(reinterpret_cast<const char*>(&recordHeader), sizeof(recordHeader));
+		ofs_.write(data.data(), data.size());
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageJournal::Flush()
+	{
+		ofs_.flush();
+		if (!ofs_)
+			THROW(L"Cannot write the coverage journal.");
+	}
+}
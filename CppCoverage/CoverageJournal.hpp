@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "CppCoverageExport.hpp"
+#include "ExecutedAddressManager.hpp"
+
+namespace CppCoverage
+{
+	namespace CoverageJournalFormat
+	{
+		enum class RecordType : uint32_t;
+	}
+
+	// Append-only file of the lines registered and executed during the
+	// coverage, written by periodic snapshots so that the coverage is not lost
+	// if OpenCppCoverage is killed. The layout is CoverageJournalFormat.
+	class CPPCOVERAGE_DLL CoverageJournal
+	{
+	  public:
+		CoverageJournal(const std::filesystem::path&, const std::wstring& name);
+		~CoverageJournal();
+
+		// Append only the lines of the snapshot and flush the file.
+		void Append(const ExecutedAddressManager::JournalLines&);
+		void AppendExitCode(int);
+		size_t GetSnapshotCount() const;
+
+		static bool IsJournal(const std::filesystem::path&);
+		// A record truncated by a crash ends the journal. The hit counts and
+		// the first hits are not journaled.
+		static Plugin::CoverageData Replay(const std::filesystem::path&);
+
+	  private:
+		CoverageJournal(const CoverageJournal&) = delete;
+		CoverageJournal& operator=(const CoverageJournal&) = delete;
+
+		void AppendLines(CoverageJournalFormat::RecordType,
+		                 const ExecutedAddressManager::LinesByModule&);
+		uint32_t GetFileId(const std::wstring& modulePath, const std::wstring& filePath);
+		void WriteRecord(CoverageJournalFormat::RecordType, const std::string& data);
+		void Flush();
+
+		std::ofstream ofs_;
+		std::map<std::wstring, uint32_t> moduleIds_;
+		std::map<std::pair<uint32_t, std::wstring>, uint32_t> fileIds_;
+		size_t snapshotCount_;
+	};
+}
@@ -0,0 +1,69 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace CppCoverage
+{
+	// Binary layout of the coverage journal. The journal is only appended: a
+	// Header followed by records, each one a RecordHeader followed by size_
+	// bytes. All values are little endian.
+	//   Name           UTF-8 name of the coverage
+	//   Module         uint32_t moduleId, UTF-8 path
+	//   File           uint32_t fileId, uint32_t moduleId, UTF-8 path
+	//   Lines          LinesHeader, bitmap of the registered lines
+	//   ExecutedLines  LinesHeader, bitmap of the executed lines
+	//   ExitCode       int32_t
+	// The ids are given in the order of the records, starting at 0. Bit i % 8
+	// of the byte i / 8 of a bitmap is the line firstLine_ + i.
+	namespace CoverageJournalFormat
+	{
+		const char Magic[8] = {'O', 'C', 'C', 'J', 'R', 'N', 'A', 'L'};
+		const uint32_t Version = 1;
+
+		struct Header
+		{
+			char magic_[8];
+			uint32_t version_;
+		};
+
+		enum class RecordType : uint32_t
+		{
+			Name,
+			Module,
+			File,
+			Lines,
+			ExecutedLines,
+			ExitCode
+		};
+
+		struct RecordHeader
+		{
+			RecordType type_;
+			uint32_t size_;
+		};
+
+		struct LinesHeader
+		{
+			uint32_t fileId_;
+			uint32_t firstLine_;
+			uint32_t lineCount_;
+		};
+	}
+}
@@ -0,0 +1,94 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageLineRemapper.hpp"
+
+#include <vector>
+#include <boost/optional/optional.hpp>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "FileFilter/UnifiedDiffCoverageFilter.hpp"
+
+#include "UnifiedDiffSettings.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	CoverageLineRemapper::CoverageLineRemapper(const UnifiedDiffSettings& unifiedDiffSettings)
+		: unifiedDiffCoverageFilter_{ std::make_unique<FileFilter::UnifiedDiffCoverageFilter>(
+			unifiedDiffSettings.GetUnifiedDiffPath(), unifiedDiffSettings.GetRootDiffFolder()) }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageLineRemapper::~CoverageLineRemapper() = default;
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageLineRemapper::Remap(const Plugin::CoverageData& coverageData)
+	{
+		Plugin::CoverageData remappedCoverageData{ coverageData.GetName(), coverageData.GetExitCode() };
+		remappedCoverageData.SetSampled(coverageData.IsSampled());
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			// The module is added with its first file with lines.
+			Plugin::ModuleCoverage* remappedModule = nullptr;
+
+			for (const auto& file : module->GetFiles())
+			{
+				const auto& lines = file->GetLines();
+				std::vector<Plugin::LineCoverage> remappedLines;
+				bool isChanged = false;
+
+				// The diff keeps the order of the lines.
+				remappedLines.reserve(lines.size());
+				for (const auto& line : lines)
+				{
+					auto lineNumber = static_cast<int>(line.GetLineNumber());
+					auto newLineNumber = unifiedDiffCoverageFilter_->GetNewLineNumber(file->GetPath(), lineNumber);
+
+					isChanged = isChanged || newLineNumber != lineNumber;
+					if (newLineNumber)
+					{
+						remappedLines.emplace_back(static_cast<unsigned int>(*newLineNumber),
+						                           line.HasBeenExecuted(),
+						                           line.GetHitCount(),
+						                           line.GetFirstHitOrder(),
+						                           line.GetFirstHitTime());
+					}
+				}
+				if (remappedLines.empty())
+					continue;
+
+				if (!remappedModule)
+					remappedModule = &remappedCoverageData.AddModule(module->GetPath());
+				auto& remappedFile = remappedModule->AddFile(file->GetPath());
+
+				// The lines are copied as they are when the diff does not change them.
+				if (!isChanged)
+					remappedFile = *file;
+				else
+					remappedFile.SetLines(std::move(remappedLines));
+			}
+		}
+		return remappedCoverageData;
+	}
+}
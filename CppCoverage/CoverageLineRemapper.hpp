@@ -0,0 +1,56 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace FileFilter
+{
+	class UnifiedDiffCoverageFilter;
+}
+
+namespace CppCoverage
+{
+	class UnifiedDiffSettings;
+
+	// Move the lines of coverage data recorded for a previous revision of
+	// the sources to their lines in the current revision, with the unified
+	// diff between the two revisions. The removed lines are dropped: the
+	// coverage data can then be merged with a run of the current revision.
+	class CPPCOVERAGE_DLL CoverageLineRemapper
+	{
+	public:
+		explicit CoverageLineRemapper(const UnifiedDiffSettings&);
+		~CoverageLineRemapper();
+
+		// The modules and the files without lines are removed.
+		Plugin::CoverageData Remap(const Plugin::CoverageData&);
+
+	private:
+		CoverageLineRemapper(const CoverageLineRemapper&) = delete;
+		CoverageLineRemapper& operator=(const CoverageLineRemapper&) = delete;
+
+		std::unique_ptr<FileFilter::UnifiedDiffCoverageFilter> unifiedDiffCoverageFilter_;
+	};
+}
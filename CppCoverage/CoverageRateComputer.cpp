@@ -29,18 +29,10 @@ namespace CppCoverage
 		//---------------------------------------------------------------------
 		CoverageRate ComputeFileCoverage(const Plugin::FileCoverage& file)
 		{
-			int executedLines = 0;
-			int unexecutedLines = 0;
+			auto executedLines = file.GetExecutedLineCount();
+			auto unexecutedLines = file.GetLines().size() - executedLines;
 
-			for (const auto& lineCoverage : file.GetLines())
-			{
-				if (lineCoverage.HasBeenExecuted())
-					++executedLines;
-				else
-					++unexecutedLines;
-			}
-
-			return CoverageRate{executedLines, unexecutedLines};
+			return CoverageRate{static_cast<int>(executedLines), static_cast<int>(unexecutedLines)};
 		}
 		
 		//---------------------------------------------------------------------
@@ -49,18 +41,21 @@ namespace CppCoverage
 			const std::vector<std::unique_ptr<Object>>& objects,
 			const std::unordered_map<const Object*, CoverageRate>& coverageRates)
 		{
-			std::vector<Object*> sortedObjects;
-			
+			// The percent rates are computed once instead of at each comparison.
+			std::vector<std::pair<int, Object*>> objectsByRate;
+
 			for (const auto& object : objects)
-				sortedObjects.push_back(object.get());
+				objectsByRate.emplace_back(coverageRates.at(object.get()).GetPercentRate(), object.get());
 
-			std::sort(sortedObjects.begin(), sortedObjects.end(), 
-				[&](const Object* object1, const Object* object2)
+			std::sort(objectsByRate.begin(), objectsByRate.end(),
+				[](const auto& pair1, const auto& pair2)
 			{
-				return coverageRates.at(object1).GetPercentRate() 
-					 < coverageRates.at(object2).GetPercentRate();
+				return pair1.first < pair2.first;
 			});
 
+			std::vector<Object*> sortedObjects;
+			for (const auto& pair : objectsByRate)
+				sortedObjects.push_back(pair.second);
 			return sortedObjects;
 		}
 	}
@@ -0,0 +1,110 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "CoverageRegion.hpp"
+
+namespace CppCoverage
+{
+	const std::wstring CoverageRegion::BeginMarker = L"OpenCppCoverage: begin coverage";
+	const std::wstring CoverageRegion::EndMarker = L"OpenCppCoverage: end coverage";
+
+	//-------------------------------------------------------------------------
+	CoverageRegion::Marker
+	CoverageRegion::ParseMarker(const std::wstring& debugString)
+	{
+		auto end = debugString.find_last_not_of(L"\r\n");
+		auto marker = debugString.substr(0, end == std::wstring::npos ? 0 : end + 1);
+
+		if (marker == BeginMarker)
+			return Marker::Begin;
+		if (marker == EndMarker)
+			return Marker::End;
+		return Marker::None;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageRegion::CoverageRegion() : isActive_{false}, regionCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageRegion::IsActive() const
+	{
+		return isActive_;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageRegion::AddAddresses(HANDLE hProcess,
+	                                  const std::vector<DWORD64>& addresses)
+	{
+		for (auto addressValue : addresses)
+			addresses_.emplace(hProcess, reinterpret_cast<void*>(addressValue));
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageRegion::OnHit(const Address& address)
+	{
+		addresses_.erase(address);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageRegion::OnExitProcess(HANDLE hProcess)
+	{
+		for (auto it = addresses_.begin(); it != addresses_.end();)
+		{
+			if (it->GetProcessHandle() == hProcess)
+				it = addresses_.erase(it);
+			else
+				++it;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::map<HANDLE, std::vector<DWORD64>> CoverageRegion::Begin()
+	{
+		if (isActive_)
+			return {};
+
+		isActive_ = true;
+		++regionCount_;
+
+		std::map<HANDLE, std::vector<DWORD64>> addressesByProcess;
+		for (const auto& address : addresses_)
+		{
+			addressesByProcess[address.GetProcessHandle()].push_back(
+			    reinterpret_cast<DWORD64>(address.GetValue()));
+		}
+		return addressesByProcess;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Address> CoverageRegion::End()
+	{
+		if (!isActive_)
+			return {};
+
+		isActive_ = false;
+		return {addresses_.begin(), addresses_.end()};
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CoverageRegion::GetRegionCount() const
+	{
+		return regionCount_;
+	}
+}
@@ -0,0 +1,78 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Track the breakpoints to arm inside the region delimited by the
+	// BeginMarker and EndMarker debug strings (see OutputDebugString).
+	// Breakpoints registered outside of the region are not written so the
+	// code outside of the region runs at native speed.
+	class CPPCOVERAGE_DLL CoverageRegion
+	{
+	  public:
+		static const std::wstring BeginMarker;
+		static const std::wstring EndMarker;
+
+		enum class Marker
+		{
+			None,
+			Begin,
+			End
+		};
+
+		// Trailing new line characters are ignored.
+		static Marker ParseMarker(const std::wstring& debugString);
+
+		CoverageRegion();
+
+		bool IsActive() const;
+
+		// Addresses registered for coverage whose breakpoint is not hit yet.
+		void AddAddresses(HANDLE hProcess, const std::vector<DWORD64>&);
+		// The address must not have a breakpoint anymore.
+		void OnHit(const Address&);
+		void OnExitProcess(HANDLE hProcess);
+
+		// Return the addresses to arm. Nothing is returned if the region is
+		// already active.
+		std::map<HANDLE, std::vector<DWORD64>> Begin();
+
+		// Return the addresses to disarm. Nothing is returned if the region
+		// is not active.
+		std::vector<Address> End();
+
+		size_t GetRegionCount() const;
+
+	  private:
+		CoverageRegion(const CoverageRegion&) = delete;
+		CoverageRegion& operator=(const CoverageRegion&) = delete;
+
+		bool isActive_;
+		std::set<Address> addresses_;
+		size_t regionCount_;
+	};
+}
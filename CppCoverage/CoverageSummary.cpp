@@ -0,0 +1,82 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageSummary.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "CoverageRateComputer.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	CoverageSummary::CoverageSummary(const std::wstring& name, int exitCode)
+		: name_{ name }
+		, exitCode_{ exitCode }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageSummary CoverageSummary::Create(
+		const Plugin::CoverageData& coverageData,
+		const CoverageRateComputer& coverageRateComputer)
+	{
+		CoverageSummary coverageSummary{ coverageData.GetName(), coverageData.GetExitCode() };
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			coverageSummary.AddModule(
+				module->GetPath(), coverageRateComputer.GetCoverageRate(*module));
+		}
+		return coverageSummary;
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageSummary::AddModule(
+		const std::filesystem::path& path,
+		const CoverageRate& coverageRate)
+	{
+		if (coverageRate.GetTotalLinesCount() == 0)
+			return;
+		modules_.push_back(Module{ path, coverageRate });
+		coverageRate_ += coverageRate;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring& CoverageSummary::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	int CoverageSummary::GetExitCode() const
+	{
+		return exitCode_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<CoverageSummary::Module>& CoverageSummary::GetModules() const
+	{
+		return modules_;
+	}
+
+	//-------------------------------------------------------------------------
+	const CoverageRate& CoverageSummary::GetCoverageRate() const
+	{
+		return coverageRate_;
+	}
+}
@@ -0,0 +1,67 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+#include "CoverageRate.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	class CoverageRateComputer;
+
+	// Line counts of a run by module, without the lines themselves.
+	class CPPCOVERAGE_DLL CoverageSummary
+	{
+	public:
+		struct Module
+		{
+			std::filesystem::path path_;
+			CoverageRate coverageRate_;
+		};
+
+		CoverageSummary(const std::wstring& name, int exitCode);
+		CoverageSummary(CoverageSummary&&) = default;
+
+		static CoverageSummary Create(const Plugin::CoverageData&, const CoverageRateComputer&);
+
+		// Modules without lines are ignored.
+		void AddModule(const std::filesystem::path&, const CoverageRate&);
+
+		const std::wstring& GetName() const;
+		int GetExitCode() const;
+		const std::vector<Module>& GetModules() const;
+		const CoverageRate& GetCoverageRate() const;
+
+	private:
+		CoverageSummary(const CoverageSummary&) = delete;
+		CoverageSummary& operator=(const CoverageSummary&) = delete;
+
+		std::wstring name_;
+		int exitCode_;
+		std::vector<Module> modules_;
+		CoverageRate coverageRate_;
+	};
+}
@@ -0,0 +1,237 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DebugEventStatistics.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		size_t GetBreakPointHistogramBucket(DebugEventStatistics::Clock::duration handlingTime)
+		{
+			auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(handlingTime).count();
+			size_t bucket = 0;
+
+			while (microseconds > 0 && bucket + 1 < DebugEventStatistics::BreakPointHistogramSize)
+			{
+				microseconds >>= 1;
+				++bucket;
+			}
+			return bucket;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsLongerStall(const DebugEventStatistics::Stall& stall1,
+		                   const DebugEventStatistics::Stall& stall2)
+		{
+			return stall1.time_ > stall2.time_;
+		}
+
+		//---------------------------------------------------------------------
+		void AddLongestStall(std::vector<DebugEventStatistics::Stall>& longestStalls,
+		                     const DebugEventStatistics::Stall& stall)
+		{
+			auto it = std::upper_bound(longestStalls.begin(), longestStalls.end(), stall, IsLongerStall);
+
+			longestStalls.insert(it, stall);
+			if (longestStalls.size() > DebugEventStatistics::MaxLongestStallCount)
+				longestStalls.pop_back();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::DebugEventStatistics()
+		: eventCount_{ 0 }
+		, eventCountByCode_{}
+		, totalHandlingTime_{ Clock::duration::zero() }
+		, breakPointCount_{ 0 }
+		, debugStringCount_{ 0 }
+		, totalBreakPointTime_{ Clock::duration::zero() }
+		, maxBreakPointTime_{ Clock::duration::zero() }
+		, breakPointHistogram_{}
+	{
+		handlingTimeByCode_.fill(Clock::duration::zero());
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventStatistics::Start(Clock::time_point start)
+	{
+		start_ = start;
+		stop_ = start;
+		eventCount_ = 0;
+		eventCountByCode_.fill(0);
+		handlingTimeByCode_.fill(Clock::duration::zero());
+		totalHandlingTime_ = Clock::duration::zero();
+		breakPointCount_ = 0;
+		debugStringCount_ = 0;
+		totalBreakPointTime_ = Clock::duration::zero();
+		maxBreakPointTime_ = Clock::duration::zero();
+		breakPointHistogram_.fill(0);
+		longestStalls_.clear();
+		dllLoadTimes_.clear();
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventStatistics::Stop(Clock::time_point stop)
+	{
+		stop_ = stop;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventStatistics::AddEvent(
+		unsigned long debugEventCode,
+		bool isBreakPoint,
+		Clock::duration handlingTime,
+		const std::wstring& modulePath)
+	{
+		++eventCount_;
+		if (debugEventCode <= MaxDebugEventCode)
+		{
+			++eventCountByCode_[debugEventCode];
+			handlingTimeByCode_[debugEventCode] += handlingTime;
+		}
+		totalHandlingTime_ += handlingTime;
+		if (isBreakPoint)
+		{
+			++breakPointCount_;
+			totalBreakPointTime_ += handlingTime;
+			maxBreakPointTime_ = std::max(maxBreakPointTime_, handlingTime);
+			++breakPointHistogram_[GetBreakPointHistogramBucket(handlingTime)];
+		}
+		if (!modulePath.empty())
+		{
+			auto& dllLoadTime = dllLoadTimes_[modulePath];
+			dllLoadTime.first += handlingTime;
+			++dllLoadTime.second;
+		}
+		// Most of the events are shorter than the last longest stall.
+		if (longestStalls_.size() < MaxLongestStallCount || handlingTime > longestStalls_.back().time_)
+			AddLongestStall(longestStalls_, {debugEventCode, isBreakPoint, modulePath, handlingTime});
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventStatistics::AddDebugString()
+	{
+		++debugStringCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventStatistics::GetEventCount() const
+	{
+		return eventCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventStatistics::GetEventCount(unsigned long debugEventCode) const
+	{
+		return debugEventCode <= MaxDebugEventCode ? eventCountByCode_[debugEventCode] : 0;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::Clock::duration DebugEventStatistics::GetHandlingTime() const
+	{
+		return totalHandlingTime_;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::Clock::duration
+	DebugEventStatistics::GetHandlingTime(unsigned long debugEventCode) const
+	{
+		return debugEventCode <= MaxDebugEventCode ? handlingTimeByCode_[debugEventCode]
+		                                           : Clock::duration::zero();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventStatistics::GetBreakPointCount() const
+	{
+		return breakPointCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventStatistics::GetDebugStringCount() const
+	{
+		return debugStringCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::Clock::duration DebugEventStatistics::GetElapsedTime() const
+	{
+		return stop_ - start_;
+	}
+
+	//-------------------------------------------------------------------------
+	double DebugEventStatistics::GetEventsPerSecond() const
+	{
+		auto seconds = std::chrono::duration<double>(GetElapsedTime()).count();
+
+		return seconds > 0 ? static_cast<double>(eventCount_) / seconds : 0;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::Clock::duration DebugEventStatistics::GetAverageBreakPointTime() const
+	{
+		if (breakPointCount_ == 0)
+			return Clock::duration::zero();
+		return totalBreakPointTime_ / static_cast<Clock::rep>(breakPointCount_);
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventStatistics::Clock::duration DebugEventStatistics::GetMaxBreakPointTime() const
+	{
+		return maxBreakPointTime_;
+	}
+
+	//-------------------------------------------------------------------------
+	const DebugEventStatistics::BreakPointHistogram&
+	DebugEventStatistics::GetBreakPointHistogram() const
+	{
+		return breakPointHistogram_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<DebugEventStatistics::Stall>& DebugEventStatistics::GetLongestStalls() const
+	{
+		return longestStalls_;
+	}
+
+	//-------------------------------------------------------------------------
+	const DebugEventStatistics::DllLoadTimes& DebugEventStatistics::GetDllLoadTimes() const
+	{
+		return dllLoadTimes_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wostream& operator<<(std::wostream& ostr, const DebugEventStatistics& statistics)
+	{
+		using Microseconds = std::chrono::duration<double, std::micro>;
+
+		ostr << L"Debug events: " << statistics.GetEventCount();
+		ostr << L" (" << static_cast<size_t>(statistics.GetEventsPerSecond()) << L"/s)";
+		ostr << L", breakpoints: " << statistics.GetBreakPointCount();
+		ostr << L", debug strings: " << statistics.GetDebugStringCount();
+		ostr << L", breakpoint latency: average " << Microseconds(statistics.GetAverageBreakPointTime()).count();
+		ostr << L"us, max " << Microseconds(statistics.GetMaxBreakPointTime()).count() << L"us";
+		ostr << L", debuggee stalled: "
+		     << std::chrono::duration<double, std::milli>(statistics.GetHandlingTime()).count() << L"ms";
+
+		return ostr;
+	}
+}
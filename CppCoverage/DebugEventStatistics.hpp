@@ -0,0 +1,104 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// The handling time of an event is the time the debuggee is stalled,
+	// from the return of WaitForDebugEvent to ContinueDebugEvent.
+	class CPPCOVERAGE_DLL DebugEventStatistics
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Stall
+		{
+			unsigned long debugEventCode_;
+			bool isBreakPoint_;
+			// The loaded DLL for LOAD_DLL_DEBUG_EVENT, when it is known.
+			std::wstring modulePath_;
+			Clock::duration time_;
+		};
+
+		// Bucket i counts the breakpoints handled in less than 2^i us, the
+		// last bucket counts the others.
+		static const size_t BreakPointHistogramSize = 24;
+		using BreakPointHistogram = std::array<size_t, BreakPointHistogramSize>;
+		static const size_t MaxLongestStallCount = 10;
+		// The handling time and the load count by DLL.
+		using DllLoadTimes = std::map<std::wstring, std::pair<Clock::duration, size_t>>;
+
+		DebugEventStatistics();
+
+		void Start(Clock::time_point);
+		void Stop(Clock::time_point);
+		// The last debug event code is RIP_EVENT.
+		static const unsigned long MaxDebugEventCode = 9;
+
+		void AddEvent(unsigned long debugEventCode,
+		              bool isBreakPoint,
+		              Clock::duration handlingTime,
+		              const std::wstring& modulePath = {});
+		void AddDebugString();
+
+		size_t GetEventCount() const;
+		size_t GetEventCount(unsigned long debugEventCode) const;
+		// Time spent handling the events, the rest is spent waiting for them.
+		Clock::duration GetHandlingTime() const;
+		Clock::duration GetHandlingTime(unsigned long debugEventCode) const;
+		size_t GetBreakPointCount() const;
+		size_t GetDebugStringCount() const;
+		Clock::duration GetElapsedTime() const;
+		double GetEventsPerSecond() const;
+		Clock::duration GetAverageBreakPointTime() const;
+		Clock::duration GetMaxBreakPointTime() const;
+		const BreakPointHistogram& GetBreakPointHistogram() const;
+		// By decreasing time.
+		const std::vector<Stall>& GetLongestStalls() const;
+		const DllLoadTimes& GetDllLoadTimes() const;
+
+		friend CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream&, const DebugEventStatistics&);
+
+	private:
+		DebugEventStatistics(const DebugEventStatistics&) = delete;
+		DebugEventStatistics& operator=(const DebugEventStatistics&) = delete;
+
+		Clock::time_point start_;
+		Clock::time_point stop_;
+		size_t eventCount_;
+		std::array<size_t, MaxDebugEventCode + 1> eventCountByCode_;
+		std::array<Clock::duration, MaxDebugEventCode + 1> handlingTimeByCode_;
+		Clock::duration totalHandlingTime_;
+		size_t breakPointCount_;
+		size_t debugStringCount_;
+		Clock::duration totalBreakPointTime_;
+		Clock::duration maxBreakPointTime_;
+		BreakPointHistogram breakPointHistogram_;
+		std::vector<Stall> longestStalls_;
+		DllLoadTimes dllLoadTimes_;
+	};
+}
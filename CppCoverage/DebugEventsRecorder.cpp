@@ -0,0 +1,252 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DebugEventsRecorder.hpp"
+
+#include <sstream>
+
+#include "Tools/PEFileHeader.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct ImageIdentityReader : private Tools::IPEFileHeaderHandler
+		{
+			//-----------------------------------------------------------------
+			DebugEventsRecorder::ImageIdentity Read(HANDLE hProcess, void* baseOfImage)
+			{
+				Tools::PEFileHeader fileHeader;
+
+				fileHeader.Load(hProcess, reinterpret_cast<DWORD64>(baseOfImage), *this);
+				return identity_;
+			}
+
+		private:
+			//-----------------------------------------------------------------
+			template <typename T_IMAGE_NT_HEADERS>
+			void OnNtHeader(const T_IMAGE_NT_HEADERS& ntHeaders)
+			{
+				identity_.timeDateStamp = ntHeaders.FileHeader.TimeDateStamp;
+				identity_.sizeOfImage = ntHeaders.OptionalHeader.SizeOfImage;
+				identity_.checkSum = ntHeaders.OptionalHeader.CheckSum;
+			}
+
+			//-----------------------------------------------------------------
+			void OnNtHeader32(HANDLE, DWORD64, const IMAGE_NT_HEADERS32& ntHeader) override
+			{
+				OnNtHeader(ntHeader);
+			}
+
+			//-----------------------------------------------------------------
+			void OnNtHeader64(HANDLE, DWORD64, const IMAGE_NT_HEADERS64& ntHeader) override
+			{
+				OnNtHeader(ntHeader);
+				identity_.is64Bits = true;
+			}
+
+			DebugEventsRecorder::ImageIdentity identity_;
+		};
+
+		//---------------------------------------------------------------------
+		std::string ToField(const void* address)
+		{
+			return std::to_string(reinterpret_cast<uintptr_t>(address));
+		}
+
+		//---------------------------------------------------------------------
+		std::string GetIds(HANDLE hProcess, HANDLE hThread)
+		{
+			return '\t' + std::to_string(GetProcessId(hProcess)) + '\t' +
+			       std::to_string(GetThreadId(hThread));
+		}
+	}
+
+	const std::string DebugEventsRecorder::FileHeader = "OpenCppCoverage debug events 1";
+	const std::string DebugEventsRecorder::ProcessRecord = "process";
+	const std::string DebugEventsRecorder::DllRecord = "dll";
+	const std::string DebugEventsRecorder::UnloadRecord = "unload";
+	const std::string DebugEventsRecorder::ExceptionRecord = "exception";
+	const std::string DebugEventsRecorder::ExitRecord = "exit";
+	const std::string DebugEventsRecorder::TimerRecord = "timer";
+
+	//-------------------------------------------------------------------------
+	DebugEventsRecorder::ImageIdentity
+	DebugEventsRecorder::ReadImageIdentity(HANDLE hProcess, void* baseOfImage)
+	{
+		ImageIdentityReader reader;
+
+		return reader.Read(hProcess, baseOfImage);
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventsRecorder::DebugEventsRecorder(IDebugEventsHandler& handler,
+	                                         const std::filesystem::path& path)
+		: handler_{handler}
+		, eventCount_{0}
+	{
+		Tools::CreateParentFolderIfNeeded(path);
+		ofs_.open(path, std::ios::binary);
+		if (!ofs_)
+			THROW(L"Cannot open debug events file: " << path.wstring());
+		ofs_ << FileHeader << '\n';
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnCreateProcess(const CREATE_PROCESS_DEBUG_INFO& processDebugInfo)
+	{
+		WriteModule(ProcessRecord,
+		            processDebugInfo.hProcess,
+		            processDebugInfo.hThread,
+		            processDebugInfo.hFile,
+		            processDebugInfo.lpBaseOfImage);
+		handler_.OnCreateProcess(processDebugInfo);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnExitProcess(HANDLE hProcess,
+	                                        HANDLE hThread,
+	                                        const EXIT_PROCESS_DEBUG_INFO& exitProcess)
+	{
+		Write(ExitRecord + GetIds(hProcess, hThread) + '\t' +
+		      std::to_string(exitProcess.dwExitCode));
+		handler_.OnExitProcess(hProcess, hThread, exitProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnLoadDll(HANDLE hProcess,
+	                                    HANDLE hThread,
+	                                    const LOAD_DLL_DEBUG_INFO& loadDll)
+	{
+		WriteModule(DllRecord, hProcess, hThread, loadDll.hFile, loadDll.lpBaseOfDll);
+		handler_.OnLoadDll(hProcess, hThread, loadDll);
+	}
+
+	//-------------------------------------------------------------------------
+	bool DebugEventsRecorder::PostponeLoadDll(HANDLE hProcess,
+	                                          HANDLE hThread,
+	                                          const LOAD_DLL_DEBUG_INFO& loadDll)
+	{
+		// The postponed event is reported again and written again: the
+		// replayer skips a module already loaded at the same address.
+		return handler_.PostponeLoadDll(hProcess, hThread, loadDll);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::CancelPostponeLoadDll(HANDLE hProcess,
+	                                                HANDLE hThread,
+	                                                const LOAD_DLL_DEBUG_INFO& loadDll)
+	{
+		handler_.CancelPostponeLoadDll(hProcess, hThread, loadDll);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnUnloadDll(HANDLE hProcess,
+	                                      HANDLE hThread,
+	                                      const UNLOAD_DLL_DEBUG_INFO& unloadDll)
+	{
+		Write(UnloadRecord + GetIds(hProcess, hThread) + '\t' + ToField(unloadDll.lpBaseOfDll));
+		handler_.OnUnloadDll(hProcess, hThread, unloadDll);
+	}
+
+	//-------------------------------------------------------------------------
+	IDebugEventsHandler::ExceptionType
+	DebugEventsRecorder::OnException(HANDLE hProcess,
+	                                 HANDLE hThread,
+	                                 const EXCEPTION_DEBUG_INFO& exceptionDebugInfo)
+	{
+		const auto& exceptionRecord = exceptionDebugInfo.ExceptionRecord;
+		auto parameterCount = (std::min)(exceptionRecord.NumberParameters,
+		                                 static_cast<DWORD>(EXCEPTION_MAXIMUM_PARAMETERS));
+		auto line = ExceptionRecord + GetIds(hProcess, hThread) + '\t' +
+		            std::to_string(exceptionRecord.ExceptionCode) + '\t' +
+		            ToField(exceptionRecord.ExceptionAddress) + '\t' +
+		            std::to_string(exceptionDebugInfo.dwFirstChance) + '\t' +
+		            std::to_string(parameterCount);
+
+		for (DWORD i = 0; i < parameterCount; ++i)
+			line += '\t' + std::to_string(exceptionRecord.ExceptionInformation[i]);
+		Write(line);
+		return handler_.OnException(hProcess, hThread, exceptionDebugInfo);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnTimer()
+	{
+		Write(TimerRecord);
+		handler_.OnTimer();
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnOutputDebugString(HANDLE hProcess,
+	                                              HANDLE hThread,
+	                                              const std::wstring& debugString)
+	{
+		handler_.OnOutputDebugString(hProcess, hThread, debugString);
+	}
+
+	//-------------------------------------------------------------------------
+	bool DebugEventsRecorder::PrepareDetach(HANDLE hProcess)
+	{
+		return handler_.PrepareDetach(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::OnDetachProcess(HANDLE hProcess)
+	{
+		handler_.OnDetachProcess(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventsRecorder::GetEventCount() const
+	{
+		return eventCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::WriteModule(const std::string& record,
+	                                      HANDLE hProcess,
+	                                      HANDLE hThread,
+	                                      HANDLE hFile,
+	                                      void* baseOfImage)
+	{
+		auto identity = ReadImageIdentity(hProcess, baseOfImage);
+		auto path = handleInformation_.ComputeFilename(hFile);
+
+		Write(record + GetIds(hProcess, hThread) + '\t' + ToField(baseOfImage) + '\t' +
+		      std::to_string(identity.timeDateStamp) + '\t' +
+		      std::to_string(identity.sizeOfImage) + '\t' +
+		      std::to_string(identity.checkSum) + '\t' +
+		      (identity.is64Bits ? "64" : "32") + '\t' + Tools::ToUtf8String(path));
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsRecorder::Write(const std::string& line)
+	{
+		// The child processes can have their own debug loop.
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		ofs_ << line << '\n';
+		if (!ofs_)
+			THROW(L"Cannot write debug events file.");
+		++eventCount_;
+	}
+}
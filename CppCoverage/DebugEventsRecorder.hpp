@@ -0,0 +1,89 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+#include "IDebugEventsHandler.hpp"
+#include "HandleInformation.hpp"
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Forward the debug events to a handler and write them to a file which
+	// DebugEventsReplayer replays without the program. The modules are written
+	// with the identity of their PE header. The OutputDebugString strings and
+	// the detaches are not written.
+	class CPPCOVERAGE_DLL DebugEventsRecorder : public IDebugEventsHandler
+	{
+	public:
+		static const std::string FileHeader;
+		static const std::string ProcessRecord;
+		static const std::string DllRecord;
+		static const std::string UnloadRecord;
+		static const std::string ExceptionRecord;
+		static const std::string ExitRecord;
+		static const std::string TimerRecord;
+
+		struct ImageIdentity
+		{
+			DWORD timeDateStamp = 0;
+			DWORD sizeOfImage = 0;
+			DWORD checkSum = 0;
+			bool is64Bits = false;
+		};
+
+		static ImageIdentity ReadImageIdentity(HANDLE hProcess, void* baseOfImage);
+
+		DebugEventsRecorder(IDebugEventsHandler&, const std::filesystem::path&);
+
+		void OnCreateProcess(const CREATE_PROCESS_DEBUG_INFO&) override;
+		void OnExitProcess(HANDLE hProcess, HANDLE hThread, const EXIT_PROCESS_DEBUG_INFO&) override;
+		void OnLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
+		bool PostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
+		void CancelPostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&) override;
+		void OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&) override;
+		ExceptionType OnException(HANDLE hProcess, HANDLE hThread, const EXCEPTION_DEBUG_INFO&) override;
+		void OnTimer() override;
+		void OnOutputDebugString(HANDLE hProcess, HANDLE hThread, const std::wstring&) override;
+		bool PrepareDetach(HANDLE hProcess) override;
+		void OnDetachProcess(HANDLE hProcess) override;
+
+		size_t GetEventCount() const;
+
+	private:
+		DebugEventsRecorder(const DebugEventsRecorder&) = delete;
+		DebugEventsRecorder& operator=(const DebugEventsRecorder&) = delete;
+
+		void WriteModule(const std::string& record,
+		                 HANDLE hProcess,
+		                 HANDLE hThread,
+		                 HANDLE hFile,
+		                 void* baseOfImage);
+		void Write(const std::string& line);
+
+		IDebugEventsHandler& handler_;
+		HandleInformation handleInformation_;
+		std::ofstream ofs_;
+		std::mutex mutex_;
+		size_t eventCount_;
+	};
+}
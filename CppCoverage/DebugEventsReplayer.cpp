@@ -0,0 +1,423 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DebugEventsReplayer.hpp"
+
+#include <fstream>
+
+#include "Tools/Log.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+#include "DebugEventsRecorder.hpp"
+#include "IDebugEventsHandler.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		DWORD WINAPI SuspendedThread(LPVOID)
+		{
+			return 0;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::string> Split(const std::string& line, size_t maxFieldCount)
+		{
+			std::vector<std::string> fields;
+			size_t start = 0;
+
+			// The last field is the rest of the line: a path can contain tabs.
+			while (fields.size() + 1 < maxFieldCount)
+			{
+				auto end = line.find('\t', start);
+				if (end == std::string::npos)
+					break;
+				fields.push_back(line.substr(start, end - start));
+				start = end + 1;
+			}
+			fields.push_back(line.substr(start));
+			return fields;
+		}
+
+		//---------------------------------------------------------------------
+		uint64_t ToNumber(const std::vector<std::string>& fields, size_t index)
+		{
+			if (index >= fields.size() || fields[index].empty() ||
+			    fields[index].find_first_not_of("0123456789") != std::string::npos)
+			{
+				THROW(L"Invalid field " << index << L" in debug events file.");
+			}
+			return std::stoull(fields[index]);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		T ToValue(const std::vector<std::string>& fields, size_t index)
+		{
+			return static_cast<T>(ToNumber(fields, index));
+		}
+
+		//---------------------------------------------------------------------
+		void* ToAddress(const std::vector<std::string>& fields, size_t index)
+		{
+			return reinterpret_cast<void*>(static_cast<uintptr_t>(ToNumber(fields, index)));
+		}
+
+		const size_t ModuleFieldCount = 9;
+	}
+
+	//-------------------------------------------------------------------------
+	struct DebugEventsReplayer::Module
+	{
+		//---------------------------------------------------------------------
+		Module(void* recordedBase, DWORD sizeOfImage, HANDLE hMapping, void* view)
+			: recordedBase_{recordedBase}
+			, sizeOfImage_{sizeOfImage}
+			, hMapping_{hMapping}
+			, view_{view}
+		{
+		}
+
+		//---------------------------------------------------------------------
+		void Release()
+		{
+			UnmapViewOfFile(view_);
+			CloseHandle(hMapping_);
+		}
+
+		//---------------------------------------------------------------------
+		void* Relocate(void* address) const
+		{
+			auto offset = static_cast<char*>(address) - static_cast<char*>(recordedBase_);
+
+			if (address < recordedBase_ || offset >= static_cast<ptrdiff_t>(sizeOfImage_))
+				return nullptr;
+			return static_cast<char*>(view_) + offset;
+		}
+
+		void* recordedBase_;
+		DWORD sizeOfImage_;
+		HANDLE hMapping_;
+		void* view_;
+	};
+
+	//-------------------------------------------------------------------------
+	struct DebugEventsReplayer::Process
+	{
+		//---------------------------------------------------------------------
+		explicit Process(HANDLE hProcess) : hProcess_{hProcess}
+		{
+		}
+
+		//---------------------------------------------------------------------
+		~Process()
+		{
+			for (auto& module : modules_)
+				module.Release();
+			for (const auto& thread : threads_)
+			{
+				TerminateThread(thread.second, 0);
+				CloseHandle(thread.second);
+			}
+			CloseHandle(hProcess_);
+		}
+
+		//---------------------------------------------------------------------
+		// The addresses outside the modules are kept.
+		void* Relocate(void* address) const
+		{
+			for (const auto& module : modules_)
+			{
+				if (auto relocatedAddress = module.Relocate(address))
+					return relocatedAddress;
+			}
+			return address;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<Module>::iterator FindModule(void* recordedBase)
+		{
+			return std::find_if(modules_.begin(), modules_.end(), [&](const auto& module) {
+				return module.recordedBase_ == recordedBase;
+			});
+		}
+
+		HANDLE hProcess_;
+		std::map<DWORD, HANDLE> threads_;
+		std::vector<Module> modules_;
+		bool isDetached_ = false;
+
+	private:
+		Process(const Process&) = delete;
+		Process& operator=(const Process&) = delete;
+	};
+
+	//-------------------------------------------------------------------------
+	DebugEventsReplayer::DebugEventsReplayer(const std::filesystem::path& path)
+		: path_{path}
+		, eventCount_{0}
+		, lineNumber_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventsReplayer::~DebugEventsReplayer() = default;
+
+	//-------------------------------------------------------------------------
+	int DebugEventsReplayer::Replay(IDebugEventsHandler& handler)
+	{
+		std::ifstream ifs{path_, std::ios::binary};
+		std::string line;
+
+		if (!ifs)
+			THROW(L"Cannot open debug events file: " << path_.wstring());
+		if (!std::getline(ifs, line) || line != DebugEventsRecorder::FileHeader)
+			THROW(L"Invalid debug events file: " << path_.wstring());
+
+		exitCode_.reset();
+		eventCount_ = 0;
+		lineNumber_ = 1;
+		while (std::getline(ifs, line))
+		{
+			++lineNumber_;
+			if (line.empty())
+				continue;
+			try
+			{
+				auto record = line.substr(0, line.find('\t'));
+				auto isModule = record == DebugEventsRecorder::ProcessRecord ||
+				                record == DebugEventsRecorder::DllRecord;
+				ReplayEvent(handler, Split(line, isModule ? ModuleFieldCount : std::string::npos));
+			}
+			catch (const std::exception& e)
+			{
+				THROW(path_.wstring() << L':' << lineNumber_ << L": " << e.what());
+			}
+			++eventCount_;
+		}
+		processes_.clear();
+		LOG_INFO << L"Debug events replayed: " << eventCount_;
+		return exitCode_ ? *exitCode_ : 0;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugEventsReplayer::GetEventCount() const
+	{
+		return eventCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsReplayer::ReplayEvent(IDebugEventsHandler& handler, const Fields& fields)
+	{
+		const auto& record = fields.front();
+
+		if (record == DebugEventsRecorder::TimerRecord)
+		{
+			handler.OnTimer();
+			return;
+		}
+		if (record == DebugEventsRecorder::ProcessRecord)
+		{
+			LoadModule(handler, fields, true);
+			return;
+		}
+
+		auto& process = GetProcess(fields);
+		if (process.isDetached_)
+			return;
+		auto hThread = GetThread(process, fields);
+		auto hProcess = process.hProcess_;
+
+		if (record == DebugEventsRecorder::DllRecord)
+			LoadModule(handler, fields, false);
+		else if (record == DebugEventsRecorder::UnloadRecord)
+		{
+			auto module = process.FindModule(ToAddress(fields, 3));
+			if (module != process.modules_.end())
+			{
+				UNLOAD_DLL_DEBUG_INFO unloadDll{};
+				unloadDll.lpBaseOfDll = module->view_;
+				handler.OnUnloadDll(hProcess, hThread, unloadDll);
+				module->Release();
+				process.modules_.erase(module);
+			}
+		}
+		else if (record == DebugEventsRecorder::ExceptionRecord)
+		{
+			EXCEPTION_DEBUG_INFO exceptionDebugInfo{};
+			auto& exceptionRecord = exceptionDebugInfo.ExceptionRecord;
+			exceptionRecord.ExceptionCode = ToValue<DWORD>(fields, 3);
+			exceptionRecord.ExceptionAddress = process.Relocate(ToAddress(fields, 4));
+			exceptionDebugInfo.dwFirstChance = ToValue<DWORD>(fields, 5);
+			exceptionRecord.NumberParameters = (std::min)(
+			    ToValue<DWORD>(fields, 6), static_cast<DWORD>(EXCEPTION_MAXIMUM_PARAMETERS));
+			for (DWORD i = 0; i < exceptionRecord.NumberParameters; ++i)
+			{
+				exceptionRecord.ExceptionInformation[i] = reinterpret_cast<ULONG_PTR>(
+				    process.Relocate(ToAddress(fields, 7 + i)));
+			}
+			handler.OnException(hProcess, hThread, exceptionDebugInfo);
+		}
+		else if (record == DebugEventsRecorder::ExitRecord)
+		{
+			EXIT_PROCESS_DEBUG_INFO exitProcess{};
+			exitProcess.dwExitCode = ToValue<DWORD>(fields, 3);
+			handler.OnExitProcess(hProcess, hThread, exitProcess);
+			if (!exitCode_)
+				exitCode_ = static_cast<int>(exitProcess.dwExitCode);
+			ReleaseProcess(ToValue<DWORD>(fields, 1));
+			return;
+		}
+		else
+			THROW(L"Unknown debug event: " << Tools::Utf8ToWString(record));
+
+		// As the debugger, after each event of the process.
+		if (handler.PrepareDetach(hProcess))
+		{
+			handler.OnDetachProcess(hProcess);
+			process.isDetached_ = true;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsReplayer::LoadModule(IDebugEventsHandler& handler,
+	                                     const Fields& fields,
+	                                     bool isProcess)
+	{
+		if (fields.size() != ModuleFieldCount)
+			THROW(L"Invalid module in debug events file.");
+		auto processId = ToValue<DWORD>(fields, 1);
+		if (isProcess)
+		{
+			HANDLE hProcess = nullptr;
+			if (processes_.count(processId))
+				THROW(L"Process " << processId << L" is already created.");
+			if (!DuplicateHandle(GetCurrentProcess(),
+			                     GetCurrentProcess(),
+			                     GetCurrentProcess(),
+			                     &hProcess,
+			                     0,
+			                     FALSE,
+			                     DUPLICATE_SAME_ACCESS))
+			{
+				THROW_LAST_ERROR(L"Cannot duplicate the process handle: ", GetLastError());
+			}
+			processes_.emplace(processId, std::make_unique<Process>(hProcess));
+		}
+
+		auto& process = GetProcess(fields);
+		auto recordedBase = ToAddress(fields, 3);
+		// A postponed load is recorded each time it is reported.
+		if (!isProcess && process.FindModule(recordedBase) != process.modules_.end())
+			return;
+
+		auto path = Tools::Utf8ToWString(fields[8]);
+		auto hFile = CreateFileW(path.c_str(),
+		                         GENERIC_READ | GENERIC_EXECUTE,
+		                         FILE_SHARE_READ | FILE_SHARE_DELETE,
+		                         nullptr,
+		                         OPEN_EXISTING,
+		                         FILE_ATTRIBUTE_NORMAL,
+		                         nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			THROW_LAST_ERROR(L"Cannot open " << path << L": ", GetLastError());
+		Tools::ScopedAction closeFile{[=]() { CloseHandle(hFile); }};
+
+		// Copy on write as the loader: the breakpoints are not written to the file.
+		auto hMapping = CreateFileMappingW(
+		    hFile, nullptr, PAGE_EXECUTE_WRITECOPY | SEC_IMAGE, 0, 0, nullptr);
+		if (!hMapping)
+			THROW_LAST_ERROR(L"Cannot map " << path << L": ", GetLastError());
+		auto view = MapViewOfFile(hMapping, FILE_MAP_COPY | FILE_MAP_EXECUTE, 0, 0, 0);
+		if (!view)
+		{
+			auto lastError = GetLastError();
+			CloseHandle(hMapping);
+			THROW_LAST_ERROR(L"Cannot map " << path << L": ", lastError);
+		}
+		process.modules_.emplace_back(
+		    recordedBase, ToValue<DWORD>(fields, 5), hMapping, view);
+
+		auto identity = DebugEventsRecorder::ReadImageIdentity(GetCurrentProcess(), view);
+		if (identity.timeDateStamp != ToValue<DWORD>(fields, 4) ||
+		    identity.sizeOfImage != ToValue<DWORD>(fields, 5) ||
+		    identity.checkSum != ToValue<DWORD>(fields, 6))
+		{
+			THROW(path << L" has changed since the recording.");
+		}
+		if (identity.is64Bits != (sizeof(void*) == 8))
+			THROW(path << L" must be replayed by the " << (identity.is64Bits ? L"x64" : L"x86")
+			           << L" version of OpenCppCoverage.");
+
+		auto hThread = GetThread(process, fields);
+		if (isProcess)
+		{
+			CREATE_PROCESS_DEBUG_INFO processDebugInfo{};
+			processDebugInfo.hFile = hFile;
+			processDebugInfo.hProcess = process.hProcess_;
+			processDebugInfo.hThread = hThread;
+			processDebugInfo.lpBaseOfImage = view;
+			processDebugInfo.fUnicode = TRUE;
+			handler.OnCreateProcess(processDebugInfo);
+		}
+		else
+		{
+			LOAD_DLL_DEBUG_INFO loadDll{};
+			loadDll.hFile = hFile;
+			loadDll.lpBaseOfDll = view;
+			loadDll.fUnicode = TRUE;
+			handler.OnLoadDll(process.hProcess_, hThread, loadDll);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	DebugEventsReplayer::Process& DebugEventsReplayer::GetProcess(const Fields& fields)
+	{
+		auto processId = ToValue<DWORD>(fields, 1);
+		auto it = processes_.find(processId);
+
+		if (it == processes_.end())
+			THROW(L"Process " << processId << L" is not created.");
+		return *it->second;
+	}
+
+	//-------------------------------------------------------------------------
+	HANDLE DebugEventsReplayer::GetThread(Process& process, const Fields& fields)
+	{
+		auto threadId = ToValue<DWORD>(fields, 2);
+		auto it = process.threads_.find(threadId);
+
+		if (it != process.threads_.end())
+			return it->second;
+		// The thread creations are not recorded: a thread is created on its
+		// first event.
+		auto hThread = CreateThread(nullptr, 0, SuspendedThread, nullptr, CREATE_SUSPENDED, nullptr);
+		if (!hThread)
+			THROW_LAST_ERROR(L"Cannot create thread: ", GetLastError());
+		process.threads_.emplace(threadId, hThread);
+		return hThread;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugEventsReplayer::ReleaseProcess(DWORD processId)
+	{
+		processes_.erase(processId);
+	}
+}
@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Windows.h>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class IDebugEventsHandler;
+
+	// Replay the debug events written by DebugEventsRecorder without the
+	// program, to measure the coverage engine alone. The replayed process is
+	// the current process: each module is mapped again as an image from its
+	// file, which must not have changed since the recording, and the recorded
+	// addresses are moved to this mapping. Each recorded thread is a suspended
+	// thread which is never resumed, so the breakpoints can be written and the
+	// thread contexts changed. PostponeLoadDll is never called.
+	class CPPCOVERAGE_DLL DebugEventsReplayer
+	{
+	public:
+		explicit DebugEventsReplayer(const std::filesystem::path&);
+		~DebugEventsReplayer();
+
+		// Return the exit code of the first process.
+		int Replay(IDebugEventsHandler&);
+		size_t GetEventCount() const;
+
+	private:
+		DebugEventsReplayer(const DebugEventsReplayer&) = delete;
+		DebugEventsReplayer& operator=(const DebugEventsReplayer&) = delete;
+
+		struct Module;
+		struct Process;
+
+		using Fields = std::vector<std::string>;
+
+		void ReplayEvent(IDebugEventsHandler&, const Fields&);
+		void LoadModule(IDebugEventsHandler&, const Fields&, bool isProcess);
+		Process& GetProcess(const Fields&);
+		HANDLE GetThread(Process&, const Fields&);
+		void ReleaseProcess(DWORD processId);
+
+		std::filesystem::path path_;
+		std::map<DWORD, std::unique_ptr<Process>> processes_;
+		boost::optional<int> exitCode_;
+		size_t eventCount_;
+		size_t lineNumber_;
+	};
+}
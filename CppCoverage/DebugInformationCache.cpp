@@ -0,0 +1,68 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DebugInformationCache.hpp"
+
+#include "DebugInformationEnumerator.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	DebugInformationCache::DebugInformationCache(
+		const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths,
+		std::shared_ptr<const PdbCache> pdbCache,
+		bool useNativePdbReader)
+		: substitutePdbSourcePaths_{substitutePdbSourcePaths}
+		, pdbCache_{std::move(pdbCache)}
+		, useNativePdbReader_{useNativePdbReader}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<const DebugInformationCache::EnumeratedModule>
+	DebugInformationCache::GetModule(const std::filesystem::path& path)
+	{
+		std::promise<std::shared_ptr<const EnumeratedModule>> promise;
+		std::error_code error;
+		auto lastWriteTime = std::filesystem::last_write_time(path, error);
+		CachedModule cachedModule;
+		bool isCached = false;
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			auto& module = modules_[path];
+
+			isCached = module.module_.valid() && module.lastWriteTime_ == lastWriteTime;
+			if (!isCached)
+				module = {promise.get_future().share(), lastWriteTime};
+			cachedModule = module;
+		}
+		// Wait outside of the lock: the other modules can be enumerated.
+		if (isCached)
+			return cachedModule.module_.get();
+
+		// An error is stored in the module and rethrown by each Replay.
+		auto enumeratedModule = std::make_shared<EnumeratedModule>();
+		DebugInformationEnumerator debugInformationEnumerator{
+		    substitutePdbSourcePaths_, pdbCache_, useNativePdbReader_};
+
+		enumeratedModule->path_ = path;
+		AsyncDebugInformationEnumerator::EnumerateModule(
+		    debugInformationEnumerator, *enumeratedModule);
+		promise.set_value(enumeratedModule);
+		return enumeratedModule;
+	}
+}
@@ -0,0 +1,65 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+#include "AsyncDebugInformationEnumerator.hpp"
+
+namespace CppCoverage
+{
+	// Share the debug information of the modules between the runners
+	// started in parallel: each module is enumerated only once.
+	// The lines are recorded by RVA so they do not depend on the process
+	// or the load address. A module is enumerated again when its file
+	// is modified.
+	class CPPCOVERAGE_DLL DebugInformationCache
+	{
+	public:
+		using EnumeratedModule = AsyncDebugInformationEnumerator::EnumeratedModule;
+
+		explicit DebugInformationCache(const std::vector<SubstitutePdbSourcePath>&,
+		                               std::shared_ptr<const PdbCache> = nullptr,
+		                               bool useNativePdbReader = false);
+
+		// Enumerate the module for the first caller: the other callers wait
+		// for this enumeration.
+		std::shared_ptr<const EnumeratedModule> GetModule(const std::filesystem::path&);
+
+	private:
+		DebugInformationCache(const DebugInformationCache&) = delete;
+		DebugInformationCache& operator=(const DebugInformationCache&) = delete;
+
+		struct CachedModule
+		{
+			std::shared_future<std::shared_ptr<const EnumeratedModule>> module_;
+			std::filesystem::file_time_type lastWriteTime_;
+		};
+
+		const std::vector<SubstitutePdbSourcePath> substitutePdbSourcePaths_;
+		const std::shared_ptr<const PdbCache> pdbCache_;
+		const bool useNativePdbReader_;
+		std::mutex mutex_;
+		std::map<std::filesystem::path, CachedModule> modules_;
+	};
+}
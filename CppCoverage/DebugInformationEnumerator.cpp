@@ -22,17 +22,33 @@
 #include <dia2.h>
 #include <atlbase.h>
 
+#include <algorithm>
 #include <filesystem>
+#include <fstream>
 #include <boost/algorithm/string.hpp>
 
 #include "tools/Log.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/ThreadPool.hpp"
 
 #include "CppCoverageException.hpp"
+#include "NativePdbReader.hpp"
+#include "PdbCache.hpp"
+#include "SymbolPrefetcher.hpp"
+#include "SymbolLoadThrottle.hpp"
+#include "EtwProvider.hpp"
 
 namespace CppCoverage
 {
 	namespace
 	{
+		// Below this count, a thread does not save the time to open its session.
+		const size_t MinSourceFileCountByWorker = 64;
+		// With /DEBUG:FASTLINK, DIA reads the lines of each source file from
+		// its object file.
+		const size_t MinFastLinkSourceFileCountByWorker = 8;
+		const size_t PrefetchBufferSize = 1024 * 1024;
+
 		//----------------------------------------------------------------------
 		class DiaString
 		{
@@ -187,7 +203,8 @@ namespace CppCoverage
 
 		//----------------------------------------------------------------------
 		CComPtr<IDiaDataSource>
-		LoadDataForExe(const std::filesystem::path& path)
+		LoadDataForExe(const std::filesystem::path& path,
+		               const boost::optional<std::filesystem::path>& searchPath)
 		{
 			CComPtr<IDiaDataSource> sourcePtr;
 
@@ -204,83 +221,538 @@ namespace CppCoverage
 			DiaLoadCallback diaLoadCallback;
 			if (!sourcePtr ||
 			    sourcePtr->loadDataForExe(
-			        path.wstring().c_str(), nullptr, &diaLoadCallback) != S_OK)
+			        path.wstring().c_str(),
+			        searchPath ? searchPath->wstring().c_str() : nullptr,
+			        &diaLoadCallback) != S_OK)
 			{
 				return nullptr;
 			}
 			return sourcePtr;
 		}
+
+		//----------------------------------------------------------------------
+		// Read the files on several threads: DIA finds them in the file cache.
+		void PrefetchFiles(const std::vector<std::filesystem::path>& paths)
+		{
+			Tools::ScratchArenas<std::vector<char>> buffers;
+
+			Tools::ParallelFor(paths.size(), 1, [&](size_t i) {
+				auto& buffer = buffers.Get();
+
+				buffer.resize(PrefetchBufferSize);
+				std::ifstream file{paths[i], std::ios::binary};
+				while (file.read(buffer.data(), buffer.size()))
+					;
+			});
+		}
+
+		//----------------------------------------------------------------------
+		// false when the module was not linked with /DEBUG:FASTLINK.
+		bool PrefetchFastLinkObjectFiles(const std::filesystem::path& path)
+		{
+			boost::optional<std::vector<std::filesystem::path>> objectFiles;
+			try
+			{
+				objectFiles = NativePdbReader::ReadFastLinkObjectFiles(path);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_WARNING << L"Cannot read the object files of the PDB of "
+				            << path.wstring() << L": " << e.what();
+			}
+			if (!objectFiles)
+				return false;
+
+			LOG_INFO << path.wstring() << L" is linked with /DEBUG:FASTLINK, prefetch its "
+			         << objectFiles->size() << L" object files.";
+			PrefetchFiles(*objectFiles);
+			return true;
+		}
 	}
 
 	//--------------------------------------------------------------------------
 	DebugInformationEnumerator::DebugInformationEnumerator(
-	    const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths)
+	    const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths,
+	    std::shared_ptr<const PdbCache> pdbCache,
+	    bool useNativePdbReader,
+	    std::shared_ptr<SymbolPrefetcher> symbolPrefetcher)
 		: substitutePdbSourcePaths_{ substitutePdbSourcePaths }
+		, pdbCache_{ std::move(pdbCache) }
+		, useNativePdbReader_{ useNativePdbReader }
+		, symbolPrefetcher_{ std::move(symbolPrefetcher) }
 	{
+		for (size_t i = 0; i < substitutePdbSourcePaths_.size(); ++i)
+		{
+			auto pdbStartPath = boost::to_lower_copy(substitutePdbSourcePaths_[i].GetPdbStartPath().wstring());
+			pdbStartPaths_.Add(pdbStartPath.begin(), pdbStartPath.end(), i);
+		}
 	}
 
+	//-------------------------------------------------------------------------
+	struct DebugInformationEnumerator::DiaModule
+	{
+		std::filesystem::file_time_type lastWriteTime_;
+		CComPtr<IDiaDataSource> dataSource_;
+		CComPtr<IDiaSession> session_;
+		bool isFastLink_;
+
+		struct SourceFileName
+		{
+			std::wstring pdbFilename_;
+			std::filesystem::path filename_;
+			Tools::SourceChecksum checksum_;
+		};
+		// In the order of the source files of the session.
+		std::vector<SourceFileName> sourceFileNames_;
+	};
+
+	//-------------------------------------------------------------------------
+	DebugInformationEnumerator::~DebugInformationEnumerator() = default;
+
 	//-------------------------------------------------------------------------
 	bool
 	DebugInformationEnumerator::Enumerate(const std::filesystem::path& path,
 	                                      IDebugInformationHandler& handler)
 	{
-		auto sourcePtr = LoadDataForExe(path);
+		EtwProvider::OnSymbolLoadStart(path);
+		Tools::ScopedAction onSymbolLoadStop{[&]() { EtwProvider::OnSymbolLoadStop(path); }};
+
+		boost::optional<std::wstring> cacheKey;
+		if (pdbCache_)
+			cacheKey = PdbCache::GetKey(path);
+		if (cacheKey && EnumerateFromCache(*cacheKey, handler))
+			return true;
+
+		// Kept until the cache file is written.
+		std::unique_ptr<PdbCache::KeyLock> keyLock;
+		if (cacheKey && !pdbCache_->IsWithoutPdb(*cacheKey, path))
+		{
+			keyLock = pdbCache_->LockKey(*cacheKey);
+			if (keyLock && keyLock->HasWaited() && EnumerateFromCache(*cacheKey, handler))
+				return true;
+		}
+		if (cacheKey && pdbCache_->IsWithoutPdb(*cacheKey, path))
+		{
+			LOG_DEBUG << L"No PDB found for " << path.wstring() << L" in a previous run.";
+			return false;
+		}
+
+		// Kept while the PDB is read.
+		SymbolLoadThrottle::Scope symbolLoadScope;
+		if (useNativePdbReader_ && EnumerateFromNativePdbReader(path, cacheKey, handler))
+			return true;
 
-		if (!sourcePtr)
+		const auto* diaModule = GetDiaModule(path);
+		if (!diaModule)
+		{
+			if (cacheKey)
+				SetWithoutPdb(path, *cacheKey);
 			return false;
+		}
+
+		const auto& sourcePtr = diaModule->dataSource_;
+		const auto& sessionPtr = diaModule->session_;
 
-		CComPtr<IDiaSession> sessionPtr;
-		if (sourcePtr->openSession(&sessionPtr) != S_OK || !sessionPtr)
-			THROW("DIA: Cannot open session.");
+		// The handler is called on this thread only.
+		std::vector<SelectedSourceFile> selectedSourceFiles;
+		const auto& sourceFileNames = diaModule->sourceFileNames_;
+		for (size_t index = 0; index < sourceFileNames.size(); ++index)
+		{
+			const auto& sourceFileName = sourceFileNames[index];
+			auto isSelected = handler.IsSourceFileSelected(sourceFileName.filename_);
+			if (isSelected || cacheKey)
+			{
+				// The cache needs all the lines.
+				boost::optional<std::set<int>> lineNumbers;
+				if (!cacheKey)
+					lineNumbers = handler.GetSelectedLineNumbers(sourceFileName.filename_);
+				selectedSourceFiles.push_back({index,
+				                               sourceFileName.pdbFilename_,
+				                               sourceFileName.filename_,
+				                               isSelected,
+				                               std::move(lineNumbers),
+				                               {},
+				                               sourceFileName.checksum_});
+			}
+		}
+
+		if (selectedSourceFiles.empty() && !cacheKey)
+		{
+			LOG_DEBUG << L"No selected source file in " << path.wstring();
+			return true;
+		}
 
-		auto sourceFiles = GetEnumSourceFiles(*sessionPtr);
+		LoadFunctions(*sessionPtr);
+		auto workerCount = (std::min)(
+		    Tools::ThreadPool::GetDefault().GetThreadCount(),
+		    selectedSourceFiles.size() / (diaModule->isFastLink_ ? MinFastLinkSourceFileCountByWorker
+		                                                         : MinSourceFileCountByWorker));
+		if (workerCount > 1)
+			EnumLinesInParallel(*sourcePtr, *sessionPtr, selectedSourceFiles, workerCount);
+		else
+			EnumSelectedLines(*sessionPtr, selectedSourceFiles, 0, 1);
+		functions_.clear();
+
+		std::vector<PdbCache::SourceFile> cachedSourceFiles;
+		for (auto& sourceFile : selectedSourceFiles)
+		{
+			if (sourceFile.isSelected_)
+			{
+				if (sourceFile.checksum_.type_ != Tools::SourceChecksum::Type::None)
+					handler.OnSourceFileChecksum(sourceFile.filename_, sourceFile.checksum_);
+				handler.OnSourceFile(sourceFile.filename_, sourceFile.lines_);
+			}
+			if (cacheKey)
+			{
+				cachedSourceFiles.push_back({std::move(sourceFile.pdbFilename_),
+				                             std::move(sourceFile.lines_),
+				                             sourceFile.checksum_});
+			}
+		}
+
+		if (cacheKey)
+			WriteCache(path, *cacheKey, cachedSourceFiles);
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	const DebugInformationEnumerator::DiaModule*
+	DebugInformationEnumerator::GetDiaModule(const std::filesystem::path& path)
+	{
+		std::error_code error;
+		auto lastWriteTime = std::filesystem::last_write_time(path, error);
+		auto& diaModule = diaModules_[path];
+
+		if (!diaModule || diaModule->lastWriteTime_ != lastWriteTime)
+		{
+			diaModule = std::make_unique<DiaModule>();
+			diaModule->lastWriteTime_ = lastWriteTime;
+			diaModule->isFastLink_ = PrefetchFastLinkObjectFiles(path);
+			boost::optional<std::filesystem::path> searchPath;
+			if (symbolPrefetcher_)
+				searchPath = symbolPrefetcher_->GetPdbFolder(path);
+			diaModule->dataSource_ = LoadDataForExe(path, searchPath);
+
+			if (diaModule->dataSource_ &&
+			    (diaModule->dataSource_->openSession(&diaModule->session_) != S_OK ||
+			     !diaModule->session_))
+			{
+				diaModule.reset();
+				THROW("DIA: Cannot open session.");
+			}
+			if (diaModule->session_)
+				LoadSourceFileNames(*diaModule);
+		}
+		else
+			LOG_DEBUG << L"Reuse the DIA session of " << path.wstring();
+
+		if (!diaModule->dataSource_)
+			return nullptr;
+		return diaModule.get();
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::LoadSourceFileNames(DiaModule& diaModule) const
+	{
+		auto sourceFiles = GetEnumSourceFiles(*diaModule.session_);
 		if (!sourceFiles)
 			THROW("DIA: cannot get SourceFiles");
 
 		EnumerateCollection<IDiaSourceFile>(
 		    *sourceFiles, [&](IDiaSourceFile& sourceFile) {
-			    auto filename = GetSourceFileName(sourceFile);
-			    if (handler.IsSourceFileSelected(filename))
+			    auto pdbFilename = GetSourceFileName(sourceFile);
+			    auto filename = SubstitutePath(pdbFilename);
+			    diaModule.sourceFileNames_.push_back(
+			        {std::move(pdbFilename), std::move(filename), GetSourceFileChecksum(sourceFile)});
+		    });
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::LoadFunctions(IDiaSession& session)
+	{
+		functions_.clear();
+
+		CComPtr<IDiaSymbol> globalScope;
+		CComPtr<IDiaEnumSymbols> compilands;
+		if (session.get_globalScope(&globalScope) != S_OK || !globalScope ||
+		    globalScope->findChildren(SymTagEnum::SymTagCompiland, nullptr, nsNone, &compilands) != S_OK ||
+		    !compilands)
+		{
+			THROW("DIA: Cannot get compilands");
+		}
+
+		EnumerateCollection<IDiaSymbol>(*compilands, [&](IDiaSymbol& compiland) {
+			CComPtr<IDiaEnumSymbols> functions;
+			if (compiland.findChildren(SymTagEnum::SymTagFunction, nullptr, nsNone, &functions) != S_OK ||
+			    !functions)
+				return;
+
+			EnumerateCollection<IDiaSymbol>(*functions, [&](IDiaSymbol& function) {
+				ULONGLONG virtualAddress = 0;
+				ULONGLONG length = 0;
+				DWORD symIndex = 0;
+				if (function.get_virtualAddress(&virtualAddress) == S_OK &&
+				    function.get_length(&length) == S_OK && length != 0 &&
+				    function.get_symIndexId(&symIndex) == S_OK)
+				{
+					functions_.push_back({virtualAddress, length, symIndex});
+				}
+			});
+		});
+
+		std::sort(functions_.begin(), functions_.end(), [](const auto& f1, const auto& f2) {
+			return f1.virtualAddress_ < f2.virtualAddress_;
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	const DebugInformationEnumerator::Function*
+	DebugInformationEnumerator::FindFunction(uint64_t virtualAddress) const
+	{
+		auto it = std::upper_bound(functions_.begin(), functions_.end(), virtualAddress,
+		                           [](uint64_t address, const auto& function) {
+			                           return address < function.virtualAddress_;
+		                           });
+		if (it == functions_.begin())
+			return nullptr;
+		--it;
+		if (virtualAddress >= it->virtualAddress_ + it->length_)
+			return nullptr;
+		return &*it;
+	}
+
+	//-------------------------------------------------------------------------
+	bool DebugInformationEnumerator::EnumerateFromCache(
+	    const std::wstring& cacheKey,
+	    IDebugInformationHandler& handler) const
+	{
+		boost::optional<std::vector<PdbCache::SourceFile>> sourceFiles;
+		try
+		{
+			sourceFiles = pdbCache_->Read(cacheKey);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot read the PDB cache: " << e.what();
+		}
+		if (!sourceFiles)
+			return false;
+
+		LOG_DEBUG << L"Debug information read from the PDB cache " << cacheKey;
+		OnSourceFiles(*sourceFiles, handler);
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool DebugInformationEnumerator::EnumerateFromNativePdbReader(
+	    const std::filesystem::path& path,
+	    const boost::optional<std::wstring>& cacheKey,
+	    IDebugInformationHandler& handler) const
+	{
+		boost::optional<std::vector<PdbSourceFile>> sourceFiles;
+		try
+		{
+			sourceFiles = NativePdbReader::Read(path);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot read the PDB of " << path.wstring()
+			            << L" without DIA: " << e.what();
+		}
+		if (!sourceFiles)
+			return false;
+
+		OnSourceFiles(*sourceFiles, handler);
+		if (cacheKey)
+			WriteCache(path, *cacheKey, *sourceFiles);
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::OnSourceFiles(
+	    const std::vector<PdbSourceFile>& sourceFiles,
+	    IDebugInformationHandler& handler) const
+	{
+		for (const auto& sourceFile : sourceFiles)
+		{
+			auto filename = SubstitutePath(sourceFile.path_);
+			if (handler.IsSourceFileSelected(filename))
+			{
+				if (sourceFile.checksum_.type_ != Tools::SourceChecksum::Type::None)
+					handler.OnSourceFileChecksum(filename, sourceFile.checksum_);
+				handler.OnSourceFile(filename, sourceFile.lines_);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::SetWithoutPdb(
+	    const std::filesystem::path& path,
+	    const std::wstring& cacheKey) const
+	{
+		try
+		{
+			pdbCache_->SetWithoutPdb(cacheKey, path);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot cache the missing PDB of "
+			            << path.wstring() << L": " << e.what();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::WriteCache(
+	    const std::filesystem::path& path,
+	    const std::wstring& cacheKey,
+	    const std::vector<PdbSourceFile>& sourceFiles) const
+	{
+		try
+		{
+			pdbCache_->Write(cacheKey, sourceFiles);
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot cache the debug information of "
+			            << path.wstring() << L": " << e.what();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::EnumSelectedLines(
+	    IDiaSession& session,
+	    std::vector<SelectedSourceFile>& selectedSourceFiles,
+	    size_t firstSourceFile,
+	    size_t step) const
+	{
+		auto sourceFiles = GetEnumSourceFiles(session);
+		if (!sourceFiles)
+			THROW("DIA: cannot get SourceFiles");
+
+		// All the sessions enumerate the source files in the same order.
+		auto next = firstSourceFile;
+		size_t index = 0;
+		EnumerateCollection<IDiaSourceFile>(
+		    *sourceFiles, [&](IDiaSourceFile& sourceFile) {
+			    if (next < selectedSourceFiles.size() &&
+			        selectedSourceFiles[next].index_ == index)
 			    {
-				    lines_.clear();
-				    EnumLines(*sessionPtr, sourceFile, handler);
-				    handler.OnSourceFile(filename, lines_);
+				    auto& selectedSourceFile = selectedSourceFiles[next];
+				    EnumLines(session,
+				              sourceFile,
+				              selectedSourceFile.lineNumbers_.get_ptr(),
+				              selectedSourceFile.lines_);
+				    next += step;
 			    }
+			    ++index;
 		    });
-		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugInformationEnumerator::EnumLinesInParallel(
+	    IDiaDataSource& dataSource,
+	    IDiaSession& session,
+	    std::vector<SelectedSourceFile>& selectedSourceFiles,
+	    size_t workerCount) const
+	{
+		LOG_DEBUG << L"Enumerate " << selectedSourceFiles.size()
+		          << L" source files with " << workerCount << L" threads.";
+
+		// Each task opens its own session: a DIA session is not thread safe.
+		Tools::TaskGroup taskGroup;
+		for (size_t i = 1; i < workerCount; ++i)
+		{
+			taskGroup.Run([&, i]() {
+				CComPtr<IDiaSession> workerSession;
+				if (dataSource.openSession(&workerSession) != S_OK || !workerSession)
+					THROW("DIA: Cannot open session.");
+				EnumSelectedLines(*workerSession, selectedSourceFiles, i, workerCount);
+			});
+		}
+
+		EnumSelectedLines(session, selectedSourceFiles, 0, workerCount);
+		taskGroup.Wait();
 	}
 
 	//----------------------------------------------------------------------
 	void
 	DebugInformationEnumerator::EnumLines(IDiaSession& session,
 	                                      IDiaSourceFile& sourceFile,
-	                                      IDebugInformationHandler& handler)
+	                                      const std::set<int>* selectedLineNumbers,
+	                                      std::vector<IDebugInformationHandler::Line>& lines) const
 	{
 		CComPtr<IDiaEnumSymbols> symbols;
 		if (sourceFile.get_compilands(&symbols) != S_OK || !symbols)
 			THROW("DIA: Cannot get compilands");
 
 		EnumerateCollection<IDiaSymbol>(*symbols, [&](IDiaSymbol& symbol) {
-			CComPtr<IDiaEnumLineNumbers> lines;
+			if (selectedLineNumbers)
+			{
+				EnumLinesByLineNumber(session, symbol, sourceFile, *selectedLineNumbers, lines);
+				return;
+			}
+
+			CComPtr<IDiaEnumLineNumbers> lineNumbers;
 
-			if (session.findLines(&symbol, &sourceFile, &lines) != S_OK ||
-			    !lines)
+			if (session.findLines(&symbol, &sourceFile, &lineNumbers) != S_OK ||
+			    !lineNumbers)
 			{
 				THROW("DIA: Cannot find lines");
 			}
 
 			EnumerateCollection<IDiaLineNumber>(
-			    *lines, [&](IDiaLineNumber& lineNumber) {
-				    OnNewLine(session, lineNumber, handler);
+			    *lineNumbers, [&](IDiaLineNumber& lineNumber) {
+				    OnNewLine(session, lineNumber, lines);
 			    });
 		});
 	}
 
+	//----------------------------------------------------------------------
+	void DebugInformationEnumerator::EnumLinesByLineNumber(
+	    IDiaSession& session,
+	    IDiaSymbol& compiland,
+	    IDiaSourceFile& sourceFile,
+	    const std::set<int>& selectedLineNumbers,
+	    std::vector<IDebugInformationHandler::Line>& lines) const
+	{
+		// findLinesByLinenum can also return the lines following a line
+		// without code: only the selected lines are kept, once.
+		std::set<std::pair<DWORD, ULONGLONG>> foundLines;
+
+		for (auto selectedLineNumber : selectedLineNumbers)
+		{
+			CComPtr<IDiaEnumLineNumbers> lineNumbers;
+			if (selectedLineNumber <= 0 ||
+			    session.findLinesByLinenum(&compiland,
+			                               &sourceFile,
+			                               static_cast<DWORD>(selectedLineNumber),
+			                               0,
+			                               &lineNumbers) != S_OK ||
+			    !lineNumbers)
+			{
+				continue;
+			}
+
+			EnumerateCollection<IDiaLineNumber>(
+			    *lineNumbers, [&](IDiaLineNumber& lineNumber) {
+				    DWORD linenum = 0;
+				    ULONGLONG virtualAddress = 0;
+				    if (lineNumber.get_lineNumber(&linenum) == S_OK &&
+				        lineNumber.get_virtualAddress(&virtualAddress) == S_OK &&
+				        selectedLineNumbers.count(static_cast<int>(linenum)) &&
+				        foundLines.emplace(linenum, virtualAddress).second)
+				    {
+					    OnNewLine(session, lineNumber, lines);
+				    }
+			    });
+		}
+	}
+
 	//----------------------------------------------------------------------
 	void
 	DebugInformationEnumerator::OnNewLine(IDiaSession& session,
 	                                      IDiaLineNumber& lineNumber,
-	                                      IDebugInformationHandler& handler)
+	                                      std::vector<IDebugInformationHandler::Line>& lines) const
 	{
 		DWORD linenum = 0;
 		if (lineNumber.get_lineNumber(&linenum) != S_OK)
@@ -293,6 +765,18 @@ namespace CppCoverage
 			if (lineNumber.get_virtualAddress(&virtualAddress) != S_OK)
 				THROW("DIA: Cannot get virtual address");
 
+			// The lines outside of the functions loaded by LoadFunctions
+			// search their symbol.
+			if (const auto* function = FindFunction(virtualAddress))
+			{
+				lines.emplace_back(linenum,
+				                   virtualAddress,
+				                   function->symbolIndex_,
+				                   function->virtualAddress_,
+				                   function->length_);
+				return;
+			}
+
 			CComPtr<IDiaSymbol> symbol;
 			if (session.findSymbolByVA(
 			        virtualAddress, SymTagEnum::SymTagNull, &symbol) != S_OK ||
@@ -305,34 +789,88 @@ namespace CppCoverage
 			if (symbol->get_symIndexId(&symIndex) != S_OK)
 				THROW("DIA: Cannot get symIndex");
 
-			lines_.emplace_back(linenum, virtualAddress, symIndex);
+			ULONGLONG functionVirtualAddress = 0;
+			ULONGLONG functionLength = 0;
+			CComPtr<IDiaSymbol> function = symbol;
+			DWORD symTag = 0;
+			if (symbol->get_symTag(&symTag) != S_OK ||
+			    symTag != SymTagEnum::SymTagFunction)
+			{
+				function = nullptr;
+				session.findSymbolByVA(
+				    virtualAddress, SymTagEnum::SymTagFunction, &function);
+			}
+			if (!function ||
+			    function->get_virtualAddress(&functionVirtualAddress) != S_OK ||
+			    function->get_length(&functionLength) != S_OK)
+			{
+				functionVirtualAddress = 0;
+				functionLength = 0;
+			}
+
+			lines.emplace_back(linenum,
+			                   virtualAddress,
+			                   symIndex,
+			                   functionVirtualAddress,
+			                   functionLength);
 		}
 	}
 
 	//----------------------------------------------------------------------
-	std::filesystem::path DebugInformationEnumerator::GetSourceFileName(
+	std::wstring DebugInformationEnumerator::GetSourceFileName(
 	    IDiaSourceFile& sourceFile) const
 	{
 		DiaString fileName;
 		if (sourceFile.get_fileName(&fileName) != S_OK)
 			THROW("DIA: Cannot get filename");
-		std::wstring filenameStr = fileName;
+		return fileName;
+	}
 
-		for (const auto& paths : substitutePdbSourcePaths_)
-		{
-			auto pdbStartPath = paths.GetPdbStartPath().wstring();
+	//----------------------------------------------------------------------
+	// The checksum is optional: an unknown algorithm is ignored.
+	Tools::SourceChecksum DebugInformationEnumerator::GetSourceFileChecksum(
+	    IDiaSourceFile& sourceFile) const
+	{
+		Tools::SourceChecksum checksum;
+		DWORD checksumType = 0;
+		DWORD size = 0;
 
-			if (boost::istarts_with(filenameStr, pdbStartPath))
-			{
-				auto startIndex = pdbStartPath.size();
-				if (startIndex < filenameStr.size() && filenameStr[startIndex] == '\\')
-					++startIndex;
-				auto remainingPath = filenameStr.substr(startIndex);
-				filenameStr = (paths.GetLocalPath() / remainingPath).wstring();
-				break;
-			}
+		if (sourceFile.get_checksumType(&checksumType) != S_OK ||
+		    checksumType > static_cast<DWORD>(Tools::SourceChecksum::Type::Sha256) ||
+		    sourceFile.get_checksum(0, &size, nullptr) != S_OK || size == 0)
+		{
+			return checksum;
 		}
 
-		return filenameStr;
+		std::string bytes(size, '\0');
+		if (sourceFile.get_checksum(size, &size, reinterpret_cast<BYTE*>(&bytes[0])) != S_OK)
+			return checksum;
+		bytes.resize(size);
+		checksum.type_ = static_cast<Tools::SourceChecksum::Type>(checksumType);
+		checksum.bytes_ = std::move(bytes);
+		return checksum;
+	}
+
+	//----------------------------------------------------------------------
+	std::filesystem::path DebugInformationEnumerator::SubstitutePath(
+	    const std::wstring& pdbFilename) const
+	{
+		if (substitutePdbSourcePaths_.empty())
+			return pdbFilename;
+
+		// The first substitution, in the command line order, whose start path
+		// begins pdbFilename.
+		const auto lowerFilename = boost::to_lower_copy(pdbFilename);
+		auto index = pdbStartPaths_.FindSmallestPrefixValue(lowerFilename.begin(), lowerFilename.end());
+
+		if (!index)
+			return pdbFilename;
+
+		const auto& paths = substitutePdbSourcePaths_[*index];
+		auto startIndex = paths.GetPdbStartPath().wstring().size();
+		if (startIndex < pdbFilename.size() && pdbFilename[startIndex] == '\\')
+			++startIndex;
+		auto remainingPath = pdbFilename.substr(startIndex);
+		return paths.GetLocalPath() / remainingPath;
 	}
 }
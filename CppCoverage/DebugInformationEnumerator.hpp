@@ -17,16 +17,29 @@
 #pragma once
 
 #include <filesystem>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
 
 #include "CppCoverageExport.hpp"
 #include "SubstitutePdbSourcePath.hpp"
+#include "Tools/PrefixTrie.hpp"
+#include "Tools/SourceChecksum.hpp"
 
+struct IDiaDataSource;
 struct IDiaSession;
 struct IDiaLineNumber;
 struct IDiaSourceFile;
+struct IDiaSymbol;
 
 namespace CppCoverage
 {
+	class PdbCache;
+	class SymbolPrefetcher;
+
 	//-------------------------------------------------------------------------
 	class IDebugInformationHandler
 	{
@@ -35,10 +48,14 @@ namespace CppCoverage
 		{
 			Line(unsigned long lineNumber,
 			     int64_t virtualAddress,
-			     unsigned long symbolIndex)
+			     unsigned long symbolIndex,
+			     int64_t functionVirtualAddress = 0,
+			     uint64_t functionLength = 0)
 			    : lineNumber_{lineNumber},
 			      virtualAddress_{virtualAddress},
-			      symbolIndex_{symbolIndex}
+			      symbolIndex_{symbolIndex},
+			      functionVirtualAddress_{functionVirtualAddress},
+			      functionLength_{functionLength}
 			{
 			}
 			Line(const Line&) = default;
@@ -48,32 +65,151 @@ namespace CppCoverage
 			unsigned long lineNumber_;
 			unsigned long symbolIndex_;
 			int64_t virtualAddress_;
+			// Unknown when functionLength_ is 0.
+			int64_t functionVirtualAddress_;
+			uint64_t functionLength_;
 		};
 
 		virtual ~IDebugInformationHandler() = default;
 		virtual bool IsSourceFileSelected(const std::filesystem::path&) = 0;
 		virtual void OnSourceFile(const std::filesystem::path&,
 		                          const std::vector<Line>&) = 0;
+
+		// Called before OnSourceFile for the selected source files whose
+		// checksum is in the PDB.
+		virtual void OnSourceFileChecksum(const std::filesystem::path&,
+		                                  const Tools::SourceChecksum&)
+		{
+		}
+
+		// The lines of a selected source file OnSourceFile needs, boost::none
+		// for all its lines. Other lines can still be returned.
+		virtual boost::optional<std::set<int>>
+		GetSelectedLineNumbers(const std::filesystem::path&)
+		{
+			return boost::none;
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	struct PdbSourceFile
+	{
+		// The path read from the PDB, before any SubstitutePdbSourcePath.
+		std::wstring path_;
+		std::vector<IDebugInformationHandler::Line> lines_;
+		Tools::SourceChecksum checksum_;
 	};
 
 	//-------------------------------------------------------------------------
 	class CPPCOVERAGE_DLL DebugInformationEnumerator
 	{
 	  public:
-		explicit DebugInformationEnumerator(const std::vector<SubstitutePdbSourcePath>&);
+		// With a PdbCache, the modules already in the cache do not load their
+		// PDB and all the source files of the other modules are enumerated to
+		// be cached. The modules without PDB are also cached.
+		// Without PdbCache, only the lines returned by
+		// IDebugInformationHandler::GetSelectedLineNumbers are searched.
+		// The lines of the modules with many source files are enumerated by
+		// several threads, each with its own DIA session.
+		// The DIA sessions are kept until the destruction of the enumerator
+		// with the names of their source files: the modules loaded again, by
+		// a child process for example, do not load their PDB again.
+		// The PDBs are read in a SymbolLoadThrottle::Scope, the cache is not.
+		// The lines are enumerated only for the selected source files.
+		// With useNativePdbReader, the line tables are read by NativePdbReader
+		// and DIA is used only for the PDBs it cannot read.
+		// With a SymbolPrefetcher, DIA loads the PDBs not found next to their
+		// module from its local copy.
+		// The object files of a PDB created with /DEBUG:FASTLINK are read on
+		// several threads before DIA loads the PDB, and its lines are
+		// enumerated by more threads. With a PdbCache, its lines are read
+		// from the object files only once.
+		explicit DebugInformationEnumerator(
+		    const std::vector<SubstitutePdbSourcePath>&,
+		    std::shared_ptr<const PdbCache> = nullptr,
+		    bool useNativePdbReader = false,
+		    std::shared_ptr<SymbolPrefetcher> = nullptr);
+		~DebugInformationEnumerator();
+
 		bool Enumerate(const std::filesystem::path&,
 		               IDebugInformationHandler&);
 
 	  private:
-		void
-		EnumLines(IDiaSession&, IDiaSourceFile&, IDebugInformationHandler&);
-		void
-		OnNewLine(IDiaSession&, IDiaLineNumber&, IDebugInformationHandler&);
+		DebugInformationEnumerator(const DebugInformationEnumerator&) = delete;
+		DebugInformationEnumerator& operator=(const DebugInformationEnumerator&) = delete;
 
-		std::filesystem::path
-		GetSourceFileName(IDiaSourceFile&) const;
+		struct DiaModule;
 
-		std::vector<IDebugInformationHandler::Line> lines_;
+		struct Function
+		{
+			uint64_t virtualAddress_;
+			uint64_t length_;
+			unsigned long symbolIndex_;
+		};
+
+		struct SelectedSourceFile
+		{
+			// Index in the source files of the session.
+			size_t index_;
+			std::wstring pdbFilename_;
+			std::filesystem::path filename_;
+			bool isSelected_;
+			// Only these lines are searched when they are set.
+			boost::optional<std::set<int>> lineNumbers_;
+			std::vector<IDebugInformationHandler::Line> lines_;
+			Tools::SourceChecksum checksum_;
+		};
+
+		// nullptr when the module has no PDB.
+		const DiaModule* GetDiaModule(const std::filesystem::path&);
+		void LoadSourceFileNames(DiaModule&) const;
+		void LoadFunctions(IDiaSession&);
+		const Function* FindFunction(uint64_t virtualAddress) const;
+		void EnumSelectedLines(IDiaSession&,
+		                       std::vector<SelectedSourceFile>&,
+		                       size_t firstSourceFile,
+		                       size_t step) const;
+		void EnumLinesInParallel(IDiaDataSource&,
+		                         IDiaSession&,
+		                         std::vector<SelectedSourceFile>&,
+		                         size_t workerCount) const;
+		void EnumLines(IDiaSession&,
+		               IDiaSourceFile&,
+		               const std::set<int>* lineNumbers,
+		               std::vector<IDebugInformationHandler::Line>&) const;
+		void EnumLinesByLineNumber(IDiaSession&,
+		                           IDiaSymbol& compiland,
+		                           IDiaSourceFile&,
+		                           const std::set<int>& selectedLineNumbers,
+		                           std::vector<IDebugInformationHandler::Line>&) const;
+		void OnNewLine(IDiaSession&,
+		               IDiaLineNumber&,
+		               std::vector<IDebugInformationHandler::Line>&) const;
+
+		bool EnumerateFromCache(const std::wstring& cacheKey,
+		                        IDebugInformationHandler&) const;
+		bool EnumerateFromNativePdbReader(const std::filesystem::path&,
+		                                  const boost::optional<std::wstring>& cacheKey,
+		                                  IDebugInformationHandler&) const;
+		void OnSourceFiles(const std::vector<PdbSourceFile>&,
+		                   IDebugInformationHandler&) const;
+		void SetWithoutPdb(const std::filesystem::path&,
+		                   const std::wstring& cacheKey) const;
+		void WriteCache(const std::filesystem::path&,
+		                const std::wstring& cacheKey,
+		                const std::vector<PdbSourceFile>&) const;
+		std::wstring GetSourceFileName(IDiaSourceFile&) const;
+		Tools::SourceChecksum GetSourceFileChecksum(IDiaSourceFile&) const;
+		std::filesystem::path SubstitutePath(const std::wstring& pdbFilename) const;
+
+		// Sorted by virtual address.
+		std::vector<Function> functions_;
 		const std::vector<SubstitutePdbSourcePath> substitutePdbSourcePaths_;
+		// The lower case pdb start paths to the index of their substitution.
+		Tools::PrefixTrie pdbStartPaths_;
+		const std::shared_ptr<const PdbCache> pdbCache_;
+		const bool useNativePdbReader_;
+		const std::shared_ptr<SymbolPrefetcher> symbolPrefetcher_;
+		std::map<std::filesystem::path, std::unique_ptr<DiaModule>> diaModules_;
 	};
 }
@@ -0,0 +1,91 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "DebugStringWriter.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	DebugStringWriter::DebugStringWriter(const std::filesystem::path& path)
+		: isStopped_{false}
+		, stringCount_{0}
+	{
+		Tools::CreateParentFolderIfNeeded(path);
+		ofs_.open(path, std::ios::binary);
+		if (!ofs_)
+			THROW(L"Cannot open debug strings file: " << path.wstring());
+		thread_ = std::thread{[this]() { WriteBatches(); }};
+	}
+
+	//-------------------------------------------------------------------------
+	DebugStringWriter::~DebugStringWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			isStopped_ = true;
+		}
+		condition_.notify_one();
+		thread_.join();
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugStringWriter::Write(DWORD processId, const std::wstring& str)
+	{
+		auto line = std::to_wstring(processId) + L": " + str;
+
+		if (line.empty() || line.back() != L'\n')
+			line += L'\n';
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			pendingStrings_.push_back(std::move(line));
+			++stringCount_;
+		}
+		condition_.notify_one();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t DebugStringWriter::GetStringCount() const
+	{
+		return stringCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void DebugStringWriter::WriteBatches()
+	{
+		std::vector<std::wstring> strings;
+
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				condition_.wait(lock, [this]() { return isStopped_ || !pendingStrings_.empty(); });
+				if (pendingStrings_.empty())
+					return;
+				strings.swap(pendingStrings_);
+			}
+			for (const auto& str : strings)
+				ofs_ << Tools::ToUtf8String(str);
+			ofs_.flush();
+			strings.clear();
+		}
+	}
+}
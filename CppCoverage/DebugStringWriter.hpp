@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Write the OutputDebugString strings to a file from a background thread:
+	// the debug loop only queues them. The strings queued while the file is
+	// written are written together by the next batch.
+	class CPPCOVERAGE_DLL DebugStringWriter
+	{
+	public:
+		explicit DebugStringWriter(const std::filesystem::path&);
+		// Write the pending strings.
+		~DebugStringWriter();
+
+		void Write(DWORD processId, const std::wstring&);
+		size_t GetStringCount() const;
+
+	private:
+		DebugStringWriter(const DebugStringWriter&) = delete;
+		DebugStringWriter& operator=(const DebugStringWriter&) = delete;
+
+		void WriteBatches();
+
+		std::ofstream ofs_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::vector<std::wstring> pendingStrings_;
+		bool isStopped_;
+		size_t stringCount_;
+		std::thread thread_;
+	};
+}
@@ -23,8 +23,19 @@
 #include "Process.hpp"
 #include "CppCoverageException.hpp"
 #include "IDebugEventsHandler.hpp"
+#include "ExceptionHandler.hpp"
+#include "TraceRecorder.hpp"
+#include "LiveCounters.hpp"
 
 #include "Tools/Tool.hpp"
+#include "Tools/ProcessMemory.hpp"
+
+#include <vector>
+
+// Defined by the Windows 10 SDK.
+#ifndef DBG_REPLY_LATER
+#define DBG_REPLY_LATER ((DWORD)0x40010001L)
+#endif
 
 namespace CppCoverage
 {
@@ -37,6 +48,71 @@ namespace CppCoverage
 				<< "(type:" << ripInfo.dwType << ")"
 				<< GetErrorMessage(ripInfo.dwError);
 		}
+
+		//---------------------------------------------------------------------
+		// A WOW64 process reports the breakpoints of its 32 bits code with
+		// the emulation code.
+		bool IsBreakPointException(DWORD exceptionCode)
+		{
+			return exceptionCode == EXCEPTION_BREAKPOINT ||
+			       exceptionCode == static_cast<DWORD>(ExceptionHandler::ExceptionEmulationX86ErrorCode);
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring ReadDebugString(
+			HANDLE hProcess,
+			const OUTPUT_DEBUG_STRING_INFO& debugString)
+		{
+			// nDebugStringLength includes the terminating null character.
+			size_t length = debugString.nDebugStringLength;
+			if (!length)
+				return{};
+
+			auto charSize = debugString.fUnicode ? sizeof(wchar_t) : sizeof(char);
+			auto buffer = Tools::ReadProcessMemory(
+				hProcess, debugString.lpDebugStringData, length * charSize);
+
+			// Do not rely on the debuggee for the terminating null character.
+			if (debugString.fUnicode)
+			{
+				std::wstring str(reinterpret_cast<const wchar_t*>(buffer.data()), length);
+				return str.c_str();
+			}
+			std::string str(reinterpret_cast<const char*>(buffer.data()), length);
+			return Tools::LocalToWString(str.c_str());
+		}
+
+		//---------------------------------------------------------------------
+		int WaitForExitCode(HANDLE hProcess)
+		{
+			if (WaitForSingleObject(hProcess, INFINITE) != WAIT_OBJECT_0)
+				THROW_LAST_ERROR("Error in WaitForSingleObject:", GetLastError());
+
+			DWORD exitCode = 0;
+			if (!GetExitCodeProcess(hProcess, &exitCode))
+				THROW_LAST_ERROR("Error in GetExitCodeProcess:", GetLastError());
+			return static_cast<int>(exitCode);
+		}
+
+		//---------------------------------------------------------------------
+		const char* GetDebugEventName(DWORD debugEventCode, bool isBreakPoint)
+		{
+			if (isBreakPoint)
+				return "Breakpoint";
+			switch (debugEventCode)
+			{
+				case EXCEPTION_DEBUG_EVENT: return "Exception";
+				case CREATE_THREAD_DEBUG_EVENT: return "Create thread";
+				case CREATE_PROCESS_DEBUG_EVENT: return "Create process";
+				case EXIT_THREAD_DEBUG_EVENT: return "Exit thread";
+				case EXIT_PROCESS_DEBUG_EVENT: return "Exit process";
+				case LOAD_DLL_DEBUG_EVENT: return "Load DLL";
+				case UNLOAD_DLL_DEBUG_EVENT: return "Unload DLL";
+				case OUTPUT_DEBUG_STRING_EVENT: return "Output debug string";
+				case RIP_EVENT: return "RIP";
+			}
+			return "Unknown debug event";
+		}
 	}	
 
 	//-------------------------------------------------------------------------
@@ -64,7 +140,40 @@ namespace CppCoverage
 		: coverChildren_{ coverChildren }
 		, continueAfterCppException_{ continueAfterCppException }
         , stopOnAssert_{ stopOnAssert }
+		, isReplyLaterSupported_{ true }
+		, isDllLoadStallsByModuleEnabled_{ false }
+		, debugStringMode_{ DebugStringMode::Read }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::SetTimerPeriod(std::chrono::milliseconds timerPeriod)
+	{
+		timerPeriod_ = timerPeriod;
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::SetDebugStringMode(DebugStringMode debugStringMode)
 	{
+		debugStringMode_ = debugStringMode;
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::SetTraceRecorder(std::shared_ptr<TraceRecorder> traceRecorder)
+	{
+		traceRecorder_ = std::move(traceRecorder);
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::SetLiveCounters(std::shared_ptr<LiveCounters> liveCounters)
+	{
+		liveCounters_ = std::move(liveCounters);
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::EnableDllLoadStallsByModule()
+	{
+		isDllLoadStallsByModuleEnabled_ = true;
 	}
 
 	//-------------------------------------------------------------------------
@@ -74,35 +183,211 @@ namespace CppCoverage
 	{
 		Process process(startInfo);
 		process.Start((coverChildren_) ? DEBUG_PROCESS: DEBUG_ONLY_THIS_PROCESS);
-		
+
+		return RunDebugLoop(debugEventsHandler);
+	}
+
+	//-------------------------------------------------------------------------
+	int Debugger::Attach(
+		DWORD processId,
+		IDebugEventsHandler& debugEventsHandler)
+	{
+		if (!DebugActiveProcess(processId))
+			THROW_LAST_ERROR(L"Cannot attach to the process " << processId << L": ", GetLastError());
+		// The process must keep running if the coverage is interrupted.
+		if (!DebugSetProcessKillOnExit(FALSE))
+			THROW_LAST_ERROR("Error in DebugSetProcessKillOnExit:", GetLastError());
+
+		// The system reports the process, its threads and its loaded
+		// modules with the usual creation events.
+		return RunDebugLoop(debugEventsHandler);
+	}
+
+	//-------------------------------------------------------------------------
+	int Debugger::RunDebugLoop(IDebugEventsHandler& debugEventsHandler)
+	{
 		DEBUG_EVENT debugEvent;
 		boost::optional<int> exitCode;
 
 		processHandles_.clear();
 		threadHandles_.clear();
+		lastProcessHandle_ = boost::none;
+		lastThreadHandle_ = boost::none;
 		rootProcessId_ = boost::none;
+		detachedRootProcess_ = boost::none;
+		statistics_.Start(DebugEventStatistics::Clock::now());
+		if (traceRecorder_)
+			traceRecorder_->SetThreadName("Debug loop");
+		auto timeout = timerPeriod_ ? static_cast<DWORD>(timerPeriod_->count()) : INFINITE;
 
-		while (!exitCode || !processHandles_.empty())
+		while ((!exitCode && !detachedRootProcess_) || !processHandles_.empty())
 		{
-			if (!WaitForDebugEvent(&debugEvent, INFINITE))
-				THROW_LAST_ERROR(L"Error WaitForDebugEvent:", GetLastError());
-
-			ProcessStatus processStatus = HandleDebugEvent(debugEvent, debugEventsHandler);
-			
-			// Get the exit code of the root process
-			// Set once as we do not want EXCEPTION_BREAKPOINT to be override
-			if (processStatus.exitCode_ && rootProcessId_ == debugEvent.dwProcessId && !exitCode)
-				exitCode = processStatus.exitCode_;
+			if (!WaitForDebugEvent(&debugEvent, timeout))
+			{
+				auto lastError = GetLastError();
+				if (timerPeriod_ && lastError == ERROR_SEM_TIMEOUT)
+				{
+					debugEventsHandler.OnTimer();
+					// No event is reported for a process which does not hit breakpoints anymore.
+					DetachProcessesIfNeeded(debugEventsHandler, exitCode);
+					continue;
+				}
+				THROW_LAST_ERROR(L"Error WaitForDebugEvent:", lastError);
+			}
 
-			auto continueStatus = boost::get_optional_value_or(processStatus.continueStatus_, DBG_CONTINUE);
+			HandleAndContinueDebugEvent(debugEvent, debugEventsHandler, exitCode, true);
 
-			if (!ContinueDebugEvent(debugEvent.dwProcessId, debugEvent.dwThreadId, continueStatus))
-				THROW_LAST_ERROR("Error in ContinueDebugEvent:", GetLastError());
+			// The handler checks the time itself: there is no timeout when
+			// the debug events follow each other.
+			if (timerPeriod_)
+				debugEventsHandler.OnTimer();
+		}
+		if (detachedRootProcess_)
+		{
+			Tools::ScopedAction scopedAction{ [this]{ CloseHandle(*detachedRootProcess_); } };
+			if (!exitCode)
+				exitCode = WaitForExitCode(*detachedRootProcess_);
 		}
+		statistics_.Stop(DebugEventStatistics::Clock::now());
 
 		return *exitCode;
 	}
 	
+	//-------------------------------------------------------------------------
+	void Debugger::HandleAndContinueDebugEvent(
+		const DEBUG_EVENT& debugEvent,
+		IDebugEventsHandler& debugEventsHandler,
+		boost::optional<int>& exitCode,
+		bool canDetach)
+	{
+		auto eventStart = DebugEventStatistics::Clock::now();
+		ProcessStatus processStatus = HandleDebugEvent(debugEvent, debugEventsHandler);
+		auto processId = debugEvent.dwProcessId;
+
+		// Get the exit code of the root process
+		// Set once as we do not want EXCEPTION_BREAKPOINT to be override
+		if (processStatus.exitCode_ && rootProcessId_ == processId && !exitCode)
+			exitCode = processStatus.exitCode_;
+
+		// The process is suspended until ContinueDebugEvent is called.
+		auto it = processHandles_.find(processId);
+		auto detach = canDetach && it != processHandles_.end() &&
+			debugEventsHandler.PrepareDetach(it->second);
+
+		auto continueStatus = boost::get_optional_value_or(processStatus.continueStatus_, DBG_CONTINUE);
+
+		if (!ContinueDebugEvent(processId, debugEvent.dwThreadId, continueStatus))
+		{
+			auto lastError = GetLastError();
+
+			// DBG_REPLY_LATER requires Windows 10: the thread runs as soon as it is resumed.
+			if (continueStatus != DBG_REPLY_LATER || lastError != ERROR_INVALID_PARAMETER)
+				THROW_LAST_ERROR("Error in ContinueDebugEvent:", lastError);
+			LOG_WARNING << "DBG_REPLY_LATER is not supported: the code executed before the registration "
+			               "of a module is not covered.";
+			isReplyLaterSupported_ = false;
+			debugEventsHandler.CancelPostponeLoadDll(
+			    GetProcessHandle(processId), GetThreadHandle(debugEvent.dwThreadId), debugEvent.u.LoadDll);
+			if (!ContinueDebugEvent(processId, debugEvent.dwThreadId, DBG_CONTINUE))
+				THROW_LAST_ERROR("Error in ContinueDebugEvent:", GetLastError());
+		}
+
+		auto isBreakPoint = debugEvent.dwDebugEventCode == EXCEPTION_DEBUG_EVENT
+			&& IsBreakPointException(debugEvent.u.Exception.ExceptionRecord.ExceptionCode);
+		auto eventDuration = DebugEventStatistics::Clock::now() - eventStart;
+		std::wstring modulePath;
+		if (loadedDllFile_)
+		{
+			Tools::ScopedAction closeFile{ [this]{ loadedDllFile_ = boost::none; } };
+			// The DLL is still grouped by event type when its path is unknown.
+			Tools::Try([&]() { modulePath = handleInformation_.ComputeFilename(loadedDllFile_->GetValue()); });
+		}
+		statistics_.AddEvent(debugEvent.dwDebugEventCode, isBreakPoint, eventDuration, modulePath);
+		if (liveCounters_)
+			liveCounters_->AddDebugEvent();
+		if (traceRecorder_)
+		{
+			traceRecorder_->AddSpan(GetDebugEventName(debugEvent.dwDebugEventCode, isBreakPoint),
+			                        "debug event", {}, eventStart, eventDuration);
+		}
+		if (debugEvent.dwDebugEventCode == OUTPUT_DEBUG_STRING_EVENT &&
+			debugStringMode_ != DebugStringMode::Drop)
+		{
+			statistics_.AddDebugString();
+		}
+
+		if (detach)
+			DetachProcess(processId, debugEventsHandler, exitCode);
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::DetachProcessesIfNeeded(
+		IDebugEventsHandler& debugEventsHandler,
+		boost::optional<int>& exitCode)
+	{
+		std::vector<DWORD> processIds;
+		for (const auto& pair : processHandles_)
+		{
+			if (debugEventsHandler.PrepareDetach(pair.second))
+				processIds.push_back(pair.first);
+		}
+
+		for (auto processId : processIds)
+			DetachProcess(processId, debugEventsHandler, exitCode);
+	}
+
+	//-------------------------------------------------------------------------
+	void Debugger::DetachProcess(
+		DWORD dwProcessId,
+		IDebugEventsHandler& debugEventsHandler,
+		boost::optional<int>& exitCode)
+	{
+		// A thread can wait for the report of a breakpoint hit before the
+		// breakpoints were removed. Each thread has at most one pending event
+		// and after the detach, a pending breakpoint would be raised in
+		// the process.
+		DEBUG_EVENT debugEvent;
+		auto pendingEventCount = threadHandles_.size();
+		for (size_t i = 0; i < pendingEventCount && WaitForDebugEvent(&debugEvent, 0); ++i)
+			HandleAndContinueDebugEvent(debugEvent, debugEventsHandler, exitCode, false);
+
+		auto it = processHandles_.find(dwProcessId);
+		if (it == processHandles_.end())
+			return;
+
+		auto hProcess = it->second;
+		debugEventsHandler.OnDetachProcess(hProcess);
+
+		// The handles of the process and its threads are closed by DebugActiveProcessStop.
+		if (rootProcessId_ == dwProcessId)
+		{
+			HANDLE hRootProcess = nullptr;
+			if (!DuplicateHandle(GetCurrentProcess(), hProcess, GetCurrentProcess(),
+				&hRootProcess, SYNCHRONIZE | PROCESS_QUERY_LIMITED_INFORMATION, FALSE, 0))
+			{
+				THROW_LAST_ERROR("Error in DuplicateHandle:", GetLastError());
+			}
+			detachedRootProcess_ = hRootProcess;
+		}
+
+		std::vector<DWORD> threadIds;
+		for (const auto& pair : threadHandles_)
+		{
+			if (GetProcessIdOfThread(pair.second) == dwProcessId)
+				threadIds.push_back(pair.first);
+		}
+
+		if (!DebugActiveProcessStop(dwProcessId))
+			THROW_LAST_ERROR("Error in DebugActiveProcessStop:", GetLastError());
+		LOG_DEBUG << "Detach Process:" << dwProcessId;
+
+		for (auto threadId : threadIds)
+			threadHandles_.erase(threadId);
+		processHandles_.erase(it);
+		lastProcessHandle_ = boost::none;
+		lastThreadHandle_ = boost::none;
+	}
+
 	//-------------------------------------------------------------------------
 	Debugger::ProcessStatus Debugger::HandleDebugEvent(
 		const DEBUG_EVENT& debugEvent,
@@ -146,8 +431,15 @@ namespace CppCoverage
 			case LOAD_DLL_DEBUG_EVENT:
 			{
 				const auto& loadDll = debugEvent.u.LoadDll;
-				Tools::ScopedAction scopedAction{ [&loadDll]{ CloseHandle(loadDll.hFile); } };
+				Tools::ScopedAction scopedAction{ [this, &loadDll]{
+					if (isDllLoadStallsByModuleEnabled_ && !loadedDllFile_ && loadDll.hFile)
+						loadedDllFile_.emplace(loadDll.hFile, &CloseHandle);
+					else if (loadDll.hFile)
+						CloseHandle(loadDll.hFile);
+				} };
 				debugEventsHandler.OnLoadDll(hProcess, hThread, loadDll);
+				if (isReplyLaterSupported_ && debugEventsHandler.PostponeLoadDll(hProcess, hThread, loadDll))
+					return ProcessStatus{ boost::none, DBG_REPLY_LATER };
 				break;
 			}
 			case UNLOAD_DLL_DEBUG_EVENT:
@@ -157,6 +449,25 @@ namespace CppCoverage
 			}
 			case EXCEPTION_DEBUG_EVENT: return OnException(debugEvent, debugEventsHandler, hProcess, hThread);
 			case RIP_EVENT: OnRip(debugEvent.u.RipInfo); break;
+			case OUTPUT_DEBUG_STRING_EVENT:
+			{
+				// Reading the string from the process is the expensive part.
+				if (debugStringMode_ == DebugStringMode::Read)
+				{
+					std::wstring debugString;
+					try
+					{
+						debugString = ReadDebugString(hProcess, debugEvent.u.DebugString);
+					}
+					catch (const std::exception& e)
+					{
+						LOG_WARNING << L"Cannot read the debug string: " << e.what();
+						break;
+					}
+					debugEventsHandler.OnOutputDebugString(hProcess, hThread, debugString);
+				}
+				break;
+			}
 			default: LOG_DEBUG << "Debug event:" << debugEvent.dwDebugEventCode; break;
 		}
 
@@ -256,6 +567,8 @@ namespace CppCoverage
 
 		if (processHandles_.erase(processId) != 1)
 			THROW("Cannot find exited process.");
+		if (lastProcessHandle_ && lastProcessHandle_->first == processId)
+			lastProcessHandle_ = boost::none;
 
 		return exitProcess.dwExitCode;
 	}
@@ -278,18 +591,24 @@ namespace CppCoverage
 
 		if (threadHandles_.erase(dwThreadId) != 1)
 			THROW("Cannot find exited thread.");
+		if (lastThreadHandle_ && lastThreadHandle_->first == dwThreadId)
+			lastThreadHandle_ = boost::none;
 	}
 
 	//-------------------------------------------------------------------------
-	HANDLE Debugger::GetProcessHandle(DWORD dwProcessId) const
+	HANDLE Debugger::GetProcessHandle(DWORD dwProcessId)
 	{
-		return processHandles_.at(dwProcessId);
+		if (!lastProcessHandle_ || lastProcessHandle_->first != dwProcessId)
+			lastProcessHandle_ = std::make_pair(dwProcessId, processHandles_.at(dwProcessId));
+		return lastProcessHandle_->second;
 	}
 
 	//-------------------------------------------------------------------------
-	HANDLE Debugger::GetThreadHandle(DWORD dwThreadId) const
+	HANDLE Debugger::GetThreadHandle(DWORD dwThreadId)
 	{
-		return threadHandles_.at(dwThreadId);
+		if (!lastThreadHandle_ || lastThreadHandle_->first != dwThreadId)
+			lastThreadHandle_ = std::make_pair(dwThreadId, threadHandles_.at(dwThreadId));
+		return lastThreadHandle_->second;
 	}
 
 	//-------------------------------------------------------------------------
@@ -303,4 +622,10 @@ namespace CppCoverage
 	{
 		return threadHandles_.size();
 	}
+
+	//-------------------------------------------------------------------------
+	const DebugEventStatistics& Debugger::GetStatistics() const
+	{
+		return statistics_;
+	}
 }
\ No newline at end of file
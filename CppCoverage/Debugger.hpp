@@ -18,15 +18,24 @@
 
 #include <boost/optional/optional.hpp>
 
+#include <chrono>
+#include <memory>
 #include <unordered_map>
+#include <utility>
 #include <Windows.h>
 #include "CppCoverageExport.hpp"
+#include "DebugEventStatistics.hpp"
+#include "DebugStringMode.hpp"
+#include "Handle.hpp"
+#include "HandleInformation.hpp"
 
 
 namespace CppCoverage
 {
 	class StartInfo;
 	class IDebugEventsHandler;
+	class TraceRecorder;
+	class LiveCounters;
 
 	class CPPCOVERAGE_DLL Debugger
 	{
@@ -36,9 +45,21 @@ namespace CppCoverage
 			bool continueAfterCppException,
             bool stopOnAssert);
 
+		void SetTimerPeriod(std::chrono::milliseconds);
+		void SetDebugStringMode(DebugStringMode);
+		// Record a span for each debug event.
+		void SetTraceRecorder(std::shared_ptr<TraceRecorder>);
+		// Count the debug events in liveCounters.
+		void SetLiveCounters(std::shared_ptr<LiveCounters>);
+		// Group the stalls of the DLL loads by module in the statistics. The
+		// path of a DLL is resolved after ContinueDebugEvent.
+		void EnableDllLoadStallsByModule();
 		int Debug(const StartInfo&, IDebugEventsHandler&);
+		// Debug a running process. It is not killed when the debugger exits.
+		int Attach(DWORD processId, IDebugEventsHandler&);
 		size_t GetRunningProcesses() const;
 		size_t GetRunningThreads() const;
+		const DebugEventStatistics& GetStatistics() const;
 
 	private:
 		Debugger(const Debugger&) = delete;
@@ -60,12 +81,22 @@ namespace CppCoverage
 
 		void OnExitThread(DWORD dwProcessId);
 
-		HANDLE GetProcessHandle(DWORD dwProcessId) const;
-		HANDLE GetThreadHandle(DWORD dwThreadId) const;
+		HANDLE GetProcessHandle(DWORD dwProcessId);
+		HANDLE GetThreadHandle(DWORD dwThreadId);
 
 		struct ProcessStatus;
 
+		int RunDebugLoop(IDebugEventsHandler&);
 		ProcessStatus HandleDebugEvent(const DEBUG_EVENT&, IDebugEventsHandler&);
+		void HandleAndContinueDebugEvent(const DEBUG_EVENT&,
+		                                 IDebugEventsHandler&,
+		                                 boost::optional<int>& exitCode,
+		                                 bool canDetach);
+		void DetachProcessesIfNeeded(IDebugEventsHandler&,
+		                             boost::optional<int>& exitCode);
+		void DetachProcess(DWORD dwProcessId,
+		                   IDebugEventsHandler&,
+		                   boost::optional<int>& exitCode);
 
 		ProcessStatus HandleNotCreationalEvent(
 			const DEBUG_EVENT& debugEvent,
@@ -79,10 +110,26 @@ namespace CppCoverage
 	private:
 		std::unordered_map<DWORD, HANDLE> processHandles_;
 		std::unordered_map<DWORD, HANDLE> threadHandles_;
+		// Consecutive events usually come from the same process and thread.
+		boost::optional<std::pair<DWORD, HANDLE>> lastProcessHandle_;
+		boost::optional<std::pair<DWORD, HANDLE>> lastThreadHandle_;
+		DebugEventStatistics statistics_;
 		boost::optional<DWORD> rootProcessId_;
+		boost::optional<HANDLE> detachedRootProcess_;
+		DebugStringMode debugStringMode_;
+		boost::optional<std::chrono::milliseconds> timerPeriod_;
+		std::shared_ptr<TraceRecorder> traceRecorder_;
+		std::shared_ptr<LiveCounters> liveCounters_;
 		bool coverChildren_;
 		bool continueAfterCppException_;
         bool stopOnAssert_;
+		// False once ContinueDebugEvent rejects DBG_REPLY_LATER.
+		bool isReplyLaterSupported_;
+		bool isDllLoadStallsByModuleEnabled_;
+		// The file of the DLL loaded by the current event, closed once its
+		// path is resolved.
+		boost::optional<Handle<HANDLE, decltype(&CloseHandle)>> loadedDllFile_;
+		HandleInformation handleInformation_;
     };
 }
 
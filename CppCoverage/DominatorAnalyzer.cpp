@@ -0,0 +1,204 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DominatorAnalyzer.hpp"
+
+#include <limits>
+
+#include "BasicBlockAnalyzer.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const size_t NoNode = (std::numeric_limits<size_t>::max)();
+
+		using Graph = std::vector<std::vector<size_t>>;
+
+		//---------------------------------------------------------------------
+		std::vector<size_t> ComputePostorder(const Graph& successors, size_t entry)
+		{
+			std::vector<size_t> postorder;
+			std::vector<bool> isVisited(successors.size(), false);
+			std::vector<std::pair<size_t, size_t>> stack{{entry, 0}};
+
+			isVisited[entry] = true;
+			while (!stack.empty())
+			{
+				auto& top = stack.back();
+				const auto& nodeSuccessors = successors[top.first];
+				if (top.second < nodeSuccessors.size())
+				{
+					auto successor = nodeSuccessors[top.second++];
+					if (!isVisited[successor])
+					{
+						isVisited[successor] = true;
+						stack.emplace_back(successor, 0);
+					}
+				}
+				else
+				{
+					postorder.push_back(top.first);
+					stack.pop_back();
+				}
+			}
+			return postorder;
+		}
+
+		//---------------------------------------------------------------------
+		// "A Simple, Fast Dominance Algorithm" of Cooper, Harvey and Kennedy.
+		// The unreachable nodes have no immediate dominator.
+		std::vector<size_t> ComputeImmediateDominators(const Graph& successors, size_t entry)
+		{
+			auto postorder = ComputePostorder(successors, entry);
+			std::vector<size_t> postorderIndexes(successors.size(), NoNode);
+			Graph predecessors(successors.size());
+
+			for (size_t i = 0; i < postorder.size(); ++i)
+				postorderIndexes[postorder[i]] = i;
+			for (size_t node = 0; node < successors.size(); ++node)
+			{
+				for (auto successor : successors[node])
+					predecessors[successor].push_back(node);
+			}
+
+			std::vector<size_t> dominators(successors.size(), NoNode);
+			auto intersect = [&](size_t first, size_t second) {
+				while (first != second)
+				{
+					while (postorderIndexes[first] < postorderIndexes[second])
+						first = dominators[first];
+					while (postorderIndexes[second] < postorderIndexes[first])
+						second = dominators[second];
+				}
+				return first;
+			};
+
+			dominators[entry] = entry;
+			for (auto isChanged = true; isChanged;)
+			{
+				isChanged = false;
+				for (auto it = postorder.rbegin(); it != postorder.rend(); ++it)
+				{
+					if (*it == entry)
+						continue;
+
+					auto dominator = NoNode;
+					for (auto predecessor : predecessors[*it])
+					{
+						if (dominators[predecessor] == NoNode)
+							continue;
+						dominator = dominator == NoNode ? predecessor : intersect(predecessor, dominator);
+					}
+					if (dominators[*it] != dominator)
+					{
+						dominators[*it] = dominator;
+						isChanged = true;
+					}
+				}
+			}
+			return dominators;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	DominatorAnalyzer::DominatorAnalyzer(const BasicBlockAnalyzer& basicBlockAnalyzer)
+	{
+		const auto& basicBlocks = basicBlockAnalyzer.GetBasicBlocks();
+		auto exit = basicBlocks.size();
+		Graph successors(basicBlocks.size());
+		Graph reversedSuccessors(basicBlocks.size() + 1);
+
+		for (size_t i = 0; i < basicBlocks.size(); ++i)
+		{
+			for (auto successor : basicBlocks[i].successors_)
+			{
+				successors[i].push_back(successor);
+				reversedSuccessors[successor].push_back(i);
+			}
+			if (basicBlocks[i].isExit_)
+				reversedSuccessors[exit].push_back(i);
+		}
+
+		if (!basicBlocks.empty())
+			dominators_ = ComputeImmediateDominators(successors, 0);
+		postDominators_ = ComputeImmediateDominators(reversedSuccessors, exit);
+		ComputeDominatorTreeOrder();
+	}
+
+	//-------------------------------------------------------------------------
+	void DominatorAnalyzer::ComputeDominatorTreeOrder()
+	{
+		Graph children(dominators_.size());
+
+		for (size_t node = 1; node < dominators_.size(); ++node)
+		{
+			if (dominators_[node] != NoNode)
+				children[dominators_[node]].push_back(node);
+		}
+
+		preorders_.assign(dominators_.size(), NoNode);
+		postorders_.assign(dominators_.size(), NoNode);
+		if (dominators_.empty())
+			return;
+
+		size_t preorder = 0;
+		size_t postorder = 0;
+		std::vector<std::pair<size_t, size_t>> stack{{0, 0}};
+		preorders_[0] = preorder++;
+		while (!stack.empty())
+		{
+			auto& top = stack.back();
+			if (top.second < children[top.first].size())
+			{
+				auto child = children[top.first][top.second++];
+				preorders_[child] = preorder++;
+				stack.emplace_back(child, 0);
+			}
+			else
+			{
+				postorders_[top.first] = postorder++;
+				stack.pop_back();
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool DominatorAnalyzer::Dominates(size_t first, size_t second) const
+	{
+		if (first >= preorders_.size() || second >= preorders_.size() ||
+		    preorders_[first] == NoNode || preorders_[second] == NoNode)
+			return first == second;
+		return preorders_[first] <= preorders_[second] &&
+		       postorders_[second] <= postorders_[first];
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<size_t> DominatorAnalyzer::GetPostDominators(size_t basicBlock) const
+	{
+		std::vector<size_t> postDominators;
+		auto exit = postDominators_.size() - 1;
+
+		// A block in an infinite loop has no post-dominator.
+		if (basicBlock >= exit)
+			return postDominators;
+		for (auto node = postDominators_[basicBlock]; node != NoNode && node != exit;
+		     node = postDominators_[node])
+			postDominators.push_back(node);
+		return postDominators;
+	}
+}
@@ -0,0 +1,60 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class BasicBlockAnalyzer;
+
+	// Dominators and post-dominators of the basic blocks of a function. A
+	// block dominates another one if every path from the function entry to
+	// the second block goes through the first one. A block post-dominates
+	// another one if every path from the second block to the function exit
+	// goes through the first one. A call can throw so it can leave the
+	// function.
+	class CPPCOVERAGE_DLL DominatorAnalyzer
+	{
+	  public:
+		explicit DominatorAnalyzer(const BasicBlockAnalyzer&);
+
+		// Return true if first dominates second. A block dominates itself.
+		bool Dominates(size_t first, size_t second) const;
+
+		// The blocks which post-dominate the block, the closest first. The
+		// block itself is not included.
+		std::vector<size_t> GetPostDominators(size_t basicBlock) const;
+
+	  private:
+		DominatorAnalyzer(const DominatorAnalyzer&) = delete;
+		DominatorAnalyzer& operator=(const DominatorAnalyzer&) = delete;
+
+		void ComputeDominatorTreeOrder();
+
+		// Immediate dominators and post-dominators. The virtual exit node
+		// follows the blocks in postDominators_.
+		std::vector<size_t> dominators_;
+		std::vector<size_t> postDominators_;
+		// Preorder and postorder positions in the dominator tree.
+		std::vector<size_t> preorders_;
+		std::vector<size_t> postorders_;
+	};
+}
@@ -0,0 +1,154 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "EtwProvider.hpp"
+
+#include <TraceLoggingProvider.h>
+#include <winmeta.h>
+
+#include "Tools/Log.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		using Microseconds = std::chrono::duration<ULONGLONG, std::micro>;
+	}
+
+	// The GUID is the hash of the name used by EventSource and TraceLogging:
+	// "*OpenCppCoverage" also selects the provider.
+	TRACELOGGING_DEFINE_PROVIDER(
+	    etwProviderHandle,
+	    "OpenCppCoverage",
+	    (0x22ad02dc, 0xd632, 0x59e5, 0xb6, 0x92, 0x48, 0x41, 0x63, 0x77, 0x40, 0x2a));
+
+	//-------------------------------------------------------------------------
+	EtwProvider::EtwProvider()
+	{
+		auto status = TraceLoggingRegister(etwProviderHandle);
+
+		// The events are ignored if the provider is not registered.
+		isRegistered_ = SUCCEEDED(status);
+		if (!isRegistered_)
+			LOG_WARNING << L"Cannot register the ETW provider: " << status;
+	}
+
+	//-------------------------------------------------------------------------
+	EtwProvider::~EtwProvider()
+	{
+		if (isRegistered_)
+			TraceLoggingUnregister(etwProviderHandle);
+	}
+
+	//-------------------------------------------------------------------------
+	bool EtwProvider::IsRegistered() const
+	{
+		return isRegistered_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool EtwProvider::IsEnabled(ULONGLONG keyword)
+	{
+		return TraceLoggingProviderEnabled(etwProviderHandle, 0, keyword);
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnModuleLoadStart(const std::wstring& modulePath)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "ModuleLoad",
+		                  TraceLoggingKeyword(ModuleKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_START),
+		                  TraceLoggingWideString(modulePath.c_str(), "Path"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnModuleLoadStop(const std::wstring& modulePath, bool isSelected)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "ModuleLoad",
+		                  TraceLoggingKeyword(ModuleKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+		                  TraceLoggingWideString(modulePath.c_str(), "Path"),
+		                  TraceLoggingBool(isSelected, "IsSelected"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnBreakPointsWritten(HANDLE hProcess,
+	                                       size_t count,
+	                                       std::chrono::steady_clock::duration duration)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "BreakPointsWritten",
+		                  TraceLoggingKeyword(BreakPointKeyword),
+		                  TraceLoggingUInt32(GetProcessId(hProcess), "ProcessId"),
+		                  TraceLoggingUInt64(count, "Count"),
+		                  TraceLoggingUInt64(
+		                      std::chrono::duration_cast<Microseconds>(duration).count(), "DurationUs"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnBreakPointHit(HANDLE hProcess, void* address)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "BreakPointHit",
+		                  TraceLoggingKeyword(HitKeyword),
+		                  TraceLoggingLevel(WINEVENT_LEVEL_VERBOSE),
+		                  TraceLoggingUInt32(GetProcessId(hProcess), "ProcessId"),
+		                  TraceLoggingPointer(address, "Address"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnSymbolLoadStart(const std::filesystem::path& modulePath)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "SymbolLoad",
+		                  TraceLoggingKeyword(SymbolKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_START),
+		                  TraceLoggingWideString(modulePath.c_str(), "Path"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnSymbolLoadStop(const std::filesystem::path& modulePath)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "SymbolLoad",
+		                  TraceLoggingKeyword(SymbolKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+		                  TraceLoggingWideString(modulePath.c_str(), "Path"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnExportStart(const std::wstring& exportName)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "Export",
+		                  TraceLoggingKeyword(ExportKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_START),
+		                  TraceLoggingWideString(exportName.c_str(), "Name"));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwProvider::OnExportStop(const std::wstring& exportName)
+	{
+		TraceLoggingWrite(etwProviderHandle,
+		                  "Export",
+		                  TraceLoggingKeyword(ExportKeyword),
+		                  TraceLoggingOpcode(WINEVENT_OPCODE_STOP),
+		                  TraceLoggingWideString(exportName.c_str(), "Name"));
+	}
+}
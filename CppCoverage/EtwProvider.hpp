@@ -0,0 +1,68 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// TraceLogging provider to correlate the work of OpenCppCoverage with the
+	// activity of the program in WPR and WPA. Its name is OpenCppCoverage and
+	// its GUID {22ad02dc-d632-59e5-b692-48416377402a}. When no session enables
+	// the provider, an event only tests a flag and does not read its fields.
+	class CPPCOVERAGE_DLL EtwProvider
+	{
+	public:
+		// Keywords to select the events.
+		static const ULONGLONG ModuleKeyword = 0x1;
+		static const ULONGLONG BreakPointKeyword = 0x2;
+		static const ULONGLONG HitKeyword = 0x4;
+		static const ULONGLONG SymbolKeyword = 0x8;
+		static const ULONGLONG ExportKeyword = 0x10;
+
+		// Register the provider until the destruction.
+		EtwProvider();
+		~EtwProvider();
+
+		bool IsRegistered() const;
+		// True when a session enables one of the keywords of the registered provider.
+		static bool IsEnabled(ULONGLONG keyword);
+
+		static void OnModuleLoadStart(const std::wstring& modulePath);
+		static void OnModuleLoadStop(const std::wstring& modulePath, bool isSelected);
+		static void OnBreakPointsWritten(HANDLE hProcess,
+		                                 size_t count,
+		                                 std::chrono::steady_clock::duration);
+		static void OnBreakPointHit(HANDLE hProcess, void* address);
+		static void OnSymbolLoadStart(const std::filesystem::path& modulePath);
+		static void OnSymbolLoadStop(const std::filesystem::path& modulePath);
+		static void OnExportStart(const std::wstring& exportName);
+		static void OnExportStop(const std::wstring& exportName);
+
+	private:
+		EtwProvider(const EtwProvider&) = delete;
+		EtwProvider& operator=(const EtwProvider&) = delete;
+
+		bool isRegistered_;
+	};
+}
@@ -0,0 +1,294 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "EtwSampler.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+#include <evntrace.h>
+#include <evntcons.h>
+
+#include "Tools/Log.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		// SystemTraceControlGuid
+		const GUID KernelLoggerGuid = {
+		    0x9e814aad, 0x3204, 0x11d2, {0x9a, 0x82, 0x00, 0x60, 0x08, 0xa8, 0x69, 0x39}};
+		const GUID PerfInfoGuid = {
+		    0xce1dbfb4, 0x137e, 0x4da6, {0x87, 0xb0, 0x3f, 0x59, 0xaa, 0x10, 0x2c, 0xbc}};
+		const GUID ThreadGuid = {
+		    0x3d6fa8d1, 0xfe05, 0x11d0, {0x9d, 0xda, 0x00, 0xc0, 0x4f, 0xd7, 0xba, 0x7c}};
+
+		const UCHAR SampledProfileOpcode = 46;
+		const UCHAR ThreadStartOpcode = 1;
+		const UCHAR ThreadDataCollectionStartOpcode = 3;
+
+		//---------------------------------------------------------------------
+		struct SessionProperties
+		{
+			EVENT_TRACE_PROPERTIES properties_;
+			wchar_t loggerName_[sizeof(KERNEL_LOGGER_NAMEW) / sizeof(wchar_t)];
+		};
+
+		//---------------------------------------------------------------------
+		SessionProperties CreateSessionProperties()
+		{
+			SessionProperties sessionProperties{};
+			auto& properties = sessionProperties.properties_;
+
+			properties.Wnode.BufferSize = sizeof(SessionProperties);
+			properties.Wnode.Guid = KernelLoggerGuid;
+			// Timestamps are QueryPerformanceCounter values.
+			properties.Wnode.ClientContext = 1;
+			properties.Wnode.Flags = WNODE_FLAG_TRACED_GUID;
+			properties.EnableFlags = EVENT_TRACE_FLAG_PROFILE | EVENT_TRACE_FLAG_THREAD;
+			properties.LogFileMode = EVENT_TRACE_REAL_TIME_MODE;
+			properties.FlushTimer = 1;
+			properties.LoggerNameOffset = offsetof(SessionProperties, loggerName_);
+
+			return sessionProperties;
+		}
+
+		//---------------------------------------------------------------------
+		void EnableProfilePrivilege()
+		{
+			HANDLE hToken = nullptr;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES, &hToken))
+				return;
+
+			TOKEN_PRIVILEGES privileges{};
+			privileges.PrivilegeCount = 1;
+			privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+			if (LookupPrivilegeValueW(nullptr, SE_SYSTEM_PROFILE_NAME, &privileges.Privileges[0].Luid))
+				AdjustTokenPrivileges(hToken, FALSE, &privileges, 0, nullptr, nullptr);
+			CloseHandle(hToken);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		bool Read(const EVENT_RECORD& record, size_t offset, size_t size, T& value)
+		{
+			if (offset + size > record.UserDataLength || size > sizeof(T))
+				return false;
+			value = 0;
+			std::memcpy(&value, static_cast<const unsigned char*>(record.UserData) + offset, size);
+			return true;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	EtwSampler::EtwSampler()
+	    : sessionHandle_{0},
+	      traceHandle_{INVALID_PROCESSTRACE_HANDLE},
+	      lastTimestamp_{0},
+	      sampleCount_{0},
+	      lostEventCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	EtwSampler::~EtwSampler()
+	{
+		Stop();
+	}
+
+	//-------------------------------------------------------------------------
+	bool EtwSampler::Start()
+	{
+		EnableProfilePrivilege();
+
+		auto sessionProperties = CreateSessionProperties();
+		TRACEHANDLE sessionHandle = 0;
+		auto status = StartTraceW(&sessionHandle, KERNEL_LOGGER_NAMEW, &sessionProperties.properties_);
+		if (status != ERROR_SUCCESS)
+		{
+			if (status == ERROR_ALREADY_EXISTS)
+				LOG_WARNING << L"Cannot start ETW sampling: " << KERNEL_LOGGER_NAMEW
+				            << L" is already used by another tool.";
+			else if (status == ERROR_ACCESS_DENIED)
+				LOG_WARNING << L"Cannot start ETW sampling: administrator rights are required.";
+			else
+				LOG_WARNING << L"Cannot start ETW sampling: " << status;
+			return false;
+		}
+		sessionHandle_ = sessionHandle;
+
+		EVENT_TRACE_LOGFILEW logFile{};
+		logFile.LoggerName = const_cast<wchar_t*>(KERNEL_LOGGER_NAMEW);
+		logFile.ProcessTraceMode = PROCESS_TRACE_MODE_REAL_TIME |
+		                           PROCESS_TRACE_MODE_EVENT_RECORD |
+		                           PROCESS_TRACE_MODE_RAW_TIMESTAMP;
+		logFile.EventRecordCallback = OnEventRecord;
+		logFile.Context = this;
+
+		traceHandle_ = OpenTraceW(&logFile);
+		if (traceHandle_ == INVALID_PROCESSTRACE_HANDLE)
+		{
+			LOG_WARNING << L"Cannot open ETW session: " << GetLastError();
+			Stop();
+			return false;
+		}
+
+		consumerThread_ = std::thread{[this]() {
+			TRACEHANDLE traceHandle = traceHandle_;
+			// Return when the session is stopped.
+			ProcessTrace(&traceHandle, 1, nullptr, nullptr);
+		}};
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::Stop()
+	{
+		if (sessionHandle_)
+		{
+			auto sessionProperties = CreateSessionProperties();
+			ControlTraceW(sessionHandle_, nullptr, &sessionProperties.properties_, EVENT_TRACE_CONTROL_STOP);
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				lostEventCount_ += sessionProperties.properties_.EventsLost;
+			}
+			sessionHandle_ = 0;
+		}
+		if (consumerThread_.joinable())
+			consumerThread_.join();
+		if (traceHandle_ != INVALID_PROCESSTRACE_HANDLE)
+		{
+			CloseTrace(traceHandle_);
+			traceHandle_ = INVALID_PROCESSTRACE_HANDLE;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::AddProcess(HANDLE hProcess)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		processes_[GetProcessId(hProcess)] = hProcess;
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::RemoveProcess(HANDLE hProcess)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		processes_.erase(GetProcessId(hProcess));
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::Flush(std::chrono::milliseconds timeout)
+	{
+		if (!sessionHandle_)
+			return;
+
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+
+		auto sessionProperties = CreateSessionProperties();
+		ControlTraceW(sessionHandle_, nullptr, &sessionProperties.properties_, EVENT_TRACE_CONTROL_FLUSH);
+
+		std::unique_lock<std::mutex> lock{mutex_};
+		eventReceived_.wait_for(lock, timeout, [&]() { return lastTimestamp_ >= now.QuadPart; });
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<EtwSampler::Sample> EtwSampler::TakeSamples()
+	{
+		std::vector<Sample> samples;
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		samples.reserve(samples_.size());
+		for (const auto& sample : samples_)
+			samples.push_back({sample.first.first, sample.first.second, sample.second});
+		samples_.clear();
+
+		return samples;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t EtwSampler::GetSampleCount() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return sampleCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t EtwSampler::GetLostEventCount() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return lostEventCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void WINAPI EtwSampler::OnEventRecord(_EVENT_RECORD* record)
+	{
+		static_cast<EtwSampler*>(record->UserContext)->OnEvent(*record);
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::OnEvent(const _EVENT_RECORD& record)
+	{
+		const auto& header = record.EventHeader;
+		const auto opcode = header.EventDescriptor.Opcode;
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		if (IsEqualGUID(header.ProviderId, PerfInfoGuid) && opcode == SampledProfileOpcode)
+			OnSampledProfile(record);
+		else if (IsEqualGUID(header.ProviderId, ThreadGuid) &&
+		         (opcode == ThreadStartOpcode || opcode == ThreadDataCollectionStartOpcode))
+		{
+			DWORD processId = 0;
+			DWORD threadId = 0;
+			// Thread ids are not reused while the thread is alive, so the
+			// mapping is overwritten when the id is given to a new thread.
+			if (Read(record, 0, sizeof(DWORD), processId) &&
+			    Read(record, sizeof(DWORD), sizeof(DWORD), threadId))
+				processIdByThreadId_[threadId] = processId;
+		}
+
+		if (header.TimeStamp.QuadPart > lastTimestamp_)
+			lastTimestamp_ = header.TimeStamp.QuadPart;
+		eventReceived_.notify_all();
+	}
+
+	//-------------------------------------------------------------------------
+	void EtwSampler::OnSampledProfile(const _EVENT_RECORD& record)
+	{
+		const size_t pointerSize =
+		    (record.EventHeader.Flags & EVENT_HEADER_FLAG_32_BIT_HEADER) ? 4 : 8;
+		DWORD64 instructionPointer = 0;
+		DWORD threadId = 0;
+		USHORT count = 1;
+
+		if (!Read(record, 0, pointerSize, instructionPointer) ||
+		    !Read(record, pointerSize, sizeof(DWORD), threadId))
+			return;
+		Read(record, pointerSize + sizeof(DWORD), sizeof(USHORT), count);
+
+		auto thread = processIdByThreadId_.find(threadId);
+		if (thread == processIdByThreadId_.end())
+			return;
+		auto process = processes_.find(thread->second);
+		if (process == processes_.end())
+			return;
+
+		samples_[{process->second, instructionPointer}] += count;
+		sampleCount_ += count;
+	}
+}
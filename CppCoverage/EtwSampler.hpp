@@ -0,0 +1,92 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+
+struct _EVENT_RECORD;
+
+namespace CppCoverage
+{
+	// Sample the instruction pointers of the processes with the CPU sampling
+	// of the ETW kernel logger. The code runs without any breakpoint: the
+	// overhead is the fixed cost of the sampling. Require the administrator
+	// rights.
+	class CPPCOVERAGE_DLL EtwSampler
+	{
+	  public:
+		struct Sample
+		{
+			HANDLE hProcess_;
+			DWORD64 instructionPointer_;
+			uint64_t count_;
+		};
+
+		EtwSampler();
+		~EtwSampler();
+
+		// Return false if the kernel logger cannot be started.
+		bool Start();
+
+		void AddProcess(HANDLE hProcess);
+		// Call Flush and TakeSamples before.
+		void RemoveProcess(HANDLE hProcess);
+
+		// Wait until the samples taken before the call are received, at most
+		// timeout.
+		void Flush(std::chrono::milliseconds timeout);
+		// Samples received since the previous call.
+		std::vector<Sample> TakeSamples();
+
+		// Samples of the processes, lost events excluded.
+		uint64_t GetSampleCount() const;
+		uint64_t GetLostEventCount() const;
+
+	  private:
+		EtwSampler(const EtwSampler&) = delete;
+		EtwSampler& operator=(const EtwSampler&) = delete;
+
+		static void WINAPI OnEventRecord(_EVENT_RECORD*);
+		void OnEvent(const _EVENT_RECORD&);
+		void OnSampledProfile(const _EVENT_RECORD&);
+		void Stop();
+
+		ULONG64 sessionHandle_;
+		ULONG64 traceHandle_;
+		std::thread consumerThread_;
+
+		mutable std::mutex mutex_;
+		std::condition_variable eventReceived_;
+		std::unordered_map<DWORD, DWORD> processIdByThreadId_;
+		std::unordered_map<DWORD, HANDLE> processes_;
+		std::map<std::pair<HANDLE, DWORD64>, uint64_t> samples_;
+		LONGLONG lastTimestamp_;
+		uint64_t sampleCount_;
+		uint64_t lostEventCount_;
+	};
+}
@@ -35,8 +35,8 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	ExceptionHandler::ExceptionHandler()
 	{
-		breakPointExceptionCode_.emplace(EXCEPTION_BREAKPOINT, std::vector<HANDLE>{});
-		breakPointExceptionCode_.emplace(ExceptionEmulationX86ErrorCode, std::vector<HANDLE>{});
+		breakPointExceptionCode_.emplace(EXCEPTION_BREAKPOINT, std::unordered_set<HANDLE>{});
+		breakPointExceptionCode_.emplace(ExceptionEmulationX86ErrorCode, std::unordered_set<HANDLE>{});
 		InitExceptionCode();
 	}
 
@@ -77,21 +77,7 @@ namespace CppCoverage
 		const auto exceptionCode = exceptionRecord.ExceptionCode;
 
 		if (exceptionDebugInfo.dwFirstChance)
-		{
-			auto it = breakPointExceptionCode_.find(exceptionCode);
-			
-			if (it != breakPointExceptionCode_.end())
-			{
-				auto& processHandles = it->second;
-				// Breakpoint exception need to be ignore the first time by process.
-				if (std::find(processHandles.begin(), processHandles.end(), hProcess) == processHandles.end())
-					processHandles.push_back(hProcess);
-				else
-					return ExceptionHandlerStatus::BreakPoint;
-			}
-
-			return ExceptionHandlerStatus::FirstChanceException;
-		}
+			return HandleFirstChanceException(hProcess, exceptionDebugInfo);
 				
 		message << std::endl << std::endl;
 		message << Tools::GetSeparatorLine() << std::endl;
@@ -108,16 +94,27 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	void ExceptionHandler::OnExitProcess(HANDLE hProcess)
+	ExceptionHandlerStatus ExceptionHandler::HandleFirstChanceException(
+		HANDLE hProcess,
+		const EXCEPTION_DEBUG_INFO& exceptionDebugInfo)
 	{
-		for (auto& pair : breakPointExceptionCode_)
-		{
-			std::vector<HANDLE>& processes = pair.second;
-			auto it = std::find(processes.begin(), processes.end(), hProcess);
+		auto it = breakPointExceptionCode_.find(exceptionDebugInfo.ExceptionRecord.ExceptionCode);
 
-			if (it != processes.end())
-				processes.erase(it);
+		if (it != breakPointExceptionCode_.end())
+		{
+			// Breakpoint exception need to be ignore the first time by process.
+			if (!it->second.insert(hProcess).second)
+				return ExceptionHandlerStatus::BreakPoint;
 		}
+
+		return ExceptionHandlerStatus::FirstChanceException;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExceptionHandler::OnExitProcess(HANDLE hProcess)
+	{
+		for (auto& pair : breakPointExceptionCode_)
+			pair.second.erase(hProcess);
 	}
 
 	//-------------------------------------------------------------------------
@@ -19,6 +19,7 @@
 #include <Windows.h>
 #include <iosfwd>
 #include <unordered_map>
+#include <unordered_set>
 #include <map>
 
 #include "CppCoverageExport.hpp"
@@ -46,6 +47,9 @@ namespace CppCoverage
 		ExceptionHandler();
 
 		ExceptionHandlerStatus HandleException(HANDLE hProcess, const EXCEPTION_DEBUG_INFO&, std::wostream&);
+
+		// Fast path for first chance exceptions: the message is never needed.
+		ExceptionHandlerStatus HandleFirstChanceException(HANDLE hProcess, const EXCEPTION_DEBUG_INFO&);
 		void OnExitProcess(HANDLE hProcess);
 
 	private:
@@ -56,7 +60,7 @@ namespace CppCoverage
 		std::wstring GetExceptionStrFromCode(DWORD) const;
 
 		std::unordered_map<DWORD, std::wstring> exceptionCode_;
-		std::map<DWORD, std::vector<HANDLE>> breakPointExceptionCode_;
+		std::map<DWORD, std::unordered_set<HANDLE>> breakPointExceptionCode_;
 	};
 }
 
@@ -17,37 +17,319 @@
 #include "stdafx.h"
 #include "ExecutedAddressManager.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <limits>
+#include <string_view>
 #include <unordered_map>
-#include <boost/container/small_vector.hpp>
+#include <unordered_set>
 
 #include "tools/Log.hpp"
+#include "Tools/MemoryUsage.hpp"
+#include "Tools/ScopedAction.hpp"
 
 #include "CppCoverageException.hpp"
 #include "Plugin/Exporter/ModuleCoverage.hpp"
 #include "Plugin/Exporter/FileCoverage.hpp"
 #include "Address.hpp"
+#include "CoverageSummary.hpp"
+#include "ICoverageSource.hpp"
 
 namespace CppCoverage
 {
-	//-------------------------------------------------------------------------
-	struct ExecutedAddressManager::Line
+	namespace
 	{
-		explicit Line(unsigned char instructionToRestore, void* dllBaseOfImage)
-			: instructionToRestore_{ instructionToRestore }
-			, dllBaseOfImage_{ dllBaseOfImage }
+		const uint32_t InvalidRva = (std::numeric_limits<uint32_t>::max)();
+
+		//---------------------------------------------------------------------
+		uint32_t GetRva(const void* baseOfImage, const void* address)
+		{
+			auto base = reinterpret_cast<uintptr_t>(baseOfImage);
+			auto value = reinterpret_cast<uintptr_t>(address);
+
+			if (value < base || value - base >= InvalidRva)
+				return InvalidRva;
+			return static_cast<uint32_t>(value - base);
+		}
+
+		//---------------------------------------------------------------------
+		enum class AddressState : unsigned char
+		{
+			Armed,
+			Executed,
+			// Executed and its breakpoint is never set again.
+			Released
+		};
+
+		//---------------------------------------------------------------------
+		struct AddressEntry
+		{
+			uint32_t rva_ = InvalidRva;
+			uint32_t lineStateIndex_ = 0;
+			unsigned char instructionToRestore_ = 0;
+			AddressState state_ = AddressState::Armed;
+			bool hasOtherLineStates_ = false;
+		};
+
+		//---------------------------------------------------------------------
+		// Open addressing table with linear probing keyed by RVA. Entries
+		// are never removed: the table is dropped with its module.
+		class AddressTable
+		{
+		public:
+			//-----------------------------------------------------------------
+			void Reserve(size_t count)
+			{
+				if (count * 2 > entries_.size())
+					Rehash(count * 2);
+			}
+
+			//-----------------------------------------------------------------
+			AddressEntry* Find(uint32_t rva)
+			{
+				const auto& constThis = *this;
+
+				return const_cast<AddressEntry*>(constThis.Find(rva));
+			}
+
+			//-----------------------------------------------------------------
+			const AddressEntry* Find(uint32_t rva) const
+			{
+				if (entries_.empty() || rva == InvalidRva)
+					return nullptr;
+
+				for (auto slot = GetSlot(rva);; slot = (slot + 1) & (entries_.size() - 1))
+				{
+					const auto& entry = entries_[slot];
+					if (entry.rva_ == rva)
+						return &entry;
+					if (entry.rva_ == InvalidRva)
+						return nullptr;
+				}
+			}
+
+			//-----------------------------------------------------------------
+			// Return the entry of rva and true if it was inserted.
+			std::pair<AddressEntry*, bool> Insert(uint32_t rva)
+			{
+				if ((size_ + 1) * 2 > entries_.size())
+					Rehash((size_ + 1) * 2);
+
+				for (auto slot = GetSlot(rva);; slot = (slot + 1) & (entries_.size() - 1))
+				{
+					auto& entry = entries_[slot];
+					if (entry.rva_ == rva)
+						return{ &entry, false };
+					if (entry.rva_ == InvalidRva)
+					{
+						entry.rva_ = rva;
+						++size_;
+						return{ &entry, true };
+					}
+				}
+			}
+
+			//-----------------------------------------------------------------
+			template <typename Function>
+			void ForEach(Function function) const
+			{
+				for (const auto& entry : entries_)
+				{
+					if (entry.rva_ != InvalidRva)
+						function(entry);
+				}
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t GetAllocatedSize() const
+			{
+				return Tools::GetAllocatedSize(entries_);
+			}
+
+		private:
+			//-----------------------------------------------------------------
+			size_t GetSlot(uint32_t rva) const
+			{
+				// Fibonacci hashing: the RVAs of a module are close together.
+				return static_cast<uint32_t>(rva * 2654435769u) >> shift_;
+			}
+
+			//-----------------------------------------------------------------
+			void Rehash(size_t minCapacity)
+			{
+				size_t capacity = 16;
+				int shift = 28;
+
+				for (; capacity < minCapacity; capacity *= 2)
+					--shift;
+				if (shift <= 0)
+					THROW("Too many addresses for a module.");
+
+				std::vector<AddressEntry> entries(capacity);
+				std::swap(entries, entries_);
+				shift_ = shift;
+				size_ = 0;
+				for (const auto& entry : entries)
+				{
+					if (entry.rva_ != InvalidRva)
+						*Insert(entry.rva_).first = entry;
+				}
+			}
+
+			std::vector<AddressEntry> entries_;
+			size_t size_ = 0;
+			int shift_ = 32;
+		};
+
+		//---------------------------------------------------------------------
+		struct SpilledRange
 		{
+			uint64_t offset_ = 0;
+			uint64_t size_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void AppendValues(std::string& content, const T* values, size_t count)
+		{
+			content.append(reinterpret_cast<const char*>(values), count * sizeof(T));
 		}
 
-		const unsigned char instructionToRestore_;
-		void* const dllBaseOfImage_;
-		boost::container::small_vector<bool*, 1> hasBeenExecutedCollection_;
+		//---------------------------------------------------------------------
+		template <typename T>
+		void AppendValue(std::string& content, T value)
+		{
+			AppendValues(content, &value, 1);
+		}
+
+		//---------------------------------------------------------------------
+		// Read the values in the order AppendValue writes them.
+		class SpilledContentReader
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit SpilledContentReader(std::string_view content) : content_{ content }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			template <typename T>
+			void ReadValues(T* values, size_t count)
+			{
+				auto size = count * sizeof(T);
+
+				if (size > content_.size())
+					THROW("Invalid spilled lines.");
+				std::copy_n(content_.data(), size, reinterpret_cast<char*>(values));
+				content_.remove_prefix(size);
+			}
+
+			//-----------------------------------------------------------------
+			template <typename T>
+			T ReadValue()
+			{
+				T value;
+
+				ReadValues(&value, 1);
+				return value;
+			}
+
+		private:
+			std::string_view content_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	// There is one by registered line: the small members are last to avoid
+	// the padding.
+	struct ExecutedAddressManager::LineState
+	{
+		uint64_t hitCount_ = 0;
+		uint64_t firstHitOrder_ = 0;
+		int64_t firstHitCounter_ = 0;
+		const std::wstring* filename_ = nullptr;
+		unsigned int lineNumber_ = 0;
+		bool hasBeenExecuted_ = false;
 	};
 
 	//-------------------------------------------------------------------------
 	struct ExecutedAddressManager::File
-	{		
-		// Use map to have iterator always valid
-		std::map<unsigned int, bool> lines;
+	{
+		static constexpr uint32_t NoLineState = (std::numeric_limits<uint32_t>::max)();
+
+		//---------------------------------------------------------------------
+		// Extend the lines to [firstLine, lastLine].
+		void Reserve(unsigned int firstLine, unsigned int lastLine)
+		{
+			if (lineStateIndexes_.empty())
+			{
+				firstLine_ = firstLine;
+				lineStateIndexes_.assign(lastLine - firstLine + 1, NoLineState);
+				return;
+			}
+			if (firstLine < firstLine_)
+			{
+				lineStateIndexes_.insert(lineStateIndexes_.begin(), firstLine_ - firstLine, NoLineState);
+				firstLine_ = firstLine;
+			}
+			if (lastLine - firstLine_ >= lineStateIndexes_.size())
+				lineStateIndexes_.resize(lastLine - firstLine_ + 1, NoLineState);
+		}
+
+		//---------------------------------------------------------------------
+		uint32_t& operator[](unsigned int lineNumber)
+		{
+			Reserve(lineNumber, lineNumber);
+			return lineStateIndexes_[lineNumber - firstLine_];
+		}
+
+		//---------------------------------------------------------------------
+		uint32_t GetLineStateIndex(unsigned int lineNumber) const
+		{
+			if (lineNumber < firstLine_ || lineNumber - firstLine_ >= lineStateIndexes_.size())
+				return NoLineState;
+			return lineStateIndexes_[lineNumber - firstLine_];
+		}
+
+		//---------------------------------------------------------------------
+		uint64_t GetAllocatedSize() const
+		{
+			return Tools::GetAllocatedSize(lineStateIndexes_);
+		}
+
+		//---------------------------------------------------------------------
+		void Save(std::string& content) const
+		{
+			AppendValue(content, firstLine_);
+			AppendValue<uint64_t>(content, lineStateIndexes_.size());
+			AppendValues(content, lineStateIndexes_.data(), lineStateIndexes_.size());
+		}
+
+		//---------------------------------------------------------------------
+		void Load(SpilledContentReader& reader)
+		{
+			firstLine_ = reader.ReadValue<unsigned int>();
+			lineStateIndexes_.resize(reader.ReadValue<uint64_t>());
+			reader.ReadValues(lineStateIndexes_.data(), lineStateIndexes_.size());
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Function>
+		void ForEachLine(Function function) const
+		{
+			for (size_t i = 0; i < lineStateIndexes_.size(); ++i)
+			{
+				if (lineStateIndexes_[i] != NoLineState)
+					function(firstLine_ + static_cast<unsigned int>(i), lineStateIndexes_[i]);
+			}
+		}
+
+	private:
+		// Index in Module::lineStates_ of each line from firstLine_:
+		// NoLineState for the lines without code.
+		unsigned int firstLine_ = 0;
+		std::vector<uint32_t> lineStateIndexes_;
 	};
 
 	//-------------------------------------------------------------------------
@@ -57,15 +339,217 @@ namespace CppCoverage
 		{
 		}
 
+		//---------------------------------------------------------------------
+		uint64_t GetLinesMemoryUsage() const
+		{
+			uint64_t bytes = Tools::GetHashNodesSize(files_) + Tools::GetAllocatedSize(lineStates_);
+
+			for (const auto& file : files_)
+				bytes += Tools::GetAllocatedSize(file.first) + file.second.GetAllocatedSize();
+			return bytes;
+		}
+
+		//---------------------------------------------------------------------
+		// The line states reference their file by its index in the content.
+		std::string SaveLines() const
+		{
+			std::unordered_map<const std::wstring*, uint32_t> fileIndexes;
+			std::string content;
+
+			AppendValue<uint64_t>(content, files_.size());
+			for (const auto& file : files_)
+			{
+				fileIndexes.emplace(&file.first, static_cast<uint32_t>(fileIndexes.size()));
+				AppendValue<uint64_t>(content, file.first.size());
+				AppendValues(content, file.first.data(), file.first.size());
+				file.second.Save(content);
+			}
+			AppendValue<uint64_t>(content, lineStates_.size());
+			for (const auto& lineState : lineStates_)
+			{
+				AppendValue(content, lineState.hitCount_);
+				AppendValue(content, lineState.firstHitOrder_);
+				AppendValue(content, lineState.firstHitCounter_);
+				AppendValue(content, fileIndexes.at(lineState.filename_));
+				AppendValue(content, lineState.lineNumber_);
+				AppendValue(content, lineState.hasBeenExecuted_);
+			}
+			return content;
+		}
+
+		//---------------------------------------------------------------------
+		void LoadLines(std::string_view content)
+		{
+			SpilledContentReader reader{ content };
+			std::vector<const std::wstring*> filenames(reader.ReadValue<uint64_t>());
+
+			for (auto& filename : filenames)
+			{
+				std::wstring path(reader.ReadValue<uint64_t>(), L'\0');
+
+				reader.ReadValues(&path[0], path.size());
+				auto it = files_.emplace(std::move(path), File{}).first;
+				it->second.Load(reader);
+				filename = &it->first;
+			}
+			for (auto count = reader.ReadValue<uint64_t>(); count; --count)
+			{
+				auto& lineState = lineStates_.emplace_back();
+				lineState.hitCount_ = reader.ReadValue<uint64_t>();
+				lineState.firstHitOrder_ = reader.ReadValue<uint64_t>();
+				lineState.firstHitCounter_ = reader.ReadValue<int64_t>();
+				lineState.filename_ = filenames.at(reader.ReadValue<uint32_t>());
+				lineState.lineNumber_ = reader.ReadValue<unsigned int>();
+				lineState.hasBeenExecuted_ = reader.ReadValue<bool>();
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void ReleaseLines()
+		{
+			std::unordered_map<std::wstring, File>{}.swap(files_);
+			std::deque<LineState>{}.swap(lineStates_);
+		}
+
 		const std::wstring name_;
+		std::wstring identity_;
 		std::unordered_map<std::wstring, File> files_;
+		// Deque to have references always valid
+		std::deque<LineState> lineStates_;
+		// The line states are only added: the ones from this index are not
+		// in the journal yet.
+		size_t journaledLineStateCount_ = 0;
+		std::vector<uint32_t> journalExecutedLineStateIndexes_;
+		uint64_t hitBreakPointCount_ = 0;
+		// files_ and lineStates_ are in the spill file.
+		boost::optional<SpilledRange> spilledRange_;
+	};
+
+	//-------------------------------------------------------------------------
+	struct ExecutedAddressManager::ModuleAddresses
+	{
+		ModuleAddresses(Module& module, void* baseOfImage)
+			: module_{ &module }
+			, baseOfImage_{ baseOfImage }
+		{
+		}
+
+		Module* module_;
+		void* baseOfImage_;
+		AddressTable addresses_;
+		// Line states of the addresses shared by several lines.
+		std::unordered_multimap<uint32_t, uint32_t> otherLineStateIndexes_;
+		size_t armedAddressCount_ = 0;
+		// Addresses of each line state for the eager line disarm.
+		std::unordered_multimap<uint32_t, uint32_t> rvasByLineState_;
+		// Dropped with the module when it is unloaded before they are taken.
+		std::vector<std::pair<unsigned char, DWORD64>> disarmedAddresses_;
+	};
+
+	//-------------------------------------------------------------------------
+	struct ExecutedAddressManager::ProcessAddresses
+	{
+		ModuleAddressesByBase modules_;
+		size_t disarmedAddressCount_ = 0;
+	};
+
+	//-------------------------------------------------------------------------
+	// Temporary file deleted when it is closed. The space of the modules read
+	// again is not reused.
+	struct ExecutedAddressManager::SpillFile
+	{
+		//---------------------------------------------------------------------
+		SpillFile()
+		{
+			wchar_t folder[MAX_PATH + 1];
+			wchar_t path[MAX_PATH + 1];
+
+			if (!GetTempPathW(MAX_PATH + 1, folder) || !GetTempFileNameW(folder, L"occ", 0, path))
+				THROW(L"Cannot get a temporary file for the spilled lines: " << GetLastError());
+			hFile_ = CreateFileW(path,
+			                     GENERIC_READ | GENERIC_WRITE,
+			                     0,
+			                     nullptr,
+			                     CREATE_ALWAYS,
+			                     FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE,
+			                     nullptr);
+			if (hFile_ == INVALID_HANDLE_VALUE)
+				THROW(L"Cannot create " << path << L": " << GetLastError());
+		}
+
+		//---------------------------------------------------------------------
+		~SpillFile()
+		{
+			CloseHandle(hFile_);
+		}
+
+		//---------------------------------------------------------------------
+		SpilledRange Write(const std::string& content)
+		{
+			SpilledRange range{ size_, content.size() };
+			LARGE_INTEGER position;
+			DWORD writtenSize = 0;
+
+			position.QuadPart = static_cast<LONGLONG>(size_);
+			if (content.size() > (std::numeric_limits<DWORD>::max)() ||
+			    !SetFilePointerEx(hFile_, position, nullptr, FILE_BEGIN) ||
+			    !WriteFile(hFile_, content.data(), static_cast<DWORD>(content.size()), &writtenSize, nullptr) ||
+			    writtenSize != content.size())
+			{
+				THROW(L"Cannot write the spilled lines: " << GetLastError());
+			}
+			size_ += content.size();
+			return range;
+		}
+
+		//---------------------------------------------------------------------
+		// function gets the content of range from a view of the file.
+		template <typename Function>
+		void Read(const SpilledRange& range, Function function) const
+		{
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			auto viewOffset = range.offset_ - range.offset_ % systemInfo.dwAllocationGranularity;
+			auto hMapping = CreateFileMappingW(hFile_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+			if (!hMapping)
+				THROW(L"Cannot map the spilled lines: " << GetLastError());
+			Tools::ScopedAction closeMapping{ [&]() { CloseHandle(hMapping); } };
+
+			auto view = MapViewOfFile(hMapping,
+			                          FILE_MAP_READ,
+			                          static_cast<DWORD>(viewOffset >> 32),
+			                          static_cast<DWORD>(viewOffset),
+			                          static_cast<SIZE_T>(range.offset_ - viewOffset + range.size_));
+			if (!view)
+				THROW(L"Cannot map the spilled lines: " << GetLastError());
+			Tools::ScopedAction unmapView{ [&]() { UnmapViewOfFile(view); } };
+
+			function(std::string_view{ static_cast<const char*>(view) + (range.offset_ - viewOffset),
+			                           static_cast<size_t>(range.size_) });
+		}
+
+		HANDLE hFile_;
+		uint64_t size_ = 0;
 	};
 	
 	//-------------------------------------------------------------------------
 	ExecutedAddressManager::ExecutedAddressManager()
+		: keepExecutedAddresses_{ false }
+		, isJournalEnabled_{ false }
+		, isEagerLineDisarmEnabled_{ false }
+		, memoryBudget_{ 0 }
+		, firstHitCount_{ 0 }
 	{
 		lastModule_.baseOfImage_ = nullptr;
 		lastModule_.module_ = nullptr;
+
+		LARGE_INTEGER counter;
+		LARGE_INTEGER frequency;
+		QueryPerformanceCounter(&counter);
+		QueryPerformanceFrequency(&frequency);
+		startCounter_ = counter.QuadPart;
+		counterFrequency_ = frequency.QuadPart;
 	}
 
 	//-------------------------------------------------------------------------
@@ -76,16 +560,39 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	void ExecutedAddressManager::AddModule(
 		const std::wstring& moduleName,
-		void* dllBaseOfImage)
+		void* dllBaseOfImage,
+		const std::wstring& identity)
 	{
-		auto it = modules_.find(moduleName);
+		auto& module = modules_.try_emplace(moduleName, moduleName).first->second;
+
+		if (!identity.empty())
+			module.identity_ = identity;
+		if (module.spilledRange_)
+			LoadSpilledLines(module);
 
-		if (it == modules_.end())
-			it = modules_.emplace(moduleName, Module{ moduleName }).first;
-		lastModule_.module_ = &it->second;
+		lastModule_.module_ = &module;
 		lastModule_.baseOfImage_ = dllBaseOfImage;
 	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::ReserveAddresses(HANDLE hProcess, size_t count)
+	{
+		GetLastAddedModuleAddresses(GetProcessAddresses(hProcess)).addresses_.Reserve(count);
+	}
 	
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::ReserveLines(
+		const std::wstring& filename,
+		unsigned int firstLine,
+		unsigned int lastLine)
+	{
+		if (firstLine > lastLine)
+			THROW(L"Invalid line range " << firstLine << L"-" << lastLine << L" for " << filename);
+
+		auto& module = GetLastAddedModule();
+		module.files_[filename].Reserve(firstLine, lastLine);
+	}
+
 	//-------------------------------------------------------------------------
 	bool ExecutedAddressManager::RegisterAddress(
 		const Address& address,
@@ -94,26 +601,45 @@ namespace CppCoverage
 		unsigned char instructionValue)
 	{
 		auto& module = GetLastAddedModule();
-		auto& file = module.files_[filename];
+		auto itFile = module.files_.emplace(filename, File{}).first;
+		auto& file = itFile->second;
 
 		LOG_TRACE << "RegisterAddress: " << address << " for " << filename << ":" << lineNumber;
 
+		auto& moduleAddresses = GetLastAddedModuleAddresses(GetProcessAddresses(address.GetProcessHandle()));
+		auto rva = GetRva(moduleAddresses.baseOfImage_, address.GetValue());
+		if (rva == InvalidRva)
+			THROW(L"Address " << address << L" is outside of " << module.name_);
+
+		auto& lineStateIndex = file[lineNumber];
+		if (lineStateIndex == File::NoLineState)
+		{
+			lineStateIndex = static_cast<uint32_t>(module.lineStates_.size());
+			auto& lineState = module.lineStates_.emplace_back();
+			lineState.filename_ = &itFile->first;
+			lineState.lineNumber_ = lineNumber;
+		}
+
 		// Different {filename, line} can have the same address.
 		// Same {filename, line} can have several addresses.		
-		bool keepBreakpoint = false;
-		auto itAddress = addressLineMap_.find(address);
+		auto insertion = moduleAddresses.addresses_.Insert(rva);
+		auto& entry = *insertion.first;
 
-		if (itAddress == addressLineMap_.end())
+		if (insertion.second)
 		{
-			itAddress = addressLineMap_.emplace(address, 
-				Line{ instructionValue, lastModule_.baseOfImage_ }).first;
-			keepBreakpoint = true;
+			entry.lineStateIndex_ = lineStateIndex;
+			entry.instructionToRestore_ = instructionValue;
+			++moduleAddresses.armedAddressCount_;
 		}
+		else
+		{
+			entry.hasOtherLineStates_ = true;
+			moduleAddresses.otherLineStateIndexes_.emplace(rva, lineStateIndex);
+		}
+		if (isEagerLineDisarmEnabled_)
+			moduleAddresses.rvasByLineState_.emplace(lineStateIndex, rva);
 		
-		auto& line = itAddress->second;
-		line.hasBeenExecutedCollection_.push_back(&file.lines[lineNumber]);
-		
-		return keepBreakpoint;
+		return insertion.second;
 	}
 
 	//-------------------------------------------------------------------------
@@ -126,25 +652,562 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	boost::optional<unsigned char> ExecutedAddressManager::MarkAddressAsExecuted(
+	ExecutedAddressManager::ProcessAddresses&
+	ExecutedAddressManager::GetProcessAddresses(HANDLE hProcess)
+	{
+		return addressesByProcess_[hProcess];
+	}
+
+	//-------------------------------------------------------------------------
+	ExecutedAddressManager::ProcessAddresses*
+	ExecutedAddressManager::FindProcessAddresses(HANDLE hProcess)
+	{
+		const auto& constThis = *this;
+
+		return const_cast<ProcessAddresses*>(constThis.FindProcessAddresses(hProcess));
+	}
+
+	//-------------------------------------------------------------------------
+	const ExecutedAddressManager::ProcessAddresses*
+	ExecutedAddressManager::FindProcessAddresses(HANDLE hProcess) const
+	{
+		auto it = addressesByProcess_.find(hProcess);
+
+		return it != addressesByProcess_.end() ? &it->second : nullptr;
+	}
+
+	//-------------------------------------------------------------------------
+	ExecutedAddressManager::ModuleAddresses&
+	ExecutedAddressManager::GetLastAddedModuleAddresses(
+		ProcessAddresses& processAddresses)
+	{
+		auto& module = GetLastAddedModule();
+		auto& modules = processAddresses.modules_;
+		auto baseOfImage = lastModule_.baseOfImage_;
+		auto it = modules.find(baseOfImage);
+
+		// A module unloaded without event can be replaced by another one.
+		if (it != modules.end() && it->second.module_ != &module)
+		{
+			processAddresses.disarmedAddressCount_ -= it->second.disarmedAddresses_.size();
+			it = modules.erase(it);
+		}
+		if (it == modules.end() || it->first != baseOfImage)
+			it = modules.emplace_hint(it, baseOfImage, ModuleAddresses{ module, baseOfImage });
+		return it->second;
+	}
+
+	//-------------------------------------------------------------------------
+	ExecutedAddressManager::ModuleAddresses*
+	ExecutedAddressManager::FindModuleAddresses(
+		ProcessAddresses& processAddresses,
 		const Address& address)
 	{
-		auto it = addressLineMap_.find(address);
+		const auto& constThis = *this;
+
+		return const_cast<ModuleAddresses*>(constThis.FindModuleAddresses(processAddresses, address));
+	}
+
+	//-------------------------------------------------------------------------
+	const ExecutedAddressManager::ModuleAddresses*
+	ExecutedAddressManager::FindModuleAddresses(
+		const ProcessAddresses& processAddresses,
+		const Address& address) const
+	{
+		// The addresses of a module are above its base of image.
+		const auto& modules = processAddresses.modules_;
+		auto it = modules.upper_bound(address.GetValue());
+
+		if (it == modules.begin())
+			return nullptr;
+		return &std::prev(it)->second;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<unsigned char> ExecutedAddressManager::MarkAddressAsExecuted(
+		const Address& address,
+		uint64_t hitCount)
+	{
+		return MarkAddress(address, hitCount, false);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<unsigned char> ExecutedAddressManager::MarkAddressTotalHitCount(
+		const Address& address,
+		uint64_t totalHitCount)
+	{
+		return MarkAddress(address, totalHitCount, true);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<unsigned char> ExecutedAddressManager::MarkAddress(
+		const Address& address,
+		uint64_t hitCount,
+		bool isTotalHitCount)
+	{
+		auto processAddresses = FindProcessAddresses(address.GetProcessHandle());
 
-		if (it == addressLineMap_.end())
+		if (!processAddresses)
 			return boost::none;
 
-		auto& line = it->second;
+		auto moduleAddresses = FindModuleAddresses(*processAddresses, address);
 
-		for (bool* hasBeenExecuted : line.hasBeenExecutedCollection_)
+		if (!moduleAddresses)
+			return boost::none;
+
+		auto rva = GetRva(moduleAddresses->baseOfImage_, address.GetValue());
+		auto entry = moduleAddresses->addresses_.Find(rva);
+
+		if (!entry || entry->state_ == AddressState::Released)
+			return boost::none;
+
+		auto isFirstHit = entry->state_ != AddressState::Executed;
+		if (entry->state_ == AddressState::Armed)
+			--moduleAddresses->armedAddressCount_;
+		// The breakpoint is never set again: only the state of the entry is
+		// kept to recognize late breakpoints.
+		entry->state_ = keepExecutedAddresses_ ? AddressState::Executed : AddressState::Released;
+
+		auto& module = *moduleAddresses->module_;
+		auto& lineStates = module.lineStates_;
+		if (isFirstHit || !isTotalHitCount)
+			++module.hitBreakPointCount_;
+		auto markLineState = [&](uint32_t lineStateIndex) {
+			auto& lineState = lineStates.at(lineStateIndex);
+			if (isJournalEnabled_ && !lineState.hasBeenExecuted_)
+				module.journalExecutedLineStateIndexes_.push_back(lineStateIndex);
+			if (!lineState.firstHitOrder_)
+			{
+				LARGE_INTEGER counter;
+				QueryPerformanceCounter(&counter);
+				lineState.firstHitOrder_ = ++firstHitCount_;
+				lineState.firstHitCounter_ = counter.QuadPart;
+			}
+			lineState.hasBeenExecuted_ = true;
+			// The counters of the addresses of a line count the same executions.
+			if (isTotalHitCount)
+				lineState.hitCount_ = (std::max)(lineState.hitCount_, hitCount);
+			else
+				lineState.hitCount_ += hitCount;
+			if (recordedLineStates_)
+				recordedLineStates_->push_back(&lineState);
+		};
+
+		markLineState(entry->lineStateIndex_);
+		if (entry->hasOtherLineStates_)
+		{
+			auto range = moduleAddresses->otherLineStateIndexes_.equal_range(rva);
+			for (auto it = range.first; it != range.second; ++it)
+				markLineState(it->second);
+		}
+		if (isEagerLineDisarmEnabled_ && !keepExecutedAddresses_)
 		{
-			if (!hasBeenExecuted)
-				THROW("Invalid pointer");
-			*hasBeenExecuted = true;
+			processAddresses->disarmedAddressCount_ +=
+				DisarmOtherAddresses(*moduleAddresses, rva);
 		}
-		return line.instructionToRestore_;
+		return entry->instructionToRestore_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ExecutedAddressManager::DisarmOtherAddresses(
+		ModuleAddresses& moduleAddresses,
+		uint32_t executedRva)
+	{
+		const auto& lineStates = moduleAddresses.module_->lineStates_;
+		auto forEachLineState = [&](uint32_t addressRva, const AddressEntry& entry, auto function) {
+			function(entry.lineStateIndex_);
+			if (entry.hasOtherLineStates_)
+			{
+				auto range = moduleAddresses.otherLineStateIndexes_.equal_range(addressRva);
+				for (auto it = range.first; it != range.second; ++it)
+					function(it->second);
+			}
+		};
+		size_t disarmedAddressCount = 0;
+		auto baseOfImage = reinterpret_cast<DWORD64>(moduleAddresses.baseOfImage_);
+
+		forEachLineState(executedRva, *moduleAddresses.addresses_.Find(executedRva), [&](uint32_t lineStateIndex) {
+			auto range = moduleAddresses.rvasByLineState_.equal_range(lineStateIndex);
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				auto entry = moduleAddresses.addresses_.Find(it->second);
+				if (!entry || entry->state_ != AddressState::Armed)
+					continue;
+
+				// The address can also be the only one of another line.
+				auto areLinesExecuted = true;
+				forEachLineState(it->second, *entry, [&](uint32_t otherLineStateIndex) {
+					areLinesExecuted = areLinesExecuted && lineStates.at(otherLineStateIndex).hasBeenExecuted_;
+				});
+				if (!areLinesExecuted)
+					continue;
+				entry->state_ = AddressState::Released;
+				--moduleAddresses.armedAddressCount_;
+				moduleAddresses.disarmedAddresses_.emplace_back(entry->instructionToRestore_, baseOfImage + it->second);
+				++disarmedAddressCount;
+			}
+		});
+		return disarmedAddressCount;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::EnableEagerLineDisarm()
+	{
+		isEagerLineDisarmEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::pair<unsigned char, DWORD64>>
+	ExecutedAddressManager::TakeDisarmedAddresses(HANDLE hProcess)
+	{
+		std::vector<std::pair<unsigned char, DWORD64>> disarmedAddresses;
+
+		if (!isEagerLineDisarmEnabled_)
+			return disarmedAddresses;
+
+		auto processAddresses = FindProcessAddresses(hProcess);
+		if (!processAddresses)
+			return disarmedAddresses;
+
+		if (!processAddresses->disarmedAddressCount_)
+			return disarmedAddresses;
+		disarmedAddresses.reserve(processAddresses->disarmedAddressCount_);
+		for (auto& pair : processAddresses->modules_)
+		{
+			auto& moduleDisarmedAddresses = pair.second.disarmedAddresses_;
+			disarmedAddresses.insert(disarmedAddresses.end(),
+				moduleDisarmedAddresses.begin(), moduleDisarmedAddresses.end());
+			moduleDisarmedAddresses.clear();
+		}
+		processAddresses->disarmedAddressCount_ = 0;
+		return disarmedAddresses;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::KeepExecutedAddresses()
+	{
+		keepExecutedAddresses_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool ExecutedAddressManager::IsAddressReleased(const Address& address) const
+	{
+		auto processAddresses = FindProcessAddresses(address.GetProcessHandle());
+
+		if (!processAddresses)
+			return false;
+
+		auto moduleAddresses = FindModuleAddresses(*processAddresses, address);
+
+		if (!moduleAddresses)
+			return false;
+
+		auto rva = GetRva(moduleAddresses->baseOfImage_, address.GetValue());
+		auto entry = moduleAddresses->addresses_.Find(rva);
+
+		return entry && entry->state_ == AddressState::Released;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::EnableLinesRecording()
+	{
+		if (!recordedLineStates_)
+			recordedLineStates_ = std::vector<const LineState*>{};
+	}
+
+	//-------------------------------------------------------------------------
+	ExecutedAddressManager::LinesByFile
+	ExecutedAddressManager::TakeRecordedLines()
+	{
+		if (!recordedLineStates_)
+			THROW("Lines recording is not enabled.");
+
+		LinesByFile linesByFile;
+		for (const auto* lineState : *recordedLineStates_)
+			linesByFile[*lineState->filename_].insert(lineState->lineNumber_);
+		recordedLineStates_->clear();
+		return linesByFile;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::EnableJournal()
+	{
+		isJournalEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	ExecutedAddressManager::JournalLines ExecutedAddressManager::TakeJournalLines()
+	{
+		if (!isJournalEnabled_)
+			THROW("Journal is not enabled.");
+
+		JournalLines journalLines;
+		for (auto& pair : modules_)
+		{
+			auto& module = pair.second;
+
+			for (auto i = module.journaledLineStateCount_; i < module.lineStates_.size(); ++i)
+			{
+				const auto& lineState = module.lineStates_[i];
+				journalLines.registeredLines_[module.name_][*lineState.filename_].insert(lineState.lineNumber_);
+			}
+			module.journaledLineStateCount_ = module.lineStates_.size();
+
+			for (auto lineStateIndex : module.journalExecutedLineStateIndexes_)
+			{
+				const auto& lineState = module.lineStates_.at(lineStateIndex);
+				journalLines.executedLines_[module.name_][*lineState.filename_].insert(lineState.lineNumber_);
+			}
+			module.journalExecutedLineStateIndexes_.clear();
+		}
+		return journalLines;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ExecutedAddressManager::GetArmedAddressCount(HANDLE hProcess) const
+	{
+		auto processAddresses = FindProcessAddresses(hProcess);
+		size_t armedAddressCount = 0;
+
+		if (processAddresses)
+		{
+			for (const auto& pair : processAddresses->modules_)
+				armedAddressCount += pair.second.armedAddressCount_;
+		}
+		return armedAddressCount;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Address> ExecutedAddressManager::GetArmedAddresses(HANDLE hProcess) const
+	{
+		std::vector<Address> addresses;
+		auto processAddresses = FindProcessAddresses(hProcess);
+
+		if (!processAddresses)
+			return addresses;
+
+		for (const auto& pair : processAddresses->modules_)
+		{
+			auto baseOfImage = static_cast<char*>(pair.first);
+			pair.second.addresses_.ForEach([&](const AddressEntry& entry) {
+				if (entry.state_ == AddressState::Armed)
+					addresses.emplace_back(hProcess, baseOfImage + entry.rva_);
+			});
+		}
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Address> ExecutedAddressManager::GetArmedAddresses(
+		HANDLE hProcess,
+		void* baseOfImage) const
+	{
+		std::vector<Address> addresses;
+		auto processAddresses = FindProcessAddresses(hProcess);
+
+		if (!processAddresses)
+			return addresses;
+
+		auto it = processAddresses->modules_.find(baseOfImage);
+		if (it == processAddresses->modules_.end())
+			return addresses;
+		it->second.addresses_.ForEach([&](const AddressEntry& entry) {
+			if (entry.state_ == AddressState::Armed)
+				addresses.emplace_back(hProcess, static_cast<char*>(baseOfImage) + entry.rva_);
+		});
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t ExecutedAddressManager::GetExecutedLineCount() const
+	{
+		return firstHitCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::pair<std::wstring, uint64_t>>
+	ExecutedAddressManager::GetHitBreakPointCounts() const
+	{
+		std::vector<std::pair<std::wstring, uint64_t>> hitBreakPointCounts;
+
+		for (const auto& pair : modules_)
+			hitBreakPointCounts.emplace_back(pair.first, pair.second.hitBreakPointCount_);
+		return hitBreakPointCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t ExecutedAddressManager::GetMemoryUsage() const
+	{
+		uint64_t bytes = Tools::GetNodesSize(modules_);
+
+		for (const auto& pair : modules_)
+		{
+			const auto& module = pair.second;
+
+			bytes += Tools::GetAllocatedSize(pair.first) + Tools::GetAllocatedSize(module.name_) +
+			         module.GetLinesMemoryUsage() +
+			         Tools::GetAllocatedSize(module.journalExecutedLineStateIndexes_);
+		}
+
+		bytes += Tools::GetNodesSize(addressesByProcess_);
+		for (const auto& processAddresses : addressesByProcess_)
+		{
+			bytes += Tools::GetNodesSize(processAddresses.second.modules_);
+			for (const auto& pair : processAddresses.second.modules_)
+			{
+				const auto& moduleAddresses = pair.second;
+				bytes += moduleAddresses.addresses_.GetAllocatedSize() +
+				         Tools::GetHashNodesSize(moduleAddresses.otherLineStateIndexes_);
+			}
+		}
+
+		if (recordedLineStates_)
+			bytes += Tools::GetAllocatedSize(*recordedLineStates_);
+		return bytes;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::SetMemoryBudget(uint64_t bytes)
+	{
+		memoryBudget_ = bytes;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ExecutedAddressManager::GetSpilledModuleCount() const
+	{
+		return static_cast<size_t>(std::count_if(modules_.begin(), modules_.end(), [](const auto& pair) {
+			return pair.second.spilledRange_.is_initialized();
+		}));
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::LoadSpilledLines(Module& module)
+	{
+		if (!module.spilledRange_)
+			return;
+		spillFile_->Read(*module.spilledRange_, [&](std::string_view content) {
+			module.LoadLines(content);
+		});
+		module.spilledRange_.reset();
+	}
+
+	//-------------------------------------------------------------------------
+	const ExecutedAddressManager::Module& ExecutedAddressManager::GetLoadedModule(
+		const Module& module,
+		std::unique_ptr<Module>& loadedModule) const
+	{
+		if (!module.spilledRange_)
+			return module;
+
+		loadedModule = std::make_unique<Module>(module.name_);
+		loadedModule->identity_ = module.identity_;
+		spillFile_->Read(*module.spilledRange_, [&](std::string_view content) {
+			loadedModule->LoadLines(content);
+		});
+		return *loadedModule;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::SpillIdleModules()
+	{
+		if (!memoryBudget_)
+			return;
+		// The recorded lines reference the line states.
+		if (recordedLineStates_)
+			return;
+
+		auto memoryUsage = GetMemoryUsage();
+		if (memoryUsage <= memoryBudget_)
+			return;
+
+		std::unordered_set<const Module*> usedModules;
+		for (const auto& processAddresses : addressesByProcess_)
+		{
+			for (const auto& pair : processAddresses.second.modules_)
+				usedModules.insert(pair.second.module_);
+		}
+		// The last added module can still get its addresses.
+		if (lastModule_.module_)
+			usedModules.insert(lastModule_.module_);
+
+		std::vector<std::pair<uint64_t, Module*>> idleModules;
+		for (auto& pair : modules_)
+		{
+			auto& module = pair.second;
+			// The lines not journaled yet reference the line states.
+			auto hasJournalLines = isJournalEnabled_ &&
+				(module.journaledLineStateCount_ != module.lineStates_.size() ||
+				 !module.journalExecutedLineStateIndexes_.empty());
+
+			if (!module.spilledRange_ && !hasJournalLines && !usedModules.count(&module))
+				idleModules.emplace_back(module.GetLinesMemoryUsage(), &module);
+		}
+
+		// The largest modules first to write as few modules as possible.
+		std::sort(idleModules.begin(), idleModules.end(), [](const auto& module1, const auto& module2) {
+			return module1.first > module2.first;
+		});
+		size_t spilledModuleCount = 0;
+		for (const auto& idleModule : idleModules)
+		{
+			if (memoryUsage <= memoryBudget_)
+				break;
+
+			auto& module = *idleModule.second;
+
+			if (!spillFile_)
+				spillFile_ = std::make_unique<SpillFile>();
+			module.spilledRange_ = spillFile_->Write(module.SaveLines());
+			module.ReleaseLines();
+			memoryUsage -= (std::min)(memoryUsage, idleModule.first);
+			++spilledModuleCount;
+		}
+		if (spilledModuleCount)
+			LOG_DEBUG << L"Spill the lines of " << spilledModuleCount << L" modules.";
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<unsigned char> ExecutedAddressManager::GetInstructionToRestore(
+		const Address& address) const
+	{
+		auto processAddresses = FindProcessAddresses(address.GetProcessHandle());
+
+		if (!processAddresses)
+			return boost::none;
+
+		auto moduleAddresses = FindModuleAddresses(*processAddresses, address);
+
+		if (!moduleAddresses)
+			return boost::none;
+
+		auto rva = GetRva(moduleAddresses->baseOfImage_, address.GetValue());
+		auto entry = moduleAddresses->addresses_.Find(rva);
+
+		if (!entry || entry->state_ == AddressState::Released)
+			return boost::none;
+		return entry->instructionToRestore_;
 	}
 	
+	//-------------------------------------------------------------------------
+	bool ExecutedAddressManager::IsLineExecuted(
+		const std::wstring& filename,
+		unsigned int lineNumber) const
+	{
+		if (!lastModule_.module_)
+			THROW("Cannot get last module.");
+
+		const auto& files = lastModule_.module_->files_;
+		auto itFile = files.find(filename);
+
+		if (itFile == files.end())
+			return false;
+
+		auto lineStateIndex = itFile->second.GetLineStateIndex(lineNumber);
+
+		return lineStateIndex != File::NoLineState
+			&& lastModule_.module_->lineStates_.at(lineStateIndex).hasBeenExecuted_;
+	}
+
 	//-------------------------------------------------------------------------
 	Plugin::CoverageData ExecutedAddressManager::CreateCoverageData(
 		const std::wstring& name,
@@ -152,62 +1215,259 @@ namespace CppCoverage
 	{
 		Plugin::CoverageData coverageData{ name, exitCode };
 
+		coverageData.ReserveModules(modules_.size());
 		for (const auto& pair : modules_)
 		{
-			const auto& module = pair.second;
-			auto& moduleCoverage = coverageData.AddModule(module.name_);
+			std::unique_ptr<Module> loadedModule;
+			AddModuleCoverage(coverageData, GetLoadedModule(pair.second, loadedModule));
+		}
+
+		return coverageData;
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData ExecutedAddressManager::TakeCoverageData(
+		const std::wstring& name,
+		int exitCode)
+	{
+		Plugin::CoverageData coverageData{ name, exitCode };
+
+		// The addresses and the recorded lines reference the line states.
+		addressesByProcess_.clear();
+		recordedLineStates_.reset();
+		lastModule_.module_ = nullptr;
+		lastModule_.baseOfImage_ = nullptr;
+
+		// Each module is released once converted so the lines are not kept
+		// twice until the end of the conversion.
+		coverageData.ReserveModules(modules_.size());
+		for (auto it = modules_.begin(); it != modules_.end(); it = modules_.erase(it))
+		{
+			std::unique_ptr<Module> loadedModule;
+			AddModuleCoverage(coverageData, GetLoadedModule(it->second, loadedModule));
+		}
+		spillFile_.reset();
+
+		return coverageData;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageSummary ExecutedAddressManager::CreateCoverageSummary(
+		const std::wstring& name,
+		int exitCode) const
+	{
+		CoverageSummary coverageSummary{ name, exitCode };
+
+		for (const auto& pair : modules_)
+		{
+			std::unique_ptr<Module> loadedModule;
+			const auto& module = GetLoadedModule(pair.second, loadedModule);
+			int executedLineCount = 0;
+			int lineCount = 0;
 
 			for (const auto& file : module.files_)
 			{
-				const std::wstring& name = file.first;
-				const File& fileData = file.second;
+				file.second.ForEachLine([&](unsigned int, uint32_t lineStateIndex) {
+					++lineCount;
+					if (module.lineStates_[lineStateIndex].hasBeenExecuted_)
+						++executedLineCount;
+				});
+			}
+			coverageSummary.AddModule(
+				module.name_, CoverageRate{ executedLineCount, lineCount - executedLineCount });
+		}
+		return coverageSummary;
+	}
 
-				auto& fileCoverage = moduleCoverage.AddFile(name);
+	//-------------------------------------------------------------------------
+	template <typename OnFile, typename OnLine>
+	void ExecutedAddressManager::ForEachModuleLine(
+		const Module& module,
+		OnFile onFile,
+		OnLine onLine) const
+	{
+		std::vector<std::pair<std::filesystem::path, const File*>> files;
 
-				for (const auto& pair : fileData.lines)
-				{
-					auto lineNumber = pair.first;
-					bool hasLineBeenExecuted = pair.second;
-					
-					fileCoverage.AddLine(lineNumber, hasLineBeenExecuted);
-				}
-			}			
+		// Sorted like CoverageDataMerger::Merge sorts the files.
+		for (const auto& file : module.files_)
+			files.emplace_back(file.first, &file.second);
+		std::sort(files.begin(), files.end(), [](const auto& file1, const auto& file2) {
+			return file1.first < file2.first;
+		});
+
+		for (const auto& file : files)
+		{
+			size_t lineCount = 0;
+
+			file.second->ForEachLine([&](unsigned int, uint32_t) { ++lineCount; });
+			if (!onFile(file.first, lineCount))
+				continue;
+
+			// ForEachLine goes through the lines in order.
+			file.second->ForEachLine([&](unsigned int lineNumber, uint32_t lineStateIndex) {
+				const auto& lineState = module.lineStates_.at(lineStateIndex);
+				auto elapsedCounter = lineState.firstHitCounter_ - startCounter_;
+				auto firstHitTime = lineState.firstHitOrder_
+					? static_cast<uint64_t>(elapsedCounter / counterFrequency_ * 1000000
+						+ elapsedCounter % counterFrequency_ * 1000000 / counterFrequency_)
+					: 0;
+
+				onLine(lineNumber,
+				       lineState.hasBeenExecuted_,
+				       lineState.hitCount_,
+				       lineState.firstHitOrder_,
+				       firstHitTime);
+			});
 		}
+	}
 
-		return coverageData;
+	//-------------------------------------------------------------------------
+	void ExecutedAddressManager::AddModuleCoverage(
+		Plugin::CoverageData& coverageData,
+		const Module& module) const
+	{
+		auto& moduleCoverage = coverageData.AddModule(module.name_);
+		Plugin::FileCoverage* fileCoverage = nullptr;
+		std::vector<Plugin::LineCoverage> lines;
+
+		moduleCoverage.SetIdentity(module.identity_);
+		moduleCoverage.ReserveFiles(module.files_.size());
+		ForEachModuleLine(
+			module,
+			[&](const std::filesystem::path& path, size_t lineCount) {
+				if (fileCoverage)
+					fileCoverage->SetLines(std::move(lines));
+				fileCoverage = &moduleCoverage.AddFile(path);
+				lines.clear();
+				lines.reserve(lineCount);
+				return true;
+			},
+			[&](unsigned int lineNumber, bool hasBeenExecuted, uint64_t hitCount, uint64_t firstHitOrder, uint64_t firstHitTime) {
+				lines.emplace_back(lineNumber, hasBeenExecuted, hitCount, firstHitOrder, firstHitTime);
+			});
+		if (fileCoverage)
+			fileCoverage->SetLines(std::move(lines));
 	}
 
 	//-------------------------------------------------------------------------
-	template <typename Condition>
-	void ExecutedAddressManager::RemoveAddressLineIf(Condition condition)
+	class ExecutedAddressManager::CoverageSource : public ICoverageSource
 	{
-		auto it = addressLineMap_.begin();
+	public:
+		//---------------------------------------------------------------------
+		CoverageSource(const ExecutedAddressManager& manager,
+		               const std::wstring& name,
+		               int exitCode,
+		               bool isSampled)
+			: manager_{ manager }
+			, name_{ name }
+			, exitCode_{ exitCode }
+			, isSampled_{ isSampled }
+		{
+			for (const auto& pair : manager.modules_)
+				modules_.push_back({ pair.first, pair.second.identity_, &pair.second });
+			// The keys of the manager are not sorted like the paths.
+			std::sort(modules_.begin(), modules_.end(), [](const auto& module1, const auto& module2) {
+				return module1.path_ < module2.path_;
+			});
+		}
 
-		while (it != addressLineMap_.end())
+		//---------------------------------------------------------------------
+		const std::wstring& GetName() const override
 		{
-			if (condition(*it))
-				it = addressLineMap_.erase(it);
-			else
-				++it;
+			return name_;
+		}
+
+		//---------------------------------------------------------------------
+		int GetExitCode() const override
+		{
+			return exitCode_;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsSampled() const override
+		{
+			return isSampled_;
 		}
+
+		//---------------------------------------------------------------------
+		size_t GetModuleCount() const override
+		{
+			return modules_.size();
+		}
+
+		//---------------------------------------------------------------------
+		const std::filesystem::path& GetModulePath(size_t moduleIndex) const override
+		{
+			return modules_.at(moduleIndex).path_;
+		}
+
+		//---------------------------------------------------------------------
+		const std::wstring& GetModuleIdentity(size_t moduleIndex) const override
+		{
+			return modules_.at(moduleIndex).identity_;
+		}
+
+		//---------------------------------------------------------------------
+		void VisitModule(size_t moduleIndex, ICoverageFileVisitor& visitor) const override
+		{
+			const auto& module = *modules_.at(moduleIndex).module_;
+			std::unique_ptr<Module> loadedModule;
+
+			manager_.ForEachModuleLine(
+				manager_.GetLoadedModule(module, loadedModule),
+				[&](const std::filesystem::path& path, size_t lineCount) {
+					return visitor.OnFile(path, lineCount);
+				},
+				[&](unsigned int lineNumber, bool hasBeenExecuted, uint64_t hitCount, uint64_t firstHitOrder, uint64_t firstHitTime) {
+					visitor.OnLine(lineNumber, hasBeenExecuted, hitCount, firstHitOrder, firstHitTime);
+				});
+		}
+
+	private:
+		struct SourceModule
+		{
+			std::filesystem::path path_;
+			std::wstring identity_;
+			const Module* module_;
+		};
+
+		const ExecutedAddressManager& manager_;
+		const std::wstring name_;
+		const int exitCode_;
+		const bool isSampled_;
+		std::vector<SourceModule> modules_;
+	};
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<ICoverageSource> ExecutedAddressManager::CreateCoverageSource(
+		const std::wstring& name,
+		int exitCode,
+		bool isSampled) const
+	{
+		return std::make_unique<CoverageSource>(*this, name, exitCode, isSampled);
 	}
 
 	//-------------------------------------------------------------------------
 	void ExecutedAddressManager::OnExitProcess(HANDLE hProcess)
 	{
-		RemoveAddressLineIf([=](const auto& pair)
-		{
-			return pair.first.GetProcessHandle() == hProcess;
-		});
+		addressesByProcess_.erase(hProcess);
+		SpillIdleModules();
 	}
 
 	//-------------------------------------------------------------------------
 	void ExecutedAddressManager::OnUnloadModule(HANDLE hProcess, void* dllBaseOfImage)
 	{
-		RemoveAddressLineIf([=](const auto& pair)
+		auto processAddresses = FindProcessAddresses(hProcess);
+
+		if (processAddresses)
 		{
-			return pair.first.GetProcessHandle() == hProcess
-				&& pair.second.dllBaseOfImage_ == dllBaseOfImage;
-		});
+			auto it = processAddresses->modules_.find(dllBaseOfImage);
+			if (it != processAddresses->modules_.end())
+			{
+				processAddresses->disarmedAddressCount_ -= it->second.disarmedAddresses_.size();
+				processAddresses->modules_.erase(it);
+			}
+		}
+		SpillIdleModules();
 	}
 }
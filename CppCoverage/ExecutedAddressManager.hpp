@@ -20,7 +20,10 @@
 
 #include <Windows.h>
 #include <map>
+#include <memory>
 #include <set>
+#include <utility>
+#include <vector>
 #include <boost/optional.hpp>
 
 #include "Plugin/Exporter/CoverageData.hpp"
@@ -30,6 +33,8 @@ namespace CppCoverage
 {
 	class FileCoverage;
 	class Address;
+	class CoverageSummary;
+	class ICoverageSource;
 
 	class CPPCOVERAGE_DLL ExecutedAddressManager
 	{
@@ -37,8 +42,16 @@ namespace CppCoverage
 		ExecutedAddressManager();
 		~ExecutedAddressManager();
 
-		void AddModule(const std::wstring& moduleName, void* dllBaseOfImage);
+		// identity is written with the coverage of the module when not empty.
+		void AddModule(const std::wstring& moduleName,
+		               void* dllBaseOfImage,
+		               const std::wstring& identity = {});
 		void OnUnloadModule(HANDLE hProcess, void* dllBaseOfImage);
+		// Reserve room for count addresses of the last added module.
+		void ReserveAddresses(HANDLE hProcess, size_t count);
+
+		// Reserve room for the lines of a file of the last added module.
+		void ReserveLines(const std::wstring& filename, unsigned int firstLine, unsigned int lastLine);
 
 		bool RegisterAddress(
 			const Address&,
@@ -46,16 +59,101 @@ namespace CppCoverage
 			unsigned int line,
 			unsigned char instruction);
 
-		boost::optional<unsigned char> MarkAddressAsExecuted(const Address&);
+		// Add hitCount to the hit count of the lines of the address and record
+		// the order and the time of their first hit. The address is then
+		// released unless KeepExecutedAddresses is called.
+		boost::optional<unsigned char> MarkAddressAsExecuted(const Address&,
+		                                                     uint64_t hitCount = 1);
+		// Same as MarkAddressAsExecuted for the count of all the executions of
+		// the address: the hit count of its lines is at least totalHitCount.
+		// The address must be kept with KeepExecutedAddresses to be marked again.
+		boost::optional<unsigned char> MarkAddressTotalHitCount(const Address&,
+		                                                        uint64_t totalHitCount);
+		boost::optional<unsigned char> GetInstructionToRestore(const Address&) const;
+
+		// The breakpoints of the executed addresses can be set again.
+		void KeepExecutedAddresses();
+		// Return true for a released address: another thread can hit its
+		// breakpoint before it is removed.
+		bool IsAddressReleased(const Address&) const;
+
+		// When a line is executed for the first time, release the other
+		// addresses of the line whose lines are all executed. Their
+		// breakpoints must be removed with TakeDisarmedAddresses before the
+		// breakpoints of the process are handled again. Ignored with
+		// KeepExecutedAddresses.
+		void EnableEagerLineDisarm();
+		// The instructions to restore, as passed to BreakPoint::RemoveBreakPoints.
+		std::vector<std::pair<unsigned char, DWORD64>> TakeDisarmedAddresses(HANDLE hProcess);
+
+		// Return true if the line of the last added module has already been
+		// executed, for example by a previous load of the same module.
+		bool IsLineExecuted(const std::wstring& filename, unsigned int line) const;
+
+		// Record the lines marked as executed until TakeRecordedLines is called.
+		using LinesByFile = std::map<std::wstring, std::set<unsigned int>>;
+		void EnableLinesRecording();
+		LinesByFile TakeRecordedLines();
+
+		// Lines registered and lines executed for the first time since the
+		// previous call, for the coverage journal. The cost depends only on
+		// the number of these lines.
+		using LinesByModule = std::map<std::wstring, LinesByFile>;
+		struct JournalLines
+		{
+			LinesByModule registeredLines_;
+			LinesByModule executedLines_;
+		};
+		void EnableJournal();
+		JournalLines TakeJournalLines();
+
+		// Registered addresses of the process not executed yet: their
+		// breakpoint is still set.
+		size_t GetArmedAddressCount(HANDLE hProcess) const;
+		std::vector<Address> GetArmedAddresses(HANDLE hProcess) const;
+		std::vector<Address> GetArmedAddresses(HANDLE hProcess, void* baseOfImage) const;
+
+		// Lines executed at least once.
+		uint64_t GetExecutedLineCount() const;
+
+		// Breakpoints hit on the registered addresses, by module.
+		std::vector<std::pair<std::wstring, uint64_t>> GetHitBreakPointCounts() const;
+
+		// Estimated bytes of the modules, lines and addresses.
+		uint64_t GetMemoryUsage() const;
+
+		// Above this GetMemoryUsage, the files and the lines of the modules
+		// loaded by no process are written to a temporary file when a module
+		// is unloaded or a process exits. They are read again when the module
+		// is loaded again or when the coverage is created. 0 disables it.
+		void SetMemoryBudget(uint64_t bytes);
+		// Modules whose lines are in the temporary file.
+		size_t GetSpilledModuleCount() const;
 
 		Plugin::CoverageData CreateCoverageData(const std::wstring& name, int exitCode) const;
+		// Same as CreateCoverageData but the modules are released as they are
+		// converted: the manager is empty afterwards.
+		Plugin::CoverageData TakeCoverageData(const std::wstring& name, int exitCode);
+		// Executed and unexecuted line counts by module, computed from the
+		// line states without creating the coverage data.
+		CoverageSummary CreateCoverageSummary(const std::wstring& name, int exitCode) const;
+		// Read the lines of the modules as they are visited, without creating
+		// the coverage data. The manager must not change while the source is
+		// used.
+		std::unique_ptr<ICoverageSource> CreateCoverageSource(
+			const std::wstring& name,
+			int exitCode,
+			bool isSampled) const;
 		void OnExitProcess(HANDLE hProcess);
 
 	private:
 		struct Module;
 		struct File;
-		struct File;
-		struct Line;
+		struct LineState;
+		struct ModuleAddresses;
+		struct ProcessAddresses;
+		struct SpillFile;
+		class CoverageSource;
 		struct LastModule
 		{
 			Module* module_;
@@ -65,12 +163,44 @@ namespace CppCoverage
 		ExecutedAddressManager(const ExecutedAddressManager&) = delete;
 		ExecutedAddressManager& operator=(const ExecutedAddressManager&) = delete;
 
+		// Key is the base of image of the module.
+		using ModuleAddressesByBase = std::map<void*, ModuleAddresses>;
+
+		void AddModuleCoverage(Plugin::CoverageData&, const Module&) const;
+		// Call onFile(path, lineCount) for the files sorted by path and, when
+		// it returns true, onLine with the values of Plugin::LineCoverage.
+		template <typename OnFile, typename OnLine>
+		void ForEachModuleLine(const Module&, OnFile onFile, OnLine onLine) const;
+		void LoadSpilledLines(Module&);
+		// The module, or a copy with the spilled lines kept by loadedModule.
+		const Module& GetLoadedModule(const Module&, std::unique_ptr<Module>& loadedModule) const;
+		void SpillIdleModules();
 		Module& GetLastAddedModule();
-		template <typename F>
-		void RemoveAddressLineIf(F fct);
+		ProcessAddresses& GetProcessAddresses(HANDLE hProcess);
+		ProcessAddresses* FindProcessAddresses(HANDLE hProcess);
+		const ProcessAddresses* FindProcessAddresses(HANDLE hProcess) const;
+		ModuleAddresses& GetLastAddedModuleAddresses(ProcessAddresses&);
+		ModuleAddresses* FindModuleAddresses(ProcessAddresses&, const Address&);
+		boost::optional<unsigned char> MarkAddress(const Address&,
+		                                           uint64_t hitCount,
+		                                           bool isTotalHitCount);
+		// Release the armed addresses of the lines of the executed address
+		// whose lines are all executed and return their count.
+		size_t DisarmOtherAddresses(ModuleAddresses&, uint32_t executedRva);
+		const ModuleAddresses* FindModuleAddresses(const ProcessAddresses&, const Address&) const;
 
 		std::map<std::wstring, Module> modules_;
-		std::map<Address, Line> addressLineMap_;
 		LastModule lastModule_;
+		std::unique_ptr<SpillFile> spillFile_;
+		std::map<HANDLE, ProcessAddresses> addressesByProcess_;
+		boost::optional<std::vector<const LineState*>> recordedLineStates_;
+		bool keepExecutedAddresses_;
+		bool isJournalEnabled_;
+		bool isEagerLineDisarmEnabled_;
+		uint64_t memoryBudget_;
+		uint64_t firstHitCount_;
+		// QueryPerformanceCounter values.
+		int64_t startCounter_;
+		int64_t counterFrequency_;
 	};
 }
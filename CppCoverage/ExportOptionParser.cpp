@@ -106,6 +106,13 @@ namespace CppCoverage
 	const std::string ExportOptionParser::ExportTypeCoberturaValue =
 	    "cobertura";
 	const std::string ExportOptionParser::ExportTypeBinaryValue = "binary";
+	const std::string ExportOptionParser::ExportTypeFirstHitsValue = "first_hits";
+	const std::string ExportOptionParser::ExportTypeCompactHtmlValue = "compact_html";
+	const std::string ExportOptionParser::ExportTypeSummaryValue = "summary";
+	const std::string ExportOptionParser::ExportTypeLcovValue = "lcov";
+	const std::string ExportOptionParser::ExportTypeAggregatorValue = "aggregator";
+	const std::string ExportOptionParser::ExportTypeParquetValue = "parquet";
+	const std::string ExportOptionParser::ExportTypeDiffHtmlValue = "diff_html";
 
 	//-------------------------------------------------------------------------
 	ExportOptionParser::ExportOptionParser(
@@ -121,6 +128,27 @@ namespace CppCoverage
 		exportTypes_.emplace(
 		    Tools::LocalToWString(ExportOptionParser::ExportTypeBinaryValue),
 		    OptionsExportType::Binary);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeFirstHitsValue),
+		    OptionsExportType::FirstHits);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeCompactHtmlValue),
+		    OptionsExportType::CompactHtml);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeSummaryValue),
+		    OptionsExportType::Summary);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeLcovValue),
+		    OptionsExportType::Lcov);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeAggregatorValue),
+		    OptionsExportType::Aggregator);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeParquetValue),
+		    OptionsExportType::Parquet);
+		exportTypes_.emplace(
+		    Tools::LocalToWString(ExportOptionParser::ExportTypeDiffHtmlValue),
+		    OptionsExportType::DiffHtml);
 	}
 
 	//----------------------------------------------------------------------------
@@ -172,7 +200,21 @@ namespace CppCoverage
 		          ExportOptionParser::ExportTypeCoberturaValue),
 		      L"output file (optional)"},
 		     {Tools::LocalToWString(ExportOptionParser::ExportTypeBinaryValue),
-		      L"output file (optional)"}};
+		      L"output file (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeFirstHitsValue),
+		      L"output file of the executed lines sorted by first hit (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeCompactHtmlValue),
+		      L"output folder of the single page report (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeSummaryValue),
+		      L"output JSON file of the line rates by module (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeLcovValue),
+		      L"output LCOV tracefile (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeAggregatorValue),
+		      L"named pipe \\\\<server>\\pipe\\<name> of the --aggregator receiving the coverage (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeParquetValue),
+		      L"output Parquet file with one row by line: run, module, file, line, executed (optional)"},
+		     {Tools::LocalToWString(ExportOptionParser::ExportTypeDiffHtmlValue),
+		      L"output HTML file of the hunks of the --unified_diff changed lines (optional)"}};
 		for (const auto& description : exportPluginDescriptions_)
 		{
 			exportArgumentInfos.push_back(
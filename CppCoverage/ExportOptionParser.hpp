@@ -33,6 +33,13 @@ namespace CppCoverage
 		static const std::string ExportTypeHtmlValue;
 		static const std::string ExportTypeCoberturaValue;
 		static const std::string ExportTypeBinaryValue;
+		static const std::string ExportTypeFirstHitsValue;
+		static const std::string ExportTypeCompactHtmlValue;
+		static const std::string ExportTypeSummaryValue;
+		static const std::string ExportTypeLcovValue;
+		static const std::string ExportTypeAggregatorValue;
+		static const std::string ExportTypeParquetValue;
+		static const std::string ExportTypeDiffHtmlValue;
 
 		explicit ExportOptionParser(std::vector<ExportPluginDescription>&&);
 
@@ -0,0 +1,166 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "FuzzingBitmap.hpp"
+
+#include <cstring>
+
+#include "Tools/Fnv1a.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	FuzzingBitmap::Marker
+	FuzzingBitmap::ParseMarker(const std::wstring& debugString)
+	{
+		auto end = debugString.find_last_not_of(L"\r\n");
+		auto marker = debugString.substr(0, end == std::wstring::npos ? 0 : end + 1);
+
+		if (marker == FuzzingBitmapFormat::IterationMarker)
+			return Marker::Iteration;
+		if (marker == FuzzingBitmapFormat::EpochMarker)
+			return Marker::Epoch;
+		return Marker::None;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring FuzzingBitmap::GetSectionName(DWORD processId)
+	{
+		return L"Local\\OpenCppCoverage.Fuzzing." + std::to_wstring(processId);
+	}
+
+	//-------------------------------------------------------------------------
+	FuzzingBitmap::FuzzingBitmap(uint32_t bitCount)
+	    : hMapping_{nullptr}, header_{nullptr}, iterationHitCount_{0}
+	{
+		auto sectionSize = FuzzingBitmapFormat::GetSectionSize(bitCount);
+		auto sectionName = GetSectionName(GetCurrentProcessId());
+
+		hMapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE,
+		                               nullptr,
+		                               PAGE_READWRITE,
+		                               0,
+		                               static_cast<DWORD>(sectionSize),
+		                               sectionName.c_str());
+		auto error = GetLastError();
+		void* view = nullptr;
+
+		// The fuzzer reads the bitmap: the coverage is useless without it. A
+		// section left by a previous run could have another size.
+		if (hMapping_ && error != ERROR_ALREADY_EXISTS)
+		{
+			view = MapViewOfFile(hMapping_, FILE_MAP_WRITE, 0, 0, sectionSize);
+			error = GetLastError();
+		}
+		if (!view)
+		{
+			if (hMapping_)
+				CloseHandle(hMapping_);
+			THROW_LAST_ERROR(L"Cannot publish the fuzzing bitmap " << sectionName << L": ", error);
+		}
+		header_ = static_cast<FuzzingBitmapFormat::Header*>(view);
+		sectionName_ = sectionName;
+		std::memset(header_, 0, sectionSize);
+		header_->version_ = FuzzingBitmapFormat::Version;
+		header_->bitCount_ = bitCount;
+	}
+
+	//-------------------------------------------------------------------------
+	FuzzingBitmap::~FuzzingBitmap()
+	{
+		UnmapViewOfFile(header_);
+		CloseHandle(hMapping_);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring& FuzzingBitmap::GetPublishedSectionName() const
+	{
+		return sectionName_;
+	}
+
+	//-------------------------------------------------------------------------
+	void FuzzingBitmap::OnHit(const Address& address)
+	{
+		auto bitIndex = GetBitIndex(address);
+
+		GetBitmap()[bitIndex / 8] |= static_cast<uint8_t>(1 << (bitIndex % 8));
+		++iterationHitCount_;
+		epochAddresses_[address.GetProcessHandle()].push_back(
+		    reinterpret_cast<DWORD64>(address.GetValue()));
+	}
+
+	//-------------------------------------------------------------------------
+	void FuzzingBitmap::OnIterationEnd()
+	{
+		++header_->iterationCount_;
+		header_->newHitCount_ = iterationHitCount_;
+		header_->epochHitCount_ += iterationHitCount_;
+		iterationHitCount_ = 0;
+	}
+
+	//-------------------------------------------------------------------------
+	void FuzzingBitmap::OnExitProcess(HANDLE hProcess)
+	{
+		epochAddresses_.erase(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	std::map<HANDLE, std::vector<DWORD64>> FuzzingBitmap::OnEpoch()
+	{
+		std::memset(GetBitmap(), 0, header_->bitCount_ / 8);
+		++header_->epochCount_;
+		header_->newHitCount_ = 0;
+		header_->epochHitCount_ = 0;
+		iterationHitCount_ = 0;
+
+		auto addresses = std::move(epochAddresses_);
+		epochAddresses_.clear();
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	const FuzzingBitmapFormat::Header& FuzzingBitmap::GetHeader() const
+	{
+		return *header_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool FuzzingBitmap::IsBitSet(const Address& address) const
+	{
+		auto bitIndex = GetBitIndex(address);
+		return (GetBitmap()[bitIndex / 8] & (1 << (bitIndex % 8))) != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t FuzzingBitmap::GetBitIndex(const Address& address) const
+	{
+		// The process is not hashed: the same module has the same addresses
+		// in the children.
+		auto addressValue = reinterpret_cast<DWORD64>(address.GetValue());
+		auto hash = Tools::Fnv1a(Tools::Fnv1aOffsetBasis, &addressValue, sizeof(addressValue));
+		return static_cast<size_t>(hash % header_->bitCount_);
+	}
+
+	//-------------------------------------------------------------------------
+	uint8_t* FuzzingBitmap::GetBitmap() const
+	{
+		return reinterpret_cast<uint8_t*>(header_ + 1);
+	}
+}
@@ -0,0 +1,77 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+#include "FuzzingBitmapFormat.hpp"
+
+namespace CppCoverage
+{
+	// Signal the new coverage of each iteration of --fuzz. A breakpoint is
+	// removed when it is hit so each hit is a new address for the epoch: the
+	// cost of an iteration only depends on the coverage it finds. The bitmap
+	// is published in a shared memory section (see FuzzingBitmapFormat).
+	class CPPCOVERAGE_DLL FuzzingBitmap
+	{
+	  public:
+		enum class Marker
+		{
+			None,
+			Iteration,
+			Epoch
+		};
+
+		// Trailing new line characters are ignored.
+		static Marker ParseMarker(const std::wstring& debugString);
+		static std::wstring GetSectionName(DWORD processId);
+
+		// Throw if the section cannot be created.
+		explicit FuzzingBitmap(uint32_t bitCount = FuzzingBitmapFormat::BitCount);
+		~FuzzingBitmap();
+
+		const std::wstring& GetPublishedSectionName() const;
+
+		void OnHit(const Address&);
+		void OnIterationEnd();
+		void OnExitProcess(HANDLE hProcess);
+
+		// Return the addresses hit during the epoch to arm again.
+		std::map<HANDLE, std::vector<DWORD64>> OnEpoch();
+
+		const FuzzingBitmapFormat::Header& GetHeader() const;
+		bool IsBitSet(const Address&) const;
+
+	  private:
+		FuzzingBitmap(const FuzzingBitmap&) = delete;
+		FuzzingBitmap& operator=(const FuzzingBitmap&) = delete;
+
+		size_t GetBitIndex(const Address&) const;
+		uint8_t* GetBitmap() const;
+
+		HANDLE hMapping_;
+		FuzzingBitmapFormat::Header* header_;
+		std::wstring sectionName_;
+		uint64_t iterationHitCount_;
+		std::map<HANDLE, std::vector<DWORD64>> epochAddresses_;
+	};
+}
@@ -0,0 +1,59 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace CppCoverage
+{
+	// Layout of the shared memory section published by --fuzz. The debuggee
+	// finds the section name in the SectionVariable environment variable and
+	// reads it after each iteration marker: the debugger updates the section
+	// before continuing the debug event so no synchronization is needed. The
+	// section contains a Header followed by bitCount_ / 8 bytes. A bit is set
+	// when a breakpoint whose address hashes to its index is hit during the
+	// current epoch.
+	// This header has no dependency so it can be included by the fuzzed program.
+	namespace FuzzingBitmapFormat
+	{
+		const uint32_t Version = 1;
+		const uint32_t BitCount = 64 * 1024 * 8;
+		const wchar_t* const SectionVariable = L"OPENCPPCOVERAGE_FUZZING_SECTION";
+		const wchar_t* const IterationMarker = L"OpenCppCoverage: fuzzing iteration";
+		const wchar_t* const EpochMarker = L"OpenCppCoverage: fuzzing epoch";
+
+		struct Header
+		{
+			uint32_t version_;
+			uint32_t bitCount_;
+			uint64_t iterationCount_;
+			uint64_t epochCount_;
+			// Breakpoints hit for the first time of the epoch by the last iteration.
+			uint64_t newHitCount_;
+			// Breakpoints hit since the beginning of the epoch.
+			uint64_t epochHitCount_;
+		};
+
+		//---------------------------------------------------------------------
+		inline size_t GetSectionSize(uint32_t bitCount)
+		{
+			return sizeof(Header) + bitCount / 8;
+		}
+	}
+}
@@ -0,0 +1,122 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <Windows.h>
+
+#include "FuzzingBitmapFormat.hpp"
+
+namespace CppCoverage
+{
+	// Persistent loop helper for the fuzzed program. Each iteration calls the
+	// target in the same process and costs one debug event instead of a
+	// process start:
+	//
+	//   CppCoverage::FuzzingHarness harness;
+	//   while (NextInput(input))
+	//   {
+	//       if (harness.RunIteration([&]() { Target(input); }))
+	//           KeepInCorpus(input);
+	//   }
+	//
+	// Without --fuzz, the target is called and nothing is reported.
+	// This header is header only so the fuzzed program does not link with
+	// OpenCppCoverage.
+	class FuzzingHarness
+	{
+	  public:
+		//---------------------------------------------------------------------
+		FuzzingHarness() : hMapping_{nullptr}, header_{nullptr}
+		{
+			wchar_t sectionName[MAX_PATH];
+			auto size = GetEnvironmentVariableW(FuzzingBitmapFormat::SectionVariable, sectionName, MAX_PATH);
+
+			if (size == 0 || size >= MAX_PATH)
+				return;
+			hMapping_ = OpenFileMappingW(FILE_MAP_READ, FALSE, sectionName);
+			if (!hMapping_)
+				return;
+			auto view = MapViewOfFile(hMapping_, FILE_MAP_READ, 0, 0, 0);
+			header_ = static_cast<const FuzzingBitmapFormat::Header*>(view);
+			if (header_ && header_->version_ != FuzzingBitmapFormat::Version)
+			{
+				UnmapViewOfFile(view);
+				header_ = nullptr;
+			}
+		}
+
+		//---------------------------------------------------------------------
+		~FuzzingHarness()
+		{
+			if (header_)
+				UnmapViewOfFile(header_);
+			if (hMapping_)
+				CloseHandle(hMapping_);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsConnected() const
+		{
+			return header_ != nullptr;
+		}
+
+		//---------------------------------------------------------------------
+		// Return the number of breakpoints hit for the first time of the
+		// epoch by the target.
+		template <typename Target>
+		uint64_t RunIteration(Target target)
+		{
+			target();
+			if (!header_)
+				return 0;
+			OutputDebugStringW(FuzzingBitmapFormat::IterationMarker);
+			return header_->newHitCount_;
+		}
+
+		//---------------------------------------------------------------------
+		// Clear the bitmap and arm again the breakpoints hit during the epoch,
+		// for example when a new corpus is started.
+		void StartEpoch()
+		{
+			if (header_)
+				OutputDebugStringW(FuzzingBitmapFormat::EpochMarker);
+		}
+
+		//---------------------------------------------------------------------
+		const FuzzingBitmapFormat::Header* GetHeader() const
+		{
+			return header_;
+		}
+
+		//---------------------------------------------------------------------
+		const uint8_t* GetBitmap() const
+		{
+			return header_ ? reinterpret_cast<const uint8_t*>(header_ + 1) : nullptr;
+		}
+
+	  private:
+		FuzzingHarness(const FuzzingHarness&) = delete;
+		FuzzingHarness& operator=(const FuzzingHarness&) = delete;
+
+		HANDLE hMapping_;
+		const FuzzingBitmapFormat::Header* header_;
+	};
+}
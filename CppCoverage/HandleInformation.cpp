@@ -117,6 +117,28 @@ namespace CppCoverage
 
 			return GetMappedFileNameStr(hfile);
 		}
+
+		//-------------------------------------------------------------------------
+		// The drive letter path without asking each drive for its device name.
+		boost::optional<std::wstring> GetFinalDosPathName(HANDLE hfile)
+		{
+			const std::wstring longPathPrefix = L"\\\\?\\";
+			const std::wstring uncPrefix = longPathPrefix + L"UNC\\";
+			std::vector<wchar_t> buffer(PathBufferSize);
+
+			if (!GetFinalPathNameByHandle(
+				hfile, &buffer[0], static_cast<int>(buffer.size()) - 1, VOLUME_NAME_DOS))
+			{
+				return boost::none;
+			}
+
+			std::wstring path = &buffer[0];
+			if (boost::algorithm::starts_with(path, uncPrefix))
+				return L"\\\\" + path.substr(uncPrefix.size());
+			if (boost::algorithm::starts_with(path, longPathPrefix))
+				return path.substr(longPathPrefix.size());
+			return path;
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -134,21 +156,38 @@ namespace CppCoverage
 			      L"module for more information.");
 		}
 
+		if (auto dosPathName = GetFinalDosPathName(hfile))
+			return *dosPathName;
+
 		auto mappedFileName = GetFinalPathName(hfile);
-		auto queryDosDevicesMapping = GetQueryDosDevicesMapping();
+		auto filename = ReplaceDeviceName(mappedFileName);
 
-		for (const auto& queryDosDeviceMapping : queryDosDevicesMapping)
+		if (!filename)
+		{
+			queryDosDevicesMapping_.reset();
+			filename = ReplaceDeviceName(mappedFileName);
+		}
+		if (!filename)
+			THROW(L"Cannot find path for the handle: " << mappedFileName);
+		return *filename;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::wstring> HandleInformation::ReplaceDeviceName(
+		const std::wstring& mappedFileName) const
+	{
+		if (!queryDosDevicesMapping_)
+			queryDosDevicesMapping_ = GetQueryDosDevicesMapping();
+
+		for (const auto& queryDosDeviceMapping : *queryDosDevicesMapping_)
 		{
 			const auto& deviceName = queryDosDeviceMapping.first;
 			const auto& logicalDrive = queryDosDeviceMapping.second;
 
 			if (boost::algorithm::istarts_with(mappedFileName, deviceName))
-			{
-				boost::algorithm::ireplace_first(mappedFileName, deviceName, logicalDrive);
-				return mappedFileName;
-			}
+				return boost::algorithm::ireplace_first_copy(mappedFileName, deviceName, logicalDrive);
 		}
 
-		THROW(L"Cannot find path for the handle: " << mappedFileName);
+		return boost::none;
 	}
 }
@@ -17,6 +17,10 @@
 #pragma once
 
 #include <Windows.h>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/optional.hpp>
 
 #include "CppCoverageExport.hpp"
 
@@ -31,6 +35,13 @@ namespace CppCoverage
 	private:
 		HandleInformation(const HandleInformation&) = delete;
 		HandleInformation& operator=(const HandleInformation&) = delete;
+
+		boost::optional<std::wstring> ReplaceDeviceName(const std::wstring& mappedFileName) const;
+
+		using QueryDosDevicesMapping = std::vector<std::pair<std::wstring, std::wstring>>;
+		// Computed on the first module which has no DOS path, and again when a
+		// device is not found in case a drive was added since.
+		mutable boost::optional<QueryDosDevicesMapping> queryDosDevicesMapping_;
 	};
 }
 
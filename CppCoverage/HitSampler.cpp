@@ -0,0 +1,153 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "HitSampler.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const auto SmallWindow = std::chrono::milliseconds{100};
+		const size_t SmallWindowsBySecond = 10;
+		const int PendingWindowCount = 10;
+
+		//---------------------------------------------------------------------
+		HitSampler::Clock::duration GetWindow(size_t trapsPerSecond)
+		{
+			// A budget lower than one trap by window cannot be respected.
+			if (trapsPerSecond < SmallWindowsBySecond)
+				return std::chrono::seconds{1};
+			return SmallWindow;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetBudgetByWindow(size_t trapsPerSecond)
+		{
+			if (trapsPerSecond < SmallWindowsBySecond)
+				return trapsPerSecond;
+			return trapsPerSecond / SmallWindowsBySecond;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	HitSampler::HitSampler(size_t trapsPerSecond, Clock::time_point start)
+	    : window_{GetWindow(trapsPerSecond)},
+	      budgetByWindow_{GetBudgetByWindow(trapsPerSecond)},
+	      windowStart_{start},
+	      armedCount_{0},
+	      sampledHitCount_{0}
+	{
+		if (!trapsPerSecond)
+			THROW("The number of traps by second must be greater than 0.");
+	}
+
+	//-------------------------------------------------------------------------
+	void HitSampler::OnHit(const Address& address)
+	{
+		if (pendingAddresses_.erase(address))
+			++sampledHitCount_;
+
+		// The address goes to the end of the rotation.
+		candidates_.push_back(address);
+	}
+
+	//-------------------------------------------------------------------------
+	HitSampler::Plan HitSampler::ComputePlan(Clock::time_point now)
+	{
+		Plan plan;
+
+		if (now - windowStart_ < window_)
+			return plan;
+		windowStart_ = now;
+
+		for (auto it = pendingAddresses_.begin(); it != pendingAddresses_.end();)
+		{
+			if (now - it->second >= window_ * PendingWindowCount)
+			{
+				plan.addressesToDisarm_.push_back(it->first);
+				it = pendingAddresses_.erase(it);
+			}
+			else
+				++it;
+		}
+
+		// Breakpoints armed during the previous windows and not hit yet
+		// can still be hit during this window.
+		while (pendingAddresses_.size() < budgetByWindow_ && !candidates_.empty())
+		{
+			const auto& address = candidates_.front();
+
+			pendingAddresses_.emplace(address, now);
+			plan.addressesToArm_.push_back(address);
+			candidates_.pop_front();
+		}
+		armedCount_ += plan.addressesToArm_.size();
+
+		// Disarmed addresses go to the end of the rotation.
+		for (const auto& address : plan.addressesToDisarm_)
+			candidates_.push_back(address);
+
+		return plan;
+	}
+
+	//-------------------------------------------------------------------------
+	void HitSampler::Remove(const Address& address)
+	{
+		pendingAddresses_.erase(address);
+	}
+
+	//-------------------------------------------------------------------------
+	void HitSampler::OnExitProcess(HANDLE hProcess)
+	{
+		std::deque<Address> candidates;
+
+		for (const auto& address : candidates_)
+		{
+			if (address.GetProcessHandle() != hProcess)
+				candidates.push_back(address);
+		}
+		candidates_.swap(candidates);
+
+		for (auto it = pendingAddresses_.begin(); it != pendingAddresses_.end();)
+		{
+			if (it->first.GetProcessHandle() == hProcess)
+				it = pendingAddresses_.erase(it);
+			else
+				++it;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	HitSampler::Clock::duration HitSampler::GetWindow() const
+	{
+		return window_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t HitSampler::GetArmedCount() const
+	{
+		return armedCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t HitSampler::GetSampledHitCount() const
+	{
+		return sampledHitCount_;
+	}
+}
@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <vector>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Choose the breakpoints to set again after they have been hit, so the
+	// hit counts can be estimated. The breakpoints are re-armed by window and
+	// at most trapsPerSecond * window of them can be pending, so re-armed
+	// breakpoints cannot be hit more than trapsPerSecond times per second.
+	// Pending breakpoints not hit after several windows are disarmed to
+	// give their budget to other addresses.
+	class CPPCOVERAGE_DLL HitSampler
+	{
+	  public:
+		using Clock = std::chrono::steady_clock;
+
+		HitSampler(size_t trapsPerSecond, Clock::time_point start);
+
+		struct Plan
+		{
+			std::vector<Address> addressesToArm_;
+			std::vector<Address> addressesToDisarm_;
+		};
+
+		// The address must not have a breakpoint anymore.
+		void OnHit(const Address&);
+		Plan ComputePlan(Clock::time_point now);
+		// The address cannot be armed anymore, for example because its module
+		// is unloaded.
+		void Remove(const Address&);
+		void OnExitProcess(HANDLE hProcess);
+
+		Clock::duration GetWindow() const;
+		size_t GetArmedCount() const;
+		size_t GetSampledHitCount() const;
+
+	  private:
+		HitSampler(const HitSampler&) = delete;
+		HitSampler& operator=(const HitSampler&) = delete;
+
+		const Clock::duration window_;
+		const size_t budgetByWindow_;
+		Clock::time_point windowStart_;
+		std::deque<Address> candidates_;
+		std::map<Address, Clock::time_point> pendingAddresses_;
+		size_t armedCount_;
+		size_t sampledHitCount_;
+	};
+}
@@ -0,0 +1,46 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+
+namespace CppCoverage
+{
+	// A part of the pages of an HTML report so several machines can render the
+	// same report from the same coverage in a shared folder. The shards 1 to
+	// count render the source and module pages. The index shard renders the
+	// project page and copies the third-party files.
+	struct HtmlShard
+	{
+		//---------------------------------------------------------------------
+		bool IsIndex() const
+		{
+			return count_ == 0;
+		}
+
+		//---------------------------------------------------------------------
+		// The pages are numbered in the order of the report.
+		bool ContainsPage(size_t pageIndex) const
+		{
+			return !IsIndex() && pageIndex % count_ + 1 == index_;
+		}
+
+		// From 1 to count_, 0 for the index shard.
+		size_t index_ = 0;
+		size_t count_ = 0;
+	};
+}
@@ -17,7 +17,10 @@
 #pragma once
 
 #include "CppCoverageExport.hpp"
+#include <set>
 #include <string>
+#include <vector>
+#include <boost/optional.hpp>
 
 namespace FileFilter
 {
@@ -41,6 +44,24 @@ namespace CppCoverage
 			const FileFilter::ModuleInfo&,
 			const FileFilter::FileInfo&,
 			const FileFilter::LineInfo&) = 0;
+		// IsLineSelected for each line of the file, with the checks which
+		// do not depend on the line done once.
+		virtual std::vector<bool> SelectLines(
+			const FileFilter::ModuleInfo&,
+			const FileFilter::FileInfo&) = 0;
+
+		// The only line numbers IsLineSelected can select in a selected source
+		// file, boost::none when it can select any line.
+		virtual boost::optional<std::set<int>> GetSelectedLineNumbers(const std::wstring&)
+		{
+			return boost::none;
+		}
+
+		// Called before the lines of these source files are selected: the
+		// work which does not depend on the module can be done in parallel.
+		virtual void PrefetchSourceFiles(const std::vector<std::wstring>&)
+		{
+		}
 	};
 }
 
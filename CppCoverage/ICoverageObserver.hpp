@@ -0,0 +1,49 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+
+namespace CppCoverage
+{
+	struct CoverageProgress
+	{
+		size_t loadedModuleCount_ = 0;
+		// Loaded modules with selected lines.
+		size_t monitoredModuleCount_ = 0;
+		uint64_t executedLineCount_ = 0;
+		std::chrono::steady_clock::duration elapsedTime_{};
+	};
+
+	// Notified by CodeCoverageRunner while the program runs to embed the
+	// coverage in another application. The methods are called from the debug
+	// loop thread: the program is stopped until they return.
+	class ICoverageObserver
+	{
+	  public:
+		virtual ~ICoverageObserver() = default;
+
+		// Called after the lines of the module are registered. isMonitored is
+		// false when the module has no selected line.
+		virtual void OnModuleLoaded(const std::filesystem::path& modulePath, bool isMonitored) = 0;
+
+		// Called every second and once when the program exits.
+		virtual void OnProgress(const CoverageProgress&) = 0;
+	};
+}
@@ -0,0 +1,60 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace CppCoverage
+{
+	// Receive the files of a module and their lines from ICoverageSource.
+	class ICoverageFileVisitor
+	{
+	public:
+		virtual ~ICoverageFileVisitor() = default;
+
+		// lineCount lines of the file are visited next unless false is returned.
+		virtual bool OnFile(const std::filesystem::path&, size_t lineCount) = 0;
+		// The lines are visited by increasing line number, with the values of
+		// Plugin::LineCoverage.
+		virtual void OnLine(unsigned int lineNumber,
+		                    bool hasBeenExecuted,
+		                    uint64_t hitCount,
+		                    uint64_t firstHitOrder,
+		                    uint64_t firstHitTime) = 0;
+	};
+
+	// Coverage of a run read module by module without creating a
+	// Plugin::CoverageData. The modules and their files are sorted by path
+	// like after CoverageDataMerger::Merge.
+	class ICoverageSource
+	{
+	public:
+		virtual ~ICoverageSource() = default;
+
+		virtual const std::wstring& GetName() const = 0;
+		virtual int GetExitCode() const = 0;
+		virtual bool IsSampled() const = 0;
+
+		virtual size_t GetModuleCount() const = 0;
+		virtual const std::filesystem::path& GetModulePath(size_t moduleIndex) const = 0;
+		virtual const std::wstring& GetModuleIdentity(size_t moduleIndex) const = 0;
+		// Can be called from several threads for different modules.
+		virtual void VisitModule(size_t moduleIndex, ICoverageFileVisitor&) const = 0;
+	};
+}
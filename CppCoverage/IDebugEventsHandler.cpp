@@ -34,6 +34,18 @@ namespace CppCoverage
 	{
 	}
 
+	//-------------------------------------------------------------------------
+	bool IDebugEventsHandler::PostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&)
+	{
+		return false;
+	}
+
+	//-------------------------------------------------------------------------
+	void IDebugEventsHandler::CancelPostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&)
+	{
+		ResumeThread(hThread);
+	}
+
 	//-------------------------------------------------------------------------
 	void IDebugEventsHandler::OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&)
 	{
@@ -44,4 +56,25 @@ namespace CppCoverage
 	{ 
 		return IDebugEventsHandler::ExceptionType::NotHandled;
 	}
+
+	//-------------------------------------------------------------------------
+	void IDebugEventsHandler::OnTimer()
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void IDebugEventsHandler::OnOutputDebugString(HANDLE hProcess, HANDLE hThread, const std::wstring&)
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	bool IDebugEventsHandler::PrepareDetach(HANDLE hProcess)
+	{
+		return false;
+	}
+
+	//-------------------------------------------------------------------------
+	void IDebugEventsHandler::OnDetachProcess(HANDLE hProcess)
+	{
+	}
 }
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <Windows.h>
+#include <string>
 
 #include "CppCoverageExport.hpp"
 
@@ -40,8 +41,25 @@ namespace CppCoverage
 		virtual void OnCreateProcess(const CREATE_PROCESS_DEBUG_INFO&);
 		virtual void OnExitProcess(HANDLE hProcess, HANDLE hThread, const EXIT_PROCESS_DEBUG_INFO&);
 		virtual void OnLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&);
+		// Called after OnLoadDll. Return true after suspending hThread to postpone
+		// the event with DBG_REPLY_LATER: the other threads keep running. The event
+		// is reported again once the handler resumes hThread.
+		virtual bool PostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&);
+		// Called when DBG_REPLY_LATER is not supported after PostponeLoadDll returned
+		// true: hThread must be resumed and the event is not reported again.
+		virtual void CancelPostponeLoadDll(HANDLE hProcess, HANDLE hThread, const LOAD_DLL_DEBUG_INFO&);
 		virtual void OnUnloadDll(HANDLE hProcess, HANDLE hThread, const UNLOAD_DLL_DEBUG_INFO&);
 		virtual ExceptionType OnException(HANDLE hProcess, HANDLE hThread, const EXCEPTION_DEBUG_INFO&);
+		// Called at least every timer period when Debugger::SetTimerPeriod is used.
+		// The debugged processes are running.
+		virtual void OnTimer();
+		virtual void OnOutputDebugString(HANDLE hProcess, HANDLE hThread, const std::wstring&);
+		// Called after each debug event of the process and on timer. Return true
+		// to detach the debugger from the process: all the breakpoints must have been
+		// removed. OnDetachProcess is called once the pending events are handled.
+		virtual bool PrepareDetach(HANDLE hProcess);
+		// The process keeps running but its events are not reported anymore.
+		virtual void OnDetachProcess(HANDLE hProcess);
 		
 	private:
 		IDebugEventsHandler(const IDebugEventsHandler&) = delete;
@@ -0,0 +1,1190 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ImageInstrumenter.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <boost/optional/optional.hpp>
+
+#include "CoverageRuntime/RuntimeSharedData.hpp"
+
+#include "Tools/Log.hpp"
+#include "Tools/Tool.hpp"
+
+#include "BasicBlockAnalyzer.hpp"
+#include "CppCoverageException.hpp"
+#include "InstructionDecoder.hpp"
+#include "ModuleLineTable.hpp"
+#include "TrampolineBuilder.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const char CodeSectionName[] = ".covtxt";
+		const WORD AddedSectionCount = 2;
+
+		// jmp [import address of the TLS callback of CoverageRuntime.dll]
+		const uint8_t TlsStub[] = {0xFF, 0x25, 0, 0, 0, 0};
+		const size_t TlsStubTargetOffset = 2;
+
+		// See UNWIND_INFO in the x64 exception handling documentation.
+		const uint8_t UnwindVersion = 1;
+		const uint8_t UnwindFlagExceptionHandler = 1;
+		const uint8_t UnwindFlagTerminationHandler = 2;
+		const uint8_t UnwindFlagChainInfo = 4;
+		const uint32_t RuntimeFunctionIndirection = 1;
+		const int MaxUnwindChainLength = 32;
+
+		//---------------------------------------------------------------------
+		struct RuntimeFunction
+		{
+			uint32_t beginAddress_;
+			uint32_t endAddress_;
+			uint32_t unwindData_;
+		};
+
+		//---------------------------------------------------------------------
+		struct Relocation
+		{
+			WORD type_;
+			// Offset of the entry in the relocation directory.
+			size_t entryOffset_;
+		};
+
+		//---------------------------------------------------------------------
+		struct Site
+		{
+			uint32_t rva_;
+			size_t displacedSize_;
+			// The RVA where the counter is incremented and the index of its
+			// line in the line table.
+			std::vector<std::pair<uint32_t, size_t>> counters_;
+			// The function of the site in 64 bits, none for a leaf function.
+			boost::optional<RuntimeFunction> function_;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		T AlignUp(T value, T alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		//---------------------------------------------------------------------
+		void CheckRange(const std::vector<uint8_t>& data, size_t offset, size_t size)
+		{
+			if (offset > data.size() || data.size() - offset < size)
+				THROW(L"Invalid image: offset " << offset << L" is outside of the file.");
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		T Read(const std::vector<uint8_t>& data, size_t offset)
+		{
+			T value;
+
+			CheckRange(data, offset, sizeof(T));
+			std::memcpy(&value, &data[offset], sizeof(T));
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void Write(std::vector<uint8_t>& data, size_t offset, const T& value)
+		{
+			CheckRange(data, offset, sizeof(T));
+			std::memcpy(&data[offset], &value, sizeof(T));
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		size_t Append(std::vector<uint8_t>& data, const T& value)
+		{
+			auto offset = data.size();
+
+			data.resize(offset + sizeof(T));
+			std::memcpy(&data[offset], &value, sizeof(T));
+			return offset;
+		}
+
+		//---------------------------------------------------------------------
+		void AlignSize(std::vector<uint8_t>& data, size_t alignment)
+		{
+			data.resize(AlignUp(data.size(), alignment));
+		}
+
+		//---------------------------------------------------------------------
+		uint32_t ComputeCheckSum(const std::vector<uint8_t>& file)
+		{
+			uint64_t sum = 0;
+
+			for (size_t i = 0; i < file.size(); i += 2)
+			{
+				sum += file[i];
+				if (i + 1 < file.size())
+					sum += static_cast<uint64_t>(file[i + 1]) << 8;
+				sum = (sum & 0xFFFF) + (sum >> 16);
+			}
+			sum = (sum & 0xFFFF) + (sum >> 16);
+			return static_cast<uint32_t>(sum + file.size());
+		}
+
+		//---------------------------------------------------------------------
+		class Image
+		{
+			// The headers of 32 and 64 bits have the same fields with different
+			// offsets.
+			//-----------------------------------------------------------------
+			template <typename F>
+			decltype(auto) OnOptionalHeader(F f)
+			{
+				return is64Bits_ ? f(optionalHeader64_) : f(optionalHeader32_);
+			}
+
+			//-----------------------------------------------------------------
+			template <typename F>
+			decltype(auto) OnOptionalHeader(F f) const
+			{
+				return is64Bits_ ? f(optionalHeader64_) : f(optionalHeader32_);
+			}
+
+		public:
+			//-----------------------------------------------------------------
+			explicit Image(const std::filesystem::path& path)
+			{
+				std::ifstream ifs{path, std::ios::binary};
+
+				if (!ifs)
+					THROW(L"Cannot read " << path.wstring());
+				file_.assign(std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{});
+
+				auto dosHeader = Read<IMAGE_DOS_HEADER>(file_, 0);
+				auto ntHeadersOffset = static_cast<size_t>(dosHeader.e_lfanew);
+				if (dosHeader.e_magic != IMAGE_DOS_SIGNATURE ||
+				    Read<DWORD>(file_, ntHeadersOffset) != IMAGE_NT_SIGNATURE)
+				{
+					THROW(path.wstring() << L" is not an image.");
+				}
+				fileHeaderOffset_ = ntHeadersOffset + sizeof(DWORD);
+				fileHeader_ = Read<IMAGE_FILE_HEADER>(file_, fileHeaderOffset_);
+				optionalHeaderOffset_ = fileHeaderOffset_ + sizeof(IMAGE_FILE_HEADER);
+				sectionsOffset_ = optionalHeaderOffset_ + fileHeader_.SizeOfOptionalHeader;
+
+				auto magic = Read<WORD>(file_, optionalHeaderOffset_);
+				if (fileHeader_.Machine == IMAGE_FILE_MACHINE_AMD64 && magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC &&
+				    fileHeader_.SizeOfOptionalHeader >= sizeof(IMAGE_OPTIONAL_HEADER64))
+				{
+					is64Bits_ = true;
+					optionalHeader64_ = Read<IMAGE_OPTIONAL_HEADER64>(file_, optionalHeaderOffset_);
+				}
+				else if (fileHeader_.Machine == IMAGE_FILE_MACHINE_I386 && magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC &&
+				         fileHeader_.SizeOfOptionalHeader >= sizeof(IMAGE_OPTIONAL_HEADER32))
+				{
+					is64Bits_ = false;
+					optionalHeader32_ = Read<IMAGE_OPTIONAL_HEADER32>(file_, optionalHeaderOffset_);
+				}
+				else
+					THROW(L"Only x86 and x64 images can be instrumented: " << path.wstring());
+
+				auto sectionAlignment = GetSectionAlignment();
+				auto fileAlignment = GetFileAlignment();
+				if (OnOptionalHeader([](auto& header) { return header.NumberOfRvaAndSizes; }) <
+				        IMAGE_NUMBEROF_DIRECTORY_ENTRIES ||
+				    !sectionAlignment || (sectionAlignment & (sectionAlignment - 1)) ||
+				    !fileAlignment || (fileAlignment & (fileAlignment - 1)))
+				{
+					THROW(L"Unsupported optional header in " << path.wstring());
+				}
+				if (GetDirectory(IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR).VirtualAddress)
+					THROW(L"Managed images cannot be instrumented: " << path.wstring());
+
+				for (WORD i = 0; i < fileHeader_.NumberOfSections; ++i)
+				{
+					sections_.push_back(Read<IMAGE_SECTION_HEADER>(
+					    file_, sectionsOffset_ + i * sizeof(IMAGE_SECTION_HEADER)));
+				}
+			}
+
+			//-----------------------------------------------------------------
+			bool Is64Bits() const
+			{
+				return is64Bits_;
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t GetImageBase() const
+			{
+				return OnOptionalHeader([](const auto& header) { return static_cast<uint64_t>(header.ImageBase); });
+			}
+
+			//-----------------------------------------------------------------
+			DWORD GetSectionAlignment() const
+			{
+				return OnOptionalHeader([](const auto& header) { return header.SectionAlignment; });
+			}
+
+			//-----------------------------------------------------------------
+			DWORD GetFileAlignment() const
+			{
+				return OnOptionalHeader([](const auto& header) { return header.FileAlignment; });
+			}
+
+			//-----------------------------------------------------------------
+			IMAGE_DATA_DIRECTORY GetDirectory(int index) const
+			{
+				return OnOptionalHeader([=](const auto& header) { return header.DataDirectory[index]; });
+			}
+
+			//-----------------------------------------------------------------
+			void SetDirectory(int index, uint32_t rva, size_t size)
+			{
+				OnOptionalHeader([=](auto& header) {
+					header.DataDirectory[index].VirtualAddress = rva;
+					header.DataDirectory[index].Size = static_cast<DWORD>(size);
+				});
+			}
+
+			//-----------------------------------------------------------------
+			// File offset of the RVA, boost::none if the data is not in the file.
+			boost::optional<size_t> FindOffset(uint32_t rva, size_t size) const
+			{
+				auto sizeOfHeaders = OnOptionalHeader([](const auto& header) { return header.SizeOfHeaders; });
+
+				if (rva < sizeOfHeaders && size <= sizeOfHeaders - rva)
+					return static_cast<size_t>(rva);
+				for (const auto& section : sections_)
+				{
+					if (rva >= section.VirtualAddress && rva - section.VirtualAddress <= section.SizeOfRawData &&
+					    size <= section.SizeOfRawData - (rva - section.VirtualAddress))
+					{
+						return static_cast<size_t>(section.PointerToRawData) + (rva - section.VirtualAddress);
+					}
+				}
+				return boost::none;
+			}
+
+			//-----------------------------------------------------------------
+			size_t GetOffset(uint32_t rva, size_t size) const
+			{
+				auto offset = FindOffset(rva, size);
+
+				if (!offset)
+					THROW(L"Invalid image: RVA " << std::hex << rva << L" is not in the file.");
+				return *offset;
+			}
+
+			//-----------------------------------------------------------------
+			template <typename T>
+			T ReadRva(uint32_t rva) const
+			{
+				return Read<T>(file_, GetOffset(rva, sizeof(T)));
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t ReadPointer(uint32_t rva) const
+			{
+				return is64Bits_ ? ReadRva<uint64_t>(rva) : ReadRva<uint32_t>(rva);
+			}
+
+			//-----------------------------------------------------------------
+			const uint8_t* GetData(uint32_t rva, size_t size) const
+			{
+				return &file_[GetOffset(rva, size)];
+			}
+
+			//-----------------------------------------------------------------
+			uint8_t* GetData(uint32_t rva, size_t size)
+			{
+				return &file_[GetOffset(rva, size)];
+			}
+
+			//-----------------------------------------------------------------
+			// RVA of a section added after the existing ones.
+			uint32_t GetEndRva() const
+			{
+				DWORD endRva = 0;
+
+				for (const auto& section : sections_)
+				{
+					auto size = section.Misc.VirtualSize ? section.Misc.VirtualSize : section.SizeOfRawData;
+					endRva = (std::max)(endRva, section.VirtualAddress + size);
+				}
+				return AlignUp(endRva, GetSectionAlignment());
+			}
+
+			//-----------------------------------------------------------------
+			void CheckRoomForSections() const
+			{
+				auto sizeOfHeaders = OnOptionalHeader([](const auto& header) { return header.SizeOfHeaders; });
+				auto sectionsEnd = sectionsOffset_ + (sections_.size() + AddedSectionCount) * sizeof(IMAGE_SECTION_HEADER);
+				auto newSectionsBegin = sectionsOffset_ + sections_.size() * sizeof(IMAGE_SECTION_HEADER);
+
+				for (const auto& section : sections_)
+				{
+					if (section.SizeOfRawData && section.PointerToRawData < sectionsEnd)
+						THROW(L"The headers of the image have no room for the new sections.");
+				}
+				if (sectionsEnd > sizeOfHeaders || sectionsEnd > file_.size() ||
+				    std::any_of(file_.begin() + newSectionsBegin, file_.begin() + sectionsEnd, [](uint8_t value) {
+					    return value != 0;
+				    }))
+				{
+					THROW(L"The headers of the image have no room for the new sections.");
+				}
+			}
+
+			//-----------------------------------------------------------------
+			// The security directory gives a file offset and not an RVA.
+			void RemoveCertificates()
+			{
+				auto security = GetDirectory(IMAGE_DIRECTORY_ENTRY_SECURITY);
+
+				if (security.VirtualAddress && security.VirtualAddress + static_cast<size_t>(security.Size) == file_.size())
+					file_.resize(security.VirtualAddress);
+				SetDirectory(IMAGE_DIRECTORY_ENTRY_SECURITY, 0, 0);
+			}
+
+			//-----------------------------------------------------------------
+			void AddSection(const char* name,
+			                uint32_t rva,
+			                uint32_t virtualSize,
+			                const std::vector<uint8_t>& data,
+			                DWORD characteristics)
+			{
+				auto fileAlignment = GetFileAlignment();
+				IMAGE_SECTION_HEADER section{};
+
+				std::memcpy(section.Name, name, std::strlen(name));
+				section.Misc.VirtualSize = virtualSize;
+				section.VirtualAddress = rva;
+				section.SizeOfRawData = AlignUp(static_cast<DWORD>(data.size()), fileAlignment);
+				section.PointerToRawData = AlignUp(static_cast<DWORD>(file_.size()), fileAlignment);
+				section.Characteristics = characteristics;
+				file_.resize(section.PointerToRawData);
+				file_.insert(file_.end(), data.begin(), data.end());
+				file_.resize(section.PointerToRawData + section.SizeOfRawData);
+				sections_.push_back(section);
+
+				OnOptionalHeader([&](auto& header) {
+					header.SizeOfImage = AlignUp<DWORD>(rva + virtualSize, header.SectionAlignment);
+					if (characteristics & IMAGE_SCN_CNT_CODE)
+						header.SizeOfCode += section.SizeOfRawData;
+					else
+						header.SizeOfInitializedData += section.SizeOfRawData;
+				});
+			}
+
+			//-----------------------------------------------------------------
+			void Save(const std::filesystem::path& path)
+			{
+				OnOptionalHeader([](auto& header) {
+					// The signature and the control flow guard metadata do not
+					// match the new code.
+					header.DllCharacteristics &=
+					    ~(IMAGE_DLLCHARACTERISTICS_FORCE_INTEGRITY | IMAGE_DLLCHARACTERISTICS_GUARD_CF);
+					header.CheckSum = 0;
+				});
+				fileHeader_.NumberOfSections = static_cast<WORD>(sections_.size());
+				Write(file_, fileHeaderOffset_, fileHeader_);
+				for (size_t i = 0; i < sections_.size(); ++i)
+					Write(file_, sectionsOffset_ + i * sizeof(IMAGE_SECTION_HEADER), sections_[i]);
+				WriteOptionalHeader();
+				OnOptionalHeader([&](auto& header) { header.CheckSum = ComputeCheckSum(file_); });
+				WriteOptionalHeader();
+
+				std::ofstream ofs{path, std::ios::binary};
+				ofs.write(reinterpret_cast<const char*>(file_.data()), file_.size());
+				if (!ofs)
+					THROW(L"Cannot write " << path.wstring());
+			}
+
+		private:
+			//-----------------------------------------------------------------
+			void WriteOptionalHeader()
+			{
+				if (is64Bits_)
+					Write(file_, optionalHeaderOffset_, optionalHeader64_);
+				else
+					Write(file_, optionalHeaderOffset_, optionalHeader32_);
+			}
+
+			std::vector<uint8_t> file_;
+			bool is64Bits_;
+			size_t fileHeaderOffset_;
+			size_t optionalHeaderOffset_;
+			size_t sectionsOffset_;
+			IMAGE_FILE_HEADER fileHeader_;
+			IMAGE_OPTIONAL_HEADER32 optionalHeader32_{};
+			IMAGE_OPTIONAL_HEADER64 optionalHeader64_{};
+			std::vector<IMAGE_SECTION_HEADER> sections_;
+		};
+
+		//---------------------------------------------------------------------
+		// Data appended to the new data section, with the relocations of the
+		// addresses it contains.
+		class SectionWriter
+		{
+		public:
+			//-----------------------------------------------------------------
+			SectionWriter(uint32_t rva, uint64_t imageBase, bool is64Bits)
+				: rva_{rva}, imageBase_{imageBase}, is64Bits_{is64Bits}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			uint32_t GetRva() const
+			{
+				return rva_ + static_cast<uint32_t>(data_.size());
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t GetVa() const
+			{
+				return imageBase_ + GetRva();
+			}
+
+			//-----------------------------------------------------------------
+			template <typename T>
+			uint32_t Append(const T& value)
+			{
+				auto rva = GetRva();
+
+				::CppCoverage::Append(data_, value);
+				return rva;
+			}
+
+			//-----------------------------------------------------------------
+			uint32_t AppendBytes(const std::vector<uint8_t>& bytes)
+			{
+				auto rva = GetRva();
+
+				data_.insert(data_.end(), bytes.begin(), bytes.end());
+				return rva;
+			}
+
+			//-----------------------------------------------------------------
+			uint32_t AppendString(const char* value)
+			{
+				auto rva = GetRva();
+
+				data_.insert(data_.end(), value, value + std::strlen(value) + 1);
+				return rva;
+			}
+
+			//-----------------------------------------------------------------
+			// A pointer-sized value which is not an address.
+			uint32_t AppendValue(uint64_t value)
+			{
+				return is64Bits_ ? Append(value) : Append(static_cast<uint32_t>(value));
+			}
+
+			//-----------------------------------------------------------------
+			uint32_t AppendPointer(uint64_t va)
+			{
+				auto rva = AppendValue(va);
+
+				if (va)
+					AddRelocation(rva);
+				return rva;
+			}
+
+			//-----------------------------------------------------------------
+			void Align(size_t alignment)
+			{
+				AlignSize(data_, alignment);
+			}
+
+			//-----------------------------------------------------------------
+			void AddRelocation(uint32_t rva)
+			{
+				AddRelocation(rva, static_cast<WORD>(is64Bits_ ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW));
+			}
+
+			//-----------------------------------------------------------------
+			void AddRelocation(uint32_t rva, WORD type)
+			{
+				relocations_.emplace_back(rva, type);
+			}
+
+			//-----------------------------------------------------------------
+			// Append the relocation blocks of the recorded relocations.
+			uint32_t AppendRelocations()
+			{
+				auto rva = GetRva();
+				auto relocations = relocations_;
+
+				std::sort(relocations.begin(), relocations.end());
+				for (auto it = relocations.begin(); it != relocations.end();)
+				{
+					auto page = it->first & ~0xFFFu;
+					auto blockOffset = ::CppCoverage::Append(data_, IMAGE_BASE_RELOCATION{page, 0});
+
+					for (; it != relocations.end() && (it->first & ~0xFFFu) == page; ++it)
+						::CppCoverage::Append(data_, static_cast<WORD>((it->second << 12) | (it->first & 0xFFF)));
+					AlignSize(data_, sizeof(DWORD));
+					Write(data_, blockOffset + offsetof(IMAGE_BASE_RELOCATION, SizeOfBlock),
+					      static_cast<DWORD>(data_.size() - blockOffset));
+				}
+				return rva;
+			}
+
+			//-----------------------------------------------------------------
+			const std::vector<uint8_t>& GetData() const
+			{
+				return data_;
+			}
+
+		private:
+			const uint32_t rva_;
+			const uint64_t imageBase_;
+			const bool is64Bits_;
+			std::vector<uint8_t> data_;
+			std::vector<std::pair<uint32_t, WORD>> relocations_;
+		};
+
+		//---------------------------------------------------------------------
+		std::vector<uint8_t> ReadDirectory(const Image& image, int index)
+		{
+			auto directory = image.GetDirectory(index);
+
+			if (!directory.VirtualAddress || !directory.Size)
+				return {};
+
+			const auto* data = image.GetData(directory.VirtualAddress, directory.Size);
+			return {data, data + directory.Size};
+		}
+
+		//---------------------------------------------------------------------
+		std::map<uint32_t, Relocation> ReadRelocations(const std::vector<uint8_t>& directory)
+		{
+			std::map<uint32_t, Relocation> relocations;
+
+			for (size_t offset = 0; offset + sizeof(IMAGE_BASE_RELOCATION) <= directory.size();)
+			{
+				auto block = Read<IMAGE_BASE_RELOCATION>(directory, offset);
+				auto blockEnd = offset + block.SizeOfBlock;
+
+				if (block.SizeOfBlock < sizeof(IMAGE_BASE_RELOCATION) || blockEnd > directory.size())
+					THROW(L"Invalid image: invalid relocation block.");
+				for (auto entryOffset = offset + sizeof(IMAGE_BASE_RELOCATION); entryOffset + sizeof(WORD) <= blockEnd;
+				     entryOffset += sizeof(WORD))
+				{
+					auto entry = Read<WORD>(directory, entryOffset);
+					auto type = static_cast<WORD>(entry >> 12);
+
+					if (type != IMAGE_REL_BASED_ABSOLUTE)
+						relocations[block.VirtualAddress + (entry & 0xFFF)] = {type, entryOffset};
+					// The entry is followed by a parameter.
+					if (type == IMAGE_REL_BASED_HIGHADJ)
+						entryOffset += sizeof(WORD);
+				}
+				offset = blockEnd;
+			}
+			return relocations;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<RuntimeFunction> ReadRuntimeFunctions(const Image& image)
+		{
+			if (!image.Is64Bits())
+				return {};
+
+			auto directory = ReadDirectory(image, IMAGE_DIRECTORY_ENTRY_EXCEPTION);
+			std::vector<RuntimeFunction> runtimeFunctions(directory.size() / sizeof(RuntimeFunction));
+
+			if (!runtimeFunctions.empty())
+				std::memcpy(runtimeFunctions.data(), directory.data(), runtimeFunctions.size() * sizeof(RuntimeFunction));
+			return runtimeFunctions;
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<RuntimeFunction> FindRuntimeFunction(const std::vector<RuntimeFunction>& runtimeFunctions,
+		                                                     uint32_t rva)
+		{
+			auto it = std::upper_bound(runtimeFunctions.begin(), runtimeFunctions.end(), rva,
+			                           [](uint32_t value, const RuntimeFunction& runtimeFunction) {
+				                           return value < runtimeFunction.beginAddress_;
+			                           });
+
+			if (it == runtimeFunctions.begin() || rva >= std::prev(it)->endAddress_)
+				return boost::none;
+			return *std::prev(it);
+		}
+
+		//---------------------------------------------------------------------
+		// An entry can give the RVA of the entry with the unwind information.
+		RuntimeFunction ResolveIndirection(const Image& image, RuntimeFunction runtimeFunction)
+		{
+			for (int i = 0; runtimeFunction.unwindData_ & RuntimeFunctionIndirection; ++i)
+			{
+				if (i == MaxUnwindChainLength)
+					THROW(L"Invalid image: too many indirections in the exception directory.");
+				runtimeFunction =
+				    image.ReadRva<RuntimeFunction>(runtimeFunction.unwindData_ & ~RuntimeFunctionIndirection);
+			}
+			return runtimeFunction;
+		}
+
+		//---------------------------------------------------------------------
+		struct UnwindInfo
+		{
+			uint8_t flags_;
+			uint8_t sizeOfProlog_;
+			// Frame register and offset.
+			uint8_t frame_;
+			boost::optional<RuntimeFunction> chainedFunction_;
+		};
+
+		//---------------------------------------------------------------------
+		UnwindInfo ReadUnwindInfo(const Image& image, const RuntimeFunction& runtimeFunction)
+		{
+			auto rva = ResolveIndirection(image, runtimeFunction).unwindData_;
+			auto header = image.ReadRva<uint32_t>(rva);
+			auto countOfCodes = (header >> 16) & 0xFF;
+			UnwindInfo unwindInfo{};
+
+			unwindInfo.flags_ = static_cast<uint8_t>((header & 0xFF) >> 3);
+			unwindInfo.sizeOfProlog_ = static_cast<uint8_t>(header >> 8);
+			unwindInfo.frame_ = static_cast<uint8_t>(header >> 24);
+			// The unwind codes are aligned on 4 bytes.
+			if (unwindInfo.flags_ & UnwindFlagChainInfo)
+			{
+				unwindInfo.chainedFunction_ =
+				    image.ReadRva<RuntimeFunction>(rva + 4 + 2 * ((countOfCodes + 1) & ~1u));
+			}
+			return unwindInfo;
+		}
+
+		//---------------------------------------------------------------------
+		// In 64 bits, a trampoline gets the unwind information of its function
+		// but not its exception handlers: see TrampolineBuilder::GetDisplacedSizeInImage.
+		bool CanFault(const Image& image, const boost::optional<RuntimeFunction>& runtimeFunction, uint32_t rva)
+		{
+			if (!image.Is64Bits() || !runtimeFunction)
+				return true;
+
+			auto unwindInfo = ReadUnwindInfo(image, *runtimeFunction);
+			if (rva - runtimeFunction->beginAddress_ < unwindInfo.sizeOfProlog_)
+				return false;
+			for (int i = 0; unwindInfo.chainedFunction_; ++i)
+			{
+				if (i == MaxUnwindChainLength)
+					THROW(L"Invalid image: too many chained unwind information.");
+				unwindInfo = ReadUnwindInfo(image, *unwindInfo.chainedFunction_);
+			}
+			return (unwindInfo.flags_ & (UnwindFlagExceptionHandler | UnwindFlagTerminationHandler)) == 0;
+		}
+
+		//---------------------------------------------------------------------
+		class SiteFinder
+		{
+		public:
+			//-----------------------------------------------------------------
+			SiteFinder(const Image& image,
+			           const std::map<uint32_t, Relocation>& relocations,
+			           const std::vector<RuntimeFunction>& runtimeFunctions,
+			           const TrampolineBuilder& trampolineBuilder)
+				: image_{image}
+				, relocations_{relocations}
+				, runtimeFunctions_{runtimeFunctions}
+				, trampolineBuilder_{trampolineBuilder}
+				, relocationType_{static_cast<WORD>(image.Is64Bits() ? IMAGE_REL_BASED_DIR64 : IMAGE_REL_BASED_HIGHLOW)}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			// The sites are sorted by RVA and the lines which cannot be
+			// instrumented have no site.
+			std::vector<Site> FindSites(const ModuleLineTable& lineTable,
+			                            const ModuleLineTable::FunctionRanges& functionRanges) const
+			{
+				const auto& lines = lineTable.GetLines();
+				std::vector<size_t> lineIndexes(lines.size());
+				std::vector<Site> sites;
+
+				std::iota(lineIndexes.begin(), lineIndexes.end(), 0);
+				std::stable_sort(lineIndexes.begin(), lineIndexes.end(), [&](size_t index1, size_t index2) {
+					return lines[index1].rva_ < lines[index2].rva_;
+				});
+				for (auto it = lineIndexes.begin(); it != lineIndexes.end();)
+				{
+					auto rva = lines[*it].rva_;
+					auto function = functionRanges.upper_bound(rva);
+
+					if (function == functionRanges.begin() ||
+					    rva - std::prev(function)->first >= std::prev(function)->second)
+					{
+						++it;
+						continue;
+					}
+					--function;
+
+					auto functionEnd = function->first + function->second;
+					auto functionEndIt = std::find_if(
+					    it, lineIndexes.end(), [&](size_t index) { return lines[index].rva_ >= functionEnd; });
+					AddFunctionSites(lines, it, functionEndIt, function->first, function->second, sites);
+					it = functionEndIt;
+				}
+				return sites;
+			}
+
+		private:
+			using LineIndexIterator = std::vector<size_t>::const_iterator;
+
+			//-----------------------------------------------------------------
+			void AddFunctionSites(const std::vector<ModuleLineTable::Line>& lines,
+			                      LineIndexIterator begin,
+			                      LineIndexIterator end,
+			                      uint32_t functionRva,
+			                      uint32_t functionLength,
+			                      std::vector<Site>& sites) const
+			{
+				if (!image_.FindOffset(functionRva, functionLength))
+					return;
+
+				const auto* data = image_.GetData(functionRva, functionLength);
+				std::vector<uint8_t> code{data, data + functionLength};
+				auto imageBase = image_.GetImageBase();
+				BasicBlockAnalyzer analyzer{code, imageBase + functionRva, image_.Is64Bits()};
+
+				if (!analyzer.IsAnalyzed())
+					return;
+
+				boost::optional<size_t> functionSite;
+				for (auto it = begin; it != end;)
+				{
+					auto rva = lines[*it].rva_;
+					auto nextIt = std::find_if(it, end, [&](size_t index) { return lines[index].rva_ != rva; });
+					auto nextRva = nextIt == end ? functionRva + functionLength : lines[*nextIt].rva_;
+
+					if (functionSite && rva < sites[*functionSite].rva_ + sites[*functionSite].displacedSize_)
+					{
+						// The line is run by the trampoline of the previous site.
+						if (analyzer.IsInstructionStart(imageBase + rva))
+						{
+							for (; it != nextIt; ++it)
+								sites[*functionSite].counters_.emplace_back(rva, *it);
+						}
+					}
+					else if (auto site = FindSite(code, functionRva, rva, nextRva, analyzer))
+					{
+						for (; it != nextIt; ++it)
+							site->counters_.emplace_back(site->rva_, *it);
+						functionSite = sites.size();
+						sites.push_back(std::move(*site));
+					}
+					it = nextIt;
+				}
+			}
+
+			//-----------------------------------------------------------------
+			// The counter of a line can be incremented by a following
+			// instruction of the same basic block when the instructions of the
+			// line cannot be moved to a trampoline.
+			boost::optional<Site> FindSite(const std::vector<uint8_t>& code,
+			                               uint32_t functionRva,
+			                               uint32_t lineRva,
+			                               uint32_t nextRva,
+			                               const BasicBlockAnalyzer& analyzer) const
+			{
+				auto imageBase = image_.GetImageBase();
+
+				for (auto rva = lineRva; rva < nextRva;)
+				{
+					auto address = imageBase + rva;
+					if (rva != lineRva && !analyzer.IsInSameBasicBlock(imageBase + lineRva, address))
+						break;
+
+					const auto* instructionCode = &code[rva - functionRva];
+					auto size = code.size() - (rva - functionRva);
+					auto runtimeFunction = FindRuntimeFunction(runtimeFunctions_, rva);
+					auto displacedSize = trampolineBuilder_.GetDisplacedSizeInImage(
+					    instructionCode, size, address, analyzer, CanFault(image_, runtimeFunction, rva));
+
+					if (displacedSize && (!runtimeFunction || rva + *displacedSize <= runtimeFunction->endAddress_) &&
+					    HasOnlyAddressRelocations(rva, *displacedSize))
+					{
+						if (runtimeFunction)
+							runtimeFunction = ResolveIndirection(image_, *runtimeFunction);
+						return Site{rva, *displacedSize, {}, runtimeFunction};
+					}
+
+					auto instruction = DecodeInstruction(instructionCode, size, address, image_.Is64Bits());
+					if (!instruction)
+						break;
+					rva += static_cast<uint32_t>(instruction->length_);
+				}
+				return boost::none;
+			}
+
+			//-----------------------------------------------------------------
+			bool HasOnlyAddressRelocations(uint32_t rva, size_t size) const
+			{
+				auto end = relocations_.lower_bound(rva + static_cast<uint32_t>(size));
+
+				for (auto it = relocations_.lower_bound(rva); it != end; ++it)
+				{
+					if (it->second.type_ != relocationType_)
+						return false;
+				}
+				return true;
+			}
+
+			const Image& image_;
+			const std::map<uint32_t, Relocation>& relocations_;
+			const std::vector<RuntimeFunction>& runtimeFunctions_;
+			const TrampolineBuilder& trampolineBuilder_;
+			const WORD relocationType_;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename TlsDirectory>
+		void AddTlsCallback(Image& image, SectionWriter& section, uint32_t callbackRva)
+		{
+			using Pointer = decltype(TlsDirectory::AddressOfCallBacks);
+
+			auto imageBase = image.GetImageBase();
+			auto directory = image.GetDirectory(IMAGE_DIRECTORY_ENTRY_TLS);
+			TlsDirectory tls{};
+			std::vector<uint64_t> callbacks;
+
+			section.Align(sizeof(uint64_t));
+			if (directory.VirtualAddress)
+			{
+				tls = image.ReadRva<TlsDirectory>(directory.VirtualAddress);
+				if (tls.AddressOfCallBacks)
+				{
+					auto rva = static_cast<uint32_t>(tls.AddressOfCallBacks - imageBase);
+					for (uint64_t callback; (callback = image.ReadPointer(rva)) != 0;
+					     rva += static_cast<uint32_t>(sizeof(Pointer)))
+						callbacks.push_back(callback);
+				}
+			}
+			else
+			{
+				// The loader requires a TLS index and TLS data.
+				tls.AddressOfIndex = static_cast<Pointer>(section.GetVa());
+				section.Append(uint64_t{0});
+				tls.StartAddressOfRawData = static_cast<Pointer>(section.GetVa());
+				section.Append(uint64_t{0});
+				tls.EndAddressOfRawData = static_cast<Pointer>(section.GetVa());
+			}
+			callbacks.push_back(imageBase + callbackRva);
+
+			tls.AddressOfCallBacks = static_cast<Pointer>(section.GetVa());
+			for (auto callback : callbacks)
+				section.AppendPointer(callback);
+			section.AppendValue(0);
+
+			auto tlsRva = section.Append(tls);
+			if (tls.StartAddressOfRawData)
+				section.AddRelocation(tlsRva + static_cast<uint32_t>(offsetof(TlsDirectory, StartAddressOfRawData)));
+			if (tls.EndAddressOfRawData)
+				section.AddRelocation(tlsRva + static_cast<uint32_t>(offsetof(TlsDirectory, EndAddressOfRawData)));
+			if (tls.AddressOfIndex)
+				section.AddRelocation(tlsRva + static_cast<uint32_t>(offsetof(TlsDirectory, AddressOfIndex)));
+			section.AddRelocation(tlsRva + static_cast<uint32_t>(offsetof(TlsDirectory, AddressOfCallBacks)));
+			image.SetDirectory(IMAGE_DIRECTORY_ENTRY_TLS, tlsRva, sizeof(TlsDirectory));
+		}
+
+		//---------------------------------------------------------------------
+		// Import the TLS callback of the runtime and return the RVA of its
+		// import address.
+		uint32_t AddRuntimeImport(Image& image, SectionWriter& section)
+		{
+			auto hintNameRva = section.Append(WORD{0});
+			section.AppendString(CoverageRuntime::TlsCallbackName);
+			auto nameRva = section.AppendString(CoverageRuntime::RuntimeFilename);
+
+			section.Align(sizeof(uint64_t));
+			auto lookupTableRva = section.AppendValue(hintNameRva);
+			section.AppendValue(0);
+			auto importAddressRva = section.AppendValue(hintNameRva);
+			section.AppendValue(0);
+
+			std::vector<IMAGE_IMPORT_DESCRIPTOR> descriptors;
+			auto directory = image.GetDirectory(IMAGE_DIRECTORY_ENTRY_IMPORT);
+			for (auto rva = directory.VirtualAddress; rva;
+			     rva += static_cast<DWORD>(sizeof(IMAGE_IMPORT_DESCRIPTOR)))
+			{
+				auto descriptor = image.ReadRva<IMAGE_IMPORT_DESCRIPTOR>(rva);
+				if (!descriptor.Name)
+					break;
+
+				// The bound import directory is removed.
+				if (descriptor.TimeDateStamp)
+				{
+					if (!descriptor.OriginalFirstThunk)
+						THROW(L"Bound imports without import lookup table are not supported.");
+					descriptor.TimeDateStamp = 0;
+				}
+				descriptors.push_back(descriptor);
+			}
+
+			IMAGE_IMPORT_DESCRIPTOR descriptor{};
+			descriptor.OriginalFirstThunk = lookupTableRva;
+			descriptor.Name = nameRva;
+			descriptor.FirstThunk = importAddressRva;
+			descriptors.push_back(descriptor);
+			descriptors.push_back(IMAGE_IMPORT_DESCRIPTOR{});
+
+			section.Align(sizeof(DWORD));
+			auto descriptorsRva = section.GetRva();
+			for (const auto& importDescriptor : descriptors)
+				section.Append(importDescriptor);
+			image.SetDirectory(IMAGE_DIRECTORY_ENTRY_IMPORT,
+			                   descriptorsRva,
+			                   descriptors.size() * sizeof(IMAGE_IMPORT_DESCRIPTOR));
+			image.SetDirectory(IMAGE_DIRECTORY_ENTRY_BOUND_IMPORT, 0, 0);
+			return importAddressRva;
+		}
+
+		//---------------------------------------------------------------------
+		// Each trampoline gets an unwind information chained to the one of its
+		// function, without unwind codes of its own.
+		void AddTrampolineRuntimeFunctions(
+		    Image& image,
+		    SectionWriter& section,
+		    const std::vector<RuntimeFunction>& runtimeFunctions,
+		    const std::vector<std::pair<RuntimeFunction, RuntimeFunction>>& trampolineFunctions)
+		{
+			std::map<uint32_t, uint32_t> unwindRvas;
+
+			section.Align(sizeof(DWORD));
+			for (const auto& trampolineFunction : trampolineFunctions)
+			{
+				const auto& function = trampolineFunction.second;
+
+				if (unwindRvas.find(function.beginAddress_) == unwindRvas.end())
+				{
+					auto unwindRva =
+					    section.Append(static_cast<uint8_t>(UnwindVersion | (UnwindFlagChainInfo << 3)));
+					section.Append(uint8_t{0}); // SizeOfProlog
+					section.Append(uint8_t{0}); // CountOfCodes
+					section.Append(ReadUnwindInfo(image, function).frame_);
+					section.Append(function);
+					unwindRvas.emplace(function.beginAddress_, unwindRva);
+				}
+			}
+
+			// The trampolines are after the code of the image, so the entries
+			// stay sorted.
+			auto runtimeFunctionsRva = section.GetRva();
+			for (const auto& runtimeFunction : runtimeFunctions)
+				section.Append(runtimeFunction);
+			for (const auto& trampolineFunction : trampolineFunctions)
+			{
+				auto runtimeFunction = trampolineFunction.first;
+				runtimeFunction.unwindData_ = unwindRvas.at(trampolineFunction.second.beginAddress_);
+				section.Append(runtimeFunction);
+			}
+			image.SetDirectory(IMAGE_DIRECTORY_ENTRY_EXCEPTION,
+			                   runtimeFunctionsRva,
+			                   (runtimeFunctions.size() + trampolineFunctions.size()) * sizeof(RuntimeFunction));
+		}
+
+		//---------------------------------------------------------------------
+		void CopyRuntime(const std::filesystem::path& outputPath)
+		{
+			auto runtimePath = Tools::GetExecutableFolder() / CoverageRuntime::RuntimeFilename;
+			auto destination = std::filesystem::absolute(outputPath).parent_path() / CoverageRuntime::RuntimeFilename;
+
+			if (!std::filesystem::exists(destination) || !std::filesystem::equivalent(runtimePath, destination))
+				std::filesystem::copy_file(runtimePath, destination, std::filesystem::copy_options::overwrite_existing);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleLineTable ImageInstrumenter::Instrument(
+	    const std::filesystem::path& modulePath,
+	    const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths,
+	    ICoverageFilterManager& coverageFilterManager,
+	    const std::filesystem::path& outputPath)
+	{
+		if (std::filesystem::exists(outputPath) && std::filesystem::equivalent(modulePath, outputPath))
+			THROW(L"The instrumented image cannot replace " << modulePath.wstring());
+
+		ModuleLineTable::FunctionRanges functionRanges;
+		auto lineTable = ModuleLineTable::Create(
+		    modulePath, substitutePdbSourcePaths, coverageFilterManager, &functionRanges);
+		Image image{modulePath};
+		image.CheckRoomForSections();
+
+		auto is64Bits = image.Is64Bits();
+		auto imageBase = image.GetImageBase();
+		auto relocationDirectory = ReadDirectory(image, IMAGE_DIRECTORY_ENTRY_BASERELOC);
+		auto relocations = ReadRelocations(relocationDirectory);
+		auto runtimeFunctions = ReadRuntimeFunctions(image);
+		TrampolineBuilder trampolineBuilder{is64Bits};
+		SiteFinder siteFinder{image, relocations, runtimeFunctions, trampolineBuilder};
+		auto sites = siteFinder.FindSites(lineTable, functionRanges);
+
+		// The size of the code section is known before building the
+		// trampolines as they need the addresses of the counters.
+		auto codeRva = image.GetEndRva();
+		auto codeSize = std::accumulate(sites.begin(), sites.end(), sizeof(TlsStub), [&](size_t size, const Site& site) {
+			return size + trampolineBuilder.GetMaxTrampolineSize(site.displacedSize_, site.counters_.size());
+		});
+		auto countersRva = AlignUp<uint32_t>(codeRva + static_cast<uint32_t>(codeSize), image.GetSectionAlignment());
+		auto counterSize = trampolineBuilder.GetCounterSize();
+		auto firstCounterVa = imageBase + countersRva + sizeof(CoverageRuntime::CountersHeader);
+
+		SectionWriter section{countersRva, imageBase, is64Bits};
+		std::vector<uint8_t> code{TlsStub, TlsStub + sizeof(TlsStub)};
+		std::vector<std::pair<RuntimeFunction, RuntimeFunction>> trampolineFunctions;
+		std::vector<size_t> instrumentedLineIndexes;
+
+		for (const auto& site : sites)
+		{
+			auto trampolineRva = codeRva + static_cast<uint32_t>(code.size());
+			std::vector<TrampolineBuilder::Counter> counters;
+
+			for (const auto& counter : site.counters_)
+			{
+				auto counterVa = firstCounterVa + (instrumentedLineIndexes.size() + counters.size()) * counterSize;
+				counters.push_back({imageBase + counter.first, counterVa});
+			}
+
+			auto* siteCode = image.GetData(site.rva_, site.displacedSize_);
+			TrampolineBuilder::Layout layout;
+			auto trampoline = trampolineBuilder.Build(
+			    siteCode, site.displacedSize_, imageBase + site.rva_, imageBase + trampolineRva, counters, &layout);
+			auto jump = trampolineBuilder.BuildJump(imageBase + site.rva_, imageBase + trampolineRva);
+			if (!trampoline || !jump)
+				continue;
+
+			// The relocations of the displaced instructions move to the
+			// trampoline.
+			std::vector<std::pair<uint32_t, const Relocation*>> movedRelocations;
+			auto relocationsEnd = relocations.lower_bound(site.rva_ + static_cast<uint32_t>(site.displacedSize_));
+			for (auto it = relocations.lower_bound(site.rva_); it != relocationsEnd; ++it)
+			{
+				const auto& offsets = layout.copiedInstructionOffsets_;
+				auto offset = it->first - site.rva_;
+				auto copied = std::upper_bound(offsets.begin(), offsets.end(), offset,
+				                               [](size_t value, const std::pair<size_t, size_t>& instructionOffsets) {
+					                               return value < instructionOffsets.first;
+				                               });
+				if (copied == offsets.begin())
+					THROW(L"Invalid relocation at RVA " << std::hex << it->first);
+				--copied;
+				movedRelocations.emplace_back(
+				    trampolineRva + static_cast<uint32_t>(copied->second + offset - copied->first), &it->second);
+			}
+			for (const auto& movedRelocation : movedRelocations)
+			{
+				section.AddRelocation(movedRelocation.first, movedRelocation.second->type_);
+				Write(relocationDirectory, movedRelocation.second->entryOffset_, WORD{0});
+			}
+			for (auto offset : layout.counterAddressOffsets_)
+				section.AddRelocation(trampolineRva + static_cast<uint32_t>(offset));
+
+			std::copy(jump->begin(), jump->end(), siteCode);
+			std::fill(siteCode + jump->size(), siteCode + site.displacedSize_, uint8_t{0xCC});
+			code.insert(code.end(), trampoline->begin(), trampoline->end());
+			if (site.function_)
+			{
+				RuntimeFunction trampolineFunction{trampolineRva, codeRva + static_cast<uint32_t>(code.size()), 0};
+				trampolineFunctions.emplace_back(trampolineFunction, *site.function_);
+			}
+			for (const auto& counter : site.counters_)
+				instrumentedLineIndexes.push_back(counter.second);
+		}
+
+		const auto& lines = lineTable.GetLines();
+		if (instrumentedLineIndexes.size() != lines.size())
+		{
+			LOG_WARNING << lines.size() - instrumentedLineIndexes.size() << L" lines of " << modulePath.wstring()
+			            << L" cannot be instrumented and are ignored.";
+		}
+
+		auto counterCount = static_cast<uint32_t>(instrumentedLineIndexes.size());
+		section.Append(CoverageRuntime::CountersHeader{
+		    CoverageRuntime::CountersVersion, static_cast<uint32_t>(counterSize), counterCount, 0});
+		section.AppendBytes(std::vector<uint8_t>(counterCount * counterSize));
+
+		if (is64Bits)
+			AddTlsCallback<IMAGE_TLS_DIRECTORY64>(image, section, codeRva);
+		else
+			AddTlsCallback<IMAGE_TLS_DIRECTORY32>(image, section, codeRva);
+		auto callbackImportRva = AddRuntimeImport(image, section);
+		if (is64Bits)
+		{
+			auto next = codeRva + static_cast<uint32_t>(sizeof(TlsStub));
+			Write(code, TlsStubTargetOffset, static_cast<uint32_t>(callbackImportRva - next));
+		}
+		else
+		{
+			Write(code, TlsStubTargetOffset, static_cast<uint32_t>(imageBase + callbackImportRva));
+			section.AddRelocation(codeRva + static_cast<uint32_t>(TlsStubTargetOffset));
+		}
+		if (!trampolineFunctions.empty())
+			AddTrampolineRuntimeFunctions(image, section, runtimeFunctions, trampolineFunctions);
+		if (!relocationDirectory.empty())
+		{
+			section.Align(sizeof(DWORD));
+			auto relocationRva = section.AppendBytes(relocationDirectory);
+			section.AppendRelocations();
+			image.SetDirectory(IMAGE_DIRECTORY_ENTRY_BASERELOC, relocationRva, section.GetRva() - relocationRva);
+		}
+
+		image.RemoveCertificates();
+		image.AddSection(CodeSectionName,
+		                 codeRva,
+		                 static_cast<uint32_t>(codeSize),
+		                 code,
+		                 IMAGE_SCN_CNT_CODE | IMAGE_SCN_MEM_EXECUTE | IMAGE_SCN_MEM_READ);
+		image.AddSection(CoverageRuntime::CountersSectionName,
+		                 countersRva,
+		                 static_cast<uint32_t>(section.GetData().size()),
+		                 section.GetData(),
+		                 IMAGE_SCN_CNT_INITIALIZED_DATA | IMAGE_SCN_MEM_READ | IMAGE_SCN_MEM_WRITE);
+		image.Save(outputPath);
+		CopyRuntime(outputPath);
+
+		std::vector<std::filesystem::path> files;
+		std::map<uint32_t, uint32_t> fileIndexes;
+		std::vector<ModuleLineTable::Line> instrumentedLines;
+		for (auto index : instrumentedLineIndexes)
+		{
+			auto line = lines[index];
+			auto it = fileIndexes.emplace(line.fileIndex_, static_cast<uint32_t>(files.size())).first;
+
+			if (it->second == files.size())
+				files.push_back(lineTable.GetFiles()[line.fileIndex_]);
+			line.fileIndex_ = it->second;
+			instrumentedLines.push_back(line);
+		}
+		return ModuleLineTable{modulePath, std::move(files), std::move(instrumentedLines)};
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path ImageInstrumenter::GetCountersPath(const std::filesystem::path& outputPath)
+	{
+		auto countersPath = outputPath;
+
+		countersPath += CoverageRuntime::CountersExtension;
+		return countersPath;
+	}
+}
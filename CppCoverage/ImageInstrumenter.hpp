@@ -0,0 +1,49 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+#include "SubstitutePdbSourcePath.hpp"
+
+namespace CppCoverage
+{
+	class ICoverageFilterManager;
+	class ModuleLineTable;
+
+	// Write a copy of a module whose selected lines increment a counter, so
+	// the coverage is known without running the module under OpenCppCoverage.
+	// The lines jump to trampolines (see TrampolineBuilder) of a new code
+	// section and the counters are in a new data section. A TLS callback of
+	// CoverageRuntime.dll saves the counters when the module is unloaded: see
+	// CoverageRuntime/RuntimeSharedData.hpp.
+	class CPPCOVERAGE_DLL ImageInstrumenter
+	{
+	public:
+		// Return the table of the instrumented lines, in the order of the
+		// counters. CoverageRuntime.dll is copied next to outputPath.
+		static ModuleLineTable Instrument(const std::filesystem::path& modulePath,
+		                                  const std::vector<SubstitutePdbSourcePath>&,
+		                                  ICoverageFilterManager&,
+		                                  const std::filesystem::path& outputPath);
+
+		// Path of the counters saved by the module at outputPath.
+		static std::filesystem::path GetCountersPath(const std::filesystem::path& outputPath);
+	};
+}
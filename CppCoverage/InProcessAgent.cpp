@@ -0,0 +1,270 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "InProcessAgent.hpp"
+
+#include <intrin.h>
+
+#include "CoverageAgent/AgentSharedData.hpp"
+
+#include "Tools/Log.hpp"
+#include "Tools/ProcessMemory.hpp"
+#include "Tools/ScopedAction.hpp"
+
+#include "CppCoverageException.hpp"
+#include "Handle.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		HANDLE CreateAgentEvent(const wchar_t* prefix, DWORD processId)
+		{
+			auto name = CoverageAgent::GetObjectName(prefix, processId);
+			auto hEvent = CreateEventW(nullptr, FALSE, FALSE, name.c_str());
+
+			if (!hEvent)
+				THROW_LAST_ERROR(L"Cannot create event " << name, GetLastError());
+			return hEvent;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsBreakPointAddress(uint64_t address)
+		{
+			return address != CoverageAgent::EmptyPatchAddress &&
+			       address != CoverageAgent::RemovedPatchAddress;
+		}
+	}
+
+	const std::wstring InProcessAgent::AgentFilename = L"CoverageAgent.dll";
+	const uint32_t InProcessAgent::DefaultPatchCapacity = 1 << 21;
+
+	//-------------------------------------------------------------------------
+	InProcessAgent::InProcessAgent(HANDLE hProcess,
+	                               DWORD processId,
+	                               uint32_t patchCapacity)
+	    : hProcess_{hProcess},
+	      hFileMapping_{nullptr},
+	      hModuleEvent_{nullptr},
+	      hModuleHandledEvent_{nullptr},
+	      header_{nullptr},
+	      breakPointCount_{0}
+	{
+		if (patchCapacity == 0 || (patchCapacity & (patchCapacity - 1)) != 0)
+			THROW("Patch capacity must be a power of 2.");
+
+		auto size = static_cast<uint64_t>(
+		    CoverageAgent::GetSharedMemorySize(patchCapacity));
+		auto name = CoverageAgent::GetObjectName(
+		    CoverageAgent::SharedMemoryPrefix, processId);
+		hFileMapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE,
+		                                   nullptr,
+		                                   PAGE_READWRITE,
+		                                   static_cast<DWORD>(size >> 32),
+		                                   static_cast<DWORD>(size),
+		                                   name.c_str());
+		if (!hFileMapping_)
+			THROW_LAST_ERROR(L"Cannot create shared memory " << name, GetLastError());
+
+		header_ = static_cast<CoverageAgent::SharedHeader*>(
+		    MapViewOfFile(hFileMapping_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+		if (!header_)
+		{
+			auto lastError = GetLastError();
+			CloseHandle(hFileMapping_);
+			THROW_LAST_ERROR(L"Cannot map shared memory " << name, lastError);
+		}
+
+		// The mapping is zero initialized: all slots are empty.
+		header_->version_ = CoverageAgent::SharedDataVersion;
+		header_->hostProcessId_ = GetCurrentProcessId();
+		header_->patchCapacity_ = patchCapacity;
+
+		hModuleEvent_ =
+		    CreateAgentEvent(CoverageAgent::ModuleEventPrefix, processId);
+		hModuleHandledEvent_ =
+		    CreateAgentEvent(CoverageAgent::ModuleHandledEventPrefix, processId);
+	}
+
+	//-------------------------------------------------------------------------
+	InProcessAgent::~InProcessAgent()
+	{
+		// Do not leave the loader of the process waiting for us.
+		if (hModuleHandledEvent_)
+		{
+			SetEvent(hModuleHandledEvent_);
+			CloseHandle(hModuleHandledEvent_);
+		}
+		if (hModuleEvent_)
+			CloseHandle(hModuleEvent_);
+		if (header_)
+			UnmapViewOfFile(header_);
+		if (hFileMapping_)
+			CloseHandle(hFileMapping_);
+	}
+
+	//-------------------------------------------------------------------------
+	void InProcessAgent::Inject(const std::filesystem::path& agentPath)
+	{
+		auto path = agentPath.wstring();
+		auto size = (path.size() + 1) * sizeof(wchar_t);
+		auto remotePath = VirtualAllocEx(
+		    hProcess_, nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+
+		if (!remotePath)
+			THROW_LAST_ERROR("Error in VirtualAllocEx:", GetLastError());
+		Tools::ScopedAction releaseRemotePath{
+		    [&] { VirtualFreeEx(hProcess_, remotePath, 0, MEM_RELEASE); }};
+
+		Tools::WriteProcessMemory(hProcess_, remotePath, &path[0], size);
+
+		// kernel32.dll is loaded at the same address in all processes.
+		auto loadLibrary = reinterpret_cast<LPTHREAD_START_ROUTINE>(
+		    GetProcAddress(GetModuleHandleW(L"kernel32.dll"), "LoadLibraryW"));
+		auto hThread = CreateRemoteThread(
+		    hProcess_, nullptr, 0, loadLibrary, remotePath, 0, nullptr);
+		if (!hThread)
+			THROW_LAST_ERROR("Error in CreateRemoteThread:", GetLastError());
+
+		auto thread = CreateHandle(hThread, CloseHandle);
+		DWORD exitCode = 0;
+
+		if (WaitForSingleObject(hThread, INFINITE) != WAIT_OBJECT_0 ||
+		    !GetExitCodeThread(hThread, &exitCode) || exitCode == 0)
+		{
+			THROW(L"Cannot load " << path << L" in the process.");
+		}
+		LOG_DEBUG << L"In-process agent loaded: " << path;
+	}
+
+	//-------------------------------------------------------------------------
+	void InProcessAgent::AddBreakPoints(
+	    const BreakPoint::InstructionCollection& instructions)
+	{
+		auto patchCapacity = header_->patchCapacity_;
+		auto* entries = CoverageAgent::GetPatchEntries(*header_);
+		auto* hitBitmap = CoverageAgent::GetHitBitmap(*header_);
+
+		for (const auto& instruction : instructions)
+		{
+			auto address = static_cast<uint64_t>(instruction.second);
+
+			if (CoverageAgent::FindSlot(entries, patchCapacity, address) >= 0)
+				continue;
+
+			// Keep at least half of the slots empty for short probe sequences.
+			if ((breakPointCount_ + 1) * 2 > patchCapacity)
+				THROW("Too many breakpoints for the in-process agent.");
+
+			auto slot = CoverageAgent::GetFirstSlot(address, patchCapacity);
+			while (IsBreakPointAddress(entries[slot].address_))
+				slot = (slot + 1) & (patchCapacity - 1);
+
+			auto& entry = entries[slot];
+			entry.originalInstruction_ = instruction.first;
+			_interlockedbittestandreset(&hitBitmap[slot / 32],
+			                            static_cast<LONG>(slot % 32));
+			MemoryBarrier();
+			entry.address_ = address;
+			++breakPointCount_;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<InProcessAgent::ModuleEvent>
+	InProcessAgent::WaitForModuleEvent()
+	{
+		HANDLE handles[] = {hModuleEvent_, hProcess_};
+
+		auto result = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+		if (result == WAIT_OBJECT_0 + 1)
+			return boost::none;
+		if (result != WAIT_OBJECT_0)
+			THROW_LAST_ERROR("Error in WaitForMultipleObjects:", GetLastError());
+
+		ModuleEvent moduleEvent;
+		moduleEvent.isLoaded_ = header_->notification_ ==
+		                        CoverageAgent::ModuleNotification::Loaded;
+		moduleEvent.baseOfImage_ =
+		    reinterpret_cast<void*>(header_->moduleBase_);
+		moduleEvent.size_ = header_->moduleSize_;
+		moduleEvent.path_ = header_->modulePath_;
+
+		return moduleEvent;
+	}
+
+	//-------------------------------------------------------------------------
+	void InProcessAgent::OnModuleEventHandled()
+	{
+		if (!SetEvent(hModuleHandledEvent_))
+			THROW_LAST_ERROR("Error in SetEvent:", GetLastError());
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<DWORD64> InProcessAgent::RemoveBreakPoints(DWORD64 begin,
+	                                                       DWORD64 end)
+	{
+		std::vector<DWORD64> executedAddresses;
+		auto* entries = CoverageAgent::GetPatchEntries(*header_);
+
+		for (uint32_t slot = 0; slot < header_->patchCapacity_; ++slot)
+		{
+			auto& entry = entries[slot];
+			auto address = entry.address_;
+
+			if (IsBreakPointAddress(address) && address >= begin &&
+			    address < end)
+			{
+				if (IsExecuted(slot))
+					executedAddresses.push_back(address);
+				// Keep the probe sequences valid.
+				entry.address_ = CoverageAgent::RemovedPatchAddress;
+				--breakPointCount_;
+			}
+		}
+		return executedAddresses;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<DWORD64> InProcessAgent::GetExecutedAddresses() const
+	{
+		std::vector<DWORD64> executedAddresses;
+		const auto* entries = CoverageAgent::GetPatchEntries(*header_);
+
+		for (uint32_t slot = 0; slot < header_->patchCapacity_; ++slot)
+		{
+			auto address = entries[slot].address_;
+			if (IsBreakPointAddress(address) && IsExecuted(slot))
+				executedAddresses.push_back(address);
+		}
+		return executedAddresses;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t InProcessAgent::GetExecutedAddressCount() const
+	{
+		return static_cast<size_t>(header_->hitCount_);
+	}
+
+	//-------------------------------------------------------------------------
+	bool InProcessAgent::IsExecuted(uint32_t slot) const
+	{
+		const auto* hitBitmap = CoverageAgent::GetHitBitmap(*header_);
+		return (static_cast<ULONG>(hitBitmap[slot / 32]) & (1u << (slot % 32))) != 0;
+	}
+}
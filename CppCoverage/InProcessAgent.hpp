@@ -0,0 +1,80 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Windows.h>
+#include <filesystem>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "BreakPoint.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CoverageAgent
+{
+	struct SharedHeader;
+}
+
+namespace CppCoverage
+{
+	// Host side of CoverageAgent.dll. The agent handles breakpoints inside the
+	// process with a vectored exception handler so there is no debugger
+	// round-trip per hit. Breakpoints are published through a shared patch
+	// table and hits are read back from a shared bitmap.
+	class CPPCOVERAGE_DLL InProcessAgent
+	{
+	  public:
+		static const std::wstring AgentFilename;
+		static const uint32_t DefaultPatchCapacity;
+
+		struct ModuleEvent
+		{
+			bool isLoaded_;
+			void* baseOfImage_;
+			DWORD64 size_;
+			std::filesystem::path path_;
+		};
+
+		InProcessAgent(HANDLE hProcess, DWORD processId, uint32_t patchCapacity);
+		~InProcessAgent();
+
+		void Inject(const std::filesystem::path& agentPath);
+		void AddBreakPoints(const BreakPoint::InstructionCollection&);
+
+		// Return boost::none when the process exits.
+		boost::optional<ModuleEvent> WaitForModuleEvent();
+		void OnModuleEventHandled();
+
+		// Forget the breakpoints in [begin, end) and return the executed ones.
+		std::vector<DWORD64> RemoveBreakPoints(DWORD64 begin, DWORD64 end);
+		std::vector<DWORD64> GetExecutedAddresses() const;
+		size_t GetExecutedAddressCount() const;
+
+	  private:
+		InProcessAgent(const InProcessAgent&) = delete;
+		InProcessAgent& operator=(const InProcessAgent&) = delete;
+
+		bool IsExecuted(uint32_t slot) const;
+
+		HANDLE hProcess_;
+		HANDLE hFileMapping_;
+		HANDLE hModuleEvent_;
+		HANDLE hModuleHandledEvent_;
+		CoverageAgent::SharedHeader* header_;
+		size_t breakPointCount_;
+	};
+}
@@ -0,0 +1,446 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "InstructionDecoder.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class Reader
+		{
+		public:
+			Reader(const uint8_t* code, size_t size)
+				: code_{ code }
+				, size_{ size }
+			{
+			}
+
+			bool Peek(uint8_t& value) const
+			{
+				if (position_ >= size_)
+					return false;
+				value = code_[position_];
+				return true;
+			}
+
+			bool Read(uint8_t& value)
+			{
+				if (!Peek(value))
+					return false;
+				++position_;
+				return true;
+			}
+
+			bool Skip(size_t count)
+			{
+				if (size_ - position_ < count)
+					return false;
+				position_ += count;
+				return true;
+			}
+
+			bool ReadSigned(size_t count, int64_t& value)
+			{
+				if (size_ - position_ < count)
+					return false;
+				uint64_t result = 0;
+				for (size_t i = 0; i < count; ++i)
+					result |= static_cast<uint64_t>(code_[position_ + i]) << (8 * i);
+				position_ += count;
+				auto shift = 64 - 8 * count;
+				value = static_cast<int64_t>(result << shift) >> shift;
+				return true;
+			}
+
+			size_t GetPosition() const
+			{
+				return position_;
+			}
+
+			void SetRipRelative()
+			{
+				isRipRelative_ = true;
+			}
+
+			bool IsRipRelative() const
+			{
+				return isRipRelative_;
+			}
+
+		private:
+			const uint8_t* code_;
+			size_t size_;
+			size_t position_ = 0;
+			bool isRipRelative_ = false;
+		};
+
+		//---------------------------------------------------------------------
+		struct Prefixes
+		{
+			bool operandSize_ = false;
+			bool addressSize_ = false;
+			bool rexW_ = false;
+		};
+
+		//---------------------------------------------------------------------
+		bool SkipModRm(Reader& reader, bool is64Bits, const Prefixes& prefixes, uint8_t& modRm)
+		{
+			if (!reader.Read(modRm))
+				return false;
+
+			// 16 bits addressing is not supported.
+			if (!is64Bits && prefixes.addressSize_)
+				return false;
+
+			auto mod = modRm >> 6;
+			auto rm = modRm & 7;
+
+			if (mod == 3)
+				return true;
+
+			size_t displacement = (mod == 1) ? 1 : (mod == 2) ? 4 : 0;
+			if (rm == 4)
+			{
+				uint8_t sib = 0;
+				if (!reader.Read(sib))
+					return false;
+				if (mod == 0 && (sib & 7) == 5)
+					displacement = 4;
+			}
+			else if (mod == 0 && rm == 5)
+			{
+				displacement = 4;
+				if (is64Bits)
+					reader.SetRipRelative();
+			}
+
+			return reader.Skip(displacement);
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetImmediateSize(const Prefixes& prefixes)
+		{
+			return (prefixes.operandSize_ && !prefixes.rexW_) ? 2 : 4;
+		}
+
+		//---------------------------------------------------------------------
+		bool HasTwoBytesModRm(uint8_t opcode)
+		{
+			switch (opcode)
+			{
+			case 0x05: case 0x06: case 0x07: case 0x08: case 0x09:
+			case 0x0B: case 0x0E: case 0x30: case 0x31: case 0x32:
+			case 0x33: case 0x34: case 0x35: case 0x37: case 0x77:
+			case 0xA0: case 0xA1: case 0xA2: case 0xA8: case 0xA9:
+			case 0xAA:
+				return false;
+			}
+			return !(opcode >= 0x80 && opcode <= 0x8F) && !(opcode >= 0xC8 && opcode <= 0xCF);
+		}
+
+		//---------------------------------------------------------------------
+		bool HasTwoBytesImmediate8(uint8_t opcode)
+		{
+			switch (opcode)
+			{
+			case 0x70: case 0x71: case 0x72: case 0x73: case 0xA4:
+			case 0xAC: case 0xBA: case 0xC2: case 0xC4: case 0xC5:
+			case 0xC6:
+				return true;
+			}
+			return false;
+		}
+
+		//---------------------------------------------------------------------
+		// Decode VEX and EVEX instructions. The opcode map is 1 for 0F, 2 for 0F38
+		// and 3 for 0F3A.
+		bool DecodeVectorInstruction(
+			Reader& reader,
+			size_t payloadSize,
+			bool is64Bits,
+			const Prefixes& prefixes)
+		{
+			uint8_t payload = 0;
+			if (!reader.Peek(payload))
+				return false;
+			auto map = (payloadSize == 1) ? 1 : (payloadSize == 2) ? (payload & 0x1F) : (payload & 0x07);
+			if (map < 1 || map > 3 || !reader.Skip(payloadSize))
+				return false;
+
+			uint8_t opcode = 0;
+			if (!reader.Read(opcode))
+				return false;
+
+			// vzeroupper and vzeroall
+			if (map == 1 && opcode == 0x77)
+				return true;
+
+			uint8_t modRm = 0;
+			if (!SkipModRm(reader, is64Bits, prefixes, modRm))
+				return false;
+			if (map == 3 || (map == 1 && HasTwoBytesImmediate8(opcode)))
+				return reader.Skip(1);
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		bool DecodeRelative(
+			Reader& reader,
+			size_t size,
+			uint64_t address,
+			bool is64Bits,
+			InstructionFlow flow,
+			DecodedInstruction& instruction)
+		{
+			int64_t offset = 0;
+			if (!reader.ReadSigned(size, offset))
+				return false;
+			auto target = address + reader.GetPosition() + static_cast<uint64_t>(offset);
+			instruction.flow_ = flow;
+			instruction.target_ = is64Bits ? target : (target & 0xFFFFFFFF);
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		bool DecodeTwoBytesOpcode(
+			Reader& reader,
+			uint64_t address,
+			bool is64Bits,
+			const Prefixes& prefixes,
+			DecodedInstruction& instruction)
+		{
+			uint8_t opcode = 0;
+			if (!reader.Read(opcode))
+				return false;
+
+			uint8_t modRm = 0;
+			if (opcode == 0x38)
+			{
+				return reader.Skip(1) && SkipModRm(reader, is64Bits, prefixes, modRm);
+			}
+			if (opcode == 0x3A)
+			{
+				return reader.Skip(1) && SkipModRm(reader, is64Bits, prefixes, modRm)
+					&& reader.Skip(1);
+			}
+			// 3DNow! instructions are not supported.
+			if (opcode == 0x0F)
+				return false;
+			if (opcode >= 0x80 && opcode <= 0x8F)
+			{
+				if (prefixes.operandSize_)
+					return false;
+				return DecodeRelative(reader, 4, address, is64Bits, InstructionFlow::ConditionalJump, instruction);
+			}
+			if (opcode == 0x0B) // ud2
+				instruction.flow_ = InstructionFlow::Interrupt;
+			if (!HasTwoBytesModRm(opcode))
+				return true;
+			if (!SkipModRm(reader, is64Bits, prefixes, modRm))
+				return false;
+			return !HasTwoBytesImmediate8(opcode) || reader.Skip(1);
+		}
+
+		//---------------------------------------------------------------------
+		bool DecodeGroup5(uint8_t modRm, DecodedInstruction& instruction)
+		{
+			auto reg = (modRm >> 3) & 7;
+			if (reg == 2 || reg == 3)
+				instruction.flow_ = InstructionFlow::Call;
+			else if (reg == 4 || reg == 5)
+			{
+				// jmp [absolute or rip relative address] is used for import thunks
+				// and tail calls. Other indirect jumps may target this function.
+				auto isMemoryJump = (modRm & 0xC7) == 0x05;
+				instruction.flow_ = isMemoryJump ? InstructionFlow::Return : InstructionFlow::IndirectJump;
+			}
+			return true;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<DecodedInstruction> DecodeInstruction(
+		const uint8_t* code,
+		size_t size,
+		uint64_t address,
+		bool is64Bits)
+	{
+		Reader reader{ code, size };
+		Prefixes prefixes;
+		DecodedInstruction instruction;
+		uint8_t opcode = 0;
+
+		for (;;)
+		{
+			if (!reader.Read(opcode))
+				return boost::none;
+			if (opcode == 0x66)
+				prefixes.operandSize_ = true;
+			else if (opcode == 0x67)
+				prefixes.addressSize_ = true;
+			else if (opcode == 0xF0 || opcode == 0xF2 || opcode == 0xF3 || opcode == 0x2E
+				|| opcode == 0x36 || opcode == 0x3E || opcode == 0x26 || opcode == 0x64
+				|| opcode == 0x65)
+			{
+			}
+			else
+				break;
+		}
+
+		if (is64Bits && (opcode & 0xF0) == 0x40)
+		{
+			prefixes.rexW_ = (opcode & 0x08) != 0;
+			if (!reader.Read(opcode))
+				return boost::none;
+		}
+
+		uint8_t modRm = 0;
+		bool isValid = false;
+
+		if (opcode < 0x40 && (opcode & 7) < 6)
+		{
+			// Arithmetic instructions: add, or, adc, sbb, and, sub, xor, cmp.
+			switch (opcode & 7)
+			{
+			case 4: isValid = reader.Skip(1); break;
+			case 5: isValid = reader.Skip(GetImmediateSize(prefixes)); break;
+			default: isValid = SkipModRm(reader, is64Bits, prefixes, modRm); break;
+			}
+		}
+		else if (opcode == 0x0F)
+			isValid = DecodeTwoBytesOpcode(reader, address, is64Bits, prefixes, instruction);
+		else if (opcode < 0x40)
+			isValid = !is64Bits; // push/pop segment, daa, das, aaa, aas
+		else if (opcode < 0x60)
+			isValid = true; // inc, dec, push, pop
+		else if (opcode >= 0x70 && opcode <= 0x7F)
+			isValid = DecodeRelative(reader, 1, address, is64Bits, InstructionFlow::ConditionalJump, instruction);
+		else if (opcode >= 0x84 && opcode <= 0x8F)
+			isValid = SkipModRm(reader, is64Bits, prefixes, modRm);
+		else if (opcode >= 0x90 && opcode <= 0x9F)
+			isValid = opcode != 0x9A;
+		else if (opcode >= 0xA0 && opcode <= 0xA3)
+		{
+			// mov with a memory offset: 16 bits addressing is not supported.
+			if (is64Bits)
+				isValid = reader.Skip(prefixes.addressSize_ ? 4 : 8);
+			else
+				isValid = !prefixes.addressSize_ && reader.Skip(4);
+		}
+		else if (opcode >= 0xB0 && opcode <= 0xB7)
+			isValid = reader.Skip(1);
+		else if (opcode >= 0xB8 && opcode <= 0xBF)
+			isValid = reader.Skip(prefixes.rexW_ ? 8 : GetImmediateSize(prefixes));
+		else if (opcode >= 0xD8 && opcode <= 0xDF)
+			isValid = SkipModRm(reader, is64Bits, prefixes, modRm); // x87
+		else
+		{
+			switch (opcode)
+			{
+			case 0x60: case 0x61: isValid = !is64Bits; break;
+			case 0x62:
+			{
+				uint8_t next = 0;
+				if (is64Bits || (reader.Peek(next) && (next & 0xC0) == 0xC0))
+					isValid = DecodeVectorInstruction(reader, 3, is64Bits, prefixes);
+				else
+					isValid = SkipModRm(reader, is64Bits, prefixes, modRm);
+				break;
+			}
+			case 0x63: isValid = SkipModRm(reader, is64Bits, prefixes, modRm); break;
+			case 0x68: isValid = reader.Skip(GetImmediateSize(prefixes)); break;
+			case 0x69: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(GetImmediateSize(prefixes)); break;
+			case 0x6A: isValid = reader.Skip(1); break;
+			case 0x6B: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(1); break;
+			case 0x6C: case 0x6D: case 0x6E: case 0x6F: isValid = true; break;
+			case 0x80: case 0x82: case 0x83:
+				isValid = (opcode != 0x82 || !is64Bits) && SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(1);
+				break;
+			case 0x81: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(GetImmediateSize(prefixes)); break;
+			case 0xA4: case 0xA5: case 0xA6: case 0xA7: case 0xAA: case 0xAB:
+			case 0xAC: case 0xAD: case 0xAE: case 0xAF:
+				isValid = true;
+				break;
+			case 0xA8: isValid = reader.Skip(1); break;
+			case 0xA9: isValid = reader.Skip(GetImmediateSize(prefixes)); break;
+			case 0xC0: case 0xC1: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(1); break;
+			case 0xC2: case 0xCA:
+				instruction.flow_ = InstructionFlow::Return;
+				isValid = reader.Skip(2);
+				break;
+			case 0xC3: case 0xCB: case 0xCF:
+				instruction.flow_ = InstructionFlow::Return;
+				isValid = true;
+				break;
+			case 0xC4: case 0xC5:
+			{
+				uint8_t next = 0;
+				if (is64Bits || (reader.Peek(next) && (next & 0xC0) == 0xC0))
+					isValid = DecodeVectorInstruction(reader, opcode == 0xC4 ? 2 : 1, is64Bits, prefixes);
+				else
+					isValid = SkipModRm(reader, is64Bits, prefixes, modRm);
+				break;
+			}
+			case 0xC6: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(1); break;
+			case 0xC7: isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && reader.Skip(GetImmediateSize(prefixes)); break;
+			case 0xC8: isValid = reader.Skip(3); break;
+			case 0xC9: isValid = true; break;
+			case 0xCC: case 0xCE: case 0xF1: case 0xF4:
+				instruction.flow_ = InstructionFlow::Interrupt;
+				isValid = true;
+				break;
+			case 0xCD:
+				instruction.flow_ = InstructionFlow::Interrupt;
+				isValid = reader.Skip(1);
+				break;
+			case 0xD0: case 0xD1: case 0xD2: case 0xD3: isValid = SkipModRm(reader, is64Bits, prefixes, modRm); break;
+			case 0xD4: case 0xD5: isValid = !is64Bits && reader.Skip(1); break;
+			case 0xD6: case 0xD7: isValid = true; break;
+			case 0xE0: case 0xE1: case 0xE2: case 0xE3:
+				isValid = DecodeRelative(reader, 1, address, is64Bits, InstructionFlow::ConditionalJump, instruction);
+				break;
+			case 0xE4: case 0xE5: case 0xE6: case 0xE7: isValid = reader.Skip(1); break;
+			case 0xE8: case 0xE9:
+				isValid = !prefixes.operandSize_ && DecodeRelative(reader, 4, address, is64Bits,
+					opcode == 0xE8 ? InstructionFlow::Call : InstructionFlow::Jump, instruction);
+				break;
+			case 0xEB: isValid = DecodeRelative(reader, 1, address, is64Bits, InstructionFlow::Jump, instruction); break;
+			case 0xEC: case 0xED: case 0xEE: case 0xEF: case 0xF5: case 0xF8: case 0xF9:
+			case 0xFA: case 0xFB: case 0xFC: case 0xFD:
+				isValid = true;
+				break;
+			case 0xF6: case 0xF7:
+				isValid = SkipModRm(reader, is64Bits, prefixes, modRm);
+				if (isValid && ((modRm >> 3) & 7) < 2)
+					isValid = reader.Skip(opcode == 0xF6 ? 1 : GetImmediateSize(prefixes));
+				break;
+			case 0xFE: isValid = SkipModRm(reader, is64Bits, prefixes, modRm); break;
+			case 0xFF:
+				isValid = SkipModRm(reader, is64Bits, prefixes, modRm) && DecodeGroup5(modRm, instruction);
+				break;
+			}
+		}
+
+		if (!isValid)
+			return boost::none;
+		instruction.length_ = reader.GetPosition();
+		instruction.isRipRelative_ = reader.IsRipRelative();
+		return instruction;
+	}
+}
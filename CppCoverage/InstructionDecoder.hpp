@@ -0,0 +1,56 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	enum class InstructionFlow
+	{
+		Sequential,
+		Jump,
+		ConditionalJump,
+		Call,
+		Return,
+		IndirectJump,
+		Interrupt
+	};
+
+	struct DecodedInstruction
+	{
+		size_t length_ = 0;
+		InstructionFlow flow_ = InstructionFlow::Sequential;
+		// Set for relative jumps and calls.
+		boost::optional<uint64_t> target_;
+		// Set when an operand is addressed relatively to rip in 64 bits.
+		bool isRipRelative_ = false;
+	};
+
+	// Minimal x86/x64 decoder: it only computes the instruction length and
+	// how the instruction changes the control flow.
+	// Return boost::none if the instruction is unknown or truncated.
+	CPPCOVERAGE_DLL boost::optional<DecodedInstruction> DecodeInstruction(
+		const uint8_t* code,
+		size_t size,
+		uint64_t address,
+		bool is64Bits);
+}
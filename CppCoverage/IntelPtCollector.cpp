@@ -0,0 +1,467 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "IntelPtCollector.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <unordered_map>
+
+#include <intrin.h>
+#include <winioctl.h>
+
+#include "CppCoverageException.hpp"
+#include "IntelPtDecoder.hpp"
+#include "Process.hpp"
+
+#include "Tools/Log.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		// Requests of the Intel Processor Trace driver of Windows (ipt.sys).
+		const wchar_t* IptDevice = L"\\\\.\\IPT";
+		const DWORD IoctlIptRequest = CTL_CODE(FILE_DEVICE_UNKNOWN, 1, METHOD_BUFFERED, FILE_ANY_ACCESS);
+		const DWORD IoctlIptReadTrace = CTL_CODE(FILE_DEVICE_UNKNOWN, 1, METHOD_OUT_DIRECT, FILE_ANY_ACCESS);
+		const USHORT IptBufferMajorVersion = 1;
+		const USHORT IptBufferMinorVersion = 0;
+		const USHORT IptTraceVersion = 1;
+		const unsigned int MaxBufferSizePow2 = 15;
+		const uint64_t PageSize = 4096;
+
+		enum class IptInputType : uint32_t
+		{
+			GetTraceVersion = 0,
+			GetProcessTraceSize = 1,
+			GetProcessTrace = 2,
+			StartProcessTrace = 5,
+			StopProcessTrace = 6
+		};
+
+		struct IptInputBuffer
+		{
+			USHORT bufferMajorVersion_;
+			USHORT bufferMinorVersion_;
+			IptInputType inputType_;
+			union
+			{
+				struct
+				{
+					USHORT traceVersion_;
+					ULONG64 processHandle_;
+				} getProcessTrace_;
+				struct
+				{
+					ULONG64 processHandle_;
+					ULONG64 options_;
+				} startProcessTrace_;
+				struct
+				{
+					ULONG64 processHandle_;
+				} stopProcessTrace_;
+			};
+		};
+
+		struct IptOutputBuffer
+		{
+			USHORT bufferMajorVersion_;
+			USHORT bufferMinorVersion_;
+			union
+			{
+				struct
+				{
+					USHORT traceVersion_;
+				} getTraceVersion_;
+				struct
+				{
+					USHORT traceVersion_;
+					ULONG64 traceSize_;
+				} getTraceSize_;
+			};
+		};
+
+#pragma pack(push, 4)
+		// Followed by the IptTraceHeader of each thread.
+		struct IptTraceData
+		{
+			USHORT traceVersion_;
+			USHORT validTrace_;
+			ULONG traceSize_;
+		};
+
+		// Followed by the ring buffer of the thread.
+		struct IptTraceHeader
+		{
+			ULONG64 threadId_;
+			uint32_t timingSettings_;
+			ULONG mtcFrequency_;
+			ULONG frequencyToTscRatio_;
+			ULONG ringBufferOffset_;
+			ULONG traceSize_;
+		};
+#pragma pack(pop)
+
+		//---------------------------------------------------------------------
+		IptInputBuffer CreateInput(IptInputType inputType)
+		{
+			IptInputBuffer input{};
+
+			input.bufferMajorVersion_ = IptBufferMajorVersion;
+			input.bufferMinorVersion_ = IptBufferMinorVersion;
+			input.inputType_ = inputType;
+			return input;
+		}
+
+		//---------------------------------------------------------------------
+		bool SendRequest(HANDLE hDevice,
+		                 DWORD ioControlCode,
+		                 const IptInputBuffer& input,
+		                 void* output,
+		                 size_t outputSize)
+		{
+			DWORD returnedSize = 0;
+
+			return DeviceIoControl(hDevice,
+			                       ioControlCode,
+			                       const_cast<IptInputBuffer*>(&input),
+			                       sizeof(input),
+			                       output,
+			                       static_cast<DWORD>(outputSize),
+			                       &returnedSize,
+			                       nullptr) != FALSE;
+		}
+
+		//---------------------------------------------------------------------
+		HANDLE OpenDevice()
+		{
+			return CreateFileW(IptDevice,
+			                   FILE_GENERIC_READ,
+			                   FILE_SHARE_READ | FILE_SHARE_WRITE,
+			                   nullptr,
+			                   OPEN_EXISTING,
+			                   FILE_FLAG_SEQUENTIAL_SCAN,
+			                   nullptr);
+		}
+
+		//---------------------------------------------------------------------
+		// No timing packet and only the user mode is traced. The children
+		// are traced when their creation is reported to the debugger.
+		ULONG64 CreateOptions(unsigned int bufferSizePow2)
+		{
+			const ULONG64 optionVersion = 1;
+			return optionVersion | (static_cast<ULONG64>(bufferSizePow2) << 16);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	struct IntelPtCollector::Process
+	{
+		//---------------------------------------------------------------------
+		Process(HANDLE hProcess, bool is64Bits)
+		    : hProcess_{hProcess},
+		      is64Bits_{is64Bits},
+		      image_{[this](uint64_t address, uint8_t* buffer, size_t size) {
+			      return ReadCode(address, buffer, size);
+		      }}
+		{
+		}
+
+		//---------------------------------------------------------------------
+		// The code is not modified as no breakpoint is set: the pages are
+		// read once.
+		size_t ReadCode(uint64_t address, uint8_t* buffer, size_t size)
+		{
+			size_t copiedSize = 0;
+
+			while (copiedSize < size)
+			{
+				auto current = address + copiedSize;
+				auto pageAddress = current & ~(PageSize - 1);
+				auto it = pages_.find(pageAddress);
+
+				if (it == pages_.end())
+				{
+					std::vector<uint8_t> page(static_cast<size_t>(PageSize));
+					SIZE_T readSize = 0;
+					if (!ReadProcessMemory(hProcess_,
+					                       reinterpret_cast<void*>(pageAddress),
+					                       page.data(),
+					                       page.size(),
+					                       &readSize) ||
+					    readSize != page.size())
+						break;
+					it = pages_.emplace(pageAddress, std::move(page)).first;
+				}
+				auto offset = static_cast<size_t>(current - pageAddress);
+				auto pageCopiedSize = (std::min)(it->second.size() - offset, size - copiedSize);
+				std::memcpy(buffer + copiedSize, it->second.data() + offset, pageCopiedSize);
+				copiedSize += pageCopiedSize;
+			}
+			return copiedSize;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetErrorCount() const
+		{
+			size_t errorCount = 0;
+			for (const auto& pair : threads_)
+				errorCount += pair.second.decoder_->GetErrorCount();
+			return errorCount;
+		}
+
+		struct Thread
+		{
+			std::unique_ptr<IntelPtDecoder> decoder_;
+			ULONG ringBufferOffset_ = 0;
+		};
+
+		const HANDLE hProcess_;
+		const bool is64Bits_;
+		std::unordered_map<uint64_t, std::vector<uint8_t>> pages_;
+		IntelPtImage image_;
+		std::map<ULONG64, Thread> threads_;
+		// Registered addresses not executed yet.
+		std::set<DWORD64> addresses_;
+	};
+
+	//-------------------------------------------------------------------------
+	bool IntelPtCollector::IsSupported()
+	{
+		int cpuInfo[4] = {};
+
+		__cpuid(cpuInfo, 0);
+		if (cpuInfo[0] < 0x14)
+			return false;
+		__cpuidex(cpuInfo, 7, 0);
+		if (!(cpuInfo[1] & (1 << 25)))
+			return false;
+
+		auto hDevice = OpenDevice();
+		if (hDevice == INVALID_HANDLE_VALUE)
+			return false;
+
+		IptOutputBuffer output{};
+		auto isSupported = SendRequest(hDevice,
+		                               IoctlIptRequest,
+		                               CreateInput(IptInputType::GetTraceVersion),
+		                               &output,
+		                               sizeof(output)) &&
+		                   output.getTraceVersion_.traceVersion_ == IptTraceVersion;
+		CloseHandle(hDevice);
+		return isSupported;
+	}
+
+	//-------------------------------------------------------------------------
+	IntelPtCollector::IntelPtCollector(unsigned int bufferSizePow2)
+	    : hDevice_{OpenDevice()},
+	      bufferSizePow2_{(std::min)(bufferSizePow2, MaxBufferSizePow2)},
+	      decodedSize_{0},
+	      exitedProcessErrorCount_{0}
+	{
+		if (hDevice_ == INVALID_HANDLE_VALUE)
+			THROW_LAST_ERROR("Cannot open the Intel Processor Trace driver: ", GetLastError());
+	}
+
+	//-------------------------------------------------------------------------
+	IntelPtCollector::~IntelPtCollector()
+	{
+		for (const auto& pair : processes_)
+			StopProcessTrace(pair.first);
+		CloseHandle(hDevice_);
+	}
+
+	//-------------------------------------------------------------------------
+	bool IntelPtCollector::StartProcessTrace(HANDLE hProcess)
+	{
+		auto input = CreateInput(IptInputType::StartProcessTrace);
+		input.startProcessTrace_.processHandle_ = reinterpret_cast<ULONG64>(hProcess);
+		input.startProcessTrace_.options_ = CreateOptions(bufferSizePow2_);
+
+		IptOutputBuffer output{};
+		if (!SendRequest(hDevice_, IoctlIptRequest, input, &output, sizeof(output)))
+		{
+			LOG_WARNING << L"Cannot start Intel Processor Trace for the process "
+			            << GetProcessId(hProcess) << L": "
+			            << GetErrorMessage(GetLastError());
+			return false;
+		}
+
+		processes_[hProcess] = std::make_unique<Process>(hProcess, CppCoverage::Process::Is64Bits(hProcess));
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool IntelPtCollector::AddAddresses(HANDLE hProcess,
+	                                    const std::vector<DWORD64>& addresses)
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it == processes_.end())
+			return false;
+		it->second->addresses_.insert(addresses.begin(), addresses.end());
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Address> IntelPtCollector::Collect(HANDLE hProcess)
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it == processes_.end())
+			return {};
+
+		auto& process = *it->second;
+		ReadTrace(process);
+
+		std::vector<Address> addresses;
+		for (const auto& range : process.image_.TakeExecutedRanges())
+		{
+			auto first = process.addresses_.lower_bound(range.first);
+			auto last = process.addresses_.lower_bound(range.second);
+			for (auto addressIt = first; addressIt != last; ++addressIt)
+				addresses.emplace_back(hProcess, reinterpret_cast<void*>(*addressIt));
+			process.addresses_.erase(first, last);
+		}
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<Address> IntelPtCollector::CollectAll()
+	{
+		std::vector<Address> addresses;
+
+		for (const auto& pair : processes_)
+		{
+			for (const auto& address : Collect(pair.first))
+				addresses.push_back(address);
+		}
+		return addresses;
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtCollector::OnUnloadModule(HANDLE hProcess)
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it != processes_.end())
+		{
+			it->second->image_.Clear();
+			it->second->pages_.clear();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtCollector::OnExitProcess(HANDLE hProcess)
+	{
+		auto it = processes_.find(hProcess);
+
+		if (it == processes_.end())
+			return;
+		exitedProcessErrorCount_ += it->second->GetErrorCount();
+		StopProcessTrace(hProcess);
+		processes_.erase(it);
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t IntelPtCollector::GetDecodedSize() const
+	{
+		return decodedSize_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t IntelPtCollector::GetErrorCount() const
+	{
+		auto errorCount = exitedProcessErrorCount_;
+
+		for (const auto& pair : processes_)
+			errorCount += pair.second->GetErrorCount();
+		return errorCount;
+	}
+
+	//-------------------------------------------------------------------------
+	// Only the bytes written since the previous read are decoded. The older
+	// bytes are lost if the ring buffer of a thread wraps between two reads.
+	void IntelPtCollector::ReadTrace(Process& process)
+	{
+		auto input = CreateInput(IptInputType::GetProcessTraceSize);
+		input.getProcessTrace_.traceVersion_ = IptTraceVersion;
+		input.getProcessTrace_.processHandle_ = reinterpret_cast<ULONG64>(process.hProcess_);
+
+		IptOutputBuffer output{};
+		if (!SendRequest(hDevice_, IoctlIptRequest, input, &output, sizeof(output)))
+		{
+			LOG_DEBUG << L"Cannot read the size of Intel Processor Trace: " << GetLastError();
+			return;
+		}
+		traceBuffer_.resize(static_cast<size_t>(output.getTraceSize_.traceSize_));
+		input.inputType_ = IptInputType::GetProcessTrace;
+		if (traceBuffer_.size() < sizeof(IptTraceData) ||
+		    !SendRequest(hDevice_, IoctlIptReadTrace, input, traceBuffer_.data(), traceBuffer_.size()))
+		{
+			LOG_DEBUG << L"Cannot read Intel Processor Trace: " << GetLastError();
+			return;
+		}
+
+		IptTraceData traceData;
+		std::memcpy(&traceData, traceBuffer_.data(), sizeof(traceData));
+		auto end = (std::min)(traceBuffer_.size(), sizeof(traceData) + traceData.traceSize_);
+
+		for (auto offset = sizeof(traceData); offset + sizeof(IptTraceHeader) <= end;)
+		{
+			IptTraceHeader header;
+			std::memcpy(&header, traceBuffer_.data() + offset, sizeof(header));
+			offset += sizeof(header);
+			if (offset + header.traceSize_ > end || header.ringBufferOffset_ > header.traceSize_)
+				break;
+
+			const auto* ringBuffer = traceBuffer_.data() + offset;
+			auto& thread = process.threads_[header.threadId_];
+			if (!thread.decoder_)
+				thread.decoder_ = std::make_unique<IntelPtDecoder>(process.image_, process.is64Bits_);
+
+			auto ringBufferOffset = header.ringBufferOffset_;
+			auto previousOffset = thread.ringBufferOffset_;
+			if (ringBufferOffset >= previousOffset)
+			{
+				thread.decoder_->Decode(ringBuffer + previousOffset, ringBufferOffset - previousOffset);
+				decodedSize_ += ringBufferOffset - previousOffset;
+			}
+			else
+			{
+				thread.decoder_->Decode(ringBuffer + previousOffset, header.traceSize_ - previousOffset);
+				thread.decoder_->Decode(ringBuffer, ringBufferOffset);
+				decodedSize_ += header.traceSize_ - previousOffset + ringBufferOffset;
+			}
+			thread.ringBufferOffset_ = ringBufferOffset;
+			offset += header.traceSize_;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtCollector::StopProcessTrace(HANDLE hProcess)
+	{
+		auto input = CreateInput(IptInputType::StopProcessTrace);
+		input.stopProcessTrace_.processHandle_ = reinterpret_cast<ULONG64>(hProcess);
+
+		IptOutputBuffer output{};
+		if (!SendRequest(hDevice_, IoctlIptRequest, input, &output, sizeof(output)))
+			LOG_DEBUG << L"Cannot stop Intel Processor Trace: " << GetLastError();
+	}
+}
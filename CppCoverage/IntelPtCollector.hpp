@@ -0,0 +1,85 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <Windows.h>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Collect the coverage with the Intel Processor Trace driver of Windows
+	// instead of breakpoints. The trace of each thread is decoded
+	// incrementally and the registered addresses inside the executed code
+	// are returned: no breakpoint is hit so the overhead does not depend on
+	// the number of lines.
+	class CPPCOVERAGE_DLL IntelPtCollector
+	{
+	  public:
+		// The trace buffer of each thread is 4 KB * 2 ^ bufferSizePow2.
+		static const unsigned int DefaultBufferSizePow2 = 12;
+
+		// Return false if the processor does not support Intel Processor
+		// Trace or if the driver is not started.
+		static bool IsSupported();
+
+		explicit IntelPtCollector(unsigned int bufferSizePow2 = DefaultBufferSizePow2);
+		~IntelPtCollector();
+
+		// Return false if the process cannot be traced.
+		bool StartProcessTrace(HANDLE hProcess);
+
+		// Return false if the process is not traced: the caller should set
+		// the breakpoints of the addresses.
+		bool AddAddresses(HANDLE hProcess, const std::vector<DWORD64>&);
+
+		// Decode the trace written since the previous call and return the
+		// registered addresses executed.
+		std::vector<Address> Collect(HANDLE hProcess);
+		std::vector<Address> CollectAll();
+
+		// Call Collect before: the code of the module is not decoded anymore.
+		void OnUnloadModule(HANDLE hProcess);
+		// Call Collect before.
+		void OnExitProcess(HANDLE hProcess);
+
+		uint64_t GetDecodedSize() const;
+		size_t GetErrorCount() const;
+
+	  private:
+		IntelPtCollector(const IntelPtCollector&) = delete;
+		IntelPtCollector& operator=(const IntelPtCollector&) = delete;
+
+		struct Process;
+
+		void ReadTrace(Process&);
+		void StopProcessTrace(HANDLE hProcess);
+
+		HANDLE hDevice_;
+		const unsigned int bufferSizePow2_;
+		std::map<HANDLE, std::unique_ptr<Process>> processes_;
+		std::vector<uint8_t> traceBuffer_;
+		uint64_t decodedSize_;
+		size_t exitedProcessErrorCount_;
+	};
+}
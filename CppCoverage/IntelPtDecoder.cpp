@@ -0,0 +1,631 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "IntelPtDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const size_t MaxInstructionSize = 15;
+		const size_t CodeChunkSize = 256;
+		// A block without branch is split so its size is bounded.
+		const uint64_t MaxBlockSize = 4096;
+		const size_t MaxReturnAddressCount = 64;
+		// The flow is lost if the same packet leads to walk more blocks.
+		const size_t MaxWalkedBlockCount = 1000000;
+		const uint8_t PsbPattern[] = {0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82,
+		                              0x02, 0x82, 0x02, 0x82, 0x02, 0x82, 0x02, 0x82};
+
+		enum class PacketType
+		{
+			Pad,
+			Tnt,
+			Tip,
+			TipPge,
+			TipPgd,
+			Fup,
+			Psb,
+			PsbEnd,
+			Overflow,
+			ModeExec,
+			Other
+		};
+
+		enum class ReadResult
+		{
+			Complete,
+			Incomplete,
+			Invalid
+		};
+
+		//---------------------------------------------------------------------
+		uint64_t ReadLittleEndian(const uint8_t* data, size_t size)
+		{
+			uint64_t value = 0;
+
+			for (size_t i = 0; i < size; ++i)
+				value |= static_cast<uint64_t>(data[i]) << (8 * i);
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetIpPayloadSize(int ipBytes)
+		{
+			switch (ipBytes)
+			{
+				case 0: return 0;
+				case 1: return 2;
+				case 2: return 4;
+				case 3: return 6;
+				case 4: return 6;
+				case 6: return 8;
+			}
+			return static_cast<size_t>(-1);
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<size_t> FindPsb(const uint8_t* trace, size_t size)
+		{
+			auto it = std::search(trace, trace + size, std::begin(PsbPattern), std::end(PsbPattern));
+
+			if (it == trace + size)
+				return boost::none;
+			return static_cast<size_t>(it - trace);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	struct IntelPtDecoder::Packet
+	{
+		PacketType type_ = PacketType::Other;
+		size_t size_ = 0;
+		int ipBytes_ = 0;
+		uint64_t ipPayload_ = 0;
+		// The oldest branch is the most significant bit.
+		uint64_t tntBits_ = 0;
+		int tntCount_ = 0;
+		uint8_t modePayload_ = 0;
+	};
+
+	namespace
+	{
+		//---------------------------------------------------------------------
+		// The most significant bit set is the stop bit.
+		template <typename Packet>
+		ReadResult SetTnt(Packet& packet, uint64_t payload)
+		{
+			if (!payload)
+				return ReadResult::Invalid;
+			int stopBit = 63;
+			while (!(payload & (1ull << stopBit)))
+				--stopBit;
+			packet.type_ = PacketType::Tnt;
+			packet.tntCount_ = stopBit;
+			packet.tntBits_ = payload & ((1ull << stopBit) - 1);
+			return ReadResult::Complete;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Packet>
+		ReadResult ReadExtendedPacket(const uint8_t* data, size_t size, Packet& packet)
+		{
+			if (size < 2)
+				return ReadResult::Incomplete;
+
+			auto setSize = [&](PacketType type, size_t packetSize) {
+				packet.type_ = type;
+				packet.size_ = packetSize;
+				return size >= packetSize ? ReadResult::Complete : ReadResult::Incomplete;
+			};
+			auto extension = data[1];
+
+			switch (extension)
+			{
+				case 0xA3:
+				{
+					auto result = setSize(PacketType::Tnt, 8);
+					if (result != ReadResult::Complete)
+						return result;
+					return SetTnt(packet, ReadLittleEndian(data + 2, 6));
+				}
+				case 0x82:
+				{
+					auto result = setSize(PacketType::Psb, sizeof(PsbPattern));
+					if (result == ReadResult::Complete && std::memcmp(data, PsbPattern, sizeof(PsbPattern)))
+						return ReadResult::Invalid;
+					return result;
+				}
+				case 0x23: return setSize(PacketType::PsbEnd, 2);
+				case 0xF3: return setSize(PacketType::Overflow, 2);
+				case 0x43: return setSize(PacketType::Other, 8); // PIP
+				case 0x03: return setSize(PacketType::Other, 4); // CBR
+				case 0xC8: return setSize(PacketType::Other, 7); // VMCS
+				case 0x73: return setSize(PacketType::Other, 7); // TMA
+				case 0x83: return setSize(PacketType::Other, 2); // TraceStop
+				case 0xC3: return setSize(PacketType::Other, 11); // MNT
+				case 0x62:
+				case 0xE2: return setSize(PacketType::Other, 2); // EXSTOP
+				case 0xC2: return setSize(PacketType::Other, 10); // MWAIT
+				case 0x22: return setSize(PacketType::Other, 4); // PWRE
+				case 0xA2: return setSize(PacketType::Other, 7); // PWRX
+			}
+			// PTWRITE
+			if ((extension & 0x1F) == 0x12)
+				return setSize(PacketType::Other, ((extension >> 5) & 3) ? 10 : 6);
+			return ReadResult::Invalid;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Packet>
+		ReadResult ReadPacket(const uint8_t* data, size_t size, Packet& packet)
+		{
+			if (!size)
+				return ReadResult::Incomplete;
+
+			auto setSize = [&](PacketType type, size_t packetSize) {
+				packet.type_ = type;
+				packet.size_ = packetSize;
+				return size >= packetSize ? ReadResult::Complete : ReadResult::Incomplete;
+			};
+			auto header = data[0];
+
+			if (header == 0x00)
+				return setSize(PacketType::Pad, 1);
+			if (header == 0x02)
+				return ReadExtendedPacket(data, size, packet);
+			if (!(header & 1))
+			{
+				packet.size_ = 1;
+				return SetTnt(packet, header >> 1);
+			}
+			// CYC
+			if ((header & 3) == 3)
+			{
+				size_t packetSize = 1;
+				if (header & 4)
+				{
+					for (;; ++packetSize)
+					{
+						if (packetSize >= size)
+							return ReadResult::Incomplete;
+						if (!(data[packetSize] & 1))
+							break;
+					}
+					++packetSize;
+				}
+				return setSize(PacketType::Other, packetSize);
+			}
+			if (header == 0x99)
+			{
+				auto result = setSize(PacketType::Other, 2);
+				if (result == ReadResult::Complete && !(data[1] >> 5))
+				{
+					packet.type_ = PacketType::ModeExec;
+					packet.modePayload_ = data[1];
+				}
+				return result;
+			}
+			if (header == 0x19)
+				return setSize(PacketType::Other, 8); // TSC
+			if (header == 0x59)
+				return setSize(PacketType::Other, 2); // MTC
+
+			PacketType type;
+			switch (header & 0x1F)
+			{
+				case 0x0D: type = PacketType::Tip; break;
+				case 0x11: type = PacketType::TipPge; break;
+				case 0x01: type = PacketType::TipPgd; break;
+				case 0x1D: type = PacketType::Fup; break;
+				default: return ReadResult::Invalid;
+			}
+			packet.ipBytes_ = header >> 5;
+			auto payloadSize = GetIpPayloadSize(packet.ipBytes_);
+			if (payloadSize == static_cast<size_t>(-1))
+				return ReadResult::Invalid;
+			auto result = setSize(type, 1 + payloadSize);
+			if (result == ReadResult::Complete)
+				packet.ipPayload_ = ReadLittleEndian(data + 1, payloadSize);
+			return result;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	IntelPtImage::IntelPtImage(ReadCode readCode) : readCode_{std::move(readCode)}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	IntelPtImage::Block* IntelPtImage::GetBlock(uint64_t address, bool is64Bits)
+	{
+		auto& blocks = is64Bits ? blocks64_ : blocks32_;
+		auto it = blocks.find(address);
+
+		if (it != blocks.end())
+			return &it->second;
+
+		uint8_t code[CodeChunkSize];
+		size_t codeSize = 0;
+		auto codeAddress = address;
+
+		for (auto current = address;;)
+		{
+			auto offset = static_cast<size_t>(current - codeAddress);
+			if (codeSize - offset < MaxInstructionSize)
+			{
+				codeAddress = current;
+				offset = 0;
+				codeSize = readCode_(current, code, sizeof(code));
+				if (!codeSize)
+					return nullptr;
+			}
+			auto instruction = DecodeInstruction(code + offset, codeSize - offset, current, is64Bits);
+			if (!instruction || !instruction->length_)
+				return nullptr;
+			current += instruction->length_;
+			if (instruction->flow_ != InstructionFlow::Sequential || current - address >= MaxBlockSize)
+				return &blocks.emplace(address, Block{address, current, *instruction, false}).first->second;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtImage::AddExecutedRange(uint64_t start, uint64_t end)
+	{
+		executedRanges_.emplace_back(start, end);
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::pair<uint64_t, uint64_t>> IntelPtImage::TakeExecutedRanges()
+	{
+		auto executedRanges = std::move(executedRanges_);
+		executedRanges_.clear();
+		return executedRanges;
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtImage::Clear()
+	{
+		blocks32_.clear();
+		blocks64_.clear();
+	}
+
+	//-------------------------------------------------------------------------
+	IntelPtDecoder::IntelPtDecoder(IntelPtImage& image, bool is64Bits)
+	    : image_{image},
+	      isSynchronized_{false},
+	      isInPsb_{false},
+	      is64Bits_{is64Bits},
+	      lastIp_{0},
+	      isDisablePending_{false},
+	      isAfterOverflow_{false},
+	      tntIndex_{0},
+	      packetCount_{0},
+	      errorCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::Decode(const uint8_t* trace, size_t size)
+	{
+		pendingTrace_.insert(pendingTrace_.end(), trace, trace + size);
+
+		const auto* data = pendingTrace_.data();
+		auto dataSize = pendingTrace_.size();
+		size_t offset = 0;
+
+		while (offset < dataSize)
+		{
+			if (!isSynchronized_)
+			{
+				auto psbOffset = FindPsb(data + offset, dataSize - offset);
+				if (!psbOffset)
+				{
+					// Keep the bytes which can be the beginning of a PSB.
+					offset = (std::max)(offset, dataSize - (std::min)(dataSize, sizeof(PsbPattern) - 1));
+					break;
+				}
+				offset += *psbOffset;
+				isSynchronized_ = true;
+			}
+
+			Packet packet;
+			auto result = ReadPacket(data + offset, dataSize - offset, packet);
+			if (result == ReadResult::Incomplete)
+				break;
+			if (result == ReadResult::Invalid)
+			{
+				OnError();
+				++offset;
+				continue;
+			}
+			offset += packet.size_;
+			++packetCount_;
+			OnPacket(packet);
+		}
+		pendingTrace_.erase(pendingTrace_.begin(), pendingTrace_.begin() + offset);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t IntelPtDecoder::GetPacketCount() const
+	{
+		return packetCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t IntelPtDecoder::GetErrorCount() const
+	{
+		return errorCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::OnPacket(const Packet& packet)
+	{
+		switch (packet.type_)
+		{
+			case PacketType::Psb:
+				// The IP compression and the return compression restart.
+				isInPsb_ = true;
+				lastIp_ = 0;
+				returnAddresses_.clear();
+				break;
+			case PacketType::PsbEnd:
+				isInPsb_ = false;
+				break;
+			case PacketType::Overflow:
+				ResetFlow();
+				isAfterOverflow_ = true;
+				break;
+			case PacketType::ModeExec:
+				is64Bits_ = (packet.modePayload_ & 1) != 0;
+				break;
+			case PacketType::Tnt:
+				for (auto i = packet.tntCount_; i > 0; --i)
+					tntBits_.push_back(((packet.tntBits_ >> (i - 1)) & 1) != 0);
+				Walk();
+				break;
+			case PacketType::Tip:
+			case PacketType::TipPge:
+			case PacketType::TipPgd:
+			case PacketType::Fup:
+				OnTip(packet);
+				break;
+			case PacketType::Pad:
+			case PacketType::Other:
+				break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::OnTip(const Packet& packet)
+	{
+		boost::optional<uint64_t> ip;
+		const auto payload = packet.ipPayload_;
+
+		switch (packet.ipBytes_)
+		{
+			case 1: ip = (lastIp_ & ~0xFFFFull) | payload; break;
+			case 2: ip = (lastIp_ & ~0xFFFFFFFFull) | payload; break;
+			case 3: ip = (payload & (1ull << 47)) ? payload | 0xFFFF000000000000ull : payload; break;
+			case 4: ip = (lastIp_ & 0xFFFF000000000000ull) | payload; break;
+			case 6: ip = payload; break;
+		}
+		if (ip)
+			lastIp_ = *ip;
+
+		switch (packet.type_)
+		{
+			case PacketType::Fup:
+				if (!ip)
+					break;
+				// The current address when the tracing starts again.
+				if (isInPsb_ || isAfterOverflow_ || !ip_)
+				{
+					ip_ = ip;
+					tip_.reset();
+					asyncIp_.reset();
+					isAfterOverflow_ = false;
+					break;
+				}
+				// Asynchronous event: the code runs up to this address.
+				asyncIp_ = ip;
+				Walk();
+				break;
+			case PacketType::TipPge:
+				ip_ = ip;
+				tip_.reset();
+				isDisablePending_ = false;
+				Walk();
+				break;
+			case PacketType::TipPgd:
+				if (!ip_)
+					break;
+				isDisablePending_ = true;
+				Walk();
+				break;
+			case PacketType::Tip:
+				if (!ip_)
+					ip_ = ip;
+				else if (ip)
+					tip_ = ip;
+				// The target is not traced.
+				else
+					isDisablePending_ = true;
+				Walk();
+				break;
+			default:
+				break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::Walk()
+	{
+		for (size_t blockCount = 0; ip_; ++blockCount)
+		{
+			if (asyncIp_ && *ip_ == *asyncIp_)
+			{
+				ip_.reset();
+				asyncIp_.reset();
+				return;
+			}
+
+			auto* block = image_.GetBlock(*ip_, is64Bits_);
+			if (!block || blockCount > MaxWalkedBlockCount)
+			{
+				OnError();
+				return;
+			}
+			if (asyncIp_ && *asyncIp_ > *ip_ && *asyncIp_ < block->end_)
+			{
+				image_.AddExecutedRange(*ip_, *asyncIp_);
+				ip_.reset();
+				asyncIp_.reset();
+				return;
+			}
+
+			const auto& instruction = block->lastInstruction_;
+			auto hasTnt = tntIndex_ < tntBits_.size();
+			auto isTipRequired = false;
+			boost::optional<uint64_t> target;
+
+			switch (instruction.flow_)
+			{
+				case InstructionFlow::Sequential:
+					target = block->end_;
+					break;
+				case InstructionFlow::Jump:
+				case InstructionFlow::Call:
+					target = instruction.target_;
+					isTipRequired = !target;
+					break;
+				case InstructionFlow::ConditionalJump:
+					if (!hasTnt)
+					{
+						// The TNT bits are written before the next TIP packet.
+						if (tip_)
+							OnError();
+						else if (isDisablePending_)
+							DisableFlow();
+						return;
+					}
+					target = tntBits_[tntIndex_++] ? instruction.target_ : block->end_;
+					if (!target)
+					{
+						OnError();
+						return;
+					}
+					break;
+				case InstructionFlow::Return:
+					// Compressed return: a taken bit instead of a TIP packet.
+					if (hasTnt)
+					{
+						if (!tntBits_[tntIndex_++] || returnAddresses_.empty())
+						{
+							OnError();
+							return;
+						}
+						target = returnAddresses_.back();
+						returnAddresses_.pop_back();
+					}
+					else
+						isTipRequired = true;
+					break;
+				case InstructionFlow::IndirectJump:
+				case InstructionFlow::Interrupt:
+					isTipRequired = true;
+					break;
+			}
+
+			if (isTipRequired)
+			{
+				if (hasTnt)
+				{
+					OnError();
+					return;
+				}
+				if (tip_)
+				{
+					target = tip_;
+					tip_.reset();
+				}
+				else if (isDisablePending_)
+				{
+					if (!block->isExecuted_)
+						image_.AddExecutedRange(block->start_, block->end_);
+					block->isExecuted_ = true;
+					DisableFlow();
+					return;
+				}
+				else
+					return;
+			}
+			if (tntIndex_ == tntBits_.size())
+			{
+				tntBits_.clear();
+				tntIndex_ = 0;
+			}
+
+			if (!block->isExecuted_)
+			{
+				block->isExecuted_ = true;
+				image_.AddExecutedRange(block->start_, block->end_);
+			}
+			if (instruction.flow_ == InstructionFlow::Call)
+			{
+				if (returnAddresses_.size() == MaxReturnAddressCount)
+					returnAddresses_.erase(returnAddresses_.begin());
+				returnAddresses_.push_back(block->end_);
+			}
+			ip_ = target;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// The return addresses are kept: the returns are still compressed when
+	// the tracing is enabled again, for example after a system call.
+	void IntelPtDecoder::DisableFlow()
+	{
+		ip_.reset();
+		tip_.reset();
+		asyncIp_.reset();
+		isDisablePending_ = false;
+		tntBits_.clear();
+		tntIndex_ = 0;
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::ResetFlow()
+	{
+		DisableFlow();
+		returnAddresses_.clear();
+	}
+
+	//-------------------------------------------------------------------------
+	void IntelPtDecoder::OnError()
+	{
+		++errorCount_;
+		ResetFlow();
+		isSynchronized_ = false;
+		isInPsb_ = false;
+	}
+}
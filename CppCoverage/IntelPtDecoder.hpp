@@ -0,0 +1,122 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+#include "InstructionDecoder.hpp"
+
+namespace CppCoverage
+{
+	// Code of a traced process shared by the decoders of its threads. A block
+	// ends with the first instruction which is not sequential and is decoded
+	// once: the cost of the decoding depends on the trace size, not on the
+	// number of lines.
+	class CPPCOVERAGE_DLL IntelPtImage
+	{
+	  public:
+		// Copy the code at the address and return the number of bytes copied.
+		using ReadCode = std::function<size_t(uint64_t address, uint8_t* buffer, size_t size)>;
+
+		struct Block
+		{
+			uint64_t start_;
+			// Address after the last instruction.
+			uint64_t end_;
+			DecodedInstruction lastInstruction_;
+			bool isExecuted_;
+		};
+
+		explicit IntelPtImage(ReadCode);
+
+		// nullptr if the code cannot be read or decoded.
+		Block* GetBlock(uint64_t address, bool is64Bits);
+		void AddExecutedRange(uint64_t start, uint64_t end);
+
+		// Return the ranges [start, end) executed since the last call.
+		std::vector<std::pair<uint64_t, uint64_t>> TakeExecutedRanges();
+
+		// The code changed, for example when a module is unloaded.
+		void Clear();
+
+	  private:
+		IntelPtImage(const IntelPtImage&) = delete;
+		IntelPtImage& operator=(const IntelPtImage&) = delete;
+
+		ReadCode readCode_;
+		std::unordered_map<uint64_t, Block> blocks32_;
+		std::unordered_map<uint64_t, Block> blocks64_;
+		std::vector<std::pair<uint64_t, uint64_t>> executedRanges_;
+	};
+
+	// Decode the Intel Processor Trace packets of a thread and add the
+	// executed code to the image. Only the packets about the control flow are
+	// used: the decoder follows the code from a known address and takes the
+	// next TNT bit or TIP packet when the target of a branch is not in the code.
+	class CPPCOVERAGE_DLL IntelPtDecoder
+	{
+	  public:
+		IntelPtDecoder(IntelPtImage&, bool is64Bits);
+
+		// The trace can be split anywhere between the calls.
+		void Decode(const uint8_t* trace, size_t size);
+
+		size_t GetPacketCount() const;
+		// Number of times the decoder lost the control flow and searched the
+		// next synchronization packet.
+		size_t GetErrorCount() const;
+
+	  private:
+		IntelPtDecoder(const IntelPtDecoder&) = delete;
+		IntelPtDecoder& operator=(const IntelPtDecoder&) = delete;
+
+		struct Packet;
+
+		size_t Synchronize(const uint8_t* trace, size_t size);
+		void OnPacket(const Packet&);
+		void OnTip(const Packet&);
+		void Walk();
+		void DisableFlow();
+		void ResetFlow();
+		void OnError();
+
+		IntelPtImage& image_;
+		std::vector<uint8_t> pendingTrace_;
+		bool isSynchronized_;
+		bool isInPsb_;
+		bool is64Bits_;
+		uint64_t lastIp_;
+		boost::optional<uint64_t> ip_;
+		boost::optional<uint64_t> tip_;
+		boost::optional<uint64_t> asyncIp_;
+		bool isDisablePending_;
+		bool isAfterOverflow_;
+		std::vector<bool> tntBits_;
+		size_t tntIndex_;
+		std::vector<uint64_t> returnAddresses_;
+		size_t packetCount_;
+		size_t errorCount_;
+	};
+}
@@ -0,0 +1,181 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "LiveCounters.hpp"
+
+#include <new>
+#include <ostream>
+
+#include "Tools/Log.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/Tool.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const uint32_t BlockVersion = 1;
+	}
+
+	//-------------------------------------------------------------------------
+	struct LiveCounters::Block
+	{
+		uint32_t version_ = BlockVersion;
+		std::atomic<uint32_t> phase_{static_cast<uint32_t>(Phase::Starting)};
+		std::atomic<uint64_t> debugEventCount_{0};
+		std::atomic<uint64_t> armedBreakPointCount_{0};
+		std::atomic<uint64_t> hitBreakPointCount_{0};
+		std::atomic<uint64_t> executedLineCount_{0};
+		std::atomic<uint64_t> loadedModuleCount_{0};
+
+		//---------------------------------------------------------------------
+		Values GetValues() const
+		{
+			return {static_cast<Phase>(phase_.load(std::memory_order_relaxed)),
+			        debugEventCount_.load(std::memory_order_relaxed),
+			        armedBreakPointCount_.load(std::memory_order_relaxed),
+			        hitBreakPointCount_.load(std::memory_order_relaxed),
+			        executedLineCount_.load(std::memory_order_relaxed),
+			        loadedModuleCount_.load(std::memory_order_relaxed)};
+		}
+	};
+
+	//-------------------------------------------------------------------------
+	std::wstring LiveCounters::GetSectionName(const std::string& name)
+	{
+		return L"Local\\OpenCppCoverage.LiveCounters." + Tools::LocalToWString(name);
+	}
+
+	//-------------------------------------------------------------------------
+	LiveCounters::LiveCounters(const std::string& name) : hMapping_{nullptr}, block_{nullptr}
+	{
+		auto sectionName = GetSectionName(name);
+		hMapping_ = CreateFileMappingW(INVALID_HANDLE_VALUE,
+		                               nullptr,
+		                               PAGE_READWRITE,
+		                               0,
+		                               sizeof(Block),
+		                               sectionName.c_str());
+		auto error = GetLastError();
+		void* view = nullptr;
+
+		// The counters of another run must not be mixed with the ones of this run.
+		if (hMapping_ && error != ERROR_ALREADY_EXISTS)
+		{
+			view = MapViewOfFile(hMapping_, FILE_MAP_WRITE, 0, 0, sizeof(Block));
+			error = GetLastError();
+		}
+		if (view)
+			block_ = new (view) Block{};
+		else
+		{
+			LOG_WARNING << L"Cannot publish the live counters as " << sectionName << L": " << error;
+			if (hMapping_)
+				CloseHandle(hMapping_);
+			hMapping_ = nullptr;
+			localBlock_ = std::make_unique<Block>();
+			block_ = localBlock_.get();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	LiveCounters::~LiveCounters()
+	{
+		if (hMapping_)
+		{
+			UnmapViewOfFile(block_);
+			CloseHandle(hMapping_);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::SetPhase(Phase phase)
+	{
+		block_->phase_.store(static_cast<uint32_t>(phase), std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::AddDebugEvent()
+	{
+		block_->debugEventCount_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::AddArmedBreakPoints(uint64_t count)
+	{
+		block_->armedBreakPointCount_.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::AddHitBreakPoint()
+	{
+		block_->hitBreakPointCount_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::AddExecutedLines(uint64_t count)
+	{
+		block_->executedLineCount_.fetch_add(count, std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	void LiveCounters::AddLoadedModule()
+	{
+		block_->loadedModuleCount_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//-------------------------------------------------------------------------
+	LiveCounters::Values LiveCounters::GetValues() const
+	{
+		return block_->GetValues();
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<LiveCounters::Values> LiveCounters::Read(const std::string& name)
+	{
+		auto hMapping = OpenFileMappingW(FILE_MAP_WRITE, FALSE, GetSectionName(name).c_str());
+		if (!hMapping)
+			return boost::none;
+		Tools::ScopedAction closeMapping{[=]() { CloseHandle(hMapping); }};
+
+		// The view is writable as a 64-bit atomic load can be a compare and
+		// exchange on x86.
+		auto view = MapViewOfFile(hMapping, FILE_MAP_WRITE, 0, 0, sizeof(Block));
+		if (!view)
+			return boost::none;
+		Tools::ScopedAction unmapView{[=]() { UnmapViewOfFile(view); }};
+
+		const auto* block = static_cast<const Block*>(view);
+		if (block->version_ != BlockVersion)
+			return boost::none;
+		return block->GetValues();
+	}
+
+	//-------------------------------------------------------------------------
+	std::wostream& operator<<(std::wostream& ostr, LiveCounters::Phase phase)
+	{
+		switch (phase)
+		{
+			case LiveCounters::Phase::Starting: return ostr << L"Starting";
+			case LiveCounters::Phase::Running: return ostr << L"Running";
+			case LiveCounters::Phase::Merging: return ostr << L"Merging";
+			case LiveCounters::Phase::Exporting: return ostr << L"Exporting";
+			case LiveCounters::Phase::Finished: return ostr << L"Finished";
+		}
+		return ostr << L"Unknown";
+	}
+}
@@ -0,0 +1,89 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include <Windows.h>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Counters of a run published in a named shared memory section and
+	// displayed by --watch. The writers only use relaxed atomic additions and the
+	// readers copy the section: reading does not interrupt the debug loop.
+	class CPPCOVERAGE_DLL LiveCounters
+	{
+	public:
+		enum class Phase : uint32_t
+		{
+			Starting,
+			Running,
+			Merging,
+			Exporting,
+			Finished
+		};
+
+		struct Values
+		{
+			Phase phase_;
+			uint64_t debugEventCount_;
+			uint64_t armedBreakPointCount_;
+			uint64_t hitBreakPointCount_;
+			uint64_t executedLineCount_;
+			uint64_t loadedModuleCount_;
+		};
+
+		static std::wstring GetSectionName(const std::string& name);
+
+		// Publish the counters of the run under this name. The counters are only
+		// kept in memory if the section cannot be created or if another run
+		// publishes under the same name.
+		explicit LiveCounters(const std::string& name);
+		~LiveCounters();
+
+		void SetPhase(Phase);
+		void AddDebugEvent();
+		void AddArmedBreakPoints(uint64_t count);
+		void AddHitBreakPoint();
+		void AddExecutedLines(uint64_t count);
+		void AddLoadedModule();
+
+		Values GetValues() const;
+
+		// boost::none when no run publishes its counters under this name.
+		static boost::optional<Values> Read(const std::string& name);
+
+	private:
+		LiveCounters(const LiveCounters&) = delete;
+		LiveCounters& operator=(const LiveCounters&) = delete;
+
+		struct Block;
+
+		HANDLE hMapping_;
+		Block* block_;
+		std::unique_ptr<Block> localBlock_;
+	};
+
+	CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream&, LiveCounters::Phase);
+}
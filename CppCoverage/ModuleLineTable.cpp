@@ -0,0 +1,296 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ModuleLineTable.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <numeric>
+#include <sstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "CppCoverageException.hpp"
+#include "DebugInformationEnumerator.hpp"
+#include "ICoverageFilterManager.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const std::string Header = "OpenCppCoverage line table ";
+
+		//---------------------------------------------------------------------
+		class LineRecorder : public IDebugInformationHandler
+		{
+		public:
+			//-----------------------------------------------------------------
+			LineRecorder(ICoverageFilterManager& coverageFilterManager,
+			             ModuleLineTable::FunctionRanges* functionRanges)
+				: coverageFilterManager_{coverageFilterManager}
+				, functionRanges_{functionRanges}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool IsSourceFileSelected(const std::filesystem::path& path) override
+			{
+				return coverageFilterManager_.IsSourceFileSelected(path.wstring());
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFile(const std::filesystem::path& path, const std::vector<Line>& lines) override
+			{
+				auto it = fileIndexes_.emplace(path, static_cast<uint32_t>(files_.size())).first;
+
+				if (it->second == files_.size())
+					files_.push_back(path);
+				for (const auto& line : lines)
+				{
+					lines_.push_back({static_cast<uint32_t>(line.virtualAddress_),
+					                  it->second,
+					                  static_cast<unsigned int>(line.lineNumber_)});
+					if (functionRanges_ && line.functionLength_)
+					{
+						functionRanges_->emplace(static_cast<uint32_t>(line.functionVirtualAddress_),
+						                         static_cast<uint32_t>(line.functionLength_));
+					}
+				}
+			}
+
+			std::vector<std::filesystem::path> files_;
+			std::vector<ModuleLineTable::Line> lines_;
+
+		private:
+			ICoverageFilterManager& coverageFilterManager_;
+			ModuleLineTable::FunctionRanges* functionRanges_;
+			std::map<std::filesystem::path, uint32_t> fileIndexes_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	const int ModuleLineTable::Version = 1;
+
+	//-------------------------------------------------------------------------
+	ModuleLineTable::ModuleLineTable(const std::filesystem::path& modulePath,
+	                                 std::vector<std::filesystem::path>&& files,
+	                                 std::vector<Line>&& lines)
+		: modulePath_{modulePath}
+		, files_{std::move(files)}
+		, lines_{std::move(lines)}
+		, lineIndexesByRva_(lines_.size())
+	{
+		for (const auto& line : lines_)
+		{
+			if (line.fileIndex_ >= files_.size())
+				THROW(L"Invalid file index for " << modulePath_.wstring());
+		}
+		std::iota(lineIndexesByRva_.begin(), lineIndexesByRva_.end(), 0);
+		std::stable_sort(lineIndexesByRva_.begin(), lineIndexesByRva_.end(),
+		                 [this](size_t index1, size_t index2) {
+			                 return lines_[index1].rva_ < lines_[index2].rva_;
+		                 });
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleLineTable ModuleLineTable::Create(
+		const std::filesystem::path& modulePath,
+		const std::vector<SubstitutePdbSourcePath>& substitutePdbSourcePaths,
+		ICoverageFilterManager& coverageFilterManager,
+		FunctionRanges* functionRanges)
+	{
+		if (!coverageFilterManager.IsModuleSelected(modulePath.wstring()))
+			THROW(L"Module " << modulePath.wstring() << L" is not selected.");
+
+		LineRecorder lineRecorder{coverageFilterManager, functionRanges};
+		DebugInformationEnumerator debugInformationEnumerator{substitutePdbSourcePaths};
+
+		if (!debugInformationEnumerator.Enumerate(modulePath, lineRecorder))
+			THROW(L"Cannot read the debug information of " << modulePath.wstring());
+		return ModuleLineTable{modulePath, std::move(lineRecorder.files_), std::move(lineRecorder.lines_)};
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleLineTable ModuleLineTable::Read(const std::filesystem::path& path)
+	{
+		std::ifstream ifs{path};
+		std::string header;
+		std::string modulePath;
+
+		if (!std::getline(ifs, header) || header != Header + std::to_string(Version) ||
+		    !std::getline(ifs, modulePath))
+			THROW(L"Invalid line table: " << path.wstring());
+
+		std::vector<std::filesystem::path> files;
+		std::map<std::filesystem::path, uint32_t> fileIndexes;
+		boost::optional<uint32_t> currentFileIndex;
+		std::vector<Line> lines;
+		std::string textLine;
+		while (std::getline(ifs, textLine))
+		{
+			if (textLine.size() > 2 && textLine.compare(0, 2, "F ") == 0)
+			{
+				auto file = std::filesystem::u8path(textLine.substr(2));
+				auto it = fileIndexes.emplace(file, static_cast<uint32_t>(files.size())).first;
+
+				if (it->second == files.size())
+					files.push_back(file);
+				currentFileIndex = it->second;
+			}
+			else if (textLine.size() > 2 && textLine.compare(0, 2, "L ") == 0 && currentFileIndex)
+			{
+				std::istringstream istr{textLine.substr(2)};
+				Line line{};
+
+				if (!(istr >> std::hex >> line.rva_ >> std::dec >> line.lineNumber_))
+					THROW(L"Invalid line in " << path.wstring() << L": " << textLine.c_str());
+				line.fileIndex_ = *currentFileIndex;
+				lines.push_back(line);
+			}
+			else if (!textLine.empty())
+				THROW(L"Invalid line in " << path.wstring() << L": " << textLine.c_str());
+		}
+		return ModuleLineTable{std::filesystem::u8path(modulePath), std::move(files), std::move(lines)};
+	}
+
+	//-------------------------------------------------------------------------
+	void ModuleLineTable::Write(const std::filesystem::path& path) const
+	{
+		std::ofstream ofs{path};
+
+		if (!ofs)
+			THROW(L"Cannot write " << path.wstring());
+		ofs << Header << Version << '\n';
+		ofs << modulePath_.u8string() << '\n';
+
+		// The counters follow the lines in the order of the file.
+		boost::optional<uint32_t> currentFileIndex;
+		for (const auto& line : lines_)
+		{
+			if (!currentFileIndex || *currentFileIndex != line.fileIndex_)
+			{
+				currentFileIndex = line.fileIndex_;
+				ofs << "F " << files_[line.fileIndex_].u8string() << '\n';
+			}
+			ofs << "L " << std::hex << line.rva_ << std::dec << ' ' << line.lineNumber_ << '\n';
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path& ModuleLineTable::GetModulePath() const
+	{
+		return modulePath_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::filesystem::path>& ModuleLineTable::GetFiles() const
+	{
+		return files_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<ModuleLineTable::Line>& ModuleLineTable::GetLines() const
+	{
+		return lines_;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> ModuleLineTable::FindLineIndex(uint32_t rva) const
+	{
+		auto it = std::upper_bound(lineIndexesByRva_.begin(), lineIndexesByRva_.end(), rva,
+		                           [this](uint32_t value, size_t index) {
+			                           return value < lines_[index].rva_;
+		                           });
+
+		if (it == lineIndexesByRva_.begin())
+			return boost::none;
+		return *std::prev(it);
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<uint64_t> ModuleLineTable::ReadHitCounts(const std::filesystem::path& path) const
+	{
+		std::ifstream ifs{path, std::ios::binary};
+
+		if (!ifs)
+			THROW(L"Cannot read " << path.wstring());
+
+		std::vector<char> counters{std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{}};
+		auto counterSize = lines_.empty() ? 1 : counters.size() / lines_.size();
+
+		if (counters.size() != counterSize * lines_.size() ||
+		    (counterSize != 1 && counterSize != 4 && counterSize != 8))
+		{
+			THROW(L"Expected counters of 1, 4 or 8 bytes for the " << lines_.size() << L" lines of "
+			                                                       << modulePath_.wstring() << L" in "
+			                                                       << path.wstring() << L".");
+		}
+
+		std::vector<uint64_t> hitCounts(lines_.size());
+		for (size_t i = 0; i < counters.size(); ++i)
+		{
+			auto byte = static_cast<uint64_t>(static_cast<unsigned char>(counters[i]));
+			hitCounts[i / counterSize] |= byte << (8 * (i % counterSize));
+		}
+		return hitCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData ModuleLineTable::CreateCoverageData(
+		const std::wstring& name,
+		const std::vector<uint64_t>& hitCounts,
+		bool hasHitCounts) const
+	{
+		if (hitCounts.size() != lines_.size())
+		{
+			THROW(L"Expected " << lines_.size() << L" counters for " << modulePath_.wstring()
+			                   << L" but got " << hitCounts.size() << L".");
+		}
+
+		Plugin::CoverageData coverageData{name, 0};
+		auto& moduleCoverage = coverageData.AddModule(modulePath_);
+		std::vector<Plugin::FileCoverage*> fileCoverages;
+
+		moduleCoverage.ReserveFiles(files_.size());
+		for (const auto& file : files_)
+			fileCoverages.push_back(&moduleCoverage.AddFile(file));
+		for (size_t i = 0; i < lines_.size(); ++i)
+		{
+			const auto& line = lines_[i];
+			auto& fileCoverage = *fileCoverages[line.fileIndex_];
+			auto hitCount = hitCounts[i];
+			const auto* lineCoverage = fileCoverage[line.lineNumber_];
+
+			// A line can have several addresses.
+			if (lineCoverage)
+			{
+				hitCount += lineCoverage->GetHitCount();
+				fileCoverage.UpdateLine(line.lineNumber_,
+				                        hitCount || lineCoverage->HasBeenExecuted(),
+				                        hasHitCounts ? hitCount : 0);
+			}
+			else
+				fileCoverage.AddLine(line.lineNumber_, hitCount != 0, hasHitCounts ? hitCount : 0);
+		}
+		return coverageData;
+	}
+}
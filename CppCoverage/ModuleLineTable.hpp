@@ -0,0 +1,101 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+#include "SubstitutePdbSourcePath.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	class ICoverageFilterManager;
+
+	// Lines of the selected source files of a module, read from its PDB
+	// without running it. Tools which instrument the module outside of
+	// OpenCppCoverage give one counter to each line of the table.
+	//
+	// The text format is UTF-8:
+	//   OpenCppCoverage line table <version>
+	//   <module path>
+	//   F <source file path>
+	//   L <hexadecimal RVA> <line number>    for each line of the last file
+	class CPPCOVERAGE_DLL ModuleLineTable
+	{
+	public:
+		static const int Version;
+
+		struct Line
+		{
+			uint32_t rva_;
+			uint32_t fileIndex_;
+			unsigned int lineNumber_;
+		};
+
+		ModuleLineTable(const std::filesystem::path& modulePath,
+		                std::vector<std::filesystem::path>&& files,
+		                std::vector<Line>&& lines);
+		ModuleLineTable(ModuleLineTable&&) = default;
+
+		// Length of each function of the lines by its RVA.
+		using FunctionRanges = std::map<uint32_t, uint32_t>;
+
+		static ModuleLineTable Create(const std::filesystem::path& modulePath,
+		                              const std::vector<SubstitutePdbSourcePath>&,
+		                              ICoverageFilterManager&,
+		                              FunctionRanges* = nullptr);
+		static ModuleLineTable Read(const std::filesystem::path&);
+		void Write(const std::filesystem::path&) const;
+
+		const std::filesystem::path& GetModulePath() const;
+		const std::vector<std::filesystem::path>& GetFiles() const;
+		const std::vector<Line>& GetLines() const;
+
+		// Index of the line whose code contains the RVA, boost::none when the
+		// RVA is before the first line.
+		boost::optional<size_t> FindLineIndex(uint32_t rva) const;
+
+		// Read one counter by line in the order of the table. The counters
+		// have 1, 4 or 8 bytes: their size is found from the size of the file.
+		std::vector<uint64_t> ReadHitCounts(const std::filesystem::path&) const;
+
+		// hitCounts gives the number of executions of each line. The hit
+		// counts are exported only when hasHitCounts is true.
+		Plugin::CoverageData CreateCoverageData(const std::wstring& name,
+		                                        const std::vector<uint64_t>& hitCounts,
+		                                        bool hasHitCounts) const;
+
+	private:
+		ModuleLineTable(const ModuleLineTable&) = delete;
+		ModuleLineTable& operator=(const ModuleLineTable&) = delete;
+
+		std::filesystem::path modulePath_;
+		std::vector<std::filesystem::path> files_;
+		std::vector<Line> lines_;
+		std::vector<size_t> lineIndexesByRva_;
+	};
+}
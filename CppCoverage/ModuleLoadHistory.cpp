@@ -0,0 +1,138 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ModuleLoadHistory.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include "Tools/BlobCache.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const wchar_t* HistoryExtension = L".loadhistory";
+
+		//---------------------------------------------------------------------
+		// Each line is: load time in ms, registration time in ms, path in UTF-8.
+		std::vector<ModuleLoadHistory::LoadedModule> ParseHistory(const std::string& content)
+		{
+			std::vector<ModuleLoadHistory::LoadedModule> modules;
+			std::istringstream istr{content};
+
+			for (std::string line; std::getline(istr, line);)
+			{
+				std::istringstream lineStream{line};
+				long long loadTime = 0;
+				long long registrationTime = 0;
+				std::string path;
+
+				if (lineStream >> loadTime >> registrationTime && lineStream.get() == '\t' &&
+				    std::getline(lineStream, path) && !path.empty())
+				{
+					modules.push_back({Tools::Utf8ToWString(path),
+					                   std::chrono::milliseconds{loadTime},
+					                   std::chrono::milliseconds{registrationTime}});
+				}
+			}
+			return modules;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleLoadHistory::ModuleLoadHistory(
+	    std::shared_ptr<const Tools::BlobCache> blobCache,
+	    const fs::path& programPath)
+	    : blobCache_{std::move(blobCache)}
+	    , name_{Tools::BlobCache::GetKey(Tools::ToUtf8String(
+	                boost::to_lower_copy(fs::absolute(programPath).wstring()))) +
+	            HistoryExtension}
+	{
+		if (auto content = blobCache_->Read(name_))
+			previousModules_ = ParseHistory(*content);
+	}
+
+	//-------------------------------------------------------------------------
+	ModuleLoadHistory::~ModuleLoadHistory() = default;
+
+	//-------------------------------------------------------------------------
+	std::vector<fs::path> ModuleLoadHistory::GetPrefetchOrder() const
+	{
+		auto modules = previousModules_;
+
+		// A module expensive to register is needed before a module loaded
+		// just before it.
+		std::stable_sort(
+		    modules.begin(), modules.end(), [](const auto& module1, const auto& module2) {
+			    return module1.loadTime_ - module1.registrationTime_ <
+			           module2.loadTime_ - module2.registrationTime_;
+		    });
+
+		std::vector<fs::path> modulePaths;
+		for (const auto& module : modules)
+		{
+			std::error_code error;
+			if (fs::is_regular_file(module.path_, error))
+				modulePaths.push_back(module.path_);
+		}
+		return modulePaths;
+	}
+
+	//-------------------------------------------------------------------------
+	void ModuleLoadHistory::AddLoadedModule(
+	    const fs::path& path,
+	    std::chrono::milliseconds loadTime,
+	    std::chrono::milliseconds registrationTime)
+	{
+		if (loadedModulePaths_.insert(boost::to_lower_copy(path.wstring())).second)
+			loadedModules_.push_back({path, loadTime, registrationTime});
+	}
+
+	//-------------------------------------------------------------------------
+	void ModuleLoadHistory::Write() const
+	{
+		std::ostringstream ostr;
+
+		for (const auto& module : loadedModules_)
+		{
+			ostr << module.loadTime_.count() << ' ' << module.registrationTime_.count() << '\t'
+			     << Tools::ToUtf8String(module.path_.wstring()) << '\n';
+		}
+		try
+		{
+			blobCache_->Write(name_, ostr.str());
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot write the module load history: "
+			            << Tools::LocalToWString(e.what());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<ModuleLoadHistory::LoadedModule>&
+	ModuleLoadHistory::GetPreviousModules() const
+	{
+		return previousModules_;
+	}
+}
@@ -0,0 +1,76 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace Tools
+{
+	class BlobCache;
+}
+
+namespace CppCoverage
+{
+	// The modules loaded by the previous run of a program, saved in the
+	// Tools::BlobCache of the PDB cache: the next run prefetches their debug
+	// information when the program starts. Each module has its load time from
+	// the start of the run and the time of its registration.
+	class CPPCOVERAGE_DLL ModuleLoadHistory
+	{
+	public:
+		struct LoadedModule
+		{
+			std::filesystem::path path_;
+			std::chrono::milliseconds loadTime_;
+			std::chrono::milliseconds registrationTime_;
+		};
+
+		ModuleLoadHistory(std::shared_ptr<const Tools::BlobCache>,
+		                  const std::filesystem::path& programPath);
+		~ModuleLoadHistory();
+
+		// The modules of the previous run which still exist. The module whose
+		// registration must start first to end before its load is the first.
+		std::vector<std::filesystem::path> GetPrefetchOrder() const;
+
+		// Only the first load of a module is recorded.
+		void AddLoadedModule(const std::filesystem::path&,
+		                     std::chrono::milliseconds loadTime,
+		                     std::chrono::milliseconds registrationTime);
+		// Replace the history of the previous run. An error is logged.
+		void Write() const;
+
+		const std::vector<LoadedModule>& GetPreviousModules() const;
+
+	private:
+		ModuleLoadHistory(const ModuleLoadHistory&) = delete;
+		ModuleLoadHistory& operator=(const ModuleLoadHistory&) = delete;
+
+		const std::shared_ptr<const Tools::BlobCache> blobCache_;
+		const std::wstring name_;
+		std::vector<LoadedModule> previousModules_;
+		std::vector<LoadedModule> loadedModules_;
+		std::set<std::wstring> loadedModulePaths_;
+	};
+}
@@ -18,19 +18,31 @@
 
 #include "MonitoredLineRegister.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <map>
+
 #include "ICoverageFilterManager.hpp"
 #include "Address.hpp"
 #include "BreakPoint.hpp"
 #include "ExecutedAddressManager.hpp"
 #include "CppCoverageException.hpp"
 #include "FilterAssistant.hpp"
+#include "BasicBlockAnalyzer.hpp"
+#include "DominatorAnalyzer.hpp"
+#include "CoverageBaseline.hpp"
+#include "PdbCache.hpp"
+#include "TraceRecorder.hpp"
 
 #include "FileFilter/ModuleInfo.hpp"
 #include "FileFilter/FileInfo.hpp"
 #include "FileFilter/LineInfo.hpp"
 
 #include "Tools/PEFileHeader.hpp"
+#include "Tools/ProcessMemory.hpp"
 #include "Tools/Log.hpp"
+#include "Tools/MemoryUsage.hpp"
+#include "Tools/SourceFileCache.hpp"
 
 namespace CppCoverage
 {
@@ -47,6 +59,20 @@ namespace CppCoverage
 				return isNativeModule_;
 			}
 
+			//----------------------------------------------------------------------------
+			bool Is64Bits() const
+			{
+				return is64Bits_;
+			}
+
+			//----------------------------------------------------------------------------
+			// The same for the copies of a module, empty when the header has
+			// neither timestamp nor checksum.
+			const std::wstring& GetIdentity() const
+			{
+				return identity_;
+			}
+
 		  private:
 			//-----------------------------------------------------------------
 			template <typename T_IMAGE_NT_HEADERS>
@@ -58,6 +84,14 @@ namespace CppCoverage
 				        .DataDirectory[IMAGE_DIRECTORY_ENTRY_COM_DESCRIPTOR];
 				isNativeModule_ = dataDirectory.VirtualAddress == 0 &&
 				                  dataDirectory.Size == 0;
+
+				auto timeDateStamp = ntHeaders.FileHeader.TimeDateStamp;
+				if (timeDateStamp != 0 || optionalHeader.CheckSum != 0)
+				{
+					identity_ = std::to_wstring(timeDateStamp) + L'-' +
+					            std::to_wstring(optionalHeader.SizeOfImage) + L'-' +
+					            std::to_wstring(optionalHeader.CheckSum);
+				}
 			}
 
 			//-----------------------------------------------------------------
@@ -74,10 +108,46 @@ namespace CppCoverage
 			                  const IMAGE_NT_HEADERS64& ntHeader) override
 			{
 				OnNtHeader(ntHeader);
+				is64Bits_ = true;
 			}
 
 			bool isNativeModule_ = true;
+			bool is64Bits_ = false;
+			std::wstring identity_;
 		};
+
+		//----------------------------------------------------------------------------
+		// Identity of the image and of its PDB, empty when one of them is unknown.
+		std::wstring GetModuleIdentity(const std::filesystem::path& modulePath,
+		                               const std::wstring& imageIdentity)
+		{
+			if (imageIdentity.empty())
+				return {};
+
+			auto pdbKey = PdbCache::GetKey(modulePath);
+			return pdbKey ? imageIdentity + L'-' + *pdbKey : std::wstring{};
+		}
+
+		//----------------------------------------------------------------------------
+		template <typename Map, typename Predicate>
+		void EraseIf(Map& map, Predicate predicate)
+		{
+			for (auto it = map.begin(); it != map.end();)
+			{
+				if (predicate(*it))
+					it = map.erase(it);
+				else
+					++it;
+			}
+		}
+
+		//----------------------------------------------------------------------------
+		DWORD64 GetSystemPageSize()
+		{
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			return systemInfo.dwPageSize;
+		}
 	}
 
 	//----------------------------------------------------------------------------
@@ -86,12 +156,36 @@ namespace CppCoverage
 	    std::shared_ptr<ExecutedAddressManager> executedAddressManager,
 	    std::shared_ptr<ICoverageFilterManager> coverageFilterManager,
 	    std::unique_ptr<DebugInformationEnumerator> debugInformationEnumerator,
-	    std::shared_ptr<FilterAssistant> filterAssistant)
+	    std::shared_ptr<FilterAssistant> filterAssistant,
+	    bool basicBlockBreakPoints,
+	    bool dominatorBreakPoints,
+	    bool lazyBreakPoints,
+	    bool pageGuardBreakPoints,
+	    std::shared_ptr<const CoverageBaseline> coverageBaseline,
+	    CoverageLevel coverageLevel)
 	    : breakPoint_{breakPoint},
 	      executedAddressManager_{executedAddressManager},
 	      coverageFilterManager_{coverageFilterManager},
 	      debugInformationEnumerator_{std::move(debugInformationEnumerator)},
-	      filterAssistant_{std::move(filterAssistant)}
+	      filterAssistant_{std::move(filterAssistant)},
+	      basicBlockBreakPoints_{basicBlockBreakPoints},
+	      dominatorBreakPoints_{dominatorBreakPoints},
+	      lazyBreakPoints_{lazyBreakPoints},
+	      pageGuardBreakPoints_{pageGuardBreakPoints},
+	      coverageBaseline_{std::move(coverageBaseline)},
+	      coverageLevel_{coverageLevel},
+	      isModule64Bits_{false},
+	      breakPointsDeferred_{false},
+	      lazyFunctionCount_{0},
+	      armedLazyFunctionCount_{0},
+	      pageSize_{GetSystemPageSize()},
+	      guardedPageCount_{0},
+	      armedGuardedPageCount_{0},
+	      skippedAddressCount_{0},
+	      monitoredFunctionCount_{0},
+	      replayedModuleCount_{0},
+	      baselineCoveredModuleCount_{0},
+	      lastRegistrationStatistics_{}
 	{
 	}
 
@@ -104,20 +198,214 @@ namespace CppCoverage
 	    HANDLE hProcess,
 	    void* baseOfImage)
 	{
-		if (!ModuleKind{}.IsNativeModule(
+		return RegisterModule(modulePath, hProcess, baseOfImage, [&]() {
+			TraceRecorder::ScopedSpan span{
+			    traceRecorder_.get(), "Debug information read", "debug information", modulePath.wstring()};
+
+			return debugInformationEnumerator_->Enumerate(modulePath, *this);
+		});
+	}
+
+	//----------------------------------------------------------------------------
+	bool MonitoredLineRegister::RegisterLineToMonitor(
+	    const AsyncDebugInformationEnumerator::EnumeratedModule& module)
+	{
+		return RegisterLineToMonitor(
+		    module, module.path_, module.hProcess_, module.baseOfImage_);
+	}
+
+	//----------------------------------------------------------------------------
+	bool MonitoredLineRegister::RegisterLineToMonitor(
+	    const AsyncDebugInformationEnumerator::EnumeratedModule& module,
+	    const std::filesystem::path& modulePath,
+	    HANDLE hProcess,
+	    void* baseOfImage)
+	{
+		return RegisterModule(modulePath, hProcess, baseOfImage, [&]() {
+			return module.Replay(*this);
+		});
+	}
+
+	//----------------------------------------------------------------------------
+	template <typename Enumerate>
+	bool MonitoredLineRegister::RegisterModule(
+	    const std::filesystem::path& modulePath,
+	    HANDLE hProcess,
+	    void* baseOfImage,
+	    Enumerate enumerate)
+	{
+		lastRegistrationStatistics_ = {};
+
+		ModuleKind moduleKind;
+		if (!moduleKind.IsNativeModule(
 		        hProcess, reinterpret_cast<DWORD64>(baseOfImage)))
 		{
 			LOG_INFO << modulePath.wstring()
 			         << " is skipped as it is a managed module.";
 			return false;
 		}
+		isModule64Bits_ = moduleKind.Is64Bits();
+		dominatorAnalyzers_.clear();
+		basicBlockAnalyzers_.clear();
+
+		// The first path of the module is kept for its copies.
+		const auto& identity = moduleKind.GetIdentity();
+		auto canonicalPath = modulePath;
+		if (!identity.empty())
+			canonicalPath = identicalModulePaths_.emplace(identity, modulePath).first->second;
 
-		executedAddressManager_->AddModule(modulePath.wstring(), baseOfImage);
+		auto reportedPath = identicalModulesMerged_ ? canonicalPath : modulePath;
+		executedAddressManager_->AddModule(
+		    reportedPath.wstring(), baseOfImage, GetModuleIdentity(modulePath, identity));
 
 		moduleInfo_ = std::make_unique<FileFilter::ModuleInfo>(
 		    hProcess, modulePath, baseOfImage);
 
-		return debugInformationEnumerator_->Enumerate(modulePath, *this);
+		pagesToGuard_.clear();
+		pendingSourceFiles_.clear();
+		enumeratedSourceFiles_.clear();
+
+		auto start = std::chrono::steady_clock::now();
+		auto isEnumerated = ReplayModulePlan(modulePath, baseOfImage, identity);
+		if (!isEnumerated && canonicalPath != modulePath)
+			isEnumerated = ReplayModulePlan(canonicalPath, baseOfImage, identity);
+		if (!isEnumerated)
+		{
+			std::error_code error;
+			auto functionCount = monitoredFunctionCount_;
+
+			recordedPlan_ = ModulePlan{
+			    std::filesystem::last_write_time(modulePath, error), identity, false, 0, {}};
+			isEnumerated = enumerate();
+			{
+				TraceRecorder::ScopedSpan span{
+				    traceRecorder_.get(), "Source file filters", "filter", modulePath.wstring()};
+				SelectEnumeratedSourceFileLines();
+			}
+			recordedPlan_->isEnumerated_ = *isEnumerated;
+			recordedPlan_->functionCount_ = monitoredFunctionCount_ - functionCount;
+			if (!error)
+				modulePlans_[modulePath] = std::move(*recordedPlan_);
+			recordedPlan_.reset();
+		}
+		lastRegistrationStatistics_.enumerationTime_ = std::chrono::steady_clock::now() - start;
+
+		SetPendingBreakPoints(hProcess);
+
+		// Guard the pages once all the instructions of the module are read
+		// as reading a guarded page removes its guard.
+		GuardPages(hProcess, pagesToGuard_);
+		return *isEnumerated;
+	}
+
+	//--------------------------------------------------------------------------
+	bool MonitoredLineRegister::RegisterBaselineCoveredModule(
+	    const std::filesystem::path& modulePath,
+	    HANDLE hProcess,
+	    void* baseOfImage)
+	{
+		if (!coverageBaseline_)
+			return false;
+
+		ModuleKind moduleKind;
+		if (!moduleKind.IsNativeModule(hProcess, reinterpret_cast<DWORD64>(baseOfImage)))
+			return false;
+
+		const auto& identity = moduleKind.GetIdentity();
+		auto reportedPath = modulePath;
+		auto it = identicalModulePaths_.find(identity);
+		if (identicalModulesMerged_ && !identity.empty() && it != identicalModulePaths_.end())
+			reportedPath = it->second;
+
+		auto moduleIdentity = GetModuleIdentity(modulePath, identity);
+		if (moduleIdentity.empty() ||
+		    !coverageBaseline_->IsModuleCovered(reportedPath, moduleIdentity))
+		{
+			return false;
+		}
+
+		// The module is written without lines: the merge with the input
+		// coverage files adds them back.
+		lastRegistrationStatistics_ = {};
+		executedAddressManager_->AddModule(reportedPath.wstring(), baseOfImage, moduleIdentity);
+		++baselineCoveredModuleCount_;
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetBaselineCoveredModuleCount() const
+	{
+		return baselineCoveredModuleCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::EnableArmedBreakPointsTracking()
+	{
+		if (!armedBreakPoints_)
+			armedBreakPoints_ = BreakPoint::InstructionCollection{};
+	}
+
+	//--------------------------------------------------------------------------
+	BreakPoint::InstructionCollection
+	MonitoredLineRegister::TakeArmedBreakPoints()
+	{
+		if (!armedBreakPoints_)
+			THROW("Armed breakpoints tracking is not enabled.");
+
+		BreakPoint::InstructionCollection armedBreakPoints;
+		std::swap(armedBreakPoints, *armedBreakPoints_);
+		return armedBreakPoints;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetBreakPointsDeferred(bool breakPointsDeferred)
+	{
+		breakPointsDeferred_ = breakPointsDeferred;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::EnableFunctionRangesTracking()
+	{
+		if (!functionRanges_)
+			functionRanges_ = std::map<DWORD64, uint64_t>{};
+	}
+
+	//--------------------------------------------------------------------------
+	std::map<DWORD64, uint64_t> MonitoredLineRegister::TakeFunctionRanges()
+	{
+		if (!functionRanges_)
+			THROW("Function ranges tracking is not enabled.");
+
+		std::map<DWORD64, uint64_t> functionRanges;
+		std::swap(functionRanges, *functionRanges_);
+		return functionRanges;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetTraceRecorder(std::shared_ptr<TraceRecorder> traceRecorder)
+	{
+		traceRecorder_ = std::move(traceRecorder);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetSourceFileCache(std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
+	{
+		sourceFileCache_ = std::move(sourceFileCache);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetIdenticalModulesMerged(bool identicalModulesMerged)
+	{
+		identicalModulesMerged_ = identicalModulesMerged;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::OnSourceFileChecksum(
+	    const std::filesystem::path& path,
+	    const Tools::SourceChecksum& checksum)
+	{
+		if (sourceFileCache_)
+			sourceFileCache_->SetChecksum(path, checksum);
 	}
 
 	//--------------------------------------------------------------------------
@@ -126,16 +414,51 @@ namespace CppCoverage
 	{
 		auto isSelected = coverageFilterManager_->IsSourceFileSelected(path.wstring());
 		filterAssistant_->OnNewSourceFile(path, isSelected);
+		++lastRegistrationStatistics_.sourceFileCount_;
+		if (isSelected)
+			++lastRegistrationStatistics_.selectedSourceFileCount_;
 		return isSelected;
 	}
 
+	//--------------------------------------------------------------------------
+	boost::optional<std::set<int>> MonitoredLineRegister::GetSelectedLineNumbers(
+	    const std::filesystem::path& path)
+	{
+		return coverageFilterManager_->GetSelectedLineNumbers(path.wstring());
+	}
+
 	//--------------------------------------------------------------------------
 	void
 	MonitoredLineRegister::OnSourceFile(const std::filesystem::path& path,
 	                                    const std::vector<Line>& lines)
+	{
+		enumeratedSourceFiles_.push_back({path, lines});
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SelectEnumeratedSourceFileLines()
+	{
+		std::vector<std::wstring> paths;
+
+		for (const auto& sourceFile : enumeratedSourceFiles_)
+			paths.push_back(sourceFile.path_.wstring());
+		coverageFilterManager_->PrefetchSourceFiles(paths);
+
+		// The breakpoints, the lazy functions and the guarded pages are
+		// registered in the same order as without prefetch.
+		for (const auto& sourceFile : enumeratedSourceFiles_)
+			SelectSourceFileLines(sourceFile.path_, sourceFile.lines_);
+		enumeratedSourceFiles_.clear();
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SelectSourceFileLines(
+	    const std::filesystem::path& path,
+	    const std::vector<Line>& lines)
 	{
 		std::vector<FileFilter::LineInfo> lineInfos;
 
+		lineInfos.reserve(lines.size());
 		for (const auto& line : lines)
 		{
 			lineInfos.emplace_back(
@@ -147,12 +470,21 @@ namespace CppCoverage
 
 		std::vector<DWORD64> addresses;
 		LineNumberByAddress lineNumberByAddress;
+		std::vector<Line> selectedLines;
+		const auto isLineSelected = coverageFilterManager_->SelectLines(moduleInfo, fileInfo);
+		auto selectedLineCount = static_cast<size_t>(
+		    std::count(isLineSelected.begin(), isLineSelected.end(), true));
+		lastRegistrationStatistics_.lineCount_ += lines.size();
+		lastRegistrationStatistics_.selectedLineCount_ += selectedLineCount;
 
-		for (const auto& lineInfo : fileInfo.lineInfoColllection_)
+		addresses.reserve(selectedLineCount);
+		lineNumberByAddress.reserve(selectedLineCount);
+		selectedLines.reserve(selectedLineCount);
+		for (size_t i = 0; i < fileInfo.lineInfoColllection_.size(); ++i)
 		{
+			const auto& lineInfo = fileInfo.lineInfoColllection_[i];
 			auto lineNumber = lineInfo.lineNumber_;
-			if (coverageFilterManager_->IsLineSelected(
-			        moduleInfo, fileInfo, lineInfo))
+			if (isLineSelected[i])
 			{
 				auto addressValue =
 				    lineInfo.virtualAddress_ +
@@ -160,49 +492,781 @@ namespace CppCoverage
 
 				lineNumberByAddress[addressValue].push_back(lineNumber);
 				addresses.push_back(addressValue);
+				selectedLines.push_back(lines[i]);
 			}
 		}
-		SetBreakPoint(path,
-		              moduleInfo.hProcess_,
-		              std::move(addresses),
-		              lineNumberByAddress);
+		if (coverageLevel_ == CoverageLevel::Function)
+			KeepFunctionEntries(selectedLines, addresses, lineNumberByAddress);
+		else if (dominatorBreakPoints_)
+			MergeDominatedLines(selectedLines, addresses, lineNumberByAddress);
+		else if (basicBlockBreakPoints_)
+			MergeBasicBlockLines(selectedLines, addresses, lineNumberByAddress);
+		if (recordedPlan_)
+		{
+			recordedPlan_->sourceFiles_.push_back(
+			    {path,
+			     PackedLineTable{selectedLines,
+			                     addresses,
+			                     lineNumberByAddress,
+			                     reinterpret_cast<DWORD64>(moduleInfo.baseOfImage_)}});
+		}
+		MonitorSourceFile(
+		    path, selectedLines, std::move(addresses), std::move(lineNumberByAddress));
 	}
 
 	//--------------------------------------------------------------------------
-	void MonitoredLineRegister::SetBreakPoint(
+	boost::optional<bool> MonitoredLineRegister::ReplayModulePlan(
+	    const std::filesystem::path& modulePath,
+	    void* baseOfImage,
+	    const std::wstring& identity)
+	{
+		auto it = modulePlans_.find(modulePath);
+		if (it == modulePlans_.end())
+			return boost::none;
+
+		std::error_code error;
+		const auto& modulePlan = it->second;
+		if (std::filesystem::last_write_time(modulePath, error) != modulePlan.lastWriteTime_ || error)
+		{
+			modulePlans_.erase(it);
+			return boost::none;
+		}
+		if (modulePlan.identity_ != identity)
+			return boost::none;
+
+		LOG_DEBUG << L"Reuse the selected lines of " << modulePath.wstring();
+		lastRegistrationStatistics_.isReplayed_ = true;
+		lastRegistrationStatistics_.selectedSourceFileCount_ = modulePlan.sourceFiles_.size();
+		for (const auto& sourceFile : modulePlan.sourceFiles_)
+		{
+			std::vector<Line> selectedLines;
+			std::vector<DWORD64> addresses;
+			LineNumberByAddress lineNumberByAddress;
+
+			lastRegistrationStatistics_.selectedLineCount_ += sourceFile.lineTable_.GetLineCount();
+			sourceFile.lineTable_.Unpack(
+			    reinterpret_cast<DWORD64>(baseOfImage), selectedLines, addresses, lineNumberByAddress);
+			MonitorSourceFile(sourceFile.path_,
+			                  selectedLines,
+			                  std::move(addresses),
+			                  std::move(lineNumberByAddress));
+		}
+		monitoredFunctionCount_ += modulePlan.functionCount_;
+		++replayedModuleCount_;
+		return modulePlan.isEnumerated_;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::MonitorSourceFile(
+	    const std::filesystem::path& path,
+	    const std::vector<Line>& selectedLines,
+	    std::vector<DWORD64>&& addresses,
+	    LineNumberByAddress&& lineNumberByAddress)
+	{
+		if (functionRanges_)
+		{
+			auto baseOfImage =
+			    reinterpret_cast<DWORD64>(GetModuleInfo().baseOfImage_);
+			for (const auto& line : selectedLines)
+			{
+				if (line.functionLength_)
+				{
+					functionRanges_->emplace(
+					    line.functionVirtualAddress_ + baseOfImage,
+					    line.functionLength_);
+				}
+			}
+		}
+		RemoveExecutedAddresses(path, addresses, lineNumberByAddress);
+		ReserveLines(path, lineNumberByAddress);
+		pendingSourceFiles_.push_back(
+		    {path, std::move(addresses), std::move(lineNumberByAddress), {}});
+		if (lazyBreakPoints_)
+			GroupByLazyFunction(selectedLines, pendingSourceFiles_.back());
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::RemoveExecutedAddresses(
+	    const std::filesystem::path& path,
+	    std::vector<DWORD64>& addresses,
+	    LineNumberByAddress& lineNumberByAddress)
+	{
+		auto filename = path.wstring();
+		const auto& modulePath = GetModuleInfo().path_;
+		auto isExecuted = [&](int lineNumber) {
+			auto line = static_cast<unsigned int>(lineNumber);
+			return executedAddressManager_->IsLineExecuted(filename, line) ||
+			       (coverageBaseline_ &&
+			        coverageBaseline_->IsLineExecuted(modulePath, path, line));
+		};
+
+		// The coverage of a module is shared by all the processes and all the
+		// loads of this module: there is no need to monitor these lines again.
+		// The baseline lines are added back when the coverage is merged with
+		// the input coverage files.
+		std::vector<DWORD64> addressesToMonitor;
+		for (auto addressValue : addresses)
+		{
+			auto it = lineNumberByAddress.find(addressValue);
+			if (it == lineNumberByAddress.end())
+				continue; // Duplicated address already skipped.
+
+			const auto& lineNumbers = it->second;
+			if (std::all_of(lineNumbers.begin(), lineNumbers.end(), isExecuted))
+			{
+				lineNumberByAddress.erase(it);
+				++skippedAddressCount_;
+			}
+			else
+				addressesToMonitor.push_back(addressValue);
+		}
+		addresses = std::move(addressesToMonitor);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::ReserveLines(
 	    const std::filesystem::path& path,
-	    HANDLE hProcess,
-	    std::vector<DWORD64>&& addressCollection,
 	    const LineNumberByAddress& lineNumberByAddress)
 	{
+		auto firstLine = (std::numeric_limits<int>::max)();
+		auto lastLine = (std::numeric_limits<int>::min)();
+
+		for (const auto& pair : lineNumberByAddress)
+		{
+			for (auto lineNumber : pair.second)
+			{
+				firstLine = (std::min)(firstLine, lineNumber);
+				lastLine = (std::max)(lastLine, lineNumber);
+			}
+		}
+		if (firstLine <= lastLine)
+		{
+			executedAddressManager_->ReserveLines(path.wstring(),
+			                                      static_cast<unsigned int>(firstLine),
+			                                      static_cast<unsigned int>(lastLine));
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	// The addresses of all the source files of the module are read and written
+	// in one sorted pass: the source files share the same code pages, for
+	// example with inlined functions.
+	void MonitoredLineRegister::SetPendingBreakPoints(HANDLE hProcess)
+	{
+		if (pageGuardBreakPoints_)
+			SetPendingPageGuardBreakPoints(hProcess);
+		else
+		{
+			// Read before any breakpoint of the module is written.
+			auto lazyInstructions = ReadLazyFunctionInstructions(hProcess);
+			auto oldInstructionByAddress = ArmPendingAddresses(hProcess);
+
+			SetPendingLazyBreakPoints(hProcess, lazyInstructions, oldInstructionByAddress);
+		}
+		pendingSourceFiles_.clear();
+	}
+
+	//--------------------------------------------------------------------------
+	std::unordered_map<DWORD64, unsigned char>
+	MonitoredLineRegister::ArmPendingAddresses(HANDLE hProcess)
+	{
+		std::vector<DWORD64> addresses;
+		std::unordered_map<DWORD64, unsigned char> oldInstructionByAddress;
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			addresses.insert(addresses.end(),
+			                 sourceFile.addresses_.begin(),
+			                 sourceFile.addresses_.end());
+		}
+		if (addresses.empty())
+			return oldInstructionByAddress;
+		executedAddressManager_->ReserveAddresses(hProcess, addresses.size());
+
+		// Several source files can share the same address, for example with
+		// inlined functions: BreakPoint ignores the duplicates.
 		auto oldInstructions =
-		    breakPoint_->SetBreakPoints(hProcess, std::move(addressCollection));
+		    breakPointsDeferred_
+		        ? breakPoint_->ReadInstructions(hProcess, std::move(addresses))
+		        : breakPoint_->SetBreakPoints(hProcess, std::move(addresses));
+		std::unordered_map<DWORD64, bool> keepBreakPointByAddress;
+
+		for (const auto& value : oldInstructions)
+			oldInstructionByAddress.emplace(value.second, value.first);
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			for (auto addressValue : sourceFile.addresses_)
+			{
+				auto& keepBreakPoint = keepBreakPointByAddress[addressValue];
+				if (RegisterAddress(sourceFile.path_,
+				                    hProcess,
+				                    addressValue,
+				                    oldInstructionByAddress.at(addressValue),
+				                    sourceFile.lineNumberByAddress_))
+				{
+					keepBreakPoint = true;
+				}
+			}
+		}
+
+		BreakPoint::InstructionCollection breakPointsToRemove;
 		for (const auto& value : oldInstructions)
 		{
-			auto oldInstruction = value.first;
-			const auto& addressValue = value.second;
+			if (!keepBreakPointByAddress[value.second])
+			{
+				if (!breakPointsDeferred_)
+					breakPointsToRemove.push_back(value);
+			}
+			else if (armedBreakPoints_)
+				armedBreakPoints_->push_back(value);
+		}
+		breakPoint_->RemoveBreakPoints(hProcess, std::move(breakPointsToRemove));
+		return oldInstructionByAddress;
+	}
 
-			auto it = lineNumberByAddress.find(addressValue);
-			if (it != lineNumberByAddress.end())
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::GroupByLazyFunction(
+	    const std::vector<Line>& selectedLines,
+	    PendingSourceFile& sourceFile)
+	{
+		auto baseOfImage = reinterpret_cast<DWORD64>(GetModuleInfo().baseOfImage_);
+		std::unordered_map<DWORD64, DWORD64> functionByAddress;
+
+		for (const auto& line : selectedLines)
+		{
+			if (line.functionLength_)
 			{
-				Address address{hProcess,
-				                reinterpret_cast<void*>(addressValue)};
-				const auto& lineNumbers = it->second;
-				for (auto lineNumber : lineNumbers)
+				functionByAddress.emplace(
+				    line.virtualAddress_ + baseOfImage,
+				    line.functionVirtualAddress_ + baseOfImage);
+			}
+		}
+
+		// Lines without a known function are monitored immediately.
+		std::vector<DWORD64> addressesWithoutFunction;
+		for (auto addressValue : sourceFile.addresses_)
+		{
+			auto it = functionByAddress.find(addressValue);
+			if (it == functionByAddress.end())
+				addressesWithoutFunction.push_back(addressValue);
+			else
+				sourceFile.addressesByFunction_[it->second].push_back(addressValue);
+		}
+		sourceFile.addresses_ = std::move(addressesWithoutFunction);
+	}
+
+	//--------------------------------------------------------------------------
+	std::unordered_map<DWORD64, unsigned char>
+	MonitoredLineRegister::ReadLazyFunctionInstructions(HANDLE hProcess)
+	{
+		std::vector<DWORD64> addresses;
+		std::unordered_map<DWORD64, unsigned char> instructionByAddress;
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			for (const auto& pair : sourceFile.addressesByFunction_)
+				addresses.insert(addresses.end(), pair.second.begin(), pair.second.end());
+		}
+		if (addresses.empty())
+			return instructionByAddress;
+		for (const auto& value : breakPoint_->ReadInstructions(hProcess, std::move(addresses)))
+			instructionByAddress.emplace(value.second, value.first);
+		return instructionByAddress;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetPendingLazyBreakPoints(
+	    HANDLE hProcess,
+	    const std::unordered_map<DWORD64, unsigned char>& lazyInstructions,
+	    const std::unordered_map<DWORD64, unsigned char>& armedInstructions)
+	{
+		auto baseOfImage = GetModuleInfo().baseOfImage_;
+		std::vector<DWORD64> entries;
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			for (const auto& pair : sourceFile.addressesByFunction_)
+			{
+				auto functionAddress = pair.first;
+				Address entry{hProcess, reinterpret_cast<void*>(functionAddress)};
+
+				if (!lazyFunctions_.count(entry))
 				{
-					if (!executedAddressManager_->RegisterAddress(
-					        address,
-					        path.wstring(),
-					        lineNumber,
-					        oldInstruction))
+					lazyFunctions_.emplace(entry, LazyFunction{0, false, baseOfImage, {}});
+					entries.push_back(functionAddress);
+					++lazyFunctionCount_;
+				}
+			}
+		}
+
+		// The entry can also be the address of a line monitored immediately
+		// whose breakpoint is already written.
+		for (const auto& value : breakPoint_->SetBreakPoints(hProcess, std::move(entries)))
+		{
+			auto it = armedInstructions.find(value.second);
+			Address entry{hProcess, reinterpret_cast<void*>(value.second)};
+
+			lazyFunctions_.at(entry).entryInstruction_ =
+			    (it != armedInstructions.end()) ? it->second : value.first;
+		}
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			for (const auto& pair : sourceFile.addressesByFunction_)
+			{
+				auto functionAddress = pair.first;
+				Address entry{hProcess, reinterpret_cast<void*>(functionAddress)};
+				auto& lazyFunction = lazyFunctions_.at(entry);
+
+				for (auto addressValue : pair.second)
+				{
+					// The entry breakpoint can already be set by another module load.
+					auto oldInstruction = (addressValue == functionAddress)
+					    ? lazyFunction.entryInstruction_
+					    : lazyInstructions.at(addressValue);
+
+					if (RegisterAddress(sourceFile.path_,
+					                    hProcess,
+					                    addressValue,
+					                    oldInstruction,
+					                    sourceFile.lineNumberByAddress_))
 					{
-						breakPoint_->RemoveBreakPoint(address, oldInstruction);
+						lazyFunction.addresses_.push_back(addressValue);
+						if (addressValue == functionAddress)
+							lazyFunction.isEntryMonitored_ = true;
 					}
 				}
 			}
 		}
 	}
 
+	//--------------------------------------------------------------------------
+	bool MonitoredLineRegister::OnLazyFunctionEntry(const Address& address)
+	{
+		auto it = lazyFunctions_.find(address);
+
+		if (it == lazyFunctions_.end())
+			return false;
+
+		auto& lazyFunction = it->second;
+		auto hProcess = address.GetProcessHandle();
+
+		breakPoint_->SetBreakPoints(hProcess, std::move(lazyFunction.addresses_));
+		if (!lazyFunction.isEntryMonitored_)
+			breakPoint_->RemoveBreakPoint(address, lazyFunction.entryInstruction_);
+		lazyFunctions_.erase(it);
+		++armedLazyFunctionCount_;
+
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::SetPendingPageGuardBreakPoints(HANDLE hProcess)
+	{
+		auto baseOfImage = GetModuleInfo().baseOfImage_;
+		std::vector<DWORD64> addresses;
+		std::unordered_map<DWORD64, unsigned char> oldInstructionByAddress;
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			addresses.insert(addresses.end(),
+			                 sourceFile.addresses_.begin(),
+			                 sourceFile.addresses_.end());
+		}
+		if (addresses.empty())
+			return;
+		for (const auto& value : breakPoint_->ReadInstructions(hProcess, std::move(addresses)))
+			oldInstructionByAddress.emplace(value.second, value.first);
+
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			for (auto addressValue : sourceFile.addresses_)
+			{
+				if (RegisterAddress(sourceFile.path_,
+				                    hProcess,
+				                    addressValue,
+				                    oldInstructionByAddress.at(addressValue),
+				                    sourceFile.lineNumberByAddress_))
+				{
+					auto pageAddress = GetPageAddress(addressValue);
+					Address page{hProcess, reinterpret_cast<void*>(pageAddress)};
+					auto it = guardedPages_.find(page);
+
+					if (it == guardedPages_.end())
+					{
+						it = guardedPages_.emplace(page, GuardedPage{baseOfImage, {}}).first;
+						pagesToGuard_.push_back(pageAddress);
+					}
+					it->second.addresses_.push_back(addressValue);
+				}
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::GuardPages(HANDLE hProcess,
+	                                       const std::vector<DWORD64>& pages)
+	{
+		for (auto pageAddress : pages)
+		{
+			auto page = reinterpret_cast<void*>(pageAddress);
+			MEMORY_BASIC_INFORMATION memoryInfo;
+			DWORD oldProtect = 0;
+
+			++guardedPageCount_;
+			if (!VirtualQueryEx(hProcess, page, &memoryInfo, sizeof(memoryInfo)) ||
+			    !VirtualProtectEx(hProcess,
+			                      page,
+			                      static_cast<SIZE_T>(pageSize_),
+			                      memoryInfo.Protect | PAGE_GUARD,
+			                      &oldProtect))
+			{
+				LOG_WARNING << "Cannot guard page " << page
+				            << ", breakpoints are set immediately.";
+				OnGuardPageViolation(hProcess, pageAddress);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	bool MonitoredLineRegister::OnGuardPageViolation(HANDLE hProcess,
+	                                                 DWORD64 address)
+	{
+		Address page{hProcess, reinterpret_cast<void*>(GetPageAddress(address))};
+		auto it = guardedPages_.find(page);
+
+		if (it == guardedPages_.end())
+			return false;
+
+		// The system removes the guard before raising the exception.
+		breakPoint_->SetBreakPoints(hProcess, std::move(it->second.addresses_));
+		guardedPages_.erase(it);
+		++armedGuardedPageCount_;
+
+		return true;
+	}
+
+	//--------------------------------------------------------------------------
+	DWORD64 MonitoredLineRegister::GetPageAddress(DWORD64 address) const
+	{
+		return address & ~(pageSize_ - 1);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::OnExitProcess(HANDLE hProcess)
+	{
+		auto isSameProcess = [=](const auto& pair) {
+			return pair.first.GetProcessHandle() == hProcess;
+		};
+		EraseIf(lazyFunctions_, isSameProcess);
+		EraseIf(guardedPages_, isSameProcess);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::OnUnloadModule(HANDLE hProcess, void* baseOfImage)
+	{
+		auto isSameModule = [=](const auto& pair) {
+			return pair.first.GetProcessHandle() == hProcess &&
+			       pair.second.baseOfImage_ == baseOfImage;
+		};
+		EraseIf(lazyFunctions_, isSameModule);
+		EraseIf(guardedPages_, isSameModule);
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetLazyFunctionCount() const
+	{
+		return lazyFunctionCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetArmedLazyFunctionCount() const
+	{
+		return armedLazyFunctionCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetGuardedPageCount() const
+	{
+		return guardedPageCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetArmedGuardedPageCount() const
+	{
+		return armedGuardedPageCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetSkippedAddressCount() const
+	{
+		return skippedAddressCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetMonitoredFunctionCount() const
+	{
+		return monitoredFunctionCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	size_t MonitoredLineRegister::GetReplayedModuleCount() const
+	{
+		return replayedModuleCount_;
+	}
+
+	//--------------------------------------------------------------------------
+	const MonitoredLineRegister::RegistrationStatistics&
+	MonitoredLineRegister::GetLastRegistrationStatistics() const
+	{
+		return lastRegistrationStatistics_;
+	}
+
+	//--------------------------------------------------------------------------
+	uint64_t MonitoredLineRegister::GetMemoryUsage() const
+	{
+			auto bytes = Tools::GetAllocatedSize(plan.sourceFiles_) + Tools::GetAllocatedSize(plan.identity_);
+			auto bytes = Tools::GetAllocatedSize(plan.sourceFiles_);
+			for (const auto& sourceFile : plan.sourceFiles_)
+			{
+				bytes += Tools::GetAllocatedSize(sourceFile.path_) +
+				         sourceFile.lineTable_.GetAllocatedSize();
+			}
+			return bytes;
+		};
+		uint64_t bytes = Tools::GetNodesSize(modulePlans_) + Tools::GetNodesSize(lazyFunctions_) +
+		                 Tools::GetNodesSize(guardedPages_) + Tools::GetAllocatedSize(pagesToGuard_) +
+		                 Tools::GetAllocatedSize(pendingSourceFiles_) +
+		                 Tools::GetAllocatedSize(enumeratedSourceFiles_) +
+		                 Tools::GetNodesSize(identicalModulePaths_);
+
+		for (const auto& pair : modulePlans_)
+			bytes += Tools::GetAllocatedSize(pair.first) + getPlanSize(pair.second);
+		for (const auto& pair : identicalModulePaths_)
+			bytes += Tools::GetAllocatedSize(pair.first) + Tools::GetAllocatedSize(pair.second);
+		if (recordedPlan_)
+			bytes += getPlanSize(*recordedPlan_);
+		for (const auto& pair : lazyFunctions_)
+			bytes += Tools::GetAllocatedSize(pair.second.addresses_);
+		for (const auto& pair : guardedPages_)
+			bytes += Tools::GetAllocatedSize(pair.second.addresses_);
+		for (const auto& sourceFile : pendingSourceFiles_)
+		{
+			bytes += Tools::GetAllocatedSize(sourceFile.path_) + Tools::GetAllocatedSize(sourceFile.addresses_) +
+			         Tools::GetHashNodesSize(sourceFile.lineNumberByAddress_);
+		}
+		for (const auto& sourceFile : enumeratedSourceFiles_)
+			bytes += Tools::GetAllocatedSize(sourceFile.path_) + Tools::GetAllocatedSize(sourceFile.lines_);
+		return bytes;
+	}
+
+	//--------------------------------------------------------------------------
+	bool MonitoredLineRegister::RegisterAddress(
+	    const std::filesystem::path& path,
+	    HANDLE hProcess,
+	    DWORD64 addressValue,
+	    unsigned char oldInstruction,
+	    const LineNumberByAddress& lineNumberByAddress)
+	{
+		Address address{hProcess, reinterpret_cast<void*>(addressValue)};
+		bool keepBreakPoint = false;
+
+		for (auto lineNumber : lineNumberByAddress.at(addressValue))
+		{
+			// Only the first registration of an address keeps the breakpoint.
+			if (executedAddressManager_->RegisterAddress(
+			        address, path.wstring(), lineNumber, oldInstruction))
+			{
+				keepBreakPoint = true;
+			}
+		}
+		return keepBreakPoint;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::KeepFunctionEntries(
+	    const std::vector<Line>& selectedLines,
+	    std::vector<DWORD64>& addresses,
+	    LineNumberByAddress& lineNumberByAddress)
+	{
+		auto baseOfImage =
+		    reinterpret_cast<DWORD64>(GetModuleInfo().baseOfImage_);
+		LineNumberByAddress entryLineNumberByAddress;
+
+		// A function is kept only when its entry is a line of this file:
+		// the lines of an inlined function belong to the caller symbol.
+		addresses.clear();
+		for (const auto& line : selectedLines)
+		{
+			if (line.functionLength_ &&
+			    line.virtualAddress_ == line.functionVirtualAddress_)
+			{
+				auto addressValue = line.virtualAddress_ + baseOfImage;
+				auto& lineNumbers = entryLineNumberByAddress[addressValue];
+
+				if (lineNumbers.empty())
+				{
+					const auto& entryLineNumbers = lineNumberByAddress.at(addressValue);
+					lineNumbers.push_back(*std::min_element(
+					    entryLineNumbers.begin(), entryLineNumbers.end()));
+					addresses.push_back(addressValue);
+					++monitoredFunctionCount_;
+				}
+			}
+		}
+		lineNumberByAddress = std::move(entryLineNumberByAddress);
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::MergeBasicBlockLines(
+	    const std::vector<Line>& selectedLines,
+	    std::vector<DWORD64>& addresses,
+	    LineNumberByAddress& lineNumberByAddress)
+	{
+		auto baseOfImage =
+		    reinterpret_cast<DWORD64>(GetModuleInfo().baseOfImage_);
+		std::map<DWORD64, const Line*> lineByAddress;
+
+		for (const auto& line : selectedLines)
+			lineByAddress.emplace(line.virtualAddress_ + baseOfImage, &line);
+
+		// Lines inside the same basic block are monitored by the breakpoint
+		// of the first line of the block.
+		addresses.clear();
+		boost::optional<DWORD64> blockAddress;
+		const BasicBlockAnalyzer* blockAnalyzer = nullptr;
+
+		for (const auto& pair : lineByAddress)
+		{
+			auto addressValue = pair.first;
+			const auto& line = *pair.second;
+			const auto* analyzer = line.functionLength_
+			                           ? &GetBasicBlockAnalyzer(line)
+			                           : nullptr;
+
+			if (blockAddress && analyzer && analyzer == blockAnalyzer &&
+			    analyzer->IsInSameBasicBlock(*blockAddress, addressValue))
+			{
+				auto& blockLineNumbers = lineNumberByAddress[*blockAddress];
+				auto it = lineNumberByAddress.find(addressValue);
+				blockLineNumbers.insert(blockLineNumbers.end(),
+				                        it->second.begin(),
+				                        it->second.end());
+				lineNumberByAddress.erase(it);
+			}
+			else
+			{
+				blockAddress = addressValue;
+				blockAnalyzer = analyzer;
+				addresses.push_back(addressValue);
+			}
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	const BasicBlockAnalyzer&
+	MonitoredLineRegister::GetBasicBlockAnalyzer(const Line& line)
+	{
+		auto& analyzer = basicBlockAnalyzers_[line.functionVirtualAddress_];
+
+		// The code is read the first time a function is seen, so before any
+		// breakpoint is set inside it.
+		if (!analyzer)
+		{
+			const auto& moduleInfo = GetModuleInfo();
+			auto functionAddress =
+			    line.functionVirtualAddress_ +
+			    reinterpret_cast<DWORD64>(moduleInfo.baseOfImage_);
+			auto code = Tools::ReadProcessMemory(
+			    moduleInfo.hProcess_,
+			    reinterpret_cast<void*>(functionAddress),
+			    static_cast<size_t>(line.functionLength_));
+
+			analyzer = std::make_unique<BasicBlockAnalyzer>(
+			    code, functionAddress, isModule64Bits_);
+		}
+		return *analyzer;
+	}
+
+	//--------------------------------------------------------------------------
+	void MonitoredLineRegister::MergeDominatedLines(
+	    const std::vector<Line>& selectedLines,
+	    std::vector<DWORD64>& addresses,
+	    LineNumberByAddress& lineNumberByAddress)
+	{
+		auto baseOfImage =
+		    reinterpret_cast<DWORD64>(GetModuleInfo().baseOfImage_);
+		std::map<DWORD64, const Line*> lineByAddress;
+
+		for (const auto& line : selectedLines)
+			lineByAddress.emplace(line.virtualAddress_ + baseOfImage, &line);
+
+		// The first line of each basic block, by function.
+		std::vector<boost::optional<size_t>> basicBlocks;
+		std::map<std::pair<int64_t, size_t>, DWORD64> blockAddresses;
+		for (const auto& pair : lineByAddress)
+		{
+			const auto& line = *pair.second;
+			boost::optional<size_t> basicBlock;
+
+			if (line.functionLength_)
+				basicBlock = GetBasicBlockAnalyzer(line).FindBasicBlock(pair.first);
+			if (basicBlock)
+				blockAddresses.emplace(std::make_pair(line.functionVirtualAddress_, *basicBlock), pair.first);
+			basicBlocks.push_back(basicBlock);
+		}
+
+		// A block always runs the blocks it dominates and which post-dominate
+		// it: its lines are monitored by the breakpoint of the farthest one.
+		addresses.clear();
+		auto basicBlock = basicBlocks.begin();
+		for (const auto& pair : lineByAddress)
+		{
+			auto addressValue = pair.first;
+			const auto& line = *pair.second;
+
+			if (!*basicBlock)
+			{
+				addresses.push_back(addressValue);
+				++basicBlock;
+				continue;
+			}
+
+			const auto& dominatorAnalyzer = GetDominatorAnalyzer(line);
+			auto probeBlock = **basicBlock;
+			for (auto postDominator : dominatorAnalyzer.GetPostDominators(probeBlock))
+			{
+				if (blockAddresses.count({line.functionVirtualAddress_, postDominator}) &&
+				    dominatorAnalyzer.Dominates(**basicBlock, postDominator))
+					probeBlock = postDominator;
+			}
+			++basicBlock;
+
+			auto probeAddress = blockAddresses.at({line.functionVirtualAddress_, probeBlock});
+			if (probeAddress == addressValue)
+			{
+				addresses.push_back(addressValue);
+				continue;
+			}
+			auto& probeLineNumbers = lineNumberByAddress[probeAddress];
+			auto it = lineNumberByAddress.find(addressValue);
+			probeLineNumbers.insert(probeLineNumbers.end(), it->second.begin(), it->second.end());
+			lineNumberByAddress.erase(it);
+		}
+	}
+
+	//--------------------------------------------------------------------------
+	const DominatorAnalyzer&
+	MonitoredLineRegister::GetDominatorAnalyzer(const Line& line)
+	{
+		auto& analyzer = dominatorAnalyzers_[line.functionVirtualAddress_];
+
+		if (!analyzer)
+			analyzer = std::make_unique<DominatorAnalyzer>(GetBasicBlockAnalyzer(line));
+		return *analyzer;
+	}
+
 	//--------------------------------------------------------------------------
 	const FileFilter::ModuleInfo& MonitoredLineRegister::GetModuleInfo() const
 	{
@@ -17,9 +17,24 @@
 #pragma once
 
 #include "DebugInformationEnumerator.hpp"
+#include "AsyncDebugInformationEnumerator.hpp"
+#include "BreakPoint.hpp"
+#include "Address.hpp"
+#include "CoverageLevel.hpp"
+#include "PackedLineTable.hpp"
+#include "CppCoverageExport.hpp"
+#include <chrono>
 #include <memory>
+#include <map>
+#include <set>
 #include <unordered_map>
 #include <filesystem>
+#include <boost/optional.hpp>
+
+namespace Tools
+{
+	class SourceFileCache;
+}
 
 namespace FileFilter
 {
@@ -30,38 +45,191 @@ namespace FileFilter
 namespace CppCoverage
 {
 	class ICoverageFilterManager;
-	class BreakPoint;
 	class ExecutedAddressManager;
 	class FilterAssistant;
+	class BasicBlockAnalyzer;
+	class DominatorAnalyzer;
+	class CoverageBaseline;
+	class TraceRecorder;
 
-	class MonitoredLineRegister : private IDebugInformationHandler
+	class CPPCOVERAGE_DLL MonitoredLineRegister : private IDebugInformationHandler
 	{
 	  public:
 		MonitoredLineRegister(std::shared_ptr<BreakPoint>,
 		                      std::shared_ptr<ExecutedAddressManager>,
 		                      std::shared_ptr<ICoverageFilterManager>,
 		                      std::unique_ptr<DebugInformationEnumerator>,
-		                      std::shared_ptr<FilterAssistant>);
+		                      std::shared_ptr<FilterAssistant>,
+		                      bool basicBlockBreakPoints,
+		                      bool dominatorBreakPoints,
+		                      bool lazyBreakPoints,
+		                      bool pageGuardBreakPoints,
+		                      std::shared_ptr<const CoverageBaseline>,
+		                      CoverageLevel);
 		~MonitoredLineRegister();
 
 		bool RegisterLineToMonitor(const std::filesystem::path& modulePath,
 		                           HANDLE hProcess,
 		                           void* baseOfImage);
+		// Register a module enumerated by AsyncDebugInformationEnumerator.
+		bool RegisterLineToMonitor(
+		    const AsyncDebugInformationEnumerator::EnumeratedModule&);
+		// Register a module enumerated for another process or load address.
+		bool RegisterLineToMonitor(
+		    const AsyncDebugInformationEnumerator::EnumeratedModule&,
+		    const std::filesystem::path& modulePath,
+		    HANDLE hProcess,
+		    void* baseOfImage);
+
+		// Keep the breakpoints set by RegisterLineToMonitor until
+		// TakeArmedBreakPoints is called.
+		void EnableArmedBreakPointsTracking();
+		BreakPoint::InstructionCollection TakeArmedBreakPoints();
+
+		// When deferred, RegisterLineToMonitor registers the addresses but does
+		// not write the breakpoints. They are still returned by
+		// TakeArmedBreakPoints so the caller can set them later.
+		void SetBreakPointsDeferred(bool);
+
+		// Keep the functions of the lines registered by RegisterLineToMonitor
+		// until TakeFunctionRanges is called: the length of each function by
+		// its address.
+		void EnableFunctionRangesTracking();
+		std::map<DWORD64, uint64_t> TakeFunctionRanges();
+
+		// Record a span for the debug information read and the source file
+		// filters of each module.
+		void SetTraceRecorder(std::shared_ptr<TraceRecorder>);
+
+		// The checksums of the selected source files read from the PDB are
+		// set in the cache which checks them when the sources are read.
+		void SetSourceFileCache(std::shared_ptr<Tools::SourceFileCache>);
+
+		// The copies of a module at other paths, with the same timestamp,
+		// size and checksum in their PE header, reuse its selected lines.
+		// When merged, their coverage is also reported under the first path
+		// registered.
+		void SetIdenticalModulesMerged(bool);
+
+		// In lazy mode, only the entry of the functions has a breakpoint.
+		// Return true if address is such an entry: the line breakpoints of the
+		// function are set and the entry breakpoint is removed.
+		bool OnLazyFunctionEntry(const Address&);
+		void OnExitProcess(HANDLE hProcess);
+		void OnUnloadModule(HANDLE hProcess, void* baseOfImage);
+		size_t GetLazyFunctionCount() const;
+		size_t GetArmedLazyFunctionCount() const;
+
+		// In page guard mode, the code pages are guarded instead of having
+		// breakpoints. Return true if address is inside such a page: the
+		// breakpoints of the page are set.
+		bool OnGuardPageViolation(HANDLE hProcess, DWORD64 address);
+		size_t GetGuardedPageCount() const;
+		size_t GetArmedGuardedPageCount() const;
+
+		// Addresses not armed because all their lines were already executed
+		// in a previous load of the same module or in the coverage baseline.
+		size_t GetSkippedAddressCount() const;
+
+		// Register a module without its lines when the coverage baseline has
+		// executed all of them for the same image and PDB: there is nothing
+		// left to learn. Return false when the module must be registered.
+		bool RegisterBaselineCoveredModule(const std::filesystem::path& modulePath,
+		                                   HANDLE hProcess,
+		                                   void* baseOfImage);
+		size_t GetBaselineCoveredModuleCount() const;
+
+		// Number of functions monitored with CoverageLevel::Function.
+		size_t GetMonitoredFunctionCount() const;
+
+		// Loads of a module already registered, in any process, which reused
+		// its selected lines instead of enumerating and filtering them again.
+		size_t GetReplayedModuleCount() const;
+
+		// Source files and lines of the module registered by the last call to
+		// RegisterLineToMonitor. Only the selected ones are known for a
+		// replayed module.
+		struct RegistrationStatistics
+		{
+			size_t sourceFileCount_;
+			size_t selectedSourceFileCount_;
+			size_t lineCount_;
+			size_t selectedLineCount_;
+			// Reading the debug information and filtering the lines.
+			std::chrono::steady_clock::duration enumerationTime_;
+			bool isReplayed_;
+		};
+		const RegistrationStatistics& GetLastRegistrationStatistics() const;
+
+		// Estimated bytes of the lines and addresses kept for the modules.
+		uint64_t GetMemoryUsage() const;
 
 	  private:
 		bool IsSourceFileSelected(const std::filesystem::path&) override;
 		void OnSourceFile(const std::filesystem::path&,
 		                  const std::vector<Line>&) override;
+		void OnSourceFileChecksum(const std::filesystem::path&,
+		                          const Tools::SourceChecksum&) override;
+		boost::optional<std::set<int>>
+		GetSelectedLineNumbers(const std::filesystem::path&) override;
+
+		void SelectSourceFileLines(const std::filesystem::path&,
+		                           const std::vector<Line>&);
+		void SelectEnumeratedSourceFileLines();
+
+		template <typename Enumerate>
+		bool RegisterModule(const std::filesystem::path& modulePath,
+		                    HANDLE hProcess,
+		                    void* baseOfImage,
+		                    Enumerate);
 
-		using LineNumberByAddress =
-		    std::unordered_map<DWORD64, std::vector<int>>;
-		void SetBreakPoint(const std::filesystem::path&,
-		                   HANDLE hProcess,
-		                   std::vector<DWORD64>&&,
-		                   const LineNumberByAddress&);
+		using LineNumberByAddress = PackedLineTable::LineNumberByAddress;
+		void MonitorSourceFile(const std::filesystem::path&,
+		                       const std::vector<Line>& selectedLines,
+		                       std::vector<DWORD64>&& addresses,
+		                       LineNumberByAddress&&);
+		// boost::none when the module has no plan.
+		boost::optional<bool> ReplayModulePlan(const std::filesystem::path& modulePath,
+		                                       void* baseOfImage,
+		                                       const std::wstring& identity);
+		void RemoveExecutedAddresses(const std::filesystem::path&,
+		                             std::vector<DWORD64>& addresses,
+		                             LineNumberByAddress&);
+		void ReserveLines(const std::filesystem::path&,
+		                  const LineNumberByAddress&);
+		struct PendingSourceFile;
+		void SetPendingBreakPoints(HANDLE hProcess);
+		// Return the instructions replaced by the breakpoints by address.
+		std::unordered_map<DWORD64, unsigned char> ArmPendingAddresses(HANDLE hProcess);
+		void GroupByLazyFunction(const std::vector<Line>& selectedLines, PendingSourceFile&);
+		std::unordered_map<DWORD64, unsigned char> ReadLazyFunctionInstructions(HANDLE hProcess);
+		void SetPendingLazyBreakPoints(
+		    HANDLE hProcess,
+		    const std::unordered_map<DWORD64, unsigned char>& lazyInstructions,
+		    const std::unordered_map<DWORD64, unsigned char>& armedInstructions);
+		void SetPendingPageGuardBreakPoints(HANDLE hProcess);
+		void GuardPages(HANDLE hProcess, const std::vector<DWORD64>& pages);
+		DWORD64 GetPageAddress(DWORD64 address) const;
+		bool RegisterAddress(const std::filesystem::path&,
+		                     HANDLE hProcess,
+		                     DWORD64 addressValue,
+		                     unsigned char oldInstruction,
+		                     const LineNumberByAddress&);
 
 		const FileFilter::ModuleInfo& GetModuleInfo() const;
 
+		void KeepFunctionEntries(const std::vector<Line>&,
+		                         std::vector<DWORD64>& addresses,
+		                         LineNumberByAddress&);
+		void MergeBasicBlockLines(const std::vector<Line>&,
+		                          std::vector<DWORD64>& addresses,
+		                          LineNumberByAddress&);
+		const BasicBlockAnalyzer& GetBasicBlockAnalyzer(const Line&);
+		void MergeDominatedLines(const std::vector<Line>&,
+		                         std::vector<DWORD64>& addresses,
+		                         LineNumberByAddress&);
+		const DominatorAnalyzer& GetDominatorAnalyzer(const Line&);
+
 		std::unique_ptr<FileFilter::ModuleInfo> moduleInfo_;
 		const std::shared_ptr<BreakPoint> breakPoint_;
 		const std::shared_ptr<ExecutedAddressManager> executedAddressManager_;
@@ -69,5 +237,92 @@ namespace CppCoverage
 		const std::unique_ptr<DebugInformationEnumerator>
 		    debugInformationEnumerator_;
 		const std::shared_ptr<FilterAssistant> filterAssistant_;
+		std::shared_ptr<TraceRecorder> traceRecorder_;
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
+		boost::optional<BreakPoint::InstructionCollection> armedBreakPoints_;
+		boost::optional<std::map<DWORD64, uint64_t>> functionRanges_;
+		const bool basicBlockBreakPoints_;
+		const bool dominatorBreakPoints_;
+		const bool lazyBreakPoints_;
+		const bool pageGuardBreakPoints_;
+		const std::shared_ptr<const CoverageBaseline> coverageBaseline_;
+		const CoverageLevel coverageLevel_;
+		bool isModule64Bits_;
+		bool breakPointsDeferred_;
+		std::unordered_map<int64_t, std::unique_ptr<BasicBlockAnalyzer>>
+		    basicBlockAnalyzers_;
+		std::unordered_map<int64_t, std::unique_ptr<DominatorAnalyzer>>
+		    dominatorAnalyzers_;
+
+		struct LazyFunction
+		{
+			unsigned char entryInstruction_;
+			bool isEntryMonitored_;
+			void* baseOfImage_;
+			std::vector<DWORD64> addresses_;
+		};
+		std::map<Address, LazyFunction> lazyFunctions_;
+		size_t lazyFunctionCount_;
+		size_t armedLazyFunctionCount_;
+
+		struct GuardedPage
+		{
+			void* baseOfImage_;
+			std::vector<DWORD64> addresses_;
+		};
+		std::map<Address, GuardedPage> guardedPages_;
+		std::vector<DWORD64> pagesToGuard_;
+
+		// Breakpoints of a module are set at once after its enumeration.
+		struct PendingSourceFile
+		{
+			std::filesystem::path path_;
+			std::vector<DWORD64> addresses_;
+			LineNumberByAddress lineNumberByAddress_;
+			// In lazy mode, the addresses of the known functions by function
+			// address. They are not in addresses_.
+			std::map<DWORD64, std::vector<DWORD64>> addressesByFunction_;
+		};
+		std::vector<PendingSourceFile> pendingSourceFiles_;
+
+		// The source files of a module are filtered at once after its
+		// enumeration, in the enumeration order.
+		struct EnumeratedSourceFile
+		{
+			std::filesystem::path path_;
+			std::vector<Line> lines_;
+		};
+		std::vector<EnumeratedSourceFile> enumeratedSourceFiles_;
+
+		// The lines selected in a module, before the removal of the lines
+		// already executed. They depend only on the module file and the
+		// filters: another load of the module only rebases the addresses.
+		// They are kept for all the modules loaded so they are packed.
+		struct PlannedSourceFile
+		{
+			std::filesystem::path path_;
+			PackedLineTable lineTable_;
+		};
+		struct ModulePlan
+		{
+			std::filesystem::file_time_type lastWriteTime_;
+			std::wstring identity_;
+			bool isEnumerated_;
+			size_t functionCount_;
+			std::vector<PlannedSourceFile> sourceFiles_;
+		};
+		std::map<std::filesystem::path, ModulePlan> modulePlans_;
+		// The first path registered for each module identity.
+		std::map<std::wstring, std::filesystem::path> identicalModulePaths_;
+		bool identicalModulesMerged_ = false;
+		boost::optional<ModulePlan> recordedPlan_;
+		DWORD64 pageSize_;
+		size_t guardedPageCount_;
+		size_t armedGuardedPageCount_;
+		size_t skippedAddressCount_;
+		size_t monitoredFunctionCount_;
+		size_t replayedModuleCount_;
+		size_t baselineCoveredModuleCount_;
+		RegistrationStatistics lastRegistrationStatistics_;
 	};
 }
@@ -0,0 +1,740 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "NativePdbReader.hpp"
+
+#include <Windows.h>
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "Tools/Log.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+#include "Handle.hpp"
+#include "PdbReference.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const char MsfMagic[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+		const uint32_t PdbInfoStream = 1;
+		const uint32_t DbiStream = 3;
+		const uint16_t NilStream = 0xFFFF;
+		const uint32_t NilStreamSize = 0xFFFFFFFF;
+		const int32_t DbiVersionSignature = -1;
+		const size_t SectionHeaderDebugStream = 5;
+		const uint32_t NamesSignature = 0xEFFEEFFE;
+		const uint32_t C13Signature = 4;
+
+		const uint16_t S_LPROC32 = 0x110F;
+		const uint16_t S_GPROC32 = 0x1110;
+		const uint16_t S_LPROC32_ID = 0x1146;
+		const uint16_t S_GPROC32_ID = 0x1147;
+
+		const uint32_t DebugSubsectionIgnore = 0x80000000;
+		const uint32_t DebugSubsectionLines = 0xF2;
+		const uint32_t DebugSubsectionFileChecksums = 0xF4;
+		const uint16_t LinesHaveColumns = 0x0001;
+		// Feature of the PDB information stream written by /DEBUG:FASTLINK.
+		const uint32_t MinimalDebugInfoFeature = 0x494E494D;
+
+		//---------------------------------------------------------------------
+		class Reader
+		{
+		public:
+			//-----------------------------------------------------------------
+			Reader(const char* data, size_t size)
+				: data_{data}, size_{size}, position_{0}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			template <typename T>
+			T Read()
+			{
+				T value;
+				std::memcpy(&value, Get(sizeof(T)), sizeof(T));
+				return value;
+			}
+
+			//-----------------------------------------------------------------
+			const char* Get(size_t size)
+			{
+				if (size > size_ - position_)
+					THROW(L"Invalid PDB file: unexpected end of stream.");
+				const auto* data = data_ + position_;
+				position_ += size;
+				return data;
+			}
+
+			//-----------------------------------------------------------------
+			void Skip(size_t size)
+			{
+				Get(size);
+			}
+
+			//-----------------------------------------------------------------
+			Reader GetReader(size_t size)
+			{
+				return Reader{Get(size), size};
+			}
+
+			//-----------------------------------------------------------------
+			std::string ReadString()
+			{
+				const auto* begin = data_ + position_;
+				const auto* end = std::find(begin, data_ + size_, '\0');
+				if (end == data_ + size_)
+					THROW(L"Invalid PDB file: unterminated string.");
+				position_ += static_cast<size_t>(end - begin) + 1;
+				return {begin, end};
+			}
+
+			//-----------------------------------------------------------------
+			void Seek(size_t position)
+			{
+				if (position > size_)
+					THROW(L"Invalid PDB file: invalid offset.");
+				position_ = position;
+			}
+
+			//-----------------------------------------------------------------
+			void Align(size_t alignment)
+			{
+				position_ = (std::min)(size_, (position_ + alignment - 1) / alignment * alignment);
+			}
+
+			//-----------------------------------------------------------------
+			bool IsEnd() const
+			{
+				return position_ == size_;
+			}
+
+		private:
+			const char* data_;
+			size_t size_;
+			size_t position_;
+		};
+
+		//---------------------------------------------------------------------
+		class MsfFile
+		{
+		public:
+			//-----------------------------------------------------------------
+			MsfFile(const char* data, size_t size)
+				: data_{data}, size_{size}
+			{
+				Reader superBlock{data, size};
+				superBlock.Skip(sizeof(MsfMagic));
+				blockSize_ = superBlock.Read<uint32_t>();
+				superBlock.Skip(2 * sizeof(uint32_t)); // FreeBlockMapBlock, NumBlocks
+				auto directorySize = superBlock.Read<uint32_t>();
+				superBlock.Skip(sizeof(uint32_t));
+				auto blockMapAddress = superBlock.Read<uint32_t>();
+
+				if (blockSize_ == 0)
+					THROW(L"Invalid PDB file: invalid block size.");
+				auto directoryBlockCount = GetBlockCount(directorySize);
+				if (directoryBlockCount * sizeof(uint32_t) > blockSize_)
+					THROW(L"Invalid PDB file: invalid stream directory.");
+
+				Reader blockMap{GetBlock(blockMapAddress, blockSize_), blockSize_};
+				std::vector<uint32_t> directoryBlocks(directoryBlockCount);
+				for (auto& block : directoryBlocks)
+					block = blockMap.Read<uint32_t>();
+				auto directory = ReadBlocks(directoryBlocks, directorySize);
+
+				Reader directoryReader{directory.data(), directory.size()};
+				streams_.resize(directoryReader.Read<uint32_t>());
+				for (auto& stream : streams_)
+				{
+					stream.size_ = directoryReader.Read<uint32_t>();
+					if (stream.size_ == NilStreamSize)
+						stream.size_ = 0;
+				}
+				for (auto& stream : streams_)
+				{
+					stream.blocks_.resize(GetBlockCount(stream.size_));
+					for (auto& block : stream.blocks_)
+						block = directoryReader.Read<uint32_t>();
+				}
+			}
+
+			//-----------------------------------------------------------------
+			std::vector<char> ReadStream(uint32_t index) const
+			{
+				if (index >= streams_.size())
+					THROW(L"Invalid PDB file: invalid stream " << index);
+				const auto& stream = streams_[index];
+				return ReadBlocks(stream.blocks_, stream.size_);
+			}
+
+		private:
+			MsfFile(const MsfFile&) = delete;
+			MsfFile& operator=(const MsfFile&) = delete;
+
+			struct Stream
+			{
+				uint32_t size_;
+				std::vector<uint32_t> blocks_;
+			};
+
+			//-----------------------------------------------------------------
+			size_t GetBlockCount(uint32_t size) const
+			{
+				return (static_cast<size_t>(size) + blockSize_ - 1) / blockSize_;
+			}
+
+			//-----------------------------------------------------------------
+			const char* GetBlock(uint32_t block, size_t size) const
+			{
+				auto offset = static_cast<uint64_t>(block) * blockSize_;
+				if (offset + size > size_)
+					THROW(L"Invalid PDB file: invalid block " << block);
+				return data_ + offset;
+			}
+
+			//-----------------------------------------------------------------
+			std::vector<char> ReadBlocks(const std::vector<uint32_t>& blocks,
+			                             uint32_t size) const
+			{
+				std::vector<char> buffer(size);
+				for (size_t i = 0; i < blocks.size(); ++i)
+				{
+					auto offset = i * blockSize_;
+					auto blockSize = (std::min)(static_cast<size_t>(blockSize_), buffer.size() - offset);
+					std::memcpy(&buffer[offset], GetBlock(blocks[i], blockSize), blockSize);
+				}
+				return buffer;
+			}
+
+			const char* data_;
+			size_t size_;
+			uint32_t blockSize_;
+			std::vector<Stream> streams_;
+		};
+
+		//---------------------------------------------------------------------
+		std::string GetString(const std::vector<char>& buffer, uint32_t offset)
+		{
+			Reader reader{buffer.data(), buffer.size()};
+			reader.Seek(offset);
+			return reader.ReadString();
+		}
+
+		//---------------------------------------------------------------------
+		struct PdbInfo
+		{
+			uint32_t namesStream_;
+			// Written by the source indexing of the PDB.
+			boost::optional<uint32_t> sourceServerStream_;
+			// The symbols and the lines are in the object files.
+			bool isFastLink_;
+		};
+
+		//---------------------------------------------------------------------
+		// boost::none when the PDB does not match the module.
+		boost::optional<PdbInfo> ReadPdbInfo(const std::vector<char>& pdbInfo,
+		                                     const PdbReference& pdbReference)
+		{
+			Reader reader{pdbInfo.data(), pdbInfo.size()};
+			reader.Skip(3 * sizeof(uint32_t)); // Version, Signature, Age
+			auto guid = reader.Read<GUID>();
+			if (guid != pdbReference.guid_)
+				return boost::none;
+
+			// Named stream map: a string buffer followed by a hash table.
+			auto stringsSize = reader.Read<uint32_t>();
+			const auto* strings = reader.Get(stringsSize);
+			std::vector<char> stringBuffer{strings, strings + stringsSize};
+			reader.Skip(sizeof(uint32_t)); // Size
+			auto capacity = reader.Read<uint32_t>();
+			std::vector<uint32_t> presentBits(reader.Read<uint32_t>());
+			for (auto& bits : presentBits)
+				bits = reader.Read<uint32_t>();
+			reader.Skip(reader.Read<uint32_t>() * sizeof(uint32_t)); // Deleted bits
+
+			boost::optional<uint32_t> namesStream;
+			boost::optional<uint32_t> sourceServerStream;
+			for (uint32_t i = 0; i < capacity; ++i)
+			{
+				if (i / 32 < presentBits.size() && (presentBits[i / 32] & (1u << (i % 32))))
+				{
+					auto nameOffset = reader.Read<uint32_t>();
+					auto streamIndex = reader.Read<uint32_t>();
+					auto name = GetString(stringBuffer, nameOffset);
+					if (name == "/names")
+						namesStream = streamIndex;
+					else if (name == "srcsrv")
+						sourceServerStream = streamIndex;
+				}
+			}
+			if (!namesStream)
+				THROW(L"Invalid PDB file: cannot find /names stream.");
+
+			// The named stream map is followed by the features of the PDB.
+			auto isFastLink = false;
+			while (!reader.IsEnd())
+				isFastLink = isFastLink || reader.Read<uint32_t>() == MinimalDebugInfoFeature;
+			return PdbInfo{*namesStream, sourceServerStream, isFastLink};
+		}
+
+		//---------------------------------------------------------------------
+		struct DbiHeader
+		{
+			Reader modInfo_;
+			Reader optionalDbgHeader_;
+		};
+
+		//---------------------------------------------------------------------
+		// boost::none when the DBI stream does not match the module.
+		boost::optional<DbiHeader> ReadDbiHeader(const std::vector<char>& dbi,
+		                                         const PdbReference& pdbReference)
+		{
+			Reader reader{dbi.data(), dbi.size()};
+			if (reader.Read<int32_t>() != DbiVersionSignature)
+				return boost::none;
+			reader.Skip(sizeof(uint32_t)); // VersionHeader
+			if (reader.Read<uint32_t>() != pdbReference.age_)
+				return boost::none;
+			reader.Skip(6 * sizeof(uint16_t));
+			auto modInfoSize = reader.Read<uint32_t>();
+			auto sectionContributionSize = reader.Read<uint32_t>();
+			auto sectionMapSize = reader.Read<uint32_t>();
+			auto sourceInfoSize = reader.Read<uint32_t>();
+			auto typeServerMapSize = reader.Read<uint32_t>();
+			reader.Skip(sizeof(uint32_t)); // MFCTypeServerIndex
+			auto optionalDbgHeaderSize = reader.Read<uint32_t>();
+			auto ecSize = reader.Read<uint32_t>();
+			reader.Skip(2 * sizeof(uint16_t) + sizeof(uint32_t)); // Flags, Machine, Padding
+
+			auto modInfo = reader.GetReader(modInfoSize);
+			reader.Skip(sectionContributionSize);
+			reader.Skip(sectionMapSize);
+			reader.Skip(sourceInfoSize);
+			reader.Skip(typeServerMapSize);
+			reader.Skip(ecSize);
+			return DbiHeader{modInfo, reader.GetReader(optionalDbgHeaderSize)};
+		}
+
+		//---------------------------------------------------------------------
+		struct DbiModuleInfo
+		{
+			uint16_t moduleStream_;
+			uint32_t symbolsSize_;
+			uint32_t c11Size_;
+			uint32_t c13Size_;
+			std::string objFileName_;
+		};
+
+		//---------------------------------------------------------------------
+		DbiModuleInfo ReadModuleInfo(Reader& modInfo)
+		{
+			DbiModuleInfo moduleInfo;
+
+			modInfo.Skip(34); // Unused, SectionContribution, Flags
+			moduleInfo.moduleStream_ = modInfo.Read<uint16_t>();
+			moduleInfo.symbolsSize_ = modInfo.Read<uint32_t>();
+			moduleInfo.c11Size_ = modInfo.Read<uint32_t>();
+			moduleInfo.c13Size_ = modInfo.Read<uint32_t>();
+			modInfo.Skip(16); // SourceFileCount, Padding, Unused, SourceFileNameIndex, PdbFilePathNameIndex
+			modInfo.ReadString(); // ModuleName
+			moduleInfo.objFileName_ = modInfo.ReadString();
+			modInfo.Align(sizeof(uint32_t));
+			return moduleInfo;
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<uint32_t> GetRva(const std::vector<IMAGE_SECTION_HEADER>& sections,
+		                                 uint16_t segment,
+		                                 uint32_t offset)
+		{
+			if (segment == 0 || segment > sections.size())
+				return boost::none;
+			return sections[segment - 1].VirtualAddress + offset;
+		}
+
+		//---------------------------------------------------------------------
+		struct Function
+		{
+			uint32_t rva_;
+			uint32_t length_;
+			unsigned long symbolIndex_;
+		};
+
+		//---------------------------------------------------------------------
+		class PdbLineReader
+		{
+		public:
+			//-----------------------------------------------------------------
+			PdbLineReader(std::vector<char> names,
+			              std::vector<IMAGE_SECTION_HEADER> sections)
+				: names_{std::move(names)}
+				, sections_{std::move(sections)}
+			{
+				Reader reader{names_.data(), names_.size()};
+				if (reader.Read<uint32_t>() != NamesSignature)
+					THROW(L"Invalid PDB file: invalid /names stream.");
+			}
+
+			//-----------------------------------------------------------------
+			// false when the module symbols are not in the C13 format.
+			bool ReadModule(const std::vector<char>& moduleStream,
+			                uint32_t symbolsSize,
+			                uint32_t c11Size,
+			                uint32_t c13Size)
+			{
+				Reader reader{moduleStream.data(), moduleStream.size()};
+				if (symbolsSize != 0 &&
+				    (symbolsSize < sizeof(uint32_t) || reader.Read<uint32_t>() != C13Signature))
+					return false;
+				auto symbols = reader.GetReader(symbolsSize ? symbolsSize - sizeof(uint32_t) : 0);
+				reader.Skip(c11Size);
+				auto lines = reader.GetReader(c13Size);
+
+				auto functions = ReadFunctions(symbols);
+				ReadLines(lines, functions);
+				return true;
+			}
+
+			//-----------------------------------------------------------------
+			std::vector<PdbSourceFile> GetSourceFiles()
+			{
+				return std::move(sourceFiles_);
+			}
+
+		private:
+			PdbLineReader(const PdbLineReader&) = delete;
+			PdbLineReader& operator=(const PdbLineReader&) = delete;
+
+			//-----------------------------------------------------------------
+			std::vector<Function> ReadFunctions(Reader& symbols)
+			{
+				std::vector<Function> functions;
+
+				while (!symbols.IsEnd())
+				{
+					auto record = symbols.GetReader(symbols.Read<uint16_t>());
+					auto kind = record.Read<uint16_t>();
+
+					if (kind == S_LPROC32 || kind == S_GPROC32 ||
+					    kind == S_LPROC32_ID || kind == S_GPROC32_ID)
+					{
+						record.Skip(3 * sizeof(uint32_t)); // Parent, End, Next
+						auto length = record.Read<uint32_t>();
+						record.Skip(3 * sizeof(uint32_t)); // DbgStart, DbgEnd, FunctionType
+						auto offset = record.Read<uint32_t>();
+						auto segment = record.Read<uint16_t>();
+						auto rva = GetRva(sections_, segment, offset);
+						if (rva)
+							functions.push_back({*rva, length, ++symbolIndex_});
+					}
+				}
+				std::sort(functions.begin(), functions.end(), [](const auto& f1, const auto& f2) {
+					return f1.rva_ < f2.rva_;
+				});
+				return functions;
+			}
+
+			//-----------------------------------------------------------------
+			void ReadLines(Reader& subsections, const std::vector<Function>& functions)
+			{
+				boost::optional<Reader> checksums;
+				std::vector<Reader> lines;
+
+				while (!subsections.IsEnd())
+				{
+					auto kind = subsections.Read<uint32_t>();
+					auto subsection = subsections.GetReader(subsections.Read<uint32_t>());
+					subsections.Align(sizeof(uint32_t));
+
+					if (kind == DebugSubsectionFileChecksums)
+						checksums = subsection;
+					else if (kind == DebugSubsectionLines)
+						lines.push_back(subsection);
+				}
+
+				if (!lines.empty() && !checksums)
+					THROW(L"Invalid PDB file: cannot find file checksums.");
+				for (auto& subsection : lines)
+					ReadLineSubsection(subsection, *checksums, functions);
+			}
+
+			//-----------------------------------------------------------------
+			void ReadLineSubsection(Reader& subsection,
+			                        Reader checksums,
+			                        const std::vector<Function>& functions)
+			{
+				auto offset = subsection.Read<uint32_t>();
+				auto segment = subsection.Read<uint16_t>();
+				auto flags = subsection.Read<uint16_t>();
+				subsection.Skip(sizeof(uint32_t)); // CodeSize
+
+				while (!subsection.IsEnd())
+				{
+					auto fileId = subsection.Read<uint32_t>();
+					auto lineCount = subsection.Read<uint32_t>();
+					auto blockSize = subsection.Read<uint32_t>();
+					if (blockSize < 3 * sizeof(uint32_t))
+						THROW(L"Invalid PDB file: invalid line block.");
+					auto block = subsection.GetReader(blockSize - 3 * sizeof(uint32_t));
+
+					checksums.Seek(fileId);
+					auto& sourceFile = GetSourceFile(checksums);
+					for (uint32_t i = 0; i < lineCount; ++i)
+					{
+						auto lineOffset = block.Read<uint32_t>();
+						auto lineNumber = block.Read<uint32_t>() & 0x00FFFFFF;
+						auto rva = GetRva(sections_, segment, offset + lineOffset);
+
+						// Skip invalid lines
+						if (rva && lineNumber != 0x00f00f00 && lineNumber != 0x00feefee)
+							AddLine(sourceFile, lineNumber, *rva, functions);
+					}
+					if (flags & LinesHaveColumns)
+						block.Skip(lineCount * 2 * sizeof(uint16_t));
+				}
+			}
+
+			//-----------------------------------------------------------------
+			// checksum is positioned on the file checksum entry of the source.
+			PdbSourceFile& GetSourceFile(Reader& checksum)
+			{
+				auto nameOffset = checksum.Read<uint32_t>();
+				auto it = sourceFileIndexes_.find(nameOffset);
+				if (it == sourceFileIndexes_.end())
+				{
+					it = sourceFileIndexes_.emplace(nameOffset, sourceFiles_.size()).first;
+					auto relativeOffset = nameOffset + 3 * sizeof(uint32_t); // Signature, Version, Size
+					sourceFiles_.push_back({Tools::Utf8ToWString(GetString(names_, static_cast<uint32_t>(relativeOffset))), {}});
+					sourceFiles_.back().checksum_ = ReadChecksum(checksum);
+				}
+				return sourceFiles_[it->second];
+			}
+
+			//-----------------------------------------------------------------
+			static Tools::SourceChecksum ReadChecksum(Reader& checksum)
+			{
+				Tools::SourceChecksum sourceChecksum;
+				auto size = checksum.Read<uint8_t>();
+				auto kind = checksum.Read<uint8_t>();
+				const auto* bytes = checksum.Get(size);
+
+				if (size != 0 && kind <= static_cast<uint8_t>(Tools::SourceChecksum::Type::Sha256))
+				{
+					sourceChecksum.type_ = static_cast<Tools::SourceChecksum::Type>(kind);
+					sourceChecksum.bytes_.assign(bytes, size);
+				}
+				return sourceChecksum;
+			}
+
+			//-----------------------------------------------------------------
+			static void AddLine(PdbSourceFile& sourceFile,
+			                    unsigned long lineNumber,
+			                    uint32_t rva,
+			                    const std::vector<Function>& functions)
+			{
+				auto it = std::upper_bound(functions.begin(), functions.end(), rva,
+				                           [](uint32_t value, const auto& function) {
+					                           return value < function.rva_;
+				                           });
+				if (it != functions.begin() && rva < std::prev(it)->rva_ + std::prev(it)->length_)
+				{
+					const auto& function = *std::prev(it);
+					sourceFile.lines_.emplace_back(lineNumber, rva, function.symbolIndex_,
+					                               function.rva_, function.length_);
+				}
+				else
+					sourceFile.lines_.emplace_back(lineNumber, rva, 0);
+			}
+
+			const std::vector<char> names_;
+			const std::vector<IMAGE_SECTION_HEADER> sections_;
+			std::vector<PdbSourceFile> sourceFiles_;
+			std::unordered_map<uint32_t, size_t> sourceFileIndexes_;
+			unsigned long symbolIndex_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		boost::optional<std::vector<PdbSourceFile>>
+		ReadPdb(const MsfFile& msfFile, const PdbReference& pdbReference)
+		{
+			auto pdbInfo = ReadPdbInfo(msfFile.ReadStream(PdbInfoStream), pdbReference);
+			if (!pdbInfo || pdbInfo->isFastLink_)
+				return boost::none;
+
+			auto dbi = msfFile.ReadStream(DbiStream);
+			auto dbiHeader = ReadDbiHeader(dbi, pdbReference);
+			if (!dbiHeader)
+				return boost::none;
+
+			auto& modInfo = dbiHeader->modInfo_;
+			auto& optionalDbgHeader = dbiHeader->optionalDbgHeader_;
+			optionalDbgHeader.Skip(SectionHeaderDebugStream * sizeof(uint16_t));
+			auto sectionHeaderStream = optionalDbgHeader.Read<uint16_t>();
+			if (sectionHeaderStream == NilStream)
+				return boost::none;
+			auto sectionHeaders = msfFile.ReadStream(sectionHeaderStream);
+			std::vector<IMAGE_SECTION_HEADER> sections(sectionHeaders.size() / sizeof(IMAGE_SECTION_HEADER));
+			if (!sections.empty())
+				std::memcpy(sections.data(), sectionHeaders.data(), sections.size() * sizeof(IMAGE_SECTION_HEADER));
+
+			PdbLineReader lineReader{msfFile.ReadStream(pdbInfo->namesStream_), std::move(sections)};
+			while (!modInfo.IsEnd())
+			{
+				auto moduleInfo = ReadModuleInfo(modInfo);
+
+				if (moduleInfo.moduleStream_ == NilStream)
+					continue;
+				if ((moduleInfo.c11Size_ != 0 && moduleInfo.c13Size_ == 0) ||
+				    !lineReader.ReadModule(msfFile.ReadStream(moduleInfo.moduleStream_),
+				                           moduleInfo.symbolsSize_,
+				                           moduleInfo.c11Size_,
+				                           moduleInfo.c13Size_))
+					return boost::none;
+			}
+			return lineReader.GetSourceFiles();
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<std::vector<std::filesystem::path>>
+		ReadObjectFiles(const MsfFile& msfFile, const PdbReference& pdbReference)
+		{
+			auto pdbInfo = ReadPdbInfo(msfFile.ReadStream(PdbInfoStream), pdbReference);
+			if (!pdbInfo || !pdbInfo->isFastLink_)
+				return boost::none;
+
+			auto dbi = msfFile.ReadStream(DbiStream);
+			auto dbiHeader = ReadDbiHeader(dbi, pdbReference);
+			if (!dbiHeader)
+				return boost::none;
+
+			std::set<std::filesystem::path> objectFiles;
+			auto& modInfo = dbiHeader->modInfo_;
+			while (!modInfo.IsEnd())
+			{
+				auto moduleInfo = ReadModuleInfo(modInfo);
+
+				// The modules of a library have the path of the library.
+				if (!moduleInfo.objFileName_.empty())
+					objectFiles.insert(Tools::Utf8ToWString(moduleInfo.objFileName_));
+			}
+			return std::vector<std::filesystem::path>{objectFiles.begin(), objectFiles.end()};
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<std::string>
+		ReadSourceServer(const MsfFile& msfFile, const PdbReference& pdbReference)
+		{
+			auto pdbInfo = ReadPdbInfo(msfFile.ReadStream(PdbInfoStream), pdbReference);
+			if (!pdbInfo || !pdbInfo->sourceServerStream_)
+				return boost::none;
+
+			auto sourceServer = msfFile.ReadStream(*pdbInfo->sourceServerStream_);
+			return std::string{sourceServer.begin(), sourceServer.end()};
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<std::filesystem::path>
+		FindPdb(const std::filesystem::path& modulePath, const PdbReference& pdbReference)
+		{
+			std::error_code error;
+			if (std::filesystem::is_regular_file(pdbReference.pdbPath_, error))
+				return pdbReference.pdbPath_;
+
+			auto pdbPath = modulePath.parent_path() / pdbReference.pdbPath_.filename();
+			if (std::filesystem::is_regular_file(pdbPath, error))
+				return pdbPath;
+			return boost::none;
+		}
+
+		//---------------------------------------------------------------------
+		// Call readPdb with the MSF file of the PDB of the module, boost::none
+		// when the PDB cannot be found or is not a MSF file.
+		template <typename ReadPdbFunction>
+		auto ReadMsfFile(const std::filesystem::path& modulePath, ReadPdbFunction readPdb)
+		    -> decltype(readPdb(std::declval<const MsfFile&>(), std::declval<const PdbReference&>()))
+		{
+			auto pdbReference = PdbReference::Read(modulePath);
+			if (!pdbReference)
+				return boost::none;
+			auto pdbPath = FindPdb(modulePath, *pdbReference);
+			if (!pdbPath)
+				return boost::none;
+
+			auto hFile = CreateFileW(pdbPath->c_str(),
+			                         GENERIC_READ,
+			                         FILE_SHARE_READ,
+			                         nullptr,
+			                         OPEN_EXISTING,
+			                         FILE_ATTRIBUTE_NORMAL,
+			                         nullptr);
+			if (hFile == INVALID_HANDLE_VALUE)
+				return boost::none;
+
+			auto file = CreateHandle(hFile, CloseHandle);
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file.GetValue(), &fileSize) ||
+			    static_cast<uint64_t>(fileSize.QuadPart) < sizeof(MsfMagic))
+				return boost::none;
+
+			auto fileMapping = CreateHandle(
+			    CreateFileMapping(file.GetValue(), nullptr, PAGE_READONLY, 0, 0, nullptr),
+			    CloseHandle);
+			auto view = CreateHandle(
+			    MapViewOfFile(fileMapping.GetValue(), FILE_MAP_READ, 0, 0, 0),
+			    UnmapViewOfFile);
+
+			const auto* data = static_cast<const char*>(view.GetValue());
+			if (std::memcmp(data, MsfMagic, sizeof(MsfMagic)) != 0)
+				return boost::none;
+
+			LOG_DEBUG << L"Read the PDB " << pdbPath->wstring();
+			MsfFile msfFile{data, static_cast<size_t>(fileSize.QuadPart)};
+			return readPdb(msfFile, *pdbReference);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::vector<PdbSourceFile>>
+	NativePdbReader::Read(const std::filesystem::path& modulePath)
+	{
+		return ReadMsfFile(modulePath, ReadPdb);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::vector<std::filesystem::path>>
+	NativePdbReader::ReadFastLinkObjectFiles(const std::filesystem::path& modulePath)
+	{
+		return ReadMsfFile(modulePath, ReadObjectFiles);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::string>
+	NativePdbReader::ReadSourceServerStream(const std::filesystem::path& modulePath)
+	{
+		return ReadMsfFile(modulePath, ReadSourceServer);
+	}
+}
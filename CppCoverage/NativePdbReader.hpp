@@ -0,0 +1,64 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+#include "DebugInformationEnumerator.hpp"
+
+namespace CppCoverage
+{
+	// Read the line tables of a PDB directly from its MSF streams, without
+	// loading DIA: the DBI stream lists the modules and the C13 line and file
+	// checksum subsections of each module stream give the lines.
+	//
+	// Only the source files and the lines are read. A line belongs to the
+	// function (S_GPROC32 or S_LPROC32) whose range contains it.
+	class CPPCOVERAGE_DLL NativePdbReader
+	{
+	public:
+		// boost::none when the PDB cannot be found next to its recorded path
+		// or the module, does not match the module, or uses a format that is
+		// not supported (C11 line table or /DEBUG:FASTLINK for example). DIA
+		// must be used instead.
+		// Throw CppCoverageException when the PDB is corrupted.
+		static boost::optional<std::vector<PdbSourceFile>>
+		Read(const std::filesystem::path& modulePath);
+
+		// The object files of a PDB created with /DEBUG:FASTLINK: its symbols
+		// and lines are read from these object files by DIA and Read returns
+		// boost::none. boost::none for the other PDBs.
+		// Throw CppCoverageException when the PDB is corrupted.
+		static boost::optional<std::vector<std::filesystem::path>>
+		ReadFastLinkObjectFiles(const std::filesystem::path& modulePath);
+
+		// The srcsrv stream written by the source indexing of the PDB, which
+		// tells how to retrieve each source file from version control.
+		// boost::none when the PDB cannot be found or is not source-indexed.
+		// Throw CppCoverageException when the PDB is corrupted.
+		static boost::optional<std::string>
+		ReadSourceServerStream(const std::filesystem::path& modulePath);
+
+	private:
+		NativePdbReader() = delete;
+	};
+}
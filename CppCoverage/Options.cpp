@@ -18,11 +18,15 @@
 #include "Options.hpp"
 #include "CppCoverageException.hpp"
 #include "OptionsExport.hpp"
+#include "Tools/Tool.hpp"
 
 namespace CppCoverage
 {
 	namespace
 	{
+		const size_t DefaultSymbolDownloadCount = 8;
+		const size_t DefaultCoverageJournalSeconds = 5;
+
 		//---------------------------------------------------------------------
 		std::wstring GetLogLevelStr(LogLevel logLevel)
 		{
@@ -34,6 +38,41 @@ namespace CppCoverage
 			}
 			THROW("Invalid Log level.");
 		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetCoverageLevelStr(CoverageLevel coverageLevel)
+		{
+			switch (coverageLevel)
+			{
+			case CoverageLevel::Line: return L"Line";
+			case CoverageLevel::Function: return L"Function";
+			}
+			THROW("Invalid coverage level.");
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetDebugStringModeStr(DebugStringMode debugStringMode)
+		{
+			switch (debugStringMode)
+			{
+			case DebugStringMode::Read: return L"Read";
+			case DebugStringMode::Count: return L"Count";
+			case DebugStringMode::Drop: return L"Drop";
+			}
+			THROW("Invalid debug string mode.");
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetReportCompressionStr(ReportCompression reportCompression)
+		{
+			switch (reportCompression)
+			{
+			case ReportCompression::None: return L"None";
+			case ReportCompression::Zip: return L"Zip";
+			case ReportCompression::Gzip: return L"Gzip";
+			}
+			THROW("Invalid report compression.");
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -49,6 +88,45 @@ namespace CppCoverage
 		, isAggregateByFileModeEnabled_{true}
 		, isContinueAfterCppExceptionModeEnabled_{false}
 		, isOptimizedBuildSupportEnabled_{false}
+		, isInProcessAgentModeEnabled_{false}
+		, isBasicBlockBreakPointsModeEnabled_{false}
+		, isDominatorBreakPointsModeEnabled_{false}
+		, isEagerLineDisarmModeEnabled_{false}
+		, isResultCacheModeEnabled_{false}
+		, isLazyBreakPointsModeEnabled_{false}
+		, isPageGuardBreakPointsModeEnabled_{false}
+		, isBaselineArmingModeEnabled_{false}
+		, isInputCoverageRefilterModeEnabled_{false}
+		, isIncrementalHtmlModeEnabled_{false}
+		, reportCompression_{ReportCompression::None}
+		, coberturaPackageCountByFile_{0}
+		, coverageLevel_{CoverageLevel::Line}
+		, samplingTrapsPerSecond_{0}
+		, adaptiveArmingTrapsPerSecond_{0}
+		, autoDetachSeconds_{0}
+		, attachProcessId_{0}
+		, debugStringMode_{DebugStringMode::Read}
+		, isCoverageRegionMarkersModeEnabled_{false}
+		, isFuzzingModeEnabled_{false}
+		, isIntelPtModeEnabled_{false}
+		, isTrampolinesModeEnabled_{false}
+		, isEtwSamplingModeEnabled_{false}
+		, isDebugHeapModeEnabled_{false}
+		, isAsyncModulesModeEnabled_{false}
+		, jobCount_{0}
+		, threadCount_{0}
+		, isThreadPlacementEnabled_{false}
+		, isOutOfProcessPluginsModeEnabled_{false}
+		, isNativePdbReaderEnabled_{false}
+		, isIdenticalModulesMergeEnabled_{false}
+		, isBinaryCompressionEnabled_{false}
+		, isDeterministicModeEnabled_{false}
+		, symbolDownloadCount_{DefaultSymbolDownloadCount}
+		, moduleTimeBudgetMilliseconds_{0}
+		, memoryBudgetMegabytes_{0}
+		, coverageJournalSeconds_{DefaultCoverageJournalSeconds}
+		, minimumLineRatePercent_{0}
+		, aggregatorRunCount_{0}
 	{
 		if (startInfo)
 			optionalStartInfo_ = *startInfo;
@@ -111,6 +189,30 @@ namespace CppCoverage
 		return isCoverChildrenModeEnabled_;
 	}
 
+	//-------------------------------------------------------------------------
+	void Options::SetAttachProcessId(unsigned int attachProcessId)
+	{
+		attachProcessId_ = attachProcessId;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int Options::GetAttachProcessId() const
+	{
+		return attachProcessId_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetChildPatterns(const Patterns& childPatterns)
+	{
+		childPatterns_ = childPatterns;
+	}
+
+	//-------------------------------------------------------------------------
+	const Patterns* Options::GetChildPatterns() const
+	{
+		return childPatterns_.get_ptr();
+	}
+
 	//-------------------------------------------------------------------------
 	void Options::DisableAggregateByFileMode()
 	{
@@ -220,40 +322,1100 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	std::wostream& operator<<(std::wostream& ostr, const Options& options)
+	void Options::EnableInProcessAgentMode()
 	{
-		if (options.optionalStartInfo_)
-			ostr << *options.optionalStartInfo_ << std::endl;
-		ostr << L"Modules: " << options.modules_ << std::endl;
-		ostr << L"Sources: " << options.sources_ << std::endl;
-		ostr << L"Log Level: " << GetLogLevelStr(options.GetLogLevel()) << std::endl;
-		ostr << L"Cover Children: " << options.isCoverChildrenModeEnabled_ << std::endl;
-		ostr << L"Aggregate by file: " << options.isAggregateByFileModeEnabled_ << std::endl;
-		ostr << L"Continue after C++ exception: " << options.isContinueAfterCppExceptionModeEnabled_ << std::endl;
-		ostr << L"Optimized build support: " << options.isOptimizedBuildSupportEnabled_ << std::endl;
+		isInProcessAgentModeEnabled_ = true;
+	}
 
-		ostr << L"Export: ";
-		for (const auto& optionExport : options.exports_)
-			ostr << optionExport << L" ";
-		ostr << std::endl;
+	//-------------------------------------------------------------------------
+	bool Options::IsInProcessAgentModeEnabled() const
+	{
+		return isInProcessAgentModeEnabled_;
+	}
 
-		ostr << L"Input coverage: ";
-		for (const auto& path : options.inputCoveragePaths_)
-			ostr << path.wstring() << L" ";
-		ostr << std::endl;
+	//-------------------------------------------------------------------------
+	void Options::EnableBasicBlockBreakPointsMode()
+	{
+		isBasicBlockBreakPointsModeEnabled_ = true;
+	}
 
-		ostr << L"Unified diff: ";
-		for (const auto& settings : options.unifiedDiffSettingsCollection_)
-		{
-			ostr << settings.GetUnifiedDiffPath() << L" Root folder: ";
-			ostr << settings.GetRootDiffFolder().get_value_or(L"") << " ";
-		}
-		ostr << std::endl;
+	//-------------------------------------------------------------------------
+	bool Options::IsBasicBlockBreakPointsModeEnabled() const
+	{
+		return isBasicBlockBreakPointsModeEnabled_;
+	}
 
-		ostr << L"Excluded line regular expressions: ";
-		for (const auto& excludedRegex : options.excludedLineRegexes_)
-			ostr << excludedRegex << L" ";
-		ostr << std::endl;
+	//-------------------------------------------------------------------------
+	void Options::EnableDominatorBreakPointsMode()
+	{
+		isDominatorBreakPointsModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsDominatorBreakPointsModeEnabled() const
+	{
+		return isDominatorBreakPointsModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableEagerLineDisarmMode()
+	{
+		isEagerLineDisarmModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsEagerLineDisarmModeEnabled() const
+	{
+		return isEagerLineDisarmModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableLazyBreakPointsMode()
+	{
+		isLazyBreakPointsModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsLazyBreakPointsModeEnabled() const
+	{
+		return isLazyBreakPointsModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnablePageGuardBreakPointsMode()
+	{
+		isPageGuardBreakPointsModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsPageGuardBreakPointsModeEnabled() const
+	{
+		return isPageGuardBreakPointsModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableBaselineArmingMode()
+	{
+		isBaselineArmingModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsBaselineArmingModeEnabled() const
+	{
+		return isBaselineArmingModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableInputCoverageRefilterMode()
+	{
+		isInputCoverageRefilterModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsInputCoverageRefilterModeEnabled() const
+	{
+		return isInputCoverageRefilterModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetInputCoverageDiffSettings(UnifiedDiffSettings&& unifiedDiffSettings)
+	{
+		inputCoverageDiffSettings_ = std::move(unifiedDiffSettings);
+	}
+
+	//-------------------------------------------------------------------------
+	const UnifiedDiffSettings* Options::GetInputCoverageDiffSettings() const
+	{
+		return inputCoverageDiffSettings_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableIncrementalHtmlMode()
+	{
+		isIncrementalHtmlModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsIncrementalHtmlModeEnabled() const
+	{
+		return isIncrementalHtmlModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetReportCompression(ReportCompression reportCompression)
+	{
+		reportCompression_ = reportCompression;
+	}
+
+	//-------------------------------------------------------------------------
+	ReportCompression Options::GetReportCompression() const
+	{
+		return reportCompression_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetHtmlAssetsFolder(const std::filesystem::path& folder)
+	{
+		htmlAssetsFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetHtmlAssetsFolder() const
+	{
+		return htmlAssetsFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetHtmlShard(const HtmlShard& shard)
+	{
+		htmlShard_ = shard;
+	}
+
+	//-------------------------------------------------------------------------
+	const HtmlShard* Options::GetHtmlShard() const
+	{
+		return htmlShard_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCoberturaPackageCountByFile(size_t coberturaPackageCountByFile)
+	{
+		coberturaPackageCountByFile_ = coberturaPackageCountByFile;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetCoberturaPackageCountByFile() const
+	{
+		return coberturaPackageCountByFile_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCoverageLevel(CoverageLevel coverageLevel)
+	{
+		coverageLevel_ = coverageLevel;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageLevel Options::GetCoverageLevel() const
+	{
+		return coverageLevel_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetSamplingTrapsPerSecond(size_t samplingTrapsPerSecond)
+	{
+		samplingTrapsPerSecond_ = samplingTrapsPerSecond;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetSamplingTrapsPerSecond() const
+	{
+		return samplingTrapsPerSecond_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetAdaptiveArmingTrapsPerSecond(size_t adaptiveArmingTrapsPerSecond)
+	{
+		adaptiveArmingTrapsPerSecond_ = adaptiveArmingTrapsPerSecond;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetAdaptiveArmingTrapsPerSecond() const
+	{
+		return adaptiveArmingTrapsPerSecond_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetAutoDetachSeconds(size_t autoDetachSeconds)
+	{
+		autoDetachSeconds_ = autoDetachSeconds;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetAutoDetachSeconds() const
+	{
+		return autoDetachSeconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableCoverageRegionMarkersMode()
+	{
+		isCoverageRegionMarkersModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsCoverageRegionMarkersModeEnabled() const
+	{
+		return isCoverageRegionMarkersModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableFuzzingMode()
+	{
+		isFuzzingModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsFuzzingModeEnabled() const
+	{
+		return isFuzzingModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableIntelPtMode()
+	{
+		isIntelPtModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsIntelPtModeEnabled() const
+	{
+		return isIntelPtModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableTrampolinesMode()
+	{
+		isTrampolinesModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsTrampolinesModeEnabled() const
+	{
+		return isTrampolinesModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableEtwSamplingMode()
+	{
+		isEtwSamplingModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsEtwSamplingModeEnabled() const
+	{
+		return isEtwSamplingModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetDebugStringMode(DebugStringMode debugStringMode)
+	{
+		debugStringMode_ = debugStringMode;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugStringMode Options::GetDebugStringMode() const
+	{
+		return debugStringMode_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetDebugStringsPath(const std::filesystem::path& path)
+	{
+		debugStringsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetDebugStringsPath() const
+	{
+		return debugStringsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetRecordDebugEventsPath(const std::filesystem::path& path)
+	{
+		recordDebugEventsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetRecordDebugEventsPath() const
+	{
+		return recordDebugEventsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetReplayDebugEventsPath(const std::filesystem::path& path)
+	{
+		replayDebugEventsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetReplayDebugEventsPath() const
+	{
+		return replayDebugEventsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetPerfStatsPath(const std::filesystem::path& path)
+	{
+		perfStatsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetPerfStatsPath() const
+	{
+		return perfStatsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetTraceOutputPath(const std::filesystem::path& path)
+	{
+		traceOutputPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetTraceOutputPath() const
+	{
+		return traceOutputPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetLiveCountersName(const std::string& name)
+	{
+		liveCountersName_ = name;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetLiveCountersName() const
+	{
+		return liveCountersName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetWatchName(const std::string& name)
+	{
+		watchName_ = name;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetWatchName() const
+	{
+		return watchName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetMeasureOverheadRunCount(unsigned int runCount)
+	{
+		measureOverheadRunCount_ = runCount;
+	}
+
+	//-------------------------------------------------------------------------
+	const unsigned int* Options::GetMeasureOverheadRunCount() const
+	{
+		return measureOverheadRunCount_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetTestImpactIndexPath(const std::filesystem::path& path)
+	{
+		testImpactIndexPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetTestImpactIndexPath() const
+	{
+		return testImpactIndexPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetSelectTestsIndexPath(const std::filesystem::path& path)
+	{
+		selectTestsIndexPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetSelectTestsIndexPath() const
+	{
+		return selectTestsIndexPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCompareCoverageOutputPath(const std::filesystem::path& path)
+	{
+		compareCoverageOutputPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetCompareCoverageOutputPath() const
+	{
+		return compareCoverageOutputPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableDebugHeapMode()
+	{
+		isDebugHeapModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsDebugHeapModeEnabled() const
+	{
+		return isDebugHeapModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableAsyncModulesMode()
+	{
+		isAsyncModulesModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsAsyncModulesModeEnabled() const
+	{
+		return isAsyncModulesModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddProgram(const StartInfo& startInfo)
+	{
+		programs_.push_back(startInfo);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<StartInfo>& Options::GetPrograms() const
+	{
+		return programs_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetJobCount(size_t jobCount)
+	{
+		jobCount_ = jobCount;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetJobCount() const
+	{
+		return jobCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetThreadCount(size_t threadCount)
+	{
+		threadCount_ = threadCount;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetThreadCount() const
+	{
+		return threadCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableThreadPlacement()
+	{
+		isThreadPlacementEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsThreadPlacementEnabled() const
+	{
+		return isThreadPlacementEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetServiceName(const std::string& name)
+	{
+		serviceName_ = name;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetServiceName() const
+	{
+		return serviceName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetUsedServiceName(const std::string& name)
+	{
+		usedServiceName_ = name;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetUsedServiceName() const
+	{
+		return usedServiceName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetQueryServiceName(const std::string& name)
+	{
+		queryServiceName_ = name;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetQueryServiceName() const
+	{
+		return queryServiceName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableOutOfProcessPluginsMode()
+	{
+		isOutOfProcessPluginsModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsOutOfProcessPluginsModeEnabled() const
+	{
+		return isOutOfProcessPluginsModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetExportPluginHostSectionName(const std::wstring& sectionName)
+	{
+		exportPluginHostSectionName_ = sectionName;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring* Options::GetExportPluginHostSectionName() const
+	{
+		return exportPluginHostSectionName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetLineTablePath(const std::filesystem::path& path)
+	{
+		lineTablePath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetLineTablePath() const
+	{
+		return lineTablePath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetInstrumentedImagePath(const std::filesystem::path& path)
+	{
+		instrumentedImagePath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetInstrumentedImagePath() const
+	{
+		return instrumentedImagePath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddInputLineCountersPaths(const LineCountersPaths& paths)
+	{
+		inputLineCountersPaths_.push_back(paths);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<Options::LineCountersPaths>& Options::GetInputLineCountersPaths() const
+	{
+		return inputLineCountersPaths_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddInputSancovPaths(const SancovPaths& paths)
+	{
+		inputSancovPaths_.push_back(paths);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<Options::SancovPaths>& Options::GetInputSancovPaths() const
+	{
+		return inputSancovPaths_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCacheFolder(const std::filesystem::path& folder, uintmax_t maxSize)
+	{
+		cacheFolder_ = folder;
+		cacheMaxSize_ = maxSize;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetCacheFolder() const
+	{
+		return cacheFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	uintmax_t Options::GetCacheMaxSize() const
+	{
+		return cacheMaxSize_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableResultCacheMode()
+	{
+		isResultCacheModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsResultCacheModeEnabled() const
+	{
+		return isResultCacheModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddResultCacheInput(const std::filesystem::path& path)
+	{
+		resultCacheInputs_.push_back(path);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::filesystem::path>& Options::GetResultCacheInputs() const
+	{
+		return resultCacheInputs_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetPdbCacheFolder(const std::filesystem::path& folder)
+	{
+		pdbCacheFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetPdbCacheFolder() const
+	{
+		return pdbCacheFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetPdbCacheRemoteStore(const std::wstring& remoteStore)
+	{
+		pdbCacheRemoteStore_ = remoteStore;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring* Options::GetPdbCacheRemoteStore() const
+	{
+		return pdbCacheRemoteStore_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetIndexedPdbsFolder(const std::filesystem::path& folder)
+	{
+		indexedPdbsFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetIndexedPdbsFolder() const
+	{
+		return indexedPdbsFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableNativePdbReader()
+	{
+		isNativePdbReaderEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsNativePdbReaderEnabled() const
+	{
+		return isNativePdbReaderEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableIdenticalModulesMerge()
+	{
+		isIdenticalModulesMergeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsIdenticalModulesMergeEnabled() const
+	{
+		return isIdenticalModulesMergeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddSymbolServer(const std::wstring& symbolServer)
+	{
+		symbolServers_.push_back(symbolServer);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::wstring>& Options::GetSymbolServers() const
+	{
+		return symbolServers_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetSymbolCacheFolder(const std::filesystem::path& folder)
+	{
+		symbolCacheFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetSymbolCacheFolder() const
+	{
+		return symbolCacheFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetSymbolDownloadCount(size_t symbolDownloadCount)
+	{
+		symbolDownloadCount_ = symbolDownloadCount;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetSymbolDownloadCount() const
+	{
+		return symbolDownloadCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetMachineSymbolLoadCount(unsigned int machineSymbolLoadCount)
+	{
+		machineSymbolLoadCount_ = machineSymbolLoadCount;
+	}
+
+	//-------------------------------------------------------------------------
+	const unsigned int* Options::GetMachineSymbolLoadCount() const
+	{
+		return machineSymbolLoadCount_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetSourceServerCacheFolder(const std::filesystem::path& folder)
+	{
+		sourceServerCacheFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetSourceServerCacheFolder() const
+	{
+		return sourceServerCacheFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::AddSourceServerCommand(const std::wstring& program)
+	{
+		sourceServerCommands_.push_back(program);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::wstring>& Options::GetSourceServerCommands() const
+	{
+		return sourceServerCommands_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetModuleTimeBudgetMilliseconds(size_t moduleTimeBudgetMilliseconds)
+	{
+		moduleTimeBudgetMilliseconds_ = moduleTimeBudgetMilliseconds;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetModuleTimeBudgetMilliseconds() const
+	{
+		return moduleTimeBudgetMilliseconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetMemoryBudgetMegabytes(size_t memoryBudgetMegabytes)
+	{
+		memoryBudgetMegabytes_ = memoryBudgetMegabytes;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetMemoryBudgetMegabytes() const
+	{
+		return memoryBudgetMegabytes_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetExclusionMarkers(const FileFilter::ExclusionMarkers& exclusionMarkers)
+	{
+		exclusionMarkers_ = exclusionMarkers;
+	}
+
+	//-------------------------------------------------------------------------
+	const FileFilter::ExclusionMarkers& Options::GetExclusionMarkers() const
+	{
+		return exclusionMarkers_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetBinaryBaselinePath(const std::filesystem::path& path)
+	{
+		binaryBaselinePath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetBinaryBaselinePath() const
+	{
+		return binaryBaselinePath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetBinaryLineTablesFolder(const std::filesystem::path& folder)
+	{
+		binaryLineTablesFolder_ = folder;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetBinaryLineTablesFolder() const
+	{
+		return binaryLineTablesFolder_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableBinaryCompression()
+	{
+		isBinaryCompressionEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsBinaryCompressionEnabled() const
+	{
+		return isBinaryCompressionEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::EnableDeterministicMode()
+	{
+		isDeterministicModeEnabled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool Options::IsDeterministicModeEnabled() const
+	{
+		return isDeterministicModeEnabled_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCoverageJournalPath(const std::filesystem::path& path)
+	{
+		coverageJournalPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* Options::GetCoverageJournalPath() const
+	{
+		return coverageJournalPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetCoverageJournalSeconds(size_t coverageJournalSeconds)
+	{
+		coverageJournalSeconds_ = coverageJournalSeconds;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetCoverageJournalSeconds() const
+	{
+		return coverageJournalSeconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetMinimumLineRatePercent(size_t minimumLineRatePercent)
+	{
+		minimumLineRatePercent_ = minimumLineRatePercent;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetMinimumLineRatePercent() const
+	{
+		return minimumLineRatePercent_;
+	}
+
+	//-------------------------------------------------------------------------
+	void Options::SetAggregator(const std::string& aggregatorName, size_t aggregatorRunCount)
+	{
+		aggregatorName_ = aggregatorName;
+		aggregatorRunCount_ = aggregatorRunCount;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* Options::GetAggregatorName() const
+	{
+		return aggregatorName_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t Options::GetAggregatorRunCount() const
+	{
+		return aggregatorRunCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wostream& operator<<(std::wostream& ostr, const Options& options)
+	{
+		if (options.optionalStartInfo_)
+			ostr << *options.optionalStartInfo_ << std::endl;
+		ostr << L"Modules: " << options.modules_ << std::endl;
+		ostr << L"Sources: " << options.sources_ << std::endl;
+		if (options.childPatterns_)
+			ostr << L"Children: " << *options.childPatterns_ << std::endl;
+		ostr << L"Log Level: " << GetLogLevelStr(options.GetLogLevel()) << std::endl;
+		ostr << L"Cover Children: " << options.isCoverChildrenModeEnabled_ << std::endl;
+		ostr << L"Aggregate by file: " << options.isAggregateByFileModeEnabled_ << std::endl;
+		ostr << L"Continue after C++ exception: " << options.isContinueAfterCppExceptionModeEnabled_ << std::endl;
+		ostr << L"Optimized build support: " << options.isOptimizedBuildSupportEnabled_ << std::endl;
+		ostr << L"In-process agent: " << options.isInProcessAgentModeEnabled_ << std::endl;
+		ostr << L"Basic block breakpoints: " << options.isBasicBlockBreakPointsModeEnabled_ << std::endl;
+		ostr << L"Dominator breakpoints: " << options.isDominatorBreakPointsModeEnabled_ << std::endl;
+		ostr << L"Eager line disarm: " << options.isEagerLineDisarmModeEnabled_ << std::endl;
+		ostr << L"Lazy breakpoints: " << options.isLazyBreakPointsModeEnabled_ << std::endl;
+		ostr << L"Page guard breakpoints: " << options.isPageGuardBreakPointsModeEnabled_ << std::endl;
+		ostr << L"Baseline arming: " << options.isBaselineArmingModeEnabled_ << std::endl;
+		ostr << L"Refilter input coverage: " << options.isInputCoverageRefilterModeEnabled_ << std::endl;
+		if (options.inputCoverageDiffSettings_)
+			ostr << L"Input coverage diff: " << options.inputCoverageDiffSettings_->GetUnifiedDiffPath().wstring() << std::endl;
+		ostr << L"Incremental HTML: " << options.isIncrementalHtmlModeEnabled_ << std::endl;
+		ostr << L"Report compression: " << GetReportCompressionStr(options.reportCompression_) << std::endl;
+		if (options.htmlAssetsFolder_)
+			ostr << L"HTML assets folder: " << options.htmlAssetsFolder_->wstring() << std::endl;
+		if (options.htmlShard_)
+		{
+			if (options.htmlShard_->IsIndex())
+				ostr << L"HTML shard: index" << std::endl;
+			else
+				ostr << L"HTML shard: " << options.htmlShard_->index_ << L'/' << options.htmlShard_->count_ << std::endl;
+		}
+		if (options.coberturaPackageCountByFile_)
+			ostr << L"Cobertura packages by file: " << options.coberturaPackageCountByFile_ << std::endl;
+		ostr << L"Coverage level: " << GetCoverageLevelStr(options.coverageLevel_) << std::endl;
+		ostr << L"Sampling traps per second: " << options.samplingTrapsPerSecond_ << std::endl;
+		if (options.adaptiveArmingTrapsPerSecond_)
+			ostr << L"Adaptive arming traps per second: " << options.adaptiveArmingTrapsPerSecond_ << std::endl;
+		ostr << L"Coverage region markers: " << options.isCoverageRegionMarkersModeEnabled_ << std::endl;
+		ostr << L"Fuzzing: " << options.isFuzzingModeEnabled_ << std::endl;
+		ostr << L"Intel Processor Trace: " << options.isIntelPtModeEnabled_ << std::endl;
+		ostr << L"Trampolines: " << options.isTrampolinesModeEnabled_ << std::endl;
+		ostr << L"ETW sampling: " << options.isEtwSamplingModeEnabled_ << std::endl;
+		ostr << L"Auto detach seconds: " << options.autoDetachSeconds_ << std::endl;
+		if (options.attachProcessId_)
+			ostr << L"Attach process id: " << options.attachProcessId_ << std::endl;
+		ostr << L"Debug strings: " << GetDebugStringModeStr(options.debugStringMode_) << std::endl;
+		if (options.debugStringsPath_)
+			ostr << L"Debug strings file: " << options.debugStringsPath_->wstring() << std::endl;
+		if (options.recordDebugEventsPath_)
+			ostr << L"Record debug events: " << options.recordDebugEventsPath_->wstring() << std::endl;
+		if (options.replayDebugEventsPath_)
+			ostr << L"Replay debug events: " << options.replayDebugEventsPath_->wstring() << std::endl;
+		if (options.perfStatsPath_)
+			ostr << L"Performance statistics file: " << options.perfStatsPath_->wstring() << std::endl;
+		if (options.traceOutputPath_)
+			ostr << L"Trace file: " << options.traceOutputPath_->wstring() << std::endl;
+		if (options.liveCountersName_)
+			ostr << L"Live counters: " << Tools::LocalToWString(*options.liveCountersName_) << std::endl;
+		if (options.watchName_)
+			ostr << L"Watch: " << Tools::LocalToWString(*options.watchName_) << std::endl;
+		if (options.measureOverheadRunCount_)
+			ostr << L"Measure overhead runs: " << *options.measureOverheadRunCount_ << std::endl;
+		if (options.testImpactIndexPath_)
+			ostr << L"Test impact index: " << options.testImpactIndexPath_->wstring() << std::endl;
+		if (options.selectTestsIndexPath_)
+			ostr << L"Select tests: " << options.selectTestsIndexPath_->wstring() << std::endl;
+		if (options.compareCoverageOutputPath_)
+			ostr << L"Compare coverage: " << options.compareCoverageOutputPath_->wstring() << std::endl;
+		ostr << L"Debug heap: " << options.isDebugHeapModeEnabled_ << std::endl;
+		ostr << L"Async modules: " << options.isAsyncModulesModeEnabled_ << std::endl;
+		for (const auto& program : options.programs_)
+			ostr << L"Program: " << program.GetPath().wstring() << std::endl;
+		if (!options.programs_.empty())
+			ostr << L"Jobs: " << options.jobCount_ << std::endl;
+		if (options.threadCount_)
+			ostr << L"Threads: " << options.threadCount_ << std::endl;
+		ostr << L"Thread placement: " << options.isThreadPlacementEnabled_ << std::endl;
+		if (options.serviceName_)
+			ostr << L"Service: " << Tools::LocalToWString(*options.serviceName_) << std::endl;
+		if (options.usedServiceName_)
+			ostr << L"Use service: " << Tools::LocalToWString(*options.usedServiceName_) << std::endl;
+		if (options.queryServiceName_)
+			ostr << L"Query service: " << Tools::LocalToWString(*options.queryServiceName_) << std::endl;
+		ostr << L"Out of process plugins: " << options.isOutOfProcessPluginsModeEnabled_ << std::endl;
+		if (options.exportPluginHostSectionName_)
+			ostr << L"Export plugin host: " << *options.exportPluginHostSectionName_ << std::endl;
+		if (options.lineTablePath_)
+			ostr << L"Line table: " << options.lineTablePath_->wstring() << std::endl;
+		if (options.instrumentedImagePath_)
+			ostr << L"Instrumented image: " << options.instrumentedImagePath_->wstring() << std::endl;
+		for (const auto& paths : options.inputLineCountersPaths_)
+			ostr << L"Input line counters: " << paths.first.wstring() << L" " << paths.second.wstring() << std::endl;
+		for (const auto& paths : options.inputSancovPaths_)
+			ostr << L"Input sancov: " << paths.first.wstring() << L" " << paths.second.wstring() << std::endl;
+		if (options.cacheFolder_)
+		{
+			ostr << L"Cache: " << options.cacheFolder_->wstring() << L" up to "
+			     << options.cacheMaxSize_ / (1024 * 1024) << L" MB" << std::endl;
+		}
+		ostr << L"Result cache: " << options.isResultCacheModeEnabled_ << std::endl;
+		for (const auto& path : options.resultCacheInputs_)
+			ostr << L"Result cache input: " << path.wstring() << std::endl;
+		if (options.pdbCacheFolder_)
+			ostr << L"PDB cache: " << options.pdbCacheFolder_->wstring() << std::endl;
+		if (options.pdbCacheRemoteStore_)
+			ostr << L"PDB cache remote store: " << *options.pdbCacheRemoteStore_ << std::endl;
+		if (options.indexedPdbsFolder_)
+			ostr << L"Index PDBs: " << options.indexedPdbsFolder_->wstring() << std::endl;
+		ostr << L"Native PDB reader: " << options.isNativePdbReaderEnabled_ << std::endl;
+		ostr << L"Merge identical modules: " << options.isIdenticalModulesMergeEnabled_ << std::endl;
+		for (const auto& symbolServer : options.symbolServers_)
+			ostr << L"Symbol server: " << symbolServer << std::endl;
+		if (options.symbolCacheFolder_)
+		{
+			ostr << L"Symbol cache: " << options.symbolCacheFolder_->wstring() << std::endl;
+			ostr << L"Symbol downloads: " << options.symbolDownloadCount_ << std::endl;
+		}
+		if (options.machineSymbolLoadCount_)
+			ostr << L"Machine symbol loads: " << *options.machineSymbolLoadCount_ << std::endl;
+		if (options.sourceServerCacheFolder_)
+			ostr << L"Source server cache: " << options.sourceServerCacheFolder_->wstring() << std::endl;
+		for (const auto& program : options.sourceServerCommands_)
+			ostr << L"Source server command: " << program << std::endl;
+		if (options.moduleTimeBudgetMilliseconds_)
+			ostr << L"Module time budget: " << options.moduleTimeBudgetMilliseconds_ << L" ms" << std::endl;
+		if (options.memoryBudgetMegabytes_)
+			ostr << L"Memory budget: " << options.memoryBudgetMegabytes_ << L" MB" << std::endl;
+		if (options.binaryBaselinePath_)
+			ostr << L"Binary baseline: " << options.binaryBaselinePath_->wstring() << std::endl;
+		if (options.binaryLineTablesFolder_)
+			ostr << L"Binary line tables: " << options.binaryLineTablesFolder_->wstring() << std::endl;
+		ostr << L"Binary compression: " << options.isBinaryCompressionEnabled_ << std::endl;
+		ostr << L"Deterministic mode: " << options.isDeterministicModeEnabled_ << std::endl;
+		if (options.coverageJournalPath_)
+		{
+			ostr << L"Coverage journal: " << options.coverageJournalPath_->wstring()
+			     << L" every " << options.coverageJournalSeconds_ << L" s" << std::endl;
+		}
+		if (options.minimumLineRatePercent_)
+			ostr << L"Fail under: " << options.minimumLineRatePercent_ << L"%" << std::endl;
+		if (options.aggregatorName_)
+		{
+			ostr << L"Aggregator: " << Tools::LocalToWString(*options.aggregatorName_)
+			     << L" for " << options.aggregatorRunCount_ << L" runs" << std::endl;
+		}
+
+		ostr << L"Export: ";
+		for (const auto& optionExport : options.exports_)
+			ostr << optionExport << L" ";
+		ostr << std::endl;
+
+		ostr << L"Input coverage: ";
+		for (const auto& path : options.inputCoveragePaths_)
+			ostr << path.wstring() << L" ";
+		ostr << std::endl;
+
+		ostr << L"Unified diff: ";
+		for (const auto& settings : options.unifiedDiffSettingsCollection_)
+		{
+			ostr << settings.GetUnifiedDiffPath() << L" Root folder: ";
+			ostr << settings.GetRootDiffFolder().get_value_or(L"") << " ";
+		}
+		ostr << std::endl;
+
+		ostr << L"Excluded line regular expressions: ";
+		for (const auto& excludedRegex : options.excludedLineRegexes_)
+			ostr << excludedRegex << L" ";
+		ostr << std::endl;
+
+		const auto& exclusionMarkers = options.exclusionMarkers_;
+		if (!exclusionMarkers.GetLineMarker().empty())
+			ostr << L"Excluded line marker: " << Tools::LocalToWString(exclusionMarkers.GetLineMarker()) << std::endl;
+		if (!exclusionMarkers.GetRegionStartMarker().empty())
+		{
+			ostr << L"Excluded region markers: " << Tools::LocalToWString(exclusionMarkers.GetRegionStartMarker())
+				<< L" " << Tools::LocalToWString(exclusionMarkers.GetRegionStopMarker()) << std::endl;
+		}
 
 		ostr << L"Substitute pdb source paths: ";
 		for (const auto& substitutePdbSourcePath : options.substitutePdbSourcePaths_)
@@ -25,6 +25,11 @@
 #include "UnifiedDiffSettings.hpp"
 #include "SubstitutePdbSourcePath.hpp"
 #include "OptionsExport.hpp"
+#include "CoverageLevel.hpp"
+#include "DebugStringMode.hpp"
+#include "ReportCompression.hpp"
+#include "HtmlShard.hpp"
+#include "FileFilter/ExclusionMarkers.hpp"
 
 namespace CppCoverage
 {
@@ -61,6 +66,14 @@ namespace CppCoverage
 		void EnableCoverChildrenMode();
 		bool IsCoverChildrenModeEnabled() const;
 
+		// 0 when the program is started by OpenCppCoverage.
+		void SetAttachProcessId(unsigned int);
+		unsigned int GetAttachProcessId() const;
+
+		// nullptr when all children processes are covered.
+		void SetChildPatterns(const Patterns&);
+		const Patterns* GetChildPatterns() const;
+
         void EnableStopOnAssertMode();
         bool IsStopOnAssertModeEnabled() const;
 
@@ -88,6 +101,269 @@ namespace CppCoverage
 		void AddSubstitutePdbSourcePath(SubstitutePdbSourcePath&&);
 		const std::vector<SubstitutePdbSourcePath>& GetSubstitutePdbSourcePaths() const;
 
+		void EnableInProcessAgentMode();
+		bool IsInProcessAgentModeEnabled() const;
+
+		void EnableBasicBlockBreakPointsMode();
+		bool IsBasicBlockBreakPointsModeEnabled() const;
+
+		void EnableDominatorBreakPointsMode();
+		bool IsDominatorBreakPointsModeEnabled() const;
+
+		void EnableEagerLineDisarmMode();
+		bool IsEagerLineDisarmModeEnabled() const;
+
+		void EnableLazyBreakPointsMode();
+		bool IsLazyBreakPointsModeEnabled() const;
+
+		void EnablePageGuardBreakPointsMode();
+		bool IsPageGuardBreakPointsModeEnabled() const;
+
+		void EnableBaselineArmingMode();
+		bool IsBaselineArmingModeEnabled() const;
+
+		// The input coverage files are filtered again on load.
+		void EnableInputCoverageRefilterMode();
+		bool IsInputCoverageRefilterModeEnabled() const;
+
+		// The lines of the input coverage files are moved through this diff
+		// on load. nullptr when not set.
+		void SetInputCoverageDiffSettings(UnifiedDiffSettings&&);
+		const UnifiedDiffSettings* GetInputCoverageDiffSettings() const;
+
+		// Only the pages which changed are written in the HTML report folder.
+		void EnableIncrementalHtmlMode();
+		bool IsIncrementalHtmlModeEnabled() const;
+
+		void SetReportCompression(ReportCompression);
+		ReportCompression GetReportCompression() const;
+
+		// The HTML reports link the third-party assets of this folder.
+		void SetHtmlAssetsFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetHtmlAssetsFolder() const;
+
+		// Only the pages of this shard are written in the HTML report folder.
+		void SetHtmlShard(const HtmlShard&);
+		const HtmlShard* GetHtmlShard() const;
+
+		// 0 when the cobertura report is written in a single file.
+		void SetCoberturaPackageCountByFile(size_t);
+		size_t GetCoberturaPackageCountByFile() const;
+
+		void SetCoverageLevel(CoverageLevel);
+		CoverageLevel GetCoverageLevel() const;
+
+		// 0 when the sampling is disabled.
+		void SetSamplingTrapsPerSecond(size_t);
+		size_t GetSamplingTrapsPerSecond() const;
+
+		// 0 when the adaptive arming is disabled.
+		void SetAdaptiveArmingTrapsPerSecond(size_t);
+		size_t GetAdaptiveArmingTrapsPerSecond() const;
+
+		void EnableCoverageRegionMarkersMode();
+		bool IsCoverageRegionMarkersModeEnabled() const;
+
+		void EnableFuzzingMode();
+		bool IsFuzzingModeEnabled() const;
+
+		void EnableIntelPtMode();
+		bool IsIntelPtModeEnabled() const;
+
+		void EnableTrampolinesMode();
+		bool IsTrampolinesModeEnabled() const;
+
+		void EnableEtwSamplingMode();
+		bool IsEtwSamplingModeEnabled() const;
+
+		// 0 when the processes are never detached.
+		void SetAutoDetachSeconds(size_t);
+		size_t GetAutoDetachSeconds() const;
+
+		void SetDebugStringMode(DebugStringMode);
+		DebugStringMode GetDebugStringMode() const;
+
+		void SetDebugStringsPath(const std::filesystem::path&);
+		const std::filesystem::path* GetDebugStringsPath() const;
+
+		void SetRecordDebugEventsPath(const std::filesystem::path&);
+		const std::filesystem::path* GetRecordDebugEventsPath() const;
+
+		void SetReplayDebugEventsPath(const std::filesystem::path&);
+		const std::filesystem::path* GetReplayDebugEventsPath() const;
+
+		void SetPerfStatsPath(const std::filesystem::path&);
+		const std::filesystem::path* GetPerfStatsPath() const;
+
+		void SetTraceOutputPath(const std::filesystem::path&);
+		const std::filesystem::path* GetTraceOutputPath() const;
+
+		// Name of the live counters published by the run.
+		void SetLiveCountersName(const std::string&);
+		const std::string* GetLiveCountersName() const;
+
+		// Display the live counters of this name instead of running a program.
+		void SetWatchName(const std::string&);
+		const std::string* GetWatchName() const;
+
+		// Runs of the program in each mode of --measure_overhead.
+		void SetMeasureOverheadRunCount(unsigned int);
+		const unsigned int* GetMeasureOverheadRunCount() const;
+
+		void SetTestImpactIndexPath(const std::filesystem::path&);
+		const std::filesystem::path* GetTestImpactIndexPath() const;
+
+		void SetSelectTestsIndexPath(const std::filesystem::path&);
+		const std::filesystem::path* GetSelectTestsIndexPath() const;
+
+		void SetCompareCoverageOutputPath(const std::filesystem::path&);
+		const std::filesystem::path* GetCompareCoverageOutputPath() const;
+
+		void EnableDebugHeapMode();
+		bool IsDebugHeapModeEnabled() const;
+
+		void EnableAsyncModulesMode();
+		bool IsAsyncModulesModeEnabled() const;
+
+		// Programs covered in parallel instead of the start info.
+		void AddProgram(const StartInfo&);
+		const std::vector<StartInfo>& GetPrograms() const;
+
+		// 0 when the number of logical processors is used.
+		void SetJobCount(size_t);
+		size_t GetJobCount() const;
+
+		// Threads of the parallel work: debug information, filters, merges
+		// and exports. 0 when the number of logical processors is used.
+		void SetThreadCount(size_t);
+		size_t GetThreadCount() const;
+
+		// The debug loop and the threads of the parallel work run on
+		// separate physical cores.
+		void EnableThreadPlacement();
+		bool IsThreadPlacementEnabled() const;
+
+		void SetServiceName(const std::string&);
+		const std::string* GetServiceName() const;
+
+		void SetUsedServiceName(const std::string&);
+		const std::string* GetUsedServiceName() const;
+
+		void SetQueryServiceName(const std::string&);
+		const std::string* GetQueryServiceName() const;
+
+		void EnableOutOfProcessPluginsMode();
+		bool IsOutOfProcessPluginsModeEnabled() const;
+
+		void SetExportPluginHostSectionName(const std::wstring&);
+		const std::wstring* GetExportPluginHostSectionName() const;
+
+		void SetLineTablePath(const std::filesystem::path&);
+		const std::filesystem::path* GetLineTablePath() const;
+
+		// Where the program instrumented with the counters of the line table
+		// is written.
+		void SetInstrumentedImagePath(const std::filesystem::path&);
+		const std::filesystem::path* GetInstrumentedImagePath() const;
+
+		// The line table and the counters of an instrumented program.
+		using LineCountersPaths = std::pair<std::filesystem::path, std::filesystem::path>;
+		void AddInputLineCountersPaths(const LineCountersPaths&);
+		const std::vector<LineCountersPaths>& GetInputLineCountersPaths() const;
+
+		// A module and the .sancov file of its covered PCs.
+		using SancovPaths = std::pair<std::filesystem::path, std::filesystem::path>;
+		void AddInputSancovPaths(const SancovPaths&);
+		const std::vector<SancovPaths>& GetInputSancovPaths() const;
+
+		// Maximum size in bytes of the folder.
+		void SetCacheFolder(const std::filesystem::path&, uintmax_t maxSize);
+		const std::filesystem::path* GetCacheFolder() const;
+		uintmax_t GetCacheMaxSize() const;
+
+		void EnableResultCacheMode();
+		bool IsResultCacheModeEnabled() const;
+
+		// Files whose content is part of the key of the cached coverage.
+		void AddResultCacheInput(const std::filesystem::path&);
+		const std::vector<std::filesystem::path>& GetResultCacheInputs() const;
+
+		void SetPdbCacheFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetPdbCacheFolder() const;
+
+		void SetPdbCacheRemoteStore(const std::wstring&);
+		const std::wstring* GetPdbCacheRemoteStore() const;
+
+		void SetIndexedPdbsFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetIndexedPdbsFolder() const;
+
+		void EnableNativePdbReader();
+		bool IsNativePdbReaderEnabled() const;
+
+		void EnableIdenticalModulesMerge();
+		bool IsIdenticalModulesMergeEnabled() const;
+
+		void AddSymbolServer(const std::wstring&);
+		const std::vector<std::wstring>& GetSymbolServers() const;
+
+		void SetSymbolCacheFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetSymbolCacheFolder() const;
+
+		void SetSymbolDownloadCount(size_t);
+		size_t GetSymbolDownloadCount() const;
+
+		void SetMachineSymbolLoadCount(unsigned int);
+		const unsigned int* GetMachineSymbolLoadCount() const;
+
+		void SetSourceServerCacheFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetSourceServerCacheFolder() const;
+
+		void AddSourceServerCommand(const std::wstring&);
+		const std::vector<std::wstring>& GetSourceServerCommands() const;
+
+		// 0 when the program waits for the debug information of each module.
+		void SetModuleTimeBudgetMilliseconds(size_t);
+		size_t GetModuleTimeBudgetMilliseconds() const;
+
+		// 0 when the lines of the modules are always in memory.
+		void SetMemoryBudgetMegabytes(size_t);
+		size_t GetMemoryBudgetMegabytes() const;
+
+		void SetExclusionMarkers(const FileFilter::ExclusionMarkers&);
+		const FileFilter::ExclusionMarkers& GetExclusionMarkers() const;
+
+		// The binary exports are written as a delta relative to this file.
+		void SetBinaryBaselinePath(const std::filesystem::path&);
+		const std::filesystem::path* GetBinaryBaselinePath() const;
+		// The binary exports hold only the executed lines and the lines are
+		// written once by build in this folder.
+		void SetBinaryLineTablesFolder(const std::filesystem::path&);
+		const std::filesystem::path* GetBinaryLineTablesFolder() const;
+		void EnableBinaryCompression();
+		bool IsBinaryCompressionEnabled() const;
+
+		// The same coverage gives the same exports.
+		void EnableDeterministicMode();
+		bool IsDeterministicModeEnabled() const;
+
+		// A snapshot of the coverage is appended to the journal every
+		// coverageJournalSeconds.
+		void SetCoverageJournalPath(const std::filesystem::path&);
+		const std::filesystem::path* GetCoverageJournalPath() const;
+		void SetCoverageJournalSeconds(size_t);
+		size_t GetCoverageJournalSeconds() const;
+
+		// The run fails when the line rate is lower than this percent.
+		// 0 means no minimum.
+		void SetMinimumLineRatePercent(size_t);
+		size_t GetMinimumLineRatePercent() const;
+
+		// The coverage of aggregatorRunCount runs is received on the named
+		// pipe \\.\pipe\<aggregatorName> and merged as it arrives.
+		void SetAggregator(const std::string& aggregatorName, size_t aggregatorRunCount);
+		const std::string* GetAggregatorName() const;
+		size_t GetAggregatorRunCount() const;
+
 		friend CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream&, const Options&);
 
 	private:
@@ -111,5 +387,84 @@ namespace CppCoverage
 		std::vector<UnifiedDiffSettings> unifiedDiffSettingsCollection_;
 		std::vector<std::wstring> excludedLineRegexes_;
 		std::vector<SubstitutePdbSourcePath> substitutePdbSourcePaths_;
+		bool isInProcessAgentModeEnabled_;
+		bool isBasicBlockBreakPointsModeEnabled_;
+		bool isDominatorBreakPointsModeEnabled_;
+		bool isEagerLineDisarmModeEnabled_;
+		bool isLazyBreakPointsModeEnabled_;
+		bool isPageGuardBreakPointsModeEnabled_;
+		bool isBaselineArmingModeEnabled_;
+		bool isInputCoverageRefilterModeEnabled_;
+		boost::optional<UnifiedDiffSettings> inputCoverageDiffSettings_;
+		bool isIncrementalHtmlModeEnabled_;
+		ReportCompression reportCompression_;
+		boost::optional<std::filesystem::path> htmlAssetsFolder_;
+		boost::optional<HtmlShard> htmlShard_;
+		size_t coberturaPackageCountByFile_;
+		CoverageLevel coverageLevel_;
+		size_t samplingTrapsPerSecond_;
+		size_t adaptiveArmingTrapsPerSecond_;
+		bool isCoverageRegionMarkersModeEnabled_;
+		bool isFuzzingModeEnabled_;
+		bool isIntelPtModeEnabled_;
+		bool isTrampolinesModeEnabled_;
+		bool isEtwSamplingModeEnabled_;
+		size_t autoDetachSeconds_;
+		boost::optional<std::filesystem::path> testImpactIndexPath_;
+		boost::optional<std::filesystem::path> selectTestsIndexPath_;
+		boost::optional<std::filesystem::path> compareCoverageOutputPath_;
+		boost::optional<Patterns> childPatterns_;
+		unsigned int attachProcessId_;
+		DebugStringMode debugStringMode_;
+		boost::optional<std::filesystem::path> debugStringsPath_;
+		boost::optional<std::filesystem::path> recordDebugEventsPath_;
+		boost::optional<std::filesystem::path> replayDebugEventsPath_;
+		boost::optional<std::filesystem::path> perfStatsPath_;
+		boost::optional<std::filesystem::path> traceOutputPath_;
+		boost::optional<std::string> liveCountersName_;
+		boost::optional<std::string> watchName_;
+		boost::optional<unsigned int> measureOverheadRunCount_;
+		bool isDebugHeapModeEnabled_;
+		bool isAsyncModulesModeEnabled_;
+		std::vector<StartInfo> programs_;
+		size_t jobCount_;
+		size_t threadCount_;
+		bool isThreadPlacementEnabled_;
+		boost::optional<std::string> serviceName_;
+		boost::optional<std::string> usedServiceName_;
+		boost::optional<std::string> queryServiceName_;
+		bool isOutOfProcessPluginsModeEnabled_;
+		boost::optional<std::wstring> exportPluginHostSectionName_;
+		boost::optional<std::filesystem::path> lineTablePath_;
+		boost::optional<std::filesystem::path> instrumentedImagePath_;
+		std::vector<LineCountersPaths> inputLineCountersPaths_;
+		std::vector<SancovPaths> inputSancovPaths_;
+		boost::optional<std::filesystem::path> cacheFolder_;
+		uintmax_t cacheMaxSize_{0};
+		bool isResultCacheModeEnabled_;
+		std::vector<std::filesystem::path> resultCacheInputs_;
+		boost::optional<std::filesystem::path> pdbCacheFolder_;
+		boost::optional<std::wstring> pdbCacheRemoteStore_;
+		boost::optional<std::filesystem::path> indexedPdbsFolder_;
+		bool isNativePdbReaderEnabled_;
+		bool isIdenticalModulesMergeEnabled_;
+		bool isBinaryCompressionEnabled_;
+		bool isDeterministicModeEnabled_;
+		std::vector<std::wstring> symbolServers_;
+		boost::optional<std::filesystem::path> symbolCacheFolder_;
+		size_t symbolDownloadCount_;
+		boost::optional<unsigned int> machineSymbolLoadCount_;
+		boost::optional<std::filesystem::path> sourceServerCacheFolder_;
+		std::vector<std::wstring> sourceServerCommands_;
+		size_t moduleTimeBudgetMilliseconds_;
+		size_t memoryBudgetMegabytes_;
+		FileFilter::ExclusionMarkers exclusionMarkers_;
+		boost::optional<std::filesystem::path> binaryBaselinePath_;
+		boost::optional<std::filesystem::path> binaryLineTablesFolder_;
+		boost::optional<std::filesystem::path> coverageJournalPath_;
+		size_t coverageJournalSeconds_;
+		size_t minimumLineRatePercent_;
+		boost::optional<std::string> aggregatorName_;
+		size_t aggregatorRunCount_;
 	};
 }
\ No newline at end of file
@@ -27,6 +27,13 @@ namespace CppCoverage
 		Html,
 		Cobertura,
 		Binary,
+		FirstHits,
+		CompactHtml,
+		Summary,
+		Lcov,
+		Aggregator,
+		Parquet,
+		DiffHtml,
 		Plugin
 	};
 
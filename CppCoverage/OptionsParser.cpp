@@ -19,20 +19,25 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include <sstream>
 #include <fstream>
 #include <filesystem>
 
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/program_options/parsers.hpp>
 
 #include "Tools/Tool.hpp"
 #include "CppCoverage/Patterns.hpp"
 
 #include "Options.hpp"
+#include "Process.hpp"
 #include "CppCoverageException.hpp"
 #include "ProgramOptions.hpp"
 #include "OptionsExport.hpp"
+#include "ExportOptionParser.hpp"
 #include "ProgramOptionsVariablesMap.hpp"
 
 #include "Tools/WarningManager.hpp"
@@ -231,20 +236,1408 @@ namespace CppCoverage
 			}
 		}
 
+		//----------------------------------------------------------------------------
+		void AddInputCoverageDiff(const ProgramOptionsVariablesMap& variablesMap,
+		                          Options& options)
+		{
+			const auto* inputCoverageDiff = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::InputCoverageDiffOption);
+
+			if (!inputCoverageDiff)
+				return;
+			if (options.GetInputCoveragePaths().empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::InputCoverageDiffOption + " requires --" +
+				    ProgramOptions::InputCoverageValue + ".");
+			}
+
+			fs::path unifiedDiffPath;
+			boost::optional<fs::path> rootDiffFolder;
+			std::tie(unifiedDiffPath, rootDiffFolder) = ExtractUnifiedDiffOption(*inputCoverageDiff);
+			if (!fs::is_regular_file(unifiedDiffPath))
+			{
+				throw Plugin::OptionsParserException(
+				    "Unified diff path " + unifiedDiffPath.string() + " does not exist.");
+			}
+			if (rootDiffFolder && !is_directory(*rootDiffFolder))
+			{
+				throw Plugin::OptionsParserException(
+				    "Unified diff root folder " + rootDiffFolder->string() + " does not exist.");
+			}
+			options.SetInputCoverageDiffSettings(UnifiedDiffSettings{unifiedDiffPath, rootDiffFolder});
+		}
+
 		//----------------------------------------------------------------------------
 		void
 		AddExcludedLineRegexes(const ProgramOptionsVariablesMap& variablesMap,
 		                       Options& options)
 		{
-			auto excludedLineRegexes =
-			    variablesMap.GetOptionalValue<std::vector<std::string>>(
-			        ProgramOptions::ExcludedLineRegexOption);
-			if (excludedLineRegexes)
+			auto excludedLineRegexes =
+			    variablesMap.GetOptionalValue<std::vector<std::string>>(
+			        ProgramOptions::ExcludedLineRegexOption);
+			if (excludedLineRegexes)
+			{
+				for (const auto& excludedLineRegex : *excludedLineRegexes)
+					options.AddExcludedLineRegex(
+					    Tools::LocalToWString(excludedLineRegex));
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddExclusionMarkers(const ProgramOptionsVariablesMap& variablesMap,
+		                         Options& options)
+		{
+			auto lineMarker = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ExcludedLineMarkerOption);
+			auto regionMarkers = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ExcludedRegionMarkersOption);
+			std::string regionStartMarker;
+			std::string regionStopMarker;
+
+			if (lineMarker && lineMarker->empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ExcludedLineMarkerOption + " cannot be empty.");
+			}
+			if (regionMarkers)
+			{
+				auto pos = regionMarkers->find(OptionsParser::PathSeparator);
+
+				if (pos != std::string::npos)
+				{
+					regionStartMarker = regionMarkers->substr(0, pos);
+					regionStopMarker = regionMarkers->substr(pos + 1);
+				}
+				if (regionStartMarker.empty() || regionStopMarker.empty())
+				{
+					throw Plugin::OptionsParserException(
+					    "Invalid value for --" + ProgramOptions::ExcludedRegionMarkersOption +
+					    ". Format is <start>" + OptionsParser::PathSeparator + "<stop>.");
+				}
+			}
+			if (lineMarker || regionMarkers)
+			{
+				options.SetExclusionMarkers(FileFilter::ExclusionMarkers{
+				    lineMarker ? *lineMarker : std::string{}, regionStartMarker, regionStopMarker});
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoverageLevel(const ProgramOptionsVariablesMap& variablesMap,
+		                      Options& options)
+		{
+			auto coverageLevel = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::CoverageLevelOption);
+
+			if (!coverageLevel ||
+			    *coverageLevel == ProgramOptions::CoverageLevelLineValue)
+				return;
+			if (*coverageLevel != ProgramOptions::CoverageLevelFunctionValue)
+			{
+				throw Plugin::OptionsParserException(
+				    "Invalid value for --" + ProgramOptions::CoverageLevelOption +
+				    ": " + *coverageLevel + ". Expected " +
+				    ProgramOptions::CoverageLevelLineValue + " or " +
+				    ProgramOptions::CoverageLevelFunctionValue + ".");
+			}
+			options.SetCoverageLevel(CoverageLevel::Function);
+		}
+
+		//---------------------------------------------------------------------
+		cov::StartInfo GetAttachedProcessStartInfo(unsigned int processId,
+		                                           bool hasProgramToRun)
+		{
+			if (hasProgramToRun)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::AttachOption +
+				    " cannot be used with a program to execute.");
+			}
+
+			boost::optional<std::filesystem::path> imagePath;
+			if (processId)
+				imagePath = cov::Process::GetImagePath(processId);
+			if (!imagePath)
+			{
+				throw Plugin::OptionsParserException(
+				    "Cannot open the process " + std::to_string(processId) +
+				    " for --" + ProgramOptions::AttachOption + ".");
+			}
+			return cov::StartInfo{*imagePath};
+		}
+
+		//---------------------------------------------------------------------
+		void AddChildPatterns(const ProgramOptionsVariablesMap& variablesMap,
+		                      Options& options)
+		{
+			using T_Strings = std::vector<std::string>;
+			const auto* selectedPatterns = variablesMap.GetOptionalValue<T_Strings>(
+			    ProgramOptions::SelectedChildrenOption);
+			const auto* excludedPatterns = variablesMap.GetOptionalValue<T_Strings>(
+			    ProgramOptions::ExcludedChildrenOption);
+
+			if (!selectedPatterns && !excludedPatterns)
+				return;
+			if (!options.IsCoverChildrenModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SelectedChildrenOption + " and --" +
+				    ProgramOptions::ExcludedChildrenOption + " require --" +
+				    ProgramOptions::CoverChildrenOption + ".");
+			}
+
+			cov::Patterns patterns{false};
+			for (const auto& pattern : selectedPatterns ? *selectedPatterns : T_Strings{"*"})
+			{
+				CheckPattern(ProgramOptions::SelectedChildrenOption, pattern);
+				patterns.AddSelectedPatterns(Tools::LocalToWString(pattern));
+			}
+			if (excludedPatterns)
+			{
+				for (const auto& pattern : *excludedPatterns)
+				{
+					CheckPattern(ProgramOptions::ExcludedChildrenOption, pattern);
+					patterns.AddExcludedPatterns(Tools::LocalToWString(pattern));
+				}
+			}
+			options.SetChildPatterns(patterns);
+		}
+
+		//---------------------------------------------------------------------
+		void AddSamplingTrapsPerSecond(const ProgramOptionsVariablesMap& variablesMap,
+		                               Options& options)
+		{
+			auto trapsPerSecond = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::SamplingTrapsPerSecondOption);
+
+			if (!trapsPerSecond)
+				return;
+			if (!*trapsPerSecond)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SamplingTrapsPerSecondOption +
+				    " must be greater than 0.");
+			}
+			if (options.IsInProcessAgentModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SamplingTrapsPerSecondOption +
+				    " and --" + ProgramOptions::InProcessAgentOption +
+				    " cannot be used at the same time.");
+			}
+			if (options.IsCoverageRegionMarkersModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SamplingTrapsPerSecondOption +
+				    " and --" + ProgramOptions::CoverageRegionMarkersOption +
+				    " cannot be used at the same time.");
+			}
+			options.SetSamplingTrapsPerSecond(*trapsPerSecond);
+		}
+
+		//---------------------------------------------------------------------
+		void AddTestImpactIndex(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			auto path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::TestImpactIndexOption);
+
+			if (!path)
+				return;
+			if (options.IsInProcessAgentModeEnabled() ||
+			    options.IsCoverageRegionMarkersModeEnabled() ||
+			    options.GetSamplingTrapsPerSecond())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::TestImpactIndexOption +
+				    " cannot be used with --" +
+				    ProgramOptions::InProcessAgentOption + ", --" +
+				    ProgramOptions::CoverageRegionMarkersOption + " or --" +
+				    ProgramOptions::SamplingTrapsPerSecondOption + ".");
+			}
+			options.SetTestImpactIndexPath(*path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddReportCompression(const ProgramOptionsVariablesMap& variablesMap,
+		                          Options& options)
+		{
+			const auto* compression = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ReportCompressionOption);
+
+			if (!compression)
+				return;
+			if (*compression == ProgramOptions::ReportCompressionZipValue)
+				options.SetReportCompression(ReportCompression::Zip);
+			else if (*compression == ProgramOptions::ReportCompressionGzipValue)
+				options.SetReportCompression(ReportCompression::Gzip);
+			else
+			{
+				throw Plugin::OptionsParserException(
+				    "Invalid value for --" + ProgramOptions::ReportCompressionOption +
+				    ": " + *compression + ". Expected " +
+				    ProgramOptions::ReportCompressionZipValue + " or " +
+				    ProgramOptions::ReportCompressionGzipValue + ".");
+			}
+			// The pages of a compressed report cannot be updated.
+			if (options.IsIncrementalHtmlModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ReportCompressionOption + " cannot be used with --" +
+				    ProgramOptions::IncrementalHtmlOption + ".");
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddHtmlAssetsFolder(const ProgramOptionsVariablesMap& variablesMap,
+		                         Options& options)
+		{
+			const auto* folder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::HtmlAssetsFolderOption);
+
+			if (folder)
+				options.SetHtmlAssetsFolder(*folder);
+		}
+
+		//---------------------------------------------------------------------
+		void AddHtmlShard(const ProgramOptionsVariablesMap& variablesMap,
+		                  Options& options)
+		{
+			const auto* value = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::HtmlShardOption);
+
+			if (!value)
+				return;
+
+			HtmlShard shard;
+			if (*value != ProgramOptions::HtmlShardIndexValue)
+			{
+				std::istringstream istr{*value};
+				char separator = 0;
+
+				if (!(istr >> shard.index_ >> separator >> shard.count_) ||
+				    separator != '/' || !istr.eof() || !shard.index_ ||
+				    shard.index_ > shard.count_)
+				{
+					throw Plugin::OptionsParserException(
+					    "Invalid value for --" + ProgramOptions::HtmlShardOption +
+					    ": " + *value + ". Expected <index>/<count> with index from 1 to count or " +
+					    ProgramOptions::HtmlShardIndexValue + ".");
+				}
+			}
+			// All the shards write in the same folder.
+			if (options.IsIncrementalHtmlModeEnabled() ||
+			    options.GetReportCompression() != ReportCompression::None)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::HtmlShardOption + " cannot be used with --" +
+				    ProgramOptions::IncrementalHtmlOption + " or --" +
+				    ProgramOptions::ReportCompressionOption + ".");
+			}
+			options.SetHtmlShard(shard);
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoberturaPackagesByFile(const ProgramOptionsVariablesMap& variablesMap,
+		                                Options& options)
+		{
+			auto packageCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::CoberturaPackagesByFileOption);
+
+			if (!packageCount)
+				return;
+			if (!*packageCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CoberturaPackagesByFileOption + " must be greater than 0.");
+			}
+			options.SetCoberturaPackageCountByFile(*packageCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddPerfStats(const ProgramOptionsVariablesMap& variablesMap,
+		                  Options& options)
+		{
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::PerfStatsOption);
+
+			if (path)
+				options.SetPerfStatsPath(*path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddTraceOutput(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::TraceOutputOption);
+
+			if (path)
+				options.SetTraceOutputPath(*path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddLiveCounters(const ProgramOptionsVariablesMap& variablesMap,
+		                     Options& options)
+		{
+			const auto* name = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::LiveCountersOption);
+
+			if (name)
+				options.SetLiveCountersName(*name);
+		}
+
+		//---------------------------------------------------------------------
+		void AddWatch(const ProgramOptionsVariablesMap& variablesMap,
+		              Options& options)
+		{
+			const auto* name = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::WatchOption);
+
+			if (name)
+				options.SetWatchName(*name);
+		}
+
+		//---------------------------------------------------------------------
+		void AddThreads(const ProgramOptionsVariablesMap& variablesMap,
+		                Options& options)
+		{
+			const auto* threadCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::ThreadsOption);
+
+			if (!threadCount)
+				return;
+			if (!*threadCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ThreadsOption + " must be greater than 0.");
+			}
+			options.SetThreadCount(*threadCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddThreadPlacement(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			if (variablesMap.IsOptionSelected(ProgramOptions::ThreadPlacementOption))
+				options.EnableThreadPlacement();
+		}
+
+		//---------------------------------------------------------------------
+		void AddMachineSymbolLoads(const ProgramOptionsVariablesMap& variablesMap,
+		                           Options& options)
+		{
+			const auto* machineSymbolLoadCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::MachineSymbolLoadsOption);
+
+			if (!machineSymbolLoadCount)
+				return;
+			if (!*machineSymbolLoadCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::MachineSymbolLoadsOption + " must be greater than 0.");
+			}
+			options.SetMachineSymbolLoadCount(*machineSymbolLoadCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddMeasureOverhead(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			const auto* runCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::MeasureOverheadOption);
+
+			if (!runCount)
+				return;
+			if (!options.GetStartInfo())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::MeasureOverheadOption + " requires a program to execute.");
+			}
+			if (!*runCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::MeasureOverheadOption + " must be greater than 0.");
+			}
+			options.SetMeasureOverheadRunCount(*runCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddDebugStrings(const ProgramOptionsVariablesMap& variablesMap,
+		                     Options& options)
+		{
+			const auto* mode = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::DebugStringsOption);
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::DebugStringsFileOption);
+
+			if (path)
+				options.SetDebugStringsPath(*path);
+			if (!mode)
+				return;
+			if (*mode == ProgramOptions::DebugStringsDropValue)
+				options.SetDebugStringMode(DebugStringMode::Drop);
+			else if (*mode == ProgramOptions::DebugStringsCountValue)
+				options.SetDebugStringMode(DebugStringMode::Count);
+			else
+			{
+				throw Plugin::OptionsParserException(
+				    "Invalid value for --" + ProgramOptions::DebugStringsOption +
+				    ": " + *mode + ". Expected " +
+				    ProgramOptions::DebugStringsDropValue + " or " +
+				    ProgramOptions::DebugStringsCountValue + ".");
+			}
+			// These options need the content of the strings.
+			if (path || options.IsCoverageRegionMarkersModeEnabled() ||
+			    options.GetTestImpactIndexPath())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::DebugStringsOption + " cannot be used with --" +
+				    ProgramOptions::DebugStringsFileOption + ", --" +
+				    ProgramOptions::CoverageRegionMarkersOption + " or --" +
+				    ProgramOptions::TestImpactIndexOption + ".");
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// Each option cannot be used with any of the options of its entry. The
+		// pairs are checked both ways, whatever their order on the command line.
+		std::vector<std::pair<std::string, std::vector<std::string>>> GetExclusiveOptions()
+		{
+			const std::vector<std::string> breakPointModes = {
+				ProgramOptions::InProcessAgentOption,
+				ProgramOptions::LazyBreakPointsOption,
+				ProgramOptions::PageGuardBreakPointsOption,
+				ProgramOptions::CoverageRegionMarkersOption,
+				ProgramOptions::SamplingTrapsPerSecondOption,
+				ProgramOptions::TestImpactIndexOption };
+			auto with = [&](std::vector<std::string> options) {
+				options.insert(options.begin(), breakPointModes.begin(), breakPointModes.end());
+				return options;
+			};
+
+			return {
+				// The section name is given to the program by an environment
+				// variable and the breakpoints are set again by each epoch.
+				{ ProgramOptions::FuzzOption, {
+					ProgramOptions::InProcessAgentOption,
+					ProgramOptions::AttachOption,
+					ProgramOptions::CoverageRegionMarkersOption,
+					ProgramOptions::SamplingTrapsPerSecondOption,
+					ProgramOptions::TestImpactIndexOption,
+					ProgramOptions::AutoDetachOption } },
+				// These modes need the breakpoints, or register the modules
+				// after the code ran.
+				{ ProgramOptions::IntelPtOption, with({
+					ProgramOptions::FuzzOption,
+					ProgramOptions::AsyncModulesOption,
+					ProgramOptions::ModuleTimeBudgetOption }) },
+				// The code is patched before it runs and these modes need the
+				// breakpoint events.
+				{ ProgramOptions::TrampolinesOption, with({
+					ProgramOptions::FuzzOption,
+					ProgramOptions::IntelPtOption,
+					ProgramOptions::AttachOption,
+					ProgramOptions::AsyncModulesOption,
+					ProgramOptions::ModuleTimeBudgetOption }) },
+				// No breakpoint is set when the sampling starts.
+				{ ProgramOptions::EtwSamplingOption, with({
+					ProgramOptions::FuzzOption,
+					ProgramOptions::IntelPtOption,
+					ProgramOptions::TrampolinesOption,
+					ProgramOptions::AsyncModulesOption,
+					ProgramOptions::ModuleTimeBudgetOption }) },
+				// These modes do not restore the instructions with the
+				// breakpoints of the debugger.
+				{ ProgramOptions::EagerLineDisarmOption, {
+					ProgramOptions::InProcessAgentOption,
+					ProgramOptions::PageGuardBreakPointsOption,
+					ProgramOptions::IntelPtOption,
+					ProgramOptions::TrampolinesOption,
+					ProgramOptions::EtwSamplingOption } },
+				// These modes set again the breakpoints already hit, do not
+				// write the breakpoints of the lines when they are registered
+				// or register the modules after the code ran.
+				{ ProgramOptions::AdaptiveArmingOption, with({
+					ProgramOptions::FuzzOption,
+					ProgramOptions::IntelPtOption,
+					ProgramOptions::TrampolinesOption,
+					ProgramOptions::EtwSamplingOption,
+					ProgramOptions::AsyncModulesOption,
+					ProgramOptions::ModuleTimeBudgetOption,
+					ProgramOptions::AutoDetachOption }) },
+				// These modes set breakpoints again after they are hit: the
+				// process would crash once detached.
+				{ ProgramOptions::AutoDetachOption, with({}) } };
+		}
+
+		//---------------------------------------------------------------------
+		void CheckExclusiveOptions(const ProgramOptionsVariablesMap& variablesMap)
+		{
+			for (const auto& exclusiveOptions : GetExclusiveOptions())
+			{
+				const auto& option = exclusiveOptions.first;
+
+				if (!variablesMap.IsOptionSelected(option))
+					continue;
+				for (const auto& otherOption : exclusiveOptions.second)
+				{
+					if (variablesMap.IsOptionSelected(otherOption))
+					{
+						throw Plugin::OptionsParserException(
+						    "--" + option + " and --" + otherOption +
+						    " cannot be used at the same time.");
+					}
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddFuzzing(const ProgramOptionsVariablesMap& variablesMap,
+		                Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::FuzzOption))
+				return;
+			// The end of an epoch is read from the debug strings.
+			if (options.GetDebugStringMode() != DebugStringMode::Read)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::FuzzOption + " cannot be used with --" +
+				    ProgramOptions::DebugStringsOption + ".");
+			}
+			options.EnableFuzzingMode();
+		}
+
+		//---------------------------------------------------------------------
+		void AddIntelPt(const ProgramOptionsVariablesMap& variablesMap,
+		                Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::IntelPtOption))
+				return;
+			options.EnableIntelPtMode();
+		}
+
+		//---------------------------------------------------------------------
+		void AddTrampolines(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::TrampolinesOption))
+				return;
+			options.EnableTrampolinesMode();
+		}
+
+		//---------------------------------------------------------------------
+		void AddEagerLineDisarm(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::EagerLineDisarmOption))
+				return;
+			options.EnableEagerLineDisarmMode();
+		}
+
+		//---------------------------------------------------------------------
+		void AddAdaptiveArming(const ProgramOptionsVariablesMap& variablesMap,
+		                       Options& options)
+		{
+			auto trapsPerSecond = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::AdaptiveArmingOption);
+
+			if (!trapsPerSecond)
+				return;
+			if (!*trapsPerSecond)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::AdaptiveArmingOption + " must be greater than 0.");
+			}
+			options.SetAdaptiveArmingTrapsPerSecond(*trapsPerSecond);
+		}
+
+		//---------------------------------------------------------------------
+		void AddEtwSampling(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::EtwSamplingOption))
+				return;
+			options.EnableEtwSamplingMode();
+		}
+
+		//---------------------------------------------------------------------
+		void AddAutoDetach(const ProgramOptionsVariablesMap& variablesMap,
+		                   Options& options)
+		{
+			auto seconds = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::AutoDetachOption);
+
+			if (!seconds)
+				return;
+			if (!*seconds)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::AutoDetachOption + " must be greater than 0.");
+			}
+			options.SetAutoDetachSeconds(*seconds);
+		}
+
+		//---------------------------------------------------------------------
+		void AddCoverageJournal(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::CoverageJournalOption);
+			auto seconds = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::CoverageJournalSecondsOption);
+
+			if (path)
+				options.SetCoverageJournalPath(*path);
+			if (!seconds)
+				return;
+			if (!path)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CoverageJournalSecondsOption +
+				    " requires --" + ProgramOptions::CoverageJournalOption + ".");
+			}
+			if (!*seconds)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CoverageJournalSecondsOption + " must be greater than 0.");
+			}
+			options.SetCoverageJournalSeconds(*seconds);
+		}
+
+		//---------------------------------------------------------------------
+		void AddFailUnder(const ProgramOptionsVariablesMap& variablesMap,
+		                  Options& options)
+		{
+			auto percent = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::FailUnderOption);
+
+			if (!percent)
+				return;
+			if (!*percent || *percent > 100)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::FailUnderOption + " must be between 1 and 100.");
+			}
+			options.SetMinimumLineRatePercent(*percent);
+		}
+
+		//---------------------------------------------------------------------
+		void AddAggregator(const ProgramOptionsVariablesMap& variablesMap,
+		                   Options& options)
+		{
+			const auto* name = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::AggregatorOption);
+			auto runCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::AggregatorRunsOption);
+
+			if (!name && !runCount)
+				return;
+			if (!name || !runCount || !*runCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::AggregatorOption + " requires --" +
+				    ProgramOptions::AggregatorRunsOption + " greater than 0.");
+			}
+			options.SetAggregator(*name, *runCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddSelectTests(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			auto path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::SelectTestsOption);
+
+			if (!path)
+				return;
+			if (!Tools::FileExists(*path))
+			{
+				throw Plugin::OptionsParserException(
+				    "Argument of " + ProgramOptions::SelectTestsOption + " <" +
+				    *path + "> does not exist.");
+			}
+			if (options.GetUnifiedDiffSettingsCollection().empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SelectTestsOption + " requires --" +
+				    ProgramOptions::UnifiedDiffOption + ".");
+			}
+			if (options.GetStartInfo())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SelectTestsOption +
+				    " cannot be used with a program to execute.");
+			}
+			options.SetSelectTestsIndexPath(*path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddCompareCoverage(const ProgramOptionsVariablesMap& variablesMap,
+		                        Options& options)
+		{
+			auto path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::CompareCoverageOption);
+
+			if (!path)
+				return;
+			if (options.GetInputCoveragePaths().size() != 2)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CompareCoverageOption + " requires two --" +
+				    ProgramOptions::InputCoverageValue + ".");
+			}
+			if (options.GetStartInfo() || !options.GetPrograms().empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CompareCoverageOption +
+				    " cannot be used with a program to execute.");
+			}
+			options.SetCompareCoverageOutputPath(*path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddDebugEvents(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			const auto* recordPath = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::RecordDebugEventsOption);
+			const auto* replayPath = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ReplayDebugEventsOption);
+
+			if (recordPath)
+				options.SetRecordDebugEventsPath(*recordPath);
+			if (!replayPath)
+				return;
+			// The replay stands for the debugger of the program.
+			if (!options.GetStartInfo() || recordPath || options.GetAttachProcessId() ||
+			    options.IsInProcessAgentModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ReplayDebugEventsOption +
+				    " requires the recorded program and cannot be used with --" +
+				    ProgramOptions::RecordDebugEventsOption + ", --" +
+				    ProgramOptions::AttachOption + " or --" +
+				    ProgramOptions::InProcessAgentOption + ".");
+			}
+			options.SetReplayDebugEventsPath(*replayPath);
+		}
+
+		//---------------------------------------------------------------------
+		void AddPrograms(const ProgramOptionsVariablesMap& variablesMap,
+		                 Options& options)
+		{
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ProgramsOption);
+
+			if (!path)
+				return;
+			// Each program has its own debugger but these options write a
+			// single file or cover a single process.
+			if (options.GetStartInfo() || options.GetAttachProcessId() ||
+			    options.GetTestImpactIndexPath() ||
+			    options.GetDebugStringsPath() || options.GetSelectTestsIndexPath() ||
+			    options.GetCoverageJournalPath())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ProgramsOption +
+				    " cannot be used with a program to execute, --" +
+				    ProgramOptions::AttachOption + ", --" +
+				    ProgramOptions::TestImpactIndexOption + ", --" +
+				    ProgramOptions::DebugStringsFileOption + ", --" +
+				    ProgramOptions::SelectTestsOption + " or --" +
+				    ProgramOptions::CoverageJournalOption + ".");
+			}
+
+			std::ifstream ifs(path->c_str());
+			if (!ifs)
+				throw Plugin::OptionsParserException("Cannot open programs file: " +
+				                             *path);
+
+			const auto* workingDirectory =
+			    variablesMap.GetOptionalValue<std::string>(
+			        ProgramOptions::WorkingDirectoryOption);
+			std::string line;
+			while (std::getline(ifs, line))
+			{
+				boost::algorithm::trim(line);
+				if (line.empty() || line[0] == '#')
+					continue;
+
+				auto arguments = boost::program_options::split_winmain(line);
+				StartInfo startInfo{arguments.front()};
+
+				for (size_t i = 1; i < arguments.size(); ++i)
+					startInfo.AddArgument(Tools::LocalToWString(arguments[i]));
+				if (workingDirectory)
+					startInfo.SetWorkingDirectory(*workingDirectory);
+				options.AddProgram(startInfo);
+			}
+			if (options.GetPrograms().empty())
+				throw Plugin::OptionsParserException("No program in " + *path);
+		}
+
+		//---------------------------------------------------------------------
+		void AddShards(const ProgramOptionsVariablesMap& variablesMap,
+		               Options& options)
+		{
+			auto shardCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::ShardsOption);
+
+			if (!shardCount)
+				return;
+			if (!*shardCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ShardsOption + " must be greater than 0.");
+			}
+			const auto* startInfo = options.GetStartInfo();
+			if (!startInfo || options.GetAttachProcessId() ||
+			    options.GetTestImpactIndexPath() || options.GetDebugStringsPath() ||
+			    options.GetCoverageJournalPath())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ShardsOption +
+				    " requires a program to execute and cannot be used with --" +
+				    ProgramOptions::AttachOption + ", --" +
+				    ProgramOptions::TestImpactIndexOption + ", --" +
+				    ProgramOptions::DebugStringsFileOption + " or --" +
+				    ProgramOptions::CoverageJournalOption + ".");
+			}
+
+			// The start info is kept to name the exports after the program.
+			for (unsigned int i = 0; i < *shardCount; ++i)
+			{
+				auto shardStartInfo = *startInfo;
+				shardStartInfo.AddEnvironmentVariable(L"GTEST_TOTAL_SHARDS",
+				                                      std::to_wstring(*shardCount));
+				shardStartInfo.AddEnvironmentVariable(L"GTEST_SHARD_INDEX",
+				                                      std::to_wstring(i));
+				options.AddProgram(shardStartInfo);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddJobs(const ProgramOptionsVariablesMap& variablesMap,
+		             Options& options)
+		{
+			auto jobCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::JobsOption);
+
+			if (!jobCount)
+				return;
+			if (options.GetPrograms().empty() && !options.GetIndexedPdbsFolder())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::JobsOption + " requires --" +
+				    ProgramOptions::ProgramsOption + ", --" +
+				    ProgramOptions::ShardsOption + " or --" +
+				    ProgramOptions::IndexPdbsOption + ".");
+			}
+			if (!*jobCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::JobsOption + " must be greater than 0.");
+			}
+			options.SetJobCount(*jobCount);
+		}
+
+		//---------------------------------------------------------------------
+		// Values of the option with the format <path1>?<path2>.
+		std::vector<std::pair<fs::path, fs::path>>
+		GetExistingPathPairs(const ProgramOptionsVariablesMap& variablesMap,
+		                     const std::string& optionName)
+		{
+			std::vector<std::pair<fs::path, fs::path>> pathPairs;
+			const auto* values =
+			    variablesMap.GetOptionalValue<std::vector<std::string>>(optionName);
+
+			if (!values)
+				return pathPairs;
+			for (const auto& value : *values)
+			{
+				auto pos = value.find(OptionsParser::PathSeparator);
+				if (pos == std::string::npos)
+				{
+					throw Plugin::OptionsParserException(
+					    "Invalid value for --" + optionName + ". Cannot find " +
+					    OptionsParser::PathSeparator + '.');
+				}
+				std::pair<fs::path, fs::path> paths{value.substr(0, pos), value.substr(pos + 1)};
+				for (const auto& path : {paths.first, paths.second})
+				{
+					if (!Tools::FileExists(path))
+					{
+						throw Plugin::OptionsParserException(
+						    "Argument of " + optionName + " <" + path.string() +
+						    "> does not exist.");
+					}
+				}
+				pathPairs.push_back(paths);
+			}
+			return pathPairs;
+		}
+
+		//---------------------------------------------------------------------
+		void AddLineCounters(const ProgramOptionsVariablesMap& variablesMap,
+		                     Options& options)
+		{
+			const auto* lineTablePath = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::LineTableOption);
+
+			if (lineTablePath)
+			{
+				if (!options.GetStartInfo() || options.GetAttachProcessId() ||
+				    !options.GetPrograms().empty())
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::LineTableOption +
+					    " requires a program to execute and cannot be used with --" +
+					    ProgramOptions::AttachOption + ", --" +
+					    ProgramOptions::ProgramsOption + " or --" +
+					    ProgramOptions::ShardsOption + ".");
+				}
+				options.SetLineTablePath(*lineTablePath);
+			}
+
+			const auto* instrumentedImagePath = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::InstrumentedImageOption);
+			if (instrumentedImagePath)
+			{
+				if (!lineTablePath)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::InstrumentedImageOption + " requires --" +
+					    ProgramOptions::LineTableOption + ".");
+				}
+				options.SetInstrumentedImagePath(*instrumentedImagePath);
+			}
+			for (const auto& paths : GetExistingPathPairs(
+			         variablesMap, ProgramOptions::InputLineCountersOption))
+				options.AddInputLineCountersPaths(paths);
+			for (const auto& paths : GetExistingPathPairs(
+			         variablesMap, ProgramOptions::InputSancovOption))
+				options.AddInputSancovPaths(paths);
+		}
+
+		//---------------------------------------------------------------------
+		void AddBinaryBaseline(const ProgramOptionsVariablesMap& variablesMap,
+		                       Options& options)
+		{
+			const auto* path = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::BinaryBaselineOption);
+
+			if (path)
 			{
-				for (const auto& excludedLineRegex : *excludedLineRegexes)
-					options.AddExcludedLineRegex(
-					    Tools::LocalToWString(excludedLineRegex));
+				if (!Tools::FileExists(*path))
+				{
+					throw Plugin::OptionsParserException(
+					    "Argument of " + ProgramOptions::BinaryBaselineOption +
+					    " <" + *path + "> does not exist.");
+				}
+				options.SetBinaryBaselinePath(*path);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddBinaryLineTables(const ProgramOptionsVariablesMap& variablesMap,
+		                         Options& options)
+		{
+			const auto* folder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::BinaryLineTablesOption);
+
+			if (!folder)
+				return;
+			if (options.GetBinaryBaselinePath())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::BinaryLineTablesOption + " and --" +
+				    ProgramOptions::BinaryBaselineOption +
+				    " cannot be used at the same time.");
+			}
+			options.SetBinaryLineTablesFolder(*folder);
+		}
+
+		//---------------------------------------------------------------------
+		void AddBinaryCompression(const ProgramOptionsVariablesMap& variablesMap,
+		                          Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::BinaryCompressionOption))
+				return;
+			// The delta and the hits are small: only the full layout is compressed.
+			if (options.GetBinaryBaselinePath() || options.GetBinaryLineTablesFolder())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::BinaryCompressionOption + " cannot be used with --" +
+				    ProgramOptions::BinaryBaselineOption + " or --" +
+				    ProgramOptions::BinaryLineTablesOption + ".");
+			}
+			options.EnableBinaryCompression();
+		}
+
+		//---------------------------------------------------------------------
+		void AddDeterministic(const ProgramOptionsVariablesMap& variablesMap,
+		                      Options& options)
+		{
+			if (!variablesMap.IsOptionSelected(ProgramOptions::DeterministicOption))
+				return;
+			// The manifest of the incremental report has the write times of the sources.
+			if (options.IsIncrementalHtmlModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::DeterministicOption + " cannot be used with --" +
+				    ProgramOptions::IncrementalHtmlOption + ".");
+			}
+			options.EnableDeterministicMode();
+		}
+
+		//---------------------------------------------------------------------
+		// The exports are parsed by the option parsers.
+		void CheckDeterministicExports(const Options& options)
+		{
+			if (!options.IsDeterministicModeEnabled())
+				return;
+			for (const auto& optionsExport : options.GetExports())
+			{
+				if (optionsExport.GetType() == OptionsExportType::FirstHits)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::DeterministicOption + " cannot be used with the " +
+					    ExportOptionParser::ExportTypeFirstHitsValue + " export.");
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// The delta export would replace the baseline it is computed from.
+		void CheckBinaryBaselineExports(const Options& options)
+		{
+			const auto* baselinePath = options.GetBinaryBaselinePath();
+
+			if (!baselinePath)
+				return;
+			for (const auto& optionsExport : options.GetExports())
+			{
+				const auto& parameter = optionsExport.GetParameter();
+				std::error_code error;
+
+				if (optionsExport.GetType() == OptionsExportType::Binary && parameter &&
+				    std::filesystem::equivalent(*parameter, *baselinePath, error))
+				{
+					throw Plugin::OptionsParserException(
+					    "The " + ExportOptionParser::ExportTypeBinaryValue +
+					    " export cannot be written to the file of --" +
+					    ProgramOptions::BinaryBaselineOption + ".");
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddCacheDir(const ProgramOptionsVariablesMap& variablesMap,
+		                 Options& options)
+		{
+			const uintmax_t DefaultCacheSizeMB = 2048;
+			const auto* folder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::CacheDirOption);
+			auto sizeMB = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::CacheSizeOption);
+
+			if (!folder)
+			{
+				if (sizeMB)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::CacheSizeOption + " requires --" +
+					    ProgramOptions::CacheDirOption + ".");
+				}
+				return;
+			}
+			if (variablesMap.GetOptionalValue<std::string>(ProgramOptions::PdbCacheOption))
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CacheDirOption + " cannot be used with --" +
+				    ProgramOptions::PdbCacheOption + ".");
+			}
+			if (sizeMB && !*sizeMB)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::CacheSizeOption + " must be greater than 0.");
+			}
+			options.SetCacheFolder(*folder, (sizeMB ? *sizeMB : DefaultCacheSizeMB) * 1024 * 1024);
+		}
+
+		//---------------------------------------------------------------------
+		void AddPdbCache(const ProgramOptionsVariablesMap& variablesMap,
+		                 Options& options)
+		{
+			const auto* pdbCacheFolder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::PdbCacheOption);
+			const auto* indexedPdbsFolder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::IndexPdbsOption);
+
+			const auto* remoteStore = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::PdbCacheRemoteOption);
+
+			auto hasPdbCache = pdbCacheFolder || options.GetCacheFolder();
+
+			if (pdbCacheFolder)
+				options.SetPdbCacheFolder(*pdbCacheFolder);
+			if (remoteStore)
+			{
+				if (!hasPdbCache)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::PdbCacheRemoteOption + " requires --" +
+					    ProgramOptions::PdbCacheOption + " or --" +
+					    ProgramOptions::CacheDirOption + ".");
+				}
+				options.SetPdbCacheRemoteStore(Tools::LocalToWString(*remoteStore));
+			}
+			if (indexedPdbsFolder)
+			{
+				if (!hasPdbCache || options.GetStartInfo() ||
+				    !options.GetPrograms().empty() || options.GetAttachProcessId())
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::IndexPdbsOption + " requires --" +
+					    ProgramOptions::PdbCacheOption + " or --" +
+					    ProgramOptions::CacheDirOption +
+					    " and cannot be used with a program to execute, --" +
+					    ProgramOptions::ProgramsOption + " or --" +
+					    ProgramOptions::AttachOption + ".");
+				}
+				if (!fs::is_directory(*indexedPdbsFolder))
+				{
+					throw Plugin::OptionsParserException(
+					    "Argument of " + ProgramOptions::IndexPdbsOption + " <" +
+					    *indexedPdbsFolder + "> is not a folder.");
+				}
+				options.SetIndexedPdbsFolder(*indexedPdbsFolder);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddResultCache(const ProgramOptionsVariablesMap& variablesMap,
+		                    Options& options)
+		{
+			const auto* inputs = variablesMap.GetOptionalValue<std::vector<std::string>>(
+			    ProgramOptions::ResultCacheInputOption);
+
+			if (!variablesMap.IsOptionSelected(ProgramOptions::ResultCacheOption))
+			{
+				if (inputs)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::ResultCacheInputOption + " requires --" +
+					    ProgramOptions::ResultCacheOption + ".");
+				}
+				return;
+			}
+			if (!options.GetCacheFolder() || !options.GetPrograms().empty() ||
+			    options.GetAttachProcessId() || options.GetTestImpactIndexPath())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ResultCacheOption + " requires --" +
+				    ProgramOptions::CacheDirOption + " and cannot be used with --" +
+				    ProgramOptions::ProgramsOption + ", --" +
+				    ProgramOptions::AttachOption + " or --" +
+				    ProgramOptions::TestImpactIndexOption + ".");
+			}
+			options.EnableResultCacheMode();
+			if (inputs)
+			{
+				for (const auto& input : *inputs)
+					options.AddResultCacheInput(input);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddModuleTimeBudget(const ProgramOptionsVariablesMap& variablesMap,
+		                         Options& options)
+		{
+			auto milliseconds = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::ModuleTimeBudgetOption);
+
+			if (!milliseconds)
+				return;
+			if (!*milliseconds)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ModuleTimeBudgetOption + " must be greater than 0.");
+			}
+			// The modules must be registered before these modes use their
+			// breakpoints, and all the modules are already registered later
+			// with --async_modules.
+			if (options.IsInProcessAgentModeEnabled() ||
+			    options.IsCoverageRegionMarkersModeEnabled() ||
+			    options.IsAsyncModulesModeEnabled())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ModuleTimeBudgetOption + " cannot be used with --" +
+				    ProgramOptions::InProcessAgentOption + ", --" +
+				    ProgramOptions::CoverageRegionMarkersOption + " or --" +
+				    ProgramOptions::AsyncModulesOption + ".");
+			}
+			options.SetModuleTimeBudgetMilliseconds(*milliseconds);
+		}
+
+		//---------------------------------------------------------------------
+		void AddMemoryBudget(const ProgramOptionsVariablesMap& variablesMap,
+		                     Options& options)
+		{
+			auto megabytes = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::MemoryBudgetOption);
+
+			if (!megabytes)
+				return;
+			if (!*megabytes)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::MemoryBudgetOption + " must be greater than 0.");
+			}
+			options.SetMemoryBudgetMegabytes(*megabytes);
+		}
+
+		//---------------------------------------------------------------------
+		void AddSymbolServers(const ProgramOptionsVariablesMap& variablesMap,
+		                      Options& options)
+		{
+			using T_Strings = std::vector<std::string>;
+			const auto* symbolServers = variablesMap.GetOptionalValue<T_Strings>(
+			    ProgramOptions::SymbolServerOption);
+			const auto* symbolCacheFolder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::SymbolCacheOption);
+			auto symbolDownloadCount = variablesMap.GetOptionalValue<unsigned int>(
+			    ProgramOptions::SymbolDownloadsOption);
+
+			if (!symbolServers)
+			{
+				if (symbolCacheFolder || symbolDownloadCount)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::SymbolCacheOption + " and --" +
+					    ProgramOptions::SymbolDownloadsOption + " require --" +
+					    ProgramOptions::SymbolServerOption + ".");
+				}
+				return;
+			}
+			if (!symbolCacheFolder)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SymbolServerOption + " requires --" +
+				    ProgramOptions::SymbolCacheOption + ".");
+			}
+			if (symbolDownloadCount && !*symbolDownloadCount)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SymbolDownloadsOption + " must be greater than 0.");
+			}
+
+			for (const auto& symbolServer : *symbolServers)
+				options.AddSymbolServer(Tools::LocalToWString(symbolServer));
+			options.SetSymbolCacheFolder(*symbolCacheFolder);
+			if (symbolDownloadCount)
+				options.SetSymbolDownloadCount(*symbolDownloadCount);
+		}
+
+		//---------------------------------------------------------------------
+		void AddSourceServerCache(const ProgramOptionsVariablesMap& variablesMap,
+		                          Options& options)
+		{
+			const auto* folder = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::SourceServerCacheOption);
+			const auto* programs = variablesMap.GetOptionalValue<std::vector<std::string>>(
+			    ProgramOptions::SourceServerCommandOption);
+
+			if (programs && !folder)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::SourceServerCommandOption + " requires --" +
+				    ProgramOptions::SourceServerCacheOption + ".");
+			}
+			if (folder)
+				options.SetSourceServerCacheFolder(*folder);
+			if (programs)
+			{
+				for (const auto& program : *programs)
+					options.AddSourceServerCommand(Tools::LocalToWString(program));
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void AddService(const ProgramOptionsVariablesMap& variablesMap,
+		                Options& options)
+		{
+			const auto* serviceName = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ServiceOption);
+			const auto* usedServiceName = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::UseServiceOption);
+
+			if (serviceName)
+			{
+				// The service only receives the runs of --use_service.
+				if (options.GetStartInfo() || !options.GetPrograms().empty() ||
+				    !options.GetInputCoveragePaths().empty() ||
+				    options.GetSelectTestsIndexPath() || usedServiceName)
+				{
+					throw Plugin::OptionsParserException(
+					    "--" + ProgramOptions::ServiceOption +
+					    " cannot be used with a program to execute, --" +
+					    ProgramOptions::ProgramsOption + ", --" +
+					    ProgramOptions::InputCoverageValue + ", --" +
+					    ProgramOptions::SelectTestsOption + " or --" +
+					    ProgramOptions::UseServiceOption + ".");
+				}
+				options.SetServiceName(*serviceName);
+			}
+			if (usedServiceName)
+				options.SetUsedServiceName(*usedServiceName);
+		}
+
+		//---------------------------------------------------------------------
+		void AddQueryService(const ProgramOptionsVariablesMap& variablesMap,
+		                     Options& options)
+		{
+			const auto* name = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::QueryServiceOption);
+
+			if (!name)
+				return;
+			if (options.GetInputCoveragePaths().size() != 1)
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::QueryServiceOption + " requires one --" +
+				    ProgramOptions::InputCoverageValue + ".");
+			}
+			if (options.GetStartInfo() || !options.GetPrograms().empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::QueryServiceOption +
+				    " cannot be used with a program to execute.");
+			}
+			options.SetQueryServiceName(*name);
+		}
+
+		//---------------------------------------------------------------------
+		void AddOutOfProcessPlugins(const ProgramOptionsVariablesMap& variablesMap,
+		                            Options& options)
+		{
+			if (variablesMap.IsOptionSelected(ProgramOptions::OutOfProcessPluginsOption))
+				options.EnableOutOfProcessPluginsMode();
+
+			const auto* sectionName = variablesMap.GetOptionalValue<std::string>(
+			    ProgramOptions::ExportPluginHostOption);
+
+			if (!sectionName)
+				return;
+			if (options.GetStartInfo() || !options.GetPrograms().empty())
+			{
+				throw Plugin::OptionsParserException(
+				    "--" + ProgramOptions::ExportPluginHostOption +
+				    " cannot be used with a program to execute.");
 			}
+			options.SetExportPluginHostSectionName(Tools::LocalToWString(*sectionName));
 		}
 
 		//---------------------------------------------------------------------
@@ -414,6 +1807,14 @@ namespace CppCoverage
 		                ProgramOptions::ExcludedSourcesOption);
 
 		auto optionalStartInfo = GetStartInfo(variablesMap);
+		const auto* attachProcessId = variablesMap.GetOptionalValue<unsigned int>(
+		    ProgramOptions::AttachOption);
+		// The coverage is named after the executable of the process.
+		if (attachProcessId)
+		{
+			optionalStartInfo = GetAttachedProcessStartInfo(
+			    *attachProcessId, optionalStartInfo.is_initialized());
+		}
 		Options options{
 		    modulePatterns, sourcePatterns, optionalStartInfo.get_ptr()};
 
@@ -447,19 +1848,172 @@ namespace CppCoverage
 			options.EnableOptimizedBuildSupport();
 		if (variablesMap.IsOptionSelected(ProgramOptions::StopOnAssertOption))
 			options.EnableStopOnAssertMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::InProcessAgentOption))
+			options.EnableInProcessAgentMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::BasicBlockBreakPointsOption))
+			options.EnableBasicBlockBreakPointsMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::DominatorBreakPointsOption))
+			options.EnableDominatorBreakPointsMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::LazyBreakPointsOption))
+			options.EnableLazyBreakPointsMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::PageGuardBreakPointsOption))
+			options.EnablePageGuardBreakPointsMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::BaselineArmingOption))
+			options.EnableBaselineArmingMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::RefilterInputCoverageOption))
+			options.EnableInputCoverageRefilterMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::IncrementalHtmlOption))
+			options.EnableIncrementalHtmlMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::CoverageRegionMarkersOption))
+			options.EnableCoverageRegionMarkersMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::DebugHeapOption))
+			options.EnableDebugHeapMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::AsyncModulesOption))
+			options.EnableAsyncModulesMode();
+		if (variablesMap.IsOptionSelected(ProgramOptions::NativePdbReaderOption))
+			options.EnableNativePdbReader();
+		if (variablesMap.IsOptionSelected(ProgramOptions::MergeIdenticalModulesOption))
+			options.EnableIdenticalModulesMerge();
+
+		if (options.IsInProcessAgentModeEnabled() &&
+		    options.IsCoverChildrenModeEnabled())
+			throw Plugin::OptionsParserException("--" + ProgramOptions::InProcessAgentOption +
+			                             " and --" +
+			                             ProgramOptions::CoverChildrenOption +
+			                             " cannot be used at the same time.");
+		// The exceptions of the program are not seen without a debugger.
+		if (options.IsInProcessAgentModeEnabled() &&
+		    (options.IsContinueAfterCppExceptionModeEnabled() ||
+		     options.IsStopOnAssertModeEnabled()))
+			throw Plugin::OptionsParserException("--" + ProgramOptions::InProcessAgentOption +
+			                             " cannot be used with --" +
+			                             ProgramOptions::ContinueAfterCppExceptionOption + " or --" +
+			                             ProgramOptions::StopOnAssertOption + ".");
+		if (options.IsInProcessAgentModeEnabled() &&
+		    options.IsLazyBreakPointsModeEnabled())
+			throw Plugin::OptionsParserException("--" + ProgramOptions::InProcessAgentOption +
+			                             " and --" +
+			                             ProgramOptions::LazyBreakPointsOption +
+			                             " cannot be used at the same time.");
+		if (options.IsPageGuardBreakPointsModeEnabled() &&
+		    (options.IsInProcessAgentModeEnabled() ||
+		     options.IsLazyBreakPointsModeEnabled()))
+			throw Plugin::OptionsParserException("--" + ProgramOptions::PageGuardBreakPointsOption +
+			                             " cannot be used with --" +
+			                             ProgramOptions::InProcessAgentOption + " or --" +
+			                             ProgramOptions::LazyBreakPointsOption + ".");
+		if (options.IsCoverageRegionMarkersModeEnabled() &&
+		    (options.IsInProcessAgentModeEnabled() ||
+		     options.IsLazyBreakPointsModeEnabled() ||
+		     options.IsPageGuardBreakPointsModeEnabled()))
+			throw Plugin::OptionsParserException("--" + ProgramOptions::CoverageRegionMarkersOption +
+			                             " cannot be used with --" +
+			                             ProgramOptions::InProcessAgentOption + ", --" +
+			                             ProgramOptions::LazyBreakPointsOption + " or --" +
+			                             ProgramOptions::PageGuardBreakPointsOption + ".");
+		// The modules must be registered before these modes use their breakpoints.
+		if (options.IsAsyncModulesModeEnabled() &&
+		    (options.IsInProcessAgentModeEnabled() ||
+		     options.IsCoverageRegionMarkersModeEnabled()))
+			throw Plugin::OptionsParserException("--" + ProgramOptions::AsyncModulesOption +
+			                             " cannot be used with --" +
+			                             ProgramOptions::InProcessAgentOption + " or --" +
+			                             ProgramOptions::CoverageRegionMarkersOption + ".");
+
+		if (attachProcessId)
+		{
+			if (options.IsInProcessAgentModeEnabled())
+				throw Plugin::OptionsParserException("--" + ProgramOptions::AttachOption +
+				                             " and --" +
+				                             ProgramOptions::InProcessAgentOption +
+				                             " cannot be used at the same time.");
+			options.SetAttachProcessId(*attachProcessId);
+		}
 
+		CheckExclusiveOptions(variablesMap);
 		AddInputCoverages(variablesMap, options);
+		if (options.IsBaselineArmingModeEnabled() &&
+		    options.GetInputCoveragePaths().empty())
+			throw Plugin::OptionsParserException("--" + ProgramOptions::BaselineArmingOption +
+			                             " requires --" +
+			                             ProgramOptions::InputCoverageValue + ".");
+		if (options.IsInputCoverageRefilterModeEnabled() &&
+		    options.GetInputCoveragePaths().empty())
+			throw Plugin::OptionsParserException("--" + ProgramOptions::RefilterInputCoverageOption +
+			                             " requires --" +
+			                             ProgramOptions::InputCoverageValue + ".");
 		AddUnifiedDiff(variablesMap, options);
+		AddInputCoverageDiff(variablesMap, options);
 		AddExcludedLineRegexes(variablesMap, options);
+		AddExclusionMarkers(variablesMap, options);
 		AddSubstitutePdbSourcePaths(variablesMap, options);
-
-		if (!options.GetStartInfo() && options.GetInputCoveragePaths().empty())
+		AddCoverageLevel(variablesMap, options);
+		AddChildPatterns(variablesMap, options);
+		AddSamplingTrapsPerSecond(variablesMap, options);
+		AddTestImpactIndex(variablesMap, options);
+		AddAutoDetach(variablesMap, options);
+		AddDebugStrings(variablesMap, options);
+		AddDebugEvents(variablesMap, options);
+		AddFuzzing(variablesMap, options);
+		AddPerfStats(variablesMap, options);
+		AddTraceOutput(variablesMap, options);
+		AddLiveCounters(variablesMap, options);
+		AddWatch(variablesMap, options);
+		AddReportCompression(variablesMap, options);
+		AddHtmlAssetsFolder(variablesMap, options);
+		AddHtmlShard(variablesMap, options);
+		AddCoberturaPackagesByFile(variablesMap, options);
+		AddCoverageJournal(variablesMap, options);
+		AddFailUnder(variablesMap, options);
+		AddAggregator(variablesMap, options);
+		AddSelectTests(variablesMap, options);
+		AddPrograms(variablesMap, options);
+		AddShards(variablesMap, options);
+		AddCompareCoverage(variablesMap, options);
+		AddCacheDir(variablesMap, options);
+		AddResultCache(variablesMap, options);
+		AddPdbCache(variablesMap, options);
+		AddSymbolServers(variablesMap, options);
+		AddMachineSymbolLoads(variablesMap, options);
+		AddSourceServerCache(variablesMap, options);
+		AddModuleTimeBudget(variablesMap, options);
+		AddMemoryBudget(variablesMap, options);
+		AddJobs(variablesMap, options);
+		AddService(variablesMap, options);
+		AddQueryService(variablesMap, options);
+		AddOutOfProcessPlugins(variablesMap, options);
+		AddLineCounters(variablesMap, options);
+		AddBinaryBaseline(variablesMap, options);
+		AddBinaryLineTables(variablesMap, options);
+		AddBinaryCompression(variablesMap, options);
+		AddDeterministic(variablesMap, options);
+		AddMeasureOverhead(variablesMap, options);
+		AddThreads(variablesMap, options);
+		AddThreadPlacement(variablesMap, options);
+		AddIntelPt(variablesMap, options);
+		AddTrampolines(variablesMap, options);
+		AddEtwSampling(variablesMap, options);
+		AddEagerLineDisarm(variablesMap, options);
+		AddAdaptiveArming(variablesMap, options);
+
+		if (!options.GetStartInfo() && options.GetPrograms().empty() &&
+		    !options.GetServiceName() &&
+		    !options.GetExportPluginHostSectionName() &&
+		    options.GetInputCoveragePaths().empty() &&
+		    options.GetInputLineCountersPaths().empty() &&
+		    options.GetInputSancovPaths().empty() &&
+		    !options.GetAggregatorName() &&
+		    !options.GetSelectTestsIndexPath() &&
+		    !options.GetIndexedPdbsFolder() &&
+		    !options.GetWatchName())
 			throw Plugin::OptionsParserException(
 			    "You must specify a program to execute or use --" +
 			    ProgramOptions::InputCoverageValue);
 
 		for (const auto& optionParser : optionParsers_)
 			optionParser->ParseOption(variablesMap, options);
+		CheckDeterministicExports(options);
+		CheckBinaryBaselineExports(options);
 		return options;
 	}
 
@@ -0,0 +1,172 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "OverheadReport.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include "PerformanceStatistics.hpp"
+#include "CppCoverageException.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		//---------------------------------------------------------------------
+		bool IsDebugEventCounter(const std::string& name)
+		{
+			const auto& prefix = PerformanceStatistics::DebugEventsCounterPrefix;
+
+			return name.compare(0, prefix.size(), prefix) == 0;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsOverheadCounter(const std::string& name)
+		{
+			return IsDebugEventCounter(name) ||
+			       name == PerformanceStatistics::ArmedBreakPointsCounter ||
+			       name == PerformanceStatistics::HitBreakPointsCounter;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void OverheadReport::AddRun(const std::wstring& modeName,
+	                            Clock::duration wallTime,
+	                            const PerformanceStatistics* statistics)
+	{
+		auto it = std::find_if(modes_.begin(), modes_.end(), [&](const Mode& mode) {
+			return mode.name_ == modeName;
+		});
+
+		if (it == modes_.end())
+			it = modes_.insert(modes_.end(), Mode{modeName, {}, {}});
+		it->wallTimes_.push_back(wallTime);
+		if (!statistics)
+			return;
+
+		for (const auto& counter : statistics->GetCounters())
+		{
+			if (!IsOverheadCounter(counter.first))
+				continue;
+			auto counterIt = std::find_if(it->counters_.begin(), it->counters_.end(), [&](const Counter& modeCounter) {
+				return modeCounter.first == counter.first;
+			});
+			if (counterIt == it->counters_.end())
+				it->counters_.push_back(counter);
+			else
+				counterIt->second += counter.second;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<OverheadReport::Mode>& OverheadReport::GetModes() const
+	{
+		return modes_;
+	}
+
+	//-------------------------------------------------------------------------
+	OverheadReport::Clock::duration OverheadReport::GetMedianWallTime(const Mode& mode)
+	{
+		if (mode.wallTimes_.empty())
+			THROW(L"No run for the mode " << mode.name_);
+
+		auto wallTimes = mode.wallTimes_;
+		auto middle = wallTimes.begin() + wallTimes.size() / 2;
+
+		std::nth_element(wallTimes.begin(), middle, wallTimes.end());
+		return *middle;
+	}
+
+	//-------------------------------------------------------------------------
+	double OverheadReport::GetRatio(const Mode& mode) const
+	{
+		if (modes_.empty())
+			THROW(L"No mode in the overhead report");
+
+		auto referenceWallTime = GetMedianWallTime(modes_.front());
+		if (referenceWallTime == Clock::duration::zero())
+			return 0;
+		return Milliseconds{GetMedianWallTime(mode)} / Milliseconds{referenceWallTime};
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t OverheadReport::GetCounter(const Mode& mode, const std::string& name)
+	{
+		for (const auto& counter : mode.counters_)
+		{
+			if (counter.first == name)
+				return counter.second / (std::max)(mode.wallTimes_.size(), size_t{1});
+		}
+		return 0;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t OverheadReport::GetDebugEventCount(const Mode& mode)
+	{
+		uint64_t count = 0;
+
+		for (const auto& counter : mode.counters_)
+		{
+			if (IsDebugEventCounter(counter.first))
+				count += GetCounter(mode, counter.first);
+		}
+		return count;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wostream& operator<<(std::wostream& ostr, const OverheadReport& overheadReport)
+	{
+		const int nameWidth = 16;
+		const int valueWidth = 14;
+
+		ostr << std::left << std::setw(nameWidth) << L"Mode" << std::right
+		     << std::setw(valueWidth) << L"Runs" << std::setw(valueWidth) << L"Median (ms)"
+		     << std::setw(valueWidth) << L"Ratio" << std::setw(valueWidth) << L"Events"
+		     << std::setw(valueWidth) << L"Armed" << std::setw(valueWidth) << L"Hit" << std::endl;
+		ostr << std::fixed << std::setprecision(1);
+		for (const auto& mode : overheadReport.GetModes())
+		{
+			ostr << std::left << std::setw(nameWidth) << mode.name_ << std::right
+			     << std::setw(valueWidth) << mode.wallTimes_.size()
+			     << std::setw(valueWidth) << Milliseconds{OverheadReport::GetMedianWallTime(mode)}.count()
+			     << std::setw(valueWidth - 1) << std::setprecision(2) << overheadReport.GetRatio(mode) << L'x'
+			     << std::setprecision(1)
+			     << std::setw(valueWidth) << OverheadReport::GetDebugEventCount(mode)
+			     << std::setw(valueWidth) << OverheadReport::GetCounter(mode, PerformanceStatistics::ArmedBreakPointsCounter)
+			     << std::setw(valueWidth) << OverheadReport::GetCounter(mode, PerformanceStatistics::HitBreakPointsCounter)
+			     << std::endl;
+		}
+
+		// Debug events by type, by run.
+		for (const auto& mode : overheadReport.GetModes())
+		{
+			for (const auto& counter : mode.counters_)
+			{
+				auto value = OverheadReport::GetCounter(mode, counter.first);
+				if (value && IsDebugEventCounter(counter.first))
+					ostr << mode.name_ << L": " << Tools::LocalToWString(counter.first) << L" " << value << std::endl;
+			}
+		}
+		return ostr;
+	}
+}
@@ -0,0 +1,71 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class PerformanceStatistics;
+
+	// Wall times and debug counters of the runs of a program in several modes,
+	// for --measure_overhead. The ratios are relative to the first mode added.
+	class CPPCOVERAGE_DLL OverheadReport
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+		using Counter = std::pair<std::string, uint64_t>;
+
+		struct Mode
+		{
+			std::wstring name_;
+			std::vector<Clock::duration> wallTimes_;
+			// Debug events and breakpoints of all the runs of the mode.
+			std::vector<Counter> counters_;
+		};
+
+		OverheadReport() = default;
+
+		// statistics is null for a run without debugger.
+		void AddRun(const std::wstring& mode,
+		            Clock::duration wallTime,
+		            const PerformanceStatistics* statistics = nullptr);
+
+		const std::vector<Mode>& GetModes() const;
+		static Clock::duration GetMedianWallTime(const Mode&);
+		// Median wall time of mode divided by the one of the first mode.
+		double GetRatio(const Mode&) const;
+		// Average by run.
+		static uint64_t GetCounter(const Mode&, const std::string& name);
+		static uint64_t GetDebugEventCount(const Mode&);
+
+	private:
+		OverheadReport(const OverheadReport&) = delete;
+		OverheadReport& operator=(const OverheadReport&) = delete;
+
+		std::vector<Mode> modes_;
+	};
+
+	CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream&, const OverheadReport&);
+}
@@ -0,0 +1,218 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "PackedLineTable.hpp"
+
+#include <algorithm>
+
+#include "Tools/MemoryUsage.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class Writer
+		{
+		public:
+			//-----------------------------------------------------------------
+			void WriteUnsigned(uint64_t value)
+			{
+				while (value >= 0x80)
+				{
+					bytes_ += static_cast<char>((value & 0x7F) | 0x80);
+					value >>= 7;
+				}
+				bytes_ += static_cast<char>(value);
+			}
+
+			//-----------------------------------------------------------------
+			// Zigzag encoding: the small negative deltas take a byte too.
+			void WriteDelta(uint64_t value, uint64_t& previousValue)
+			{
+				auto delta = static_cast<int64_t>(value - previousValue);
+
+				WriteUnsigned((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+				previousValue = value;
+			}
+
+			//-----------------------------------------------------------------
+			std::string& GetBytes()
+			{
+				return bytes_;
+			}
+
+		private:
+			std::string bytes_;
+		};
+
+		//---------------------------------------------------------------------
+		class Reader
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit Reader(const std::string& bytes)
+				: bytes_{ bytes }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t ReadUnsigned()
+			{
+				uint64_t value = 0;
+
+				for (int shift = 0;; shift += 7)
+				{
+					if (position_ >= bytes_.size())
+						THROW("Invalid packed line table.");
+					auto byte = static_cast<unsigned char>(bytes_[position_++]);
+					value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+					if (!(byte & 0x80))
+						return value;
+				}
+			}
+
+			//-----------------------------------------------------------------
+			uint64_t ReadDelta(uint64_t& previousValue)
+			{
+				auto value = ReadUnsigned();
+				auto delta = (value >> 1) ^ (~(value & 1) + 1);
+
+				previousValue += delta;
+				return previousValue;
+			}
+
+		private:
+			const std::string& bytes_;
+			size_t position_ = 0;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	PackedLineTable::PackedLineTable(
+		const std::vector<Line>& lines,
+		const std::vector<DWORD64>& addresses,
+		const LineNumberByAddress& lineNumberByAddress,
+		DWORD64 baseOfImage)
+		: lineCount_{ lines.size() }
+	{
+		Writer writer;
+		uint64_t lineNumber = 0;
+		uint64_t virtualAddress = 0;
+		uint64_t symbolIndex = 0;
+
+		for (const auto& line : lines)
+		{
+			writer.WriteDelta(line.lineNumber_, lineNumber);
+			writer.WriteDelta(static_cast<uint64_t>(line.virtualAddress_), virtualAddress);
+			writer.WriteDelta(line.symbolIndex_, symbolIndex);
+			writer.WriteUnsigned(line.functionLength_);
+			auto functionVirtualAddress = virtualAddress;
+			writer.WriteDelta(static_cast<uint64_t>(line.functionVirtualAddress_), functionVirtualAddress);
+		}
+
+		// Unsigned arithmetic: the RVAs are relative to baseOfImage.
+		uint64_t rva = 0;
+		writer.WriteUnsigned(addresses.size());
+		for (auto address : addresses)
+			writer.WriteDelta(address - baseOfImage, rva);
+
+		std::vector<LineNumberByAddress::const_iterator> sortedAddresses;
+		sortedAddresses.reserve(lineNumberByAddress.size());
+		for (auto it = lineNumberByAddress.begin(); it != lineNumberByAddress.end(); ++it)
+			sortedAddresses.push_back(it);
+		std::sort(sortedAddresses.begin(), sortedAddresses.end(), [](const auto& it1, const auto& it2) {
+			return it1->first < it2->first;
+		});
+
+		rva = 0;
+		lineNumber = 0;
+		writer.WriteUnsigned(sortedAddresses.size());
+		for (const auto& it : sortedAddresses)
+		{
+			writer.WriteDelta(it->first - baseOfImage, rva);
+			writer.WriteUnsigned(it->second.size());
+			for (auto addressLineNumber : it->second)
+				writer.WriteDelta(static_cast<uint64_t>(addressLineNumber), lineNumber);
+		}
+
+		bytes_ = std::move(writer.GetBytes());
+		bytes_.shrink_to_fit();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t PackedLineTable::GetLineCount() const
+	{
+		return lineCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t PackedLineTable::GetAllocatedSize() const
+	{
+		return Tools::GetAllocatedSize(bytes_);
+	}
+
+	//-------------------------------------------------------------------------
+	void PackedLineTable::Unpack(
+		DWORD64 baseOfImage,
+		std::vector<Line>& lines,
+		std::vector<DWORD64>& addresses,
+		LineNumberByAddress& lineNumberByAddress) const
+	{
+		Reader reader{ bytes_ };
+		uint64_t lineNumber = 0;
+		uint64_t virtualAddress = 0;
+		uint64_t symbolIndex = 0;
+
+		lines.clear();
+		lines.reserve(lineCount_);
+		for (size_t i = 0; i < lineCount_; ++i)
+		{
+			reader.ReadDelta(lineNumber);
+			reader.ReadDelta(virtualAddress);
+			reader.ReadDelta(symbolIndex);
+			auto functionLength = reader.ReadUnsigned();
+			auto functionVirtualAddress = virtualAddress;
+			reader.ReadDelta(functionVirtualAddress);
+			lines.emplace_back(static_cast<unsigned long>(lineNumber),
+			                   static_cast<int64_t>(virtualAddress),
+			                   static_cast<unsigned long>(symbolIndex),
+			                   static_cast<int64_t>(functionVirtualAddress),
+			                   functionLength);
+		}
+
+		uint64_t rva = 0;
+		addresses.resize(static_cast<size_t>(reader.ReadUnsigned()));
+		for (auto& address : addresses)
+			address = baseOfImage + reader.ReadDelta(rva);
+
+		rva = 0;
+		lineNumber = 0;
+		lineNumberByAddress.clear();
+		auto addressCount = static_cast<size_t>(reader.ReadUnsigned());
+		lineNumberByAddress.reserve(addressCount);
+		for (size_t i = 0; i < addressCount; ++i)
+		{
+			auto& lineNumbers = lineNumberByAddress[baseOfImage + reader.ReadDelta(rva)];
+			auto lineNumberCount = static_cast<size_t>(reader.ReadUnsigned());
+			for (size_t j = 0; j < lineNumberCount; ++j)
+				lineNumbers.push_back(static_cast<int>(reader.ReadDelta(lineNumber)));
+		}
+	}
+}
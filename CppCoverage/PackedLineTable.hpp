@@ -0,0 +1,67 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/container/small_vector.hpp>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+#include "DebugInformationEnumerator.hpp"
+
+namespace CppCoverage
+{
+	// Selected lines of a source file with their addresses, kept in a few
+	// bytes by line: the values are varint encoded as deltas from the
+	// previous ones and the addresses as deltas of their RVA. The table is
+	// unpacked at once, for another load of its module.
+	class CPPCOVERAGE_DLL PackedLineTable
+	{
+	public:
+		using Line = IDebugInformationHandler::Line;
+		// Most addresses have a single line: it is stored inline.
+		using LineNumberByAddress =
+		    std::unordered_map<DWORD64, boost::container::small_vector<int, 1>>;
+
+		PackedLineTable(const std::vector<Line>& lines,
+		                const std::vector<DWORD64>& addresses,
+		                const LineNumberByAddress&,
+		                DWORD64 baseOfImage);
+
+		PackedLineTable(PackedLineTable&&) = default;
+		PackedLineTable& operator=(PackedLineTable&&) = default;
+
+		size_t GetLineCount() const;
+		uint64_t GetAllocatedSize() const;
+
+		// The addresses are rebased on baseOfImage.
+		void Unpack(DWORD64 baseOfImage,
+		            std::vector<Line>& lines,
+		            std::vector<DWORD64>& addresses,
+		            LineNumberByAddress&) const;
+
+	private:
+		PackedLineTable(const PackedLineTable&) = delete;
+		PackedLineTable& operator=(const PackedLineTable&) = delete;
+
+		size_t lineCount_;
+		std::string bytes_;
+	};
+}
@@ -0,0 +1,520 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "PdbCache.hpp"
+#include <algorithm>
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <Windows.h>
+#include <urlmon.h>
+
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include "Tools/BlobCache.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/SecurityAttributes.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+#include "Handle.hpp"
+#include "PdbReference.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const uint64_t Magic = 0x4548434142445043; // "CPDBACHE"
+		const size_t MaxChecksumSize = 32; // SHA-256
+		// Reading a large PDB with DIA can take several minutes.
+		const DWORD KeyLockTimeoutMilliseconds = 10 * 60 * 1000;
+		// Another machine can upload the missing file meanwhile.
+		const std::chrono::seconds RemoteMissDuration = std::chrono::hours{1};
+
+		//---------------------------------------------------------------------
+		struct Header
+		{
+			uint64_t magic_;
+			uint32_t version_;
+			uint32_t fileCount_;
+			uint64_t lineCount_;
+			uint64_t pathsSize_;
+		};
+
+		//---------------------------------------------------------------------
+		struct FileRecord
+		{
+			uint64_t pathOffset_;
+			uint32_t pathSize_;
+			uint32_t lineCount_;
+			uint8_t checksumType_;
+			uint8_t checksumSize_;
+			char checksum_[MaxChecksumSize];
+		};
+
+		//---------------------------------------------------------------------
+		struct LineRecord
+		{
+			int64_t virtualAddress_;
+			int64_t functionVirtualAddress_;
+			uint64_t functionLength_;
+			uint32_t lineNumber_;
+			uint32_t symbolIndex_;
+		};
+
+		//---------------------------------------------------------------------
+		bool IsUrl(const std::wstring& remoteStore)
+		{
+			return boost::istarts_with(remoteStore, L"http://") ||
+			       boost::istarts_with(remoteStore, L"https://");
+		}
+
+		//---------------------------------------------------------------------
+		std::chrono::seconds GetTimeSinceEpoch()
+		{
+			return std::chrono::duration_cast<std::chrono::seconds>(
+			    std::chrono::system_clock::now().time_since_epoch());
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void WriteValue(std::ofstream& ofs, const T& value)
+		{
+			ofs.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetVariable(const wchar_t* name)
+		{
+			auto size = GetEnvironmentVariableW(name, nullptr, 0);
+			if (!size)
+				return{};
+			std::wstring value(size, L'\0');
+			value.resize(GetEnvironmentVariableW(name, &value[0], size));
+			return value;
+		}
+
+		//---------------------------------------------------------------------
+		// What the search of the PDB of a module depends on: the PDB files
+		// searched by DIA with their last write time, and the symbol path.
+		std::wstring GetPdbLookup(const std::filesystem::path& modulePath)
+		{
+			std::vector<std::filesystem::path> pdbPaths{
+			    std::filesystem::path{modulePath}.replace_extension(L".pdb")};
+			auto pdbReference = PdbReference::Read(modulePath);
+			if (pdbReference)
+			{
+				pdbPaths.push_back(pdbReference->pdbPath_);
+				pdbPaths.push_back(modulePath.parent_path() / pdbReference->pdbPath_.filename());
+			}
+
+			std::wostringstream ostr;
+			for (const auto& pdbPath : pdbPaths)
+			{
+				std::error_code error;
+				auto lastWriteTime = std::filesystem::last_write_time(pdbPath, error);
+				ostr << pdbPath.wstring() << L'|'
+				     << (error ? 0 : lastWriteTime.time_since_epoch().count()) << L'|';
+			}
+			ostr << GetVariable(L"_NT_SYMBOL_PATH") << L'|' << GetVariable(L"_NT_ALT_SYMBOL_PATH");
+			return Tools::BlobCache::GetKey(Tools::ToUtf8String(ostr.str()));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const int PdbCache::Version = 2;
+
+	//-------------------------------------------------------------------------
+	PdbCache::KeyLock::KeyLock(void* hMutex, bool hasWaited)
+		: hMutex_{hMutex}
+		, hasWaited_{hasWaited}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	PdbCache::KeyLock::~KeyLock()
+	{
+		ReleaseMutex(hMutex_);
+		CloseHandle(hMutex_);
+	}
+
+	//-------------------------------------------------------------------------
+	bool PdbCache::KeyLock::HasWaited() const
+	{
+		return hasWaited_;
+	}
+
+	//-------------------------------------------------------------------------
+	PdbCache::PdbCache(const std::filesystem::path& folder,
+	                   const std::wstring& remoteStore)
+		: PdbCache{std::make_shared<Tools::BlobCache>(folder, 0), remoteStore}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	PdbCache::PdbCache(std::shared_ptr<const Tools::BlobCache> blobCache,
+	                   const std::wstring& remoteStore)
+		: blobCache_{std::move(blobCache)}
+		, remoteStore_{boost::trim_right_copy_if(remoteStore, boost::is_any_of(L"/\\"))}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	PdbCache::~PdbCache() = default;
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::wstring> PdbCache::GetKey(const std::filesystem::path& modulePath)
+	{
+		auto pdbReference = PdbReference::Read(modulePath);
+		if (!pdbReference)
+			return boost::none;
+
+		const auto& guid = pdbReference->guid_;
+		std::wostringstream ostr;
+
+		ostr << std::hex << std::uppercase << std::setfill(L'0')
+		     << std::setw(8) << guid.Data1 << std::setw(4) << guid.Data2
+		     << std::setw(4) << guid.Data3;
+		for (auto byte : guid.Data4)
+			ostr << std::setw(2) << static_cast<int>(byte);
+		ostr << L'-' << pdbReference->age_ << L'-' << std::setw(8) << pdbReference->timeDateStamp_;
+		return ostr.str();
+	}
+
+	//-------------------------------------------------------------------------
+	bool PdbCache::Contains(const std::wstring& key) const
+	{
+		return blobCache_->Contains(GetName(key)) || Download(key);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::vector<PdbCache::SourceFile>>
+	PdbCache::Read(const std::wstring& key) const
+	{
+		auto name = GetName(key);
+		auto foundPath = blobCache_->Find(name);
+		if (!foundPath && Download(key))
+			foundPath = blobCache_->Find(name);
+		if (!foundPath)
+			return boost::none;
+
+		const auto& path = *foundPath;
+		auto hFile = CreateFileW(path.c_str(),
+		                         GENERIC_READ,
+		                         FILE_SHARE_READ | FILE_SHARE_DELETE,
+		                         nullptr,
+		                         OPEN_EXISTING,
+		                         FILE_ATTRIBUTE_NORMAL,
+		                         nullptr);
+		if (hFile == INVALID_HANDLE_VALUE)
+			return boost::none;
+
+		auto file = CreateHandle(hFile, CloseHandle);
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(file.GetValue(), &fileSize) ||
+		    static_cast<uint64_t>(fileSize.QuadPart) < sizeof(Header))
+			THROW(L"Invalid PDB cache file: " << path.wstring());
+
+		auto fileMapping = CreateHandle(
+		    CreateFileMapping(file.GetValue(), nullptr, PAGE_READONLY, 0, 0, nullptr),
+		    CloseHandle);
+		auto view = CreateHandle(
+		    MapViewOfFile(fileMapping.GetValue(), FILE_MAP_READ, 0, 0, 0),
+		    UnmapViewOfFile);
+
+		const auto* data = static_cast<const char*>(view.GetValue());
+		const auto& header = *reinterpret_cast<const Header*>(data);
+		auto size = static_cast<uint64_t>(fileSize.QuadPart);
+		if (header.magic_ == Magic && header.version_ != Version)
+		{
+			// Written by another version: the module is enumerated again.
+			LOG_DEBUG << L"Ignore the PDB cache file of version " << header.version_ << L": " << path.wstring();
+			return boost::none;
+		}
+		if (header.magic_ != Magic ||
+		    size != sizeof(Header) + header.fileCount_ * sizeof(FileRecord) +
+		                header.lineCount_ * sizeof(LineRecord) + header.pathsSize_)
+			THROW(L"Invalid PDB cache file: " << path.wstring());
+
+		const auto* fileRecords = reinterpret_cast<const FileRecord*>(data + sizeof(Header));
+		const auto* lineRecords = reinterpret_cast<const LineRecord*>(fileRecords + header.fileCount_);
+		const auto* paths = reinterpret_cast<const wchar_t*>(lineRecords + header.lineCount_);
+		auto pathCount = header.pathsSize_ / sizeof(wchar_t);
+		uint64_t lineIndex = 0;
+
+		std::vector<SourceFile> sourceFiles(header.fileCount_);
+		for (size_t i = 0; i < sourceFiles.size(); ++i)
+		{
+			const auto& fileRecord = fileRecords[i];
+			if (fileRecord.pathOffset_ + fileRecord.pathSize_ > pathCount ||
+			    lineIndex + fileRecord.lineCount_ > header.lineCount_ ||
+			    fileRecord.checksumSize_ > MaxChecksumSize)
+				THROW(L"Invalid PDB cache file: " << path.wstring());
+
+			auto& sourceFile = sourceFiles[i];
+			sourceFile.path_.assign(paths + fileRecord.pathOffset_, fileRecord.pathSize_);
+			sourceFile.checksum_.type_ = static_cast<Tools::SourceChecksum::Type>(fileRecord.checksumType_);
+			sourceFile.checksum_.bytes_.assign(fileRecord.checksum_, fileRecord.checksumSize_);
+			sourceFile.lines_.reserve(fileRecord.lineCount_);
+			for (uint32_t j = 0; j < fileRecord.lineCount_; ++j)
+			{
+				const auto& lineRecord = lineRecords[lineIndex++];
+				sourceFile.lines_.emplace_back(lineRecord.lineNumber_,
+				                               lineRecord.virtualAddress_,
+				                               lineRecord.symbolIndex_,
+				                               lineRecord.functionVirtualAddress_,
+				                               lineRecord.functionLength_);
+			}
+		}
+		return sourceFiles;
+	}
+
+	//-------------------------------------------------------------------------
+	void PdbCache::Write(const std::wstring& key,
+	                     const std::vector<SourceFile>& sourceFiles) const
+	{
+		Header header{Magic, static_cast<uint32_t>(Version), static_cast<uint32_t>(sourceFiles.size()), 0, 0};
+		for (const auto& sourceFile : sourceFiles)
+		{
+			header.lineCount_ += sourceFile.lines_.size();
+			header.pathsSize_ += sourceFile.path_.size() * sizeof(wchar_t);
+		}
+
+		// Several runs can write the same module: the complete file replaces
+		// the existing one.
+		auto name = GetName(key);
+		auto temporaryPath = blobCache_->GetTemporaryPath(name);
+
+		std::filesystem::create_directories(blobCache_->GetFolder());
+		try
+		{
+			std::ofstream ofs{temporaryPath, std::ios::binary};
+			uint64_t pathOffset = 0;
+
+			WriteValue(ofs, header);
+			for (const auto& sourceFile : sourceFiles)
+			{
+				FileRecord fileRecord{pathOffset,
+				                      static_cast<uint32_t>(sourceFile.path_.size()),
+				                      static_cast<uint32_t>(sourceFile.lines_.size())};
+				const auto& checksum = sourceFile.checksum_;
+				if (checksum.bytes_.size() <= MaxChecksumSize)
+				{
+					fileRecord.checksumType_ = static_cast<uint8_t>(checksum.type_);
+					fileRecord.checksumSize_ = static_cast<uint8_t>(checksum.bytes_.size());
+					std::copy(checksum.bytes_.begin(), checksum.bytes_.end(), fileRecord.checksum_);
+				}
+				WriteValue(ofs, fileRecord);
+				pathOffset += sourceFile.path_.size();
+			}
+			for (const auto& sourceFile : sourceFiles)
+			{
+				for (const auto& line : sourceFile.lines_)
+				{
+					WriteValue(ofs, LineRecord{line.virtualAddress_,
+					                      line.functionVirtualAddress_,
+					                      line.functionLength_,
+					                      static_cast<uint32_t>(line.lineNumber_),
+					                      static_cast<uint32_t>(line.symbolIndex_)});
+				}
+			}
+			for (const auto& sourceFile : sourceFiles)
+			{
+				ofs.write(reinterpret_cast<const char*>(sourceFile.path_.data()),
+				          sourceFile.path_.size() * sizeof(wchar_t));
+			}
+			if (!ofs)
+				THROW(L"Cannot write PDB cache file: " << temporaryPath.wstring());
+		}
+		catch (...)
+		{
+			std::error_code error;
+			std::filesystem::remove(temporaryPath, error);
+			throw;
+		}
+		blobCache_->Publish(name, temporaryPath);
+		Upload(key);
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<PdbCache::KeyLock> PdbCache::LockKey(const std::wstring& key) const
+	{
+		auto folder = boost::to_lower_copy(blobCache_->GetFolder().lexically_normal().wstring());
+		// The runs of all the sessions share the folder.
+		auto name = L"Global\\OpenCppCoverage.PdbCache." +
+		            Tools::BlobCache::GetKey(Tools::ToUtf8String(folder)) + L'.' + key;
+		auto securityAttributes = Tools::SecurityAttributes::CreateForAuthenticatedUsers();
+		auto hMutex = CreateMutexW(securityAttributes.Get(), FALSE, name.c_str());
+		if (!hMutex)
+		{
+			LOG_WARNING << L"Cannot create the mutex " << name << L": " << GetLastError();
+			return nullptr;
+		}
+
+		auto hasWaited = false;
+		auto result = WaitForSingleObject(hMutex, 0);
+		if (result == WAIT_TIMEOUT)
+		{
+			LOG_DEBUG << L"Wait for another run enumerating " << key;
+			hasWaited = true;
+			result = WaitForSingleObject(hMutex, KeyLockTimeoutMilliseconds);
+		}
+
+		// WAIT_ABANDONED: the run owning the mutex exited without writing
+		// its cache file.
+		if (result != WAIT_OBJECT_0 && result != WAIT_ABANDONED)
+		{
+			LOG_WARNING << L"Cannot lock the PDB cache key " << key << L": " << result;
+			CloseHandle(hMutex);
+			return nullptr;
+		}
+		return std::make_unique<KeyLock>(hMutex, hasWaited);
+	}
+
+	//-------------------------------------------------------------------------
+	bool PdbCache::IsWithoutPdb(const std::wstring& key,
+	                            const std::filesystem::path& modulePath) const
+	{
+		return static_cast<bool>(blobCache_->Find(GetWithoutPdbName(key, modulePath)));
+	}
+
+	//-------------------------------------------------------------------------
+	void PdbCache::SetWithoutPdb(const std::wstring& key,
+	                             const std::filesystem::path& modulePath) const
+	{
+		blobCache_->Write(GetWithoutPdbName(key, modulePath), std::string_view{});
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring PdbCache::GetName(const std::wstring& key)
+	{
+		return key + L".pdbcache";
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring PdbCache::GetWithoutPdbName(const std::wstring& key,
+	                                         const std::filesystem::path& modulePath)
+	{
+		return key + L'.' + GetPdbLookup(modulePath) + L".nopdb";
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring PdbCache::GetRemoteMissName(const std::wstring& key)
+	{
+		return key + L".remotemiss";
+	}
+
+	//-------------------------------------------------------------------------
+	bool PdbCache::IsRemoteMiss(const std::wstring& key) const
+	{
+		auto content = blobCache_->Read(GetRemoteMissName(key));
+		if (!content)
+			return false;
+
+		// The content is the time of the miss in seconds since the epoch.
+		std::istringstream istr{*content};
+		long long missTime = 0;
+		if (!(istr >> missTime))
+			return false;
+		return GetTimeSinceEpoch() - std::chrono::seconds{missTime} < RemoteMissDuration;
+	}
+
+	//-------------------------------------------------------------------------
+	bool PdbCache::Download(const std::wstring& key) const
+	{
+		if (remoteStore_.empty())
+			return false;
+
+		// Each request to a store without the file takes a round trip.
+		auto isUrl = IsUrl(remoteStore_);
+		if (isUrl && IsRemoteMiss(key))
+			return false;
+
+		auto filename = GetName(key);
+		auto temporaryPath = blobCache_->GetTemporaryPath(filename);
+		std::error_code error;
+
+		std::filesystem::create_directories(blobCache_->GetFolder(), error);
+		auto isDownloaded = isUrl
+			? URLDownloadToFileW(nullptr, (remoteStore_ + L'/' + filename).c_str(),
+			                     temporaryPath.c_str(), 0, nullptr) == S_OK
+			: std::filesystem::copy_file(std::filesystem::path{remoteStore_} / filename,
+			                             temporaryPath,
+			                             std::filesystem::copy_options::overwrite_existing,
+			                             error);
+		if (isUrl && !isDownloaded)
+		{
+			auto writeError = Tools::Try([&]() {
+				blobCache_->Write(GetRemoteMissName(key),
+				                  std::to_string(GetTimeSinceEpoch().count()));
+			});
+			if (writeError)
+				LOG_DEBUG << L"Cannot write the remote miss of " << filename << L": " << *writeError;
+		}
+		try
+		{
+			if (isDownloaded)
+				blobCache_->Publish(filename, temporaryPath);
+		}
+		catch (const std::exception&)
+		{
+			isDownloaded = false;
+		}
+		if (!isDownloaded)
+		{
+			std::filesystem::remove(temporaryPath, error);
+			return false;
+		}
+
+		LOG_DEBUG << L"PDB cache file " << filename << L" downloaded from " << remoteStore_;
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	void PdbCache::Upload(const std::wstring& key) const
+	{
+		if (remoteStore_.empty() || IsUrl(remoteStore_))
+			return;
+
+		// The first run writing a module fills the store: the other runs
+		// download the same content.
+		auto name = GetName(key);
+		auto path = blobCache_->GetPath(name);
+		auto remotePath = std::filesystem::path{remoteStore_} / name;
+		auto temporaryPath = Tools::BlobCache::GetTemporaryPath(remoteStore_, name);
+		std::error_code error;
+
+		if (std::filesystem::is_regular_file(remotePath, error))
+			return;
+		std::filesystem::create_directories(remoteStore_, error);
+		if (std::filesystem::copy_file(path, temporaryPath,
+		                               std::filesystem::copy_options::overwrite_existing, error))
+			std::filesystem::rename(temporaryPath, remotePath, error);
+		if (error)
+		{
+			std::filesystem::remove(temporaryPath, error);
+			LOG_WARNING << L"Cannot copy the PDB cache file " << remotePath.wstring();
+		}
+	}
+}
@@ -0,0 +1,121 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+#include "DebugInformationEnumerator.hpp"
+
+namespace Tools
+{
+	class BlobCache;
+}
+
+namespace CppCoverage
+{
+	// Source files and lines read by DebugInformationEnumerator, saved in a
+	// Tools::BlobCache between the runs. A module is looked up with the GUID and the
+	// age of its PDB and its link timestamp, all read from the PE file: an
+	// unchanged module does not load its PDB.
+	//
+	// Each cache file is a binary file which is memory mapped:
+	//   Header
+	//   FileRecord  for each source file, with its checksum read from the PDB
+	//   LineRecord  for each line, grouped by source file
+	//   the paths of the source files in UTF-16
+	//
+	// A module whose PDB was not found has an empty marker file instead, so
+	// the next runs do not search its PDB again. The marker is named after
+	// what the search depends on, the symbol path and the last write time of
+	// the PDB files searched: a PDB found later is read.
+	//
+	// A remote store shared by several machines can back the folder: an http
+	// or https URL or a folder, a file share for example, with the same file
+	// names. A cache file missing in the folder is downloaded from the store,
+	// and a new cache file is copied to the store when it is a folder. The
+	// markers of the modules without PDB are not shared. A file missing in an
+	// http store is not requested again for an hour.
+	//
+	// The runs in parallel on the same machine with the same folder enumerate
+	// a module once: LockKey makes the others wait for its cache file, which
+	// they map instead of loading the PDB.
+	class CPPCOVERAGE_DLL PdbCache
+	{
+	public:
+		static const int Version;
+
+		// A named mutex owned until the destruction.
+		class CPPCOVERAGE_DLL KeyLock
+		{
+		public:
+			KeyLock(void* hMutex, bool hasWaited);
+			~KeyLock();
+
+			// Another run owned the lock: its cache file may now exist.
+			bool HasWaited() const;
+
+		private:
+			KeyLock(const KeyLock&) = delete;
+			KeyLock& operator=(const KeyLock&) = delete;
+
+			void* const hMutex_;
+			const bool hasWaited_;
+		};
+
+		using SourceFile = PdbSourceFile;
+
+		explicit PdbCache(const std::filesystem::path& folder,
+		                  const std::wstring& remoteStore = L"");
+		explicit PdbCache(std::shared_ptr<const Tools::BlobCache>,
+		                  const std::wstring& remoteStore = L"");
+		~PdbCache();
+
+		// boost::none when the module has no CodeView debug directory.
+		static boost::optional<std::wstring> GetKey(const std::filesystem::path& modulePath);
+
+		bool Contains(const std::wstring& key) const;
+		// boost::none when the key is not in the cache.
+		boost::optional<std::vector<SourceFile>> Read(const std::wstring& key) const;
+		void Write(const std::wstring& key, const std::vector<SourceFile>&) const;
+		// nullptr when the lock cannot be owned, after a timeout for example.
+		std::unique_ptr<KeyLock> LockKey(const std::wstring& key) const;
+
+		bool IsWithoutPdb(const std::wstring& key, const std::filesystem::path& modulePath) const;
+		void SetWithoutPdb(const std::wstring& key, const std::filesystem::path& modulePath) const;
+
+	private:
+		PdbCache(const PdbCache&) = delete;
+		PdbCache& operator=(const PdbCache&) = delete;
+
+		static std::wstring GetName(const std::wstring& key);
+		static std::wstring GetWithoutPdbName(const std::wstring& key,
+		                                      const std::filesystem::path& modulePath);
+		static std::wstring GetRemoteMissName(const std::wstring& key);
+		bool IsRemoteMiss(const std::wstring& key) const;
+		bool Download(const std::wstring& key) const;
+		void Upload(const std::wstring& key) const;
+
+		const std::shared_ptr<const Tools::BlobCache> blobCache_;
+		const std::wstring remoteStore_;
+	};
+}
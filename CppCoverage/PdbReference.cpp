@@ -0,0 +1,140 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "PdbReference.hpp"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const DWORD CodeViewSignature = 0x53445352; // "RSDS"
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		bool ReadAt(std::ifstream& ifs, uint64_t offset, T& value)
+		{
+			ifs.seekg(offset);
+			return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<uint64_t> GetFileOffset(
+			const std::vector<IMAGE_SECTION_HEADER>& sections,
+			DWORD rva)
+		{
+			for (const auto& section : sections)
+			{
+				if (rva >= section.VirtualAddress &&
+				    rva < section.VirtualAddress + section.SizeOfRawData)
+					return rva - section.VirtualAddress + section.PointerToRawData;
+			}
+			return boost::none;
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<IMAGE_DATA_DIRECTORY> GetDebugDirectory(
+			std::ifstream& ifs,
+			uint64_t optionalHeaderOffset)
+		{
+			WORD magic = 0;
+			if (!ReadAt(ifs, optionalHeaderOffset, magic))
+				return boost::none;
+
+			if (magic == IMAGE_NT_OPTIONAL_HDR32_MAGIC)
+			{
+				IMAGE_OPTIONAL_HEADER32 optionalHeader;
+				if (ReadAt(ifs, optionalHeaderOffset, optionalHeader) &&
+				    optionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_DEBUG)
+					return optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+			}
+			else if (magic == IMAGE_NT_OPTIONAL_HDR64_MAGIC)
+			{
+				IMAGE_OPTIONAL_HEADER64 optionalHeader;
+				if (ReadAt(ifs, optionalHeaderOffset, optionalHeader) &&
+				    optionalHeader.NumberOfRvaAndSizes > IMAGE_DIRECTORY_ENTRY_DEBUG)
+					return optionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_DEBUG];
+			}
+			return boost::none;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<PdbReference> PdbReference::Read(const std::filesystem::path& modulePath)
+	{
+		std::ifstream ifs{modulePath, std::ios::binary};
+		IMAGE_DOS_HEADER dosHeader;
+		DWORD signature = 0;
+		IMAGE_FILE_HEADER fileHeader;
+
+		if (!ReadAt(ifs, 0, dosHeader) || dosHeader.e_magic != IMAGE_DOS_SIGNATURE)
+			return boost::none;
+
+		auto ntHeaderOffset = static_cast<uint64_t>(dosHeader.e_lfanew);
+		if (!ReadAt(ifs, ntHeaderOffset, signature) || signature != IMAGE_NT_SIGNATURE ||
+		    !ReadAt(ifs, ntHeaderOffset + sizeof(signature), fileHeader))
+			return boost::none;
+
+		auto optionalHeaderOffset = ntHeaderOffset + sizeof(signature) + sizeof(fileHeader);
+		auto debugDirectory = GetDebugDirectory(ifs, optionalHeaderOffset);
+		if (!debugDirectory || !debugDirectory->VirtualAddress)
+			return boost::none;
+
+		std::vector<IMAGE_SECTION_HEADER> sections(fileHeader.NumberOfSections);
+		for (size_t i = 0; i < sections.size(); ++i)
+		{
+			auto sectionOffset = optionalHeaderOffset + fileHeader.SizeOfOptionalHeader +
+			                     i * sizeof(IMAGE_SECTION_HEADER);
+			if (!ReadAt(ifs, sectionOffset, sections[i]))
+				return boost::none;
+		}
+
+		auto debugDirectoryOffset = GetFileOffset(sections, debugDirectory->VirtualAddress);
+		if (!debugDirectoryOffset)
+			return boost::none;
+
+		for (DWORD i = 0; i < debugDirectory->Size / sizeof(IMAGE_DEBUG_DIRECTORY); ++i)
+		{
+			IMAGE_DEBUG_DIRECTORY entry;
+			if (!ReadAt(ifs, *debugDirectoryOffset + i * sizeof(entry), entry))
+				return boost::none;
+
+			DWORD codeViewSignature = 0;
+			PdbReference pdbReference;
+			uint64_t offset = entry.PointerToRawData;
+			if (entry.Type == IMAGE_DEBUG_TYPE_CODEVIEW &&
+			    entry.SizeOfData > sizeof(codeViewSignature) + sizeof(pdbReference.guid_) + sizeof(pdbReference.age_) &&
+			    ReadAt(ifs, offset, codeViewSignature) &&
+			    codeViewSignature == CodeViewSignature &&
+			    ReadAt(ifs, offset + sizeof(codeViewSignature), pdbReference.guid_) &&
+			    ReadAt(ifs, offset + sizeof(codeViewSignature) + sizeof(pdbReference.guid_), pdbReference.age_))
+			{
+				// The path is a null terminated UTF-8 string.
+				std::string pdbPath;
+				std::getline(ifs, pdbPath, '\0');
+				pdbReference.timeDateStamp_ = fileHeader.TimeDateStamp;
+				pdbReference.pdbPath_ = std::filesystem::u8path(pdbPath);
+				return pdbReference;
+			}
+		}
+		return boost::none;
+	}
+}
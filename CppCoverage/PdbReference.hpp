@@ -0,0 +1,41 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <boost/optional.hpp>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// The PDB of a module as recorded in the CodeView debug directory of its
+	// PE file. The PE file is read from the disk, not from a process.
+	struct CPPCOVERAGE_DLL PdbReference
+	{
+		// boost::none when the module has no CodeView debug directory.
+		static boost::optional<PdbReference> Read(const std::filesystem::path& modulePath);
+
+		GUID guid_;
+		DWORD age_;
+		DWORD timeDateStamp_;
+		std::filesystem::path pdbPath_;
+	};
+}
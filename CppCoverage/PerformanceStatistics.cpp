@@ -0,0 +1,601 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "PerformanceStatistics.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <ostream>
+
+#include <Windows.h>
+
+#include "Tools/Tool.hpp"
+#include "Tools/MemoryUsage.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::duration<double, std::milli>;
+
+		//---------------------------------------------------------------------
+		uint64_t ToUInt64(const FILETIME& fileTime)
+		{
+			return (static_cast<uint64_t>(fileTime.dwHighDateTime) << 32) | fileTime.dwLowDateTime;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteJsonString(std::ostream& ostr, const std::string& value)
+		{
+			ostr << '"';
+			for (auto c : value)
+			{
+				if (c == '"' || c == '\\')
+					ostr << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					ostr << ' ';
+				else
+					ostr << c;
+			}
+			ostr << '"';
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring FormatRatio(size_t selectedCount, size_t count)
+		{
+			std::wstring ratio = std::to_wstring(selectedCount);
+
+			// The counts seen are unknown for the modules only replayed.
+			if (count)
+				ratio += L"/" + std::to_wstring(count);
+			return ratio;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<PerformanceStatistics::DebuggeeStall>
+		SortByDecreasingTime(std::vector<PerformanceStatistics::DebuggeeStall> stalls)
+		{
+			std::stable_sort(stalls.begin(), stalls.end(), [](const auto& stall1, const auto& stall2) {
+				return stall1.time_ > stall2.time_;
+			});
+			return stalls;
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetStallName(const PerformanceStatistics::DebuggeeStall& stall)
+		{
+			auto name = Tools::LocalToWString(stall.event_);
+
+			if (!stall.modulePath_.empty())
+				name += L": " + std::filesystem::path{stall.modulePath_}.filename().wstring();
+			return name;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteJsonStalls(std::ostream& ostr,
+		                     const std::vector<PerformanceStatistics::DebuggeeStall>& stalls)
+		{
+			for (size_t i = 0; i < stalls.size(); ++i)
+			{
+				const auto& stall = stalls[i];
+
+				ostr << (i ? ",\n" : "\n") << "    {\"event\": ";
+				WriteJsonString(ostr, stall.event_);
+				ostr << ", \"path\": ";
+				WriteJsonString(ostr, Tools::ToUtf8String(stall.modulePath_));
+				ostr << ", \"ms\": " << Milliseconds{stall.time_}.count()
+				     << ", \"count\": " << stall.count_ << "}";
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string PerformanceStatistics::DebugEventsCounterPrefix = "Debug events: ";
+	const std::string PerformanceStatistics::ArmedBreakPointsCounter = "Breakpoints armed";
+	const std::string PerformanceStatistics::HitBreakPointsCounter = "Breakpoints hit";
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::ScopedPhase::ScopedPhase(PerformanceStatistics* statistics,
+	                                                const char* name,
+	                                                bool measureCpuTime)
+		: statistics_{statistics}
+		, name_{name}
+		, measureCpuTime_{measureCpuTime}
+		, cpuStart_{Clock::duration::zero()}
+	{
+		if (!statistics_)
+			return;
+		if (measureCpuTime_)
+			cpuStart_ = GetProcessCpuTime();
+		start_ = Clock::now();
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::ScopedPhase::~ScopedPhase()
+	{
+		if (!statistics_)
+			return;
+
+		auto wallTime = Clock::now() - start_;
+		if (measureCpuTime_)
+			statistics_->AddPhase(name_, wallTime, GetProcessCpuTime() - cpuStart_);
+		else
+			statistics_->AddPhase(name_, wallTime);
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::MemoryTracker::MemoryTracker(PerformanceStatistics* statistics,
+	                                                    const char* subsystem)
+		: statistics_{statistics}
+		, subsystem_{subsystem}
+		, bytes_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::MemoryTracker::Update(uint64_t bytes)
+	{
+		if (!statistics_)
+			return;
+		statistics_->UpdateMemoryUsage(subsystem_, bytes_, bytes);
+		bytes_ = bytes;
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::Clock::duration PerformanceStatistics::GetProcessCpuTime()
+	{
+		using FileTimeDuration = std::chrono::duration<uint64_t, std::ratio<1, 10000000>>;
+		FILETIME creationTime;
+		FILETIME exitTime;
+		FILETIME kernelTime;
+		FILETIME userTime;
+
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+			return Clock::duration::zero();
+		return std::chrono::duration_cast<Clock::duration>(
+		    FileTimeDuration{ToUInt64(kernelTime) + ToUInt64(userTime)});
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::Clock::duration PerformanceStatistics::GetProcessUpTime()
+	{
+		using FileTimeDuration = std::chrono::duration<uint64_t, std::ratio<1, 10000000>>;
+		FILETIME creationTime;
+		FILETIME exitTime;
+		FILETIME kernelTime;
+		FILETIME userTime;
+		FILETIME now;
+
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+			return Clock::duration::zero();
+		GetSystemTimeAsFileTime(&now);
+		if (ToUInt64(now) < ToUInt64(creationTime))
+			return Clock::duration::zero();
+		return std::chrono::duration_cast<Clock::duration>(
+		    FileTimeDuration{ToUInt64(now) - ToUInt64(creationTime)});
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t PerformanceStatistics::GetMemoryUsage(const Plugin::CoverageData& coverageData)
+	{
+		uint64_t bytes = Tools::GetAllocatedSize(coverageData.GetName()) +
+		                 Tools::GetAllocatedSize(coverageData.GetModules());
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			bytes += sizeof(*module) + Tools::GetAllocatedSize(module->GetPath()) +
+			         Tools::GetAllocatedSize(module->GetFiles());
+			for (const auto& file : module->GetFiles())
+			{
+				// The lines shared with another coverage are counted twice.
+				bytes += sizeof(*file) + Tools::GetAllocatedSize(file->GetPath()) +
+				         Tools::GetAllocatedSize(file->GetLines());
+			}
+		}
+		return bytes;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddPhase(const std::string& name, Clock::duration wallTime)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto& phase = GetPhase(name);
+
+		phase.wallTime_ += wallTime;
+		++phase.count_;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddPhase(const std::string& name,
+	                                     Clock::duration wallTime,
+	                                     Clock::duration cpuTime)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto& phase = GetPhase(name);
+
+		phase.wallTime_ += wallTime;
+		phase.cpuTime_ += cpuTime;
+		phase.hasCpuTime_ = true;
+		++phase.count_;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddCounter(const std::string& name, uint64_t value)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto it = std::find_if(counters_.begin(), counters_.end(), [&](const Counter& counter) {
+			return counter.first == name;
+		});
+
+		if (it == counters_.end())
+			counters_.emplace_back(name, value);
+		else
+			it->second += value;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddModuleCost(const ModuleCost& cost)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto& moduleCost = GetModuleCost(cost.path_);
+
+		moduleCost.pdbSize_ = cost.pdbSize_;
+		moduleCost.registrationTime_ += cost.registrationTime_;
+		moduleCost.debugInformationTime_ += cost.debugInformationTime_;
+		moduleCost.sourceFileCount_ += cost.sourceFileCount_;
+		moduleCost.selectedSourceFileCount_ += cost.selectedSourceFileCount_;
+		moduleCost.lineCount_ += cost.lineCount_;
+		moduleCost.selectedLineCount_ += cost.selectedLineCount_;
+		moduleCost.armedBreakPointCount_ += cost.armedBreakPointCount_;
+		moduleCost.writtenBytes_ += cost.writtenBytes_;
+		++moduleCost.loadCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddHitBreakPointCount(const std::wstring& modulePath, uint64_t count)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		GetModuleCost(modulePath).hitBreakPointCount_ += count;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddDebuggeeStall(const DebuggeeStall& stall)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto it = std::find_if(debuggeeStalls_.begin(), debuggeeStalls_.end(), [&](const DebuggeeStall& debuggeeStall) {
+			return debuggeeStall.event_ == stall.event_ && debuggeeStall.modulePath_ == stall.modulePath_;
+		});
+
+		if (it == debuggeeStalls_.end())
+			debuggeeStalls_.push_back(stall);
+		else
+		{
+			it->time_ += stall.time_;
+			it->count_ += stall.count_;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddLongestDebuggeeStall(const DebuggeeStall& stall)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		longestDebuggeeStalls_.push_back(stall);
+		longestDebuggeeStalls_ = SortByDecreasingTime(std::move(longestDebuggeeStalls_));
+		if (longestDebuggeeStalls_.size() > MaxLongestStallCount)
+			longestDebuggeeStalls_.pop_back();
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::AddBreakPointStallHistogram(const std::vector<uint64_t>& histogram)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		if (breakPointStallHistogram_.size() < histogram.size())
+			breakPointStallHistogram_.resize(histogram.size());
+		for (size_t i = 0; i < histogram.size(); ++i)
+			breakPointStallHistogram_[i] += histogram[i];
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::UpdateMemoryUsage(const std::string& subsystem,
+	                                              uint64_t previousBytes,
+	                                              uint64_t bytes)
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto it = std::find_if(memoryUsages_.begin(), memoryUsages_.end(), [&](const MemoryUsage& memoryUsage) {
+			return memoryUsage.subsystem_ == subsystem;
+		});
+
+		if (it == memoryUsages_.end())
+			it = memoryUsages_.insert(memoryUsages_.end(), {subsystem, 0, 0});
+		it->finalBytes_ += bytes;
+		it->finalBytes_ -= (std::min)(previousBytes, it->finalBytes_);
+		it->peakBytes_ = (std::max)(it->peakBytes_, it->finalBytes_);
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::Phase> PerformanceStatistics::GetPhases() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return phases_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::Counter> PerformanceStatistics::GetCounters() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return counters_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::ModuleCost> PerformanceStatistics::GetModuleCosts() const
+	{
+		std::unique_lock<std::mutex> lock{mutex_};
+		auto moduleCosts = moduleCosts_;
+
+		lock.unlock();
+		std::stable_sort(moduleCosts.begin(), moduleCosts.end(), [](const ModuleCost& cost1, const ModuleCost& cost2) {
+			return cost1.registrationTime_ > cost2.registrationTime_;
+		});
+		return moduleCosts;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::MemoryUsage> PerformanceStatistics::GetMemoryUsages() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return memoryUsages_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::DebuggeeStall> PerformanceStatistics::GetDebuggeeStalls() const
+	{
+		std::unique_lock<std::mutex> lock{mutex_};
+		auto debuggeeStalls = debuggeeStalls_;
+
+		lock.unlock();
+		return SortByDecreasingTime(std::move(debuggeeStalls));
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<PerformanceStatistics::DebuggeeStall> PerformanceStatistics::GetLongestDebuggeeStalls() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return longestDebuggeeStalls_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<uint64_t> PerformanceStatistics::GetBreakPointStallHistogram() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return breakPointStallHistogram_;
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::WriteTable(std::wostream& ostr) const
+	{
+		const int nameWidth = 44;
+		const int valueWidth = 12;
+
+		ostr << std::left << std::setw(nameWidth) << L"Phase" << std::right
+		     << std::setw(valueWidth) << L"Wall (ms)" << std::setw(valueWidth) << L"CPU (ms)"
+		     << std::setw(valueWidth) << L"Count" << std::endl;
+		ostr << std::fixed << std::setprecision(1);
+		for (const auto& phase : GetPhases())
+		{
+			ostr << std::left << std::setw(nameWidth) << Tools::LocalToWString(phase.name_) << std::right
+			     << std::setw(valueWidth) << Milliseconds{phase.wallTime_}.count() << std::setw(valueWidth);
+			if (phase.hasCpuTime_)
+				ostr << Milliseconds{phase.cpuTime_}.count();
+			else
+				ostr << L"-";
+			ostr << std::setw(valueWidth) << phase.count_ << std::endl;
+		}
+		ostr << std::endl << std::left << std::setw(nameWidth) << L"Counter" << std::right
+		     << std::setw(valueWidth) << L"Value" << std::endl;
+		for (const auto& counter : GetCounters())
+		{
+			ostr << std::left << std::setw(nameWidth) << Tools::LocalToWString(counter.first)
+			     << std::right << std::setw(valueWidth) << counter.second << std::endl;
+		}
+
+		auto memoryUsages = GetMemoryUsages();
+		if (!memoryUsages.empty())
+		{
+			ostr << std::endl << std::left << std::setw(nameWidth) << L"Memory" << std::right
+			     << std::setw(valueWidth) << L"Peak (KB)" << std::setw(valueWidth) << L"Final (KB)" << std::endl;
+			for (const auto& memoryUsage : memoryUsages)
+			{
+				ostr << std::left << std::setw(nameWidth) << Tools::LocalToWString(memoryUsage.subsystem_)
+				     << std::right << std::setw(valueWidth) << memoryUsage.peakBytes_ / 1024
+				     << std::setw(valueWidth) << memoryUsage.finalBytes_ / 1024 << std::endl;
+			}
+		}
+
+		auto debuggeeStalls = GetDebuggeeStalls();
+		if (!debuggeeStalls.empty())
+		{
+			auto totalStall = Clock::duration::zero();
+			uint64_t totalCount = 0;
+			for (const auto& stall : debuggeeStalls)
+			{
+				if (stall.modulePath_.empty())
+				{
+					totalStall += stall.time_;
+					totalCount += stall.count_;
+				}
+			}
+			ostr << std::endl << std::left << std::setw(nameWidth) << L"Debuggee stall" << std::right
+			     << std::setw(valueWidth) << L"Wall (ms)" << std::setw(valueWidth) << L"Count" << std::endl;
+			ostr << std::left << std::setw(nameWidth) << L"Total" << std::right << std::setw(valueWidth)
+			     << Milliseconds{totalStall}.count() << std::setw(valueWidth) << totalCount << std::endl;
+			for (const auto& stall : debuggeeStalls)
+			{
+				ostr << std::left << std::setw(nameWidth) << GetStallName(stall) << std::right
+				     << std::setw(valueWidth) << Milliseconds{stall.time_}.count()
+				     << std::setw(valueWidth) << stall.count_ << std::endl;
+			}
+			ostr << std::endl << std::left << std::setw(nameWidth) << L"Longest stall" << std::right
+			     << std::setw(valueWidth) << L"Wall (ms)" << std::endl;
+			for (const auto& stall : GetLongestDebuggeeStalls())
+			{
+				ostr << std::left << std::setw(nameWidth) << GetStallName(stall) << std::right
+				     << std::setw(valueWidth) << Milliseconds{stall.time_}.count() << std::endl;
+			}
+		}
+
+		auto histogram = GetBreakPointStallHistogram();
+		if (std::any_of(histogram.begin(), histogram.end(), [](uint64_t count) { return count != 0; }))
+		{
+			ostr << std::endl << std::left << std::setw(nameWidth) << L"Breakpoint stall" << std::right
+			     << std::setw(valueWidth) << L"Count" << std::endl;
+			for (size_t i = 0; i < histogram.size(); ++i)
+			{
+				if (!histogram[i])
+					continue;
+				auto bucket = i + 1 < histogram.size()
+				                  ? L"< " + std::to_wstring(uint64_t{1} << i) + L" us"
+				                  : L">= " + std::to_wstring(uint64_t{1} << (i - 1)) + L" us";
+				ostr << std::left << std::setw(nameWidth) << bucket << std::right
+				     << std::setw(valueWidth) << histogram[i] << std::endl;
+			}
+		}
+
+		auto moduleCosts = GetModuleCosts();
+		if (moduleCosts.empty())
+			return;
+		ostr << std::endl << std::left << std::setw(nameWidth) << L"Module" << std::right
+		     << std::setw(valueWidth) << L"Reg. (ms)" << std::setw(valueWidth) << L"Debug (ms)"
+		     << std::setw(valueWidth) << L"PDB (KB)" << std::setw(valueWidth) << L"Files"
+		     << std::setw(valueWidth) << L"Lines" << std::setw(valueWidth) << L"Armed"
+		     << std::setw(valueWidth) << L"Hit" << std::setw(valueWidth) << L"Written" << std::endl;
+		for (const auto& moduleCost : moduleCosts)
+		{
+			ostr << std::left << std::setw(nameWidth)
+			     << std::filesystem::path{moduleCost.path_}.filename().wstring() << std::right
+			     << std::setw(valueWidth) << Milliseconds{moduleCost.registrationTime_}.count()
+			     << std::setw(valueWidth) << Milliseconds{moduleCost.debugInformationTime_}.count()
+			     << std::setw(valueWidth) << moduleCost.pdbSize_ / 1024
+			     << std::setw(valueWidth) << FormatRatio(moduleCost.selectedSourceFileCount_, moduleCost.sourceFileCount_)
+			     << std::setw(valueWidth) << FormatRatio(moduleCost.selectedLineCount_, moduleCost.lineCount_)
+			     << std::setw(valueWidth) << moduleCost.armedBreakPointCount_
+			     << std::setw(valueWidth) << moduleCost.hitBreakPointCount_
+			     << std::setw(valueWidth) << moduleCost.writtenBytes_ << std::endl;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void PerformanceStatistics::WriteJson(std::ostream& ostr) const
+	{
+		auto phases = GetPhases();
+		auto counters = GetCounters();
+		auto moduleCosts = GetModuleCosts();
+		auto memoryUsages = GetMemoryUsages();
+
+		ostr << "{\n  \"phases\": [";
+		for (size_t i = 0; i < phases.size(); ++i)
+		{
+			const auto& phase = phases[i];
+
+			ostr << (i ? ",\n" : "\n") << "    {\"name\": ";
+			WriteJsonString(ostr, phase.name_);
+			ostr << ", \"wallMs\": " << Milliseconds{phase.wallTime_}.count() << ", \"cpuMs\": ";
+			if (phase.hasCpuTime_)
+				ostr << Milliseconds{phase.cpuTime_}.count();
+			else
+				ostr << "null";
+			ostr << ", \"count\": " << phase.count_ << "}";
+		}
+		ostr << "\n  ],\n  \"counters\": {";
+		for (size_t i = 0; i < counters.size(); ++i)
+		{
+			ostr << (i ? ",\n" : "\n") << "    ";
+			WriteJsonString(ostr, counters[i].first);
+			ostr << ": " << counters[i].second;
+		}
+		ostr << "\n  },\n  \"modules\": [";
+		for (size_t i = 0; i < moduleCosts.size(); ++i)
+		{
+			const auto& moduleCost = moduleCosts[i];
+
+			ostr << (i ? ",\n" : "\n") << "    {\"path\": ";
+			WriteJsonString(ostr, Tools::ToUtf8String(moduleCost.path_));
+			ostr << ", \"registrationMs\": " << Milliseconds{moduleCost.registrationTime_}.count()
+			     << ", \"debugInformationMs\": " << Milliseconds{moduleCost.debugInformationTime_}.count()
+			     << ", \"pdbSize\": " << moduleCost.pdbSize_
+			     << ", \"sourceFiles\": " << moduleCost.sourceFileCount_
+			     << ", \"selectedSourceFiles\": " << moduleCost.selectedSourceFileCount_
+			     << ", \"lines\": " << moduleCost.lineCount_
+			     << ", \"selectedLines\": " << moduleCost.selectedLineCount_
+			     << ", \"breakpointsArmed\": " << moduleCost.armedBreakPointCount_
+			     << ", \"breakpointsHit\": " << moduleCost.hitBreakPointCount_
+			     << ", \"bytesWritten\": " << moduleCost.writtenBytes_
+			     << ", \"loads\": " << moduleCost.loadCount_ << "}";
+		}
+		ostr << "\n  ],\n  \"memory\": [";
+		for (size_t i = 0; i < memoryUsages.size(); ++i)
+		{
+			ostr << (i ? ",\n" : "\n") << "    {\"subsystem\": ";
+			WriteJsonString(ostr, memoryUsages[i].subsystem_);
+			ostr << ", \"peakBytes\": " << memoryUsages[i].peakBytes_
+			     << ", \"finalBytes\": " << memoryUsages[i].finalBytes_ << "}";
+		}
+		ostr << "\n  ],\n  \"debuggeeStalls\": [";
+		WriteJsonStalls(ostr, GetDebuggeeStalls());
+		ostr << "\n  ],\n  \"longestDebuggeeStalls\": [";
+		WriteJsonStalls(ostr, GetLongestDebuggeeStalls());
+		// Bucket i counts the breakpoints handled in less than 2^i us.
+		ostr << "\n  ],\n  \"breakpointStallHistogram\": [";
+		auto histogram = GetBreakPointStallHistogram();
+		for (size_t i = 0; i < histogram.size(); ++i)
+			ostr << (i ? ", " : "") << histogram[i];
+		ostr << "]\n}\n";
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::Phase& PerformanceStatistics::GetPhase(const std::string& name)
+	{
+		auto it = std::find_if(phases_.begin(), phases_.end(), [&](const Phase& phase) {
+			return phase.name_ == name;
+		});
+
+		if (it != phases_.end())
+			return *it;
+		phases_.push_back({name, Clock::duration::zero(), Clock::duration::zero(), false, 0});
+		return phases_.back();
+	}
+
+	//-------------------------------------------------------------------------
+	PerformanceStatistics::ModuleCost& PerformanceStatistics::GetModuleCost(const std::wstring& modulePath)
+	{
+		auto it = std::find_if(moduleCosts_.begin(), moduleCosts_.end(), [&](const ModuleCost& moduleCost) {
+			return moduleCost.path_ == modulePath;
+		});
+
+		if (it != moduleCosts_.end())
+			return *it;
+		moduleCosts_.push_back({});
+		moduleCosts_.back().path_ = modulePath;
+		return moduleCosts_.back();
+	}
+}
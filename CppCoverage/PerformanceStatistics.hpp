@@ -0,0 +1,196 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	// Wall and CPU times of the phases of a run and counters, for --perf_stats.
+	// The times of a phase measured several times are added. The CPU time is
+	// the time of the whole process, including the threads working in
+	// parallel. Can be used from several threads.
+	class CPPCOVERAGE_DLL PerformanceStatistics
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Phase
+		{
+			std::string name_;
+			Clock::duration wallTime_;
+			Clock::duration cpuTime_;
+			bool hasCpuTime_;
+			size_t count_;
+		};
+
+		using Counter = std::pair<std::string, uint64_t>;
+
+		// Counters of a run under the debugger.
+		static const std::string DebugEventsCounterPrefix;
+		static const std::string ArmedBreakPointsCounter;
+		static const std::string HitBreakPointsCounter;
+
+		// Cost of the registration of a module. The loads of a module are
+		// added.
+		struct ModuleCost
+		{
+			std::wstring path_;
+			// 0 when the PDB is not found next to the module.
+			uintmax_t pdbSize_;
+			// The debuggee is blocked during the registration.
+			Clock::duration registrationTime_;
+			// Part of the registration reading the debug information and
+			// filtering the lines.
+			Clock::duration debugInformationTime_;
+			size_t sourceFileCount_;
+			size_t selectedSourceFileCount_;
+			size_t lineCount_;
+			size_t selectedLineCount_;
+			uint64_t armedBreakPointCount_;
+			uint64_t hitBreakPointCount_;
+			uint64_t writtenBytes_;
+			size_t loadCount_;
+		};
+
+		// Time the debug events stall the debuggee. The stalls of an event
+		// type have no module path, the ones of the DLL loads are also
+		// grouped by module.
+		struct DebuggeeStall
+		{
+			std::string event_;
+			std::wstring modulePath_;
+			Clock::duration time_;
+			uint64_t count_;
+		};
+
+		static const size_t MaxLongestStallCount = 10;
+
+		// Estimated bytes of the structures of a subsystem. The structures of
+		// the runs in parallel are added.
+		struct MemoryUsage
+		{
+			std::string subsystem_;
+			uint64_t peakBytes_;
+			// Last reported bytes.
+			uint64_t finalBytes_;
+		};
+
+		// Report the size of a structure to its subsystem each time it
+		// changes. Nothing is reported when statistics is null.
+		class CPPCOVERAGE_DLL MemoryTracker
+		{
+		public:
+			MemoryTracker(PerformanceStatistics* statistics, const char* subsystem);
+
+			void Update(uint64_t bytes);
+
+		private:
+			MemoryTracker(const MemoryTracker&) = delete;
+			MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+			PerformanceStatistics* statistics_;
+			const char* subsystem_;
+			uint64_t bytes_;
+		};
+
+		// Measure the time until its destruction. Nothing is measured when
+		// statistics is null.
+		class CPPCOVERAGE_DLL ScopedPhase
+		{
+		public:
+			ScopedPhase(PerformanceStatistics* statistics,
+			            const char* name,
+			            bool measureCpuTime = true);
+			~ScopedPhase();
+
+		private:
+			ScopedPhase(const ScopedPhase&) = delete;
+			ScopedPhase& operator=(const ScopedPhase&) = delete;
+
+			PerformanceStatistics* statistics_;
+			const char* name_;
+			bool measureCpuTime_;
+			Clock::time_point start_;
+			Clock::duration cpuStart_;
+		};
+
+		PerformanceStatistics() = default;
+
+		static Clock::duration GetProcessCpuTime();
+		// Wall time since the creation of the current process.
+		static Clock::duration GetProcessUpTime();
+		static uint64_t GetMemoryUsage(const Plugin::CoverageData&);
+
+		void AddPhase(const std::string& name, Clock::duration wallTime);
+		void AddPhase(const std::string& name, Clock::duration wallTime, Clock::duration cpuTime);
+		void AddCounter(const std::string& name, uint64_t value);
+		// loadCount_ and hitBreakPointCount_ are ignored.
+		void AddModuleCost(const ModuleCost&);
+		void AddHitBreakPointCount(const std::wstring& modulePath, uint64_t count);
+		// The stalls with the same event and module are added.
+		void AddDebuggeeStall(const DebuggeeStall&);
+		// Keep the MaxLongestStallCount longest single events.
+		void AddLongestDebuggeeStall(const DebuggeeStall&);
+		// Bucket i counts the breakpoints handled in less than 2^i us, the
+		// last bucket counts the others.
+		void AddBreakPointStallHistogram(const std::vector<uint64_t>&);
+		// A structure of subsystem goes from previousBytes to bytes.
+		void UpdateMemoryUsage(const std::string& subsystem, uint64_t previousBytes, uint64_t bytes);
+
+		std::vector<Phase> GetPhases() const;
+		std::vector<Counter> GetCounters() const;
+		// Sorted by decreasing registration time.
+		std::vector<ModuleCost> GetModuleCosts() const;
+		std::vector<MemoryUsage> GetMemoryUsages() const;
+		// Sorted by decreasing time.
+		std::vector<DebuggeeStall> GetDebuggeeStalls() const;
+		std::vector<DebuggeeStall> GetLongestDebuggeeStalls() const;
+		std::vector<uint64_t> GetBreakPointStallHistogram() const;
+
+		void WriteTable(std::wostream&) const;
+		void WriteJson(std::ostream&) const;
+
+	private:
+		PerformanceStatistics(const PerformanceStatistics&) = delete;
+		PerformanceStatistics& operator=(const PerformanceStatistics&) = delete;
+
+		Phase& GetPhase(const std::string& name);
+		ModuleCost& GetModuleCost(const std::wstring& modulePath);
+
+		mutable std::mutex mutex_;
+		std::vector<Phase> phases_;
+		std::vector<Counter> counters_;
+		std::vector<ModuleCost> moduleCosts_;
+		std::vector<MemoryUsage> memoryUsages_;
+		std::vector<DebuggeeStall> debuggeeStalls_;
+		std::vector<DebuggeeStall> longestDebuggeeStalls_;
+		std::vector<uint64_t> breakPointStallHistogram_;
+	};
+}
@@ -18,10 +18,13 @@
 #include "Process.hpp"
 
 #include <Windows.h>
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include "Tools/Log.hpp"
 #include "Tools/Tool.hpp"
+#include "Tools/ScopedAction.hpp"
 
 #include "StartInfo.hpp"
 #include "CppCoverageException.hpp"
@@ -52,7 +55,40 @@ namespace CppCoverage
 			}
 
 			return commandLine;
-		}		
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<std::vector<wchar_t>>
+			CreateEnvironmentBlock(const StartInfo::EnvironmentVariables& variables)
+		{
+			if (variables.empty())
+				return boost::none;
+
+			auto* environmentStrings = GetEnvironmentStringsW();
+			if (!environmentStrings)
+				THROW_LAST_ERROR("Error in GetEnvironmentStrings:", GetLastError());
+			Tools::ScopedAction scopedAction{ [=]{ FreeEnvironmentStringsW(environmentStrings); } };
+
+			// Variables of the current environment are kept unless they are redefined.
+			std::vector<wchar_t> block;
+			for (const auto* str = environmentStrings; *str; str += wcslen(str) + 1)
+			{
+				std::wstring variable = str;
+				auto isRedefined = std::any_of(variables.begin(), variables.end(),
+					[&](const auto& pair) {
+						return boost::algorithm::istarts_with(variable, pair.first + L'=');
+					});
+				if (!isRedefined)
+					block.insert(block.end(), variable.c_str(), variable.c_str() + variable.size() + 1);
+			}
+			for (const auto& pair : variables)
+			{
+				auto variable = pair.first + L'=' + pair.second;
+				block.insert(block.end(), variable.c_str(), variable.c_str() + variable.size() + 1);
+			}
+			block.push_back(L'\0');
+			return block;
+		}
 	}
 
 	const std::wstring Process::CannotFindPathMessage = L"Cannot find path: ";
@@ -92,6 +128,9 @@ namespace CppCoverage
 		const auto* workindDirectory = startInfo_.GetWorkingDirectory();
 		auto optionalCommandLine = CreateCommandLine(startInfo_.GetArguments());
 		auto commandLine = (optionalCommandLine) ? &(*optionalCommandLine)[0] : nullptr;
+		auto optionalEnvironment = CreateEnvironmentBlock(startInfo_.GetEnvironmentVariables());
+		if (optionalEnvironment)
+			creationFlags |= CREATE_UNICODE_ENVIRONMENT;
 
 		processInformation_ = PROCESS_INFORMATION{};
 		if (!CreateProcess(
@@ -101,7 +140,7 @@ namespace CppCoverage
 			nullptr,
 			FALSE,
 			creationFlags,
-			nullptr,
+			(optionalEnvironment) ? optionalEnvironment->data() : nullptr,
 			(workindDirectory) ? workindDirectory->c_str() : nullptr,
 			&lpStartupInfo,
 			&processInformation_.get()
@@ -127,4 +166,37 @@ namespace CppCoverage
 			throw std::runtime_error(Tools::ToLocalString(ostr.str()));
 		}		
 	}
+
+	//-------------------------------------------------------------------------
+	const PROCESS_INFORMATION& Process::GetProcessInformation() const
+	{
+		if (!processInformation_)
+			THROW(L"Process is not started");
+		return *processInformation_;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::filesystem::path> Process::GetImagePath(DWORD processId)
+	{
+		auto hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+
+		if (!hProcess)
+			return boost::none;
+
+		Tools::ScopedAction scopedAction{ [hProcess]{ CloseHandle(hProcess); } };
+		std::vector<wchar_t> buffer(PathBufferSize);
+		auto size = static_cast<DWORD>(buffer.size());
+
+		if (!QueryFullProcessImageNameW(hProcess, 0, buffer.data(), &size))
+			return boost::none;
+		return std::filesystem::path{std::wstring(buffer.data(), size)};
+	}
+
+	//-------------------------------------------------------------------------
+	bool Process::Is64Bits(HANDLE hProcess)
+	{
+		BOOL isWow64 = FALSE;
+		IsWow64Process(hProcess, &isWow64);
+		return sizeof(void*) == 8 && !isWow64;
+	}
 }
@@ -30,10 +30,17 @@ namespace CppCoverage
 		static const std::wstring CannotFindPathMessage;
 		static const std::wstring CheckIfValidExecutableMessage;
 
+		// boost::none if the process cannot be opened.
+		static boost::optional<std::filesystem::path> GetImagePath(DWORD processId);
+
+		// True for a native 64 bits process, false for a 32 bits or a WOW64 one.
+		static bool Is64Bits(HANDLE hProcess);
+
 		Process(const StartInfo& startInfo);
 		~Process();
 		
 		void Start(DWORD creationFlags);
+		const PROCESS_INFORMATION& GetProcessInformation() const;
 
 	private:
 		Process(const Process&) = delete;
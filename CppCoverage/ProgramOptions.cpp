@@ -18,6 +18,7 @@
 #include "ProgramOptions.hpp"
 
 #include "Tools/Tool.hpp"
+#include "CoverageRuntime/RuntimeSharedData.hpp"
 
 #include "CppCoverageException.hpp"
 #include "OptionsParser.hpp"
@@ -75,9 +76,15 @@ namespace CppCoverage
 				"The pattern that source's paths should NOT match. Can have multiple occurrences.")
 				(ProgramOptions::InputCoverageValue.c_str(), po::value<T_Strings>()->composing(),
 				("A output path of " + ExportOptionParser::ExportTypeOption + "=" + ExportOptionParser::ExportTypeBinaryValue +
-				". This coverage data will be merged with the current one. Can have multiple occurrences.").c_str())
+				", a Cobertura XML report or an LCOV tracefile. This coverage data will be merged with the current one. "
+				"Can have multiple occurrences.").c_str())
 				(ProgramOptions::WorkingDirectoryOption.c_str(), po::value<std::string>(), "The program working directory.")
 				(ProgramOptions::CoverChildrenOption.c_str(), "Enable code coverage for children processes.")
+				(ProgramOptions::SelectedChildrenOption.c_str(), po::value<T_Strings>()->composing(),
+					("The pattern that children executable's paths should match. The other children are not "
+					"debugged. Requires --" + ProgramOptions::CoverChildrenOption + ". Can have multiple occurrences.").c_str())
+				(ProgramOptions::ExcludedChildrenOption.c_str(), po::value<T_Strings>()->composing(),
+					"The pattern that children executable's paths should NOT match. Can have multiple occurrences.")
 				(ProgramOptions::NoAggregateByFileOption.c_str(), "Do not aggregate coverage for same file path.")
                 (ProgramOptions::StopOnAssertOption.c_str(), "Do not continue after DebugBreak() or assert().")
               (ProgramOptions::UnifiedDiffOption.c_str(),
@@ -87,9 +94,307 @@ namespace CppCoverage
 					"Enable heuristics to support optimized build. See documentation for restrictions.")
 				(ProgramOptions::ExcludedLineRegexOption.c_str(), po::value<T_Strings>()->composing(),
 					"Exclude all lines match the regular expression. Regular expression must match the whole line.")
+				(ProgramOptions::ExcludedLineMarkerOption.c_str(), po::value<std::string>(),
+					"Exclude all lines which contain this text, for example COVERAGE_EXCL_LINE.")
+				(ProgramOptions::ExcludedRegionMarkersOption.c_str(), po::value<std::string>(),
+					"Exclude all lines from the one which contains the start text to the one which contains the stop text."
+					"\nFormat: <start>?<stop>, for example COVERAGE_EXCL_START?COVERAGE_EXCL_STOP.")
 				(ProgramOptions::SubstitutePdbSourcePathOption.c_str(), po::value<T_Strings>()->composing(),
 					"Substitute the starting path defined in the pdb by a local path.\nFormat: <pdbStartPath>?<localPath>. " 
-					"Can have multiple occurrences.");
+					"Can have multiple occurrences.")
+				(ProgramOptions::InProcessAgentOption.c_str(),
+					"Handle breakpoints inside the program with an injected agent instead of a debugger. "
+					"Faster, but children processes and C++ exception options are not supported.")
+				(ProgramOptions::BasicBlockBreakPointsOption.c_str(),
+					"Set a breakpoint only at the first line of each basic block instead of each line. "
+					"Reduce the number of breakpoints, but a line can be reported as executed when an exception "
+					"is thrown before it.")
+				(ProgramOptions::DominatorBreakPointsOption.c_str(),
+					("Same as --" + ProgramOptions::BasicBlockBreakPointsOption + " but a basic block "
+					"has no breakpoint when it always leads to run a later block it dominates: its lines are "
+					"reported as executed with the lines of that block.").c_str())
+				(ProgramOptions::EagerLineDisarmOption.c_str(),
+					"Remove the breakpoints of the other addresses of a line when one of them is hit, for example "
+					"the template instantiations and the inlined calls. They are removed together at the next "
+					"breakpoint. Reduce the number of breakpoints hit, but the hit counts of the lines are lower.")
+				(ProgramOptions::LazyBreakPointsOption.c_str(),
+					"Set the line breakpoints of a function only when the function is called for the first time. "
+					"Reduce the module loading time for big modules.")
+				(ProgramOptions::PageGuardBreakPointsOption.c_str(),
+					"Guard the code pages instead of setting breakpoints at module loading. "
+					"The breakpoints of a page are set when the page is accessed for the first time so "
+					"pages which are never run stay shared between processes.")
+				(ProgramOptions::BaselineArmingOption.c_str(),
+					"Do not set breakpoints on the lines already executed in the --input_coverage files. "
+					"Use it when only the union with these files is needed.")
+				(ProgramOptions::RefilterInputCoverageOption.c_str(),
+					"Apply the module, source, unified diff and excluded line filters to the --input_coverage files "
+					"so that a report with other filters does not require to run the programs again.")
+				(ProgramOptions::InputCoverageDiffOption.c_str(), po::value<std::string>(),
+					("Unified diff from the revision of the sources of the --" + ProgramOptions::InputCoverageValue +
+					" files to the current one. Their lines are moved to their number in the current revision and "
+					"the removed lines are dropped, so they can be merged with a run of the current revision.\n" +
+					GetUnifiedDiffHelp()).c_str())
+				(ProgramOptions::IncrementalHtmlOption.c_str(),
+					"Update the HTML report in its folder: only the pages whose source file, coverage or template "
+					"changed since the last export with this option are written.")
+				(ProgramOptions::ReportCompressionOption.c_str(), po::value<std::string>(),
+					("Compression of the reports: " + ProgramOptions::ReportCompressionZipValue + " or " +
+					ProgramOptions::ReportCompressionGzipValue + ". With " + ProgramOptions::ReportCompressionZipValue +
+					", the HTML reports are written in a single <folder>.zip archive. With " +
+					ProgramOptions::ReportCompressionGzipValue + ", each page is written as <page>.gz with a manifest. "
+					"The cobertura and first hits reports are replaced by <file>.zip or <file>.gz.").c_str())
+				(ProgramOptions::HtmlAssetsFolderOption.c_str(), po::value<std::string>(),
+					"Share the scripts and styles of the HTML reports in this folder instead of copying them in each "
+					"report. They are copied once in a sub folder named by their content.")
+				(ProgramOptions::HtmlShardOption.c_str(), po::value<std::string>(),
+					("Render only a part of the HTML report so several machines can share it: <index>/<count> "
+					"renders one page of count, " + ProgramOptions::HtmlShardIndexValue + " renders index.html "
+					"and copies the third-party files. All the shards must export the same coverage in the same "
+					"folder.").c_str())
+				(ProgramOptions::CoberturaPackagesByFileOption.c_str(), po::value<unsigned int>(),
+					"Split the cobertura report in files of this number of packages (modules) named "
+					"<report>-<index>.xml. The report file only contains the coverage of the packages "
+					"without their classes.")
+				(ProgramOptions::CoverageLevelOption.c_str(), po::value<std::string>(),
+					("Granularity of the coverage: " + ProgramOptions::CoverageLevelLineValue + " (default) or " +
+					ProgramOptions::CoverageLevelFunctionValue + ". With " + ProgramOptions::CoverageLevelFunctionValue +
+					", only the function entries have a breakpoint and each function is reported as "
+					"the line of its entry.").c_str())
+				(ProgramOptions::SamplingTrapsPerSecondOption.c_str(), po::value<unsigned int>(),
+					"Set again the breakpoints already hit to estimate how many times each line is executed. "
+					"The value is the maximum number of these breakpoints hit by second. "
+					"Hit counts are exported with cobertura format.")
+				(ProgramOptions::AdaptiveArmingOption.c_str(), po::value<unsigned int>(),
+					"Maximum number of breakpoints hit by second. When it is exceeded, the functions "
+					"with the most hits keep one breakpoint by basic block for their lines not executed yet. "
+					"The other functions keep one breakpoint by line.")
+				(ProgramOptions::CoverageRegionMarkersOption.c_str(),
+					"Arm the breakpoints only between the \"OpenCppCoverage: begin coverage\" "
+					"and \"OpenCppCoverage: end coverage\" strings sent by OutputDebugString. "
+					"Code outside of these markers is not covered and runs at native speed.")
+				(ProgramOptions::FuzzOption.c_str(),
+					"Publish the breakpoints hit by each fuzzing iteration in a shared memory bitmap. "
+					"An iteration ends when the \"OpenCppCoverage: fuzzing iteration\" string is sent by "
+					"OutputDebugString and \"OpenCppCoverage: fuzzing epoch\" sets again the breakpoints "
+					"hit since the previous epoch. See CppCoverage/FuzzingHarness.hpp.")
+				(ProgramOptions::IntelPtOption.c_str(),
+					"Collect the coverage with Intel Processor Trace instead of breakpoints. "
+					"The breakpoints are used when the processor or Windows does not support it.")
+				(ProgramOptions::TrampolinesOption.c_str(),
+					"Replace the breakpoints by jumps to trampolines counting the hits in the memory "
+					"of the process. The lines are reported with their exact hit count. Breakpoints "
+					"are used for the lines whose code cannot be relocated.")
+				(ProgramOptions::EtwSamplingOption.c_str(),
+					"Approximate the coverage by sampling the instruction pointers with the ETW "
+					"kernel logger instead of breakpoints. The lines not sampled are reported as "
+					"not executed and the hit counts are sample counts. Require the administrator "
+					"rights; the breakpoints are used when the kernel logger cannot be started.")
+				(ProgramOptions::TestImpactIndexOption.c_str(), po::value<std::string>(),
+					"Write the lines executed by each test to this file. A test ends when the "
+					"\"OpenCppCoverage: end test <name>\" string is sent by OutputDebugString, "
+					"for example from a test framework listener.")
+				(ProgramOptions::SelectTestsOption.c_str(), po::value<std::string>(),
+					("Print the tests of this --" + ProgramOptions::TestImpactIndexOption +
+					" file which execute a line changed by --" + ProgramOptions::UnifiedDiffOption +
+					". No program is run.").c_str())
+				(ProgramOptions::CompareCoverageOption.c_str(), po::value<std::string>(),
+					("Compare the two --" + ProgramOptions::InputCoverageValue + " files and write to this file "
+					"the lines executed only by the second one (+) and only by the first one (-). No program is run.").c_str())
+				(ProgramOptions::AutoDetachOption.c_str(), po::value<unsigned int>(),
+					"Detach the debugger from a process when all its breakpoints are hit or when "
+					"no new line is executed during this number of seconds. The process then runs "
+					"at native speed but the modules loaded after the detach are not covered.")
+				(ProgramOptions::AttachOption.c_str(), po::value<unsigned int>(),
+					"Cover the already running process with this id instead of starting a program. "
+					"The process keeps running if OpenCppCoverage stops.")
+				(ProgramOptions::DebugStringsOption.c_str(), po::value<std::string>(),
+					("Handling of the OutputDebugString strings: " + ProgramOptions::DebugStringsDropValue +
+					" or " + ProgramOptions::DebugStringsCountValue + ". The strings are not read from the program, "
+					"which is faster when it sends many of them.").c_str())
+				(ProgramOptions::DebugStringsFileOption.c_str(), po::value<std::string>(),
+					"Write the OutputDebugString strings to this file. The file is written by a background thread.")
+				(ProgramOptions::RecordDebugEventsOption.c_str(), po::value<std::string>(),
+					"Write the debug events of the run to this file: module loads, exceptions and process exits.")
+				(ProgramOptions::ReplayDebugEventsOption.c_str(), po::value<std::string>(),
+					"Replay the debug events of this file written by --record_debug_events instead of starting the program, "
+					"to measure the coverage engine alone. The modules must not have changed since the recording.")
+				(ProgramOptions::DebugHeapOption.c_str(),
+					"Keep the Windows debug heap enabled for processes started by the debugger. By default, _NO_DEBUG_HEAP=1 is set "
+					"because the debug heap makes allocations much slower.")
+				(ProgramOptions::AsyncModulesOption.c_str(),
+					"Register the modules on a worker thread: the program continues while the debug information is read. "
+					"On Windows 10 and later, only the thread loading a DLL waits for its registration. Otherwise, and for "
+					"the program itself, the code executed before a module is registered is not covered.")
+				(ProgramOptions::ProgramsOption.c_str(), po::value<std::string>(),
+					"Cover the programs of this file instead of a single program: one program path followed by its "
+					"arguments per line. The programs are run in parallel and their coverages are merged.")
+				(ProgramOptions::ShardsOption.c_str(), po::value<unsigned int>(),
+					"Run the Google Test program as this number of shards in parallel: GTEST_TOTAL_SHARDS and "
+					"GTEST_SHARD_INDEX are set for each shard and their coverages are merged.")
+				(ProgramOptions::JobsOption.c_str(), po::value<unsigned int>(),
+					("Number of programs of --" + ProgramOptions::ProgramsOption + " or shards of --" +
+					ProgramOptions::ShardsOption +
+					" covered at the same time. Default is the number of logical processors.").c_str())
+				(ProgramOptions::ServiceOption.c_str(), po::value<std::string>(),
+					("Run as a service on the named pipe \\\\.\\pipe\\<name> and cover the command lines sent by --" +
+					ProgramOptions::UseServiceOption + ". The debug information already read is kept between "
+					"the runs. No program is run.").c_str())
+				(ProgramOptions::UseServiceOption.c_str(), po::value<std::string>(),
+					("Send this command line to the service started with --" + ProgramOptions::ServiceOption +
+					" <name> and wait for the end of the run. The service writes the exports but uses its own "
+					"environment and log.").c_str())
+				(ProgramOptions::QueryServiceOption.c_str(), po::value<std::string>(),
+					("Answer on the named pipe \\\\.\\pipe\\<name> the coverage of a source file and the modules "
+					"containing it from the --" + ProgramOptions::InputCoverageValue + " binary file, for an IDE. "
+					"No program is run.").c_str())
+				(ProgramOptions::OutOfProcessPluginsOption.c_str(),
+					("Run each export plugin in its own process. The coverage is written once in a shared memory "
+					"section that the plugin processes map read-only: the plugins export in parallel and an "
+					"error of a plugin does not stop the other exports. Uses --" + ProgramOptions::ExportPluginHostOption +
+					".").c_str())
+				(ProgramOptions::ExportPluginHostOption.c_str(), po::value<std::string>(),
+					("Perform the plugin exports of --" + ExportOptionParser::ExportTypeOption + " from the coverage of "
+					"the shared memory section <name>, in the process started by --" +
+					ProgramOptions::OutOfProcessPluginsOption + ". No program is run.").c_str())
+				(ProgramOptions::LineTableOption.c_str(), po::value<std::string>(),
+					"Write the selected lines of the program to execute with their RVA to this file, for a tool which "
+					"instruments the program with one counter by line. No program is run.")
+				(ProgramOptions::InstrumentedImageOption.c_str(), po::value<std::string>(),
+					("Also write to this path a copy of the program with one counter by line of the --" +
+					ProgramOptions::LineTableOption + " file. The copy needs " + CoverageRuntime::RuntimeFilename +
+					", copied next to it, and writes <path>" + Tools::ToLocalString(CoverageRuntime::CountersExtension) +
+					" for --" + ProgramOptions::InputLineCountersOption + " when it exits.").c_str())
+				(ProgramOptions::InputLineCountersOption.c_str(), po::value<T_Strings>()->composing(),
+					("Merge the counters written by a program instrumented from a --" + ProgramOptions::LineTableOption +
+					" file.\nFormat: <lineTable>?<counters> where counters has one counter of 1, 4 or 8 bytes by line "
+					"of the table. "
+					"Can have multiple occurrences.").c_str())
+				(ProgramOptions::InputSancovOption.c_str(), po::value<T_Strings>()->composing(),
+					"Merge a .sancov file written by a module built with clang-cl -fsanitize-coverage. The covered "
+					"PCs are mapped to lines with the PDB of the module.\nFormat: <module>?<sancovFile>. "
+					"Can have multiple occurrences.")
+				(ProgramOptions::CacheDirOption.c_str(), po::value<std::string>(),
+					("Folder where the caches of OpenCppCoverage are kept between the runs, the debug information "
+					"of --" + ProgramOptions::PdbCacheOption + " for example. Several runs can use it at the same "
+					"time. The least recently used files are removed above --" + ProgramOptions::CacheSizeOption + ".").c_str())
+				(ProgramOptions::CacheSizeOption.c_str(), po::value<unsigned int>(),
+					("Maximum size in MB of the --" + ProgramOptions::CacheDirOption + " folder. Default is 2048.").c_str())
+				(ProgramOptions::ResultCacheOption.c_str(),
+					("Keep the coverage of the program in the --" + ProgramOptions::CacheDirOption + " folder. "
+					"The program is not run again while its command line, the options, the program, the "
+					"--" + ProgramOptions::ResultCacheInputOption + " files and the covered modules and their "
+					"PDBs do not change. The cached coverage and exit code are used instead.").c_str())
+				(ProgramOptions::ResultCacheInputOption.c_str(), po::value<T_Strings>()->composing(),
+					("File read by the program: a change of its content runs the program again with --" +
+					ProgramOptions::ResultCacheOption + ". Can have multiple occurrences.").c_str())
+				(ProgramOptions::PdbCacheOption.c_str(), po::value<std::string>(),
+					"Folder where the lines read from the PDBs are cached between the runs. An unchanged module "
+					"does not load its PDB anymore. The runs in parallel on this machine read the PDB of a module "
+					"once: the others wait for its cache file. The modules loaded by the program are also saved: "
+					"the next run reads their lines in parallel when the program starts.")
+				(ProgramOptions::PdbCacheRemoteOption.c_str(), po::value<std::string>(),
+					("Store shared by several machines behind the --" + ProgramOptions::PdbCacheOption + " folder, "
+					"an http URL or a folder. The cache files missing in the --" + ProgramOptions::PdbCacheOption +
+					" folder are downloaded from it and the new ones are copied to it when it is a folder.").c_str())
+				(ProgramOptions::IndexPdbsOption.c_str(), po::value<std::string>(),
+					("Fill the --" + ProgramOptions::PdbCacheOption + " folder with the debug information of the "
+					"modules of this folder and its subfolders, one module by job. No program is run.").c_str())
+				(ProgramOptions::NativePdbReaderOption.c_str(),
+					"Read the line tables of the PDBs directly instead of using DIA. DIA is still used for the "
+					"PDBs which cannot be read this way: C11 line tables or PDBs not found next to the module for example.")
+				(ProgramOptions::MergeIdenticalModulesOption.c_str(),
+					"Report the copies of a module at other paths under the path of the first one loaded. The copies "
+					"have the same timestamp, size and checksum in their PE header. They always reuse the lines "
+					"selected for the first one.")
+				(ProgramOptions::SymbolServerOption.c_str(), po::value<T_Strings>()->composing(),
+					("Download the PDBs not found next to their module from this symbol server, an http URL or a "
+					"folder, into the --" + ProgramOptions::SymbolCacheOption + " folder. The PDBs of the program and "
+					"of its static imports are downloaded in parallel before they are needed. "
+					"Can have multiple occurrences.").c_str())
+				(ProgramOptions::SymbolCacheOption.c_str(), po::value<std::string>(),
+					("Folder where the PDBs downloaded from --" + ProgramOptions::SymbolServerOption +
+					" are kept between the runs.").c_str())
+				(ProgramOptions::SymbolDownloadsOption.c_str(), po::value<unsigned int>(),
+					"Number of PDBs downloaded at the same time. Default is 8.")
+				(ProgramOptions::MachineSymbolLoadsOption.c_str(), po::value<unsigned int>(),
+					"Maximum number of PDBs read at the same time by all the runs of the machine using the same "
+					("value, for many runs starting together on a build agent. The time waited is reported by --" +
+					ProgramOptions::PerfStatsOption + ".").c_str())
+				(ProgramOptions::SourceServerCacheOption.c_str(), po::value<std::string>(),
+					"Fetch the source files which are not on the disk from the source server (srcsrv) stream of the "
+					"PDBs into this folder before the export, several files at the same time. The fetched files are "
+					("kept between the runs. The files extracted by a command are fetched only when the program of the "
+					"command is allowed by --" + ProgramOptions::SourceServerCommandOption + ".").c_str())
+				(ProgramOptions::SourceServerCommandOption.c_str(), po::value<T_Strings>()->composing(),
+					("Program, such as tf.exe, allowed to run the source server commands of the PDBs for --" +
+					ProgramOptions::SourceServerCacheOption + ". The commands come from the PDBs: allow only the "
+					"programs of trusted version control systems. Can have multiple occurrences.").c_str())
+				(ProgramOptions::ModuleTimeBudgetOption.c_str(), po::value<unsigned int>(),
+					"Maximum time in milliseconds the program waits for the debug information of a module when it is "
+					"loaded. A module which takes longer is registered once its debug information is read, and the code "
+					"executed before, such as DllMain and static initializers, is not covered.")
+				(ProgramOptions::MemoryBudgetOption.c_str(), po::value<unsigned int>(),
+					"Memory in megabytes for the lines of the modules. Above it, the lines of the modules loaded by "
+					"no process are written to a temporary file until the coverage is created or the module is "
+					"loaded again.")
+				(ProgramOptions::BinaryBaselineOption.c_str(), po::value<std::string>(),
+					"Write the binary exports as a delta relative to this binary coverage file: only the lines whose "
+					"executed state differs are stored. The delta is read with this file, which must not change.")
+				(ProgramOptions::BinaryLineTablesOption.c_str(), po::value<std::string>(),
+					"Write the binary exports as the executed lines only. The lines, which are the same for all the runs "
+					"of a build, are written once in a line table of this folder.")
+				(ProgramOptions::BinaryCompressionOption.c_str(),
+					"Compress each module of the binary exports in an independent frame. The modules are encoded "
+					"and read back on several threads.")
+				(ProgramOptions::DeterministicOption.c_str(),
+					("Write the same exports for the same coverage: the modules and the files are sorted by path, "
+					"the exports have no timestamp, the zip entries are sorted by name and the first hits, which "
+					"depend on the scheduling of the threads, are removed. Cannot be used with the first_hits "
+					"export or --" + ProgramOptions::IncrementalHtmlOption + ".").c_str())
+				(ProgramOptions::CoverageJournalOption.c_str(), po::value<std::string>(),
+					("Append periodically the lines newly registered and executed to this journal so that the coverage "
+					"is kept if OpenCppCoverage is killed. The journal can be used with --" +
+					ProgramOptions::InputCoverageValue + ".").c_str())
+				(ProgramOptions::CoverageJournalSecondsOption.c_str(), po::value<unsigned int>(),
+					("Seconds between two snapshots of --" + ProgramOptions::CoverageJournalOption + 
+					", 5 by default.").c_str())
+				(ProgramOptions::FailUnderOption.c_str(), po::value<unsigned int>(),
+					"Return an error code when the line coverage rate, in percent, is lower than this value.")
+				(ProgramOptions::AggregatorOption.c_str(), po::value<std::string>(),
+					("Receive the coverage sent by the aggregator export of other runs, also from other machines, "
+					"on the named pipe \\\\.\\pipe\\<name>. Each coverage is merged while the next one is "
+					"received and the result is exported once --" + ProgramOptions::AggregatorRunsOption +
+					" coverages are received.").c_str())
+				(ProgramOptions::AggregatorRunsOption.c_str(), po::value<unsigned int>(),
+					("Number of coverages received by --" + ProgramOptions::AggregatorOption + ".").c_str())
+				(ProgramOptions::PerfStatsOption.c_str(), po::value<std::string>(),
+					"Log the wall and CPU time of the phases of the run and its counters, debug events by type, "
+					"breakpoints and memory of the program read and written for example, and the cost of each "
+					"module sorted by registration time, and the estimated peak and final memory of the "
+					"structures of the run, and write them to this JSON file.")
+				(ProgramOptions::TraceOutputOption.c_str(), po::value<std::string>(),
+					"Write a timeline of the run to this file in the Chrome trace event format, with a track by "
+					"thread: debug events, module registrations, debug information reads, source file filters "
+					"and exports. It can be opened with chrome://tracing or Perfetto.")
+				(ProgramOptions::LiveCountersOption.c_str(), po::value<std::string>(),
+					("Publish the live counters of the run under this name for --" +
+					 ProgramOptions::WatchOption + ".").c_str())
+				(ProgramOptions::WatchOption.c_str(), po::value<std::string>(),
+					("Display every second the live counters published under this name by --" +
+					 ProgramOptions::LiveCountersOption + ": current phase, debug events per second, "
+					 "breakpoints armed and remaining, lines covered and modules loaded.").c_str())
+				(ProgramOptions::MeasureOverheadOption.c_str(), po::value<unsigned int>(),
+					"Run the program this number of times natively, under the debugger without breakpoints and "
+					"under coverage, then log the median wall time of each mode, its ratio to the native run and "
+					"the debug events and breakpoints by run. No coverage is exported.")
+				(ProgramOptions::ThreadsOption.c_str(), po::value<unsigned int>(),
+					"Number of threads reading the debug information, filtering the source files, merging and "
+					"exporting the coverage. Default is the number of logical processors.")
+				(ProgramOptions::ThreadPlacementOption.c_str(),
+					"Run the debug loop with a high priority on its own physical core and the threads of "
+					"--threads on the other cores, within the processor affinity of OpenCppCoverage. "
+					"Default --threads becomes the number of logical processors of these other cores.");
 				for (const auto& optionParser : optionParsers)
 					optionParser->AddOption(options);
 		}
@@ -119,6 +424,8 @@ namespace CppCoverage
 	const std::string ProgramOptions::ConfigFileOption = "config_file";	
 	const std::string ProgramOptions::WorkingDirectoryOption = "working_dir";
 	const std::string ProgramOptions::CoverChildrenOption = "cover_children";
+	const std::string ProgramOptions::SelectedChildrenOption = "children";
+	const std::string ProgramOptions::ExcludedChildrenOption = "excluded_children";
 	const std::string ProgramOptions::NoAggregateByFileOption = "no_aggregate_by_file";
 	const std::string ProgramOptions::ProgramToRunOption = "programToRun";
 	const std::string ProgramOptions::ProgramToRunArgOption = "programToRunArg";
@@ -127,8 +434,95 @@ namespace CppCoverage
 	const std::string ProgramOptions::ContinueAfterCppExceptionOption = "continue_after_cpp_exception";
 	const std::string ProgramOptions::OptimizedBuildOption = "optimized_build";
 	const std::string ProgramOptions::ExcludedLineRegexOption = "excluded_line_regex";
+	const std::string ProgramOptions::ExcludedLineMarkerOption = "excluded_line_marker";
+	const std::string ProgramOptions::ExcludedRegionMarkersOption = "excluded_region_markers";
 	const std::string ProgramOptions::SubstitutePdbSourcePathOption = "substitute_pdb_source_path";
     const std::string ProgramOptions::StopOnAssertOption = "stop_on_assert";
+	const std::string ProgramOptions::InProcessAgentOption = "in_process_agent";
+	const std::string ProgramOptions::BasicBlockBreakPointsOption = "basic_block_breakpoints";
+	const std::string ProgramOptions::DominatorBreakPointsOption = "dominator_breakpoints";
+	const std::string ProgramOptions::EagerLineDisarmOption = "eager_line_disarm";
+	const std::string ProgramOptions::LazyBreakPointsOption = "lazy_breakpoints";
+	const std::string ProgramOptions::PageGuardBreakPointsOption = "page_guard_breakpoints";
+	const std::string ProgramOptions::BaselineArmingOption = "baseline_arming";
+	const std::string ProgramOptions::RefilterInputCoverageOption = "refilter_input_coverage";
+	const std::string ProgramOptions::InputCoverageDiffOption = "input_coverage_diff";
+	const std::string ProgramOptions::IncrementalHtmlOption = "incremental_html";
+	const std::string ProgramOptions::ReportCompressionOption = "report_compression";
+	const std::string ProgramOptions::ReportCompressionZipValue = "zip";
+	const std::string ProgramOptions::ReportCompressionGzipValue = "gzip";
+	const std::string ProgramOptions::HtmlAssetsFolderOption = "html_assets_folder";
+	const std::string ProgramOptions::HtmlShardOption = "html_shard";
+	const std::string ProgramOptions::HtmlShardIndexValue = "index";
+	const std::string ProgramOptions::CoberturaPackagesByFileOption = "cobertura_packages_by_file";
+	const std::string ProgramOptions::CoverageLevelOption = "coverage_level";
+	const std::string ProgramOptions::CoverageLevelLineValue = "line";
+	const std::string ProgramOptions::CoverageLevelFunctionValue = "function";
+	const std::string ProgramOptions::SamplingTrapsPerSecondOption = "sampling_traps_per_second";
+	const std::string ProgramOptions::AdaptiveArmingOption = "adaptive_arming";
+	const std::string ProgramOptions::CoverageRegionMarkersOption = "coverage_region_markers";
+	const std::string ProgramOptions::FuzzOption = "fuzz";
+	const std::string ProgramOptions::IntelPtOption = "intel_pt";
+	const std::string ProgramOptions::TrampolinesOption = "trampolines";
+	const std::string ProgramOptions::EtwSamplingOption = "etw_sampling";
+	const std::string ProgramOptions::TestImpactIndexOption = "test_impact_index";
+	const std::string ProgramOptions::SelectTestsOption = "select_tests";
+	const std::string ProgramOptions::CompareCoverageOption = "compare_coverage";
+	const std::string ProgramOptions::AutoDetachOption = "auto_detach";
+	const std::string ProgramOptions::AttachOption = "attach";
+	const std::string ProgramOptions::DebugStringsOption = "debug_strings";
+	const std::string ProgramOptions::DebugStringsDropValue = "drop";
+	const std::string ProgramOptions::DebugStringsCountValue = "count";
+	const std::string ProgramOptions::DebugStringsFileOption = "debug_strings_file";
+	const std::string ProgramOptions::RecordDebugEventsOption = "record_debug_events";
+	const std::string ProgramOptions::ReplayDebugEventsOption = "replay_debug_events";
+	const std::string ProgramOptions::DebugHeapOption = "debug_heap";
+	const std::string ProgramOptions::AsyncModulesOption = "async_modules";
+	const std::string ProgramOptions::ProgramsOption = "programs";
+	const std::string ProgramOptions::JobsOption = "jobs";
+	const std::string ProgramOptions::ShardsOption = "shards";
+	const std::string ProgramOptions::ServiceOption = "service";
+	const std::string ProgramOptions::UseServiceOption = "use_service";
+	const std::string ProgramOptions::QueryServiceOption = "query_service";
+	const std::string ProgramOptions::OutOfProcessPluginsOption = "out_of_process_plugins";
+	const std::string ProgramOptions::ExportPluginHostOption = "export_plugin_host";
+	const std::string ProgramOptions::LineTableOption = "line_table";
+	const std::string ProgramOptions::InstrumentedImageOption = "instrumented_image";
+	const std::string ProgramOptions::InputLineCountersOption = "input_line_counters";
+	const std::string ProgramOptions::InputSancovOption = "input_sancov";
+	const std::string ProgramOptions::CacheDirOption = "cache_dir";
+	const std::string ProgramOptions::CacheSizeOption = "cache_size";
+	const std::string ProgramOptions::ResultCacheOption = "result_cache";
+	const std::string ProgramOptions::ResultCacheInputOption = "result_cache_input";
+	const std::string ProgramOptions::PdbCacheOption = "pdb_cache";
+	const std::string ProgramOptions::PdbCacheRemoteOption = "pdb_cache_remote";
+	const std::string ProgramOptions::IndexPdbsOption = "index_pdbs";
+	const std::string ProgramOptions::NativePdbReaderOption = "native_pdb_reader";
+	const std::string ProgramOptions::MergeIdenticalModulesOption = "merge_identical_modules";
+	const std::string ProgramOptions::SymbolServerOption = "symbol_server";
+	const std::string ProgramOptions::SymbolCacheOption = "symbol_cache";
+	const std::string ProgramOptions::SymbolDownloadsOption = "symbol_downloads";
+	const std::string ProgramOptions::MachineSymbolLoadsOption = "machine_symbol_loads";
+	const std::string ProgramOptions::SourceServerCacheOption = "source_server_cache";
+	const std::string ProgramOptions::SourceServerCommandOption = "source_server_command";
+	const std::string ProgramOptions::ModuleTimeBudgetOption = "module_time_budget";
+	const std::string ProgramOptions::MemoryBudgetOption = "memory_budget";
+	const std::string ProgramOptions::BinaryBaselineOption = "binary_baseline";
+	const std::string ProgramOptions::BinaryLineTablesOption = "binary_line_tables";
+	const std::string ProgramOptions::BinaryCompressionOption = "binary_compression";
+	const std::string ProgramOptions::DeterministicOption = "deterministic";
+	const std::string ProgramOptions::CoverageJournalOption = "coverage_journal";
+	const std::string ProgramOptions::CoverageJournalSecondsOption = "coverage_journal_seconds";
+	const std::string ProgramOptions::FailUnderOption = "fail_under";
+	const std::string ProgramOptions::AggregatorOption = "aggregator";
+	const std::string ProgramOptions::AggregatorRunsOption = "aggregator_runs";
+	const std::string ProgramOptions::PerfStatsOption = "perf_stats";
+	const std::string ProgramOptions::TraceOutputOption = "trace_output";
+	const std::string ProgramOptions::LiveCountersOption = "live_counters";
+	const std::string ProgramOptions::WatchOption = "watch";
+	const std::string ProgramOptions::MeasureOverheadOption = "measure_overhead";
+	const std::string ProgramOptions::ThreadsOption = "threads";
+	const std::string ProgramOptions::ThreadPlacementOption = "thread_placement";
 
 	//-------------------------------------------------------------------------
 	ProgramOptions::ProgramOptions(
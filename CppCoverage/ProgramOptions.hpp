@@ -41,6 +41,8 @@ namespace CppCoverage
 		static const std::string ConfigFileOption;
 		static const std::string WorkingDirectoryOption;
 		static const std::string CoverChildrenOption;
+		static const std::string SelectedChildrenOption;
+		static const std::string ExcludedChildrenOption;
 		static const std::string NoAggregateByFileOption;
         static const std::string StopOnAssertOption;
         static const std::string ProgramToRunOption;
@@ -50,7 +52,94 @@ namespace CppCoverage
 		static const std::string ContinueAfterCppExceptionOption;
 		static const std::string OptimizedBuildOption;
 		static const std::string ExcludedLineRegexOption;
+		static const std::string ExcludedLineMarkerOption;
+		static const std::string ExcludedRegionMarkersOption;
 		static const std::string SubstitutePdbSourcePathOption;
+		static const std::string InProcessAgentOption;
+		static const std::string BasicBlockBreakPointsOption;
+		static const std::string DominatorBreakPointsOption;
+		static const std::string EagerLineDisarmOption;
+		static const std::string LazyBreakPointsOption;
+		static const std::string PageGuardBreakPointsOption;
+		static const std::string BaselineArmingOption;
+		static const std::string RefilterInputCoverageOption;
+		static const std::string InputCoverageDiffOption;
+		static const std::string IncrementalHtmlOption;
+		static const std::string ReportCompressionOption;
+		static const std::string ReportCompressionZipValue;
+		static const std::string ReportCompressionGzipValue;
+		static const std::string HtmlAssetsFolderOption;
+		static const std::string HtmlShardOption;
+		static const std::string HtmlShardIndexValue;
+		static const std::string CoberturaPackagesByFileOption;
+		static const std::string CoverageLevelOption;
+		static const std::string CoverageLevelLineValue;
+		static const std::string CoverageLevelFunctionValue;
+		static const std::string SamplingTrapsPerSecondOption;
+		static const std::string AdaptiveArmingOption;
+		static const std::string CoverageRegionMarkersOption;
+		static const std::string FuzzOption;
+		static const std::string IntelPtOption;
+		static const std::string TrampolinesOption;
+		static const std::string EtwSamplingOption;
+		static const std::string TestImpactIndexOption;
+		static const std::string SelectTestsOption;
+		static const std::string CompareCoverageOption;
+		static const std::string AutoDetachOption;
+		static const std::string AttachOption;
+		static const std::string DebugStringsOption;
+		static const std::string DebugStringsDropValue;
+		static const std::string DebugStringsCountValue;
+		static const std::string DebugStringsFileOption;
+		static const std::string RecordDebugEventsOption;
+		static const std::string ReplayDebugEventsOption;
+		static const std::string DebugHeapOption;
+		static const std::string AsyncModulesOption;
+		static const std::string ProgramsOption;
+		static const std::string JobsOption;
+		static const std::string ShardsOption;
+		static const std::string ServiceOption;
+		static const std::string UseServiceOption;
+		static const std::string QueryServiceOption;
+		static const std::string OutOfProcessPluginsOption;
+		static const std::string ExportPluginHostOption;
+		static const std::string LineTableOption;
+		static const std::string InstrumentedImageOption;
+		static const std::string InputLineCountersOption;
+		static const std::string InputSancovOption;
+		static const std::string CacheDirOption;
+		static const std::string CacheSizeOption;
+		static const std::string ResultCacheOption;
+		static const std::string ResultCacheInputOption;
+		static const std::string PdbCacheOption;
+		static const std::string PdbCacheRemoteOption;
+		static const std::string IndexPdbsOption;
+		static const std::string NativePdbReaderOption;
+		static const std::string MergeIdenticalModulesOption;
+		static const std::string SymbolServerOption;
+		static const std::string SymbolCacheOption;
+		static const std::string SymbolDownloadsOption;
+		static const std::string MachineSymbolLoadsOption;
+		static const std::string SourceServerCacheOption;
+		static const std::string SourceServerCommandOption;
+		static const std::string ModuleTimeBudgetOption;
+		static const std::string MemoryBudgetOption;
+		static const std::string BinaryBaselineOption;
+		static const std::string BinaryLineTablesOption;
+		static const std::string BinaryCompressionOption;
+		static const std::string DeterministicOption;
+		static const std::string CoverageJournalOption;
+		static const std::string CoverageJournalSecondsOption;
+		static const std::string FailUnderOption;
+		static const std::string AggregatorOption;
+		static const std::string AggregatorRunsOption;
+		static const std::string PerfStatsOption;
+		static const std::string TraceOutputOption;
+		static const std::string LiveCountersOption;
+		static const std::string WatchOption;
+		static const std::string MeasureOverheadOption;
+		static const std::string ThreadsOption;
+		static const std::string ThreadPlacementOption;
 
 		explicit ProgramOptions(const std::vector<std::unique_ptr<IOptionParser>>&);
 
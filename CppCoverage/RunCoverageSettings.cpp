@@ -34,7 +34,31 @@ namespace CppCoverage
 	      maxUnmatchPathsForWarning_{0},
 	      optimizedBuildSupport_{false},
 	      excludedLineRegexes_{excludedLineRegexes},
-	      substitutePdbSourcePath_{substitutePdbSourcePath}
+	      substitutePdbSourcePath_{substitutePdbSourcePath},
+	      inProcessAgent_{false},
+	      basicBlockBreakPoints_{false},
+	      dominatorBreakPoints_{false},
+	      eagerLineDisarm_{false},
+	      lazyBreakPoints_{false},
+	      pageGuardBreakPoints_{false},
+	      coverageLevel_{CoverageLevel::Line},
+	      samplingTrapsPerSecond_{0},
+	      adaptiveArmingTrapsPerSecond_{0},
+	      coverageRegionMarkers_{false},
+	      fuzzing_{false},
+	      intelPt_{false},
+	      trampolines_{false},
+	      etwSampling_{false},
+	      autoDetachSeconds_{0},
+	      attachProcessId_{0},
+	      debugStringMode_{DebugStringMode::Read},
+	      debugHeap_{false},
+	      asyncModules_{false},
+	      nativePdbReader_{false},
+	      identicalModulesMerged_{false},
+	      moduleTimeBudgetMilliseconds_{0},
+	      memoryBudgetBytes_{0},
+	      coverageJournalSeconds_{0}
 	{
 	}
 
@@ -127,4 +151,505 @@ namespace CppCoverage
 	{
 		return substitutePdbSourcePath_;
 	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetInProcessAgent(bool inProcessAgent)
+	{
+		inProcessAgent_ = inProcessAgent;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetInProcessAgent() const
+	{
+		return inProcessAgent_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetBasicBlockBreakPoints(bool basicBlockBreakPoints)
+	{
+		basicBlockBreakPoints_ = basicBlockBreakPoints;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetBasicBlockBreakPoints() const
+	{
+		return basicBlockBreakPoints_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetDominatorBreakPoints(bool dominatorBreakPoints)
+	{
+		dominatorBreakPoints_ = dominatorBreakPoints;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetDominatorBreakPoints() const
+	{
+		return dominatorBreakPoints_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetEagerLineDisarm(bool eagerLineDisarm)
+	{
+		eagerLineDisarm_ = eagerLineDisarm;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetEagerLineDisarm() const
+	{
+		return eagerLineDisarm_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetLazyBreakPoints(bool lazyBreakPoints)
+	{
+		lazyBreakPoints_ = lazyBreakPoints;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetLazyBreakPoints() const
+	{
+		return lazyBreakPoints_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetPageGuardBreakPoints(bool pageGuardBreakPoints)
+	{
+		pageGuardBreakPoints_ = pageGuardBreakPoints;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetPageGuardBreakPoints() const
+	{
+		return pageGuardBreakPoints_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetCoverageBaseline(
+	    std::shared_ptr<const CoverageBaseline> coverageBaseline)
+	{
+		coverageBaseline_ = coverageBaseline;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<const CoverageBaseline>
+	RunCoverageSettings::GetCoverageBaseline() const
+	{
+		return coverageBaseline_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetCoverageLevel(CoverageLevel coverageLevel)
+	{
+		coverageLevel_ = coverageLevel;
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageLevel RunCoverageSettings::GetCoverageLevel() const
+	{
+		return coverageLevel_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetSamplingTrapsPerSecond(size_t samplingTrapsPerSecond)
+	{
+		samplingTrapsPerSecond_ = samplingTrapsPerSecond;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t RunCoverageSettings::GetSamplingTrapsPerSecond() const
+	{
+		return samplingTrapsPerSecond_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetAdaptiveArmingTrapsPerSecond(size_t adaptiveArmingTrapsPerSecond)
+	{
+		adaptiveArmingTrapsPerSecond_ = adaptiveArmingTrapsPerSecond;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t RunCoverageSettings::GetAdaptiveArmingTrapsPerSecond() const
+	{
+		return adaptiveArmingTrapsPerSecond_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetCoverageRegionMarkers(bool coverageRegionMarkers)
+	{
+		coverageRegionMarkers_ = coverageRegionMarkers;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetCoverageRegionMarkers() const
+	{
+		return coverageRegionMarkers_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetFuzzing(bool fuzzing)
+	{
+		fuzzing_ = fuzzing;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetFuzzing() const
+	{
+		return fuzzing_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetIntelPt(bool intelPt)
+	{
+		intelPt_ = intelPt;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetIntelPt() const
+	{
+		return intelPt_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetTrampolines(bool trampolines)
+	{
+		trampolines_ = trampolines;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetTrampolines() const
+	{
+		return trampolines_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetEtwSampling(bool etwSampling)
+	{
+		etwSampling_ = etwSampling;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetEtwSampling() const
+	{
+		return etwSampling_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetTestImpactIndex(
+	    std::shared_ptr<TestImpactIndex> testImpactIndex)
+	{
+		testImpactIndex_ = testImpactIndex;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<TestImpactIndex>
+	RunCoverageSettings::GetTestImpactIndex() const
+	{
+		return testImpactIndex_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetAutoDetachSeconds(size_t autoDetachSeconds)
+	{
+		autoDetachSeconds_ = autoDetachSeconds;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t RunCoverageSettings::GetAutoDetachSeconds() const
+	{
+		return autoDetachSeconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetChildPatterns(const Patterns& childPatterns)
+	{
+		childPatterns_ = childPatterns;
+	}
+
+	//-------------------------------------------------------------------------
+	const Patterns* RunCoverageSettings::GetChildPatterns() const
+	{
+		return childPatterns_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetAttachProcessId(unsigned int attachProcessId)
+	{
+		attachProcessId_ = attachProcessId;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int RunCoverageSettings::GetAttachProcessId() const
+	{
+		return attachProcessId_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetDebugHeap(bool debugHeap)
+	{
+		debugHeap_ = debugHeap;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetDebugHeap() const
+	{
+		return debugHeap_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetDebugStringMode(DebugStringMode debugStringMode)
+	{
+		debugStringMode_ = debugStringMode;
+	}
+
+	//-------------------------------------------------------------------------
+	DebugStringMode RunCoverageSettings::GetDebugStringMode() const
+	{
+		return debugStringMode_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetDebugStringsPath(const std::filesystem::path& path)
+	{
+		debugStringsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* RunCoverageSettings::GetDebugStringsPath() const
+	{
+		return debugStringsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetRecordDebugEventsPath(const std::filesystem::path& path)
+	{
+		recordDebugEventsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* RunCoverageSettings::GetRecordDebugEventsPath() const
+	{
+		return recordDebugEventsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetReplayDebugEventsPath(const std::filesystem::path& path)
+	{
+		replayDebugEventsPath_ = path;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* RunCoverageSettings::GetReplayDebugEventsPath() const
+	{
+		return replayDebugEventsPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetAsyncModules(bool asyncModules)
+	{
+		asyncModules_ = asyncModules;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetAsyncModules() const
+	{
+		return asyncModules_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetDebugInformationCache(
+	    std::shared_ptr<DebugInformationCache> debugInformationCache)
+	{
+		debugInformationCache_ = debugInformationCache;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<DebugInformationCache>
+	RunCoverageSettings::GetDebugInformationCache() const
+	{
+		return debugInformationCache_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetPdbCache(std::shared_ptr<const PdbCache> pdbCache)
+	{
+		pdbCache_ = pdbCache;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<const PdbCache> RunCoverageSettings::GetPdbCache() const
+	{
+		return pdbCache_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetModuleLoadHistoryCache(
+	    std::shared_ptr<const Tools::BlobCache> moduleLoadHistoryCache)
+	{
+		moduleLoadHistoryCache_ = moduleLoadHistoryCache;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<const Tools::BlobCache>
+	RunCoverageSettings::GetModuleLoadHistoryCache() const
+	{
+		return moduleLoadHistoryCache_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetNativePdbReader(bool nativePdbReader)
+	{
+		nativePdbReader_ = nativePdbReader;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetNativePdbReader() const
+	{
+		return nativePdbReader_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetIdenticalModulesMerged(bool identicalModulesMerged)
+	{
+		identicalModulesMerged_ = identicalModulesMerged;
+	}
+
+	//-------------------------------------------------------------------------
+	bool RunCoverageSettings::GetIdenticalModulesMerged() const
+	{
+		return identicalModulesMerged_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetSymbolPrefetcher(std::shared_ptr<SymbolPrefetcher> symbolPrefetcher)
+	{
+		symbolPrefetcher_ = symbolPrefetcher;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<SymbolPrefetcher> RunCoverageSettings::GetSymbolPrefetcher() const
+	{
+		return symbolPrefetcher_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetModuleTimeBudgetMilliseconds(size_t moduleTimeBudgetMilliseconds)
+	{
+		moduleTimeBudgetMilliseconds_ = moduleTimeBudgetMilliseconds;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t RunCoverageSettings::GetModuleTimeBudgetMilliseconds() const
+	{
+		return moduleTimeBudgetMilliseconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetMemoryBudgetBytes(uint64_t memoryBudgetBytes)
+	{
+		memoryBudgetBytes_ = memoryBudgetBytes;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t RunCoverageSettings::GetMemoryBudgetBytes() const
+	{
+		return memoryBudgetBytes_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetExclusionMarkers(const FileFilter::ExclusionMarkers& exclusionMarkers)
+	{
+		exclusionMarkers_ = exclusionMarkers;
+	}
+
+	//-------------------------------------------------------------------------
+	const FileFilter::ExclusionMarkers& RunCoverageSettings::GetExclusionMarkers() const
+	{
+		return exclusionMarkers_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetCoverageJournal(
+		const std::filesystem::path& path,
+		size_t seconds)
+	{
+		coverageJournalPath_ = path;
+		coverageJournalSeconds_ = seconds;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path* RunCoverageSettings::GetCoverageJournalPath() const
+	{
+		return coverageJournalPath_.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t RunCoverageSettings::GetCoverageJournalSeconds() const
+	{
+		return coverageJournalSeconds_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetSourceFileCache(
+	    std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
+	{
+		sourceFileCache_ = sourceFileCache;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<Tools::SourceFileCache>
+	RunCoverageSettings::GetSourceFileCache() const
+	{
+		return sourceFileCache_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetPerformanceStatistics(
+	    std::shared_ptr<PerformanceStatistics> performanceStatistics)
+	{
+		performanceStatistics_ = performanceStatistics;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<PerformanceStatistics>
+	RunCoverageSettings::GetPerformanceStatistics() const
+	{
+		return performanceStatistics_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetTraceRecorder(std::shared_ptr<TraceRecorder> traceRecorder)
+	{
+		traceRecorder_ = traceRecorder;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<TraceRecorder> RunCoverageSettings::GetTraceRecorder() const
+	{
+		return traceRecorder_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetLiveCounters(std::shared_ptr<LiveCounters> liveCounters)
+	{
+		liveCounters_ = liveCounters;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<LiveCounters> RunCoverageSettings::GetLiveCounters() const
+	{
+		return liveCounters_;
+	}
+
+	//-------------------------------------------------------------------------
+	void RunCoverageSettings::SetCoverageObserver(std::shared_ptr<ICoverageObserver> coverageObserver)
+	{
+		coverageObserver_ = coverageObserver;
+	}
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<ICoverageObserver> RunCoverageSettings::GetCoverageObserver() const
+	{
+		return coverageObserver_;
+	}
 }
@@ -17,15 +17,36 @@
 #pragma once
 
 #include <vector>
+#include <memory>
+#include <boost/optional.hpp>
 #include "StartInfo.hpp"
 #include "UnifiedDiffSettings.hpp"
 #include "CoverageFilterSettings.hpp"
 
 #include "CppCoverageExport.hpp"
 #include "SubstitutePdbSourcePath.hpp"
+#include "CoverageLevel.hpp"
+#include "DebugStringMode.hpp"
+#include "FileFilter/ExclusionMarkers.hpp"
+
+namespace Tools
+{
+	class SourceFileCache;
+	class BlobCache;
+}
 
 namespace CppCoverage
 {
+	class CoverageBaseline;
+	class TestImpactIndex;
+	class DebugInformationCache;
+	class PdbCache;
+	class SymbolPrefetcher;
+	class PerformanceStatistics;
+	class TraceRecorder;
+	class LiveCounters;
+	class ICoverageObserver;
+
 	class CPPCOVERAGE_DLL RunCoverageSettings
 	{
 	public:
@@ -44,6 +65,47 @@ namespace CppCoverage
         void SetStopOnAssert(bool);
         void SetMaxUnmatchPathsForWarning(size_t);
 		void SetOptimizedBuildSupport(bool);
+		void SetInProcessAgent(bool);
+		void SetBasicBlockBreakPoints(bool);
+		void SetDominatorBreakPoints(bool);
+		void SetEagerLineDisarm(bool);
+		void SetLazyBreakPoints(bool);
+		void SetPageGuardBreakPoints(bool);
+		void SetCoverageBaseline(std::shared_ptr<const CoverageBaseline>);
+		void SetCoverageLevel(CoverageLevel);
+		void SetSamplingTrapsPerSecond(size_t);
+		void SetAdaptiveArmingTrapsPerSecond(size_t);
+		void SetCoverageRegionMarkers(bool);
+		void SetFuzzing(bool);
+		void SetIntelPt(bool);
+		void SetTrampolines(bool);
+		void SetEtwSampling(bool);
+		void SetTestImpactIndex(std::shared_ptr<TestImpactIndex>);
+		void SetAutoDetachSeconds(size_t);
+		void SetChildPatterns(const Patterns&);
+		void SetDebugStringMode(DebugStringMode);
+		void SetDebugStringsPath(const std::filesystem::path&);
+		void SetRecordDebugEventsPath(const std::filesystem::path&);
+		void SetReplayDebugEventsPath(const std::filesystem::path&);
+		void SetAttachProcessId(unsigned int);
+		void SetDebugHeap(bool);
+		void SetAsyncModules(bool);
+		void SetDebugInformationCache(std::shared_ptr<DebugInformationCache>);
+		void SetPdbCache(std::shared_ptr<const PdbCache>);
+		// The modules loaded by the program are saved in this cache.
+		void SetModuleLoadHistoryCache(std::shared_ptr<const Tools::BlobCache>);
+		void SetNativePdbReader(bool);
+		void SetIdenticalModulesMerged(bool);
+		void SetSymbolPrefetcher(std::shared_ptr<SymbolPrefetcher>);
+		void SetModuleTimeBudgetMilliseconds(size_t);
+		void SetMemoryBudgetBytes(uint64_t);
+		void SetExclusionMarkers(const FileFilter::ExclusionMarkers&);
+		void SetCoverageJournal(const std::filesystem::path&, size_t seconds);
+		void SetSourceFileCache(std::shared_ptr<Tools::SourceFileCache>);
+		void SetPerformanceStatistics(std::shared_ptr<PerformanceStatistics>);
+		void SetTraceRecorder(std::shared_ptr<TraceRecorder>);
+		void SetLiveCounters(std::shared_ptr<LiveCounters>);
+		void SetCoverageObserver(std::shared_ptr<ICoverageObserver>);
 
 		const StartInfo& GetStartInfo() const;
 		const CoverageFilterSettings& GetCoverageFilterSettings() const;
@@ -55,6 +117,47 @@ namespace CppCoverage
 		bool GetOptimizedBuildSupport() const;
 		const std::vector<std::wstring>& GetExcludedLineRegexes() const;
 		const std::vector<SubstitutePdbSourcePath>& GetSubstitutePdbSourcePaths() const;
+		bool GetInProcessAgent() const;
+		bool GetBasicBlockBreakPoints() const;
+		bool GetDominatorBreakPoints() const;
+		bool GetEagerLineDisarm() const;
+		bool GetLazyBreakPoints() const;
+		bool GetPageGuardBreakPoints() const;
+		std::shared_ptr<const CoverageBaseline> GetCoverageBaseline() const;
+		CoverageLevel GetCoverageLevel() const;
+		size_t GetSamplingTrapsPerSecond() const;
+		size_t GetAdaptiveArmingTrapsPerSecond() const;
+		bool GetCoverageRegionMarkers() const;
+		bool GetFuzzing() const;
+		bool GetIntelPt() const;
+		bool GetTrampolines() const;
+		bool GetEtwSampling() const;
+		std::shared_ptr<TestImpactIndex> GetTestImpactIndex() const;
+		size_t GetAutoDetachSeconds() const;
+		const Patterns* GetChildPatterns() const;
+		DebugStringMode GetDebugStringMode() const;
+		const std::filesystem::path* GetDebugStringsPath() const;
+		const std::filesystem::path* GetRecordDebugEventsPath() const;
+		const std::filesystem::path* GetReplayDebugEventsPath() const;
+		unsigned int GetAttachProcessId() const;
+		bool GetDebugHeap() const;
+		bool GetAsyncModules() const;
+		std::shared_ptr<DebugInformationCache> GetDebugInformationCache() const;
+		std::shared_ptr<const PdbCache> GetPdbCache() const;
+		std::shared_ptr<const Tools::BlobCache> GetModuleLoadHistoryCache() const;
+		bool GetNativePdbReader() const;
+		bool GetIdenticalModulesMerged() const;
+		std::shared_ptr<SymbolPrefetcher> GetSymbolPrefetcher() const;
+		size_t GetModuleTimeBudgetMilliseconds() const;
+		uint64_t GetMemoryBudgetBytes() const;
+		const FileFilter::ExclusionMarkers& GetExclusionMarkers() const;
+		const std::filesystem::path* GetCoverageJournalPath() const;
+		size_t GetCoverageJournalSeconds() const;
+		std::shared_ptr<Tools::SourceFileCache> GetSourceFileCache() const;
+		std::shared_ptr<PerformanceStatistics> GetPerformanceStatistics() const;
+		std::shared_ptr<TraceRecorder> GetTraceRecorder() const;
+		std::shared_ptr<LiveCounters> GetLiveCounters() const;
+		std::shared_ptr<ICoverageObserver> GetCoverageObserver() const;
 
 	private:
 		StartInfo startInfo_;
@@ -67,5 +170,46 @@ namespace CppCoverage
 		bool optimizedBuildSupport_;
 		std::vector<std::wstring> excludedLineRegexes_;
 		std::vector<SubstitutePdbSourcePath> substitutePdbSourcePath_;
+		bool inProcessAgent_;
+		bool basicBlockBreakPoints_;
+		bool dominatorBreakPoints_;
+		bool eagerLineDisarm_;
+		bool lazyBreakPoints_;
+		bool pageGuardBreakPoints_;
+		std::shared_ptr<const CoverageBaseline> coverageBaseline_;
+		CoverageLevel coverageLevel_;
+		size_t samplingTrapsPerSecond_;
+		size_t adaptiveArmingTrapsPerSecond_;
+		bool coverageRegionMarkers_;
+		bool fuzzing_;
+		bool intelPt_;
+		bool trampolines_;
+		bool etwSampling_;
+		std::shared_ptr<TestImpactIndex> testImpactIndex_;
+		size_t autoDetachSeconds_;
+		boost::optional<Patterns> childPatterns_;
+		DebugStringMode debugStringMode_;
+		boost::optional<std::filesystem::path> debugStringsPath_;
+		boost::optional<std::filesystem::path> recordDebugEventsPath_;
+		boost::optional<std::filesystem::path> replayDebugEventsPath_;
+		unsigned int attachProcessId_;
+		bool debugHeap_;
+		bool asyncModules_;
+		std::shared_ptr<DebugInformationCache> debugInformationCache_;
+		std::shared_ptr<const PdbCache> pdbCache_;
+		std::shared_ptr<const Tools::BlobCache> moduleLoadHistoryCache_;
+		bool nativePdbReader_;
+		bool identicalModulesMerged_;
+		std::shared_ptr<SymbolPrefetcher> symbolPrefetcher_;
+		size_t moduleTimeBudgetMilliseconds_;
+		uint64_t memoryBudgetBytes_;
+		FileFilter::ExclusionMarkers exclusionMarkers_;
+		boost::optional<std::filesystem::path> coverageJournalPath_;
+		size_t coverageJournalSeconds_;
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
+		std::shared_ptr<PerformanceStatistics> performanceStatistics_;
+		std::shared_ptr<TraceRecorder> traceRecorder_;
+		std::shared_ptr<LiveCounters> liveCounters_;
+		std::shared_ptr<ICoverageObserver> coverageObserver_;
 	};
 }
@@ -0,0 +1,95 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SampledAddressMapper.hpp"
+
+#include <algorithm>
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	void SampledAddressMapper::AddModule(
+	    HANDLE hProcess,
+	    void* baseOfImage,
+	    const std::map<DWORD64, uint64_t>& functionRanges,
+	    std::vector<DWORD64> addresses)
+	{
+		std::sort(addresses.begin(), addresses.end());
+		addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+
+		auto& functions = functionsByProcess_[hProcess];
+		for (const auto& range : functionRanges)
+		{
+			auto end = range.first + range.second;
+			auto first = std::lower_bound(addresses.begin(), addresses.end(), range.first);
+			auto last = std::lower_bound(first, addresses.end(), end);
+
+			if (first != last)
+				functions[range.first] = Function{end, baseOfImage, {first, last}};
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void SampledAddressMapper::OnUnloadModule(HANDLE hProcess, void* baseOfImage)
+	{
+		auto it = functionsByProcess_.find(hProcess);
+
+		if (it == functionsByProcess_.end())
+			return;
+		auto& functions = it->second;
+		for (auto function = functions.begin(); function != functions.end();)
+		{
+			if (function->second.baseOfImage_ == baseOfImage)
+				function = functions.erase(function);
+			else
+				++function;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void SampledAddressMapper::OnExitProcess(HANDLE hProcess)
+	{
+		functionsByProcess_.erase(hProcess);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<DWORD64> SampledAddressMapper::Find(
+	    HANDLE hProcess,
+	    DWORD64 instructionPointer) const
+	{
+		auto it = functionsByProcess_.find(hProcess);
+
+		if (it == functionsByProcess_.end())
+			return boost::none;
+
+		const auto& functions = it->second;
+		auto function = functions.upper_bound(instructionPointer);
+		if (function == functions.begin())
+			return boost::none;
+		--function;
+		if (instructionPointer >= function->second.end_)
+			return boost::none;
+
+		// The code before the first line, such as the prologue, is part of
+		// the first line.
+		const auto& addresses = function->second.addresses_;
+		auto address = std::upper_bound(addresses.begin(), addresses.end(), instructionPointer);
+		if (address != addresses.begin())
+			--address;
+		return *address;
+	}
+}
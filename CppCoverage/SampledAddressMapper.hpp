@@ -0,0 +1,64 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <Windows.h>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Find the line of a sampled instruction pointer: the registered address
+	// of a line is the start of the line. The function of the instruction
+	// must contain registered addresses so code of unselected functions is
+	// not reported.
+	class CPPCOVERAGE_DLL SampledAddressMapper
+	{
+	  public:
+		SampledAddressMapper() = default;
+
+		// functionRanges is the length of each function by its address.
+		void AddModule(HANDLE hProcess,
+		               void* baseOfImage,
+		               const std::map<DWORD64, uint64_t>& functionRanges,
+		               std::vector<DWORD64> addresses);
+		void OnUnloadModule(HANDLE hProcess, void* baseOfImage);
+		void OnExitProcess(HANDLE hProcess);
+
+		// Return the registered address of the line running the instruction.
+		boost::optional<DWORD64> Find(HANDLE hProcess, DWORD64 instructionPointer) const;
+
+	  private:
+		SampledAddressMapper(const SampledAddressMapper&) = delete;
+		SampledAddressMapper& operator=(const SampledAddressMapper&) = delete;
+
+		struct Function
+		{
+			DWORD64 end_;
+			void* baseOfImage_;
+			// Sorted addresses of the lines of the function.
+			std::vector<DWORD64> addresses_;
+		};
+
+		// Functions by start address.
+		std::map<HANDLE, std::map<DWORD64, Function>> functionsByProcess_;
+	};
+}
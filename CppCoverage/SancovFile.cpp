@@ -0,0 +1,102 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "SancovFile.hpp"
+
+#include <fstream>
+#include <limits>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+#include "CppCoverageException.hpp"
+#include "ModuleLineTable.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		template <typename T>
+		bool ReadValue(std::ifstream& ifs, T& value)
+		{
+			return static_cast<bool>(ifs.read(reinterpret_cast<char*>(&value), sizeof(value)));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const uint64_t SancovFile::Magic32 = 0xC0BFFFFFFFFFFF32;
+	const uint64_t SancovFile::Magic64 = 0xC0BFFFFFFFFFFF64;
+
+	//-------------------------------------------------------------------------
+	std::vector<uint64_t> SancovFile::ReadOffsets(const std::filesystem::path& path)
+	{
+		std::ifstream ifs{path, std::ios::binary};
+		uint64_t magic = 0;
+
+		if (!ReadValue(ifs, magic) || (magic != Magic32 && magic != Magic64))
+			THROW(L"Invalid sancov file: " << path.wstring());
+
+		std::vector<uint64_t> offsets;
+		if (magic == Magic32)
+		{
+			uint32_t offset = 0;
+			while (ReadValue(ifs, offset))
+				offsets.push_back(offset);
+		}
+		else
+		{
+			uint64_t offset = 0;
+			while (ReadValue(ifs, offset))
+				offsets.push_back(offset);
+		}
+		return offsets;
+	}
+
+	//-------------------------------------------------------------------------
+	void SancovFile::WriteOffsets(const std::filesystem::path& path,
+	                              const std::vector<uint64_t>& offsets)
+	{
+		std::ofstream ofs{path, std::ios::binary};
+
+		ofs.write(reinterpret_cast<const char*>(&Magic64), sizeof(Magic64));
+		if (!offsets.empty())
+		{
+			ofs.write(reinterpret_cast<const char*>(offsets.data()),
+			          offsets.size() * sizeof(offsets[0]));
+		}
+		if (!ofs)
+			THROW(L"Cannot write sancov file: " << path.wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData SancovFile::CreateCoverageData(const ModuleLineTable& lineTable,
+	                                                    const std::vector<uint64_t>& offsets)
+	{
+		std::vector<uint64_t> hitCounts(lineTable.GetLines().size());
+
+		for (auto offset : offsets)
+		{
+			if (offset > (std::numeric_limits<uint32_t>::max)())
+				continue;
+			if (auto lineIndex = lineTable.FindLineIndex(static_cast<uint32_t>(offset)))
+				hitCounts[*lineIndex] = 1;
+		}
+		return lineTable.CreateCoverageData(
+		    lineTable.GetModulePath().filename().wstring(), hitCounts, false);
+	}
+}
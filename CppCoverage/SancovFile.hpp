@@ -0,0 +1,54 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	class ModuleLineTable;
+
+	// PCs covered by a module built with clang-cl -fsanitize-coverage, as
+	// dumped by the sanitizer runtime.
+	//
+	// The binary format is a 64-bit magic followed by the offsets of the PCs
+	// from the base of the module. The last byte of the magic tells whether
+	// the offsets are 32 or 64-bit.
+	class CPPCOVERAGE_DLL SancovFile
+	{
+	public:
+		static const uint64_t Magic32;
+		static const uint64_t Magic64;
+
+		static std::vector<uint64_t> ReadOffsets(const std::filesystem::path&);
+		static void WriteOffsets(const std::filesystem::path&,
+		                         const std::vector<uint64_t>& offsets);
+
+		// Coverage of the lines of the table which contain one of the offsets.
+		static Plugin::CoverageData CreateCoverageData(const ModuleLineTable&,
+		                                               const std::vector<uint64_t>& offsets);
+	};
+}
@@ -0,0 +1,65 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "SaturationDetector.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	SaturationDetector::SaturationDetector(Clock::duration flatPeriod)
+		: flatPeriod_{flatPeriod}
+	{
+		if (flatPeriod_ <= Clock::duration::zero())
+			THROW(L"Saturation period must be greater than zero.");
+	}
+
+	//-------------------------------------------------------------------------
+	bool SaturationDetector::IsSaturated(
+		HANDLE hProcess,
+		size_t armedAddressCount,
+		Clock::time_point now)
+	{
+		auto it = states_.find(hProcess);
+
+		if (it == states_.end())
+		{
+			if (armedAddressCount != 0)
+				states_.emplace(hProcess, ProcessState{armedAddressCount, now});
+			return false;
+		}
+
+		auto& state = it->second;
+		if (armedAddressCount == 0)
+			return true;
+		if (armedAddressCount != state.armedAddressCount_)
+		{
+			state.armedAddressCount_ = armedAddressCount;
+			state.lastChange_ = now;
+			return false;
+		}
+		return now - state.lastChange_ >= flatPeriod_;
+	}
+
+	//-------------------------------------------------------------------------
+	void SaturationDetector::OnExitProcess(HANDLE hProcess)
+	{
+		states_.erase(hProcess);
+	}
+}
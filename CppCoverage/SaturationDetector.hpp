@@ -0,0 +1,56 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <chrono>
+#include <map>
+
+#include <Windows.h>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Decide when a debugged process does not need the debugger anymore: all
+	// its breakpoints have been hit or their count has not changed during
+	// the given period. A process is considered only after it has at least
+	// one breakpoint, so it is not detached before its modules are loaded.
+	class CPPCOVERAGE_DLL SaturationDetector
+	{
+	  public:
+		using Clock = std::chrono::steady_clock;
+
+		explicit SaturationDetector(Clock::duration flatPeriod);
+
+		bool IsSaturated(HANDLE hProcess, size_t armedAddressCount, Clock::time_point now);
+		void OnExitProcess(HANDLE hProcess);
+
+	  private:
+		SaturationDetector(const SaturationDetector&) = delete;
+		SaturationDetector& operator=(const SaturationDetector&) = delete;
+
+		struct ProcessState
+		{
+			size_t armedAddressCount_;
+			Clock::time_point lastChange_;
+		};
+
+		const Clock::duration flatPeriod_;
+		std::map<HANDLE, ProcessState> states_;
+	};
+}
@@ -0,0 +1,300 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SourceServerFetcher.hpp"
+
+#include <Windows.h>
+#include <urlmon.h>
+
+#include <atomic>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/replace.hpp>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+
+#include "Tools/Fnv1a.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/ThreadPool.hpp"
+#include "Tools/Tool.hpp"
+
+#include "Handle.hpp"
+#include "NativePdbReader.hpp"
+
+namespace fs = std::filesystem;
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const DWORD CommandTimeoutMilliseconds = 5 * 60 * 1000;
+
+		//---------------------------------------------------------------------
+		bool IsUrl(const std::wstring& target)
+		{
+			return boost::istarts_with(target, L"http://") ||
+			       boost::istarts_with(target, L"https://");
+		}
+
+		//---------------------------------------------------------------------
+		struct PendingFetch
+		{
+			SourceServerStream::Extraction extraction_;
+			std::vector<fs::path> sourcePaths_;
+		};
+
+		//---------------------------------------------------------------------
+		// The source files missing on the disk by module, once for all the modules.
+		std::vector<std::pair<fs::path, std::vector<fs::path>>>
+		GetMissingSourceFiles(const Plugin::CoverageData& coverageData)
+		{
+			std::vector<std::pair<fs::path, std::vector<fs::path>>> missingSourcesFiles;
+			std::unordered_set<std::wstring> sourcePaths;
+
+			for (const auto& module : coverageData.GetModules())
+			{
+				std::vector<fs::path> missingFiles;
+
+				for (const auto& file : module->GetFiles())
+				{
+					const auto& path = file->GetPath();
+					if (sourcePaths.insert(boost::to_lower_copy(path.wstring())).second && !Tools::FileExists(path))
+						missingFiles.push_back(path);
+				}
+				if (!missingFiles.empty())
+					missingSourcesFiles.emplace_back(module->GetPath(), std::move(missingFiles));
+			}
+			return missingSourcesFiles;
+		}
+
+		//---------------------------------------------------------------------
+		bool RunCommand(const std::wstring& command)
+		{
+			std::vector<wchar_t> commandLine{ command.begin(), command.end() };
+			commandLine.push_back(L'\0');
+			STARTUPINFOW startupInfo{};
+			startupInfo.cb = sizeof(startupInfo);
+			PROCESS_INFORMATION processInformation{};
+
+			if (!CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE,
+			                    CREATE_NO_WINDOW, nullptr, nullptr, &startupInfo, &processInformation))
+			{
+				LOG_WARNING << L"Cannot run " << command << L": " << GetLastError();
+				return false;
+			}
+			auto process = CreateHandle(processInformation.hProcess, CloseHandle);
+			auto thread = CreateHandle(processInformation.hThread, CloseHandle);
+
+			if (WaitForSingleObject(process.GetValue(), CommandTimeoutMilliseconds) != WAIT_OBJECT_0)
+			{
+				LOG_WARNING << L"Timeout when running " << command;
+				TerminateProcess(process.GetValue(), 1);
+				return false;
+			}
+			DWORD exitCode = 0;
+			return GetExitCodeProcess(process.GetValue(), &exitCode) && exitCode == 0;
+		}
+
+		//---------------------------------------------------------------------
+		// The program is the first token of the command, quoted or not.
+		std::wstring GetProgram(const std::wstring& command)
+		{
+			auto begin = command.find_first_not_of(L' ');
+			if (begin == std::wstring::npos)
+				return L"";
+			if (command[begin] == L'"')
+				return command.substr(begin + 1, command.find(L'"', begin + 1) - begin - 1);
+			return command.substr(begin, command.find(L' ', begin) - begin);
+		}
+
+		//---------------------------------------------------------------------
+		// Another run using the same folder never reads a partial file.
+		bool Publish(const fs::path& temporaryPath, const fs::path& localPath)
+		{
+			std::error_code error;
+
+			if (Tools::FileExists(temporaryPath))
+				fs::rename(temporaryPath, localPath, error);
+			if (!error)
+				return Tools::FileExists(localPath);
+			fs::remove(temporaryPath, error);
+			return Tools::FileExists(localPath);
+		}
+
+		//---------------------------------------------------------------------
+		bool FetchFile(const SourceServerStream::Extraction& extraction, const fs::path& localPath)
+		{
+			if (Tools::FileExists(localPath))
+				return true;
+			if (extraction.command_.empty() && !IsUrl(extraction.target_))
+				return false;
+
+			Tools::CreateParentFolderIfNeeded(localPath);
+			auto temporaryPath = localPath;
+			temporaryPath += L".download";
+			if (!extraction.command_.empty())
+			{
+				// The command writes to the target: it is redirected to the temporary file.
+				if (extraction.command_.find(extraction.target_) == std::wstring::npos)
+				{
+					LOG_WARNING << L"The command " << extraction.command_ << L" does not write to " << extraction.target_;
+					return false;
+				}
+				auto command = boost::replace_all_copy(extraction.command_, extraction.target_, temporaryPath.wstring());
+				if (!RunCommand(command))
+				{
+					std::error_code error;
+					fs::remove(temporaryPath, error);
+					return false;
+				}
+				return Publish(temporaryPath, localPath);
+			}
+
+			if (URLDownloadToFileW(nullptr, extraction.target_.c_str(), temporaryPath.c_str(), 0, nullptr) != S_OK)
+			{
+				std::error_code error;
+				fs::remove(temporaryPath, error);
+				return false;
+			}
+			return Publish(temporaryPath, localPath);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	SourceServerFetcher::SourceServerFetcher(
+		const fs::path& cacheFolder,
+		const std::vector<std::wstring>& allowedPrograms)
+		: cacheFolder_{ cacheFolder }
+	{
+		for (const auto& program : allowedPrograms)
+			allowedPrograms_.push_back(boost::to_lower_copy(program));
+	}
+
+	//-------------------------------------------------------------------------
+	size_t SourceServerFetcher::Fetch(
+		const Plugin::CoverageData& coverageData,
+		Tools::SourceFileCache& sourceFileCache) const
+	{
+		// Several source files can be extracted to the same local file.
+		std::map<fs::path, PendingFetch> fetches;
+		size_t disallowedCommandCount = 0;
+
+		for (const auto& missingSourceFiles : GetMissingSourceFiles(coverageData))
+		{
+			const auto& modulePath = missingSourceFiles.first;
+
+			try
+			{
+				auto content = NativePdbReader::ReadSourceServerStream(modulePath);
+				if (!content)
+					continue;
+
+				SourceServerStream sourceServerStream{ *content };
+				for (const auto& sourcePath : missingSourceFiles.second)
+				{
+					if (auto extraction = sourceServerStream.GetExtraction(sourcePath, cacheFolder_))
+					{
+						if (!extraction->command_.empty() && !IsAllowedCommand(extraction->command_))
+						{
+							LOG_DEBUG << L"The source server command is not allowed: " << extraction->command_;
+							++disallowedCommandCount;
+							continue;
+						}
+						auto& fetch = fetches[GetLocalPath(*extraction)];
+						fetch.extraction_ = *extraction;
+						fetch.sourcePaths_.push_back(sourcePath);
+					}
+				}
+			}
+			catch (const std::exception& e)
+			{
+				LOG_WARNING << L"Cannot read the source server stream of " << modulePath.wstring() << L": " << e.what();
+			}
+		}
+
+		if (disallowedCommandCount)
+		{
+			LOG_WARNING << disallowedCommandCount << L" source files are not fetched because their "
+			            << L"source server command runs a program which is not allowed.";
+		}
+
+		// The downloads and the commands mostly wait: one file by task.
+		std::vector<const std::pair<const fs::path, PendingFetch>*> pendingFetches;
+		for (const auto& fetch : fetches)
+			pendingFetches.push_back(&fetch);
+		std::atomic<size_t> localCopyCount{ 0 };
+		Tools::ParallelFor(pendingFetches.size(), 1, [&](size_t i) {
+			const auto& localPath = pendingFetches[i]->first;
+			const auto& fetch = pendingFetches[i]->second;
+
+			if (!FetchFile(fetch.extraction_, localPath))
+			{
+				LOG_WARNING << L"Cannot fetch " << fetch.sourcePaths_.front().wstring() << L" from the source server.";
+				return;
+			}
+			for (const auto& sourcePath : fetch.sourcePaths_)
+				sourceFileCache.SetLocalCopy(sourcePath, localPath);
+			localCopyCount += fetch.sourcePaths_.size();
+		});
+
+		if (!fetches.empty())
+			LOG_INFO << localCopyCount.load() << L" source files fetched from the source servers.";
+		return localCopyCount.load();
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path SourceServerFetcher::GetLocalPath(const SourceServerStream::Extraction& extraction) const
+	{
+		const auto& target = extraction.target_;
+		if (!extraction.command_.empty() || !IsUrl(target))
+			return target;
+
+		// The URL contains the revision of the file.
+		auto hash = Tools::Fnv1a(Tools::Fnv1aOffsetBasis, target.c_str(), target.size() * sizeof(target[0]));
+		std::wostringstream folder;
+		folder << std::hex << std::setw(16) << std::setfill(L'0') << hash;
+
+		auto filename = target.substr(target.find_last_of(L'/') + 1);
+		filename = filename.substr(0, filename.find_first_of(L"?#"));
+		return cacheFolder_ / folder.str() / (filename.empty() ? L"source" : filename);
+	}
+
+	//-------------------------------------------------------------------------
+	bool SourceServerFetcher::IsAllowedCommand(const std::wstring& command) const
+	{
+		// A program with a folder is allowed only by its full path.
+		auto program = boost::to_lower_copy(GetProgram(command));
+
+		if (program.empty())
+			return false;
+		for (const auto& allowedProgram : allowedPrograms_)
+		{
+			if (program == allowedProgram || program == allowedProgram + L".exe" ||
+			    program + L".exe" == allowedProgram)
+				return true;
+		}
+		return false;
+	}
+}
@@ -0,0 +1,70 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+#include "SourceServerStream.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Tools
+{
+	class SourceFileCache;
+}
+
+namespace CppCoverage
+{
+	// Fetch the source files missing on the disk from the srcsrv streams of
+	// the PDBs of their modules into a local folder, in parallel. A file is
+	// not fetched again when it is already in the folder: the extracted path
+	// contains the revision of the file for the usual srcsrv indexers.
+	// The SRCSRVCMD commands come from the PDBs: only the commands running
+	// one of the allowed programs, such as tf.exe, are run. A command writes
+	// into a temporary file which is renamed once the command succeeds.
+	class CPPCOVERAGE_DLL SourceServerFetcher
+	{
+	public:
+		// allowedPrograms are the programs as written in the commands, such as
+		// tf.exe or C:\Tools\tf.exe, compared case-insensitively and ".exe"
+		// can be omitted. No command is run when it is empty.
+		SourceServerFetcher(const std::filesystem::path& cacheFolder,
+		                    const std::vector<std::wstring>& allowedPrograms);
+
+		// Set the local copies of the fetched files in sourceFileCache.
+		// Return the number of source files which have a local copy.
+		size_t Fetch(const Plugin::CoverageData&, Tools::SourceFileCache&) const;
+
+		// The path of the file in the cache folder for an http target.
+		std::filesystem::path GetLocalPath(const SourceServerStream::Extraction&) const;
+
+		bool IsAllowedCommand(const std::wstring& command) const;
+
+	private:
+		SourceServerFetcher(const SourceServerFetcher&) = delete;
+		SourceServerFetcher& operator=(const SourceServerFetcher&) = delete;
+
+		const std::filesystem::path cacheFolder_;
+		std::vector<std::wstring> allowedPrograms_;
+	};
+}
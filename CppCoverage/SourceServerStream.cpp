@@ -0,0 +1,221 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SourceServerStream.hpp"
+
+#include <sstream>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		const std::wstring SectionPrefix = L"SRCSRV:";
+		const std::wstring TargetVariable = L"srcsrvtrg";
+		const std::wstring CommandVariable = L"srcsrvcmd";
+		const std::wstring TargetFolderVariable = L"targ";
+		// The variables used by a variable are expanded recursively.
+		const int MaxExpansionDepth = 32;
+
+		enum class Section
+		{
+			None,
+			Ini,
+			Variables,
+			SourceFiles,
+			End
+		};
+
+		//---------------------------------------------------------------------
+		Section GetSection(const std::wstring& line)
+		{
+			auto name = boost::trim_copy(line.substr(SectionPrefix.size()));
+
+			if (boost::istarts_with(name, L"ini"))
+				return Section::Ini;
+			if (boost::istarts_with(name, L"variables"))
+				return Section::Variables;
+			if (boost::istarts_with(name, L"source files"))
+				return Section::SourceFiles;
+			if (boost::istarts_with(name, L"end"))
+				return Section::End;
+			THROW(L"Invalid srcsrv stream: unknown section " << line);
+		}
+
+		//---------------------------------------------------------------------
+		size_t FindClosingParenthesis(const std::wstring& text, size_t openingParenthesis)
+		{
+			int depth = 0;
+
+			for (auto i = openingParenthesis; i < text.size(); ++i)
+			{
+				if (text[i] == L'(')
+					++depth;
+				else if (text[i] == L')' && --depth == 0)
+					return i;
+			}
+			THROW(L"Invalid srcsrv stream: missing ) in " << text);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsFunction(const std::wstring& name)
+		{
+			return name == L"fnvar" || name == L"fnbksl" || name == L"fnfile";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	SourceServerStream::SourceServerStream(const std::string& content)
+	{
+		std::istringstream istr{ content };
+		std::string localLine;
+		auto section = Section::None;
+
+		while (section != Section::End && std::getline(istr, localLine))
+		{
+			auto line = boost::trim_right_copy(Tools::LocalToWString(localLine));
+
+			if (boost::istarts_with(line, SectionPrefix))
+				section = GetSection(line);
+			else if (!line.empty())
+			{
+				if (section == Section::SourceFiles)
+				{
+					std::vector<std::wstring> fields;
+					boost::split(fields, line, [](wchar_t c) { return c == L'*'; });
+					sourceFiles_[boost::to_lower_copy(fields[0])] = std::move(fields);
+					continue;
+				}
+
+				auto separator = line.find(L'=');
+				if (section == Section::None || separator == std::wstring::npos)
+					THROW(L"Invalid srcsrv stream: " << line);
+				variables_[boost::to_lower_copy(line.substr(0, separator))] = line.substr(separator + 1);
+			}
+		}
+		if (section != Section::End)
+			THROW(L"Invalid srcsrv stream: missing end section.");
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::filesystem::path> SourceServerStream::GetSourcePaths() const
+	{
+		std::vector<std::filesystem::path> sourcePaths;
+
+		for (const auto& sourceFile : sourceFiles_)
+			sourcePaths.push_back(sourceFile.second[0]);
+		return sourcePaths;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<SourceServerStream::Extraction> SourceServerStream::GetExtraction(
+		const std::filesystem::path& sourcePath,
+		const std::filesystem::path& targetFolder) const
+	{
+		auto it = sourceFiles_.find(boost::to_lower_copy(sourcePath.wstring()));
+		if (it == sourceFiles_.end())
+			return boost::none;
+
+		// The fields of the source file are not expanded.
+		Variables fileVariables;
+		const auto& fields = it->second;
+		for (size_t i = 0; i < fields.size(); ++i)
+			fileVariables[L"var" + std::to_wstring(i + 1)] = fields[i];
+		fileVariables[TargetFolderVariable] = targetFolder.wstring();
+
+		Extraction extraction;
+		extraction.target_ = GetVariable(TargetVariable, fileVariables, 0);
+		if (extraction.target_.empty())
+			THROW(L"Invalid srcsrv stream: no target for " << sourcePath.wstring());
+		fileVariables[TargetVariable] = extraction.target_;
+		extraction.command_ = GetVariable(CommandVariable, fileVariables, 0);
+
+		return extraction;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring SourceServerStream::Expand(
+		const std::wstring& text,
+		const Variables& fileVariables,
+		int depth) const
+	{
+		if (depth > MaxExpansionDepth)
+			THROW(L"Invalid srcsrv stream: recursive variable in " << text);
+
+		std::wstring result;
+		size_t position = 0;
+
+		while (position < text.size())
+		{
+			auto begin = text.find(L'%', position);
+			auto end = begin == std::wstring::npos ? begin : text.find(L'%', begin + 1);
+
+			if (end == std::wstring::npos)
+			{
+				result.append(text, position, std::wstring::npos);
+				break;
+			}
+			result.append(text, position, begin - position);
+			auto name = boost::to_lower_copy(text.substr(begin + 1, end - begin - 1));
+			position = end + 1;
+
+			if (!IsFunction(name) || position == text.size() || text[position] != L'(')
+			{
+				result += GetVariable(name, fileVariables, depth);
+				continue;
+			}
+
+			auto closingParenthesis = FindClosingParenthesis(text, position);
+			auto argument = Expand(
+				text.substr(position + 1, closingParenthesis - position - 1), fileVariables, depth + 1);
+			position = closingParenthesis + 1;
+
+			if (name == L"fnvar")
+				result += GetVariable(boost::to_lower_copy(argument), fileVariables, depth);
+			else if (name == L"fnbksl")
+				result += boost::replace_all_copy(argument, L"/", L"\\");
+			else
+				result += argument.substr(argument.find_last_of(L"/\\") + 1);
+		}
+		return result;
+	}
+
+	//-------------------------------------------------------------------------
+	// Empty for an unknown variable.
+	std::wstring SourceServerStream::GetVariable(
+		const std::wstring& name,
+		const Variables& fileVariables,
+		int depth) const
+	{
+		auto fileVariable = fileVariables.find(name);
+		if (fileVariable != fileVariables.end())
+			return fileVariable->second;
+
+		auto variable = variables_.find(name);
+		if (variable == variables_.end())
+			return L"";
+		return Expand(variable->second, fileVariables, depth + 1);
+	}
+}
@@ -0,0 +1,69 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// The srcsrv stream of a source-indexed PDB: the variables of the version
+	// control system and the fields of each indexed source file. A source
+	// file is extracted by expanding SRCSRVTRG, the path of the extracted
+	// file, and SRCSRVCMD, the command which writes it. SRCSRVTRG is an http
+	// URL or the path of an existing file when there is no command.
+	// The variable names are case-insensitive. %fnvar%(), %fnbksl%() and
+	// %fnfile%() are supported.
+	class CPPCOVERAGE_DLL SourceServerStream
+	{
+	public:
+		struct Extraction
+		{
+			// Empty when the file is read from target_.
+			std::wstring command_;
+			std::wstring target_;
+		};
+
+		// Throw CppCoverageException when the stream is invalid.
+		explicit SourceServerStream(const std::string& content);
+
+		std::vector<std::filesystem::path> GetSourcePaths() const;
+
+		// targetFolder is the value of %targ%.
+		// boost::none when the source file is not indexed.
+		// Throw CppCoverageException when a variable cannot be expanded.
+		boost::optional<Extraction> GetExtraction(
+			const std::filesystem::path& sourcePath,
+			const std::filesystem::path& targetFolder) const;
+
+	private:
+		using Variables = std::unordered_map<std::wstring, std::wstring>;
+
+		std::wstring Expand(const std::wstring&, const Variables& fileVariables, int depth) const;
+		std::wstring GetVariable(const std::wstring& name, const Variables& fileVariables, int depth) const;
+
+		Variables variables_;
+		// The fields of the source files by lowercase path:
+		// var1 is the path, var2 the next field...
+		std::unordered_map<std::wstring, std::vector<std::wstring>> sourceFiles_;
+	};
+}
@@ -48,6 +48,7 @@ namespace CppCoverage
 		: path_{ std::move(startInfo.path_) }
 		, arguments_( std::move(startInfo.arguments_) )
 		, workingDirectory_{ std::move(startInfo.workingDirectory_) }
+		, environmentVariables_( std::move(startInfo.environmentVariables_) )
 	{
 	}
 
@@ -64,6 +65,14 @@ namespace CppCoverage
 		arguments_.push_back(argument);
 	}
 
+	//-------------------------------------------------------------------------
+	void StartInfo::AddEnvironmentVariable(
+		const std::wstring& name,
+		const std::wstring& value)
+	{
+		environmentVariables_.emplace_back(name, value);
+	}
+
 	//-------------------------------------------------------------------------
 	const std::filesystem::path& StartInfo::GetPath() const
 	{
@@ -84,6 +93,12 @@ namespace CppCoverage
 		return nullptr;
 	}
 
+	//-------------------------------------------------------------------------
+	const StartInfo::EnvironmentVariables& StartInfo::GetEnvironmentVariables() const
+	{
+		return environmentVariables_;
+	}
+
 	//-------------------------------------------------------------------------
 	std::wostream& operator<<(std::wostream& ostr, const StartInfo& startInfo)
 	{
@@ -101,6 +116,8 @@ namespace CppCoverage
 			ostr << *startInfo.workingDirectory_;
 		else
 			ostr << L"not set.";
+		for (const auto& variable : startInfo.environmentVariables_)
+			ostr << std::endl << L"Environment: " << variable.first << L'=' << variable.second;
 		return ostr;
 	}
 }
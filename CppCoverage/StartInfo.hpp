@@ -18,6 +18,7 @@
 
 #include <string>
 #include <vector>
+#include <utility>
 #include <iosfwd>
 #include <boost/optional.hpp>
 #include <filesystem>
@@ -38,10 +39,14 @@ namespace CppCoverage
 
 		void SetWorkingDirectory(const std::filesystem::path&);
 		void AddArgument(const std::wstring&);
+		// Added to the environment of the current process.
+		void AddEnvironmentVariable(const std::wstring& name, const std::wstring& value);
 
 		const std::filesystem::path& GetPath() const;
 		const std::vector<std::wstring>& GetArguments() const;
 		const std::filesystem::path* GetWorkingDirectory() const;
+		using EnvironmentVariables = std::vector<std::pair<std::wstring, std::wstring>>;
+		const EnvironmentVariables& GetEnvironmentVariables() const;
 
 		friend CPPCOVERAGE_DLL std::wostream& operator<<(std::wostream& ostr, const StartInfo&);
 
@@ -49,6 +54,7 @@ namespace CppCoverage
 		std::filesystem::path path_;
 		std::vector<std::wstring> arguments_;
 		boost::optional<std::filesystem::path> workingDirectory_;
+		EnvironmentVariables environmentVariables_;
 	};
 }
 
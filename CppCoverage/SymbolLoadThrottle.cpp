@@ -0,0 +1,121 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SymbolLoadThrottle.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+#include <Windows.h>
+
+#include "Tools/Log.hpp"
+#include "Tools/SecurityAttributes.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		std::atomic<unsigned int> machineConcurrency{0};
+		std::atomic<uint64_t> waitNanoseconds{0};
+		std::atomic<uint64_t> waitCount{0};
+
+		//---------------------------------------------------------------------
+		// Created once by process and never closed: the slots are only held
+		// by the scopes.
+		HANDLE GetSemaphore(unsigned int concurrency)
+		{
+			static std::once_flag semaphoreCreation;
+			static HANDLE hSemaphore = nullptr;
+
+			std::call_once(semaphoreCreation, [&]() {
+				// The count is in the name: the maximum of a semaphore is set by its creator.
+				auto name = L"Global\\OpenCppCoverage.SymbolLoads." + std::to_wstring(concurrency);
+				auto concurrencyValue = static_cast<LONG>(concurrency);
+				// The runs of the other users open the same semaphore.
+				auto securityAttributes = Tools::SecurityAttributes::CreateForAuthenticatedUsers();
+
+				hSemaphore = CreateSemaphoreW(
+				    securityAttributes.Get(), concurrencyValue, concurrencyValue, name.c_str());
+				if (!hSemaphore)
+				{
+					LOG_WARNING << L"Cannot create the semaphore " << name
+					            << L", the symbol loads are not limited: " << GetLastError();
+				}
+			});
+			return hSemaphore;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void SymbolLoadThrottle::SetMachineConcurrency(unsigned int concurrency)
+	{
+		machineConcurrency = concurrency;
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int SymbolLoadThrottle::GetMachineConcurrency()
+	{
+		return machineConcurrency;
+	}
+
+	//-------------------------------------------------------------------------
+	SymbolLoadThrottle::Scope::Scope() : hSemaphore_{nullptr}
+	{
+		auto concurrency = machineConcurrency.load();
+		if (!concurrency)
+			return;
+
+		auto hSemaphore = GetSemaphore(concurrency);
+		if (!hSemaphore)
+			return;
+
+		if (WaitForSingleObject(hSemaphore, 0) != WAIT_OBJECT_0)
+		{
+			auto waitStart = std::chrono::steady_clock::now();
+
+			if (WaitForSingleObject(hSemaphore, INFINITE) != WAIT_OBJECT_0)
+			{
+				LOG_WARNING << L"Cannot wait for the symbol load semaphore: " << GetLastError();
+				return;
+			}
+			waitNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+			                       std::chrono::steady_clock::now() - waitStart).count();
+			++waitCount;
+		}
+		hSemaphore_ = hSemaphore;
+	}
+
+	//-------------------------------------------------------------------------
+	SymbolLoadThrottle::Scope::~Scope()
+	{
+		if (hSemaphore_)
+			ReleaseSemaphore(hSemaphore_, 1, nullptr);
+	}
+
+	//-------------------------------------------------------------------------
+	std::chrono::nanoseconds SymbolLoadThrottle::GetWaitTime()
+	{
+		return std::chrono::nanoseconds{waitNanoseconds.load()};
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t SymbolLoadThrottle::GetWaitCount()
+	{
+		return waitCount;
+	}
+}
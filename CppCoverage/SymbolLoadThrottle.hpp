@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Limit the number of the PDB loads performed at the same time by all
+	// the OpenCppCoverage processes of the machine with a named semaphore.
+	// Many runs starting together would otherwise read their PDBs at the
+	// same time and the random reads are slower than the same reads one
+	// after another.
+	class CPPCOVERAGE_DLL SymbolLoadThrottle
+	{
+	public:
+		// 0, the default, disables the limit. The runs must use the same
+		// value to share the same semaphore.
+		static void SetMachineConcurrency(unsigned int);
+		static unsigned int GetMachineConcurrency();
+
+		// Hold a slot of the machine until the destruction. Do not nest on
+		// the same thread.
+		class CPPCOVERAGE_DLL Scope
+		{
+		public:
+			Scope();
+			~Scope();
+
+		private:
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+			void* hSemaphore_;
+		};
+
+		// Time waited by this process for a slot and the number of the waits.
+		static std::chrono::nanoseconds GetWaitTime();
+		static uint64_t GetWaitCount();
+
+	private:
+		SymbolLoadThrottle() = delete;
+	};
+}
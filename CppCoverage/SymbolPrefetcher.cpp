@@ -0,0 +1,258 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SymbolPrefetcher.hpp"
+
+#include <Windows.h>
+#include <urlmon.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+
+#include "Tools/Log.hpp"
+
+#include "PdbReference.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		// The debuggee is suspended while it waits for a PDB.
+		const auto PdbDownloadTimeout = std::chrono::minutes{5};
+
+		//---------------------------------------------------------------------
+		bool IsUrl(const std::wstring& symbolServer)
+		{
+			return boost::istarts_with(symbolServer, L"http://") ||
+			       boost::istarts_with(symbolServer, L"https://");
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::wstring> TrimSymbolServers(const std::vector<std::wstring>& symbolServers)
+		{
+			std::vector<std::wstring> trimmedSymbolServers;
+			for (const auto& symbolServer : symbolServers)
+				trimmedSymbolServers.push_back(boost::trim_right_copy_if(symbolServer, boost::is_any_of(L"/\\")));
+			return trimmedSymbolServers;
+		}
+
+		//---------------------------------------------------------------------
+		bool Download(const std::wstring& symbolServer,
+		              const std::filesystem::path& relativePath,
+		              const std::filesystem::path& destination)
+		{
+			if (IsUrl(symbolServer))
+			{
+				auto url = symbolServer + L'/' + relativePath.generic_wstring();
+				return URLDownloadToFileW(nullptr, url.c_str(), destination.c_str(), 0, nullptr) == S_OK;
+			}
+
+			std::error_code error;
+			return std::filesystem::copy_file(std::filesystem::path{symbolServer} / relativePath,
+			                                  destination,
+			                                  std::filesystem::copy_options::overwrite_existing,
+			                                  error);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	SymbolPrefetcher::SymbolPrefetcher(const std::vector<std::wstring>& symbolServers,
+	                                   const std::filesystem::path& cacheFolder,
+	                                   size_t downloadCount)
+		: symbolServers_{TrimSymbolServers(symbolServers)}
+		, cacheFolder_{cacheFolder}
+		, isStopped_{false}
+	{
+		for (size_t i = 0; i < (std::max)(downloadCount, size_t{1}); ++i)
+			threads_.emplace_back([this]() { DownloadPdbs(); });
+	}
+
+	//-------------------------------------------------------------------------
+	SymbolPrefetcher::~SymbolPrefetcher()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			isStopped_ = true;
+			pendingPdbs_.clear();
+		}
+		condition_.notify_all();
+		for (auto& thread : threads_)
+			thread.join();
+	}
+
+	//-------------------------------------------------------------------------
+	void SymbolPrefetcher::Prefetch(const std::vector<std::filesystem::path>& modulePaths)
+	{
+		for (const auto& modulePath : modulePaths)
+			StartDownload(modulePath);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::filesystem::path>
+	SymbolPrefetcher::GetPdbFolder(const std::filesystem::path& modulePath)
+	{
+		auto relativePath = StartDownload(modulePath);
+		if (!relativePath)
+			return boost::none;
+
+		std::unique_lock<std::mutex> lock{mutex_};
+		const auto& state = downloadStates_.at(*relativePath);
+
+		// The debuggee waits for this PDB: it is downloaded first.
+		auto it = std::find(pendingPdbs_.begin(), pendingPdbs_.end(), *relativePath);
+		if (it != pendingPdbs_.end())
+		{
+			pendingPdbs_.erase(it);
+			pendingPdbs_.push_front(*relativePath);
+		}
+		auto isDone = condition_.wait_for(lock, PdbDownloadTimeout, [&]() {
+			return isStopped_ || state == DownloadState::Downloaded || state == DownloadState::Failed;
+		});
+		if (!isDone)
+		{
+			LOG_WARNING << L"Timeout while downloading " << relativePath->wstring();
+			return boost::none;
+		}
+		if (state != DownloadState::Downloaded)
+			return boost::none;
+		return (cacheFolder_ / *relativePath).parent_path();
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path SymbolPrefetcher::GetRelativePath(const PdbReference& pdbReference)
+	{
+		const auto& guid = pdbReference.guid_;
+		std::wostringstream ostr;
+
+		ostr << std::hex << std::uppercase << std::setfill(L'0')
+		     << std::setw(8) << guid.Data1 << std::setw(4) << guid.Data2
+		     << std::setw(4) << guid.Data3;
+		for (auto byte : guid.Data4)
+			ostr << std::setw(2) << static_cast<int>(byte);
+		ostr << pdbReference.age_;
+
+		auto pdbFilename = pdbReference.pdbPath_.filename();
+		return pdbFilename / ostr.str() / pdbFilename;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::filesystem::path>
+	SymbolPrefetcher::StartDownload(const std::filesystem::path& modulePath)
+	{
+		auto pdbReference = PdbReference::Read(modulePath);
+		if (!pdbReference || pdbReference->pdbPath_.filename().empty())
+			return boost::none;
+
+		std::error_code error;
+		if (std::filesystem::is_regular_file(pdbReference->pdbPath_, error) ||
+		    std::filesystem::is_regular_file(
+		        modulePath.parent_path() / pdbReference->pdbPath_.filename(), error))
+			return boost::none;
+
+		auto relativePath = GetRelativePath(*pdbReference);
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			if (downloadStates_.count(relativePath))
+				return relativePath;
+
+			if (std::filesystem::is_regular_file(cacheFolder_ / relativePath, error))
+				downloadStates_.emplace(relativePath, DownloadState::Downloaded);
+			else
+			{
+				downloadStates_.emplace(relativePath, DownloadState::Pending);
+				pendingPdbs_.push_back(relativePath);
+			}
+		}
+		// The waiting threads share the condition with the download threads.
+		condition_.notify_all();
+		return relativePath;
+	}
+
+	//-------------------------------------------------------------------------
+	void SymbolPrefetcher::DownloadPdbs()
+	{
+		auto isComInitialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+		std::unique_lock<std::mutex> lock{mutex_};
+
+		while (true)
+		{
+			condition_.wait(lock, [&]() { return isStopped_ || !pendingPdbs_.empty(); });
+			if (isStopped_)
+				break;
+
+			auto relativePath = pendingPdbs_.front();
+			pendingPdbs_.pop_front();
+			downloadStates_.at(relativePath) = DownloadState::Downloading;
+			lock.unlock();
+
+			auto isDownloaded = false;
+			try
+			{
+				isDownloaded = DownloadPdb(relativePath);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_WARNING << L"Cannot download " << relativePath.wstring() << L": " << e.what();
+			}
+
+			lock.lock();
+			downloadStates_.at(relativePath) =
+			    isDownloaded ? DownloadState::Downloaded : DownloadState::Failed;
+			condition_.notify_all();
+		}
+
+		lock.unlock();
+		if (isComInitialized)
+			CoUninitialize();
+	}
+
+	//-------------------------------------------------------------------------
+	bool SymbolPrefetcher::DownloadPdb(const std::filesystem::path& relativePath) const
+	{
+		auto pdbPath = cacheFolder_ / relativePath;
+		std::filesystem::create_directories(pdbPath.parent_path());
+
+		// Another run can download the same PDB: the file is renamed once complete.
+		auto temporaryPath = pdbPath;
+		temporaryPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." +
+		                 std::to_wstring(GetCurrentThreadId()) + L".download";
+		std::error_code error;
+
+		for (const auto& symbolServer : symbolServers_)
+		{
+			if (Download(symbolServer, relativePath, temporaryPath))
+			{
+				std::filesystem::rename(temporaryPath, pdbPath, error);
+				if (error)
+					std::filesystem::remove(temporaryPath, error);
+				if (std::filesystem::is_regular_file(pdbPath, error))
+				{
+					LOG_INFO << L"Downloaded " << relativePath.wstring() << L" from " << symbolServer;
+					return true;
+				}
+			}
+		}
+		std::filesystem::remove(temporaryPath, error);
+		LOG_WARNING << L"Cannot download " << relativePath.wstring() << L" from the symbol servers.";
+		return false;
+	}
+}
@@ -0,0 +1,87 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	struct PdbReference;
+
+	// Download the PDBs not found next to their module from symbol servers
+	// into a local folder, on several threads. The servers and the folder
+	// use the symbol store layout: <pdb name>\<GUID><age>\<pdb name>.
+	// A server is an http or https URL or a folder, a file share for example.
+	// Compressed files (.pd_) are not supported.
+	class CPPCOVERAGE_DLL SymbolPrefetcher
+	{
+	public:
+		SymbolPrefetcher(const std::vector<std::wstring>& symbolServers,
+		                 const std::filesystem::path& cacheFolder,
+		                 size_t downloadCount);
+		// Wait for the current downloads: the pending ones are dropped.
+		~SymbolPrefetcher();
+
+		// Start the download of the PDBs of these modules.
+		void Prefetch(const std::vector<std::filesystem::path>& modulePaths);
+
+		// The folder of the downloaded PDB of the module, after its download.
+		// boost::none when the PDB is next to the module or at its recorded
+		// path, or cannot be downloaded in a few minutes.
+		boost::optional<std::filesystem::path>
+		GetPdbFolder(const std::filesystem::path& modulePath);
+
+		static std::filesystem::path GetRelativePath(const PdbReference&);
+
+	private:
+		SymbolPrefetcher(const SymbolPrefetcher&) = delete;
+		SymbolPrefetcher& operator=(const SymbolPrefetcher&) = delete;
+
+		enum class DownloadState
+		{
+			Pending,
+			Downloading,
+			Downloaded,
+			Failed
+		};
+
+		// boost::none when the PDB does not need to be downloaded.
+		boost::optional<std::filesystem::path>
+		StartDownload(const std::filesystem::path& modulePath);
+		void DownloadPdbs();
+		bool DownloadPdb(const std::filesystem::path& relativePath) const;
+
+		const std::vector<std::wstring> symbolServers_;
+		const std::filesystem::path cacheFolder_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		std::deque<std::filesystem::path> pendingPdbs_;
+		std::map<std::filesystem::path, DownloadState> downloadStates_;
+		bool isStopped_;
+		std::vector<std::thread> threads_;
+	};
+}
@@ -0,0 +1,202 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "TestImpactIndex.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "Tools/Tool.hpp"
+#include "CppCoverageException.hpp"
+#include "TestImpactIndexFormat.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		namespace Format = TestImpactIndexFormat;
+
+		//---------------------------------------------------------------------
+		uint32_t ToUInt32(size_t value)
+		{
+			if (value > (std::numeric_limits<uint32_t>::max)())
+				THROW(L"The test impact index is too big.");
+			return static_cast<uint32_t>(value);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void WriteValues(std::ostream& ostr, const std::vector<T>& values)
+		{
+			if (!values.empty())
+			{
+				ostr.write(reinterpret_cast<const char*>(values.data()),
+				           values.size() * sizeof(T));
+			}
+		}
+	}
+
+	const std::wstring TestImpactIndex::TestEndMarker = L"OpenCppCoverage: end test ";
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::wstring>
+	TestImpactIndex::ParseTestEndMarker(const std::wstring& debugString)
+	{
+		if (debugString.compare(0, TestEndMarker.size(), TestEndMarker))
+			return boost::none;
+
+		auto end = debugString.find_last_not_of(L"\r\n");
+		if (end == std::wstring::npos || end < TestEndMarker.size())
+			return boost::none;
+		return debugString.substr(TestEndMarker.size(), end + 1 - TestEndMarker.size());
+	}
+
+	//-------------------------------------------------------------------------
+	TestImpactIndex::TestImpactIndex() = default;
+
+	//-------------------------------------------------------------------------
+	TestImpactIndex::~TestImpactIndex() = default;
+
+	//-------------------------------------------------------------------------
+	void TestImpactIndex::AddTest(const std::wstring& testName,
+	                              const LinesByFile& linesByFile)
+	{
+		auto& test = tests_[testName];
+
+		for (const auto& pair : linesByFile)
+		{
+			if (!pair.second.empty())
+				test[GetFileId(pair.first)].insert(pair.second.begin(), pair.second.end());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TestImpactIndex::GetTestCount() const
+	{
+		return tests_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TestImpactIndex::GetFileCount() const
+	{
+		return files_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	TestImpactIndex::LinesByFile
+	TestImpactIndex::GetLines(const std::wstring& testName) const
+	{
+		LinesByFile linesByFile;
+		auto it = tests_.find(testName);
+
+		if (it != tests_.end())
+		{
+			for (const auto& pair : it->second)
+				linesByFile.emplace(files_.at(pair.first), pair.second);
+		}
+		return linesByFile;
+	}
+
+	//-------------------------------------------------------------------------
+	void TestImpactIndex::Write(std::ostream& ostr) const
+	{
+		std::string strings;
+		auto addString = [&strings](const std::wstring& str) {
+			auto utf8 = Tools::ToUtf8String(str);
+			Format::String string{ToUInt32(strings.size()), ToUInt32(utf8.size())};
+			strings += utf8;
+			return string;
+		};
+
+		// Test ids follow the order of tests_ which is sorted by name.
+		std::vector<Format::TestEntry> testEntries;
+		std::vector<std::map<unsigned int, std::vector<uint32_t>>> testIdsByLineByFile(files_.size());
+		for (const auto& test : tests_)
+		{
+			auto testId = ToUInt32(testEntries.size());
+			testEntries.push_back({addString(test.first)});
+			for (const auto& pair : test.second)
+			{
+				auto& testIdsByLine = testIdsByLineByFile.at(pair.first);
+				for (auto line : pair.second)
+					testIdsByLine[line].push_back(testId);
+			}
+		}
+
+		// fileIds_ is sorted by path.
+		std::vector<Format::FileEntry> fileEntries;
+		std::vector<Format::LineEntry> lineEntries;
+		std::vector<uint32_t> postings;
+		for (const auto& file : fileIds_)
+		{
+			const auto& testIdsByLine = testIdsByLineByFile.at(file.second);
+			fileEntries.push_back({addString(file.first),
+			                       ToUInt32(lineEntries.size()),
+			                       ToUInt32(testIdsByLine.size())});
+			for (const auto& pair : testIdsByLine)
+			{
+				lineEntries.push_back({pair.first,
+				                       ToUInt32(postings.size()),
+				                       ToUInt32(pair.second.size())});
+				postings.insert(postings.end(), pair.second.begin(), pair.second.end());
+			}
+		}
+
+		Format::Header header;
+		std::memcpy(header.magic_, Format::Magic, sizeof(header.magic_));
+		header.version_ = Format::Version;
+		header.testCount_ = ToUInt32(testEntries.size());
+		header.fileCount_ = ToUInt32(fileEntries.size());
+		header.lineCount_ = ToUInt32(lineEntries.size());
+		header.postingCount_ = ToUInt32(postings.size());
+		header.stringsSize_ = ToUInt32(strings.size());
+
+		ostr.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		WriteValues(ostr, testEntries);
+		WriteValues(ostr, fileEntries);
+		WriteValues(ostr, lineEntries);
+		WriteValues(ostr, postings);
+		ostr.write(strings.data(), strings.size());
+	}
+
+	//-------------------------------------------------------------------------
+	void TestImpactIndex::Write(const std::filesystem::path& path) const
+	{
+		Tools::CreateParentFolderIfNeeded(path);
+		std::ofstream ofs{path, std::ios::binary};
+
+		if (!ofs)
+			THROW(L"Cannot open test impact index: " << path.wstring());
+		Write(ofs);
+		Tools::ShowOutputMessage(L"Test impact index generated: ", path);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TestImpactIndex::GetFileId(const std::wstring& filePath)
+	{
+		auto it = fileIds_.find(filePath);
+
+		if (it == fileIds_.end())
+		{
+			it = fileIds_.emplace(filePath, files_.size()).first;
+			files_.push_back(filePath);
+		}
+		return it->second;
+	}
+}
@@ -0,0 +1,70 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <filesystem>
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Lines executed by each test. The index is written with the inverted
+	// layout of TestImpactIndexFormat and read by TestImpactIndexReader.
+	class CPPCOVERAGE_DLL TestImpactIndex
+	{
+	  public:
+		using LinesByFile = std::map<std::wstring, std::set<unsigned int>>;
+
+		// Followed by the name of the test.
+		static const std::wstring TestEndMarker;
+
+		// Return the test name if debugString is a TestEndMarker. Trailing new
+		// line characters are ignored.
+		static boost::optional<std::wstring>
+		ParseTestEndMarker(const std::wstring& debugString);
+
+		TestImpactIndex();
+		~TestImpactIndex();
+
+		// The lines are merged if the test is already in the index.
+		void AddTest(const std::wstring& testName, const LinesByFile&);
+
+		size_t GetTestCount() const;
+		size_t GetFileCount() const;
+		LinesByFile GetLines(const std::wstring& testName) const;
+
+		void Write(std::ostream&) const;
+		void Write(const std::filesystem::path&) const;
+
+	  private:
+		TestImpactIndex(const TestImpactIndex&) = delete;
+		TestImpactIndex& operator=(const TestImpactIndex&) = delete;
+
+		size_t GetFileId(const std::wstring& filePath);
+
+		std::vector<std::wstring> files_;
+		std::map<std::wstring, size_t> fileIds_;
+		std::map<std::wstring, std::map<size_t, std::set<unsigned int>>> tests_;
+	};
+}
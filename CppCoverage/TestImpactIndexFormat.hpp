@@ -0,0 +1,75 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace CppCoverage
+{
+	// Binary layout of the test impact index. The index is inverted: for each
+	// file line, the postings are the ids of the tests executing the line so
+	// a query only reads the lines of the changed files. All values are
+	// little endian and the sections follow each other in this order:
+	//   Header
+	//   TestEntry[testCount_]         sorted by test name
+	//   FileEntry[fileCount_]         sorted by file path
+	//   LineEntry[lineCount_]         grouped by file and sorted by line
+	//   uint32_t[postingCount_]       test ids, sorted for each line
+	//   char[stringsSize_]            UTF-8 test names and file paths
+	namespace TestImpactIndexFormat
+	{
+		const char Magic[8] = {'O', 'C', 'C', 'T', 'I', 'I', 'D', 'X'};
+		const uint32_t Version = 1;
+
+		struct Header
+		{
+			char magic_[8];
+			uint32_t version_;
+			uint32_t testCount_;
+			uint32_t fileCount_;
+			uint32_t lineCount_;
+			uint32_t postingCount_;
+			uint32_t stringsSize_;
+		};
+
+		struct String
+		{
+			uint32_t offset_;
+			uint32_t size_;
+		};
+
+		struct TestEntry
+		{
+			String name_;
+		};
+
+		struct FileEntry
+		{
+			String path_;
+			uint32_t firstLine_;
+			uint32_t lineCount_;
+		};
+
+		struct LineEntry
+		{
+			uint32_t lineNumber_;
+			uint32_t firstPosting_;
+			uint32_t postingCount_;
+		};
+	}
+}
@@ -0,0 +1,183 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "TestImpactIndexReader.hpp"
+
+#include <cstring>
+#include <set>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "FileFilter/UnifiedDiffCoverageFilter.hpp"
+#include "Tools/Tool.hpp"
+
+#include "CppCoverageException.hpp"
+#include "TestImpactIndexFormat.hpp"
+#include "UnifiedDiffSettings.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		namespace Format = TestImpactIndexFormat;
+
+		//---------------------------------------------------------------------
+		void CheckRange(uint64_t first, uint64_t count, uint64_t size)
+		{
+			if (first + count > size)
+				THROW(L"The test impact index is corrupted.");
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TestImpactIndexReader::TestImpactIndexReader(const std::filesystem::path& path)
+	{
+		if (!Tools::FileExists(path))
+			THROW(L"Cannot find the test impact index: " << path.wstring());
+		if (std::filesystem::file_size(path) < sizeof(Format::Header))
+			THROW(L"Invalid test impact index: " << path.wstring());
+
+		mappedFile_ = std::make_unique<boost::iostreams::mapped_file_source>(path.string());
+		if (!mappedFile_->is_open())
+			THROW(L"Cannot open the test impact index: " << path.wstring());
+
+		const auto* data = mappedFile_->data();
+		uint64_t size = mappedFile_->size();
+		header_ = reinterpret_cast<const Format::Header*>(data);
+		if (std::memcmp(header_->magic_, Format::Magic, sizeof(header_->magic_)) ||
+		    header_->version_ != Format::Version)
+		{
+			THROW(L"Invalid test impact index: " << path.wstring());
+		}
+
+		uint64_t offset = sizeof(Format::Header);
+		auto getSection = [&](uint64_t count, uint64_t elementSize) {
+			auto section = data + offset;
+			offset += count * elementSize;
+			return section;
+		};
+		tests_ = reinterpret_cast<const Format::TestEntry*>(
+		    getSection(header_->testCount_, sizeof(Format::TestEntry)));
+		files_ = reinterpret_cast<const Format::FileEntry*>(
+		    getSection(header_->fileCount_, sizeof(Format::FileEntry)));
+		lines_ = reinterpret_cast<const Format::LineEntry*>(
+		    getSection(header_->lineCount_, sizeof(Format::LineEntry)));
+		postings_ = reinterpret_cast<const uint32_t*>(
+		    getSection(header_->postingCount_, sizeof(uint32_t)));
+		strings_ = getSection(header_->stringsSize_, sizeof(char));
+
+		if (offset != size)
+			THROW(L"Invalid test impact index: " << path.wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TestImpactIndexReader::~TestImpactIndexReader() = default;
+
+	//-------------------------------------------------------------------------
+	size_t TestImpactIndexReader::GetTestCount() const
+	{
+		return header_->testCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TestImpactIndexReader::GetFileCount() const
+	{
+		return header_->fileCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring TestImpactIndexReader::GetTestName(size_t testId) const
+	{
+		CheckRange(testId, 1, header_->testCount_);
+		return Tools::Utf8ToWString(GetString(tests_[testId].name_));
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path TestImpactIndexReader::GetFilePath(size_t fileId) const
+	{
+		CheckRange(fileId, 1, header_->fileCount_);
+		return Tools::Utf8ToWString(GetString(files_[fileId].path_));
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::wstring> TestImpactIndexReader::SelectTests(
+	    FileFilter::UnifiedDiffCoverageFilter& unifiedDiffCoverageFilter) const
+	{
+		std::vector<bool> isTestSelected(header_->testCount_);
+
+		for (size_t fileId = 0; fileId < header_->fileCount_; ++fileId)
+		{
+			auto path = GetFilePath(fileId);
+			if (!unifiedDiffCoverageFilter.IsSourceFileSelected(path))
+				continue;
+
+			const auto& file = files_[fileId];
+			CheckRange(file.firstLine_, file.lineCount_, header_->lineCount_);
+			for (auto lineId = file.firstLine_; lineId < file.firstLine_ + file.lineCount_; ++lineId)
+			{
+				const auto& line = lines_[lineId];
+				if (!unifiedDiffCoverageFilter.IsLineSelected(
+				        path, static_cast<int>(line.lineNumber_)))
+				{
+					continue;
+				}
+
+				CheckRange(line.firstPosting_, line.postingCount_, header_->postingCount_);
+				for (auto i = line.firstPosting_; i < line.firstPosting_ + line.postingCount_; ++i)
+				{
+					auto testId = postings_[i];
+					CheckRange(testId, 1, header_->testCount_);
+					isTestSelected[testId] = true;
+				}
+			}
+		}
+
+		// Test ids are sorted by name.
+		std::vector<std::wstring> selectedTests;
+		for (size_t testId = 0; testId < isTestSelected.size(); ++testId)
+		{
+			if (isTestSelected[testId])
+				selectedTests.push_back(GetTestName(testId));
+		}
+		return selectedTests;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<std::wstring> TestImpactIndexReader::SelectTests(
+	    const std::vector<UnifiedDiffSettings>& unifiedDiffSettingsCollection) const
+	{
+		std::set<std::wstring> selectedTests;
+
+		for (const auto& unifiedDiffSettings : unifiedDiffSettingsCollection)
+		{
+			FileFilter::UnifiedDiffCoverageFilter unifiedDiffCoverageFilter{
+			    unifiedDiffSettings.GetUnifiedDiffPath(),
+			    unifiedDiffSettings.GetRootDiffFolder()};
+			auto tests = SelectTests(unifiedDiffCoverageFilter);
+			selectedTests.insert(tests.begin(), tests.end());
+		}
+		return {selectedTests.begin(), selectedTests.end()};
+	}
+
+	//-------------------------------------------------------------------------
+	std::string TestImpactIndexReader::GetString(
+	    const TestImpactIndexFormat::String& string) const
+	{
+		CheckRange(string.offset_, string.size_, header_->stringsSize_);
+		return {strings_ + string.offset_, string.size_};
+	}
+}
@@ -0,0 +1,91 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
+
+namespace FileFilter
+{
+	class UnifiedDiffCoverageFilter;
+}
+
+namespace CppCoverage
+{
+	namespace TestImpactIndexFormat
+	{
+		struct Header;
+		struct String;
+		struct TestEntry;
+		struct FileEntry;
+		struct LineEntry;
+	}
+
+	class UnifiedDiffSettings;
+
+	// Read a test impact index written by TestImpactIndex. The file is memory
+	// mapped and only the sections needed by a query are accessed.
+	class CPPCOVERAGE_DLL TestImpactIndexReader
+	{
+	  public:
+		explicit TestImpactIndexReader(const std::filesystem::path&);
+		~TestImpactIndexReader();
+
+		size_t GetTestCount() const;
+		size_t GetFileCount() const;
+		std::wstring GetTestName(size_t testId) const;
+		std::filesystem::path GetFilePath(size_t fileId) const;
+
+		// Return the tests executing at least one line selected by the
+		// filter, sorted by name.
+		std::vector<std::wstring>
+		SelectTests(FileFilter::UnifiedDiffCoverageFilter&) const;
+
+		// Return the tests executing at least one line changed by one of the
+		// unified diffs, sorted by name.
+		std::vector<std::wstring>
+		SelectTests(const std::vector<UnifiedDiffSettings>&) const;
+
+	  private:
+		TestImpactIndexReader(const TestImpactIndexReader&) = delete;
+		TestImpactIndexReader& operator=(const TestImpactIndexReader&) = delete;
+
+		std::string GetString(const TestImpactIndexFormat::String&) const;
+
+		std::unique_ptr<boost::iostreams::mapped_file_source> mappedFile_;
+		const TestImpactIndexFormat::Header* header_;
+		const TestImpactIndexFormat::TestEntry* tests_;
+		const TestImpactIndexFormat::FileEntry* files_;
+		const TestImpactIndexFormat::LineEntry* lines_;
+		const uint32_t* postings_;
+		const char* strings_;
+	};
+}
@@ -0,0 +1,150 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "TraceRecorder.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+
+#include <Windows.h>
+
+#include "Tools/Tool.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		using Microseconds = std::chrono::duration<double, std::micro>;
+
+		//---------------------------------------------------------------------
+		void WriteJsonString(std::ostream& ostr, const std::string& value)
+		{
+			ostr << '"';
+			for (auto c : value)
+			{
+				if (c == '"' || c == '\\')
+					ostr << '\\' << c;
+				else if (static_cast<unsigned char>(c) < 0x20)
+					ostr << ' ';
+				else
+					ostr << c;
+			}
+			ostr << '"';
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TraceRecorder::ScopedSpan::ScopedSpan(TraceRecorder* traceRecorder,
+	                                      const char* name,
+	                                      const char* category,
+	                                      const std::wstring& detail)
+		: traceRecorder_{traceRecorder}
+		, name_{name}
+		, category_{category}
+	{
+		if (!traceRecorder_)
+			return;
+		if (!detail.empty())
+			detail_ = Tools::ToUtf8String(detail);
+		start_ = Clock::now();
+	}
+
+	//-------------------------------------------------------------------------
+	TraceRecorder::ScopedSpan::~ScopedSpan()
+	{
+		if (traceRecorder_)
+			traceRecorder_->AddSpan(name_, category_, std::move(detail_), start_, Clock::now() - start_);
+	}
+
+	//-------------------------------------------------------------------------
+	TraceRecorder::TraceRecorder() : start_{Clock::now()}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void TraceRecorder::AddSpan(const char* name,
+	                            const char* category,
+	                            std::string detail,
+	                            Clock::time_point start,
+	                            Clock::duration duration)
+	{
+		auto threadId = GetCurrentThreadId();
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		spans_.push_back({name, category, std::move(detail), threadId, start, duration});
+	}
+
+	//-------------------------------------------------------------------------
+	void TraceRecorder::SetThreadName(const std::string& name)
+	{
+		auto threadId = GetCurrentThreadId();
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto it = std::find_if(threadNames_.begin(), threadNames_.end(), [&](const auto& threadName) {
+			return threadName.first == threadId;
+		});
+
+		if (it == threadNames_.end())
+			threadNames_.emplace_back(threadId, name);
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<TraceRecorder::Span> TraceRecorder::GetSpans() const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		return spans_;
+	}
+
+	//-------------------------------------------------------------------------
+	void TraceRecorder::Write(std::ostream& ostr) const
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		auto processId = GetCurrentProcessId();
+		auto separator = "\n";
+
+		// The timestamps are in microseconds.
+		ostr << std::fixed << std::setprecision(3);
+		ostr << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+		for (const auto& threadName : threadNames_)
+		{
+			ostr << separator << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << processId
+			     << ", \"tid\": " << threadName.first << ", \"args\": {\"name\": ";
+			WriteJsonString(ostr, threadName.second);
+			ostr << "}}";
+			separator = ",\n";
+		}
+		for (const auto& span : spans_)
+		{
+			ostr << separator << "{\"name\": ";
+			WriteJsonString(ostr, span.name_);
+			ostr << ", \"cat\": ";
+			WriteJsonString(ostr, span.category_);
+			ostr << ", \"ph\": \"X\", \"ts\": " << Microseconds{span.start_ - start_}.count()
+			     << ", \"dur\": " << Microseconds{span.duration_}.count() << ", \"pid\": " << processId
+			     << ", \"tid\": " << span.threadId_;
+			if (!span.detail_.empty())
+			{
+				ostr << ", \"args\": {\"detail\": ";
+				WriteJsonString(ostr, span.detail_);
+				ostr << "}";
+			}
+			ostr << "}";
+			separator = ",\n";
+		}
+		ostr << "\n]}\n";
+	}
+}
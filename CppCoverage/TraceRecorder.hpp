@@ -0,0 +1,93 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <chrono>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Spans of a run for --trace_output, written in the Chrome trace event
+	// format with a track by thread. Can be used from several threads.
+	class CPPCOVERAGE_DLL TraceRecorder
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		struct Span
+		{
+			std::string name_;
+			std::string category_;
+			// Shown in the arguments of the span, for example a module path.
+			std::string detail_;
+			unsigned long threadId_;
+			Clock::time_point start_;
+			Clock::duration duration_;
+		};
+
+		// Record a span of the calling thread until its destruction. Nothing
+		// is recorded when traceRecorder is null.
+		class CPPCOVERAGE_DLL ScopedSpan
+		{
+		public:
+			ScopedSpan(TraceRecorder* traceRecorder,
+			           const char* name,
+			           const char* category,
+			           const std::wstring& detail = {});
+			~ScopedSpan();
+
+		private:
+			ScopedSpan(const ScopedSpan&) = delete;
+			ScopedSpan& operator=(const ScopedSpan&) = delete;
+
+			TraceRecorder* traceRecorder_;
+			const char* name_;
+			const char* category_;
+			std::string detail_;
+			Clock::time_point start_;
+		};
+
+		TraceRecorder();
+
+		// The span belongs to the calling thread.
+		void AddSpan(const char* name,
+		             const char* category,
+		             std::string detail,
+		             Clock::time_point start,
+		             Clock::duration duration);
+		// Name the track of the calling thread. A thread keeps its first name.
+		void SetThreadName(const std::string&);
+
+		std::vector<Span> GetSpans() const;
+		void Write(std::ostream&) const;
+
+	private:
+		TraceRecorder(const TraceRecorder&) = delete;
+		TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+		const Clock::time_point start_;
+		mutable std::mutex mutex_;
+		std::vector<Span> spans_;
+		std::vector<std::pair<unsigned long, std::string>> threadNames_;
+	};
+}
@@ -0,0 +1,340 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "TrampolineBuilder.hpp"
+
+#include <limits>
+
+#include "BasicBlockAnalyzer.hpp"
+#include "InstructionDecoder.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		// A relative jump of 8 bits is relocated as a jump of 32 bits.
+		const size_t MaxRelocationGrowth = 4;
+		// A jump has at least 2 bytes and only the last displaced instruction
+		// can end after TrampolineBuilder::JumpSize.
+		const size_t MaxDisplacedJumpCount = (TrampolineBuilder::JumpSize + 1) / 2;
+		// pushf, lock inc [counter]
+		const size_t CounterAddressOffset = 4;
+
+		//---------------------------------------------------------------------
+		void AddValue(std::vector<uint8_t>& code, uint32_t value)
+		{
+			for (int i = 0; i < 4; ++i)
+				code.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+
+		//---------------------------------------------------------------------
+		bool IsRelocatable(const uint8_t* code, const DecodedInstruction& instruction)
+		{
+			switch (instruction.flow_)
+			{
+			case InstructionFlow::Sequential:
+			case InstructionFlow::Return:
+				return true;
+			case InstructionFlow::Jump:
+			case InstructionFlow::ConditionalJump:
+			{
+				// loop and jecxz have no 32 bits form.
+				auto opcode = code[0];
+				return opcode == 0xEB || opcode == 0xE9 || (opcode >= 0x70 && opcode <= 0x7F) ||
+				       (opcode == 0x0F && code[1] >= 0x80 && code[1] <= 0x8F);
+			}
+			default:
+				// A call is not relocated as its return address would be
+				// inside the trampoline, which has no unwind information.
+				return false;
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// The trampolines have no unwind information: in 64 bits, an exception
+		// raised by a displaced instruction could not be dispatched to the
+		// handlers of its function. In 32 bits, the handlers are found from
+		// fs:[0] and not from the code address. Only the instructions which cannot fault are
+		// displaced: the ones with register operands only, except the divisions,
+		// and lea and nop. The stack accesses of push, pop and ret are kept as
+		// the system grows the stack on its guard page without an exception.
+		bool CannotFault(const uint8_t* code, size_t length)
+		{
+			size_t i = 0;
+			bool hasRepPrefix = false;
+
+			// A lock prefix on a register operand raises an exception.
+			for (; i < length && (code[i] == 0x66 || code[i] == 0xF3 || code[i] == 0x2E || code[i] == 0x3E); ++i)
+				hasRepPrefix = hasRepPrefix || code[i] == 0xF3;
+			if (i < length && (code[i] & 0xF0) == 0x40)
+				++i;
+			if (i >= length)
+				return false;
+
+			auto opcode = code[i];
+			auto isRegisterModRm = [&](size_t index) { return index < length && (code[index] >> 6) == 3; };
+			auto getModRmReg = [&](size_t index) { return (code[index] >> 3) & 7; };
+
+			if (hasRepPrefix)
+				return opcode == 0xC3; // rep ret
+			if (opcode < 0x40 && (opcode & 7) < 4)
+				return isRegisterModRm(i + 1); // add, or, adc, sbb, and, sub, xor, cmp
+			if (opcode < 0x40 && (opcode & 7) < 6)
+				return true; // Same with al or eax and an immediate.
+			if ((opcode >= 0x50 && opcode <= 0x5F) || (opcode >= 0x70 && opcode <= 0x7F) ||
+			    (opcode >= 0x90 && opcode <= 0x99) || (opcode >= 0xB0 && opcode <= 0xBF) ||
+			    opcode == 0xC2 || opcode == 0xC3 || opcode == 0xE9 || opcode == 0xEB)
+			{
+				return true; // push, pop, jcc, nop, xchg, cdq, mov immediate, ret, jmp
+			}
+			if (opcode == 0x8D)
+				return !isRegisterModRm(i + 1); // lea does not read the memory.
+			if (opcode == 0x63 || opcode == 0x69 || opcode == 0x6B || (opcode >= 0x80 && opcode <= 0x8B) ||
+			    opcode == 0xC0 || opcode == 0xC1 || (opcode >= 0xD0 && opcode <= 0xD3))
+			{
+				return isRegisterModRm(i + 1); // movsxd, imul, arithmetic, test, xchg, mov, shifts
+			}
+			if (opcode == 0xC6 || opcode == 0xC7)
+				return isRegisterModRm(i + 1) && getModRmReg(i + 1) == 0; // mov immediate
+			if (opcode == 0xF6 || opcode == 0xF7)
+				return isRegisterModRm(i + 1) && getModRmReg(i + 1) < 6; // test, not, neg, mul, imul
+			if (opcode == 0xFE || opcode == 0xFF)
+				return isRegisterModRm(i + 1) && getModRmReg(i + 1) < 2; // inc, dec
+			if (opcode == 0x0F && i + 1 < length)
+			{
+				auto secondOpcode = code[i + 1];
+				if (secondOpcode == 0x1F || (secondOpcode >= 0x80 && secondOpcode <= 0x8F))
+					return true; // nop, jcc
+				if ((secondOpcode >= 0x40 && secondOpcode <= 0x4F) || (secondOpcode >= 0x90 && secondOpcode <= 0x9F) ||
+				    secondOpcode == 0xAF || secondOpcode == 0xB6 || secondOpcode == 0xB7 ||
+				    secondOpcode == 0xBE || secondOpcode == 0xBF)
+				{
+					return isRegisterModRm(i + 2); // cmov, setcc, imul, movzx, movsx
+				}
+			}
+			return false;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TrampolineBuilder::TrampolineBuilder(bool is64Bits) : is64Bits_{is64Bits}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> TrampolineBuilder::GetDisplacedSize(
+	    const uint8_t* code,
+	    size_t size,
+	    uint64_t address,
+	    const BasicBlockAnalyzer& analyzer) const
+	{
+		return ComputeDisplacedSize(code, size, address, analyzer, false, false);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> TrampolineBuilder::GetDisplacedSizeInImage(
+	    const uint8_t* code,
+	    size_t size,
+	    uint64_t address,
+	    const BasicBlockAnalyzer& analyzer,
+	    bool canFault) const
+	{
+		return ComputeDisplacedSize(code, size, address, analyzer, true, canFault);
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TrampolineBuilder::GetMaxTrampolineSize(size_t displacedSize,
+	                                               size_t counterCount) const
+	{
+		size_t counterIncrementSize = is64Bits_ ? 10 : 9;
+
+		return counterCount * counterIncrementSize + displacedSize +
+		       MaxDisplacedJumpCount * MaxRelocationGrowth + JumpSize;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::vector<uint8_t>> TrampolineBuilder::Build(
+	    const uint8_t* displacedCode,
+	    size_t displacedSize,
+	    uint64_t address,
+	    uint64_t trampolineAddress,
+	    const std::vector<Counter>& counters,
+	    Layout* layout) const
+	{
+		std::vector<uint8_t> trampoline;
+		auto counter = counters.begin();
+		size_t offset = 0;
+
+		while (offset < displacedSize)
+		{
+			auto instructionAddress = address + offset;
+			for (; counter != counters.end() && counter->instructionAddress_ == instructionAddress; ++counter)
+			{
+				if (layout && !is64Bits_)
+					layout->counterAddressOffsets_.push_back(trampoline.size() + CounterAddressOffset);
+				if (!AddCounterIncrement(trampoline, trampolineAddress, counter->counterAddress_))
+					return boost::none;
+			}
+
+			auto instruction = DecodeInstruction(displacedCode + offset,
+			                                     displacedSize - offset,
+			                                     instructionAddress,
+			                                     is64Bits_);
+			if (!instruction)
+				return boost::none;
+
+			const auto* instructionCode = displacedCode + offset;
+			if (instruction->target_)
+			{
+				auto opcode = instructionCode[0];
+				if (opcode == 0xEB || opcode == 0xE9)
+					trampoline.push_back(0xE9);
+				else
+				{
+					auto condition = (opcode == 0x0F) ? instructionCode[1] : opcode;
+					trampoline.push_back(0x0F);
+					trampoline.push_back(static_cast<uint8_t>(0x80 | (condition & 0x0F)));
+				}
+				if (!AddRelative(trampoline, trampolineAddress, *instruction->target_))
+					return boost::none;
+			}
+			else
+			{
+				if (layout)
+					layout->copiedInstructionOffsets_.emplace_back(offset, trampoline.size());
+				trampoline.insert(trampoline.end(),
+				                  instructionCode,
+				                  instructionCode + instruction->length_);
+			}
+			offset += instruction->length_;
+		}
+		// A counter not at the start of a displaced instruction.
+		if (counter != counters.end())
+			return boost::none;
+
+		trampoline.push_back(0xE9);
+		if (!AddRelative(trampoline, trampolineAddress, address + displacedSize))
+			return boost::none;
+		return trampoline;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::vector<uint8_t>>
+	TrampolineBuilder::BuildJump(uint64_t address, uint64_t target) const
+	{
+		std::vector<uint8_t> jump{0xE9};
+
+		if (!AddRelative(jump, address, target))
+			return boost::none;
+		return jump;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TrampolineBuilder::GetCounterSize() const
+	{
+		return is64Bits_ ? sizeof(uint64_t) : sizeof(uint32_t);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<size_t> TrampolineBuilder::ComputeDisplacedSize(
+	    const uint8_t* code,
+	    size_t size,
+	    uint64_t address,
+	    const BasicBlockAnalyzer& analyzer,
+	    bool isInImage,
+	    bool canFault) const
+	{
+		if (!analyzer.IsInstructionStart(address))
+			return boost::none;
+
+		size_t displacedSize = 0;
+		while (displacedSize < JumpSize)
+		{
+			auto instructionAddress = address + displacedSize;
+
+			// A jump target inside the displaced instructions would run the
+			// jump written at address.
+			if (displacedSize && (isInImage ? analyzer.IsJumpTarget(instructionAddress)
+			                                : !analyzer.IsInSameBasicBlock(address, instructionAddress)))
+			{
+				return boost::none;
+			}
+
+			auto instruction = DecodeInstruction(
+			    code + displacedSize, size - displacedSize, instructionAddress, is64Bits_);
+			if (!instruction || instruction->isRipRelative_ ||
+			    !IsRelocatable(code + displacedSize, *instruction) ||
+			    (is64Bits_ && !canFault && !CannotFault(code + displacedSize, instruction->length_)))
+			{
+				return boost::none;
+			}
+			displacedSize += instruction->length_;
+
+			// In the image, the code after a conditional jump is only run by
+			// the jump: the code after a jump or a return can be run from an
+			// exception handler which is not a jump target.
+			auto canDisplaceNext = instruction->flow_ == InstructionFlow::Sequential ||
+			                       (isInImage && instruction->flow_ == InstructionFlow::ConditionalJump);
+			if (!canDisplaceNext && displacedSize < JumpSize)
+				return boost::none;
+		}
+		return displacedSize;
+	}
+
+	//-------------------------------------------------------------------------
+	bool TrampolineBuilder::AddCounterIncrement(std::vector<uint8_t>& code,
+	                                            uint64_t trampolineAddress,
+	                                            uint64_t counterAddress) const
+	{
+		// The flags can be used by the displaced instructions.
+		code.push_back(0x9C); // pushf
+
+		// lock inc qword ptr [rip + offset] or lock inc dword ptr [address]
+		code.push_back(0xF0);
+		if (is64Bits_)
+			code.push_back(0x48);
+		code.push_back(0xFF);
+		code.push_back(0x05);
+		if (is64Bits_)
+		{
+			if (!AddRelative(code, trampolineAddress, counterAddress))
+				return false;
+		}
+		else
+			AddValue(code, static_cast<uint32_t>(counterAddress));
+
+		code.push_back(0x9D); // popf
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool TrampolineBuilder::AddRelative(std::vector<uint8_t>& code,
+	                                    uint64_t trampolineAddress,
+	                                    uint64_t target) const
+	{
+		auto next = trampolineAddress + code.size() + 4;
+		auto offset = static_cast<int64_t>(target - next);
+
+		if (is64Bits_ && (offset < (std::numeric_limits<int32_t>::min)() ||
+		                  offset > (std::numeric_limits<int32_t>::max)()))
+		{
+			return false;
+		}
+		AddValue(code, static_cast<uint32_t>(offset));
+		return true;
+	}
+}
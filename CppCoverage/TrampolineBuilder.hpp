@@ -0,0 +1,123 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <boost/optional/optional.hpp>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	class BasicBlockAnalyzer;
+
+	// Build the code replacing a breakpoint by a jump to a trampoline. The
+	// trampoline increments an in-memory counter, runs the instructions
+	// overwritten by the jump and jumps back.
+	class CPPCOVERAGE_DLL TrampolineBuilder
+	{
+	  public:
+		// Size of the jump written at the instrumented address.
+		static const size_t JumpSize = 5;
+
+		// A counter is a 64 bits integer in 64 bits and a 32 bits integer
+		// in 32 bits.
+		struct Counter
+		{
+			// The counter is incremented before running this instruction.
+			uint64_t instructionAddress_;
+			uint64_t counterAddress_;
+		};
+
+		// Where the bytes of a trampoline come from, to relocate it with its
+		// image.
+		struct Layout
+		{
+			// Offset in the trampoline of each instruction copied as is, by
+			// its offset in the displaced code.
+			std::vector<std::pair<size_t, size_t>> copiedInstructionOffsets_;
+			// Offsets of the absolute counter addresses in 32 bits.
+			std::vector<size_t> counterAddressOffsets_;
+		};
+
+		explicit TrampolineBuilder(bool is64Bits);
+
+		// code is the code starting at address until the end of its function.
+		// Return the size of the instructions overwritten by the jump, or
+		// boost::none if they cannot run from a trampoline: they must be in
+		// the same basic block, must not be addressed relatively to rip, must
+		// not fault in 64 bits and only the last one can be a relative jump.
+		boost::optional<size_t> GetDisplacedSize(
+		    const uint8_t* code,
+		    size_t size,
+		    uint64_t address,
+		    const BasicBlockAnalyzer&) const;
+
+		// Same as GetDisplacedSize for a trampoline written in the image file.
+		// The displaced instructions can also follow a conditional jump when
+		// they are not jump targets. They can fault in 64 bits when canFault is true: the
+		// caller gives the unwind information of the function to the
+		// trampoline.
+		boost::optional<size_t> GetDisplacedSizeInImage(
+		    const uint8_t* code,
+		    size_t size,
+		    uint64_t address,
+		    const BasicBlockAnalyzer&,
+		    bool canFault) const;
+
+		// Upper bound of the size of the trampoline.
+		size_t GetMaxTrampolineSize(size_t displacedSize, size_t counterCount) const;
+
+		// Return boost::none if a jump target is too far from the trampoline.
+		// counters must be sorted and inside the displaced instructions.
+		boost::optional<std::vector<uint8_t>> Build(
+		    const uint8_t* displacedCode,
+		    size_t displacedSize,
+		    uint64_t address,
+		    uint64_t trampolineAddress,
+		    const std::vector<Counter>&,
+		    Layout* = nullptr) const;
+
+		// Return boost::none if the target is too far.
+		boost::optional<std::vector<uint8_t>> BuildJump(uint64_t address,
+		                                                uint64_t target) const;
+
+		size_t GetCounterSize() const;
+
+	  private:
+		TrampolineBuilder(const TrampolineBuilder&) = delete;
+		TrampolineBuilder& operator=(const TrampolineBuilder&) = delete;
+
+		boost::optional<size_t> ComputeDisplacedSize(const uint8_t* code,
+		                                             size_t size,
+		                                             uint64_t address,
+		                                             const BasicBlockAnalyzer&,
+		                                             bool isInImage,
+		                                             bool canFault) const;
+		bool AddCounterIncrement(std::vector<uint8_t>&,
+		                         uint64_t trampolineAddress,
+		                         uint64_t counterAddress) const;
+		bool AddRelative(std::vector<uint8_t>&,
+		                 uint64_t trampolineAddress,
+		                 uint64_t target) const;
+
+		const bool is64Bits_;
+	};
+}
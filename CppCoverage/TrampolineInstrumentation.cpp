@@ -0,0 +1,342 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "TrampolineInstrumentation.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "BasicBlockAnalyzer.hpp"
+#include "CppCoverageException.hpp"
+#include "Process.hpp"
+#include "TrampolineBuilder.hpp"
+
+#include "Tools/Log.hpp"
+#include "Tools/ProcessMemory.hpp"
+
+namespace CppCoverage
+{
+	namespace
+	{
+		// Trampolines are allocated close enough to the module for a 32 bits
+		// jump to reach any of its addresses.
+		const DWORD64 MaxModuleDistance = 0x40000000;
+
+		//---------------------------------------------------------------------
+		struct Site
+		{
+			DWORD64 address_;
+			std::vector<uint8_t> displacedCode_;
+			std::vector<DWORD64> addresses_;
+		};
+
+		//---------------------------------------------------------------------
+		DWORD64 AlignUp(DWORD64 value, DWORD64 alignment)
+		{
+			return (value + alignment - 1) / alignment * alignment;
+		}
+
+		//---------------------------------------------------------------------
+		DWORD64 AllocateNear(HANDLE hProcess, DWORD64 baseOfImage, size_t size, bool is64Bits)
+		{
+			if (!is64Bits)
+			{
+				return reinterpret_cast<DWORD64>(VirtualAllocEx(
+				    hProcess, nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+			}
+
+			SYSTEM_INFO systemInfo;
+			GetSystemInfo(&systemInfo);
+			DWORD64 granularity = systemInfo.dwAllocationGranularity;
+			auto address = AlignUp(
+			    baseOfImage > MaxModuleDistance ? baseOfImage - MaxModuleDistance : granularity,
+			    granularity);
+			auto end = baseOfImage + MaxModuleDistance;
+			MEMORY_BASIC_INFORMATION memoryInfo;
+
+			while (address < end &&
+			       VirtualQueryEx(hProcess, reinterpret_cast<void*>(address), &memoryInfo, sizeof(memoryInfo)))
+			{
+				auto regionEnd = reinterpret_cast<DWORD64>(memoryInfo.BaseAddress) + memoryInfo.RegionSize;
+				auto candidate = AlignUp(address, granularity);
+
+				if (memoryInfo.State == MEM_FREE && candidate + size <= regionEnd)
+				{
+					auto block = VirtualAllocEx(hProcess,
+					                            reinterpret_cast<void*>(candidate),
+					                            size,
+					                            MEM_RESERVE | MEM_COMMIT,
+					                            PAGE_READWRITE);
+					if (block)
+						return reinterpret_cast<DWORD64>(block);
+				}
+				address = regionEnd;
+			}
+			return 0;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<Site> FindSites(HANDLE hProcess,
+		                            const TrampolineBuilder& builder,
+		                            bool is64Bits,
+		                            const std::map<DWORD64, uint64_t>& functionRanges,
+		                            const std::vector<DWORD64>& addresses,
+		                            std::vector<DWORD64>& breakPointAddresses)
+		{
+			std::vector<Site> sites;
+			auto it = addresses.begin();
+
+			while (it != addresses.end())
+			{
+				auto function = functionRanges.upper_bound(*it);
+				if (function == functionRanges.begin() ||
+				    *it >= std::prev(function)->first + std::prev(function)->second)
+				{
+					breakPointAddresses.push_back(*it++);
+					continue;
+				}
+				--function;
+
+				auto functionAddress = function->first;
+				auto functionEnd = functionAddress + function->second;
+				auto code = Tools::ReadProcessMemory(hProcess,
+				                                     reinterpret_cast<void*>(functionAddress),
+				                                     static_cast<size_t>(function->second));
+				BasicBlockAnalyzer analyzer{code, functionAddress, is64Bits};
+
+				while (it != addresses.end() && *it < functionEnd)
+				{
+					auto offset = static_cast<size_t>(*it - functionAddress);
+					auto displacedSize = builder.GetDisplacedSize(
+					    &code[offset], code.size() - offset, *it, analyzer);
+					if (!displacedSize)
+					{
+						breakPointAddresses.push_back(*it++);
+						continue;
+					}
+
+					Site site{*it,
+					          {code.begin() + offset, code.begin() + offset + *displacedSize},
+					          {}};
+					for (; it != addresses.end() && *it < site.address_ + *displacedSize; ++it)
+						site.addresses_.push_back(*it);
+					sites.push_back(std::move(site));
+				}
+			}
+			return sites;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TrampolineInstrumentation::TrampolineInstrumentation()
+	    : instrumentedAddressCount_{0}, breakPointAddressCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	TrampolineInstrumentation::~TrampolineInstrumentation() = default;
+
+	//-------------------------------------------------------------------------
+	std::vector<DWORD64> TrampolineInstrumentation::Instrument(
+	    HANDLE hProcess,
+	    void* baseOfImage,
+	    const std::map<DWORD64, uint64_t>& functionRanges,
+	    std::vector<DWORD64> addresses)
+	{
+		std::sort(addresses.begin(), addresses.end());
+		addresses.erase(std::unique(addresses.begin(), addresses.end()), addresses.end());
+
+		auto is64Bits = Process::Is64Bits(hProcess);
+		TrampolineBuilder builder{is64Bits};
+		std::vector<DWORD64> breakPointAddresses;
+		auto sites = FindSites(hProcess, builder, is64Bits, functionRanges, addresses, breakPointAddresses);
+
+		size_t counterCount = 0;
+		size_t maxCodeSize = 0;
+		for (const auto& site : sites)
+		{
+			counterCount += site.addresses_.size();
+			maxCodeSize += builder.GetMaxTrampolineSize(site.displacedCode_.size(), site.addresses_.size());
+		}
+
+		SYSTEM_INFO systemInfo;
+		GetSystemInfo(&systemInfo);
+		auto counterSize = builder.GetCounterSize();
+		// The counters are writable and the trampolines are executable.
+		auto codeOffset = AlignUp(counterCount * counterSize, systemInfo.dwPageSize);
+		auto block = sites.empty() ? 0 : AllocateNear(hProcess,
+		                                              reinterpret_cast<DWORD64>(baseOfImage),
+		                                              static_cast<size_t>(codeOffset + maxCodeSize),
+		                                              is64Bits);
+		if (!block)
+		{
+			if (!sites.empty())
+			{
+				LOG_WARNING << L"Cannot allocate the trampolines near " << baseOfImage
+				            << L": breakpoints are used.";
+			}
+			breakPointAddressCount_ += addresses.size();
+			return addresses;
+		}
+
+		Module module{block, counterSize, {}, {}};
+		std::vector<uint8_t> code;
+		std::vector<std::pair<DWORD64, std::vector<uint8_t>>> jumps;
+
+		for (const auto& site : sites)
+		{
+			auto trampolineAddress = block + codeOffset + code.size();
+			std::vector<TrampolineBuilder::Counter> counters;
+			for (size_t i = 0; i < site.addresses_.size(); ++i)
+			{
+				auto counterIndex = module.addresses_.size() + i;
+				counters.push_back({site.addresses_[i], block + counterIndex * counterSize});
+			}
+
+			auto trampoline = builder.Build(site.displacedCode_.data(),
+			                                site.displacedCode_.size(),
+			                                site.address_,
+			                                trampolineAddress,
+			                                counters);
+			auto jump = builder.BuildJump(site.address_, trampolineAddress);
+			if (!trampoline || !jump)
+			{
+				breakPointAddresses.insert(breakPointAddresses.end(),
+				                           site.addresses_.begin(),
+				                           site.addresses_.end());
+				continue;
+			}
+			code.insert(code.end(), trampoline->begin(), trampoline->end());
+			jumps.emplace_back(site.address_, std::move(*jump));
+			module.addresses_.insert(module.addresses_.end(),
+			                         site.addresses_.begin(),
+			                         site.addresses_.end());
+		}
+
+		if (!code.empty())
+		{
+			auto codeAddress = reinterpret_cast<void*>(block + codeOffset);
+			DWORD oldProtect = 0;
+
+			Tools::WriteProcessMemory(hProcess, codeAddress, code.data(), code.size());
+			if (!VirtualProtectEx(hProcess, codeAddress, code.size(), PAGE_EXECUTE_READ, &oldProtect))
+				THROW_LAST_ERROR("Cannot protect the trampolines:", GetLastError());
+			for (auto& jump : jumps)
+			{
+				Tools::WriteProcessMemory(hProcess,
+				                          reinterpret_cast<void*>(jump.first),
+				                          jump.second.data(),
+				                          jump.second.size());
+			}
+		}
+
+		module.reportedCounts_.resize(module.addresses_.size());
+		instrumentedAddressCount_ += module.addresses_.size();
+		breakPointAddressCount_ += breakPointAddresses.size();
+		if (module.addresses_.empty())
+			VirtualFreeEx(hProcess, reinterpret_cast<void*>(block), 0, MEM_RELEASE);
+		else
+			processes_[hProcess][baseOfImage] = std::move(module);
+		return breakPointAddresses;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<TrampolineInstrumentation::HitCount> TrampolineInstrumentation::CollectAll()
+	{
+		std::vector<HitCount> hitCounts;
+
+		for (auto& process : processes_)
+		{
+			for (auto& module : process.second)
+				ReadCounters(process.first, module.second, hitCounts);
+		}
+		return hitCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<TrampolineInstrumentation::HitCount>
+	TrampolineInstrumentation::OnUnloadModule(HANDLE hProcess, void* baseOfImage)
+	{
+		std::vector<HitCount> hitCounts;
+		auto process = processes_.find(hProcess);
+
+		if (process != processes_.end())
+		{
+			auto it = process->second.find(baseOfImage);
+			if (it != process->second.end())
+			{
+				// The code of the module is unmapped: no thread runs the
+				// trampolines anymore.
+				ReadCounters(hProcess, it->second, hitCounts);
+				VirtualFreeEx(hProcess, reinterpret_cast<void*>(it->second.block_), 0, MEM_RELEASE);
+				process->second.erase(it);
+			}
+		}
+		return hitCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<TrampolineInstrumentation::HitCount>
+	TrampolineInstrumentation::OnExitProcess(HANDLE hProcess)
+	{
+		std::vector<HitCount> hitCounts;
+		auto process = processes_.find(hProcess);
+
+		// The trampolines are kept when detaching as the code still jumps
+		// to them.
+		if (process != processes_.end())
+		{
+			for (auto& module : process->second)
+				ReadCounters(hProcess, module.second, hitCounts);
+			processes_.erase(process);
+		}
+		return hitCounts;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TrampolineInstrumentation::GetInstrumentedAddressCount() const
+	{
+		return instrumentedAddressCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t TrampolineInstrumentation::GetBreakPointAddressCount() const
+	{
+		return breakPointAddressCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void TrampolineInstrumentation::ReadCounters(HANDLE hProcess,
+	                                             Module& module,
+	                                             std::vector<HitCount>& hitCounts) const
+	{
+		std::vector<uint8_t> counters(module.addresses_.size() * module.counterSize_);
+
+		Tools::ReadProcessMemory(hProcess, module.block_, counters.data(), counters.size());
+		for (size_t i = 0; i < module.addresses_.size(); ++i)
+		{
+			uint64_t count = 0;
+			std::memcpy(&count, &counters[i * module.counterSize_], module.counterSize_);
+			if (count != module.reportedCounts_[i])
+			{
+				module.reportedCounts_[i] = count;
+				hitCounts.push_back({Address{hProcess, reinterpret_cast<void*>(module.addresses_[i])}, count});
+			}
+		}
+	}
+}
@@ -0,0 +1,83 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <Windows.h>
+
+#include "Address.hpp"
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Replace the breakpoints by jumps to trampolines incrementing a counter
+	// in the memory of the process: no debug event is sent when the lines
+	// are executed and their exact hit count is known. The code is patched
+	// when the module is loaded, before it runs.
+	class CPPCOVERAGE_DLL TrampolineInstrumentation
+	{
+	  public:
+		struct HitCount
+		{
+			Address address_;
+			// The count of all the executions of the address.
+			uint64_t totalCount_;
+		};
+
+		TrampolineInstrumentation();
+		~TrampolineInstrumentation();
+
+		// functionRanges is the length of each function by its address.
+		// Return the addresses which cannot be instrumented: the caller
+		// should set their breakpoints.
+		std::vector<DWORD64> Instrument(HANDLE hProcess,
+		                                void* baseOfImage,
+		                                const std::map<DWORD64, uint64_t>& functionRanges,
+		                                std::vector<DWORD64> addresses);
+
+		// The functions below return the addresses executed since the
+		// previous call for their module.
+		std::vector<HitCount> CollectAll();
+		std::vector<HitCount> OnUnloadModule(HANDLE hProcess, void* baseOfImage);
+		std::vector<HitCount> OnExitProcess(HANDLE hProcess);
+
+		size_t GetInstrumentedAddressCount() const;
+		size_t GetBreakPointAddressCount() const;
+
+	  private:
+		TrampolineInstrumentation(const TrampolineInstrumentation&) = delete;
+		TrampolineInstrumentation& operator=(const TrampolineInstrumentation&) = delete;
+
+		struct Module
+		{
+			DWORD64 block_;
+			size_t counterSize_;
+			// The counter at index i is the counter of addresses_[i].
+			std::vector<DWORD64> addresses_;
+			// The values of the counters at the previous read.
+			std::vector<uint64_t> reportedCounts_;
+		};
+
+		void ReadCounters(HANDLE hProcess, Module&, std::vector<HitCount>&) const;
+
+		std::map<HANDLE, std::map<void*, Module>> processes_;
+		size_t instrumentedAddressCount_;
+		size_t breakPointAddressCount_;
+	};
+}
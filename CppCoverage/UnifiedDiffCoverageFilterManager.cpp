@@ -16,6 +16,7 @@
 
 #include "stdafx.h"
 #include <sstream>
+#include <algorithm>
 
 #include "UnifiedDiffCoverageFilterManager.hpp"
 #include "UnifiedDiffSettings.hpp"
@@ -60,14 +61,22 @@ namespace CppCoverage
 		//-------------------------------------------------------------------------
 		boost::optional<int> GetExecutableLineOrPreviousOne(
 			int lineNumber,
-			const std::set<int>& executableLinesSet)
+			const std::vector<int>& executableLines)
 		{
-			auto it = executableLinesSet.lower_bound(lineNumber);
-
-			if (it != executableLinesSet.end() && *it == lineNumber)
-				return lineNumber;
-
-			return (it == executableLinesSet.begin()) ? boost::optional<int>{} : *(--it);
+			if (executableLines.empty() || executableLines.front() > lineNumber)
+				return boost::none;
+
+			// Binary search for the last line <= lineNumber: the conditional
+			// move replaces the unpredictable branch of lower_bound.
+			const int* first = executableLines.data();
+			auto count = executableLines.size();
+			while (count > 1)
+			{
+				auto half = count / 2;
+				first = (first[half] <= lineNumber) ? first + half : first;
+				count -= half;
+			}
+			return *first;
 		}
 
 		//-------------------------------------------------------------------------
@@ -116,9 +125,9 @@ namespace CppCoverage
 		if (unifiedDiffCoverageFilters_.empty())
 			return true;
 
-		const auto& executableLinesSet = GetExecutableLinesSet(fileInfo);
+		const auto& executableLines = GetExecutableLines(fileInfo);
 
-		auto executableLineNumber = GetExecutableLineOrPreviousOne(lineInfo.lineNumber_, executableLinesSet);
+		auto executableLineNumber = GetExecutableLineOrPreviousOne(lineInfo.lineNumber_, executableLines);
 		if (!executableLineNumber)
 			return false;
 
@@ -127,6 +136,46 @@ namespace CppCoverage
 		});
 	}
 
+	//-------------------------------------------------------------------------
+	void UnifiedDiffCoverageFilterManager::SelectLines(
+		const FileFilter::FileInfo& fileInfo,
+		std::vector<bool>& selectedLines)
+	{
+		if (unifiedDiffCoverageFilters_.empty())
+			return;
+
+		const auto& executableLines = GetExecutableLines(fileInfo);
+		const auto& lineInfos = fileInfo.lineInfoColllection_;
+
+		for (size_t i = 0; i < lineInfos.size(); ++i)
+		{
+			if (!selectedLines[i])
+				continue;
+
+			auto executableLineNumber = GetExecutableLineOrPreviousOne(lineInfos[i].lineNumber_, executableLines);
+			selectedLines[i] = executableLineNumber &&
+				AnyOfOrTrueIfEmpty(unifiedDiffCoverageFilters_, [&](const auto& filter) {
+					return filter->IsLineSelected(fileInfo.filePath_, *executableLineNumber);
+				});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::set<int>> UnifiedDiffCoverageFilterManager::GetSelectedLines(
+		const std::wstring& filename)
+	{
+		if (unifiedDiffCoverageFilters_.empty())
+			return boost::none;
+
+		std::set<int> selectedLines;
+		for (const auto& filter : unifiedDiffCoverageFilters_)
+		{
+			if (const auto* lines = filter->GetSelectedLines(filename))
+				selectedLines.insert(lines->begin(), lines->end());
+		}
+		return selectedLines;
+	}
+
 	//-------------------------------------------------------------------------
 	std::vector<std::wstring> UnifiedDiffCoverageFilterManager::ComputeWarningMessageLines(size_t maxUnmatchPaths) const
 	{
@@ -172,22 +221,25 @@ namespace CppCoverage
 	}
 
 	//-------------------------------------------------------------------------
-	const std::set<int>& UnifiedDiffCoverageFilterManager::GetExecutableLinesSet(
+	const std::vector<int>& UnifiedDiffCoverageFilterManager::GetExecutableLines(
 		const FileFilter::FileInfo& fileInfo)
 	{
-		auto filePath = fileInfo.filePath_;
+		const auto& filePath = fileInfo.filePath_;
 
 		if (filePath != executableLineCache_.currentFilePath)
 		{
-			auto& executableLinesSet = executableLineCache_.executableLinesSet;
+			auto& executableLines = executableLineCache_.executableLines;
 
-			executableLinesSet.clear();
+			executableLines.clear();
 			for (const auto& lineInfo : fileInfo.lineInfoColllection_)
-				executableLinesSet.insert(lineInfo.lineNumber_);
+				executableLines.push_back(lineInfo.lineNumber_);
+			std::sort(executableLines.begin(), executableLines.end());
+			executableLines.erase(
+				std::unique(executableLines.begin(), executableLines.end()), executableLines.end());
 			LOG_DEBUG << L"Executable lines for " << filePath << L": ";
-			LOG_DEBUG << ToWString(executableLinesSet);
+			LOG_DEBUG << ToWString(executableLines);
 			executableLineCache_.currentFilePath = filePath;
 		}
-		return executableLineCache_.executableLinesSet;
+		return executableLineCache_.executableLines;
 	}
 }
@@ -21,6 +21,7 @@
 #include <set>
 
 #include <filesystem>
+#include <boost/optional.hpp>
 
 #include "CppCoverageExport.hpp"
 
@@ -52,6 +53,11 @@ namespace CppCoverage
 		bool IsLineSelected(
 			const FileFilter::FileInfo&,
 			const FileFilter::LineInfo&);
+		// Unselect the lines of the file which are not selected.
+		void SelectLines(const FileFilter::FileInfo&, std::vector<bool>& selectedLines);
+		// The lines of all the unified diffs, boost::none when there is no
+		// unified diff.
+		boost::optional<std::set<int>> GetSelectedLines(const std::wstring& filename);
 
 		std::vector<std::wstring> ComputeWarningMessageLines(size_t maxUnmatchPaths) const;
 
@@ -63,13 +69,14 @@ namespace CppCoverage
 			const std::set<std::filesystem::path>& unmatchPaths,
 			size_t maxUnmatchPaths) const;
 
-		const std::set<int>& GetExecutableLinesSet(const FileFilter::FileInfo&);
+		const std::vector<int>& GetExecutableLines(const FileFilter::FileInfo&);
 		const UnifiedDiffCoverageFilters unifiedDiffCoverageFilters_;
 
 		struct ExecutableLineCache
 		{
 			std::filesystem::path currentFilePath;
-			std::set<int> executableLinesSet;
+			// Sorted without duplicates.
+			std::vector<int> executableLines;
 		};
 
 		ExecutableLineCache executableLineCache_;
@@ -24,46 +24,69 @@
 
 #include "CoverageFilterSettings.hpp"
 #include "Patterns.hpp"
-#include "Wildcards.hpp"
+#include "WildcardsMatcher.hpp"
 
 namespace CppCoverage
 {	
 	//-------------------------------------------------------------------------
 	struct WildcardCoverageFilter::Filter
-	{		
-		std::vector<Wildcards> selectedWildcards;
-		std::vector<Wildcards> excludedWildcards;
+	{
+		WildcardsMatcher selectedWildcards;
+		WildcardsMatcher excludedWildcards;
+	};
+
+	//-------------------------------------------------------------------------
+	struct WildcardCoverageFilter::MatchResult
+	{
+		const std::wstring* selectedWildcards = nullptr;
+		const std::wstring* excludedWildcards = nullptr;
+
+		bool IsSelected() const
+		{
+			return selectedWildcards && !excludedWildcards;
+		}
 	};
 
 	namespace
 	{
 		//---------------------------------------------------------------------
-		const Wildcards* MatchAny(
-			const std::wstring& str, 
-			const std::vector<Wildcards>& wildcardsCollection)
+		// Written only when the log record is enabled.
+		template <typename MatchResult>
+		struct MatchMessage
 		{
-			
-			for (const auto& wildcards : wildcardsCollection)
-			{				
-				if (wildcards.Match(str))
-					return &wildcards;
-			}
+			const std::wstring& str;
+			const MatchResult& matchResult;
+		};
+
+		//---------------------------------------------------------------------
+		template <typename MatchResult>
+		MatchMessage<MatchResult> MakeMatchMessage(
+			const std::wstring& str,
+			const MatchResult& matchResult)
+		{
+			return {str, matchResult};
+		}
 
-			return nullptr;
-		}		
-				
 		//---------------------------------------------------------------------
-		std::vector<Wildcards> BuildWildcards(
-			const std::vector<std::wstring>& regexesStr,
-			bool isRegexCaseSensitiv)
-		{			
-			std::vector<Wildcards> wildcardsCollection;
-
-			for (const auto& regexStr : regexesStr)
-				wildcardsCollection.emplace_back(regexStr, isRegexCaseSensitiv);
-						
-			return wildcardsCollection;
-		}	
+		template <typename MatchResult>
+		std::wostream& operator<<(std::wostream& ostr, const MatchMessage<MatchResult>& message)
+		{
+			const auto& matchResult = message.matchResult;
+
+			if (!matchResult.selectedWildcards)
+				ostr << L": " << message.str << L" is skipped because it matches no selected patterns";
+			else if (matchResult.excludedWildcards)
+			{
+				ostr << L": " << message.str << L" is not selected because it matches excluded pattern: "
+					<< *matchResult.excludedWildcards;
+			}
+			else
+			{
+				ostr << L": " << message.str << L" is selected because it matches selected pattern: "
+					<< *matchResult.selectedWildcards;
+			}
+			return ostr;
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -81,15 +104,13 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	bool WildcardCoverageFilter::IsModuleSelected(const std::wstring& filename) const
 	{
-		std::wostringstream ostr;
-
-		ostr << L"Module";
-		bool isSelected = Match(filename, *moduleFilter_, ostr);
+		auto matchResult = Match(filename, *moduleFilter_);
+		bool isSelected = matchResult.IsSelected();
 
 		if (isSelected)
-			LOG_INFO << ostr.str();
+			LOG_INFO << L"Module" << MakeMatchMessage(filename, matchResult);
 		else
-			LOG_DEBUG << ostr.str();
+			LOG_DEBUG << L"Module" << MakeMatchMessage(filename, matchResult);
 
 		return isSelected;
 	}
@@ -97,52 +118,31 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	bool WildcardCoverageFilter::IsSourceFileSelected(const std::wstring& filename) const
 	{
-		std::wostringstream ostr;
-		bool isSelected = Match(filename, *sourceFilter_, ostr);
+		auto matchResult = Match(filename, *sourceFilter_);
 
-		LOG_DEBUG << L"Filename" << ostr.str();
-		return isSelected;		
+		LOG_DEBUG << L"Filename" << MakeMatchMessage(filename, matchResult);
+		return matchResult.IsSelected();
 	}
 
 	//-------------------------------------------------------------------------
 	std::unique_ptr<WildcardCoverageFilter::Filter> 
 		WildcardCoverageFilter::BuildFilter(const Patterns& patterns) const
 	{
-		std::unique_ptr<Filter> filter{ new Filter()};
-
-		filter->selectedWildcards = BuildWildcards(
-			patterns.GetSelectedPatterns(), 
-			patterns.IsRegexCaseSensitiv());
-		filter->excludedWildcards = BuildWildcards(
-			patterns.GetExcludedPatterns(), 
-			patterns.IsRegexCaseSensitiv());
-
-		return filter;
+		return std::unique_ptr<Filter>{ new Filter{
+			WildcardsMatcher{patterns.GetSelectedPatterns(), patterns.IsRegexCaseSensitiv()},
+			WildcardsMatcher{patterns.GetExcludedPatterns(), patterns.IsRegexCaseSensitiv()}}};
 	}
 
 	//---------------------------------------------------------------------
-	bool WildcardCoverageFilter::Match(
+	WildcardCoverageFilter::MatchResult WildcardCoverageFilter::Match(
 		const std::wstring& str,
-		const Filter& filter,
-		std::wostream& ostr) const
+		const Filter& filter) const
 	{
-		const auto* selectedRegEx = MatchAny(str, filter.selectedWildcards);
-
-		if (!selectedRegEx)
-		{
-			ostr << L": " << str << L" is skipped because it matches no selected patterns";
-			return false;
-		}
-		
-		const auto* excludedRegEx = MatchAny(str, filter.excludedWildcards);
-
-		if (excludedRegEx)
-		{
-			ostr << L": " << str << L" is not selected because it matches excluded pattern: " << *excludedRegEx;
-			return false;
-		}
+		MatchResult matchResult;
 
-		ostr << L": " << str << L" is selected because it matches selected pattern: " << *selectedRegEx;;
-		return true;			
+		matchResult.selectedWildcards = filter.selectedWildcards.Match(str);
+		if (matchResult.selectedWildcards)
+			matchResult.excludedWildcards = filter.excludedWildcards.Match(str);
+		return matchResult;
 	}
 }
@@ -41,12 +41,10 @@ namespace CppCoverage
 		WildcardCoverageFilter& operator=(const WildcardCoverageFilter&) = delete;
 		
 		struct Filter;
+		struct MatchResult;
 
 		std::unique_ptr<Filter> BuildFilter(const Patterns& pattern) const;
-		bool Match(
-			const std::wstring& str,
-			const Filter& filter,
-			std::wostream& ostr) const;
+		MatchResult Match(const std::wstring& str, const Filter& filter) const;
 	private:
 		std::unique_ptr<Filter> moduleFilter_;
 		std::unique_ptr<Filter> sourceFilter_;		
@@ -17,12 +17,25 @@
 #include "stdafx.h"
 #include "Wildcards.hpp"
 
-#include <boost/algorithm/string.hpp>
+#include <algorithm>
+#include <cwctype>
 
-#include "Tools/Tool.hpp"
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
 
 namespace CppCoverage
 {
+	namespace
+	{
+		//---------------------------------------------------------------------
+		wchar_t ToLower(wchar_t c)
+		{
+			if (c < 0x80)
+				return (c >= L'A' && c <= L'Z') ? static_cast<wchar_t>(c - L'A' + L'a') : c;
+			return static_cast<wchar_t>(std::towlower(c));
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	const std::vector<wchar_t> Wildcards::EscapedChars = 
 		{ L'\\', L'^', L'$', L'.', L'+', L'(', L')', L'[', L']', L'{', L'}', L'|', L'?' };
@@ -30,32 +43,41 @@ namespace CppCoverage
 	//-------------------------------------------------------------------------
 	Wildcards::Wildcards(std::wstring str, bool isRegexCaseSensitiv)
 		: originalStr_( str )
+		, isCaseSensitive_{ isRegexCaseSensitiv }
 	{
-		auto flags = (isRegexCaseSensitiv) ? std::regex::basic : std::regex::icase;
-		// Do not escaped '*'
-		
-		for (auto c : EscapedChars)
-		{
-			std::wstring escapedString{ c };
-			boost::replace_all(str, escapedString, L"\\" + escapedString);
-		}
-		
-		// remove useless * 
-		boost::trim_if(str, [](wchar_t c){ return c == L'*';});
-		boost::replace_all(str, L"*", L".*");
-		wildcars_.assign(str, flags);
+		// The case insensitive wildcards are lowered once: only the
+		// characters of the matched strings are lowered.
+		if (!isRegexCaseSensitiv)
+			std::transform(str.begin(), str.end(), str.begin(), ToLower);
+		boost::split(parts_, str, boost::is_any_of(L"*"), boost::token_compress_on);
 	}
 
 	//-------------------------------------------------------------------------
 	Wildcards::Wildcards(Wildcards&& wildcards)
-		: wildcars_(std::move(wildcards.wildcars_))
+		: parts_(std::move(wildcards.parts_))
+		, originalStr_(std::move(wildcards.originalStr_))
+		, isCaseSensitive_(wildcards.isCaseSensitive_)
 	{
 	}
 
 	//-------------------------------------------------------------------------
+	// The parts are searched in order, each after the previous one: the
+	// wildcards can match anywhere in str.
 	bool Wildcards::Match(const std::wstring& str) const
 	{
-		return std::regex_search(str, wildcars_);
+		auto position = str.begin();
+
+		for (const auto& part : parts_)
+		{
+			auto it = isCaseSensitive_
+			    ? std::search(position, str.end(), part.begin(), part.end())
+			    : std::search(position, str.end(), part.begin(), part.end(),
+			                  [](wchar_t c, wchar_t partChar) { return ToLower(c) == partChar; });
+			if (it == str.end() && !part.empty())
+				return false;
+			position = it + part.size();
+		}
+		return true;
 	}
 
 	//-------------------------------------------------------------------------
@@ -16,8 +16,8 @@
 
 #pragma once
 
-#include <regex>
 #include <string>
+#include <vector>
 
 #include "CppCoverageExport.hpp"
 
@@ -26,6 +26,7 @@ namespace CppCoverage
 	class CPPCOVERAGE_DLL Wildcards
 	{
 	public:
+		// Matched as they are: only '*' is a wildcard.
 		static const std::vector<wchar_t> EscapedChars;
 
 	public:
@@ -41,7 +42,9 @@ namespace CppCoverage
 		Wildcards& operator=(const Wildcards&) = delete;
 
 	private:
-		std::wregex wildcars_;
+		// The parts of the wildcards between the '*', in order.
+		std::vector<std::wstring> parts_;
 		std::wstring originalStr_;
+		bool isCaseSensitive_;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,185 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "WildcardsMatcher.hpp"
+
+#include <algorithm>
+#include <queue>
+#include <boost/algorithm/string.hpp>
+
+namespace CppCoverage
+{
+	//-------------------------------------------------------------------------
+	WildcardsMatcher::WildcardsMatcher(
+		const std::vector<std::wstring>& patterns,
+		bool isCaseSensitive)
+		: isCaseSensitive_{isCaseSensitive}
+		, patterns_(patterns)
+		, nodes_(1)
+	{
+		std::map<std::wstring, size_t> segmentIndexes;
+
+		for (const auto& pattern : patterns_)
+		{
+			auto foldedPattern = Fold(pattern);
+			std::vector<std::wstring> segments;
+			std::vector<size_t> segmentIndexesOfPattern;
+
+			boost::split(segments, foldedPattern, [](wchar_t c) { return c == L'*'; });
+			for (const auto& segment : segments)
+			{
+				if (segment.empty())
+					continue;
+				auto it = segmentIndexes.find(segment);
+				if (it == segmentIndexes.end())
+					it = segmentIndexes.emplace(segment, AddSegment(segment)).first;
+				segmentIndexesOfPattern.push_back(it->second);
+			}
+			patternSegments_.push_back(std::move(segmentIndexesOfPattern));
+		}
+		BuildFailures();
+	}
+
+	//-------------------------------------------------------------------------
+	WildcardsMatcher::~WildcardsMatcher() = default;
+
+	//-------------------------------------------------------------------------
+	const std::wstring* WildcardsMatcher::Match(const std::wstring& str) const
+	{
+		// Start positions of each segment in str, in increasing order.
+		std::vector<std::vector<size_t>> segmentPositions(segmentLengths_.size());
+		const auto folded = Fold(str);
+		size_t state = 0;
+
+		for (size_t i = 0; i < folded.size(); ++i)
+		{
+			auto c = folded[i];
+			for (;;)
+			{
+				const auto& transitions = nodes_[state].transitions_;
+				auto it = transitions.find(c);
+
+				if (it != transitions.end())
+				{
+					state = it->second;
+					break;
+				}
+				if (state == 0)
+					break;
+				state = nodes_[state].failure_;
+			}
+			for (auto segment : nodes_[state].segments_)
+				segmentPositions[segment].push_back(i + 1 - segmentLengths_[segment]);
+		}
+
+		for (size_t i = 0; i < patterns_.size(); ++i)
+		{
+			size_t position = 0;
+			bool isMatching = true;
+
+			for (auto segment : patternSegments_[i])
+			{
+				const auto& positions = segmentPositions[segment];
+				auto it = std::lower_bound(positions.begin(), positions.end(), position);
+
+				if (it == positions.end())
+				{
+					isMatching = false;
+					break;
+				}
+				position = *it + segmentLengths_[segment];
+			}
+			if (isMatching)
+				return &patterns_[i];
+		}
+		return nullptr;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t WildcardsMatcher::AddSegment(const std::wstring& segment)
+	{
+		size_t state = 0;
+
+		for (auto c : segment)
+		{
+			auto it = nodes_[state].transitions_.find(c);
+			if (it == nodes_[state].transitions_.end())
+			{
+				nodes_.emplace_back();
+				it = nodes_[state].transitions_.emplace(c, nodes_.size() - 1).first;
+			}
+			state = it->second;
+		}
+
+		auto segmentIndex = segmentLengths_.size();
+		segmentLengths_.push_back(segment.size());
+		nodes_[state].segments_.push_back(segmentIndex);
+		return segmentIndex;
+	}
+
+	//-------------------------------------------------------------------------
+	void WildcardsMatcher::BuildFailures()
+	{
+		std::queue<size_t> states;
+
+		for (const auto& transition : nodes_[0].transitions_)
+			states.push(transition.second);
+
+		// Breadth-first: the failure state of a node is always closer to the root.
+		while (!states.empty())
+		{
+			auto state = states.front();
+			states.pop();
+
+			for (const auto& transition : nodes_[state].transitions_)
+			{
+				auto c = transition.first;
+				auto next = transition.second;
+				auto failure = nodes_[state].failure_;
+
+				for (;;)
+				{
+					const auto& transitions = nodes_[failure].transitions_;
+					auto it = transitions.find(c);
+
+					if (it != transitions.end())
+					{
+						failure = it->second;
+						break;
+					}
+					if (failure == 0)
+						break;
+					failure = nodes_[failure].failure_;
+				}
+				nodes_[next].failure_ = failure;
+
+				const auto& failureSegments = nodes_[failure].segments_;
+				auto& segments = nodes_[next].segments_;
+				segments.insert(segments.end(), failureSegments.begin(), failureSegments.end());
+				states.push(next);
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring WildcardsMatcher::Fold(std::wstring str) const
+	{
+		if (!isCaseSensitive_)
+			boost::to_lower(str);
+		return str;
+	}
+}
@@ -0,0 +1,62 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "CppCoverageExport.hpp"
+
+namespace CppCoverage
+{
+	// Match a string against a collection of wildcards in a single pass.
+	// The literal segments between the '*' of all the patterns are searched
+	// together with an Aho-Corasick automaton, then each pattern checks that
+	// its segments occur in order.
+	class CPPCOVERAGE_DLL WildcardsMatcher
+	{
+	public:
+		WildcardsMatcher(const std::vector<std::wstring>& patterns, bool isCaseSensitive);
+		WildcardsMatcher(WildcardsMatcher&&) = default;
+		~WildcardsMatcher();
+
+		// Return the first pattern that matches str or nullptr.
+		const std::wstring* Match(const std::wstring& str) const;
+
+	private:
+		WildcardsMatcher(const WildcardsMatcher&) = delete;
+		WildcardsMatcher& operator=(const WildcardsMatcher&) = delete;
+
+		struct Node
+		{
+			std::map<wchar_t, size_t> transitions_;
+			size_t failure_ = 0;
+			std::vector<size_t> segments_;
+		};
+
+		size_t AddSegment(const std::wstring& segment);
+		void BuildFailures();
+		std::wstring Fold(std::wstring) const;
+
+		bool isCaseSensitive_;
+		std::vector<std::wstring> patterns_;
+		std::vector<std::vector<size_t>> patternSegments_;
+		std::vector<size_t> segmentLengths_;
+		std::vector<Node> nodes_;
+	};
+}
@@ -0,0 +1,179 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/AdaptiveArming.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+#include "TestHelper/Tools.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Clock = cov::AdaptiveArming::Clock;
+
+		HANDLE const ProcessHandle = reinterpret_cast<HANDLE>(1);
+		void* const BaseOfImage = reinterpret_cast<void*>(0x1000);
+		using TestHelper::CreateAddress;
+
+		//---------------------------------------------------------------------
+		void AddFunctions(cov::AdaptiveArming& adaptiveArming)
+		{
+			adaptiveArming.AddFunctions(ProcessHandle, BaseOfImage, {{0x1000, 0x100}, {0x2000, 0x100}});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, InvalidBudget)
+	{
+		ASSERT_THROW(cov::AdaptiveArming(0, Clock::now()), cov::CppCoverageException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, HotFunction)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		AddFunctions(adaptiveArming);
+
+		ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1000), start).empty());
+		ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x2000), start).empty());
+
+		auto hotFunctions = adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1010), start);
+		ASSERT_EQ(1, hotFunctions.size());
+		ASSERT_EQ(ProcessHandle, hotFunctions[0].hProcess_);
+		ASSERT_EQ(0x1000, hotFunctions[0].address_);
+		ASSERT_EQ(0x100, hotFunctions[0].length_);
+
+		// A function is hot only once.
+		for (int i = 0; i < 3; ++i)
+			ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1020 + i), start).empty());
+		ASSERT_EQ(1, adaptiveArming.GetHotFunctionCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, ColdFunctions)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		AddFunctions(adaptiveArming);
+
+		// Each function is hit once: the lines keep their breakpoints.
+		adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1000), start);
+		adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x2000), start);
+		ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x3000), start).empty());
+		ASSERT_EQ(0, adaptiveArming.GetHotFunctionCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, BudgetByProcess)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		auto otherProcessHandle = reinterpret_cast<HANDLE>(2);
+		AddFunctions(adaptiveArming);
+		adaptiveArming.AddFunctions(otherProcessHandle, BaseOfImage, {{0x1000, 0x100}});
+
+		adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1000), start);
+		adaptiveArming.OnHit(CreateAddress(otherProcessHandle, 0x1000), start);
+		adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1010), start);
+		ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(otherProcessHandle, 0x1010), start).empty());
+
+		auto hotFunctions = adaptiveArming.OnHit(CreateAddress(otherProcessHandle, 0x1020), start);
+		ASSERT_EQ(1, hotFunctions.size());
+		ASSERT_EQ(otherProcessHandle, hotFunctions[0].hProcess_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, Window)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		auto window = adaptiveArming.GetWindow();
+		AddFunctions(adaptiveArming);
+
+		// The hits of the previous windows are not counted.
+		for (int i = 0; i < 5; ++i)
+		{
+			auto now = start + i * window;
+			ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1000 + 2 * i), now).empty());
+			ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1001 + 2 * i), now).empty());
+		}
+		ASSERT_EQ(0, adaptiveArming.GetHotFunctionCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, Block)
+	{
+		cov::AdaptiveArming adaptiveArming{20, Clock::now()};
+		auto monitor = CreateAddress(ProcessHandle, 0x1000);
+
+		adaptiveArming.AddBlock(monitor, {0x1004, 0x1008});
+		ASSERT_EQ(1, adaptiveArming.GetBlockCount());
+		ASSERT_TRUE(adaptiveArming.TakeBlock(CreateAddress(ProcessHandle, 0x1004)).empty());
+		ASSERT_EQ((std::vector<DWORD64>{0x1004, 0x1008}), adaptiveArming.TakeBlock(monitor));
+		ASSERT_TRUE(adaptiveArming.TakeBlock(monitor).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, ArmedAddresses)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		AddFunctions(adaptiveArming);
+		adaptiveArming.AddArmedAddresses(ProcessHandle,
+			{ CreateAddress(ProcessHandle, 0x1008), CreateAddress(ProcessHandle, 0x1004),
+			  CreateAddress(ProcessHandle, 0x100C), CreateAddress(ProcessHandle, 0x1800) });
+
+		// The addresses outside the functions are not kept.
+		ASSERT_TRUE(adaptiveArming.GetArmedAddresses(ProcessHandle, 0x1800, 1).empty());
+		ASSERT_EQ((std::vector<DWORD64>{0x1004, 0x1008, 0x100C}),
+			adaptiveArming.GetArmedAddresses(ProcessHandle, 0x1000, 0x100));
+
+		adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1004), start);
+		adaptiveArming.AddBlock(CreateAddress(ProcessHandle, 0x1008), {0x100C});
+		ASSERT_EQ((std::vector<DWORD64>{0x1008}),
+			adaptiveArming.GetArmedAddresses(ProcessHandle, 0x1000, 0x100));
+
+		adaptiveArming.OnUnloadModule(ProcessHandle, BaseOfImage);
+		ASSERT_TRUE(adaptiveArming.GetArmedAddresses(ProcessHandle, 0x1000, 0x100).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AdaptiveArmingTest, UnloadModule)
+	{
+		auto start = Clock::now();
+		cov::AdaptiveArming adaptiveArming{20, start};
+		auto otherBaseOfImage = reinterpret_cast<void*>(0x3000);
+		AddFunctions(adaptiveArming);
+		adaptiveArming.AddFunctions(ProcessHandle, otherBaseOfImage, {{0x3000, 0x100}});
+		adaptiveArming.AddBlock(CreateAddress(ProcessHandle, 0x1000), {0x1004});
+		adaptiveArming.AddBlock(CreateAddress(ProcessHandle, 0x3000), {0x3004});
+
+		adaptiveArming.OnUnloadModule(ProcessHandle, BaseOfImage);
+		ASSERT_TRUE(adaptiveArming.TakeBlock(CreateAddress(ProcessHandle, 0x1000)).empty());
+		ASSERT_FALSE(adaptiveArming.TakeBlock(CreateAddress(ProcessHandle, 0x3000)).empty());
+
+		// The functions of the unloaded module are not hot anymore.
+		for (int i = 0; i < 3; ++i)
+			ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x1000 + i), start).empty());
+		adaptiveArming.OnExitProcess(ProcessHandle);
+		ASSERT_TRUE(adaptiveArming.OnHit(CreateAddress(ProcessHandle, 0x3000), start).empty());
+	}
+}
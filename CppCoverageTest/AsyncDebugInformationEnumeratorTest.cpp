@@ -0,0 +1,75 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/AsyncDebugInformationEnumerator.hpp"
+#include "TestCoverageConsole/TestDebugInformationEnumerator.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+#include "DebugInformationHandlerMock.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(AsyncDebugInformationEnumeratorTest, Enumerate)
+	{
+		auto selectedFilename = TestCoverageConsole::GetDebugInformationEnumeratorTestPath().filename();
+		auto binary = TestCoverageConsole::GetOutputBinaryPath();
+		auto hProcess = GetCurrentProcess();
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+		cov::AsyncDebugInformationEnumerator asyncEnumerator{{}};
+
+		asyncEnumerator.Enumerate(hProcess, baseOfImage, binary);
+		auto modules = asyncEnumerator.WaitForEnumeratedModules();
+		ASSERT_EQ(1, modules.size());
+		const auto& module = modules.at(0);
+		ASSERT_EQ(hProcess, module.hProcess_);
+		ASSERT_EQ(baseOfImage, module.baseOfImage_);
+		ASSERT_TRUE(asyncEnumerator.TakeEnumeratedModules().empty());
+
+		DebugInformationHandlerMock asyncHandler{selectedFilename};
+		ASSERT_TRUE(module.Replay(asyncHandler));
+
+		DebugInformationHandlerMock handler{selectedFilename};
+		cov::DebugInformationEnumerator{{}}.Enumerate(binary, handler);
+		ASSERT_FALSE(handler.lines_.empty());
+		ASSERT_EQ(handler.lines_, asyncHandler.lines_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(AsyncDebugInformationEnumeratorTest, Cancel)
+	{
+		auto binary = TestCoverageConsole::GetOutputBinaryPath();
+		auto hProcess = GetCurrentProcess();
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+		cov::AsyncDebugInformationEnumerator asyncEnumerator{{}};
+
+		asyncEnumerator.Enumerate(hProcess, baseOfImage, binary);
+		asyncEnumerator.Enumerate(hProcess, nullptr, binary);
+		asyncEnumerator.Cancel(hProcess, baseOfImage);
+		auto modules = asyncEnumerator.WaitForEnumeratedModules();
+		ASSERT_EQ(1, modules.size());
+		ASSERT_EQ(nullptr, modules.at(0).baseOfImage_);
+
+		asyncEnumerator.Enumerate(hProcess, baseOfImage, binary);
+		asyncEnumerator.Cancel(hProcess);
+		ASSERT_TRUE(asyncEnumerator.WaitForEnumeratedModules().empty());
+	}
+}
@@ -0,0 +1,120 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/BasicBlockAnalyzer.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const uint64_t Address = 0x1000;
+
+		// 0x1000 push rbp
+		// 0x1001 mov rbp, rsp
+		// 0x1004 test eax, eax
+		// 0x1006 je 0x100A
+		// 0x1008 inc eax
+		// 0x100A inc eax
+		// 0x100C ret
+		const std::vector<unsigned char> Code{
+			0x55, 0x48, 0x89, 0xE5, 0x85, 0xC0, 0x74, 0x02, 0xFF, 0xC0, 0xFF, 0xC0, 0xC3 };
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, SameBasicBlock)
+	{
+		cov::BasicBlockAnalyzer analyzer{ Code, Address, true };
+
+		ASSERT_TRUE(analyzer.IsAnalyzed());
+		ASSERT_TRUE(analyzer.IsInSameBasicBlock(Address, Address + 4));
+		ASSERT_TRUE(analyzer.IsInSameBasicBlock(Address, Address + 6));
+		ASSERT_TRUE(analyzer.IsInSameBasicBlock(Address + 0xA, Address + 0xC));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, DifferentBasicBlock)
+	{
+		cov::BasicBlockAnalyzer analyzer{ Code, Address, true };
+
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address, Address + 8)); // After je
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address + 8, Address + 0xA)); // Target of je
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address + 4, Address));
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address, Address + 2)); // Not an instruction
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, JumpTarget)
+	{
+		cov::BasicBlockAnalyzer analyzer{ Code, Address, true };
+
+		ASSERT_TRUE(analyzer.IsJumpTarget(Address + 0xA));
+		ASSERT_FALSE(analyzer.IsJumpTarget(Address + 8)); // After je
+		ASSERT_FALSE(analyzer.IsJumpTarget(Address));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, IndirectJump)
+	{
+		// mov eax, ecx; jmp rax; inc eax
+		std::vector<unsigned char> code{ 0x89, 0xC8, 0xFF, 0xE0, 0xFF, 0xC0 };
+		cov::BasicBlockAnalyzer analyzer{ code, Address, true };
+
+		ASSERT_FALSE(analyzer.IsAnalyzed());
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address, Address + 2));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, Call)
+	{
+		// call 0x2000; inc eax
+		std::vector<unsigned char> code{ 0xE8, 0xFB, 0x0F, 0, 0, 0xFF, 0xC0 };
+		cov::BasicBlockAnalyzer analyzer{ code, Address, true };
+
+		ASSERT_TRUE(analyzer.IsAnalyzed());
+		ASSERT_FALSE(analyzer.IsInSameBasicBlock(Address, Address + 5));
+
+		// The call can throw.
+		const auto& basicBlocks = analyzer.GetBasicBlocks();
+		ASSERT_EQ(2, basicBlocks.size());
+		ASSERT_EQ(std::vector<size_t>{ 1 }, basicBlocks[0].successors_);
+		ASSERT_TRUE(basicBlocks[0].isExit_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BasicBlockAnalyzerTest, BasicBlocks)
+	{
+		cov::BasicBlockAnalyzer analyzer{ Code, Address, true };
+		const auto& basicBlocks = analyzer.GetBasicBlocks();
+
+		ASSERT_EQ(3, basicBlocks.size());
+		ASSERT_EQ(Address, basicBlocks[0].address_);
+		ASSERT_EQ((std::vector<size_t>{ 1, 2 }), basicBlocks[0].successors_);
+		ASSERT_FALSE(basicBlocks[0].isExit_);
+		ASSERT_EQ(Address + 8, basicBlocks[1].address_);
+		ASSERT_EQ(std::vector<size_t>{ 2 }, basicBlocks[1].successors_);
+		ASSERT_EQ(Address + 0xA, basicBlocks[2].address_);
+		ASSERT_TRUE(basicBlocks[2].successors_.empty());
+		ASSERT_TRUE(basicBlocks[2].isExit_);
+
+		ASSERT_EQ(boost::optional<size_t>{ 0 }, analyzer.FindBasicBlock(Address + 6));
+		ASSERT_EQ(boost::optional<size_t>{ 2 }, analyzer.FindBasicBlock(Address + 0xC));
+		ASSERT_FALSE(analyzer.FindBasicBlock(Address + 2));
+	}
+}
@@ -121,4 +121,57 @@ namespace CppCoverageTest
 		ASSERT_EQ(42, oldInstructionCollection.at(0).first);
 		ASSERT_EQ(ToDWORD64(&value), oldInstructionCollection.at(0).second);
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(BreakPointTest, SetBreakPointsDuplicatedAddresses)
+	{
+		CppCoverage::BreakPoint breakPoint;
+		unsigned char values[] = {42, 43};
+		auto address = ToDWORD64(&values[0]);
+
+		auto oldInstructionCollection = breakPoint.SetBreakPoints(
+		    GetCurrentProcess(), {address, address, address});
+
+		ASSERT_EQ(1, oldInstructionCollection.size());
+		ASSERT_EQ(42, oldInstructionCollection.at(0).first);
+		ASSERT_EQ(BreakPoint::breakPointInstruction, values[0]);
+		ASSERT_EQ(43, values[1]);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BreakPointTest, SystemCallCount)
+	{
+		CppCoverage::BreakPoint breakPoint;
+		std::vector<unsigned char> values(100, 42);
+		auto address = ToDWORD64(&values[0]);
+
+		breakPoint.SetBreakPoints(
+		    GetCurrentProcess(), {address, address + 10, address + 10});
+
+		// One read, one write and one flush.
+		ASSERT_EQ(3, breakPoint.GetSystemCallCount());
+		ASSERT_EQ(2, breakPoint.GetSavedSystemCallCount());
+
+		breakPoint.ReadInstructions(GetCurrentProcess(), {address});
+		ASSERT_EQ(4, breakPoint.GetSystemCallCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(BreakPointTest, RemoveBreakPoints)
+	{
+		CppCoverage::BreakPoint breakPoint;
+		auto values = GenerateValues(100, 100);
+		auto address = ToDWORD64(&values[0]);
+
+		auto oldInstructions = breakPoint.SetBreakPoints(
+		    GetCurrentProcess(), {address, address + 10, address + 20});
+		oldInstructions.erase(oldInstructions.begin() + 1);
+		breakPoint.RemoveBreakPoints(GetCurrentProcess(), std::move(oldInstructions));
+
+		ASSERT_EQ(0, values[0]);
+		ASSERT_EQ(BreakPoint::breakPointInstruction, values[10]);
+		ASSERT_EQ(20, values[20]);
+		// One read, one write and one flush for each call.
+		ASSERT_EQ(6, breakPoint.GetSystemCallCount());
+	}
 }
\ No newline at end of file
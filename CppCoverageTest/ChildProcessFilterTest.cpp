@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/ChildProcessFilter.hpp"
+#include "CppCoverage/Patterns.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(ChildProcessFilterTest, IsChildSelected)
+	{
+		cov::Patterns patterns;
+		patterns.AddSelectedPatterns(L"*");
+		patterns.AddExcludedPatterns(L"*\\cmd.exe");
+		patterns.AddExcludedPatterns(L"git*.exe");
+		cov::ChildProcessFilter filter{patterns};
+
+		ASSERT_TRUE(filter.IsChildSelected(L"C:\\Dev\\Test.exe"));
+		ASSERT_FALSE(filter.IsChildSelected(L"C:\\Windows\\System32\\CMD.exe"));
+		ASSERT_FALSE(filter.IsChildSelected(L"C:\\Git\\bin\\git-remote.exe"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ChildProcessFilterTest, NoSelectedPattern)
+	{
+		cov::ChildProcessFilter filter{cov::Patterns{}};
+
+		ASSERT_FALSE(filter.IsChildSelected(L"C:\\Dev\\Test.exe"));
+	}
+}
@@ -34,6 +34,7 @@
 #include "CppCoverage/CoverageDataMerger.hpp"
 #include "CppCoverage/UnifiedDiffSettings.hpp"
 #include "CppCoverage/RunCoverageSettings.hpp"
+#include "CppCoverage/ICoverageObserver.hpp"
 
 #include "Tools/Log.hpp"
 #include "Tools/Tool.hpp"
@@ -120,6 +121,26 @@ namespace CppCoverageTest
 			return coverageData;
 		}
 
+		//---------------------------------------------------------------------
+		// Check that the breakpoint mode enabled by mode gives the same
+		// coverage as the default line breakpoints.
+		void CheckSameCoverageWithMode(bool CoverageArgs::*mode,
+		                               const std::wstring& programArg,
+		                               const std::wstring& modulePattern,
+		                               const std::wstring& sourcePattern)
+		{
+			CoverageArgs args{{programArg}, modulePattern, sourcePattern};
+			// The in-process agent cannot cover the children.
+			args.coverChildren_ = false;
+
+			auto expectedCoverageData = ComputeCoverageDataPatterns(args);
+			args.*mode = true;
+			auto coverageData = ComputeCoverageDataPatterns(args);
+
+			TestHelper::CoverageDataComparer().AssertEquals(
+			    expectedCoverageData, coverageData);
+		}
+
 		//---------------------------------------------------------------------
 		Plugin::CoverageData RunCoverageWithException(
 			const std::wstring& programArg,
@@ -169,6 +190,108 @@ namespace CppCoverageTest
 		boost::shared_ptr<std::ostringstream> error_;		
 	};
 
+	// The breakpoint modes are checked against the default line breakpoints.
+	using CodeCoverageRunnerInProcessAgentTest = CodeCoverageRunnerTest;
+	using CodeCoverageRunnerBasicBlockTest = CodeCoverageRunnerTest;
+	using CodeCoverageRunnerLazyBreakPointsTest = CodeCoverageRunnerTest;
+	using CodeCoverageRunnerPageGuardTest = CodeCoverageRunnerTest;
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerTest, FunctionCoverageLevel)
+	{
+		CoverageArgs args{
+			{ TestCoverageConsole::TestBasic },
+			TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+			TestCoverageConsole::GetTestBasicFilename().wstring() };
+
+		auto lineCoverageData = ComputeCoverageDataPatterns(args);
+		args.coverageLevel_ = cov::CoverageLevel::Function;
+		auto functionCoverageData = ComputeCoverageDataPatterns(args);
+
+		const auto& lineFile = GetFirstFileCoverage(lineCoverageData);
+		const auto& functionFile = GetFirstFileCoverage(functionCoverageData);
+		auto functionLines = functionFile.GetLines();
+
+		ASSERT_FALSE(functionLines.empty());
+		ASSERT_LT(functionLines.size(), lineFile.GetLines().size());
+		for (const auto& functionLine : functionLines)
+		{
+			const auto* line = lineFile[functionLine.GetLineNumber()];
+			ASSERT_NE(nullptr, line);
+			ASSERT_EQ(line->HasBeenExecuted(), functionLine.HasBeenExecuted());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerTest, SamplingTrapsPerSecond)
+	{
+		CoverageArgs args{
+			{ TestCoverageConsole::TestBasic },
+			TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+			TestCoverageConsole::GetTestBasicFilename().wstring() };
+
+		auto expectedCoverageData = ComputeCoverageDataPatterns(args);
+		args.samplingTrapsPerSecond_ = 1000;
+		auto coverageData = ComputeCoverageDataPatterns(args);
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+		    expectedCoverageData, coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerTest, AdaptiveArming)
+	{
+		CoverageArgs args{
+			{ TestCoverageConsole::TestBasic },
+			TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+			TestCoverageConsole::GetTestBasicFilename().wstring() };
+
+		auto expectedCoverageData = ComputeCoverageDataPatterns(args);
+		// The lowest budget monitors the functions by basic block as soon as
+		// two of their lines are executed.
+		args.adaptiveArmingTrapsPerSecond_ = 1;
+		auto coverageData = ComputeCoverageDataPatterns(args);
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+		    expectedCoverageData, coverageData);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerTest, CoverageObserver)
+	{
+		struct CoverageObserver : public cov::ICoverageObserver
+		{
+			void OnModuleLoaded(const fs::path& modulePath, bool isMonitored) override
+			{
+				if (isMonitored)
+					monitoredModules_.push_back(modulePath.filename());
+			}
+
+			void OnProgress(const cov::CoverageProgress& progress) override
+			{
+				lastProgress_ = progress;
+			}
+
+			std::vector<fs::path> monitoredModules_;
+			cov::CoverageProgress lastProgress_;
+		};
+
+		auto coverageObserver = std::make_shared<CoverageObserver>();
+		CoverageArgs args{
+			{ TestCoverageConsole::TestBasic },
+			TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+			TestCoverageConsole::GetTestBasicFilename().wstring() };
+		args.coverageObserver_ = coverageObserver;
+
+		auto coverageData = ComputeCoverageDataPatterns(args);
+
+		std::vector<fs::path> expectedModules{ TestCoverageConsole::GetOutputBinaryPath().filename() };
+		ASSERT_EQ(expectedModules, coverageObserver->monitoredModules_);
+		ASSERT_EQ(1u, coverageObserver->lastProgress_.monitoredModuleCount_);
+		ASSERT_LT(1u, coverageObserver->lastProgress_.loadedModuleCount_);
+		ASSERT_LT(0u, coverageObserver->lastProgress_.executedLineCount_);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST_F(CodeCoverageRunnerTest, RunCoverage)
 	{		
@@ -495,4 +618,114 @@ namespace CppCoverageTest
 		const auto& file = GetFirstFileCoverage(coverageData);
 		ASSERT_EQ(expectedPath, file.GetPath());
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerInProcessAgentTest, RunCoverageDll)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::inProcessAgent_,
+		    TestCoverageConsole::TestSharedLib,
+		    TestCoverageSharedLib::GetOutputBinaryPath().wstring(),
+		    TestCoverageSharedLib::GetMainCppPath().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerInProcessAgentTest, UnloadReloadDll)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::inProcessAgent_,
+		    TestCoverageConsole::TestUnloadReloadDll,
+		    TestHelper::GetOutputBinaryPath().wstring(),
+		    TestHelper::GetTestUnloadDllFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerBasicBlockTest, RunCoverage)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::basicBlockBreakPoints_,
+		    TestCoverageConsole::TestBasic,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestBasicFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerBasicBlockTest, RunThread)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::basicBlockBreakPoints_,
+		    TestCoverageConsole::TestThread,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestThreadFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerBasicBlockTest, RunCoverageDll)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::basicBlockBreakPoints_,
+		    TestCoverageConsole::TestSharedLib,
+		    TestCoverageSharedLib::GetOutputBinaryPath().wstring(),
+		    TestCoverageSharedLib::GetMainCppPath().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerTest, DominatorBreakPoints)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::dominatorBreakPoints_,
+		    TestCoverageConsole::TestBasic,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestBasicFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerLazyBreakPointsTest, RunCoverage)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::lazyBreakPoints_,
+		    TestCoverageConsole::TestBasic,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestBasicFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerLazyBreakPointsTest, RunThread)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::lazyBreakPoints_,
+		    TestCoverageConsole::TestThread,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestThreadFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerLazyBreakPointsTest, UnloadReloadDll)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::lazyBreakPoints_,
+		    TestCoverageConsole::TestUnloadReloadDll,
+		    TestHelper::GetOutputBinaryPath().wstring(),
+		    TestHelper::GetTestUnloadDllFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerPageGuardTest, RunThread)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::pageGuardBreakPoints_,
+		    TestCoverageConsole::TestThread,
+		    TestCoverageConsole::GetOutputBinaryPath().filename().wstring(),
+		    TestCoverageConsole::GetTestThreadFilename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(CodeCoverageRunnerPageGuardTest, RunCoverageDll)
+	{
+		CheckSameCoverageWithMode(
+		    &CoverageArgs::pageGuardBreakPoints_,
+		    TestCoverageConsole::TestSharedLib,
+		    TestCoverageSharedLib::GetOutputBinaryPath().wstring(),
+		    TestCoverageSharedLib::GetMainCppPath().wstring());
+	}
+}
@@ -0,0 +1,97 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/CoverageBaseline.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(CoverageBaselineTest, IsLineExecuted)
+	{
+		std::vector<Plugin::CoverageData> coverageDatas;
+		coverageDatas.emplace_back(L"", 0);
+		auto& file = coverageDatas.back().AddModule(L"module").AddFile(L"file");
+		file.AddLine(42, true);
+		file.AddLine(43, false);
+
+		cov::CoverageBaseline coverageBaseline{coverageDatas};
+
+		ASSERT_TRUE(coverageBaseline.IsLineExecuted(L"module", L"file", 42));
+		ASSERT_FALSE(coverageBaseline.IsLineExecuted(L"module", L"file", 43));
+		ASSERT_FALSE(coverageBaseline.IsLineExecuted(L"module", L"file", 44));
+		ASSERT_FALSE(coverageBaseline.IsLineExecuted(L"module", L"otherFile", 42));
+		ASSERT_FALSE(coverageBaseline.IsLineExecuted(L"otherModule", L"file", 42));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageBaselineTest, SeveralCoverageData)
+	{
+		std::vector<Plugin::CoverageData> coverageDatas;
+
+		for (int i = 0; i < 2; ++i)
+		{
+			coverageDatas.emplace_back(L"", 0);
+			auto& file = coverageDatas.back().AddModule(L"module").AddFile(L"file");
+			file.AddLine(42, true);
+			file.AddLine(43 + i, true);
+		}
+
+		cov::CoverageBaseline coverageBaseline{coverageDatas};
+
+		ASSERT_EQ(3, coverageBaseline.GetExecutedLineCount());
+		ASSERT_TRUE(coverageBaseline.IsLineExecuted(L"module", L"file", 43));
+		ASSERT_TRUE(coverageBaseline.IsLineExecuted(L"module", L"file", 44));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageBaselineTest, IsModuleCovered)
+	{
+		std::vector<Plugin::CoverageData> coverageDatas;
+
+		for (int i = 0; i < 2; ++i)
+		{
+			coverageDatas.emplace_back(L"", 0);
+			auto& coveredModule = coverageDatas.back().AddModule(L"coveredModule");
+			coveredModule.SetIdentity(L"identity");
+			coveredModule.AddFile(L"file").AddLine(42 + i, true);
+
+			auto& partialModule = coverageDatas.back().AddModule(L"partialModule");
+			partialModule.SetIdentity(L"identity");
+			partialModule.AddFile(L"file").AddLine(42 + i, i == 0);
+
+			auto& rebuiltModule = coverageDatas.back().AddModule(L"rebuiltModule");
+			rebuiltModule.SetIdentity(L"identity" + std::to_wstring(i));
+			rebuiltModule.AddFile(L"file").AddLine(42, true);
+		}
+		coverageDatas.back().AddModule(L"moduleWithoutIdentity").AddFile(L"file").AddLine(42, true);
+
+		cov::CoverageBaseline coverageBaseline{coverageDatas};
+
+		ASSERT_TRUE(coverageBaseline.IsModuleCovered(L"coveredModule", L"identity"));
+		ASSERT_FALSE(coverageBaseline.IsModuleCovered(L"coveredModule", L"otherIdentity"));
+		ASSERT_FALSE(coverageBaseline.IsModuleCovered(L"partialModule", L"identity"));
+		ASSERT_FALSE(coverageBaseline.IsModuleCovered(L"rebuiltModule", L"identity0"));
+		ASSERT_FALSE(coverageBaseline.IsModuleCovered(L"moduleWithoutIdentity", L""));
+		ASSERT_FALSE(coverageBaseline.IsModuleCovered(L"otherModule", L"identity"));
+	}
+}
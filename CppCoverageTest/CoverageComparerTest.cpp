@@ -0,0 +1,100 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "CppCoverage/CoverageComparer.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		void AddLines(Plugin::CoverageData& coverageData,
+		              const std::wstring& filePath,
+		              const std::vector<std::pair<unsigned int, bool>>& lines)
+		{
+			auto& file = coverageData.AddModule(L"module").AddFile(filePath);
+			for (const auto& line : lines)
+				file.AddLine(line.first, line.second);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageComparerTest, Compare)
+	{
+		Plugin::CoverageData first{L"first", 0};
+		Plugin::CoverageData second{L"second", 0};
+
+		AddLines(first, L"file1", {{1, true}, {2, false}, {3, true}, {130, true}});
+		AddLines(second, L"file1", {{1, true}, {2, true}, {3, false}, {200, true}});
+		AddLines(first, L"file2", {{5, true}});
+		AddLines(second, L"file2", {{5, true}});
+		AddLines(second, L"file3", {{7, true}, {8, true}});
+
+		cov::CoverageComparer comparer;
+		auto comparison = comparer.Compare(first, second);
+
+		ASSERT_EQ(4, comparison.newlyCoveredLineCount_);
+		ASSERT_EQ(2, comparison.newlyUncoveredLineCount_);
+		ASSERT_EQ(2, comparison.commonLineCount_);
+		ASSERT_EQ(2, comparison.files_.size());
+
+		const auto& file1 = comparison.files_.at(0);
+		ASSERT_EQ(L"file1", file1.filePath_.wstring());
+		ASSERT_EQ((std::vector<unsigned int>{2, 200}), file1.newlyCoveredLines_);
+		ASSERT_EQ((std::vector<unsigned int>{3, 130}), file1.newlyUncoveredLines_);
+
+		const auto& file3 = comparison.files_.at(1);
+		ASSERT_EQ(L"file3", file3.filePath_.wstring());
+		ASSERT_EQ((std::vector<unsigned int>{7, 8}), file3.newlyCoveredLines_);
+		ASSERT_TRUE(file3.newlyUncoveredLines_.empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageComparerTest, Write)
+	{
+		Plugin::CoverageData first{L"first", 0};
+		Plugin::CoverageData second{L"second", 0};
+
+		AddLines(first, L"file", {{1, false}, {9, true}});
+		AddLines(second, L"file", {{3, true}, {4, true}, {5, true}, {9, false}, {12, true}});
+
+		cov::CoverageComparer comparer;
+		TestHelper::TemporaryPath path;
+		comparer.Write(comparer.Compare(first, second), path);
+
+		std::ifstream ifs{path.GetPath()};
+		std::ostringstream content;
+		content << ifs.rdbuf();
+		ASSERT_EQ("OpenCppCoverage coverage comparison 1\n"
+		          "M module\n"
+		          "F file\n"
+		          "+ 3-5 12\n"
+		          "- 9\n",
+		          content.str());
+	}
+}
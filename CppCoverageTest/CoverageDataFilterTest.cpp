@@ -0,0 +1,93 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/CoverageDataFilter.hpp"
+#include "CppCoverage/CoverageFilterManager.hpp"
+#include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/Patterns.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/CoverageDataComparer.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::Patterns CreatePatterns(const std::wstring& excludedPattern)
+		{
+			cov::Patterns patterns;
+
+			patterns.AddSelectedPatterns(L"*");
+			patterns.AddExcludedPatterns(excludedPattern);
+			return patterns;
+		}
+
+		//---------------------------------------------------------------------
+		void AddLines(Plugin::FileCoverage& file)
+		{
+			file.AddLine(1, true, 3);
+			file.AddLine(2, true, 1);
+			file.AddLine(3, false);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataFilterTest, Filter)
+	{
+		TestHelper::TemporaryPath sourcePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		{
+			std::ofstream ofs{ sourcePath.GetPath() };
+			ofs << "int i;\nint j; // COVERAGE_EXCL_LINE\nint k;\n";
+		}
+		cov::CoverageFilterSettings settings{ CreatePatterns(L"module2"), CreatePatterns(L"excluded") };
+		cov::CoverageFilterManager coverageFilterManager{
+			settings, {}, {}, false, FileFilter::ExclusionMarkers{ "COVERAGE_EXCL_LINE", "", "" } };
+		cov::CoverageDataFilter coverageDataFilter{ coverageFilterManager };
+
+		Plugin::CoverageData coverageData{ L"name", 42 };
+		auto& module1 = coverageData.AddModule(L"module1");
+		AddLines(module1.AddFile(sourcePath.GetPath()));
+		AddLines(module1.AddFile(L"excluded.cpp"));
+		AddLines(module1.AddFile(L"unknown.cpp"));
+		AddLines(coverageData.AddModule(L"module2").AddFile(L"unknown.cpp"));
+		coverageData.AddModule(L"module3").AddFile(L"excluded.cpp").AddLine(1, true);
+
+		ASSERT_TRUE(coverageDataFilter.IsModuleSelected(L"module1"));
+		ASSERT_FALSE(coverageDataFilter.IsModuleSelected(L"module2"));
+
+		Plugin::CoverageData expectedCoverageData{ L"name", 42 };
+		auto& expectedModule = expectedCoverageData.AddModule(L"module1");
+		auto& expectedFile = expectedModule.AddFile(sourcePath.GetPath());
+		expectedFile.AddLine(1, true, 3);
+		expectedFile.AddLine(3, false);
+		// The lines of a source file which cannot be read are kept.
+		AddLines(expectedModule.AddFile(L"unknown.cpp"));
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+			expectedCoverageData, coverageDataFilter.Filter(coverageData));
+	}
+}
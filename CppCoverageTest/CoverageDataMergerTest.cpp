@@ -25,6 +25,8 @@
 #include "Plugin/Exporter/FileCoverage.hpp" 
 #include "Plugin/Exporter/LineCoverage.hpp" 
 
+#include "TestHelper/CoverageDataComparer.hpp"
+
 namespace cov = CppCoverage;
 namespace fs = std::filesystem;
 
@@ -114,6 +116,16 @@ namespace CppCoverageTest
 		ASSERT_EQ(exitCode, coverageDataMerged.GetExitCode());
 	}
 	
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, Sampled)
+	{
+		auto coverageDatas = CreateCoverageDataCollection({ { L"", 0 }, { L"", 0 } });
+		ASSERT_FALSE(cov::CoverageDataMerger{}.Merge(coverageDatas).IsSampled());
+
+		coverageDatas.back().SetSampled(true);
+		ASSERT_TRUE(cov::CoverageDataMerger{}.Merge(coverageDatas).IsSampled());
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(CoverageDataMergerTest, Module)
 	{
@@ -161,6 +173,19 @@ namespace CppCoverageTest
 		CheckLineHasBeenExecuted(mergedFile, 3, true);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, LineHitCount)
+	{
+		auto coverageDatas = CreateCoverageDataCollection(2);
+
+		coverageDatas[0].AddModule(modulePath).AddFile(filePath).AddLine(0, true, 3);
+		coverageDatas[1].AddModule(modulePath).AddFile(filePath).AddLine(0, true, 4);
+
+		auto coverageDataMerged = cov::CoverageDataMerger{}.Merge(coverageDatas);
+		const auto& mergedFile = coverageDataMerged.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(7, (*mergedFile)[0]->GetHitCount());
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(CoverageDataMergerTest, MergeFileCoverageEmpty)
 	{
@@ -200,4 +225,78 @@ namespace CppCoverageTest
 			CheckLineHasBeenExecuted(mergedFile, 3, true);
 		}
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, RemoveFirstHits)
+	{
+		Plugin::CoverageData coverageData{ L"test", 0 };
+		cov::CoverageDataMerger coverageDataMerger;
+
+		auto& fileCoverage1 = coverageData.AddModule(modulePath).AddFile(filePath);
+		auto& fileCoverage2 = coverageData.AddModule(L"otherModule").AddFile(filePath);
+		fileCoverage1.AddLine(1, true, 3, 2, 10);
+		fileCoverage1.AddLine(2, false);
+		fileCoverage2.AddLine(2, true, 1, 1, 5);
+		coverageDataMerger.MergeFileCoverage(coverageData);
+		coverageDataMerger.RemoveFirstHits(coverageData);
+
+		ASSERT_EQ(&fileCoverage1.GetLines(), &fileCoverage2.GetLines());
+		const auto& lines = fileCoverage1.GetLines();
+		ASSERT_EQ(2, lines.size());
+		ASSERT_EQ(3, lines[0].GetHitCount());
+		ASSERT_EQ(1, lines[1].GetHitCount());
+		for (const auto& line : lines)
+		{
+			ASSERT_TRUE(line.HasBeenExecuted());
+			ASSERT_EQ(0, line.GetFirstHitOrder());
+			ASSERT_EQ(0, line.GetFirstHitTime());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, SingleMergedCoverageData)
+	{
+		auto coverageDatas = CreateCoverageDataCollection(1);
+
+		AddLine(coverageDatas[0], "m1", "f1", { { 1, true } });
+		AddLine(coverageDatas[0], "m2", "f1", { { 1, false } });
+		const auto* module = coverageDatas[0].GetModules().at(0).get();
+
+		auto coverageDataMerged = cov::CoverageDataMerger{}.Merge(std::move(coverageDatas));
+		ASSERT_EQ(2, coverageDataMerged.GetModules().size());
+		ASSERT_EQ(module, coverageDataMerged.GetModules().at(0).get());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, SingleNotMergedCoverageData)
+	{
+		auto coverageDatas = CreateCoverageDataCollection(1);
+
+		AddLine(coverageDatas[0], "m1", "f1", { { 1, true } });
+		AddLine(coverageDatas[0], "m1", "f1", { { 2, false } });
+
+		auto coverageDataMerged = cov::CoverageDataMerger{}.Merge(std::move(coverageDatas));
+		ASSERT_EQ(1, coverageDataMerged.GetModules().size());
+		const auto& files = coverageDataMerged.GetModules().at(0)->GetFiles();
+		ASSERT_EQ(1, files.size());
+		ASSERT_EQ(2, files.at(0)->GetLines().size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataMergerTest, MergeInto)
+	{
+		auto coverageDatas = CreateCoverageDataCollection({ { L"1", 1 }, { L"2", 2 }, { L"3", 0 } });
+
+		AddLine(coverageDatas[0], "m1", "f1", { { 1, true }, { 3, false } });
+		AddLine(coverageDatas[1], "m1", "f1", { { 2, false }, { 3, true } });
+		AddLine(coverageDatas[1], "m2", "f1", { { 1, false } });
+		AddLine(coverageDatas[2], "m1", "f2", { { 1, true } });
+		cov::CoverageDataMerger merger;
+		auto expectedCoverageData = merger.Merge(coverageDatas);
+
+		auto sum = std::move(coverageDatas[0]);
+		for (size_t i = 1; i < coverageDatas.size(); ++i)
+			merger.MergeInto(sum, std::move(coverageDatas[i]));
+		TestHelper::CoverageDataComparer().AssertEquals(expectedCoverageData, sum);
+	}
 }
\ No newline at end of file
@@ -0,0 +1,126 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/CoverageJournal.hpp"
+#include "CppCoverage/CoverageJournalFormat.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+#include "TestHelper/CoverageDataComparer.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		Plugin::CoverageData CreateExpectedCoverageData()
+		{
+			Plugin::CoverageData coverageData{ L"name", 42 };
+			auto& module1 = coverageData.AddModule(L"module1");
+			auto& file1 = module1.AddFile(L"file1");
+
+			file1.AddLine(10, true);
+			file1.AddLine(11, false);
+			file1.AddLine(200, true);
+			module1.AddFile(L"file2").AddLine(1, false);
+			coverageData.AddModule(L"module2").AddFile(L"file1").AddLine(5, true);
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteJournal(const std::filesystem::path& path)
+		{
+			cov::CoverageJournal journal{ path, L"name" };
+			cov::ExecutedAddressManager::JournalLines journalLines;
+
+			journalLines.registeredLines_ = {
+				{ L"module1", { { L"file1", { 10, 11, 200 } }, { L"file2", { 1 } } } } };
+			journalLines.executedLines_ = { { L"module1", { { L"file1", { 10 } } } } };
+			journal.Append(journalLines);
+
+			journalLines.registeredLines_ = { { L"module2", { { L"file1", { 5 } } } } };
+			journalLines.executedLines_ = {
+				{ L"module1", { { L"file1", { 200 } } } }, { L"module2", { { L"file1", { 5 } } } } };
+			journal.Append(journalLines);
+			journal.AppendExitCode(42);
+			ASSERT_EQ(2, journal.GetSnapshotCount());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, Replay)
+	{
+		TestHelper::TemporaryPath path;
+
+		WriteJournal(path);
+		ASSERT_TRUE(cov::CoverageJournal::IsJournal(path));
+		TestHelper::CoverageDataComparer().AssertEquals(
+			CreateExpectedCoverageData(), cov::CoverageJournal::Replay(path));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, TruncatedJournal)
+	{
+		TestHelper::TemporaryPath path;
+
+		WriteJournal(path);
+		// The exit code record is truncated.
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+		auto coverageData = cov::CoverageJournal::Replay(path);
+		ASSERT_EQ(0, coverageData.GetExitCode());
+		ASSERT_EQ(2, coverageData.GetModules().size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, TornRecordSize)
+	{
+		TestHelper::TemporaryPath path;
+
+		WriteJournal(path);
+		{
+			std::ofstream ofs{ path.GetPath(), std::ios::binary | std::ios::app };
+			cov::CoverageJournalFormat::RecordHeader recordHeader{
+				cov::CoverageJournalFormat::RecordType::ExitCode, 0xFFFFFFFF };
+			ofs.write(reinterpret_cast<const char*>(&recordHeader), sizeof(recordHeader));
+		}
+
+		auto coverageData = cov::CoverageJournal::Replay(path);
+		ASSERT_EQ(42, coverageData.GetExitCode());
+		ASSERT_EQ(2, coverageData.GetModules().size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageJournalTest, InvalidJournal)
+	{
+		TestHelper::TemporaryPath path;
+
+		std::ofstream{ path.GetPath(), std::ios::binary } << "Not a journal";
+		ASSERT_FALSE(cov::CoverageJournal::IsJournal(path));
+		ASSERT_THROW(cov::CoverageJournal::Replay(path), cov::CppCoverageException);
+	}
+}
@@ -0,0 +1,74 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/CoverageRegion.hpp"
+#include "TestHelper/Tools.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const auto hProcess1 = reinterpret_cast<HANDLE>(static_cast<intptr_t>(1));
+		const auto hProcess2 = reinterpret_cast<HANDLE>(static_cast<intptr_t>(2));
+		using TestHelper::CreateAddress;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageRegionTest, ParseMarker)
+	{
+		using Marker = cov::CoverageRegion::Marker;
+
+		ASSERT_EQ(Marker::Begin, cov::CoverageRegion::ParseMarker(cov::CoverageRegion::BeginMarker));
+		ASSERT_EQ(Marker::End, cov::CoverageRegion::ParseMarker(cov::CoverageRegion::EndMarker + L"\r\n"));
+		ASSERT_EQ(Marker::None, cov::CoverageRegion::ParseMarker(L""));
+		ASSERT_EQ(Marker::None, cov::CoverageRegion::ParseMarker(L"\n"));
+		ASSERT_EQ(Marker::None, cov::CoverageRegion::ParseMarker(L" " + cov::CoverageRegion::EndMarker));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageRegionTest, BeginEnd)
+	{
+		cov::CoverageRegion coverageRegion;
+
+		coverageRegion.AddAddresses(hProcess1, {10, 20});
+		coverageRegion.AddAddresses(hProcess2, {30});
+		ASSERT_FALSE(coverageRegion.IsActive());
+		ASSERT_TRUE(coverageRegion.End().empty());
+
+		auto addressesByProcess = coverageRegion.Begin();
+		ASSERT_TRUE(coverageRegion.IsActive());
+		ASSERT_EQ(2, addressesByProcess.size());
+		ASSERT_EQ((std::vector<DWORD64>{10, 20}), addressesByProcess.at(hProcess1));
+		ASSERT_EQ((std::vector<DWORD64>{30}), addressesByProcess.at(hProcess2));
+		ASSERT_TRUE(coverageRegion.Begin().empty());
+
+		coverageRegion.OnHit(CreateAddress(hProcess1, 10));
+		auto addresses = coverageRegion.End();
+		ASSERT_FALSE(coverageRegion.IsActive());
+		ASSERT_EQ(2, addresses.size());
+
+		coverageRegion.OnExitProcess(hProcess2);
+		addressesByProcess = coverageRegion.Begin();
+		ASSERT_EQ(1, addressesByProcess.size());
+		ASSERT_EQ((std::vector<DWORD64>{20}), addressesByProcess.at(hProcess1));
+		ASSERT_EQ(2, coverageRegion.GetRegionCount());
+	}
+}
@@ -0,0 +1,121 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+#include <Windows.h>
+
+#include "CppCoverage/DebugEventStatistics.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Clock = cov::DebugEventStatistics::Clock;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventStatisticsTest, Empty)
+	{
+		cov::DebugEventStatistics statistics;
+		auto now = Clock::now();
+
+		statistics.Start(now);
+		statistics.Stop(now);
+		ASSERT_EQ(0, statistics.GetEventCount());
+		ASSERT_EQ(0, statistics.GetBreakPointCount());
+		ASSERT_EQ(0, statistics.GetEventsPerSecond());
+		ASSERT_EQ(Clock::duration::zero(), statistics.GetAverageBreakPointTime());
+		ASSERT_EQ(Clock::duration::zero(), statistics.GetMaxBreakPointTime());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventStatisticsTest, AddEvent)
+	{
+		cov::DebugEventStatistics statistics;
+		auto start = Clock::now();
+
+		statistics.Start(start);
+		statistics.AddEvent(OUTPUT_DEBUG_STRING_EVENT, false, std::chrono::microseconds{ 100 });
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::microseconds{ 10 });
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::microseconds{ 30 });
+		statistics.AddDebugString();
+		statistics.Stop(start + std::chrono::seconds{ 2 });
+
+		ASSERT_EQ(3, statistics.GetEventCount());
+		ASSERT_EQ(2, statistics.GetEventCount(EXCEPTION_DEBUG_EVENT));
+		ASSERT_EQ(1, statistics.GetEventCount(OUTPUT_DEBUG_STRING_EVENT));
+		ASSERT_EQ(0, statistics.GetEventCount(CREATE_THREAD_DEBUG_EVENT));
+		ASSERT_EQ(std::chrono::microseconds{ 140 }, statistics.GetHandlingTime());
+		ASSERT_EQ(2, statistics.GetBreakPointCount());
+		ASSERT_EQ(1, statistics.GetDebugStringCount());
+		ASSERT_DOUBLE_EQ(1.5, statistics.GetEventsPerSecond());
+		ASSERT_EQ(std::chrono::microseconds{ 20 }, statistics.GetAverageBreakPointTime());
+		ASSERT_EQ(std::chrono::microseconds{ 30 }, statistics.GetMaxBreakPointTime());
+
+		std::wostringstream ostr;
+		ostr << statistics;
+		ASSERT_NE(std::wstring::npos, ostr.str().find(L"breakpoints: 2"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventStatisticsTest, StartResets)
+	{
+		cov::DebugEventStatistics statistics;
+
+		statistics.Start(Clock::now());
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::microseconds{ 10 });
+		statistics.Start(Clock::now());
+		ASSERT_EQ(0, statistics.GetEventCount());
+		ASSERT_EQ(0, statistics.GetBreakPointCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventStatisticsTest, Stalls)
+	{
+		cov::DebugEventStatistics statistics;
+
+		statistics.Start(Clock::now());
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::microseconds{ 0 });
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::microseconds{ 3 });
+		statistics.AddEvent(EXCEPTION_DEBUG_EVENT, true, std::chrono::hours{ 1 });
+		statistics.AddEvent(LOAD_DLL_DEBUG_EVENT, false, std::chrono::milliseconds{ 20 }, L"module.dll");
+		for (size_t i = 0; i < cov::DebugEventStatistics::MaxLongestStallCount; ++i)
+			statistics.AddEvent(CREATE_THREAD_DEBUG_EVENT, false, std::chrono::milliseconds{ 10 });
+		statistics.AddEvent(LOAD_DLL_DEBUG_EVENT, false, std::chrono::milliseconds{ 5 }, L"module.dll");
+
+		ASSERT_EQ(std::chrono::milliseconds{ 25 }, statistics.GetHandlingTime(LOAD_DLL_DEBUG_EVENT));
+		ASSERT_EQ(std::chrono::milliseconds{ 10 * 10 }, statistics.GetHandlingTime(CREATE_THREAD_DEBUG_EVENT));
+		const auto& histogram = statistics.GetBreakPointHistogram();
+		ASSERT_EQ(1u, histogram[0]);
+		ASSERT_EQ(1u, histogram[2]);
+		ASSERT_EQ(1u, histogram.back());
+
+		const auto& longestStalls = statistics.GetLongestStalls();
+		ASSERT_EQ(cov::DebugEventStatistics::MaxLongestStallCount, longestStalls.size());
+		ASSERT_TRUE(longestStalls[0].isBreakPoint_);
+		ASSERT_EQ(L"module.dll", longestStalls[1].modulePath_);
+		ASSERT_EQ(static_cast<unsigned long>(CREATE_THREAD_DEBUG_EVENT), longestStalls.back().debugEventCode_);
+
+		const auto& dllLoadTimes = statistics.GetDllLoadTimes();
+		ASSERT_EQ(1u, dllLoadTimes.size());
+		ASSERT_EQ(std::chrono::milliseconds{ 25 }, dllLoadTimes.at(L"module.dll").first);
+		ASSERT_EQ(2u, dllLoadTimes.at(L"module.dll").second);
+	}
+}
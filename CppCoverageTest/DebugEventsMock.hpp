@@ -28,8 +28,10 @@ namespace CppCoverageTest
 		MOCK_METHOD1(OnCreateProcess, void(const CREATE_PROCESS_DEBUG_INFO&));
 		MOCK_METHOD3(OnExitProcess, void(HANDLE, HANDLE, const EXIT_PROCESS_DEBUG_INFO&));
 		MOCK_METHOD3(OnLoadDll, void(HANDLE, HANDLE, const LOAD_DLL_DEBUG_INFO&));
+		MOCK_METHOD3(PostponeLoadDll, bool(HANDLE, HANDLE, const LOAD_DLL_DEBUG_INFO&));
 		MOCK_METHOD3(OnUnloadDll, void(HANDLE, HANDLE, const UNLOAD_DLL_DEBUG_INFO&));
 		MOCK_METHOD3(OnException, ExceptionType(HANDLE, HANDLE, const EXCEPTION_DEBUG_INFO&));
+		MOCK_METHOD0(OnTimer, void());
 
 	private:
 		DebugEventsHandlerMock(const DebugEventsHandlerMock&) = delete;
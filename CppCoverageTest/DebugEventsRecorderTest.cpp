@@ -0,0 +1,94 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/CppCoverageException.hpp"
+#include "CppCoverage/DebugEventsRecorder.hpp"
+#include "CppCoverage/DebugEventsReplayer.hpp"
+#include "CppCoverage/Debugger.hpp"
+#include "CppCoverage/StartInfo.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "DebugEventsMock.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		void ExpectDebugEvents(DebugEventsHandlerMock& handler, int& loadDllCount)
+		{
+			EXPECT_CALL(handler, OnCreateProcess(testing::_));
+			EXPECT_CALL(handler, OnExitProcess(testing::_, testing::_, testing::_));
+			EXPECT_CALL(handler, OnLoadDll(testing::_, testing::_, testing::_))
+				.WillRepeatedly(testing::Invoke([&](HANDLE, HANDLE, const LOAD_DLL_DEBUG_INFO&) {
+					++loadDllCount;
+				}));
+			EXPECT_CALL(handler, PostponeLoadDll(testing::_, testing::_, testing::_))
+				.WillRepeatedly(testing::Return(false));
+			EXPECT_CALL(handler, OnUnloadDll(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+			EXPECT_CALL(handler, OnException(testing::_, testing::_, testing::_))
+				.WillRepeatedly(testing::Return(cov::IDebugEventsHandler::ExceptionType::NotHandled));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventsRecorderTest, RecordAndReplay)
+	{
+		TestHelper::TemporaryPath path;
+		cov::StartInfo startInfo{ TestCoverageConsole::GetOutputBinaryPath() };
+		cov::Debugger debugger{ false, false, false };
+		DebugEventsHandlerMock recordedHandler;
+		int recordedLoadDllCount = 0;
+		int exitCode = 0;
+		size_t eventCount = 0;
+
+		ExpectDebugEvents(recordedHandler, recordedLoadDllCount);
+		{
+			cov::DebugEventsRecorder recorder{ recordedHandler, path.GetPath() };
+			exitCode = debugger.Debug(startInfo, recorder);
+			eventCount = recorder.GetEventCount();
+		}
+		ASSERT_LT(0, recordedLoadDllCount);
+
+		DebugEventsHandlerMock replayedHandler;
+		int replayedLoadDllCount = 0;
+		cov::DebugEventsReplayer replayer{ path.GetPath() };
+
+		ExpectDebugEvents(replayedHandler, replayedLoadDllCount);
+		EXPECT_CALL(replayedHandler, PostponeLoadDll(testing::_, testing::_, testing::_)).Times(0);
+		ASSERT_EQ(exitCode, replayer.Replay(replayedHandler));
+		ASSERT_EQ(eventCount, replayer.GetEventCount());
+		ASSERT_EQ(recordedLoadDllCount, replayedLoadDllCount);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DebugEventsRecorderTest, InvalidFile)
+	{
+		TestHelper::TemporaryPath path;
+		DebugEventsHandlerMock handler;
+
+		std::ofstream{ path.GetPath() } << "invalid";
+		ASSERT_THROW(cov::DebugEventsReplayer{ path.GetPath() }.Replay(handler),
+		             cov::CppCoverageException);
+	}
+}
@@ -0,0 +1,44 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <thread>
+
+#include "CppCoverage/DebugInformationCache.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(DebugInformationCacheTest, GetModule)
+	{
+		auto binary = TestCoverageConsole::GetOutputBinaryPath();
+		cov::DebugInformationCache debugInformationCache{{}};
+		std::shared_ptr<const cov::DebugInformationCache::EnumeratedModule> otherModule;
+
+		std::thread thread{[&]() { otherModule = debugInformationCache.GetModule(binary); }};
+		auto module = debugInformationCache.GetModule(binary);
+		thread.join();
+
+		ASSERT_EQ(module, otherModule);
+		ASSERT_EQ(binary, module->path_);
+		ASSERT_TRUE(module->isEnumerated_);
+		ASSERT_FALSE(module->sourceFiles_.empty());
+	}
+}
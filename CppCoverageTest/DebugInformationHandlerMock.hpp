@@ -0,0 +1,51 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <vector>
+
+#include "CppCoverage/DebugInformationEnumerator.hpp"
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	struct DebugInformationHandlerMock : CppCoverage::IDebugInformationHandler
+	{
+		//---------------------------------------------------------------------
+		explicit DebugInformationHandlerMock(const std::filesystem::path& selectedFilename)
+			: selectedFilename_{selectedFilename}
+		{
+		}
+
+		//---------------------------------------------------------------------
+		bool IsSourceFileSelected(const std::filesystem::path& sourceFile) override
+		{
+			return selectedFilename_ == sourceFile.filename();
+		}
+
+		//---------------------------------------------------------------------
+		void OnSourceFile(const std::filesystem::path&, const std::vector<Line>& lines) override
+		{
+			for (const auto& line : lines)
+				lines_.push_back(line.lineNumber_);
+		}
+
+		const std::filesystem::path selectedFilename_;
+		std::vector<unsigned long> lines_;
+	};
+}
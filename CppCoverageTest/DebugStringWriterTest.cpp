@@ -0,0 +1,47 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "CppCoverage/DebugStringWriter.hpp"
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(DebugStringWriterTest, Write)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			cov::DebugStringWriter writer{path.GetPath()};
+
+			writer.Write(42, L"first\n");
+			writer.Write(43, L"second");
+			ASSERT_EQ(2, writer.GetStringCount());
+		}
+
+		std::ifstream ifs{path.GetPath(), std::ios::binary};
+		std::ostringstream content;
+		content << ifs.rdbuf();
+		ASSERT_EQ("42: first\n43: second\n", content.str());
+	}
+}
@@ -44,4 +44,46 @@ namespace CppCoverageTest
 		ASSERT_EQ(0, debugger.GetRunningProcesses());
 		ASSERT_EQ(0, debugger.GetRunningThreads());
 	}	
+
+	//-----------------------------------------------------------------------------
+	TEST(DebugerTest, PostponeLoadDll)
+	{
+		cov::StartInfo startInfo{ TestCoverageConsole::GetOutputBinaryPath() };
+		cov::Debugger debugger{ false, false, false };
+		DebugEventsHandlerMock debugEventsHandlerMock;
+		void* postponedBaseOfDll = nullptr;
+		HANDLE hPostponedThread = nullptr;
+		int postponedLoadCount = 0;
+
+		debugger.SetTimerPeriod(std::chrono::milliseconds{ 10 });
+		EXPECT_CALL(debugEventsHandlerMock, OnCreateProcess(testing::_));
+		EXPECT_CALL(debugEventsHandlerMock, OnExitProcess(testing::_, testing::_, testing::_));
+		EXPECT_CALL(debugEventsHandlerMock, OnLoadDll(testing::_, testing::_, testing::_))
+			.WillRepeatedly(testing::Invoke([&](HANDLE, HANDLE, const LOAD_DLL_DEBUG_INFO& loadDll) {
+				if (loadDll.lpBaseOfDll == postponedBaseOfDll)
+					++postponedLoadCount;
+			}));
+		// The first DLL is postponed: its event is reported again once its thread is resumed.
+		EXPECT_CALL(debugEventsHandlerMock, PostponeLoadDll(testing::_, testing::_, testing::_))
+			.WillRepeatedly(testing::Invoke([&](HANDLE, HANDLE hThread, const LOAD_DLL_DEBUG_INFO& loadDll) {
+				if (postponedBaseOfDll)
+					return false;
+				postponedBaseOfDll = loadDll.lpBaseOfDll;
+				postponedLoadCount = 1;
+				hPostponedThread = hThread;
+				return SuspendThread(hThread) != static_cast<DWORD>(-1);
+			}));
+		EXPECT_CALL(debugEventsHandlerMock, OnTimer())
+			.WillRepeatedly(testing::Invoke([&]() {
+				if (hPostponedThread)
+					ResumeThread(hPostponedThread);
+				hPostponedThread = nullptr;
+			}));
+		EXPECT_CALL(debugEventsHandlerMock, OnUnloadDll(testing::_, testing::_, testing::_)).Times(testing::AnyNumber());
+		EXPECT_CALL(debugEventsHandlerMock, OnException(testing::_, testing::_, testing::_))
+			.WillRepeatedly(testing::Return(cov::IDebugEventsHandler::ExceptionType::NotHandled));
+
+		debugger.Debug(startInfo, debugEventsHandlerMock);
+		ASSERT_EQ(2, postponedLoadCount);
+	}
 }
\ No newline at end of file
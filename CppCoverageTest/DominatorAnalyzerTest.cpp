@@ -0,0 +1,108 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/BasicBlockAnalyzer.hpp"
+#include "CppCoverage/DominatorAnalyzer.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const uint64_t Address = 0x1000;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DominatorAnalyzerTest, Branch)
+	{
+		// 0x1000 test eax, eax
+		// 0x1002 je 0x1006
+		// 0x1004 inc eax
+		// 0x1006 inc eax
+		// 0x1008 ret
+		std::vector<unsigned char> code{ 0x85, 0xC0, 0x74, 0x02, 0xFF, 0xC0, 0xFF, 0xC0, 0xC3 };
+		cov::BasicBlockAnalyzer basicBlockAnalyzer{ code, Address, true };
+		cov::DominatorAnalyzer analyzer{ basicBlockAnalyzer };
+
+		ASSERT_TRUE(analyzer.Dominates(0, 1));
+		ASSERT_TRUE(analyzer.Dominates(0, 2));
+		ASSERT_TRUE(analyzer.Dominates(2, 2));
+		ASSERT_FALSE(analyzer.Dominates(1, 2));
+		ASSERT_FALSE(analyzer.Dominates(2, 0));
+
+		ASSERT_EQ(std::vector<size_t>{ 2 }, analyzer.GetPostDominators(0));
+		ASSERT_EQ(std::vector<size_t>{ 2 }, analyzer.GetPostDominators(1));
+		ASSERT_TRUE(analyzer.GetPostDominators(2).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DominatorAnalyzerTest, Loop)
+	{
+		// 0x1000 inc eax
+		// 0x1002 test eax, eax
+		// 0x1004 jne 0x1000
+		// 0x1006 ret
+		std::vector<unsigned char> code{ 0xFF, 0xC0, 0x85, 0xC0, 0x75, 0xFA, 0xC3 };
+		cov::BasicBlockAnalyzer basicBlockAnalyzer{ code, Address, true };
+		cov::DominatorAnalyzer analyzer{ basicBlockAnalyzer };
+
+		ASSERT_TRUE(analyzer.Dominates(0, 1));
+		ASSERT_EQ(std::vector<size_t>{ 1 }, analyzer.GetPostDominators(0));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DominatorAnalyzerTest, Call)
+	{
+		// 0x1000 call 0x2000
+		// 0x1005 inc eax
+		// 0x1007 ret
+		std::vector<unsigned char> code{ 0xE8, 0xFB, 0x0F, 0, 0, 0xFF, 0xC0, 0xC3 };
+		cov::BasicBlockAnalyzer basicBlockAnalyzer{ code, Address, true };
+		cov::DominatorAnalyzer analyzer{ basicBlockAnalyzer };
+
+		// The call can throw so the next block may never run.
+		ASSERT_TRUE(analyzer.Dominates(0, 1));
+		ASSERT_TRUE(analyzer.GetPostDominators(0).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DominatorAnalyzerTest, InfiniteLoop)
+	{
+		// 0x1000 inc eax
+		// 0x1002 jmp 0x1000
+		std::vector<unsigned char> code{ 0xFF, 0xC0, 0xEB, 0xFC };
+		cov::BasicBlockAnalyzer basicBlockAnalyzer{ code, Address, true };
+		cov::DominatorAnalyzer analyzer{ basicBlockAnalyzer };
+
+		ASSERT_TRUE(analyzer.Dominates(0, 0));
+		ASSERT_TRUE(analyzer.GetPostDominators(0).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DominatorAnalyzerTest, NotAnalyzed)
+	{
+		// jmp rax
+		std::vector<unsigned char> code{ 0xFF, 0xE0 };
+		cov::BasicBlockAnalyzer basicBlockAnalyzer{ code, Address, true };
+		cov::DominatorAnalyzer analyzer{ basicBlockAnalyzer };
+
+		ASSERT_FALSE(analyzer.Dominates(0, 1));
+		ASSERT_TRUE(analyzer.GetPostDominators(0).empty());
+	}
+}
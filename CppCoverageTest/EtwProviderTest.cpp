@@ -0,0 +1,49 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/EtwProvider.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(EtwProviderTest, WriteEvents)
+	{
+		const auto keywords = cov::EtwProvider::ModuleKeyword | cov::EtwProvider::BreakPointKeyword |
+		                      cov::EtwProvider::HitKeyword | cov::EtwProvider::SymbolKeyword |
+		                      cov::EtwProvider::ExportKeyword;
+
+		// The events can be written before, while and after the registration.
+		ASSERT_FALSE(cov::EtwProvider::IsEnabled(keywords));
+		ASSERT_NO_THROW(cov::EtwProvider::OnExportStart(L"export"));
+		{
+			cov::EtwProvider etwProvider;
+			ASSERT_TRUE(etwProvider.IsRegistered());
+			ASSERT_NO_THROW(cov::EtwProvider::OnModuleLoadStart(L"module.dll"));
+			ASSERT_NO_THROW(cov::EtwProvider::OnSymbolLoadStart(L"module.dll"));
+			ASSERT_NO_THROW(cov::EtwProvider::OnSymbolLoadStop(L"module.dll"));
+			ASSERT_NO_THROW(cov::EtwProvider::OnBreakPointsWritten(
+			    GetCurrentProcess(), 10, std::chrono::milliseconds{1}));
+			ASSERT_NO_THROW(cov::EtwProvider::OnBreakPointHit(GetCurrentProcess(), nullptr));
+			ASSERT_NO_THROW(cov::EtwProvider::OnModuleLoadStop(L"module.dll", true));
+		}
+		ASSERT_FALSE(cov::EtwProvider::IsEnabled(keywords));
+		ASSERT_NO_THROW(cov::EtwProvider::OnExportStop(L"export"));
+	}
+}
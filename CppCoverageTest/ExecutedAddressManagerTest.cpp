@@ -16,6 +16,9 @@
 
 #include "stdafx.h"
 
+#include <filesystem>
+#include <vector>
+
 #include "CppCoverage/ExecutedAddressManager.hpp"
 #include "CppCoverage/CppCoverageException.hpp"
 #include "Plugin/Exporter/CoverageData.hpp"
@@ -23,6 +26,8 @@
 #include "Plugin/Exporter/FileCoverage.hpp"
 #include "Plugin/Exporter/LineCoverage.hpp"
 #include "CppCoverage/Address.hpp"
+#include "CppCoverage/CoverageSummary.hpp"
+#include "CppCoverage/ICoverageSource.hpp"
 
 namespace cov = CppCoverage;
 
@@ -109,6 +114,369 @@ namespace CppCoverageTest
 		ASSERT_TRUE(line43->HasBeenExecuted());
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, CreateCoverageSummary)
+	{
+		cov::ExecutedAddressManager manager;
+		const std::wstring moduleName = L"module";
+		cov::Address address1 = CreateAddress(0x1001);
+		cov::Address address2 = CreateAddress(0x1002);
+		cov::Address address3 = CreateAddress(0x1003);
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+
+		manager.AddModule(L"moduleWithoutLines", nullptr);
+		manager.AddModule(moduleName, baseOfImage);
+		manager.RegisterAddress(address1, L"file1", 42, 0);
+		manager.RegisterAddress(address2, L"file1", 43, 0);
+		manager.RegisterAddress(address3, L"file2", 10, 0);
+		manager.MarkAddressAsExecuted(address2);
+
+		auto coverageSummary = manager.CreateCoverageSummary(L"name", 42);
+
+		ASSERT_EQ(L"name", coverageSummary.GetName());
+		ASSERT_EQ(42, coverageSummary.GetExitCode());
+		const auto& modules = coverageSummary.GetModules();
+		ASSERT_EQ(1, modules.size());
+		ASSERT_EQ(moduleName, modules.front().path_);
+		ASSERT_EQ(1, modules.front().coverageRate_.GetExecutedLinesCount());
+		ASSERT_EQ(2, modules.front().coverageRate_.GetUnExecutedLinesCount());
+		ASSERT_EQ(3, coverageSummary.GetCoverageRate().GetTotalLinesCount());
+	}
+
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct FileVisitor : public cov::ICoverageFileVisitor
+		{
+			//-----------------------------------------------------------------
+			bool OnFile(const std::filesystem::path& path, size_t lineCount) override
+			{
+				files_.emplace_back(path, lineCount);
+				return true;
+			}
+
+			//-----------------------------------------------------------------
+			void OnLine(unsigned int lineNumber, bool hasBeenExecuted, uint64_t, uint64_t, uint64_t) override
+			{
+				lines_.emplace_back(lineNumber, hasBeenExecuted);
+			}
+
+			std::vector<std::pair<std::filesystem::path, size_t>> files_;
+			std::vector<std::pair<unsigned int, bool>> lines_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, CreateCoverageSource)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(0x1001);
+		cov::Address address2 = CreateAddress(0x1002);
+		cov::Address address3 = CreateAddress(0x1003);
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+
+		manager.AddModule(L"moduleWithoutLines", nullptr);
+		manager.AddModule(L"module", baseOfImage, L"identity");
+		manager.RegisterAddress(address1, L"file2", 10, 0);
+		manager.RegisterAddress(address2, L"file1", 43, 0);
+		manager.RegisterAddress(address3, L"file1", 42, 0);
+		manager.MarkAddressAsExecuted(address2);
+
+		auto coverageSource = manager.CreateCoverageSource(L"name", 42, true);
+
+		ASSERT_EQ(L"name", coverageSource->GetName());
+		ASSERT_EQ(42, coverageSource->GetExitCode());
+		ASSERT_TRUE(coverageSource->IsSampled());
+		ASSERT_EQ(2, coverageSource->GetModuleCount());
+		ASSERT_EQ(L"module", coverageSource->GetModulePath(0));
+		ASSERT_EQ(L"identity", coverageSource->GetModuleIdentity(0));
+		ASSERT_EQ(L"moduleWithoutLines", coverageSource->GetModulePath(1));
+
+		FileVisitor visitor;
+		coverageSource->VisitModule(0, visitor);
+		using File = std::pair<std::filesystem::path, size_t>;
+		ASSERT_EQ((std::vector<File>{ { L"file1", 2 }, { L"file2", 1 } }), visitor.files_);
+		using Line = std::pair<unsigned int, bool>;
+		ASSERT_EQ((std::vector<Line>{ { 42, false }, { 43, true }, { 10, false } }), visitor.lines_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, IsLineExecuted)
+	{
+		cov::ExecutedAddressManager manager;
+		const std::wstring moduleName = L"module";
+		const std::wstring filename = L"filename";
+		cov::Address address = CreateAddress(1);
+
+		manager.AddModule(moduleName, nullptr);
+		manager.RegisterAddress(address, filename, 42, 0);
+		ASSERT_FALSE(manager.IsLineExecuted(filename, 42));
+
+		manager.MarkAddressAsExecuted(address);
+		manager.OnExitProcess(nullptr);
+		ASSERT_TRUE(manager.IsLineExecuted(filename, 42));
+		ASSERT_FALSE(manager.IsLineExecuted(filename, 43));
+		ASSERT_FALSE(manager.IsLineExecuted(L"otherFilename", 42));
+
+		manager.AddModule(L"otherModule", nullptr);
+		ASSERT_FALSE(manager.IsLineExecuted(filename, 42));
+
+		manager.AddModule(moduleName, nullptr);
+		ASSERT_TRUE(manager.IsLineExecuted(filename, 42));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, HitCount)
+	{
+		cov::ExecutedAddressManager manager;
+		const std::wstring filename = L"filename";
+		cov::Address address = CreateAddress(1);
+
+		manager.AddModule(L"module", nullptr);
+		manager.KeepExecutedAddresses();
+		manager.RegisterAddress(address, filename, 42, 10);
+		ASSERT_EQ(10, manager.GetInstructionToRestore(address).get());
+		ASSERT_EQ(boost::none, manager.GetInstructionToRestore(CreateAddress(2)));
+
+		manager.MarkAddressAsExecuted(address);
+		manager.MarkAddressAsExecuted(address);
+
+		auto coverageData = manager.CreateCoverageData(L"", 0);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(2, file[42]->GetHitCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, AddedHitCount)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address = CreateAddress(1);
+
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address, L"filename", 42, 10);
+		manager.MarkAddressAsExecuted(address, 1000);
+
+		auto coverageData = manager.CreateCoverageData(L"", 0);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(1000, file[42]->GetHitCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, FirstHitOrder)
+	{
+		cov::ExecutedAddressManager manager;
+		const std::wstring filename = L"filename";
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+
+		manager.AddModule(L"module", nullptr);
+		manager.KeepExecutedAddresses();
+		manager.RegisterAddress(address1, filename, 42, 10);
+		manager.RegisterAddress(address2, filename, 43, 10);
+		manager.RegisterAddress(CreateAddress(3), filename, 44, 10);
+
+		manager.MarkAddressAsExecuted(address2);
+		manager.MarkAddressAsExecuted(address1);
+		manager.MarkAddressAsExecuted(address2);
+
+		auto coverageData = manager.CreateCoverageData(L"", 0);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(2, file[42]->GetFirstHitOrder());
+		ASSERT_EQ(1, file[43]->GetFirstHitOrder());
+		ASSERT_EQ(0, file[44]->GetFirstHitOrder());
+		ASSERT_LE(file[43]->GetFirstHitTime(), file[42]->GetFirstHitTime());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, LinesRecording)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+
+		ASSERT_THROW(manager.TakeRecordedLines(), cov::CppCoverageException);
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address1, L"file1", 10, 0);
+		manager.RegisterAddress(address1, L"file2", 20, 0);
+		manager.RegisterAddress(address2, L"file1", 11, 0);
+		manager.EnableLinesRecording();
+
+		manager.MarkAddressAsExecuted(address1);
+		cov::ExecutedAddressManager::LinesByFile expectedLines{
+			{ L"file1", { 10 } }, { L"file2", { 20 } } };
+		ASSERT_EQ(expectedLines, manager.TakeRecordedLines());
+
+		manager.MarkAddressAsExecuted(address2);
+		manager.MarkAddressAsExecuted(address2);
+		expectedLines = { { L"file1", { 11 } } };
+		ASSERT_EQ(expectedLines, manager.TakeRecordedLines());
+		ASSERT_TRUE(manager.TakeRecordedLines().empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, JournalLines)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+
+		ASSERT_THROW(manager.TakeJournalLines(), cov::CppCoverageException);
+		manager.EnableJournal();
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address1, L"file1", 10, 0);
+		manager.RegisterAddress(address1, L"file2", 20, 0);
+		manager.MarkAddressAsExecuted(address1);
+
+		auto journalLines = manager.TakeJournalLines();
+		cov::ExecutedAddressManager::LinesByModule expectedLines{
+			{ L"module", { { L"file1", { 10 } }, { L"file2", { 20 } } } } };
+		ASSERT_EQ(expectedLines, journalLines.registeredLines_);
+		ASSERT_EQ(expectedLines, journalLines.executedLines_);
+
+		manager.RegisterAddress(address2, L"file1", 11, 0);
+		manager.KeepExecutedAddresses();
+		manager.MarkAddressAsExecuted(address2);
+		manager.MarkAddressAsExecuted(address2);
+		journalLines = manager.TakeJournalLines();
+		expectedLines = { { L"module", { { L"file1", { 11 } } } } };
+		ASSERT_EQ(expectedLines, journalLines.registeredLines_);
+		ASSERT_EQ(expectedLines, journalLines.executedLines_);
+
+		journalLines = manager.TakeJournalLines();
+		ASSERT_TRUE(journalLines.registeredLines_.empty());
+		ASSERT_TRUE(journalLines.executedLines_.empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, ArmedAddressCount)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+		cov::Address address3 = CreateAddress(0x1003);
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address1, L"file", 10, 0);
+		manager.RegisterAddress(address1, L"file", 11, 0);
+		manager.RegisterAddress(address2, L"file", 12, 0);
+		manager.AddModule(L"module2", baseOfImage);
+		manager.RegisterAddress(address3, L"file2", 1, 0);
+		ASSERT_EQ(3, manager.GetArmedAddressCount(nullptr));
+
+		manager.MarkAddressAsExecuted(address1);
+		manager.MarkAddressAsExecuted(address1);
+		ASSERT_EQ(2, manager.GetArmedAddressCount(nullptr));
+		auto armedAddresses = manager.GetArmedAddresses(nullptr);
+		ASSERT_EQ(2, armedAddresses.size());
+		ASSERT_EQ(address2.GetValue(), armedAddresses.at(0).GetValue());
+		ASSERT_EQ(address3.GetValue(), armedAddresses.at(1).GetValue());
+
+		manager.OnUnloadModule(nullptr, baseOfImage);
+		ASSERT_EQ(1, manager.GetArmedAddressCount(nullptr));
+
+		manager.OnExitProcess(nullptr);
+		ASSERT_EQ(0, manager.GetArmedAddressCount(nullptr));
+		ASSERT_TRUE(manager.GetArmedAddresses(nullptr).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, ReleaseExecutedAddress)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(0x1001);
+		cov::Address address2 = CreateAddress(0x1002);
+		auto baseOfImage = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+
+		manager.AddModule(L"module", baseOfImage);
+		manager.RegisterAddress(address1, L"file", 10, 42);
+		manager.RegisterAddress(address2, L"file", 11, 43);
+
+		ASSERT_EQ(42, manager.MarkAddressAsExecuted(address1).get());
+		ASSERT_EQ(boost::none, manager.GetInstructionToRestore(address1));
+		ASSERT_EQ(boost::none, manager.MarkAddressAsExecuted(address1));
+		ASSERT_TRUE(manager.IsAddressReleased(address1));
+		ASSERT_FALSE(manager.IsAddressReleased(address2));
+
+		manager.OnUnloadModule(nullptr, baseOfImage);
+		ASSERT_FALSE(manager.IsAddressReleased(address1));
+
+		auto coverageData = manager.CreateCoverageData(L"", 0);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_TRUE(file[10]->HasBeenExecuted());
+		ASSERT_EQ(1, file[10]->GetHitCount());
+		ASSERT_FALSE(file[11]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, AddressesByProcess)
+	{
+		cov::ExecutedAddressManager manager;
+		auto hProcess = reinterpret_cast<HANDLE>(static_cast<intptr_t>(42));
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2{ hProcess, address1.GetValue() };
+
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address1, L"file", 10, 1);
+		manager.RegisterAddress(address2, L"file", 10, 2);
+
+		manager.OnExitProcess(nullptr);
+		ASSERT_EQ(boost::none, manager.GetInstructionToRestore(address1));
+		ASSERT_EQ(2, manager.GetInstructionToRestore(address2).get());
+		ASSERT_EQ(1, manager.GetArmedAddressCount(hProcess));
+
+		manager.OnUnloadModule(hProcess, nullptr);
+		ASSERT_EQ(boost::none, manager.GetInstructionToRestore(address2));
+		ASSERT_EQ(0, manager.GetArmedAddressCount(hProcess));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, ManyAddresses)
+	{
+		cov::ExecutedAddressManager manager;
+		const int addressCount = 1000;
+
+		manager.AddModule(L"module", nullptr);
+		manager.ReserveAddresses(nullptr, addressCount / 2);
+		for (int i = 0; i < addressCount; ++i)
+		{
+			auto instruction = static_cast<unsigned char>(i);
+			ASSERT_TRUE(manager.RegisterAddress(CreateAddress(i * 3), L"file", i, instruction));
+		}
+		ASSERT_EQ(addressCount, manager.GetArmedAddressCount(nullptr));
+
+		for (int i = 0; i < addressCount; ++i)
+		{
+			ASSERT_EQ(static_cast<unsigned char>(i), manager.GetInstructionToRestore(CreateAddress(i * 3)).get());
+			ASSERT_EQ(boost::none, manager.GetInstructionToRestore(CreateAddress(i * 3 + 1)));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, ReserveLines)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+
+		manager.AddModule(L"module", nullptr);
+		ASSERT_THROW(manager.ReserveLines(L"file", 2, 1), cov::CppCoverageException);
+		manager.ReserveLines(L"file", 10, 20);
+		manager.RegisterAddress(address1, L"file", 5, 0);
+		manager.RegisterAddress(address2, L"file", 30, 0);
+		manager.MarkAddressAsExecuted(address2);
+		ASSERT_FALSE(manager.IsLineExecuted(L"file", 15));
+		ASSERT_FALSE(manager.IsLineExecuted(L"file", 5));
+		ASSERT_TRUE(manager.IsLineExecuted(L"file", 30));
+
+		auto coverageData = manager.CreateCoverageData(L"", 0);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(2, file.GetLines().size());
+		ASSERT_NE(nullptr, file[5]);
+		ASSERT_EQ(nullptr, file[15]);
+		ASSERT_TRUE(file[30]->HasBeenExecuted());
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(ExecutedAddressManagerTest, AddSameModuleTwice)
 	{
@@ -127,4 +495,75 @@ namespace CppCoverageTest
 		ASSERT_EQ(moduleName1, modules.at(0)->GetPath().wstring());
 		ASSERT_EQ(moduleName2, modules.at(1)->GetPath().wstring());
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, MemoryBudget)
+	{
+		cov::ExecutedAddressManager manager;
+		auto baseOfImage1 = reinterpret_cast<void*>(static_cast<intptr_t>(0x1000));
+		auto baseOfImage2 = reinterpret_cast<void*>(static_cast<intptr_t>(0x2000));
+		HANDLE hProcess = nullptr;
+
+		manager.SetMemoryBudget(1);
+		manager.AddModule(L"module1", baseOfImage1);
+		manager.RegisterAddress(CreateAddress(0x1001), L"file1", 42, 0);
+		manager.RegisterAddress(CreateAddress(0x1002), L"file1", 43, 0);
+		manager.MarkAddressAsExecuted(CreateAddress(0x1002), 3);
+		manager.AddModule(L"module2", baseOfImage2);
+		manager.RegisterAddress(CreateAddress(0x2001), L"file2", 10, 0);
+
+		// module2 is the last added module.
+		manager.OnUnloadModule(hProcess, baseOfImage1);
+		ASSERT_EQ(1u, manager.GetSpilledModuleCount());
+
+		auto checkCoverageData = [](const Plugin::CoverageData& coverageData) {
+			const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+			ASSERT_EQ(L"file1", file.GetPath().wstring());
+			ASSERT_FALSE(file[42]->HasBeenExecuted());
+			ASSERT_TRUE(file[43]->HasBeenExecuted());
+			ASSERT_EQ(3, file[43]->GetHitCount());
+		};
+		checkCoverageData(manager.CreateCoverageData(L"", 0));
+		ASSERT_EQ(1, manager.CreateCoverageSummary(L"", 0).GetModules().at(0).coverageRate_.GetExecutedLinesCount());
+		ASSERT_EQ(1u, manager.GetSpilledModuleCount());
+
+		manager.AddModule(L"module1", baseOfImage1);
+		ASSERT_EQ(0u, manager.GetSpilledModuleCount());
+		ASSERT_TRUE(manager.IsLineExecuted(L"file1", 43));
+		checkCoverageData(manager.TakeCoverageData(L"", 0));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ExecutedAddressManagerTest, EagerLineDisarm)
+	{
+		cov::ExecutedAddressManager manager;
+		cov::Address address1 = CreateAddress(1);
+		cov::Address address2 = CreateAddress(2);
+		cov::Address address3 = CreateAddress(3);
+		cov::Address address4 = CreateAddress(4);
+
+		manager.EnableEagerLineDisarm();
+		manager.AddModule(L"module", nullptr);
+		manager.RegisterAddress(address1, L"file", 10, 1);
+		manager.RegisterAddress(address2, L"file", 10, 2);
+		manager.RegisterAddress(address3, L"file", 10, 3);
+		manager.RegisterAddress(address3, L"file", 11, 3);
+		manager.RegisterAddress(address4, L"file", 20, 4);
+		ASSERT_TRUE(manager.TakeDisarmedAddresses(nullptr).empty());
+
+		manager.MarkAddressAsExecuted(address1);
+		// The line 11 of the address 3 is not executed yet.
+		auto disarmedAddresses = manager.TakeDisarmedAddresses(nullptr);
+		ASSERT_EQ(1, disarmedAddresses.size());
+		ASSERT_EQ(2, disarmedAddresses[0].first);
+		ASSERT_EQ(2, disarmedAddresses[0].second);
+		ASSERT_TRUE(manager.IsAddressReleased(address2));
+		ASSERT_FALSE(manager.MarkAddressAsExecuted(address2));
+		ASSERT_EQ(2, manager.GetArmedAddressCount(nullptr));
+		ASSERT_TRUE(manager.TakeDisarmedAddresses(nullptr).empty());
+
+		ASSERT_EQ(3, *manager.MarkAddressAsExecuted(address3));
+		ASSERT_TRUE(manager.TakeDisarmedAddresses(nullptr).empty());
+		ASSERT_EQ(1, manager.GetArmedAddressCount(nullptr));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,89 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/FuzzingBitmap.hpp"
+#include "TestHelper/Tools.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const auto hProcess1 = reinterpret_cast<HANDLE>(static_cast<intptr_t>(1));
+		const auto hProcess2 = reinterpret_cast<HANDLE>(static_cast<intptr_t>(2));
+		using TestHelper::CreateAddress;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FuzzingBitmapTest, ParseMarker)
+	{
+		using Marker = cov::FuzzingBitmap::Marker;
+
+		ASSERT_EQ(Marker::Iteration, cov::FuzzingBitmap::ParseMarker(cov::FuzzingBitmapFormat::IterationMarker));
+		ASSERT_EQ(Marker::Epoch, cov::FuzzingBitmap::ParseMarker(std::wstring{cov::FuzzingBitmapFormat::EpochMarker} + L"\r\n"));
+		ASSERT_EQ(Marker::None, cov::FuzzingBitmap::ParseMarker(L""));
+		ASSERT_EQ(Marker::None, cov::FuzzingBitmap::ParseMarker(L"\n"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FuzzingBitmapTest, Iterations)
+	{
+		cov::FuzzingBitmap fuzzingBitmap{1024};
+		const auto& header = fuzzingBitmap.GetHeader();
+
+		ASSERT_EQ(cov::FuzzingBitmapFormat::Version, header.version_);
+		ASSERT_EQ(1024, header.bitCount_);
+		ASSERT_FALSE(fuzzingBitmap.IsBitSet(CreateAddress(hProcess1, 10)));
+
+		fuzzingBitmap.OnHit(CreateAddress(hProcess1, 10));
+		fuzzingBitmap.OnHit(CreateAddress(hProcess1, 20));
+		fuzzingBitmap.OnIterationEnd();
+		ASSERT_EQ(1, header.iterationCount_);
+		ASSERT_EQ(2, header.newHitCount_);
+		ASSERT_TRUE(fuzzingBitmap.IsBitSet(CreateAddress(hProcess1, 10)));
+
+		fuzzingBitmap.OnIterationEnd();
+		ASSERT_EQ(2, header.iterationCount_);
+		ASSERT_EQ(0, header.newHitCount_);
+		ASSERT_EQ(2, header.epochHitCount_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FuzzingBitmapTest, Epoch)
+	{
+		cov::FuzzingBitmap fuzzingBitmap{1024};
+
+		fuzzingBitmap.OnHit(CreateAddress(hProcess1, 10));
+		fuzzingBitmap.OnHit(CreateAddress(hProcess2, 20));
+		fuzzingBitmap.OnHit(CreateAddress(hProcess2, 30));
+		fuzzingBitmap.OnExitProcess(hProcess1);
+		fuzzingBitmap.OnIterationEnd();
+
+		auto addressesByProcess = fuzzingBitmap.OnEpoch();
+		ASSERT_EQ(1, addressesByProcess.size());
+		ASSERT_EQ((std::vector<DWORD64>{20, 30}), addressesByProcess.at(hProcess2));
+
+		const auto& header = fuzzingBitmap.GetHeader();
+		ASSERT_EQ(1, header.epochCount_);
+		ASSERT_EQ(0, header.epochHitCount_);
+		ASSERT_FALSE(fuzzingBitmap.IsBitSet(CreateAddress(hProcess2, 20)));
+		ASSERT_TRUE(fuzzingBitmap.OnEpoch().empty());
+	}
+}
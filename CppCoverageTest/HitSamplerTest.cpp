@@ -0,0 +1,122 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/HitSampler.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+#include "TestHelper/Tools.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Clock = cov::HitSampler::Clock;
+		using TestHelper::CreateAddress;
+
+		//---------------------------------------------------------------------
+		std::vector<void*> GetValues(const std::vector<cov::Address>& addresses)
+		{
+			std::vector<void*> values;
+
+			for (const auto& address : addresses)
+				values.push_back(address.GetValue());
+			return values;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HitSamplerTest, InvalidBudget)
+	{
+		ASSERT_THROW(cov::HitSampler(0, Clock::now()), cov::CppCoverageException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HitSamplerTest, Budget)
+	{
+		auto start = Clock::now();
+		cov::HitSampler hitSampler{20, start};
+		auto window = hitSampler.GetWindow();
+
+		for (int i = 0; i < 5; ++i)
+			hitSampler.OnHit(CreateAddress(nullptr, i));
+
+		ASSERT_TRUE(hitSampler.ComputePlan(start).addressesToArm_.empty());
+
+		auto plan = hitSampler.ComputePlan(start + window);
+		ASSERT_EQ(2, plan.addressesToArm_.size());
+
+		// Armed addresses not hit yet use the budget.
+		plan = hitSampler.ComputePlan(start + 2 * window);
+		ASSERT_TRUE(plan.addressesToArm_.empty());
+
+		hitSampler.OnHit(CreateAddress(nullptr, 0));
+		plan = hitSampler.ComputePlan(start + 3 * window);
+		ASSERT_EQ(1, plan.addressesToArm_.size());
+		ASSERT_EQ(1, hitSampler.GetSampledHitCount());
+		ASSERT_EQ(3, hitSampler.GetArmedCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HitSamplerTest, Rotation)
+	{
+		auto start = Clock::now();
+		cov::HitSampler hitSampler{10, start};
+		auto window = hitSampler.GetWindow();
+
+		hitSampler.OnHit(CreateAddress(nullptr, 1));
+		hitSampler.OnHit(CreateAddress(nullptr, 2));
+
+		auto plan = hitSampler.ComputePlan(start + window);
+		ASSERT_EQ(GetValues({CreateAddress(nullptr, 1)}), GetValues(plan.addressesToArm_));
+
+		hitSampler.OnHit(CreateAddress(nullptr, 1));
+		plan = hitSampler.ComputePlan(start + 2 * window);
+		ASSERT_EQ(GetValues({CreateAddress(nullptr, 2)}), GetValues(plan.addressesToArm_));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HitSamplerTest, DisarmPendingAddresses)
+	{
+		auto start = Clock::now();
+		cov::HitSampler hitSampler{1, start};
+		auto window = hitSampler.GetWindow();
+
+		hitSampler.OnHit(CreateAddress(nullptr, 1));
+		hitSampler.OnHit(CreateAddress(nullptr, 2));
+		hitSampler.ComputePlan(start + window);
+
+		auto plan = hitSampler.ComputePlan(start + 20 * window);
+		ASSERT_EQ(GetValues({CreateAddress(nullptr, 1)}), GetValues(plan.addressesToDisarm_));
+		ASSERT_EQ(GetValues({CreateAddress(nullptr, 2)}), GetValues(plan.addressesToArm_));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HitSamplerTest, OnExitProcess)
+	{
+		auto start = Clock::now();
+		cov::HitSampler hitSampler{1, start};
+		auto hProcess = reinterpret_cast<HANDLE>(static_cast<intptr_t>(1));
+
+		hitSampler.OnHit(CreateAddress(hProcess, 1));
+		hitSampler.OnExitProcess(hProcess);
+
+		auto plan = hitSampler.ComputePlan(start + hitSampler.GetWindow());
+		ASSERT_TRUE(plan.addressesToArm_.empty());
+	}
+}
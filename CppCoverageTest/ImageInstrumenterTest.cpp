@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <filesystem>
+#include <boost/algorithm/string.hpp>
+
+#include "CppCoverage/CoverageFilterManager.hpp"
+#include "CppCoverage/CoverageFilterSettings.hpp"
+#include "CppCoverage/ImageInstrumenter.hpp"
+#include "CppCoverage/ModuleLineTable.hpp"
+#include "CppCoverage/Patterns.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "Tools/Tool.hpp"
+
+#include "TestHelper/Tools.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+#include "TestCoverageConsole/TestBasic.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(ImageInstrumenterTest, Instrument)
+	{
+		cov::Patterns modulePatterns{ false };
+		cov::Patterns sourcePatterns{ false };
+
+		modulePatterns.AddSelectedPatterns(L"*");
+		sourcePatterns.AddSelectedPatterns(
+			boost::to_lower_copy(TestCoverageConsole::GetTestBasicFilename().wstring()));
+
+		cov::CoverageFilterSettings coverageFilterSettings{ modulePatterns, sourcePatterns };
+		cov::CoverageFilterManager coverageFilterManager{ coverageFilterSettings, {}, {}, false };
+		auto outputPath = std::filesystem::path{ OUT_DIR } / "TestCoverageConsoleInstrumented.exe";
+		auto countersPath = cov::ImageInstrumenter::GetCountersPath(outputPath);
+
+		std::filesystem::remove(countersPath);
+		auto lineTable = cov::ImageInstrumenter::Instrument(
+			TestCoverageConsole::GetOutputBinaryPath(), {}, coverageFilterManager, outputPath);
+		TestHelper::RunProcess(outputPath, { Tools::ToLocalString(TestCoverageConsole::TestBasic) });
+
+		auto coverageData = lineTable.CreateCoverageData(L"name", lineTable.ReadHitCounts(countersPath), true);
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		const auto* functionLine = file[TestCoverageConsole::GetTestBasicLine()];
+		ASSERT_NE(nullptr, functionLine);
+		ASSERT_EQ(1u, functionLine->GetHitCount());
+
+		// int answer = 42;
+		const auto* notExecutedLine = file[TestCoverageConsole::GetTestBasicLine() + 4];
+		ASSERT_TRUE(!notExecutedLine || !notExecutedLine->HasBeenExecuted());
+	}
+}
@@ -0,0 +1,104 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/InstructionDecoder.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const uint64_t Address = 0x1000;
+
+		//---------------------------------------------------------------------
+		cov::DecodedInstruction Decode(const std::vector<uint8_t>& code, bool is64Bits = true)
+		{
+			auto instruction = cov::DecodeInstruction(code.data(), code.size(), Address, is64Bits);
+			if (!instruction)
+				throw std::runtime_error("Cannot decode instruction.");
+			return *instruction;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(InstructionDecoderTest, Sequential)
+	{
+		ASSERT_EQ(1, Decode({ 0x55 }, false).length_); // push ebp
+		ASSERT_EQ(3, Decode({ 0x48, 0x89, 0xE5 }).length_); // mov rbp, rsp
+		ASSERT_EQ(4, Decode({ 0x8B, 0x44, 0x24, 0x08 }, false).length_); // mov eax, [esp+8]
+		ASSERT_EQ(7, Decode({ 0x48, 0x8B, 0x05, 1, 2, 3, 4 }).length_); // mov rax, [rip+x]
+		ASSERT_EQ(10, Decode({ 0x48, 0xB8, 1, 2, 3, 4, 5, 6, 7, 8 }).length_); // mov rax, imm64
+		ASSERT_EQ(6, Decode({ 0x66, 0xC7, 0x45, 0xFC, 1, 0 }).length_); // mov word ptr [rbp-4], 1
+		ASSERT_EQ(5, Decode({ 0xC5, 0xFA, 0x10, 0x45, 0xFC }).length_); // vmovss
+		ASSERT_EQ(6, Decode({ 0xC4, 0xE3, 0x79, 0x04, 0xC0, 0x01 }).length_); // vpermilps
+		ASSERT_EQ(4, Decode({ 0xF3, 0x0F, 0x1E, 0xFA }).length_); // endbr64
+
+		auto instruction = Decode({ 0x48, 0x83, 0xEC, 0x20 }); // sub rsp, 20h
+		ASSERT_EQ(cov::InstructionFlow::Sequential, instruction.flow_);
+		ASSERT_FALSE(instruction.target_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(InstructionDecoderTest, RelativeJumps)
+	{
+		auto jump = Decode({ 0xEB, 0x10 });
+		ASSERT_EQ(cov::InstructionFlow::Jump, jump.flow_);
+		ASSERT_EQ(Address + 2 + 0x10, *jump.target_);
+
+		auto conditionalJump = Decode({ 0x0F, 0x84, 0xF0, 0xFF, 0xFF, 0xFF });
+		ASSERT_EQ(cov::InstructionFlow::ConditionalJump, conditionalJump.flow_);
+		ASSERT_EQ(Address + 6 - 0x10, *conditionalJump.target_);
+
+		auto call = Decode({ 0xE8, 0, 1, 0, 0 });
+		ASSERT_EQ(cov::InstructionFlow::Call, call.flow_);
+		ASSERT_EQ(Address + 5 + 0x100, *call.target_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(InstructionDecoderTest, ControlFlow)
+	{
+		ASSERT_EQ(cov::InstructionFlow::Return, Decode({ 0xC3 }).flow_);
+		ASSERT_EQ(cov::InstructionFlow::Return, Decode({ 0xFF, 0x25, 0, 0, 0, 0 }).flow_);
+		ASSERT_EQ(cov::InstructionFlow::IndirectJump, Decode({ 0xFF, 0xE0 }).flow_);
+		ASSERT_EQ(cov::InstructionFlow::IndirectJump,
+			Decode({ 0xFF, 0x24, 0x85, 0, 0, 0, 0 }, false).flow_);
+		ASSERT_EQ(cov::InstructionFlow::Call, Decode({ 0xFF, 0xD0 }).flow_);
+		ASSERT_EQ(cov::InstructionFlow::Interrupt, Decode({ 0xCC }).flow_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(InstructionDecoderTest, RipRelative)
+	{
+		ASSERT_TRUE(Decode({ 0x48, 0x8B, 0x05, 1, 2, 3, 4 }).isRipRelative_); // mov rax, [rip+x]
+		ASSERT_TRUE(Decode({ 0x0F, 0x10, 0x05, 1, 2, 3, 4 }).isRipRelative_); // movups xmm0, [rip+x]
+		ASSERT_FALSE(Decode({ 0x8B, 0x05, 1, 2, 3, 4 }, false).isRipRelative_); // mov eax, [x]
+		ASSERT_FALSE(Decode({ 0x8B, 0x04, 0x25, 1, 2, 3, 4 }).isRipRelative_); // mov eax, [x]
+		ASSERT_FALSE(Decode({ 0x48, 0x89, 0xE5 }).isRipRelative_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(InstructionDecoderTest, Invalid)
+	{
+		std::vector<uint8_t> truncated{ 0xE8, 0, 0 };
+		ASSERT_FALSE(cov::DecodeInstruction(truncated.data(), truncated.size(), Address, true));
+
+		std::vector<uint8_t> farJump{ 0xEA, 0, 0, 0, 0, 0, 0 };
+		ASSERT_FALSE(cov::DecodeInstruction(farJump.data(), farJump.size(), Address, false));
+	}
+}
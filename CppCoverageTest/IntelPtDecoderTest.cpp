@@ -0,0 +1,179 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <algorithm>
+
+#include "CppCoverage/IntelPtDecoder.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Ranges = std::vector<std::pair<uint64_t, uint64_t>>;
+		using Trace = std::vector<uint8_t>;
+
+		const uint64_t CodeAddress = 0x1000;
+
+		//---------------------------------------------------------------------
+		std::vector<uint8_t> CreateCode()
+		{
+			std::vector<uint8_t> code(0x50, 0xCC);
+			const std::vector<std::vector<uint8_t>> instructions = {
+				{0x48, 0x85, 0xC0},                 // 0x1000: test rax, rax
+				{0x74, 0x05},                       // 0x1003: je 0x100A
+				{0xE8, 0x10, 0x00, 0x00, 0x00},     // 0x1005: call 0x101A
+				{0xFF, 0xE0}};                      // 0x100A: jmp rax
+			auto it = code.begin();
+			for (const auto& instruction : instructions)
+				it = std::copy(instruction.begin(), instruction.end(), it);
+			code[0x1A] = 0xC3;                      // 0x101A: ret
+			code[0x30] = 0x90;                      // 0x1030: nop
+			code[0x31] = 0xC3;                      // 0x1031: ret
+			code[0x40] = 0x90;                      // 0x1040: nop
+			code[0x41] = 0x90;                      // 0x1041: nop
+			code[0x42] = 0x90;                      // 0x1042: nop
+			code[0x43] = 0xC3;                      // 0x1043: ret
+			return code;
+		}
+
+		//---------------------------------------------------------------------
+		cov::IntelPtImage::ReadCode CreateReadCode(const std::vector<uint8_t>& code)
+		{
+			return [&code](uint64_t address, uint8_t* buffer, size_t size) -> size_t {
+				if (address < CodeAddress || address >= CodeAddress + code.size())
+					return 0;
+				auto offset = static_cast<size_t>(address - CodeAddress);
+				auto copiedSize = (std::min)(size, code.size() - offset);
+				std::copy_n(code.begin() + offset, copiedSize, buffer);
+				return copiedSize;
+			};
+		}
+
+		//---------------------------------------------------------------------
+		void Append(Trace& trace, const Trace& packet)
+		{
+			trace.insert(trace.end(), packet.begin(), packet.end());
+		}
+
+		//---------------------------------------------------------------------
+		Trace CreatePsb()
+		{
+			Trace trace;
+			for (int i = 0; i < 8; ++i)
+				Append(trace, {0x02, 0x82});
+			Append(trace, {0x02, 0x23}); // PSBEND
+			return trace;
+		}
+
+		//---------------------------------------------------------------------
+		Trace CreateFlowTrace()
+		{
+			auto trace = CreatePsb();
+			Append(trace, {0xD1, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}); // TIP.PGE 0x1000
+			Append(trace, {0x19, 0, 0, 0, 0, 0, 0, 0});                          // TSC
+			Append(trace, {0x0A});                                                // TNT not taken, taken
+			Append(trace, {0x2D, 0x30, 0x10});                                    // TIP 0x1030
+			Append(trace, {0x01});                                                // TIP.PGD
+			return trace;
+		}
+
+		//---------------------------------------------------------------------
+		const Ranges ExpectedFlowRanges = {
+			{0x1000, 0x1005}, {0x1005, 0x100A}, {0x101A, 0x101B}, {0x100A, 0x100C}, {0x1030, 0x1032}};
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(IntelPtDecoderTest, Flow)
+	{
+		auto code = CreateCode();
+		cov::IntelPtImage image{CreateReadCode(code)};
+		cov::IntelPtDecoder decoder{image, true};
+		auto trace = CreateFlowTrace();
+
+		decoder.Decode(trace.data(), trace.size());
+		ASSERT_EQ(ExpectedFlowRanges, image.TakeExecutedRanges());
+		ASSERT_EQ(0, decoder.GetErrorCount());
+
+		// The blocks are reported once.
+		decoder.Decode(trace.data(), trace.size());
+		ASSERT_TRUE(image.TakeExecutedRanges().empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(IntelPtDecoderTest, SplitTrace)
+	{
+		auto code = CreateCode();
+		cov::IntelPtImage image{CreateReadCode(code)};
+		cov::IntelPtDecoder decoder{image, true};
+		auto trace = CreateFlowTrace();
+
+		for (auto byte : trace)
+			decoder.Decode(&byte, 1);
+		ASSERT_EQ(ExpectedFlowRanges, image.TakeExecutedRanges());
+		ASSERT_EQ(7, decoder.GetPacketCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(IntelPtDecoderTest, Synchronization)
+	{
+		auto code = CreateCode();
+		cov::IntelPtImage image{CreateReadCode(code)};
+		cov::IntelPtDecoder decoder{image, true};
+		Trace trace = {0x0D, 0x42, 0x02};
+
+		// 0x02 0x42 is not a valid packet.
+		Append(trace, CreatePsb());
+		Append(trace, {0x02, 0x42});
+		Append(trace, CreateFlowTrace());
+		decoder.Decode(trace.data(), trace.size());
+		ASSERT_EQ(ExpectedFlowRanges, image.TakeExecutedRanges());
+		ASSERT_EQ(1, decoder.GetErrorCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(IntelPtDecoderTest, AsynchronousEvent)
+	{
+		auto code = CreateCode();
+		cov::IntelPtImage image{CreateReadCode(code)};
+		cov::IntelPtDecoder decoder{image, true};
+		auto trace = CreatePsb();
+
+		Append(trace, {0x31, 0x40, 0x10}); // TIP.PGE 0x1040
+		Append(trace, {0x3D, 0x42, 0x10}); // FUP 0x1042
+		Append(trace, {0x01});             // TIP.PGD
+		decoder.Decode(trace.data(), trace.size());
+		ASSERT_EQ((Ranges{{0x1040, 0x1042}}), image.TakeExecutedRanges());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(IntelPtDecoderTest, UnreadableCode)
+	{
+		auto code = CreateCode();
+		cov::IntelPtImage image{CreateReadCode(code)};
+		cov::IntelPtDecoder decoder{image, true};
+		auto trace = CreatePsb();
+
+		Append(trace, {0x31, 0x00, 0x20}); // TIP.PGE 0x2000
+		decoder.Decode(trace.data(), trace.size());
+		ASSERT_TRUE(image.TakeExecutedRanges().empty());
+		ASSERT_EQ(1, decoder.GetErrorCount());
+	}
+}
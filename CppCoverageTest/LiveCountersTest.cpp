@@ -0,0 +1,67 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/LiveCounters.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(LiveCountersTest, Read)
+	{
+		cov::LiveCounters liveCounters{"LiveCountersTest"};
+
+		liveCounters.SetPhase(cov::LiveCounters::Phase::Running);
+		liveCounters.AddDebugEvent();
+		liveCounters.AddDebugEvent();
+		liveCounters.AddArmedBreakPoints(10);
+		liveCounters.AddHitBreakPoint();
+		liveCounters.AddExecutedLines(3);
+		liveCounters.AddLoadedModule();
+
+		auto values = cov::LiveCounters::Read("LiveCountersTest");
+		ASSERT_TRUE(static_cast<bool>(values));
+		ASSERT_EQ(cov::LiveCounters::Phase::Running, values->phase_);
+		ASSERT_EQ(2u, values->debugEventCount_);
+		ASSERT_EQ(10u, values->armedBreakPointCount_);
+		ASSERT_EQ(1u, values->hitBreakPointCount_);
+		ASSERT_EQ(3u, values->executedLineCount_);
+		ASSERT_EQ(1u, values->loadedModuleCount_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LiveCountersTest, ReadUnknownName)
+	{
+		ASSERT_FALSE(static_cast<bool>(cov::LiveCounters::Read("UnknownName")));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LiveCountersTest, SameName)
+	{
+		cov::LiveCounters liveCounters{"LiveCountersTest"};
+		liveCounters.AddDebugEvent();
+
+		cov::LiveCounters otherLiveCounters{"LiveCountersTest"};
+		otherLiveCounters.AddDebugEvent();
+		otherLiveCounters.AddDebugEvent();
+
+		ASSERT_EQ(1u, cov::LiveCounters::Read("LiveCountersTest")->debugEventCount_);
+		ASSERT_EQ(2u, otherLiveCounters.GetValues().debugEventCount_);
+	}
+}
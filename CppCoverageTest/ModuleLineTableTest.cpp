@@ -0,0 +1,111 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/ModuleLineTable.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		cov::ModuleLineTable CreateModuleLineTable()
+		{
+			return cov::ModuleLineTable{
+			    L"C:\\module.exe",
+			    {L"C:\\file1.cpp", L"C:\\file2.cpp"},
+			    {{0x1020, 0, 10}, {0x1030, 0, 11}, {0x1010, 1, 5}, {0x1040, 0, 10}}};
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ModuleLineTableTest, FindLineIndex)
+	{
+		auto lineTable = CreateModuleLineTable();
+
+		ASSERT_FALSE(lineTable.FindLineIndex(0x1000));
+		ASSERT_EQ(2u, *lineTable.FindLineIndex(0x1010));
+		ASSERT_EQ(2u, *lineTable.FindLineIndex(0x101F));
+		ASSERT_EQ(0u, *lineTable.FindLineIndex(0x1020));
+		ASSERT_EQ(3u, *lineTable.FindLineIndex(0x2000));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ModuleLineTableTest, WriteRead)
+	{
+		TestHelper::TemporaryPath path;
+		CreateModuleLineTable().Write(path);
+
+		auto lineTable = cov::ModuleLineTable::Read(path);
+		ASSERT_EQ(std::filesystem::path{L"C:\\module.exe"}, lineTable.GetModulePath());
+		ASSERT_EQ(2u, lineTable.GetFiles().size());
+
+		const auto& lines = lineTable.GetLines();
+		ASSERT_EQ(4u, lines.size());
+		ASSERT_EQ(0x1010u, lines[2].rva_);
+		ASSERT_EQ(1u, lines[2].fileIndex_);
+		ASSERT_EQ(5u, lines[2].lineNumber_);
+		ASSERT_EQ(0u, lines[3].fileIndex_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ModuleLineTableTest, CreateCoverageData)
+	{
+		auto lineTable = CreateModuleLineTable();
+		auto coverageData = lineTable.CreateCoverageData(L"name", {1, 0, 0, 2}, true);
+
+		const auto& module = *coverageData.GetModules().at(0);
+		const auto& file1 = *module.GetFiles().at(0);
+		const auto& file2 = *module.GetFiles().at(1);
+		ASSERT_TRUE(file1[10]->HasBeenExecuted());
+		ASSERT_EQ(3u, file1[10]->GetHitCount());
+		ASSERT_FALSE(file1[11]->HasBeenExecuted());
+		ASSERT_FALSE(file2[5]->HasBeenExecuted());
+
+		ASSERT_ANY_THROW(lineTable.CreateCoverageData(L"name", {1}, true));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ModuleLineTableTest, ReadHitCounts)
+	{
+		TestHelper::TemporaryPath path;
+		auto lineTable = CreateModuleLineTable();
+		{
+			const uint32_t counters[] = {1, 0, 0x10203, 2};
+			std::ofstream ofs{path.GetPath(), std::ios::binary};
+			ofs.write(reinterpret_cast<const char*>(counters), sizeof(counters));
+		}
+		ASSERT_EQ((std::vector<uint64_t>{1, 0, 0x10203, 2}), lineTable.ReadHitCounts(path));
+
+		{
+			std::ofstream ofs{path.GetPath(), std::ios::binary};
+			ofs << std::string(12, '\0');
+		}
+		ASSERT_ANY_THROW(lineTable.ReadHitCounts(path));
+	}
+}
@@ -0,0 +1,82 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/ModuleLoadHistory.hpp"
+#include "Tools/BlobCache.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+using std::chrono::milliseconds;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(ModuleLoadHistoryTest, WriteRead)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		auto blobCache = std::make_shared<Tools::BlobCache>(folder, 0);
+		TestHelper::TemporaryPath module1{TestHelper::TemporaryPathOption::CreateAsFile};
+		TestHelper::TemporaryPath module2{TestHelper::TemporaryPathOption::CreateAsFile};
+
+		{
+			cov::ModuleLoadHistory history{blobCache, L"Program.exe"};
+			ASSERT_TRUE(history.GetPreviousModules().empty());
+			history.AddLoadedModule(module1, milliseconds{5}, milliseconds{20});
+			history.AddLoadedModule(module2, milliseconds{10}, milliseconds{1});
+			history.AddLoadedModule(module1, milliseconds{30}, milliseconds{1});
+			history.Write();
+		}
+		ASSERT_TRUE(cov::ModuleLoadHistory(blobCache, L"Other.exe").GetPreviousModules().empty());
+
+		cov::ModuleLoadHistory history{blobCache, L"Program.exe"};
+		const auto& modules = history.GetPreviousModules();
+		ASSERT_EQ(2u, modules.size());
+		ASSERT_EQ(module1.GetPath(), modules[0].path_);
+		ASSERT_EQ(milliseconds{5}, modules[0].loadTime_);
+		ASSERT_EQ(milliseconds{20}, modules[0].registrationTime_);
+		ASSERT_EQ(module2.GetPath(), modules[1].path_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ModuleLoadHistoryTest, GetPrefetchOrder)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		auto blobCache = std::make_shared<Tools::BlobCache>(folder, 0);
+		TestHelper::TemporaryPath module1{TestHelper::TemporaryPathOption::CreateAsFile};
+		TestHelper::TemporaryPath module2{TestHelper::TemporaryPathOption::CreateAsFile};
+		TestHelper::TemporaryPath module3{TestHelper::TemporaryPathOption::CreateAsFile};
+		TestHelper::TemporaryPath removedModule;
+
+		{
+			cov::ModuleLoadHistory history{blobCache, L"Program.exe"};
+			history.AddLoadedModule(module1, milliseconds{0}, milliseconds{1});
+			history.AddLoadedModule(removedModule, milliseconds{10}, milliseconds{1});
+			history.AddLoadedModule(module2, milliseconds{50}, milliseconds{1});
+			history.AddLoadedModule(module3, milliseconds{100}, milliseconds{90});
+			history.Write();
+		}
+
+		// module3 must start before module2 to be ready when it is loaded.
+		auto modulePaths = cov::ModuleLoadHistory{blobCache, L"Program.exe"}.GetPrefetchOrder();
+		ASSERT_EQ(3u, modulePaths.size());
+		ASSERT_EQ(module1.GetPath(), modulePaths[0]);
+		ASSERT_EQ(module3.GetPath(), modulePaths[1]);
+		ASSERT_EQ(module2.GetPath(), modulePaths[2]);
+	}
+}
@@ -0,0 +1,145 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <algorithm>
+
+#include "CppCoverage/NativePdbReader.hpp"
+#include "TestCoverageConsole/TestDebugInformationEnumerator.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct DebugInformationHandlerMock : cov::IDebugInformationHandler
+		{
+			//-----------------------------------------------------------------
+			explicit DebugInformationHandlerMock(const std::filesystem::path& selectedFilename)
+				: selectedFilename_{selectedFilename}
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool IsSourceFileSelected(const std::filesystem::path& sourceFile) override
+			{
+				return selectedFilename_ == sourceFile.filename();
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFile(const std::filesystem::path&, const std::vector<Line>& lines) override
+			{
+				for (const auto& line : lines)
+					lines_.emplace_back(line.lineNumber_, line.virtualAddress_);
+			}
+
+			//-----------------------------------------------------------------
+			void OnSourceFileChecksum(const std::filesystem::path&,
+			                          const Tools::SourceChecksum& checksum) override
+			{
+				checksums_.push_back(checksum);
+			}
+
+			const std::filesystem::path selectedFilename_;
+			std::vector<std::pair<unsigned long, int64_t>> lines_;
+			std::vector<Tools::SourceChecksum> checksums_;
+		};
+
+		//---------------------------------------------------------------------
+		void Enumerate(bool useNativePdbReader, DebugInformationHandlerMock& handler)
+		{
+			cov::DebugInformationEnumerator debugInformationEnumerator{{}, nullptr, useNativePdbReader};
+
+			if (!debugInformationEnumerator.Enumerate(TestCoverageConsole::GetOutputBinaryPath(), handler))
+				throw std::runtime_error("Cannot enumerate the lines");
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::pair<unsigned long, int64_t>> EnumerateLines(bool useNativePdbReader)
+		{
+			DebugInformationHandlerMock handler{
+			    TestCoverageConsole::GetDebugInformationEnumeratorTestPath().filename()};
+
+			Enumerate(useNativePdbReader, handler);
+			std::sort(handler.lines_.begin(), handler.lines_.end());
+			return handler.lines_;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<Tools::SourceChecksum> EnumerateChecksums(bool useNativePdbReader)
+		{
+			DebugInformationHandlerMock handler{
+			    TestCoverageConsole::GetDebugInformationEnumeratorTestPath().filename()};
+
+			Enumerate(useNativePdbReader, handler);
+			return handler.checksums_;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(NativePdbReaderTest, Read)
+	{
+		TestHelper::TemporaryPath path{TestHelper::TemporaryPathOption::CreateAsFile};
+
+		ASSERT_FALSE(cov::NativePdbReader::Read(path));
+		ASSERT_TRUE(static_cast<bool>(cov::NativePdbReader::Read(TestCoverageConsole::GetOutputBinaryPath())));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(NativePdbReaderTest, ReadFastLinkObjectFiles)
+	{
+		TestHelper::TemporaryPath path{TestHelper::TemporaryPathOption::CreateAsFile};
+
+		ASSERT_FALSE(cov::NativePdbReader::ReadFastLinkObjectFiles(path));
+		ASSERT_FALSE(cov::NativePdbReader::ReadFastLinkObjectFiles(TestCoverageConsole::GetOutputBinaryPath()));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(NativePdbReaderTest, ReadSourceServerStream)
+	{
+		TestHelper::TemporaryPath path{TestHelper::TemporaryPathOption::CreateAsFile};
+
+		// The test binaries are not source-indexed.
+		ASSERT_FALSE(cov::NativePdbReader::ReadSourceServerStream(path));
+		ASSERT_FALSE(cov::NativePdbReader::ReadSourceServerStream(TestCoverageConsole::GetOutputBinaryPath()));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(NativePdbReaderTest, SameLinesAsDia)
+	{
+		auto lines = EnumerateLines(true);
+
+		ASSERT_FALSE(lines.empty());
+		ASSERT_EQ(EnumerateLines(false), lines);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(NativePdbReaderTest, SameChecksumsAsDia)
+	{
+		auto checksums = EnumerateChecksums(true);
+
+		ASSERT_EQ(1, checksums.size());
+		ASSERT_NE(Tools::SourceChecksum::Type::None, checksums.at(0).type_);
+		ASSERT_EQ(EnumerateChecksums(false), checksums);
+	}
+}
@@ -19,6 +19,7 @@
 #include "CppCoverage/OptionsParser.hpp"
 #include "CppCoverage/ExportOptionParser.hpp"
 #include "CppCoverage/OptionsExport.hpp"
+#include "CppCoverage/ProgramOptions.hpp"
 
 #include "CppCoverageTest/TestTools.hpp"
 
@@ -115,6 +116,62 @@ namespace CppCoverageTest
 		     MakeOptionExport(cov::OptionsExportType::Cobertura));
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesFirstHitsValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeFirstHitsValue},
+		     MakeOptionExport(cov::OptionsExportType::FirstHits));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesCompactHtmlValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeCompactHtmlValue},
+		     MakeOptionExport(cov::OptionsExportType::CompactHtml));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesSummaryValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeSummaryValue},
+		     MakeOptionExport(cov::OptionsExportType::Summary));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesLcovValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeLcovValue},
+		     MakeOptionExport(cov::OptionsExportType::Lcov));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesAggregatorValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeAggregatorValue},
+		     MakeOptionExport(cov::OptionsExportType::Aggregator));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesParquetValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeParquetValue},
+		     MakeOptionExport(cov::OptionsExportType::Parquet));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, ExportTypesDiffHtmlValue)
+	{
+		TestExportTypes(
+		    {cov::ExportOptionParser::ExportTypeDiffHtmlValue},
+		     MakeOptionExport(cov::OptionsExportType::DiffHtml));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(OptionsParserExportTest, ExportTypesBoth)
 	{
@@ -164,6 +221,36 @@ namespace CppCoverageTest
 		ASSERT_FALSE(options);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, DeterministicFirstHits)
+	{
+		auto parser = CreateOptionParser();
+		const auto exportTypeOption = TestTools::GetOptionPrefix() + cov::ExportOptionParser::ExportTypeOption;
+		const auto deterministicOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::DeterministicOption;
+
+		ASSERT_TRUE(static_cast<bool>(TestTools::Parse(*parser,
+		    {deterministicOption, exportTypeOption, cov::ExportOptionParser::ExportTypeBinaryValue})));
+		ASSERT_FALSE(TestTools::Parse(*parser,
+		    {deterministicOption, exportTypeOption, cov::ExportOptionParser::ExportTypeFirstHitsValue}));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserExportTest, BinaryBaselineOutput)
+	{
+		auto parser = CreateOptionParser();
+		TestHelper::TemporaryPath baselinePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto exportTypeOption = TestTools::GetOptionPrefix() + cov::ExportOptionParser::ExportTypeOption;
+		const auto binaryBaselineOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryBaselineOption;
+		const auto binaryExport = cov::ExportOptionParser::ExportTypeBinaryValue +
+		                          cov::ExportOptionParser::ExportSeparator;
+
+		ASSERT_TRUE(static_cast<bool>(TestTools::Parse(*parser,
+		    {binaryBaselineOption, baselinePath.GetPath().string(), exportTypeOption, binaryExport + "Delta.cov"})));
+		ASSERT_FALSE(TestTools::Parse(*parser,
+		    {binaryBaselineOption, baselinePath.GetPath().string(),
+		     exportTypeOption, binaryExport + baselinePath.GetPath().string()}));
+	}
+
 	namespace
 	{
 		//-------------------------------------------------------------------------
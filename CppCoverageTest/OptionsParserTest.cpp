@@ -17,6 +17,7 @@
 #include "stdafx.h"
 
 #include <filesystem>
+#include <fstream>
 #include "CppCoverage/Options.hpp"
 #include "CppCoverage/ProgramOptions.hpp"
 
@@ -48,6 +49,48 @@ namespace CppCoverageTest
 		ASSERT_TRUE(options->IsAggregateByFileModeEnabled());
 		ASSERT_FALSE(options->IsContinueAfterCppExceptionModeEnabled());
 		ASSERT_FALSE(options->IsOptimizedBuildSupportEnabled());
+		ASSERT_FALSE(options->IsInProcessAgentModeEnabled());
+		ASSERT_FALSE(options->IsBasicBlockBreakPointsModeEnabled());
+		ASSERT_FALSE(options->IsDominatorBreakPointsModeEnabled());
+		ASSERT_FALSE(options->IsEagerLineDisarmModeEnabled());
+		ASSERT_FALSE(options->IsResultCacheModeEnabled());
+		ASSERT_FALSE(options->IsLazyBreakPointsModeEnabled());
+		ASSERT_FALSE(options->IsPageGuardBreakPointsModeEnabled());
+		ASSERT_FALSE(options->IsBaselineArmingModeEnabled());
+		ASSERT_FALSE(options->IsInputCoverageRefilterModeEnabled());
+		ASSERT_EQ(nullptr, options->GetInputCoverageDiffSettings());
+		ASSERT_FALSE(options->IsIncrementalHtmlModeEnabled());
+		ASSERT_EQ(cov::ReportCompression::None, options->GetReportCompression());
+		ASSERT_EQ(nullptr, options->GetHtmlAssetsFolder());
+		ASSERT_EQ(nullptr, options->GetHtmlShard());
+		ASSERT_EQ(0u, options->GetCoberturaPackageCountByFile());
+		ASSERT_EQ(0u, options->GetMinimumLineRatePercent());
+		ASSERT_EQ(nullptr, options->GetAggregatorName());
+		ASSERT_EQ(cov::CoverageLevel::Line, options->GetCoverageLevel());
+		ASSERT_EQ(0, options->GetSamplingTrapsPerSecond());
+		ASSERT_EQ(0, options->GetAdaptiveArmingTrapsPerSecond());
+		ASSERT_EQ(0, options->GetAutoDetachSeconds());
+		ASSERT_EQ(nullptr, options->GetChildPatterns());
+		ASSERT_EQ(0, options->GetAttachProcessId());
+		ASSERT_EQ(cov::DebugStringMode::Read, options->GetDebugStringMode());
+		ASSERT_EQ(nullptr, options->GetDebugStringsPath());
+		ASSERT_EQ(nullptr, options->GetRecordDebugEventsPath());
+		ASSERT_EQ(nullptr, options->GetReplayDebugEventsPath());
+		ASSERT_FALSE(options->IsCoverageRegionMarkersModeEnabled());
+		ASSERT_FALSE(options->IsFuzzingModeEnabled());
+		ASSERT_FALSE(options->IsIntelPtModeEnabled());
+		ASSERT_FALSE(options->IsTrampolinesModeEnabled());
+		ASSERT_FALSE(options->IsEtwSamplingModeEnabled());
+		ASSERT_EQ(nullptr, options->GetTestImpactIndexPath());
+		ASSERT_FALSE(options->IsDebugHeapModeEnabled());
+		ASSERT_FALSE(options->IsAsyncModulesModeEnabled());
+		ASSERT_FALSE(options->IsNativePdbReaderEnabled());
+		ASSERT_FALSE(options->IsOutOfProcessPluginsModeEnabled());
+		ASSERT_EQ(nullptr, options->GetExportPluginHostSectionName());
+		ASSERT_FALSE(options->IsIdenticalModulesMergeEnabled());
+		ASSERT_FALSE(options->IsBinaryCompressionEnabled());
+		ASSERT_FALSE(options->IsDeterministicModeEnabled());
+		ASSERT_FALSE(options->IsThreadPlacementEnabled());
 		ASSERT_TRUE(options->GetExcludedLineRegexes().empty());
 		ASSERT_TRUE(options->GetSubstitutePdbSourcePaths().empty());
 	}
@@ -294,4 +337,1167 @@ namespace CppCoverageTest
 		ASSERT_TRUE(ParseSubstitutePdbSourcePath(validPath, localPath));
 		ASSERT_FALSE(ParseSubstitutePdbSourcePath("C:\\Dev/Invalid", localPath));
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InProcessAgent)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption })
+			->IsInProcessAgentModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InProcessAgentWithCoverChildren)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption,
+		  TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverChildrenOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InProcessAgentWithCppExceptionOptions)
+	{
+		cov::OptionsParser parser;
+
+		for (const auto& option : { cov::ProgramOptions::ContinueAfterCppExceptionOption,
+		                            cov::ProgramOptions::StopOnAssertOption })
+		{
+			ASSERT_FALSE(TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption,
+			  TestTools::GetOptionPrefix() + option }));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BasicBlockBreakPoints)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::BasicBlockBreakPointsOption })
+			->IsBasicBlockBreakPointsModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, DominatorBreakPoints)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::DominatorBreakPointsOption })
+			->IsDominatorBreakPointsModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, EagerLineDisarm)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::EagerLineDisarmOption;
+		const auto trampolines = TestTools::GetOptionPrefix() + cov::ProgramOptions::TrampolinesOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsEagerLineDisarmModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser, { option, trampolines }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, LazyBreakPoints)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption })
+			->IsLazyBreakPointsModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, LazyBreakPointsWithInProcessAgent)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption,
+		  TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, PageGuardBreakPoints)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::PageGuardBreakPointsOption })
+			->IsPageGuardBreakPointsModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, PageGuardBreakPointsWithLazyBreakPoints)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::PageGuardBreakPointsOption,
+		  TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BaselineArming)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath temporaryPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+
+		auto options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::BaselineArmingOption,
+			  TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageValue,
+			  temporaryPath.GetPath().string() });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsBaselineArmingModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BaselineArmingWithoutInputCoverage)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::BaselineArmingOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CoverageLevel)
+	{
+		cov::OptionsParser parser;
+		const auto coverageLevel = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageLevelOption;
+
+		auto functionOptions = TestTools::Parse(parser,
+			{ coverageLevel, cov::ProgramOptions::CoverageLevelFunctionValue });
+		ASSERT_TRUE(static_cast<bool>(functionOptions));
+		ASSERT_EQ(cov::CoverageLevel::Function, functionOptions->GetCoverageLevel());
+
+		auto lineOptions = TestTools::Parse(parser,
+			{ coverageLevel, cov::ProgramOptions::CoverageLevelLineValue });
+		ASSERT_TRUE(static_cast<bool>(lineOptions));
+		ASSERT_EQ(cov::CoverageLevel::Line, lineOptions->GetCoverageLevel());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { coverageLevel, "invalid" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, SamplingTrapsPerSecond)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::SamplingTrapsPerSecondOption;
+
+		auto options = TestTools::Parse(parser, { option, "100" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(100, options->GetSamplingTrapsPerSecond());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "100", TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, AdaptiveArming)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::AdaptiveArmingOption;
+
+		auto options = TestTools::Parse(parser, { option, "1000" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(1000, options->GetAdaptiveArmingTrapsPerSecond());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "1000", TestTools::GetOptionPrefix() + cov::ProgramOptions::SamplingTrapsPerSecondOption, "10" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "1000", TestTools::GetOptionPrefix() + cov::ProgramOptions::TrampolinesOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CoverageRegionMarkers)
+	{
+		cov::OptionsParser parser;
+
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageRegionMarkersOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsCoverageRegionMarkersModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::SamplingTrapsPerSecondOption, "10" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Fuzz)
+	{
+		cov::OptionsParser parser;
+
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::FuzzOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsFuzzingModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageRegionMarkersOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::DebugStringsOption,
+			  cov::ProgramOptions::DebugStringsDropValue }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, IntelPt)
+	{
+		cov::OptionsParser parser;
+
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::IntelPtOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsIntelPtModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::AsyncModulesOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Trampolines)
+	{
+		cov::OptionsParser parser;
+
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::TrampolinesOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsTrampolinesModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::IntelPtOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::PageGuardBreakPointsOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, EtwSampling)
+	{
+		cov::OptionsParser parser;
+
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::EtwSamplingOption;
+
+		ASSERT_TRUE(TestTools::Parse(parser, { option })->IsEtwSamplingModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::TrampolinesOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ExclusiveOptions)
+	{
+		cov::OptionsParser parser;
+		const auto adaptiveArming = TestTools::GetOptionPrefix() + cov::ProgramOptions::AdaptiveArmingOption;
+		const auto asyncModules = TestTools::GetOptionPrefix() + cov::ProgramOptions::AsyncModulesOption;
+		const auto intelPt = TestTools::GetOptionPrefix() + cov::ProgramOptions::IntelPtOption;
+		const auto lazyBreakPoints = TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption;
+
+		ASSERT_FALSE(TestTools::Parse(parser, { intelPt, lazyBreakPoints }));
+		ASSERT_FALSE(TestTools::Parse(parser, { lazyBreakPoints, intelPt }));
+		ASSERT_FALSE(TestTools::Parse(parser, { adaptiveArming, "1000", asyncModules }));
+		ASSERT_FALSE(TestTools::Parse(parser, { asyncModules, adaptiveArming, "1000" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ adaptiveArming, "1000", TestTools::GetOptionPrefix() + cov::ProgramOptions::AutoDetachOption, "5" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, TestImpactIndex)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::TestImpactIndexOption;
+
+		auto options = TestTools::Parse(parser, { option, "index.txt" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"index.txt"}, *options->GetTestImpactIndexPath());
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "index.txt", TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageRegionMarkersOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, AutoDetach)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::AutoDetachOption;
+
+		auto options = TestTools::Parse(parser, { option, "5" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(5, options->GetAutoDetachSeconds());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "5", TestTools::GetOptionPrefix() + cov::ProgramOptions::LazyBreakPointsOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "5", TestTools::GetOptionPrefix() + cov::ProgramOptions::SamplingTrapsPerSecondOption, "10" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ChildPatterns)
+	{
+		cov::OptionsParser parser;
+		const auto coverChildren = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverChildrenOption;
+		const auto excludedChildren = TestTools::GetOptionPrefix() + cov::ProgramOptions::ExcludedChildrenOption;
+
+		auto options = TestTools::Parse(parser, { coverChildren, excludedChildren, "cmd.exe" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		const auto* childPatterns = options->GetChildPatterns();
+		ASSERT_NE(nullptr, childPatterns);
+		ASSERT_EQ(cov::Patterns::T_Patterns{ L"*" }, childPatterns->GetSelectedPatterns());
+		ASSERT_EQ(cov::Patterns::T_Patterns{ L"cmd.exe" }, childPatterns->GetExcludedPatterns());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { excludedChildren, "cmd.exe" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Attach)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::AttachOption;
+		const auto processId = std::to_string(GetCurrentProcessId());
+
+		auto options = TestTools::Parse(parser, { option, processId }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(GetCurrentProcessId(), options->GetAttachProcessId());
+		ASSERT_NE(nullptr, options->GetStartInfo());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "0" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { option, processId }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, DebugHeap)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::DebugHeapOption })
+			->IsDebugHeapModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, DebugStrings)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::DebugStringsOption;
+		const auto fileOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::DebugStringsFileOption;
+
+		ASSERT_EQ(cov::DebugStringMode::Drop, TestTools::Parse(parser,
+			{ option, cov::ProgramOptions::DebugStringsDropValue })->GetDebugStringMode());
+		ASSERT_EQ(cov::DebugStringMode::Count, TestTools::Parse(parser,
+			{ option, cov::ProgramOptions::DebugStringsCountValue })->GetDebugStringMode());
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "invalid" }));
+
+		auto options = TestTools::Parse(parser, { fileOption, "strings.txt" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"strings.txt"}, *options->GetDebugStringsPath());
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, cov::ProgramOptions::DebugStringsDropValue, fileOption, "strings.txt" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, DebugEvents)
+	{
+		cov::OptionsParser parser;
+		const auto recordOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::RecordDebugEventsOption;
+		const auto replayOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ReplayDebugEventsOption;
+
+		auto options = TestTools::Parse(parser, { recordOption, "events.txt" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"events.txt"}, *options->GetRecordDebugEventsPath());
+
+		options = TestTools::Parse(parser, { replayOption, "events.txt" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"events.txt"}, *options->GetReplayDebugEventsPath());
+		ASSERT_FALSE(TestTools::Parse(parser, { replayOption, "events.txt" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ replayOption, "events.txt", recordOption, "events2.txt" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ replayOption, "events.txt", TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, AsyncModules)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::AsyncModulesOption })
+			->IsAsyncModulesModeEnabled());
+		ASSERT_FALSE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::AsyncModulesOption,
+		  TestTools::GetOptionPrefix() + cov::ProgramOptions::InProcessAgentOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Programs)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath manifestPath;
+		const auto programsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ProgramsOption;
+		const auto jobsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::JobsOption;
+		const auto programToRun = TestTools::GetProgramToRun();
+		{
+			std::ofstream ofs{manifestPath.GetPath()};
+			ofs << "# Comment" << std::endl;
+			ofs << '"' << programToRun << "\" arg1 \"arg 2\"" << std::endl;
+			ofs << std::endl;
+			ofs << programToRun << std::endl;
+		}
+
+		auto options = TestTools::Parse(parser,
+			{ programsOption, manifestPath.GetPath().string(), jobsOption, "3" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetStartInfo());
+		ASSERT_EQ(3u, options->GetJobCount());
+
+		const auto& programs = options->GetPrograms();
+		ASSERT_EQ(2u, programs.size());
+		ASSERT_EQ(std::filesystem::path{programToRun}, programs[0].GetPath());
+		ASSERT_EQ((std::vector<std::wstring>{
+			Tools::LocalToWString(programToRun), L"arg1", L"arg 2"}),
+			programs[0].GetArguments());
+		ASSERT_EQ(1u, programs[1].GetArguments().size());
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ programsOption, manifestPath.GetPath().string() }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ programsOption, manifestPath.GetPath().string(), jobsOption, "0" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { jobsOption, "3" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Shards)
+	{
+		cov::OptionsParser parser;
+		const auto shardsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ShardsOption;
+
+		auto options = TestTools::Parse(parser, { shardsOption, "2" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_NE(nullptr, options->GetStartInfo());
+
+		const auto& programs = options->GetPrograms();
+		ASSERT_EQ(2u, programs.size());
+		for (size_t i = 0; i < programs.size(); ++i)
+		{
+			ASSERT_EQ(options->GetStartInfo()->GetArguments(), programs[i].GetArguments());
+			ASSERT_EQ((cov::StartInfo::EnvironmentVariables{
+				{L"GTEST_TOTAL_SHARDS", L"2"}, {L"GTEST_SHARD_INDEX", std::to_wstring(i)}}),
+				programs[i].GetEnvironmentVariables());
+		}
+		ASSERT_FALSE(TestTools::Parse(parser, { shardsOption, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { shardsOption, "2" }, false));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Service)
+	{
+		cov::OptionsParser parser;
+		const auto serviceOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ServiceOption;
+		const auto useServiceOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::UseServiceOption;
+
+		auto options = TestTools::Parse(parser, { serviceOption, "name" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("name", *options->GetServiceName());
+		ASSERT_EQ(nullptr, options->GetUsedServiceName());
+		ASSERT_FALSE(TestTools::Parse(parser, { serviceOption, "name" }));
+
+		options = TestTools::Parse(parser, { useServiceOption, "name" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("name", *options->GetUsedServiceName());
+		ASSERT_FALSE(TestTools::Parse(parser, { useServiceOption, "name" }, false));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, QueryService)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath path{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto queryServiceOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::QueryServiceOption;
+		const auto inputCoverageOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageValue;
+
+		auto options = TestTools::Parse(parser,
+			{ queryServiceOption, "name", inputCoverageOption, path.GetPath().string() }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("name", *options->GetQueryServiceName());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { queryServiceOption, "name" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ queryServiceOption, "name", inputCoverageOption, path.GetPath().string() }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, OutOfProcessPlugins)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::OutOfProcessPluginsOption });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsOutOfProcessPluginsModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ExportPluginHost)
+	{
+		cov::OptionsParser parser;
+		const auto exportPluginHostOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ExportPluginHostOption;
+
+		auto options = TestTools::Parse(parser, { exportPluginHostOption, "section" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(L"section", *options->GetExportPluginHostSectionName());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { exportPluginHostOption, "section" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, LineCounters)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath lineTablePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath countersPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto lineTableOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::LineTableOption;
+		const auto inputLineCountersOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputLineCountersOption;
+
+		auto options = TestTools::Parse(parser, { lineTableOption, "lines.txt" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"lines.txt"}, *options->GetLineTablePath());
+		ASSERT_FALSE(TestTools::Parse(parser, { lineTableOption, "lines.txt" }, false));
+
+		options = TestTools::Parse(parser, { inputLineCountersOption,
+			lineTablePath.GetPath().string() + cov::OptionsParser::PathSeparator + countersPath.GetPath().string() }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ((std::vector<cov::Options::LineCountersPaths>{{lineTablePath.GetPath(), countersPath.GetPath()}}),
+			options->GetInputLineCountersPaths());
+		ASSERT_FALSE(TestTools::Parse(parser, { inputLineCountersOption, lineTablePath.GetPath().string() }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InstrumentedImage)
+	{
+		cov::OptionsParser parser;
+		const auto lineTableOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::LineTableOption;
+		const auto instrumentedImageOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InstrumentedImageOption;
+
+		auto options = TestTools::Parse(parser, { lineTableOption, "lines.txt", instrumentedImageOption, "Instrumented.exe" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"Instrumented.exe"}, *options->GetInstrumentedImagePath());
+		ASSERT_FALSE(TestTools::Parse(parser, { instrumentedImageOption, "Instrumented.exe" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InputSancov)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath modulePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath sancovPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto inputSancovOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputSancovOption;
+
+		auto options = TestTools::Parse(parser, { inputSancovOption,
+			modulePath.GetPath().string() + cov::OptionsParser::PathSeparator + sancovPath.GetPath().string() }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ((std::vector<cov::Options::SancovPaths>{{modulePath.GetPath(), sancovPath.GetPath()}}),
+			options->GetInputSancovPaths());
+		ASSERT_FALSE(TestTools::Parse(parser, { inputSancovOption,
+			modulePath.GetPath().string() + cov::OptionsParser::PathSeparator + "missing.sancov" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, PdbCache)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetPdbCacheFolder());
+
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::PdbCacheOption, "cache" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"cache"}, *options->GetPdbCacheFolder());
+		ASSERT_EQ(nullptr, options->GetPdbCacheRemoteStore());
+
+		const auto remoteOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::PdbCacheRemoteOption;
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::PdbCacheOption, "cache", remoteOption, "http://server/cache" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(L"http://server/cache", *options->GetPdbCacheRemoteStore());
+		ASSERT_FALSE(TestTools::Parse(parser, { remoteOption, "http://server/cache" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CacheDir)
+	{
+		cov::OptionsParser parser;
+		const auto cacheDirOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CacheDirOption;
+		const auto cacheSizeOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CacheSizeOption;
+
+		auto options = TestTools::Parse(parser, { cacheDirOption, "cache" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"cache"}, *options->GetCacheFolder());
+		ASSERT_EQ(2048u * 1024 * 1024, options->GetCacheMaxSize());
+
+		options = TestTools::Parse(parser, { cacheDirOption, "cache", cacheSizeOption, "10" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(10u * 1024 * 1024, options->GetCacheMaxSize());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { cacheSizeOption, "10" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { cacheDirOption, "cache", cacheSizeOption, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ cacheDirOption, "cache", TestTools::GetOptionPrefix() + cov::ProgramOptions::PdbCacheOption, "cache" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ResultCache)
+	{
+		cov::OptionsParser parser;
+		const auto cacheDirOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CacheDirOption;
+		const auto resultCacheOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ResultCacheOption;
+		const auto inputOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ResultCacheInputOption;
+
+		auto options = TestTools::Parse(parser,
+			{ cacheDirOption, "cache", resultCacheOption, inputOption, "input1", inputOption, "input2" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsResultCacheModeEnabled());
+		std::vector<std::filesystem::path> expectedInputs{ "input1", "input2" };
+		ASSERT_EQ(expectedInputs, options->GetResultCacheInputs());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { resultCacheOption }));
+		ASSERT_FALSE(TestTools::Parse(parser, { cacheDirOption, "cache", inputOption, "input1" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, IndexPdbs)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		const auto indexPdbsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::IndexPdbsOption;
+		const auto pdbCacheOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::PdbCacheOption;
+		const auto jobsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::JobsOption;
+
+		auto options = TestTools::Parse(parser,
+			{ indexPdbsOption, folder.GetPath().string(), pdbCacheOption, "cache", jobsOption, "4" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(folder.GetPath(), *options->GetIndexedPdbsFolder());
+		ASSERT_EQ(4u, options->GetJobCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { indexPdbsOption, folder.GetPath().string() }, false));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ indexPdbsOption, folder.GetPath().string(), pdbCacheOption, "cache" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ indexPdbsOption, "missing", pdbCacheOption, "cache" }, false));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, NativePdbReader)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::NativePdbReaderOption })
+			->IsNativePdbReaderEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, MergeIdenticalModules)
+	{
+		cov::OptionsParser parser;
+
+		ASSERT_TRUE(TestTools::Parse(parser,
+		{ TestTools::GetOptionPrefix() + cov::ProgramOptions::MergeIdenticalModulesOption })
+			->IsIdenticalModulesMergeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, SymbolServer)
+	{
+		cov::OptionsParser parser;
+		const auto symbolServerOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::SymbolServerOption;
+		const auto symbolCacheOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::SymbolCacheOption;
+		const auto symbolDownloadsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::SymbolDownloadsOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->GetSymbolServers().empty());
+		ASSERT_EQ(nullptr, options->GetSymbolCacheFolder());
+
+		options = TestTools::Parse(parser,
+			{ symbolServerOption, "http://server", symbolServerOption, "\\\\share\\symbols",
+			  symbolCacheOption, "symbols", symbolDownloadsOption, "16" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ((std::vector<std::wstring>{L"http://server", L"\\\\share\\symbols"}), options->GetSymbolServers());
+		ASSERT_EQ(std::filesystem::path{"symbols"}, *options->GetSymbolCacheFolder());
+		ASSERT_EQ(16u, options->GetSymbolDownloadCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { symbolServerOption, "http://server" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { symbolCacheOption, "symbols" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ symbolServerOption, "http://server", symbolCacheOption, "symbols", symbolDownloadsOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, SourceServerCache)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetSourceServerCacheFolder());
+
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::SourceServerCacheOption, "sources" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"sources"}, *options->GetSourceServerCacheFolder());
+		ASSERT_TRUE(options->GetSourceServerCommands().empty());
+
+		auto sourceServerCommandOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::SourceServerCommandOption;
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::SourceServerCacheOption, "sources",
+			  sourceServerCommandOption, "tf.exe", sourceServerCommandOption, "git" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ((std::vector<std::wstring>{ L"tf.exe", L"git" }), options->GetSourceServerCommands());
+		ASSERT_FALSE(TestTools::Parse(parser, { sourceServerCommandOption, "tf.exe" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ModuleTimeBudget)
+	{
+		cov::OptionsParser parser;
+		const auto moduleTimeBudgetOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ModuleTimeBudgetOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(0u, options->GetModuleTimeBudgetMilliseconds());
+
+		options = TestTools::Parse(parser, { moduleTimeBudgetOption, "500" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(500u, options->GetModuleTimeBudgetMilliseconds());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { moduleTimeBudgetOption, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ moduleTimeBudgetOption, "500", TestTools::GetOptionPrefix() + cov::ProgramOptions::AsyncModulesOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, MemoryBudget)
+	{
+		cov::OptionsParser parser;
+		const auto memoryBudgetOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::MemoryBudgetOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(0u, options->GetMemoryBudgetMegabytes());
+
+		options = TestTools::Parse(parser, { memoryBudgetOption, "512" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(512u, options->GetMemoryBudgetMegabytes());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { memoryBudgetOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ExclusionMarkers)
+	{
+		cov::OptionsParser parser;
+		const auto lineMarkerOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ExcludedLineMarkerOption;
+		const auto regionMarkersOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ExcludedRegionMarkersOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->GetExclusionMarkers().IsEmpty());
+
+		options = TestTools::Parse(parser,
+			{ lineMarkerOption, "EXCL_LINE", regionMarkersOption, "EXCL_START?EXCL_STOP" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		const auto& exclusionMarkers = options->GetExclusionMarkers();
+		ASSERT_EQ("EXCL_LINE", exclusionMarkers.GetLineMarker());
+		ASSERT_EQ("EXCL_START", exclusionMarkers.GetRegionStartMarker());
+		ASSERT_EQ("EXCL_STOP", exclusionMarkers.GetRegionStopMarker());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { regionMarkersOption, "EXCL_START" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { regionMarkersOption, "EXCL_START?" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BinaryBaseline)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath baselinePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto binaryBaselineOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryBaselineOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetBinaryBaselinePath());
+
+		options = TestTools::Parse(parser, { binaryBaselineOption, baselinePath.GetPath().string() });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(baselinePath.GetPath(), *options->GetBinaryBaselinePath());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { binaryBaselineOption, "MissingFile.cov" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CoverageJournal)
+	{
+		cov::OptionsParser parser;
+		const auto journalOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageJournalOption;
+		const auto secondsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoverageJournalSecondsOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetCoverageJournalPath());
+
+		options = TestTools::Parse(parser, { journalOption, "journal.bin" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"journal.bin"}, *options->GetCoverageJournalPath());
+		ASSERT_EQ(5, options->GetCoverageJournalSeconds());
+
+		options = TestTools::Parse(parser, { journalOption, "journal.bin", secondsOption, "2" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(2, options->GetCoverageJournalSeconds());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { secondsOption, "2" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { journalOption, "journal.bin", secondsOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BinaryLineTables)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath baselinePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto lineTablesOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryLineTablesOption;
+		const auto binaryBaselineOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryBaselineOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetBinaryLineTablesFolder());
+
+		options = TestTools::Parse(parser, { lineTablesOption, "LineTables" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"LineTables"}, *options->GetBinaryLineTablesFolder());
+
+		ASSERT_FALSE(TestTools::Parse(parser, {
+			lineTablesOption, "LineTables", binaryBaselineOption, baselinePath.GetPath().string() }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, BinaryCompression)
+	{
+		cov::OptionsParser parser;
+		const auto compressionOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryCompressionOption;
+		const auto lineTablesOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::BinaryLineTablesOption;
+
+		auto options = TestTools::Parse(parser, { compressionOption });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsBinaryCompressionEnabled());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { compressionOption, lineTablesOption, "LineTables" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Deterministic)
+	{
+		cov::OptionsParser parser;
+		const auto deterministicOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::DeterministicOption;
+		const auto incrementalHtmlOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::IncrementalHtmlOption;
+
+		auto options = TestTools::Parse(parser, { deterministicOption });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsDeterministicModeEnabled());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { deterministicOption, incrementalHtmlOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, RefilterInputCoverage)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath temporaryPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto refilterOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::RefilterInputCoverageOption;
+
+		auto options = TestTools::Parse(parser,
+			{ refilterOption,
+			  TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageValue,
+			  temporaryPath.GetPath().string() });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsInputCoverageRefilterModeEnabled());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { refilterOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, InputCoverageDiff)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath inputCoveragePath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath diffPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto diffOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageDiffOption;
+		const auto inputCoverageOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageValue;
+
+		auto options = TestTools::Parse(parser,
+			{ diffOption, diffPath.GetPath().string(),
+			  inputCoverageOption, inputCoveragePath.GetPath().string() });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_NE(nullptr, options->GetInputCoverageDiffSettings());
+		ASSERT_EQ(diffPath.GetPath(), options->GetInputCoverageDiffSettings()->GetUnifiedDiffPath());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { diffOption, diffPath.GetPath().string() }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ diffOption, "MissingDiff", inputCoverageOption, inputCoveragePath.GetPath().string() }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CompareCoverage)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath firstPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		TestHelper::TemporaryPath secondPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto compareOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CompareCoverageOption;
+		const auto inputCoverageOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::InputCoverageValue;
+
+		auto options = TestTools::Parse(parser,
+			{ compareOption, "comparison.txt",
+			  inputCoverageOption, firstPath.GetPath().string(),
+			  inputCoverageOption, secondPath.GetPath().string() });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(L"comparison.txt", options->GetCompareCoverageOutputPath()->wstring());
+
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ compareOption, "comparison.txt", inputCoverageOption, firstPath.GetPath().string() }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, IncrementalHtml)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::IncrementalHtmlOption });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsIncrementalHtmlModeEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ReportCompression)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::ReportCompressionOption;
+
+		ASSERT_EQ(cov::ReportCompression::Zip, TestTools::Parse(parser,
+			{ option, cov::ProgramOptions::ReportCompressionZipValue })->GetReportCompression());
+		ASSERT_EQ(cov::ReportCompression::Gzip, TestTools::Parse(parser,
+			{ option, cov::ProgramOptions::ReportCompressionGzipValue })->GetReportCompression());
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "rar" }));
+		ASSERT_FALSE(TestTools::Parse(parser, 
+			{ option, cov::ProgramOptions::ReportCompressionZipValue, 
+			  TestTools::GetOptionPrefix() + cov::ProgramOptions::IncrementalHtmlOption }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, HtmlAssetsFolder)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::HtmlAssetsFolderOption, "Assets" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"Assets"}, *options->GetHtmlAssetsFolder());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, HtmlShard)
+	{
+		cov::OptionsParser parser;
+		const auto option = TestTools::GetOptionPrefix() + cov::ProgramOptions::HtmlShardOption;
+
+		auto options = TestTools::Parse(parser, { option, "2/3" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(2, options->GetHtmlShard()->index_);
+		ASSERT_EQ(3, options->GetHtmlShard()->count_);
+
+		options = TestTools::Parse(parser, { option, cov::ProgramOptions::HtmlShardIndexValue });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->GetHtmlShard()->IsIndex());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "0/3" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "4/3" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "1-3" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { option, "1/3x" }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "1/3", TestTools::GetOptionPrefix() + cov::ProgramOptions::IncrementalHtmlOption }));
+		ASSERT_FALSE(TestTools::Parse(parser,
+			{ option, "1/3", TestTools::GetOptionPrefix() + cov::ProgramOptions::ReportCompressionOption,
+			  cov::ProgramOptions::ReportCompressionZipValue }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, CoberturaPackagesByFile)
+	{
+		cov::OptionsParser parser;
+		const auto packagesByFileOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::CoberturaPackagesByFileOption;
+
+		auto options = TestTools::Parse(parser, { packagesByFileOption, "10" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(10u, options->GetCoberturaPackageCountByFile());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { packagesByFileOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, FailUnder)
+	{
+		cov::OptionsParser parser;
+		const auto failUnderOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::FailUnderOption;
+
+		auto options = TestTools::Parse(parser, { failUnderOption, "80" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(80u, options->GetMinimumLineRatePercent());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { failUnderOption, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { failUnderOption, "101" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, PerfStats)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetPerfStatsPath());
+
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::PerfStatsOption, "stats.json" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"stats.json"}, *options->GetPerfStatsPath());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, TraceOutput)
+	{
+		cov::OptionsParser parser;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetTraceOutputPath());
+
+		options = TestTools::Parse(parser,
+			{ TestTools::GetOptionPrefix() + cov::ProgramOptions::TraceOutputOption, "trace.json" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(std::filesystem::path{"trace.json"}, *options->GetTraceOutputPath());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Watch)
+	{
+		cov::OptionsParser parser;
+		auto watchOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::WatchOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetWatchName());
+
+		options = TestTools::Parse(parser, { watchOption, "run" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("run", *options->GetWatchName());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, LiveCounters)
+	{
+		cov::OptionsParser parser;
+		auto liveCountersOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::LiveCountersOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetLiveCountersName());
+
+		options = TestTools::Parse(parser, { liveCountersOption, "run" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("run", *options->GetLiveCountersName());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, MeasureOverhead)
+	{
+		cov::OptionsParser parser;
+		auto measureOverheadOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::MeasureOverheadOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetMeasureOverheadRunCount());
+
+		options = TestTools::Parse(parser, { measureOverheadOption, "3" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(3u, *options->GetMeasureOverheadRunCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { measureOverheadOption, "0" }));
+		ASSERT_FALSE(TestTools::Parse(parser, { measureOverheadOption, "3" }, false));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Threads)
+	{
+		cov::OptionsParser parser;
+		auto threadsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::ThreadsOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(0u, options->GetThreadCount());
+
+		options = TestTools::Parse(parser, { threadsOption, "2" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(2u, options->GetThreadCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { threadsOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, ThreadPlacement)
+	{
+		cov::OptionsParser parser;
+		auto options = TestTools::Parse(parser, {
+			TestTools::GetOptionPrefix() + cov::ProgramOptions::ThreadPlacementOption });
+
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_TRUE(options->IsThreadPlacementEnabled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, MachineSymbolLoads)
+	{
+		cov::OptionsParser parser;
+		auto machineSymbolLoadsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::MachineSymbolLoadsOption;
+
+		auto options = TestTools::Parse(parser, {});
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(nullptr, options->GetMachineSymbolLoadCount());
+
+		options = TestTools::Parse(parser, { machineSymbolLoadsOption, "2" });
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ(2u, *options->GetMachineSymbolLoadCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { machineSymbolLoadsOption, "0" }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OptionsParserTest, Aggregator)
+	{
+		cov::OptionsParser parser;
+		const auto aggregatorOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::AggregatorOption;
+		const auto aggregatorRunsOption = TestTools::GetOptionPrefix() + cov::ProgramOptions::AggregatorRunsOption;
+
+		auto options = TestTools::Parse(parser, { aggregatorOption, "name", aggregatorRunsOption, "80" }, false);
+		ASSERT_TRUE(static_cast<bool>(options));
+		ASSERT_EQ("name", *options->GetAggregatorName());
+		ASSERT_EQ(80u, options->GetAggregatorRunCount());
+
+		ASSERT_FALSE(TestTools::Parse(parser, { aggregatorOption, "name" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { aggregatorOption, "name", aggregatorRunsOption, "0" }, false));
+		ASSERT_FALSE(TestTools::Parse(parser, { aggregatorRunsOption, "80" }));
+	}
+}
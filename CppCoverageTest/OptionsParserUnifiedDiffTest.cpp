@@ -141,4 +141,22 @@ namespace CppCoverageTest
 
 		CheckUnifiedDiffSettings(unifiedDiffSettingsCollection);
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST_F(OptionsParserUnifiedDifftTest, SelectTests)
+	{
+		cov::OptionsParser parser;
+		TestHelper::TemporaryPath indexPath{ TestHelper::TemporaryPathOption::CreateAsFile };
+		const auto selectTests = TestTools::GetOptionPrefix() + cov::ProgramOptions::SelectTestsOption;
+		const auto unifiedDiff = TestTools::GetOptionPrefix() + cov::ProgramOptions::UnifiedDiffOption;
+
+		auto options = TestTools::Parse(parser,
+			{ selectTests, indexPath->string(), unifiedDiff, temporaryPath.GetPath().string() }, false);
+		ASSERT_TRUE(!!options);
+		ASSERT_EQ(indexPath.GetPath(), *options->GetSelectTestsIndexPath());
+
+		ASSERT_FALSE(!!TestTools::Parse(parser, { selectTests, indexPath->string() }, false));
+		ASSERT_FALSE(!!TestTools::Parse(parser,
+			{ selectTests, indexPath->string(), unifiedDiff, temporaryPath.GetPath().string() }, true));
+	}
+}
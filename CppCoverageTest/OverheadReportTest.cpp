@@ -0,0 +1,71 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/OverheadReport.hpp"
+#include "CppCoverage/PerformanceStatistics.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Milliseconds = std::chrono::milliseconds;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OverheadReportTest, Ratio)
+	{
+		cov::OverheadReport overheadReport;
+
+		overheadReport.AddRun(L"Native", Milliseconds{10});
+		overheadReport.AddRun(L"Native", Milliseconds{30});
+		overheadReport.AddRun(L"Native", Milliseconds{20});
+		overheadReport.AddRun(L"Coverage", Milliseconds{40});
+
+		const auto& modes = overheadReport.GetModes();
+		ASSERT_EQ(2u, modes.size());
+		ASSERT_EQ(Milliseconds{20}, cov::OverheadReport::GetMedianWallTime(modes[0]));
+		ASSERT_DOUBLE_EQ(1, overheadReport.GetRatio(modes[0]));
+		ASSERT_DOUBLE_EQ(2, overheadReport.GetRatio(modes[1]));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(OverheadReportTest, Counters)
+	{
+		cov::OverheadReport overheadReport;
+
+		for (uint64_t i = 1; i <= 2; ++i)
+		{
+			cov::PerformanceStatistics statistics;
+			statistics.AddCounter(cov::PerformanceStatistics::DebugEventsCounterPrefix + "Exception", 10 * i);
+			statistics.AddCounter(cov::PerformanceStatistics::DebugEventsCounterPrefix + "Load dll", 2 * i);
+			statistics.AddCounter(cov::PerformanceStatistics::ArmedBreakPointsCounter, 100 * i);
+			statistics.AddCounter(cov::PerformanceStatistics::HitBreakPointsCounter, 8 * i);
+			statistics.AddCounter("Other", 1);
+			overheadReport.AddRun(L"Coverage", Milliseconds{1}, &statistics);
+		}
+
+		const auto& mode = overheadReport.GetModes().at(0);
+		ASSERT_EQ(18u, cov::OverheadReport::GetDebugEventCount(mode));
+		ASSERT_EQ(150u, cov::OverheadReport::GetCounter(mode, cov::PerformanceStatistics::ArmedBreakPointsCounter));
+		ASSERT_EQ(12u, cov::OverheadReport::GetCounter(mode, cov::PerformanceStatistics::HitBreakPointsCounter));
+		ASSERT_EQ(0u, cov::OverheadReport::GetCounter(mode, "Other"));
+	}
+}
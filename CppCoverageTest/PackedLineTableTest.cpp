@@ -0,0 +1,63 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/PackedLineTable.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(PackedLineTableTest, Unpack)
+	{
+		const DWORD64 baseOfImage = 0x7FF600000000;
+		const DWORD64 newBaseOfImage = 0x10000000;
+		std::vector<cov::PackedLineTable::Line> lines{
+			{ 20, 0x1040, 3, 0x1000, 0x80 },
+			{ 10, 0x1010, 3, 0x1000, 0x80 },
+			{ 11, 0x1010, 4 }};
+		std::vector<DWORD64> addresses{ baseOfImage + 0x1040, baseOfImage + 0x1010, baseOfImage + 0x1010 };
+		cov::PackedLineTable::LineNumberByAddress lineNumberByAddress;
+		lineNumberByAddress[baseOfImage + 0x1040].push_back(20);
+		lineNumberByAddress[baseOfImage + 0x1010].push_back(10);
+		lineNumberByAddress[baseOfImage + 0x1010].push_back(11);
+
+		cov::PackedLineTable lineTable{ lines, addresses, lineNumberByAddress, baseOfImage };
+		ASSERT_EQ(lines.size(), lineTable.GetLineCount());
+
+		std::vector<cov::PackedLineTable::Line> unpackedLines;
+		std::vector<DWORD64> unpackedAddresses;
+		cov::PackedLineTable::LineNumberByAddress unpackedLineNumberByAddress;
+		lineTable.Unpack(newBaseOfImage, unpackedLines, unpackedAddresses, unpackedLineNumberByAddress);
+
+		ASSERT_EQ(lines.size(), unpackedLines.size());
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			ASSERT_EQ(lines[i].lineNumber_, unpackedLines[i].lineNumber_);
+			ASSERT_EQ(lines[i].virtualAddress_, unpackedLines[i].virtualAddress_);
+			ASSERT_EQ(lines[i].symbolIndex_, unpackedLines[i].symbolIndex_);
+			ASSERT_EQ(lines[i].functionVirtualAddress_, unpackedLines[i].functionVirtualAddress_);
+			ASSERT_EQ(lines[i].functionLength_, unpackedLines[i].functionLength_);
+		}
+		std::vector<DWORD64> expectedAddresses{ newBaseOfImage + 0x1040, newBaseOfImage + 0x1010, newBaseOfImage + 0x1010 };
+		ASSERT_EQ(expectedAddresses, unpackedAddresses);
+		ASSERT_EQ(2u, unpackedLineNumberByAddress.size());
+		ASSERT_EQ(lineNumberByAddress.at(baseOfImage + 0x1010), unpackedLineNumberByAddress.at(newBaseOfImage + 0x1010));
+		ASSERT_EQ(lineNumberByAddress.at(baseOfImage + 0x1040), unpackedLineNumberByAddress.at(newBaseOfImage + 0x1040));
+	}
+}
@@ -0,0 +1,152 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <future>
+
+#include "CppCoverage/PdbCache.hpp"
+#include "TestCoverageConsole/TestDebugInformationEnumerator.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "DebugInformationHandlerMock.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, WriteRead)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		cov::PdbCache pdbCache{folder};
+
+		ASSERT_FALSE(pdbCache.Read(L"key"));
+		Tools::SourceChecksum checksum{Tools::SourceChecksum::Type::Md5, std::string(16, 'a')};
+		pdbCache.Write(L"key", {{L"file1.cpp", {{10, 0x1010, 1, 0x1000, 0x40}, {11, 0x1020, 2}}, checksum},
+		                        {L"file2.cpp", {}}});
+
+		auto sourceFiles = pdbCache.Read(L"key");
+		ASSERT_TRUE(static_cast<bool>(sourceFiles));
+		ASSERT_EQ(2u, sourceFiles->size());
+		const auto& sourceFile = sourceFiles->at(0);
+		ASSERT_EQ(L"file1.cpp", sourceFile.path_);
+		ASSERT_EQ(2u, sourceFile.lines_.size());
+		ASSERT_EQ(10u, sourceFile.lines_[0].lineNumber_);
+		ASSERT_EQ(0x1010, sourceFile.lines_[0].virtualAddress_);
+		ASSERT_EQ(1u, sourceFile.lines_[0].symbolIndex_);
+		ASSERT_EQ(0x1000, sourceFile.lines_[0].functionVirtualAddress_);
+		ASSERT_EQ(0x40u, sourceFile.lines_[0].functionLength_);
+		ASSERT_EQ(checksum, sourceFile.checksum_);
+		ASSERT_EQ(L"file2.cpp", sourceFiles->at(1).path_);
+		ASSERT_EQ(Tools::SourceChecksum::Type::None, sourceFiles->at(1).checksum_.type_);
+		ASSERT_TRUE(sourceFiles->at(1).lines_.empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, RemoteStore)
+	{
+		TestHelper::TemporaryPath remoteStore{TestHelper::TemporaryPathOption::CreateAsFolder};
+		TestHelper::TemporaryPath folder1{TestHelper::TemporaryPathOption::CreateAsFolder};
+		TestHelper::TemporaryPath folder2{TestHelper::TemporaryPathOption::CreateAsFolder};
+		cov::PdbCache pdbCache1{folder1, remoteStore.GetPath().wstring()};
+		cov::PdbCache pdbCache2{folder2, remoteStore.GetPath().wstring()};
+
+		ASSERT_FALSE(pdbCache2.Contains(L"key"));
+		pdbCache1.Write(L"key", {{L"file.cpp", {{10, 0x1010, 1}}}});
+
+		ASSERT_TRUE(pdbCache2.Contains(L"key"));
+		auto sourceFiles = pdbCache2.Read(L"key");
+		ASSERT_TRUE(static_cast<bool>(sourceFiles));
+		ASSERT_EQ(1u, sourceFiles->size());
+		ASSERT_EQ(L"file.cpp", sourceFiles->at(0).path_);
+		ASSERT_TRUE(cov::PdbCache{folder2}.Contains(L"key"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, GetKey)
+	{
+		TestHelper::TemporaryPath path{TestHelper::TemporaryPathOption::CreateAsFile};
+		auto binary = TestCoverageConsole::GetOutputBinaryPath();
+
+		ASSERT_FALSE(cov::PdbCache::GetKey(path));
+		auto key = cov::PdbCache::GetKey(binary);
+		ASSERT_TRUE(static_cast<bool>(key));
+		ASSERT_EQ(*key, *cov::PdbCache::GetKey(binary));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, Enumerate)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		auto pdbCache = std::make_shared<cov::PdbCache>(folder);
+		auto selectedFilename = TestCoverageConsole::GetDebugInformationEnumeratorTestPath().filename();
+		auto binary = TestCoverageConsole::GetOutputBinaryPath();
+
+		DebugInformationHandlerMock handler{selectedFilename};
+		ASSERT_TRUE(cov::DebugInformationEnumerator({}, pdbCache).Enumerate(binary, handler));
+		ASSERT_FALSE(handler.lines_.empty());
+		ASSERT_TRUE(static_cast<bool>(pdbCache->Read(*cov::PdbCache::GetKey(binary))));
+
+		DebugInformationHandlerMock cachedHandler{selectedFilename};
+		ASSERT_TRUE(cov::DebugInformationEnumerator({}, pdbCache).Enumerate(binary, cachedHandler));
+		ASSERT_EQ(handler.lines_, cachedHandler.lines_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, WithoutPdb)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		cov::PdbCache pdbCache{folder};
+		auto modulePath = folder.GetPath() / L"Module.dll";
+
+		ASSERT_FALSE(pdbCache.IsWithoutPdb(L"key", modulePath));
+		pdbCache.SetWithoutPdb(L"key", modulePath);
+		ASSERT_TRUE(pdbCache.IsWithoutPdb(L"key", modulePath));
+		ASSERT_FALSE(pdbCache.Contains(L"key"));
+		ASSERT_FALSE(pdbCache.IsWithoutPdb(L"otherKey", modulePath));
+
+		// A PDB found later is read.
+		std::ofstream{folder.GetPath() / L"Module.pdb"};
+		ASSERT_FALSE(pdbCache.IsWithoutPdb(L"key", modulePath));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PdbCacheTest, LockKey)
+	{
+		TestHelper::TemporaryPath folder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		cov::PdbCache pdbCache{folder};
+		cov::PdbCache otherPdbCache{folder};
+
+		auto keyLock = pdbCache.LockKey(L"key");
+		ASSERT_NE(nullptr, keyLock);
+		ASSERT_FALSE(keyLock->HasWaited());
+
+		// The mutex is released by the thread which owns it.
+		auto hasWaited = std::async(std::launch::async, [&]() {
+			auto otherKeyLock = otherPdbCache.LockKey(L"key");
+			return otherKeyLock && otherKeyLock->HasWaited();
+		});
+		ASSERT_EQ(std::future_status::timeout, hasWaited.wait_for(std::chrono::milliseconds{100}));
+		keyLock.reset();
+		ASSERT_TRUE(hasWaited.get());
+		ASSERT_FALSE(pdbCache.LockKey(L"otherKey")->HasWaited());
+	}
+}
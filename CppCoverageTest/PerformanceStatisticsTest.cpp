@@ -0,0 +1,173 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+
+#include "CppCoverage/PerformanceStatistics.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, AddPhase)
+	{
+		cov::PerformanceStatistics statistics;
+
+		statistics.AddPhase("phase1", std::chrono::milliseconds{ 10 }, std::chrono::milliseconds{ 5 });
+		statistics.AddPhase("phase2", std::chrono::milliseconds{ 1 });
+		statistics.AddPhase("phase1", std::chrono::milliseconds{ 20 }, std::chrono::milliseconds{ 15 });
+
+		auto phases = statistics.GetPhases();
+		ASSERT_EQ(2u, phases.size());
+		ASSERT_EQ("phase1", phases[0].name_);
+		ASSERT_EQ(std::chrono::milliseconds{ 30 }, phases[0].wallTime_);
+		ASSERT_EQ(std::chrono::milliseconds{ 20 }, phases[0].cpuTime_);
+		ASSERT_TRUE(phases[0].hasCpuTime_);
+		ASSERT_EQ(2u, phases[0].count_);
+		ASSERT_EQ("phase2", phases[1].name_);
+		ASSERT_FALSE(phases[1].hasCpuTime_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, ScopedPhase)
+	{
+		cov::PerformanceStatistics statistics;
+
+		{
+			cov::PerformanceStatistics::ScopedPhase phase{ &statistics, "phase" };
+			cov::PerformanceStatistics::ScopedPhase ignoredPhase{ nullptr, "ignoredPhase" };
+		}
+		auto phases = statistics.GetPhases();
+		ASSERT_EQ(1u, phases.size());
+		ASSERT_EQ("phase", phases[0].name_);
+		ASSERT_TRUE(phases[0].hasCpuTime_);
+		ASSERT_EQ(1u, phases[0].count_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, Write)
+	{
+		cov::PerformanceStatistics statistics;
+
+		statistics.AddPhase("phase", std::chrono::milliseconds{ 10 });
+		statistics.AddCounter("counter", 2);
+		statistics.AddCounter("counter", 3);
+
+		std::wostringstream table;
+		statistics.WriteTable(table);
+		ASSERT_NE(std::wstring::npos, table.str().find(L"phase"));
+		ASSERT_NE(std::wstring::npos, table.str().find(L"5"));
+
+		std::ostringstream json;
+		statistics.WriteJson(json);
+		ASSERT_NE(std::string::npos, json.str().find("{\"name\": \"phase\", \"wallMs\": 10, \"cpuMs\": null, \"count\": 1}"));
+		ASSERT_NE(std::string::npos, json.str().find("\"counter\": 5"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, ModuleCost)
+	{
+		cov::PerformanceStatistics statistics;
+		cov::PerformanceStatistics::ModuleCost moduleCost{};
+
+		moduleCost.path_ = L"module1.dll";
+		moduleCost.registrationTime_ = std::chrono::milliseconds{ 10 };
+		moduleCost.selectedLineCount_ = 3;
+		statistics.AddModuleCost(moduleCost);
+		statistics.AddModuleCost(moduleCost);
+		moduleCost.path_ = L"module2.dll";
+		moduleCost.registrationTime_ = std::chrono::milliseconds{ 30 };
+		statistics.AddModuleCost(moduleCost);
+		statistics.AddHitBreakPointCount(L"module1.dll", 4);
+
+		auto moduleCosts = statistics.GetModuleCosts();
+		ASSERT_EQ(2u, moduleCosts.size());
+		ASSERT_EQ(L"module2.dll", moduleCosts[0].path_);
+		ASSERT_EQ(L"module1.dll", moduleCosts[1].path_);
+		ASSERT_EQ(std::chrono::milliseconds{ 20 }, moduleCosts[1].registrationTime_);
+		ASSERT_EQ(6u, moduleCosts[1].selectedLineCount_);
+		ASSERT_EQ(4u, moduleCosts[1].hitBreakPointCount_);
+		ASSERT_EQ(2u, moduleCosts[1].loadCount_);
+
+		std::ostringstream json;
+		statistics.WriteJson(json);
+		ASSERT_NE(std::string::npos, json.str().find("{\"path\": \"module2.dll\", \"registrationMs\": 30"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, MemoryUsage)
+	{
+		cov::PerformanceStatistics statistics;
+		cov::PerformanceStatistics::MemoryTracker tracker1{ &statistics, "subsystem" };
+		cov::PerformanceStatistics::MemoryTracker tracker2{ &statistics, "subsystem" };
+		cov::PerformanceStatistics::MemoryTracker ignoredTracker{ nullptr, "subsystem" };
+
+		tracker1.Update(100);
+		tracker2.Update(50);
+		tracker1.Update(20);
+		ignoredTracker.Update(1000);
+
+		auto memoryUsages = statistics.GetMemoryUsages();
+		ASSERT_EQ(1u, memoryUsages.size());
+		ASSERT_EQ("subsystem", memoryUsages[0].subsystem_);
+		ASSERT_EQ(150u, memoryUsages[0].peakBytes_);
+		ASSERT_EQ(70u, memoryUsages[0].finalBytes_);
+
+		std::ostringstream json;
+		statistics.WriteJson(json);
+		ASSERT_NE(std::string::npos, json.str().find("{\"subsystem\": \"subsystem\", \"peakBytes\": 150, \"finalBytes\": 70}"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PerformanceStatisticsTest, DebuggeeStall)
+	{
+		cov::PerformanceStatistics statistics;
+
+		statistics.AddDebuggeeStall({"load dll", L"", std::chrono::milliseconds{ 10 }, 2});
+		statistics.AddDebuggeeStall({"exception", L"", std::chrono::milliseconds{ 30 }, 5});
+		statistics.AddDebuggeeStall({"load dll", L"", std::chrono::milliseconds{ 25 }, 1});
+		statistics.AddDebuggeeStall({"load dll", L"C:\\module.dll", std::chrono::milliseconds{ 36 }, 3});
+		for (int i = 1; i <= 12; ++i)
+			statistics.AddLongestDebuggeeStall({"breakpoint", L"", std::chrono::milliseconds{ i }, 1});
+		statistics.AddBreakPointStallHistogram({1, 2});
+		statistics.AddBreakPointStallHistogram({1, 0, 4});
+
+		auto stalls = statistics.GetDebuggeeStalls();
+		ASSERT_EQ(3u, stalls.size());
+		ASSERT_EQ(L"C:\\module.dll", stalls[0].modulePath_);
+		ASSERT_EQ("load dll", stalls[1].event_);
+		ASSERT_EQ(std::chrono::milliseconds{ 35 }, stalls[1].time_);
+		ASSERT_EQ(3u, stalls[1].count_);
+		auto longestStalls = statistics.GetLongestDebuggeeStalls();
+		ASSERT_EQ(cov::PerformanceStatistics::MaxLongestStallCount, longestStalls.size());
+		ASSERT_EQ(std::chrono::milliseconds{ 12 }, longestStalls.front().time_);
+		ASSERT_EQ(std::chrono::milliseconds{ 3 }, longestStalls.back().time_);
+		ASSERT_EQ((std::vector<uint64_t>{2, 2, 4}), statistics.GetBreakPointStallHistogram());
+
+		std::wostringstream table;
+		statistics.WriteTable(table);
+		ASSERT_NE(std::wstring::npos, table.str().find(L"load dll: module.dll"));
+		ASSERT_NE(std::wstring::npos, table.str().find(L"< 4 us"));
+
+		std::ostringstream json;
+		statistics.WriteJson(json);
+		ASSERT_NE(std::string::npos, json.str().find("{\"event\": \"exception\", \"path\": \"\", \"ms\": 30, \"count\": 5}"));
+		ASSERT_NE(std::string::npos, json.str().find("\"breakpointStallHistogram\": [2, 2, 4]"));
+	}
+}
@@ -67,6 +67,24 @@ namespace CppCoverageTest
 		    });
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(Process, EnvironmentVariable)
+	{
+		cov::StartInfo startInfo{ L"cmd.exe" };
+		startInfo.AddArgument(L"/C");
+		startInfo.AddArgument(L"exit %OPENCPPCOVERAGE_TEST_EXIT_CODE%");
+		startInfo.AddEnvironmentVariable(L"OPENCPPCOVERAGE_TEST_EXIT_CODE", L"42");
+
+		cov::Process process{ startInfo };
+		ASSERT_NO_THROW(process.Start(0));
+
+		auto hProcess = process.GetProcessInformation().hProcess;
+		DWORD exitCode = 0;
+		ASSERT_EQ(WAIT_OBJECT_0, WaitForSingleObject(hProcess, INFINITE));
+		ASSERT_TRUE(GetExitCodeProcess(hProcess, &exitCode));
+		ASSERT_EQ(42, exitCode);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(Process, ProgramInPath)
 	{
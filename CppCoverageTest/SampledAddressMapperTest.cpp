@@ -0,0 +1,78 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <boost/optional/optional_io.hpp>
+
+#include "CppCoverage/SampledAddressMapper.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const auto hProcess = reinterpret_cast<HANDLE>(42);
+		const auto baseOfImage = reinterpret_cast<void*>(0x1000);
+
+		//---------------------------------------------------------------------
+		void AddModule(cov::SampledAddressMapper& mapper)
+		{
+			// The second function has no selected line.
+			mapper.AddModule(hProcess, baseOfImage, {{0x1000, 0x20}, {0x1020, 0x10}}, {0x1010, 0x1004, 0x1018});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SampledAddressMapperTest, Find)
+	{
+		cov::SampledAddressMapper mapper;
+		AddModule(mapper);
+
+		ASSERT_EQ(boost::optional<DWORD64>{0x1004}, mapper.Find(hProcess, 0x1000));
+		ASSERT_EQ(boost::optional<DWORD64>{0x1004}, mapper.Find(hProcess, 0x1004));
+		ASSERT_EQ(boost::optional<DWORD64>{0x1004}, mapper.Find(hProcess, 0x100F));
+		ASSERT_EQ(boost::optional<DWORD64>{0x1010}, mapper.Find(hProcess, 0x1010));
+		ASSERT_EQ(boost::optional<DWORD64>{0x1018}, mapper.Find(hProcess, 0x101F));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SampledAddressMapperTest, FindOutsideSelectedFunctions)
+	{
+		cov::SampledAddressMapper mapper;
+		AddModule(mapper);
+
+		ASSERT_FALSE(mapper.Find(hProcess, 0xFFF));
+		ASSERT_FALSE(mapper.Find(hProcess, 0x1020));
+		ASSERT_FALSE(mapper.Find(hProcess, 0x1030));
+		ASSERT_FALSE(mapper.Find(reinterpret_cast<HANDLE>(43), 0x1004));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SampledAddressMapperTest, Unload)
+	{
+		cov::SampledAddressMapper mapper;
+		AddModule(mapper);
+
+		mapper.OnUnloadModule(hProcess, baseOfImage);
+		ASSERT_FALSE(mapper.Find(hProcess, 0x1004));
+
+		AddModule(mapper);
+		mapper.OnExitProcess(hProcess);
+		ASSERT_FALSE(mapper.Find(hProcess, 0x1004));
+	}
+}
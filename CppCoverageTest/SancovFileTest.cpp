@@ -0,0 +1,78 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/SancovFile.hpp"
+#include "CppCoverage/ModuleLineTable.hpp"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(SancovFileTest, WriteReadOffsets)
+	{
+		TestHelper::TemporaryPath path;
+		std::vector<uint64_t> offsets{0x1010, 0x1045};
+
+		cov::SancovFile::WriteOffsets(path, offsets);
+		ASSERT_EQ(offsets, cov::SancovFile::ReadOffsets(path));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SancovFileTest, ReadOffsets32)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			std::ofstream ofs{path.GetPath(), std::ios::binary};
+			uint32_t offsets[] = {0x1010, 0x1045};
+			ofs.write(reinterpret_cast<const char*>(&cov::SancovFile::Magic32), sizeof(uint64_t));
+			ofs.write(reinterpret_cast<const char*>(offsets), sizeof(offsets));
+		}
+		ASSERT_EQ((std::vector<uint64_t>{0x1010, 0x1045}), cov::SancovFile::ReadOffsets(path));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SancovFileTest, InvalidMagic)
+	{
+		TestHelper::TemporaryPath path{TestHelper::TemporaryPathOption::CreateAsFile};
+		ASSERT_ANY_THROW(cov::SancovFile::ReadOffsets(path));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SancovFileTest, CreateCoverageData)
+	{
+		cov::ModuleLineTable lineTable{
+		    L"C:\\module.dll", {L"C:\\file.cpp"}, {{0x1010, 0, 5}, {0x1020, 0, 6}, {0x1030, 0, 7}}};
+		auto coverageData = cov::SancovFile::CreateCoverageData(lineTable, {0x1024, 0x1000, 0x1010});
+
+		const auto& file = *coverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_TRUE(file[5]->HasBeenExecuted());
+		ASSERT_TRUE(file[6]->HasBeenExecuted());
+		ASSERT_FALSE(file[7]->HasBeenExecuted());
+	}
+}
@@ -0,0 +1,86 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include "CppCoverage/SaturationDetector.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		using Clock = cov::SaturationDetector::Clock;
+
+		const auto hProcess = reinterpret_cast<HANDLE>(static_cast<intptr_t>(1));
+		const auto hProcess2 = reinterpret_cast<HANDLE>(static_cast<intptr_t>(2));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SaturationDetectorTest, InvalidPeriod)
+	{
+		ASSERT_THROW(cov::SaturationDetector(Clock::duration::zero()), cov::CppCoverageException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SaturationDetectorTest, NoBreakPoint)
+	{
+		cov::SaturationDetector detector{std::chrono::seconds{1}};
+		auto now = Clock::now();
+
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 0, now));
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 0, now + std::chrono::seconds{10}));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SaturationDetectorTest, AllBreakPointsHit)
+	{
+		cov::SaturationDetector detector{std::chrono::seconds{1}};
+		auto now = Clock::now();
+
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 2, now));
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 1, now));
+		ASSERT_TRUE(detector.IsSaturated(hProcess, 0, now));
+		ASSERT_FALSE(detector.IsSaturated(hProcess2, 0, now));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SaturationDetectorTest, FlatPeriod)
+	{
+		cov::SaturationDetector detector{std::chrono::seconds{2}};
+		auto now = Clock::now();
+
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 2, now));
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 2, now + std::chrono::seconds{1}));
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 1, now + std::chrono::seconds{2}));
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 1, now + std::chrono::seconds{3}));
+		ASSERT_TRUE(detector.IsSaturated(hProcess, 1, now + std::chrono::seconds{4}));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SaturationDetectorTest, OnExitProcess)
+	{
+		cov::SaturationDetector detector{std::chrono::seconds{1}};
+		auto now = Clock::now();
+
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 1, now));
+		detector.OnExitProcess(hProcess);
+		ASSERT_FALSE(detector.IsSaturated(hProcess, 0, now));
+	}
+}
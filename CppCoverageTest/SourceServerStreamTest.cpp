@@ -0,0 +1,112 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/SourceServerStream.hpp"
+#include "CppCoverage/SourceServerFetcher.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const std::string Stream =
+			"SRCSRV: ini ------------------------------------------------\r\n"
+			"VERSION=2\r\n"
+			"VERCTRL=Team Foundation Server\r\n"
+			"SRCSRV: variables ------------------------------------------\r\n"
+			"TFS_EXTRACT_CMD=tf.exe view /version:%var4% \"$%var3%\" /server:%fnvar%(%var2%) /output:%srcsrvtrg%\r\n"
+			"TFS_EXTRACT_TARGET=%targ%\\%var2%%fnbksl%(%var3%)\\%var4%\\%fnfile%(%var1%)\r\n"
+			"SERVER=http://server:8080/tfs\r\n"
+			"SRCSRVTRG=%tfs_extract_target%\r\n"
+			"SRCSRVCMD=%TFS_EXTRACT_CMD%\r\n"
+			"SRCSRV: source files ---------------------------------------\r\n"
+			"C:\\Build\\Src\\Main.cpp*SERVER*/Project/Src/Main.cpp*42\r\n"
+			"SRCSRV: end ------------------------------------------------\r\n";
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SourceServerStreamTest, GetExtraction)
+	{
+		cov::SourceServerStream stream{ Stream };
+
+		ASSERT_EQ(1, stream.GetSourcePaths().size());
+		ASSERT_FALSE(stream.GetExtraction(L"C:\\Build\\Src\\Other.cpp", L"C:\\Cache"));
+
+		auto extraction = stream.GetExtraction(L"c:\\build\\src\\main.cpp", L"C:\\Cache");
+		ASSERT_TRUE(static_cast<bool>(extraction));
+		ASSERT_EQ(L"C:\\Cache\\SERVER\\Project\\Src\\Main.cpp\\42\\Main.cpp", extraction->target_);
+		ASSERT_EQ(L"tf.exe view /version:42 \"$/Project/Src/Main.cpp\" /server:http://server:8080/tfs "
+			L"/output:C:\\Cache\\SERVER\\Project\\Src\\Main.cpp\\42\\Main.cpp", extraction->command_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SourceServerStreamTest, HttpTarget)
+	{
+		cov::SourceServerStream stream{
+			"SRCSRV: ini ------------------------------------------------\n"
+			"VERSION=2\n"
+			"SRCSRV: variables ------------------------------------------\n"
+			"SRCSRVTRG=https://server/%var2%/%var3%?format=raw\n"
+			"SRCSRV: source files ---------------------------------------\n"
+			"C:\\Build\\Main.cpp*abc123*Src/Main.cpp\n"
+			"SRCSRV: end ------------------------------------------------\n" };
+		auto extraction = stream.GetExtraction(L"C:\\Build\\Main.cpp", L"C:\\Cache");
+
+		ASSERT_TRUE(static_cast<bool>(extraction));
+		ASSERT_EQ(L"https://server/abc123/Src/Main.cpp?format=raw", extraction->target_);
+		ASSERT_TRUE(extraction->command_.empty());
+
+		cov::SourceServerFetcher fetcher{ L"C:\\Cache", {} };
+		auto localPath = fetcher.GetLocalPath(*extraction);
+		ASSERT_EQ(L"C:\\Cache", localPath.parent_path().parent_path().wstring());
+		ASSERT_EQ(L"Main.cpp", localPath.filename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SourceServerStreamTest, IsAllowedCommand)
+	{
+		cov::SourceServerFetcher noCommandFetcher{ L"C:\\Cache", {} };
+		ASSERT_FALSE(noCommandFetcher.IsAllowedCommand(L"tf.exe view /output:Main.cpp"));
+
+		cov::SourceServerFetcher fetcher{ L"C:\\Cache", { L"TF", L"C:\\Program Files\\Git\\git.exe" } };
+		ASSERT_TRUE(fetcher.IsAllowedCommand(L"tf.exe view /output:Main.cpp"));
+		ASSERT_TRUE(fetcher.IsAllowedCommand(L"\"C:\\Program Files\\Git\\git.exe\" show 42:Main.cpp"));
+		ASSERT_FALSE(fetcher.IsAllowedCommand(L"git show 42:Main.cpp"));
+		ASSERT_FALSE(fetcher.IsAllowedCommand(L"C:\\Temp\\tf.exe view /output:Main.cpp"));
+		ASSERT_FALSE(fetcher.IsAllowedCommand(L"cmd.exe /c tf.exe view"));
+		ASSERT_FALSE(fetcher.IsAllowedCommand(L"\"C:\\tf.exe.bat\" view"));
+		ASSERT_FALSE(fetcher.IsAllowedCommand(L""));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SourceServerStreamTest, InvalidStream)
+	{
+		ASSERT_THROW(cov::SourceServerStream{ "VERSION=2\n" }, cov::CppCoverageException);
+		ASSERT_THROW(cov::SourceServerStream{ "SRCSRV: ini ----\nVERSION=2\n" }, cov::CppCoverageException);
+
+		cov::SourceServerStream recursiveStream{
+			"SRCSRV: variables ----\n"
+			"SRCSRVTRG=%srcsrvtrg%\n"
+			"SRCSRV: source files ----\n"
+			"C:\\Main.cpp\n"
+			"SRCSRV: end ----\n" };
+		ASSERT_THROW(recursiveStream.GetExtraction(L"C:\\Main.cpp", L"C:\\Cache"), cov::CppCoverageException);
+	}
+}
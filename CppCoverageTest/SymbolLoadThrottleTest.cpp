@@ -0,0 +1,46 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <chrono>
+#include <future>
+
+#include "CppCoverage/SymbolLoadThrottle.hpp"
+#include "Tools/ScopedAction.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(SymbolLoadThrottleTest, Wait)
+	{
+		cov::SymbolLoadThrottle::SetMachineConcurrency(1);
+		Tools::ScopedAction disableThrottle{[]() { cov::SymbolLoadThrottle::SetMachineConcurrency(0); }};
+		auto waitCount = cov::SymbolLoadThrottle::GetWaitCount();
+		std::future<void> secondLoad;
+
+		{
+			cov::SymbolLoadThrottle::Scope scope;
+			secondLoad = std::async(std::launch::async, []() { cov::SymbolLoadThrottle::Scope scope; });
+			ASSERT_EQ(std::future_status::timeout, secondLoad.wait_for(std::chrono::milliseconds{100}));
+		}
+		secondLoad.get();
+		ASSERT_EQ(waitCount + 1, cov::SymbolLoadThrottle::GetWaitCount());
+		ASSERT_LT(std::chrono::nanoseconds{0}, cov::SymbolLoadThrottle::GetWaitTime());
+	}
+}
@@ -0,0 +1,56 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/SymbolPrefetcher.hpp"
+#include "CppCoverage/PdbReference.hpp"
+#include "TestCoverageConsole/TestCoverageConsole.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(SymbolPrefetcherTest, GetRelativePath)
+	{
+		cov::PdbReference pdbReference{
+		    {0x01234567, 0x89AB, 0xCDEF, {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF}},
+		    10,
+		    0,
+		    L"C:\\Build\\Module.pdb"};
+
+		ASSERT_EQ(std::filesystem::path{L"Module.pdb"} / L"0123456789ABCDEF0123456789ABCDEFA" / L"Module.pdb",
+		          cov::SymbolPrefetcher::GetRelativePath(pdbReference));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SymbolPrefetcherTest, LocalPdb)
+	{
+		TestHelper::TemporaryPath symbolServer{TestHelper::TemporaryPathOption::CreateAsFolder};
+		TestHelper::TemporaryPath cacheFolder{TestHelper::TemporaryPathOption::CreateAsFolder};
+		TestHelper::TemporaryPath file{TestHelper::TemporaryPathOption::CreateAsFile};
+		cov::SymbolPrefetcher symbolPrefetcher{{symbolServer.GetPath().wstring()}, cacheFolder, 2};
+		auto modulePath = TestCoverageConsole::GetOutputBinaryPath();
+
+		symbolPrefetcher.Prefetch({modulePath, file});
+		ASSERT_FALSE(symbolPrefetcher.GetPdbFolder(modulePath));
+		ASSERT_FALSE(symbolPrefetcher.GetPdbFolder(file));
+		ASSERT_TRUE(std::filesystem::is_empty(cacheFolder.GetPath()));
+	}
+}
@@ -0,0 +1,120 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "CppCoverage/TestImpactIndex.hpp"
+#include "CppCoverage/TestImpactIndexReader.hpp"
+#include "CppCoverage/CppCoverageException.hpp"
+
+#include "FileFilter/File.hpp"
+#include "FileFilter/UnifiedDiffCoverageFilter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::vector<std::wstring> SelectTests(
+			const cov::TestImpactIndexReader& reader,
+			const std::filesystem::path& diffPath,
+			const std::vector<int>& changedLines)
+		{
+			std::vector<FileFilter::File> files;
+			files.emplace_back(diffPath);
+			files.back().AddSelectedLines(changedLines);
+
+			FileFilter::UnifiedDiffCoverageFilter filter{std::move(files), boost::none};
+			return reader.SelectTests(filter);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TestImpactIndexTest, ParseTestEndMarker)
+	{
+		const auto& marker = cov::TestImpactIndex::TestEndMarker;
+
+		ASSERT_EQ(std::wstring{L"Suite.Test"},
+		          cov::TestImpactIndex::ParseTestEndMarker(marker + L"Suite.Test\n").get());
+		ASSERT_EQ(boost::none, cov::TestImpactIndex::ParseTestEndMarker(marker));
+		ASSERT_EQ(boost::none, cov::TestImpactIndex::ParseTestEndMarker(marker + L"\r\n"));
+		ASSERT_EQ(boost::none, cov::TestImpactIndex::ParseTestEndMarker(L"Suite.Test"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TestImpactIndexTest, AddTest)
+	{
+		cov::TestImpactIndex index;
+
+		index.AddTest(L"Test1", {{L"File1", {1, 2}}, {L"File2", {3}}});
+		index.AddTest(L"Test2", {{L"File2", {4}}});
+		index.AddTest(L"Test1", {{L"File1", {5}}, {L"File3", {}}});
+
+		ASSERT_EQ(2, index.GetTestCount());
+		ASSERT_EQ(2, index.GetFileCount());
+		cov::TestImpactIndex::LinesByFile expectedLines{
+		    {L"File1", {1, 2, 5}}, {L"File2", {3}}};
+		ASSERT_EQ(expectedLines, index.GetLines(L"Test1"));
+		ASSERT_TRUE(index.GetLines(L"Unknown").empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TestImpactIndexTest, SelectTests)
+	{
+		cov::TestImpactIndex index;
+		TestHelper::TemporaryPath indexPath;
+
+		index.AddTest(L"Test2", {{L"C:\\Dev\\File1.cpp", {1, 2, 3}}});
+		index.AddTest(L"Test1", {{L"C:\\Dev\\File1.cpp", {3}}, {L"C:\\Dev\\File2.cpp", {10}}});
+		index.AddTest(L"Test3", {{L"C:\\Dev\\File2.cpp", {11}}});
+		index.Write(indexPath);
+
+		cov::TestImpactIndexReader reader{indexPath};
+		ASSERT_EQ(3, reader.GetTestCount());
+		ASSERT_EQ(2, reader.GetFileCount());
+		ASSERT_EQ(L"Test1", reader.GetTestName(0));
+		ASSERT_EQ(std::filesystem::path{L"C:\\Dev\\File2.cpp"}, reader.GetFilePath(1));
+
+		ASSERT_EQ((std::vector<std::wstring>{L"Test1", L"Test2"}),
+		          SelectTests(reader, L"File1.cpp", {3, 4}));
+		ASSERT_EQ((std::vector<std::wstring>{L"Test2"}),
+		          SelectTests(reader, L"File1.cpp", {1}));
+		ASSERT_EQ((std::vector<std::wstring>{L"Test3"}),
+		          SelectTests(reader, L"File2.cpp", {11}));
+		ASSERT_TRUE(SelectTests(reader, L"File2.cpp", {12}).empty());
+		ASSERT_TRUE(SelectTests(reader, L"File3.cpp", {1}).empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TestImpactIndexTest, InvalidIndex)
+	{
+		TestHelper::TemporaryPath indexPath;
+
+		ASSERT_THROW(cov::TestImpactIndexReader{indexPath}, cov::CppCoverageException);
+		{
+			std::ofstream ofs{indexPath.GetPath(), std::ios::binary};
+			ofs << "Not an index file but long enough for the header.";
+		}
+		ASSERT_THROW(cov::TestImpactIndexReader{indexPath}, cov::CppCoverageException);
+	}
+}
@@ -148,6 +148,15 @@ namespace CppCoverageTest
 			settings.SetCoverChildren(args.coverChildren_);
 			settings.SetContinueAfterCppException(args.continueAfterCppException_);
 			settings.SetOptimizedBuildSupport(args.optimizedBuildSupport_);
+			settings.SetInProcessAgent(args.inProcessAgent_);
+			settings.SetBasicBlockBreakPoints(args.basicBlockBreakPoints_);
+			settings.SetDominatorBreakPoints(args.dominatorBreakPoints_);
+			settings.SetLazyBreakPoints(args.lazyBreakPoints_);
+			settings.SetPageGuardBreakPoints(args.pageGuardBreakPoints_);
+			settings.SetCoverageLevel(args.coverageLevel_);
+			settings.SetSamplingTrapsPerSecond(args.samplingTrapsPerSecond_);
+			settings.SetAdaptiveArmingTrapsPerSecond(args.adaptiveArmingTrapsPerSecond_);
+			settings.SetCoverageObserver(args.coverageObserver_);
 
 			auto coverageData = codeCoverageRunner.RunCoverage(settings);
 
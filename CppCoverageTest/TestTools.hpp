@@ -21,6 +21,7 @@
 #include <string>
 #include <functional>
 #include <filesystem>
+#include <memory>
 
 #include "CppCoverage/OptionsParser.hpp"
 #include "CppCoverage/Options.hpp"
@@ -31,6 +32,11 @@ namespace Plugin
 	class CoverageData;
 }
 
+namespace CppCoverage
+{
+	class ICoverageObserver;
+}
+
 namespace CppCoverageTest
 {
 	namespace TestTools
@@ -64,6 +70,15 @@ namespace CppCoverageTest
 			bool coverChildren_ = true;
 			bool continueAfterCppException_ = false;
 			bool optimizedBuildSupport_ = false;
+			bool inProcessAgent_ = false;
+			bool basicBlockBreakPoints_ = false;
+			bool dominatorBreakPoints_ = false;
+			bool lazyBreakPoints_ = false;
+			bool pageGuardBreakPoints_ = false;
+			CppCoverage::CoverageLevel coverageLevel_ = CppCoverage::CoverageLevel::Line;
+			size_t samplingTrapsPerSecond_ = 0;
+			size_t adaptiveArmingTrapsPerSecond_ = 0;
+			std::shared_ptr<CppCoverage::ICoverageObserver> coverageObserver_;
 			std::vector<std::wstring> excludedLineRegexes_;
 			std::vector<CppCoverage::SubstitutePdbSourcePath> substitutePdbSourcePath_;
 		};
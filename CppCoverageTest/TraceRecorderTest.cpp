@@ -0,0 +1,79 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+#include <thread>
+
+#include "CppCoverage/TraceRecorder.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	//-------------------------------------------------------------------------
+	TEST(TraceRecorderTest, ScopedSpan)
+	{
+		cov::TraceRecorder traceRecorder;
+
+		{
+			cov::TraceRecorder::ScopedSpan span{ &traceRecorder, "span", "category", L"detail" };
+			cov::TraceRecorder::ScopedSpan ignoredSpan{ nullptr, "ignoredSpan", "category" };
+		}
+		auto spans = traceRecorder.GetSpans();
+		ASSERT_EQ(1u, spans.size());
+		ASSERT_EQ("span", spans[0].name_);
+		ASSERT_EQ("category", spans[0].category_);
+		ASSERT_EQ("detail", spans[0].detail_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TraceRecorderTest, Threads)
+	{
+		cov::TraceRecorder traceRecorder;
+		auto now = cov::TraceRecorder::Clock::now();
+
+		traceRecorder.AddSpan("span1", "category", "", now, std::chrono::milliseconds{ 1 });
+		std::thread{ [&]() {
+			traceRecorder.AddSpan("span2", "category", "", now, std::chrono::milliseconds{ 1 });
+		} }.join();
+
+		auto spans = traceRecorder.GetSpans();
+		ASSERT_EQ(2u, spans.size());
+		ASSERT_NE(spans[0].threadId_, spans[1].threadId_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TraceRecorderTest, Write)
+	{
+		cov::TraceRecorder traceRecorder;
+
+		traceRecorder.SetThreadName("thread");
+		traceRecorder.SetThreadName("ignoredName");
+		traceRecorder.AddSpan("span", "category", "C:\\module.dll",
+		                      cov::TraceRecorder::Clock::now(), std::chrono::milliseconds{ 2 });
+
+		std::ostringstream ostr;
+		traceRecorder.Write(ostr);
+		auto trace = ostr.str();
+		ASSERT_NE(std::string::npos, trace.find("\"args\": {\"name\": \"thread\"}"));
+		ASSERT_EQ(std::string::npos, trace.find("ignoredName"));
+		ASSERT_NE(std::string::npos, trace.find("{\"name\": \"span\", \"cat\": \"category\", \"ph\": \"X\""));
+		ASSERT_NE(std::string::npos, trace.find("\"dur\": 2000.000"));
+		ASSERT_NE(std::string::npos, trace.find("\"args\": {\"detail\": \"C:\\\\module.dll\"}"));
+	}
+}
@@ -0,0 +1,211 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <boost/optional/optional_io.hpp>
+
+#include "CppCoverage/BasicBlockAnalyzer.hpp"
+#include "CppCoverage/TrampolineBuilder.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		const uint64_t Address = 0x1000;
+		const uint64_t TrampolineAddress = 0x2000;
+		const uint64_t CounterAddress = 0x3000;
+
+		// 0x1000 push rbp
+		// 0x1001 mov rbp, rsp
+		// 0x1004 test eax, eax
+		// 0x1006 je 0x100A
+		// 0x1008 inc eax
+		// 0x100A inc eax
+		// 0x100C ret
+		const std::vector<unsigned char> Code{
+			0x55, 0x48, 0x89, 0xE5, 0x85, 0xC0, 0x74, 0x02, 0xFF, 0xC0, 0xFF, 0xC0, 0xC3 };
+
+		//---------------------------------------------------------------------
+		boost::optional<size_t> GetDisplacedSize(
+			const std::vector<unsigned char>& code,
+			uint64_t address,
+			bool is64Bits = true)
+		{
+			cov::BasicBlockAnalyzer analyzer{ code, Address, is64Bits };
+			cov::TrampolineBuilder builder{ is64Bits };
+			auto offset = static_cast<size_t>(address - Address);
+
+			return builder.GetDisplacedSize(&code[offset], code.size() - offset, address, analyzer);
+		}
+
+		//---------------------------------------------------------------------
+		boost::optional<size_t> GetDisplacedSizeInImage(
+			const std::vector<unsigned char>& code,
+			uint64_t address,
+			bool canFault)
+		{
+			cov::BasicBlockAnalyzer analyzer{ code, Address, true };
+			cov::TrampolineBuilder builder{ true };
+			auto offset = static_cast<size_t>(address - Address);
+
+			return builder.GetDisplacedSizeInImage(
+				&code[offset], code.size() - offset, address, analyzer, canFault);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, DisplacedSize)
+	{
+		ASSERT_EQ(boost::optional<size_t>{ 6 }, GetDisplacedSize(Code, 0x1000));
+		// The jump is followed by another basic block.
+		ASSERT_FALSE(GetDisplacedSize(Code, 0x1004));
+		// 0x100A is a jump target.
+		ASSERT_FALSE(GetDisplacedSize(Code, 0x1008));
+		ASSERT_FALSE(GetDisplacedSize(Code, 0x1002));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, DisplacedSizeInImage)
+	{
+		// 0x1008 is not a jump target.
+		ASSERT_EQ(boost::optional<size_t>{ 6 }, GetDisplacedSizeInImage(Code, 0x1004, false));
+		ASSERT_FALSE(GetDisplacedSizeInImage(Code, 0x1008, false));
+		// nop, ret: an exception handler can follow the return.
+		ASSERT_FALSE(GetDisplacedSizeInImage({ 0x90, 0xC3, 0x90, 0x90, 0x90, 0x90, 0xC3 }, Address, true));
+
+		// mov rax, [rcx]
+		// mov rbx, rax
+		std::vector<uint8_t> memoryRead{ 0x48, 0x8B, 0x01, 0x48, 0x89, 0xC3, 0xC3 };
+		ASSERT_FALSE(GetDisplacedSizeInImage(memoryRead, Address, false));
+		ASSERT_EQ(boost::optional<size_t>{ 6 }, GetDisplacedSizeInImage(memoryRead, Address, true));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, NotRelocatable)
+	{
+		// mov rax, [rip]
+		ASSERT_FALSE(GetDisplacedSize({ 0x48, 0x8B, 0x05, 0, 0, 0, 0, 0xC3 }, Address));
+		// call 0x1005
+		ASSERT_FALSE(GetDisplacedSize({ 0xE8, 0, 0, 0, 0, 0xC3 }, Address));
+		// jmp rax
+		ASSERT_FALSE(GetDisplacedSize({ 0x48, 0x83, 0xEC, 0x20, 0xFF, 0xE0 }, Address));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, MayFault)
+	{
+		// mov rax, [rcx]
+		// mov rbx, rax
+		std::vector<uint8_t> memoryRead{ 0x48, 0x8B, 0x01, 0x48, 0x89, 0xC3, 0xC3 };
+		ASSERT_FALSE(GetDisplacedSize(memoryRead, Address));
+		ASSERT_EQ(boost::optional<size_t>{ 6 }, GetDisplacedSize(memoryRead, Address, false));
+
+		// div rcx
+		// mov rbx, rax
+		ASSERT_FALSE(GetDisplacedSize({ 0x48, 0xF7, 0xF1, 0x48, 0x89, 0xC3, 0xC3 }, Address));
+
+		// lea rax, [rcx + 8]
+		// mov rbx, rax
+		ASSERT_EQ(boost::optional<size_t>{ 7 },
+		          GetDisplacedSize({ 0x48, 0x8D, 0x41, 0x08, 0x48, 0x89, 0xC3, 0xC3 }, Address));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, Counters)
+	{
+		cov::TrampolineBuilder builder{ true };
+		auto trampoline = builder.Build(
+			Code.data(), 6, Address, TrampolineAddress,
+			{ { 0x1000, CounterAddress }, { 0x1004, CounterAddress + 8 } });
+
+		std::vector<uint8_t> expectedTrampoline{
+			0x9C, 0xF0, 0x48, 0xFF, 0x05, 0xF7, 0x0F, 0, 0, 0x9D, // lock inc [0x3000]
+			0x55, 0x48, 0x89, 0xE5,
+			0x9C, 0xF0, 0x48, 0xFF, 0x05, 0xF1, 0x0F, 0, 0, 0x9D, // lock inc [0x3008]
+			0x85, 0xC0,
+			0xE9, 0xE7, 0xEF, 0xFF, 0xFF }; // jmp 0x1006
+		ASSERT_TRUE(trampoline);
+		ASSERT_EQ(expectedTrampoline, *trampoline);
+		ASSERT_GE(builder.GetMaxTrampolineSize(6, 2), trampoline->size());
+		ASSERT_EQ(8, builder.GetCounterSize());
+
+		// A counter in the middle of an instruction.
+		ASSERT_FALSE(builder.Build(Code.data(), 6, Address, TrampolineAddress, { { 0x1002, CounterAddress } }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, ConditionalJump)
+	{
+		// sub rsp, 20h
+		// je 0x1016
+		std::vector<uint8_t> code{ 0x48, 0x83, 0xEC, 0x20, 0x74, 0x10, 0xC3 };
+		ASSERT_EQ(boost::optional<size_t>{ 6 }, GetDisplacedSize(code, Address));
+
+		cov::TrampolineBuilder builder{ true };
+		auto trampoline = builder.Build(
+			code.data(), 6, Address, TrampolineAddress, { { Address, CounterAddress } });
+
+		std::vector<uint8_t> expectedTrampoline{
+			0x9C, 0xF0, 0x48, 0xFF, 0x05, 0xF7, 0x0F, 0, 0, 0x9D,
+			0x48, 0x83, 0xEC, 0x20,
+			0x0F, 0x84, 0x02, 0xF0, 0xFF, 0xFF, // je 0x1016
+			0xE9, 0xED, 0xEF, 0xFF, 0xFF }; // jmp 0x1006
+		ASSERT_TRUE(trampoline);
+		ASSERT_EQ(expectedTrampoline, *trampoline);
+		ASSERT_GE(builder.GetMaxTrampolineSize(6, 1), trampoline->size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, Trampoline32Bits)
+	{
+		// push ebp
+		// mov ebp, esp
+		// test eax, eax
+		std::vector<uint8_t> code{ 0x55, 0x89, 0xE5, 0x85, 0xC0, 0xC3 };
+		ASSERT_EQ(boost::optional<size_t>{ 5 }, GetDisplacedSize(code, Address, false));
+
+		cov::TrampolineBuilder builder{ false };
+		cov::TrampolineBuilder::Layout layout;
+		auto trampoline = builder.Build(
+			code.data(), 5, Address, TrampolineAddress, { { Address, CounterAddress } }, &layout);
+
+		std::vector<uint8_t> expectedTrampoline{
+			0x9C, 0xF0, 0xFF, 0x05, 0x00, 0x30, 0, 0, 0x9D, // lock inc dword ptr [0x3000]
+			0x55, 0x89, 0xE5, 0x85, 0xC0,
+			0xE9, 0xF2, 0xEF, 0xFF, 0xFF }; // jmp 0x1005
+		ASSERT_TRUE(trampoline);
+		ASSERT_EQ(expectedTrampoline, *trampoline);
+		ASSERT_EQ(4, builder.GetCounterSize());
+		ASSERT_EQ((std::vector<size_t>{ 4 }), layout.counterAddressOffsets_);
+		ASSERT_EQ((std::vector<std::pair<size_t, size_t>>{ { 0, 9 }, { 1, 10 }, { 3, 12 } }),
+		          layout.copiedInstructionOffsets_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(TrampolineBuilderTest, Jump)
+	{
+		cov::TrampolineBuilder builder{ true };
+
+		std::vector<uint8_t> expectedJump{ 0xE9, 0xFB, 0x0F, 0, 0 };
+		auto jump = builder.BuildJump(Address, TrampolineAddress);
+		ASSERT_TRUE(jump);
+		ASSERT_EQ(expectedJump, *jump);
+		ASSERT_FALSE(builder.BuildJump(Address, 0x100000000 + TrampolineAddress));
+	}
+}
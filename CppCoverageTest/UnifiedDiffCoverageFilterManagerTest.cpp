@@ -142,4 +142,19 @@ namespace CppCoverageTest
 		ASSERT_FALSE(IsLineSelected(4, {}));
 		ASSERT_TRUE(IsLineSelected(4, { 3 }));
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST(UnifiedDiffCoverageFilterManagerTest, GetSelectedLines)
+	{
+		const fs::path filename = L"diff";
+		auto filters = CreateFilter({ filename }, { 3, 5 });
+		auto filters2 = CreateFilter({ filename }, { 5, 10 });
+		filters.push_back(std::move(filters2.at(0)));
+		auto filterManager = CreateFilterManager(std::move(filters));
+
+		ASSERT_EQ((std::set<int>{ 3, 5, 10 }), *filterManager->GetSelectedLines(filename.wstring()));
+		ASSERT_TRUE(filterManager->GetSelectedLines(L"Unknow")->empty());
+		ASSERT_FALSE(cov::UnifiedDiffCoverageFilterManager{ UnifiedDiffCoverageFilters{} }
+			.GetSelectedLines(filename.wstring()));
+	}
+}
@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "CppCoverage/Wildcards.hpp"
+#include "CppCoverage/WildcardsMatcher.hpp"
+
+namespace cov = CppCoverage;
+
+namespace CppCoverageTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		bool Match(const std::wstring& pattern, const std::wstring& str)
+		{
+			return cov::WildcardsMatcher{{pattern}, false}.Match(str) != nullptr;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, SameAsWildcards)
+	{
+		const std::vector<std::pair<std::wstring, std::wstring>> patternAndStrings = {
+			{L"abc", L"abc"}, {L"a", L"abc"}, {L"ac", L"bac"}, {L"ab", L"aa"},
+			{L"a*b", L"aab"}, {L"b**", L"ba"}, {L"**b**", L"ab"}, {L"b*a", L"ab"},
+			{L"*", L"aa"}, {L"aba*ba", L"ababa"}, {L"abab*ba", L"ababa"},
+			{L"C:\\Dev*.cpp", L"c:\\dev\\main.cpp"}, {L"(a+b)", L"x(A+B)"}};
+
+		for (const auto& patternAndString : patternAndStrings)
+		{
+			const auto& pattern = patternAndString.first;
+			const auto& str = patternAndString.second;
+
+			ASSERT_EQ(cov::Wildcards{pattern}.Match(str), Match(pattern, str))
+				<< pattern << L" " << str;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, FirstMatchingPattern)
+	{
+		cov::WildcardsMatcher matcher{{L"zzz", L"she*rs", L"hers"}, false};
+
+		auto pattern = matcher.Match(L"USHERS");
+		ASSERT_NE(nullptr, pattern);
+		ASSERT_EQ(L"she*rs", *pattern);
+
+		pattern = matcher.Match(L"hers");
+		ASSERT_NE(nullptr, pattern);
+		ASSERT_EQ(L"hers", *pattern);
+
+		ASSERT_EQ(nullptr, matcher.Match(L"he"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, CaseSensitive)
+	{
+		cov::WildcardsMatcher matcher{{L"Abc"}, true};
+
+		ASSERT_NE(nullptr, matcher.Match(L"xAbc"));
+		ASSERT_EQ(nullptr, matcher.Match(L"xabc"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(WildcardsMatcherTest, NoPatterns)
+	{
+		ASSERT_EQ(nullptr, cov::WildcardsMatcher({}, false).Match(L"abc"));
+	}
+}
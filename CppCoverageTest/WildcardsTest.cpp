@@ -54,6 +54,14 @@ namespace CppCoverageTest
 		ASSERT_TRUE(cov::Wildcards(L"*b*").Match(L"bbb"));
 	}
 	
+	//-------------------------------------------------------------------------
+	TEST(WildcardsTest, CaseSensitivity)
+	{
+		ASSERT_TRUE(cov::Wildcards(L"A*c").Match(L"xaBCx"));
+		ASSERT_TRUE(cov::Wildcards(L"A*c", true).Match(L"xABcx"));
+		ASSERT_FALSE(cov::Wildcards(L"A*c", true).Match(L"xaBcx"));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(WildcardsTest, SpecialCharMatch)
 	{		
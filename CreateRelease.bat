@@ -6,6 +6,8 @@ xcopy /y Release\OpenCppCoverage.exe NewRelease\x86\Binaries
 xcopy /y Release\Exporter.dll NewRelease\x86\Binaries
 xcopy /y Release\CppCoverage.dll NewRelease\x86\Binaries
 xcopy /y Release\Tools.dll NewRelease\x86\Binaries
+xcopy /y Release\CoverageAgent.dll NewRelease\x86\Binaries
+xcopy /y Release\CoverageRuntime.dll NewRelease\x86\Binaries
 xcopy /y Release\libctemplate.dll NewRelease\x86\Binaries
 xcopy /y Release\template_test_util_test.dll NewRelease\x86\Binaries
 xcopy /y Release\boost_filesystem-vc120-mt-1_55.dll NewRelease\x86\Binaries
@@ -31,6 +33,8 @@ xcopy /y x64\Release\OpenCppCoverage.exe NewRelease\x64\Binaries
 xcopy /y x64\Release\Exporter.dll NewRelease\x64\Binaries
 xcopy /y x64\Release\CppCoverage.dll NewRelease\x64\Binaries
 xcopy /y x64\Release\Tools.dll NewRelease\x64\Binaries
+xcopy /y x64\Release\CoverageAgent.dll NewRelease\x64\Binaries
+xcopy /y x64\Release\CoverageRuntime.dll NewRelease\x64\Binaries
 xcopy /y x64\Release\libctemplate.dll NewRelease\x64\Binaries
 xcopy /y x64\Release\template_test_util_test.dll NewRelease\x64\Binaries
 xcopy /y x64\Release\boost_filesystem-vc120-mt-1_55.dll NewRelease\x64\Binaries
@@ -0,0 +1,127 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "AggregatorExporter.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <Windows.h>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "CoverageDataSerializer.hpp"
+#include "CoverageDataDeserializer.hpp"
+#include "../ExporterException.hpp"
+#include "../ReportWriter.hpp"
+
+#include "Tools/ScopedAction.hpp"
+#include "Tools/Tool.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		// Remote named pipes do not accept bigger writes.
+		const size_t MaxWriteSize = 60 * 1024;
+
+		//---------------------------------------------------------------------
+		HANDLE ConnectToAggregator(const std::filesystem::path& pipePath)
+		{
+			for (;;)
+			{
+				auto hPipe = CreateFileW(pipePath.c_str(), GENERIC_READ | GENERIC_WRITE,
+				                         0, nullptr, OPEN_EXISTING, 0, nullptr);
+
+				if (hPipe != INVALID_HANDLE_VALUE)
+					return hPipe;
+
+				// The aggregator receives one coverage at a time.
+				auto lastError = GetLastError();
+				if (lastError != ERROR_PIPE_BUSY ||
+				    !WaitNamedPipeW(pipePath.c_str(), NMPWAIT_WAIT_FOREVER))
+				{
+					THROW(L"Cannot connect to the coverage aggregator " << pipePath.wstring()
+					      << L": error " << lastError);
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		void Write(HANDLE hPipe, const char* data, size_t size)
+		{
+			while (size)
+			{
+				DWORD writtenSize = 0;
+				auto sizeToWrite = static_cast<DWORD>((std::min)(size, MaxWriteSize));
+
+				if (!WriteFile(hPipe, data, sizeToWrite, &writtenSize, nullptr))
+					THROW(L"Cannot send the coverage to the aggregator: error " << GetLastError());
+				data += writtenSize;
+				size -= writtenSize;
+			}
+		}
+	}
+
+	const std::wstring AggregatorExporter::DefaultPipePath = L"\\\\.\\pipe\\OpenCppCoverageAggregator";
+	const uint8_t AggregatorExporter::Acknowledgment = 1;
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path AggregatorExporter::GetDefaultPath(const std::wstring&) const
+	{
+		return DefaultPipePath;
+	}
+
+	//-------------------------------------------------------------------------
+	void AggregatorExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output)
+	{
+		auto content = CreateContent(coverageData);
+		auto hPipe = ConnectToAggregator(output);
+		Tools::ScopedAction closePipe{ [=]() { CloseHandle(hPipe); } };
+		uint64_t size = content.size();
+
+		Write(hPipe, reinterpret_cast<const char*>(&size), sizeof(size));
+		Write(hPipe, content.data(), content.size());
+
+		uint8_t acknowledgment = 0;
+		DWORD readSize = 0;
+		if (!ReadFile(hPipe, &acknowledgment, sizeof(acknowledgment), &readSize, nullptr) ||
+		    readSize != sizeof(acknowledgment) || acknowledgment != Acknowledgment)
+		{
+			THROW(L"The coverage aggregator " << output.wstring() << L" did not receive the coverage.");
+		}
+		Tools::ShowOutputMessage(
+		    L"Coverage sent (" + std::to_wstring(content.size()) + L" bytes) to the aggregator: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	std::string AggregatorExporter::CreateContent(const Plugin::CoverageData& coverageData)
+	{
+		std::ostringstream ostr;
+
+		CoverageDataSerializer{}.Serialize(coverageData, ostr);
+		return ReportWriter::Gzip(ostr.str());
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData AggregatorExporter::ReadContent(const std::string& content)
+	{
+		std::istringstream istr{ ReportWriter::Gunzip(content) };
+
+		return CoverageDataDeserializer{}.Deserialize(istr, "Invalid coverage received by the aggregator.");
+	}
+}
@@ -0,0 +1,49 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "../ExporterExport.hpp"
+#include "../IExporter.hpp"
+
+namespace Exporter
+{
+	// Send the coverage to an aggregator on the named pipe of the output,
+	// \\<server>\pipe\<name>. The message is the size of the content on 8
+	// bytes followed by the content, the gzip compressed binary coverage.
+	// The aggregator answers Acknowledgment once the content is received.
+	class EXPORTER_DLL AggregatorExporter : public IExporter
+	{
+	public:
+		static const std::wstring DefaultPipePath;
+		static const uint8_t Acknowledgment;
+
+		AggregatorExporter() = default;
+
+		std::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+
+		static std::string CreateContent(const Plugin::CoverageData&);
+		static Plugin::CoverageData ReadContent(const std::string&);
+
+	private:
+		AggregatorExporter(const AggregatorExporter&) = delete;
+		AggregatorExporter& operator=(const AggregatorExporter&) = delete;
+	};
+}
@@ -24,9 +24,22 @@
 #include "CoverageDataSerializer.hpp"
 
 #include "Tools/Tool.hpp"
+#include "../ExporterException.hpp"
 
 namespace Exporter
 {
+	//-------------------------------------------------------------------------
+	BinaryExporter::BinaryExporter(Layout layout, const std::filesystem::path& path)
+		: layout_{ std::make_pair(layout, path) }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	BinaryExporter::BinaryExporter(bool areModulesCompressed)
+		: areModulesCompressed_{ areModulesCompressed }
+	{
+	}
+
 	//-------------------------------------------------------------------------
 	std::filesystem::path BinaryExporter::GetDefaultPath(const std::wstring& prefix) const
 	{
@@ -42,9 +55,37 @@ namespace Exporter
 		const Plugin::CoverageData& coverageData, 
 		const std::filesystem::path& output)
 	{
-		CoverageDataSerializer coverageDataSerializer;
+		using Version = CoverageDataSerializer::Version;
+		CoverageDataSerializer coverageDataSerializer{ areModulesCompressed_ ? Version::V2Compressed : Version::V2 };
+
+		if (layout_ && layout_->first == Layout::Delta)
+			coverageDataSerializer.SerializeDelta(coverageData, layout_->second, output);
+		else if (layout_ && layout_->first == Layout::Hits)
+			coverageDataSerializer.SerializeHits(coverageData, layout_->second, output);
+		else
+			coverageDataSerializer.Serialize(coverageData, output);
+		peakMessageSize_ = coverageDataSerializer.GetPeakMessageSize();
+		Tools::ShowOutputMessage(L"Coverage binary generated in file: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	void BinaryExporter::Export(
+		const CppCoverage::ICoverageSource& coverageSource,
+		const std::filesystem::path& output)
+	{
+		using Version = CoverageDataSerializer::Version;
+		CoverageDataSerializer coverageDataSerializer{ areModulesCompressed_ ? Version::V2Compressed : Version::V2 };
 
-		coverageDataSerializer.Serialize(coverageData, output);
+		if (layout_)
+			THROW(L"The binary layouts need the coverage data.");
+		coverageDataSerializer.Serialize(coverageSource, output);
+		peakMessageSize_ = coverageDataSerializer.GetPeakMessageSize();
 		Tools::ShowOutputMessage(L"Coverage binary generated in file: ", output);
 	}
+
+	//-------------------------------------------------------------------------
+	IExporter::BufferSizes BinaryExporter::GetPeakBufferSizes() const
+	{
+		return {{"Protobuf messages", peakMessageSize_}};
+	}
 }
@@ -16,22 +16,51 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
+
 #include "../ExporterExport.hpp"
 #include "../IExporter.hpp"
 
+namespace CppCoverage
+{
+	class ICoverageSource;
+}
+
 namespace Exporter
 {
 	class EXPORTER_DLL BinaryExporter : public IExporter
 	{
 	public:
+		enum class Layout
+		{
+			// Only the differences with the binary coverage file of the path.
+			Delta,
+			// Only the executed lines. The lines are in a line table of the
+			// folder of the path.
+			Hits
+		};
+
 		BinaryExporter() = default;
+		BinaryExporter(Layout, const std::filesystem::path&);
+		// Write each module in an independent gzip frame.
+		explicit BinaryExporter(bool areModulesCompressed);
 
 		std::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
 		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		// Write the coverage while it is read from the source. Not supported
+		// for the layouts.
+		void Export(const CppCoverage::ICoverageSource&, const std::filesystem::path& output);
+		BufferSizes GetPeakBufferSizes() const override;
 
 	private:
 		BinaryExporter(const BinaryExporter&) = delete;
 		BinaryExporter& operator=(const BinaryExporter&) = delete;
+
+	private:
+		std::optional<std::pair<Layout, std::filesystem::path>> layout_;
+		bool areModulesCompressed_ = false;
+		uint64_t peakMessageSize_ = 0;
 	};
 }
 
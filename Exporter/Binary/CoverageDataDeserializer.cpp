@@ -17,20 +17,27 @@
 #include "stdafx.h"
 #include "CoverageDataDeserializer.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "CoverageData.pb.hpp"
 
 #include "Plugin/Exporter/CoverageData.hpp"
 #include "Plugin/Exporter/ModuleCoverage.hpp"
 #include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
 
 #include "../ExporterException.hpp"
 
 #include "Tools/Tool.hpp"
+#include "Tools/ThreadPool.hpp"
 
 #include "CoverageDataSerializer.hpp"
 #include "ProtoBuff.hpp"
+#include "../ReportWriter.hpp"
 
 namespace pb = ProtoBuff;
 
@@ -38,6 +45,10 @@ namespace Exporter
 {
 	namespace
 	{
+		// The compressed modules are uncompressed by batches so the memory
+		// used by the frames is bounded whatever the number of modules.
+		const size_t ModuleBatchSize = 128;
+
 		//---------------------------------------------------------------------
 		void ReadMessage(
 			google::protobuf::io::CodedInputStream& input,
@@ -55,6 +66,20 @@ namespace Exporter
 			input.PopLimit(limit);
 		}
 
+		//---------------------------------------------------------------------
+		// The paths of the first format are repeated in each module using
+		// them: each distinct path is converted once.
+		const std::filesystem::path& GetPath(
+			std::unordered_map<std::string, std::filesystem::path>& pathsByUtf8,
+			const std::string& utf8Path)
+		{
+			auto it = pathsByUtf8.find(utf8Path);
+
+			if (it == pathsByUtf8.end())
+				it = pathsByUtf8.emplace(utf8Path, Tools::Utf8ToWString(utf8Path)).first;
+			return it->second;
+		}
+
 		//---------------------------------------------------------------------
 		void InitCoverageDataFrom(
 			google::protobuf::io::CodedInputStream&  input,
@@ -62,48 +87,579 @@ namespace Exporter
 			Plugin::CoverageData& coverageData)
 		{
 			auto moduleCount = coverageDataProtoBuff.modulecount();
+			std::unordered_map<std::string, std::filesystem::path> pathsByUtf8;
+			// The message is reused for all the modules: the parsing clears
+			// the files and the lines and fills them again without new allocations.
+			google::protobuf::Arena arena;
+			auto& moduleProtoBuff = *google::protobuf::Arena::CreateMessage<pb::ModuleCoverage>(&arena);
 
 			for (size_t i = 0; i < moduleCount; ++i)
 			{
-				pb::ModuleCoverage moduleProtoBuff;
-
-				ReadMessage(input, moduleProtoBuff);				
-				auto& module = coverageData.AddModule(Tools::Utf8ToWString(moduleProtoBuff.path()));
+				ReadMessage(input, moduleProtoBuff);
+				auto& module = coverageData.AddModule(GetPath(pathsByUtf8, moduleProtoBuff.path()));
+				module.SetIdentity(Tools::Utf8ToWString(moduleProtoBuff.identity()));
+				module.ReserveFiles(static_cast<size_t>(moduleProtoBuff.files_size()));
 
 				for (const auto& fileProtoBuff : moduleProtoBuff.files())
 				{
-					auto& file = module.AddFile(Tools::Utf8ToWString(fileProtoBuff.path()));
+					auto& file = module.AddFile(GetPath(pathsByUtf8, fileProtoBuff.path()));
+					std::vector<Plugin::LineCoverage> lines;
 
+					// The lines are serialized in order.
+					lines.reserve(static_cast<size_t>(fileProtoBuff.lines_size()));
 					for (const auto& line : fileProtoBuff.lines())
-						file.AddLine(line.linenumber(), line.hasbeenexecuted());
+					{
+						lines.emplace_back(line.linenumber(),
+						                   line.hasbeenexecuted(),
+						                   0,
+						                   line.firsthitorder(),
+						                   line.firsthittime());
+					}
+					file.SetLines(std::move(lines));
 				}
 			}
 		}		
 
-		//-------------------------------------------------------------------------
-		Plugin::CoverageData DeserializeFromStream(
+		//---------------------------------------------------------------------
+		const std::filesystem::path& GetPath(
+			const std::vector<std::filesystem::path>& paths,
+			unsigned int pathIndex)
+		{
+			if (pathIndex >= paths.size())
+				THROW(L"Invalid path index: " << pathIndex);
+			return paths[pathIndex];
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<Plugin::LineCoverage> GetLines(const pb::FileCoverageV2& fileProtoBuff)
+		{
+			const auto& lineNumberDeltas = fileProtoBuff.linenumberdeltas();
+			const auto& executedLines = fileProtoBuff.executedlines();
+			auto lineCount = static_cast<size_t>(lineNumberDeltas.size());
+
+			if (executedLines.size() != (lineCount + 7) / 8)
+				THROW(L"Invalid executed lines size.");
+			if (fileProtoBuff.firsthitorders_size() != fileProtoBuff.firsthitlineindexes_size()
+				|| fileProtoBuff.firsthittimes_size() != fileProtoBuff.firsthitlineindexes_size())
+				THROW(L"Invalid first hits size.");
+
+			std::vector<Plugin::LineCoverage> lines;
+			unsigned int lineNumber = 0;
+			int firstHit = 0;
+
+			lines.reserve(lineCount);
+			for (size_t i = 0; i < lineCount; ++i)
+			{
+				lineNumber += lineNumberDeltas[static_cast<int>(i)];
+				bool hasBeenExecuted = (executedLines[i / 8] & (1 << (i % 8))) != 0;
+				uint64_t firstHitOrder = 0;
+				uint64_t firstHitTime = 0;
+
+				// First hits are serialized in the order of the lines.
+				if (firstHit < fileProtoBuff.firsthitlineindexes_size()
+					&& fileProtoBuff.firsthitlineindexes(firstHit) == i)
+				{
+					firstHitOrder = fileProtoBuff.firsthitorders(firstHit);
+					firstHitTime = fileProtoBuff.firsthittimes(firstHit);
+					++firstHit;
+				}
+				lines.emplace_back(lineNumber, hasBeenExecuted, 0, firstHitOrder, firstHitTime);
+			}
+			if (firstHit != fileProtoBuff.firsthitlineindexes_size())
+				THROW(L"Invalid first hit line index.");
+
+			return lines;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename CoverageDataProtoBuff>
+		std::vector<std::filesystem::path> GetPaths(const CoverageDataProtoBuff& coverageDataProtoBuff)
+		{
+			std::vector<std::filesystem::path> paths;
+
+			// Each path of the table is converted once.
+			paths.reserve(static_cast<size_t>(coverageDataProtoBuff.paths_size()));
+			for (const auto& path : coverageDataProtoBuff.paths())
+				paths.emplace_back(Tools::Utf8ToWString(path));
+			return paths;
+		}
+
+		//---------------------------------------------------------------------
+		void AddModuleV2(
+			const std::vector<std::filesystem::path>& paths,
+			const pb::ModuleCoverageV2& moduleProtoBuff,
+			Plugin::CoverageData& coverageData)
+		{
+			auto& module = coverageData.AddModule(GetPath(paths, moduleProtoBuff.pathindex()));
+			module.SetIdentity(Tools::Utf8ToWString(moduleProtoBuff.identity()));
+			module.ReserveFiles(static_cast<size_t>(moduleProtoBuff.files_size()));
+
+			for (const auto& fileProtoBuff : moduleProtoBuff.files())
+			{
+				auto& file = module.AddFile(GetPath(paths, fileProtoBuff.pathindex()));
+				file.SetLines(GetLines(fileProtoBuff));
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// A frame is the size of the compressed module followed by it.
+		std::string ReadFrame(google::protobuf::io::CodedInputStream& input)
+		{
+			unsigned int size = 0;
+			std::string frame;
+
+			if (!input.ReadVarint32(&size) || !input.ReadString(&frame, static_cast<int>(size)))
+				THROW(L"Cannot read the frame of a module.");
+			return frame;
+		}
+
+		//---------------------------------------------------------------------
+		void ParseCompressedModule(const std::string& frame, pb::ModuleCoverageV2& moduleProtoBuff)
+		{
+			if (!moduleProtoBuff.ParseFromString(ReportWriter::Gunzip(frame)))
+				THROW(L"Cannot parse message.");
+		}
+
+		//---------------------------------------------------------------------
+		// The frames are read in order and the modules of a batch are
+		// uncompressed and parsed in parallel.
+		void AddCompressedModulesV2(
+			const std::vector<std::filesystem::path>& paths,
+			std::vector<std::string>&& frames,
+			Plugin::CoverageData& coverageData)
+		{
+			std::vector<pb::ModuleCoverageV2> moduleProtoBuffs(frames.size());
+
+			Tools::ParallelFor(frames.size(), 1, [&](size_t i) {
+				ParseCompressedModule(frames[i], moduleProtoBuffs[i]);
+				frames[i] = std::string{};
+			});
+			for (const auto& moduleProtoBuff : moduleProtoBuffs)
+				AddModuleV2(paths, moduleProtoBuff, coverageData);
+		}
+
+		//---------------------------------------------------------------------
+		void InitCoverageDataV2From(
+			google::protobuf::io::CodedInputStream& input,
+			const pb::CoverageDataV2& coverageDataProtoBuff,
+			Plugin::CoverageData& coverageData)
+		{
+			auto paths = GetPaths(coverageDataProtoBuff);
+			auto moduleCount = static_cast<size_t>(coverageDataProtoBuff.modulecount());
+
+			coverageData.SetSampled(coverageDataProtoBuff.issampled());
+
+			if (coverageDataProtoBuff.hascompressedmodules())
+			{
+				for (size_t batchStart = 0; batchStart < moduleCount; batchStart += ModuleBatchSize)
+				{
+					std::vector<std::string> frames((std::min)(ModuleBatchSize, moduleCount - batchStart));
+
+					for (auto& frame : frames)
+						frame = ReadFrame(input);
+					AddCompressedModulesV2(paths, std::move(frames), coverageData);
+				}
+				return;
+			}
+
+			google::protobuf::Arena arena;
+			auto& moduleProtoBuff = *google::protobuf::Arena::CreateMessage<pb::ModuleCoverageV2>(&arena);
+
+			for (size_t i = 0; i < moduleCount; ++i)
+			{
+				ReadMessage(input, moduleProtoBuff);
+				AddModuleV2(paths, moduleProtoBuff, coverageData);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		std::ifstream OpenFile(const std::filesystem::path& path)
+		{
+			std::ifstream ifs(path.string(), std::ios::binary);
+
+			if (!ifs)
+				THROW(L"Cannot open file " + path.wstring());
+			return ifs;
+		}
+
+		//---------------------------------------------------------------------
+		void SeekTo(std::istream& istr, uint64_t offset)
+		{
+			istr.clear();
+			if (!istr.seekg(static_cast<std::streamoff>(offset), std::ios::beg))
+				THROW(L"Cannot seek to " << offset);
+		}
+
+		//---------------------------------------------------------------------
+		void ReadMessageAt(
 			std::istream& istr,
-			const std::string& errorIfNotCorrectFormat)
+			uint64_t offset,
+			google::protobuf::MessageLite& message)
 		{
-			google::protobuf::io::IstreamInputStream outputStream(&istr);
-			google::protobuf::io::CodedInputStream  codedInputStream(&outputStream);
+			SeekTo(istr, offset);
+
+			google::protobuf::io::IstreamInputStream inputStream(&istr);
+			google::protobuf::io::CodedInputStream codedInputStream(&inputStream);
 
+			ReadMessage(codedInputStream, message);
+		}
+
+		//---------------------------------------------------------------------
+		std::string ReadFrameAt(std::istream& istr, uint64_t offset)
+		{
+			SeekTo(istr, offset);
+
+			google::protobuf::io::IstreamInputStream inputStream(&istr);
+			google::protobuf::io::CodedInputStream codedInputStream(&inputStream);
+
+			return ReadFrame(codedInputStream);
+		}
+
+		//---------------------------------------------------------------------
+		pb::CoverageDataV2 ReadHeaderV2(
+			std::istream& istr,
+			const std::string& errorIfNotCorrectFormat)
+		{
+			google::protobuf::io::IstreamInputStream inputStream(&istr);
+			google::protobuf::io::CodedInputStream codedInputStream(&inputStream);
 			unsigned int fileTypeId;
-			if (!codedInputStream.ReadVarint32(&fileTypeId) || fileTypeId != CoverageDataSerializer::FileTypeId)
-				throw std::runtime_error(errorIfNotCorrectFormat);
 
-			pb::CoverageData coverageDataProtoBuff;
+			if (!codedInputStream.ReadVarint32(&fileTypeId) 
+				|| fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+				throw std::runtime_error(errorIfNotCorrectFormat);
 
+			pb::CoverageDataV2 coverageDataProtoBuff;
 			ReadMessage(codedInputStream, coverageDataProtoBuff);
 
+			return coverageDataProtoBuff;
+		}
+
+		//---------------------------------------------------------------------
+		pb::ModuleIndexV2 ReadModuleIndex(std::istream& istr)
+		{
+			uint64_t indexOffset = 0;
+			unsigned int fileTypeId = 0;
+
+			istr.clear();
+			if (!istr.seekg(-static_cast<std::streamoff>(CoverageDataSerializer::IndexFooterSize), std::ios::end))
+				THROW(L"Cannot read the module index.");
+			{
+				google::protobuf::io::IstreamInputStream inputStream(&istr);
+				google::protobuf::io::CodedInputStream codedInputStream(&inputStream);
+
+				if (!codedInputStream.ReadLittleEndian64(&indexOffset)
+					|| !codedInputStream.ReadLittleEndian32(&fileTypeId)
+					|| fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+				{
+					THROW(L"Cannot read the module index.");
+				}
+			}
+
+			pb::ModuleIndexV2 moduleIndex;
+			ReadMessageAt(istr, indexOffset, moduleIndex);
+
+			return moduleIndex;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename CoverageDataProtoBuff, typename InitCoverageData>
+		Plugin::CoverageData DeserializeFrom(
+			google::protobuf::io::CodedInputStream& input,
+			InitCoverageData initCoverageData)
+		{
+			CoverageDataProtoBuff coverageDataProtoBuff;
+
+			ReadMessage(input, coverageDataProtoBuff);
+
 			Plugin::CoverageData coverageData{
 				Tools::Utf8ToWString(coverageDataProtoBuff.name()),
 				coverageDataProtoBuff.exitcode() };
 
-			InitCoverageDataFrom(codedInputStream, coverageDataProtoBuff, coverageData);
+			initCoverageData(input, coverageDataProtoBuff, coverageData);
 
 			return coverageData;
 		}
+
+		//---------------------------------------------------------------------
+		std::filesystem::path GetBaselinePath(
+			const pb::CoverageDataDeltaV2& coverageDataDelta,
+			const std::filesystem::path& deltaPath)
+		{
+			std::filesystem::path baselinePath{ Tools::Utf8ToWString(coverageDataDelta.baselinepath()) };
+
+			// The baseline can be moved with the delta.
+			if (!Tools::FileExists(baselinePath))
+				baselinePath = deltaPath.parent_path() / baselinePath.filename();
+			if (!Tools::FileExists(baselinePath))
+				THROW(L"Cannot find the baseline " << baselinePath.wstring());
+			if (CoverageDataSerializer::ComputeFileHash(baselinePath) != coverageDataDelta.baselinehash())
+				THROW(L"The baseline " << baselinePath.wstring() << L" has changed since the delta was written.");
+			return baselinePath;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<Plugin::LineCoverage> ToggleLines(
+			const Plugin::FileCoverage& baselineFile,
+			const pb::FileDeltaV2& fileDelta)
+		{
+			const auto& baselineLines = baselineFile.GetLines();
+			std::vector<bool> toggledLines(baselineLines.size());
+			std::vector<Plugin::LineCoverage> lines;
+
+			for (auto lineIndex : fileDelta.toggledlineindexes())
+			{
+				if (lineIndex >= baselineLines.size())
+					THROW(L"Invalid line index: " << lineIndex);
+				toggledLines[lineIndex] = true;
+			}
+
+			lines.reserve(baselineLines.size());
+			for (size_t i = 0; i < baselineLines.size(); ++i)
+			{
+				const auto& line = baselineLines[i];
+				lines.emplace_back(line.GetLineNumber(),
+				                   line.HasBeenExecuted() != toggledLines[i],
+				                   line.GetHitCount(),
+				                   line.GetFirstHitOrder(),
+				                   line.GetFirstHitTime());
+			}
+			return lines;
+		}
+
+		//---------------------------------------------------------------------
+		void CopyModule(
+			const Plugin::ModuleCoverage& baselineModule,
+			Plugin::CoverageData& coverageData)
+		{
+			auto& module = coverageData.AddModule(baselineModule.GetPath());
+			module.SetIdentity(baselineModule.GetIdentity());
+
+			module.ReserveFiles(baselineModule.GetFiles().size());
+			for (const auto& baselineFile : baselineModule.GetFiles())
+				module.AddFile(baselineFile->GetPath()) = *baselineFile;
+		}
+
+		//---------------------------------------------------------------------
+		// The files of the baseline come first, in the same order, followed by
+		// the new files of the delta.
+		void AddModuleDelta(
+			const std::vector<std::filesystem::path>& paths,
+			const Plugin::ModuleCoverage* baselineModule,
+			const pb::ModuleDeltaV2& moduleDelta,
+			Plugin::CoverageData& coverageData)
+		{
+			auto& module = coverageData.AddModule(GetPath(paths, moduleDelta.pathindex()));
+			if (moduleDelta.has_identity())
+				module.SetIdentity(Tools::Utf8ToWString(moduleDelta.identity()));
+			else if (baselineModule)
+				module.SetIdentity(baselineModule->GetIdentity());
+			std::unordered_map<std::filesystem::path::string_type, const pb::FileDeltaV2*> fileDeltas;
+			std::unordered_set<std::filesystem::path::string_type> removedFiles;
+
+			for (const auto& fileDelta : moduleDelta.files())
+				fileDeltas.emplace(GetPath(paths, fileDelta.pathindex()).native(), &fileDelta);
+			for (auto pathIndex : moduleDelta.removedfilepathindexes())
+				removedFiles.insert(GetPath(paths, pathIndex).native());
+
+			if (baselineModule)
+			{
+				for (const auto& baselineFile : baselineModule->GetFiles())
+				{
+					const auto& path = baselineFile->GetPath();
+
+					if (removedFiles.count(path.native()))
+						continue;
+
+					auto& file = module.AddFile(path);
+					auto it = fileDeltas.find(path.native());
+
+					if (it == fileDeltas.end())
+						file = *baselineFile;
+					else
+					{
+						const auto& fileDelta = *it->second;
+
+						file.SetLines(fileDelta.has_lines() 
+							? GetLines(fileDelta.lines()) : ToggleLines(*baselineFile, fileDelta));
+						fileDeltas.erase(it);
+					}
+				}
+			}
+
+			for (const auto& fileDelta : moduleDelta.files())
+			{
+				const auto& path = GetPath(paths, fileDelta.pathindex());
+
+				if (fileDeltas.count(path.native()))
+				{
+					if (!fileDelta.has_lines())
+						THROW(L"Cannot find " << path.wstring() << L" in the baseline.");
+					module.AddFile(path).SetLines(GetLines(fileDelta.lines()));
+				}
+			}
+		}
+
+		//---------------------------------------------------------------------
+		// The modules of the baseline come first, in the same order, followed by
+		// the new modules of the delta.
+		Plugin::CoverageData DeserializeDelta(
+			google::protobuf::io::CodedInputStream& input,
+			const std::filesystem::path& deltaPath,
+			const std::string& errorIfNotCorrectFormat)
+		{
+			pb::CoverageDataDeltaV2 coverageDataDelta;
+
+			ReadMessage(input, coverageDataDelta);
+
+			// The baseline can itself be a delta.
+			auto baseline = CoverageDataDeserializer{}.Deserialize(
+				GetBaselinePath(coverageDataDelta, deltaPath), errorIfNotCorrectFormat);
+			auto paths = GetPaths(coverageDataDelta);
+			std::vector<pb::ModuleDeltaV2> moduleDeltas(static_cast<size_t>(coverageDataDelta.modulecount()));
+			std::unordered_map<std::filesystem::path::string_type, const pb::ModuleDeltaV2*> moduleDeltasByPath;
+			std::unordered_set<std::filesystem::path::string_type> removedModules;
+
+			for (auto& moduleDelta : moduleDeltas)
+			{
+				ReadMessage(input, moduleDelta);
+				moduleDeltasByPath.emplace(GetPath(paths, moduleDelta.pathindex()).native(), &moduleDelta);
+			}
+			for (auto pathIndex : coverageDataDelta.removedmodulepathindexes())
+				removedModules.insert(GetPath(paths, pathIndex).native());
+
+			Plugin::CoverageData coverageData{
+				Tools::Utf8ToWString(coverageDataDelta.name()),
+				coverageDataDelta.exitcode() };
+
+			for (const auto& baselineModule : baseline.GetModules())
+			{
+				const auto& path = baselineModule->GetPath();
+				auto it = moduleDeltasByPath.find(path.native());
+
+				if (removedModules.count(path.native()))
+					continue;
+				if (it == moduleDeltasByPath.end())
+					CopyModule(*baselineModule, coverageData);
+				else
+				{
+					AddModuleDelta(paths, baselineModule.get(), *it->second, coverageData);
+					moduleDeltasByPath.erase(it);
+				}
+			}
+
+			for (const auto& moduleDelta : moduleDeltas)
+			{
+				if (moduleDeltasByPath.count(GetPath(paths, moduleDelta.pathindex()).native()))
+					AddModuleDelta(paths, nullptr, moduleDelta, coverageData);
+			}
+
+			return coverageData;
+		}
+
+		//---------------------------------------------------------------------
+		std::filesystem::path GetLineTablePath(
+			const pb::CoverageDataHitsV2& coverageDataHits,
+			const std::filesystem::path& hitsPath)
+		{
+			auto lineTablePath = CoverageDataSerializer::GetLineTablePath(
+				Tools::Utf8ToWString(coverageDataHits.linetablefolder()), coverageDataHits.buildid());
+
+			// The line table can be moved with the runs.
+			if (!Tools::FileExists(lineTablePath))
+				lineTablePath = hitsPath.parent_path() / lineTablePath.filename();
+			if (!Tools::FileExists(lineTablePath))
+				THROW(L"Cannot find the line table " << lineTablePath.wstring());
+			return lineTablePath;
+		}
+
+		//---------------------------------------------------------------------
+		void AddModuleHits(
+			const Plugin::ModuleCoverage& lineTableModule,
+			const pb::ModuleHitsV2& moduleHits,
+			Plugin::CoverageData& coverageData)
+		{
+			const auto& lineTableFiles = lineTableModule.GetFiles();
+			auto& module = coverageData.AddModule(lineTableModule.GetPath());
+			module.SetIdentity(lineTableModule.GetIdentity());
+
+			if (static_cast<size_t>(moduleHits.executedlines_size()) != lineTableFiles.size())
+				THROW(L"Invalid file count for " << lineTableModule.GetPath().wstring());
+			module.ReserveFiles(lineTableFiles.size());
+			for (size_t i = 0; i < lineTableFiles.size(); ++i)
+			{
+				const auto& lineTableFile = *lineTableFiles[i];
+				const auto& lineTableLines = lineTableFile.GetLines();
+				const auto& executedLines = moduleHits.executedlines(static_cast<int>(i));
+				std::vector<Plugin::LineCoverage> lines;
+
+				if (executedLines.size() != (lineTableLines.size() + 7) / 8)
+					THROW(L"Invalid executed lines size for " << lineTableFile.GetPath().wstring());
+				lines.reserve(lineTableLines.size());
+				for (size_t j = 0; j < lineTableLines.size(); ++j)
+				{
+					lines.emplace_back(lineTableLines[j].GetLineNumber(),
+					                   (executedLines[j / 8] & (1 << (j % 8))) != 0);
+				}
+				module.AddFile(lineTableFile.GetPath()).SetLines(std::move(lines));
+			}
+		}
+
+		//---------------------------------------------------------------------
+		Plugin::CoverageData DeserializeHits(
+			google::protobuf::io::CodedInputStream& input,
+			const std::filesystem::path& hitsPath,
+			const std::string& errorIfNotCorrectFormat)
+		{
+			pb::CoverageDataHitsV2 coverageDataHits;
+
+			ReadMessage(input, coverageDataHits);
+
+			auto lineTablePath = GetLineTablePath(coverageDataHits, hitsPath);
+			auto lineTable = CoverageDataDeserializer{}.Deserialize(lineTablePath, errorIfNotCorrectFormat);
+			const auto& lineTableModules = lineTable.GetModules();
+
+			if (CoverageDataSerializer::ComputeBuildId(lineTable) != coverageDataHits.buildid()
+				|| coverageDataHits.modulecount() != lineTableModules.size())
+				THROW(L"The line table " << lineTablePath.wstring() << L" is not the one of the build.");
+
+			Plugin::CoverageData coverageData{
+				Tools::Utf8ToWString(coverageDataHits.name()),
+				coverageDataHits.exitcode() };
+
+			coverageData.ReserveModules(lineTableModules.size());
+			for (const auto& lineTableModule : lineTableModules)
+			{
+				pb::ModuleHitsV2 moduleHits;
+
+				ReadMessage(input, moduleHits);
+				AddModuleHits(*lineTableModule, moduleHits, coverageData);
+			}
+			return coverageData;
+		}
+
+		//-------------------------------------------------------------------------
+		Plugin::CoverageData DeserializeFromStream(
+			std::istream& istr,
+			const std::filesystem::path& path,
+			const std::string& errorIfNotCorrectFormat)
+		{
+			google::protobuf::io::IstreamInputStream outputStream(&istr);
+			google::protobuf::io::CodedInputStream  codedInputStream(&outputStream);
+
+			unsigned int fileTypeId;
+			if (!codedInputStream.ReadVarint32(&fileTypeId))
+				throw std::runtime_error(errorIfNotCorrectFormat);
+
+			if (fileTypeId == CoverageDataSerializer::FileTypeIdV2)
+				return DeserializeFrom<pb::CoverageDataV2>(codedInputStream, InitCoverageDataV2From);
+			if (fileTypeId == CoverageDataSerializer::FileTypeId)
+				return DeserializeFrom<pb::CoverageData>(codedInputStream, InitCoverageDataFrom);
+			if (fileTypeId == CoverageDataSerializer::FileTypeIdDelta)
+				return DeserializeDelta(codedInputStream, path, errorIfNotCorrectFormat);
+			if (fileTypeId == CoverageDataSerializer::FileTypeIdHits)
+				return DeserializeHits(codedInputStream, path, errorIfNotCorrectFormat);
+			throw std::runtime_error(errorIfNotCorrectFormat);
+		}
 	}
 		
 	//-------------------------------------------------------------------------
@@ -111,10 +667,92 @@ namespace Exporter
 		const std::filesystem::path& path, 
 		const std::string& errorIfNotCorrectFormat) const
 	{
-		std::ifstream ifs(path.string(), std::ios::binary);
+		auto ifs = OpenFile(path);
+
+		return DeserializeFromStream(ifs, path, errorIfNotCorrectFormat);
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageDataDeserializer::Deserialize(
+		std::istream& istr,
+		const std::string& errorIfNotCorrectFormat) const
+	{
+		return DeserializeFromStream(istr, {}, errorIfNotCorrectFormat);
+	}
 
-		if (!ifs)
-			THROW(L"Cannot open file " + path.wstring());
-		return DeserializeFromStream(ifs, errorIfNotCorrectFormat);
+	//-------------------------------------------------------------------------
+	bool CoverageDataDeserializer::HasModuleIndex(const std::filesystem::path& path) const
+	{
+		auto ifs = OpenFile(path);
+		google::protobuf::io::IstreamInputStream inputStream(&ifs);
+		google::protobuf::io::CodedInputStream codedInputStream(&inputStream);
+		unsigned int fileTypeId;
+
+		return codedInputStream.ReadVarint32(&fileTypeId)
+			&& fileTypeId == CoverageDataSerializer::FileTypeIdV2;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<ModuleSummary> CoverageDataDeserializer::DeserializeModuleSummaries(
+		const std::filesystem::path& path,
+		const std::string& errorIfNotCorrectFormat) const
+	{
+		auto ifs = OpenFile(path);
+		auto coverageDataProtoBuff = ReadHeaderV2(ifs, errorIfNotCorrectFormat);
+		auto moduleIndex = ReadModuleIndex(ifs);
+		std::vector<ModuleSummary> moduleSummaries;
+
+		moduleSummaries.reserve(static_cast<size_t>(moduleIndex.modules_size()));
+		for (const auto& entry : moduleIndex.modules())
+		{
+			if (entry.pathindex() >= static_cast<unsigned int>(coverageDataProtoBuff.paths_size()))
+				THROW(L"Invalid path index: " << entry.pathindex());
+			moduleSummaries.emplace_back(
+				Tools::Utf8ToWString(coverageDataProtoBuff.paths(static_cast<int>(entry.pathindex()))),
+				static_cast<size_t>(entry.filecount()),
+				static_cast<size_t>(entry.linecount()),
+				static_cast<size_t>(entry.executedlinecount()));
+		}
+		return moduleSummaries;
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageDataDeserializer::DeserializeModules(
+		const std::filesystem::path& path,
+		const std::vector<std::filesystem::path>& modulePaths,
+		const std::string& errorIfNotCorrectFormat) const
+	{
+		auto ifs = OpenFile(path);
+		auto coverageDataProtoBuff = ReadHeaderV2(ifs, errorIfNotCorrectFormat);
+		auto moduleIndex = ReadModuleIndex(ifs);
+		auto paths = GetPaths(coverageDataProtoBuff);
+		Plugin::CoverageData coverageData{
+			Tools::Utf8ToWString(coverageDataProtoBuff.name()),
+			coverageDataProtoBuff.exitcode() };
+		std::vector<std::string> frames;
+
+		for (const auto& entry : moduleIndex.modules())
+		{
+			const auto& modulePath = GetPath(paths, entry.pathindex());
+
+			if (std::find(modulePaths.begin(), modulePaths.end(), modulePath) != modulePaths.end())
+			{
+				if (coverageDataProtoBuff.hascompressedmodules())
+				{
+					frames.push_back(ReadFrameAt(ifs, entry.offset()));
+					continue;
+				}
+
+				pb::ModuleCoverageV2 moduleProtoBuff;
+
+				ReadMessageAt(ifs, entry.offset(), moduleProtoBuff);
+				if (moduleProtoBuff.pathindex() != entry.pathindex())
+					THROW(L"Invalid module index for " << modulePath.wstring());
+				AddModuleV2(paths, moduleProtoBuff, coverageData);
+			}
+		}
+		if (!frames.empty())
+			AddCompressedModulesV2(paths, std::move(frames), coverageData);
+		return coverageData;
 	}
 }
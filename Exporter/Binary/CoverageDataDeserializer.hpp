@@ -17,8 +17,11 @@
 #pragma once
 
 #include <filesystem>
+#include <iosfwd>
+#include <vector>
 
 #include "../ExporterExport.hpp"
+#include "ModuleSummary.hpp"
 
 namespace Plugin
 {
@@ -32,7 +35,25 @@ namespace Exporter
 	public:		
 		CoverageDataDeserializer() = default;
 
+		// A delta file is applied to its baseline, which must be unchanged, and
+		// the hits of a run are joined with the line table of its build.
 		Plugin::CoverageData Deserialize(const std::filesystem::path&, const std::string& errorIfNotCorrectFormat) const;
+		// A hits content is read with the line tables of the current folder.
+		Plugin::CoverageData Deserialize(std::istream&, const std::string& errorIfNotCorrectFormat) const;
+
+		// The following methods use the module index of the version 2 and
+		// read only the header, the index and the selected modules.
+		bool HasModuleIndex(const std::filesystem::path&) const;
+
+		std::vector<ModuleSummary> DeserializeModuleSummaries(
+			const std::filesystem::path&,
+			const std::string& errorIfNotCorrectFormat) const;
+
+		// Modules not in the file are ignored.
+		Plugin::CoverageData DeserializeModules(
+			const std::filesystem::path&,
+			const std::vector<std::filesystem::path>& modulePaths,
+			const std::string& errorIfNotCorrectFormat) const;
 		
 	private:
 		CoverageDataDeserializer(const CoverageDataDeserializer&) = delete;
@@ -0,0 +1,298 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataReader.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "CoverageData.pb.hpp"
+
+#include "Tools/Tool.hpp"
+#include "Tools/MappedFile.hpp"
+
+#include "../ExporterException.hpp"
+
+#include "CoverageDataSerializer.hpp"
+#include "ProtoBuff.hpp"
+#include "../ReportWriter.hpp"
+
+namespace pb = ProtoBuff;
+using google::protobuf::io::CodedInputStream;
+using google::protobuf::internal::WireFormatLite;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string_view GetBytes(std::string_view bytes, uint64_t offset, uint64_t size)
+		{
+			if (offset > bytes.size() || size > bytes.size() - offset)
+				THROW(L"Invalid offset: " << offset << L" size: " << size);
+			return bytes.substr(static_cast<size_t>(offset), static_cast<size_t>(size));
+		}
+
+		//---------------------------------------------------------------------
+		// CodedInputStream reads at most INT_MAX bytes.
+		class InputStream
+		{
+		public:
+			explicit InputStream(std::string_view bytes)
+				: bytes_{ bytes.substr(0, (std::min)(
+					bytes.size(), static_cast<size_t>((std::numeric_limits<int>::max)()))) }
+				, input_{ reinterpret_cast<const uint8_t*>(bytes_.data()), static_cast<int>(bytes_.size()) }
+			{
+			}
+
+			CodedInputStream& Get()
+			{
+				return input_;
+			}
+
+			std::string_view ReadLengthDelimited()
+			{
+				unsigned int size = 0;
+
+				if (!input_.ReadVarint32(&size))
+					THROW(L"Cannot read size.");
+				auto bytes = GetBytes(bytes_, static_cast<uint64_t>(input_.CurrentPosition()), size);
+				input_.Skip(static_cast<int>(size));
+				return bytes;
+			}
+
+		private:
+			InputStream(const InputStream&) = delete;
+			InputStream& operator=(const InputStream&) = delete;
+
+			std::string_view bytes_;
+			CodedInputStream input_;
+		};
+
+		//---------------------------------------------------------------------
+		// bytes starts with the size of the message like written by the serializer.
+		void ParseMessage(std::string_view bytes, google::protobuf::MessageLite& message)
+		{
+			auto messageBytes = InputStream{ bytes }.ReadLengthDelimited();
+
+			if (!message.ParseFromArray(messageBytes.data(), static_cast<int>(messageBytes.size())))
+				THROW(L"Cannot parse message.");
+		}
+
+		//---------------------------------------------------------------------
+		constexpr uint32_t MakeTag(int fieldNumber, WireFormatLite::WireType wireType)
+		{
+			return (static_cast<uint32_t>(fieldNumber) << 3) | static_cast<uint32_t>(wireType);
+		}
+
+		//---------------------------------------------------------------------
+		// Parse only the fields needed by the view so the bytes are not copied.
+		FileCoverageView ParseFile(std::string_view fileBytes)
+		{
+			InputStream input{ fileBytes };
+			auto& codedInput = input.Get();
+			unsigned int pathIndex = 0;
+			bool hasPathIndex = false;
+			std::string_view lineNumberDeltas;
+			std::string_view executedLines;
+			bool hasExecutedLines = false;
+
+			while (auto tag = codedInput.ReadTag())
+			{
+				switch (tag)
+				{
+				case MakeTag(pb::FileCoverageV2::kPathIndexFieldNumber, WireFormatLite::WIRETYPE_VARINT):
+					if (!codedInput.ReadVarint32(&pathIndex))
+						THROW(L"Cannot read path index.");
+					hasPathIndex = true;
+					break;
+				case MakeTag(pb::FileCoverageV2::kLineNumberDeltasFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED):
+					if (!lineNumberDeltas.empty())
+						THROW(L"Line numbers are not packed in a single field.");
+					lineNumberDeltas = input.ReadLengthDelimited();
+					break;
+				case MakeTag(pb::FileCoverageV2::kExecutedLinesFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED):
+					executedLines = input.ReadLengthDelimited();
+					hasExecutedLines = true;
+					break;
+				default:
+					if (!WireFormatLite::SkipField(&codedInput, tag))
+						THROW(L"Cannot parse file.");
+				}
+			}
+			if (!hasPathIndex || !hasExecutedLines)
+				THROW(L"Cannot parse file.");
+			return FileCoverageView{ pathIndex, lineNumberDeltas, executedLines };
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<FileCoverageView> ParseFiles(std::string_view moduleBytes)
+		{
+			InputStream input{ moduleBytes };
+			auto& codedInput = input.Get();
+			std::vector<FileCoverageView> files;
+
+			while (auto tag = codedInput.ReadTag())
+			{
+				if (tag == MakeTag(pb::ModuleCoverageV2::kFilesFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED))
+					files.push_back(ParseFile(input.ReadLengthDelimited()));
+				else if (!WireFormatLite::SkipField(&codedInput, tag))
+					THROW(L"Cannot parse module.");
+			}
+			return files;
+		}
+
+		//---------------------------------------------------------------------
+		uint64_t GetModuleIndexOffset(std::string_view content)
+		{
+			const auto footerSize = CoverageDataSerializer::IndexFooterSize;
+
+			if (content.size() < footerSize)
+				THROW(L"Cannot read the module index.");
+
+			InputStream input{ content.substr(content.size() - footerSize) };
+			uint64_t indexOffset = 0;
+			unsigned int fileTypeId = 0;
+
+			if (!input.Get().ReadLittleEndian64(&indexOffset) 
+				|| !input.Get().ReadLittleEndian32(&fileTypeId)
+				|| fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+			{
+				THROW(L"Cannot read the module index.");
+			}
+			return indexOffset;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataReader::CoverageDataReader(
+		const std::filesystem::path& path,
+		const std::string& errorIfNotCorrectFormat)
+		: mappedFile_{ Tools::MappedFile::TryCreateBinary(path) }
+		, exitCode_{ 0 }
+		, areModulesCompressed_{ false }
+	{
+		if (!Tools::FileExists(path))
+			THROW(L"Cannot open file " + path.wstring());
+		if (!mappedFile_)
+			throw std::runtime_error(errorIfNotCorrectFormat);
+
+		auto content = mappedFile_->GetContent();
+		InputStream input{ content };
+		unsigned int fileTypeId = 0;
+
+		if (!input.Get().ReadVarint32(&fileTypeId) || fileTypeId != CoverageDataSerializer::FileTypeIdV2)
+			throw std::runtime_error(errorIfNotCorrectFormat);
+
+		pb::CoverageDataV2 coverageDataProtoBuff;
+		ParseMessage(content.substr(static_cast<size_t>(input.Get().CurrentPosition())), coverageDataProtoBuff);
+		name_ = Tools::Utf8ToWString(coverageDataProtoBuff.name());
+		exitCode_ = coverageDataProtoBuff.exitcode();
+		areModulesCompressed_ = coverageDataProtoBuff.hascompressedmodules();
+		paths_.reserve(static_cast<size_t>(coverageDataProtoBuff.paths_size()));
+		for (const auto& utf8Path : coverageDataProtoBuff.paths())
+			paths_.emplace_back(Tools::Utf8ToWString(utf8Path));
+
+		pb::ModuleIndexV2 moduleIndex;
+		auto indexOffset = GetModuleIndexOffset(content);
+		ParseMessage(GetBytes(content, indexOffset, content.size() - indexOffset), moduleIndex);
+
+		if (static_cast<uint64_t>(moduleIndex.modules_size()) != coverageDataProtoBuff.modulecount())
+			THROW(L"Invalid module index.");
+		moduleSummaries_.reserve(static_cast<size_t>(moduleIndex.modules_size()));
+		moduleLocations_.reserve(static_cast<size_t>(moduleIndex.modules_size()));
+		for (const auto& entry : moduleIndex.modules())
+		{
+			moduleSummaries_.emplace_back(
+				GetPath(entry.pathindex()),
+				static_cast<size_t>(entry.filecount()),
+				static_cast<size_t>(entry.linecount()),
+				static_cast<size_t>(entry.executedlinecount()));
+			moduleLocations_.push_back({ entry.offset(), entry.size() });
+		}
+		if (areModulesCompressed_)
+			uncompressedModules_.resize(moduleLocations_.size());
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataReader::~CoverageDataReader() = default;
+
+	//-------------------------------------------------------------------------
+	const std::wstring& CoverageDataReader::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	int CoverageDataReader::GetExitCode() const
+	{
+		return exitCode_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<ModuleSummary>& CoverageDataReader::GetModuleSummaries() const
+	{
+		return moduleSummaries_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<FileCoverageView> CoverageDataReader::GetFiles(size_t moduleIndex) const
+	{
+		if (moduleIndex >= moduleLocations_.size())
+			THROW(L"Invalid module index: " << moduleIndex);
+
+		auto files = ParseFiles(GetModuleBytes(moduleIndex));
+
+		// Check the path indexes here so GetPath does not throw later.
+		for (const auto& file : files)
+			GetPath(file.GetPathIndex());
+		return files;
+	}
+
+	//-------------------------------------------------------------------------
+	std::string_view CoverageDataReader::GetModuleBytes(size_t moduleIndex) const
+	{
+		const auto& location = moduleLocations_[moduleIndex];
+		auto bytes = InputStream{ GetBytes(mappedFile_->GetContent(), location.offset_, location.size_) }
+			.ReadLengthDelimited();
+
+		if (!areModulesCompressed_)
+			return bytes;
+
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			if (const auto& uncompressedModule = uncompressedModules_[moduleIndex])
+				return *uncompressedModule;
+		}
+		// Uncompressed outside the lock so several modules can be read in parallel.
+		auto uncompressedModule = std::make_unique<std::string>(ReportWriter::Gunzip(bytes));
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		auto& module = uncompressedModules_[moduleIndex];
+
+		if (!module)
+			module = std::move(uncompressedModule);
+		return *module;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path& CoverageDataReader::GetPath(unsigned int pathIndex) const
+	{
+		if (pathIndex >= paths_.size())
+			THROW(L"Invalid path index: " << pathIndex);
+		return paths_[pathIndex];
+	}
+}
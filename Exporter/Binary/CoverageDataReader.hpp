@@ -0,0 +1,80 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+#include "ModuleSummary.hpp"
+#include "FileCoverageView.hpp"
+
+namespace Tools
+{
+	class MappedFile;
+}
+
+namespace Exporter
+{
+	// Read a binary coverage file of version 2 through a memory mapping.
+	// Only the header and the module index are parsed at construction,
+	// the bytes of a module are read when its files are requested.
+	// The modules of a compressed file are uncompressed the first time their
+	// files are requested and kept until the reader is destroyed.
+	class EXPORTER_DLL CoverageDataReader
+	{
+	public:
+		CoverageDataReader(const std::filesystem::path&, const std::string& errorIfNotCorrectFormat);
+		~CoverageDataReader();
+
+		const std::wstring& GetName() const;
+		int GetExitCode() const;
+
+		const std::vector<ModuleSummary>& GetModuleSummaries() const;
+		std::vector<FileCoverageView> GetFiles(size_t moduleIndex) const;
+
+		// pathIndex is FileCoverageView::GetPathIndex.
+		const std::filesystem::path& GetPath(unsigned int pathIndex) const;
+
+	private:
+		CoverageDataReader(const CoverageDataReader&) = delete;
+		CoverageDataReader& operator=(const CoverageDataReader&) = delete;
+
+		struct ModuleLocation
+		{
+			uint64_t offset_;
+			uint64_t size_;
+		};
+
+		// The bytes of the ModuleCoverageV2 message.
+		std::string_view GetModuleBytes(size_t moduleIndex) const;
+
+		std::unique_ptr<Tools::MappedFile> mappedFile_;
+		std::wstring name_;
+		int exitCode_;
+		std::vector<std::filesystem::path> paths_;
+		std::vector<ModuleSummary> moduleSummaries_;
+		std::vector<ModuleLocation> moduleLocations_;
+		bool areModulesCompressed_;
+		mutable std::mutex mutex_;
+		mutable std::vector<std::unique_ptr<std::string>> uncompressedModules_;
+	};
+}
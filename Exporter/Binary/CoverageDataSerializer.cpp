@@ -16,7 +16,14 @@
 
 #include "stdafx.h"
 #include "CoverageDataSerializer.hpp"
+#include <algorithm>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 #include "CoverageData.pb.hpp"
 
@@ -25,12 +32,20 @@
 #include "Plugin/Exporter/FileCoverage.hpp"
 #include "Plugin/Exporter/LineCoverage.hpp"
 
+#include "CppCoverage/ICoverageSource.hpp"
+
 #include "../ExporterException.hpp"
 
 #include "Tools/Tool.hpp"
+#include "Tools/PathTable.hpp"
+#include "Tools/MappedFile.hpp"
+#include "Tools/Fnv1a.hpp"
+#include "Tools/ThreadPool.hpp"
 
 #include "ProtoBuff.hpp"
+#include "CoverageDataDeserializer.hpp"
 #include "../InvalidOutputFileException.hpp"
+#include "../ReportWriter.hpp"
 
 namespace pb = ProtoBuff;
 
@@ -38,12 +53,38 @@ namespace Exporter
 {
 	namespace
 	{
+		// The modules are encoded by batches so the memory used by the
+		// encoded modules is bounded whatever the number of modules.
+		const size_t ModuleBatchSize = 128;
+
+		//---------------------------------------------------------------------
+		// The paths of the first format are repeated in each module using
+		// them: each distinct path is converted once.
+		class Utf8Paths
+		{
+		public:
+			//-----------------------------------------------------------------
+			const std::string& Get(const std::filesystem::path& path)
+			{
+				auto it = utf8Paths_.find(path.native());
+
+				if (it == utf8Paths_.end())
+					it = utf8Paths_.emplace(path.native(), Tools::ToUtf8String(path.wstring())).first;
+				return it->second;
+			}
+
+		private:
+			std::unordered_map<std::filesystem::path::string_type, std::string> utf8Paths_;
+		};
+
 		//---------------------------------------------------------------------
 		void InitializeProtoBuffFrom(
 			const Plugin::FileCoverage& file,
+			Utf8Paths& utf8Paths,
 			pb::FileCoverage& fileProtoBuff)
 		{
-			fileProtoBuff.set_path(Tools::ToUtf8String(file.GetPath().wstring()));
+			fileProtoBuff.set_path(utf8Paths.Get(file.GetPath()));
+			fileProtoBuff.mutable_lines()->Reserve(static_cast<int>(file.GetLines().size()));
 
 			for (const auto& line : file.GetLines())
 			{
@@ -51,20 +92,29 @@ namespace Exporter
 				
 				lineProtoBuff->set_linenumber(line.GetLineNumber());
 				lineProtoBuff->set_hasbeenexecuted(line.HasBeenExecuted());
+				if (line.GetFirstHitOrder())
+				{
+					lineProtoBuff->set_firsthitorder(line.GetFirstHitOrder());
+					lineProtoBuff->set_firsthittime(line.GetFirstHitTime());
+				}
 			}
 		}
 
 		//---------------------------------------------------------------------
 		void InitializeModuleProtoBuffFrom(
 			const Plugin::ModuleCoverage& module,
+			Utf8Paths& utf8Paths,
 			pb::ModuleCoverage& moduleProtoBuff)
 		{
-			moduleProtoBuff.set_path(Tools::ToUtf8String(module.GetPath().wstring()));
-			
+			moduleProtoBuff.set_path(utf8Paths.Get(module.GetPath()));
+			if (!module.GetIdentity().empty())
+				moduleProtoBuff.set_identity(Tools::ToUtf8String(module.GetIdentity()));
+			moduleProtoBuff.mutable_files()->Reserve(static_cast<int>(module.GetFiles().size()));
+
 			for (const auto& file : module.GetFiles())
 			{
 				auto fileProtoBuff = moduleProtoBuff.add_files();
-				InitializeProtoBuffFrom(*file, *fileProtoBuff);
+				InitializeProtoBuffFrom(*file, utf8Paths, *fileProtoBuff);
 			}
 		}
 
@@ -79,25 +129,751 @@ namespace Exporter
 		}
 
 		//---------------------------------------------------------------------
-		void WriteMessage(
+		unsigned int ToPathIndex(size_t id)
+		{
+			if (id > (std::numeric_limits<unsigned int>::max)())
+				THROW(L"Too many paths to serialize.");
+			return static_cast<unsigned int>(id);
+		}
+
+		//---------------------------------------------------------------------
+		enum class Content
+		{
+			LinesAndHits,
+			// The lines are not executed and have no first hit.
+			Lines
+		};
+
+		//---------------------------------------------------------------------
+		std::string GetExecutedLines(const Plugin::FileCoverage& file)
+		{
+			const auto& lines = file.GetLines();
+			std::string executedLines((lines.size() + 7) / 8, '\0');
+
+			for (size_t i = 0; i < lines.size(); ++i)
+			{
+				if (lines[i].HasBeenExecuted())
+					executedLines[i / 8] |= static_cast<char>(1 << (i % 8));
+			}
+			return executedLines;
+		}
+
+		//---------------------------------------------------------------------
+		void InitializeProtoBuffV2From(
+			const Plugin::FileCoverage& file,
+			unsigned int pathIndex,
+			pb::FileCoverageV2& fileProtoBuff,
+			Content content = Content::LinesAndHits)
+		{
+			const auto& lines = file.GetLines();
+			std::string executedLines((lines.size() + 7) / 8, '\0');
+			unsigned int previousLineNumber = 0;
+
+			fileProtoBuff.set_pathindex(pathIndex);
+			fileProtoBuff.mutable_linenumberdeltas()->Reserve(static_cast<int>(lines.size()));
+			for (size_t i = 0; i < lines.size(); ++i)
+			{
+				const auto& line = lines[i];
+				auto lineNumber = line.GetLineNumber();
+
+				// Lines are sorted and unique so the delta is positive.
+				fileProtoBuff.add_linenumberdeltas(lineNumber - previousLineNumber);
+				previousLineNumber = lineNumber;
+				if (content == Content::Lines)
+					continue;
+				if (line.HasBeenExecuted())
+					executedLines[i / 8] |= static_cast<char>(1 << (i % 8));
+				if (line.GetFirstHitOrder())
+				{
+					fileProtoBuff.add_firsthitlineindexes(static_cast<unsigned int>(i));
+					fileProtoBuff.add_firsthitorders(line.GetFirstHitOrder());
+					fileProtoBuff.add_firsthittimes(line.GetFirstHitTime());
+				}
+			}
+			fileProtoBuff.set_executedlines(std::move(executedLines));
+		}
+
+		//---------------------------------------------------------------------
+		// Return the number of bytes written.
+		uint64_t WriteMessage(
 			const google::protobuf::MessageLite& message, 
-			google::protobuf::io::CodedOutputStream& output)
+			google::protobuf::io::CodedOutputStream& output,
+			uint64_t& peakMessageSize)
 		{
-			output.WriteVarint64(message.ByteSizeLong());
+			auto size = message.ByteSizeLong();
+
+			peakMessageSize = (std::max)(peakMessageSize, static_cast<uint64_t>(size));
+
+			output.WriteVarint64(size);
 			if (!message.SerializeToCodedStream(&output))
 				THROW(L"Cannot serialize message to stream");
+			return google::protobuf::io::CodedOutputStream::VarintSize64(size) + size;
+		}
+
+		//---------------------------------------------------------------------
+		void SerializeV1(
+			const Plugin::CoverageData& coverageData,
+			google::protobuf::io::CodedOutputStream& codedOutputStream,
+			uint64_t& peakMessageSize)
+		{
+			pb::CoverageData coverageDataProtoBuff;
+
+			codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeId);
+
+			FillCoverageDataProtoBuffFrom(coverageData, coverageDataProtoBuff);
+			WriteMessage(coverageDataProtoBuff, codedOutputStream, peakMessageSize);
+
+			// The message is reused for all the modules: the files and the
+			// lines cleared are filled again without new allocations.
+			google::protobuf::Arena arena;
+			auto& moduleProtoBuff = *google::protobuf::Arena::CreateMessage<pb::ModuleCoverage>(&arena);
+			Utf8Paths utf8Paths;
+
+			// Here we serialize manually modules because protobuff's limit.
+			// See https://developers.google.com/protocol-buffers/docs/techniques#large-data
+			for (const auto& module : coverageData.GetModules())
+			{
+				moduleProtoBuff.Clear();
+				InitializeModuleProtoBuffFrom(*module, utf8Paths, moduleProtoBuff);
+
+				WriteMessage(moduleProtoBuff, codedOutputStream, peakMessageSize);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		struct EncodedModule
+		{
+			// Written as it is, like WriteMessage for an uncompressed module.
+			std::string frame_;
+			uint64_t messageSize_ = 0;
+			pb::ModuleIndexEntryV2 indexEntry_;
+		};
+
+		//---------------------------------------------------------------------
+		std::string MakeFrame(std::string_view bytes)
+		{
+			using google::protobuf::io::CodedOutputStream;
+
+			std::string frame(CodedOutputStream::VarintSize64(bytes.size()) + bytes.size(), '\0');
+			auto data = reinterpret_cast<uint8_t*>(&frame[0]);
+
+			data = CodedOutputStream::WriteVarint64ToArray(bytes.size(), data);
+			std::copy(bytes.begin(), bytes.end(), data);
+			return frame;
+		}
+
+		//---------------------------------------------------------------------
+		// The offset of the index entry is set when the frame is written.
+		EncodedModule EncodeModuleV2(
+			const pb::ModuleCoverageV2& moduleProtoBuff,
+			const std::filesystem::path& modulePath,
+			uint64_t lineCount,
+			uint64_t executedLineCount,
+			bool isCompressed)
+		{
+			EncodedModule encodedModule;
+			std::string bytes;
+
+			if (!moduleProtoBuff.SerializeToString(&bytes))
+				THROW(L"Cannot serialize message to stream");
+			encodedModule.messageSize_ = bytes.size();
+			encodedModule.frame_ = MakeFrame(isCompressed ? ReportWriter::Gzip(bytes) : bytes);
+			if (encodedModule.frame_.size() > static_cast<size_t>((std::numeric_limits<int>::max)()))
+				THROW(L"The module is too big to serialize: " << modulePath.wstring());
+
+			auto& indexEntry = encodedModule.indexEntry_;
+			indexEntry.set_pathindex(moduleProtoBuff.pathindex());
+			indexEntry.set_size(encodedModule.frame_.size());
+			indexEntry.set_filecount(moduleProtoBuff.files_size());
+			indexEntry.set_linecount(lineCount);
+			indexEntry.set_executedlinecount(executedLineCount);
+			return encodedModule;
+		}
+
+		//---------------------------------------------------------------------
+		// Run on the threads of the pool: pathTable is only read.
+		EncodedModule EncodeModuleV2(
+			const Plugin::ModuleCoverage& module,
+			const Tools::PathTable& pathTable,
+			Content content,
+			bool isCompressed)
+		{
+			pb::ModuleCoverageV2 moduleProtoBuff;
+			uint64_t lineCount = 0;
+			uint64_t executedLineCount = 0;
+
+			moduleProtoBuff.mutable_files()->Reserve(static_cast<int>(module.GetFiles().size()));
+			moduleProtoBuff.set_pathindex(ToPathIndex(pathTable.GetId(module.GetPath())));
+			if (!module.GetIdentity().empty())
+				moduleProtoBuff.set_identity(Tools::ToUtf8String(module.GetIdentity()));
+			for (const auto& file : module.GetFiles())
+			{
+				InitializeProtoBuffV2From(
+					*file,
+					ToPathIndex(pathTable.GetId(file->GetPath())),
+					*moduleProtoBuff.add_files(),
+					content);
+				lineCount += file->GetLines().size();
+				if (content == Content::LinesAndHits)
+					executedLineCount += file->GetExecutedLineCount();
+			}
+			return EncodeModuleV2(moduleProtoBuff, module.GetPath(), lineCount, executedLineCount, isCompressed);
+		}
+
+		//---------------------------------------------------------------------
+		// Fill the files of the message like InitializeProtoBuffV2From while
+		// the source visits them, without the intermediate Plugin::FileCoverage.
+		class ModuleProtoBuffV2Filler : public CppCoverage::ICoverageFileVisitor
+		{
+		public:
+			//-----------------------------------------------------------------
+			ModuleProtoBuffV2Filler(const Tools::PathTable& pathTable, pb::ModuleCoverageV2& moduleProtoBuff)
+				: pathTable_{ pathTable }
+				, moduleProtoBuff_{ moduleProtoBuff }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool OnFile(const std::filesystem::path& path, size_t lineCount) override
+			{
+				SetExecutedLines();
+				fileProtoBuff_ = moduleProtoBuff_.add_files();
+				fileProtoBuff_->set_pathindex(ToPathIndex(pathTable_.GetId(path)));
+				fileProtoBuff_->mutable_linenumberdeltas()->Reserve(static_cast<int>(lineCount));
+				executedLines_.assign((lineCount + 7) / 8, '\0');
+				lineIndex_ = 0;
+				previousLineNumber_ = 0;
+				lineCount_ += lineCount;
+				return true;
+			}
+
+			//-----------------------------------------------------------------
+			void OnLine(unsigned int lineNumber,
+			            bool hasBeenExecuted,
+			            uint64_t,
+			            uint64_t firstHitOrder,
+			            uint64_t firstHitTime) override
+			{
+				// Lines are sorted and unique so the delta is positive.
+				fileProtoBuff_->add_linenumberdeltas(lineNumber - previousLineNumber_);
+				previousLineNumber_ = lineNumber;
+				if (hasBeenExecuted)
+				{
+					executedLines_[lineIndex_ / 8] |= static_cast<char>(1 << (lineIndex_ % 8));
+					++executedLineCount_;
+				}
+				if (firstHitOrder)
+				{
+					fileProtoBuff_->add_firsthitlineindexes(static_cast<unsigned int>(lineIndex_));
+					fileProtoBuff_->add_firsthitorders(firstHitOrder);
+					fileProtoBuff_->add_firsthittimes(firstHitTime);
+				}
+				++lineIndex_;
+			}
+
+			//-----------------------------------------------------------------
+			// Called when all the files are visited.
+			void SetExecutedLines()
+			{
+				if (fileProtoBuff_)
+					fileProtoBuff_->set_executedlines(std::move(executedLines_));
+				fileProtoBuff_ = nullptr;
+			}
+
+			uint64_t GetLineCount() const { return lineCount_; }
+			uint64_t GetExecutedLineCount() const { return executedLineCount_; }
+
+		private:
+			const Tools::PathTable& pathTable_;
+			pb::ModuleCoverageV2& moduleProtoBuff_;
+			pb::FileCoverageV2* fileProtoBuff_ = nullptr;
+			std::string executedLines_;
+			size_t lineIndex_ = 0;
+			unsigned int previousLineNumber_ = 0;
+			uint64_t lineCount_ = 0;
+			uint64_t executedLineCount_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		// Run on the threads of the pool: pathTable is only read.
+		EncodedModule EncodeModuleV2(
+			const CppCoverage::ICoverageSource& coverageSource,
+			size_t moduleIndex,
+			const Tools::PathTable& pathTable,
+			bool isCompressed)
+		{
+			pb::ModuleCoverageV2 moduleProtoBuff;
+			const auto& modulePath = coverageSource.GetModulePath(moduleIndex);
+			const auto& identity = coverageSource.GetModuleIdentity(moduleIndex);
+			ModuleProtoBuffV2Filler filler{ pathTable, moduleProtoBuff };
+
+			moduleProtoBuff.set_pathindex(ToPathIndex(pathTable.GetId(modulePath)));
+			if (!identity.empty())
+				moduleProtoBuff.set_identity(Tools::ToUtf8String(identity));
+			coverageSource.VisitModule(moduleIndex, filler);
+			filler.SetExecutedLines();
+			return EncodeModuleV2(
+				moduleProtoBuff, modulePath, filler.GetLineCount(), filler.GetExecutedLineCount(), isCompressed);
+		}
+
+		//---------------------------------------------------------------------
+		// The paths of the files are only interned: the lines are not read.
+		class FilePathsInterner : public CppCoverage::ICoverageFileVisitor
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit FilePathsInterner(Tools::PathTable& pathTable) : pathTable_{ pathTable }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			bool OnFile(const std::filesystem::path& path, size_t) override
+			{
+				pathTable_.Intern(path);
+				return false;
+			}
+
+			//-----------------------------------------------------------------
+			void OnLine(unsigned int, bool, uint64_t, uint64_t, uint64_t) override
+			{
+			}
+
+		private:
+			Tools::PathTable& pathTable_;
+		};
+
+		//---------------------------------------------------------------------
+		// Write the header with the paths of pathTable, the modules encoded by
+		// encodeModule(moduleIndex) and the index.
+		template <typename EncodeModule>
+		void WriteV2(
+			pb::CoverageDataV2& coverageDataProtoBuff,
+			const Tools::PathTable& pathTable,
+			EncodeModule encodeModule,
+			google::protobuf::io::CodedOutputStream& codedOutputStream,
+			uint64_t& peakMessageSize)
+		{
+			coverageDataProtoBuff.mutable_paths()->Reserve(static_cast<int>(pathTable.GetCount()));
+			for (size_t id = 0; id < pathTable.GetCount(); ++id)
+				coverageDataProtoBuff.add_paths(Tools::ToUtf8String(pathTable.GetPath(id).wstring()));
+
+			// ByteCount of CodedOutputStream is an int so the offsets are computed here.
+			uint64_t offset = google::protobuf::io::CodedOutputStream::VarintSize32(
+				CoverageDataSerializer::FileTypeIdV2);
+
+			codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeIdV2);
+			offset += WriteMessage(coverageDataProtoBuff, codedOutputStream, peakMessageSize);
+
+			pb::ModuleIndexV2 moduleIndex;
+			auto moduleCount = static_cast<size_t>(coverageDataProtoBuff.modulecount());
+			std::vector<EncodedModule> encodedModules;
+
+			// The modules of a batch are encoded in parallel and written in
+			// their order.
+			moduleIndex.mutable_modules()->Reserve(static_cast<int>(moduleCount));
+			for (size_t batchStart = 0; batchStart < moduleCount; batchStart += ModuleBatchSize)
+			{
+				auto batchSize = (std::min)(ModuleBatchSize, moduleCount - batchStart);
+
+				encodedModules.clear();
+				encodedModules.resize(batchSize);
+				Tools::ParallelFor(batchSize, 1, [&](size_t i) { encodedModules[i] = encodeModule(batchStart + i); });
+				for (auto& encodedModule : encodedModules)
+				{
+					const auto& frame = encodedModule.frame_;
+					auto& indexEntry = *moduleIndex.add_modules();
+
+					codedOutputStream.WriteRaw(frame.data(), static_cast<int>(frame.size()));
+					peakMessageSize = (std::max)(peakMessageSize, encodedModule.messageSize_);
+					indexEntry = std::move(encodedModule.indexEntry_);
+					indexEntry.set_offset(offset);
+					offset += frame.size();
+				}
+			}
+
+			// The index lets a reader seek to a module from the end of the file
+			// without parsing the previous ones.
+			WriteMessage(moduleIndex, codedOutputStream, peakMessageSize);
+			codedOutputStream.WriteLittleEndian64(offset);
+			codedOutputStream.WriteLittleEndian32(CoverageDataSerializer::FileTypeIdV2);
+		}
+
+		//---------------------------------------------------------------------
+		void SerializeV2(
+			const Plugin::CoverageData& coverageData,
+			google::protobuf::io::CodedOutputStream& codedOutputStream,
+			uint64_t& peakMessageSize,
+			Content content = Content::LinesAndHits,
+			bool areModulesCompressed = false)
+		{
+			pb::CoverageDataV2 coverageDataProtoBuff;
+			Tools::PathTable pathTable;
+
+			// The path table is in the header so each path is converted once
+			// during the deserialization whatever the number of modules using it.
+			for (const auto& module : coverageData.GetModules())
+			{
+				pathTable.Intern(module->GetPath());
+				for (const auto& file : module->GetFiles())
+					pathTable.Intern(file->GetPath());
+			}
+
+			// A line table is the same for all the runs of a build.
+			coverageDataProtoBuff.set_name(content == Content::Lines ? "" : Tools::ToUtf8String(coverageData.GetName()));
+			coverageDataProtoBuff.set_exitcode(content == Content::Lines ? 0 : coverageData.GetExitCode());
+			coverageDataProtoBuff.set_modulecount(coverageData.GetModules().size());
+			if (coverageData.IsSampled())
+				coverageDataProtoBuff.set_issampled(true);
+			if (areModulesCompressed)
+				coverageDataProtoBuff.set_hascompressedmodules(true);
+
+			const auto& modules = coverageData.GetModules();
+			WriteV2(coverageDataProtoBuff,
+			        pathTable,
+			        [&](size_t moduleIndex) {
+				        return EncodeModuleV2(*modules[moduleIndex], pathTable, content, areModulesCompressed);
+			        },
+			        codedOutputStream,
+			        peakMessageSize);
+		}
+
+		//---------------------------------------------------------------------
+		// Same as SerializeV2 for the coverage read from coverageSource.
+		void SerializeV2(
+			const CppCoverage::ICoverageSource& coverageSource,
+			google::protobuf::io::CodedOutputStream& codedOutputStream,
+			uint64_t& peakMessageSize,
+			bool areModulesCompressed)
+		{
+			pb::CoverageDataV2 coverageDataProtoBuff;
+			Tools::PathTable pathTable;
+			FilePathsInterner filePathsInterner{ pathTable };
+			auto moduleCount = coverageSource.GetModuleCount();
+
+			for (size_t moduleIndex = 0; moduleIndex < moduleCount; ++moduleIndex)
+			{
+				pathTable.Intern(coverageSource.GetModulePath(moduleIndex));
+				coverageSource.VisitModule(moduleIndex, filePathsInterner);
+			}
+
+			coverageDataProtoBuff.set_name(Tools::ToUtf8String(coverageSource.GetName()));
+			coverageDataProtoBuff.set_exitcode(coverageSource.GetExitCode());
+			coverageDataProtoBuff.set_modulecount(moduleCount);
+			if (coverageSource.IsSampled())
+				coverageDataProtoBuff.set_issampled(true);
+			if (areModulesCompressed)
+				coverageDataProtoBuff.set_hascompressedmodules(true);
+			WriteV2(coverageDataProtoBuff,
+			        pathTable,
+			        [&](size_t moduleIndex) {
+				        return EncodeModuleV2(coverageSource, moduleIndex, pathTable, areModulesCompressed);
+			        },
+			        codedOutputStream,
+			        peakMessageSize);
+		}
+
+		//---------------------------------------------------------------------
+		// The modules and the files of a delta are matched by path.
+		template <typename Object>
+		std::unordered_map<std::filesystem::path::string_type, const Object*> GetByPath(
+			const std::vector<std::unique_ptr<Object>>& objects)
+		{
+			std::unordered_map<std::filesystem::path::string_type, const Object*> objectsByPath;
+
+			for (const auto& object : objects)
+			{
+				if (!objectsByPath.emplace(object->GetPath().native(), object.get()).second)
+					THROW(L"Cannot write a delta with several " << object->GetPath().wstring());
+			}
+			return objectsByPath;
+		}
+
+		//---------------------------------------------------------------------
+		bool HasFirstHits(const Plugin::FileCoverage& file)
+		{
+			const auto& lines = file.GetLines();
+
+			return std::any_of(lines.begin(), lines.end(), [](const auto& line) {
+				return line.GetFirstHitOrder() != 0;
+			});
+		}
+
+		//---------------------------------------------------------------------
+		// Return false when the file is the same as the baseline one.
+		bool FillFileDelta(
+			const Plugin::FileCoverage& file,
+			const Plugin::FileCoverage* baselineFile,
+			Tools::PathTable& pathTable,
+			pb::FileDeltaV2& fileDelta)
+		{
+			const auto& lines = file.GetLines();
+
+			if (baselineFile && !HasFirstHits(file) && !HasFirstHits(*baselineFile) &&
+			    std::equal(lines.begin(), lines.end(),
+			               baselineFile->GetLines().begin(), baselineFile->GetLines().end(),
+			               [](const auto& line1, const auto& line2) {
+				               return line1.GetLineNumber() == line2.GetLineNumber();
+			               }))
+			{
+				const auto& baselineLines = baselineFile->GetLines();
+
+				for (size_t i = 0; i < lines.size(); ++i)
+				{
+					if (lines[i].HasBeenExecuted() != baselineLines[i].HasBeenExecuted())
+						fileDelta.add_toggledlineindexes(static_cast<unsigned int>(i));
+				}
+				if (fileDelta.toggledlineindexes_size() == 0)
+					return false;
+				fileDelta.set_pathindex(ToPathIndex(pathTable.Intern(file.GetPath())));
+			}
+			else
+			{
+				auto pathIndex = ToPathIndex(pathTable.Intern(file.GetPath()));
+
+				fileDelta.set_pathindex(pathIndex);
+				InitializeProtoBuffV2From(file, pathIndex, *fileDelta.mutable_lines());
+			}
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		// Return false when the module is the same as the baseline one.
+		bool FillModuleDelta(
+			const Plugin::ModuleCoverage& module,
+			const Plugin::ModuleCoverage* baselineModule,
+			Tools::PathTable& pathTable,
+			pb::ModuleDeltaV2& moduleDelta)
+		{
+			std::unordered_map<std::filesystem::path::string_type, const Plugin::FileCoverage*> baselineFiles;
+			auto files = GetByPath(module.GetFiles());
+
+			if (baselineModule)
+				baselineFiles = GetByPath(baselineModule->GetFiles());
+			for (const auto& file : module.GetFiles())
+			{
+				auto it = baselineFiles.find(file->GetPath().native());
+				pb::FileDeltaV2 fileDelta;
+
+				if (FillFileDelta(*file, it != baselineFiles.end() ? it->second : nullptr, pathTable, fileDelta))
+					*moduleDelta.add_files() = std::move(fileDelta);
+			}
+			if (baselineModule)
+			{
+				for (const auto& baselineFile : baselineModule->GetFiles())
+				{
+					if (!files.count(baselineFile->GetPath().native()))
+						moduleDelta.add_removedfilepathindexes(ToPathIndex(pathTable.Intern(baselineFile->GetPath())));
+				}
+			}
+			const auto& baselineIdentity = baselineModule ? baselineModule->GetIdentity() : std::wstring{};
+			if (baselineIdentity != module.GetIdentity())
+				moduleDelta.set_identity(Tools::ToUtf8String(module.GetIdentity()));
+			if (baselineModule && moduleDelta.files_size() == 0 &&
+			    moduleDelta.removedfilepathindexes_size() == 0 && !moduleDelta.has_identity())
+			{
+				return false;
+			}
+			moduleDelta.set_pathindex(ToPathIndex(pathTable.Intern(module.GetPath())));
+			return true;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteDelta(
+			const Plugin::CoverageData& coverageData,
+			const Plugin::CoverageData& baseline,
+			pb::CoverageDataDeltaV2& coverageDataDelta,
+			google::protobuf::io::CodedOutputStream& codedOutputStream,
+			uint64_t& peakMessageSize)
+		{
+			Tools::PathTable pathTable;
+			std::vector<pb::ModuleDeltaV2> moduleDeltas;
+			auto baselineModules = GetByPath(baseline.GetModules());
+			auto modules = GetByPath(coverageData.GetModules());
+
+			for (const auto& module : coverageData.GetModules())
+			{
+				auto it = baselineModules.find(module->GetPath().native());
+				pb::ModuleDeltaV2 moduleDelta;
+
+				if (FillModuleDelta(*module, it != baselineModules.end() ? it->second : nullptr, pathTable, moduleDelta))
+					moduleDeltas.push_back(std::move(moduleDelta));
+			}
+			for (const auto& baselineModule : baseline.GetModules())
+			{
+				if (!modules.count(baselineModule->GetPath().native()))
+					coverageDataDelta.add_removedmodulepathindexes(ToPathIndex(pathTable.Intern(baselineModule->GetPath())));
+			}
+
+			coverageDataDelta.set_name(Tools::ToUtf8String(coverageData.GetName()));
+			coverageDataDelta.set_exitcode(coverageData.GetExitCode());
+			coverageDataDelta.set_modulecount(moduleDeltas.size());
+			for (size_t id = 0; id < pathTable.GetCount(); ++id)
+				coverageDataDelta.add_paths(Tools::ToUtf8String(pathTable.GetPath(id).wstring()));
+
+			codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeIdDelta);
+			WriteMessage(coverageDataDelta, codedOutputStream, peakMessageSize);
+			// The module deltas are kept together until they are written.
+			uint64_t moduleDeltasSize = 0;
+			for (const auto& moduleDelta : moduleDeltas)
+				moduleDeltasSize += WriteMessage(moduleDelta, codedOutputStream, peakMessageSize);
+			peakMessageSize = (std::max)(peakMessageSize, moduleDeltasSize);
 		}
 	}
 
 	//-------------------------------------------------------------------------
 	const unsigned int CoverageDataSerializer::FileTypeId = 1351727964; // random number
-	
+	const unsigned int CoverageDataSerializer::FileTypeIdV2 = 1351727965;
+	const unsigned int CoverageDataSerializer::IndexFooterSize = sizeof(uint64_t) + sizeof(uint32_t);
+	const unsigned int CoverageDataSerializer::FileTypeIdDelta = 1351727966;
+	const unsigned int CoverageDataSerializer::FileTypeIdHits = 1351727967;
+
+	//-------------------------------------------------------------------------
+	CoverageDataSerializer::CoverageDataSerializer(Version version)
+		: version_{ version }
+		, peakMessageSize_{ 0 }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataSerializer::Serialize(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output) const
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+
+		std::ofstream ofs(output.string(), std::ios::binary);
+		if (!ofs)
+			throw InvalidOutputFileException(output, "binary");
+
+		Serialize(coverageData, ofs);
+	}
+
 	//-------------------------------------------------------------------------
 	void CoverageDataSerializer::Serialize(
 		const Plugin::CoverageData& coverageData,
+		std::ostream& ostream) const
+	{
+		google::protobuf::io::OstreamOutputStream outputStream(&ostream);
+		google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
+
+		if (version_ == Version::V1)
+			SerializeV1(coverageData, codedOutputStream, peakMessageSize_);
+		else
+		{
+			SerializeV2(
+				coverageData,
+				codedOutputStream,
+				peakMessageSize_,
+				Content::LinesAndHits,
+				version_ == Version::V2Compressed);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataSerializer::Serialize(
+		const CppCoverage::ICoverageSource& coverageSource,
 		const std::filesystem::path& output) const
-	{		
-		pb::CoverageData coverageDataProtoBuff;
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+
+		std::ofstream ofs(output.string(), std::ios::binary);
+		if (!ofs)
+			throw InvalidOutputFileException(output, "binary");
+
+		Serialize(coverageSource, ofs);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataSerializer::Serialize(
+		const CppCoverage::ICoverageSource& coverageSource,
+		std::ostream& ostream) const
+	{
+		if (version_ == Version::V1)
+			THROW(L"The coverage source can only be serialized in the V2 formats.");
+
+		google::protobuf::io::OstreamOutputStream outputStream(&ostream);
+		google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
+
+		SerializeV2(coverageSource, codedOutputStream, peakMessageSize_, version_ == Version::V2Compressed);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataSerializer::SerializeDelta(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& baselinePath,
+		const std::filesystem::path& output) const
+	{
+		auto baseline = CoverageDataDeserializer{}.Deserialize(
+			baselinePath, "Cannot read the binary baseline " + baselinePath.string());
+		pb::CoverageDataDeltaV2 coverageDataDelta;
+
+		coverageDataDelta.set_baselinehash(ComputeFileHash(baselinePath));
+		coverageDataDelta.set_baselinepath(Tools::ToUtf8String(std::filesystem::absolute(baselinePath).wstring()));
+		Tools::CreateParentFolderIfNeeded(output);
+
+		std::ofstream ofs(output.string(), std::ios::binary);
+		if (!ofs)
+			throw InvalidOutputFileException(output, "binary");
+
+		google::protobuf::io::OstreamOutputStream outputStream(&ofs);
+		google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
+
+		WriteDelta(coverageData, baseline, coverageDataDelta, codedOutputStream, peakMessageSize_);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageDataSerializer::SerializeHits(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& lineTableFolder,
+		const std::filesystem::path& output) const
+	{
+		auto buildId = ComputeBuildId(coverageData);
+		auto lineTablePath = GetLineTablePath(lineTableFolder, buildId);
+
+		if (!Tools::FileExists(lineTablePath))
+		{
+			// Written to a temporary file so that a run never reads a partial line
+			// table. The runs in parallel write their own file.
+			auto temporaryPath = lineTablePath;
+			temporaryPath += L"." + std::to_wstring(GetCurrentProcessId()) + L"." +
+			                 std::to_wstring(GetCurrentThreadId()) + L".tmp";
+			try
+			{
+				Tools::CreateParentFolderIfNeeded(temporaryPath);
+				std::ofstream ofs(temporaryPath.string(), std::ios::binary);
+				if (!ofs)
+					throw InvalidOutputFileException(temporaryPath, "binary");
+
+				google::protobuf::io::OstreamOutputStream outputStream(&ofs);
+				google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
+
+				SerializeV2(coverageData, codedOutputStream, peakMessageSize_, Content::Lines);
+			}
+			catch (...)
+			{
+				std::error_code error;
+				std::filesystem::remove(temporaryPath, error);
+				throw;
+			}
+
+			// Another run can write the same line table at the same time.
+			std::error_code error;
+			std::filesystem::rename(temporaryPath, lineTablePath, error);
+			if (error)
+			{
+				std::filesystem::remove(temporaryPath, error);
+				if (!Tools::FileExists(lineTablePath))
+					throw InvalidOutputFileException(lineTablePath, "binary");
+			}
+		}
+
+		pb::CoverageDataHitsV2 coverageDataHits;
+
+		coverageDataHits.set_buildid(buildId);
+		coverageDataHits.set_linetablefolder(Tools::ToUtf8String(std::filesystem::absolute(lineTableFolder).wstring()));
+		coverageDataHits.set_name(Tools::ToUtf8String(coverageData.GetName()));
+		coverageDataHits.set_exitcode(coverageData.GetExitCode());
+		coverageDataHits.set_modulecount(coverageData.GetModules().size());
 		Tools::CreateParentFolderIfNeeded(output);
 
 		std::ofstream ofs(output.string(), std::ios::binary);
@@ -107,19 +883,76 @@ namespace Exporter
 		google::protobuf::io::OstreamOutputStream outputStream(&ofs);
 		google::protobuf::io::CodedOutputStream codedOutputStream(&outputStream);
 
-		codedOutputStream.WriteVarint32(CoverageDataSerializer::FileTypeId);
+		codedOutputStream.WriteVarint32(FileTypeIdHits);
+		WriteMessage(coverageDataHits, codedOutputStream, peakMessageSize_);
+		for (const auto& module : coverageData.GetModules())
+		{
+			pb::ModuleHitsV2 moduleHits;
+
+			for (const auto& file : module->GetFiles())
+				moduleHits.add_executedlines(GetExecutedLines(*file));
+			WriteMessage(moduleHits, codedOutputStream, peakMessageSize_);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t CoverageDataSerializer::GetPeakMessageSize() const
+	{
+		return peakMessageSize_;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t CoverageDataSerializer::ComputeFileHash(const std::filesystem::path& path)
+	{
+		auto mappedFile = Tools::MappedFile::TryCreateBinary(path);
+		uint64_t hash = Tools::Fnv1aOffsetBasis;
+
+		if (mappedFile)
+		{
+			auto content = mappedFile->GetContent();
+			hash = Tools::Fnv1a(hash, content.data(), content.size());
+		}
+		return hash;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t CoverageDataSerializer::ComputeBuildId(const Plugin::CoverageData& coverageData)
+	{
+		uint64_t hash = Tools::Fnv1aOffsetBasis;
+		auto addPath = [&hash](const std::filesystem::path& path) {
+			const auto& native = path.native();
+			// The terminating null character separates the paths.
+			hash = Tools::Fnv1a(hash, native.c_str(), (native.size() + 1) * sizeof(native[0]));
+		};
 
-		FillCoverageDataProtoBuffFrom(coverageData, coverageDataProtoBuff);
-		WriteMessage(coverageDataProtoBuff, codedOutputStream);
-				 			
-		// Here we serialize manually modules because protobuff's limit.
-		// See https://developers.google.com/protocol-buffers/docs/techniques#large-data
 		for (const auto& module : coverageData.GetModules())
 		{
-			pb::ModuleCoverage moduleProtoBuff;
-			InitializeModuleProtoBuffFrom(*module, moduleProtoBuff);
+			addPath(module->GetPath());
+			for (const auto& file : module->GetFiles())
+			{
+				const auto& lines = file->GetLines();
+				auto lineCount = static_cast<uint64_t>(lines.size());
 
-			WriteMessage(moduleProtoBuff, codedOutputStream);
+				addPath(file->GetPath());
+				hash = Tools::Fnv1a(hash, &lineCount, sizeof(lineCount));
+				for (const auto& line : lines)
+				{
+					auto lineNumber = line.GetLineNumber();
+					hash = Tools::Fnv1a(hash, &lineNumber, sizeof(lineNumber));
+				}
+			}
 		}
+		return hash;
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path CoverageDataSerializer::GetLineTablePath(
+		const std::filesystem::path& lineTableFolder,
+		uint64_t buildId)
+	{
+		std::wostringstream ostr;
+
+		ostr << L"LineTable-" << std::hex << std::setw(16) << std::setfill(L'0') << buildId << L".cov";
+		return lineTableFolder / ostr.str();
 	}
 }
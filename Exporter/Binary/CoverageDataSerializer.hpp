@@ -16,7 +16,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <iosfwd>
 #include "../ExporterExport.hpp"
 
 namespace Plugin
@@ -24,20 +26,74 @@ namespace Plugin
 	class CoverageData;
 }
 
+namespace CppCoverage
+{
+	class ICoverageSource;
+}
+
 namespace Exporter
 {
 	class EXPORTER_DLL CoverageDataSerializer
 	{
 	public:
 		const static unsigned int FileTypeId;
+		const static unsigned int FileTypeIdV2;
+		const static unsigned int IndexFooterSize;
+		const static unsigned int FileTypeIdDelta;
+		const static unsigned int FileTypeIdHits;
 
-		CoverageDataSerializer() = default;
+		enum class Version
+		{
+			V1,
+			V2, // Path table and lines stored as columns.
+			// V2 with each module in an independent gzip frame. The modules
+			// are encoded and compressed in parallel.
+			V2Compressed
+		};
+
+		explicit CoverageDataSerializer(Version = Version::V2);
 
 		void Serialize(const Plugin::CoverageData&, const std::filesystem::path&) const;
+		void Serialize(const Plugin::CoverageData&, std::ostream&) const;
+
+		// Write the same file as Serialize(CoverageData) for the coverage of
+		// the source, without building the CoverageData. V2 formats only.
+		void Serialize(const CppCoverage::ICoverageSource&, const std::filesystem::path&) const;
+		void Serialize(const CppCoverage::ICoverageSource&, std::ostream&) const;
+
+		// Write only the differences with the binary coverage file baselinePath.
+		// The delta can be read only while baselinePath is unchanged.
+		void SerializeDelta(
+			const Plugin::CoverageData&,
+			const std::filesystem::path& baselinePath,
+			const std::filesystem::path& output) const;
+
+		// Write only the executed lines, with the id of the build. The lines
+		// are written once by build in a line table of lineTableFolder.
+		void SerializeHits(
+			const Plugin::CoverageData&,
+			const std::filesystem::path& lineTableFolder,
+			const std::filesystem::path& output) const;
+
+		// Serialized size of the biggest protobuf message held since the
+		// creation of the serializer.
+		uint64_t GetPeakMessageSize() const;
+
+		// FNV-1a hash of the content, used to identify the baseline of a delta.
+		static uint64_t ComputeFileHash(const std::filesystem::path&);
+		// FNV-1a hash of the modules, the files and the lines, used to identify
+		// the line table of a build.
+		static uint64_t ComputeBuildId(const Plugin::CoverageData&);
+		static std::filesystem::path GetLineTablePath(
+			const std::filesystem::path& lineTableFolder,
+			uint64_t buildId);
 
 	private:
 		CoverageDataSerializer(const CoverageDataSerializer&) = delete;
 		CoverageDataSerializer& operator=(const CoverageDataSerializer&) = delete;
+
+		const Version version_;
+		mutable uint64_t peakMessageSize_;
 	};
 }
 
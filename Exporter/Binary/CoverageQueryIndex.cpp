@@ -0,0 +1,73 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageQueryIndex.hpp"
+
+#include <boost/algorithm/string.hpp>
+
+#include "CoverageDataReader.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::wstring GetKey(const std::filesystem::path& path)
+		{
+			return boost::algorithm::to_lower_copy(path.lexically_normal().make_preferred().wstring());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageQueryIndex::CoverageQueryIndex(const CoverageDataReader& reader)
+	{
+		// The paths are shared by the modules so each key is computed only once.
+		std::unordered_map<unsigned int, std::vector<FileCoverageEntry>*> entriesByPathIndex;
+
+		for (size_t moduleIndex = 0; moduleIndex < reader.GetModuleSummaries().size(); ++moduleIndex)
+		{
+			for (const auto& file : reader.GetFiles(moduleIndex))
+			{
+				auto& entries = entriesByPathIndex[file.GetPathIndex()];
+
+				if (!entries)
+					entries = &entriesByPath_[GetKey(reader.GetPath(file.GetPathIndex()))];
+				entries->push_back({ moduleIndex, file });
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<CoverageQueryIndex::FileCoverageEntry>&
+	CoverageQueryIndex::GetFileCoverages(const std::filesystem::path& path) const
+	{
+		static const std::vector<FileCoverageEntry> noEntries;
+		auto it = entriesByPath_.find(GetKey(path));
+
+		return it != entriesByPath_.end() ? it->second : noEntries;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<size_t> CoverageQueryIndex::GetModules(const std::filesystem::path& path) const
+	{
+		std::vector<size_t> modules;
+
+		for (const auto& entry : GetFileCoverages(path))
+			modules.push_back(entry.moduleIndex_);
+		return modules;
+	}
+}
@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+#include "FileCoverageView.hpp"
+
+namespace Exporter
+{
+	class CoverageDataReader;
+
+	// Index the files of a binary coverage file of version 2 by their path
+	// so a file can be found without reading all the modules again.
+	// The paths are compared case insensitive like Windows paths.
+	class EXPORTER_DLL CoverageQueryIndex
+	{
+	public:
+		struct FileCoverageEntry
+		{
+			size_t moduleIndex_;
+			FileCoverageView file_;
+		};
+
+		// Read all the modules of reader which must outlive the index.
+		explicit CoverageQueryIndex(const CoverageDataReader& reader);
+
+		// Return the coverage of the file in each module containing it.
+		const std::vector<FileCoverageEntry>& GetFileCoverages(const std::filesystem::path&) const;
+
+		// Return the indexes of CoverageDataReader::GetModuleSummaries containing the file.
+		std::vector<size_t> GetModules(const std::filesystem::path&) const;
+
+	private:
+		CoverageQueryIndex(const CoverageQueryIndex&) = delete;
+		CoverageQueryIndex& operator=(const CoverageQueryIndex&) = delete;
+
+		std::unordered_map<std::wstring, std::vector<FileCoverageEntry>> entriesByPath_;
+	};
+}
@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "FileCoverageView.hpp"
+
+#include <algorithm>
+#include <bitset>
+
+#include "../ExporterException.hpp"
+
+namespace Exporter
+{
+	//-------------------------------------------------------------------------
+	FileCoverageView::FileCoverageView(unsigned int pathIndex,
+	                                   std::string_view lineNumberDeltas,
+	                                   std::string_view executedLines)
+		: pathIndex_{ pathIndex }
+		, lineNumberDeltas_{ lineNumberDeltas }
+		, executedLines_{ executedLines }
+		, lineCount_{ 0 }
+	{
+		// Each varint ends with the only byte without the high bit.
+		lineCount_ = static_cast<size_t>(std::count_if(
+			lineNumberDeltas.begin(), lineNumberDeltas.end(), [](char c) {
+				return (static_cast<unsigned char>(c) & 0x80) == 0;
+			}));
+		if (!lineNumberDeltas.empty() && (static_cast<unsigned char>(lineNumberDeltas.back()) & 0x80) != 0)
+			THROW(L"Invalid line numbers.");
+		if (executedLines.size() != (lineCount_ + 7) / 8)
+			THROW(L"Invalid executed lines size.");
+	}
+
+	//-------------------------------------------------------------------------
+	unsigned int FileCoverageView::GetPathIndex() const
+	{
+		return pathIndex_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t FileCoverageView::GetLineCount() const
+	{
+		return lineCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t FileCoverageView::GetExecutedLineCount() const
+	{
+		std::bitset<8> lastByteMask{ (1u << (lineCount_ % 8 ? lineCount_ % 8 : 8)) - 1 };
+		size_t executedLineCount = 0;
+
+		for (size_t i = 0; i < executedLines_.size(); ++i)
+		{
+			std::bitset<8> byte{ static_cast<unsigned char>(executedLines_[i]) };
+
+			// Ignore the unused bits of the last byte.
+			if (i + 1 == executedLines_.size())
+				byte &= lastByteMask;
+			executedLineCount += byte.count();
+		}
+		return executedLineCount;
+	}
+
+	//-------------------------------------------------------------------------
+	bool FileCoverageView::HasBeenExecuted(size_t lineIndex) const
+	{
+		if (lineIndex >= lineCount_)
+			THROW(L"Invalid line index: " << lineIndex);
+		return (static_cast<unsigned char>(executedLines_[lineIndex / 8]) & (1 << (lineIndex % 8))) != 0;
+	}
+}
@@ -0,0 +1,74 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string_view>
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	// Read only view of a file stored in a binary coverage file of version 2.
+	// The view points into the mapping of CoverageDataReader and is valid
+	// until the reader is destroyed.
+	class EXPORTER_DLL FileCoverageView
+	{
+	public:
+		FileCoverageView(unsigned int pathIndex,
+		                 std::string_view lineNumberDeltas,
+		                 std::string_view executedLines);
+
+		unsigned int GetPathIndex() const;
+		size_t GetLineCount() const;
+		size_t GetExecutedLineCount() const;
+
+		// lineIndex is the position of the line in the file, not its number.
+		bool HasBeenExecuted(size_t lineIndex) const;
+
+		// Decode the line numbers, function is called with
+		// (unsigned int lineNumber, bool hasBeenExecuted) in the order of the lines.
+		template <typename Function>
+		void ForEachLine(Function function) const
+		{
+			unsigned int lineNumber = 0;
+			unsigned int delta = 0;
+			int shift = 0;
+			size_t lineIndex = 0;
+
+			for (auto c : lineNumberDeltas_)
+			{
+				auto byte = static_cast<unsigned char>(c);
+
+				delta |= static_cast<unsigned int>(byte & 0x7F) << shift;
+				shift += 7;
+				if ((byte & 0x80) == 0)
+				{
+					lineNumber += delta;
+					function(lineNumber, HasBeenExecuted(lineIndex++));
+					delta = 0;
+					shift = 0;
+				}
+			}
+		}
+
+	private:
+		unsigned int pathIndex_;
+		std::string_view lineNumberDeltas_; // packed varints
+		std::string_view executedLines_;
+		size_t lineCount_;
+	};
+}
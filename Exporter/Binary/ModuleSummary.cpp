@@ -0,0 +1,57 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ModuleSummary.hpp"
+
+namespace Exporter
+{
+	//-------------------------------------------------------------------------
+	ModuleSummary::ModuleSummary(const std::filesystem::path& path,
+	                             size_t fileCount,
+	                             size_t lineCount,
+	                             size_t executedLineCount)
+		: path_{ path }
+		, fileCount_{ fileCount }
+		, lineCount_{ lineCount }
+		, executedLineCount_{ executedLineCount }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	const std::filesystem::path& ModuleSummary::GetPath() const
+	{
+		return path_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ModuleSummary::GetFileCount() const
+	{
+		return fileCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ModuleSummary::GetLineCount() const
+	{
+		return lineCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ModuleSummary::GetExecutedLineCount() const
+	{
+		return executedLineCount_;
+	}
+}
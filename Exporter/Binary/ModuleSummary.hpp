@@ -0,0 +1,45 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	// Counts of a module stored in the index of a binary coverage file.
+	class EXPORTER_DLL ModuleSummary
+	{
+	public:
+		ModuleSummary(const std::filesystem::path& path,
+		              size_t fileCount,
+		              size_t lineCount,
+		              size_t executedLineCount);
+
+		const std::filesystem::path& GetPath() const;
+		size_t GetFileCount() const;
+		size_t GetLineCount() const;
+		size_t GetExecutedLineCount() const;
+
+	private:
+		std::filesystem::path path_;
+		size_t fileCount_;
+		size_t lineCount_;
+		size_t executedLineCount_;
+	};
+}
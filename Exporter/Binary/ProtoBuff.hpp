@@ -20,8 +20,10 @@
 
 #pragma warning(disable: 4244) // conversion from '__int64' to 'int', possible loss of data
 
+#include <google/protobuf/arena.h>
 #include <google/protobuf/io/coded_stream.h>
 #include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/wire_format_lite.h>
 
 #pragma warning(pop)
 
@@ -16,9 +16,13 @@
 
 #include "stdafx.h"
 
-#include <unordered_set>
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/xml_parser.hpp>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <set>
+#include <sstream>
 #include <filesystem>
 
 #include "CoberturaExporter.hpp"
@@ -28,144 +32,324 @@
 #include "Plugin/Exporter/LineCoverage.hpp"
 #include "CppCoverage/CoverageRateComputer.hpp"
 #include "InvalidOutputFileException.hpp"
+#include "Html/HtmlEscape.hpp"
+#include "ReportWriter.hpp"
 
 #include "Tools/Tool.hpp"
+#include "Tools/ThreadPool.hpp"
 
-namespace property_tree = boost::property_tree;
 namespace fs = std::filesystem;
 
 namespace Exporter
 {
 	namespace
 	{
+		// The classes are rendered by groups: the memory used does not depend
+		// on the size of the coverage data.
+		const size_t ClassGroupSize = 1024;
+		const size_t MinClassCountByWorker = 16;
+
+		//-------------------------------------------------------------------------
+		std::string ToUtf8String(const fs::path& path)
+		{
+			return Tools::ToUtf8String(path.wstring());
+		}
+
+		//-------------------------------------------------------------------------
+		void AppendIndent(std::string& output, int depth)
+		{
+			output.append(static_cast<size_t>(depth) * 2, ' ');
+		}
+
+		//-------------------------------------------------------------------------
+		template <typename T>
+		void AppendNumber(std::string& output, T value)
+		{
+			char buffer[32];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			output.append(buffer, result.ptr);
+		}
+
+		//-------------------------------------------------------------------------
+		// Same format as the previous boost::property_tree writer: shortest
+		// representation with all the significant digits.
+		void AppendNumber(std::string& output, double value)
+		{
+			char buffer[32];
+			auto result = std::to_chars(
+			    buffer, buffer + sizeof(buffer), value,
+			    std::chars_format::general, std::numeric_limits<double>::max_digits10);
+			output.append(buffer, result.ptr);
+		}
+
 		//-------------------------------------------------------------------------
-		property_tree::wptree& AddChild(property_tree::wptree& tree, const std::wstring& name)
+		void AppendAttribute(std::string& output, std::string_view name, std::string_view value)
 		{
-			return tree.add_child(name, property_tree::wptree{});
+			output += ' ';
+			output.append(name.data(), name.size());
+			output += "=\"";
+			AppendHtmlEscaped(output, value);
+			output += '"';
 		}
 
 		//-------------------------------------------------------------------------
-		std::wstring ToUft8WString(const fs::path& path)
+		template <typename T>
+		void AppendNumberAttribute(std::string& output, std::string_view name, T value)
 		{
-			auto str = Tools::ToUtf8String(path.wstring());
-			auto utf8Str = Tools::LocalToWString(str);
-			return utf8Str;
+			output += ' ';
+			output.append(name.data(), name.size());
+			output += "=\"";
+			AppendNumber(output, value);
+			output += '"';
 		}
 
 		//-------------------------------------------------------------------------
-		void SetCoverage(
-			property_tree::wptree& node,
+		void AppendCoverage(
+			std::string& output,
 			const CppCoverage::CoverageRate& coverageRate)
 		{
-			node.put(L"<xmlattr>.line-rate", coverageRate.GetRate());
-			node.put(L"<xmlattr>.branch-rate", 0);
-			node.put(L"<xmlattr>.complexity", 0);
+			AppendNumberAttribute(output, "line-rate", coverageRate.GetRate());
+			output += " branch-rate=\"0\" complexity=\"0\"";
 		}
 
 		//-------------------------------------------------------------------------
-		void FillFileTree(
+		void AppendClass(
+			std::string& output,
 			const CppCoverage::CoverageRateComputer& coverageRateComputer,
-			property_tree::wptree& fileTree, 
 			const Plugin::FileCoverage& file)
 		{
 			const auto& path = file.GetPath();
-			auto res = path.relative_path();
-			const auto& coverageRate = coverageRateComputer.GetCoverageRate(file);
-
-			fileTree.put(L"<xmlattr>.name", ToUft8WString(path.filename()));
-			fileTree.put(L"<xmlattr>.filename", ToUft8WString(path.relative_path()));
-			SetCoverage(fileTree, coverageRate);
-			AddChild(fileTree, L"methods");
-
-			property_tree::wptree& linesTree = AddChild(fileTree, L"lines");
-
-			for (const auto& line : file.GetLines())
+			const auto& lines = file.GetLines();
+
+			AppendIndent(output, 4);
+			output += "<class";
+			AppendAttribute(output, "name", ToUtf8String(path.filename()));
+			AppendAttribute(output, "filename", ToUtf8String(path.relative_path()));
+			AppendCoverage(output, coverageRateComputer.GetCoverageRate(file));
+			output += ">\n";
+			AppendIndent(output, 5);
+			output += "<methods/>\n";
+			AppendIndent(output, 5);
+			if (lines.empty())
+				output += "<lines/>\n";
+			else
 			{
-				property_tree::wptree& lineTree = AddChild(linesTree, L"line");
-
-				lineTree.put(L"<xmlattr>.number", std::to_wstring(line.GetLineNumber()));
-				lineTree.put(L"<xmlattr>.hits", line.HasBeenExecuted() ? L"1" : L"0");
+				output += "<lines>\n";
+				for (const auto& line : lines)
+				{
+					auto hits = line.HasBeenExecuted()
+					                ? std::max<uint64_t>(line.GetHitCount(), 1)
+					                : 0;
+
+					AppendIndent(output, 6);
+					output += "<line";
+					AppendNumberAttribute(output, "number", line.GetLineNumber());
+					AppendNumberAttribute(output, "hits", hits);
+					output += "/>\n";
+				}
+				AppendIndent(output, 5);
+				output += "</lines>\n";
 			}
+			AppendIndent(output, 4);
+			output += "</class>\n";
 		}
 
 		//-------------------------------------------------------------------------
-		void WriteSourceRoots(
-			const Plugin::CoverageData& coverageData,
-			property_tree::wptree& coverageTree)
+		void Write(std::ostream& ostream, const std::string& content)
 		{
-			std::unordered_set<std::wstring> rootPaths;
+			ostream.write(content.data(), static_cast<std::streamsize>(content.size()));
+		}
 
-			for (const auto& module : coverageData.GetModules())
+		//-------------------------------------------------------------------------
+		void AppendSourceRoots(
+			std::string& output,
+			const std::vector<const Plugin::ModuleCoverage*>& packages)
+		{
+			std::set<std::string> rootPaths;
+
+			for (const auto* module : packages)
 			{
 				for (const auto& file : module->GetFiles())
+					rootPaths.insert(ToUtf8String(file->GetPath().root_name()));
+			}
+
+			AppendIndent(output, 1);
+			if (rootPaths.empty())
+			{
+				output += "<sources/>\n";
+				return;
+			}
+			output += "<sources>\n";
+			for (const auto& rootPath : rootPaths)
+			{
+				AppendIndent(output, 2);
+				if (rootPath.empty())
+					output += "<source/>\n";
+				else
 				{
-					const auto& path = file->GetPath();
-					rootPaths.insert(path.root_name().wstring());
+					output += "<source>";
+					AppendHtmlEscaped(output, rootPath);
+					output += "</source>\n";
 				}
 			}
+			AppendIndent(output, 1);
+			output += "</sources>\n";
+		}
 
-			auto& sourcesTree = AddChild(coverageTree, L"sources");
+		//-------------------------------------------------------------------------
+		// 0 for the deterministic reports.
+		int64_t GetTimestamp(bool isDeterministic)
+		{
+			if (isDeterministic)
+				return 0;
 
-			for (const auto& rootPath : rootPaths)
-				sourcesTree.add(L"source", rootPath);
+			auto now = std::chrono::system_clock::now();
+			return std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
 		}
 
 		//-------------------------------------------------------------------------
-		void SetCoverageAttributes(property_tree::wptree& coverageTree,
-		                           const CppCoverage::CoverageRate& coverageRate)
+		void AppendCoverageElement(
+			std::string& output,
+			const CppCoverage::CoverageRate& coverageRate,
+			int64_t timestamp)
 		{
-			coverageTree.put(L"<xmlattr>.branches-covered", 0);
-			coverageTree.put(L"<xmlattr>.branches-valid", 0);
+			output += "<coverage";
+			AppendCoverage(output, coverageRate);
+			output += " branches-covered=\"0\" branches-valid=\"0\"";
+			AppendNumberAttribute(output, "timestamp", timestamp);
+			AppendNumberAttribute(output, "lines-covered", coverageRate.GetExecutedLinesCount());
+			AppendNumberAttribute(output, "lines-valid", coverageRate.GetTotalLinesCount());
+			output += " version=\"0\">\n";
+		}
 
-			auto now = std::chrono::system_clock::now();
-			auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
-			coverageTree.put(L"<xmlattr>.timestamp", timestamp);
-			coverageTree.put(L"<xmlattr>.lines-covered",
-			                 coverageRate.GetExecutedLinesCount());
-			coverageTree.put(L"<xmlattr>.lines-valid",
-			                 coverageRate.GetTotalLinesCount());
-			coverageTree.put(L"<xmlattr>.version", 0);
+		enum class PackageContent
+		{
+			// The coverage of the packages without their classes.
+			Summary,
+			Classes,
+			ClassesInParallel
+		};
+
+		//-------------------------------------------------------------------------
+		void WritePackage(
+			std::ostream& ostream,
+			const CppCoverage::CoverageRateComputer& coverageRateComputer,
+			const Plugin::ModuleCoverage& module,
+			PackageContent packageContent)
+		{
+			std::string output;
+			const auto& files = module.GetFiles();
+
+			AppendIndent(output, 2);
+			output += "<package";
+			AppendAttribute(output, "name", ToUtf8String(module.GetPath()));
+			AppendCoverage(output, coverageRateComputer.GetCoverageRate(module));
+			output += ">\n";
+			AppendIndent(output, 3);
+			if (packageContent == PackageContent::Summary)
+			{
+				output += "<classes/>\n";
+				AppendIndent(output, 2);
+				output += "</package>\n";
+				Write(ostream, output);
+				return;
+			}
+			output += "<classes>\n";
+			Write(ostream, output);
+
+			// The classes of a group are rendered on several threads and
+			// written in order.
+			auto minClassCountByWorker = packageContent == PackageContent::ClassesInParallel
+			    ? MinClassCountByWorker : ClassGroupSize + 1;
+			std::vector<std::string> classes;
+			for (size_t first = 0; first < files.size(); first += ClassGroupSize)
+			{
+				auto count = (std::min)(ClassGroupSize, files.size() - first);
+
+				classes.resize(count);
+				Tools::ParallelFor(count, minClassCountByWorker, [&](size_t i) {
+					classes[i].clear();
+					AppendClass(classes[i], coverageRateComputer, *files[first + i]);
+				});
+				for (size_t i = 0; i < count; ++i)
+					Write(ostream, classes[i]);
+			}
+
+			output.clear();
+			AppendIndent(output, 3);
+			output += "</classes>\n";
+			AppendIndent(output, 2);
+			output += "</package>\n";
+			Write(ostream, output);
 		}
 
 		//-------------------------------------------------------------------------
-		void FillCoverageTree(
-			property_tree::wptree& root,
-			const Plugin::CoverageData& coverageData)
+		void WriteReport(
+			std::ostream& ostream,
+			const CppCoverage::CoverageRateComputer& coverageRateComputer,
+			const CppCoverage::CoverageRate& coverageRate,
+			int64_t timestamp,
+			const std::vector<const Plugin::ModuleCoverage*>& packages,
+			PackageContent packageContent)
 		{
-			CppCoverage::CoverageRateComputer coverageRateComputer(coverageData);
-			auto& coverageTree = AddChild(root, L"coverage");
-			const auto& coverageRate = coverageRateComputer.GetCoverageRate();
-			SetCoverage(coverageTree, coverageRate);
-			SetCoverageAttributes(coverageTree, coverageRate);
+			std::string output = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n";
+
+			AppendCoverageElement(output, coverageRate, timestamp);
+			AppendSourceRoots(output, packages);
+			AppendIndent(output, 1);
+			output += packages.empty() ? "<packages/>\n" : "<packages>\n";
+			Write(ostream, output);
 
-			WriteSourceRoots(coverageData, coverageTree);
+			for (const auto* module : packages)
+				WritePackage(ostream, coverageRateComputer, *module, packageContent);
 
-			property_tree::wptree& packagesTree = AddChild(coverageTree, L"packages");
+			output.clear();
+			if (!packages.empty())
+			{
+				AppendIndent(output, 1);
+				output += "</packages>\n";
+			}
+			output += "</coverage>\n";
+			Write(ostream, output);
+			ostream.flush();
+		}
+
+		//-------------------------------------------------------------------------
+		std::vector<const Plugin::ModuleCoverage*> GetPackages(const Plugin::CoverageData& coverageData)
+		{
+			std::vector<const Plugin::ModuleCoverage*> packages;
 
+			// Do not create package if no files exists -> Coverage will not be visible by module
 			for (const auto& module : coverageData.GetModules())
 			{
-				// Do not create package if no files exists -> Coverage will not be visible by module
 				if (!module->GetFiles().empty())
-				{
-					property_tree::wptree& packageTree = AddChild(packagesTree, L"package");
-					property_tree::wptree& classesTree = AddChild(packageTree, L"classes");
-					const auto& coverageRate = coverageRateComputer.GetCoverageRate(*module);
-
-					packageTree.put(L"<xmlattr>.name", ToUft8WString(module->GetPath()));
-					SetCoverage(packageTree, coverageRate);
-
-					for (const auto& file : module->GetFiles())
-					{
-						property_tree::wptree& fileTree = AddChild(classesTree, L"class");
-						FillFileTree(coverageRateComputer, fileTree, *file);
-					}
-				}
+					packages.push_back(module.get());
 			}
+			return packages;
+		}
+
+		//-------------------------------------------------------------------------
+		template <typename Function>
+		void WriteFile(const fs::path& path, Function writeReport)
+		{
+			std::ofstream ofs{ path, std::ios::binary };
+
+			if (!ofs)
+				throw InvalidOutputFileException(path, "cobertura");
+			writeReport(ofs);
 		}
 	}
 
 	//-------------------------------------------------------------------------
-	CoberturaExporter::CoberturaExporter() = default;
+	CoberturaExporter::CoberturaExporter(
+		size_t packageCountByFile,
+		CppCoverage::ReportCompression compression,
+		bool isDeterministic)
+		: packageCountByFile_{ packageCountByFile }
+		, compression_{ compression }
+		, isDeterministic_{ isDeterministic }
+	{
+	}
 
 	//-------------------------------------------------------------------------
 	std::filesystem::path CoberturaExporter::GetDefaultPath(const std::wstring& prefix) const
@@ -177,18 +361,86 @@ namespace Exporter
 		return path;		
 	}
 
+	//-------------------------------------------------------------------------
+	fs::path CoberturaExporter::GetFilePath(const fs::path& output, size_t index)
+	{
+		auto filename = output.stem();
+
+		filename += "-" + std::to_string(index + 1);
+		filename += output.extension();
+		return output.parent_path() / filename;
+	}
+
 	//-------------------------------------------------------------------------
 	void CoberturaExporter::Export(
 		const Plugin::CoverageData& coverageData, 
 		const std::filesystem::path& output)
+	{
+		CppCoverage::CoverageRateComputer coverageRateComputer(coverageData);
+
+		Export(coverageData, coverageRateComputer, output);
+	}
+
+	//-------------------------------------------------------------------------
+	void CoberturaExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const CppCoverage::CoverageRateComputer& coverageRateComputer,
+		const std::filesystem::path& output)
 	{
 		Tools::CreateParentFolderIfNeeded(output);
-		std::wofstream ofs{ output.string().c_str() };
 
-		if (!ofs)
-			throw InvalidOutputFileException(output, "cobertura");
-		Export(coverageData, ofs);
+		auto packages = GetPackages(coverageData);
+		auto packageContent = PackageContent::ClassesInParallel;
+		auto timestamp = GetTimestamp(isDeterministic_);
+
+		if (packageCountByFile_)
+		{
+			auto fileCount = (packages.size() + packageCountByFile_ - 1) / packageCountByFile_;
+
+			// The files are rendered on several threads.
+			Tools::ParallelFor(fileCount, 1, [&](size_t i) {
+				auto first = packages.begin() + i * packageCountByFile_;
+				auto last = packages.begin() + (std::min)((i + 1) * packageCountByFile_, packages.size());
+				std::vector<const Plugin::ModuleCoverage*> filePackages{ first, last };
+				CppCoverage::CoverageRate coverageRate;
+
+				for (const auto* module : filePackages)
+					coverageRate += coverageRateComputer.GetCoverageRate(*module);
+
+				auto path = GetFilePath(output, i);
+				WriteFile(path, [&](std::ostream& ostream) {
+					WriteReport(ostream, coverageRateComputer, coverageRate, timestamp, filePackages, PackageContent::Classes);
+				});
+				ReportWriter::CompressFile(path, compression_, isDeterministic_);
+			});
+			packageContent = PackageContent::Summary;
+		}
+
+		WriteFile(output, [&](std::ostream& ostream) {
+			WriteReport(ostream, coverageRateComputer, coverageRateComputer.GetCoverageRate(), timestamp, packages, packageContent);
+		});
 		Tools::ShowOutputMessage(L"Cobertura report generated: ", output);
+		if (compression_ != CppCoverage::ReportCompression::None)
+		{
+			Tools::ShowOutputMessage(L"Report compressed in ",
+			    ReportWriter::CompressFile(output, compression_, isDeterministic_));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CoberturaExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		std::ostream& ostream) const
+	{
+		CppCoverage::CoverageRateComputer coverageRateComputer(coverageData);
+
+		WriteReport(
+			ostream,
+			coverageRateComputer,
+			coverageRateComputer.GetCoverageRate(),
+			GetTimestamp(isDeterministic_),
+			GetPackages(coverageData),
+			PackageContent::ClassesInParallel);
 	}
 
 	//-------------------------------------------------------------------------
@@ -196,12 +448,9 @@ namespace Exporter
 		const Plugin::CoverageData& coverageData,
 		std::wostream& ostream) const
 	{
-		using Ptree = property_tree::wptree;
-		Ptree root;
-		
-		FillCoverageTree(root, coverageData);
+		std::ostringstream ostr;
 
-		property_tree::xml_writer_settings<Ptree::key_type> settings(' ', 2);
-		property_tree::xml_parser::write_xml(ostream, root, settings);
+		Export(coverageData, ostr);
+		ostream << Tools::LocalToWString(ostr.str());
 	}
 }
@@ -21,6 +21,7 @@
 
 #include "ExporterExport.hpp"
 #include "IExporter.hpp"
+#include "CppCoverage/ReportCompression.hpp"
 
 namespace Plugin
 {
@@ -32,15 +33,36 @@ namespace Exporter
 	class EXPORTER_DLL CoberturaExporter: public IExporter
 	{
 	public:
-		CoberturaExporter() ;
+		// When packageCountByFile is not 0, the classes are written in files of
+		// packageCountByFile packages named by GetFilePath and the report only
+		// contains the coverage of the packages. The timestamp of a
+		// deterministic report is 0.
+		explicit CoberturaExporter(
+			size_t packageCountByFile = 0,
+			CppCoverage::ReportCompression = CppCoverage::ReportCompression::None,
+			bool isDeterministic = false);
+
+		// <output folder>/<output stem>-<index + 1><output extension>
+		static std::filesystem::path GetFilePath(const std::filesystem::path& output, size_t index);
 
 		std::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
 		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& output) override;
+		// The report is written in UTF-8 while it is rendered, without building
+		// the whole document in memory.
+		void Export(const Plugin::CoverageData&, std::ostream&) const;
 		void Export(const Plugin::CoverageData&, std::wostream&) const;
 
 	private:
 		CoberturaExporter(const CoberturaExporter&) = delete;
 		CoberturaExporter& operator=(const CoberturaExporter&) = delete;
+
+		const size_t packageCountByFile_;
+		const CppCoverage::ReportCompression compression_;
+		const bool isDeterministic_;
 	};
 }
 
@@ -0,0 +1,316 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageImporter.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <string_view>
+#include <vector>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "ExporterException.hpp"
+#include "XmlReader.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		// The format is guessed from this number of bytes.
+		const size_t HeaderSize = 4096;
+		const std::string_view Utf8Bom = "\xEF\xBB\xBF";
+
+		// Hit count by line number, for each file of a module.
+		using LinesByFile = std::map<fs::path, std::map<unsigned int, uint64_t>>;
+
+		//-------------------------------------------------------------------------
+		bool StartsWith(std::string_view text, std::string_view prefix)
+		{
+			return text.substr(0, prefix.size()) == prefix;
+		}
+
+		//-------------------------------------------------------------------------
+		std::string_view Trim(std::string_view text)
+		{
+			const std::string_view spaces = " \t\r\n";
+			auto first = text.find_first_not_of(spaces);
+
+			if (first == std::string_view::npos)
+				return {};
+			return text.substr(first, text.find_last_not_of(spaces) - first + 1);
+		}
+
+		//-------------------------------------------------------------------------
+		// Some tools write the counts as decimal numbers: the fraction is ignored.
+		template <typename T>
+		bool TryParseNumber(std::string_view text, T& number)
+		{
+			auto last = text.data() + text.size();
+			auto result = std::from_chars(text.data(), last, number);
+
+			return result.ec == std::errc{} && (result.ptr == last || *result.ptr == '.');
+		}
+
+		//-------------------------------------------------------------------------
+		void AddModule(Plugin::CoverageData& coverageData, const fs::path& path, const LinesByFile& files)
+		{
+			if (files.empty())
+				return;
+
+			auto& module = coverageData.AddModule(path);
+			module.ReserveFiles(files.size());
+			for (const auto& file : files)
+			{
+				std::vector<Plugin::LineCoverage> lines;
+
+				lines.reserve(file.second.size());
+				for (const auto& line : file.second)
+					lines.emplace_back(line.first, line.second > 0, line.second);
+				module.AddFile(file.first).SetLines(std::move(lines));
+			}
+		}
+
+		//-------------------------------------------------------------------------
+		const std::string& GetAttribute(const XmlReader& reader, std::string_view name)
+		{
+			const auto* value = reader.FindAttribute(name);
+
+			if (!value)
+			{
+				THROW(L"Missing attribute " << Tools::Utf8ToWString(std::string{ name })
+				      << L" of the element " << Tools::Utf8ToWString(reader.GetName()) << L".");
+			}
+			return *value;
+		}
+
+		//-------------------------------------------------------------------------
+		template <typename T>
+		T GetNumberAttribute(const XmlReader& reader, std::string_view name)
+		{
+			const auto& value = GetAttribute(reader, name);
+			T number = 0;
+
+			if (!TryParseNumber(value, number))
+			{
+				THROW(L"Invalid attribute " << Tools::Utf8ToWString(std::string{ name })
+				      << L": " << Tools::Utf8ToWString(value));
+			}
+			return number;
+		}
+
+		//-------------------------------------------------------------------------
+		// The same file is written a/b or a\.\b by different tools.
+		fs::path NormalizePath(const fs::path& path)
+		{
+			return path.lexically_normal().make_preferred();
+		}
+
+		//-------------------------------------------------------------------------
+		// The first of the sources where filename exists, computed once by
+		// filename while the sources are unchanged.
+		fs::path GetFilePath(const std::vector<fs::path>& sources,
+		                     std::map<fs::path, fs::path>& filePaths,
+		                     const fs::path& filename)
+		{
+			if (filename.is_absolute() || sources.empty())
+				return NormalizePath(filename);
+
+			auto it = filePaths.find(filename);
+			if (it != filePaths.end())
+				return it->second;
+
+			std::vector<fs::path> paths;
+			for (auto source : sources)
+			{
+				// The cobertura export writes the drive as a source.
+				if (source.has_root_name() && !source.has_root_directory())
+					source += fs::path::preferred_separator;
+				paths.push_back(NormalizePath(source / filename));
+			}
+
+			auto existingPath = std::find_if(paths.begin(), paths.end(), [](const fs::path& path) {
+				return Tools::FileExists(path);
+			});
+			auto filePath = existingPath != paths.end() ? *existingPath : paths.front();
+			return filePaths.emplace(filename, filePath).first->second;
+		}
+
+		//-------------------------------------------------------------------------
+		Plugin::CoverageData ImportCobertura(std::istream& istream, const std::wstring& name)
+		{
+			using Node = XmlReader::Node;
+			Plugin::CoverageData coverageData{ name, 0 };
+			XmlReader reader{ istream };
+			std::vector<fs::path> sources;
+			std::map<fs::path, fs::path> filePaths;
+			std::string source;
+			std::optional<fs::path> packagePath;
+			LinesByFile packageFiles;
+			std::map<unsigned int, uint64_t>* classLines = nullptr;
+			size_t methodsDepth = 0;
+			auto isInSource = false;
+
+			for (auto node = reader.Read(); node != Node::End; node = reader.Read())
+			{
+				const auto& element = reader.GetName();
+
+				if (node == Node::Text)
+				{
+					if (isInSource)
+						source += reader.GetText();
+				}
+				else if (node == Node::StartElement)
+				{
+					if (element == "source")
+					{
+						isInSource = true;
+						source.clear();
+					}
+					else if (element == "package")
+					{
+						packagePath = Tools::Utf8ToWString(GetAttribute(reader, "name"));
+						packageFiles.clear();
+					}
+					else if (element == "class" && packagePath)
+					{
+						auto filename = Tools::Utf8ToWString(GetAttribute(reader, "filename"));
+						classLines = &packageFiles[GetFilePath(sources, filePaths, filename)];
+					}
+					else if (element == "methods")
+						++methodsDepth;
+					else if (element == "line" && classLines && !methodsDepth)
+					{
+						auto& hitCount = (*classLines)[GetNumberAttribute<unsigned int>(reader, "number")];
+						hitCount = (std::max)(hitCount, GetNumberAttribute<uint64_t>(reader, "hits"));
+					}
+				}
+				else if (element == "source")
+				{
+					isInSource = false;
+					auto trimmedSource = Trim(source);
+					if (!trimmedSource.empty())
+					{
+						sources.emplace_back(Tools::Utf8ToWString(std::string{ trimmedSource }));
+						filePaths.clear();
+					}
+				}
+				else if (element == "package" && packagePath)
+				{
+					AddModule(coverageData, *packagePath, packageFiles);
+					packagePath.reset();
+				}
+				else if (element == "class")
+					classLines = nullptr;
+				else if (element == "methods")
+					--methodsDepth;
+			}
+			return coverageData;
+		}
+
+		//-------------------------------------------------------------------------
+		Plugin::CoverageData ImportLcov(std::istream& istream, const std::wstring& name)
+		{
+			Plugin::CoverageData coverageData{ name, 0 };
+			LinesByFile files;
+			std::map<unsigned int, uint64_t>* fileLines = nullptr;
+			std::string line;
+
+			for (size_t lineNumber = 1; std::getline(istream, line); ++lineNumber)
+			{
+				auto record = Trim(line);
+
+				if (StartsWith(record, "SF:"))
+					fileLines = &files[NormalizePath(Tools::Utf8ToWString(std::string{ record.substr(3) }))];
+				else if (record == "end_of_record")
+					fileLines = nullptr;
+				else if (StartsWith(record, "DA:") && fileLines)
+				{
+					// DA:<line number>,<hit count>[,<checksum>]
+					auto fields = record.substr(3);
+					auto separator = fields.find(',');
+					auto hitCountField = separator == std::string_view::npos
+					    ? std::string_view{} : fields.substr(separator + 1);
+					unsigned int number = 0;
+					uint64_t hitCount = 0;
+
+					if (!TryParseNumber(fields.substr(0, separator), number) ||
+					    !TryParseNumber(hitCountField.substr(0, hitCountField.find(',')), hitCount))
+					{
+						THROW(L"Invalid LCOV record at line " << lineNumber << L": " << Tools::Utf8ToWString(line));
+					}
+					(*fileLines)[number] += hitCount;
+				}
+			}
+			AddModule(coverageData, name, files);
+			return coverageData;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::optional<CoverageImporter::Format> CoverageImporter::GetFormat(const fs::path& path)
+	{
+		std::ifstream ifs{ path, std::ios::binary };
+		std::string header(HeaderSize, '\0');
+
+		ifs.read(&header[0], static_cast<std::streamsize>(header.size()));
+		header.resize(static_cast<size_t>(ifs.gcount()));
+
+		std::string_view content{ header };
+		if (StartsWith(content, Utf8Bom))
+			content.remove_prefix(Utf8Bom.size());
+		content = Trim(content);
+
+		if ((StartsWith(content, "<?xml") || StartsWith(content, "<!") || StartsWith(content, "<coverage")) &&
+		    content.find("<coverage") != std::string_view::npos)
+		{
+			return Format::Cobertura;
+		}
+		if (StartsWith(content, "TN:") || StartsWith(content, "SF:"))
+			return Format::Lcov;
+		return std::nullopt;
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageImporter::Import(const fs::path& path, Format format) const
+	{
+		std::ifstream ifs{ path, std::ios::binary };
+
+		if (!ifs)
+			THROW(L"Cannot open " << path.wstring());
+		return Import(ifs, format, path.filename().wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData CoverageImporter::Import(
+		std::istream& istream,
+		Format format,
+		const std::wstring& name) const
+	{
+		if (format == Format::Cobertura)
+			return ImportCobertura(istream, name);
+		return ImportLcov(istream, name);
+	}
+}
@@ -0,0 +1,62 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <iosfwd>
+#include <optional>
+#include <string>
+
+#include "ExporterExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Read the reports of the other coverage tools while they are parsed,
+	// without a document in memory.
+	// Cobertura: a package is a module, the lines of the methods are ignored
+	// and the lines of the classes of a file are merged with their highest
+	// hit count. The relative filenames are completed with the first source
+	// where the file exists, or the first source.
+	// LCOV: the files of the tracefile are in a single module named after
+	// the tracefile, and the hits of the records of a file are added.
+	class EXPORTER_DLL CoverageImporter
+	{
+	public:
+		enum class Format
+		{
+			Cobertura,
+			Lcov
+		};
+
+		CoverageImporter() = default;
+
+		// Guessed from the beginning of the file, none for the other files.
+		static std::optional<Format> GetFormat(const std::filesystem::path&);
+
+		Plugin::CoverageData Import(const std::filesystem::path&, Format) const;
+		Plugin::CoverageData Import(std::istream&, Format, const std::wstring& name) const;
+
+	private:
+		CoverageImporter(const CoverageImporter&) = delete;
+		CoverageImporter& operator=(const CoverageImporter&) = delete;
+	};
+}
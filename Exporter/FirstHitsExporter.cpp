@@ -0,0 +1,111 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+#include "FirstHitsExporter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <tuple>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "InvalidOutputFileException.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		//-------------------------------------------------------------------------
+		struct FirstHit
+		{
+			uint64_t order_;
+			uint64_t time_;
+			const Plugin::ModuleCoverage* module_;
+			const Plugin::FileCoverage* file_;
+			unsigned int lineNumber_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path FirstHitsExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		std::filesystem::path path{ prefix };
+
+		path += "FirstHits.txt";
+
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	void FirstHitsExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output)
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+		std::wofstream ofs{ output.string().c_str() };
+
+		if (!ofs)
+			throw InvalidOutputFileException(output, "first hits");
+		Export(coverageData, ofs);
+		Tools::ShowOutputMessage(L"First hits report generated: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	void FirstHitsExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		std::wostream& ostream) const
+	{
+		std::vector<FirstHit> firstHits;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			for (const auto& file : module->GetFiles())
+			{
+				for (const auto& line : file->GetLines())
+				{
+					if (line.GetFirstHitOrder())
+					{
+						firstHits.push_back({line.GetFirstHitOrder(),
+						                     line.GetFirstHitTime(),
+						                     module.get(),
+						                     file.get(),
+						                     line.GetLineNumber()});
+					}
+				}
+			}
+		}
+
+		std::sort(firstHits.begin(), firstHits.end(), [](const auto& firstHit1, const auto& firstHit2) {
+			return std::tie(firstHit1.order_, firstHit1.lineNumber_) <
+			       std::tie(firstHit2.order_, firstHit2.lineNumber_);
+		});
+
+		ostream << L"Order\tTime (us)\tModule\tFile\tLine\n";
+		for (const auto& firstHit : firstHits)
+		{
+			ostream << firstHit.order_ << L'\t' << firstHit.time_ << L'\t'
+			        << firstHit.module_->GetPath().wstring() << L'\t'
+			        << firstHit.file_->GetPath().wstring() << L'\t'
+			        << firstHit.lineNumber_ << L'\n';
+		}
+	}
+}
@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#pragma once
+
+#include <iosfwd>
+#include <filesystem>
+
+#include "ExporterExport.hpp"
+#include "IExporter.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Executed lines sorted by their first hit, one line by row:
+	// <order>\t<time in microseconds>\t<module>\t<file>\t<line>
+	class EXPORTER_DLL FirstHitsExporter: public IExporter
+	{
+	public:
+		FirstHitsExporter() = default;
+
+		std::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(const Plugin::CoverageData&, std::wostream&) const;
+
+	private:
+		FirstHitsExporter(const FirstHitsExporter&) = delete;
+		FirstHitsExporter& operator=(const FirstHitsExporter&) = delete;
+	};
+}
@@ -0,0 +1,314 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CompactHtmlExporter.hpp"
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "Tools/MappedFile.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/Tool.hpp"
+#include "Tools/ThreadPool.hpp"
+
+#include "../ReportWriter.hpp"
+#include "HtmlEscape.hpp"
+
+namespace fs = std::filesystem;
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		struct SourceEntry
+		{
+			const Plugin::FileCoverage* file_;
+			int bundle_;
+			size_t offset_;
+			size_t size_;
+		};
+
+		//---------------------------------------------------------------------
+		struct ModuleEntry
+		{
+			const Plugin::ModuleCoverage* module_;
+			std::vector<SourceEntry> sources_;
+		};
+
+		//---------------------------------------------------------------------
+		std::string ToBase64(const std::string& data)
+		{
+			const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+			std::string base64;
+
+			base64.reserve((data.size() + 2) / 3 * 4);
+			for (size_t i = 0; i < data.size(); i += 3)
+			{
+				auto byteCount = (std::min)(data.size() - i, size_t{3});
+				uint32_t value = static_cast<unsigned char>(data[i]) << 16;
+
+				if (byteCount > 1)
+					value |= static_cast<unsigned char>(data[i + 1]) << 8;
+				if (byteCount > 2)
+					value |= static_cast<unsigned char>(data[i + 2]);
+				base64 += alphabet[(value >> 18) & 0x3F];
+				base64 += alphabet[(value >> 12) & 0x3F];
+				base64 += (byteCount > 1) ? alphabet[(value >> 6) & 0x3F] : '=';
+				base64 += (byteCount > 2) ? alphabet[value & 0x3F] : '=';
+			}
+			return base64;
+		}
+
+		//---------------------------------------------------------------------
+		void AddJsonPath(std::string& json, const fs::path& path)
+		{
+			AppendJsonString(json, Tools::ToUtf8String(path.wstring()));
+		}
+
+		//---------------------------------------------------------------------
+		// The bundles are filled in the order of the files with their size on
+		// the disk. The actual offsets are set when the bundles are written.
+		std::vector<std::vector<SourceEntry*>> CreateSourceBundles(
+			std::vector<ModuleEntry>& modules,
+			const Tools::SourceFileCache& sourceFileCache)
+		{
+			std::vector<std::vector<SourceEntry*>> bundles;
+			size_t bundleSize = 0;
+
+			for (auto& module : modules)
+			{
+				for (auto& source : module.sources_)
+				{
+					auto path = sourceFileCache.GetLocalPath(source.file_->GetPath());
+					if (!Tools::FileExists(path))
+						continue;
+
+					std::error_code error;
+					auto fileSize = static_cast<size_t>(fs::file_size(path, error));
+					if (error)
+						fileSize = 0;
+					if (bundles.empty() || (!bundles.back().empty() && 
+						bundleSize + fileSize > CompactHtmlExporter::SourceBundleSize))
+					{
+						bundles.emplace_back();
+						bundleSize = 0;
+					}
+					source.bundle_ = static_cast<int>(bundles.size() - 1);
+					bundles.back().push_back(&source);
+					bundleSize += fileSize;
+				}
+			}
+			return bundles;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteSourceBundle(
+			ReportWriter& reportWriter,
+			Tools::SourceFileCache& sourceFileCache,
+			const fs::path& sourcesFolder,
+			size_t bundleIndex,
+			const std::vector<SourceEntry*>& sources)
+		{
+			std::string content;
+
+			for (auto* source : sources)
+			{
+				source->offset_ = content.size();
+				if (auto mappedFile = sourceFileCache.TryGet(source->file_->GetPath()))
+				{
+					auto fileContent = mappedFile->GetContent();
+					content.append(fileContent.data(), fileContent.size());
+				}
+				source->size_ = content.size() - source->offset_;
+			}
+
+			auto bundleName = std::to_string(bundleIndex);
+			reportWriter.WriteFile(
+				sourcesFolder / (bundleName + ".js"), 
+				"OpenCppCoverage.addSourceBundle(" + bundleName + ", \"" + ToBase64(ReportWriter::Gzip(content)) + "\");\n");
+		}
+
+		//---------------------------------------------------------------------
+		// The bundles of a previous export would not be referenced anymore.
+		// The other files of the folder are kept.
+		void RemoveStaleBundles(const fs::path& sourcesFolder, size_t bundleCount)
+		{
+			std::vector<fs::path> staleBundles;
+			std::error_code error;
+
+			for (fs::directory_iterator it{ sourcesFolder, error }, end; !error && it != end; it.increment(error))
+			{
+				const auto& path = it->path();
+				auto stem = path.stem().string();
+				auto isBundle = path.extension() == ".js" && !stem.empty() && stem.size() < 20 &&
+					std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; });
+
+				if (isBundle && std::stoull(stem) >= bundleCount)
+					staleBundles.push_back(path);
+			}
+			for (const auto& staleBundle : staleBundles)
+				fs::remove(staleBundle, error);
+		}
+
+		//---------------------------------------------------------------------
+		std::string CreateIndex(
+			const Plugin::CoverageData& coverageData,
+			const std::vector<ModuleEntry>& modules)
+		{
+			std::string json = "{\"title\":";
+
+			AppendJsonString(json, Tools::ToUtf8String(coverageData.GetName()));
+			json += ",\"version\":";
+			AppendJsonString(json, OPENCPPCOVERAGE_VERSION);
+			json += ",\"exitCode\":" + std::to_string(coverageData.GetExitCode());
+			json += ",\"modules\":[";
+			for (const auto& module : modules)
+			{
+				if (&module != &modules.front())
+					json += ',';
+				json += "{\"path\":";
+				AddJsonPath(json, module.module_->GetPath());
+				json += ",\"files\":[";
+				for (const auto& source : module.sources_)
+				{
+					if (&source != &module.sources_.front())
+						json += ',';
+					json += "{\"path\":";
+					AddJsonPath(json, source.file_->GetPath());
+					json += ",\"lines\":\"" + ToBase64(CompactHtmlExporter::CreateCoverageBitmap(*source.file_)) + '"';
+					json += ",\"bundle\":" + std::to_string(source.bundle_);
+					json += ",\"offset\":" + std::to_string(source.offset_);
+					json += ",\"size\":" + std::to_string(source.size_) + '}';
+				}
+				json += "]}";
+			}
+			json += "]}";
+			return json;
+		}
+	}
+
+	const std::string CompactHtmlExporter::ViewerTemplateFilename = "CompactViewer.html";
+	const std::string CompactHtmlExporter::IndexFilename = "coverage.js";
+	const std::string CompactHtmlExporter::SourcesFolder = "sources";
+	const size_t CompactHtmlExporter::SourceBundleSize = 1024 * 1024;
+
+	//-------------------------------------------------------------------------
+	CompactHtmlExporter::CompactHtmlExporter(
+		const fs::path& templateFolder,
+		cov::ReportCompression compression,
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache,
+		bool isDeterministic)
+		: templateFolder_{ templateFolder }
+		, compression_{ compression }
+		, sourceFileCache_{ sourceFileCache ? sourceFileCache : std::make_shared<Tools::SourceFileCache>() }
+		, isDeterministic_{ isDeterministic }
+		, peakBufferedSize_{ 0 }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	IExporter::BufferSizes CompactHtmlExporter::GetPeakBufferSizes() const
+	{
+		return {{"Exporter buffers", peakBufferedSize_}};
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path CompactHtmlExporter::GetDefaultPath(const std::wstring&) const
+	{
+		auto now = std::time(nullptr);
+		auto localNow = std::localtime(&now);
+		std::ostringstream ostr;
+
+		ostr << "CompactCoverageReport-" << std::put_time(localNow, "%Y-%m-%d-%Hh%Mm%Ss");
+
+		return ostr.str();
+	}
+
+	//-------------------------------------------------------------------------
+	void CompactHtmlExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const fs::path& outputFolder)
+	{
+		auto sourcesFolder = outputFolder / SourcesFolder;
+		std::vector<ModuleEntry> modules;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			ModuleEntry moduleEntry{ module.get(), {} };
+
+			for (const auto& file : module->GetFiles())
+			{
+				if (!file->GetLines().empty())
+					moduleEntry.sources_.push_back(SourceEntry{ file.get(), -1, 0, 0 });
+			}
+			if (!moduleEntry.sources_.empty())
+				modules.push_back(std::move(moduleEntry));
+		}
+
+		auto isZip = compression_ == cov::ReportCompression::Zip;
+		ReportWriter reportWriter{ outputFolder, compression_, isDeterministic_ };
+		if (!isZip)
+			fs::create_directories(sourcesFolder);
+
+		auto bundles = CreateSourceBundles(modules, *sourceFileCache_);
+		Tools::ParallelFor(bundles.size(), 1, [&](size_t i) {
+			WriteSourceBundle(reportWriter, *sourceFileCache_, sourcesFolder, i, bundles[i]);
+		});
+		if (!isZip)
+			RemoveStaleBundles(sourcesFolder, bundles.size());
+
+		reportWriter.WriteFile(
+			outputFolder / IndexFilename,
+			"OpenCppCoverage.setIndex(\"" + ToBase64(ReportWriter::Gzip(CreateIndex(coverageData, modules))) + "\");\n");
+		reportWriter.CopyFile(templateFolder_ / ViewerTemplateFilename, outputFolder / "index.html");
+		auto output = reportWriter.Close();
+		peakBufferedSize_ = reportWriter.GetPeakBufferedSize();
+		Tools::ShowOutputMessage(isZip ? L"Coverage generated in " : L"Coverage generated in Folder ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	std::string CompactHtmlExporter::CreateCoverageBitmap(const Plugin::FileCoverage& file)
+	{
+		unsigned int lastLineNumber = 0;
+
+		for (const auto& line : file.GetLines())
+			lastLineNumber = (std::max)(lastLineNumber, line.GetLineNumber());
+
+		std::string bitmap((lastLineNumber + 3) / 4, '\0');
+		for (const auto& line : file.GetLines())
+		{
+			if (!line.GetLineNumber())
+				continue;
+			auto index = line.GetLineNumber() - 1;
+			auto bits = line.HasBeenExecuted() ? 3 : 1;
+
+			bitmap[index / 4] |= static_cast<char>(bits << (index % 4 * 2));
+		}
+		return bitmap;
+	}
+}
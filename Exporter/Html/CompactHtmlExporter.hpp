@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include "../ExporterExport.hpp"
+#include "../IExporter.hpp"
+#include "CppCoverage/ReportCompression.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+	class FileCoverage;
+}
+
+namespace Tools
+{
+	class SourceFileCache;
+}
+
+namespace Exporter
+{
+	// Single page report: the viewer page loads the coverage index and
+	// fetches the sources on demand. The index and the sources are stored
+	// gzip compressed in scripts so the report also works from the disk:
+	//   index.html           The viewer.
+	//   coverage.js          The modules, the files and their coverage bitmaps.
+	//   sources/<bundle>.js  The content of several source files.
+	class EXPORTER_DLL CompactHtmlExporter: public IExporter
+	{
+	public:
+		static const std::string ViewerTemplateFilename;
+		static const std::string IndexFilename;
+		static const std::string SourcesFolder;
+		// Maximum uncompressed size of a bundle, except for bigger source files.
+		static const size_t SourceBundleSize;
+
+	public:
+		// The sources are read from sourceFileCache, or from a cache owned by
+		// the exporter when it is null.
+		explicit CompactHtmlExporter(
+			const std::filesystem::path& templateFolder,
+			CppCoverage::ReportCompression = CppCoverage::ReportCompression::None,
+			std::shared_ptr<Tools::SourceFileCache> sourceFileCache = nullptr,
+			bool isDeterministic = false);
+
+		std::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& outputFolder) override;
+		BufferSizes GetPeakBufferSizes() const override;
+
+		// Two bits by line starting at line 1: executable line and executed line.
+		// Four lines by byte, the first line in the least significant bits.
+		static std::string CreateCoverageBitmap(const Plugin::FileCoverage&);
+
+	private:
+		CompactHtmlExporter(const CompactHtmlExporter&) = delete;
+		CompactHtmlExporter& operator=(const CompactHtmlExporter&) = delete;
+
+	private:
+		std::filesystem::path templateFolder_;
+		const CppCoverage::ReportCompression compression_;
+		const std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
+		const bool isDeterministic_;
+		size_t peakBufferedSize_;
+	};
+}
@@ -0,0 +1,362 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CppSyntaxHighlighter.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+#include "HtmlEscape.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		// Sorted for the binary search.
+		const std::string_view Keywords[] = {
+			"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "bool",
+			"break", "case", "catch", "char", "char16_t", "char32_t", "char8_t", "class",
+			"co_await", "co_return", "co_yield", "compl", "concept", "const", "const_cast",
+			"consteval", "constexpr", "constinit", "continue", "decltype", "default", "delete",
+			"do", "double", "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+			"false", "final", "float", "for", "friend", "goto", "if", "inline", "int", "long",
+			"mutable", "namespace", "new", "noexcept", "not", "not_eq", "nullptr", "operator",
+			"or", "or_eq", "override", "private", "protected", "public", "register",
+			"reinterpret_cast", "requires", "return", "short", "signed", "sizeof", "static",
+			"static_assert", "static_cast", "struct", "switch", "template", "this",
+			"thread_local", "throw", "true", "try", "typedef", "typeid", "typename", "union",
+			"unsigned", "using", "virtual", "void", "volatile", "wchar_t", "while", "xor",
+			"xor_eq" };
+
+		const std::string_view StringPrefixes[] = { "L", "LR", "R", "U", "UR", "u", "u8", "u8R", "uR" };
+		const std::string_view Punctuations = "!#%&()*+,-./:;<=>?[]^{|}~";
+		const size_t MaxRawStringDelimiterSize = 16;
+
+		//---------------------------------------------------------------------
+		// Write the consecutive tokens of the same class in the same span.
+		class SpanWriter
+		{
+		public:
+			explicit SpanWriter(std::string& output)
+				: output_{ output }
+				, openClass_{ nullptr }
+			{
+			}
+
+			~SpanWriter()
+			{
+				Close();
+			}
+
+			void Append(std::string_view token, const std::string* cssClass, bool isBlank)
+			{
+				// The blanks have no color: they do not close the current span.
+				if (cssClass != openClass_ && !isBlank)
+				{
+					Close();
+					if (cssClass)
+						output_ += "<span class=\"" + *cssClass + "\">";
+					openClass_ = cssClass;
+				}
+				AppendHtmlEscaped(output_, token);
+			}
+
+			void Close()
+			{
+				if (openClass_)
+					output_ += "</span>";
+				openClass_ = nullptr;
+			}
+
+		private:
+			SpanWriter(const SpanWriter&) = delete;
+			SpanWriter& operator=(const SpanWriter&) = delete;
+
+			std::string& output_;
+			const std::string* openClass_;
+		};
+
+		//---------------------------------------------------------------------
+		bool IsSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+		}
+
+		//---------------------------------------------------------------------
+		bool IsDigit(char c)
+		{
+			return c >= '0' && c <= '9';
+		}
+
+		//---------------------------------------------------------------------
+		bool IsUpper(char c)
+		{
+			return c >= 'A' && c <= 'Z';
+		}
+
+		//---------------------------------------------------------------------
+		bool IsLower(char c)
+		{
+			return c >= 'a' && c <= 'z';
+		}
+
+		//---------------------------------------------------------------------
+		// The bytes of the UTF-8 sequences are part of the identifiers.
+		bool IsIdentifierStart(char c)
+		{
+			return IsUpper(c) || IsLower(c) || c == '_' || static_cast<unsigned char>(c) >= 0x80;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsIdentifierChar(char c)
+		{
+			return IsIdentifierStart(c) || IsDigit(c);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsPunctuation(char c)
+		{
+			return Punctuations.find(c) != std::string_view::npos;
+		}
+
+		//---------------------------------------------------------------------
+		bool Contains(std::string_view line, size_t position, std::string_view text)
+		{
+			return line.compare(position, text.size(), text) == 0;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsKeyword(std::string_view identifier)
+		{
+			return std::binary_search(std::begin(Keywords), std::end(Keywords), identifier);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsStringPrefix(std::string_view identifier)
+		{
+			return std::find(std::begin(StringPrefixes), std::end(StringPrefixes), identifier)
+				!= std::end(StringPrefixes);
+		}
+
+		//---------------------------------------------------------------------
+		// Same rule as prettify: capital letters followed by a lower case
+		// letter, or a name ending with _t.
+		bool IsType(std::string_view identifier)
+		{
+			size_t i = identifier[0] == '_' ? 1 : 0;
+			auto upperBegin = i;
+
+			while (i < identifier.size() && IsUpper(identifier[i]))
+				++i;
+			if (i > upperBegin && i < identifier.size() && IsLower(identifier[i]))
+				return true;
+			return identifier.size() > 2 && identifier.substr(identifier.size() - 2) == "_t";
+		}
+
+		//---------------------------------------------------------------------
+		// Return the position after the closing quote or the end of the line.
+		size_t FindQuotedEnd(std::string_view line, size_t begin, char quote)
+		{
+			for (auto i = begin; i < line.size(); ++i)
+			{
+				if (line[i] == '\\')
+					++i;
+				else if (line[i] == quote)
+					return i + 1;
+			}
+			return line.size();
+		}
+
+		//---------------------------------------------------------------------
+		size_t FindNumberEnd(std::string_view line, size_t begin)
+		{
+			auto i = begin + 1;
+
+			while (i < line.size())
+			{
+				auto c = line[i];
+				auto isExponentSign = (c == '+' || c == '-')
+					&& std::string_view{ "eEpP" }.find(line[i - 1]) != std::string_view::npos;
+
+				if (!IsIdentifierChar(c) && c != '.' && c != '\'' && !isExponentSign)
+					break;
+				++i;
+			}
+			return i;
+		}
+
+		//---------------------------------------------------------------------
+		// Return the position after text or npos.
+		size_t FindEnd(std::string_view line, size_t begin, std::string_view text)
+		{
+			auto position = line.find(text, begin);
+
+			return position == std::string_view::npos ? position : position + text.size();
+		}
+
+		//---------------------------------------------------------------------
+		size_t FindPunctuationEnd(std::string_view line, size_t begin)
+		{
+			auto i = begin + 1;
+
+			while (i < line.size() && IsPunctuation(line[i])
+				&& !Contains(line, i, "//") && !Contains(line, i, "/*")
+				&& !(line[i] == '.' && i + 1 < line.size() && IsDigit(line[i + 1])))
+			{
+				++i;
+			}
+			return i;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string CppSyntaxHighlighter::KeywordClass = "kwd";
+	const std::string CppSyntaxHighlighter::TypeClass = "typ";
+	const std::string CppSyntaxHighlighter::StringClass = "str";
+	const std::string CppSyntaxHighlighter::CommentClass = "com";
+	const std::string CppSyntaxHighlighter::LiteralClass = "lit";
+	const std::string CppSyntaxHighlighter::PunctuationClass = "pun";
+
+	//-------------------------------------------------------------------------
+	CppSyntaxHighlighter::CppSyntaxHighlighter()
+		: state_{ State::Code }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void CppSyntaxHighlighter::AppendLine(std::string& output, std::string_view line)
+	{
+		SpanWriter writer{ output };
+		size_t i = 0;
+
+		if (state_ != State::Code)
+		{
+			auto isComment = state_ == State::BlockComment;
+			auto end = FindEnd(line, 0, isComment ? std::string_view{ "*/" } : rawStringEnd_);
+
+			writer.Append(line.substr(0, end), isComment ? &CommentClass : &StringClass, false);
+			if (end == std::string_view::npos)
+				return;
+			state_ = State::Code;
+			i = end;
+		}
+
+		auto isLineStart = i == 0;
+		auto isInclude = false;
+		while (i < line.size())
+		{
+			auto c = line[i];
+			auto tokenEnd = i + 1;
+			const std::string* cssClass = nullptr;
+
+			if (IsSpace(c))
+			{
+				while (tokenEnd < line.size() && IsSpace(line[tokenEnd]))
+					++tokenEnd;
+			}
+			else if (c == '#' && isLineStart)
+			{
+				while (tokenEnd < line.size() && IsSpace(line[tokenEnd]))
+					++tokenEnd;
+				auto directiveBegin = tokenEnd;
+				while (tokenEnd < line.size() && IsIdentifierChar(line[tokenEnd]))
+					++tokenEnd;
+				auto directive = line.substr(directiveBegin, tokenEnd - directiveBegin);
+				isInclude = directive == "include" || directive == "import";
+				cssClass = &CommentClass;
+			}
+			else if (Contains(line, i, "//"))
+			{
+				tokenEnd = line.size();
+				cssClass = &CommentClass;
+			}
+			else if (Contains(line, i, "/*"))
+			{
+				tokenEnd = FindEnd(line, i + 2, "*/");
+				if (tokenEnd == std::string_view::npos)
+				{
+					state_ = State::BlockComment;
+					tokenEnd = line.size();
+				}
+				cssClass = &CommentClass;
+			}
+			else if (c == '<' && isInclude)
+			{
+				tokenEnd = FindEnd(line, i + 1, ">");
+				if (tokenEnd == std::string_view::npos)
+					tokenEnd = line.size();
+				cssClass = &StringClass;
+			}
+			else if (IsDigit(c) || (c == '.' && i + 1 < line.size() && IsDigit(line[i + 1])))
+			{
+				tokenEnd = FindNumberEnd(line, i);
+				cssClass = &LiteralClass;
+			}
+			else if (c == '"' || c == '\'')
+			{
+				tokenEnd = FindQuotedEnd(line, i + 1, c);
+				cssClass = &StringClass;
+			}
+			else if (IsIdentifierStart(c))
+			{
+				while (tokenEnd < line.size() && IsIdentifierChar(line[tokenEnd]))
+					++tokenEnd;
+				auto identifier = line.substr(i, tokenEnd - i);
+				auto quote = tokenEnd < line.size() ? line[tokenEnd] : '\0';
+
+				if ((quote == '"' || quote == '\'') && IsStringPrefix(identifier))
+				{
+					auto delimiterEnd = line.find('(', tokenEnd + 1);
+					auto isRawString = identifier.back() == 'R' && quote == '"'
+						&& delimiterEnd != std::string_view::npos
+						&& delimiterEnd - tokenEnd - 1 <= MaxRawStringDelimiterSize;
+
+					if (isRawString)
+					{
+						rawStringEnd_ = ")";
+						rawStringEnd_ += line.substr(tokenEnd + 1, delimiterEnd - tokenEnd - 1);
+						rawStringEnd_ += '"';
+						tokenEnd = FindEnd(line, delimiterEnd + 1, rawStringEnd_);
+						if (tokenEnd == std::string_view::npos)
+						{
+							state_ = State::RawString;
+							tokenEnd = line.size();
+						}
+					}
+					else
+						tokenEnd = FindQuotedEnd(line, tokenEnd + 1, quote);
+					cssClass = &StringClass;
+				}
+				else if (IsKeyword(identifier))
+					cssClass = &KeywordClass;
+				else if (IsType(identifier))
+					cssClass = &TypeClass;
+			}
+			else if (IsPunctuation(c))
+			{
+				tokenEnd = FindPunctuationEnd(line, i);
+				cssClass = &PunctuationClass;
+			}
+
+			auto isBlank = IsSpace(c);
+			if (!isBlank)
+				isLineStart = false;
+			writer.Append(line.substr(i, tokenEnd - i), cssClass, isBlank);
+			i = tokenEnd;
+		}
+	}
+}
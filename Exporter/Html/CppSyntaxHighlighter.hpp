@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	// Tokenize C++ sources and write the tokens in spans with the classes of
+	// google-code-prettify, so the pages are highlighted without running
+	// prettify in the browser.
+	class EXPORTER_DLL CppSyntaxHighlighter
+	{
+	public:
+		static const std::string KeywordClass;
+		static const std::string TypeClass;
+		static const std::string StringClass;
+		static const std::string CommentClass;
+		static const std::string LiteralClass;
+		static const std::string PunctuationClass;
+
+	public:
+		CppSyntaxHighlighter();
+
+		// Append the escaped line with its highlighting spans. All the spans
+		// are closed at the end of the line: a comment or a raw string on
+		// several lines is continued by the next call.
+		void AppendLine(std::string& output, std::string_view line);
+
+	private:
+		CppSyntaxHighlighter(const CppSyntaxHighlighter&) = delete;
+		CppSyntaxHighlighter& operator=(const CppSyntaxHighlighter&) = delete;
+
+		enum class State
+		{
+			Code,
+			BlockComment,
+			RawString
+		};
+
+		State state_;
+		std::string rawStringEnd_;
+	};
+}
@@ -0,0 +1,242 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "DiffHtmlExporter.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+
+#include "Tools/MappedFile.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/Tool.hpp"
+
+#include "../InvalidOutputFileException.hpp"
+#include "../ReportWriter.hpp"
+#include "HtmlEscape.hpp"
+
+namespace fs = std::filesystem;
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		const char* Style =
+			"body{font-family:sans-serif;margin:1em}"
+			"table{border-collapse:collapse}"
+			"td,th{padding:0 .5em;text-align:left}"
+			".src td{font-family:monospace;white-space:pre}"
+			".src td:first-child{text-align:right;color:#888}"
+			".hunk td{background:#eef;color:#558}"
+			".c{background:#dfd}.u{background:#fdd}";
+
+		//---------------------------------------------------------------------
+		std::string ToPercent(const cov::CoverageRate& coverageRate)
+		{
+			return std::to_string(coverageRate.GetPercentRate()) + '%';
+		}
+
+		//---------------------------------------------------------------------
+		void AppendSummaryRow(
+			std::string& html,
+			const std::string& name,
+			const cov::CoverageRate& coverageRate)
+		{
+			html += "<tr><td>" + name + "</td><td>";
+			html += std::to_string(coverageRate.GetExecutedLinesCount()) + '/';
+			html += std::to_string(coverageRate.GetTotalLinesCount());
+			html += "</td><td>" + ToPercent(coverageRate) + "</td></tr>\n";
+		}
+
+		//---------------------------------------------------------------------
+		void AppendFile(
+			std::string& html,
+			Tools::SourceFileCache& sourceFileCache,
+			const Plugin::FileCoverage& file,
+			const cov::CoverageRate& coverageRate,
+			size_t fileIndex)
+		{
+			std::map<unsigned int, bool> executedByLine;
+			for (const auto& line : file.GetLines())
+				executedByLine[line.GetLineNumber()] |= line.HasBeenExecuted();
+
+			html += "<h2 id=\"f" + std::to_string(fileIndex) + "\">";
+			AppendHtmlEscaped(html, Tools::ToUtf8String(file.GetPath().wstring()));
+			html += " (" + ToPercent(coverageRate) + ")</h2>\n";
+
+			auto mappedFile = sourceFileCache.TryGet(file.GetPath());
+			if (!mappedFile)
+				html += "<p>Source file not found.</p>\n";
+			auto isUtf8 = !mappedFile || IsUtf8(mappedFile->GetContent());
+			std::string utf8Line;
+
+			html += "<table class=\"src\">\n";
+			for (const auto& hunk : DiffHtmlExporter::ComputeHunks(file, DiffHtmlExporter::ContextLineCount))
+			{
+				auto lastLineNumber = hunk.lastLineNumber_;
+				if (mappedFile)
+				{
+					auto lineCount = static_cast<unsigned int>(mappedFile->GetLines().size());
+					lastLineNumber = (std::min)(lastLineNumber, (std::max)(lineCount, executedByLine.rbegin()->first));
+				}
+				html += "<tr class=\"hunk\"><td></td><td>@@ +" + std::to_string(hunk.firstLineNumber_) + ',';
+				html += std::to_string(lastLineNumber - hunk.firstLineNumber_ + 1) + " @@</td></tr>\n";
+
+				for (auto lineNumber = hunk.firstLineNumber_; lineNumber <= lastLineNumber; ++lineNumber)
+				{
+					auto it = executedByLine.find(lineNumber);
+					if (it == executedByLine.end())
+						html += "<tr>";
+					else
+						html += it->second ? "<tr class=\"c\">" : "<tr class=\"u\">";
+					html += "<td>" + std::to_string(lineNumber) + "</td><td>";
+					if (mappedFile && lineNumber <= mappedFile->GetLines().size())
+					{
+						auto line = mappedFile->GetLines()[lineNumber - 1];
+						AppendHtmlEscaped(html, isUtf8 ? line : AnsiToUtf8(line, utf8Line));
+					}
+					html += "</td></tr>\n";
+				}
+			}
+			html += "</table>\n";
+		}
+	}
+
+	const unsigned int DiffHtmlExporter::ContextLineCount = 3;
+
+	//-------------------------------------------------------------------------
+	DiffHtmlExporter::DiffHtmlExporter(
+		cov::ReportCompression compression,
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache,
+		bool isDeterministic)
+		: compression_{ compression }
+		, sourceFileCache_{ sourceFileCache ? sourceFileCache : std::make_shared<Tools::SourceFileCache>() }
+		, isDeterministic_{ isDeterministic }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path DiffHtmlExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		fs::path path{ prefix };
+
+		path += "DiffCoverage.html";
+
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	void DiffHtmlExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const fs::path& output)
+	{
+		cov::CoverageRateComputer coverageRateComputer(coverageData);
+
+		Export(coverageData, coverageRateComputer, output);
+	}
+
+	//-------------------------------------------------------------------------
+	void DiffHtmlExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const fs::path& output)
+	{
+		std::vector<const Plugin::FileCoverage*> files;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			for (const auto& file : module->GetFiles())
+			{
+				if (!file->GetLines().empty())
+					files.push_back(file.get());
+			}
+		}
+
+		std::string html = "<!DOCTYPE html>\n<html><head><meta charset=\"utf-8\"><title>";
+		AppendHtmlEscaped(html, Tools::ToUtf8String(coverageData.GetName()));
+		html += "</title><style>";
+		html += Style;
+		html += "</style></head><body>\n<h1>Diff coverage: ";
+		AppendHtmlEscaped(html, Tools::ToUtf8String(coverageData.GetName()));
+		html += "</h1>\n<table>\n<tr><th>File</th><th>Lines</th><th>Rate</th></tr>\n";
+		for (size_t i = 0; i < files.size(); ++i)
+		{
+			std::string name = "<a href=\"#f" + std::to_string(i) + "\">";
+			AppendHtmlEscaped(name, Tools::ToUtf8String(files[i]->GetPath().wstring()));
+			name += "</a>";
+			AppendSummaryRow(html, name, coverageRateComputer.GetCoverageRate(*files[i]));
+		}
+		AppendSummaryRow(html, "<b>Total</b>", coverageRateComputer.GetCoverageRate());
+		html += "</table>\n";
+
+		for (size_t i = 0; i < files.size(); ++i)
+			AppendFile(html, *sourceFileCache_, *files[i], coverageRateComputer.GetCoverageRate(*files[i]), i);
+		html += "</body></html>\n";
+
+		Tools::CreateParentFolderIfNeeded(output);
+		{
+			std::ofstream ofs{ output, std::ios::binary };
+
+			if (!ofs)
+				throw InvalidOutputFileException(output, "diff HTML");
+			ofs.write(html.data(), static_cast<std::streamsize>(html.size()));
+		}
+		Tools::ShowOutputMessage(L"Diff coverage report generated: ", output);
+		if (compression_ != cov::ReportCompression::None)
+		{
+			Tools::ShowOutputMessage(L"Report compressed in ",
+			    ReportWriter::CompressFile(output, compression_, isDeterministic_));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<DiffHtmlExporter::Hunk> DiffHtmlExporter::ComputeHunks(
+		const Plugin::FileCoverage& file,
+		unsigned int contextLineCount)
+	{
+		std::vector<unsigned int> lineNumbers;
+
+		for (const auto& line : file.GetLines())
+		{
+			if (line.GetLineNumber())
+				lineNumbers.push_back(line.GetLineNumber());
+		}
+		std::sort(lineNumbers.begin(), lineNumbers.end());
+
+		std::vector<Hunk> hunks;
+		for (auto lineNumber : lineNumbers)
+		{
+			auto firstLineNumber = (lineNumber > contextLineCount) ? lineNumber - contextLineCount : 1;
+			auto lastLineNumber = lineNumber + contextLineCount;
+
+			if (!hunks.empty() && firstLineNumber <= hunks.back().lastLineNumber_ + 1)
+				hunks.back().lastLineNumber_ = (std::max)(hunks.back().lastLineNumber_, lastLineNumber);
+			else
+				hunks.push_back(Hunk{ firstLineNumber, lastLineNumber });
+		}
+		return hunks;
+	}
+}
@@ -0,0 +1,85 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+#include "../IExporter.hpp"
+#include "CppCoverage/ReportCompression.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+	class FileCoverage;
+}
+
+namespace Tools
+{
+	class SourceFileCache;
+}
+
+namespace Exporter
+{
+	// Single HTML file with only the hunks of the executable lines and their
+	// coverage. With --unified_diff, the executable lines are the changed
+	// lines so the report is the coverage of the diff, with a summary of the
+	// covered changed lines by file.
+	class EXPORTER_DLL DiffHtmlExporter: public IExporter
+	{
+	public:
+		// Lines shown before and after the executable lines of a hunk.
+		static const unsigned int ContextLineCount;
+
+		struct Hunk
+		{
+			unsigned int firstLineNumber_;
+			unsigned int lastLineNumber_;
+		};
+
+	public:
+		// The sources are read from sourceFileCache, or from a cache owned by
+		// the exporter when it is null.
+		explicit DiffHtmlExporter(
+			CppCoverage::ReportCompression = CppCoverage::ReportCompression::None,
+			std::shared_ptr<Tools::SourceFileCache> sourceFileCache = nullptr,
+			bool isDeterministic = false);
+
+		std::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& output) override;
+
+		// The executable lines with contextLineCount lines around them, the
+		// overlapping or adjacent ranges merged. The last hunk may end after
+		// the end of the file.
+		static std::vector<Hunk> ComputeHunks(const Plugin::FileCoverage&, unsigned int contextLineCount);
+
+	private:
+		DiffHtmlExporter(const DiffHtmlExporter&) = delete;
+		DiffHtmlExporter& operator=(const DiffHtmlExporter&) = delete;
+
+	private:
+		const CppCoverage::ReportCompression compression_;
+		const std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
+		const bool isDeterministic_;
+	};
+}
@@ -0,0 +1,131 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "HtmlEscape.hpp"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define OPENCPPCOVERAGE_SSE2
+#endif
+
+#include <limits>
+
+#include "Tools/Tool.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		const char* GetEscape(char c)
+		{
+			switch (c)
+			{
+				case '&': return "&amp;";
+				case '<': return "&lt;";
+				case '>': return "&gt;";
+				case '"': return "&quot;";
+			}
+			return nullptr;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// The text between the characters to escape is copied in one go.
+	void AppendHtmlEscaped(std::string& output, std::string_view text)
+	{
+		size_t cleanBegin = 0;
+		size_t i = 0;
+		auto appendEscape = [&](size_t position, const char* escape) {
+			output.append(text.data() + cleanBegin, position - cleanBegin);
+			output += escape;
+			cleanBegin = position + 1;
+		};
+
+#ifdef OPENCPPCOVERAGE_SSE2
+		const auto ampersands = _mm_set1_epi8('&');
+		const auto lessThans = _mm_set1_epi8('<');
+		const auto greaterThans = _mm_set1_epi8('>');
+		const auto quotes = _mm_set1_epi8('"');
+
+		// Most of the blocks of 16 characters have nothing to escape.
+		for (; i + 16 <= text.size(); i += 16)
+		{
+			auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+			auto matches = _mm_or_si128(
+				_mm_or_si128(_mm_cmpeq_epi8(block, ampersands), _mm_cmpeq_epi8(block, lessThans)),
+				_mm_or_si128(_mm_cmpeq_epi8(block, greaterThans), _mm_cmpeq_epi8(block, quotes)));
+
+			if (_mm_movemask_epi8(matches))
+			{
+				for (auto j = i; j < i + 16; ++j)
+				{
+					if (const auto* escape = GetEscape(text[j]))
+						appendEscape(j, escape);
+				}
+			}
+		}
+#endif
+		for (; i < text.size(); ++i)
+		{
+			if (const auto* escape = GetEscape(text[i]))
+				appendEscape(i, escape);
+		}
+		output.append(text.data() + cleanBegin, text.size() - cleanBegin);
+	}
+
+	//-------------------------------------------------------------------------
+	void AppendJsonString(std::string& json, std::string_view utf8Str)
+	{
+		const char* hexDigits = "0123456789abcdef";
+
+		json += '"';
+		for (auto c : utf8Str)
+		{
+			if (c == '"' || c == '\\')
+			{
+				json += '\\';
+				json += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20 || c == '<')
+			{
+				json += "\\u00";
+				json += hexDigits[c >> 4];
+				json += hexDigits[c & 0xF];
+			}
+			else
+				json += c;
+		}
+		json += '"';
+	}
+
+	//-------------------------------------------------------------------------
+	bool IsUtf8(std::string_view text)
+	{
+		if (text.empty() || text.size() > static_cast<size_t>((std::numeric_limits<int>::max)()))
+			return true;
+		return MultiByteToWideChar(CP_UTF8, MB_ERR_INVALID_CHARS, text.data(),
+		                           static_cast<int>(text.size()), nullptr, 0) != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	std::string_view AnsiToUtf8(std::string_view text, std::string& buffer)
+	{
+		buffer = Tools::ToUtf8String(Tools::LocalToWString(std::string{text}));
+		return buffer;
+	}
+}
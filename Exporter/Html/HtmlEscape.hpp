@@ -0,0 +1,35 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Exporter
+{
+	// Append text to output with & < > and " replaced by their HTML entities.
+	void AppendHtmlEscaped(std::string& output, std::string_view text);
+
+	// Append utf8Str as a quoted JSON string. < is also escaped so the JSON
+	// can be written in a script element.
+	void AppendJsonString(std::string& json, std::string_view utf8Str);
+
+	// The source files which are not valid UTF-8 are in the ANSI code page.
+	bool IsUtf8(std::string_view text);
+	// text in the ANSI code page converted to UTF-8 in buffer.
+	std::string_view AnsiToUtf8(std::string_view text, std::string& buffer);
+}
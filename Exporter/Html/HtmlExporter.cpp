@@ -18,6 +18,9 @@
 #include "HtmlExporter.hpp"
 
 #include <boost/optional/optional.hpp>
+#include <algorithm>
+#include <map>
+#include <set>
 #include <sstream>
 #include <iomanip>
 #include "CTemplate.hpp"
@@ -25,15 +28,24 @@
 #include "Plugin/Exporter/CoverageData.hpp"
 #include "Plugin/Exporter/ModuleCoverage.hpp"
 #include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
 #include "CppCoverage/CoverageRateComputer.hpp"
 #include "CppCoverage/CoverageRate.hpp"
 
 #include "Tools/Log.hpp"
 #include "Tools/Tool.hpp"
+#include "Tools/Fnv1a.hpp"
+#include "Tools/MappedFile.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/ThreadPool.hpp"
 
 #include "TemplateHtmlExporter.hpp"
 #include "HtmlFileCoverageExporter.hpp"
 #include "HtmlFolderStructure.hpp"
+#include "HtmlManifest.hpp"
+#include "HtmlModuleIndex.hpp"
+#include "../ExporterException.hpp"
+#include "../ReportWriter.hpp"
 namespace cov = CppCoverage;
 
 namespace Exporter
@@ -41,26 +53,217 @@ namespace Exporter
 
 	namespace
 	{
+		const size_t MinSourcePageCountByWorker = 8;
+		const std::string MainTemplateFilename = "MainTemplate.html";
+		const std::string SourceTemplateFilename = "SourceTemplate.html";
+		const std::string ModuleIndexTemplateFilename = "ModuleIndexTemplate.html";
+
+		//-------------------------------------------------------------------------
+		uint64_t AddPath(uint64_t hash, const fs::path& path)
+		{
+			const auto& native = path.native();
+
+			// The terminating null character separates the path from the next data.
+			return Tools::Fnv1a(hash, native.c_str(), (native.size() + 1) * sizeof(native[0]));
+		}
+
+		//-------------------------------------------------------------------------
+		uint64_t AddFileContent(uint64_t hash, const fs::path& path)
+		{
+			if (auto mappedFile = Tools::MappedFile::TryCreateBinary(path))
+			{
+				auto content = mappedFile->GetContent();
+				hash = Tools::Fnv1a(hash, content.data(), content.size());
+			}
+			return hash;
+		}
+
+		//-------------------------------------------------------------------------
+		uint64_t AddCoverageRate(uint64_t hash, const cov::CoverageRate& coverageRate)
+		{
+			int lineCounts[] = { coverageRate.GetExecutedLinesCount(), coverageRate.GetTotalLinesCount() };
+
+			return Tools::Fnv1a(hash, lineCounts, sizeof(lineCounts));
+		}
+
+		//-------------------------------------------------------------------------
+		// The templates, the version and the third-party path, which are written
+		// in all the pages.
+		uint64_t ComputeTemplateVersion(const fs::path& templateFolder, const std::string& thirdPartyPath)
+		{
+			std::string version = OPENCPPCOVERAGE_VERSION;
+			auto hash = Tools::Fnv1a(Tools::Fnv1aOffsetBasis, version.c_str(), version.size() + 1);
+
+			hash = Tools::Fnv1a(hash, thirdPartyPath.c_str(), thirdPartyPath.size() + 1);
+
+			hash = AddFileContent(hash, templateFolder / MainTemplateFilename);
+			hash = AddFileContent(hash, templateFolder / ModuleIndexTemplateFilename);
+			return AddFileContent(hash, templateFolder / SourceTemplateFilename);
+		}
+
+		//-------------------------------------------------------------------------
+		struct SharedSourcePage
+		{
+			const Plugin::ModuleCoverage* module_;
+			const Plugin::FileCoverage* file_;
+			HtmlFile htmlFile_;
+		};
+
+		//-------------------------------------------------------------------------
+		bool HaveSameExecutedLines(const Plugin::FileCoverage& file, const Plugin::FileCoverage& otherFile)
+		{
+			const auto& lines = file.GetLines();
+			const auto& otherLines = otherFile.GetLines();
+
+			return std::equal(lines.begin(), lines.end(), otherLines.begin(), otherLines.end(),
+				[](const Plugin::LineCoverage& line, const Plugin::LineCoverage& otherLine) {
+					return line.GetLineNumber() == otherLine.GetLineNumber()
+						&& line.HasBeenExecuted() == otherLine.HasBeenExecuted();
+				});
+		}
+
+		//-------------------------------------------------------------------------
+		// Link from the report root to the shared third-party folder. A file URL
+		// is used when there is no relative path, for example on another drive.
+		std::string GetThirdPartyLink(const fs::path& outputFolder, const fs::path& sharedThirdParty)
+		{
+			auto relativePath = sharedThirdParty.lexically_relative(outputFolder);
+
+			if (!relativePath.empty())
+				return relativePath.generic_u8string();
+			return "file:///" + sharedThirdParty.generic_u8string();
+		}
+
+		//-------------------------------------------------------------------------
+		// With the checksum read from the PDB, the source is not read: its size
+		// and last write time change with its content.
+		boost::optional<uint64_t> ComputeSourceHashFromChecksum(
+			Tools::SourceFileCache& sourceFileCache, const fs::path& path, uint64_t hash)
+		{
+			auto checksum = sourceFileCache.GetChecksum(path);
+			if (!checksum)
+				return boost::none;
+
+			std::error_code sizeError;
+			std::error_code timeError;
+			auto localPath = sourceFileCache.GetLocalPath(path);
+			auto size = fs::file_size(localPath, sizeError);
+			auto lastWriteTime = fs::last_write_time(localPath, timeError).time_since_epoch().count();
+			if (sizeError || timeError)
+				return boost::none;
+
+			auto type = static_cast<char>(checksum->type_);
+			hash = Tools::Fnv1a(hash, &type, sizeof(type));
+			hash = Tools::Fnv1a(hash, checksum->bytes_.data(), checksum->bytes_.size());
+			hash = Tools::Fnv1a(hash, &size, sizeof(size));
+			return Tools::Fnv1a(hash, &lastWriteTime, sizeof(lastWriteTime));
+		}
+
+		//-------------------------------------------------------------------------
+		// Without checksum, the source is mapped once for the hash and the page.
+		uint64_t ComputeSourceHash(Tools::SourceFileCache& sourceFileCache, const fs::path& path)
+		{
+			auto hash = AddPath(Tools::Fnv1aOffsetBasis, path);
+
+			if (auto checksumHash = ComputeSourceHashFromChecksum(sourceFileCache, path, hash))
+				return *checksumHash;
+			if (auto mappedFile = sourceFileCache.TryGet(path))
+			{
+				auto content = mappedFile->GetContent();
+				hash = Tools::Fnv1a(hash, content.data(), content.size());
+			}
+			return hash;
+		}
+
+		//-------------------------------------------------------------------------
+		// Only the executed state of the lines is shown in a source page.
+		uint64_t ComputeCoverageHash(const Plugin::FileCoverage& file)
+		{
+			auto hash = Tools::Fnv1aOffsetBasis;
+
+			for (const auto& line : file.GetLines())
+			{
+				auto lineNumber = line.GetLineNumber();
+				auto hasBeenExecuted = static_cast<char>(line.HasBeenExecuted());
+
+				hash = Tools::Fnv1a(hash, &lineNumber, sizeof(lineNumber));
+				hash = Tools::Fnv1a(hash, &hasBeenExecuted, sizeof(hasBeenExecuted));
+			}
+			return hash;
+		}
+
+		//-------------------------------------------------------------------------
+		fs::path GetPagePath(const fs::path& outputFolder, const HtmlFile& htmlFile)
+		{
+			return htmlFile.GetAbsolutePath().lexically_relative(outputFolder);
+		}
+
+		//-------------------------------------------------------------------------
+		bool IsUpToDate(
+			const HtmlManifest& previousManifest,
+			const fs::path& outputFolder,
+			const HtmlFile& htmlFile,
+			const HtmlPageVersion& version)
+		{
+			return previousManifest.IsUpToDate(GetPagePath(outputFolder, htmlFile), version)
+				&& Tools::FileExists(htmlFile.GetAbsolutePath());
+		}
+
 		//-------------------------------------------------------------------------
 		std::wstring GetMainMessage(const Plugin::CoverageData& coverageData)
 		{
 			auto exitCode = coverageData.GetExitCode();
+			std::wstring message;
 
 			if (exitCode)
-				return HtmlExporter::WarningExitCodeMessage + std::to_wstring(exitCode);
-			return L"";
+				message = HtmlExporter::WarningExitCodeMessage + std::to_wstring(exitCode);
+			if (coverageData.IsSampled())
+				message += (message.empty() ? L"" : L" ") + HtmlExporter::SampledCoverageMessage;
+			return message;
 		}
 	}
 	
 	//-------------------------------------------------------------------------
 	const std::wstring HtmlExporter::WarningExitCodeMessage = L"Warning: Your program has exited with error code: ";
+	const std::wstring HtmlExporter::SampledCoverageMessage =
+		L"Sampled coverage: lines not sampled may have been executed and the hit counts are sample counts.";
+	const size_t HtmlExporter::MaxModulePageFileCount = 1000;
 
 	//-------------------------------------------------------------------------
-	HtmlExporter::HtmlExporter(const fs::path& templateFolder)
-		: exporter_(templateFolder / "MainTemplate.html", templateFolder / "SourceTemplate.html")
-		, fileCoverageExporter_()
+	HtmlExporter::HtmlExporter(
+		const fs::path& templateFolder, 
+		bool isIncremental,
+		cov::ReportCompression compression,
+		const fs::path* assetsFolder,
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache,
+		const cov::HtmlShard* shard,
+		bool isDeterministic)
+		: sourceFileCache_{ sourceFileCache ? sourceFileCache : std::make_shared<Tools::SourceFileCache>() }
+		, exporter_(
+			templateFolder / MainTemplateFilename,
+			templateFolder / SourceTemplateFilename,
+			templateFolder / ModuleIndexTemplateFilename)
+		, fileCoverageExporter_(sourceFileCache_)
 		, templateFolder_(templateFolder)
+		, isIncremental_{ isIncremental && compression == cov::ReportCompression::None }
+		, compression_{ compression }
+		, isDeterministic_{ isDeterministic }
+		, peakBufferedSize_{ 0 }
+	{
+		if (assetsFolder)
+			assetsFolder_ = *assetsFolder;
+		if (shard)
+		{
+			if (isIncremental_ || compression != cov::ReportCompression::None)
+				THROW(L"An HTML shard cannot be compressed or incremental.");
+			shard_ = *shard;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	IExporter::BufferSizes HtmlExporter::GetPeakBufferSizes() const
 	{
+		return {{"Exporter buffers", peakBufferedSize_}};
 	}
 
 	//-------------------------------------------------------------------------
@@ -75,18 +278,112 @@ namespace Exporter
 		return ostr.str();
 	}
 
+	//-------------------------------------------------------------------------
+	struct HtmlExporter::ModulePage
+	{
+		ModulePage(const Plugin::ModuleCoverage& module, const HtmlFile& htmlFile)
+			: module_{ module }
+			, htmlFile_{ htmlFile }
+		{
+		}
+
+		const Plugin::ModuleCoverage& module_;
+		HtmlFile htmlFile_;
+		// Sorted by coverage rate, with the link of the source page when the
+		// source file exists.
+		std::vector<std::pair<const Plugin::FileCoverage*, boost::optional<HtmlFile>>> files_;
+	};
+
+	//-------------------------------------------------------------------------
+	// The module page shows the coverage rates and the links of its files.
+	uint64_t HtmlExporter::ComputeModuleCoverageHash(
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const ModulePage& modulePage)
+	{
+		auto hash = AddCoverageRate(Tools::Fnv1aOffsetBasis, coverageRateComputer.GetCoverageRate(modulePage.module_));
+
+		for (const auto& file : modulePage.files_)
+		{
+			hash = AddPath(hash, file.first->GetPath());
+			hash = AddCoverageRate(hash, coverageRateComputer.GetCoverageRate(*file.first));
+			hash = AddPath(hash, file.second ? file.second->GetRelativeLinkPath() : fs::path{});
+		}
+		return hash;
+	}
+
 	//-------------------------------------------------------------------------
 	void HtmlExporter::Export(
 		const Plugin::CoverageData& coverageData, 
 		const std::filesystem::path& outputFolderPrefix)
 	{	
-		HtmlFolderStructure htmlFolderStructure{templateFolder_};
 		cov::CoverageRateComputer coverageRateComputer{ coverageData };
 
+		Export(coverageData, coverageRateComputer, outputFolderPrefix);
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const std::filesystem::path& outputFolderPrefix)
+	{
+		auto isZip = compression_ == cov::ReportCompression::Zip;
+		auto isIndexExported = !shard_ || shard_->IsIndex();
+		HtmlFolderStructure htmlFolderStructure{templateFolder_, !isZip, !assetsFolder_ && isIndexExported};
+
+		auto outputFolder = htmlFolderStructure.CreateCurrentRoot(outputFolderPrefix);
+		std::string thirdPartyPath{ Tools::ToLocalString(HtmlFolderStructure::ThirdParty) };
+		if (assetsFolder_)
+			thirdPartyPath = GetThirdPartyLink(outputFolder, htmlFolderStructure.CreateSharedThirdParty(*assetsFolder_));
+		exporter_.SetThirdPartyPath(thirdPartyPath);
+
 		auto mainMessage = GetMainMessage(coverageData);
 
 		auto projectDictionary = exporter_.CreateTemplateDictionary(coverageData.GetName(), mainMessage);
-		auto outputFolder = htmlFolderStructure.CreateCurrentRoot(outputFolderPrefix);
+		ReportWriter reportWriter{ outputFolder, compression_, isDeterministic_ };
+		if (isZip && !assetsFolder_)
+		{
+			reportWriter.CopyFolder(
+				templateFolder_ / HtmlFolderStructure::ThirdParty,
+				outputFolder / HtmlFolderStructure::ThirdParty);
+		}
+		auto previousManifest = isIncremental_ ? HtmlManifest::Read(outputFolder) : HtmlManifest{};
+		HtmlManifest manifest;
+		auto templateVersion = isIncremental_ ? ComputeTemplateVersion(templateFolder_, thirdPartyPath) : 0;
+
+		HtmlManifest::Remove(outputFolder);
+		auto modulePages = CreateModulePages(coverageRateComputer, htmlFolderStructure);
+		std::vector<std::pair<const Plugin::FileCoverage*, const HtmlFile*>> sourcePages;
+		std::set<fs::path> sourcePagePaths;
+
+		for (const auto& modulePage : modulePages)
+		{
+			for (const auto& file : modulePage.files_)
+			{
+				if (file.second && sourcePagePaths.insert(file.second->GetAbsolutePath()).second)
+					sourcePages.emplace_back(file.first, file.second.get_ptr());
+			}
+		}
+		// The source pages are independent: only the module and project pages
+		// need the order of the files.
+		std::vector<HtmlPageVersion> sourcePageVersions(sourcePages.size());
+		Tools::ParallelFor(sourcePages.size(), MinSourcePageCountByWorker, [&](size_t i) {
+			const auto& file = *sourcePages[i].first;
+			const auto& htmlFile = *sourcePages[i].second;
+
+			if (shard_ && !shard_->ContainsPage(i))
+				return;
+			if (isIncremental_)
+			{
+				auto& version = sourcePageVersions[i];
+				version = HtmlPageVersion{ ComputeSourceHash(*sourceFileCache_, file.GetPath()), ComputeCoverageHash(file), templateVersion };
+				if (IsUpToDate(previousManifest, outputFolder, htmlFile, version))
+					return;
+			}
+			ExportFile(file, htmlFile, reportWriter);
+		});
+		for (size_t i = 0; i < sourcePages.size(); ++i)
+			manifest.SetPageVersion(GetPagePath(outputFolder, *sourcePages[i].second), sourcePageVersions[i]);
 
 		exporter_.AddModuleSectionToDictionary(
 		    coverageData.GetName(),
@@ -95,40 +392,122 @@ namespace Exporter
 			nullptr,
 		    *projectDictionary);
 
-		for (const auto& module : coverageRateComputer.SortModulesByCoverageRate())
-		{			
-			const auto& moduleCoverageRate = coverageRateComputer.GetCoverageRate(*module);
+		for (size_t i = 0; i < modulePages.size(); ++i)
+		{
+			const auto& modulePage = modulePages[i];
+			const auto& module = modulePage.module_;
+			// The module path is the title of the module page.
+			HtmlPageVersion version{};
 
-			if (moduleCoverageRate.GetTotalLinesCount())
+			// The module pages are numbered after the source pages.
+			auto isPageExported = !shard_ || shard_->ContainsPage(sourcePages.size() + i);
+			if (isIncremental_)
 			{
-				const auto& modulePath = module->GetPath();
-				auto moduleFilename = module->GetPath().filename();
-				auto moduleTemplateDictionary = exporter_.CreateTemplateDictionary(moduleFilename.wstring(), L"");
-
-				auto htmlModulePath = htmlFolderStructure.CreateCurrentModule(modulePath);
-				ExportFiles(coverageRateComputer, *module, htmlFolderStructure, *moduleTemplateDictionary);
-
-				exporter_.GenerateModuleTemplate(*moduleTemplateDictionary, htmlModulePath.GetAbsolutePath());
-				exporter_.AddModuleSectionToDictionary(
-				    module->GetPath(),
-				    moduleCoverageRate,
-					false,
-				    &htmlModulePath.GetRelativeLinkPath(),
-				    *projectDictionary);
+				version = HtmlPageVersion{
+					AddPath(Tools::Fnv1aOffsetBasis, module.GetPath()), 
+					ComputeModuleCoverageHash(coverageRateComputer, modulePage), 
+					templateVersion };
 			}
+			if (isPageExported &&
+				(!isIncremental_ || !IsUpToDate(previousManifest, outputFolder, modulePage.htmlFile_, version)))
+			{
+				if (modulePage.files_.size() > MaxModulePageFileCount)
+					ExportModuleIndex(coverageRateComputer, modulePage, reportWriter);
+				else
+				{
+					auto moduleFilename = module.GetPath().filename();
+					auto moduleTemplateDictionary = exporter_.CreateTemplateDictionary(moduleFilename.wstring(), L"");
+
+					ExportFiles(coverageRateComputer, modulePage, *moduleTemplateDictionary);
+					exporter_.GenerateModuleTemplate(
+						*moduleTemplateDictionary, modulePage.htmlFile_.GetAbsolutePath(), &reportWriter);
+				}
+			}
+			manifest.SetPageVersion(GetPagePath(outputFolder, modulePage.htmlFile_), version);
+			exporter_.AddModuleSectionToDictionary(
+			    module.GetPath(),
+			    coverageRateComputer.GetCoverageRate(module),
+				false,
+			    &modulePage.htmlFile_.GetRelativeLinkPath(),
+			    *projectDictionary);
 		}
 
-		exporter_.GenerateProjectTemplate(*projectDictionary, outputFolder / L"index.html");
-		Tools::ShowOutputMessage(L"Coverage generated in Folder ", outputFolder);
+		if (isIndexExported)
+			exporter_.GenerateProjectTemplate(*projectDictionary, outputFolder / L"index.html", &reportWriter);
+		else
+		{
+			auto pageCount = sourcePages.size() + modulePages.size();
+			LOG_INFO << L"HTML shard " << shard_->index_ << L'/' << shard_->count_ << L": "
+			         << (pageCount + shard_->count_ - shard_->index_) / shard_->count_
+			         << L" of the " << pageCount << L" pages.";
+		}
+		if (isIncremental_)
+		{
+			for (const auto& page : previousManifest.GetRemovedPages(manifest))
+			{
+				std::error_code error;
+				fs::remove(outputFolder / page, error);
+			}
+			manifest.Write(outputFolder);
+		}
+		auto output = reportWriter.Close();
+		peakBufferedSize_ = reportWriter.GetPeakBufferedSize();
+		Tools::ShowOutputMessage(isZip ? L"Coverage generated in " : L"Coverage generated in Folder ", output);
 	}	
 
+	//---------------------------------------------------------------------
+	// The output paths are unique in the order of the files so they are
+	// assigned before the pages are generated.
+	std::vector<HtmlExporter::ModulePage> HtmlExporter::CreateModulePages(
+		const cov::CoverageRateComputer& coverageRateComputer,
+		HtmlFolderStructure& htmlFolderStructure) const
+	{
+		std::vector<ModulePage> modulePages;
+		// A source file with the same executed lines in several modules has
+		// only one page, linked from all the module pages.
+		std::map<std::pair<fs::path, uint64_t>, std::vector<SharedSourcePage>> sourcePages;
+
+		for (const auto& module : coverageRateComputer.SortModulesByCoverageRate())
+		{
+			if (!coverageRateComputer.GetCoverageRate(*module).GetTotalLinesCount())
+				continue;
+
+			modulePages.emplace_back(*module, htmlFolderStructure.CreateCurrentModule(module->GetPath()));
+			auto& files = modulePages.back().files_;
+			for (const auto& file : coverageRateComputer.SortFilesByCoverageRate(*module))
+			{
+				auto& samePathPages = sourcePages[{ file->GetPath(), ComputeCoverageHash(*file) }];
+				auto sourcePage = std::find_if(samePathPages.begin(), samePathPages.end(), [&](const auto& page) {
+					return page.module_ != module && HaveSameExecutedLines(*page.file_, *file);
+				});
+				boost::optional<HtmlFile> htmlFile;
+
+				if (sourcePage != samePathPages.end())
+					htmlFile.emplace(sourcePage->htmlFile_);
+				else
+				{
+					auto htmlFilePath = htmlFolderStructure.GetHtmlFilePath(file->GetPath());
+
+					if (sourceFileCache_->Exists(file->GetPath()))
+					{
+						htmlFile.emplace(htmlFilePath);
+						samePathPages.push_back(SharedSourcePage{ module, file, htmlFilePath });
+					}
+				}
+				files.emplace_back(file, std::move(htmlFile));
+			}
+		}
+		return modulePages;
+	}
+
 	//---------------------------------------------------------------------
 	void HtmlExporter::ExportFiles(
-		cov::CoverageRateComputer& coverageRateComputer,
-		const Plugin::ModuleCoverage& module,
-		const HtmlFolderStructure& htmlFolderStructure, 
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const ModulePage& modulePage,
 		ctemplate::TemplateDictionary& moduleTemplateDictionary)
 	{
+		const auto& module = modulePage.module_;
+
 		exporter_.AddFileSectionToDictionary(
 			module.GetPath(),
 			coverageRateComputer.GetCoverageRate(module),
@@ -136,37 +515,55 @@ namespace Exporter
 			nullptr, 
 			moduleTemplateDictionary);
 
-		for (const auto& file : coverageRateComputer.SortFilesByCoverageRate(module))
+		for (const auto& file : modulePage.files_)
 		{
-			const auto& fileCoverageRate = coverageRateComputer.GetCoverageRate(*file);
-			boost::optional<fs::path> generatedOutput = ExportFile(htmlFolderStructure, *file);
+			const auto& htmlFile = file.second;
+
 			exporter_.AddFileSectionToDictionary(
-				file->GetPath(), 
-				fileCoverageRate, 
+				file.first->GetPath(), 
+				coverageRateComputer.GetCoverageRate(*file.first), 
 				false,
-				generatedOutput.get_ptr(), 
+				htmlFile ? &htmlFile->GetRelativeLinkPath() : nullptr, 
 				moduleTemplateDictionary);
 		}
 	}
 
 	//---------------------------------------------------------------------
-	boost::optional<fs::path> HtmlExporter::ExportFile(
-		const HtmlFolderStructure& htmlFolderStructure,
-		const Plugin::FileCoverage& fileCoverage) const
+	void HtmlExporter::ExportModuleIndex(
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const ModulePage& modulePage,
+		ReportWriter& reportWriter) const
 	{
-		auto htmlFilePath = htmlFolderStructure.GetHtmlFilePath(fileCoverage.GetPath());
-		std::wostringstream ostr;
-		
-		if (!Tools::FileExists(fileCoverage.GetPath()))
-			return boost::optional<fs::path>();
+		const auto& module = modulePage.module_;
+		HtmlModuleIndex moduleIndex{ module.GetPath(), coverageRateComputer.GetCoverageRate(module) };
 
-		auto enableCodePrettify = fileCoverageExporter_.Export(fileCoverage, ostr);
+		for (const auto& file : modulePage.files_)
+		{
+			const auto& htmlFile = file.second;
+
+			moduleIndex.AddFile(
+				file.first->GetPath(),
+				coverageRateComputer.GetCoverageRate(*file.first),
+				htmlFile ? &htmlFile->GetRelativeLinkPath() : nullptr);
+		}
+		exporter_.GenerateModuleIndexTemplate(
+			module.GetPath().filename().wstring(),
+			moduleIndex.ToJson(),
+			modulePage.htmlFile_.GetAbsolutePath(),
+			&reportWriter);
+	}
+
+	//---------------------------------------------------------------------
+	void HtmlExporter::ExportFile(
+		const Plugin::FileCoverage& fileCoverage,
+		const HtmlFile& htmlFile,
+		ReportWriter& reportWriter) const
+	{
+		std::string codeContent;
+		auto highlighting = fileCoverageExporter_.Export(fileCoverage, codeContent);
 
 		auto title = fileCoverage.GetPath().filename().wstring();
 		exporter_.GenerateSourceTemplate(
-			title, ostr.str(), enableCodePrettify, htmlFilePath.GetAbsolutePath());
-
-		return htmlFilePath.GetRelativeLinkPath();
+			title, codeContent, highlighting, htmlFile.GetAbsolutePath(), &reportWriter);
 	}	
 }
-
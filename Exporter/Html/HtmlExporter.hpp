@@ -16,11 +16,18 @@
 
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
+#include <memory>
+#include <vector>
+#include <boost/optional/optional.hpp>
 #include "../ExporterExport.hpp"
+#include "CppCoverage/HtmlShard.hpp"
+#include "CppCoverage/ReportCompression.hpp"
 
 #include "TemplateHtmlExporter.hpp"
 #include "HtmlFileCoverageExporter.hpp"
+#include "HtmlFile.hpp"
 #include "../IExporter.hpp"
 
 namespace Plugin
@@ -35,45 +42,96 @@ namespace CppCoverage
 	class CoverageRateComputer;
 }
 
-namespace boost
+namespace Tools
 {
-	template <typename T>
-	class optional;
+	class SourceFileCache;
 }
 
 namespace Exporter
 {
 	class HtmlFolderStructure;
+	class ReportWriter;
 
 	class EXPORTER_DLL HtmlExporter: public IExporter
 	{
 	public:
 		static const std::wstring WarningExitCodeMessage;
+		static const std::wstring SampledCoverageMessage;
+		// The modules with more files have a module page rendered in the
+		// browser from an index of the files.
+		static const size_t MaxModulePageFileCount;
 
 	public:
-		explicit HtmlExporter(const std::filesystem::path& templateFolder);
+		// In incremental mode, only the pages which changed since the last
+		// export to the same folder are written. The incremental mode is
+		// ignored when the report is compressed.
+		// When assetsFolder is not null, the third-party files are shared by all
+		// the reports using the same assets folder instead of being copied in
+		// each report.
+		// The sources are read from sourceFileCache, or from a cache owned by
+		// the exporter when it is null.
+		// When shard is not null, only the pages of the shard are written: the
+		// shards must use the same coverage and output folder, without
+		// compression nor incremental mode.
+		// The zip archive of a deterministic report is the same for the same
+		// pages.
+		explicit HtmlExporter(
+			const std::filesystem::path& templateFolder,
+			bool isIncremental = false,
+			CppCoverage::ReportCompression = CppCoverage::ReportCompression::None,
+			const std::filesystem::path* assetsFolder = nullptr,
+			std::shared_ptr<Tools::SourceFileCache> sourceFileCache = nullptr,
+			const CppCoverage::HtmlShard* shard = nullptr,
+			bool isDeterministic = false);
 
 		std::filesystem::path GetDefaultPath(const std::wstring& prefix) const override;
 		void Export(const Plugin::CoverageData&, const std::filesystem::path& outputFolder) override;
+		BufferSizes GetPeakBufferSizes() const override;
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& outputFolder) override;
 
 	private:
 		HtmlExporter(const HtmlExporter&) = delete;
 		HtmlExporter& operator=(const HtmlExporter&) = delete;
 
-		boost::optional<std::filesystem::path> ExportFile(
-			const HtmlFolderStructure& htmlFolderStructure,
-			const Plugin::FileCoverage& fileCoverage) const;
+		struct ModulePage;
+
+		static uint64_t ComputeModuleCoverageHash(
+			const CppCoverage::CoverageRateComputer&,
+			const ModulePage&);
+
+		std::vector<ModulePage> CreateModulePages(
+			const CppCoverage::CoverageRateComputer&,
+			HtmlFolderStructure& htmlFolderStructure) const;
+
+		void ExportFile(
+			const Plugin::FileCoverage& fileCoverage,
+			const HtmlFile& htmlFile,
+			ReportWriter& reportWriter) const;
 
 		void ExportFiles(
-			CppCoverage::CoverageRateComputer&,
-			const Plugin::ModuleCoverage& module,
-			const HtmlFolderStructure& htmlFolderStructure,
+			const CppCoverage::CoverageRateComputer&,
+			const ModulePage& modulePage,
 			ctemplate::TemplateDictionary& moduleTemplateDictionary);
 
+		void ExportModuleIndex(
+			const CppCoverage::CoverageRateComputer&,
+			const ModulePage& modulePage,
+			ReportWriter& reportWriter) const;
+
 	private:
+		const std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
 		TemplateHtmlExporter exporter_;
 		HtmlFileCoverageExporter fileCoverageExporter_;
 		std::filesystem::path templateFolder_;
+		const bool isIncremental_;
+		const CppCoverage::ReportCompression compression_;
+		const bool isDeterministic_;
+		boost::optional<std::filesystem::path> assetsFolder_;
+		boost::optional<CppCoverage::HtmlShard> shard_;
+		size_t peakBufferedSize_;
 	};
 }
 
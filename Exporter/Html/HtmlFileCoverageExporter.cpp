@@ -17,21 +17,29 @@
 #include "stdafx.h"
 #include "HtmlFileCoverageExporter.hpp"
 
-#include <fstream>
-#include <filesystem>
-#include <boost/spirit/include/classic.hpp>
-#include <boost/spirit/include/classic_tree_to_xml.hpp>
+#include <string_view>
+#include <vector>
+#include <boost/optional/optional.hpp>
 
 #include "Plugin/Exporter/FileCoverage.hpp"
 
-#include "../ExporterException.hpp"
+#include "Tools/MappedFile.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/Tool.hpp"
 
-namespace fs = std::filesystem;
+#include "../ExporterException.hpp"
+#include "HtmlEscape.hpp"
+#include "CppSyntaxHighlighter.hpp"
 
 namespace Exporter
 {
 	namespace
 	{
+		const std::string StyleBackgroundColor = "<span style = \"background-color:#";
+		const std::string StyleExecuted = StyleBackgroundColor + "dfd" + "\">";
+		const std::string StyleUnexecuted = StyleBackgroundColor + "fdd" + "\">";
+		const std::string EndStyle = "</span>";
+
 		//---------------------------------------------------------------------
 		bool HaveSameCoverage(
 			const Plugin::LineCoverage* lineCoverage,
@@ -43,65 +51,103 @@ namespace Exporter
 		}
 
 		//---------------------------------------------------------------------
-		std::wstring GetStyle(const Plugin::LineCoverage* lineCoverage)
+		const std::string* GetStyle(const Plugin::LineCoverage* lineCoverage)
 		{
 			if (!lineCoverage)
-				return L"";
+				return nullptr;
 
-			return (lineCoverage->HasBeenExecuted())
-				? HtmlFileCoverageExporter::StyleBackgroundColorExecuted
-				: HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted;
+			return (lineCoverage->HasBeenExecuted()) ? &StyleExecuted : &StyleUnexecuted;
 		}
 
 		//---------------------------------------------------------------------
 		void AddEndStyleIfNeeded(
-			std::wostream& output,
+			std::string& output,
 			const Plugin::LineCoverage* previousLineCoverage)
 		{
 			if (previousLineCoverage)
-				output << HtmlFileCoverageExporter::EndStyle;
+				output += EndStyle;
 		}
 
 		//---------------------------------------------------------------------
-		bool AddLineCoverageColor(
-			std::wostream& output,
-			const std::wstring& line, 
+		void AppendLine(
+			std::string& output,
+			std::string_view line,
+			const std::string* style,
+			CppSyntaxHighlighter* highlighter)
+		{
+			output += '\n';
+			if (style)
+				output += *style;
+			if (highlighter)
+				highlighter->AppendLine(output, line);
+			else
+				AppendHtmlEscaped(output, line);
+		}
+
+		//---------------------------------------------------------------------
+		void AddLineCoverageColor(
+			std::string& output,
+			std::string_view line, 
 			const Plugin::LineCoverage* lineCoverage,
-			const Plugin::LineCoverage* previousLineCoverage)
+			const Plugin::LineCoverage* previousLineCoverage,
+			CppSyntaxHighlighter* highlighter)
 		{
 			if (HaveSameCoverage(lineCoverage, previousLineCoverage))
 			{
-				output << std::endl << line;
-				return false;
+				AppendLine(output, line, nullptr, highlighter);
+				return;
 			}
 			
 			AddEndStyleIfNeeded(output, previousLineCoverage);
-			auto style = GetStyle(lineCoverage);
+			AppendLine(output, line, GetStyle(lineCoverage), highlighter);
+		}
 
-			output << std::endl;			
-			output << style << line;
+		//---------------------------------------------------------------------
+		// Number of coverage spans in the exported source.
+		int CountStyleChanges(const Plugin::FileCoverage& fileCoverage, size_t lineCount)
+		{
+			const Plugin::LineCoverage* previousLineCoverage = nullptr;
+			int styleChangesCount = 0;
 
-			return !style.empty();
-		}
+			for (size_t i = 0; i < lineCount; ++i)
+			{
+				auto lineCoverage = fileCoverage[static_cast<unsigned int>(i + 1)];
 
-		const std::wstring StyleBackgroundColor = L"<span style = \"background-color:#";
+				if (!HaveSameCoverage(lineCoverage, previousLineCoverage) && lineCoverage)
+					++styleChangesCount;
+				previousLineCoverage = lineCoverage;
+			}
+			return styleChangesCount;
+		}
 	}
 
 	const std::wstring HtmlFileCoverageExporter::StyleBackgroundColorExecuted = 
-		StyleBackgroundColor + L"dfd" + L"\">";
+		Tools::Utf8ToWString(StyleExecuted);
 	const std::wstring HtmlFileCoverageExporter::StyleBackgroundColorUnexecuted = 
-		StyleBackgroundColor + L"fdd" + L"\">";
-	const std::wstring HtmlFileCoverageExporter::EndStyle = L"</span>";
+		Tools::Utf8ToWString(StyleUnexecuted);
+	const std::wstring HtmlFileCoverageExporter::EndStyle = Tools::Utf8ToWString(Exporter::EndStyle);
 
 	//-------------------------------------------------------------------------
 	HtmlFileCoverageExporter::HtmlFileCoverageExporter(
 		int maxSourceLineCount,
 		int maxSourceLineStyleChangesCount,
-		int maxStyleChangesCount)
+		int maxStyleChangesCount,
+		bool exportSyntaxHighlighting)
 		: maxSourceLineCount_{ maxSourceLineCount }
 		, maxSourceLineStyleChangesCount_{ maxSourceLineStyleChangesCount }
 		, maxStyleChangesCount_{ maxStyleChangesCount }
+		, exportSyntaxHighlighting_{ exportSyntaxHighlighting }
+		, sourceFileCache_{ std::make_shared<Tools::SourceFileCache>() }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	HtmlFileCoverageExporter::HtmlFileCoverageExporter(
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
+		: HtmlFileCoverageExporter()
 	{
+		if (sourceFileCache)
+			sourceFileCache_ = sourceFileCache;
 	}
 
 	//-------------------------------------------------------------------------
@@ -109,30 +155,60 @@ namespace Exporter
 		const Plugin::FileCoverage& fileCoverage,
 		std::wostream& output) const
 	{
-		auto filePath = fileCoverage.GetPath();
+		std::string utf8Output;
+		auto enableCodePrettify = Export(fileCoverage, utf8Output) == SyntaxHighlighting::CodePrettify;
+
+		output << Tools::Utf8ToWString(utf8Output);
+		output.flush();
+		return enableCodePrettify;
+	}
+
+	//-------------------------------------------------------------------------
+	SyntaxHighlighting HtmlFileCoverageExporter::Export(
+		const Plugin::FileCoverage& fileCoverage,
+		std::string& output) const
+	{
+		const auto& filePath = fileCoverage.GetPath();
 
-		std::wifstream ifs{filePath.string()};
-		if (!ifs)
+		if (!sourceFileCache_->Exists(filePath))
 			THROW(L"Cannot open file : " + filePath.wstring());
 
-		std::wstring line;
+		// No mapping for an empty file.
+		auto mappedFile = sourceFileCache_->TryGet(filePath);
+		const std::vector<std::string_view> noLines;
+		const auto& lines = mappedFile ? mappedFile->GetLines() : noLines;
+
+		if (mappedFile)
+			output.reserve(output.size() + mappedFile->GetContent().size() * 5 / 4);
+
+		auto styleChangesCount = CountStyleChanges(fileCoverage, lines.size());
+		auto highlighting = SyntaxHighlighting::CodePrettify;
+		boost::optional<CppSyntaxHighlighter> highlighter;
+
+		if (!MustEnableCodePrettify(static_cast<int>(lines.size()), styleChangesCount))
+		{
+			highlighting = SyntaxHighlighting::None;
+			if (exportSyntaxHighlighting_)
+			{
+				highlighting = SyntaxHighlighting::Exported;
+				highlighter.emplace();
+			}
+		}
+
 		const Plugin::LineCoverage* previousLineCoverage = nullptr;
-		int styleChangesCount = 0;
-		int lineCount = 0;
-		for (int i = 1; std::getline(ifs, line); ++i)
+		auto isUtf8 = !mappedFile || IsUtf8(mappedFile->GetContent());
+		std::string utf8Line;
+		for (size_t i = 0; i < lines.size(); ++i)
 		{			
-			auto lineCoverage = fileCoverage[i];
+			auto lineCoverage = fileCoverage[static_cast<unsigned int>(i + 1)];
+			auto line = isUtf8 ? lines[i] : AnsiToUtf8(lines[i], utf8Line);
 			
-			line = boost::spirit::classic::xml::encode(line);				
-			if (AddLineCoverageColor(output, line, lineCoverage, previousLineCoverage))
-				++styleChangesCount;
-			++lineCount;
+			AddLineCoverageColor(output, line, lineCoverage, previousLineCoverage, highlighter.get_ptr());
 			previousLineCoverage = lineCoverage;
 		}
 		AddEndStyleIfNeeded(output, previousLineCoverage);
-		output.flush();
 
-		return MustEnableCodePrettify(lineCount, styleChangesCount);
+		return highlighting;
 	}
 
 	//-------------------------------------------------------------------------
@@ -17,14 +17,22 @@
 #pragma once
 
 #include <iosfwd> 
+#include <memory>
+#include <string>
 
 #include "../ExporterExport.hpp"
+#include "SyntaxHighlighting.hpp"
 
 namespace Plugin
 {
 	class FileCoverage;
 }
 
+namespace Tools
+{
+	class SourceFileCache;
+}
+
 namespace Exporter
 {
 	class EXPORTER_DLL HtmlFileCoverageExporter
@@ -35,14 +43,25 @@ namespace Exporter
 		static const std::wstring EndStyle;
 
 	public:
+		// The sources too big for google-code-prettify are highlighted by the
+		// export when exportSyntaxHighlighting is true.
 		HtmlFileCoverageExporter(
 			int maxSourceLineCount = 8000, 
 			int maxSourceLineStyleChangesCount = 1000,
-			int maxStyleChangesCount = 2000);
+			int maxStyleChangesCount = 2000,
+			bool exportSyntaxHighlighting = true);
+		// Read the sources from a cache shared with the other consumers.
+		explicit HtmlFileCoverageExporter(std::shared_ptr<Tools::SourceFileCache>);
 
 		bool Export(
 			const Plugin::FileCoverage&,
 			std::wostream& output) const;
+		// Append the source in UTF-8 without conversion: the source file
+		// is mapped and the text between the characters to escape is copied
+		// as is.
+		SyntaxHighlighting Export(
+			const Plugin::FileCoverage&,
+			std::string& output) const;
 		
 		bool MustEnableCodePrettify(int lineCount, int styleChangedCount) const;
 
@@ -53,6 +72,8 @@ namespace Exporter
 		int maxSourceLineCount_;
 		int maxSourceLineStyleChangesCount_;
 		int maxStyleChangesCount_;
+		bool exportSyntaxHighlighting_;
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
 	};
 }
 
@@ -17,12 +17,20 @@
 #include "stdafx.h"
 #include "HtmlFolderStructure.hpp"
 
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <vector>
 #include <boost/algorithm/string.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
 
 #include "Exporter/ExporterException.hpp"
 
 #include "Tools/Tool.hpp"
 #include "Tools/UniquePath.hpp"
+#include "Tools/Fnv1a.hpp"
+#include "Tools/MappedFile.hpp"
 
 namespace fs = std::filesystem;
 
@@ -51,15 +59,48 @@ namespace Exporter
 					fs::copy_file(path, destination, fs::copy_options::overwrite_existing);
 			}
 		}
+
+		//---------------------------------------------------------------------
+		// Hash the relative paths and the content of the files in a stable order.
+		uint64_t ComputeFolderHash(const fs::path& folder)
+		{
+			std::vector<fs::path> files;
+
+			for (fs::recursive_directory_iterator it(folder);
+				it != fs::recursive_directory_iterator(); ++it)
+			{
+				if (fs::is_regular_file(it->path()))
+					files.push_back(it->path().lexically_relative(folder));
+			}
+			std::sort(files.begin(), files.end());
+
+			auto hash = Tools::Fnv1aOffsetBasis;
+			for (const auto& file : files)
+			{
+				auto name = file.generic_u8string();
+
+				hash = Tools::Fnv1a(hash, name.c_str(), name.size() + 1);
+				if (auto mappedFile = Tools::MappedFile::TryCreateBinary(folder / file))
+				{
+					auto content = mappedFile->GetContent();
+					uint64_t size = content.size();
+
+					hash = Tools::Fnv1a(hash, &size, sizeof(size));
+					hash = Tools::Fnv1a(hash, content.data(), content.size());
+				}
+			}
+			return hash;
+		}
 	}
 
 	//-------------------------------------------------------------------------
 	struct HtmlFolderStructure::Hierarchy
 	{
-		explicit Hierarchy(const std::filesystem::path& path)
+		Hierarchy(const std::filesystem::path& path, bool createFolder)
 			: path_{ path } 
 		{
-			fs::create_directories(path);
+			if (createFolder)
+				fs::create_directories(path);
 		}
 
 		std::filesystem::path path_;
@@ -71,8 +112,13 @@ namespace Exporter
 	const std::wstring HtmlFolderStructure::FolderModules = L"Modules";
 
 	//-------------------------------------------------------------------------
-	HtmlFolderStructure::HtmlFolderStructure(const std::filesystem::path& templateFolder)
+	HtmlFolderStructure::HtmlFolderStructure(
+		const std::filesystem::path& templateFolder,
+		bool createFolders,
+		bool copyThirdParty)
 		: templateFolder_(templateFolder)
+		, createFolders_{ createFolders }
+		, copyThirdParty_{ copyThirdParty }
 	{
 	}
 
@@ -83,10 +129,13 @@ namespace Exporter
 	std::filesystem::path HtmlFolderStructure::CreateCurrentRoot(const std::filesystem::path& outputFolder)
 	{
 		auto root{ fs::absolute(outputFolder) };
-		optionalCurrentRoot_ = std::make_unique<Hierarchy>(root);
-		CopyRecursiveDirectoryContent(
-			templateFolder_ / HtmlFolderStructure::ThirdParty,
-			root / HtmlFolderStructure::ThirdParty);
+		optionalCurrentRoot_ = std::make_unique<Hierarchy>(root, createFolders_);
+		if (createFolders_ && copyThirdParty_)
+		{
+			CopyRecursiveDirectoryContent(
+				templateFolder_ / HtmlFolderStructure::ThirdParty,
+				root / HtmlFolderStructure::ThirdParty);
+		}
 
 		return root;
 	}
@@ -103,7 +152,7 @@ namespace Exporter
 
 		auto moduleFolder = folderModules / moduleName;
 		auto uniqueModulesFolder = optionalCurrentRoot_->uniqueChildrenPath_.GetUniquePath(moduleFolder);
-		optionalCurrentModule_ = std::make_unique<Hierarchy>(uniqueModulesFolder);
+		optionalCurrentModule_ = std::make_unique<Hierarchy>(uniqueModulesFolder, createFolders_);
 		fs::path moduleHtmlPath = uniqueModulesFolder.wstring() + L".html";
 		
 		return HtmlFile{ 
@@ -124,4 +173,35 @@ namespace Exporter
 
 		return HtmlFile{fileHtmlPath, modulePath.filename() / fileHtmlPath.filename()};
 	}	
+
+	//-------------------------------------------------------------------------
+	fs::path HtmlFolderStructure::CreateSharedThirdParty(const fs::path& assetsFolder) const
+	{
+		auto thirdParty = templateFolder_ / HtmlFolderStructure::ThirdParty;
+		std::wostringstream ostr;
+
+		ostr << HtmlFolderStructure::ThirdParty << L'-'
+			<< std::hex << std::setw(16) << std::setfill(L'0') << ComputeFolderHash(thirdParty);
+
+		auto sharedThirdParty = fs::absolute(assetsFolder / ostr.str());
+		if (fs::exists(sharedThirdParty))
+			return sharedThirdParty;
+
+		// Copy in a temporary folder first so another export using the same
+		// assets folder never sees a partial copy.
+		auto id = boost::uuids::to_string(boost::uuids::random_generator()());
+		auto temporaryFolder = fs::absolute(assetsFolder / (L"tmp-" + Tools::LocalToWString(id)));
+
+		CopyRecursiveDirectoryContent(thirdParty, temporaryFolder);
+
+		std::error_code error;
+		fs::rename(temporaryFolder, sharedThirdParty, error);
+		if (error)
+		{
+			fs::remove_all(temporaryFolder, error);
+			if (!fs::exists(sharedThirdParty))
+				THROW(L"Cannot create " << sharedThirdParty.wstring());
+		}
+		return sharedThirdParty;
+	}
 }
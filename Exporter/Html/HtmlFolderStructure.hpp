@@ -31,19 +31,33 @@ namespace Exporter
 		static const std::wstring FolderModules;
 
 	public:
-		HtmlFolderStructure(const std::filesystem::path& templateFolder);
+		// When createFolders is false, the files are only named: the report is
+		// written in an archive. When copyThirdParty is false, the report uses
+		// a shared copy of the third-party folder (see CreateSharedThirdParty).
+		HtmlFolderStructure(
+			const std::filesystem::path& templateFolder,
+			bool createFolders = true,
+			bool copyThirdParty = true);
 		~HtmlFolderStructure();
 
 		std::filesystem::path CreateCurrentRoot(const std::filesystem::path& outputFolder);
 		HtmlFile CreateCurrentModule(const std::filesystem::path&);		
 		HtmlFile GetHtmlFilePath(const std::filesystem::path& filePath) const;
 
+		// Copy the third-party folder in assetsFolder if it is not already there
+		// and return the absolute path of the copy. The name of the copy depends
+		// on the content so the reports of different versions can share
+		// assetsFolder.
+		std::filesystem::path CreateSharedThirdParty(const std::filesystem::path& assetsFolder) const;
+
 	private:
 		HtmlFolderStructure(const HtmlFolderStructure&) = delete;
 		HtmlFolderStructure& operator=(const HtmlFolderStructure&) = delete;
 
 	private:
 		std::filesystem::path templateFolder_;
+		const bool createFolders_;
+		const bool copyThirdParty_;
 
 		struct Hierarchy;
 		std::unique_ptr<Hierarchy> optionalCurrentRoot_;
@@ -0,0 +1,129 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "HtmlManifest.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Tools/Tool.hpp"
+
+#include "../ExporterException.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		const std::string Header = "OpenCppCoverage HTML manifest 1";
+	}
+
+	//-------------------------------------------------------------------------
+	bool operator==(const HtmlPageVersion& version, const HtmlPageVersion& otherVersion)
+	{
+		return version.sourceHash_ == otherVersion.sourceHash_
+			&& version.coverageHash_ == otherVersion.coverageHash_
+			&& version.templateVersion_ == otherVersion.templateVersion_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring HtmlManifest::Filename = L"HtmlManifest.txt";
+
+	//-------------------------------------------------------------------------
+	HtmlManifest HtmlManifest::Read(const fs::path& outputFolder)
+	{
+		std::ifstream ifs((outputFolder / Filename).string());
+		std::string line;
+		HtmlManifest manifest;
+
+		if (!std::getline(ifs, line) || line != Header)
+			return manifest;
+
+		// Format: <source hash> <coverage hash> <template version> <page path>
+		while (std::getline(ifs, line))
+		{
+			std::istringstream istr{ line };
+			HtmlPageVersion version;
+			std::string pagePath;
+
+			istr >> std::hex >> version.sourceHash_ >> version.coverageHash_ >> version.templateVersion_;
+			if (!istr || istr.get() != ' ' || !std::getline(istr, pagePath) || pagePath.empty())
+				return HtmlManifest{};
+			manifest.SetPageVersion(fs::u8path(pagePath), version);
+		}
+		return manifest;
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlManifest::Remove(const fs::path& outputFolder)
+	{
+		std::error_code error;
+
+		fs::remove(outputFolder / Filename, error);
+	}
+
+	//-------------------------------------------------------------------------
+	bool HtmlManifest::IsUpToDate(const fs::path& pagePath, const HtmlPageVersion& version) const
+	{
+		auto it = pageVersions_.find(pagePath);
+
+		return it != pageVersions_.end() && it->second == version;
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlManifest::SetPageVersion(const fs::path& pagePath, const HtmlPageVersion& version)
+	{
+		pageVersions_[pagePath] = version;
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<fs::path> HtmlManifest::GetRemovedPages(const HtmlManifest& manifest) const
+	{
+		std::vector<fs::path> removedPages;
+
+		for (const auto& pageVersion : pageVersions_)
+		{
+			if (manifest.pageVersions_.count(pageVersion.first) == 0)
+				removedPages.push_back(pageVersion.first);
+		}
+		return removedPages;
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlManifest::Write(const fs::path& outputFolder) const
+	{
+		auto path = outputFolder / Filename;
+		std::ofstream ofs(path.string());
+
+		if (!ofs)
+			THROW(L"Cannot open file " << path.wstring());
+		ofs << Header << '\n' << std::hex << std::setfill('0');
+		for (const auto& pageVersion : pageVersions_)
+		{
+			const auto& version = pageVersion.second;
+
+			ofs << std::setw(16) << version.sourceHash_ << ' '
+				<< std::setw(16) << version.coverageHash_ << ' '
+				<< std::setw(16) << version.templateVersion_ << ' '
+				<< Tools::ToUtf8String(pageVersion.first.generic_wstring()) << '\n';
+		}
+		if (!ofs)
+			THROW(L"Cannot write file " << path.wstring());
+	}
+}
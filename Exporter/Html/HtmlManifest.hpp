@@ -0,0 +1,68 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	// Hashes of what a page is generated from.
+	struct EXPORTER_DLL HtmlPageVersion
+	{
+		uint64_t sourceHash_;
+		uint64_t coverageHash_;
+		uint64_t templateVersion_;
+	};
+
+	EXPORTER_DLL bool operator==(const HtmlPageVersion&, const HtmlPageVersion&);
+
+	// Version of each page of a report, stored in the report folder so that a
+	// report can be updated by writing only the pages whose version changed.
+	class EXPORTER_DLL HtmlManifest
+	{
+	public:
+		static const std::wstring Filename;
+
+		// Empty when the report folder has no valid manifest.
+		static HtmlManifest Read(const std::filesystem::path& outputFolder);
+		// The pages may be modified after the call: their versions are unknown.
+		static void Remove(const std::filesystem::path& outputFolder);
+
+		HtmlManifest() = default;
+		HtmlManifest(HtmlManifest&&) = default;
+		HtmlManifest& operator=(HtmlManifest&&) = default;
+
+		// The page paths are relative to the report folder.
+		bool IsUpToDate(const std::filesystem::path& pagePath, const HtmlPageVersion&) const;
+		void SetPageVersion(const std::filesystem::path& pagePath, const HtmlPageVersion&);
+		// The pages of this manifest which are not in the other one.
+		std::vector<std::filesystem::path> GetRemovedPages(const HtmlManifest&) const;
+
+		void Write(const std::filesystem::path& outputFolder) const;
+
+	private:
+		HtmlManifest(const HtmlManifest&) = delete;
+		HtmlManifest& operator=(const HtmlManifest&) = delete;
+
+		std::map<std::filesystem::path, HtmlPageVersion> pageVersions_;
+	};
+}
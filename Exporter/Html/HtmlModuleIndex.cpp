@@ -0,0 +1,130 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "HtmlModuleIndex.hpp"
+
+#include <map>
+
+#include "CppCoverage/CoverageRate.hpp"
+#include "Tools/Tool.hpp"
+
+#include "HtmlEscape.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		struct DirectoryRollup
+		{
+			size_t index_ = 0;
+			int executedLinesCount_ = 0;
+			int totalLinesCount_ = 0;
+			int fileCount_ = 0;
+		};
+
+		//---------------------------------------------------------------------
+		std::string ToUtf8(const fs::path& path)
+		{
+			return Tools::ToUtf8String(path.wstring());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	HtmlModuleIndex::HtmlModuleIndex(
+		const fs::path& modulePath,
+		const CppCoverage::CoverageRate& moduleCoverageRate)
+		: module_{
+			modulePath,
+			std::string{},
+			moduleCoverageRate.GetExecutedLinesCount(),
+			moduleCoverageRate.GetTotalLinesCount() }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	void HtmlModuleIndex::AddFile(
+		const fs::path& filePath,
+		const CppCoverage::CoverageRate& coverageRate,
+		const fs::path* link)
+	{
+		files_.push_back(File{
+			filePath,
+			link ? ToUtf8(link->generic_wstring()) : std::string{},
+			coverageRate.GetExecutedLinesCount(),
+			coverageRate.GetTotalLinesCount() });
+	}
+
+	//-------------------------------------------------------------------------
+	std::string HtmlModuleIndex::ToJson() const
+	{
+		std::map<fs::path, DirectoryRollup> directories;
+
+		for (const auto& file : files_)
+		{
+			// The rollup of a folder contains the files of its sub folders.
+			for (auto folder = file.path_.parent_path(); ; folder = folder.parent_path())
+			{
+				auto& rollup = directories[folder];
+				rollup.executedLinesCount_ += file.executedLinesCount_;
+				rollup.totalLinesCount_ += file.totalLinesCount_;
+				++rollup.fileCount_;
+
+				if (folder.parent_path() == folder || !folder.has_relative_path())
+					break;
+			}
+		}
+
+		std::string json = "{\"module\":[";
+		AppendJsonString(json, ToUtf8(module_.path_));
+		json += ',' + std::to_string(module_.executedLinesCount_);
+		json += ',' + std::to_string(module_.totalLinesCount_);
+		json += "],\"separator\":";
+		AppendJsonString(json, ToUtf8(fs::path::string_type(1, fs::path::preferred_separator)));
+		json += ",\"dirs\":[";
+		size_t index = 0;
+		for (auto& directory : directories)
+		{
+			auto& rollup = directory.second;
+
+			rollup.index_ = index;
+			json += index++ ? ",[" : "[";
+			AppendJsonString(json, ToUtf8(directory.first));
+			json += ',' + std::to_string(rollup.executedLinesCount_);
+			json += ',' + std::to_string(rollup.totalLinesCount_);
+			json += ',' + std::to_string(rollup.fileCount_) + ']';
+		}
+
+		json += "],\"files\":[";
+		for (size_t i = 0; i < files_.size(); ++i)
+		{
+			const auto& file = files_[i];
+
+			json += i ? ",[" : "[";
+			json += std::to_string(directories.at(file.path_.parent_path()).index_) + ',';
+			AppendJsonString(json, ToUtf8(file.path_.filename()));
+			json += ',';
+			AppendJsonString(json, file.link_);
+			json += ',' + std::to_string(file.executedLinesCount_);
+			json += ',' + std::to_string(file.totalLinesCount_) + ']';
+		}
+		json += "]}";
+
+		return json;
+	}
+}
@@ -0,0 +1,72 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+
+namespace CppCoverage
+{
+	class CoverageRate;
+}
+
+namespace Exporter
+{
+	// Compact JSON index of the files of a module, used by the module pages of
+	// the modules with many files. The page only renders the visible rows and
+	// sorts and filters the files in the browser.
+	class EXPORTER_DLL HtmlModuleIndex
+	{
+	public:
+		HtmlModuleIndex(
+			const std::filesystem::path& modulePath,
+			const CppCoverage::CoverageRate& moduleCoverageRate);
+
+		// link is the path of the source page from the module page, or null
+		// when the source file does not exist.
+		void AddFile(
+			const std::filesystem::path& filePath,
+			const CppCoverage::CoverageRate& coverageRate,
+			const std::filesystem::path* link);
+
+		// {"module":[path, executedLines, totalLines],
+		//  "separator":"\\",
+		//  "dirs":[[path, executedLines, totalLines, fileCount], ...],
+		//  "files":[[dirIndex, filename, link, executedLines, totalLines], ...]}
+		// The directories are sorted and include the rollups of all the files
+		// below them. The files are in the order of AddFile.
+		std::string ToJson() const;
+
+	private:
+		HtmlModuleIndex(const HtmlModuleIndex&) = delete;
+		HtmlModuleIndex& operator=(const HtmlModuleIndex&) = delete;
+
+		struct File
+		{
+			std::filesystem::path path_;
+			std::string link_;
+			int executedLinesCount_;
+			int totalLinesCount_;
+		};
+
+		File module_;
+		std::vector<File> files_;
+	};
+}
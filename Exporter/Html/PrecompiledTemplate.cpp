@@ -0,0 +1,113 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "PrecompiledTemplate.hpp"
+
+#include <algorithm>
+
+#include "Tools/MappedFile.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		const std::string_view MarkerStart = "{{";
+		const std::string_view MarkerEnd = "}}";
+
+		//---------------------------------------------------------------------
+		bool IsVariableName(std::string_view name)
+		{
+			auto isNameCharacter = [](char c) {
+				return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_';
+			};
+
+			return !name.empty() && std::all_of(name.begin(), name.end(), isNameCharacter);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const size_t PrecompiledTemplate::NoVariable = static_cast<size_t>(-1);
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<PrecompiledTemplate> PrecompiledTemplate::TryCreate(
+		const fs::path& templatePath,
+		const std::vector<std::string>& variables)
+	{
+		auto mappedFile = Tools::MappedFile::TryCreateBinary(templatePath);
+		if (!mappedFile)
+			return nullptr;
+
+		auto content = mappedFile->GetContent();
+		std::unique_ptr<PrecompiledTemplate> precompiledTemplate{ new PrecompiledTemplate{} };
+		auto& text = precompiledTemplate->text_;
+		auto& segments = precompiledTemplate->segments_;
+		size_t offset = 0;
+
+		text.reserve(content.size());
+		for (auto start = content.find(MarkerStart); start != std::string_view::npos;
+		     start = content.find(MarkerStart, offset))
+		{
+			auto end = content.find(MarkerEnd, start + MarkerStart.size());
+			if (end == std::string_view::npos)
+				return nullptr;
+
+			auto name = content.substr(start + MarkerStart.size(), end - start - MarkerStart.size());
+			if (!IsVariableName(name))
+				return nullptr;
+
+			auto segmentOffset = text.size();
+			text.append(content.data() + offset, start - offset);
+			auto it = std::find(variables.begin(), variables.end(), name);
+			auto variable = it == variables.end() ? NoVariable : static_cast<size_t>(it - variables.begin());
+			segments.push_back(Segment{ segmentOffset, text.size() - segmentOffset, variable });
+			offset = end + MarkerEnd.size();
+		}
+
+		auto segmentOffset = text.size();
+		text.append(content.data() + offset, content.size() - offset);
+		segments.push_back(Segment{ segmentOffset, text.size() - segmentOffset, NoVariable });
+
+		return precompiledTemplate;
+	}
+
+	//-------------------------------------------------------------------------
+	void PrecompiledTemplate::Expand(
+		const std::vector<std::string_view>& values,
+		std::string& output) const
+	{
+		auto size = output.size() + text_.size();
+
+		for (const auto& segment : segments_)
+		{
+			if (segment.variable_ != NoVariable)
+				size += values.at(segment.variable_).size();
+		}
+		output.reserve(size);
+
+		for (const auto& segment : segments_)
+		{
+			output.append(text_, segment.offset_, segment.size_);
+			if (segment.variable_ != NoVariable)
+			{
+				auto value = values[segment.variable_];
+				output.append(value.data(), value.size());
+			}
+		}
+	}
+}
@@ -0,0 +1,63 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "../ExporterExport.hpp"
+
+namespace Exporter
+{
+	// Template split once in text segments and variables. A page is expanded
+	// by appending the segments and the values to a single buffer, without a
+	// ctemplate::TemplateDictionary.
+	class EXPORTER_DLL PrecompiledTemplate
+	{
+	public:
+		// Null when the template cannot be read or uses more than {{VARIABLE}}
+		// markers (sections, comments, modifiers...): the caller should expand
+		// it with ctemplate. The markers not in variables expand to nothing.
+		static std::unique_ptr<PrecompiledTemplate> TryCreate(
+			const std::filesystem::path& templatePath,
+			const std::vector<std::string>& variables);
+
+		// values[i] is the value of variables[i].
+		void Expand(const std::vector<std::string_view>& values, std::string& output) const;
+
+	private:
+		PrecompiledTemplate() = default;
+		PrecompiledTemplate(const PrecompiledTemplate&) = delete;
+		PrecompiledTemplate& operator=(const PrecompiledTemplate&) = delete;
+
+		// The text before the variable is [offset_, offset_ + size_) in text_.
+		struct Segment
+		{
+			size_t offset_;
+			size_t size_;
+			size_t variable_;
+		};
+
+		static const size_t NoVariable;
+
+		std::string text_;
+		std::vector<Segment> segments_;
+	};
+}
@@ -19,15 +19,18 @@
 
 #include <fstream>
 #include <filesystem>
+#include <mutex>
 #include <boost/algorithm/string.hpp>
 #include <boost/uuid/uuid_io.hpp>
 
 #include "CTemplate.hpp"
+#include "PrecompiledTemplate.hpp"
 #include "Tools/Tool.hpp"
 
 #include "CppCoverage/CoverageRate.hpp"
 
 #include "../ExporterException.hpp"
+#include "../ReportWriter.hpp"
 
 namespace cov = CppCoverage;
 namespace fs = std::filesystem;
@@ -74,16 +77,44 @@ namespace Exporter
 			return output;
 		}
 		
+		//-------------------------------------------------------------------------
+		void WritePageContent(
+			const std::string& content,
+			const fs::path& output,
+			ReportWriter* reportWriter)
+		{
+			if (reportWriter)
+				reportWriter->WriteFile(output, content);
+			else
+				WriteContentTo(content, output);
+		}
+
 		//-------------------------------------------------------------------------
 		void WriteTemplate(
 			const ctemplate::TemplateDictionary& templateDictionary,
 			const fs::path& templatePath,
-			const fs::path& output)
+			const fs::path& output,
+			ReportWriter* reportWriter)
 		{			
-			std::string content = GenerateTemplate(templateDictionary, templatePath);
-			WriteContentTo(content, output);
+			WritePageContent(GenerateTemplate(templateDictionary, templatePath), output, reportWriter);
 		}
 	}
+
+	//-------------------------------------------------------------------------
+	struct TemplateHtmlExporter::PageTemplate
+	{
+		PageTemplate(const fs::path& path, std::vector<std::string> variables)
+			: path_{ path }
+			, variables_{ std::move(variables) }
+		{
+		}
+
+		const fs::path path_;
+		const std::vector<std::string> variables_;
+		// The pages are written on several threads.
+		std::once_flag precompileFlag_;
+		std::unique_ptr<PrecompiledTemplate> precompiledTemplate_;
+	};
 	
 	//-------------------------------------------------------------------------
 	const std::string TemplateHtmlExporter::MainTemplateItemSection = "ITEMS";
@@ -107,6 +138,7 @@ namespace Exporter
 	const std::string TemplateHtmlExporter::CodeTemplate = "CODE";
 	const std::string TemplateHtmlExporter::IdTemplate = "ID";
 	const std::string TemplateHtmlExporter::ThirdPartyPathTemplate = "THIRD_PARTY_PATH";
+	const std::string TemplateHtmlExporter::ModuleIndexTemplate = "MODULE_INDEX";
 	const std::string TemplateHtmlExporter::OCCProjectLink = "OCC_PROJECT_LINK";
 	const std::string TemplateHtmlExporter::OCCVersion = "OCC_VERSION";
 	const std::string TemplateHtmlExporter::ActualProjectLink = "https://github.com/OpenCppCoverage/OpenCppCoverage/releases";
@@ -114,12 +146,40 @@ namespace Exporter
 	//-------------------------------------------------------------------------
 	TemplateHtmlExporter::TemplateHtmlExporter(
 		const fs::path& mainTemplatePath,
-		const fs::path& fileTemplatePath)
+		const fs::path& fileTemplatePath,
+		const fs::path& moduleIndexTemplatePath)
 		: mainTemplatePath_(mainTemplatePath)
-		, fileTemplatePath_(fileTemplatePath)
+		, sourceTemplate_(std::make_unique<PageTemplate>(
+			fileTemplatePath,
+			std::vector<std::string>{
+				TitleTemplate,
+				CodeTemplate,
+				BodyOnLoadTemplate,
+				SourceWarningMessageTemplate,
+				OCCProjectLink,
+				OCCVersion,
+				ThirdPartyPathTemplate }))
+		, moduleIndexTemplate_(std::make_unique<PageTemplate>(
+			moduleIndexTemplatePath,
+			std::vector<std::string>{
+				TitleTemplate,
+				ModuleIndexTemplate,
+				OCCProjectLink,
+				OCCVersion,
+				ThirdPartyPathTemplate }))
+		, thirdPartyPath_("third-party")
 	{		
 	}
 
+	//-------------------------------------------------------------------------
+	TemplateHtmlExporter::~TemplateHtmlExporter() = default;
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::SetThirdPartyPath(const std::string& thirdPartyPath)
+	{
+		thirdPartyPath_ = thirdPartyPath;
+	}
+
 	//-------------------------------------------------------------------------
 	std::unique_ptr<ctemplate::TemplateDictionary> 
 	TemplateHtmlExporter::CreateTemplateDictionary(
@@ -149,7 +209,7 @@ namespace Exporter
 	{
 		auto sectionDictionary = moduleTemplateDictionary.AddSectionDictionary(MainTemplateItemSection);
 		
-		moduleTemplateDictionary.SetValue(ThirdPartyPathTemplate, "../third-party");
+		moduleTemplateDictionary.SetValue(ThirdPartyPathTemplate, GetThirdPartyPath(1));
 		FillSection(*sectionDictionary, isSimpleText, fileOutput, coverageRate, originalFilename);
 	}
 	
@@ -163,24 +223,26 @@ namespace Exporter
 	{
 		auto sectionDictionary = projectDictionary.AddSectionDictionary(MainTemplateItemSection);			
 			
-		projectDictionary.SetValue(ThirdPartyPathTemplate, "third-party");
+		projectDictionary.SetValue(ThirdPartyPathTemplate, GetThirdPartyPath(0));
 		FillSection(*sectionDictionary, isSimpleText, moduleOutput, coverageRate, originalFilename);
 	}				
 	
 	//-------------------------------------------------------------------------
 	void TemplateHtmlExporter::GenerateModuleTemplate(
 		const ctemplate::TemplateDictionary& templateDictionary,
-		const fs::path& output) const
+		const fs::path& output,
+		ReportWriter* reportWriter) const
 	{
-		WriteTemplate(templateDictionary, mainTemplatePath_, output);
+		WriteTemplate(templateDictionary, mainTemplatePath_, output, reportWriter);
 	}
 
 	//-------------------------------------------------------------------------
 	void TemplateHtmlExporter::GenerateProjectTemplate(
 		const ctemplate::TemplateDictionary& templateDictionary,
-		const fs::path& output) const
+		const fs::path& output,
+		ReportWriter* reportWriter) const
 	{
-		WriteTemplate(templateDictionary, mainTemplatePath_, output);
+		WriteTemplate(templateDictionary, mainTemplatePath_, output, reportWriter);
 	}
 
 	//-------------------------------------------------------------------------
@@ -188,27 +250,89 @@ namespace Exporter
 		const std::wstring& title,
 		const std::wstring& codeContent,
 		bool enableCodePrettify,
-		const fs::path& output) const
+		const fs::path& output,
+		ReportWriter* reportWriter) const
+	{
+		auto highlighting = enableCodePrettify ? SyntaxHighlighting::CodePrettify : SyntaxHighlighting::None;
+
+		GenerateSourceTemplate(title, ToString(codeContent), highlighting, output, reportWriter);
+	}
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::GenerateSourceTemplate(
+		const std::wstring& title,
+		const std::string& utf8CodeContent,
+		SyntaxHighlighting highlighting,
+		const fs::path& output,
+		ReportWriter* reportWriter) const
 	{
 		auto titleStr = ToString(title);
-		ctemplate::TemplateDictionary dictionary(titleStr);
-		std::string bodyLoad = BodyOnLoadFct;
-		std::string warning = "";
+		std::string_view bodyLoad = BodyOnLoadFct;
+		std::string_view warning = "";
 
-		if (!enableCodePrettify)
-		{
+		if (highlighting != SyntaxHighlighting::CodePrettify)
 			bodyLoad = "";
+		if (highlighting == SyntaxHighlighting::None)
 			warning = SyntaxHighlightingDisabledMsg;
+
+		auto thirdPartyPath = GetThirdPartyPath(2);
+		WritePage(
+			*sourceTemplate_,
+			{ titleStr, utf8CodeContent, bodyLoad, warning, ActualProjectLink, OPENCPPCOVERAGE_VERSION, thirdPartyPath },
+			output,
+			reportWriter);
+	}
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::GenerateModuleIndexTemplate(
+		const std::wstring& title,
+		const std::string& jsonModuleIndex,
+		const fs::path& output,
+		ReportWriter* reportWriter) const
+	{
+		auto titleStr = ToString(title);
+		auto thirdPartyPath = GetThirdPartyPath(1);
+
+		WritePage(
+			*moduleIndexTemplate_,
+			{ titleStr, jsonModuleIndex, ActualProjectLink, OPENCPPCOVERAGE_VERSION, thirdPartyPath },
+			output,
+			reportWriter);
+	}
+
+	//-------------------------------------------------------------------------
+	void TemplateHtmlExporter::WritePage(
+		PageTemplate& pageTemplate,
+		const std::vector<std::string_view>& values,
+		const fs::path& output,
+		ReportWriter* reportWriter) const
+	{
+		std::call_once(pageTemplate.precompileFlag_, [&]() {
+			pageTemplate.precompiledTemplate_ = PrecompiledTemplate::TryCreate(
+				pageTemplate.path_, pageTemplate.variables_);
+		});
+
+		if (const auto* precompiledTemplate = pageTemplate.precompiledTemplate_.get())
+		{
+			std::string content;
+
+			precompiledTemplate->Expand(values, content);
+			WritePageContent(content, output, reportWriter);
 		}
+		else
+		{
+			ctemplate::TemplateDictionary dictionary(pageTemplate.path_.string());
 
-		dictionary.SetValue(TitleTemplate, titleStr);
-		dictionary.SetValue(CodeTemplate, ToString(codeContent));
-		dictionary.SetValue(BodyOnLoadTemplate, bodyLoad);
-		dictionary.SetValue(SourceWarningMessageTemplate, warning);
-		dictionary.SetValue(OCCProjectLink, ActualProjectLink);
-		dictionary.SetValue(OCCVersion, OPENCPPCOVERAGE_VERSION);
-		WriteTemplate(dictionary, fileTemplatePath_, output);
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				dictionary.SetValue(
+					pageTemplate.variables_.at(i),
+					ctemplate::TemplateString(values[i].data(), values[i].size()));
+			}
+			WriteTemplate(dictionary, pageTemplate.path_, output, reportWriter);
+		}
 	}
+
 	//-------------------------------------------------------------------------
 	std::string TemplateHtmlExporter::GetUuid()
 	{
@@ -217,6 +341,18 @@ namespace Exporter
 		return boost::uuids::to_string(id);
 	}
 
+	//-------------------------------------------------------------------------
+	std::string TemplateHtmlExporter::GetThirdPartyPath(int depth) const
+	{
+		if (boost::algorithm::starts_with(thirdPartyPath_, "file:"))
+			return thirdPartyPath_;
+
+		std::string path;
+		for (int i = 0; i < depth; ++i)
+			path += "../";
+		return path + thirdPartyPath_;
+	}
+
 	//-------------------------------------------------------------------------
 	void TemplateHtmlExporter::FillSection(
 		ctemplate::TemplateDictionary& sectionDictionary,
@@ -17,6 +17,8 @@
 #pragma once
 
 #include <memory>
+#include <string_view>
+#include <vector>
 
 #include <filesystem>
 
@@ -24,6 +26,7 @@
 #define BOOST_ALLOW_DEPRECATED_HEADERS
 #include <boost/uuid/uuid_generators.hpp>
 #include "../ExporterExport.hpp"
+#include "SyntaxHighlighting.hpp"
 
 namespace CppCoverage
 {
@@ -40,6 +43,7 @@ namespace fs = std::filesystem;
 namespace Exporter
 {
 	class ITemplateExpander;
+	class ReportWriter;
 
 	class EXPORTER_DLL TemplateHtmlExporter
 	{
@@ -64,14 +68,24 @@ namespace Exporter
 		static const std::string CodeTemplate;
 		static const std::string IdTemplate;
 		static const std::string ThirdPartyPathTemplate;
+		static const std::string ModuleIndexTemplate;
 		static const std::string OCCProjectLink;
 		static const std::string OCCVersion;
 		static const std::string ActualProjectLink;
 
 	public:
+		// The module index template is only needed by GenerateModuleIndexTemplate.
+		// The source and module index templates are precompiled on their first
+		// use when they only have variables.
 		explicit TemplateHtmlExporter(
 			const fs::path& mainTemplatePath,
-			const fs::path& fileTemplatePath);
+			const fs::path& fileTemplatePath,
+			const fs::path& moduleIndexTemplatePath = {});
+		~TemplateHtmlExporter();
+
+		// The path of the third-party folder from the root of the report, or
+		// an absolute file URL. The default is third-party.
+		void SetThirdPartyPath(const std::string& thirdPartyPath);
 
 		std::unique_ptr<ctemplate::TemplateDictionary>	
 		CreateTemplateDictionary(const std::wstring& title, const std::wstring& message) const;
@@ -90,24 +104,54 @@ namespace Exporter
 			const fs::path* moduleOutput,
 			ctemplate::TemplateDictionary& projectDictionary);
 
+		// The pages are written with reportWriter when it is not null.
 		void GenerateModuleTemplate(
 			const ctemplate::TemplateDictionary& templateDictionary,
-			const fs::path&) const;
+			const fs::path&,
+			ReportWriter* reportWriter = nullptr) const;
 
 		void GenerateProjectTemplate(
 			const ctemplate::TemplateDictionary& templateDictionary,
-			const fs::path&) const;
+			const fs::path&,
+			ReportWriter* reportWriter = nullptr) const;
 
 		void GenerateSourceTemplate(
 			const std::wstring& title, 
 			const std::wstring& codeContent,
 			bool enableCodePrettify,
-			const fs::path& output) const;
+			const fs::path& output,
+			ReportWriter* reportWriter = nullptr) const;
+		// Same as above without converting the code already in UTF-8.
+		void GenerateSourceTemplate(
+			const std::wstring& title, 
+			const std::string& utf8CodeContent,
+			SyntaxHighlighting highlighting,
+			const fs::path& output,
+			ReportWriter* reportWriter = nullptr) const;
+
+		// Module page for the modules with many files: the files are in
+		// jsonModuleIndex (see HtmlModuleIndex) instead of the items section.
+		void GenerateModuleIndexTemplate(
+			const std::wstring& title,
+			const std::string& jsonModuleIndex,
+			const fs::path& output,
+			ReportWriter* reportWriter = nullptr) const;
 
 	private:
 		TemplateHtmlExporter(const TemplateHtmlExporter&) = delete;
 		TemplateHtmlExporter& operator=(const TemplateHtmlExporter&) = delete;
+
+		struct PageTemplate;
+
+		// values[i] is the value of the variable i of the page template.
+		void WritePage(
+			PageTemplate&,
+			const std::vector<std::string_view>& values,
+			const fs::path& output,
+			ReportWriter* reportWriter) const;
 		std::string GetUuid();
+		// The depth is the number of folders between the page and the root.
+		std::string GetThirdPartyPath(int depth) const;
 		void FillSection(
 			ctemplate::TemplateDictionary&,
 			bool isSimpleText,
@@ -117,7 +161,9 @@ namespace Exporter
 
 	private:
 		fs::path mainTemplatePath_;		
-		fs::path fileTemplatePath_;
+		std::unique_ptr<PageTemplate> sourceTemplate_;
+		std::unique_ptr<PageTemplate> moduleIndexTemplate_;
+		std::string thirdPartyPath_;
 		boost::uuids::random_generator uuidGenerator_;
 	};
 }
@@ -16,14 +16,22 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <filesystem>
+#include <utility>
+#include <vector>
 
 namespace Plugin
 {
 	class CoverageData;
 }
 
+namespace CppCoverage
+{
+	class CoverageRateComputer;
+}
+
 namespace Exporter
 {
 	class EXPORTER_DLL IExporter
@@ -34,6 +42,22 @@ namespace Exporter
 		virtual std::filesystem::path GetDefaultPath(const std::wstring& prefix) const = 0;
 		virtual void Export(const Plugin::CoverageData&, const std::filesystem::path& output) = 0;
 
+		// The coverage rates of coverageData are computed once for all the exporters.
+		virtual void Export(
+			const Plugin::CoverageData& coverageData,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& output)
+		{
+			Export(coverageData, output);
+		}
+
+		// Peak bytes of the buffers of the last export by subsystem, for --perf_stats.
+		using BufferSizes = std::vector<std::pair<std::string, uint64_t>>;
+		virtual BufferSizes GetPeakBufferSizes() const
+		{
+			return {};
+		}
+
 	private:
 		IExporter(const IExporter&) = delete;
 		IExporter& operator=(const IExporter&) = delete;
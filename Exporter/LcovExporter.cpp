@@ -0,0 +1,161 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "LcovExporter.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <string>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+#include "InvalidOutputFileException.hpp"
+#include "ReportWriter.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Exporter
+{
+	namespace
+	{
+		// The records are written when the buffer reaches this size.
+		const size_t BufferSize = 64 * 1024;
+
+		//-------------------------------------------------------------------------
+		template <typename T>
+		void AppendNumber(std::string& output, T value)
+		{
+			char buffer[32];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			output.append(buffer, result.ptr);
+		}
+
+		//-------------------------------------------------------------------------
+		void Write(std::ostream& ostream, const std::string& content)
+		{
+			ostream.write(content.data(), static_cast<std::streamsize>(content.size()));
+		}
+
+		//-------------------------------------------------------------------------
+		void AppendRecord(
+			std::string& output,
+			const CppCoverage::CoverageRateComputer& coverageRateComputer,
+			const Plugin::FileCoverage& file)
+		{
+			output += "SF:";
+			output += Tools::ToUtf8String(file.GetPath().wstring());
+			output += '\n';
+			for (const auto& line : file.GetLines())
+			{
+				// The hit count is not known for all the lines.
+				auto hitCount = line.GetHitCount();
+				if (line.HasBeenExecuted() && !hitCount)
+					hitCount = 1;
+				output += "DA:";
+				AppendNumber(output, line.GetLineNumber());
+				output += ',';
+				AppendNumber(output, line.HasBeenExecuted() ? hitCount : 0);
+				output += '\n';
+			}
+
+			const auto& coverageRate = coverageRateComputer.GetCoverageRate(file);
+			output += "LF:";
+			AppendNumber(output, coverageRate.GetTotalLinesCount());
+			output += "\nLH:";
+			AppendNumber(output, coverageRate.GetExecutedLinesCount());
+			output += "\nend_of_record\n";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	LcovExporter::LcovExporter(CppCoverage::ReportCompression compression, bool isDeterministic)
+		: compression_{ compression }
+		, isDeterministic_{ isDeterministic }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path LcovExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		std::filesystem::path path{ prefix };
+
+		path += "Coverage.info";
+
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	void LcovExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output)
+	{
+		CppCoverage::CoverageRateComputer coverageRateComputer(coverageData);
+
+		Export(coverageData, coverageRateComputer, output);
+	}
+
+	//-------------------------------------------------------------------------
+	void LcovExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const CppCoverage::CoverageRateComputer& coverageRateComputer,
+		const std::filesystem::path& output)
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+		{
+			std::ofstream ofs{ output, std::ios::binary };
+
+			if (!ofs)
+				throw InvalidOutputFileException(output, "LCOV");
+			Export(coverageData, coverageRateComputer, ofs);
+		}
+		Tools::ShowOutputMessage(L"LCOV report generated: ", output);
+		if (compression_ != CppCoverage::ReportCompression::None)
+		{
+			Tools::ShowOutputMessage(L"Report compressed in ",
+			    ReportWriter::CompressFile(output, compression_, isDeterministic_));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void LcovExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const CppCoverage::CoverageRateComputer& coverageRateComputer,
+		std::ostream& ostream) const
+	{
+		std::string output = "TN:\n";
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			for (const auto& file : module->GetFiles())
+			{
+				AppendRecord(output, coverageRateComputer, *file);
+				if (output.size() >= BufferSize)
+				{
+					Write(ostream, output);
+					output.clear();
+				}
+			}
+		}
+		Write(ostream, output);
+		ostream.flush();
+	}
+}
@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <filesystem>
+
+#include "ExporterExport.hpp"
+#include "IExporter.hpp"
+#include "CppCoverage/ReportCompression.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// LCOV tracefile: one SF/DA/LF/LH record by file, as read by genhtml.
+	class EXPORTER_DLL LcovExporter: public IExporter
+	{
+	public:
+		explicit LcovExporter(
+			CppCoverage::ReportCompression = CppCoverage::ReportCompression::None,
+			bool isDeterministic = false);
+
+		std::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& output) override;
+		// The records are written in UTF-8 file by file, without building the
+		// whole tracefile in memory.
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			std::ostream&) const;
+
+	private:
+		LcovExporter(const LcovExporter&) = delete;
+		LcovExporter& operator=(const LcovExporter&) = delete;
+
+		const CppCoverage::ReportCompression compression_;
+		const bool isDeterministic_;
+	};
+}
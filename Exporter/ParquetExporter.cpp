@@ -0,0 +1,479 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ParquetExporter.hpp"
+
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string_view>
+#include <vector>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "InvalidOutputFileException.hpp"
+
+#include "Tools/PathTable.hpp"
+#include "Tools/Tool.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		// Values of parquet.thrift.
+		const int32_t TypeBoolean = 0;
+		const int32_t TypeInt32 = 1;
+		const int32_t TypeByteArray = 6;
+		const int32_t RepetitionRequired = 0;
+		const int32_t ConvertedTypeUtf8 = 0;
+		const int32_t EncodingPlain = 0;
+		const int32_t EncodingRle = 3;
+		const int32_t EncodingRleDictionary = 8;
+		const int32_t CodecUncompressed = 0;
+		const int32_t PageTypeData = 0;
+		const int32_t PageTypeDictionary = 2;
+
+		const std::string_view Magic = "PAR1";
+
+		//---------------------------------------------------------------------
+		void AppendVarint(std::string& output, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				output += static_cast<char>((value & 0x7F) | 0x80);
+				value >>= 7;
+			}
+			output += static_cast<char>(value);
+		}
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void AppendLittleEndian(std::string& output, T value, size_t size = sizeof(T))
+		{
+			for (size_t i = 0; i < size; ++i)
+				output += static_cast<char>((static_cast<uint64_t>(value) >> (8 * i)) & 0xFF);
+		}
+
+		//---------------------------------------------------------------------
+		// Thrift compact protocol, only what the metadata of the file needs.
+		class CompactWriter
+		{
+		public:
+			enum class FieldType : uint8_t
+			{
+				I32 = 5,
+				I64 = 6,
+				Binary = 8,
+				List = 9,
+				Struct = 12
+			};
+
+			//-----------------------------------------------------------------
+			void WriteI32(int16_t fieldId, int32_t value)
+			{
+				WriteFieldHeader(fieldId, FieldType::I32);
+				WriteI32Element(value);
+			}
+
+			//-----------------------------------------------------------------
+			void WriteI64(int16_t fieldId, int64_t value)
+			{
+				WriteFieldHeader(fieldId, FieldType::I64);
+				AppendVarint(buffer_, ZigZag(value));
+			}
+
+			//-----------------------------------------------------------------
+			void WriteBinary(int16_t fieldId, std::string_view value)
+			{
+				WriteFieldHeader(fieldId, FieldType::Binary);
+				WriteBinaryElement(value);
+			}
+
+			//-----------------------------------------------------------------
+			// The elements follow with the Write*Element or BeginStruct() calls.
+			void BeginList(int16_t fieldId, FieldType elementType, size_t size)
+			{
+				WriteFieldHeader(fieldId, FieldType::List);
+				if (size < 15)
+					buffer_ += static_cast<char>((size << 4) | static_cast<uint8_t>(elementType));
+				else
+				{
+					buffer_ += static_cast<char>(0xF0 | static_cast<uint8_t>(elementType));
+					AppendVarint(buffer_, size);
+				}
+			}
+
+			//-----------------------------------------------------------------
+			void WriteI32Element(int32_t value)
+			{
+				AppendVarint(buffer_, ZigZag(value));
+			}
+
+			//-----------------------------------------------------------------
+			void WriteBinaryElement(std::string_view value)
+			{
+				AppendVarint(buffer_, value.size());
+				buffer_ += value;
+			}
+
+			//-----------------------------------------------------------------
+			// Struct of a field.
+			void BeginStruct(int16_t fieldId)
+			{
+				WriteFieldHeader(fieldId, FieldType::Struct);
+				BeginStruct();
+			}
+
+			//-----------------------------------------------------------------
+			// Root struct or element of a list.
+			void BeginStruct()
+			{
+				lastFieldIds_.push_back(0);
+			}
+
+			//-----------------------------------------------------------------
+			void EndStruct()
+			{
+				buffer_ += '\0';
+				lastFieldIds_.pop_back();
+			}
+
+			//-----------------------------------------------------------------
+			const std::string& GetBuffer() const
+			{
+				return buffer_;
+			}
+
+		private:
+			//-----------------------------------------------------------------
+			static uint64_t ZigZag(int64_t value)
+			{
+				return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+			}
+
+			//-----------------------------------------------------------------
+			void WriteFieldHeader(int16_t fieldId, FieldType type)
+			{
+				auto delta = fieldId - lastFieldIds_.back();
+
+				if (delta > 0 && delta <= 15)
+					buffer_ += static_cast<char>((delta << 4) | static_cast<uint8_t>(type));
+				else
+				{
+					buffer_ += static_cast<char>(type);
+					AppendVarint(buffer_, ZigZag(fieldId));
+				}
+				lastFieldIds_.back() = fieldId;
+			}
+
+			std::string buffer_;
+			std::vector<int16_t> lastFieldIds_;
+		};
+
+		//---------------------------------------------------------------------
+		struct Column
+		{
+			std::string name_;
+			int32_t type_;
+			bool hasDictionary_;
+			// The pages of the column, the dictionary page first.
+			std::string pages_;
+			size_t dataPageOffset_;
+		};
+
+		//---------------------------------------------------------------------
+		void AppendPage(std::string& pages,
+		                int32_t pageType,
+		                int32_t encoding,
+		                size_t valueCount,
+		                const std::string& data)
+		{
+			CompactWriter header;
+
+			header.BeginStruct();
+			header.WriteI32(1, pageType);
+			header.WriteI32(2, static_cast<int32_t>(data.size()));
+			header.WriteI32(3, static_cast<int32_t>(data.size()));
+			if (pageType == PageTypeDictionary)
+			{
+				header.BeginStruct(7);
+				header.WriteI32(1, static_cast<int32_t>(valueCount));
+				header.WriteI32(2, encoding);
+				header.EndStruct();
+			}
+			else
+			{
+				header.BeginStruct(5);
+				header.WriteI32(1, static_cast<int32_t>(valueCount));
+				header.WriteI32(2, encoding);
+				header.WriteI32(3, EncodingRle);
+				header.WriteI32(4, EncodingRle);
+				header.EndStruct();
+			}
+			header.EndStruct();
+			pages += header.GetBuffer();
+			pages += data;
+		}
+
+		//---------------------------------------------------------------------
+		// The indices are written as runs of the RLE / bit-packing hybrid
+		// encoding: the rows of a file follow each other.
+		Column CreateDictionaryColumn(std::string name,
+		                              const std::vector<std::string>& dictionary,
+		                              const std::vector<uint32_t>& indices)
+		{
+			Column column{ std::move(name), TypeByteArray, true, {}, 0 };
+			std::string values;
+
+			for (const auto& value : dictionary)
+			{
+				AppendLittleEndian(values, static_cast<uint32_t>(value.size()));
+				values += value;
+			}
+			AppendPage(column.pages_, PageTypeDictionary, EncodingPlain, dictionary.size(), values);
+			column.dataPageOffset_ = column.pages_.size();
+
+			uint8_t bitWidth = 1;
+			while ((uint64_t{ 1 } << bitWidth) < dictionary.size())
+				++bitWidth;
+			const size_t byteWidth = (bitWidth + 7) / 8;
+
+			std::string runs(1, static_cast<char>(bitWidth));
+			for (size_t i = 0; i < indices.size();)
+			{
+				auto end = i;
+				while (end < indices.size() && indices[end] == indices[i])
+					++end;
+				AppendVarint(runs, static_cast<uint64_t>(end - i) << 1);
+				AppendLittleEndian(runs, indices[i], byteWidth);
+				i = end;
+			}
+			AppendPage(column.pages_, PageTypeData, EncodingRleDictionary, indices.size(), runs);
+			return column;
+		}
+
+		//---------------------------------------------------------------------
+		Column CreateInt32Column(std::string name, const std::vector<int32_t>& values)
+		{
+			Column column{ std::move(name), TypeInt32, false, {}, 0 };
+			std::string data;
+
+			data.reserve(values.size() * sizeof(int32_t));
+			for (auto value : values)
+				AppendLittleEndian(data, static_cast<uint32_t>(value));
+			AppendPage(column.pages_, PageTypeData, EncodingPlain, values.size(), data);
+			return column;
+		}
+
+		//---------------------------------------------------------------------
+		Column CreateBooleanColumn(std::string name, const std::vector<bool>& values)
+		{
+			Column column{ std::move(name), TypeBoolean, false, {}, 0 };
+			std::string data((values.size() + 7) / 8, '\0');
+
+			for (size_t i = 0; i < values.size(); ++i)
+			{
+				if (values[i])
+					data[i / 8] |= static_cast<char>(1 << (i % 8));
+			}
+			AppendPage(column.pages_, PageTypeData, EncodingPlain, values.size(), data);
+			return column;
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::string> GetDictionary(const Tools::PathTable& pathTable)
+		{
+			std::vector<std::string> dictionary;
+
+			for (size_t id = 0; id < pathTable.GetCount(); ++id)
+				dictionary.push_back(Tools::ToUtf8String(pathTable.GetPath(id).wstring()));
+			return dictionary;
+		}
+
+		//---------------------------------------------------------------------
+		void WriteSchemaElement(CompactWriter& writer, const Column& column)
+		{
+			writer.BeginStruct();
+			writer.WriteI32(1, column.type_);
+			writer.WriteI32(3, RepetitionRequired);
+			writer.WriteBinary(4, column.name_);
+			if (column.type_ == TypeByteArray)
+				writer.WriteI32(6, ConvertedTypeUtf8);
+			writer.EndStruct();
+		}
+
+		//---------------------------------------------------------------------
+		void WriteColumnChunk(CompactWriter& writer, const Column& column, size_t offset, size_t rowCount)
+		{
+			using FieldType = CompactWriter::FieldType;
+
+			writer.BeginStruct();
+			writer.WriteI64(2, offset);
+			writer.BeginStruct(3);
+			writer.WriteI32(1, column.type_);
+			writer.BeginList(2, FieldType::I32, column.hasDictionary_ ? 3 : 2);
+			writer.WriteI32Element(EncodingPlain);
+			writer.WriteI32Element(EncodingRle);
+			if (column.hasDictionary_)
+				writer.WriteI32Element(EncodingRleDictionary);
+			writer.BeginList(3, FieldType::Binary, 1);
+			writer.WriteBinaryElement(column.name_);
+			writer.WriteI32(4, CodecUncompressed);
+			writer.WriteI64(5, rowCount);
+			writer.WriteI64(6, column.pages_.size());
+			writer.WriteI64(7, column.pages_.size());
+			writer.WriteI64(9, offset + column.dataPageOffset_);
+			if (column.hasDictionary_)
+				writer.WriteI64(11, offset);
+			writer.EndStruct();
+			writer.EndStruct();
+		}
+
+		//---------------------------------------------------------------------
+		std::string GetLocalTime()
+		{
+			auto now = std::time(nullptr);
+			auto localNow = std::localtime(&now);
+			std::ostringstream ostr;
+
+			ostr << std::put_time(localNow, "%Y-%m-%d %H:%M:%S");
+			return ostr.str();
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	ParquetExporter::ParquetExporter()
+		: ParquetExporter{ GetLocalTime() }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	ParquetExporter::ParquetExporter(std::string run)
+		: run_{ std::move(run) }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path ParquetExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		std::filesystem::path path{ prefix };
+
+		path += "Coverage.parquet";
+
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	void ParquetExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output)
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+		std::ofstream ofs{ output, std::ios::binary };
+
+		if (!ofs)
+			throw InvalidOutputFileException(output, "parquet");
+		Export(coverageData, ofs);
+		Tools::ShowOutputMessage(L"Parquet file generated: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	void ParquetExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		std::ostream& ostream) const
+	{
+		Tools::PathTable modulePaths;
+		Tools::PathTable filePaths;
+		std::vector<uint32_t> moduleIds;
+		std::vector<uint32_t> fileIds;
+		std::vector<int32_t> lineNumbers;
+		std::vector<bool> executedLines;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			auto moduleId = static_cast<uint32_t>(modulePaths.Intern(module->GetPath()));
+
+			for (const auto& file : module->GetFiles())
+			{
+				auto fileId = static_cast<uint32_t>(filePaths.Intern(file->GetPath()));
+
+				for (const auto& line : file->GetLines())
+				{
+					moduleIds.push_back(moduleId);
+					fileIds.push_back(fileId);
+					lineNumbers.push_back(static_cast<int32_t>(line.GetLineNumber()));
+					executedLines.push_back(line.HasBeenExecuted());
+				}
+			}
+		}
+
+		const auto rowCount = lineNumbers.size();
+		std::vector<Column> columns;
+		columns.push_back(CreateDictionaryColumn("run", { run_ }, std::vector<uint32_t>(rowCount, 0)));
+		columns.push_back(CreateDictionaryColumn("module", GetDictionary(modulePaths), moduleIds));
+		columns.push_back(CreateDictionaryColumn("file", GetDictionary(filePaths), fileIds));
+		columns.push_back(CreateInt32Column("line", lineNumbers));
+		columns.push_back(CreateBooleanColumn("executed", executedLines));
+
+		using FieldType = CompactWriter::FieldType;
+		CompactWriter metadata;
+		metadata.BeginStruct();
+		metadata.WriteI32(1, 1);
+		metadata.BeginList(2, FieldType::Struct, columns.size() + 1);
+		metadata.BeginStruct();
+		metadata.WriteBinary(4, "schema");
+		metadata.WriteI32(5, static_cast<int32_t>(columns.size()));
+		metadata.EndStruct();
+		for (const auto& column : columns)
+			WriteSchemaElement(metadata, column);
+		metadata.WriteI64(3, rowCount);
+
+		// A row group without rows is not written.
+		metadata.BeginList(4, FieldType::Struct, rowCount ? 1 : 0);
+		size_t offset = Magic.size();
+		if (rowCount)
+		{
+			size_t totalSize = 0;
+			metadata.BeginStruct();
+			metadata.BeginList(1, FieldType::Struct, columns.size());
+			for (const auto& column : columns)
+			{
+				WriteColumnChunk(metadata, column, offset + totalSize, rowCount);
+				totalSize += column.pages_.size();
+			}
+			metadata.WriteI64(2, totalSize);
+			metadata.WriteI64(3, rowCount);
+			metadata.EndStruct();
+		}
+		metadata.WriteBinary(6, "OpenCppCoverage");
+		metadata.EndStruct();
+
+		ostream.write(Magic.data(), Magic.size());
+		if (rowCount)
+		{
+			for (const auto& column : columns)
+				ostream.write(column.pages_.data(), static_cast<std::streamsize>(column.pages_.size()));
+		}
+		std::string footer = metadata.GetBuffer();
+		AppendLittleEndian(footer, static_cast<uint32_t>(metadata.GetBuffer().size()));
+		footer += Magic;
+		ostream.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+	}
+}
@@ -0,0 +1,54 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <filesystem>
+#include <string>
+
+#include "ExporterExport.hpp"
+#include "IExporter.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Parquet file with one row by line: run, module, file, line, executed.
+	// The module and file columns are dictionary encoded with the ids of a
+	// Tools::PathTable and the dictionary indices are run length encoded, so
+	// the size of the file is close to the size of the line numbers.
+	class EXPORTER_DLL ParquetExporter: public IExporter
+	{
+	public:
+		// The run is the local time of the export.
+		ParquetExporter();
+		explicit ParquetExporter(std::string run);
+
+		std::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(const Plugin::CoverageData&, std::ostream&) const;
+
+	private:
+		ParquetExporter(const ParquetExporter&) = delete;
+		ParquetExporter& operator=(const ParquetExporter&) = delete;
+
+		const std::string run_;
+	};
+}
@@ -17,6 +17,7 @@
 #include "stdafx.h"
 #include "ExporterPluginManager.hpp"
 
+#include <fstream>
 #include <optional>
 
 #include "Plugin/OptionsParserException.hpp"
@@ -31,6 +32,8 @@ namespace Exporter
 {
 	namespace
 	{
+		const std::string ManifestHeader = "OpenCppCoverage export plugin manifest 1";
+
 		//---------------------------------------------------------------------
 		std::string
 		InvalidPluginError(const std::optional<std::string>& functionName,
@@ -65,9 +68,20 @@ namespace Exporter
 			    });
 		}
 
+		//---------------------------------------------------------------------
+		void ShowOutputMessage(const std::wstring& pluginName,
+		                       const std::optional<std::filesystem::path>& optionalOutput)
+		{
+			if (optionalOutput)
+			{
+				Tools::ShowOutputMessage(
+				    pluginName + L" has generated the report at ", *optionalOutput);
+			}
+		}
+
 		//---------------------------------------------------------------------
 		void CheckVersion(const Plugin::IExportPlugin& exportPlugin,
-		                  const std::filesystem::path& pluginPath)
+		                 const std::filesystem::path& pluginPath)
 		{
 			const auto functionName = "GetExportPluginVersion";
 			auto pluginVersion = CallPluginfunction(
@@ -75,6 +89,7 @@ namespace Exporter
 			    functionName,
 			    pluginPath);
 			auto currentVersion = Plugin::CurrentExportPluginVersion;
+			// The interface is not binary compatible between the versions.
 			if (pluginVersion != currentVersion)
 			{
 				auto error =
@@ -86,13 +101,93 @@ namespace Exporter
 				    InvalidPluginError(functionName, error, pluginPath));
 			}
 		}
+
+		//---------------------------------------------------------------------
+		void CheckArgument(Plugin::IExportPlugin& exportPlugin,
+		                   const std::filesystem::path& pluginPath,
+		                   const std::optional<std::wstring>& parameter)
+		{
+			std::string error;
+			try
+			{
+				exportPlugin.CheckArgument(parameter);
+				return;
+			}
+			catch (const Plugin::OptionsParserException&)
+			{
+				throw;
+			}
+			catch (const std::exception& e)
+			{
+				error = e.what();
+			}
+			catch (...)
+			{
+				error = "Unknow";
+			}
+
+			auto fullErrorMessage = InvalidPluginError("CheckArgument", error, pluginPath);
+			throw std::runtime_error(fullErrorMessage);
+		}
+
+		//---------------------------------------------------------------------
+		// Return the argument help description or std::nullopt when the
+		// manifest does not exist.
+		std::optional<std::wstring> ReadManifest(const std::filesystem::path& manifestPath,
+		                                         const std::filesystem::path& pluginPath)
+		{
+			if (!Tools::FileExists(manifestPath))
+				return std::nullopt;
+
+			std::ifstream ifs{manifestPath, std::ios::binary};
+			std::string header;
+			std::string argumentHelpDescription;
+
+			std::getline(ifs, header);
+			std::getline(ifs, argumentHelpDescription);
+			for (auto* line : {&header, &argumentHelpDescription})
+			{
+				if (!line->empty() && line->back() == '\r')
+					line->pop_back();
+			}
+			if (!ifs || header != ManifestHeader)
+			{
+				throw std::runtime_error(InvalidPluginError(
+				    std::nullopt, "Invalid manifest " + manifestPath.string(), pluginPath));
+			}
+			return Tools::Utf8ToWString(argumentHelpDescription);
+		}
+
+		//---------------------------------------------------------------------
+		bool IsThreadSafePlugin(const Plugin::IExportPlugin& exportPlugin,
+		                        const std::filesystem::path& pluginPath)
+		{
+			return CallPluginfunction(
+			    [&]() { return exportPlugin.IsThreadSafe(); },
+			    "IsThreadSafe",
+			    pluginPath);
+		}
 	}
 
+	//-------------------------------------------------------------------------
+	struct ExporterPluginManager::PluginEntry
+	{
+		std::filesystem::path path_;
+		// Read from the manifest.
+		std::optional<std::wstring> argumentHelpDescription_;
+		// Null until the plugin is loaded.
+		std::shared_ptr<LoadedPlugin<Plugin::IExportPlugin>> plugin_;
+		bool isThreadSafe_ = false;
+	};
+
+	//-------------------------------------------------------------------------
+	const std::wstring ExporterPluginManager::ManifestExtension = L".pluginmanifest";
+
 	//-------------------------------------------------------------------------
 	ExporterPluginManager::ExporterPluginManager(
-	    const IPluginLoader<Plugin::IExportPlugin>& pluginLoader,
+	    std::shared_ptr<const IPluginLoader<Plugin::IExportPlugin>> pluginLoader,
 	    std::filesystem::path&& pluginFolder)
-	    : pluginFolder_{std::move(pluginFolder)}
+	    : pluginLoader_{std::move(pluginLoader)}, pluginFolder_{std::move(pluginFolder)}
 	{
 		for (auto pluginPath :
 		     std::filesystem::directory_iterator(pluginFolder_))
@@ -102,19 +197,14 @@ namespace Exporter
 			if (path.extension() != ".dll")
 				continue;
 
-			auto pluginName = path.stem().wstring();
-			const std::string pluginFactoryFctName = "CreatePlugin";
-
-			auto plugin = Tools::Try<std::runtime_error>(
-			    [&]() {
-				    return pluginLoader.TryLoadPlugin(pluginPath,
-				                                      pluginFactoryFctName);
-			    },
-			    [&](const auto& error) {
-				    return InvalidPluginError(std::nullopt, error, path);
-			    });
-			CheckVersion(plugin->Get(), path);
-			plugins_.emplace(pluginName, std::move(plugin));
+			auto plugin = std::make_shared<PluginEntry>();
+			plugin->path_ = path;
+			auto manifestPath = path;
+			manifestPath.replace_extension(ManifestExtension);
+			plugin->argumentHelpDescription_ = ReadManifest(manifestPath, path);
+			if (!plugin->argumentHelpDescription_)
+				Load(*plugin);
+			plugins_.emplace(path.stem().wstring(), std::move(plugin));
 		}
 	}
 
@@ -122,36 +212,36 @@ namespace Exporter
 	ExporterPluginManager::~ExporterPluginManager() = default;
 
 	//-------------------------------------------------------------------------
-	void
-	CheckArgument(const std::weak_ptr<LoadedPlugin<Plugin::IExportPlugin>>& weakPlugin,
-	              const std::filesystem::path& pluginPath,
-	              const std::optional<std::wstring>& parameter)
+	void ExporterPluginManager::Load(PluginEntry& plugin) const
 	{
-		auto p = weakPlugin.lock();
-		if (!p)
-			THROW("Plugin was released");
+		const auto& path = plugin.path_;
+		const std::string pluginFactoryFctName = "CreatePlugin";
 
-		std::string error;
-		try
-		{
-			p->Get().CheckArgument(parameter);
-			return;
-		}
-		catch (const Plugin::OptionsParserException&)
-		{
-			throw;
-		}
-		catch (const std::exception& e)
-		{
-			error = e.what();
-		}
-		catch (...)
-		{
-			error = "Unknow";
-		}
+		auto loadedPlugin = Tools::Try<std::runtime_error>(
+		    [&]() {
+			    return pluginLoader_->TryLoadPlugin(path, pluginFactoryFctName);
+		    },
+		    [&](const auto& error) {
+			    return InvalidPluginError(std::nullopt, error, path);
+		    });
+		CheckVersion(loadedPlugin->Get(), path);
+		plugin.isThreadSafe_ = IsThreadSafePlugin(loadedPlugin->Get(), path);
+		plugin.plugin_ = std::move(loadedPlugin);
+	}
+
+	//-------------------------------------------------------------------------
+	const ExporterPluginManager::PluginEntry&
+	ExporterPluginManager::GetLoadedPlugin(const std::wstring& pluginName) const
+	{
+		auto it = plugins_.find(pluginName);
+		if (it == plugins_.end())
+			THROW("Cannot find plugin: " << pluginName);
 
-		auto fullErrorMessage = InvalidPluginError("CheckArgument", error, pluginPath);
-		throw std::runtime_error(fullErrorMessage);
+		auto& plugin = *it->second;
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (!plugin.plugin_)
+			Load(plugin);
+		return plugin;
 	}
 
 	//-------------------------------------------------------------------------
@@ -164,24 +254,28 @@ namespace Exporter
 		for (const auto& plugin : plugins_)
 		{
 			const auto& pluginName = plugin.first;
-			const auto& exportPlugin = plugin.second;
-			const auto pluginPath = pluginFolder_ / (pluginName + L".dll");
+			const auto& pluginEntry = plugin.second;
 
-			auto helpDescription = CallPluginfunction(
-			    [&]() { return exportPlugin->Get().GetArgumentHelpDescription(); },
-			    "GetHelpDescription",
-			    pluginPath);
+			auto helpDescription = pluginEntry->argumentHelpDescription_
+			    ? *pluginEntry->argumentHelpDescription_
+			    : CallPluginfunction(
+			          [&]() { return pluginEntry->plugin_->Get().GetArgumentHelpDescription(); },
+			          "GetHelpDescription",
+			          pluginEntry->path_);
 
-			std::weak_ptr<LoadedPlugin<Plugin::IExportPlugin>> weakPlugin{exportPlugin};
+			std::weak_ptr<PluginEntry> weakPlugin{pluginEntry};
 
 			exportPluginDescriptions.push_back(
 			    CppCoverage::ExportPluginDescription{
 			        std::wstring{pluginName},
 			        std::move(helpDescription),
-			        [weakPlugin, pluginPath, this](
+			        [weakPlugin, pluginName, this](
 			            const std::optional<std::wstring>& parameter) {
-					CheckArgument(weakPlugin, pluginPath, parameter);
-				}});
+				        if (weakPlugin.expired())
+					        THROW("Plugin was released");
+				        const auto& loadedPlugin = GetLoadedPlugin(pluginName);
+				        CheckArgument(loadedPlugin.plugin_->Get(), loadedPlugin.path_, parameter);
+			        }});
 		}
 
 		return exportPluginDescriptions;
@@ -192,20 +286,57 @@ namespace Exporter
 	ExporterPluginManager::Export(const std::wstring& pluginName,
 	                              const Plugin::CoverageData& coverageData,
 	                              const std::optional<std::wstring>& argument) const
+	{
+		const auto& plugin = GetLoadedPlugin(pluginName);
+
+		ShowOutputMessage(pluginName,
+		                  CallPluginfunction(
+		                      [&]() { return plugin.plugin_->Get().Export(coverageData, argument); },
+		                      "Export",
+		                      plugin.path_));
+	}
+
+	//-------------------------------------------------------------------------
+	void
+	ExporterPluginManager::Export(const std::wstring& pluginName,
+	                              const Plugin::CoverageDataView& coverageDataView,
+	                              const std::optional<std::wstring>& argument) const
+	{
+		const auto& plugin = GetLoadedPlugin(pluginName);
+
+		ShowOutputMessage(pluginName,
+		                  CallPluginfunction(
+		                      [&]() { return plugin.plugin_->Get().ExportView(coverageDataView, argument); },
+		                      "ExportView",
+		                      plugin.path_));
+	}
+
+	//-------------------------------------------------------------------------
+	bool ExporterPluginManager::IsThreadSafe(const std::wstring& pluginName) const
 	{
 		auto it = plugins_.find(pluginName);
-		if (it == plugins_.end())
-			THROW("Cannot find plugin: " << pluginName);
-		auto& plugin = it->second;
 
-		auto optionalOutput = CallPluginfunction(
-		    [&]() { return plugin->Get().Export(coverageData, argument); },
-		    "Export",
-		    pluginFolder_ / pluginName);
-		if (optionalOutput)
-		{
-			Tools::ShowOutputMessage(
-			    pluginName + L" has generated the report at ", *optionalOutput);
-		}
+		return it != plugins_.end() && GetLoadedPlugin(pluginName).isThreadSafe_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool ExporterPluginManager::IsLoaded(const std::wstring& pluginName) const
+	{
+		auto it = plugins_.find(pluginName);
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		return it != plugins_.end() && it->second->plugin_;
+	}
+
+	//-------------------------------------------------------------------------
+	void ExporterPluginManager::WriteManifest(
+	    const std::filesystem::path& manifestPath,
+	    const std::wstring& argumentHelpDescription)
+	{
+		std::ofstream ofs{manifestPath, std::ios::binary};
+
+		ofs << ManifestHeader << '\n' << Tools::ToUtf8String(argumentHelpDescription) << '\n';
+		if (!ofs)
+			THROW(L"Cannot write " << manifestPath.wstring());
 	}
 }
@@ -22,6 +22,7 @@
 #include <string>
 #include <filesystem>
 #include <unordered_map>
+#include <mutex>
 #include <optional>
 
 #include "CppCoverage/ExportPluginDescription.hpp"
@@ -29,6 +30,7 @@
 namespace Plugin
 {
 	class CoverageData;
+	class CoverageDataView;
 	class IExportPlugin;
 }
 
@@ -43,8 +45,16 @@ namespace Exporter
 	class EXPORTER_DLL ExporterPluginManager
 	{
 	  public:
-		explicit ExporterPluginManager(const IPluginLoader<Plugin::IExportPlugin>&,
-		                               std::filesystem::path&& pluginFolder);
+		// A plugin with a manifest <plugin name>.pluginmanifest next to its
+		// dll is loaded only when it is used. The manifest is a UTF-8 file:
+		//     OpenCppCoverage export plugin manifest 1
+		//     <argument help description>
+		static const std::wstring ManifestExtension;
+
+	  public:
+		explicit ExporterPluginManager(
+		    std::shared_ptr<const IPluginLoader<Plugin::IExportPlugin>>,
+		    std::filesystem::path&& pluginFolder);
 		~ExporterPluginManager();
 
 		ExporterPluginManager(const ExporterPluginManager&) = delete;
@@ -59,11 +69,30 @@ namespace Exporter
 		void Export(const std::wstring& pluginName,
 		            const Plugin::CoverageData&,
 		            const std::optional<std::wstring>& argument) const;
+		void Export(const std::wstring& pluginName,
+		            const Plugin::CoverageDataView&,
+		            const std::optional<std::wstring>& argument) const;
+
+		// Return true if the plugin can export while the other exports are
+		// performed.
+		bool IsThreadSafe(const std::wstring& pluginName) const;
+
+		// Return true if the plugin has been loaded.
+		bool IsLoaded(const std::wstring& pluginName) const;
+
+		static void WriteManifest(const std::filesystem::path& manifestPath,
+		                          const std::wstring& argumentHelpDescription);
 
 	  private:
-		std::unordered_map<std::wstring,
-		                   std::shared_ptr<LoadedPlugin<Plugin::IExportPlugin>>>
-		    plugins_;
+		struct PluginEntry;
+
+		// Load the plugin if needed. Can be called from several threads.
+		const PluginEntry& GetLoadedPlugin(const std::wstring& pluginName) const;
+		void Load(PluginEntry&) const;
+
+		std::shared_ptr<const IPluginLoader<Plugin::IExportPlugin>> pluginLoader_;
+		std::unordered_map<std::wstring, std::shared_ptr<PluginEntry>> plugins_;
 		std::filesystem::path pluginFolder_;
+		mutable std::mutex mutex_;
 	};
 }
@@ -0,0 +1,154 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SharedCoverageSection.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <sstream>
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+#include "Tools/ScopedAction.hpp"
+#include "Tools/Tool.hpp"
+
+#include "../Binary/CoverageDataSerializer.hpp"
+#include "../Binary/CoverageDataDeserializer.hpp"
+#include "../ExporterException.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		// The content is preceded by its size.
+		using ContentSize = uint64_t;
+
+		//---------------------------------------------------------------------
+		std::wstring CreateSectionName()
+		{
+			static std::atomic<unsigned int> sectionCount{0};
+
+			return L"Local\\OpenCppCoverage.Coverage." + std::to_wstring(GetCurrentProcessId()) +
+			       L'.' + std::to_wstring(sectionCount++);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<SharedCoverageSection>
+	SharedCoverageSection::Create(const Plugin::CoverageData& coverageData)
+	{
+		std::ostringstream ostr;
+		CoverageDataSerializer{}.Serialize(coverageData, ostr);
+		const auto content = ostr.str();
+		const auto sectionSize = static_cast<uint64_t>(sizeof(ContentSize) + content.size());
+		auto name = CreateSectionName();
+
+		auto hMapping = CreateFileMappingW(INVALID_HANDLE_VALUE,
+		                                   nullptr,
+		                                   PAGE_READWRITE,
+		                                   static_cast<DWORD>(sectionSize >> 32),
+		                                   static_cast<DWORD>(sectionSize),
+		                                   name.c_str());
+		if (!hMapping)
+			THROW(L"Cannot create the shared section " << name << L": " << GetLastError());
+		Tools::ScopedAction closeMapping{[&]() {
+			if (hMapping)
+				CloseHandle(hMapping);
+		}};
+
+		auto view = MapViewOfFile(hMapping, FILE_MAP_WRITE, 0, 0, 0);
+		if (!view)
+			THROW(L"Cannot map the shared section " << name << L": " << GetLastError());
+
+		auto contentSize = static_cast<ContentSize>(content.size());
+		std::memcpy(view, &contentSize, sizeof(contentSize));
+		std::memcpy(static_cast<char*>(view) + sizeof(contentSize), content.data(), content.size());
+
+		std::unique_ptr<SharedCoverageSection> section{
+		    new SharedCoverageSection{std::move(name), hMapping, view}};
+		hMapping = nullptr;
+		return section;
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<SharedCoverageSection> SharedCoverageSection::Open(const std::wstring& name)
+	{
+		auto hMapping = OpenFileMappingW(FILE_MAP_READ, FALSE, name.c_str());
+		if (!hMapping)
+			THROW(L"Cannot open the shared section " << name << L": " << GetLastError());
+		Tools::ScopedAction closeMapping{[&]() {
+			if (hMapping)
+				CloseHandle(hMapping);
+		}};
+
+		auto view = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view)
+			THROW(L"Cannot map the shared section " << name << L": " << GetLastError());
+
+		std::unique_ptr<SharedCoverageSection> section{
+		    new SharedCoverageSection{std::wstring{name}, hMapping, view}};
+		hMapping = nullptr;
+		return section;
+	}
+
+	//-------------------------------------------------------------------------
+	SharedCoverageSection::SharedCoverageSection(std::wstring&& name, HANDLE hMapping, const void* view)
+	    : name_{std::move(name)}, hMapping_{hMapping}, view_{view}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	SharedCoverageSection::~SharedCoverageSection()
+	{
+		UnmapViewOfFile(view_);
+		CloseHandle(hMapping_);
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring& SharedCoverageSection::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	std::string_view SharedCoverageSection::GetContent() const
+	{
+		MEMORY_BASIC_INFORMATION memoryInformation{};
+		ContentSize contentSize = 0;
+
+		// The view can be bigger than the section: its size is rounded to a page.
+		if (!VirtualQuery(view_, &memoryInformation, sizeof(memoryInformation)))
+			THROW(L"Cannot query the shared section " << name_ << L": " << GetLastError());
+		std::memcpy(&contentSize, view_, sizeof(contentSize));
+		if (contentSize > memoryInformation.RegionSize - sizeof(contentSize))
+			THROW(L"Invalid shared section " << name_);
+		return {static_cast<const char*>(view_) + sizeof(contentSize), static_cast<size_t>(contentSize)};
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData SharedCoverageSection::Read() const
+	{
+		auto content = GetContent();
+		boost::iostreams::stream<boost::iostreams::array_source> istr{content.data(), content.size()};
+
+		return CoverageDataDeserializer{}.Deserialize(
+		    istr, "Cannot extract coverage data from the shared section " + Tools::ToLocalString(name_));
+	}
+}
@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <Windows.h>
+
+#include "../ExporterExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace Exporter
+{
+	// Binary coverage content of the version 2 in a named memory section
+	// backed by the paging file. The content is written once by the owner of
+	// the section and the export plugin processes map it read-only. Its paths
+	// are stored once in the path table and its lines as columns.
+	class EXPORTER_DLL SharedCoverageSection
+	{
+	public:
+		// The name is unique in the session.
+		static std::unique_ptr<SharedCoverageSection> Create(const Plugin::CoverageData&);
+		static std::unique_ptr<SharedCoverageSection> Open(const std::wstring& name);
+		~SharedCoverageSection();
+
+		const std::wstring& GetName() const;
+		// The bytes point into the mapping and are valid until this object is destroyed.
+		std::string_view GetContent() const;
+		Plugin::CoverageData Read() const;
+
+	private:
+		SharedCoverageSection(std::wstring&& name, HANDLE hMapping, const void* view);
+		SharedCoverageSection(const SharedCoverageSection&) = delete;
+		SharedCoverageSection& operator=(const SharedCoverageSection&) = delete;
+
+		const std::wstring name_;
+		const HANDLE hMapping_;
+		const void* const view_;
+	};
+}
@@ -0,0 +1,460 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ReportWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <iterator>
+#include <limits>
+#include <system_error>
+
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+#include "Tools/Tool.hpp"
+
+#include "ExporterException.hpp"
+
+namespace fs = std::filesystem;
+namespace io = boost::iostreams;
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		const uint32_t ZipLocalHeaderSignature = 0x04034b50;
+		const uint32_t ZipCentralHeaderSignature = 0x02014b50;
+		const uint32_t ZipEndSignature = 0x06054b50;
+		const uint32_t Zip64EndSignature = 0x06064b50;
+		const uint32_t Zip64EndLocatorSignature = 0x07064b50;
+		const uint16_t ZipVersion = 20;
+		const uint16_t Zip64Version = 45;
+		const uint16_t ZipUtf8NameFlag = 0x0800;
+		const uint16_t ZipStoredMethod = 0;
+		const uint16_t ZipDeflatedMethod = 8;
+		const std::string GzipManifestHeader = "OpenCppCoverage gzip manifest 1";
+		const uint16_t ZipMinDosDate = (1 << 5) | 1;
+
+		//---------------------------------------------------------------------
+		template <typename T>
+		void AddLittleEndian(std::string& buffer, T value)
+		{
+			for (size_t i = 0; i < sizeof(T); ++i)
+				buffer += static_cast<char>((static_cast<uint64_t>(value) >> (i * 8)) & 0xFF);
+		}
+
+		//---------------------------------------------------------------------
+		std::array<uint32_t, 256> CreateCrc32Table()
+		{
+			std::array<uint32_t, 256> table;
+
+			for (uint32_t i = 0; i < table.size(); ++i)
+			{
+				auto value = i;
+				for (int bit = 0; bit < 8; ++bit)
+					value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+				table[i] = value;
+			}
+			return table;
+		}
+
+		//---------------------------------------------------------------------
+		uint32_t ComputeCrc32(std::string_view content)
+		{
+			static const auto table = CreateCrc32Table();
+			uint32_t crc = 0xFFFFFFFF;
+
+			for (auto c : content)
+				crc = table[(crc ^ static_cast<unsigned char>(c)) & 0xFF] ^ (crc >> 8);
+			return crc ^ 0xFFFFFFFF;
+		}
+
+		//---------------------------------------------------------------------
+		template <typename Filter>
+		std::string ApplyFilter(std::string_view content, Filter filter)
+		{
+			std::string filteredContent;
+			{
+				io::filtering_ostream ostr;
+
+				ostr.push(filter);
+				ostr.push(io::back_inserter(filteredContent));
+				ostr.write(content.data(), content.size());
+			}
+			return filteredContent;
+		}
+
+		//---------------------------------------------------------------------
+		std::string ReadContent(const fs::path& path)
+		{
+			std::ifstream ifs{ path, std::ios::binary };
+
+			if (!ifs)
+				THROW(L"Cannot read " << path);
+			return std::string{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+		}
+
+		//---------------------------------------------------------------------
+		void WriteContent(const fs::path& path, std::string_view content)
+		{
+			std::ofstream ofs{ path, std::ios::binary };
+
+			if (!ofs)
+				THROW(L"Cannot open file" << path);
+			ofs.write(content.data(), content.size());
+		}
+
+		//---------------------------------------------------------------------
+		fs::path AddExtension(fs::path path, const std::wstring& extension)
+		{
+			path += extension;
+			return path;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring ReportWriter::GzipManifestFilename = L"GzipManifest.txt";
+	const std::wstring ReportWriter::GzipExtension = L".gz";
+	const std::wstring ReportWriter::ZipExtension = L".zip";
+
+	//-------------------------------------------------------------------------
+	ReportWriter::ReportWriter(
+		const fs::path& root,
+		cov::ReportCompression compression,
+		bool isDeterministic)
+		: root_{ root }
+		, compression_{ compression }
+		, zipOffset_{ 0 }
+		, dosTime_{ 0 }
+		, dosDate_{ ZipMinDosDate }
+		, isDeterministic_{ isDeterministic }
+		, isClosed_{ false }
+	{
+		if (compression_ != cov::ReportCompression::Zip)
+			return;
+
+		if (!isDeterministic_)
+		{
+			auto now = std::time(nullptr);
+			const auto* localNow = std::localtime(&now);
+			dosTime_ = static_cast<uint16_t>((localNow->tm_hour << 11) | (localNow->tm_min << 5) | (localNow->tm_sec / 2));
+			dosDate_ = static_cast<uint16_t>(((localNow->tm_year - 80) << 9) | ((localNow->tm_mon + 1) << 5) | localNow->tm_mday);
+		}
+
+		auto zipPath = AddExtension(root_, ZipExtension);
+		Tools::CreateParentFolderIfNeeded(zipPath);
+		zip_.open(zipPath, std::ios::binary);
+		if (!zip_)
+			THROW(L"Cannot open file" << zipPath);
+	}
+
+	//-------------------------------------------------------------------------
+	ReportWriter::~ReportWriter()
+	{
+		// An archive without central directory cannot be read.
+		if (zip_.is_open())
+		{
+			zip_.close();
+			std::error_code error;
+			fs::remove(AddExtension(root_, ZipExtension), error);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	cov::ReportCompression ReportWriter::GetCompression() const
+	{
+		return compression_;
+	}
+
+	//-------------------------------------------------------------------------
+	void ReportWriter::WriteFile(const fs::path& path, std::string_view content)
+	{
+		switch (compression_)
+		{
+			case cov::ReportCompression::None:
+				fileWriter_.Write(path, std::string{ content });
+				break;
+			case cov::ReportCompression::Gzip:
+			{
+				fileWriter_.Write(AddExtension(path, GzipExtension), Gzip(content));
+				std::lock_guard<std::mutex> lock{ mutex_ };
+				gzipFiles_.emplace_back(GetName(path), content.size());
+				break;
+			}
+			case cov::ReportCompression::Zip:
+				WriteZipEntry(GetName(path), content);
+				break;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void ReportWriter::CopyFile(const fs::path& from, const fs::path& to)
+	{
+		if (compression_ == cov::ReportCompression::None)
+			fs::copy_file(from, to, fs::copy_options::overwrite_existing);
+		else
+			WriteFile(to, ReadContent(from));
+	}
+
+	//-------------------------------------------------------------------------
+	void ReportWriter::CopyFolder(const fs::path& from, const fs::path& to)
+	{
+		for (fs::recursive_directory_iterator it(from); it != fs::recursive_directory_iterator(); ++it)
+		{
+			const auto& path = it->path();
+			auto destination = to / path.lexically_relative(from);
+
+			if (fs::is_directory(path))
+			{
+				if (compression_ != cov::ReportCompression::Zip)
+					fs::create_directories(destination);
+			}
+			else
+				CopyFile(path, destination);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ReportWriter::GetPeakBufferedSize() const
+	{
+		return fileWriter_.GetPeakQueuedSize();
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path ReportWriter::Close()
+	{
+		if (isClosed_)
+			THROW(L"The report is already closed");
+		isClosed_ = true;
+
+		switch (compression_)
+		{
+			case cov::ReportCompression::None:
+				fileWriter_.Flush();
+				break;
+			case cov::ReportCompression::Gzip:
+			{
+				fileWriter_.Flush();
+				std::string manifest = GzipManifestHeader + '\n';
+
+				std::sort(gzipFiles_.begin(), gzipFiles_.end());
+				for (const auto& file : gzipFiles_)
+					manifest += std::to_string(file.second) + ' ' + file.first + '\n';
+				WriteContent(root_ / GzipManifestFilename, manifest);
+				break;
+			}
+			case cov::ReportCompression::Zip:
+				std::sort(pendingZipEntries_.begin(), pendingZipEntries_.end(), [](const auto& entry1, const auto& entry2) {
+					return entry1.first.name_ < entry2.first.name_;
+				});
+				for (auto& pendingZipEntry : pendingZipEntries_)
+					WriteZipData(std::move(pendingZipEntry.first), pendingZipEntry.second, {});
+				pendingZipEntries_.clear();
+				WriteZipCentralDirectory();
+				zip_.close();
+				if (!zip_)
+					THROW(L"Cannot write " << AddExtension(root_, ZipExtension));
+				return AddExtension(root_, ZipExtension);
+		}
+		return root_;
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path ReportWriter::CompressFile(
+		const fs::path& path,
+		cov::ReportCompression compression,
+		bool isDeterministic)
+	{
+		if (compression == cov::ReportCompression::None)
+			return path;
+
+		auto content = ReadContent(path);
+		fs::path output;
+		if (compression == cov::ReportCompression::Gzip)
+		{
+			output = AddExtension(path, GzipExtension);
+			WriteContent(output, Gzip(content));
+		}
+		else
+		{
+			ReportWriter reportWriter{ path, compression, isDeterministic };
+
+			reportWriter.WriteZipEntry(Tools::ToUtf8String(path.filename().wstring()), content);
+			output = reportWriter.Close();
+		}
+		fs::remove(path);
+		return output;
+	}
+
+	//-------------------------------------------------------------------------
+	std::string ReportWriter::Gzip(std::string_view content)
+	{
+		return ApplyFilter(content, io::gzip_compressor{});
+	}
+
+	//-------------------------------------------------------------------------
+	std::string ReportWriter::Gunzip(std::string_view compressedContent)
+	{
+		return ApplyFilter(compressedContent, io::gzip_decompressor{});
+	}
+
+	//-------------------------------------------------------------------------
+	std::string ReportWriter::GetName(const fs::path& path) const
+	{
+		return Tools::ToUtf8String(path.lexically_relative(root_).generic_wstring());
+	}
+
+	//-------------------------------------------------------------------------
+	void ReportWriter::WriteZipEntry(std::string&& name, std::string_view content)
+	{
+		if (content.size() > (std::numeric_limits<uint32_t>::max)())
+			THROW(L"The file is too big for the zip archive: " << Tools::Utf8ToWString(name));
+
+		// Raw deflate: the zip format has its own header.
+		io::zlib_params params;
+		params.noheader = true;
+		auto compressedContent = ApplyFilter(content, io::zlib_compressor{ params });
+		auto isStored = compressedContent.size() >= content.size();
+		auto data = isStored ? content : std::string_view{ compressedContent };
+		ZipEntry entry{ 
+			std::move(name), 
+			ComputeCrc32(content), 
+			isStored ? ZipStoredMethod : ZipDeflatedMethod,
+			static_cast<uint32_t>(data.size()),
+			static_cast<uint32_t>(content.size()),
+			0 };
+
+		std::string header;
+		AddLittleEndian(header, ZipLocalHeaderSignature);
+		AddLittleEndian(header, ZipVersion);
+		AddLittleEndian(header, ZipUtf8NameFlag);
+		AddLittleEndian(header, entry.method_);
+		AddLittleEndian(header, dosTime_);
+		AddLittleEndian(header, dosDate_);
+		AddLittleEndian(header, entry.crc_);
+		AddLittleEndian(header, entry.compressedSize_);
+		AddLittleEndian(header, entry.size_);
+		AddLittleEndian(header, static_cast<uint16_t>(entry.name_.size()));
+		AddLittleEndian(header, uint16_t{ 0 });
+		header += entry.name_;
+
+		// The order of the threads writing the files must not change the archive.
+		if (isDeterministic_)
+		{
+			header.append(data);
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			pendingZipEntries_.emplace_back(std::move(entry), std::move(header));
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		WriteZipData(std::move(entry), header, data);
+	}
+
+	//-------------------------------------------------------------------------
+	// Called with mutex_ locked or after the files are written.
+	void ReportWriter::WriteZipData(ZipEntry&& entry, std::string_view header, std::string_view data)
+	{
+		entry.offset_ = zipOffset_;
+		zip_.write(header.data(), header.size());
+		zip_.write(data.data(), data.size());
+		if (!zip_)
+			THROW(L"Cannot write " << AddExtension(root_, ZipExtension));
+		zipOffset_ += header.size() + data.size();
+		zipEntries_.push_back(std::move(entry));
+	}
+
+	//-------------------------------------------------------------------------
+	// The zip64 records are used when there are more than 65535 files or
+	// when the archive is bigger than 4 GB.
+	void ReportWriter::WriteZipCentralDirectory()
+	{
+		const uint32_t Max32 = 0xFFFFFFFF;
+		std::string directory;
+
+		for (const auto& entry : zipEntries_)
+		{
+			auto isZip64 = entry.offset_ >= Max32;
+
+			AddLittleEndian(directory, ZipCentralHeaderSignature);
+			AddLittleEndian(directory, Zip64Version);
+			AddLittleEndian(directory, isZip64 ? Zip64Version : ZipVersion);
+			AddLittleEndian(directory, ZipUtf8NameFlag);
+			AddLittleEndian(directory, entry.method_);
+			AddLittleEndian(directory, dosTime_);
+			AddLittleEndian(directory, dosDate_);
+			AddLittleEndian(directory, entry.crc_);
+			AddLittleEndian(directory, entry.compressedSize_);
+			AddLittleEndian(directory, entry.size_);
+			AddLittleEndian(directory, static_cast<uint16_t>(entry.name_.size()));
+			AddLittleEndian(directory, static_cast<uint16_t>(isZip64 ? 12 : 0));
+			AddLittleEndian(directory, uint16_t{ 0 }); // Comment
+			AddLittleEndian(directory, uint16_t{ 0 }); // Disk
+			AddLittleEndian(directory, uint16_t{ 0 }); // Internal attributes
+			AddLittleEndian(directory, uint32_t{ 0 }); // External attributes
+			AddLittleEndian(directory, isZip64 ? Max32 : static_cast<uint32_t>(entry.offset_));
+			directory += entry.name_;
+			if (isZip64)
+			{
+				AddLittleEndian(directory, uint16_t{ 1 }); // Zip64 extended information
+				AddLittleEndian(directory, uint16_t{ 8 });
+				AddLittleEndian(directory, entry.offset_);
+			}
+		}
+
+		uint64_t entryCount = zipEntries_.size();
+		auto directoryOffset = zipOffset_;
+		uint64_t directorySize = directory.size();
+		auto isZip64 = entryCount >= 0xFFFF || directoryOffset >= Max32 || directorySize >= Max32;
+		if (isZip64)
+		{
+			auto zip64EndOffset = directoryOffset + directorySize;
+
+			AddLittleEndian(directory, Zip64EndSignature);
+			AddLittleEndian(directory, uint64_t{ 44 }); // Size of the remaining record
+			AddLittleEndian(directory, Zip64Version);
+			AddLittleEndian(directory, Zip64Version);
+			AddLittleEndian(directory, uint32_t{ 0 }); // Disk
+			AddLittleEndian(directory, uint32_t{ 0 }); // Disk of the central directory
+			AddLittleEndian(directory, entryCount);
+			AddLittleEndian(directory, entryCount);
+			AddLittleEndian(directory, directorySize);
+			AddLittleEndian(directory, directoryOffset);
+
+			AddLittleEndian(directory, Zip64EndLocatorSignature);
+			AddLittleEndian(directory, uint32_t{ 0 }); // Disk of the zip64 end record
+			AddLittleEndian(directory, zip64EndOffset);
+			AddLittleEndian(directory, uint32_t{ 1 }); // Disk count
+		}
+
+		auto entryCount16 = static_cast<uint16_t>((std::min)(entryCount, uint64_t{ 0xFFFF }));
+		AddLittleEndian(directory, ZipEndSignature);
+		AddLittleEndian(directory, uint16_t{ 0 }); // Disk
+		AddLittleEndian(directory, uint16_t{ 0 }); // Disk of the central directory
+		AddLittleEndian(directory, entryCount16);
+		AddLittleEndian(directory, entryCount16);
+		AddLittleEndian(directory, static_cast<uint32_t>((std::min)(directorySize, uint64_t{ Max32 })));
+		AddLittleEndian(directory, static_cast<uint32_t>((std::min)(directoryOffset, uint64_t{ Max32 })));
+		AddLittleEndian(directory, uint16_t{ 0 }); // Comment
+		zip_.write(directory.data(), directory.size());
+	}
+}
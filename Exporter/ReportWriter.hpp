@@ -0,0 +1,112 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "ExporterExport.hpp"
+#include "CppCoverage/ReportCompression.hpp"
+#include "Tools/FileWriter.hpp"
+
+namespace Exporter
+{
+	// Write the files of a report under a root folder: as they are, gzip
+	// compressed with a manifest or in a single <root>.zip archive.
+	// The files can be written from several threads and are compressed
+	// in the calling thread. The files which are not zipped are written to
+	// the disk in the background until Close.
+	class EXPORTER_DLL ReportWriter
+	{
+	public:
+		static const std::wstring GzipManifestFilename;
+		static const std::wstring GzipExtension;
+		static const std::wstring ZipExtension;
+
+	public:
+		// When isDeterministic, the zip entries are sorted by name and dated
+		// 1980-01-01 so that the same files give the same archive.
+		ReportWriter(const std::filesystem::path& root,
+		             CppCoverage::ReportCompression,
+		             bool isDeterministic = false);
+		~ReportWriter();
+
+		CppCoverage::ReportCompression GetCompression() const;
+
+		// path must be under the root folder.
+		void WriteFile(const std::filesystem::path& path, std::string_view content);
+		void CopyFile(const std::filesystem::path& from, const std::filesystem::path& to);
+		void CopyFolder(const std::filesystem::path& from, const std::filesystem::path& to);
+
+		// Write the zip central directory or the gzip manifest and return
+		// the zip archive or the root folder.
+		std::filesystem::path Close();
+
+		// Peak size of the files waiting to be written to the disk.
+		size_t GetPeakBufferedSize() const;
+
+		// Replace a report of a single file by <path>.gz or <path>.zip.
+		static std::filesystem::path CompressFile(
+			const std::filesystem::path&,
+			CppCoverage::ReportCompression,
+			bool isDeterministic = false);
+
+		static std::string Gzip(std::string_view content);
+		static std::string Gunzip(std::string_view compressedContent);
+
+	private:
+		ReportWriter(const ReportWriter&) = delete;
+		ReportWriter& operator=(const ReportWriter&) = delete;
+
+		struct ZipEntry
+		{
+			std::string name_;
+			uint32_t crc_;
+			uint16_t method_;
+			uint32_t compressedSize_;
+			uint32_t size_;
+			uint64_t offset_;
+		};
+
+		std::string GetName(const std::filesystem::path&) const;
+		void WriteZipEntry(std::string&& name, std::string_view content);
+		void WriteZipData(ZipEntry&&, std::string_view header, std::string_view data);
+		void WriteZipCentralDirectory();
+
+	private:
+		std::filesystem::path root_;
+		const CppCoverage::ReportCompression compression_;
+		std::mutex mutex_;
+		std::ofstream zip_;
+		uint64_t zipOffset_;
+		std::vector<ZipEntry> zipEntries_;
+		// The entries and their data in the deterministic mode until Close.
+		std::vector<std::pair<ZipEntry, std::string>> pendingZipEntries_;
+		std::vector<std::pair<std::string, uint64_t>> gzipFiles_;
+		Tools::FileWriter fileWriter_;
+		uint16_t dosTime_;
+		uint16_t dosDate_;
+		const bool isDeterministic_;
+		bool isClosed_;
+	};
+}
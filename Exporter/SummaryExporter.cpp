@@ -0,0 +1,133 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SummaryExporter.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <string>
+
+#include "CppCoverage/CoverageRateComputer.hpp"
+#include "CppCoverage/CoverageSummary.hpp"
+#include "InvalidOutputFileException.hpp"
+#include "Html/HtmlEscape.hpp"
+
+#include "Tools/Tool.hpp"
+#include "Tools/Log.hpp"
+
+namespace cov = CppCoverage;
+
+namespace Exporter
+{
+	namespace
+	{
+		//-------------------------------------------------------------------------
+		template <typename T>
+		void AppendNumber(std::string& json, T value)
+		{
+			char buffer[32];
+			auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+			json.append(buffer, result.ptr);
+		}
+
+		//-------------------------------------------------------------------------
+		void AppendCoverageRate(std::string& json, const cov::CoverageRate& coverageRate)
+		{
+			json += "\"linesCovered\":";
+			AppendNumber(json, coverageRate.GetExecutedLinesCount());
+			json += ",\"linesValid\":";
+			AppendNumber(json, coverageRate.GetTotalLinesCount());
+			json += ",\"lineRate\":";
+			AppendNumber(json, coverageRate.GetRate());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::filesystem::path SummaryExporter::GetDefaultPath(const std::wstring& prefix) const
+	{
+		std::filesystem::path path{ prefix };
+
+		path += "Summary.json";
+
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	void SummaryExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const std::filesystem::path& output)
+	{
+		cov::CoverageRateComputer coverageRateComputer{ coverageData };
+
+		Export(coverageData, coverageRateComputer, output);
+	}
+
+	//-------------------------------------------------------------------------
+	void SummaryExporter::Export(
+		const Plugin::CoverageData& coverageData,
+		const cov::CoverageRateComputer& coverageRateComputer,
+		const std::filesystem::path& output)
+	{
+		Export(cov::CoverageSummary::Create(coverageData, coverageRateComputer), output);
+	}
+
+	//-------------------------------------------------------------------------
+	void SummaryExporter::Export(
+		const cov::CoverageSummary& coverageSummary,
+		const std::filesystem::path& output) const
+	{
+		Tools::CreateParentFolderIfNeeded(output);
+		std::ofstream ofs{ output, std::ios::binary };
+
+		if (!ofs)
+			throw InvalidOutputFileException(output, "summary");
+		Export(coverageSummary, ofs);
+
+		const auto& coverageRate = coverageSummary.GetCoverageRate();
+		LOG_INFO << L"Line coverage: " << coverageRate.GetPercentRate() << L"% ("
+		         << coverageRate.GetExecutedLinesCount() << L"/"
+		         << coverageRate.GetTotalLinesCount() << L" lines).";
+		Tools::ShowOutputMessage(L"Summary generated: ", output);
+	}
+
+	//-------------------------------------------------------------------------
+	void SummaryExporter::Export(
+		const cov::CoverageSummary& coverageSummary,
+		std::ostream& ostream) const
+	{
+		std::string json = "{\"name\":";
+
+		AppendJsonString(json, Tools::ToUtf8String(coverageSummary.GetName()));
+		json += ",\"exitCode\":";
+		AppendNumber(json, coverageSummary.GetExitCode());
+		json += ',';
+		AppendCoverageRate(json, coverageSummary.GetCoverageRate());
+		json += ",\"modules\":[";
+		for (const auto& module : coverageSummary.GetModules())
+		{
+			if (json.back() == '}')
+				json += ',';
+			json += "{\"path\":";
+			AppendJsonString(json, Tools::ToUtf8String(module.path_.wstring()));
+			json += ',';
+			AppendCoverageRate(json, module.coverageRate_);
+			json += '}';
+		}
+		json += "]}\n";
+		ostream << json;
+	}
+}
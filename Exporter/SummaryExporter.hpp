@@ -0,0 +1,51 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <filesystem>
+
+#include "ExporterExport.hpp"
+#include "IExporter.hpp"
+
+namespace CppCoverage
+{
+	class CoverageSummary;
+}
+
+namespace Exporter
+{
+	// Line counts and line rate of the run and of each module, as JSON.
+	class EXPORTER_DLL SummaryExporter: public IExporter
+	{
+	public:
+		SummaryExporter() = default;
+
+		std::filesystem::path GetDefaultPath(const std::wstring& runningCommandFilename) const override;
+		void Export(const Plugin::CoverageData&, const std::filesystem::path& output) override;
+		void Export(
+			const Plugin::CoverageData&,
+			const CppCoverage::CoverageRateComputer&,
+			const std::filesystem::path& output) override;
+		void Export(const CppCoverage::CoverageSummary&, const std::filesystem::path& output) const;
+		void Export(const CppCoverage::CoverageSummary&, std::ostream&) const;
+
+	private:
+		SummaryExporter(const SummaryExporter&) = delete;
+		SummaryExporter& operator=(const SummaryExporter&) = delete;
+	};
+}
@@ -0,0 +1,366 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "XmlReader.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <istream>
+
+#include "ExporterException.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace Exporter
+{
+	namespace
+	{
+		const size_t BufferSize = 64 * 1024;
+		// The longest entity is a character reference like #x10FFFF.
+		const size_t MaxEntitySize = 10;
+
+		//-------------------------------------------------------------------------
+		bool IsSpace(int c)
+		{
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+		}
+
+		//-------------------------------------------------------------------------
+		bool IsNameEnd(int c)
+		{
+			return IsSpace(c) || c == '/' || c == '>' || c == '=' || c == EOF;
+		}
+
+		//-------------------------------------------------------------------------
+		void AppendUtf8(std::string& output, uint32_t codePoint)
+		{
+			if (codePoint < 0x80)
+				output += static_cast<char>(codePoint);
+			else if (codePoint < 0x800)
+			{
+				output += static_cast<char>(0xC0 | (codePoint >> 6));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else if (codePoint < 0x10000)
+			{
+				output += static_cast<char>(0xE0 | (codePoint >> 12));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+			else
+			{
+				output += static_cast<char>(0xF0 | (codePoint >> 18));
+				output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+				output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+				output += static_cast<char>(0x80 | (codePoint & 0x3F));
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	XmlReader::XmlReader(std::istream& istream)
+		: istream_{ istream }
+		, buffer_(BufferSize)
+		, position_{ 0 }
+		, size_{ 0 }
+		, attributeCount_{ 0 }
+		, depth_{ 0 }
+		, isEndElementPending_{ false }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	XmlReader::Node XmlReader::Read()
+	{
+		if (isEndElementPending_)
+		{
+			isEndElementPending_ = false;
+			--depth_;
+			return Node::EndElement;
+		}
+
+		text_.clear();
+		while (true)
+		{
+			auto c = Peek();
+
+			if (c != '<' && c != EOF)
+			{
+				ReadText();
+				continue;
+			}
+			if (std::any_of(text_.begin(), text_.end(), [](char character) { return !IsSpace(character); }))
+				return Node::Text;
+			text_.clear();
+			if (c == EOF)
+			{
+				if (depth_)
+					THROW("Unexpected end of the XML document.");
+				return Node::End;
+			}
+
+			Get();
+			if (Peek() == '?')
+				ReadUntil("?>", nullptr);
+			else if (Peek() == '!')
+			{
+				Get();
+				if (Peek() == '-')
+				{
+					Expect("--");
+					ReadUntil("-->", nullptr);
+				}
+				else if (Peek() == '[')
+				{
+					Expect("[CDATA[");
+					ReadUntil("]]>", &text_);
+				}
+				else
+					SkipDeclaration();
+			}
+			else if (Peek() == '/')
+			{
+				Get();
+				ReadName(name_);
+				SkipSpaces();
+				Expect(">");
+				if (!depth_)
+					THROW(L"Unexpected end of element in the XML document: " << Tools::Utf8ToWString(name_));
+				--depth_;
+				return Node::EndElement;
+			}
+			else
+			{
+				ReadName(name_);
+				ReadAttributes();
+				++depth_;
+				return Node::StartElement;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string& XmlReader::GetName() const
+	{
+		return name_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string* XmlReader::FindAttribute(std::string_view name) const
+	{
+		auto end = attributes_.begin() + attributeCount_;
+		auto it = std::find_if(attributes_.begin(), end, [&](const auto& attribute) {
+			return attribute.first == name;
+		});
+
+		return it != end ? &it->second : nullptr;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::string& XmlReader::GetText() const
+	{
+		return text_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t XmlReader::GetDepth() const
+	{
+		return depth_;
+	}
+
+	//-------------------------------------------------------------------------
+	int XmlReader::Peek()
+	{
+		if (position_ == size_)
+		{
+			istream_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+			size_ = static_cast<size_t>(istream_.gcount());
+			position_ = 0;
+			if (!size_)
+				return EOF;
+		}
+		return static_cast<unsigned char>(buffer_[position_]);
+	}
+
+	//-------------------------------------------------------------------------
+	char XmlReader::Get()
+	{
+		if (Peek() == EOF)
+			THROW("Unexpected end of the XML document.");
+		return buffer_[position_++];
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::Expect(std::string_view expected)
+	{
+		for (auto c : expected)
+		{
+			if (Get() != c)
+				THROW(L"Invalid XML document: " << Tools::Utf8ToWString(std::string{ expected }) << L" is expected.");
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::SkipSpaces()
+	{
+		while (IsSpace(Peek()))
+			Get();
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::ReadUntil(std::string_view end, std::string* content)
+	{
+		std::string last;
+
+		while (last != end)
+		{
+			auto c = Get();
+
+			last += c;
+			if (last.size() > end.size())
+			{
+				if (content)
+					*content += last.front();
+				last.erase(last.begin());
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// <!DOCTYPE name [ <!ENTITY ...> ]>: the internal subset contains markup.
+	void XmlReader::SkipDeclaration()
+	{
+		int bracketDepth = 0;
+		char quote = 0;
+
+		for (auto c = Get(); quote || bracketDepth || c != '>'; c = Get())
+		{
+			if (quote)
+			{
+				if (c == quote)
+					quote = 0;
+			}
+			else if (c == '"' || c == '\'')
+				quote = c;
+			else if (c == '[')
+				++bracketDepth;
+			else if (c == ']')
+				--bracketDepth;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::ReadName(std::string& name)
+	{
+		name.clear();
+		while (!IsNameEnd(Peek()))
+			name += Get();
+		if (name.empty())
+			THROW("Invalid XML document: a name is expected.");
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::ReadText()
+	{
+		for (auto c = Peek(); c != '<' && c != EOF; c = Peek())
+		{
+			if (Get() == '&')
+				ReadEntity(text_);
+			else
+				text_ += static_cast<char>(c);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::ReadAttributes()
+	{
+		attributeCount_ = 0;
+		while (true)
+		{
+			SkipSpaces();
+			if (Peek() == '>')
+			{
+				Get();
+				return;
+			}
+			if (Peek() == '/')
+			{
+				Expect("/>");
+				isEndElementPending_ = true;
+				return;
+			}
+
+			if (attributeCount_ == attributes_.size())
+				attributes_.emplace_back();
+			auto& attribute = attributes_[attributeCount_++];
+			ReadName(attribute.first);
+			SkipSpaces();
+			Expect("=");
+			SkipSpaces();
+
+			auto quote = Get();
+			if (quote != '"' && quote != '\'')
+				THROW(L"Invalid XML document: the value of " << Tools::Utf8ToWString(attribute.first) << L" is not quoted.");
+			attribute.second.clear();
+			for (auto c = Get(); c != quote; c = Get())
+			{
+				if (c == '&')
+					ReadEntity(attribute.second);
+				else
+					attribute.second += c;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void XmlReader::ReadEntity(std::string& output)
+	{
+		std::string entity;
+
+		for (auto c = Get(); c != ';'; c = Get())
+		{
+			if (entity.size() == MaxEntitySize)
+				THROW("Invalid XML document: the entity is too long.");
+			entity += c;
+		}
+
+		if (entity == "amp")
+			output += '&';
+		else if (entity == "lt")
+			output += '<';
+		else if (entity == "gt")
+			output += '>';
+		else if (entity == "quot")
+			output += '"';
+		else if (entity == "apos")
+			output += '\'';
+		else if (entity.size() > 1 && entity.front() == '#')
+		{
+			auto isHexadecimal = entity[1] == 'x';
+			auto first = entity.data() + (isHexadecimal ? 2 : 1);
+			auto last = entity.data() + entity.size();
+			uint32_t codePoint = 0;
+			auto result = std::from_chars(first, last, codePoint, isHexadecimal ? 16 : 10);
+
+			if (result.ec != std::errc{} || result.ptr != last || first == last || codePoint > 0x10FFFF)
+				THROW(L"Invalid XML character reference: " << Tools::Utf8ToWString(entity));
+			AppendUtf8(output, codePoint);
+		}
+		else
+			THROW(L"Unknown XML entity: " << Tools::Utf8ToWString(entity));
+	}
+}
@@ -0,0 +1,85 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Exporter
+{
+	// Pull parser for the XML reports of the coverage tools. The comments,
+	// the processing instructions and the document type declaration are
+	// skipped, and a CDATA section is read as text. The input is read by
+	// blocks, so the memory used does not depend on the size of the document.
+	class XmlReader
+	{
+	public:
+		enum class Node
+		{
+			StartElement,
+			// Also follows the StartElement of an empty element <name/>.
+			EndElement,
+			// The text of an element, without the text made only of spaces.
+			Text,
+			End
+		};
+
+		explicit XmlReader(std::istream&);
+
+		Node Read();
+
+		// Name of the last StartElement or EndElement.
+		const std::string& GetName() const;
+		// Attribute of the last StartElement, with its entities decoded.
+		const std::string* FindAttribute(std::string_view name) const;
+		// Content of the last Text, with its entities decoded.
+		const std::string& GetText() const;
+		// Number of the elements started and not ended.
+		size_t GetDepth() const;
+
+	private:
+		XmlReader(const XmlReader&) = delete;
+		XmlReader& operator=(const XmlReader&) = delete;
+
+		int Peek();
+		char Get();
+		void Expect(std::string_view);
+		void SkipSpaces();
+		// Consume the characters until end, which is consumed too.
+		void ReadUntil(std::string_view end, std::string* content);
+		void SkipDeclaration();
+		void ReadName(std::string&);
+		void ReadText();
+		void ReadAttributes();
+		void ReadEntity(std::string&);
+
+		std::istream& istream_;
+		std::vector<char> buffer_;
+		size_t position_;
+		size_t size_;
+		std::string name_;
+		// Reused between the elements: only the first attributeCount_ are set.
+		std::vector<std::pair<std::string, std::string>> attributes_;
+		size_t attributeCount_;
+		std::string text_;
+		size_t depth_;
+		bool isEndElementPending_;
+	};
+}
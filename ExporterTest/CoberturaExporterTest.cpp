@@ -78,6 +78,30 @@ namespace ExporterTest
 		ASSERT_EQ(result, expectedResult);
 	}	
 
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, HitCount)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		coverageData.AddModule(L"Module").AddFile(L"File").AddLine(0, true, 42);
+
+		std::wostringstream ostr;
+		Exporter::CoberturaExporter().Export(coverageData, ostr);
+
+		ASSERT_TRUE(boost::algorithm::contains(ostr.str(), L"hits=\"42\""));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, Deterministic)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		coverageData.AddModule(L"Module").AddFile(L"File").AddLine(0, true);
+
+		std::wostringstream ostr;
+		Exporter::CoberturaExporter(0, CppCoverage::ReportCompression::None, true).Export(coverageData, ostr);
+
+		ASSERT_TRUE(boost::algorithm::contains(ostr.str(), L"timestamp=\"0\""));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(CoberturaExporterTest, SubFolderDoesNotExist)
 	{
@@ -129,4 +153,65 @@ namespace ExporterTest
 		                 coverageData, outputPath.GetPath() / "InvalidFile/"),
 		             Exporter::InvalidOutputFileException);
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, ManyFiles)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& module = coverageData.AddModule(L"Module");
+		const int fileCount = 2500;
+
+		for (int i = 0; i < fileCount; ++i)
+			module.AddFile(L"File" + std::to_wstring(i)).AddLine(i, true);
+
+		std::wostringstream ostr;
+		Exporter::CoberturaExporter().Export(coverageData, ostr);
+		auto result = ostr.str();
+
+		size_t pos = 0;
+		for (int i = 0; i < fileCount; ++i)
+		{
+			auto name = L"class name=\"File" + std::to_wstring(i) + L"\"";
+			pos = result.find(name, pos);
+			ASSERT_NE(std::wstring::npos, pos);
+			pos = result.find(L"<line number=\"" + std::to_wstring(i) + L"\" hits=\"1\"/>", pos);
+			ASSERT_NE(std::wstring::npos, pos);
+		}
+		ASSERT_TRUE(boost::algorithm::ends_with(result, L"  </packages>\n</coverage>\n"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoberturaExporterTest, PackagesByFile)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+
+		for (int i = 0; i < 3; ++i)
+			coverageData.AddModule(L"Module" + std::to_wstring(i)).AddFile(L"File").AddLine(i, true);
+
+		TestHelper::TemporaryPath output{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		auto outputPath = output.GetPath() / "output.xml";
+		Exporter::CoberturaExporter(2).Export(coverageData, outputPath);
+
+		auto readFile = [](const fs::path& path) {
+			std::ifstream ifs{ path };
+			std::ostringstream ostr;
+			ostr << ifs.rdbuf();
+			return ostr.str();
+		};
+		auto firstFilePath = Exporter::CoberturaExporter::GetFilePath(outputPath, 0);
+		auto secondFilePath = Exporter::CoberturaExporter::GetFilePath(outputPath, 1);
+		ASSERT_EQ(output.GetPath() / "output-1.xml", firstFilePath);
+		ASSERT_FALSE(Tools::FileExists(Exporter::CoberturaExporter::GetFilePath(outputPath, 2)));
+
+		auto firstFile = readFile(firstFilePath);
+		ASSERT_TRUE(boost::algorithm::contains(firstFile, "package name=\"Module1\""));
+		ASSERT_TRUE(boost::algorithm::contains(firstFile, "<line number=\"1\" hits=\"1\"/>"));
+		ASSERT_FALSE(boost::algorithm::contains(firstFile, "Module2"));
+		ASSERT_TRUE(boost::algorithm::contains(readFile(secondFilePath), "<line number=\"2\" hits=\"1\"/>"));
+
+		auto report = readFile(outputPath);
+		ASSERT_TRUE(boost::algorithm::contains(report, "package name=\"Module2\""));
+		ASSERT_TRUE(boost::algorithm::contains(report, "<classes/>"));
+		ASSERT_FALSE(boost::algorithm::contains(report, "<line "));
+	}
+}
@@ -0,0 +1,96 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "Exporter/Html/CompactHtmlExporter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string ReadContent(const fs::path& path)
+		{
+			std::ifstream ifs{ path, std::ios::binary };
+
+			return std::string{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CompactHtmlExporterTest, CreateCoverageBitmap)
+	{
+		Plugin::FileCoverage file{ "File.cpp" };
+
+		file.AddLine(1, true);
+		file.AddLine(2, false);
+		file.AddLine(5, true);
+
+		ASSERT_EQ(std::string("\x07\x03", 2), Exporter::CompactHtmlExporter::CreateCoverageBitmap(file));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CompactHtmlExporterTest, Export)
+	{
+		TestHelper::TemporaryPath source;
+		TestHelper::TemporaryPath output{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		{
+			std::ofstream ofs{ source.GetPath() };
+			ofs << "int main()\n{\n}\n";
+		}
+		Plugin::CoverageData coverageData{ L"Test", 0 };
+		auto& file = coverageData.AddModule(L"Module.exe").AddFile(source);
+		file.AddLine(1, true);
+		file.AddLine(3, false);
+		coverageData.AddModule(L"Module.dll").AddFile(L"MissingFile.cpp").AddLine(1, false);
+
+		auto sourcesFolder = output.GetPath() / Exporter::CompactHtmlExporter::SourcesFolder;
+		fs::create_directories(sourcesFolder);
+		std::ofstream{ sourcesFolder / "9.js" };
+		std::ofstream{ sourcesFolder / "notes.txt" };
+
+		Exporter::CompactHtmlExporter exporter{ fs::canonical(OUT_DIR) / "Template" };
+		exporter.Export(coverageData, output);
+
+		// Only the existing source is bundled.
+		ASSERT_TRUE(Tools::FileExists(output.GetPath() / "index.html"));
+		ASSERT_TRUE(Tools::FileExists(sourcesFolder / "0.js"));
+		ASSERT_FALSE(Tools::FileExists(sourcesFolder / "1.js"));
+		ASSERT_FALSE(Tools::FileExists(sourcesFolder / "9.js"));
+		ASSERT_TRUE(Tools::FileExists(sourcesFolder / "notes.txt"));
+
+		// The base64 encoding of the gzip magic number.
+		auto index = ReadContent(output.GetPath() / Exporter::CompactHtmlExporter::IndexFilename);
+		ASSERT_EQ(0u, index.find("OpenCppCoverage.setIndex(\"H4sI"));
+		auto bundle = ReadContent(sourcesFolder / "0.js");
+		ASSERT_EQ(0u, bundle.find("OpenCppCoverage.addSourceBundle(0, \"H4sI"));
+	}
+}
@@ -0,0 +1,118 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Exporter/Binary/CoverageDataReader.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::vector<std::pair<unsigned int, bool>> GetLines(const Exporter::FileCoverageView& file)
+		{
+			std::vector<std::pair<unsigned int, bool>> lines;
+
+			file.ForEachLine([&](unsigned int lineNumber, bool hasBeenExecuted) {
+				lines.emplace_back(lineNumber, hasBeenExecuted);
+			});
+			return lines;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataReaderTest, Read)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"name", 42 };
+		auto& module1 = coverageData.AddModule(L"module1");
+		auto& file1 = module1.AddFile(L"file1");
+
+		file1.AddLine(1, true);
+		file1.AddLine(200, false);
+		file1.AddLine(100000, true);
+		module1.AddFile(L"file2");
+		coverageData.AddModule(L"module2").AddFile(L"file1").AddLine(3, false);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, path);
+
+		Exporter::CoverageDataReader reader{ path, "" };
+		ASSERT_EQ(L"name", reader.GetName());
+		ASSERT_EQ(42, reader.GetExitCode());
+
+		const auto& moduleSummaries = reader.GetModuleSummaries();
+		ASSERT_EQ(2, moduleSummaries.size());
+		ASSERT_EQ(L"module2", moduleSummaries[1].GetPath());
+		ASSERT_EQ(3, moduleSummaries[0].GetLineCount());
+
+		auto files = reader.GetFiles(0);
+		ASSERT_EQ(2, files.size());
+		ASSERT_EQ(L"file1", reader.GetPath(files[0].GetPathIndex()));
+		ASSERT_EQ(3, files[0].GetLineCount());
+		ASSERT_EQ(2, files[0].GetExecutedLineCount());
+		ASSERT_FALSE(files[0].HasBeenExecuted(1));
+		std::vector<std::pair<unsigned int, bool>> expectedLines{ { 1, true }, { 200, false }, { 100000, true } };
+		ASSERT_EQ(expectedLines, GetLines(files[0]));
+		ASSERT_EQ(0, files[1].GetLineCount());
+
+		auto files2 = reader.GetFiles(1);
+		ASSERT_EQ(1, files2.size());
+		ASSERT_EQ(files[0].GetPathIndex(), files2[0].GetPathIndex());
+		ASSERT_EQ(0, files2[0].GetExecutedLineCount());
+		ASSERT_THROW(reader.GetFiles(2), std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataReaderTest, Compressed)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"name", 42 };
+		auto& file = coverageData.AddModule(L"module1").AddFile(L"file1");
+
+		file.AddLine(1, true);
+		file.AddLine(200, false);
+		coverageData.AddModule(L"module2").AddFile(L"file2").AddLine(3, true);
+		Exporter::CoverageDataSerializer{ Exporter::CoverageDataSerializer::Version::V2Compressed }.Serialize(
+			coverageData, path);
+
+		Exporter::CoverageDataReader reader{ path, "" };
+		ASSERT_EQ(2, reader.GetModuleSummaries().size());
+		auto files = reader.GetFiles(0);
+		ASSERT_EQ(1, files.size());
+		ASSERT_EQ(L"file1", reader.GetPath(files[0].GetPathIndex()));
+		std::vector<std::pair<unsigned int, bool>> expectedLines{ { 1, true }, { 200, false } };
+		ASSERT_EQ(expectedLines, GetLines(files[0]));
+		ASSERT_EQ(expectedLines, GetLines(reader.GetFiles(0)[0]));
+		ASSERT_EQ(L"file2", reader.GetPath(reader.GetFiles(1)[0].GetPathIndex()));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataReaderTest, V1)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"module").AddFile(L"file").AddLine(1, true);
+		Exporter::CoverageDataSerializer{ Exporter::CoverageDataSerializer::Version::V1 }.Serialize(coverageData, path);
+		ASSERT_THROW((Exporter::CoverageDataReader{ path, "v1" }), std::runtime_error);
+	}
+}
@@ -19,6 +19,8 @@
 #include <sstream>
 #include <random>
 #include <fstream>
+#include <filesystem>
+#include <iterator>
 
 #include "Plugin/Exporter/CoverageData.hpp"
 #include "Plugin/Exporter/ModuleCoverage.hpp"
@@ -26,6 +28,7 @@
 #include "Plugin/Exporter/LineCoverage.hpp"
 #include "Exporter/Binary/CoverageDataSerializer.hpp"
 #include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "CppCoverage/ICoverageSource.hpp"
 
 #include "TestHelper/TemporaryPath.hpp"
 #include "TestHelper/CoverageDataComparer.hpp"
@@ -66,6 +69,8 @@ namespace ExporterTest
 				if (distribution(generator))
 				{
 					auto& module = coverageData.AddModule(std::to_wstring(moduleIndex));
+					if (distribution(generator))
+						module.SetIdentity(L"identity" + std::to_wstring(moduleIndex));
 					AddRandomFiles(module, generator, distribution);
 				}
 			}
@@ -74,6 +79,56 @@ namespace ExporterTest
 
 			return coverageData;
 		}
+
+		//---------------------------------------------------------------------
+		class CoverageDataSource : public CppCoverage::ICoverageSource
+		{
+		public:
+			//-----------------------------------------------------------------
+			explicit CoverageDataSource(const Plugin::CoverageData& coverageData)
+				: coverageData_{ coverageData }
+			{
+			}
+
+			//-----------------------------------------------------------------
+			const std::wstring& GetName() const override { return coverageData_.GetName(); }
+			int GetExitCode() const override { return coverageData_.GetExitCode(); }
+			bool IsSampled() const override { return coverageData_.IsSampled(); }
+			size_t GetModuleCount() const override { return coverageData_.GetModules().size(); }
+
+			//-----------------------------------------------------------------
+			const std::filesystem::path& GetModulePath(size_t moduleIndex) const override
+			{
+				return coverageData_.GetModules().at(moduleIndex)->GetPath();
+			}
+
+			//-----------------------------------------------------------------
+			const std::wstring& GetModuleIdentity(size_t moduleIndex) const override
+			{
+				return coverageData_.GetModules().at(moduleIndex)->GetIdentity();
+			}
+
+			//-----------------------------------------------------------------
+			void VisitModule(size_t moduleIndex, CppCoverage::ICoverageFileVisitor& visitor) const override
+			{
+				for (const auto& file : coverageData_.GetModules().at(moduleIndex)->GetFiles())
+				{
+					if (!visitor.OnFile(file->GetPath(), file->GetLines().size()))
+						continue;
+					for (const auto& line : file->GetLines())
+					{
+						visitor.OnLine(line.GetLineNumber(),
+						               line.HasBeenExecuted(),
+						               line.GetHitCount(),
+						               line.GetFirstHitOrder(),
+						               line.GetFirstHitTime());
+					}
+				}
+			}
+
+		private:
+			const Plugin::CoverageData& coverageData_;
+		};
 	}
 	
 	//-------------------------------------------------------------------------
@@ -91,6 +146,311 @@ namespace ExporterTest
 		TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageDataRestored);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, SerializeToStream)
+	{
+		auto randomCoverageData = CreateRandomCoverageData();
+		std::stringstream content;
+
+		Exporter::CoverageDataSerializer().Serialize(randomCoverageData, content);
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(content, "");
+
+		TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, Sampled)
+	{
+		Plugin::CoverageData coverageData{ L"Test", 0 };
+		std::stringstream content;
+
+		coverageData.SetSampled(true);
+		coverageData.AddModule("module").AddFile("file").AddLine(1, true, 10);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, content);
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(content, "");
+
+		ASSERT_TRUE(coverageDataRestored.IsSampled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeV1)
+	{
+		TestHelper::TemporaryPath path;
+		Exporter::CoverageDataSerializer serializer{ Exporter::CoverageDataSerializer::Version::V1 };
+		auto randomCoverageData = CreateRandomCoverageData();
+
+		serializer.Serialize(randomCoverageData, path.GetPath().string());
+
+		Exporter::CoverageDataDeserializer deserializer;
+		auto coverageDataRestored = deserializer.Deserialize(path.GetPath().string(), "");
+
+		TestHelper::CoverageDataComparer().AssertEquals(randomCoverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, SharedPaths)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"module1").AddFile(L"file").AddLine(10, true);
+		coverageData.AddModule(L"module2").AddFile(L"file").AddLine(20, false);
+		coverageData.AddModule(L"file").AddFile(L"module1").AddLine(30, true);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, path);
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(path, "");
+		TestHelper::CoverageDataComparer().AssertEquals(coverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, SharedPathsV1)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& module1 = coverageData.AddModule(L"module1");
+
+		// The second module is read in the message of the first one.
+		module1.AddFile(L"file1").AddLine(10, true);
+		module1.AddFile(L"file2").AddLine(20, false);
+		coverageData.AddModule(L"module2").AddFile(L"file2").AddLine(30, true);
+		Exporter::CoverageDataSerializer{ Exporter::CoverageDataSerializer::Version::V1 }.Serialize(
+			coverageData, path);
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(path, "");
+		TestHelper::CoverageDataComparer().AssertEquals(coverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, ModuleSummaries)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& module1 = coverageData.AddModule(L"module1");
+
+		module1.AddFile(L"file1").AddLine(10, true);
+		module1.AddFile(L"file2").AddLine(20, false);
+		auto& file = coverageData.AddModule(L"module2").AddFile(L"file1");
+		file.AddLine(30, true);
+		file.AddLine(31, true);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, path);
+
+		ASSERT_TRUE(Exporter::CoverageDataDeserializer().HasModuleIndex(path));
+		auto moduleSummaries = Exporter::CoverageDataDeserializer().DeserializeModuleSummaries(path, "");
+		ASSERT_EQ(2, moduleSummaries.size());
+		ASSERT_EQ(L"module1", moduleSummaries[0].GetPath());
+		ASSERT_EQ(2, moduleSummaries[0].GetFileCount());
+		ASSERT_EQ(2, moduleSummaries[0].GetLineCount());
+		ASSERT_EQ(1, moduleSummaries[0].GetExecutedLineCount());
+		ASSERT_EQ(L"module2", moduleSummaries[1].GetPath());
+		ASSERT_EQ(1, moduleSummaries[1].GetFileCount());
+		ASSERT_EQ(2, moduleSummaries[1].GetExecutedLineCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeserializeModules)
+	{
+		TestHelper::TemporaryPath path;
+		auto randomCoverageData = CreateRandomCoverageData();
+		const auto& modules = randomCoverageData.GetModules();
+		Exporter::CoverageDataSerializer().Serialize(randomCoverageData, path);
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().DeserializeModules(
+			path, { modules.back()->GetPath(), L"unknown", modules.front()->GetPath() }, "");
+
+		Plugin::CoverageData expectedCoverageData{ randomCoverageData.GetName(), randomCoverageData.GetExitCode() };
+		for (const auto& module : { modules.front().get(), modules.back().get() })
+		{
+			auto& expectedModule = expectedCoverageData.AddModule(module->GetPath());
+			for (const auto& file : module->GetFiles())
+				expectedModule.AddFile(file->GetPath()) = *file;
+		}
+		TestHelper::CoverageDataComparer().AssertEquals(expectedCoverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, Compressed)
+	{
+		TestHelper::TemporaryPath path;
+		auto randomCoverageData = CreateRandomCoverageData();
+
+		// More modules than a batch of frames.
+		for (int i = 0; i < 300; ++i)
+			randomCoverageData.AddModule(L"batch" + std::to_wstring(i)).AddFile(L"file").AddLine(i, i % 2 == 0);
+		Exporter::CoverageDataSerializer{ Exporter::CoverageDataSerializer::Version::V2Compressed }.Serialize(
+			randomCoverageData, path);
+		const auto& modules = randomCoverageData.GetModules();
+
+		TestHelper::CoverageDataComparer().AssertEquals(
+			randomCoverageData, Exporter::CoverageDataDeserializer().Deserialize(path, ""));
+		ASSERT_EQ(modules.size(), Exporter::CoverageDataDeserializer().DeserializeModuleSummaries(path, "").size());
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().DeserializeModules(
+			path, { modules.back()->GetPath() }, "");
+		ASSERT_EQ(1, coverageDataRestored.GetModules().size());
+		TestHelper::CoverageDataComparer().AssertEquals(
+			modules.back().get(), coverageDataRestored.GetModules().front().get());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, ModuleIndexV1)
+	{
+		TestHelper::TemporaryPath path;
+
+		Exporter::CoverageDataSerializer{ Exporter::CoverageDataSerializer::Version::V1 }.Serialize(
+			CreateRandomCoverageData(), path);
+		ASSERT_FALSE(Exporter::CoverageDataDeserializer().HasModuleIndex(path));
+		ASSERT_THROW(Exporter::CoverageDataDeserializer().DeserializeModuleSummaries(path, "v1"),
+		             std::runtime_error);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, FirstHits)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& file = coverageData.AddModule(L"module").AddFile(L"file");
+
+		file.AddLine(1, true, 1, 2, 20);
+		file.AddLine(2, false);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, path);
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(path, "");
+		const auto& fileRestored = *coverageDataRestored.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(2, fileRestored[1]->GetFirstHitOrder());
+		ASSERT_EQ(20, fileRestored[1]->GetFirstHitTime());
+		ASSERT_EQ(0, fileRestored[2]->GetFirstHitOrder());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, CoverageSource)
+	{
+		using Version = Exporter::CoverageDataSerializer::Version;
+		auto randomCoverageData = CreateRandomCoverageData();
+		CoverageDataSource coverageSource{ randomCoverageData };
+
+		randomCoverageData.SetSampled(true);
+		randomCoverageData.AddModule(L"firstHits").AddFile(L"file").AddLine(1, true, 1, 2, 20);
+		for (auto version : { Version::V2, Version::V2Compressed })
+		{
+			std::stringstream expectedContent;
+			std::stringstream content;
+
+			Exporter::CoverageDataSerializer{ version }.Serialize(randomCoverageData, expectedContent);
+			Exporter::CoverageDataSerializer{ version }.Serialize(coverageSource, content);
+			ASSERT_EQ(expectedContent.str(), content.str());
+		}
+
+		std::stringstream content;
+		ASSERT_THROW(Exporter::CoverageDataSerializer{ Version::V1 }.Serialize(coverageSource, content),
+		             std::runtime_error);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, Delta)
+	{
+		TestHelper::TemporaryPath baselinePath;
+		TestHelper::TemporaryPath deltaPath;
+		Plugin::CoverageData baseline{ L"", 0 };
+		auto& baselineModule1 = baseline.AddModule(L"module1");
+		auto& baselineFile1 = baselineModule1.AddFile(L"file1");
+
+		baselineFile1.AddLine(1, true);
+		baselineFile1.AddLine(2, false);
+		baselineModule1.AddFile(L"file2").AddLine(3, true);
+		baseline.AddModule(L"module2").AddFile(L"file").AddLine(4, true);
+		auto& baselineModule3 = baseline.AddModule(L"module3");
+		baselineModule3.SetIdentity(L"identity3");
+		baselineModule3.AddFile(L"file").AddLine(5, false);
+		baseline.AddModule(L"module5").AddFile(L"file").AddLine(8, true);
+		Exporter::CoverageDataSerializer().Serialize(baseline, baselinePath);
+
+		Plugin::CoverageData coverageData{ L"name", 1 };
+		auto& module1 = coverageData.AddModule(L"module1");
+		auto& file1 = module1.AddFile(L"file1");
+
+		file1.AddLine(1, false);
+		file1.AddLine(2, true);
+		module1.AddFile(L"file3").AddLine(6, true);
+		auto& module3 = coverageData.AddModule(L"module3");
+		module3.SetIdentity(L"identity3");
+		module3.AddFile(L"file").AddLine(5, false);
+		coverageData.AddModule(L"module4").AddFile(L"file").AddLine(7, true);
+		// Only the identity of the module changes.
+		auto& module5 = coverageData.AddModule(L"module5");
+		module5.SetIdentity(L"identity5");
+		module5.AddFile(L"file").AddLine(8, true);
+		Exporter::CoverageDataSerializer().SerializeDelta(coverageData, baselinePath, deltaPath);
+
+		auto coverageDataRestored = Exporter::CoverageDataDeserializer().Deserialize(deltaPath, "");
+		TestHelper::CoverageDataComparer().AssertEquals(coverageData, coverageDataRestored);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, DeltaWithChangedBaseline)
+	{
+		TestHelper::TemporaryPath baselinePath;
+		TestHelper::TemporaryPath deltaPath;
+		Plugin::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"module").AddFile(L"file").AddLine(1, true);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, baselinePath);
+		Exporter::CoverageDataSerializer().SerializeDelta(coverageData, baselinePath, deltaPath);
+
+		coverageData.AddModule(L"module2").AddFile(L"file").AddLine(1, true);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, baselinePath);
+		ASSERT_THROW(Exporter::CoverageDataDeserializer().Deserialize(deltaPath, ""), std::exception);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, Hits)
+	{
+		TestHelper::TemporaryPath lineTableFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		TestHelper::TemporaryPath hitsPath1;
+		TestHelper::TemporaryPath hitsPath2;
+		auto randomCoverageData = CreateRandomCoverageData();
+		Plugin::CoverageData coverageData{ L"name", 1 };
+
+		for (const auto& module : randomCoverageData.GetModules())
+		{
+			auto& moduleCoverage = coverageData.AddModule(module->GetPath());
+			for (const auto& file : module->GetFiles())
+			{
+				auto& fileCoverage = moduleCoverage.AddFile(file->GetPath());
+				for (const auto& line : file->GetLines())
+					fileCoverage.AddLine(line.GetLineNumber(), !line.HasBeenExecuted());
+			}
+		}
+		Exporter::CoverageDataSerializer().SerializeHits(randomCoverageData, lineTableFolder, hitsPath1);
+		Exporter::CoverageDataSerializer().SerializeHits(coverageData, lineTableFolder, hitsPath2);
+
+		auto buildId = Exporter::CoverageDataSerializer::ComputeBuildId(randomCoverageData);
+		ASSERT_EQ(buildId, Exporter::CoverageDataSerializer::ComputeBuildId(coverageData));
+		ASSERT_TRUE(std::filesystem::exists(
+			Exporter::CoverageDataSerializer::GetLineTablePath(lineTableFolder, buildId)));
+		ASSERT_EQ(1, std::distance(std::filesystem::directory_iterator{ lineTableFolder.GetPath() },
+		                           std::filesystem::directory_iterator{}));
+
+		Exporter::CoverageDataDeserializer deserializer;
+		TestHelper::CoverageDataComparer().AssertEquals(
+			randomCoverageData, deserializer.Deserialize(hitsPath1, ""));
+		TestHelper::CoverageDataComparer().AssertEquals(
+			coverageData, deserializer.Deserialize(hitsPath2, ""));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataSerializerTest, HitsWithoutLineTable)
+	{
+		TestHelper::TemporaryPath lineTableFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		TestHelper::TemporaryPath hitsPath;
+		Plugin::CoverageData coverageData{ L"", 0 };
+
+		coverageData.AddModule(L"module").AddFile(L"file").AddLine(1, true);
+		Exporter::CoverageDataSerializer().SerializeHits(coverageData, lineTableFolder, hitsPath);
+		std::filesystem::remove(Exporter::CoverageDataSerializer::GetLineTablePath(
+			lineTableFolder, Exporter::CoverageDataSerializer::ComputeBuildId(coverageData)));
+		ASSERT_THROW(Exporter::CoverageDataDeserializer().Deserialize(hitsPath, ""), std::exception);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(CoverageDataSerializerTest, InvalidFile)
 	{
@@ -0,0 +1,178 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+
+#include "Exporter/CoberturaExporter.hpp"
+#include "Exporter/CoverageImporter.hpp"
+#include "Exporter/ExporterException.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace ExporterTest
+{
+	namespace
+	{
+		using Format = Exporter::CoverageImporter::Format;
+
+		//-------------------------------------------------------------------------
+		Plugin::CoverageData Import(const std::string& content, Format format)
+		{
+			std::istringstream istr{ content };
+
+			return Exporter::CoverageImporter{}.Import(istr, format, L"Name");
+		}
+
+		//-------------------------------------------------------------------------
+		std::optional<Format> GetFormat(const std::string& content)
+		{
+			TestHelper::TemporaryPath path;
+			{
+				std::ofstream ofs{ path.GetPath(), std::ios::binary };
+				ofs << content;
+			}
+			return Exporter::CoverageImporter::GetFormat(path);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageImporterTest, GetFormat)
+	{
+		ASSERT_EQ(Format::Cobertura, GetFormat("\xEF\xBB\xBF<?xml version=\"1.0\"?>\n<coverage></coverage>"));
+		ASSERT_EQ(Format::Cobertura, GetFormat("<!DOCTYPE coverage SYSTEM \"coverage.dtd\">\n<coverage/>"));
+		ASSERT_EQ(Format::Lcov, GetFormat("TN:\nSF:File\nend_of_record\n"));
+		ASSERT_EQ(Format::Lcov, GetFormat("SF:File\nend_of_record\n"));
+		ASSERT_EQ(std::nullopt, GetFormat("<?xml version=\"1.0\"?>\n<report/>"));
+		ASSERT_EQ(std::nullopt, GetFormat(std::string{ "\x01\x00", 2 }));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageImporterTest, Cobertura)
+	{
+		auto coverageData = Import(
+			"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+			"<!DOCTYPE coverage SYSTEM \"http://cobertura.sourceforge.net/xml/coverage-04.dtd\">\n"
+			"<coverage line-rate=\"0.5\" version=\"1\">\n"
+			"  <!-- Generated by another tool -->\n"
+			"  <sources><source> C:\\Src </source></sources>\n"
+			"  <packages>\n"
+			"    <package name=\"Module&amp;1\">\n"
+			"      <classes>\n"
+			"        <class name=\"A\" filename=\"Dir/File.cpp\">\n"
+			"          <methods><method name=\"f\"><lines><line number=\"1\" hits=\"100\"/></lines></method></methods>\n"
+			"          <lines><line number=\"1\" hits=\"3\"/><line number=\"2\" hits=\"0\"/></lines>\n"
+			"        </class>\n"
+			"        <class name='B' filename='Dir/File.cpp'>\n"
+			"          <lines><line number='1' hits='5.0'/><line number='3' hits='1' branch='false'/></lines>\n"
+			"        </class>\n"
+			"        <class name=\"C\" filename=\"D:\\Other.cpp\"><lines/></class>\n"
+			"      </classes>\n"
+			"    </package>\n"
+			"    <package name=\"Empty\"><classes/></package>\n"
+			"  </packages>\n"
+			"</coverage>\n",
+			Format::Cobertura);
+
+		ASSERT_EQ(L"Name", coverageData.GetName());
+		const auto& modules = coverageData.GetModules();
+		ASSERT_EQ(1u, modules.size());
+		ASSERT_EQ(L"Module&1", modules[0]->GetPath().wstring());
+
+		const auto& files = modules[0]->GetFiles();
+		ASSERT_EQ(2u, files.size());
+		const auto& file = *files[0];
+		ASSERT_EQ(std::filesystem::path{ L"C:\\Src\\Dir\\File.cpp" }, file.GetPath());
+		ASSERT_EQ(3u, file.GetLines().size());
+		ASSERT_EQ(5u, file[1]->GetHitCount());
+		ASSERT_FALSE(file[2]->HasBeenExecuted());
+		ASSERT_TRUE(file[3]->HasBeenExecuted());
+		ASSERT_EQ(std::filesystem::path{ L"D:\\Other.cpp" }, files[1]->GetPath());
+		ASSERT_TRUE(files[1]->GetLines().empty());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageImporterTest, CoberturaExport)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& file = coverageData.AddModule(L"Module").AddFile(L"C:\\Dev\\File.cpp");
+		file.AddLine(1, true, 2);
+		file.AddLine(2, false);
+
+		std::ostringstream ostr;
+		Exporter::CoberturaExporter{}.Export(coverageData, ostr);
+		auto importedCoverageData = Import(ostr.str(), Format::Cobertura);
+
+		const auto& importedFile = *importedCoverageData.GetModules().at(0)->GetFiles().at(0);
+		ASSERT_EQ(file.GetPath(), importedFile.GetPath());
+		ASSERT_EQ(2u, importedFile[1]->GetHitCount());
+		ASSERT_FALSE(importedFile[2]->HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageImporterTest, InvalidCobertura)
+	{
+		ASSERT_THROW(Import("<coverage><packages>", Format::Cobertura), Exporter::ExporterException);
+		ASSERT_THROW(Import("<coverage a=b/>", Format::Cobertura), Exporter::ExporterException);
+		ASSERT_THROW(Import("<coverage>&unknown;</coverage>", Format::Cobertura), Exporter::ExporterException);
+		ASSERT_THROW(Import(
+			"<coverage><packages><package name=\"M\"><classes><class filename=\"F\">"
+			"<lines><line number=\"x\" hits=\"1\"/></lines></class></classes></package></packages></coverage>",
+			Format::Cobertura), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageImporterTest, Lcov)
+	{
+		auto coverageData = Import(
+			"TN:test1\r\n"
+			"SF:C:\\Dev\\File.cpp\r\n"
+			"FN:1,main\r\n"
+			"DA:1,2\r\n"
+			"DA:2,0,checksum\r\n"
+			"LF:2\r\n"
+			"LH:1\r\n"
+			"end_of_record\r\n"
+			"TN:test2\n"
+			"SF:C:/Dev/./File.cpp\n"
+			"DA:1,3\n"
+			"DA:3,1\n"
+			"end_of_record\n",
+			Format::Lcov);
+
+		const auto& modules = coverageData.GetModules();
+		ASSERT_EQ(1u, modules.size());
+		ASSERT_EQ(L"Name", modules[0]->GetPath().wstring());
+
+		// The same file written with another separator is merged.
+		ASSERT_EQ(1u, modules[0]->GetFiles().size());
+		const auto& file = *modules[0]->GetFiles().at(0);
+		ASSERT_EQ(std::filesystem::path{ L"C:\\Dev\\File.cpp" }, file.GetPath());
+		ASSERT_EQ(3u, file.GetLines().size());
+		ASSERT_EQ(5u, file[1]->GetHitCount());
+		ASSERT_FALSE(file[2]->HasBeenExecuted());
+		ASSERT_TRUE(file[3]->HasBeenExecuted());
+
+		ASSERT_THROW(Import("SF:File\nDA:1\nend_of_record\n", Format::Lcov), Exporter::ExporterException);
+	}
+}
@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Exporter/Binary/CoverageDataReader.hpp"
+#include "Exporter/Binary/CoverageQueryIndex.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(CoverageQueryIndexTest, Query)
+	{
+		TestHelper::TemporaryPath path;
+		Plugin::CoverageData coverageData{ L"name", 0 };
+		auto& module1 = coverageData.AddModule(L"module1");
+
+		module1.AddFile(L"C:\\Dir\\File1.cpp").AddLine(10, true);
+		module1.AddFile(L"C:\\Dir\\File2.cpp").AddLine(20, false);
+		auto& file1 = coverageData.AddModule(L"module2").AddFile(L"C:\\Dir\\File1.cpp");
+		file1.AddLine(10, false);
+		file1.AddLine(11, true);
+		Exporter::CoverageDataSerializer().Serialize(coverageData, path);
+
+		Exporter::CoverageDataReader reader{ path, "" };
+		Exporter::CoverageQueryIndex index{ reader };
+
+		std::vector<size_t> expectedModules{ 0, 1 };
+		ASSERT_EQ(expectedModules, index.GetModules(L"c:\\dir\\subdir\\..\\file1.CPP"));
+		ASSERT_EQ(std::vector<size_t>{ 0 }, index.GetModules(L"C:/Dir/File2.cpp"));
+		ASSERT_TRUE(index.GetModules(L"C:\\Dir\\File3.cpp").empty());
+
+		const auto& entries = index.GetFileCoverages(L"C:\\Dir\\File1.cpp");
+		ASSERT_EQ(2, entries.size());
+		ASSERT_EQ(1, entries[1].moduleIndex_);
+		ASSERT_EQ(2, entries[1].file_.GetLineCount());
+		ASSERT_TRUE(entries[1].file_.HasBeenExecuted(1));
+	}
+}
@@ -0,0 +1,123 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <string>
+#include <vector>
+
+#include "Exporter/Html/CppSyntaxHighlighter.hpp"
+
+using Exporter::CppSyntaxHighlighter;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::vector<std::string> Highlight(const std::vector<std::string>& lines)
+		{
+			CppSyntaxHighlighter highlighter;
+			std::vector<std::string> results;
+
+			for (const auto& line : lines)
+			{
+				std::string output;
+				highlighter.AppendLine(output, line);
+				results.push_back(output);
+			}
+			return results;
+		}
+
+		//---------------------------------------------------------------------
+		std::string Span(const std::string& cssClass, const std::string& text)
+		{
+			return "<span class=\"" + cssClass + "\">" + text + "</span>";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppSyntaxHighlighterTest, Tokens)
+	{
+		auto lines = Highlight({ "int value = Foo(1.5e-3, x); // comment" });
+
+		ASSERT_EQ(
+			Span(CppSyntaxHighlighter::KeywordClass, "int ") + "value "
+			+ Span(CppSyntaxHighlighter::PunctuationClass, "= ")
+			+ Span(CppSyntaxHighlighter::TypeClass, "Foo")
+			+ Span(CppSyntaxHighlighter::PunctuationClass, "(")
+			+ Span(CppSyntaxHighlighter::LiteralClass, "1.5e-3")
+			+ Span(CppSyntaxHighlighter::PunctuationClass, ", ") + "x"
+			+ Span(CppSyntaxHighlighter::PunctuationClass, "); ")
+			+ Span(CppSyntaxHighlighter::CommentClass, "// comment"),
+			lines.at(0));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppSyntaxHighlighterTest, Escape)
+	{
+		auto lines = Highlight({ "a<\"<&>\"" });
+
+		ASSERT_EQ(
+			"a" + Span(CppSyntaxHighlighter::PunctuationClass, "&lt;")
+			+ Span(CppSyntaxHighlighter::StringClass, "&quot;&lt;&amp;&gt;&quot;"),
+			lines.at(0));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppSyntaxHighlighterTest, Preprocessor)
+	{
+		auto lines = Highlight({ "#include <vector>", "  #  define X \"a\\\"b\"" });
+
+		ASSERT_EQ(
+			Span(CppSyntaxHighlighter::CommentClass, "#include ")
+			+ Span(CppSyntaxHighlighter::StringClass, "&lt;vector&gt;"),
+			lines.at(0));
+		ASSERT_EQ(
+			"  " + Span(CppSyntaxHighlighter::CommentClass, "#  define ") + "X "
+			+ Span(CppSyntaxHighlighter::StringClass, "&quot;a\\&quot;b&quot;"),
+			lines.at(1));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppSyntaxHighlighterTest, BlockComment)
+	{
+		auto lines = Highlight({ "x /* begin", "middle", "end */ return" });
+
+		ASSERT_EQ("x " + Span(CppSyntaxHighlighter::CommentClass, "/* begin"), lines.at(0));
+		ASSERT_EQ(Span(CppSyntaxHighlighter::CommentClass, "middle"), lines.at(1));
+		ASSERT_EQ(
+			Span(CppSyntaxHighlighter::CommentClass, "end */ ")
+			+ Span(CppSyntaxHighlighter::KeywordClass, "return"),
+			lines.at(2));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CppSyntaxHighlighterTest, RawString)
+	{
+		auto lines = Highlight({ "auto s = u8R\"tag(a)\"", ")tag\";" });
+
+		ASSERT_EQ(
+			Span(CppSyntaxHighlighter::KeywordClass, "auto ") + "s "
+			+ Span(CppSyntaxHighlighter::PunctuationClass, "= ")
+			+ Span(CppSyntaxHighlighter::StringClass, "u8R&quot;tag(a)&quot;"),
+			lines.at(0));
+		ASSERT_EQ(
+			Span(CppSyntaxHighlighter::StringClass, ")tag&quot;")
+			+ Span(CppSyntaxHighlighter::PunctuationClass, ";"),
+			lines.at(1));
+	}
+}
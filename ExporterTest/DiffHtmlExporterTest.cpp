@@ -0,0 +1,99 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "Exporter/Html/DiffHtmlExporter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string ReadContent(const fs::path& path)
+		{
+			std::ifstream ifs{ path, std::ios::binary };
+
+			return std::string{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DiffHtmlExporterTest, ComputeHunks)
+	{
+		Plugin::FileCoverage file{ "File.cpp" };
+
+		file.AddLine(20, false);
+		file.AddLine(2, true);
+		file.AddLine(8, false);
+
+		auto hunks = Exporter::DiffHtmlExporter::ComputeHunks(file, 2);
+		ASSERT_EQ(3u, hunks.size());
+		ASSERT_EQ(1u, hunks[0].firstLineNumber_);
+		ASSERT_EQ(4u, hunks[0].lastLineNumber_);
+		ASSERT_EQ(6u, hunks[1].firstLineNumber_);
+		ASSERT_EQ(10u, hunks[1].lastLineNumber_);
+		ASSERT_EQ(18u, hunks[2].firstLineNumber_);
+		ASSERT_EQ(22u, hunks[2].lastLineNumber_);
+
+		// Adjacent ranges are merged.
+		hunks = Exporter::DiffHtmlExporter::ComputeHunks(file, 5);
+		ASSERT_EQ(2u, hunks.size());
+		ASSERT_EQ(13u, hunks[0].lastLineNumber_);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(DiffHtmlExporterTest, Export)
+	{
+		TestHelper::TemporaryPath source;
+		TestHelper::TemporaryPath output;
+		{
+			std::ofstream ofs{ source.GetPath() };
+			for (int i = 1; i <= 20; ++i)
+				ofs << "line" << i << (i == 10 ? " < 1" : "") << '\n';
+		}
+		Plugin::CoverageData coverageData{ L"Test", 0 };
+		auto& file = coverageData.AddModule(L"Module.exe").AddFile(source);
+		file.AddLine(10, true);
+		file.AddLine(11, false);
+		coverageData.AddModule(L"Module.dll").AddFile(L"NotChanged.cpp");
+
+		Exporter::DiffHtmlExporter exporter;
+		exporter.Export(coverageData, output);
+
+		auto html = ReadContent(output);
+		ASSERT_NE(std::string::npos, html.find("<td>1/2</td><td>50%</td>"));
+		ASSERT_NE(std::string::npos, html.find("@@ +7,8 @@"));
+		ASSERT_NE(std::string::npos, html.find("<tr class=\"c\"><td>10</td><td>line10 &lt; 1</td></tr>"));
+		ASSERT_NE(std::string::npos, html.find("<tr class=\"u\"><td>11</td>"));
+		// Only the hunk is rendered.
+		ASSERT_EQ(std::string::npos, html.find(">line6<"));
+		ASSERT_EQ(std::string::npos, html.find(">line15<"));
+		ASSERT_EQ(std::string::npos, html.find("NotChanged.cpp"));
+	}
+}
@@ -26,6 +26,7 @@
 #include "Exporter/Plugin/ExporterPluginManager.hpp"
 
 #include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/CoverageDataView.hpp"
 
 #include "Tools/Tool.hpp"
 
@@ -60,6 +61,11 @@ namespace ExporterTest
 			             void(const std::optional<std::wstring>&));
 			MOCK_METHOD0(GetArgumentHelpDescription, std::wstring());
 			MOCK_CONST_METHOD0(GetExportPluginVersion, int());
+			MOCK_CONST_METHOD0(IsThreadSafe, bool());
+			MOCK_METHOD2(ExportView,
+			             std::optional<std::filesystem::path>(
+			                 const Plugin::CoverageDataView&,
+			                 const std::optional<std::wstring>& argument));
 		};
 	}
 
@@ -81,36 +87,51 @@ namespace ExporterTest
 		std::unique_ptr<Exporter::ExporterPluginManager>
 		CreateManager(std::unique_ptr<ExportPluginMock> exportPlugin)
 		{
-			PluginLoaderMock pluginLoader;
+			return CreateManager(CreatePluginLoader(std::move(exportPlugin)));
+		}
 
-			EXPECT_CALL(pluginLoader, TryLoadPlugin(pluginPath_, _))
-			    .WillOnce(testing::Invoke([&](const auto& p, const auto&) {
-				    EXPECT_EQ(pluginPath_, p);
+		//---------------------------------------------------------------------
+		// The plugin can be loaded after the creation of the manager.
+		std::shared_ptr<PluginLoaderMock>
+		CreatePluginLoader(std::unique_ptr<ExportPluginMock> exportPlugin) const
+		{
+			auto pluginLoader = std::make_shared<PluginLoaderMock>();
+			auto sharedExportPlugin = std::make_shared<std::unique_ptr<ExportPluginMock>>(
+			    std::move(exportPlugin));
+			auto pluginPath = pluginPath_;
+
+			EXPECT_CALL(*pluginLoader, TryLoadPlugin(pluginPath_, _))
+			    .WillOnce(testing::Invoke([=](const auto& p, const auto&) {
+				    EXPECT_EQ(pluginPath, p);
 				    auto plugin = std::make_unique<
 				        Exporter::LoadedPlugin<Plugin::IExportPlugin>>(nullptr);
-				    plugin->Set(std::move(exportPlugin));
+				    plugin->Set(std::move(*sharedExportPlugin));
 
 				    return plugin;
 			    }));
-			return CreateManager(pluginLoader);
+			return pluginLoader;
 		}
 
 		//---------------------------------------------------------------------
 		std::unique_ptr<Exporter::ExporterPluginManager>
-		CreateManager(PluginLoaderMock& pluginLoader)
+		CreateManager(std::shared_ptr<PluginLoaderMock> pluginLoader)
 		{
 			return std::make_unique<Exporter::ExporterPluginManager>(
-			    pluginLoader, std::filesystem::path{pluginFolder_.GetPath()});
+			    std::move(pluginLoader), std::filesystem::path{pluginFolder_.GetPath()});
 		}
 
 		//---------------------------------------------------------------------
 		std::unique_ptr<ExportPluginMock> CreateExportPluginMock(
-		    int pluginVersion = Plugin::CurrentExportPluginVersion) const
+		    int pluginVersion = Plugin::CurrentExportPluginVersion,
+		    bool isThreadSafe = false) const
 		{
 			auto exportPlugin = std::make_unique<ExportPluginMock>();
 
 			EXPECT_CALL(*exportPlugin, GetExportPluginVersion())
 			    .WillOnce(testing::Return(pluginVersion));
+			EXPECT_CALL(*exportPlugin, IsThreadSafe())
+			    .Times(testing::AtMost(1))
+			    .WillRepeatedly(testing::Return(isThreadSafe));
 
 			return exportPlugin;
 		}
@@ -150,6 +171,43 @@ namespace ExporterTest
 		             Exporter::ExporterException);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST_F(ExporterPluginManagerTest, Manifest)
+	{
+		const std::wstring description = L"description";
+		auto manifestPath = pluginPath_;
+		manifestPath.replace_extension(Exporter::ExporterPluginManager::ManifestExtension);
+		Exporter::ExporterPluginManager::WriteManifest(manifestPath, description);
+
+		auto exportPlugin = CreateExportPluginMock();
+		const std::optional<std::wstring> argument = L"argument";
+		EXPECT_CALL(*exportPlugin, GetArgumentHelpDescription()).Times(0);
+		EXPECT_CALL(*exportPlugin, CheckArgument(argument));
+
+		auto pluginManager = CreateManager(CreatePluginLoader(std::move(exportPlugin)));
+		auto pluginDescriptions =
+		    pluginManager->CreateExportPluginDescriptions();
+
+		ASSERT_EQ(1, pluginDescriptions.size());
+		ASSERT_EQ(description, pluginDescriptions[0].GetParameterDescription());
+		ASSERT_FALSE(pluginManager->IsLoaded(pluginName_));
+
+		pluginDescriptions[0].CheckArgument(argument);
+		ASSERT_TRUE(pluginManager->IsLoaded(pluginName_));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(ExporterPluginManagerTest, InvalidManifest)
+	{
+		auto manifestPath = pluginPath_;
+		manifestPath.replace_extension(Exporter::ExporterPluginManager::ManifestExtension);
+		TestHelper::CreateEmptyFile(manifestPath);
+
+		auto pluginLoader = std::make_shared<PluginLoaderMock>();
+		EXPECT_CALL(*pluginLoader, TryLoadPlugin(_, _)).Times(0);
+		ASSERT_THROW(CreateManager(pluginLoader), std::runtime_error);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST_F(ExporterPluginManagerTest, InvalidVersion)
 	{
@@ -161,15 +219,37 @@ namespace ExporterTest
 		    CreateExportPluginMock(Plugin::CurrentExportPluginVersion + 1);
 		ASSERT_THROW(CreateManager(std::move(exportPlugin)),
 		             std::runtime_error);
+
+		exportPlugin =
+		    CreateExportPluginMock(Plugin::CurrentExportPluginVersion - 1);
+		ASSERT_THROW(CreateManager(std::move(exportPlugin)),
+		             std::runtime_error);
+
+		exportPlugin = CreateExportPluginMock(0);
+		ASSERT_THROW(CreateManager(std::move(exportPlugin)),
+		             std::runtime_error);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(ExporterPluginManagerTest, IsThreadSafe)
+	{
+		auto pluginManager = CreateManager(CreateExportPluginMock(
+		    Plugin::CurrentExportPluginVersion, true));
+		ASSERT_TRUE(pluginManager->IsThreadSafe(pluginName_));
+		ASSERT_FALSE(pluginManager->IsThreadSafe(L"InvalidPluginName"));
+
+		pluginManager = CreateManager(CreateExportPluginMock(
+		    Plugin::CurrentExportPluginVersion, false));
+		ASSERT_FALSE(pluginManager->IsThreadSafe(pluginName_));
 	}
 
 	//-------------------------------------------------------------------------
 	TEST_F(ExporterPluginManagerTest, TryLoadPluginFailure)
 	{
-		PluginLoaderMock pluginLoader;
+		auto pluginLoader = std::make_shared<PluginLoaderMock>();
 		const auto errorMessage = "errorMessage";
 
-		EXPECT_CALL(pluginLoader, TryLoadPlugin(pluginPath_, _))
+		EXPECT_CALL(*pluginLoader, TryLoadPlugin(pluginPath_, _))
 		    .WillOnce(testing::Invoke([&](const auto&, const auto&) {
 			    throw 42;
 			    return nullptr;
@@ -202,6 +282,20 @@ namespace ExporterTest
 		pluginManager->Export(pluginName_, coverageData, argument);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST_F(ExporterPluginManagerTest, ExportView)
+	{
+		Plugin::CoverageData coverageData{L"", 0};
+		Plugin::CoverageDataView coverageDataView{coverageData};
+		const std::optional<std::wstring> argument = L"argument";
+
+		auto exportPlugin = CreateExportPluginMock();
+		EXPECT_CALL(*exportPlugin, ExportView(testing::Ref(coverageDataView), argument));
+		EXPECT_CALL(*exportPlugin, Export(_, _)).Times(0);
+		auto pluginManager = CreateManager(std::move(exportPlugin));
+		pluginManager->Export(pluginName_, coverageDataView, argument);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST_F(ExporterPluginManagerTest, InvalidExport)
 	{
@@ -0,0 +1,49 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "stdafx.h"
+
+#include <sstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "Exporter/FirstHitsExporter.hpp"
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(FirstHitsExporterTest, Export)
+	{
+		Plugin::CoverageData coverageData{L"", 0};
+		auto& module = coverageData.AddModule(L"Module");
+		auto& file = module.AddFile(L"File");
+
+		file.AddLine(1, true, 1, 2, 30);
+		file.AddLine(2, false);
+		module.AddFile(L"File2").AddLine(5, true, 1, 1, 10);
+
+		std::wostringstream ostr;
+		Exporter::FirstHitsExporter().Export(coverageData, ostr);
+
+		ASSERT_EQ(L"Order\tTime (us)\tModule\tFile\tLine\n"
+		          L"1\t10\tModule\tFile2\t5\n"
+		          L"2\t30\tModule\tFile\t1\n",
+		          ostr.str());
+	}
+}
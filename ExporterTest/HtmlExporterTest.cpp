@@ -23,9 +23,13 @@
 
 #include <fstream>
 #include <filesystem>
+#include <iterator>
 
+#include "Exporter/ExporterException.hpp"
 #include "Exporter/Html/HtmlExporter.hpp"
 #include "Exporter/Html/HtmlFolderStructure.hpp"
+#include "Exporter/Html/HtmlManifest.hpp"
+#include "Exporter/ReportWriter.hpp"
 
 #include "TestHelper/TemporaryPath.hpp"
 
@@ -60,12 +64,14 @@ namespace ExporterTest
 		}
 
 		//---------------------------------------------------------------------
-		void CheckWarningInIndex(bool expectedValue)
+		void CheckWarningInIndex(
+			bool expectedValue,
+			const std::wstring& message = Exporter::HtmlExporter::WarningExitCodeMessage)
 		{
 			auto indexPath = output_.GetPath() / "index.html";
 			ASSERT_TRUE(Tools::FileExists(indexPath));
 			std::wifstream ifs{ indexPath.string()};
-			bool hasWarning = Contains(ifs, Exporter::HtmlExporter::WarningExitCodeMessage);
+			bool hasWarning = Contains(ifs, message);
 			
 			ASSERT_EQ(expectedValue, hasWarning);
 		}
@@ -119,6 +125,17 @@ namespace ExporterTest
 		CheckWarningInIndex(true);
 	}
 
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, Sampled)
+	{
+		Plugin::CoverageData data{ L"Test", 0 };
+
+		data.SetSampled(true);
+		htmlExporter_.Export(data, output_);
+		CheckWarningInIndex(false);
+		CheckWarningInIndex(true, Exporter::HtmlExporter::SampledCoverageMessage);
+	}
+
 	//-------------------------------------------------------------------------
 	TEST_F(HtmlExporterTest, SubFolderDoesNotExist)
 	{
@@ -160,5 +177,201 @@ namespace ExporterTest
 		ASSERT_TRUE(Tools::FileExists(modulesPath / "module" / (filename + L"2.html")));
 		ASSERT_TRUE(Tools::FileExists(modulesPath / "module.html"));
 	}
-}
 
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, ManySourceFiles)
+	{
+		Plugin::CoverageData data{ L"Test", 0 };
+		const std::wstring filename = L"TestFile1.cpp";
+		const int fileCount = 100;
+
+		auto& module = data.AddModule(L"module.exe");
+		for (int i = 0; i < fileCount; ++i)
+			module.AddFile(fs::path(PROJECT_DIR) / "Data" / filename).AddLine(1, i % 2 == 0);
+
+		htmlExporter_.Export(data, output_);
+
+		auto modulesPath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules;
+		std::wifstream ifs{ (modulesPath / "module.html").string() };
+		std::wstring modulePage{ std::istreambuf_iterator<wchar_t>{ifs}, std::istreambuf_iterator<wchar_t>{} };
+
+		// The names are the same as when the pages are generated in order.
+		for (int i = 1; i <= fileCount; ++i)
+		{
+			auto htmlFilename = filename + (i == 1 ? L"" : std::to_wstring(i)) + L".html";
+			auto htmlFilePath = modulesPath / "module" / htmlFilename;
+
+			ASSERT_TRUE(Tools::FileExists(htmlFilePath));
+			ASSERT_NE(0, fs::file_size(htmlFilePath));
+			ASSERT_NE(std::wstring::npos, modulePage.find(L"module/" + htmlFilename + L"\""));
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, Incremental)
+	{
+		Exporter::HtmlExporter htmlExporter{ fs::canonical(OUT_DIR) / "Template", true };
+		Plugin::CoverageData data{ L"Test", 0 };
+		auto& module = data.AddModule(L"module.exe");
+		module.AddFile(fs::path(PROJECT_DIR) / "Data" / "TestFile1.cpp").AddLine(1, true);
+		auto& file2 = module.AddFile(fs::path(PROJECT_DIR) / "Data" / "TestFile2.cpp");
+		file2.AddLine(1, true);
+
+		auto modulePath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules / "module";
+		auto page1 = modulePath / "TestFile1.cpp.html";
+		auto page2 = modulePath / "TestFile2.cpp.html";
+		auto markPage = [](const fs::path& path) { std::ofstream{ path.string() } << "Not generated"; };
+		auto isMarked = [](const fs::path& path) {
+			std::ifstream ifs{ path.string() };
+			std::string content{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+			return content == "Not generated";
+		};
+
+		htmlExporter.Export(data, output_);
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / Exporter::HtmlManifest::Filename));
+		markPage(page1);
+		markPage(page2);
+		file2.UpdateLine(1, false);
+		htmlExporter.Export(data, output_);
+		ASSERT_TRUE(isMarked(page1));
+		ASSERT_FALSE(isMarked(page2));
+
+		Plugin::CoverageData dataWithoutFile2{ L"Test", 0 };
+		dataWithoutFile2.AddModule(L"module.exe").AddFile(fs::path(PROJECT_DIR) / "Data" / "TestFile1.cpp").AddLine(1, true);
+		htmlExporter.Export(dataWithoutFile2, output_);
+		ASSERT_TRUE(isMarked(page1));
+		ASSERT_FALSE(Tools::FileExists(page2));
+
+		// A full export does not keep the manifest as it rewrites the pages.
+		htmlExporter_.Export(dataWithoutFile2, output_);
+		ASSERT_FALSE(isMarked(page1));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / Exporter::HtmlManifest::Filename));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, Compression)
+	{
+		fs::path testFolder = fs::path(PROJECT_DIR) / "Data";
+		Plugin::CoverageData data{ L"Test", 0 };
+		data.AddModule(L"Module1.exe").AddFile(testFolder / L"TestFile1.cpp").AddLine(0, true);
+		auto templateFolder = fs::canonical(OUT_DIR) / "Template";
+		auto zipPath = output_.GetPath();
+		zipPath += Exporter::ReportWriter::ZipExtension;
+
+		Exporter::HtmlExporter{ templateFolder, false, CppCoverage::ReportCompression::Zip }.Export(data, output_);
+		ASSERT_TRUE(Tools::FileExists(zipPath));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath()));
+		fs::remove(zipPath);
+
+		Exporter::HtmlExporter{ templateFolder, false, CppCoverage::ReportCompression::Gzip }.Export(data, output_);
+		auto modulesPath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules;
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / "index.html.gz"));
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module1.html.gz"));
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module1" / "TestFile1.cpp.html.gz"));
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / Exporter::ReportWriter::GzipManifestFilename));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / "index.html"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, SharedThirdParty)
+	{
+		fs::path testFolder = fs::path(PROJECT_DIR) / "Data";
+		Plugin::CoverageData data{ L"Test", 0 };
+		data.AddModule(L"Module1.exe").AddFile(testFolder / L"TestFile1.cpp").AddLine(0, true);
+		auto templateFolder = fs::canonical(OUT_DIR) / "Template";
+		TestHelper::TemporaryPath assetsFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		TestHelper::TemporaryPath otherOutput;
+
+		Exporter::HtmlExporter{ templateFolder, false, CppCoverage::ReportCompression::None, &assetsFolder.GetPath() }.Export(data, output_);
+		Exporter::HtmlExporter{ templateFolder, false, CppCoverage::ReportCompression::None, &assetsFolder.GetPath() }.Export(data, otherOutput);
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / "index.html"));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / Exporter::HtmlFolderStructure::ThirdParty));
+		ASSERT_FALSE(Tools::FileExists(otherOutput.GetPath() / Exporter::HtmlFolderStructure::ThirdParty));
+
+		std::vector<fs::path> sharedFolders{ fs::directory_iterator{ assetsFolder.GetPath() }, fs::directory_iterator{} };
+		ASSERT_EQ(1u, sharedFolders.size());
+		ASSERT_EQ(0u, sharedFolders[0].filename().wstring().find(Exporter::HtmlFolderStructure::ThirdParty + L"-"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, Shard)
+	{
+		fs::path testFolder = fs::path(PROJECT_DIR) / "Data";
+		Plugin::CoverageData data{ L"Test", 0 };
+		auto& module = data.AddModule(L"Module1.exe");
+		module.AddFile(testFolder / L"TestFile1.cpp").AddLine(0, true);
+		module.AddFile(testFolder / L"TestFile2.cpp").AddLine(0, true);
+		auto templateFolder = fs::canonical(OUT_DIR) / "Template";
+		auto modulesPath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules;
+		auto exportShard = [&](size_t index, size_t count) {
+			CppCoverage::HtmlShard shard{ index, count };
+			Exporter::HtmlExporter{ templateFolder, false, CppCoverage::ReportCompression::None,
+				nullptr, nullptr, &shard }.Export(data, output_);
+		};
+
+		exportShard(2, 2);
+		ASSERT_FALSE(Tools::FileExists(modulesPath / "module1" / "TestFile1.cpp.html"));
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module1" / "TestFile2.cpp.html"));
+		ASSERT_FALSE(Tools::FileExists(modulesPath / "module1.html"));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / "index.html"));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / Exporter::HtmlFolderStructure::ThirdParty));
+
+		exportShard(1, 2);
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module1" / "TestFile1.cpp.html"));
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module1.html"));
+		ASSERT_FALSE(Tools::FileExists(output_.GetPath() / "index.html"));
+
+		exportShard(0, 0);
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / "index.html"));
+		ASSERT_TRUE(Tools::FileExists(output_.GetPath() / Exporter::HtmlFolderStructure::ThirdParty));
+
+		CppCoverage::HtmlShard shard{ 1, 2 };
+		ASSERT_THROW((Exporter::HtmlExporter{ templateFolder, true, CppCoverage::ReportCompression::None,
+			nullptr, nullptr, &shard }), Exporter::ExporterException);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, ModuleIndex)
+	{
+		Plugin::CoverageData data{ L"Test", 0 };
+		auto& module = data.AddModule(L"module.exe");
+
+		for (size_t i = 0; i <= Exporter::HtmlExporter::MaxModulePageFileCount; ++i)
+			module.AddFile(L"NotFound" + std::to_wstring(i) + L".cpp").AddLine(1, true);
+		htmlExporter_.Export(data, output_);
+
+		auto modulePagePath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules / "module.html";
+		std::ifstream ifs{ modulePagePath.string() };
+		std::string modulePage{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+
+		ASSERT_NE(std::string::npos, modulePage.find("[0,\"NotFound0.cpp\",\"\",1,1]"));
+		ASSERT_EQ(std::string::npos, modulePage.find("pi_"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(HtmlExporterTest, SharedSourcePage)
+	{
+		Plugin::CoverageData data{ L"Test", 0 };
+		const std::wstring filename = L"TestFile1.cpp";
+		auto filePath = fs::path(PROJECT_DIR) / "Data" / filename;
+
+		data.AddModule(L"Module1.exe").AddFile(filePath).AddLine(1, true);
+		data.AddModule(L"Module2.exe").AddFile(filePath).AddLine(1, true);
+		data.AddModule(L"Module3.exe").AddFile(filePath).AddLine(1, false);
+		htmlExporter_.Export(data, output_);
+
+		auto modulesPath = output_.GetPath() / Exporter::HtmlFolderStructure::FolderModules;
+		auto htmlFilename = filename + L".html";
+		// Module1 and Module2 have the same coverage rate so their order is not defined.
+		auto isModule1First = Tools::FileExists(modulesPath / "module1" / htmlFilename);
+		std::wstring sharedModule = isModule1First ? L"module1" : L"module2";
+		std::wstring otherModule = isModule1First ? L"module2" : L"module1";
+		ASSERT_TRUE(Tools::FileExists(modulesPath / sharedModule / htmlFilename));
+		ASSERT_FALSE(Tools::FileExists(modulesPath / otherModule / htmlFilename));
+		ASSERT_TRUE(Tools::FileExists(modulesPath / "module3" / htmlFilename));
+
+		std::wifstream ifs{ (modulesPath / (otherModule + L".html")).string() };
+		std::wstring modulePage{ std::istreambuf_iterator<wchar_t>{ifs}, std::istreambuf_iterator<wchar_t>{} };
+		ASSERT_NE(std::wstring::npos, modulePage.find(sharedModule + L"/" + htmlFilename + L"\""));
+	}
+}
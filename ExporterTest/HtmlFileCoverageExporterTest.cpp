@@ -21,7 +21,9 @@
 #include <boost/algorithm/string.hpp>
 #include "Plugin/Exporter/FileCoverage.hpp"
 #include "Exporter/Html/HtmlFileCoverageExporter.hpp"
+#include "Exporter/Html/CppSyntaxHighlighter.hpp"
 #include "TestHelper/TemporaryPath.hpp"
+#include "Tools/Tool.hpp"
 
 namespace ExporterTest
 {
@@ -146,4 +148,72 @@ namespace ExporterTest
 		ASSERT_TRUE(exporter.MustEnableCodePrettify(2000, 2000));
 		ASSERT_FALSE(exporter.MustEnableCodePrettify(2000, 2001));
 	}
-}
\ No newline at end of file
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, EscapedLine)
+	{
+		auto exportedLines = GetExportedLines({ 
+			{ L"if (a < b && c > \"0123456789\")", CoverageType::NotExecutable },
+			{ L"<&>\"", CoverageType::NotExecutable } });
+
+		ASSERT_EQ(L"if (a &lt; b &amp;&amp; c &gt; &quot;0123456789&quot;)", exportedLines.at(0));
+		ASSERT_EQ(L"&lt;&amp;&gt;&quot;", exportedLines.at(1));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, Utf8Export)
+	{
+		TestHelper::TemporaryPath sourceFile;
+		Plugin::FileCoverage fileCoverage{ sourceFile };
+		{
+			std::ofstream ofs(sourceFile.GetPath().string(), std::ios::binary);
+			ofs << "\xC3\xA9<\r\n";
+		}
+		fileCoverage.AddLine(1, true);
+
+		std::string output;
+		Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
+		ASSERT_EQ("\n" + Tools::ToUtf8String(StyleExecuted + L"\u00E9&lt;" + EndStyle), output);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, AnsiExport)
+	{
+		TestHelper::TemporaryPath sourceFile;
+		Plugin::FileCoverage fileCoverage{ sourceFile };
+		{
+			std::ofstream ofs(sourceFile.GetPath().string(), std::ios::binary);
+			ofs << "\xE9<\r\n";
+		}
+
+		std::string output;
+		Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output);
+		ASSERT_EQ("\n" + Tools::ToUtf8String(Tools::LocalToWString("\xE9")) + "&lt;", output);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(HtmlFileCoverageExporterTest, ExportedSyntaxHighlighting)
+	{
+		TestHelper::TemporaryPath sourceFile;
+		Plugin::FileCoverage fileCoverage{ sourceFile };
+		{
+			std::ofstream ofs(sourceFile.GetPath().string(), std::ios::binary);
+			ofs << "int a;\nint b;\n";
+		}
+		fileCoverage.AddLine(1, true);
+
+		std::string output;
+		ASSERT_EQ(Exporter::SyntaxHighlighting::CodePrettify, Exporter::HtmlFileCoverageExporter{}.Export(fileCoverage, output));
+		ASSERT_EQ(std::string::npos, output.find("<span class="));
+
+		output.clear();
+		ASSERT_EQ(Exporter::SyntaxHighlighting::Exported, Exporter::HtmlFileCoverageExporter{ 1 }.Export(fileCoverage, output));
+		auto keyword = "<span class=\"" + Exporter::CppSyntaxHighlighter::KeywordClass + "\">int </span>";
+		ASSERT_EQ("\n" + Tools::ToUtf8String(StyleExecuted) + keyword + "a<span class=\"pun\">;</span>"
+			+ Tools::ToUtf8String(EndStyle) + "\n" + keyword + "b<span class=\"pun\">;</span>", output);
+
+		output.clear();
+		Exporter::HtmlFileCoverageExporter exporterWithoutHighlighting{ 1, 1000, 2000, false };
+		ASSERT_EQ(Exporter::SyntaxHighlighting::None, exporterWithoutHighlighting.Export(fileCoverage, output));
+	}
+}
@@ -0,0 +1,84 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+
+#include "Exporter/Html/HtmlManifest.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		const Exporter::HtmlPageVersion Version{ 1, 2, 3 };
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HtmlManifestTest, WriteRead)
+	{
+		TestHelper::TemporaryPath outputFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Exporter::HtmlManifest manifest;
+		const auto pagePath = fs::path{ "Modules" } / "module" / "file name.cpp.html";
+
+		manifest.SetPageVersion(pagePath, Version);
+		manifest.SetPageVersion("Modules/module.html", Exporter::HtmlPageVersion{ 0, 0xFFFFFFFFFFFFFFFF, 4 });
+		manifest.Write(outputFolder);
+
+		auto manifestRead = Exporter::HtmlManifest::Read(outputFolder);
+		ASSERT_TRUE(manifestRead.IsUpToDate(pagePath, Version));
+		ASSERT_TRUE(manifestRead.IsUpToDate("Modules/module.html", Exporter::HtmlPageVersion{ 0, 0xFFFFFFFFFFFFFFFF, 4 }));
+		ASSERT_FALSE(manifestRead.IsUpToDate(pagePath, Exporter::HtmlPageVersion{ 1, 2, 4 }));
+		ASSERT_FALSE(manifestRead.IsUpToDate("Modules/unknown.html", Version));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HtmlManifestTest, GetRemovedPages)
+	{
+		Exporter::HtmlManifest manifest;
+		Exporter::HtmlManifest newManifest;
+
+		manifest.SetPageVersion("page1.html", Version);
+		manifest.SetPageVersion("page2.html", Version);
+		newManifest.SetPageVersion("page2.html", Exporter::HtmlPageVersion{ 4, 5, 6 });
+		newManifest.SetPageVersion("page3.html", Version);
+
+		ASSERT_EQ(std::vector<fs::path>{ "page1.html" }, manifest.GetRemovedPages(newManifest));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(HtmlManifestTest, InvalidManifest)
+	{
+		TestHelper::TemporaryPath outputFolder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+
+		ASSERT_FALSE(Exporter::HtmlManifest::Read(outputFolder).IsUpToDate("page.html", Version));
+		{
+			std::ofstream ofs{ (outputFolder.GetPath() / Exporter::HtmlManifest::Filename).string() };
+			ofs << "Invalid";
+		}
+		ASSERT_FALSE(Exporter::HtmlManifest::Read(outputFolder).IsUpToDate("page.html", Version));
+
+		Exporter::HtmlManifest manifest;
+		manifest.SetPageVersion("page.html", Version);
+		manifest.Write(outputFolder);
+		Exporter::HtmlManifest::Remove(outputFolder);
+		ASSERT_FALSE(Exporter::HtmlManifest::Read(outputFolder).IsUpToDate("page.html", Version));
+	}
+}
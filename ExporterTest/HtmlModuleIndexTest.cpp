@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <filesystem>
+#include <string>
+
+#include "Exporter/Html/HtmlModuleIndex.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(HtmlModuleIndexTest, ToJson)
+	{
+		auto folder = fs::path{ "src" };
+		auto subFolder = folder / "sub";
+		auto link = fs::path{ "module" } / "b.cpp.html";
+		Exporter::HtmlModuleIndex moduleIndex{ "module.exe", CppCoverage::CoverageRate{ 3, 7 } };
+
+		moduleIndex.AddFile(folder / "a.cpp", CppCoverage::CoverageRate{ 2, 3 }, nullptr);
+		moduleIndex.AddFile(subFolder / "b<.cpp", CppCoverage::CoverageRate{ 1, 4 }, &link);
+
+		std::string separator = fs::path::preferred_separator == '\\' ? "\\\\" : "/";
+		ASSERT_EQ(
+			"{\"module\":[\"module.exe\",3,10],"
+			"\"separator\":\"" + separator + "\","
+			"\"dirs\":[[\"\",3,10,2],[\"src\",3,10,2],[\"src" + separator + "sub\",1,5,1]],"
+			"\"files\":[[1,\"a.cpp\",\"\",2,5],[2,\"b\\u003c.cpp\",\"module/b.cpp.html\",1,5]]}",
+			moduleIndex.ToJson());
+	}
+}
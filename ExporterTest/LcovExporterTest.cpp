@@ -0,0 +1,51 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+
+#include "Exporter/LcovExporter.hpp"
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(LcovExporterTest, Export)
+	{
+		Plugin::CoverageData coverageData{L"", 0};
+		auto& module = coverageData.AddModule(L"Module");
+		auto& file = module.AddFile(L"File");
+
+		file.AddLine(1, true, 5);
+		file.AddLine(2, false);
+		file.AddLine(3, true);
+		coverageData.AddModule(L"Module2").AddFile(L"File2").AddLine(10, false);
+
+		CppCoverage::CoverageRateComputer coverageRateComputer{coverageData};
+		std::ostringstream ostr;
+		Exporter::LcovExporter().Export(coverageData, coverageRateComputer, ostr);
+
+		ASSERT_EQ("TN:\n"
+		          "SF:File\nDA:1,5\nDA:2,0\nDA:3,1\nLF:3\nLH:2\nend_of_record\n"
+		          "SF:File2\nDA:10,0\nLF:1\nLH:0\nend_of_record\n",
+		          ostr.str());
+	}
+}
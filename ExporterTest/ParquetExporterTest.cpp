@@ -0,0 +1,68 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+#include "Exporter/ParquetExporter.hpp"
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		size_t Count(const std::string& content, const std::string& value)
+		{
+			size_t count = 0;
+
+			for (auto pos = content.find(value); pos != std::string::npos; pos = content.find(value, pos + 1))
+				++count;
+			return count;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ParquetExporterTest, Export)
+	{
+		Plugin::CoverageData coverageData{L"", 0};
+		auto& module = coverageData.AddModule(L"Module");
+
+		module.AddFile(L"File").AddLine(1, true);
+		module.AddFile(L"File2").AddLine(2, false);
+		coverageData.AddModule(L"Module2").AddFile(L"File").AddLine(3, true);
+
+		std::ostringstream ostr;
+		Exporter::ParquetExporter("run").Export(coverageData, ostr);
+		const auto content = ostr.str();
+
+		ASSERT_EQ("PAR1", content.substr(0, 4));
+		ASSERT_EQ("PAR1", content.substr(content.size() - 4));
+		uint32_t metadataSize = 0;
+		for (size_t i = 0; i < sizeof(metadataSize); ++i)
+			metadataSize |= static_cast<uint32_t>(static_cast<unsigned char>(content[content.size() - 8 + i])) << (8 * i);
+		ASSERT_GT(content.size(), metadataSize + 12);
+
+		// The paths are written once in the dictionaries.
+		ASSERT_EQ(1u, Count(content, std::string{"\x04\0\0\0File", 8}));
+		ASSERT_EQ(1u, Count(content, std::string{"\x07\0\0\0Module2", 11}));
+		ASSERT_EQ(1u, Count(content, std::string{"\x03\0\0\0run", 7}));
+	}
+}
@@ -0,0 +1,76 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "Exporter/Html/PrecompiledTemplate.hpp"
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::unique_ptr<Exporter::PrecompiledTemplate> TryCreate(const std::string& content)
+		{
+			TestHelper::TemporaryPath path;
+			{
+				std::ofstream ofs(path.GetPath().string(), std::ios::binary);
+				ofs << content;
+			}
+
+			return Exporter::PrecompiledTemplate::TryCreate(path, { "TITLE", "CODE" });
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PrecompiledTemplateTest, Expand)
+	{
+		auto precompiledTemplate = TryCreate("<b>{{TITLE}}</b>{{CODE}}{{UNKNOWN}}<pre>{{CODE}}</pre>");
+		ASSERT_NE(nullptr, precompiledTemplate);
+
+		std::string output = "Page:";
+		precompiledTemplate->Expand({ "Title", "{{TITLE}}" }, output);
+		ASSERT_EQ("Page:<b>Title</b>{{TITLE}}<pre>{{TITLE}}</pre>", output);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PrecompiledTemplateTest, NoVariable)
+	{
+		auto precompiledTemplate = TryCreate("<html>{ {}</html>");
+		ASSERT_NE(nullptr, precompiledTemplate);
+
+		std::string output;
+		precompiledTemplate->Expand({ "Title", "Code" }, output);
+		ASSERT_EQ("<html>{ {}</html>", output);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(PrecompiledTemplateTest, NotOnlyVariables)
+	{
+		ASSERT_EQ(nullptr, TryCreate("{{#ITEMS}}{{TITLE}}{{/ITEMS}}"));
+		ASSERT_EQ(nullptr, TryCreate("{{! Comment}}"));
+		ASSERT_EQ(nullptr, TryCreate("{{TITLE:h}}"));
+		ASSERT_EQ(nullptr, TryCreate("{{TITLE"));
+		ASSERT_EQ(nullptr, Exporter::PrecompiledTemplate::TryCreate("MissingTemplate", { "TITLE" }));
+	}
+}
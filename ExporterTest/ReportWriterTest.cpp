@@ -0,0 +1,158 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <fstream>
+#include <filesystem>
+#include <iterator>
+#include <vector>
+
+#include "Exporter/ReportWriter.hpp"
+
+#include "TestHelper/TemporaryPath.hpp"
+
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+namespace cov = CppCoverage;
+
+namespace ExporterTest
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string ReadContent(const fs::path& path)
+		{
+			std::ifstream ifs{ path, std::ios::binary };
+
+			return std::string{ std::istreambuf_iterator<char>{ifs}, std::istreambuf_iterator<char>{} };
+		}
+
+		//---------------------------------------------------------------------
+		fs::path AddExtension(fs::path path, const std::wstring& extension)
+		{
+			path += extension;
+			return path;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, None)
+	{
+		TestHelper::TemporaryPath root{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Exporter::ReportWriter reportWriter{ root, cov::ReportCompression::None };
+
+		reportWriter.WriteFile(root.GetPath() / "index.html", "content");
+		ASSERT_EQ(root.GetPath(), reportWriter.Close());
+		ASSERT_EQ("content", ReadContent(root.GetPath() / "index.html"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, Zip)
+	{
+		TestHelper::TemporaryPath root;
+		auto zipPath = AddExtension(root, Exporter::ReportWriter::ZipExtension);
+		{
+			Exporter::ReportWriter reportWriter{ root, cov::ReportCompression::Zip };
+
+			reportWriter.WriteFile(root.GetPath() / "index.html", std::string(1000, 'a'));
+			reportWriter.WriteFile(root.GetPath() / "Modules" / "Module.html", "b");
+			ASSERT_EQ(zipPath, reportWriter.Close());
+		}
+		ASSERT_FALSE(fs::exists(root.GetPath()));
+
+		auto zip = ReadContent(zipPath);
+		ASSERT_EQ(0u, zip.find("PK\x03\x04"));
+		ASSERT_NE(std::string::npos, zip.find("Modules/Module.html"));
+		ASSERT_NE(std::string::npos, zip.find("PK\x05\x06"));
+		fs::remove(zipPath);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, DeterministicZip)
+	{
+		std::vector<std::string> zips;
+
+		for (const auto& filenames : { std::vector<std::string>{ "a.html", "b.html" }, { "b.html", "a.html" } })
+		{
+			TestHelper::TemporaryPath root;
+			auto zipPath = AddExtension(root, Exporter::ReportWriter::ZipExtension);
+			{
+				Exporter::ReportWriter reportWriter{ root, cov::ReportCompression::Zip, true };
+
+				for (const auto& filename : filenames)
+					reportWriter.WriteFile(root.GetPath() / filename, filename);
+				reportWriter.Close();
+			}
+			zips.push_back(ReadContent(zipPath));
+			fs::remove(zipPath);
+		}
+		ASSERT_EQ(zips.at(0), zips.at(1));
+		ASSERT_LT(zips.at(0).find("a.html"), zips.at(0).find("b.html"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, NotClosedZip)
+	{
+		TestHelper::TemporaryPath root;
+		auto zipPath = AddExtension(root, Exporter::ReportWriter::ZipExtension);
+		{
+			Exporter::ReportWriter reportWriter{ root, cov::ReportCompression::Zip };
+			reportWriter.WriteFile(root.GetPath() / "index.html", "content");
+		}
+		ASSERT_FALSE(fs::exists(zipPath));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, Gzip)
+	{
+		TestHelper::TemporaryPath root{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Exporter::ReportWriter reportWriter{ root, cov::ReportCompression::Gzip };
+
+		reportWriter.WriteFile(root.GetPath() / "index.html", "content");
+		reportWriter.Close();
+
+		auto page = ReadContent(root.GetPath() / "index.html.gz");
+		ASSERT_EQ(Exporter::ReportWriter::Gzip("content"), page);
+		ASSERT_EQ(0u, page.find("\x1F\x8B"));
+		ASSERT_EQ("OpenCppCoverage gzip manifest 1\n7 index.html\n",
+			ReadContent(root.GetPath() / Exporter::ReportWriter::GzipManifestFilename));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, Gunzip)
+	{
+		ASSERT_EQ("content", Exporter::ReportWriter::Gunzip(Exporter::ReportWriter::Gzip("content")));
+		ASSERT_ANY_THROW(Exporter::ReportWriter::Gunzip("content"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ReportWriterTest, CompressFile)
+	{
+		TestHelper::TemporaryPath path;
+		{
+			std::ofstream ofs{ path.GetPath() };
+			ofs << "content";
+		}
+		auto output = Exporter::ReportWriter::CompressFile(path, cov::ReportCompression::Gzip);
+
+		ASSERT_EQ(AddExtension(path, Exporter::ReportWriter::GzipExtension), output);
+		ASSERT_FALSE(fs::exists(path.GetPath()));
+		ASSERT_EQ(Exporter::ReportWriter::Gzip("content"), ReadContent(output));
+		fs::remove(output);
+	}
+}
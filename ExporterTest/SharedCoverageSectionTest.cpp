@@ -0,0 +1,61 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+#include "Plugin/Exporter/LineCoverage.hpp"
+#include "Exporter/Plugin/SharedCoverageSection.hpp"
+#include "Exporter/ExporterException.hpp"
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(SharedCoverageSectionTest, Read)
+	{
+		Plugin::CoverageData coverageData{ L"name", 42 };
+		auto& file = coverageData.AddModule(L"module").AddFile(L"file");
+
+		file.AddLine(1, true);
+		file.AddLine(200, false);
+		coverageData.AddModule(L"module2").AddFile(L"file").AddLine(3, false);
+
+		auto section = Exporter::SharedCoverageSection::Create(coverageData);
+		auto readOnlySection = Exporter::SharedCoverageSection::Open(section->GetName());
+		ASSERT_EQ(section->GetContent(), readOnlySection->GetContent());
+
+		auto readCoverageData = readOnlySection->Read();
+		ASSERT_EQ(L"name", readCoverageData.GetName());
+		ASSERT_EQ(42, readCoverageData.GetExitCode());
+
+		const auto& modules = readCoverageData.GetModules();
+		ASSERT_EQ(2, modules.size());
+		ASSERT_EQ(L"module2", modules[1]->GetPath());
+		const auto& lines = modules[0]->GetFiles().at(0)->GetLines();
+		ASSERT_EQ(2, lines.size());
+		ASSERT_EQ(200, lines[1].GetLineNumber());
+		ASSERT_FALSE(lines[1].HasBeenExecuted());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SharedCoverageSectionTest, OpenMissingSection)
+	{
+		ASSERT_THROW(Exporter::SharedCoverageSection::Open(L"Local\\OpenCppCoverage.Coverage.Missing"),
+		             Exporter::ExporterException);
+	}
+}
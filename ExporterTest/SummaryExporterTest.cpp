@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+
+#include "CppCoverage/CoverageSummary.hpp"
+#include "CppCoverage/CoverageRate.hpp"
+
+#include "Exporter/SummaryExporter.hpp"
+
+namespace cov = CppCoverage;
+
+namespace ExporterTest
+{
+	//-------------------------------------------------------------------------
+	TEST(SummaryExporterTest, Export)
+	{
+		cov::CoverageSummary coverageSummary{L"Name", 1};
+
+		coverageSummary.AddModule(L"Module1", cov::CoverageRate{1, 3});
+		coverageSummary.AddModule(L"Module2", cov::CoverageRate{0, 0});
+		coverageSummary.AddModule(L"Module3", cov::CoverageRate{2, 2});
+
+		std::ostringstream ostr;
+		Exporter::SummaryExporter().Export(coverageSummary, ostr);
+
+		ASSERT_EQ("{\"name\":\"Name\",\"exitCode\":1,"
+		          "\"linesCovered\":3,\"linesValid\":8,\"lineRate\":0.375,\"modules\":["
+		          "{\"path\":\"Module1\",\"linesCovered\":1,\"linesValid\":4,\"lineRate\":0.25},"
+		          "{\"path\":\"Module3\",\"linesCovered\":2,\"linesValid\":4,\"lineRate\":0.5}]}\n",
+		          ostr.str());
+	}
+}
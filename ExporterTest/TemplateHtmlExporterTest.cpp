@@ -97,7 +97,8 @@ namespace ExporterTest
 				TemplateHtmlExporter::TitleTemplate,
 				TemplateHtmlExporter::BodyOnLoadTemplate,
 				TemplateHtmlExporter::SourceWarningMessageTemplate,
-				TemplateHtmlExporter::CodeTemplate })
+				TemplateHtmlExporter::CodeTemplate,
+				TemplateHtmlExporter::ThirdPartyPathTemplate })
 			{
 				AddTag(ofs, tag);
 			}
@@ -204,4 +205,41 @@ namespace ExporterTest
 		ASSERT_EQ(L"", templateValues.at(TemplateHtmlExporter::BodyOnLoadTemplate));
 		ASSERT_NE(L"", templateValues.at(TemplateHtmlExporter::SourceWarningMessageTemplate));
 	}
-}
\ No newline at end of file
+
+	//-------------------------------------------------------------------------
+	TEST_F(TemplateHtmlExporterTest, ThirdPartyPath)
+	{
+		auto sourceTemplate = CreateSourceTemplate();
+		TemplateHtmlExporter exporter{ sourceTemplate, sourceTemplate };
+		auto outputFile = output_folder.GetPath() / "file";
+
+		exporter.GenerateSourceTemplate(L"Title", L"Content", true, outputFile);
+		ASSERT_EQ(L"../../third-party", ReadTemplate(outputFile).at(TemplateHtmlExporter::ThirdPartyPathTemplate));
+
+		exporter.SetThirdPartyPath("../Assets/third-party-0");
+		exporter.GenerateSourceTemplate(L"Title", L"Content", true, outputFile);
+		ASSERT_EQ(L"../../../Assets/third-party-0", ReadTemplate(outputFile).at(TemplateHtmlExporter::ThirdPartyPathTemplate));
+
+		exporter.SetThirdPartyPath("file:///C:/Assets/third-party-0");
+		exporter.GenerateSourceTemplate(L"Title", L"Content", true, outputFile);
+		ASSERT_EQ(L"file:///C:/Assets/third-party-0", ReadTemplate(outputFile).at(TemplateHtmlExporter::ThirdPartyPathTemplate));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(TemplateHtmlExporterTest, FileTemplateNotPrecompiled)
+	{
+		auto sourceTemplate = CreateSourceTemplate();
+		{
+			std::ofstream ofs(sourceTemplate.string(), std::ios::app);
+			ofs << "{{! Not precompiled}}" << std::endl;
+		}
+		TemplateHtmlExporter exporter{ sourceTemplate, sourceTemplate };
+		auto outputFile = output_folder.GetPath() / "file";
+
+		exporter.GenerateSourceTemplate(L"SourceTitle", L"SourceContent", true, outputFile);
+		auto templateValues = ReadTemplate(outputFile);
+
+		ASSERT_EQ(L"SourceTitle", templateValues.at(TemplateHtmlExporter::TitleTemplate));
+		ASSERT_EQ(L"SourceContent", templateValues.at(TemplateHtmlExporter::CodeTemplate));
+	}
+}
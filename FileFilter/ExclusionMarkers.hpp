@@ -0,0 +1,74 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+
+namespace FileFilter
+{
+	// Literal markers written in the source files to exclude lines from the coverage.
+	// An empty marker is not searched.
+	class ExclusionMarkers
+	{
+	public:
+		//---------------------------------------------------------------------
+		ExclusionMarkers() = default;
+
+		//---------------------------------------------------------------------
+		ExclusionMarkers(
+			std::string lineMarker,
+			std::string regionStartMarker,
+			std::string regionStopMarker)
+			: lineMarker_{ std::move(lineMarker) }
+			, regionStartMarker_{ std::move(regionStartMarker) }
+			, regionStopMarker_{ std::move(regionStopMarker) }
+		{
+		}
+
+		//---------------------------------------------------------------------
+		// Exclude the line which contains this marker.
+		const std::string& GetLineMarker() const
+		{
+			return lineMarker_;
+		}
+
+		//---------------------------------------------------------------------
+		// Exclude the lines from the one which contains the start marker to
+		// the one which contains the stop marker, both included.
+		const std::string& GetRegionStartMarker() const
+		{
+			return regionStartMarker_;
+		}
+
+		//---------------------------------------------------------------------
+		const std::string& GetRegionStopMarker() const
+		{
+			return regionStopMarker_;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsEmpty() const
+		{
+			return lineMarker_.empty() && regionStartMarker_.empty();
+		}
+
+	private:
+		std::string lineMarker_;
+		std::string regionStartMarker_;
+		std::string regionStopMarker_;
+	};
+}
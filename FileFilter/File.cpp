@@ -17,6 +17,8 @@
 #include "stdafx.h"
 #include "File.hpp"
 
+#include <algorithm>
+
 namespace FileFilter
 {
 	//----------------------------------------------------------------------------
@@ -31,6 +33,35 @@ namespace FileFilter
 		selectedLines_.insert(lines.begin(), lines.end());
 	}
 
+	//----------------------------------------------------------------------------
+	void File::AddHunk(Hunk&& hunk)
+	{
+		hunks_.push_back(std::move(hunk));
+	}
+
+	//----------------------------------------------------------------------------
+	boost::optional<int> File::GetNewLineNumber(int oldLineNumber) const
+	{
+		// The last hunk starting before the line.
+		auto it = std::upper_bound(hunks_.begin(), hunks_.end(), oldLineNumber,
+			[](int lineNumber, const Hunk& hunk) { return lineNumber < hunk.startFrom_; });
+		if (it == hunks_.begin())
+			return oldLineNumber;
+
+		const auto& hunk = *std::prev(it);
+		auto index = static_cast<size_t>(oldLineNumber - hunk.startFrom_);
+		if (index < hunk.newLineNumbers_.size())
+		{
+			auto newLineNumber = hunk.newLineNumbers_[index];
+			if (newLineNumber == 0)
+				return boost::none;
+			return newLineNumber;
+		}
+
+		auto endFrom = hunk.startFrom_ + static_cast<int>(hunk.newLineNumbers_.size());
+		return oldLineNumber + hunk.startTo_ + hunk.countTo_ - endFrom;
+	}
+
 	//----------------------------------------------------------------------------
 	const std::filesystem::path& File::GetPath() const
 	{
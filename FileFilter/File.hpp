@@ -18,7 +18,9 @@
 
 #include "FileFilterExport.hpp"
 #include <set>
+#include <vector>
 #include <filesystem>
+#include <boost/optional/optional.hpp>
 
 namespace FileFilter
 {
@@ -31,6 +33,23 @@ namespace FileFilter
 
 		void AddSelectedLines(const std::vector<int>&);
 
+		// The lines of a hunk of the diff, in the order of the diff.
+		struct Hunk
+		{
+			// First line of the hunk before and after the diff.
+			int startFrom_;
+			int startTo_;
+			int countTo_;
+			// The number after the diff of each line of the hunk before the
+			// diff, 0 for a removed line.
+			std::vector<int> newLineNumbers_;
+		};
+		void AddHunk(Hunk&&);
+
+		// The number of a line of the file before the diff once the diff is
+		// applied, boost::none for a removed line.
+		boost::optional<int> GetNewLineNumber(int oldLineNumber) const;
+
 		const std::filesystem::path& GetPath() const;
 		void SetPath(const std::filesystem::path&);
 
@@ -45,6 +64,7 @@ namespace FileFilter
 
 		std::filesystem::path path_;
 		std::set<int> selectedLines_;
+		std::vector<Hunk> hunks_;
 	};
 }
 
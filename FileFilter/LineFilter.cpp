@@ -17,20 +17,41 @@
 #include "stdafx.h"
 #include "LineFilter.hpp"
 
+#include <unordered_set>
+
 #include "FileFilter/FileInfo.hpp"
 #include "FileFilter/LineInfo.hpp"
 #include "Tools/Log.hpp"
 #include "Tools/Tool.hpp"
 #include "Tools/MappedFile.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/ThreadPool.hpp"
 
 namespace FileFilter
 {
+	namespace
+	{
+		const size_t MinFileCountByWorker = 16;
+
+		//---------------------------------------------------------------------
+		// std::string_view::find looks for the first character with memchr
+		// which is vectorized by the CRT.
+		bool Contains(std::string_view line, const std::string& marker, size_t pos = 0)
+		{
+			return !marker.empty() && line.find(marker, pos) != std::string_view::npos;
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	LineFilter::LineFilter(
 		const std::vector<std::wstring>& excludedLineRegexes,
-		bool enableLog)
+		bool enableLog,
+		const ExclusionMarkers& exclusionMarkers,
+		std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
 		: fileReadCount_{0}
 		, enableLog_{ enableLog }
+		, exclusionMarkers_{ exclusionMarkers }
+		, sourceFileCache_{ sourceFileCache ? sourceFileCache : std::make_shared<Tools::SourceFileCache>() }
 	{
 		for (const auto& regex : excludedLineRegexes)
 			excludedLineRegexes_.emplace_back(Tools::ToLocalString(regex));
@@ -52,28 +73,57 @@ namespace FileFilter
 		const std::filesystem::path& filePath, 
 		int lineNumber)
 	{
-		const auto* lines = GetLines(filePath);
+		const auto* selectedLines = GetSelectedLines(filePath);
 
-		if (!lines)
+		if (!selectedLines)
 			return true;
 	
-		if (lineNumber <= 0 || lineNumber > static_cast<int>(lines->size()))
+		if (lineNumber <= 0 || lineNumber > static_cast<int>(selectedLines->size()))
 		{
 			if (enableLog_)
 				LOG_DEBUG << filePath.wstring() << L" line " << lineNumber << L" does not exist, skipped";
 			return false;
 		}
 
-		const auto& line = (*lines)[lineNumber - 1];
-		return IsLineSelected(line);
+		return (*selectedLines)[lineNumber - 1];
+	}
+
+	//-------------------------------------------------------------------------
+	void LineFilter::SelectLines(const FileInfo& fileInfo, std::vector<bool>& selectedLines)
+	{
+		const auto* selectedFileLines = GetSelectedLines(fileInfo.filePath_);
+
+		if (!selectedFileLines)
+			return;
+
+		const auto& lineInfos = fileInfo.lineInfoColllection_;
+		const auto lineCount = static_cast<int>(selectedFileLines->size());
+		for (size_t i = 0; i < lineInfos.size(); ++i)
+		{
+			if (!selectedLines[i])
+				continue;
+
+			auto lineNumber = lineInfos[i].lineNumber_;
+			if (lineNumber <= 0 || lineNumber > lineCount)
+			{
+				if (enableLog_)
+				{
+					LOG_DEBUG << fileInfo.filePath_.wstring() << L" line " << lineNumber
+						<< L" does not exist, skipped";
+				}
+				selectedLines[i] = false;
+			}
+			else
+				selectedLines[i] = (*selectedFileLines)[lineNumber - 1];
+		}
 	}
 
 	//-------------------------------------------------------------------------
-	bool LineFilter::IsLineSelected(const std::string& line) const
+	bool LineFilter::IsLineSelected(std::string_view line) const
 	{
 		for (const auto& excludedRegex : excludedLineRegexes_)
 		{
-			if (std::regex_match(line, excludedRegex))
+			if (std::regex_match(line.data(), line.data() + line.size(), excludedRegex))
 				return false;
 		}
 
@@ -81,18 +131,87 @@ namespace FileFilter
 	}
 
 	//-------------------------------------------------------------------------
-	const std::vector<std::string>* LineFilter::GetLines(
+	const std::vector<bool>* LineFilter::GetSelectedLines(
 		const std::filesystem::path& path)
 	{
-		if (path != filePath_)
+		auto it = selectedLinesByFile_.find(path.wstring());
+
+		if (it == selectedLinesByFile_.end())
+		{
+			boost::optional<std::vector<bool>> selectedLines;
+
+			if (auto mappedFile = sourceFileCache_->TryGet(path))
+			{
+				++fileReadCount_;
+				selectedLines = FilterLines(mappedFile->GetLines());
+			}
+			it = selectedLinesByFile_.emplace(path.wstring(), std::move(selectedLines)).first;
+		}
+
+		return it->second.get_ptr();
+	}
+
+	//-------------------------------------------------------------------------
+	void LineFilter::Prefetch(const std::vector<std::wstring>& paths)
+	{
+		std::vector<std::wstring> pathsToRead;
+		std::unordered_set<std::wstring> uniquePaths;
+
+		for (const auto& path : paths)
+		{
+			if (selectedLinesByFile_.count(path) == 0 && uniquePaths.insert(path).second)
+				pathsToRead.push_back(path);
+		}
+
+		if (pathsToRead.size() / MinFileCountByWorker <= 1 ||
+		    Tools::ThreadPool::GetDefault().GetThreadCount() <= 1)
+			return; // GetSelectedLines reads them on demand.
+
+		// FilterLines only reads the regular expression and the markers.
+		std::vector<boost::optional<std::vector<bool>>> selectedLines(pathsToRead.size());
+		Tools::ParallelFor(pathsToRead.size(), MinFileCountByWorker, [&](size_t i) {
+			if (auto mappedFile = sourceFileCache_->TryGet(pathsToRead[i]))
+				selectedLines[i] = FilterLines(mappedFile->GetLines());
+		});
+
+		for (size_t i = 0; i < pathsToRead.size(); ++i)
 		{
-			mappedFileForFilePath_ = Tools::MappedFile::TryCreate(path);
-			if (mappedFileForFilePath_)
+			if (selectedLines[i])
 				++fileReadCount_;
-			filePath_ = path;
+			selectedLinesByFile_.emplace(std::move(pathsToRead[i]), std::move(selectedLines[i]));
 		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::vector<bool> LineFilter::FilterLines(const std::vector<std::string_view>& lines) const
+	{
+		std::vector<bool> selectedLines;
+		const auto& regionStartMarker = exclusionMarkers_.GetRegionStartMarker();
+		const auto& regionStopMarker = exclusionMarkers_.GetRegionStopMarker();
+		bool isInExcludedRegion = false;
+
+		selectedLines.reserve(lines.size());
+		for (const auto& line : lines)
+		{
+			bool isExcluded = isInExcludedRegion;
 
-		return mappedFileForFilePath_ ? &mappedFileForFilePath_->GetLines() : nullptr;
+			if (isInExcludedRegion)
+				isInExcludedRegion = !Contains(line, regionStopMarker);
+			else
+			{
+				auto startPos = regionStartMarker.empty() ? std::string_view::npos : line.find(regionStartMarker);
+
+				if (startPos != std::string_view::npos)
+				{
+					isExcluded = true;
+					isInExcludedRegion = !Contains(line, regionStopMarker, startPos + regionStartMarker.size());
+				}
+			}
+			isExcluded = isExcluded || Contains(line, exclusionMarkers_.GetLineMarker());
+			// The markers are much cheaper than the regular expressions.
+			selectedLines.push_back(!isExcluded && IsLineSelected(line));
+		}
+		return selectedLines;
 	}
 
 	//-------------------------------------------------------------------------
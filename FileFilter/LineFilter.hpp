@@ -17,14 +17,19 @@
 #pragma once
 
 #include "FileFilterExport.hpp"
+#include "ExclusionMarkers.hpp"
 #include <filesystem>
+#include <memory>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <regex>
+#include <unordered_map>
+#include <boost/optional.hpp>
 
 namespace Tools
 {
-	class MappedFile;
+	class SourceFileCache;
 }
 
 namespace FileFilter
@@ -35,13 +40,21 @@ namespace FileFilter
 	class FILEFILTER_DLL LineFilter
 	{
 	public:
+		// The source files are read from sourceFileCache, or from a cache
+		// owned by the filter when it is null.
 		explicit LineFilter(
 			const std::vector<std::wstring>& excludedLineRegexes,
-			bool enableLog = true);
+			bool enableLog = true,
+			const ExclusionMarkers& exclusionMarkers = {},
+			std::shared_ptr<Tools::SourceFileCache> sourceFileCache = nullptr);
 		~LineFilter();
 
 		bool IsLineSelected(const FileInfo&, const LineInfo&);
 		bool IsLineSelected(const std::filesystem::path&, int lineNumber);
+		// Unselect the lines of the file which are not selected.
+		void SelectLines(const FileInfo&, std::vector<bool>& selectedLines);
+		// Read and filter the files not read yet on several threads.
+		void Prefetch(const std::vector<std::wstring>& paths);
 		int GetFileReadCount() const;
 
 	private:
@@ -50,13 +63,19 @@ namespace FileFilter
 		LineFilter(LineFilter&&) = delete;
 		LineFilter& operator=(LineFilter&&) = delete;
 
-		const std::vector<std::string>* GetLines(const std::filesystem::path&);
-		bool IsLineSelected(const std::string& line) const;
+		const std::vector<bool>* GetSelectedLines(const std::filesystem::path&);
+		bool IsLineSelected(std::string_view line) const;
+		std::vector<bool> FilterLines(const std::vector<std::string_view>& lines) const;
 
+		// Compiled one by one: the back references and the groups of a regex
+		// do not depend on the other regexes.
 		std::vector<std::regex> excludedLineRegexes_;
-		std::filesystem::path filePath_;
-		std::unique_ptr<Tools::MappedFile> mappedFileForFilePath_;
+		// The same headers are used by most of the modules: each file is read
+		// and filtered once. The value is none when the file cannot be read.
+		std::unordered_map<std::wstring, boost::optional<std::vector<bool>>> selectedLinesByFile_;
 		int fileReadCount_;
 		const bool enableLog_;
+		const ExclusionMarkers exclusionMarkers_;
+		const std::shared_ptr<Tools::SourceFileCache> sourceFileCache_;
 	};
 }
@@ -22,11 +22,12 @@
 #include <boost/optional/optional.hpp>
 #include <boost/algorithm/string.hpp>
 
-#include <unordered_map>
 #include <map>
 
 #include "AmbiguousPathException.hpp"
 #include "File.hpp"
+#include "Tools/PrefixTrie.hpp"
+#include "Tools/Tool.hpp"
 
 namespace fs = std::filesystem;
 
@@ -37,7 +38,7 @@ namespace FileFilter
 		//---------------------------------------------------------------------
 		fs::path NormalizePath(const fs::path& path)
 		{
-			fs::path lowerPath = boost::algorithm::to_lower_copy(path.wstring());
+			fs::path lowerPath = Tools::ToLowerCopy(path.wstring());
 			lowerPath.make_preferred();
 
 			return lowerPath;
@@ -62,9 +63,10 @@ namespace FileFilter
 		{			
 			for (auto&& file : files)
 			{
-				auto path = NormalizePath(file.GetPath());
-				auto filename = path.filename().wstring();
-				postFixPathByFilename_[filename].emplace_back(std::move(file));
+				auto postFixPath = NormalizePath(file.GetPath()).wstring();
+
+				postFixPaths_.Add(postFixPath.rbegin(), postFixPath.rend(), pathDatas_.size());
+				pathDatas_.emplace_back(std::move(file), std::move(postFixPath));
 			}			
 		}
 
@@ -72,30 +74,30 @@ namespace FileFilter
 		File* Match(const fs::path& path) override
 		{		
 			const auto normalizedPath = NormalizePath(path);
-			const auto filenameStr = normalizedPath.filename().wstring();
-			auto it = postFixPathByFilename_.find(filenameStr);
-
-			if (it == postFixPathByFilename_.end())
+			const auto normalizedPathStr = normalizedPath.wstring();
+			// The first post fix path, in the order of the files, which ends
+			// normalizedPath at the start of a component: main.cpp does not
+			// match domain.cpp.
+			auto begin = normalizedPathStr.rbegin();
+			auto end = normalizedPathStr.rend();
+			auto index = postFixPaths_.FindSmallestPrefixValue(begin, end, [&](auto keyEnd) {
+				return keyEnd == begin || keyEnd == end ||
+				       *keyEnd == fs::path::preferred_separator ||
+				       *std::prev(keyEnd) == fs::path::preferred_separator;
+			});
+
+			if (!index)
 				return nullptr;
-						
-			for (auto& pathData : it->second)
+
+			auto& pathData = pathDatas_[*index];
+			if (pathData.matchedPath_ && 
+				!boost::algorithm::equals(pathData.matchedPath_->wstring(), normalizedPathStr))
 			{
-				auto postFixPath = NormalizePath(pathData.postFixPath_.GetPath());
-
-				if (boost::algorithm::ends_with(normalizedPath.wstring(), postFixPath.wstring()))
-				{
-					if (pathData.matchedPath_ && 
-						!boost::algorithm::equals(pathData.matchedPath_->wstring(), normalizedPath.wstring()))
-					{
-						throw AmbiguousPathException(postFixPath,
-							*pathData.matchedPath_, normalizedPath);
-					}
-					pathData.matchedPath_ = normalizedPath;
-					return &pathData.postFixPath_;
-				}
+				throw AmbiguousPathException(pathData.normalizedPostFixPath_,
+					*pathData.matchedPath_, normalizedPath);
 			}
-
-			return nullptr;
+			pathData.matchedPath_ = normalizedPath;
+			return &pathData.postFixPath_;
 		}
 
 		//-----------------------------------------------------------------
@@ -103,14 +105,10 @@ namespace FileFilter
 		{
 			PathCollection paths;
 
-			for (const auto& pair : postFixPathByFilename_)
+			for (const auto& pathData : pathDatas_)
 			{
-				const auto& postFixPathCollection = pair.second;
-				for (const auto& pathData : postFixPathCollection)
-				{
-					if (!pathData.matchedPath_)
-						paths.push_back(pathData.postFixPath_.GetPath());
-				}
+				if (!pathData.matchedPath_)
+					paths.push_back(pathData.postFixPath_.GetPath());
 			}
 
 			return paths;
@@ -119,14 +117,21 @@ namespace FileFilter
 	private:
 		struct PathData
 		{
-			explicit PathData(File&& postFixPath) : postFixPath_{ std::move(postFixPath) } {}
+			PathData(File&& postFixPath, std::wstring&& normalizedPostFixPath)
+				: postFixPath_{ std::move(postFixPath) }
+				, normalizedPostFixPath_{ std::move(normalizedPostFixPath) }
+			{
+			}
 			PathData(PathData&& pathData) = default;
 			
 			File postFixPath_;
+			fs::path normalizedPostFixPath_;
 			boost::optional<fs::path> matchedPath_;
 		};
 		
-		std::unordered_map<std::wstring, std::vector<PathData>> postFixPathByFilename_;
+		// The normalized post fix paths are added reversed.
+		Tools::PrefixTrie postFixPaths_;
+		std::vector<PathData> pathDatas_;
 	};
 
 	//---------------------------------------------------------------------
@@ -17,6 +17,7 @@
 #include "stdafx.h"
 #include "RelocationsExtractor.hpp"
 #include <memory>
+#include <boost/optional.hpp>
 #include "FileFilterException.hpp"
 #include "Tools/ProcessMemory.hpp"
 #include "Tools/PEFileHeader.hpp"
@@ -26,42 +27,54 @@ namespace FileFilter
 	namespace
 	{
 		//-------------------------------------------------------------------------
-		DWORD64 ExtractRelocations(
+		// Each block covers one page: the pointed values of the whole block are
+		// read with a single ReadProcessMemory.
+		void ExtractRelocations(
 			HANDLE hProcess,
 			DWORD64 baseOfImage,
-			DWORD64 imageBaseRelocationPtr,
+			const IMAGE_BASE_RELOCATION& imageBaseRelocation,
+			const WORD* relocationPtrs,
+			size_t count,
 			int sizeOfPointer,
 			std::unordered_set<DWORD64>& relocations)
 		{
-			auto imageBaseRelocation = Tools::ReadStructInProcessMemory<IMAGE_BASE_RELOCATION>(
-				hProcess, imageBaseRelocationPtr);
-			auto sizeOfBlock = imageBaseRelocation->SizeOfBlock;
-			auto count = (sizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(WORD);
+			boost::optional<WORD> maxRva;
 
-			std::vector<WORD> relocationPtrs(count);
+			for (size_t i = 0; i < count; ++i)
+			{
+				auto relocationType = (relocationPtrs[i] & 0xf000) >> 12;
+
+				if (relocationType == IMAGE_REL_BASED_HIGHLOW || relocationType == IMAGE_REL_BASED_DIR64)
+				{
+					auto rva = static_cast<WORD>(relocationPtrs[i] & 0x0fff);
+					maxRva = maxRva ? (std::max)(*maxRva, rva) : rva;
+				}
+			}
+			if (!maxRva)
+				return;
+
+			// Read up to the end of the last value, which can be on the next page.
+			std::vector<BYTE> values(*maxRva + sizeOfPointer);
 			Tools::ReadProcessMemory(
 				hProcess,
-				imageBaseRelocationPtr + sizeof(IMAGE_BASE_RELOCATION),
-				&relocationPtrs[0],
-				relocationPtrs.size() * sizeof(WORD));
+				baseOfImage + imageBaseRelocation.VirtualAddress,
+				values.data(),
+				values.size());
 
-			for (auto relocationPtr : relocationPtrs)
+			for (size_t i = 0; i < count; ++i)
 			{
-				auto relocationType = (relocationPtr & 0xf000) >> 12;
+				auto relocationType = (relocationPtrs[i] & 0xf000) >> 12;
 
 				if (relocationType == IMAGE_REL_BASED_HIGHLOW || relocationType == IMAGE_REL_BASED_DIR64)
 				{
-					auto rva = relocationPtr & 0x0fff;
-					auto relocationAddress = imageBaseRelocation->VirtualAddress + rva + baseOfImage;
+					auto rva = relocationPtrs[i] & 0x0fff;
 					DWORD_PTR relocationValue = 0;
-					Tools::ReadProcessMemory(hProcess, relocationAddress, &relocationValue, sizeOfPointer);
+					memcpy(&relocationValue, &values[rva], sizeOfPointer);
 
 					auto relocation = relocationValue - baseOfImage;
 					relocations.insert(relocation);
 				}
 			}
-
-			return sizeOfBlock;
 		}
 
 		//-------------------------------------------------------------------------
@@ -108,7 +121,7 @@ namespace FileFilter
 				FillRelocations(
 				    hProcess,
 				    baseOfImage,
-				    GetRelocationsDirectory(ntHeader, sizeof(DWORD_PTR)));
+				    GetRelocationsDirectory(ntHeader, sizeof(ULONGLONG)));
 			}
 
 			//-----------------------------------------------------------------
@@ -118,19 +131,39 @@ namespace FileFilter
 			    std::unique_ptr<RelocationsDirectoryInfo> relocationsInfo)
 			{
 				const auto& directory = relocationsInfo->directory;
-				auto imageBaseRelocationPtr =
-				    baseOfImage + directory.VirtualAddress;
-				auto endBaseRelocationPtr =
-				    imageBaseRelocationPtr + directory.Size;
-
-				while (imageBaseRelocationPtr < endBaseRelocationPtr)
+				if (!directory.Size)
+					return;
+
+				// The whole directory is read at once instead of block by block.
+				std::vector<BYTE> blocks(directory.Size);
+				Tools::ReadProcessMemory(hProcess,
+				                         baseOfImage + directory.VirtualAddress,
+				                         blocks.data(),
+				                         blocks.size());
+
+				size_t offset = 0;
+				while (offset + sizeof(IMAGE_BASE_RELOCATION) <= blocks.size())
 				{
-					imageBaseRelocationPtr +=
-					    ExtractRelocations(hProcess,
-					                       baseOfImage,
-					                       imageBaseRelocationPtr,
-					                       relocationsInfo->sizeOfPointer,
-					                       relocations_);
+					IMAGE_BASE_RELOCATION imageBaseRelocation;
+					memcpy(&imageBaseRelocation, &blocks[offset], sizeof(imageBaseRelocation));
+
+					auto sizeOfBlock = imageBaseRelocation.SizeOfBlock;
+					if (sizeOfBlock < sizeof(IMAGE_BASE_RELOCATION) ||
+					    offset + sizeOfBlock > blocks.size())
+					{
+						THROW(L"Invalid relocation block.");
+					}
+
+					auto count = (sizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(WORD);
+					ExtractRelocations(hProcess,
+					                   baseOfImage,
+					                   imageBaseRelocation,
+					                   reinterpret_cast<const WORD*>(
+					                       &blocks[offset + sizeof(IMAGE_BASE_RELOCATION)]),
+					                   count,
+					                   relocationsInfo->sizeOfPointer,
+					                   relocations_);
+					offset += sizeOfBlock;
 				}
 			}
 
@@ -82,6 +82,30 @@ namespace FileFilter
 		return file->IsLineSelected(lineNumber);
 	}
 
+	//-------------------------------------------------------------------------
+	const std::set<int>* UnifiedDiffCoverageFilter::GetSelectedLines(const std::filesystem::path& path)
+	{
+		auto file = SearchFile(path);
+
+		if (!file)
+			return nullptr;
+
+		return &file->GetSelectedLines();
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<int> UnifiedDiffCoverageFilter::GetNewLineNumber(
+		const std::filesystem::path& path,
+		int oldLineNumber)
+	{
+		auto file = SearchFile(path);
+
+		if (!file)
+			return oldLineNumber;
+
+		return file->GetNewLineNumber(oldLineNumber);
+	}
+
 	//-------------------------------------------------------------------------
 	File* UnifiedDiffCoverageFilter::SearchFile(const std::filesystem::path& path)
 	{
@@ -18,6 +18,7 @@
 
 #include "FileFilterExport.hpp"
 
+#include <set>
 #include <vector>
 
 #include <boost/optional/optional_fwd.hpp>
@@ -41,6 +42,12 @@ namespace FileFilter
 
 		bool IsSourceFileSelected(const std::filesystem::path&);
 		bool IsLineSelected(const std::filesystem::path&, int lineNumber);
+		// nullptr when the file is not in the unified diff.
+		const std::set<int>* GetSelectedLines(const std::filesystem::path&);
+		// The number of a line before the diff once the diff is applied,
+		// boost::none for a removed line. The lines of a file which is not
+		// in the unified diff are unchanged.
+		boost::optional<int> GetNewLineNumber(const std::filesystem::path&, int oldLineNumber);
 		std::vector<std::filesystem::path> GetUnmatchedPaths() const;
 
 	private:
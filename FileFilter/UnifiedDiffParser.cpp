@@ -34,6 +34,16 @@ namespace FileFilter
 		const std::wstring GitTargetPrefix = L"b/";
 		const std::wstring DevNull = L"/dev/null";
 
+		//-----------------------------------------------------------------------
+		// Compiled once: a large diff has a hunk every few lines.
+		const std::wregex& GetHunkRegex()
+		{
+			static const std::wstring range = L"(\\d+)(?:,(\\d+))?";
+			static const std::wregex hunkRegex{ L"^@@\\s*-" + range + L"\\s*\\+" + range + L"\\s*@@" };
+
+			return hunkRegex;
+		}
+
 		//-----------------------------------------------------------------------
 		bool IsGitDetected(
 			const std::vector<File>& files,
@@ -174,8 +184,7 @@ namespace FileFilter
 	{
 		if (files.empty())
 			ThrowError(stream, UnifiedDiffParserException::ErrorNoFilenameBeforeHunks);
-		auto updatedLines = ExtractUpdatedLines(stream, line);
-		files.back().AddSelectedLines(updatedLines);
+		ExtractUpdatedLines(stream, line, files.back());
 	}
 
 	//---------------------------------------------------------------------
@@ -202,11 +211,9 @@ namespace FileFilter
 			const Stream& stream, 
 			const std::wstring& hunksDifferencesLine) const
 	{
-		std::wstring range = L"(\\d+)(?:,(\\d+))?";
-		std::wregex hunkRegex{ L"^@@\\s*-" + range + L"\\s*\\+" + range + L"\\s*@@" };
 		std::wcmatch match;
 
-		if (std::regex_search(hunksDifferencesLine.c_str(), match, hunkRegex))
+		if (std::regex_search(hunksDifferencesLine.c_str(), match, GetHunkRegex()))
 		{
 			if (match.size() == 5 && match[1].matched && match[3].matched)
 			{
@@ -225,30 +232,49 @@ namespace FileFilter
 	}
 	
 	//-------------------------------------------------------------------------
-	std::vector<int> UnifiedDiffParser::ExtractUpdatedLines(		
+	// The hunk also maps the lines before the diff to the lines after it.
+	void UnifiedDiffParser::ExtractUpdatedLines(
 		Stream& stream,
-		const std::wstring& hunksDifferencesLine) const
+		const std::wstring& hunksDifferencesLine,
+		File& file) const
 	{
 		HunksDifferences hunksDifferences = ExtractHunksDifferences(stream, hunksDifferencesLine);
 
+		// An empty range starts after its line number.
+		auto getStart = [](int start, int count) { return count == 0 ? start + 1 : start; };
+		File::Hunk hunk{ getStart(hunksDifferences.startFrom, hunksDifferences.countFrom),
+			getStart(hunksDifferences.startTo, hunksDifferences.countTo),
+			hunksDifferences.countTo, {} };
+
 		std::wstring lineStr;
-		int currentLine = hunksDifferences.startTo;
-		const int endLine = hunksDifferences.startTo + hunksDifferences.countTo;
+		int currentLine = hunk.startTo_;
+		const int endLine = hunk.startTo_ + hunksDifferences.countTo;
+		int oldLineCount = 0;
 		std::vector<int> updatedLines;
-		while (currentLine < endLine && stream.GetLine(lineStr))
+		while ((currentLine < endLine || oldLineCount < hunksDifferences.countFrom) && stream.GetLine(lineStr))
 		{
-			if (!boost::algorithm::starts_with(lineStr, "-") &&
-				!boost::algorithm::starts_with(lineStr, "\\")) // For: \ No newline at end of file
+			if (boost::algorithm::starts_with(lineStr, "-"))
+			{
+				hunk.newLineNumbers_.push_back(0);
+				++oldLineCount;
+			}
+			else if (!boost::algorithm::starts_with(lineStr, "\\")) // For: \ No newline at end of file
 			{
 				if (boost::algorithm::starts_with(lineStr, "+"))
 					updatedLines.push_back(currentLine);
+				else
+				{
+					hunk.newLineNumbers_.push_back(currentLine);
+					++oldLineCount;
+				}
 				++currentLine;
 			}
 		}
 
-		if (currentLine != endLine)
+		if (currentLine != endLine || oldLineCount != hunksDifferences.countFrom)
 			ThrowError(stream, UnifiedDiffParserException::ErrorContextHunks);
-		return updatedLines;
+		file.AddSelectedLines(updatedLines);
+		file.AddHunk(std::move(hunk));
 	}
 	
 	//-------------------------------------------------------------------------
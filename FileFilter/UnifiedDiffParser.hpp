@@ -47,9 +47,10 @@ namespace FileFilter
 							const Stream&, 
 							const std::wstring& hunksDifferencesLine) const;
 
-		std::vector<int> ExtractUpdatedLines(
+		void ExtractUpdatedLines(
 							Stream&, 
-							const std::wstring& hunksDifferencesLine) const;
+							const std::wstring& hunksDifferencesLine,
+							File&) const;
 
 		void ThrowError(const Stream&, const std::wstring&) const;
 
@@ -17,6 +17,7 @@
 #include "stdafx.h"
 
 #include "FileFilter/LineFilter.hpp"
+#include "FileFilter/FileInfo.hpp"
 #include "TestHelper/TemporaryPath.hpp"
 
 using namespace FileFilter;
@@ -28,6 +29,20 @@ namespace FileFilterTest
 		const auto line1 = __LINE__;
 		const auto line2 = __LINE__;
 		const auto line21 = __LINE__;
+		const auto lineMarker = __LINE__; // LINE_FILTER_TEST_EXCL
+		const auto regionStart = __LINE__; // LINE_FILTER_TEST_START
+		const auto regionLine = __LINE__;
+		const auto regionStop = __LINE__; // LINE_FILTER_TEST_STOP
+		const auto afterRegion = __LINE__;
+		const auto doubledWord = __LINE__; // doubled doubled
+
+		//---------------------------------------------------------------------
+		// Built at runtime: the markers must appear only on the lines above.
+		ExclusionMarkers CreateExclusionMarkers()
+		{
+			const std::string prefix = "LINE_FILTER_TEST_";
+			return ExclusionMarkers{prefix + "EXCL", prefix + "START", prefix + "STOP"};
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -51,6 +66,17 @@ namespace FileFilterTest
 		ASSERT_FALSE(filter.IsLineSelected(__FILE__, line21));
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(LineFilterTest, SeveralRegexWithBackReference)
+	{
+		// \1 is the group of the second regex, not the one of the first.
+		LineFilter filter{ { L".*(line1) =.*", L".*\\b(\\w+) \\1\\b.*" } };
+
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, line1));
+		ASSERT_TRUE(filter.IsLineSelected(__FILE__, line2));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, doubledWord));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(LineFilterTest, FileNotFound)
 	{
@@ -95,6 +121,66 @@ namespace FileFilterTest
 		ASSERT_TRUE(filter.IsLineSelected(path.GetPath(), line1));
 
 		ASSERT_FALSE(filter.IsLineSelected(__FILE__, line1));
-		ASSERT_EQ(2, filter.GetFileReadCount());
+		ASSERT_EQ(1, filter.GetFileReadCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LineFilterTest, ExclusionMarkers)
+	{
+		LineFilter filter{ {}, true, CreateExclusionMarkers() };
+
+		ASSERT_TRUE(filter.IsLineSelected(__FILE__, line21));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, lineMarker));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, regionStart));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, regionLine));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, regionStop));
+		ASSERT_TRUE(filter.IsLineSelected(__FILE__, afterRegion));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LineFilterTest, ExclusionMarkersAndRegex)
+	{
+		LineFilter filter{ { L".*line1.*" }, true, CreateExclusionMarkers() };
+
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, line1));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, lineMarker));
+		ASSERT_TRUE(filter.IsLineSelected(__FILE__, line2));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LineFilterTest, SelectLines)
+	{
+		bool enableLog = false;
+		LineFilter filter{ { L".*line1.*" }, enableLog };
+		std::vector<LineInfo> lineInfos;
+		for (auto lineNumber : { line1, line2, line21, 1000 * 1000 })
+			lineInfos.emplace_back(lineNumber, 0, 0);
+		FileInfo fileInfo{ __FILE__, std::move(lineInfos) };
+
+		std::vector<bool> selectedLines{ true, false, true, true };
+		filter.SelectLines(fileInfo, selectedLines);
+		ASSERT_EQ((std::vector<bool>{ false, false, true, false }), selectedLines);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(LineFilterTest, Prefetch)
+	{
+		LineFilter filter{ { L".*li.*2 =.*" } };
+		std::vector<std::unique_ptr<TestHelper::TemporaryPath>> emptyFiles;
+		std::vector<std::wstring> paths{ std::filesystem::path{ __FILE__ }.wstring() };
+
+		for (int i = 0; i < 100; ++i)
+		{
+			emptyFiles.push_back(std::make_unique<TestHelper::TemporaryPath>(
+				TestHelper::TemporaryPathOption::CreateAsFile));
+			paths.push_back(emptyFiles.back()->GetPath().wstring());
+		}
+		filter.Prefetch(paths);
+
+		ASSERT_TRUE(filter.IsLineSelected(__FILE__, line1));
+		ASSERT_FALSE(filter.IsLineSelected(__FILE__, line2));
+		for (const auto& emptyFile : emptyFiles)
+			ASSERT_TRUE(filter.IsLineSelected(emptyFile->GetPath(), line1));
+		ASSERT_EQ(1, filter.GetFileReadCount());
 	}
-}
\ No newline at end of file
+}
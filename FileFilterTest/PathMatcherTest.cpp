@@ -68,6 +68,19 @@ namespace FileFilterTest
 		ASSERT_EQ(0, pathMatcher.GetUnmatchedPaths().size());
 	}	
 
+	//-------------------------------------------------------------------------
+	TEST(PathMatcherTest, PostFixComponentMatch)
+	{
+		std::vector<std::wstring> filenames = { L"main.cpp", L"\\Test.txt" };
+		auto files = ToFiles(filenames);
+		PathMatcher pathMatcher{std::move(files), boost::none };
+
+		ASSERT_EQ(nullptr, pathMatcher.Match("domain.cpp"));
+		ASSERT_EQ(nullptr, pathMatcher.Match("src\\domain.cpp"));
+		ASSERT_EQ(filenames.at(0), Match(pathMatcher, "src\\main.cpp"));
+		ASSERT_EQ(filenames.at(1), Match(pathMatcher, "src\\Test.txt"));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(PathMatcherTest, PostFixAmgigousPath)
 	{
@@ -57,6 +57,20 @@ namespace FileFilterTest
 		ASSERT_FALSE(filter.IsLineSelected("Unknow", line));
 	}
 
+	//-------------------------------------------------------------------------
+	TEST(UnifiedDiffCoverageFilterTest, GetSelectedLines)
+	{
+		auto files = ToFiles(fileNames_);
+		const auto line = 42;
+
+		files.at(0).AddSelectedLines({ line });
+		UnifiedDiffCoverageFilter filter{std::move(files), boost::none };
+
+		ASSERT_EQ(std::set<int>{ line }, *filter.GetSelectedLines(fileNames_.at(0)));
+		ASSERT_TRUE(filter.GetSelectedLines(fileNames_.at(1))->empty());
+		ASSERT_EQ(nullptr, filter.GetSelectedLines("Unknow"));
+	}
+
 	//-------------------------------------------------------------------------
 	TEST(UnifiedDiffCoverageFilterTest, AmbiguousPathException)
 	{
@@ -256,4 +256,40 @@ namespace FileFilterTest
 		auto files = unifiedDiffParser_.Parse(istr);
 		AssertSingleFile(files, L"test1.txt", {});
 	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(UnifiedDiffParserTest, NewLineNumbers)
+	{
+		std::wistringstream istr{
+			L"--- a/test\n"
+			L"+++ b/test\n"
+			L"@@ -3,4 +3,6 @@\n"
+			L" line3\n"
+			L"-line4\n"
+			L"+line4\n"
+			L"+line5\n"
+			L" line5\n"
+			L"+line7\n"
+			L" line6\n"
+			L"@@ -10,2 +11,0 @@\n"
+			L"-line10\n"
+			L"-line11\n"
+			L"@@ -20,0 +21,2 @@\n"
+			L"+line21\n"
+			L"+line22\n" };
+		auto files = unifiedDiffParser_.Parse(istr);
+		ASSERT_EQ(1, files.size());
+		const auto& file = files.at(0);
+
+		ASSERT_EQ(1, file.GetNewLineNumber(1));
+		ASSERT_EQ(3, file.GetNewLineNumber(3));
+		ASSERT_FALSE(file.GetNewLineNumber(4));
+		ASSERT_EQ(6, file.GetNewLineNumber(5));
+		ASSERT_EQ(8, file.GetNewLineNumber(6));
+		ASSERT_EQ(9, file.GetNewLineNumber(7));
+		ASSERT_FALSE(file.GetNewLineNumber(10));
+		ASSERT_FALSE(file.GetNewLineNumber(11));
+		ASSERT_EQ(12, file.GetNewLineNumber(12));
+		ASSERT_EQ(23, file.GetNewLineNumber(21));
+	}
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageAggregator.hpp"
+
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <optional>
+#include <Windows.h>
+
+#include "CppCoverage/CppCoverageException.hpp"
+#include "CppCoverage/CoverageDataMerger.hpp"
+#include "Exporter/Binary/AggregatorExporter.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/SecurityAttributes.hpp"
+#include "Tools/Tool.hpp"
+
+namespace OpenCppCoverage
+{
+	namespace
+	{
+		const DWORD BufferSize = 64 * 1024;
+		// Far larger than the coverage of a run: a bigger size is not a coverage.
+		const uint64_t MaxContentSize = 2ull * 1024 * 1024 * 1024;
+
+		//---------------------------------------------------------------------
+		void Read(HANDLE hPipe, char* data, size_t size)
+		{
+			while (size)
+			{
+				DWORD readSize = 0;
+				auto sizeToRead = static_cast<DWORD>((std::min)(size, static_cast<size_t>(BufferSize)));
+
+				if (!ReadFile(hPipe, data, sizeToRead, &readSize, nullptr) || !readSize)
+					THROW_LAST_ERROR(L"Cannot read the coverage: ", GetLastError());
+				data += readSize;
+				size -= readSize;
+			}
+		}
+
+		//---------------------------------------------------------------------
+		std::string ReceiveContent(HANDLE hPipe)
+		{
+			uint64_t size = 0;
+			Read(hPipe, reinterpret_cast<char*>(&size), sizeof(size));
+			if (size > MaxContentSize || size > (std::numeric_limits<size_t>::max)())
+				THROW(L"Invalid coverage size: " << size);
+
+			std::string content(static_cast<size_t>(size), '\0');
+			Read(hPipe, &content[0], content.size());
+
+			DWORD writtenSize = 0;
+			const auto& acknowledgment = Exporter::AggregatorExporter::Acknowledgment;
+			if (!WriteFile(hPipe, &acknowledgment, sizeof(acknowledgment), &writtenSize, nullptr))
+				THROW_LAST_ERROR(L"Cannot acknowledge the coverage: ", GetLastError());
+			FlushFileBuffers(hPipe);
+			return content;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	Plugin::CoverageData AggregateCoverages(const std::string& name, size_t runCount)
+	{
+		auto pipePath = L"\\\\.\\pipe\\" + Tools::LocalToWString(name);
+		// Only the runs of the current user can send their coverage.
+		auto securityAttributes = Tools::SecurityAttributes::CreateForCurrentUser();
+		// A single instance reused for all the clients: the others wait while
+		// it is busy.
+		auto hPipe = CreateNamedPipeW(
+		    pipePath.c_str(),
+		    PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE,
+		    PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+		    1, BufferSize, BufferSize, 0, securityAttributes.Get());
+
+		if (hPipe == INVALID_HANDLE_VALUE)
+			THROW_LAST_ERROR(L"Cannot create the named pipe " << pipePath << L": ", GetLastError());
+		Tools::ScopedAction closePipe{[=]() { CloseHandle(hPipe); }};
+
+		LOG_INFO << L"Coverage aggregator started on " << pipePath << L" for "
+		         << runCount << L" runs.";
+		CppCoverage::CoverageDataMerger coverageDataMerger;
+		std::optional<Plugin::CoverageData> sum;
+		std::future<void> merge;
+		size_t receivedCount = 0;
+
+		while (receivedCount < runCount)
+		{
+			if (!ConnectNamedPipe(hPipe, nullptr) && GetLastError() != ERROR_PIPE_CONNECTED)
+				THROW_LAST_ERROR(L"Cannot connect the named pipe " << pipePath << L": ", GetLastError());
+
+			// A client which stops does not stop the aggregator.
+			std::string content;
+			try
+			{
+				content = ReceiveContent(hPipe);
+			}
+			catch (const std::exception& e)
+			{
+				LOG_ERROR << L"Cannot receive the coverage: " << e.what();
+			}
+			DisconnectNamedPipe(hPipe);
+			if (content.empty())
+				continue;
+
+			++receivedCount;
+			LOG_INFO << L"Coverage " << receivedCount << L"/" << runCount << L" received.";
+			if (merge.valid())
+				merge.get();
+			merge = std::async(std::launch::async, [&, content = std::move(content)]() {
+				try
+				{
+					auto coverageData = Exporter::AggregatorExporter::ReadContent(content);
+
+					if (!sum)
+						sum = std::move(coverageData);
+					else
+						coverageDataMerger.MergeInto(*sum, std::move(coverageData));
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR << L"Cannot merge the coverage: " << e.what();
+				}
+			});
+		}
+		if (merge.valid())
+			merge.get();
+
+		if (!sum)
+			return Plugin::CoverageData{Tools::LocalToWString(name), 0};
+		return std::move(*sum);
+	}
+}
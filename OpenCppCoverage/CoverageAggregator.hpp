@@ -0,0 +1,30 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <string>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+namespace OpenCppCoverage
+{
+	// Receive runCount coverages sent by Exporter::AggregatorExporter on the
+	// named pipe \\.\pipe\<name>, also from other machines. Each coverage is
+	// merged while the next one is received. A coverage which cannot be read
+	// is counted but not merged.
+	Plugin::CoverageData AggregateCoverages(const std::string& name, size_t runCount);
+}
@@ -0,0 +1,156 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageResultCache.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include "Exporter/Binary/CoverageDataDeserializer.hpp"
+#include "Exporter/Binary/CoverageDataSerializer.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Tools/BlobCache.hpp"
+#include "Tools/Fnv1a.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace OpenCppCoverage
+{
+	namespace
+	{
+		const wchar_t* RunExtension = L".resultrun";
+		const wchar_t* CoverageExtension = L".resultcoverage";
+
+		//---------------------------------------------------------------------
+		// A missing file has its own value, so creating it changes the key.
+		void AddFile(std::ostream& ostr, const fs::path& path)
+		{
+			std::ifstream ifs{ path, std::ios::binary };
+
+			ostr << Tools::ToUtf8String(path.wstring()) << '\n';
+			if (!ifs)
+			{
+				ostr << "missing\n";
+				return;
+			}
+
+			std::vector<char> buffer(64 * 1024);
+			auto hash = Tools::Fnv1aOffsetBasis;
+			uint64_t size = 0;
+			while (ifs.read(buffer.data(), buffer.size()) || ifs.gcount())
+			{
+				auto readSize = static_cast<size_t>(ifs.gcount());
+				hash = Tools::Fnv1a(hash, buffer.data(), readSize);
+				size += readSize;
+			}
+			ostr << std::hex << hash << std::dec << ' ' << size << '\n';
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring ComputeRunKey(
+			const fs::path& programPath,
+			const std::wstring& runDescription,
+			const std::vector<fs::path>& inputPaths)
+		{
+			std::ostringstream ostr;
+
+			ostr << Tools::ToUtf8String(runDescription) << '\n';
+			AddFile(ostr, programPath);
+			for (const auto& inputPath : inputPaths)
+				AddFile(ostr, inputPath);
+			return Tools::BlobCache::GetKey(ostr.str());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageResultCache::CoverageResultCache(
+		std::shared_ptr<const Tools::BlobCache> blobCache,
+		const fs::path& programPath,
+		const std::wstring& runDescription,
+		const std::vector<fs::path>& inputPaths)
+		: blobCache_{ std::move(blobCache) }
+		, runKey_{ ComputeRunKey(programPath, runDescription, inputPaths) }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageResultCache::~CoverageResultCache() = default;
+
+	//-------------------------------------------------------------------------
+	boost::optional<Plugin::CoverageData> CoverageResultCache::Find() const
+	{
+		auto modules = blobCache_->Read(runKey_ + RunExtension);
+		if (!modules)
+			return boost::none;
+
+		std::vector<fs::path> modulePaths;
+		std::istringstream istr{ *modules };
+		for (std::string modulePath; std::getline(istr, modulePath);)
+			modulePaths.emplace_back(Tools::Utf8ToWString(modulePath));
+
+		auto coveragePath = blobCache_->Find(GetCoverageName(modulePaths));
+		if (!coveragePath)
+			return boost::none;
+
+		try
+		{
+			return Exporter::CoverageDataDeserializer{}.Deserialize(
+				*coveragePath, Tools::ToUtf8String(coveragePath->wstring()) + " is not a coverage file.");
+		}
+		catch (const std::exception& e)
+		{
+			LOG_WARNING << L"Cannot read the cached coverage: " << Tools::LocalToWString(e.what());
+			return boost::none;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void CoverageResultCache::Write(const Plugin::CoverageData& coverageData) const
+	{
+		std::vector<fs::path> modulePaths;
+		std::string modules;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			modulePaths.push_back(module->GetPath());
+			modules += Tools::ToUtf8String(module->GetPath().wstring()) + '\n';
+		}
+
+		// The list of the modules is written last: it is read first.
+		blobCache_->Write(GetCoverageName(modulePaths), [&](std::ostream& ostr) {
+			Exporter::CoverageDataSerializer{}.Serialize(coverageData, ostr);
+		});
+		blobCache_->Write(runKey_ + RunExtension, modules);
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring CoverageResultCache::GetCoverageName(const std::vector<fs::path>& modulePaths) const
+	{
+		std::ostringstream ostr;
+
+		ostr << Tools::ToUtf8String(runKey_) << '\n';
+		for (const auto& modulePath : modulePaths)
+		{
+			AddFile(ostr, modulePath);
+			AddFile(ostr, fs::path{ modulePath }.replace_extension(L".pdb"));
+		}
+		return Tools::BlobCache::GetKey(ostr.str()) + CoverageExtension;
+	}
+}
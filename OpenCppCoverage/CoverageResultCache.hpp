@@ -0,0 +1,64 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+#include "Plugin/Exporter/CoverageData.hpp"
+
+namespace Tools
+{
+	class BlobCache;
+}
+
+namespace OpenCppCoverage
+{
+	// Coverage of the previous runs of a program, saved in a Tools::BlobCache
+	// with their exit code. A run is identified by the content of the program
+	// and of the input files, and by a description of the run: its command
+	// line and its options.
+	//
+	// The modules covered are known only after the run: the key of the run
+	// names a list of the covered modules, and the coverage is named by this
+	// key and the content of these modules and of the PDBs next to them.
+	class CoverageResultCache
+	{
+	public:
+		CoverageResultCache(std::shared_ptr<const Tools::BlobCache>,
+		                    const std::filesystem::path& programPath,
+		                    const std::wstring& runDescription,
+		                    const std::vector<std::filesystem::path>& inputPaths);
+		~CoverageResultCache();
+
+		// boost::none when the run, or one of the modules it covered, changed.
+		boost::optional<Plugin::CoverageData> Find() const;
+		void Write(const Plugin::CoverageData&) const;
+
+	private:
+		CoverageResultCache(const CoverageResultCache&) = delete;
+		CoverageResultCache& operator=(const CoverageResultCache&) = delete;
+
+		std::wstring GetCoverageName(const std::vector<std::filesystem::path>& modulePaths) const;
+
+		const std::shared_ptr<const Tools::BlobCache> blobCache_;
+		const std::wstring runKey_;
+	};
+}
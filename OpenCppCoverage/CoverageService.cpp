@@ -0,0 +1,261 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageService.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <Windows.h>
+
+#include "CppCoverage/CppCoverageException.hpp"
+#include "Exporter/Binary/CoverageDataReader.hpp"
+#include "Exporter/Binary/CoverageQueryIndex.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/ScopedAction.hpp"
+#include "Tools/SecurityAttributes.hpp"
+#include "Tools/Tool.hpp"
+
+namespace OpenCppCoverage
+{
+	namespace
+	{
+		const DWORD BufferSize = 4096;
+
+		//---------------------------------------------------------------------
+		std::wstring GetPipePath(const std::string& name)
+		{
+			return L"\\\\.\\pipe\\" + Tools::LocalToWString(name);
+		}
+
+		//---------------------------------------------------------------------
+		// Each field of the message is ended by '\0'.
+		std::vector<std::string> ReadMessage(HANDLE hPipe)
+		{
+			std::vector<char> message;
+			char buffer[BufferSize];
+
+			for (;;)
+			{
+				DWORD readSize = 0;
+				auto isRead = ReadFile(hPipe, buffer, sizeof(buffer), &readSize, nullptr);
+
+				message.insert(message.end(), buffer, buffer + readSize);
+				if (isRead)
+					break;
+				if (GetLastError() != ERROR_MORE_DATA)
+					THROW_LAST_ERROR(L"Cannot read the coverage request: ", GetLastError());
+			}
+
+			std::vector<std::string> fields;
+			auto begin = message.begin();
+			for (auto it = begin; it != message.end(); ++it)
+			{
+				if (!*it)
+				{
+					fields.emplace_back(begin, it);
+					begin = it + 1;
+				}
+			}
+			return fields;
+		}
+
+		//---------------------------------------------------------------------
+		// The request is the current directory of the client followed by its
+		// arguments.
+		std::vector<std::string> ReadRequest(HANDLE hPipe)
+		{
+			auto request = ReadMessage(hPipe);
+
+			if (request.size() < 2)
+				THROW(L"Invalid coverage request.");
+			return request;
+		}
+
+		//---------------------------------------------------------------------
+		void Write(HANDLE hPipe, const void* data, size_t size)
+		{
+			DWORD writtenSize = 0;
+
+			if (!WriteFile(hPipe, data, static_cast<DWORD>(size), &writtenSize, nullptr))
+				THROW_LAST_ERROR(L"Cannot write to the coverage service pipe: ", GetLastError());
+		}
+
+		//---------------------------------------------------------------------
+		int RunRequest(HANDLE hPipe, const RunCoverageRequest& runCoverageRequest)
+		{
+			auto request = ReadRequest(hPipe);
+			auto currentDirectory = std::filesystem::current_path();
+			Tools::ScopedAction restoreCurrentDirectory{
+			    [&]() { std::filesystem::current_path(currentDirectory); }};
+
+			std::filesystem::current_path(request.front());
+			request.erase(request.begin());
+			return runCoverageRequest(request);
+		}
+
+		//---------------------------------------------------------------------
+		std::string AnswerQuery(const std::vector<std::string>& query,
+		                        const Exporter::CoverageDataReader& reader,
+		                        const Exporter::CoverageQueryIndex& index)
+		{
+			if (query.size() != 2)
+				THROW(L"Invalid coverage query.");
+
+			std::filesystem::path sourcePath = Tools::Utf8ToWString(query[1]);
+			const auto& moduleSummaries = reader.GetModuleSummaries();
+			std::ostringstream answer;
+
+			if (query[0] == "file")
+			{
+				for (const auto& entry : index.GetFileCoverages(sourcePath))
+				{
+					answer << "module\t"
+					       << Tools::ToUtf8String(moduleSummaries[entry.moduleIndex_].GetPath().wstring()) << '\n';
+					entry.file_.ForEachLine([&](unsigned int lineNumber, bool hasBeenExecuted) {
+						answer << lineNumber << '\t' << (hasBeenExecuted ? '1' : '0') << '\n';
+					});
+				}
+			}
+			else if (query[0] == "modules")
+			{
+				for (auto moduleIndex : index.GetModules(sourcePath))
+					answer << Tools::ToUtf8String(moduleSummaries[moduleIndex].GetPath().wstring()) << '\n';
+			}
+			else
+				THROW(L"Unknown coverage query: " << Tools::Utf8ToWString(query[0]));
+			return answer.str();
+		}
+
+		//---------------------------------------------------------------------
+		// Answer the clients of the pipe one after the other until the process
+		// is stopped.
+		void Serve(const std::wstring& pipePath, const std::function<void(HANDLE)>& answer)
+		{
+			// Only the current user can query the coverage.
+			auto securityAttributes = Tools::SecurityAttributes::CreateForCurrentUser();
+
+			for (;;)
+			{
+				// The previous instance is closed: fail if another process
+				// created the pipe between two clients.
+				auto hPipe = CreateNamedPipeW(
+				    pipePath.c_str(),
+				    PIPE_ACCESS_DUPLEX | FILE_FLAG_FIRST_PIPE_INSTANCE,
+				    PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+				    1, BufferSize, BufferSize, 0, securityAttributes.Get());
+
+				if (hPipe == INVALID_HANDLE_VALUE)
+					THROW_LAST_ERROR(L"Cannot create the named pipe " << pipePath << L": ", GetLastError());
+				Tools::ScopedAction closePipe{[=]() { CloseHandle(hPipe); }};
+
+				if (!ConnectNamedPipe(hPipe, nullptr) && GetLastError() != ERROR_PIPE_CONNECTED)
+					THROW_LAST_ERROR(L"Cannot connect the named pipe " << pipePath << L": ", GetLastError());
+
+				// An invalid request or a client which stops does not stop the service.
+				try
+				{
+					answer(hPipe);
+					FlushFileBuffers(hPipe);
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR << L"Coverage request failed: " << e.what();
+				}
+				DisconnectNamedPipe(hPipe);
+			}
+		}
+
+		//---------------------------------------------------------------------
+		HANDLE ConnectToService(const std::wstring& pipePath)
+		{
+			for (;;)
+			{
+				auto hPipe = CreateFileW(pipePath.c_str(), GENERIC_READ | GENERIC_WRITE,
+				                         0, nullptr, OPEN_EXISTING, 0, nullptr);
+
+				if (hPipe != INVALID_HANDLE_VALUE)
+					return hPipe;
+
+				// The service runs one request at a time.
+				if (GetLastError() != ERROR_PIPE_BUSY ||
+				    !WaitNamedPipeW(pipePath.c_str(), NMPWAIT_WAIT_FOREVER))
+				{
+					THROW_LAST_ERROR(L"Cannot connect to the coverage service " << pipePath << L": ",
+					                 GetLastError());
+				}
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void ServeCoverageRequests(const std::string& name,
+	                           const RunCoverageRequest& runCoverageRequest)
+	{
+		auto pipePath = GetPipePath(name);
+
+		LOG_INFO << L"Coverage service started on " << pipePath;
+		Serve(pipePath, [&](HANDLE hPipe) {
+			auto exitCode = RunRequest(hPipe, runCoverageRequest);
+
+			Write(hPipe, &exitCode, sizeof(exitCode));
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	void ServeCoverageQueries(const std::string& name, const std::filesystem::path& coveragePath)
+	{
+		auto pipePath = GetPipePath(name);
+		auto start = std::chrono::steady_clock::now();
+		Exporter::CoverageDataReader reader{
+		    coveragePath, "The coverage queries require a binary coverage file of version 2."};
+		Exporter::CoverageQueryIndex index{reader};
+		std::chrono::duration<double, std::milli> indexDuration = std::chrono::steady_clock::now() - start;
+
+		LOG_INFO << L"Coverage query service started on " << pipePath << L" for "
+		         << coveragePath.wstring() << L" (indexed in " << indexDuration.count() << L" ms)";
+		Serve(pipePath, [&](HANDLE hPipe) {
+			auto answer = AnswerQuery(ReadMessage(hPipe), reader, index);
+
+			Write(hPipe, answer.data(), answer.size());
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	int SubmitCoverageRequest(const std::string& name, int argc, const char** argv)
+	{
+		auto pipePath = GetPipePath(name);
+		auto hPipe = ConnectToService(pipePath);
+		Tools::ScopedAction closePipe{[=]() { CloseHandle(hPipe); }};
+
+		std::string message = std::filesystem::current_path().string();
+		message.push_back('\0');
+		for (int i = 0; i < argc; ++i)
+		{
+			message += argv[i];
+			message.push_back('\0');
+		}
+		Write(hPipe, message.data(), message.size());
+
+		int exitCode = 0;
+		DWORD readSize = 0;
+		if (!ReadFile(hPipe, &exitCode, sizeof(exitCode), &readSize, nullptr) ||
+		    readSize != sizeof(exitCode))
+			THROW(L"The coverage service " << pipePath << L" stopped before the end of the run.");
+		return exitCode;
+	}
+}
@@ -0,0 +1,45 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace OpenCppCoverage
+{
+	// Run on the command line sent to the service. The arguments start
+	// with the program name as for main.
+	using RunCoverageRequest = std::function<int(const std::vector<std::string>& arguments)>;
+
+	// Run the requests sent on the named pipe \\.\pipe\<name> one after the
+	// other until the process is stopped. Each request runs in the current
+	// directory of its client.
+	void ServeCoverageRequests(const std::string& name, const RunCoverageRequest&);
+
+	// Send the command line to the service and return the exit code of its run.
+	int SubmitCoverageRequest(const std::string& name, int argc, const char** argv);
+
+	// Answer the queries sent on the named pipe \\.\pipe\<name> from the
+	// binary coverage file until the process is stopped. A query is
+	// "file\0<source path>\0" or "modules\0<source path>\0", the paths are UTF-8.
+	// The answer to "file" is, for each module containing the source file,
+	// "module\t<module path>\n" followed by "<line number>\t<0|1>\n" for each line.
+	// The answer to "modules" is "<module path>\n" for each module.
+	void ServeCoverageQueries(const std::string& name, const std::filesystem::path& coveragePath);
+}
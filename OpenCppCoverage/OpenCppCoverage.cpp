@@ -17,7 +17,21 @@
 #include "stdafx.h"
 #include "OpenCppCoverage.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <sstream>
+
+#include <Windows.h>
+#include <Psapi.h>
+
+#include <boost/algorithm/string/case_conv.hpp>
 
 #include "CppCoverage/CodeCoverageRunner.hpp"
 #include "CppCoverage/CoverageFilterSettings.hpp"
@@ -25,22 +39,68 @@
 #include "CppCoverage/Options.hpp"
 #include "CppCoverage/ProgramOptions.hpp"
 #include "CppCoverage/CoverageDataMerger.hpp"
+#include "CppCoverage/CoverageComparer.hpp"
+#include "CppCoverage/CoverageBaseline.hpp"
+#include "CppCoverage/TestImpactIndex.hpp"
+#include "CppCoverage/TestImpactIndexReader.hpp"
 #include "CppCoverage/OptionsExport.hpp"
 #include "CppCoverage/RunCoverageSettings.hpp"
+#include "CppCoverage/DebugInformationCache.hpp"
+#include "CppCoverage/PdbCache.hpp"
+#include "CppCoverage/PerformanceStatistics.hpp"
+#include "CppCoverage/TraceRecorder.hpp"
+#include "CppCoverage/LiveCounters.hpp"
+#include "CppCoverage/OverheadReport.hpp"
+#include "CppCoverage/Process.hpp"
+#include "CppCoverage/EtwProvider.hpp"
+#include "CppCoverage/SourceServerFetcher.hpp"
+#include "CppCoverage/SymbolPrefetcher.hpp"
+#include "CppCoverage/SymbolLoadThrottle.hpp"
+#include "CppCoverage/CoverageFilterManager.hpp"
+#include "CppCoverage/ImageInstrumenter.hpp"
+#include "CppCoverage/ModuleLineTable.hpp"
+#include "CppCoverage/SancovFile.hpp"
 #include "CppCoverage/ExportOptionParser.hpp"
+#include "CppCoverage/CoverageJournal.hpp"
+#include "CppCoverage/CoverageDataFilter.hpp"
+#include "CppCoverage/CoverageLineRemapper.hpp"
+#include "CppCoverage/CoverageRateComputer.hpp"
+#include "CppCoverage/CoverageSummary.hpp"
+#include "CppCoverage/ICoverageSource.hpp"
 
 #include "Exporter/Html/HtmlExporter.hpp"
 #include "Exporter/CoberturaExporter.hpp"
+#include "Exporter/FirstHitsExporter.hpp"
+#include "Exporter/SummaryExporter.hpp"
+#include "Exporter/LcovExporter.hpp"
+#include "Exporter/CoverageImporter.hpp"
+#include "Exporter/ParquetExporter.hpp"
+#include "Exporter/Html/CompactHtmlExporter.hpp"
+#include "Exporter/Html/DiffHtmlExporter.hpp"
+#include "Exporter/ReportWriter.hpp"
 #include "Exporter/Binary/BinaryExporter.hpp"
+#include "Exporter/Binary/AggregatorExporter.hpp"
 #include "Exporter/Binary/CoverageDataDeserializer.hpp"
 #include "Exporter/Plugin/ExporterPluginManager.hpp"
 #include "Exporter/Plugin/PluginLoader.hpp"
 
 #include "Plugin/Exporter/IExportPlugin.hpp"
+#include "Plugin/Exporter/CoverageDataView.hpp"
 
 #include "Tools/Tool.hpp"
 #include "Tools/Log.hpp"
+#include "Tools/ThreadPlacement.hpp"
+#include "Tools/ThreadPool.hpp"
+#include "Tools/ProcessMemory.hpp"
+#include "Tools/ScopedAction.hpp"
 #include "Tools/WarningManager.hpp"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/BlobCache.hpp"
+
+#include "CoverageService.hpp"
+#include "CoverageAggregator.hpp"
+#include "CoverageResultCache.hpp"
+#include "PluginProcesses.hpp"
 
 namespace cov = CppCoverage;
 namespace logging = boost::log;
@@ -78,31 +138,217 @@ namespace OpenCppCoverage
 		}
 
 		//-----------------------------------------------------------------------------
-		void
+		template <typename F>
+		auto OnCoverageFilterManager(const cov::Options& options, F f)
+		{
+			cov::CoverageFilterSettings coverageFilterSettings{ options.GetModulePatterns(), options.GetSourcePatterns() };
+			cov::CoverageFilterManager coverageFilterManager{
+			    coverageFilterSettings,
+			    options.GetUnifiedDiffSettingsCollection(),
+			    options.GetExcludedLineRegexes(),
+			    options.IsOptimizedBuildSupportEnabled(),
+			    options.GetExclusionMarkers()};
+
+			return f(coverageFilterManager);
+		}
+
+		//-----------------------------------------------------------------------------
+		cov::ModuleLineTable CreateModuleLineTable(
+		    const cov::Options& options,
+		    const std::filesystem::path& modulePath)
+		{
+			return OnCoverageFilterManager(options, [&](cov::CoverageFilterManager& coverageFilterManager) {
+				return cov::ModuleLineTable::Create(
+				    modulePath, options.GetSubstitutePdbSourcePaths(), coverageFilterManager);
+			});
+		}
+
+		//-----------------------------------------------------------------------------
+		size_t GetJobCount(const cov::Options& options, size_t taskCount)
+		{
+			size_t jobCount = options.GetJobCount();
+
+			if (!jobCount)
+				jobCount = std::thread::hardware_concurrency();
+			return (std::max)(size_t{1}, (std::min)(jobCount, taskCount));
+		}
+
+		//-----------------------------------------------------------------------------
+		// Call function(i) for i in [0, count) on at most jobCount threads.
+		// The jobs are tasks of the thread pool used by the loops they run,
+		// so nested parallelism does not start more threads than the pool.
+		template <typename Function>
+		void RunJobs(size_t jobCount, size_t count, Function function)
+		{
+			std::vector<std::exception_ptr> errors(count);
+			std::atomic<size_t> next{0};
+			auto run = [&]() {
+				for (size_t i = next++; i < count; i = next++)
+				{
+					try
+					{
+						function(i);
+					}
+					catch (...)
+					{
+						errors[i] = std::current_exception();
+					}
+				}
+			};
+
+			Tools::TaskGroup taskGroup;
+			for (size_t i = 1; i < (std::min)(jobCount, count); ++i)
+				taskGroup.Run(run);
+			run();
+			taskGroup.Wait();
+			for (const auto& error : errors)
+			{
+				if (error)
+					std::rethrow_exception(error);
+			}
+		}
+
+		//-----------------------------------------------------------------------------
+		// The exporters are created only for the export types requested: the
+		// HTML exporter reads its templates when it is created.
+		std::unique_ptr<Exporter::IExporter> CreateExporter(
+		    cov::OptionsExportType exportType,
+		    const cov::Options& options,
+		    std::shared_ptr<Tools::SourceFileCache> sourceFileCache)
+		{
+			auto reportCompression = options.GetReportCompression();
+
+			switch (exportType)
+			{
+				case cov::OptionsExportType::Html:
+					return std::make_unique<Exporter::HtmlExporter>(
+					    GetTemplateFolder(),
+					    options.IsIncrementalHtmlModeEnabled(),
+					    reportCompression,
+					    options.GetHtmlAssetsFolder(),
+					    sourceFileCache,
+					    options.GetHtmlShard(),
+					    options.IsDeterministicModeEnabled());
+				case cov::OptionsExportType::Cobertura:
+					return std::make_unique<Exporter::CoberturaExporter>(
+					    options.GetCoberturaPackageCountByFile(),
+					    reportCompression,
+					    options.IsDeterministicModeEnabled());
+				case cov::OptionsExportType::Binary:
+				{
+					using BinaryLayout = Exporter::BinaryExporter::Layout;
+
+					if (const auto* binaryBaselinePath = options.GetBinaryBaselinePath())
+						return std::make_unique<Exporter::BinaryExporter>(BinaryLayout::Delta, *binaryBaselinePath);
+					if (const auto* binaryLineTablesFolder = options.GetBinaryLineTablesFolder())
+						return std::make_unique<Exporter::BinaryExporter>(BinaryLayout::Hits, *binaryLineTablesFolder);
+					return std::make_unique<Exporter::BinaryExporter>(options.IsBinaryCompressionEnabled());
+				}
+				case cov::OptionsExportType::FirstHits:
+					return std::make_unique<Exporter::FirstHitsExporter>();
+				case cov::OptionsExportType::Summary:
+					return std::make_unique<Exporter::SummaryExporter>();
+				case cov::OptionsExportType::Lcov:
+					return std::make_unique<Exporter::LcovExporter>(
+					    reportCompression, options.IsDeterministicModeEnabled());
+				case cov::OptionsExportType::Parquet:
+					// The run of a deterministic export is empty.
+					if (options.IsDeterministicModeEnabled())
+						return std::make_unique<Exporter::ParquetExporter>(std::string{});
+					return std::make_unique<Exporter::ParquetExporter>();
+				case cov::OptionsExportType::Aggregator:
+					return std::make_unique<Exporter::AggregatorExporter>();
+				case cov::OptionsExportType::CompactHtml:
+					return std::make_unique<Exporter::CompactHtmlExporter>(
+					    GetTemplateFolder(), reportCompression, sourceFileCache,
+					    options.IsDeterministicModeEnabled());
+				case cov::OptionsExportType::DiffHtml:
+					return std::make_unique<Exporter::DiffHtmlExporter>(
+					    reportCompression, sourceFileCache, options.IsDeterministicModeEnabled());
+				case cov::OptionsExportType::Plugin:
+					// The plugins are exported by ExporterPluginManager.
+					break;
+			}
+			return nullptr;
+		}
+
+		//-----------------------------------------------------------------------------
+		// Return the coverage rate of coverage.
+		cov::CoverageRate
 		Export(const cov::Options& options,
 		       const Exporter::ExporterPluginManager& exporterPluginManager,
-		       const Plugin::CoverageData& coverage)
+		       const Plugin::CoverageData& coverage,
+		       std::shared_ptr<Tools::SourceFileCache> sourceFileCache,
+		       cov::PerformanceStatistics* performanceStatistics,
+		       cov::TraceRecorder* traceRecorder)
 		{
 			const auto& exports = options.GetExports();
 			std::map<cov::OptionsExportType, std::unique_ptr<Exporter::IExporter>> exporters;
-			
-			exporters.emplace(cov::OptionsExportType::Html, 
-				std::unique_ptr<Exporter::IExporter>(std::make_unique<Exporter::HtmlExporter>( GetTemplateFolder() )));
-			exporters.emplace(cov::OptionsExportType::Cobertura, 
-				std::unique_ptr<Exporter::IExporter>(std::make_unique<Exporter::CoberturaExporter>()));
-			exporters.emplace(cov::OptionsExportType::Binary,
-				std::unique_ptr<Exporter::IExporter>(std::make_unique<Exporter::BinaryExporter>()));
-			
+
+			for (const auto& singleExport : exports)
+			{
+				auto exportType = singleExport.GetType();
+
+				if (exportType != cov::OptionsExportType::Plugin && !exporters.count(exportType))
+					exporters.emplace(exportType, CreateExporter(exportType, options, sourceFileCache));
+			}
+
 			auto defaultPathPrefix = GetDefaultPathPrefix(options);
 
+			// The exports only read the coverage and run in parallel, except the
+			// exports of the same exporter which are performed one after another
+			// and the plugins which are not thread-safe.
+			cov::CoverageRateComputer coverageRateComputer{ coverage };
+			std::map<std::pair<cov::OptionsExportType, std::wstring>, std::vector<const cov::OptionsExport*>> exportGroups;
+			std::vector<const cov::OptionsExport*> sequentialExports;
+			std::vector<const cov::OptionsExport*> pluginProcessExports;
+			// Built by the first plugin export, while the other exports are performed.
+			std::unique_ptr<Plugin::CoverageDataView> coverageDataView;
+			std::once_flag coverageDataViewFlag;
+
 			for (const auto& singleExport : exports)
 			{
 				auto exportType = singleExport.GetType();
+
+				if (exportType == cov::OptionsExportType::Plugin && options.IsOutOfProcessPluginsModeEnabled())
+				{
+					pluginProcessExports.push_back(&singleExport);
+					continue;
+				}
+
+				if (exportType != cov::OptionsExportType::Plugin)
+					exportGroups[{exportType, L""}].push_back(&singleExport);
+				else if (exporterPluginManager.IsThreadSafe(singleExport.GetName()))
+					exportGroups[{exportType, singleExport.GetName()}].push_back(&singleExport);
+				else
+					sequentialExports.push_back(&singleExport);
+			}
+
+			auto runExport = [&](const cov::OptionsExport& singleExport) {
+				auto exportType = singleExport.GetType();
 				auto parameter = singleExport.GetParameter();
+				auto wallStart = cov::PerformanceStatistics::Clock::now();
+				cov::TraceRecorder::ScopedSpan span{traceRecorder, "Export", "export", singleExport.GetName()};
+				cov::EtwProvider::OnExportStart(singleExport.GetName());
+				Tools::ScopedAction onExportStop{[&]() { cov::EtwProvider::OnExportStop(singleExport.GetName()); }};
+				Tools::ScopedAction addExportPhase{[&]() {
+					// The exports run in parallel: the CPU time of the process is not theirs.
+					if (performanceStatistics)
+					{
+						performanceStatistics->AddPhase(
+						    "Export " + Tools::ToUtf8String(singleExport.GetName()),
+						    cov::PerformanceStatistics::Clock::now() - wallStart);
+					}
+				}};
 
 				if (exportType == cov::OptionsExportType::Plugin)
+				{
+					std::call_once(coverageDataViewFlag, [&]() {
+						coverageDataView = std::make_unique<Plugin::CoverageDataView>(coverage);
+					});
 					exporterPluginManager.Export(
-					    singleExport.GetName(), coverage, parameter);
+					    singleExport.GetName(), *coverageDataView, parameter);
+				}
 				else
 				{
 					const auto& exporter = exporters.at(exportType);
@@ -111,23 +357,296 @@ namespace OpenCppCoverage
 					        ? fs::path{*parameter}
 					        : exporter->GetDefaultPath(defaultPathPrefix);
 
-					exporter->Export(coverage, output);
+					exporter->Export(coverage, coverageRateComputer, output);
+					if (performanceStatistics)
+					{
+						// The buffers are released at the end of the export.
+						for (const auto& bufferSize : exporter->GetPeakBufferSizes())
+						{
+							performanceStatistics->UpdateMemoryUsage(bufferSize.first, 0, bufferSize.second);
+							performanceStatistics->UpdateMemoryUsage(bufferSize.first, bufferSize.second, 0);
+						}
+					}
+					// The binary export is kept as it is to be read by --input_coverage.
+					if (reportCompression != cov::ReportCompression::None &&
+					    exportType == cov::OptionsExportType::FirstHits)
+					{
+						Tools::ShowOutputMessage(L"Report compressed in ",
+						    Exporter::ReportWriter::CompressFile(
+						        output, reportCompression, options.IsDeterministicModeEnabled()));
+					}
 				}
+			};
+
+			// The plugin processes export while the other exports are performed.
+			std::optional<PluginProcesses> pluginProcesses;
+			if (!pluginProcessExports.empty())
+				pluginProcesses.emplace(coverage, pluginProcessExports);
+
+			std::vector<const std::vector<const cov::OptionsExport*>*> jobs;
+			for (const auto& exportGroup : exportGroups)
+				jobs.push_back(&exportGroup.second);
+			RunJobs(GetJobCount(options, jobs.size()), jobs.size(), [&](size_t i) {
+				if (traceRecorder)
+					traceRecorder->SetThreadName("Export worker");
+				for (const auto* singleExport : *jobs[i])
+					runExport(*singleExport);
+			});
+			for (const auto* singleExport : sequentialExports)
+				runExport(*singleExport);
+			if (pluginProcesses)
+				pluginProcesses->Wait();
+
+			return coverageRateComputer.GetCoverageRate();
+		}
+
+		//-----------------------------------------------------------------------------
+		bool IsSummaryExportOnly(const cov::Options& options)
+		{
+			const auto& exports = options.GetExports();
+
+			return !exports.empty() &&
+			       std::all_of(exports.begin(), exports.end(), [](const auto& singleExport) {
+				       return singleExport.GetType() == cov::OptionsExportType::Summary;
+			       });
+		}
+
+		//-----------------------------------------------------------------------------
+		// The binary exports which can be written without the coverage data.
+		bool IsBinaryExportOnly(const cov::Options& options)
+		{
+			const auto& exports = options.GetExports();
+
+			return !exports.empty() && !options.GetBinaryBaselinePath() && !options.GetBinaryLineTablesFolder() &&
+			       std::all_of(exports.begin(), exports.end(), [](const auto& singleExport) {
+				       return singleExport.GetType() == cov::OptionsExportType::Binary;
+			       });
+		}
+
+		//-----------------------------------------------------------------------------
+		void ExportBinary(const cov::Options& options, const cov::ICoverageSource& coverageSource)
+		{
+			Exporter::BinaryExporter binaryExporter{options.IsBinaryCompressionEnabled()};
+			auto defaultPathPrefix = GetDefaultPathPrefix(options);
+
+			for (const auto& singleExport : options.GetExports())
+			{
+				const auto& parameter = singleExport.GetParameter();
+				binaryExporter.Export(coverageSource,
+				                      (parameter) ? fs::path{*parameter}
+				                                  : binaryExporter.GetDefaultPath(defaultPathPrefix));
+			}
+		}
+
+		//-----------------------------------------------------------------------------
+		cov::CoverageRate ExportSummary(const cov::Options& options,
+		                                const cov::CoverageSummary& coverageSummary)
+		{
+			Exporter::SummaryExporter summaryExporter;
+			auto defaultPathPrefix = GetDefaultPathPrefix(options);
+
+			for (const auto& singleExport : options.GetExports())
+			{
+				const auto& parameter = singleExport.GetParameter();
+				summaryExporter.Export(coverageSummary,
+				                       (parameter) ? fs::path{*parameter}
+				                                   : summaryExporter.GetDefaultPath(defaultPathPrefix));
 			}
+			return coverageSummary.GetCoverageRate();
+		}
+
+		//-----------------------------------------------------------------------------
+		int GetRunExitCode(const cov::Options& options,
+		                   const cov::CoverageRate& coverageRate,
+		                   int exitCode)
+		{
+			if (exitCode)
+				LOG_ERROR << L"Your program stop with error code: " << exitCode;
+
+			auto minimumLineRatePercent = options.GetMinimumLineRatePercent();
+			if (coverageRate.GetRate() * 100 < minimumLineRatePercent)
+			{
+				LOG_ERROR << L"The line coverage rate " << coverageRate.GetPercentRate()
+				          << L"% is lower than --" << Tools::LocalToWString(cov::ProgramOptions::FailUnderOption)
+				          << L" " << minimumLineRatePercent << L"%.";
+				if (!exitCode)
+					return FailureExitCode;
+			}
+			return exitCode;
+		}
+
+		//-----------------------------------------------------------------------------
+		// The release filter needs the process so it cannot be applied again.
+		std::unique_ptr<cov::CoverageFilterManager> CreateInputCoverageFilterManager(
+		    const cov::Options& options)
+		{
+			if (!options.IsInputCoverageRefilterModeEnabled())
+				return nullptr;
+
+			cov::CoverageFilterSettings coverageFilterSettings{ options.GetModulePatterns(), options.GetSourcePatterns() };
+			return std::make_unique<cov::CoverageFilterManager>(
+			    coverageFilterSettings,
+			    options.GetUnifiedDiffSettingsCollection(),
+			    options.GetExcludedLineRegexes(),
+			    false,
+			    options.GetExclusionMarkers());
+		}
+
+		//-----------------------------------------------------------------------------
+		// When the coverage is filtered again, only the selected modules of a
+		// file with a module index are read.
+		// The lines are remapped before the filter which reads the current
+		// revision of the sources.
+		Plugin::CoverageData LoadInputCoverageFile(
+		    const std::filesystem::path& path,
+		    const Exporter::CoverageDataDeserializer& coverageDataDeserializer,
+		    cov::CoverageLineRemapper* coverageLineRemapper,
+		    cov::CoverageDataFilter* coverageDataFilter)
+		{
+			auto errorMsg = "Cannot extract coverage data from " + path.string();
+			auto finish = [&](Plugin::CoverageData&& coverageData) {
+				if (coverageLineRemapper)
+					coverageData = coverageLineRemapper->Remap(coverageData);
+				return coverageDataFilter ? coverageDataFilter->Filter(coverageData) : std::move(coverageData);
+			};
+
+			LOG_INFO << L"Load coverage file: " << path.wstring();
+			// A journal is replayed up to its last complete record.
+			if (cov::CoverageJournal::IsJournal(path))
+				return finish(cov::CoverageJournal::Replay(path));
+			// The reports of the other tools are parsed while they are read.
+			if (auto format = Exporter::CoverageImporter::GetFormat(path))
+				return finish(Exporter::CoverageImporter{}.Import(path, *format));
+			if (!coverageDataFilter || !coverageDataDeserializer.HasModuleIndex(path))
+				return finish(coverageDataDeserializer.Deserialize(path, errorMsg));
+
+			std::vector<std::filesystem::path> modulePaths;
+			for (const auto& moduleSummary : coverageDataDeserializer.DeserializeModuleSummaries(path, errorMsg))
+			{
+				if (coverageDataFilter->IsModuleSelected(moduleSummary.GetPath()))
+					modulePaths.push_back(moduleSummary.GetPath());
+			}
+			return finish(coverageDataDeserializer.DeserializeModules(path, modulePaths, errorMsg));
+		}
+
+		//-----------------------------------------------------------------------------
+		// Each job loads a contiguous range of the files and merges them as soon
+		// as they are loaded: at most one file by job and the sums are in memory.
+		// The sums of the neighbour ranges are then merged by pair so the result
+		// is the same as merging the files in order.
+		// The line counts of a single binary file with a module index are read
+		// from its index. Several files cannot be summed as their lines are merged.
+		std::optional<cov::CoverageSummary> LoadInputCoverageSummary(const cov::Options& options)
+		{
+			const auto& paths = options.GetInputCoveragePaths();
+			if (paths.size() != 1 || options.GetStartInfo() || !options.GetPrograms().empty() ||
+			    options.GetAggregatorName() ||
+			    !options.GetInputLineCountersPaths().empty() || !options.GetInputSancovPaths().empty() ||
+			    options.IsInputCoverageRefilterModeEnabled() || options.GetInputCoverageDiffSettings() ||
+			    options.IsAggregateByFileModeEnabled() || !IsSummaryExportOnly(options))
+			{
+				return std::nullopt;
+			}
+
+			const auto& path = paths.front();
+			Exporter::CoverageDataDeserializer coverageDataDeserializer;
+			if (cov::CoverageJournal::IsJournal(path) || !coverageDataDeserializer.HasModuleIndex(path))
+				return std::nullopt;
+
+			LOG_INFO << L"Load coverage summary: " << path.wstring();
+			cov::CoverageSummary coverageSummary{ path.filename().wstring(), 0 };
+			for (const auto& moduleSummary : coverageDataDeserializer.DeserializeModuleSummaries(
+			         path, "Cannot extract coverage data from " + path.string()))
+			{
+				auto executedLineCount = static_cast<int>(moduleSummary.GetExecutedLineCount());
+				coverageSummary.AddModule(
+				    moduleSummary.GetPath(),
+				    cov::CoverageRate{ executedLineCount,
+				                       static_cast<int>(moduleSummary.GetLineCount()) - executedLineCount });
+			}
+			return coverageSummary;
+		}
+
+		//-----------------------------------------------------------------------------
+		std::optional<Plugin::CoverageData> LoadInputCoverageData(const cov::Options& options)
+		{
+			const auto& paths = options.GetInputCoveragePaths();
+			if (paths.empty())
+				return std::nullopt;
+
+			auto jobCount = GetJobCount(options, paths.size());
+			std::vector<std::optional<Plugin::CoverageData>> sums(jobCount);
+			cov::CoverageDataMerger coverageDataMerger;
+
+			LOG_INFO << L"Load " << paths.size() << L" coverage files with "
+			         << jobCount << L" jobs.";
+			RunJobs(jobCount, jobCount, [&](size_t job) {
+				Exporter::CoverageDataDeserializer coverageDataDeserializer;
+				// The filters read the source files: each job has its own.
+				auto coverageFilterManager = CreateInputCoverageFilterManager(options);
+				std::optional<cov::CoverageDataFilter> coverageDataFilter;
+				std::optional<cov::CoverageLineRemapper> coverageLineRemapper;
+				auto& sum = sums[job];
+
+				if (coverageFilterManager)
+					coverageDataFilter.emplace(*coverageFilterManager);
+				if (const auto* inputCoverageDiffSettings = options.GetInputCoverageDiffSettings())
+					coverageLineRemapper.emplace(*inputCoverageDiffSettings);
+				for (auto i = paths.size() * job / jobCount; i < paths.size() * (job + 1) / jobCount; ++i)
+				{
+					auto coverageData = LoadInputCoverageFile(
+					    paths[i], coverageDataDeserializer,
+					    coverageLineRemapper ? &*coverageLineRemapper : nullptr,
+					    coverageDataFilter ? &*coverageDataFilter : nullptr);
+					if (!sum)
+						sum.emplace(std::move(coverageData));
+					else
+						coverageDataMerger.MergeInto(*sum, std::move(coverageData));
+				}
+			});
+
+			for (size_t step = 1; step < jobCount; step *= 2)
+			{
+				auto pairCount = (jobCount - step + 2 * step - 1) / (2 * step);
+
+				RunJobs(jobCount, pairCount, [&](size_t pair) {
+					auto i = pair * 2 * step;
+					coverageDataMerger.MergeInto(*sums[i], std::move(*sums[i + step]));
+					sums[i + step].reset();
+				});
+			}
+			return std::move(sums.front());
 		}
 
 		//-----------------------------------------------------------------------------
 		std::vector<Plugin::CoverageData> LoadInputCoverageDatas(const cov::Options& options)
 		{
 			std::vector<Plugin::CoverageData> coverageDatas;
-			Exporter::CoverageDataDeserializer coverageDataDeserializer;
 
-			for (const auto& path : options.GetInputCoveragePaths())
-			{				
-				auto errorMsg = "Cannot extract coverage data from " + path.string();
+			if (auto inputCoverageData = LoadInputCoverageData(options))
+				coverageDatas.push_back(std::move(*inputCoverageData));
+
+			for (const auto& paths : options.GetInputLineCountersPaths())
+			{
+				LOG_INFO << L"Load line counters: " << paths.second.wstring();
+				auto lineTable = cov::ModuleLineTable::Read(paths.first);
+
+				coverageDatas.push_back(lineTable.CreateCoverageData(
+				    lineTable.GetModulePath().filename().wstring(), lineTable.ReadHitCounts(paths.second), true));
+			}
 
-				LOG_INFO << L"Load coverage file: " << path.wstring();
-				coverageDatas.push_back(coverageDataDeserializer.Deserialize(path, errorMsg));
+			for (const auto& paths : options.GetInputSancovPaths())
+			{
+				LOG_INFO << L"Load sancov file: " << paths.second.wstring();
+				auto lineTable = CreateModuleLineTable(options, std::filesystem::absolute(paths.first));
+				coverageDatas.push_back(cov::SancovFile::CreateCoverageData(
+				    lineTable, cov::SancovFile::ReadOffsets(paths.second)));
+			}
+
+			if (const auto* aggregatorName = options.GetAggregatorName())
+			{
+				coverageDatas.push_back(
+				    AggregateCoverages(*aggregatorName, options.GetAggregatorRunCount()));
 			}
 			return coverageDatas;
 		}
@@ -143,33 +662,633 @@ namespace OpenCppCoverage
 				case cov::LogLevel::Quiet: logLevel = logging::trivial::error; break;
 			}
 
-			Tools::InitConsoleAndFileLog(L"LastCoverageResults.log");
+			// The service runs several command lines in the same process.
+			static std::once_flag logInitialization;
+			std::call_once(logInitialization, [&]() {
+				// A plugin process runs at the same time as the process which started it.
+				std::wstring logPath = L"LastCoverageResults.log";
+				if (options.GetExportPluginHostSectionName() && !options.GetExports().empty())
+					logPath = L"LastCoverageResults." + options.GetExports().front().GetName() + L".log";
+				Tools::InitConsoleAndFileLog(logPath);
+			});
 			Tools::SetLoggerMinSeverity(logLevel);
 		}
 
 		//-----------------------------------------------------------------------------
+		void SelectTests(const cov::Options& options)
+		{
+			cov::TestImpactIndexReader testImpactIndexReader{*options.GetSelectTestsIndexPath()};
+			auto selectedTests = testImpactIndexReader.SelectTests(
+			    options.GetUnifiedDiffSettingsCollection());
+
+			LOG_INFO << selectedTests.size() << L" tests selected out of "
+			         << testImpactIndexReader.GetTestCount() << L".";
+			Tools::FlushLog();
+			for (const auto& test : selectedTests)
+				std::wcout << test << std::endl;
+		}
+
+		//-----------------------------------------------------------------------------
+		void CompareCoverages(const cov::Options& options)
+		{
+			const auto& paths = options.GetInputCoveragePaths();
+			std::vector<std::optional<Plugin::CoverageData>> coverageDatas(paths.size());
+
+			RunJobs(GetJobCount(options, paths.size()), paths.size(), [&](size_t i) {
+				Exporter::CoverageDataDeserializer coverageDataDeserializer;
+				auto coverageFilterManager = CreateInputCoverageFilterManager(options);
+				std::optional<cov::CoverageDataFilter> coverageDataFilter;
+
+				if (coverageFilterManager)
+					coverageDataFilter.emplace(*coverageFilterManager);
+				coverageDatas[i] = LoadInputCoverageFile(
+				    paths[i], coverageDataDeserializer, nullptr,
+				    coverageDataFilter ? &*coverageDataFilter : nullptr);
+			});
+
+			cov::CoverageComparer coverageComparer;
+			auto comparison = coverageComparer.Compare(*coverageDatas.at(0), *coverageDatas.at(1));
+			const auto& outputPath = *options.GetCompareCoverageOutputPath();
+
+			coverageComparer.Write(comparison, outputPath);
+			LOG_INFO << comparison.newlyCoveredLineCount_ << L" lines newly covered, "
+			         << comparison.newlyUncoveredLineCount_ << L" lines newly uncovered and "
+			         << comparison.commonLineCount_ << L" lines covered by both in "
+			         << comparison.files_.size() << L" changed files written to "
+			         << outputPath.wstring() << L".";
+		}
+
+		//-----------------------------------------------------------------------------
+		void WriteLineTable(const cov::Options& options)
+		{
+			auto modulePath = std::filesystem::absolute(options.GetStartInfo()->GetPath());
+			const auto* instrumentedImagePath = options.GetInstrumentedImagePath();
+			auto lineTable = instrumentedImagePath
+			    ? OnCoverageFilterManager(options, [&](cov::CoverageFilterManager& coverageFilterManager) {
+				      return cov::ImageInstrumenter::Instrument(modulePath,
+				                                                options.GetSubstitutePdbSourcePaths(),
+				                                                coverageFilterManager,
+				                                                *instrumentedImagePath);
+			      })
+			    : CreateModuleLineTable(options, modulePath);
+
+			if (instrumentedImagePath)
+			{
+				LOG_INFO << L"Instrumented image written to " << instrumentedImagePath->wstring()
+				         << L": it writes its counters to "
+				         << cov::ImageInstrumenter::GetCountersPath(*instrumentedImagePath).wstring() << L".";
+			}
+			lineTable.Write(*options.GetLineTablePath());
+			LOG_INFO << lineTable.GetLines().size() << L" lines of " << modulePath.wstring()
+			         << L" written to " << options.GetLineTablePath()->wstring() << L".";
+		}
+
+		//-----------------------------------------------------------------------------
+		void WritePerformanceStatistics(cov::PerformanceStatistics& performanceStatistics,
+		                                const fs::path& path)
+		{
+			performanceStatistics.AddCounter("Program memory bytes read", Tools::GetReadProcessMemoryBytes());
+			performanceStatistics.AddCounter("Program memory bytes written", Tools::GetWrittenProcessMemoryBytes());
+
+			PROCESS_MEMORY_COUNTERS memoryCounters{};
+			if (GetProcessMemoryInfo(GetCurrentProcess(), &memoryCounters, sizeof(memoryCounters)))
+			{
+				performanceStatistics.AddCounter("Peak working set bytes", memoryCounters.PeakWorkingSetSize);
+				performanceStatistics.AddCounter("Peak commit bytes", memoryCounters.PeakPagefileUsage);
+			}
+			if (cov::SymbolLoadThrottle::GetMachineConcurrency())
+			{
+				performanceStatistics.AddPhase("Symbol loads: waiting for the machine",
+				                               cov::SymbolLoadThrottle::GetWaitTime());
+				performanceStatistics.AddCounter("Symbol load waits", cov::SymbolLoadThrottle::GetWaitCount());
+			}
+
+			std::wostringstream ostr;
+			performanceStatistics.WriteTable(ostr);
+			LOG_INFO << L"Performance statistics:" << std::endl << ostr.str();
+
+			Tools::CreateParentFolderIfNeeded(path);
+			std::ofstream ofs{path};
+			performanceStatistics.WriteJson(ofs);
+			if (!ofs)
+			{
+				LOG_ERROR << L"Cannot write the performance statistics in " << path.wstring();
+				return;
+			}
+			Tools::ShowOutputMessage(L"Performance statistics written in ", path);
+		}
+
+		//-----------------------------------------------------------------------------
+		void WriteTrace(const cov::TraceRecorder& traceRecorder, const fs::path& path)
+		{
+			Tools::CreateParentFolderIfNeeded(path);
+			std::ofstream ofs{path};
+			traceRecorder.Write(ofs);
+			if (!ofs)
+			{
+				LOG_ERROR << L"Cannot write the trace in " << path.wstring();
+				return;
+			}
+			Tools::ShowOutputMessage(L"Trace written in ", path);
+		}
+
+		//-----------------------------------------------------------------------------
+		// Stop when the run ends.
+		int WatchLiveCounters(const std::string& name)
+		{
+			auto values = cov::LiveCounters::Read(name);
+			if (!values)
+			{
+				LOG_ERROR << L"No run publishes its counters as " << Tools::LocalToWString(name) << L".";
+				return FailureExitCode;
+			}
+
+			while (values->phase_ != cov::LiveCounters::Phase::Finished)
+			{
+				auto previousDebugEventCount = values->debugEventCount_;
+
+				std::this_thread::sleep_for(std::chrono::seconds{1});
+				values = cov::LiveCounters::Read(name);
+				if (!values)
+					break;
+				auto remainingBreakPointCount = (std::max)(values->armedBreakPointCount_,
+				                                           values->hitBreakPointCount_) - values->hitBreakPointCount_;
+				LOG_INFO << L"Phase: " << values->phase_
+				         << L", debug events per second: " << values->debugEventCount_ - previousDebugEventCount
+				         << L", breakpoints armed: " << values->armedBreakPointCount_
+				         << L", remaining: " << remainingBreakPointCount
+				         << L", lines covered: " << values->executedLineCount_
+				         << L", modules loaded: " << values->loadedModuleCount_;
+			}
+			return 0;
+		}
+
+		//-----------------------------------------------------------------------------
+		std::shared_ptr<const Tools::BlobCache> CreatePdbBlobCache(const cov::Options& options)
+		{
+			const auto* pdbCacheFolder = options.GetPdbCacheFolder();
+			const auto* cacheFolder = options.GetCacheFolder();
+
+			if (pdbCacheFolder)
+				return std::make_shared<Tools::BlobCache>(*pdbCacheFolder, 0);
+			if (cacheFolder)
+				return std::make_shared<Tools::BlobCache>(*cacheFolder, options.GetCacheMaxSize());
+			return nullptr;
+		}
+
+		//-----------------------------------------------------------------------------
+		std::shared_ptr<const cov::PdbCache> CreatePdbCache(
+		    const cov::Options& options,
+		    std::shared_ptr<const Tools::BlobCache> blobCache)
+		{
+			const auto* remoteStore = options.GetPdbCacheRemoteStore();
+
+			if (!blobCache)
+				return nullptr;
+			return std::make_shared<cov::PdbCache>(
+			    std::move(blobCache), remoteStore ? *remoteStore : L"");
+		}
+
+		//-----------------------------------------------------------------------------
+		std::shared_ptr<const cov::PdbCache> CreatePdbCache(const cov::Options& options)
+		{
+			return CreatePdbCache(options, CreatePdbBlobCache(options));
+		}
+
+		//-----------------------------------------------------------------------------
+		std::unique_ptr<CoverageResultCache> CreateResultCache(
+			const cov::Options& options,
+			const cov::StartInfo& startInfo)
+		{
+			if (!options.IsResultCacheModeEnabled())
+				return nullptr;
+
+			// The options print the command line of the program.
+			std::wostringstream ostr;
+			ostr << options;
+			return std::make_unique<CoverageResultCache>(
+				std::make_shared<Tools::BlobCache>(*options.GetCacheFolder(), options.GetCacheMaxSize()),
+				startInfo.GetPath(), ostr.str(), options.GetResultCacheInputs());
+		}
+
+		//-----------------------------------------------------------------------------
+		std::shared_ptr<cov::SymbolPrefetcher> CreateSymbolPrefetcher(const cov::Options& options)
+		{
+			const auto* symbolCacheFolder = options.GetSymbolCacheFolder();
+
+			if (!symbolCacheFolder)
+				return nullptr;
+			return std::make_shared<cov::SymbolPrefetcher>(
+			    options.GetSymbolServers(), *symbolCacheFolder, options.GetSymbolDownloadCount());
+		}
+
+		//-----------------------------------------------------------------------------
+		void InitRunCoverageSettings(
+		    const cov::Options& options,
+		    std::shared_ptr<const cov::CoverageBaseline> coverageBaseline,
+		    std::shared_ptr<cov::PerformanceStatistics> performanceStatistics,
+		    std::shared_ptr<cov::TraceRecorder> traceRecorder,
+		    std::shared_ptr<cov::LiveCounters> liveCounters,
+		    cov::RunCoverageSettings& runCoverageSettings)
+		{
+			size_t maxUnmatchPathsForWarning = (options.GetLogLevel() == cov::LogLevel::Verbose) 
+				? std::numeric_limits<size_t>::max() : 30;
+
+			runCoverageSettings.SetCoverChildren(options.IsCoverChildrenModeEnabled());
+			runCoverageSettings.SetContinueAfterCppException(options.IsContinueAfterCppExceptionModeEnabled());
+			runCoverageSettings.SetStopOnAssert(options.IsStopOnAssertModeEnabled());
+			runCoverageSettings.SetMaxUnmatchPathsForWarning(maxUnmatchPathsForWarning);
+			runCoverageSettings.SetOptimizedBuildSupport(options.IsOptimizedBuildSupportEnabled());
+			runCoverageSettings.SetInProcessAgent(options.IsInProcessAgentModeEnabled());
+			runCoverageSettings.SetBasicBlockBreakPoints(options.IsBasicBlockBreakPointsModeEnabled());
+			runCoverageSettings.SetDominatorBreakPoints(options.IsDominatorBreakPointsModeEnabled());
+			runCoverageSettings.SetEagerLineDisarm(options.IsEagerLineDisarmModeEnabled());
+			runCoverageSettings.SetLazyBreakPoints(options.IsLazyBreakPointsModeEnabled());
+			runCoverageSettings.SetPageGuardBreakPoints(options.IsPageGuardBreakPointsModeEnabled());
+			runCoverageSettings.SetCoverageLevel(options.GetCoverageLevel());
+			runCoverageSettings.SetSamplingTrapsPerSecond(options.GetSamplingTrapsPerSecond());
+			runCoverageSettings.SetAdaptiveArmingTrapsPerSecond(options.GetAdaptiveArmingTrapsPerSecond());
+			runCoverageSettings.SetAutoDetachSeconds(options.GetAutoDetachSeconds());
+			runCoverageSettings.SetAttachProcessId(options.GetAttachProcessId());
+			runCoverageSettings.SetDebugStringMode(options.GetDebugStringMode());
+			if (options.GetDebugStringsPath())
+				runCoverageSettings.SetDebugStringsPath(*options.GetDebugStringsPath());
+			if (options.GetRecordDebugEventsPath())
+				runCoverageSettings.SetRecordDebugEventsPath(*options.GetRecordDebugEventsPath());
+			if (options.GetReplayDebugEventsPath())
+				runCoverageSettings.SetReplayDebugEventsPath(*options.GetReplayDebugEventsPath());
+			if (options.GetChildPatterns())
+				runCoverageSettings.SetChildPatterns(*options.GetChildPatterns());
+			if (coverageBaseline)
+				runCoverageSettings.SetCoverageBaseline(coverageBaseline);
+			runCoverageSettings.SetCoverageRegionMarkers(options.IsCoverageRegionMarkersModeEnabled());
+			runCoverageSettings.SetFuzzing(options.IsFuzzingModeEnabled());
+			runCoverageSettings.SetIntelPt(options.IsIntelPtModeEnabled());
+			runCoverageSettings.SetTrampolines(options.IsTrampolinesModeEnabled());
+			runCoverageSettings.SetEtwSampling(options.IsEtwSamplingModeEnabled());
+			runCoverageSettings.SetDebugHeap(options.IsDebugHeapModeEnabled());
+			runCoverageSettings.SetAsyncModules(options.IsAsyncModulesModeEnabled());
+			// The modules loaded by the program are saved next to their lines.
+			auto pdbBlobCache = CreatePdbBlobCache(options);
+			runCoverageSettings.SetPdbCache(CreatePdbCache(options, pdbBlobCache));
+			runCoverageSettings.SetModuleLoadHistoryCache(pdbBlobCache);
+			runCoverageSettings.SetNativePdbReader(options.IsNativePdbReaderEnabled());
+			runCoverageSettings.SetIdenticalModulesMerged(options.IsIdenticalModulesMergeEnabled());
+			runCoverageSettings.SetSymbolPrefetcher(CreateSymbolPrefetcher(options));
+			runCoverageSettings.SetModuleTimeBudgetMilliseconds(options.GetModuleTimeBudgetMilliseconds());
+			runCoverageSettings.SetMemoryBudgetBytes(uint64_t{options.GetMemoryBudgetMegabytes()} * 1024 * 1024);
+			runCoverageSettings.SetExclusionMarkers(options.GetExclusionMarkers());
+			if (options.GetCoverageJournalPath())
+				runCoverageSettings.SetCoverageJournal(
+				    *options.GetCoverageJournalPath(), options.GetCoverageJournalSeconds());
+			runCoverageSettings.SetPerformanceStatistics(performanceStatistics);
+			runCoverageSettings.SetTraceRecorder(traceRecorder);
+			runCoverageSettings.SetLiveCounters(liveCounters);
+		}
+
+		//-----------------------------------------------------------------------------
+		// The cache records all the source files: none is needed here.
+		class IgnoreSourceFiles : public cov::IDebugInformationHandler
+		{
+		public:
+			//-------------------------------------------------------------------------
+			bool IsSourceFileSelected(const std::filesystem::path&) override
+			{
+				return false;
+			}
+
+			//-------------------------------------------------------------------------
+			void OnSourceFile(const std::filesystem::path&, const std::vector<Line>&) override
+			{
+			}
+		};
+
+		//-----------------------------------------------------------------------------
+		void IndexPdbs(const cov::Options& options)
+		{
+			std::vector<std::filesystem::path> modulePaths;
+			for (const auto& entry :
+			     std::filesystem::recursive_directory_iterator{*options.GetIndexedPdbsFolder()})
+			{
+				auto extension = boost::to_lower_copy(entry.path().extension().wstring());
+				if (entry.is_regular_file() && (extension == L".exe" || extension == L".dll"))
+					modulePaths.push_back(entry.path());
+			}
+
+			auto pdbCache = CreatePdbCache(options);
+			auto symbolPrefetcher = CreateSymbolPrefetcher(options);
+			if (symbolPrefetcher)
+				symbolPrefetcher->Prefetch(modulePaths);
+			auto jobCount = GetJobCount(options, modulePaths.size());
+			std::atomic<size_t> nextModule{0};
+			std::atomic<size_t> indexedModuleCount{0};
+			LOG_INFO << L"Index " << modulePaths.size() << L" modules with "
+			         << jobCount << L" jobs.";
+
+			// Each worker has its own DIA session.
+			auto indexModules = [&]() {
+				cov::DebugInformationEnumerator debugInformationEnumerator{
+				    options.GetSubstitutePdbSourcePaths(), pdbCache,
+				    options.IsNativePdbReaderEnabled(), symbolPrefetcher};
+				IgnoreSourceFiles ignoreSourceFiles;
+
+				for (size_t i = nextModule++; i < modulePaths.size(); i = nextModule++)
+				{
+					try
+					{
+						auto key = cov::PdbCache::GetKey(modulePaths[i]);
+						if (key && !pdbCache->Contains(*key) && !pdbCache->IsWithoutPdb(*key, modulePaths[i]) &&
+						    debugInformationEnumerator.Enumerate(modulePaths[i], ignoreSourceFiles))
+						{
+							++indexedModuleCount;
+							LOG_DEBUG << L"Index " << modulePaths[i].wstring();
+						}
+					}
+					catch (const std::exception& e)
+					{
+						LOG_WARNING << L"Cannot index " << modulePaths[i].wstring() << L": " << e.what();
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < jobCount; ++i)
+				workers.emplace_back(indexModules);
+			indexModules();
+			for (auto& worker : workers)
+				worker.join();
+			LOG_INFO << indexedModuleCount.load() << L" modules added to the PDB cache.";
+		}
+
+		//-----------------------------------------------------------------------------
+		int MeasureOverhead(const cov::Options& options,
+		                    std::shared_ptr<Tools::WarningManager> warningManager)
+		{
+			const auto& startInfo = *options.GetStartInfo();
+			auto runCount = *options.GetMeasureOverheadRunCount();
+			cov::OverheadReport overheadReport;
+
+			for (unsigned int i = 0; i < runCount; ++i)
+			{
+				cov::Process process{startInfo};
+				auto start = cov::OverheadReport::Clock::now();
+
+				process.Start(0);
+				WaitForSingleObject(process.GetProcessInformation().hProcess, INFINITE);
+				overheadReport.AddRun(L"Native", cov::OverheadReport::Clock::now() - start);
+			}
+
+			// Without selected module, no breakpoint is set: only the cost of the
+			// debugger remains.
+			cov::CoverageFilterSettings armNothingSettings{cov::Patterns{}, options.GetSourcePatterns()};
+			cov::CoverageFilterSettings coverageSettings{options.GetModulePatterns(), options.GetSourcePatterns()};
+			auto runCoverage = [&](const std::wstring& mode, const cov::CoverageFilterSettings& coverageFilterSettings) {
+				for (unsigned int i = 0; i < runCount; ++i)
+				{
+					auto performanceStatistics = std::make_shared<cov::PerformanceStatistics>();
+					cov::CodeCoverageRunner codeCoverageRunner{warningManager};
+					cov::RunCoverageSettings runCoverageSettings(
+					    startInfo,
+					    coverageFilterSettings,
+					    options.GetUnifiedDiffSettingsCollection(),
+					    options.GetExcludedLineRegexes(),
+					    options.GetSubstitutePdbSourcePaths());
+
+					InitRunCoverageSettings(
+					    options, nullptr, performanceStatistics, nullptr, nullptr, runCoverageSettings);
+					auto start = cov::OverheadReport::Clock::now();
+					codeCoverageRunner.RunCoverage(runCoverageSettings);
+					overheadReport.AddRun(mode, cov::OverheadReport::Clock::now() - start, performanceStatistics.get());
+				}
+			};
+			runCoverage(L"Arm nothing", armNothingSettings);
+			runCoverage(L"Coverage", coverageSettings);
+
+			std::wostringstream ostr;
+			ostr << std::endl << overheadReport;
+			LOG_INFO << L"Overhead:" << ostr.str();
+			return 0;
+		}
+
+		//-----------------------------------------------------------------------------
+		std::vector<Plugin::CoverageData> RunPrograms(
+		    const cov::Options& options,
+		    const cov::CoverageFilterSettings& coverageFilterSettings,
+		    std::shared_ptr<const cov::CoverageBaseline> coverageBaseline,
+		    std::shared_ptr<Tools::WarningManager> warningManager,
+		    std::shared_ptr<cov::DebugInformationCache> debugInformationCache,
+		    std::shared_ptr<Tools::SourceFileCache> sourceFileCache,
+		    std::shared_ptr<cov::PerformanceStatistics> performanceStatistics,
+		    std::shared_ptr<cov::TraceRecorder> traceRecorder,
+		    std::shared_ptr<cov::LiveCounters> liveCounters)
+		{
+			const auto& programs = options.GetPrograms();
+			auto jobCount = GetJobCount(options, programs.size());
+			LOG_INFO << L"Cover " << programs.size() << L" programs with "
+			         << jobCount << L" jobs.";
+
+			std::vector<std::unique_ptr<Plugin::CoverageData>> coverageDatas(programs.size());
+			std::vector<std::exception_ptr> errors(programs.size());
+			std::atomic<size_t> nextProgram{0};
+			if (!debugInformationCache)
+			{
+				debugInformationCache = std::make_shared<cov::DebugInformationCache>(
+				    options.GetSubstitutePdbSourcePaths(), CreatePdbCache(options),
+				    options.IsNativePdbReaderEnabled());
+			}
+
+			// A debugger receives only the events of the processes started by its
+			// thread: each worker runs its programs with its own runner.
+			auto runPrograms = [&]() {
+				for (size_t i = nextProgram++; i < programs.size(); i = nextProgram++)
+				{
+					try
+					{
+						cov::CodeCoverageRunner codeCoverageRunner{warningManager};
+						cov::RunCoverageSettings runCoverageSettings(
+						    programs[i],
+						    coverageFilterSettings,
+						    options.GetUnifiedDiffSettingsCollection(),
+						    options.GetExcludedLineRegexes(),
+						    options.GetSubstitutePdbSourcePaths());
+
+						InitRunCoverageSettings(
+						    options, coverageBaseline, performanceStatistics, traceRecorder, liveCounters, runCoverageSettings);
+						runCoverageSettings.SetDebugInformationCache(debugInformationCache);
+						runCoverageSettings.SetSourceFileCache(sourceFileCache);
+						coverageDatas[i] = std::make_unique<Plugin::CoverageData>(
+						    codeCoverageRunner.RunCoverage(runCoverageSettings));
+					}
+					catch (...)
+					{
+						errors[i] = std::current_exception();
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < jobCount; ++i)
+				workers.emplace_back(runPrograms);
+			runPrograms();
+			for (auto& worker : workers)
+				worker.join();
+
+			std::vector<Plugin::CoverageData> results;
+			for (size_t i = 0; i < programs.size(); ++i)
+			{
+				if (errors[i])
+					std::rethrow_exception(errors[i]);
+				if (auto exitCode = coverageDatas[i]->GetExitCode())
+				{
+					LOG_ERROR << programs[i].GetPath().wstring()
+					          << L" stop with error code: " << exitCode;
+				}
+				results.push_back(std::move(*coverageDatas[i]));
+			}
+			return results;
+		}
+
+		//-----------------------------------------------------------------------------
+		// debugInformationCache is nullptr when the modules of a single program
+		// are not cached.
 		int Run(const cov::Options& options,
 		        const Exporter::ExporterPluginManager& exporterPluginManager,
-		        std::shared_ptr<Tools::WarningManager> warningManager)
+		        std::shared_ptr<Tools::WarningManager> warningManager,
+		        std::shared_ptr<cov::DebugInformationCache> debugInformationCache)
 		{
 			InitLogger(options);
 
-			auto coveraDatas = LoadInputCoverageDatas(options);
-			const auto* startInfo = options.GetStartInfo();
-			
+			if (options.GetSelectTestsIndexPath())
+			{
+				SelectTests(options);
+				return 0;
+			}
+			if (options.GetCompareCoverageOutputPath())
+			{
+				CompareCoverages(options);
+				return 0;
+			}
+			if (const auto* sectionName = options.GetExportPluginHostSectionName())
+			{
+				ExportFromSharedCoverage(*sectionName, options.GetExports(), exporterPluginManager);
+				return 0;
+			}
+			if (options.GetQueryServiceName())
+			{
+				ServeCoverageQueries(*options.GetQueryServiceName(), options.GetInputCoveragePaths().front());
+				return 0;
+			}
+			if (options.GetLineTablePath())
+			{
+				WriteLineTable(options);
+				return 0;
+			}
+			if (options.GetIndexedPdbsFolder())
+			{
+				IndexPdbs(options);
+				return 0;
+			}
+			if (options.GetWatchName())
+				return WatchLiveCounters(*options.GetWatchName());
+			if (options.GetMeasureOverheadRunCount())
+				return MeasureOverhead(options, warningManager);
+
 			std::wostringstream ostr;
 			ostr << std::endl << options;
 			LOG_INFO << L"Start Program:" << ostr.str();
 
+			std::shared_ptr<cov::PerformanceStatistics> performanceStatistics;
+			if (options.GetPerfStatsPath())
+				performanceStatistics = std::make_shared<cov::PerformanceStatistics>();
+			Tools::ScopedAction writePerformanceStatistics{[&]() {
+				if (performanceStatistics)
+					WritePerformanceStatistics(*performanceStatistics, *options.GetPerfStatsPath());
+			}};
+			// The time to reach the run, from the loading of the executable
+			// to the parsing of the options. A service has started long before.
+			if (performanceStatistics && !debugInformationCache)
+				performanceStatistics->AddPhase("Startup", cov::PerformanceStatistics::GetProcessUpTime());
+			cov::PerformanceStatistics::ScopedPhase runPhase{performanceStatistics.get(), "Total"};
+
+			std::shared_ptr<cov::TraceRecorder> traceRecorder;
+			if (options.GetTraceOutputPath())
+				traceRecorder = std::make_shared<cov::TraceRecorder>();
+			Tools::ScopedAction writeTrace{[&]() {
+				if (traceRecorder)
+					WriteTrace(*traceRecorder, *options.GetTraceOutputPath());
+			}};
+
+			std::shared_ptr<cov::LiveCounters> liveCounters;
+			if (options.GetLiveCountersName())
+				liveCounters = std::make_shared<cov::LiveCounters>(*options.GetLiveCountersName());
+			auto setLiveCountersPhase = [&](cov::LiveCounters::Phase phase) {
+				if (liveCounters)
+					liveCounters->SetPhase(phase);
+			};
+			Tools::ScopedAction finishLiveCounters{[&]() {
+				setLiveCountersPhase(cov::LiveCounters::Phase::Finished);
+			}};
+
+			if (auto coverageSummary = LoadInputCoverageSummary(options))
+				return GetRunExitCode(options, ExportSummary(options, *coverageSummary), 0);
+
+			std::vector<Plugin::CoverageData> coveraDatas;
+			{
+				cov::PerformanceStatistics::ScopedPhase phase{performanceStatistics.get(), "Input coverage loading"};
+				cov::TraceRecorder::ScopedSpan span{traceRecorder.get(), "Input coverage loading", "run"};
+				coveraDatas = LoadInputCoverageDatas(options);
+			}
+			cov::PerformanceStatistics::MemoryTracker coverageDataMemory{performanceStatistics.get(), "Coverage data"};
+			auto updateCoverageDataMemory = [&]() {
+				if (!performanceStatistics)
+					return;
+				uint64_t bytes = 0;
+				for (const auto& coverageData : coveraDatas)
+					bytes += cov::PerformanceStatistics::GetMemoryUsage(coverageData);
+				coverageDataMemory.Update(bytes);
+			};
+			updateCoverageDataMemory();
+			const auto* startInfo = options.GetStartInfo();
+
+			// The sources read by the line filters are exported from the same mappings.
+			auto sourceFileCache = std::make_shared<Tools::SourceFileCache>();
 			cov::CodeCoverageRunner codeCoverageRunner{ warningManager };
 			cov::CoverageFilterSettings coverageFilterSettings{ options.GetModulePatterns(), options.GetSourcePatterns() };
 			auto exitCode = 0;
 
-			if (startInfo)
+			std::shared_ptr<const cov::CoverageBaseline> coverageBaseline;
+			if (options.IsBaselineArmingModeEnabled())
+			{
+				auto baseline = std::make_shared<cov::CoverageBaseline>(coveraDatas);
+				LOG_INFO << L"Coverage baseline: "
+				         << baseline->GetExecutedLineCount()
+				         << L" executed lines.";
+				coverageBaseline = baseline;
+			}
+
+			setLiveCountersPhase(cov::LiveCounters::Phase::Running);
+			// The shards of --shards also keep the start info.
+			if (!options.GetPrograms().empty())
 			{
-				size_t maxUnmatchPathsForWarning = (options.GetLogLevel() == cov::LogLevel::Verbose) 
-					? std::numeric_limits<size_t>::max() : 30;
+				auto programCoverageDatas = RunPrograms(options,
+				                                        coverageFilterSettings,
+				                                        coverageBaseline,
+				                                        warningManager,
+				                                        debugInformationCache,
+				                                        sourceFileCache,
+				                                        performanceStatistics,
+				                                        traceRecorder,
+				                                        liveCounters);
 
+				for (auto& coverageData : programCoverageDatas)
+				{
+					if (!exitCode)
+						exitCode = coverageData.GetExitCode();
+					coveraDatas.push_back(std::move(coverageData));
+				}
+			}
+			else if (startInfo)
+			{
 				cov::RunCoverageSettings runCoverageSettings(
 				    *startInfo,
 				    coverageFilterSettings,
@@ -177,76 +1296,197 @@ namespace OpenCppCoverage
 				    options.GetExcludedLineRegexes(),
 				    options.GetSubstitutePdbSourcePaths());
 
-				runCoverageSettings.SetCoverChildren(options.IsCoverChildrenModeEnabled());
-				runCoverageSettings.SetContinueAfterCppException(options.IsContinueAfterCppExceptionModeEnabled());
-                runCoverageSettings.SetStopOnAssert(options.IsStopOnAssertModeEnabled());
-                runCoverageSettings.SetMaxUnmatchPathsForWarning(maxUnmatchPathsForWarning);
-				runCoverageSettings.SetOptimizedBuildSupport(options.IsOptimizedBuildSupportEnabled());
-				auto coverageData = codeCoverageRunner.RunCoverage(runCoverageSettings);
-				exitCode = coverageData.GetExitCode();
-				coveraDatas.push_back(std::move(coverageData));
+				InitRunCoverageSettings(
+				    options, coverageBaseline, performanceStatistics, traceRecorder, liveCounters, runCoverageSettings);
+				runCoverageSettings.SetDebugInformationCache(debugInformationCache);
+				runCoverageSettings.SetSourceFileCache(sourceFileCache);
+				std::shared_ptr<cov::TestImpactIndex> testImpactIndex;
+				if (options.GetTestImpactIndexPath())
+				{
+					testImpactIndex = std::make_shared<cov::TestImpactIndex>();
+					runCoverageSettings.SetTestImpactIndex(testImpactIndex);
+				}
+				auto resultCache = CreateResultCache(options, *startInfo);
+				boost::optional<Plugin::CoverageData> cachedCoverageData;
+				if (resultCache)
+					cachedCoverageData = resultCache->Find();
+				if (cachedCoverageData)
+				{
+					LOG_INFO << L"The program and its modules did not change: the cached coverage is used.";
+					exitCode = cachedCoverageData->GetExitCode();
+					coveraDatas.push_back(std::move(*cachedCoverageData));
+				}
+				// Only the line counts are needed: the coverage data is not created.
+				else if (!resultCache && coveraDatas.empty() && !options.IsAggregateByFileModeEnabled() &&
+				         IsSummaryExportOnly(options))
+				{
+					auto coverageSummary = codeCoverageRunner.RunCoverageSummary(runCoverageSettings);
+					if (testImpactIndex)
+						testImpactIndex->Write(*options.GetTestImpactIndexPath());
+					return GetRunExitCode(options,
+					                      ExportSummary(options, coverageSummary),
+					                      coverageSummary.GetExitCode());
+				}
+				// The binary files are written from the collected coverage: the
+				// coverage data is not created.
+				else if (!resultCache && coveraDatas.empty() && !options.IsAggregateByFileModeEnabled() &&
+				         !options.IsDeterministicModeEnabled() && !options.GetSourceServerCacheFolder() &&
+				         IsBinaryExportOnly(options))
+				{
+					auto coverageSummary = codeCoverageRunner.RunCoverage(
+					    runCoverageSettings,
+					    [&](const cov::ICoverageSource& coverageSource) { ExportBinary(options, coverageSource); });
+					if (testImpactIndex)
+						testImpactIndex->Write(*options.GetTestImpactIndexPath());
+					return GetRunExitCode(options, coverageSummary.GetCoverageRate(), coverageSummary.GetExitCode());
+				}
+				else
+				{
+					auto coverageData = codeCoverageRunner.RunCoverage(runCoverageSettings);
+					if (testImpactIndex)
+						testImpactIndex->Write(*options.GetTestImpactIndexPath());
+					if (resultCache)
+						resultCache->Write(coverageData);
+					exitCode = coverageData.GetExitCode();
+					coveraDatas.push_back(std::move(coverageData));
+				}
 			}
+			updateCoverageDataMemory();
+			setLiveCountersPhase(cov::LiveCounters::Phase::Merging);
 			cov::CoverageDataMerger	coverageDataMerger;
+			auto mergeStart = cov::PerformanceStatistics::Clock::now();
+			auto mergeCpuStart = cov::PerformanceStatistics::GetProcessCpuTime();
 
-			auto coverageData = coverageDataMerger.Merge(coveraDatas);
+			auto coverageData = coverageDataMerger.Merge(std::move(coveraDatas));
 
 			if (options.IsAggregateByFileModeEnabled())
 				coverageDataMerger.MergeFileCoverage(coverageData);
+			// The modules and the files are already sorted by path.
+			if (options.IsDeterministicModeEnabled())
+				coverageDataMerger.RemoveFirstHits(coverageData);
+			if (performanceStatistics)
+			{
+				coverageDataMemory.Update(cov::PerformanceStatistics::GetMemoryUsage(coverageData));
+				performanceStatistics->AddPhase("Merge",
+				                                cov::PerformanceStatistics::Clock::now() - mergeStart,
+				                                cov::PerformanceStatistics::GetProcessCpuTime() - mergeCpuStart);
+			}
+			if (traceRecorder)
+				traceRecorder->AddSpan("Merge", "run", {}, mergeStart, cov::PerformanceStatistics::Clock::now() - mergeStart);
 
-			Export(options, exporterPluginManager, coverageData);
+			setLiveCountersPhase(cov::LiveCounters::Phase::Exporting);
+			if (const auto* sourceServerCacheFolder = options.GetSourceServerCacheFolder())
+			{
+				cov::PerformanceStatistics::ScopedPhase phase{performanceStatistics.get(), "Source server fetch"};
+				cov::SourceServerFetcher{*sourceServerCacheFolder, options.GetSourceServerCommands()}.Fetch(coverageData, *sourceFileCache);
+			}
+			auto coverageRate = Export(options, exporterPluginManager, coverageData, sourceFileCache,
+			                           performanceStatistics.get(), traceRecorder.get());
 			LOG_INFO << L"The code coverage report is not what you expect? See the FAQ "
 				L"https://github.com/OpenCppCoverage/OpenCppCoverage/wiki/FAQ.";
 
-			if (exitCode)
-				LOG_ERROR << L"Your program stop with error code: " << exitCode;
-			return exitCode;
+			return GetRunExitCode(options, coverageRate, exitCode);
 		}
-	}
 
-	//-----------------------------------------------------------------------------
-	int OpenCppCoverage::Run(int argc,
-	                         const char** argv,
-	                         std::wostream* emptyOptionsExplanation) const
-	{
-		auto warningManager = std::make_shared<Tools::WarningManager>();
-		std::vector<std::unique_ptr<cov::IOptionParser>> optionParsers;
+		//-----------------------------------------------------------------------------
+		// serviceCache is set when the command line is run by the service.
+		int RunCommandLine(int argc,
+		                   const char** argv,
+		                   std::wostream* emptyOptionsExplanation,
+		                   std::shared_ptr<cov::DebugInformationCache> serviceCache)
+		{
+			auto warningManager = std::make_shared<Tools::WarningManager>();
+			std::vector<std::unique_ptr<cov::IOptionParser>> optionParsers;
 
-		Exporter::ExporterPluginManager exporterPluginManager{
-		    Exporter::PluginLoader<Plugin::IExportPlugin>{},
-		    GetPluginsExportFolder()};
+			Exporter::ExporterPluginManager exporterPluginManager{
+			    std::make_shared<Exporter::PluginLoader<Plugin::IExportPlugin>>(),
+			    GetPluginsExportFolder()};
 
-		auto exportPluginDescriptions =
-		    exporterPluginManager.CreateExportPluginDescriptions();
-		optionParsers.push_back(std::make_unique<cov::ExportOptionParser>(
-		    std::move(exportPluginDescriptions)));
-		cov::OptionsParser optionsParser{warningManager, std::move(optionParsers)};
+			auto exportPluginDescriptions =
+			    exporterPluginManager.CreateExportPluginDescriptions();
+			optionParsers.push_back(std::make_unique<cov::ExportOptionParser>(
+			    std::move(exportPluginDescriptions)));
+			cov::OptionsParser optionsParser{warningManager, std::move(optionParsers)};
 
-		auto options = optionsParser.Parse(argc, argv, emptyOptionsExplanation);
-		auto status = FailureExitCode;
+			auto options = optionsParser.Parse(argc, argv, emptyOptionsExplanation);
+			auto status = FailureExitCode;
 
-		if (options)
-		{
-			try
-			{
-				status = ::OpenCppCoverage::Run(*options, exporterPluginManager, warningManager);
-			}
-			catch (const std::exception& e)
-			{
-				LOG_ERROR << "Error: " << e.what();
-			}
-			catch (...)
+			if (options)
 			{
-				LOG_ERROR << "Unkown Error";
-			}
+				try
+				{
+					// The pool is created by its first use: a service keeps
+					// the thread count of its own command line.
+					Tools::ThreadPool::SetDefaultThreadCount(options->GetThreadCount());
+					if (options->IsThreadPlacementEnabled())
+					{
+						// The debug loop runs on this thread.
+						std::shared_ptr<const Tools::ThreadPlacement> threadPlacement =
+							Tools::ThreadPlacement::CreateFromSystem();
 
-			warningManager->DisplayWarnings();
-			if (options->IsPlugingModeEnabled())
-			{
-				std::cout << "Press any key to continue... ";
-				std::cin.get();
+						Tools::ThreadPool::SetDefaultThreadPlacement(threadPlacement);
+						threadPlacement->PlaceDebugLoopThread();
+					}
+					if (const auto* machineSymbolLoadCount = options->GetMachineSymbolLoadCount())
+						cov::SymbolLoadThrottle::SetMachineConcurrency(*machineSymbolLoadCount);
+					if (serviceCache && options->GetServiceName())
+						LOG_ERROR << L"A service cannot be started by a service.";
+					else if (options->GetServiceName())
+					{
+						InitLogger(*options);
+						// The substitutions of the service are used for all the requests.
+						auto debugInformationCache = std::make_shared<cov::DebugInformationCache>(
+						    options->GetSubstitutePdbSourcePaths(), CreatePdbCache(*options),
+						    options->IsNativePdbReaderEnabled());
+						ServeCoverageRequests(
+						    *options->GetServiceName(),
+						    [&](const std::vector<std::string>& arguments) {
+							    std::vector<const char*> requestArgv;
+							    for (const auto& argument : arguments)
+								    requestArgv.push_back(argument.c_str());
+							    return RunCommandLine(static_cast<int>(requestArgv.size()),
+							                          requestArgv.data(),
+							                          emptyOptionsExplanation,
+							                          debugInformationCache);
+						    });
+					}
+					else if (!serviceCache && options->GetUsedServiceName())
+						status = SubmitCoverageRequest(*options->GetUsedServiceName(), argc, argv);
+					else
+						status = Run(*options, exporterPluginManager, warningManager, serviceCache);
+				}
+				catch (const std::exception& e)
+				{
+					LOG_ERROR << "Error: " << e.what();
+				}
+				catch (...)
+				{
+					LOG_ERROR << "Unkown Error";
+				}
+
+				warningManager->DisplayWarnings();
+				Tools::FlushLog();
+				if (options->IsPlugingModeEnabled() && !serviceCache)
+				{
+					std::cout << "Press any key to continue... ";
+					std::cin.get();
+				}
 			}
+
+			return status;
 		}
+	}
+
+	//-----------------------------------------------------------------------------
+	int OpenCppCoverage::Run(int argc,
+	                         const char** argv,
+	                         std::wostream* emptyOptionsExplanation) const
+	{
+		cov::EtwProvider etwProvider;
+		auto exitCode = RunCommandLine(argc, argv, emptyOptionsExplanation, nullptr);
 
-		return status;
+		// Write the pending records before the process exits.
+		Tools::FlushLog();
+		return exitCode;
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,204 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "PluginProcesses.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <Windows.h>
+
+#include "CppCoverage/CppCoverageException.hpp"
+#include "CppCoverage/ExportOptionParser.hpp"
+#include "CppCoverage/OptionsExport.hpp"
+#include "CppCoverage/ProgramOptions.hpp"
+#include "Exporter/Plugin/ExporterPluginManager.hpp"
+#include "Exporter/Plugin/SharedCoverageSection.hpp"
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/CoverageDataView.hpp"
+#include "Tools/Log.hpp"
+#include "Tools/Tool.hpp"
+
+namespace cov = CppCoverage;
+
+namespace OpenCppCoverage
+{
+	namespace
+	{
+		// All the exports must end before: a plugin which hangs does not
+		// block the run.
+		const auto ExportTimeout = std::chrono::hours{1};
+
+		//---------------------------------------------------------------------
+		// Quote the argument like CommandLineToArgvW expects it.
+		std::wstring QuoteArgument(const std::wstring& argument)
+		{
+			std::wstring quotedArgument = L"\"";
+			size_t backslashCount = 0;
+
+			for (auto c : argument)
+			{
+				if (c == L'\\')
+				{
+					++backslashCount;
+					continue;
+				}
+				// The backslashes before a quote are escaped.
+				quotedArgument.append(c == L'"' ? backslashCount * 2 + 1 : backslashCount, L'\\');
+				quotedArgument += c;
+				backslashCount = 0;
+			}
+			quotedArgument.append(backslashCount * 2, L'\\');
+			return quotedArgument + L'"';
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring GetOption(const std::string& option)
+		{
+			return L" --" + Tools::LocalToWString(option) + L' ';
+		}
+
+		//---------------------------------------------------------------------
+		std::wstring CreateCommandLine(const std::wstring& sectionName,
+		                               const cov::OptionsExport& optionsExport)
+		{
+			std::vector<wchar_t> executablePath(MAX_PATH);
+
+			while (GetModuleFileNameW(nullptr, executablePath.data(), static_cast<DWORD>(executablePath.size())) ==
+			       executablePath.size())
+			{
+				executablePath.resize(executablePath.size() * 2);
+			}
+
+			auto exportType = optionsExport.GetName();
+			if (const auto& parameter = optionsExport.GetParameter())
+				exportType += cov::ExportOptionParser::ExportSeparator + *parameter;
+
+			auto commandLine = QuoteArgument(executablePath.data());
+			commandLine += GetOption(cov::ProgramOptions::ExportPluginHostOption) + QuoteArgument(sectionName);
+			commandLine += GetOption(cov::ExportOptionParser::ExportTypeOption) + QuoteArgument(exportType);
+			if (!Tools::IsLogSeverityEnabled(boost::log::trivial::info))
+				commandLine += GetOption(cov::ProgramOptions::QuietOption);
+			else if (Tools::IsLogSeverityEnabled(boost::log::trivial::debug))
+				commandLine += GetOption(cov::ProgramOptions::VerboseOption);
+			return commandLine;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	struct PluginProcesses::PluginProcess
+	{
+		std::wstring pluginName_;
+		HANDLE hProcess_;
+	};
+
+	//-------------------------------------------------------------------------
+	PluginProcesses::PluginProcesses(const Plugin::CoverageData& coverageData,
+	                                 const std::vector<const cov::OptionsExport*>& exports)
+	    : sharedCoverageSection_{Exporter::SharedCoverageSection::Create(coverageData)}
+	{
+		for (const auto* optionsExport : exports)
+		{
+			auto command = CreateCommandLine(sharedCoverageSection_->GetName(), *optionsExport);
+			std::vector<wchar_t> commandLine{command.begin(), command.end()};
+			commandLine.push_back(L'\0');
+			STARTUPINFOW startupInfo{};
+			startupInfo.cb = sizeof(startupInfo);
+			PROCESS_INFORMATION processInformation{};
+
+			LOG_DEBUG << L"Start the plugin process: " << command;
+			// The plugin processes write in the console of the run.
+			if (!CreateProcessW(nullptr, commandLine.data(), nullptr, nullptr, FALSE,
+			                    0, nullptr, nullptr, &startupInfo, &processInformation))
+			{
+				LOG_ERROR << L"Cannot start the process of the plugin " << optionsExport->GetName()
+				          << L": " << cov::GetErrorMessage(GetLastError());
+				pluginProcesses_.push_back({optionsExport->GetName(), nullptr});
+				continue;
+			}
+			CloseHandle(processInformation.hThread);
+			pluginProcesses_.push_back({optionsExport->GetName(), processInformation.hProcess});
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	PluginProcesses::~PluginProcesses()
+	{
+		// The processes keep their own mapping of the section.
+		for (const auto& pluginProcess : pluginProcesses_)
+		{
+			if (pluginProcess.hProcess_)
+				CloseHandle(pluginProcess.hProcess_);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void PluginProcesses::Wait()
+	{
+		size_t failureCount = 0;
+		auto deadline = std::chrono::steady_clock::now() + ExportTimeout;
+
+		for (auto& pluginProcess : pluginProcesses_)
+		{
+			DWORD exitCode = 0;
+
+			if (!pluginProcess.hProcess_)
+			{
+				++failureCount;
+				continue;
+			}
+
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+			    deadline - std::chrono::steady_clock::now());
+			auto timeout = static_cast<DWORD>((std::max)(remaining.count(), 0ll));
+			if (WaitForSingleObject(pluginProcess.hProcess_, timeout) == WAIT_TIMEOUT)
+			{
+				LOG_ERROR << L"The export of the plugin " << pluginProcess.pluginName_
+				          << L" did not end in time: its process is terminated.";
+				TerminateProcess(pluginProcess.hProcess_, 1);
+				WaitForSingleObject(pluginProcess.hProcess_, INFINITE);
+			}
+			if (!GetExitCodeProcess(pluginProcess.hProcess_, &exitCode) || exitCode != 0)
+			{
+				LOG_ERROR << L"The export of the plugin " << pluginProcess.pluginName_
+				          << L" failed with the exit code " << exitCode << L'.';
+				++failureCount;
+			}
+			CloseHandle(pluginProcess.hProcess_);
+			pluginProcess.hProcess_ = nullptr;
+		}
+		if (failureCount)
+			THROW(failureCount << L" plugin exports failed.");
+	}
+
+	//-------------------------------------------------------------------------
+	void ExportFromSharedCoverage(const std::wstring& sectionName,
+	                              const std::vector<cov::OptionsExport>& exports,
+	                              const Exporter::ExporterPluginManager& exporterPluginManager)
+	{
+		auto sharedCoverageSection = Exporter::SharedCoverageSection::Open(sectionName);
+		auto coverageData = sharedCoverageSection->Read();
+		Plugin::CoverageDataView coverageDataView{coverageData};
+
+		for (const auto& optionsExport : exports)
+		{
+			if (optionsExport.GetType() != cov::OptionsExportType::Plugin)
+				THROW(L"--" << Tools::LocalToWString(cov::ProgramOptions::ExportPluginHostOption)
+				            << L" supports only the export plugins.");
+			exporterPluginManager.Export(optionsExport.GetName(), coverageDataView, optionsExport.GetParameter());
+		}
+	}
+}
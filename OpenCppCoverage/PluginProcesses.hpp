@@ -0,0 +1,73 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Plugin
+{
+	class CoverageData;
+}
+
+namespace CppCoverage
+{
+	class OptionsExport;
+}
+
+namespace Exporter
+{
+	class ExporterPluginManager;
+	class SharedCoverageSection;
+}
+
+namespace OpenCppCoverage
+{
+	// Run each plugin export in its own OpenCppCoverage process started with
+	// --export_plugin_host. The coverage is written once in a shared memory
+	// section mapped read-only by all the processes: the plugins export in
+	// parallel and the failure of a plugin, even a crash, does not stop the
+	// other exports.
+	class PluginProcesses
+	{
+	public:
+		// Start the processes, the exports must be plugin exports.
+		PluginProcesses(const Plugin::CoverageData&,
+		                const std::vector<const CppCoverage::OptionsExport*>&);
+		~PluginProcesses();
+
+		// Wait for the end of the processes and throw if an export failed.
+		// A process still running after an hour is terminated.
+		void Wait();
+
+	private:
+		PluginProcesses(const PluginProcesses&) = delete;
+		PluginProcesses& operator=(const PluginProcesses&) = delete;
+
+		struct PluginProcess;
+
+		std::unique_ptr<Exporter::SharedCoverageSection> sharedCoverageSection_;
+		std::vector<PluginProcess> pluginProcesses_;
+	};
+
+	// Perform the plugin exports from the shared memory section sectionName,
+	// in the process started by PluginProcesses.
+	void ExportFromSharedCoverage(const std::wstring& sectionName,
+	                              const std::vector<CppCoverage::OptionsExport>&,
+	                              const Exporter::ExporterPluginManager&);
+}
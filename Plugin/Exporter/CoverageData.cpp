@@ -25,6 +25,7 @@ namespace Plugin
 	CoverageData::CoverageData(const std::wstring& name, int exitCode)
 		: name_(name)
 		, exitCode_(exitCode)
+		, isSampled_(false)
 	{
 	}
 
@@ -47,6 +48,7 @@ namespace Plugin
 			std::swap(modules_, coverageData.modules_);
 			name_ = coverageData.name_;
 			exitCode_ = coverageData.exitCode_;
+			isSampled_ = coverageData.isSampled_;
 		}
 		return *this;
 	}
@@ -59,6 +61,12 @@ namespace Plugin
 		return *modules_.back();
 	}
 
+	//-------------------------------------------------------------------------
+	void CoverageData::ReserveModules(size_t count)
+	{
+		modules_.reserve(count);
+	}
+
 	//-------------------------------------------------------------------------	
 	void CoverageData::SetName(const std::wstring& name)
 	{
@@ -71,6 +79,12 @@ namespace Plugin
 		exitCode_ = exitCode;
 	}
 
+	//-------------------------------------------------------------------------
+	void CoverageData::SetSampled(bool isSampled)
+	{
+		isSampled_ = isSampled;
+	}
+
 	//-------------------------------------------------------------------------
 	const CoverageData::T_ModuleCoverageCollection& CoverageData::GetModules() const
 	{
@@ -88,5 +102,11 @@ namespace Plugin
 	{
 		return exitCode_;
 	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageData::IsSampled() const
+	{
+		return isSampled_;
+	}
 }
 
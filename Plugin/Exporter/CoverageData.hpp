@@ -39,13 +39,20 @@ namespace Plugin
 		CoverageData(CoverageData&&);			
 		CoverageData& operator=(CoverageData&&);
 		ModuleCoverage& AddModule(const std::filesystem::path& name);
+		// Avoid reallocations when the number of modules is known.
+		void ReserveModules(size_t count);
 		
 		void SetName(const std::wstring&);
 		void SetExitCode(int);
+		// The executed lines were observed by sampling the instruction
+		// pointers: a line not executed may have run and the hit counts are
+		// the numbers of samples.
+		void SetSampled(bool);
 
 		const T_ModuleCoverageCollection& GetModules() const;
 		const std::wstring& GetName() const;
 		int GetExitCode() const;
+		bool IsSampled() const;
 
 	private:
 		CoverageData(const CoverageData&) = delete;
@@ -55,6 +62,7 @@ namespace Plugin
 		T_ModuleCoverageCollection modules_;
 		std::wstring name_;
 		int exitCode_;
+		bool isSampled_;
 	};
 }
 
@@ -0,0 +1,149 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "CoverageDataView.hpp"
+
+#include <unordered_map>
+
+#include "CoverageData.hpp"
+#include "ModuleCoverage.hpp"
+#include "FileCoverage.hpp"
+
+namespace Plugin
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class PathInterner
+		{
+		public:
+			explicit PathInterner(std::vector<std::string>& paths)
+				: paths_{ paths }
+			{
+			}
+
+			size_t Intern(const std::filesystem::path& path)
+			{
+				auto it = indexes_.emplace(path.native(), paths_.size());
+
+				if (it.second)
+					paths_.push_back(path.u8string());
+				return it.first->second;
+			}
+
+		private:
+			std::vector<std::string>& paths_;
+			std::unordered_map<std::filesystem::path::string_type, size_t> indexes_;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	CoverageDataView::CoverageDataView(const CoverageData& coverageData)
+		: coverageData_{ coverageData }
+		, executedLineCount_{ 0 }
+	{
+		PathInterner pathInterner{ paths_ };
+		size_t fileCount = 0;
+		size_t lineCount = 0;
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			fileCount += module->GetFiles().size();
+			for (const auto& file : module->GetFiles())
+				lineCount += file->GetLines().size();
+		}
+		modules_.reserve(coverageData.GetModules().size());
+		files_.reserve(fileCount);
+		lineNumbers_.reserve(lineCount);
+		executedLines_.resize((lineCount + 63) / 64);
+
+		for (const auto& module : coverageData.GetModules())
+		{
+			Module moduleView{ pathInterner.Intern(module->GetPath()), files_.size(), module->GetFiles().size(), 0, 0 };
+
+			for (const auto& file : module->GetFiles())
+			{
+				const auto& lines = file->GetLines();
+				File fileView{ pathInterner.Intern(file->GetPath()), lineNumbers_.size(), lines.size(), 0 };
+
+				for (const auto& line : lines)
+				{
+					if (line.HasBeenExecuted())
+					{
+						auto index = lineNumbers_.size();
+						executedLines_[index / 64] |= uint64_t{ 1 } << (index % 64);
+						++fileView.executedLineCount_;
+					}
+					lineNumbers_.push_back(line.GetLineNumber());
+				}
+				moduleView.lineCount_ += fileView.lineCount_;
+				moduleView.executedLineCount_ += fileView.executedLineCount_;
+				files_.push_back(fileView);
+			}
+			executedLineCount_ += moduleView.executedLineCount_;
+			modules_.push_back(moduleView);
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const CoverageData& CoverageDataView::GetCoverageData() const
+	{
+		return coverageData_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::string>& CoverageDataView::GetPaths() const
+	{
+		return paths_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<CoverageDataView::Module>& CoverageDataView::GetModules() const
+	{
+		return modules_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<CoverageDataView::File>& CoverageDataView::GetFiles() const
+	{
+		return files_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<unsigned int>& CoverageDataView::GetLineNumbers() const
+	{
+		return lineNumbers_;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::vector<uint64_t>& CoverageDataView::GetExecutedLines() const
+	{
+		return executedLines_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool CoverageDataView::IsExecuted(size_t line) const
+	{
+		return ((executedLines_.at(line / 64) >> (line % 64)) & 1) != 0;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t CoverageDataView::GetExecutedLineCount() const
+	{
+		return executedLineCount_;
+	}
+}
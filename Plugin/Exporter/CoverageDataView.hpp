@@ -0,0 +1,86 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../PluginExport.hpp"
+
+namespace Plugin
+{
+	class CoverageData;
+
+	// Read-only columnar copy of a CoverageData built once for all the export
+	// plugins. The paths are interned in UTF-8 and the lines of all the files
+	// are stored in single arrays.
+	class PLUGIN_DLL CoverageDataView
+	{
+	public:
+		struct Module
+		{
+			// Index in GetPaths.
+			size_t path_;
+			// The files of the module are [firstFile_, firstFile_ + fileCount_) in GetFiles.
+			size_t firstFile_;
+			size_t fileCount_;
+			size_t lineCount_;
+			size_t executedLineCount_;
+		};
+
+		struct File
+		{
+			// Index in GetPaths.
+			size_t path_;
+			// The lines of the file are [firstLine_, firstLine_ + lineCount_) in
+			// GetLineNumbers, sorted by line number.
+			size_t firstLine_;
+			size_t lineCount_;
+			size_t executedLineCount_;
+		};
+
+	public:
+		explicit CoverageDataView(const CoverageData&);
+
+		const CoverageData& GetCoverageData() const;
+
+		// A path used by several modules or files is stored once.
+		const std::vector<std::string>& GetPaths() const;
+		const std::vector<Module>& GetModules() const;
+		const std::vector<File>& GetFiles() const;
+		const std::vector<unsigned int>& GetLineNumbers() const;
+		// The line i is executed when the bit i % 64 of GetExecutedLines()[i / 64] is set.
+		const std::vector<uint64_t>& GetExecutedLines() const;
+		bool IsExecuted(size_t line) const;
+
+		size_t GetExecutedLineCount() const;
+
+	private:
+		CoverageDataView(const CoverageDataView&) = delete;
+		CoverageDataView& operator=(const CoverageDataView&) = delete;
+
+	private:
+		const CoverageData& coverageData_;
+		std::vector<std::string> paths_;
+		std::vector<Module> modules_;
+		std::vector<File> files_;
+		std::vector<unsigned int> lineNumbers_;
+		std::vector<uint64_t> executedLines_;
+		size_t executedLineCount_;
+	};
+}
@@ -16,39 +16,108 @@
 
 #include "stdafx.h"
 #include <string>
+#include <algorithm>
+#include <memory>
 #include "FileCoverage.hpp"
 
 namespace Plugin
 {
+	namespace
+	{
+		//---------------------------------------------------------------------
+		template <typename Lines>
+		auto LowerBound(Lines& lines, unsigned int lineNumber)
+		{
+			return std::lower_bound(lines.begin(), lines.end(), lineNumber,
+				[](const LineCoverage& line, unsigned int value) {
+					return line.GetLineNumber() < value;
+				});
+		}
+	}
+
 	//-------------------------------------------------------------------------
 	FileCoverage::FileCoverage(const std::filesystem::path& path)
 		: path_(path)
+		, lines_{ std::make_shared<Lines>() }
 	{
 	}
 
 	//-------------------------------------------------------------------------
-	void FileCoverage::AddLine(unsigned int lineNumber, bool hasBeenExecuted)
+	void FileCoverage::AddLine(unsigned int lineNumber,
+	                           bool hasBeenExecuted,
+	                           uint64_t hitCount,
+	                           uint64_t firstHitOrder,
+	                           uint64_t firstHitTime)
 	{
-		LineCoverage line{ lineNumber, hasBeenExecuted };
+		LineCoverage line{ lineNumber, hasBeenExecuted, hitCount, firstHitOrder, firstHitTime };
+		auto& lines = GetMutableLines();
 
-		if (!lines_.emplace(lineNumber, line).second)
+		// The lines are usually added in order.
+		if (lines.lines_.empty() || lines.lines_.back().GetLineNumber() < lineNumber)
+			lines.lines_.push_back(line);
+		else
 		{
-			throw std::runtime_error("Line " + std::to_string(lineNumber) +
-				" already exists for " + path_.string());
+			auto it = LowerBound(lines.lines_, lineNumber);
+			if (it != lines.lines_.end() && it->GetLineNumber() == lineNumber)
+			{
+				throw std::runtime_error("Line " + std::to_string(lineNumber) +
+					" already exists for " + path_.string());
+			}
+			lines.lines_.insert(it, line);
 		}
+		if (hasBeenExecuted)
+			++lines.executedLineCount_;
 	}
 
 	//-------------------------------------------------------------------------
-	void FileCoverage::UpdateLine(unsigned int lineNumber, bool hasBeenExecuted)
+	void FileCoverage::UpdateLine(unsigned int lineNumber,
+	                              bool hasBeenExecuted,
+	                              uint64_t hitCount,
+	                              uint64_t firstHitOrder,
+	                              uint64_t firstHitTime)
 	{
-		if (!lines_.erase(lineNumber))
+		auto it = LowerBound(lines_->lines_, lineNumber);
+
+		if (it == lines_->lines_.end() || it->GetLineNumber() != lineNumber)
 		{
 			throw std::runtime_error(
 			    "Line " + std::to_string(lineNumber) +
 			    " does not exists and cannot be updated for " + path_.string());
 		}
 
-		AddLine(lineNumber, hasBeenExecuted);
+		auto& lines = GetMutableLines();
+		it = LowerBound(lines.lines_, lineNumber);
+		if (it->HasBeenExecuted())
+			--lines.executedLineCount_;
+		if (hasBeenExecuted)
+			++lines.executedLineCount_;
+		*it = LineCoverage{ lineNumber, hasBeenExecuted, hitCount, firstHitOrder, firstHitTime };
+	}
+
+	//-------------------------------------------------------------------------
+	void FileCoverage::ReserveLines(size_t count)
+	{
+		GetMutableLines().lines_.reserve(count);
+	}
+
+	//-------------------------------------------------------------------------
+	void FileCoverage::SetLines(std::vector<LineCoverage>&& lines)
+	{
+		auto newLines = std::make_shared<Lines>();
+
+		for (size_t i = 0; i < lines.size(); ++i)
+		{
+			auto lineNumber = lines[i].GetLineNumber();
+			if (i && lines[i - 1].GetLineNumber() >= lineNumber)
+			{
+				throw std::runtime_error("Line " + std::to_string(lineNumber) +
+					" is not sorted or already exists for " + path_.string());
+			}
+			if (lines[i].HasBeenExecuted())
+				++newLines->executedLineCount_;
+		}
+		newLines->lines_ = std::move(lines);
+		lines_ = std::move(newLines);
 	}
 
 	//-------------------------------------------------------------------------
@@ -60,22 +129,31 @@ namespace Plugin
 	//-------------------------------------------------------------------------
 	const LineCoverage* FileCoverage::operator[](unsigned int line) const
 	{
-		auto it = lines_.find(line);
+		auto it = LowerBound(lines_->lines_, line);
 
-		if (it == lines_.end())
+		if (it == lines_->lines_.end() || it->GetLineNumber() != line)
 			return 0;
 
-		return &it->second;
+		return &*it;
 	}
 		
 	//-------------------------------------------------------------------------
-	std::vector<LineCoverage> FileCoverage::GetLines() const
+	const std::vector<LineCoverage>& FileCoverage::GetLines() const
 	{
-		std::vector<LineCoverage> lines;
-		
-		for (const auto& pair : lines_)
-			lines.push_back(pair.second);
-		
-		return lines;
-	}	
+		return lines_->lines_;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t FileCoverage::GetExecutedLineCount() const
+	{
+		return lines_->executedLineCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	FileCoverage::Lines& FileCoverage::GetMutableLines()
+	{
+		if (lines_.use_count() > 1)
+			lines_ = std::make_shared<Lines>(*lines_);
+		return *lines_;
+	}
 }
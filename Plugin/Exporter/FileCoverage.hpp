@@ -17,7 +17,8 @@
 #pragma once
 
 #include <filesystem>
-#include <map>
+#include <memory>
+#include <vector>
 
 #include "LineCoverage.hpp"
 #include "../PluginExport.hpp"
@@ -29,21 +30,47 @@ namespace Plugin
 	public:
 		explicit FileCoverage(const std::filesystem::path& path);
 
-		void AddLine(unsigned int lineNumber, bool hasBeenExecuted);
-		void UpdateLine(unsigned int lineNumber, bool hasBeenExecuted);
+		void AddLine(unsigned int lineNumber,
+		             bool hasBeenExecuted,
+		             uint64_t hitCount = 0,
+		             uint64_t firstHitOrder = 0,
+		             uint64_t firstHitTime = 0);
+		void UpdateLine(unsigned int lineNumber,
+		                bool hasBeenExecuted,
+		                uint64_t hitCount = 0,
+		                uint64_t firstHitOrder = 0,
+		                uint64_t firstHitTime = 0);
+		// Avoid reallocations when the number of lines is known.
+		void ReserveLines(size_t count);
+		// Replace all the lines, which must be sorted by line number and
+		// unique, without copying them.
+		void SetLines(std::vector<LineCoverage>&& lines);
 
 		const std::filesystem::path& GetPath() const;
 		const LineCoverage* operator[](unsigned int line) const;
-		std::vector<LineCoverage> GetLines() const;
+		// Sorted by line number.
+		const std::vector<LineCoverage>& GetLines() const;
+		// Kept up to date by AddLine and UpdateLine.
+		size_t GetExecutedLineCount() const;
 
+		// The lines are shared with the other file until one of them is
+		// modified.
 		FileCoverage& operator=(const FileCoverage&) = default;
 
 	private:
 		FileCoverage(const FileCoverage&) = delete;
+
+		struct Lines
+		{
+			std::vector<LineCoverage> lines_;
+			size_t executedLineCount_ = 0;
+		};
+
+		Lines& GetMutableLines();
 			
 	private:
 		std::filesystem::path path_;
-		std::map<unsigned int, LineCoverage> lines_;	
+		std::shared_ptr<Lines> lines_;
 	};
 }
 
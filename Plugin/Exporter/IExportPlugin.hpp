@@ -20,6 +20,8 @@
 #include <optional>
 #include <filesystem>
 
+#include "CoverageDataView.hpp"
+
 namespace Plugin
 {
 	class CoverageData;
@@ -64,8 +66,34 @@ namespace Plugin
 		// Must be implemented as return Plugin::CurrentExportPluginVersion.
 		//---------------------------------------------------------------------
 		virtual int GetExportPluginVersion() const = 0;
+
+		//---------------------------------------------------------------------
+		// Return true if Export can run while the other exports are performed.
+		// Export only reads coverageData which is not modified during the
+		// exports. Added in the version 2.
+		//---------------------------------------------------------------------
+		virtual bool IsThreadSafe() const
+		{
+			return false;
+		}
+
+		//---------------------------------------------------------------------
+		// Perform the export from a columnar view of the coverage, built once
+		// for all the plugins. Override it instead of Export to avoid walking
+		// the modules, the files and the lines of coverageData.
+		//    coverageDataView: stores the result of the code coverage.
+		//    argument: same as Export.
+		// Added in the version 3.
+		//---------------------------------------------------------------------
+		virtual std::optional<std::filesystem::path>
+		ExportView(const Plugin::CoverageDataView& coverageDataView,
+		           const std::optional<std::wstring>& argument)
+		{
+			return Export(coverageDataView.GetCoverageData(), argument);
+		}
 	};
 
 	// The current version of IExportPlugin.
-	const int CurrentExportPluginVersion = 1;
+	// The plugins built for another version are rejected.
+	const int CurrentExportPluginVersion = 4;
 }
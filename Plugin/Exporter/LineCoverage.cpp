@@ -20,9 +20,16 @@
 namespace Plugin
 {
 	//-------------------------------------------------------------------------
-	LineCoverage::LineCoverage(unsigned int lineNumber, bool hasBeenExecuted)
+	LineCoverage::LineCoverage(unsigned int lineNumber,
+	                           bool hasBeenExecuted,
+	                           uint64_t hitCount,
+	                           uint64_t firstHitOrder,
+	                           uint64_t firstHitTime)
 		: lineNumber_(lineNumber)
 		, hasBeenExecuted_(hasBeenExecuted)
+		, hitCount_(hitCount)
+		, firstHitOrder_(firstHitOrder)
+		, firstHitTime_(firstHitTime)
 	{
 	}
 		
@@ -37,4 +44,22 @@ namespace Plugin
 	{
 		return hasBeenExecuted_;
 	}
+
+	//-------------------------------------------------------------------------
+	uint64_t LineCoverage::GetHitCount() const
+	{
+		return hitCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t LineCoverage::GetFirstHitOrder() const
+	{
+		return firstHitOrder_;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t LineCoverage::GetFirstHitTime() const
+	{
+		return firstHitTime_;
+	}
 }
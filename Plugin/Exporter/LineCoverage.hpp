@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include "../PluginExport.hpp"
 
 namespace Plugin
@@ -23,15 +25,32 @@ namespace Plugin
 	class PLUGIN_DLL LineCoverage
 	{
 	public:
-		LineCoverage(unsigned int lineNumber, bool hasBeenExecuted);
+		LineCoverage(unsigned int lineNumber,
+		             bool hasBeenExecuted,
+		             uint64_t hitCount = 0,
+		             uint64_t firstHitOrder = 0,
+		             uint64_t firstHitTime = 0);
 		LineCoverage(const LineCoverage&) = default;
 		
 		unsigned int GetLineNumber() const;
 		bool HasBeenExecuted() const;
+
+		// Approximate number of executions, 0 when unknown.
+		uint64_t GetHitCount() const;
+
+		// Position of the line in the order of the first executions of the
+		// run, starting at 1. 0 when unknown.
+		uint64_t GetFirstHitOrder() const;
+		// Time of the first execution in microseconds since the start of the
+		// coverage. Meaningful only when GetFirstHitOrder is not 0.
+		uint64_t GetFirstHitTime() const;
 		
 	private:
 		unsigned int lineNumber_;
 		bool hasBeenExecuted_;
+		uint64_t hitCount_;
+		uint64_t firstHitOrder_;
+		uint64_t firstHitTime_;
 	};
 }
 
@@ -40,6 +40,12 @@ namespace Plugin
 		return *files_.back();
 	}
 
+	//-------------------------------------------------------------------------
+	void ModuleCoverage::ReserveFiles(size_t count)
+	{
+		files_.reserve(count);
+	}
+
 	//-------------------------------------------------------------------------
 	const std::filesystem::path& ModuleCoverage::GetPath() const
 	{
@@ -51,4 +57,16 @@ namespace Plugin
 	{
 		return files_;
 	}
+
+	//-------------------------------------------------------------------------
+	void ModuleCoverage::SetIdentity(const std::wstring& identity)
+	{
+		identity_ = identity;
+	}
+
+	//-------------------------------------------------------------------------
+	const std::wstring& ModuleCoverage::GetIdentity() const
+	{
+		return identity_;
+	}
 }
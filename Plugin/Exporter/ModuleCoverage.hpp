@@ -18,6 +18,7 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 
 #include <filesystem>
 
@@ -37,10 +38,16 @@ namespace Plugin
 		~ModuleCoverage();
 
 		FileCoverage& AddFile(const std::filesystem::path& filename);
+		// Avoid reallocations when the number of files is known.
+		void ReserveFiles(size_t count);
 		
 		const std::filesystem::path& GetPath() const;
 		const T_FileCoverageCollection& GetFiles() const;
 
+		// Identity of the image and of its PDB, empty when unknown.
+		void SetIdentity(const std::wstring&);
+		const std::wstring& GetIdentity() const;
+
 	private:
 		ModuleCoverage(const ModuleCoverage&) = delete;
 		ModuleCoverage& operator=(const ModuleCoverage&) = delete;
@@ -48,6 +55,7 @@ namespace Plugin
 	private:
 		T_FileCoverageCollection files_;
 		std::filesystem::path path_;		
+		std::wstring identity_;
 	};
 }
 
@@ -0,0 +1,86 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "pch.h"
+
+#include "Plugin/Exporter/CoverageData.hpp"
+#include "Plugin/Exporter/CoverageDataView.hpp"
+#include "Plugin/Exporter/ModuleCoverage.hpp"
+#include "Plugin/Exporter/FileCoverage.hpp"
+
+namespace PluginTest
+{
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, Basic)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& module1 = coverageData.AddModule(L"module1");
+		auto& file = module1.AddFile(L"file");
+		file.AddLine(1, true);
+		file.AddLine(2, false);
+		module1.AddFile(L"file2").AddLine(3, true);
+		coverageData.AddModule(L"module2").AddFile(L"file").AddLine(4, false);
+
+		Plugin::CoverageDataView view{ coverageData };
+		ASSERT_EQ(&coverageData, &view.GetCoverageData());
+
+		const auto& paths = view.GetPaths();
+		ASSERT_EQ(4, paths.size());
+
+		const auto& modules = view.GetModules();
+		ASSERT_EQ(2, modules.size());
+		ASSERT_EQ("module1", paths.at(modules[0].path_));
+		ASSERT_EQ(0, modules[0].firstFile_);
+		ASSERT_EQ(2, modules[0].fileCount_);
+		ASSERT_EQ(3, modules[0].lineCount_);
+		ASSERT_EQ(2, modules[0].executedLineCount_);
+		ASSERT_EQ(2, modules[1].firstFile_);
+
+		const auto& files = view.GetFiles();
+		ASSERT_EQ(3, files.size());
+		ASSERT_EQ(files[0].path_, files[2].path_);
+		ASSERT_EQ("file2", paths.at(files[1].path_));
+		ASSERT_EQ(2, files[1].firstLine_);
+		ASSERT_EQ(1, files[1].lineCount_);
+		ASSERT_EQ(1, files[1].executedLineCount_);
+
+		std::vector<unsigned int> expectedLineNumbers{ 1, 2, 3, 4 };
+		ASSERT_EQ(expectedLineNumbers, view.GetLineNumbers());
+		ASSERT_TRUE(view.IsExecuted(0));
+		ASSERT_FALSE(view.IsExecuted(1));
+		ASSERT_TRUE(view.IsExecuted(2));
+		ASSERT_FALSE(view.IsExecuted(3));
+		ASSERT_EQ(1, view.GetExecutedLines().size());
+		ASSERT_EQ(2, view.GetExecutedLineCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(CoverageDataViewTest, ManyLines)
+	{
+		Plugin::CoverageData coverageData{ L"", 0 };
+		auto& file = coverageData.AddModule(L"module").AddFile(L"file");
+		const unsigned int lineCount = 200;
+
+		for (unsigned int i = 0; i < lineCount; ++i)
+			file.AddLine(i, i % 3 == 0);
+
+		Plugin::CoverageDataView view{ coverageData };
+		ASSERT_EQ(4, view.GetExecutedLines().size());
+		for (unsigned int i = 0; i < lineCount; ++i)
+			ASSERT_EQ(i % 3 == 0, view.IsExecuted(i));
+		ASSERT_EQ(67, view.GetExecutedLineCount());
+	}
+}
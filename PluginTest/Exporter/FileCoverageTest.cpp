@@ -60,4 +60,76 @@ namespace PluginTest
 		
 		ASSERT_THROW(file.UpdateLine(0, false), std::runtime_error);
 	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, LinesSorted)
+	{
+		Plugin::FileCoverage file{ L"" };
+
+		file.AddLine(10, true);
+		file.AddLine(2, false);
+		file.AddLine(5, true);
+		ASSERT_THROW(file.AddLine(5, false), std::runtime_error);
+		file.UpdateLine(2, true, 3);
+
+		const auto& lines = file.GetLines();
+		ASSERT_EQ(3, lines.size());
+		ASSERT_EQ(2, lines[0].GetLineNumber());
+		ASSERT_EQ(3, lines[0].GetHitCount());
+		ASSERT_EQ(5, lines[1].GetLineNumber());
+		ASSERT_EQ(10, lines[2].GetLineNumber());
+		ASSERT_EQ(nullptr, file[3]);
+		ASSERT_EQ(10, file[10]->GetLineNumber());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, ExecutedLineCount)
+	{
+		Plugin::FileCoverage file{ L"" };
+
+		file.AddLine(1, true);
+		file.AddLine(2, false);
+		file.AddLine(3, false);
+		ASSERT_EQ(1, file.GetExecutedLineCount());
+
+		file.UpdateLine(2, true);
+		file.UpdateLine(1, true);
+		ASSERT_EQ(2, file.GetExecutedLineCount());
+
+		file.UpdateLine(1, false);
+		ASSERT_EQ(1, file.GetExecutedLineCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, SharedLines)
+	{
+		Plugin::FileCoverage file{ L"file" };
+		Plugin::FileCoverage otherFile{ L"file" };
+
+		file.AddLine(1, true);
+		otherFile = file;
+		ASSERT_EQ(&file.GetLines(), &otherFile.GetLines());
+
+		otherFile.UpdateLine(1, false);
+		otherFile.AddLine(2, true);
+		ASSERT_TRUE(file[1]->HasBeenExecuted());
+		ASSERT_EQ(1, file.GetLines().size());
+		ASSERT_FALSE(otherFile[1]->HasBeenExecuted());
+		ASSERT_EQ(2, otherFile.GetLines().size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(FileCoverageTest, SetLines)
+	{
+		Plugin::FileCoverage file{ L"" };
+
+		file.SetLines({ { 1, true }, { 3, false }, { 4, true } });
+		ASSERT_EQ(3, file.GetLines().size());
+		ASSERT_EQ(2, file.GetExecutedLineCount());
+		ASSERT_FALSE(file[3]->HasBeenExecuted());
+
+		ASSERT_THROW(file.SetLines({ { 1, true }, { 1, false } }), std::runtime_error);
+		ASSERT_THROW(file.SetLines({ { 2, true }, { 1, false } }), std::runtime_error);
+		ASSERT_EQ(3, file.GetLines().size());
+	}
 }
\ No newline at end of file
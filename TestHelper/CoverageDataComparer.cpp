@@ -61,6 +61,7 @@ namespace TestHelper
 			const Plugin::ModuleCoverage& module2)
 		{
 			AssertEqual(module1.GetPath(), module2.GetPath());
+			AssertEqual(module1.GetIdentity(), module2.GetIdentity());
 			AssertContainerUniquePtrEqual(module1.GetFiles(), module2.GetFiles(), AssertFilesEquals);
 		}
 	}
@@ -72,6 +73,7 @@ namespace TestHelper
 	{
 		AssertEqual(coverageData.GetName(), coverageDataRestored.GetName());
 		AssertEqual(coverageData.GetExitCode(), coverageDataRestored.GetExitCode());
+		AssertEqual(coverageData.IsSampled(), coverageDataRestored.IsSampled());
 
 		AssertContainerUniquePtrEqual(
 			coverageData.GetModules(),
@@ -92,4 +92,10 @@ namespace TestHelper
 			    "Invalid Visual Studio installation path: " + value);
 		return installerPath;
 	}
+
+	//-------------------------------------------------------------------------
+	CppCoverage::Address CreateAddress(HANDLE hProcess, intptr_t addressValue)
+	{
+		return CppCoverage::Address{hProcess, reinterpret_cast<void*>(addressValue)};
+	}
 }
\ No newline at end of file
@@ -18,6 +18,7 @@
 
 #include <filesystem>
 #include "TestHelperExport.hpp"
+#include "CppCoverage/Address.hpp"
 
 extern "C"
 {
@@ -37,6 +38,8 @@ namespace TestHelper
 
 	std::filesystem::path TEST_HELPER_DLL GetVisualStudioPath();
 
+	CppCoverage::Address TEST_HELPER_DLL CreateAddress(HANDLE hProcess, intptr_t addressValue);
+
 	//-------------------------------------------------------------------------
 	template <typename ExceptionType, typename Fct>
 	void AssertThrow(Fct fct,
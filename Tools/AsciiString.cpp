@@ -0,0 +1,148 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "AsciiString.hpp"
+
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define TOOLS_ASCII_SSE2
+#endif
+
+namespace Tools
+{
+	namespace
+	{
+		static_assert(sizeof(wchar_t) == 2, "The kernels expect UTF-16 strings.");
+
+		//---------------------------------------------------------------------
+		bool IsAscii(wchar_t c)
+		{
+			return static_cast<unsigned int>(c) < 0x80;
+		}
+
+		//---------------------------------------------------------------------
+		bool IsAscii(char c)
+		{
+			return static_cast<unsigned char>(c) < 0x80;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	size_t GetAsciiPrefixLength(const wchar_t* str, size_t size)
+	{
+		size_t i = 0;
+
+#ifdef TOOLS_ASCII_SSE2
+		const auto nonAsciiBits = _mm_set1_epi16(static_cast<short>(0xFF80));
+		const auto zero = _mm_setzero_si128();
+		for (; i + 8 <= size; i += 8)
+		{
+			auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+			auto isAscii = _mm_cmpeq_epi16(_mm_and_si128(chars, nonAsciiBits), zero);
+			if (_mm_movemask_epi8(isAscii) != 0xFFFF)
+				break;
+		}
+#endif
+		while (i < size && IsAscii(str[i]))
+			++i;
+		return i;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t GetAsciiPrefixLength(const char* str, size_t size)
+	{
+		size_t i = 0;
+
+#ifdef TOOLS_ASCII_SSE2
+		// The high bit of each byte is the bit of the mask.
+		for (; i + 16 <= size; i += 16)
+		{
+			auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+			if (_mm_movemask_epi8(chars))
+				break;
+		}
+#endif
+		while (i < size && IsAscii(str[i]))
+			++i;
+		return i;
+	}
+
+	//-------------------------------------------------------------------------
+	void NarrowAscii(const wchar_t* str, size_t size, char* output)
+	{
+		size_t i = 0;
+
+#ifdef TOOLS_ASCII_SSE2
+		for (; i + 16 <= size; i += 16)
+		{
+			auto chars1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+			auto chars2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i + 8));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_packus_epi16(chars1, chars2));
+		}
+#endif
+		for (; i < size; ++i)
+			output[i] = static_cast<char>(str[i]);
+	}
+
+	//-------------------------------------------------------------------------
+	void WidenAscii(const char* str, size_t size, wchar_t* output)
+	{
+		size_t i = 0;
+
+#ifdef TOOLS_ASCII_SSE2
+		const auto zero = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16)
+		{
+			auto chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_unpacklo_epi8(chars, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + i + 8), _mm_unpackhi_epi8(chars, zero));
+		}
+#endif
+		for (; i < size; ++i)
+			output[i] = static_cast<wchar_t>(str[i]);
+	}
+
+	//-------------------------------------------------------------------------
+	bool TryToLowerAscii(std::wstring& str)
+	{
+		auto size = str.size();
+
+		if (GetAsciiPrefixLength(str.data(), size) != size)
+			return false;
+
+		auto* chars = &str[0];
+		size_t i = 0;
+#ifdef TOOLS_ASCII_SSE2
+		const auto beforeA = _mm_set1_epi16(L'A' - 1);
+		const auto afterZ = _mm_set1_epi16(L'Z' + 1);
+		const auto caseBit = _mm_set1_epi16(0x20);
+		for (; i + 8 <= size; i += 8)
+		{
+			auto* address = reinterpret_cast<__m128i*>(chars + i);
+			auto value = _mm_loadu_si128(address);
+			auto isUpper = _mm_and_si128(_mm_cmpgt_epi16(value, beforeA), _mm_cmplt_epi16(value, afterZ));
+			_mm_storeu_si128(address, _mm_or_si128(value, _mm_and_si128(isUpper, caseBit)));
+		}
+#endif
+		for (; i < size; ++i)
+		{
+			if (chars[i] >= L'A' && chars[i] <= L'Z')
+				chars[i] = static_cast<wchar_t>(chars[i] | 0x20);
+		}
+		return true;
+	}
+}
@@ -0,0 +1,40 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Kernels for the strings whose characters are all ASCII, the paths of
+	// most builds. They use SSE2 on x86 and x64.
+
+	// The number of ASCII characters at the start of str.
+	TOOLS_DLL size_t GetAsciiPrefixLength(const wchar_t* str, size_t size);
+	TOOLS_DLL size_t GetAsciiPrefixLength(const char* str, size_t size);
+
+	// Convert size ASCII characters.
+	TOOLS_DLL void NarrowAscii(const wchar_t* str, size_t size, char* output);
+	TOOLS_DLL void WidenAscii(const char* str, size_t size, wchar_t* output);
+
+	// Lower the letters of str. Return false and leave str unchanged when
+	// str is not ASCII.
+	TOOLS_DLL bool TryToLowerAscii(std::wstring& str);
+}
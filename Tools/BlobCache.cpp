@@ -0,0 +1,274 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "BlobCache.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <Windows.h>
+
+#include "Fnv1a.hpp"
+#include "Log.hpp"
+#include "Tool.hpp"
+#include "ToolsException.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Tools
+{
+	namespace
+	{
+		const std::wstring TemporaryExtension = L".tmp";
+
+		//---------------------------------------------------------------------
+		struct Blob
+		{
+			fs::path path_;
+			fs::file_time_type lastWriteTime_;
+			uintmax_t size_;
+		};
+
+		//---------------------------------------------------------------------
+		std::vector<Blob> GetBlobs(const fs::path& folder)
+		{
+			std::vector<Blob> blobs;
+			std::error_code error;
+
+			for (fs::directory_iterator it{folder, error}, end; !error && it != end; it.increment(error))
+			{
+				const auto& path = it->path();
+				if (path.extension() == TemporaryExtension || !it->is_regular_file(error))
+					continue;
+				auto lastWriteTime = it->last_write_time(error);
+				auto size = error ? 0 : it->file_size(error);
+				if (!error)
+					blobs.push_back({path, lastWriteTime, size});
+			}
+			return blobs;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	BlobCache::BlobCache(const fs::path& folder, uintmax_t maxSize)
+		: folder_{folder}
+		, maxSize_{maxSize}
+		, hitCount_{0}
+		, missCount_{0}
+		, writeCount_{0}
+		, evictionCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	BlobCache::~BlobCache()
+	{
+		auto statistics = GetStatistics();
+
+		if (statistics.hitCount_ || statistics.missCount_ || statistics.writeCount_)
+		{
+			LOG_INFO << L"Cache " << folder_.wstring() << L": " << statistics.hitCount_
+			         << L" hits, " << statistics.missCount_ << L" misses, "
+			         << statistics.writeCount_ << L" writes, "
+			         << statistics.evictionCount_ << L" evictions.";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring BlobCache::GetKey(std::string_view content)
+	{
+		std::wostringstream ostr;
+
+		ostr << std::hex << std::uppercase << std::setfill(L'0') << std::setw(16)
+		     << Fnv1a(Fnv1aOffsetBasis, content.data(), content.size())
+		     << L'-' << std::setw(8) << content.size();
+		return ostr.str();
+	}
+
+	//-------------------------------------------------------------------------
+	const fs::path& BlobCache::GetFolder() const
+	{
+		return folder_;
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path BlobCache::GetPath(const std::wstring& name) const
+	{
+		return folder_ / name;
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path BlobCache::GetTemporaryPath(const std::wstring& name) const
+	{
+		return GetTemporaryPath(folder_, name);
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path BlobCache::GetTemporaryPath(const fs::path& folder, const std::wstring& name)
+	{
+		return folder / (name + L"." + std::to_wstring(GetCurrentProcessId()) + L"." +
+		                  std::to_wstring(GetCurrentThreadId()) + TemporaryExtension);
+	}
+
+	//-------------------------------------------------------------------------
+	bool BlobCache::Contains(const std::wstring& name) const
+	{
+		std::error_code error;
+		return fs::is_regular_file(GetPath(name), error);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<fs::path> BlobCache::Find(const std::wstring& name) const
+	{
+		auto path = GetPath(name);
+		std::error_code error;
+
+		if (!fs::is_regular_file(path, error))
+		{
+			++missCount_;
+			return boost::none;
+		}
+		++hitCount_;
+
+		// Another run can use the blob at the same time: the time is only a hint.
+		fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+		return path;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<std::string> BlobCache::Read(const std::wstring& name) const
+	{
+		auto path = Find(name);
+		if (!path)
+			return boost::none;
+
+		std::ifstream ifs{*path, std::ios::binary};
+		std::ostringstream ostr;
+
+		ostr << ifs.rdbuf();
+		if (!ifs)
+			return boost::none;
+		return ostr.str();
+	}
+
+	//-------------------------------------------------------------------------
+	void BlobCache::Write(const std::wstring& name, std::string_view content) const
+	{
+		Write(name, [&](std::ostream& ostr) {
+			ostr.write(content.data(), content.size());
+		});
+	}
+
+	//-------------------------------------------------------------------------
+	void BlobCache::Write(const std::wstring& name,
+	                      const std::function<void(std::ostream&)>& write) const
+	{
+		auto temporaryPath = GetTemporaryPath(name);
+
+		fs::create_directories(folder_);
+		try
+		{
+			std::ofstream ofs{temporaryPath, std::ios::binary};
+			write(ofs);
+			if (!ofs)
+				THROW(L"Cannot write the cache file: " << temporaryPath.wstring());
+		}
+		catch (...)
+		{
+			std::error_code error;
+			fs::remove(temporaryPath, error);
+			throw;
+		}
+		Publish(name, temporaryPath);
+	}
+
+	//-------------------------------------------------------------------------
+	void BlobCache::Publish(const std::wstring& name,
+	                        const fs::path& temporaryPath) const
+	{
+		auto path = GetPath(name);
+		std::error_code error;
+		auto size = fs::file_size(temporaryPath, error);
+
+		// Several runs can write the same blob: the complete file replaces
+		// the existing one.
+		if (!error)
+			fs::rename(temporaryPath, path, error);
+		if (error)
+		{
+			std::error_code removeError;
+			fs::remove(temporaryPath, removeError);
+			// The existing blob is open by another run: it has the same content.
+			if (fs::is_regular_file(path, removeError))
+				return;
+			THROW(L"Cannot write the cache file " << path.wstring() << L": "
+			                                      << LocalToWString(error.message()));
+		}
+		++writeCount_;
+		Evict(size);
+	}
+
+	//-------------------------------------------------------------------------
+	BlobCache::Statistics BlobCache::GetStatistics() const
+	{
+		return {hitCount_, missCount_, writeCount_, evictionCount_};
+	}
+
+	//-------------------------------------------------------------------------
+	void BlobCache::Evict(uintmax_t addedSize) const
+	{
+		if (!maxSize_)
+			return;
+
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (size_ && *size_ + addedSize <= maxSize_)
+		{
+			*size_ += addedSize;
+			return;
+		}
+
+		// The folder is read again because the other runs also write to it.
+		auto blobs = GetBlobs(folder_);
+		uintmax_t size = 0;
+		for (const auto& blob : blobs)
+			size += blob.size_;
+
+		if (size > maxSize_)
+		{
+			// Remove more than needed so the next writes do not read the folder again.
+			auto targetSize = maxSize_ - maxSize_ / 10;
+			std::sort(blobs.begin(), blobs.end(), [](const Blob& blob1, const Blob& blob2) {
+				return blob1.lastWriteTime_ < blob2.lastWriteTime_;
+			});
+			for (const auto& blob : blobs)
+			{
+				if (size <= targetSize)
+					break;
+				std::error_code error;
+				if (fs::remove(blob.path_, error))
+				{
+					size -= blob.size_;
+					++evictionCount_;
+				}
+			}
+		}
+		size_ = size;
+	}
+}
@@ -0,0 +1,96 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <boost/optional.hpp>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Files saved in a folder between the runs and shared by the caches of
+	// OpenCppCoverage. A blob is named by its key, a hash of what it is
+	// computed from, and an extension for the cache which owns it.
+	//
+	// A blob is written in a temporary file and renamed once complete, so
+	// the runs in parallel see either no blob or the complete one. A blob
+	// found is marked as used: the least recently used blobs are removed
+	// when the size of the folder is above the maximum.
+	class TOOLS_DLL BlobCache
+	{
+	public:
+		struct Statistics
+		{
+			size_t hitCount_;
+			size_t missCount_;
+			size_t writeCount_;
+			size_t evictionCount_;
+		};
+
+		// 0 for no maximum size.
+		BlobCache(const std::filesystem::path& folder, uintmax_t maxSize);
+		~BlobCache();
+
+		static std::wstring GetKey(std::string_view content);
+
+		const std::filesystem::path& GetFolder() const;
+		std::filesystem::path GetPath(const std::wstring& name) const;
+		// Use Publish to make this file a blob.
+		std::filesystem::path GetTemporaryPath(const std::wstring& name) const;
+		// A file of folder unique to the thread, to be renamed to folder / name.
+		static std::filesystem::path GetTemporaryPath(const std::filesystem::path& folder,
+		                                              const std::wstring& name);
+
+		bool Contains(const std::wstring& name) const;
+		// boost::none when the blob does not exist.
+		boost::optional<std::filesystem::path> Find(const std::wstring& name) const;
+		boost::optional<std::string> Read(const std::wstring& name) const;
+
+		void Write(const std::wstring& name, std::string_view content) const;
+		void Write(const std::wstring& name,
+		           const std::function<void(std::ostream&)>& write) const;
+		// Rename a file written at GetTemporaryPath(name). The file is removed
+		// when the rename fails.
+		void Publish(const std::wstring& name,
+		             const std::filesystem::path& temporaryPath) const;
+
+		Statistics GetStatistics() const;
+
+	private:
+		BlobCache(const BlobCache&) = delete;
+		BlobCache& operator=(const BlobCache&) = delete;
+
+		void Evict(uintmax_t addedSize) const;
+
+		const std::filesystem::path folder_;
+		const uintmax_t maxSize_;
+		mutable std::mutex mutex_;
+		mutable boost::optional<uintmax_t> size_;
+		mutable std::atomic<size_t> hitCount_;
+		mutable std::atomic<size_t> missCount_;
+		mutable std::atomic<size_t> writeCount_;
+		mutable std::atomic<size_t> evictionCount_;
+	};
+}
@@ -0,0 +1,146 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "FileWriter.hpp"
+
+#include <algorithm>
+
+#include "ToolsException.hpp"
+#include "ScopedAction.hpp"
+
+namespace Tools
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		void WriteContent(const std::filesystem::path& path, const std::string& content)
+		{
+			auto hFile = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr,
+				CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+			if (hFile == INVALID_HANDLE_VALUE)
+				THROW(L"Cannot open file " << path.wstring());
+			ScopedAction closeFile{ [&]() { CloseHandle(hFile); } };
+
+			// A single WriteFile cannot write more than 4 GB.
+			const size_t maxWriteSize = 1 << 30;
+			for (size_t offset = 0; offset < content.size();)
+			{
+				auto size = static_cast<DWORD>((std::min)(maxWriteSize, content.size() - offset));
+				DWORD writtenSize = 0;
+
+				if (!WriteFile(hFile, content.data() + offset, size, &writtenSize, nullptr) || !writtenSize)
+					THROW(L"Cannot write file " << path.wstring());
+				offset += writtenSize;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	const size_t FileWriter::DefaultMaxQueuedSize = 64 * 1024 * 1024;
+
+	//-------------------------------------------------------------------------
+	FileWriter::FileWriter(size_t maxQueuedSize)
+		: maxQueuedSize_{ maxQueuedSize }
+		, queuedSize_{ 0 }
+		, peakQueuedSize_{ 0 }
+		, isWriting_{ false }
+		, isStopped_{ false }
+		, thread_{ [this]() { WriteQueuedFiles(); } }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	FileWriter::~FileWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			isStopped_ = true;
+		}
+		queueChanged_.notify_all();
+		thread_.join();
+	}
+
+	//-------------------------------------------------------------------------
+	void FileWriter::Write(const std::filesystem::path& path, std::string&& content)
+	{
+		std::unique_lock<std::mutex> lock{ mutex_ };
+
+		// A file bigger than the maximum is queued when the queue is empty.
+		queueChanged_.wait(lock, [&]() {
+			return queuedSize_ == 0 || queuedSize_ + content.size() <= maxQueuedSize_;
+		});
+		queuedSize_ += content.size();
+		peakQueuedSize_ = (std::max)(peakQueuedSize_, queuedSize_);
+		files_.emplace_back(path, std::move(content));
+		lock.unlock();
+		queueChanged_.notify_all();
+	}
+
+	//-------------------------------------------------------------------------
+	void FileWriter::Flush()
+	{
+		std::unique_lock<std::mutex> lock{ mutex_ };
+
+		queueChanged_.wait(lock, [&]() { return files_.empty() && !isWriting_; });
+		if (error_)
+			std::rethrow_exception(std::exchange(error_, nullptr));
+	}
+
+	//-------------------------------------------------------------------------
+	size_t FileWriter::GetPeakQueuedSize() const
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		return peakQueuedSize_;
+	}
+
+	//-------------------------------------------------------------------------
+	void FileWriter::WriteQueuedFiles()
+	{
+		std::unique_lock<std::mutex> lock{ mutex_ };
+
+		for (;;)
+		{
+			queueChanged_.wait(lock, [&]() { return !files_.empty() || isStopped_; });
+			if (files_.empty())
+				return;
+
+			auto file = std::move(files_.front());
+			files_.pop_front();
+			isWriting_ = true;
+			lock.unlock();
+
+			std::exception_ptr error;
+			try
+			{
+				WriteContent(file.first, file.second);
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+
+			lock.lock();
+			isWriting_ = false;
+			queuedSize_ -= file.second.size();
+			if (error && !error_)
+				error_ = error;
+			queueChanged_.notify_all();
+		}
+	}
+}
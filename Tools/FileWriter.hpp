@@ -0,0 +1,71 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Write whole files on a background thread so the caller can render the
+	// next file while the disk works. Write blocks while the size of the
+	// queued files is above the maximum.
+	class TOOLS_DLL FileWriter
+	{
+	public:
+		static const size_t DefaultMaxQueuedSize;
+
+		explicit FileWriter(size_t maxQueuedSize = DefaultMaxQueuedSize);
+		// Wait for the queued files. The errors are ignored.
+		~FileWriter();
+
+		// Replace the file at path by content. The parent folder must exist.
+		// Can be called from several threads.
+		void Write(const std::filesystem::path&, std::string&& content);
+
+		// Wait for the queued files and rethrow the first write error.
+		void Flush();
+
+		// Peak size of the files waiting to be written.
+		size_t GetPeakQueuedSize() const;
+
+	private:
+		FileWriter(const FileWriter&) = delete;
+		FileWriter& operator=(const FileWriter&) = delete;
+
+		void WriteQueuedFiles();
+
+		const size_t maxQueuedSize_;
+		mutable std::mutex mutex_;
+		std::condition_variable queueChanged_;
+		std::deque<std::pair<std::filesystem::path, std::string>> files_;
+		size_t queuedSize_;
+		size_t peakQueuedSize_;
+		bool isWriting_;
+		bool isStopped_;
+		std::exception_ptr error_;
+		std::thread thread_;
+	};
+}
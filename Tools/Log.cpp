@@ -17,13 +17,19 @@
 #include "stdafx.h"
 #include "Log.hpp"
 
+#include <atomic>
 #include <filesystem>
 
 #include <boost/log/expressions.hpp>
-#include <boost/log/utility/setup/file.hpp>
-#include <boost/log/utility/setup/console.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/bounded_fifo_queue.hpp>
+#include <boost/log/sinks/block_on_overflow.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
 #include <boost/log/utility/setup/common_attributes.hpp>
 #include <boost/log/support/date_time.hpp>
+#include <boost/core/null_deleter.hpp>
 
 #include <boost/locale.hpp>
 
@@ -36,12 +42,41 @@ namespace Tools
 {
 	namespace
 	{
+		// The debug loop waits for the writer thread when the queue is full:
+		// no record is lost in verbose mode.
+		const size_t MaxQueuedRecordCount = 64 * 1024;
+
+		template <typename Backend>
+		using AsyncSink = sinks::asynchronous_sink<
+		    Backend,
+		    sinks::bounded_fifo_queue<MaxQueuedRecordCount, sinks::block_on_overflow>>;
+
+		// Mirror the filter and the enabled state of the logging core.
+		std::atomic<int> minSeverity{logging::trivial::trace};
+		std::atomic<bool> isLoggerEnabled{true};
+
 		//-------------------------------------------------------------------------
 		void SetLogSink(boost::shared_ptr<logging::sinks::sink> sink)
 		{
 			logging::core::get()->remove_all_sinks();
 			logging::core::get()->add_sink(sink);
 		}
+
+		//-------------------------------------------------------------------------
+		template <typename Backend, typename Formatter>
+		boost::shared_ptr<AsyncSink<Backend>> AddAsyncSink(
+			boost::shared_ptr<Backend> backend,
+			Formatter formatter,
+			const std::locale& loc)
+		{
+			auto sink = boost::make_shared<AsyncSink<Backend>>(backend);
+
+			sink->set_formatter(formatter);
+			// Set correct endocing for special char
+			sink->imbue(loc);
+			logging::core::get()->add_sink(sink);
+			return sink;
+		}
 	}
 
 	//-------------------------------------------------------------------------
@@ -49,38 +84,59 @@ namespace Tools
 	{		
 		boost::log::add_common_attributes();
 
-		auto fileSink = logging::add_file_log(logPath.wstring(),
-			boost::log::keywords::format =
+		// Only the UTF-8 conversion of the messages is used by the sinks:
+		// generating all the facets is a large part of the startup of a run.
+		boost::locale::generator generator;
+		generator.categories(boost::locale::codepage_facet);
+		generator.characters(boost::locale::char_facet | boost::locale::wchar_t_facet);
+		auto loc = generator("en_US.UTF-8");
+		auto fileBackend = boost::make_shared<sinks::text_file_backend>(
+			keywords::file_name = logPath.wstring());
+
+		AddAsyncSink(fileBackend,
 			expr::stream
 			<< "[" << expr::format_date_time< boost::posix_time::ptime >("TimeStamp", "%Y-%m-%d %H:%M:%S")
 			<< "] [" << logging::trivial::severity
-			<< "] " << expr::message);
+			<< "] " << expr::message,
+			loc);
+
+		auto consoleBackend = boost::make_shared<sinks::text_ostream_backend>();
 
-		auto consoleSink = logging::add_console_log(std::clog,
-			boost::log::keywords::format =
+		consoleBackend->add_stream(boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+		AddAsyncSink(consoleBackend,
 			expr::stream
 			<< "[" << logging::trivial::severity
-			<< "] " << expr::message
-			);
+			<< "] " << expr::message,
+			loc);
+	}
 
-		// Set correct endocing for special char
-		auto loc = boost::locale::generator()("en_US.UTF-8");		
-		fileSink->imbue(loc);
-		consoleSink->imbue(loc);		
+	//-------------------------------------------------------------------------
+	void FlushLog()
+	{
+		logging::core::get()->flush();
 	}
 
 	//-------------------------------------------------------------------------
-	void SetLoggerMinSeverity(boost::log::trivial::severity_level minSeverity)
+	void SetLoggerMinSeverity(boost::log::trivial::severity_level minSeverityLevel)
 	{
-		auto filter = logging::trivial::severity >= minSeverity;
+		auto filter = logging::trivial::severity >= minSeverityLevel;
 
 		logging::core::get()->set_filter(filter);		
+		minSeverity = minSeverityLevel;
+	}
+
+	//-------------------------------------------------------------------------
+	bool IsLogSeverityEnabled(boost::log::trivial::severity_level severity)
+	{
+		return isLoggerEnabled.load(std::memory_order_relaxed) &&
+		       severity >= minSeverity.load(std::memory_order_relaxed);
 	}
 
 	//-------------------------------------------------------------------------
 	void EnableLogger(bool isEnabled)
 	{
 		logging::core::get()->set_logging_enabled(isEnabled);
+		isLoggerEnabled = isEnabled;
 	}
 
 	//-------------------------------------------------------------------------
@@ -94,4 +150,4 @@ namespace Tools
 		backend->auto_flush(true);
 		SetLogSink(sink);
 	}	
-}
\ No newline at end of file
+}
@@ -27,16 +27,26 @@
 // Define the logger
 BOOST_LOG_INLINE_GLOBAL_LOGGER_DEFAULT(globalLogger, boost::log::sources::wseverity_logger<boost::log::trivial::severity_level >)
 
-#define LOG_TRACE BOOST_LOG_SEV  (globalLogger::get(), boost::log::trivial::trace) 
-#define LOG_DEBUG BOOST_LOG_SEV  (globalLogger::get(), boost::log::trivial::debug) 
-#define LOG_INFO BOOST_LOG_SEV   (globalLogger::get(), boost::log::trivial::info) 
-#define LOG_WARNING BOOST_LOG_SEV(globalLogger::get(), boost::log::trivial::warning) 
-#define LOG_ERROR BOOST_LOG_SEV  (globalLogger::get(), boost::log::trivial::error) 
+// The message is built only when the severity is enabled: the check does not
+// go through the filter of the logging core.
+#define LOG_SEV(severity) \
+	if (!Tools::IsLogSeverityEnabled(severity)) {} else BOOST_LOG_SEV(globalLogger::get(), severity)
+
+#define LOG_TRACE LOG_SEV  (boost::log::trivial::trace) 
+#define LOG_DEBUG LOG_SEV  (boost::log::trivial::debug) 
+#define LOG_INFO LOG_SEV   (boost::log::trivial::info) 
+#define LOG_WARNING LOG_SEV(boost::log::trivial::warning) 
+#define LOG_ERROR LOG_SEV  (boost::log::trivial::error) 
 
 namespace Tools
 {
+	// The records are formatted and written by a writer thread. The debug
+	// loop waits only when the queue of the records is full.
 	void TOOLS_DLL InitConsoleAndFileLog(const std::filesystem::path& logPath);
+	// Wait until the records of InitConsoleAndFileLog are written.
+	void TOOLS_DLL FlushLog();
 	void TOOLS_DLL SetLoggerMinSeverity(boost::log::trivial::severity_level minSeverity);
+	bool TOOLS_DLL IsLogSeverityEnabled(boost::log::trivial::severity_level severity);
 	void TOOLS_DLL EnableLogger(bool isEnabled);
 	void TOOLS_DLL InitLoggerOstream(const boost::shared_ptr<std::ostringstream>& ostr);
 }
@@ -20,44 +20,62 @@
 #include "ToolsException.hpp"
 #include "Tools/Tool.hpp"
 
+#include <cstring>
 #include <boost/iostreams/device/mapped_file.hpp>
 
 namespace Tools
 {
 	//-------------------------------------------------------------------------
-	MappedFile::MappedFile(const std::filesystem::path& path)
+	MappedFile::MappedFile(const std::filesystem::path& path, bool splitLines)
+		: mappedFile_{std::make_unique<boost::iostreams::mapped_file_source>(path.string())}
 	{
-		boost::iostreams::mapped_file mappedFile(path.string(), boost::iostreams::mapped_file::readonly);
-
-		if (!mappedFile)
+		if (!mappedFile_->is_open())
 			THROW(L"Cannot create mapped file: " + path.wstring());
+		if (!splitLines)
+			return;
+
+		const char* begin = mappedFile_->data();
+		const char* const end = begin + mappedFile_->size();
 
-		auto begin = mappedFile.const_begin();
-		const auto end = mappedFile.const_end();
-		for (auto it = begin; it != end; ++it)
+		// memchr is vectorized by the CRT.
+		while (const auto* it = static_cast<const char*>(std::memchr(begin, '\n', static_cast<size_t>(end - begin))))
 		{
-			if (*it == '\n')
-			{
-				const auto endOfLine = (it != begin && *(it - 1) == '\r') ? it - 1 : it;
-				lines_.push_back({ begin, endOfLine });
-				begin = it + 1;
-			}
+			const auto* endOfLine = (it != begin && *(it - 1) == '\r') ? it - 1 : it;
+			lines_.emplace_back(begin, static_cast<size_t>(endOfLine - begin));
+			begin = it + 1;
 		}
 		if (begin != end)
-			lines_.push_back({begin, end});
+			lines_.emplace_back(begin, static_cast<size_t>(end - begin));
 	}
 
 	//-------------------------------------------------------------------------
-	const std::vector<std::string>& MappedFile::GetLines() const
+	MappedFile::~MappedFile() = default;
+
+	//-------------------------------------------------------------------------
+	const std::vector<std::string_view>& MappedFile::GetLines() const
 	{
 		return lines_;
 	}
 
+	//-------------------------------------------------------------------------
+	std::string_view MappedFile::GetContent() const
+	{
+		return { mappedFile_->data(), mappedFile_->size() };
+	}
+
 	//-------------------------------------------------------------------------
 	std::unique_ptr<MappedFile> MappedFile::TryCreate(const std::filesystem::path& path)
 	{
 		if (!FileExists(path) || std::filesystem::file_size(path) == 0)
 			return nullptr;
-		return std::unique_ptr<MappedFile>(new MappedFile{ path });
+		return std::unique_ptr<MappedFile>(new MappedFile{ path, true });
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<MappedFile> MappedFile::TryCreateBinary(const std::filesystem::path& path)
+	{
+		if (!FileExists(path) || std::filesystem::file_size(path) == 0)
+			return nullptr;
+		return std::unique_ptr<MappedFile>(new MappedFile{ path, false });
 	}
 }
@@ -17,28 +17,42 @@
 #pragma once
 
 #include <vector>
-#include <string>
+#include <string_view>
 #include <memory>
 #include <filesystem>
 
 #include "ToolsExport.hpp"
 
+namespace boost
+{
+	namespace iostreams
+	{
+		class mapped_file_source;
+	}
+}
+
 namespace Tools
 {
 	class TOOLS_DLL MappedFile
 	{
 	public:
 		static std::unique_ptr<MappedFile> TryCreate(const std::filesystem::path&);
-		
-		const std::vector<std::string>& GetLines() const;
+		// Do not split the content in lines: GetLines is empty.
+		static std::unique_ptr<MappedFile> TryCreateBinary(const std::filesystem::path&);
+		~MappedFile();
+
+		// The lines point into the mapping and are valid until this object is destroyed.
+		const std::vector<std::string_view>& GetLines() const;
+		std::string_view GetContent() const;
 
 		MappedFile(const MappedFile&) = delete;
 		MappedFile& operator=(const MappedFile&) = delete;
 		MappedFile(MappedFile&&) = default;
 
 	private:
-		explicit MappedFile(const std::filesystem::path&);
+		MappedFile(const std::filesystem::path&, bool splitLines);
 
-		std::vector<std::string> lines_;
+		std::unique_ptr<boost::iostreams::mapped_file_source> mappedFile_;
+		std::vector<std::string_view> lines_;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,80 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Tools
+{
+	// Estimates of the bytes allocated by the containers for --perf_stats.
+	// The size of the container object and the bookkeeping of the heap are
+	// not counted.
+
+	// Links of a node of std::map, std::set and std::unordered_map.
+	const uint64_t NodeOverhead = 3 * sizeof(void*);
+
+	//-------------------------------------------------------------------------
+	template <typename T>
+	uint64_t GetAllocatedSize(const std::vector<T>& values)
+	{
+		return values.capacity() * sizeof(T);
+	}
+
+	//-------------------------------------------------------------------------
+	template <typename T>
+	uint64_t GetAllocatedSize(const std::deque<T>& values)
+	{
+		return values.size() * sizeof(T);
+	}
+
+	//-------------------------------------------------------------------------
+	template <typename Char>
+	uint64_t GetAllocatedSize(const std::basic_string<Char>& value)
+	{
+		// The short strings are stored in the string object.
+		if ((value.capacity() + 1) * sizeof(Char) <= sizeof(value))
+			return 0;
+		return (value.capacity() + 1) * sizeof(Char);
+	}
+
+	//-------------------------------------------------------------------------
+	inline uint64_t GetAllocatedSize(const std::filesystem::path& path)
+	{
+		return GetAllocatedSize(path.native());
+	}
+
+	//-------------------------------------------------------------------------
+	// Nodes of a node based container, without what their values allocate.
+	template <typename Container>
+	uint64_t GetNodesSize(const Container& container)
+	{
+		return container.size() * (sizeof(typename Container::value_type) + NodeOverhead);
+	}
+
+	//-------------------------------------------------------------------------
+	// Nodes and buckets of an unordered container, without what their values
+	// allocate.
+	template <typename Container>
+	uint64_t GetHashNodesSize(const Container& container)
+	{
+		return GetNodesSize(container) + container.bucket_count() * 2 * sizeof(void*);
+	}
+}
@@ -0,0 +1,89 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+namespace Tools
+{
+	// Give a small integer id to each distinct path so the paths can be
+	// grouped by id instead of comparing std::filesystem::path which parses
+	// their components at each comparison.
+	class PathTable
+	{
+	public:
+		//---------------------------------------------------------------------
+		// The ids are given in the order of the first call for each path.
+		// The paths equal once normalized, such as a/b and a\.\b, have the
+		// same id and the first one is kept.
+		size_t Intern(const std::filesystem::path& path)
+		{
+			auto it = ids_.emplace(GetKey(path), paths_.size()).first;
+
+			if (it->second == paths_.size())
+				paths_.push_back(path);
+			return it->second;
+		}
+
+		//---------------------------------------------------------------------
+		// The id of an interned path. Unlike Intern, it can be called from
+		// several threads.
+		size_t GetId(const std::filesystem::path& path) const
+		{
+			return ids_.at(GetKey(path));
+		}
+
+		//---------------------------------------------------------------------
+		const std::filesystem::path& GetPath(size_t id) const
+		{
+			return paths_.at(id);
+		}
+
+		//---------------------------------------------------------------------
+		size_t GetCount() const
+		{
+			return paths_.size();
+		}
+
+		//---------------------------------------------------------------------
+		// All the ids in the order of std::filesystem::path.
+		std::vector<size_t> GetSortedIds() const
+		{
+			std::vector<size_t> ids(paths_.size());
+
+			for (size_t id = 0; id < ids.size(); ++id)
+				ids[id] = id;
+			std::sort(ids.begin(), ids.end(), [&](size_t id1, size_t id2) {
+				return paths_[id1] < paths_[id2];
+			});
+			return ids;
+		}
+
+	private:
+		//---------------------------------------------------------------------
+		static std::filesystem::path::string_type GetKey(const std::filesystem::path& path)
+		{
+			return path.lexically_normal().make_preferred().native();
+		}
+
+		std::unordered_map<std::filesystem::path::string_type, size_t> ids_;
+		std::vector<std::filesystem::path> paths_;
+	};
+}
@@ -0,0 +1,111 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace Tools
+{
+	// Character trie which finds, in a single walk over a string, the keys
+	// which are a prefix of this string.
+	class PrefixTrie
+	{
+	public:
+		//---------------------------------------------------------------------
+		PrefixTrie()
+			: nodes_(1)
+		{
+		}
+
+		//---------------------------------------------------------------------
+		// When the key is already present, the first value is kept.
+		template <typename Iterator>
+		void Add(Iterator begin, Iterator end, size_t value)
+		{
+			size_t node = 0;
+
+			for (auto it = begin; it != end; ++it)
+			{
+				auto& children = nodes_[node].children_;
+				auto child = children.find(*it);
+
+				if (child == children.end())
+				{
+					auto childNode = nodes_.size();
+					nodes_[node].children_.emplace(*it, childNode);
+					nodes_.emplace_back();
+					node = childNode;
+				}
+				else
+					node = child->second;
+			}
+			if (!nodes_[node].value_)
+				nodes_[node].value_ = value;
+		}
+
+		//---------------------------------------------------------------------
+		// Return the smallest value of the keys which are a prefix of [begin, end).
+		template <typename Iterator>
+		boost::optional<size_t> FindSmallestPrefixValue(Iterator begin, Iterator end) const
+		{
+			return FindSmallestPrefixValue(begin, end, [](Iterator) { return true; });
+		}
+
+		//---------------------------------------------------------------------
+		// Same as above for the keys whose end, the iterator after the last
+		// character of the key, is accepted by isKeyEnd.
+		template <typename Iterator, typename IsKeyEnd>
+		boost::optional<size_t> FindSmallestPrefixValue(Iterator begin,
+		                                                Iterator end,
+		                                                IsKeyEnd isKeyEnd) const
+		{
+			boost::optional<size_t> smallestValue;
+			size_t node = 0;
+
+			if (isKeyEnd(begin))
+				smallestValue = nodes_[0].value_;
+
+			for (auto it = begin; it != end; ++it)
+			{
+				const auto& children = nodes_[node].children_;
+				auto child = children.find(*it);
+
+				if (child == children.end())
+					break;
+				node = child->second;
+
+				const auto& value = nodes_[node].value_;
+				if (value && (!smallestValue || *value < *smallestValue) && isKeyEnd(std::next(it)))
+					smallestValue = value;
+			}
+			return smallestValue;
+		}
+
+	private:
+		struct Node
+		{
+			std::map<wchar_t, size_t> children_;
+			boost::optional<size_t> value_;
+		};
+
+		std::vector<Node> nodes_;
+	};
+}
@@ -19,8 +19,16 @@
 #include "ToolsException.hpp"
 #include "Log.hpp"
 
+#include <atomic>
+
 namespace Tools
 {
+	namespace
+	{
+		std::atomic<uint64_t> readBytes{0};
+		std::atomic<uint64_t> writtenBytes{0};
+	}
+
 	//-------------------------------------------------------------------------
 	std::vector<unsigned char>
 	ReadProcessMemory(HANDLE hProcess, void* address, size_t size)
@@ -46,7 +54,7 @@ namespace Tools
 		{
 			if (!::ReadProcessMemory(
 			        hProcess,
-			        reinterpret_cast<void*>(address),
+			        reinterpret_cast<void*>(address + totalBytesRead),
 			        &reinterpret_cast<char*>(buffer)[totalBytesRead],
 			        size - totalBytesRead,
 			        &bytesRead))
@@ -58,13 +66,15 @@ namespace Tools
 
 			totalBytesRead += bytesRead;
 		}
+		readBytes += totalBytesRead;
 	}
 
 	//-------------------------------------------------------------------------
 	void WriteProcessMemory(HANDLE hProcess,
 	                        void* address,
 	                        void* buffer,
-	                        size_t size)
+	                        size_t size,
+	                        bool flushInstructionCache)
 	{
 		SIZE_T totalWritten = 0;
 		SIZE_T written = 0;
@@ -72,8 +82,9 @@ namespace Tools
 		while (totalWritten < size)
 		{
 			auto startBuffer = static_cast<char*>(buffer) + totalWritten;
+			auto startAddress = static_cast<char*>(address) + totalWritten;
 			if (!::WriteProcessMemory(hProcess,
-			                          address,
+			                          startAddress,
 			                          startBuffer,
 			                          size - totalWritten,
 			                          &written))
@@ -84,9 +95,25 @@ namespace Tools
 			if (written == 0)
 				THROW("Cannot write process memory");
 
-			if (!FlushInstructionCache(hProcess, startBuffer, written))
+			if (flushInstructionCache &&
+			    !FlushInstructionCache(hProcess, startAddress, written))
+			{
 				THROW("Cannot flush memory:");
+			}
 			totalWritten += written;
 		}
+		writtenBytes += totalWritten;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t GetReadProcessMemoryBytes()
+	{
+		return readBytes;
+	}
+
+	//-------------------------------------------------------------------------
+	uint64_t GetWrittenProcessMemoryBytes()
+	{
+		return writtenBytes;
 	}
 }
@@ -24,10 +24,13 @@
 
 namespace Tools
 {
+	// When flushInstructionCache is false, the caller is responsible
+	// for calling FlushInstructionCache on the written memory.
 	TOOLS_DLL void WriteProcessMemory(HANDLE hProcess,
 	                                  void* address,
 	                                  void* buffer,
-	                                  size_t size);
+	                                  size_t size,
+	                                  bool flushInstructionCache = true);
 
 	TOOLS_DLL std::vector<unsigned char>
 	ReadProcessMemory(HANDLE hProcess, void* address, size_t size);
@@ -37,6 +40,11 @@ namespace Tools
 	                                 void* buffer,
 	                                 SIZE_T size);
 
+	// Bytes read and written by the functions above since the start of the
+	// program, for all the threads.
+	TOOLS_DLL uint64_t GetReadProcessMemoryBytes();
+	TOOLS_DLL uint64_t GetWrittenProcessMemoryBytes();
+
 	//-------------------------------------------------------------------------
 	template <typename T>
 	std::unique_ptr<T> ReadStructInProcessMemory(HANDLE hProcess,
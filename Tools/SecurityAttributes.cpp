@@ -0,0 +1,92 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SecurityAttributes.hpp"
+
+#include <memory>
+#include <vector>
+#include <sddl.h>
+
+#include "ToolsException.hpp"
+
+namespace Tools
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::wstring GetCurrentUserSid()
+		{
+			HANDLE hToken = nullptr;
+			if (!OpenProcessToken(GetCurrentProcess(), TOKEN_QUERY, &hToken))
+				THROW(L"Cannot open the process token: " << GetLastError());
+			std::unique_ptr<void, decltype(&CloseHandle)> token{hToken, &CloseHandle};
+
+			DWORD size = 0;
+			GetTokenInformation(hToken, TokenUser, nullptr, 0, &size);
+			std::vector<char> buffer(size);
+			if (!GetTokenInformation(hToken, TokenUser, buffer.data(), size, &size))
+				THROW(L"Cannot get the user of the process token: " << GetLastError());
+
+			wchar_t* sid = nullptr;
+			const auto& tokenUser = *reinterpret_cast<const TOKEN_USER*>(buffer.data());
+			if (!ConvertSidToStringSidW(tokenUser.User.Sid, &sid))
+				THROW(L"Cannot convert the user SID: " << GetLastError());
+			std::unique_ptr<wchar_t, decltype(&LocalFree)> sidOwner{sid, &LocalFree};
+
+			return sid;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	SecurityAttributes SecurityAttributes::CreateForCurrentUser()
+	{
+		// A protected DACL: the inherited entries are ignored.
+		return SecurityAttributes{L"D:P(A;;GA;;;SY)(A;;GA;;;" + GetCurrentUserSid() + L")"};
+	}
+
+	//-------------------------------------------------------------------------
+	SecurityAttributes SecurityAttributes::CreateForAuthenticatedUsers()
+	{
+		return SecurityAttributes{L"D:P(A;;GA;;;SY)(A;;GA;;;AU)"};
+	}
+
+	//-------------------------------------------------------------------------
+	SecurityAttributes::SecurityAttributes(const std::wstring& sddl)
+	    : attributes_{sizeof(SECURITY_ATTRIBUTES), nullptr, FALSE}
+	{
+		if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(
+		        sddl.c_str(),
+		        SDDL_REVISION_1,
+		        &attributes_.lpSecurityDescriptor,
+		        nullptr))
+		{
+			THROW(L"Cannot create the security descriptor " << sddl << L": " << GetLastError());
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	SecurityAttributes::~SecurityAttributes()
+	{
+		LocalFree(attributes_.lpSecurityDescriptor);
+	}
+
+	//-------------------------------------------------------------------------
+	SECURITY_ATTRIBUTES* SecurityAttributes::Get()
+	{
+		return &attributes_;
+	}
+}
@@ -0,0 +1,48 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <Windows.h>
+#include <string>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Security descriptor of the named objects shared with the other processes.
+	class TOOLS_DLL SecurityAttributes
+	{
+	public:
+		// Give access only to the current user and to the system.
+		static SecurityAttributes CreateForCurrentUser();
+		// Give access to the users logged on the machine and to the system, for
+		// the objects shared by the runs of all the sessions.
+		static SecurityAttributes CreateForAuthenticatedUsers();
+
+		// sddl is a security descriptor string, for example L"D:P(A;;GA;;;SY)".
+		explicit SecurityAttributes(const std::wstring& sddl);
+		~SecurityAttributes();
+
+		SECURITY_ATTRIBUTES* Get();
+
+		SecurityAttributes(const SecurityAttributes&) = delete;
+		SecurityAttributes& operator=(const SecurityAttributes&) = delete;
+
+	private:
+		SECURITY_ATTRIBUTES attributes_;
+	};
+}
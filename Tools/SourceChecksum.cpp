@@ -0,0 +1,92 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SourceChecksum.hpp"
+
+#include <algorithm>
+#include <bcrypt.h>
+
+#include "ScopedAction.hpp"
+
+namespace Tools
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		LPCWSTR GetAlgorithm(SourceChecksum::Type type)
+		{
+			switch (type)
+			{
+				case SourceChecksum::Type::Md5: return BCRYPT_MD5_ALGORITHM;
+				case SourceChecksum::Type::Sha1: return BCRYPT_SHA1_ALGORITHM;
+				case SourceChecksum::Type::Sha256: return BCRYPT_SHA256_ALGORITHM;
+				default: return nullptr;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool operator==(const SourceChecksum& checksum1, const SourceChecksum& checksum2)
+	{
+		return checksum1.type_ == checksum2.type_ && checksum1.bytes_ == checksum2.bytes_;
+	}
+
+	//-------------------------------------------------------------------------
+	bool operator!=(const SourceChecksum& checksum1, const SourceChecksum& checksum2)
+	{
+		return !(checksum1 == checksum2);
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<SourceChecksum> ComputeSourceChecksum(
+	    SourceChecksum::Type type, std::string_view content)
+	{
+		auto algorithm = GetAlgorithm(type);
+		BCRYPT_ALG_HANDLE hAlgorithm = nullptr;
+
+		if (!algorithm || BCryptOpenAlgorithmProvider(&hAlgorithm, algorithm, nullptr, 0) != 0)
+			return boost::none;
+		ScopedAction closeAlgorithm{ [=]() { BCryptCloseAlgorithmProvider(hAlgorithm, 0); } };
+
+		DWORD hashSize = 0;
+		ULONG resultSize = 0;
+		BCRYPT_HASH_HANDLE hHash = nullptr;
+		if (BCryptGetProperty(hAlgorithm, BCRYPT_HASH_LENGTH, reinterpret_cast<PUCHAR>(&hashSize),
+		                      sizeof(hashSize), &resultSize, 0) != 0 ||
+		    BCryptCreateHash(hAlgorithm, &hHash, nullptr, 0, nullptr, 0, 0) != 0)
+		{
+			return boost::none;
+		}
+		ScopedAction destroyHash{ [=]() { BCryptDestroyHash(hHash); } };
+
+		// BCryptHashData takes at most ULONG bytes at a time.
+		auto data = reinterpret_cast<PUCHAR>(const_cast<char*>(content.data()));
+		for (size_t offset = 0; offset < content.size();)
+		{
+			auto size = static_cast<ULONG>((std::min)(content.size() - offset, size_t{ 1 } << 30));
+
+			if (BCryptHashData(hHash, data + offset, size, 0) != 0)
+				return boost::none;
+			offset += size;
+		}
+
+		SourceChecksum checksum{ type, std::string(hashSize, '\0') };
+		if (BCryptFinishHash(hHash, reinterpret_cast<PUCHAR>(&checksum.bytes_[0]), hashSize, 0) != 0)
+			return boost::none;
+		return checksum;
+	}
+}
@@ -0,0 +1,51 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <boost/optional.hpp>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Checksum of a source file recorded by the compiler in the PDB. The
+	// values of Type are the ones of CV_SourceChksum_t.
+	struct TOOLS_DLL SourceChecksum
+	{
+		enum class Type : uint8_t
+		{
+			None = 0,
+			Md5 = 1,
+			Sha1 = 2,
+			Sha256 = 3
+		};
+
+		Type type_ = Type::None;
+		std::string bytes_;
+	};
+
+	TOOLS_DLL bool operator==(const SourceChecksum&, const SourceChecksum&);
+	TOOLS_DLL bool operator!=(const SourceChecksum&, const SourceChecksum&);
+
+	// The checksum of content computed like the compiler does.
+	// boost::none when type is not supported.
+	TOOLS_DLL boost::optional<SourceChecksum> ComputeSourceChecksum(
+	    SourceChecksum::Type type, std::string_view content);
+}
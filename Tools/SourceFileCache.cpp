@@ -0,0 +1,185 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "SourceFileCache.hpp"
+
+#include "Log.hpp"
+#include "MappedFile.hpp"
+#include "Tool.hpp"
+
+namespace fs = std::filesystem;
+
+namespace Tools
+{
+	//-------------------------------------------------------------------------
+#ifdef _WIN64
+	const uintmax_t SourceFileCache::DefaultMaxMappedSize = uintmax_t{ 1024 } * 1024 * 1024;
+#else
+	const uintmax_t SourceFileCache::DefaultMaxMappedSize = uintmax_t{ 256 } * 1024 * 1024;
+#endif
+
+	//-------------------------------------------------------------------------
+	SourceFileCache::SourceFileCache(uintmax_t maxMappedSize)
+		: mappedSize_{ 0 }
+		, maxMappedSize_{ maxMappedSize }
+		, mappedFileCount_{ 0 }
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	SourceFileCache::~SourceFileCache() = default;
+
+	//-------------------------------------------------------------------------
+	std::shared_ptr<const MappedFile> SourceFileCache::TryGet(const fs::path& sourcePath)
+	{
+		auto path = GetLocalPath(sourcePath);
+		std::error_code error;
+		auto lastWriteTime = fs::last_write_time(path, error);
+		auto size = error ? 0 : fs::file_size(path, error);
+
+		if (error || size == 0)
+			return nullptr;
+
+		auto key = path.wstring();
+		{
+			std::lock_guard<std::mutex> lock{ mutex_ };
+			auto it = entries_.find(key);
+
+			if (it != entries_.end() && it->second.lastWriteTime_ == lastWriteTime && it->second.size_ == size)
+			{
+				usageOrder_.splice(usageOrder_.end(), usageOrder_, it->second.usage_);
+				return it->second.file_;
+			}
+		}
+
+		// The file is mapped without the lock so several files can be mapped
+		// at the same time.
+		std::shared_ptr<const MappedFile> file = MappedFile::TryCreate(path);
+		if (!file)
+			return nullptr;
+		CheckChecksum(sourcePath, *file);
+
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		auto& entry = entries_[key];
+
+		++mappedFileCount_;
+		if (entry.file_)
+		{
+			mappedSize_ -= entry.size_;
+			usageOrder_.splice(usageOrder_.end(), usageOrder_, entry.usage_);
+		}
+		else
+			usageOrder_.push_back(key);
+		entry = Entry{ file, lastWriteTime, size, std::prev(usageOrder_.end()) };
+		mappedSize_ += size;
+		Release();
+
+		return file;
+	}
+
+	//-------------------------------------------------------------------------
+	int SourceFileCache::GetMappedFileCount() const
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		return mappedFileCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void SourceFileCache::SetLocalCopy(const fs::path& sourcePath, const fs::path& localPath)
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		localCopies_[sourcePath.wstring()] = localPath;
+	}
+
+	//-------------------------------------------------------------------------
+	fs::path SourceFileCache::GetLocalPath(const fs::path& sourcePath) const
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		auto it = localCopies_.find(sourcePath.wstring());
+
+		return it != localCopies_.end() ? it->second : sourcePath;
+	}
+
+	//-------------------------------------------------------------------------
+	bool SourceFileCache::Exists(const fs::path& sourcePath) const
+	{
+		return FileExists(GetLocalPath(sourcePath));
+	}
+
+	//-------------------------------------------------------------------------
+	void SourceFileCache::SetChecksum(const fs::path& sourcePath, const SourceChecksum& checksum)
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		checksums_[sourcePath.wstring()] = checksum;
+	}
+
+	//-------------------------------------------------------------------------
+	boost::optional<SourceChecksum> SourceFileCache::GetChecksum(const fs::path& sourcePath) const
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		auto it = checksums_.find(sourcePath.wstring());
+
+		if (it == checksums_.end())
+			return boost::none;
+		return it->second;
+	}
+
+	//-------------------------------------------------------------------------
+	int SourceFileCache::GetChecksumMismatchCount() const
+	{
+		std::lock_guard<std::mutex> lock{ mutex_ };
+
+		return static_cast<int>(mismatchedSources_.size());
+	}
+
+	//-------------------------------------------------------------------------
+	// The content is hashed without the lock, like it is mapped.
+	void SourceFileCache::CheckChecksum(const fs::path& sourcePath, const MappedFile& file)
+	{
+		auto checksum = GetChecksum(sourcePath);
+		if (!checksum)
+			return;
+
+		auto contentChecksum = ComputeSourceChecksum(checksum->type_, file.GetContent());
+		if (!contentChecksum || *contentChecksum == *checksum)
+			return;
+
+		std::lock_guard<std::mutex> lock{ mutex_ };
+		if (mismatchedSources_.insert(sourcePath.wstring()).second)
+		{
+			LOG_WARNING << sourcePath.wstring() << L" is not the version the module was built from: "
+			            << L"its lines in the report may be wrong.";
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	// The files still used by a consumer stay mapped until it releases them.
+	void SourceFileCache::Release()
+	{
+		while (mappedSize_ > maxMappedSize_ && usageOrder_.size() > 1)
+		{
+			auto it = entries_.find(usageOrder_.front());
+
+			usageOrder_.pop_front();
+			mappedSize_ -= it->second.size_;
+			entries_.erase(it);
+		}
+	}
+}
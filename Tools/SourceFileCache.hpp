@@ -0,0 +1,100 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <boost/optional.hpp>
+
+#include "ToolsExport.hpp"
+#include "SourceChecksum.hpp"
+
+namespace Tools
+{
+	class MappedFile;
+
+	// Source files mapped and split in lines once and shared by the filters
+	// and the exporters of a run. A file is mapped again when its size or its
+	// last write time changed. The least recently used files are released
+	// when the mapped size is above the maximum.
+	// A source can be read from a local copy, a source fetched from a source
+	// server for example: the consumers still use the path of the source.
+	// The checksum of a source recorded in the PDB is compared with the
+	// content each time the source is mapped.
+	class TOOLS_DLL SourceFileCache
+	{
+	public:
+		// Lower in a 32-bit process whose address space is shared with the
+		// rest of the run.
+		static const uintmax_t DefaultMaxMappedSize;
+
+		explicit SourceFileCache(uintmax_t maxMappedSize = DefaultMaxMappedSize);
+		~SourceFileCache();
+
+		// Null when the file does not exist or is empty, like MappedFile::TryCreate.
+		// Can be called from several threads.
+		std::shared_ptr<const MappedFile> TryGet(const std::filesystem::path&);
+		int GetMappedFileCount() const;
+
+		// Can be called from several threads.
+		void SetLocalCopy(const std::filesystem::path& sourcePath, const std::filesystem::path& localPath);
+		// The path the source is read from: its local copy or sourcePath.
+		std::filesystem::path GetLocalPath(const std::filesystem::path& sourcePath) const;
+		// The source or its local copy exists.
+		bool Exists(const std::filesystem::path& sourcePath) const;
+
+		// Can be called from several threads.
+		void SetChecksum(const std::filesystem::path& sourcePath, const SourceChecksum&);
+		boost::optional<SourceChecksum> GetChecksum(const std::filesystem::path& sourcePath) const;
+		// Number of sources whose content does not match their checksum: the
+		// module was built from another version of the source.
+		int GetChecksumMismatchCount() const;
+
+	private:
+		SourceFileCache(const SourceFileCache&) = delete;
+		SourceFileCache& operator=(const SourceFileCache&) = delete;
+
+		struct Entry
+		{
+			std::shared_ptr<const MappedFile> file_;
+			std::filesystem::file_time_type lastWriteTime_;
+			uintmax_t size_;
+			// The position of the entry in usageOrder_.
+			std::list<std::wstring>::iterator usage_;
+		};
+
+		void Release();
+		void CheckChecksum(const std::filesystem::path& sourcePath, const MappedFile&);
+
+		mutable std::mutex mutex_;
+		std::unordered_map<std::wstring, Entry> entries_;
+		// The least recently used first.
+		std::list<std::wstring> usageOrder_;
+		std::unordered_map<std::wstring, std::filesystem::path> localCopies_;
+		std::unordered_map<std::wstring, SourceChecksum> checksums_;
+		std::unordered_set<std::wstring> mismatchedSources_;
+		uintmax_t mappedSize_;
+		const uintmax_t maxMappedSize_;
+		int mappedFileCount_;
+	};
+}
@@ -0,0 +1,172 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ThreadPlacement.hpp"
+
+#include <algorithm>
+#include <Windows.h>
+
+#include "Log.hpp"
+#include "ToolsException.hpp"
+
+namespace Tools
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		size_t GetProcessorCount(uint64_t mask)
+		{
+			size_t count = 0;
+
+			for (; mask; mask &= mask - 1)
+				++count;
+			return count;
+		}
+
+		//---------------------------------------------------------------------
+		void SetCurrentThreadAffinity(const ProcessorGroupAffinity& affinity)
+		{
+			GROUP_AFFINITY groupAffinity{};
+
+			groupAffinity.Group = affinity.group_;
+			groupAffinity.Mask = static_cast<KAFFINITY>(affinity.mask_);
+			if (!SetThreadGroupAffinity(GetCurrentThread(), &groupAffinity, nullptr))
+				LOG_WARNING << L"Cannot set the affinity of the thread: " << GetLastError();
+		}
+
+		//---------------------------------------------------------------------
+		// The processors the threads can use, by group.
+		std::vector<uint64_t> GetAllowedMasks()
+		{
+			std::vector<uint64_t> masks(GetActiveProcessorGroupCount(), ~uint64_t{0});
+			DWORD_PTR processMask = 0;
+			DWORD_PTR systemMask = 0;
+
+			// Both masks are 0 when the process already runs in several groups.
+			if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask) &&
+			    processMask != systemMask)
+			{
+				USHORT groupCount = 1;
+				USHORT group = 0;
+
+				GetProcessGroupAffinity(GetCurrentProcess(), &groupCount, &group);
+				std::fill(masks.begin(), masks.end(), 0);
+				if (group < masks.size())
+					masks[group] = processMask;
+			}
+			return masks;
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	bool ProcessorGroupAffinity::operator==(const ProcessorGroupAffinity& other) const
+	{
+		return group_ == other.group_ && mask_ == other.mask_;
+	}
+
+	//-------------------------------------------------------------------------
+	ThreadPlacement::ThreadPlacement(std::vector<ProcessorGroupAffinity> cores)
+	{
+		if (cores.empty())
+			THROW("No processor for the threads.");
+
+		const auto& lastCore = cores.back();
+
+		debugLoopAffinity_ = {lastCore.group_, lastCore.mask_ & (~lastCore.mask_ + 1)};
+		// A single core is shared by the debug loop and the workers.
+		if (cores.size() > 1)
+			cores.pop_back();
+		for (const auto& core : cores)
+		{
+			auto it = std::find_if(workerAffinities_.begin(), workerAffinities_.end(), [&](const auto& affinity) {
+				return affinity.group_ == core.group_;
+			});
+
+			if (it == workerAffinities_.end())
+				it = workerAffinities_.insert(it, {core.group_, 0});
+			it->mask_ |= core.mask_;
+		}
+		for (size_t i = 0; i < workerAffinities_.size(); ++i)
+			workerProcessors_.insert(workerProcessors_.end(), GetProcessorCount(workerAffinities_[i].mask_), i);
+	}
+
+	//-------------------------------------------------------------------------
+	std::unique_ptr<ThreadPlacement> ThreadPlacement::CreateFromSystem()
+	{
+		DWORD size = 0;
+
+		GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &size);
+
+		std::vector<char> buffer(size);
+		auto information = reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data());
+
+		if (!size || !GetLogicalProcessorInformationEx(RelationProcessorCore, information, &size))
+			THROW("Cannot get the processor cores: " << GetLastError());
+
+		auto allowedMasks = GetAllowedMasks();
+		std::vector<ProcessorGroupAffinity> cores;
+
+		for (DWORD offset = 0; offset < size;)
+		{
+			const auto& core = *reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(&buffer[offset]);
+			// The processors of a core are in a single group.
+			const auto& groupMask = core.Processor.GroupMask[0];
+
+			if (groupMask.Group < allowedMasks.size())
+			{
+				auto mask = static_cast<uint64_t>(groupMask.Mask) & allowedMasks[groupMask.Group];
+
+				if (mask)
+					cores.push_back({groupMask.Group, mask});
+			}
+			offset += core.Size;
+		}
+		return std::make_unique<ThreadPlacement>(std::move(cores));
+	}
+
+	//-------------------------------------------------------------------------
+	ProcessorGroupAffinity ThreadPlacement::GetDebugLoopAffinity() const
+	{
+		return debugLoopAffinity_;
+	}
+
+	//-------------------------------------------------------------------------
+	ProcessorGroupAffinity ThreadPlacement::GetWorkerAffinity(size_t workerIndex) const
+	{
+		return workerAffinities_[workerProcessors_[workerIndex % workerProcessors_.size()]];
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ThreadPlacement::GetWorkerProcessorCount() const
+	{
+		return workerProcessors_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPlacement::PlaceDebugLoopThread() const
+	{
+		SetCurrentThreadAffinity(debugLoopAffinity_);
+		if (!SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_HIGHEST))
+			LOG_WARNING << L"Cannot set the priority of the debug loop: " << GetLastError();
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPlacement::PlaceWorkerThread(size_t workerIndex) const
+	{
+		SetCurrentThreadAffinity(GetWorkerAffinity(workerIndex));
+	}
+}
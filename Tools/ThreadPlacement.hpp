@@ -0,0 +1,75 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	// Logical processors of a processor group: Windows runs a thread in a
+	// single group, of at most 64 logical processors.
+	struct TOOLS_DLL ProcessorGroupAffinity
+	{
+		bool operator==(const ProcessorGroupAffinity&) const;
+
+		unsigned short group_;
+		uint64_t mask_;
+	};
+
+	// Run the debug loop on its own physical core and the workers on the
+	// other cores: the debuggee waits for the debug loop at each debug event,
+	// so the workers must not delay it.
+	class TOOLS_DLL ThreadPlacement
+	{
+	public:
+		// cores are the logical processors of each physical core, in the order
+		// of the processors. The debug loop uses the last core, the one the
+		// scheduler tends to use last.
+		explicit ThreadPlacement(std::vector<ProcessorGroupAffinity> cores);
+
+		// The cores of all the processor groups, or only the processors of the
+		// affinity of the process when it is restricted: this affinity is
+		// inherited by the debuggee and is never changed.
+		static std::unique_ptr<ThreadPlacement> CreateFromSystem();
+
+		// A single logical processor of the last core.
+		ProcessorGroupAffinity GetDebugLoopAffinity() const;
+		// The processors of the other cores in the group of the worker. The
+		// workers fill the groups in order, one by processor.
+		ProcessorGroupAffinity GetWorkerAffinity(size_t workerIndex) const;
+		size_t GetWorkerProcessorCount() const;
+
+		// The debug loop runs on the calling thread, with the highest priority.
+		void PlaceDebugLoopThread() const;
+		// Called by the ThreadPool workers.
+		void PlaceWorkerThread(size_t workerIndex) const;
+
+	private:
+		ThreadPlacement(const ThreadPlacement&) = delete;
+		ThreadPlacement& operator=(const ThreadPlacement&) = delete;
+
+		ProcessorGroupAffinity debugLoopAffinity_;
+		// The affinity of each group with processors for the workers.
+		std::vector<ProcessorGroupAffinity> workerAffinities_;
+		// The index in workerAffinities_ of each processor of the workers.
+		std::vector<size_t> workerProcessors_;
+	};
+}
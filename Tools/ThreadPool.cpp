@@ -0,0 +1,334 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "ThreadPool.hpp"
+
+#include "ThreadPlacement.hpp"
+
+namespace Tools
+{
+	namespace
+	{
+		std::atomic<size_t> defaultThreadCount{0};
+		std::shared_ptr<const ThreadPlacement> defaultThreadPlacement;
+
+		// The worker running the current thread.
+		thread_local const ThreadPool* currentThreadPool = nullptr;
+		thread_local size_t currentQueueIndex = 0;
+	}
+
+	//-------------------------------------------------------------------------
+	ThreadPool::ThreadPool(
+		size_t threadCount,
+		std::shared_ptr<const ThreadPlacement> threadPlacement)
+	    : threadPlacement_{std::move(threadPlacement)},
+	      nextQueue_{0},
+	      queuedTaskCount_{0},
+	      isStopping_{false}
+	{
+		if (!threadCount && threadPlacement_)
+			threadCount = threadPlacement_->GetWorkerProcessorCount() + 1;
+		if (!threadCount)
+			threadCount = std::thread::hardware_concurrency();
+		threadCount = (std::max)(threadCount, size_t{1});
+
+		// The queue 0 has no worker: its tasks are stolen.
+		for (size_t i = 0; i < threadCount; ++i)
+			queues_.push_back(std::make_unique<TaskQueue>());
+		for (size_t i = 1; i < threadCount; ++i)
+			workers_.emplace_back([this, i]() { RunWorker(i); });
+	}
+
+	//-------------------------------------------------------------------------
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			isStopping_ = true;
+		}
+		condition_.notify_all();
+		for (auto& worker : workers_)
+			worker.join();
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPool::SetDefaultThreadCount(size_t threadCount)
+	{
+		defaultThreadCount = threadCount;
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPool::SetDefaultThreadPlacement(
+		std::shared_ptr<const ThreadPlacement> threadPlacement)
+	{
+		std::atomic_store(&defaultThreadPlacement, std::move(threadPlacement));
+	}
+
+	//-------------------------------------------------------------------------
+	ThreadPool& ThreadPool::GetDefault()
+	{
+		// Never destroyed: the workers are not joined while the process exits.
+		static auto* threadPool = new ThreadPool{
+			defaultThreadCount, std::atomic_load(&defaultThreadPlacement)};
+
+		return *threadPool;
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ThreadPool::GetThreadCount() const
+	{
+		return queues_.size();
+	}
+
+	//-------------------------------------------------------------------------
+	size_t ThreadPool::GetCurrentThreadIndex() const
+	{
+		return currentThreadPool == this ? currentQueueIndex : 0;
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPool::Push(TaskGroup& group, std::function<void()> function)
+	{
+		auto queueIndex = currentThreadPool == this
+		                      ? currentQueueIndex
+		                      : nextQueue_++ % queues_.size();
+		auto& queue = *queues_[queueIndex];
+
+		// The counters are increased first: a task can be popped as soon as
+		// it is queued.
+		group.OnTaskQueued();
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			++queuedTaskCount_;
+		}
+		{
+			std::lock_guard<std::mutex> lock{queue.mutex_};
+			queue.tasks_.push_back(QueuedTask{&group, std::move(function)});
+		}
+		condition_.notify_one();
+	}
+
+	//-------------------------------------------------------------------------
+	bool ThreadPool::TryPop(size_t queueIndex, const TaskGroup* group, QueuedTask& task)
+	{
+		auto isSelected = [&](const QueuedTask& queuedTask) {
+			return !group || queuedTask.group_ == group;
+		};
+		bool isPopped = false;
+
+		for (size_t i = 0; i < queues_.size() && !isPopped; ++i)
+		{
+			auto& queue = *queues_[(queueIndex + i) % queues_.size()];
+			std::lock_guard<std::mutex> lock{queue.mutex_};
+			auto& tasks = queue.tasks_;
+
+			if (i == 0)
+			{
+				// The last task of its own queue uses the data still in the cache.
+				auto it = std::find_if(tasks.rbegin(), tasks.rend(), isSelected);
+				if (it != tasks.rend())
+				{
+					task = std::move(*it);
+					tasks.erase(std::next(it).base());
+					isPopped = true;
+				}
+			}
+			else
+			{
+				auto it = std::find_if(tasks.begin(), tasks.end(), isSelected);
+				if (it != tasks.end())
+				{
+					task = std::move(*it);
+					tasks.erase(it);
+					isPopped = true;
+				}
+			}
+		}
+
+		if (isPopped)
+		{
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				--queuedTaskCount_;
+			}
+			task.group_->OnTaskPopped();
+		}
+		return isPopped;
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPool::Execute(QueuedTask& task)
+	{
+		std::exception_ptr error;
+
+		if (!task.group_->IsCanceled())
+		{
+			try
+			{
+				task.function_();
+			}
+			catch (...)
+			{
+				error = std::current_exception();
+			}
+		}
+		task.group_->OnTaskDone(error);
+	}
+
+	//-------------------------------------------------------------------------
+	void ThreadPool::RunWorker(size_t queueIndex)
+	{
+		currentThreadPool = this;
+		currentQueueIndex = queueIndex;
+		if (threadPlacement_)
+			threadPlacement_->PlaceWorkerThread(queueIndex - 1);
+
+		while (true)
+		{
+			QueuedTask task;
+
+			if (TryPop(queueIndex, nullptr, task))
+				Execute(task);
+			else
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+
+				condition_.wait(lock, [&]() { return isStopping_ || queuedTaskCount_ > 0; });
+				if (isStopping_ && !queuedTaskCount_)
+					return;
+			}
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	TaskGroup::TaskGroup(ThreadPool& threadPool)
+	    : threadPool_{threadPool},
+	      isCanceled_{false},
+	      pendingTaskCount_{0},
+	      queuedTaskCount_{0}
+	{
+	}
+
+	//-------------------------------------------------------------------------
+	TaskGroup::~TaskGroup()
+	{
+		Cancel();
+		try
+		{
+			Wait();
+		}
+		catch (...)
+		{
+		}
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::Run(std::function<void()> function)
+	{
+		threadPool_.Push(*this, std::move(function));
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::Wait()
+	{
+		auto queueIndex = threadPool_.GetCurrentThreadIndex();
+
+		while (true)
+		{
+			ThreadPool::QueuedTask task;
+
+			if (threadPool_.TryPop(queueIndex, this, task))
+			{
+				threadPool_.Execute(task);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock{mutex_};
+
+			if (!pendingTaskCount_)
+				break;
+			if (queuedTaskCount_)
+			{
+				// Counted but not yet in its queue.
+				lock.unlock();
+				std::this_thread::yield();
+			}
+			else
+			{
+				condition_.wait(lock, [&]() {
+					return !pendingTaskCount_ || queuedTaskCount_;
+				});
+			}
+		}
+
+		std::lock_guard<std::mutex> lock{mutex_};
+		if (error_)
+			std::rethrow_exception(error_);
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::Cancel()
+	{
+		isCanceled_ = true;
+	}
+
+	//-------------------------------------------------------------------------
+	bool TaskGroup::IsCanceled() const
+	{
+		return isCanceled_;
+	}
+
+	//-------------------------------------------------------------------------
+	ThreadPool& TaskGroup::GetThreadPool() const
+	{
+		return threadPool_;
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::OnTaskQueued()
+	{
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			++pendingTaskCount_;
+			++queuedTaskCount_;
+		}
+		condition_.notify_all();
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::OnTaskPopped()
+	{
+		std::lock_guard<std::mutex> lock{mutex_};
+		--queuedTaskCount_;
+	}
+
+	//-------------------------------------------------------------------------
+	void TaskGroup::OnTaskDone(std::exception_ptr error)
+	{
+		// Notified under the lock: Wait cannot return and destroy the group
+		// before notify_all.
+		std::lock_guard<std::mutex> lock{mutex_};
+
+		if (error && !error_)
+		{
+			error_ = error;
+			isCanceled_ = true;
+		}
+		if (!--pendingTaskCount_)
+			condition_.notify_all();
+	}
+}
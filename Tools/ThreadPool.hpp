@@ -0,0 +1,205 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ToolsExport.hpp"
+
+namespace Tools
+{
+	class TaskGroup;
+	class ThreadPlacement;
+
+	// Work-stealing pool: each worker runs the tasks of its queue, the last
+	// queued first, and steals the oldest task of another queue when its
+	// queue is empty.
+	// The thread waiting for a TaskGroup runs the queued tasks of this group
+	// only: the debug loop can wait for a group without running unrelated
+	// tasks, and the tasks never call the debugging functions which are
+	// bound to the debug loop thread.
+	class TOOLS_DLL ThreadPool
+	{
+	  public:
+		// 0 uses one thread by logical processor. The thread waiting for a
+		// TaskGroup also runs its tasks: threadCount - 1 workers are started.
+		// With a threadPlacement, each worker is placed by its index and 0
+		// uses one worker by processor of the workers.
+		explicit ThreadPool(
+			size_t threadCount = 0,
+			std::shared_ptr<const ThreadPlacement> threadPlacement = nullptr);
+		~ThreadPool();
+
+		// Pool of the subsystems. threadCount and threadPlacement are used by
+		// the first call of GetDefault only.
+		static void SetDefaultThreadCount(size_t threadCount);
+		static void SetDefaultThreadPlacement(std::shared_ptr<const ThreadPlacement>);
+		static ThreadPool& GetDefault();
+
+		// Threads which can run the tasks at the same time.
+		size_t GetThreadCount() const;
+
+		// In [0, GetThreadCount()): the index of the worker running the
+		// calling thread, 0 for the other threads.
+		size_t GetCurrentThreadIndex() const;
+
+	  private:
+		friend class TaskGroup;
+
+		struct QueuedTask
+		{
+			TaskGroup* group_ = nullptr;
+			std::function<void()> function_;
+		};
+
+		struct TaskQueue
+		{
+			std::mutex mutex_;
+			std::deque<QueuedTask> tasks_;
+		};
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		void Push(TaskGroup&, std::function<void()>);
+		// With a group, only its tasks are returned.
+		bool TryPop(size_t queueIndex, const TaskGroup* group, QueuedTask&);
+		void Execute(QueuedTask&);
+		void RunWorker(size_t queueIndex);
+
+		const std::shared_ptr<const ThreadPlacement> threadPlacement_;
+		std::vector<std::unique_ptr<TaskQueue>> queues_;
+		std::vector<std::thread> workers_;
+		std::atomic<size_t> nextQueue_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		size_t queuedTaskCount_;
+		bool isStopping_;
+	};
+
+	// Tasks waited together. The first exception thrown by a task cancels the
+	// group and is rethrown by Wait.
+	class TOOLS_DLL TaskGroup
+	{
+	  public:
+		explicit TaskGroup(ThreadPool& = ThreadPool::GetDefault());
+		// Cancel the tasks not started and wait for the others.
+		~TaskGroup();
+
+		void Run(std::function<void()>);
+
+		// Run the queued tasks of the group on the calling thread until all
+		// of them are done.
+		void Wait();
+
+		// The tasks not started are dropped. The running ones can stop early
+		// by checking IsCanceled.
+		void Cancel();
+		bool IsCanceled() const;
+
+		ThreadPool& GetThreadPool() const;
+
+	  private:
+		friend class ThreadPool;
+
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+
+		void OnTaskQueued();
+		void OnTaskPopped();
+		void OnTaskDone(std::exception_ptr);
+
+		ThreadPool& threadPool_;
+		std::atomic<bool> isCanceled_;
+		std::mutex mutex_;
+		std::condition_variable condition_;
+		size_t pendingTaskCount_;
+		size_t queuedTaskCount_;
+		std::exception_ptr error_;
+	};
+
+	// One T by thread of a ThreadPool: a task uses the one of its thread as
+	// scratch memory without synchronization. The threads which are not
+	// workers share the first one: only one of them can use it at a time.
+	template <typename T>
+	class ScratchArenas
+	{
+	  public:
+		//---------------------------------------------------------------------
+		explicit ScratchArenas(ThreadPool& threadPool = ThreadPool::GetDefault())
+		    : threadPool_{threadPool}, arenas_(threadPool.GetThreadCount())
+		{
+		}
+
+		//---------------------------------------------------------------------
+		T& Get()
+		{
+			return arenas_[threadPool_.GetCurrentThreadIndex()];
+		}
+
+		//---------------------------------------------------------------------
+		std::vector<T>& GetAll()
+		{
+			return arenas_;
+		}
+
+	  private:
+		ThreadPool& threadPool_;
+		std::vector<T> arenas_;
+	};
+
+	//-------------------------------------------------------------------------
+	// Call function(i) for i in [0, count) on the threads of threadPool. The
+	// items must be independent. Each task takes the next item: the items are
+	// run on the calling thread when there are fewer than 2 * minCountByTask.
+	template <typename Function>
+	void ParallelFor(size_t count,
+	                 size_t minCountByTask,
+	                 Function function,
+	                 ThreadPool& threadPool = ThreadPool::GetDefault())
+	{
+		auto taskCount = (std::min)(threadPool.GetThreadCount(),
+		                            count / (std::max)(minCountByTask, size_t{1}));
+
+		if (taskCount <= 1)
+		{
+			for (size_t i = 0; i < count; ++i)
+				function(i);
+			return;
+		}
+
+		TaskGroup taskGroup{threadPool};
+		std::atomic<size_t> nextIndex{0};
+		auto run = [&]() {
+			for (auto i = nextIndex++; i < count && !taskGroup.IsCanceled(); i = nextIndex++)
+				function(i);
+		};
+
+		for (size_t i = 0; i < taskCount; ++i)
+			taskGroup.Run(run);
+		taskGroup.Wait();
+	}
+}
@@ -18,11 +18,14 @@
 #include "Tool.hpp"
 
 #include <boost/optional/optional.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <cvt/wstring>
 #include <codecvt>
 #include <filesystem>
+#include <mutex>
 #include <system_error>
 
+#include "AsciiString.hpp"
 #include "Log.hpp"
 #include "ToolsException.hpp"
 
@@ -100,7 +103,23 @@ namespace Tools
 	//-------------------------------------------------------------------------
 	std::string ToUtf8String(const std::wstring& str)
 	{
-		return ToString(CP_UTF8, str);
+		// Most paths are ASCII: they do not need WideCharToMultiByte.
+		if (GetAsciiPrefixLength(str.data(), str.size()) != str.size())
+			return ToString(CP_UTF8, str);
+
+		std::string utf8(str.size(), '\0');
+		NarrowAscii(str.data(), str.size(), &utf8[0]);
+		return utf8;
+	}
+
+	//-------------------------------------------------------------------------
+	std::wstring ToLowerCopy(const std::wstring& str)
+	{
+		auto lowerStr = str;
+
+		if (!TryToLowerAscii(lowerStr))
+			return boost::algorithm::to_lower_copy(str);
+		return lowerStr;
 	}
 
 	//-------------------------------------------------------------------------
@@ -112,7 +131,12 @@ namespace Tools
 	//-------------------------------------------------------------------------
 	std::wstring Utf8ToWString(const std::string& str)
 	{
-		return ToWString(CP_UTF8, str);
+		if (GetAsciiPrefixLength(str.data(), str.size()) != str.size())
+			return ToWString(CP_UTF8, str);
+
+		std::wstring wstr(str.size(), L'\0');
+		WidenAscii(str.data(), str.size(), &wstr[0]);
+		return wstr;
 	}
 
 	//-------------------------------------------------------------------------
@@ -139,6 +163,10 @@ namespace Tools
 		const std::wstring& message, 
 		const std::filesystem::path& path)
 	{
+		// The exports run in parallel: keep the lines of a message together.
+		static std::mutex mutex;
+		std::lock_guard<std::mutex> lock{mutex};
+
 		LOG_INFO << GetSeparatorLine();
 		LOG_INFO << message << path.wstring();
 		LOG_INFO << GetSeparatorLine();
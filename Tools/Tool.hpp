@@ -30,6 +30,8 @@ namespace Tools
 	TOOLS_DLL std::wstring Utf8ToWString(const std::string&);
 	TOOLS_DLL std::string ToLocalString(const std::wstring&);
 	TOOLS_DLL std::string ToUtf8String(const std::wstring&);
+	// boost::algorithm::to_lower_copy without the locale for the ASCII strings.
+	TOOLS_DLL std::wstring ToLowerCopy(const std::wstring&);
 
 	TOOLS_DLL boost::optional<std::wstring> Try(std::function<void()>);	
 	
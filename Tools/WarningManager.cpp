@@ -23,12 +23,14 @@ namespace Tools
 	//-------------------------------------------------------------------------
 	void WarningManager::AddWarning(const std::wstring& warning)
 	{
+		std::lock_guard<std::mutex> lock{mutex_};
 		warnings_.push_back(warning);
 	}
 
 	//-------------------------------------------------------------------------
 	void WarningManager::DisplayWarnings() const
 	{
+		std::lock_guard<std::mutex> lock{mutex_};
 		for (const auto& warning : warnings_)
 			LOG_WARNING << warning;
 	}
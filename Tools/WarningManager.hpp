@@ -19,6 +19,7 @@
 #include "ToolsExport.hpp"
 #include <string>
 #include <vector>
+#include <mutex>
 
 namespace Tools
 {
@@ -27,10 +28,12 @@ namespace Tools
 	public:
 		WarningManager() = default;
 
+		// Can be called from several threads.
 		void AddWarning(const std::wstring&);
 		void DisplayWarnings() const;
 		
 	private:
 		std::vector<std::wstring> warnings_;
+		mutable std::mutex mutex_;
 	};
 }
\ No newline at end of file
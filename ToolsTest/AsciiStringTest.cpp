@@ -0,0 +1,78 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <boost/algorithm/string/case_conv.hpp>
+
+#include "Tools/AsciiString.hpp"
+#include "Tools/Tool.hpp"
+
+namespace ToolsTests
+{
+	namespace
+	{
+		const std::wstring longAscii = L"C:\\Dev\\OpenCppCoverage\\CppCoverage\\CodeCoverageRunner.cpp";
+	}
+
+	//---------------------------------------------------------------------
+	TEST(AsciiStringTest, GetAsciiPrefixLength)
+	{
+		ASSERT_EQ(0u, Tools::GetAsciiPrefixLength(L"", 0));
+		ASSERT_EQ(longAscii.size(), Tools::GetAsciiPrefixLength(longAscii.data(), longAscii.size()));
+
+		auto str = longAscii + L"\u00e9" + longAscii;
+		ASSERT_EQ(longAscii.size(), Tools::GetAsciiPrefixLength(str.data(), str.size()));
+
+		std::string narrowStr = "C:\\Dev\\OpenCppCoverage\\Code\xc3\xa9";
+		ASSERT_EQ(narrowStr.size() - 2, Tools::GetAsciiPrefixLength(narrowStr.data(), narrowStr.size()));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(AsciiStringTest, NarrowWidenAscii)
+	{
+		std::string narrowStr(longAscii.size(), '\0');
+		Tools::NarrowAscii(longAscii.data(), longAscii.size(), &narrowStr[0]);
+		ASSERT_EQ(std::string(longAscii.begin(), longAscii.end()), narrowStr);
+
+		std::wstring wideStr(narrowStr.size(), L'\0');
+		Tools::WidenAscii(narrowStr.data(), narrowStr.size(), &wideStr[0]);
+		ASSERT_EQ(longAscii, wideStr);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(AsciiStringTest, TryToLowerAscii)
+	{
+		std::wstring str = L"C:\\Dev\\OpenCppCoverage\\CppCoverage\\CODECOVERAGERUNNER.cpp [@Z]";
+		ASSERT_TRUE(Tools::TryToLowerAscii(str));
+		ASSERT_EQ(L"c:\\dev\\opencppcoverage\\cppcoverage\\codecoveragerunner.cpp [@z]", str);
+
+		std::wstring nonAsciiStr = L"C:\\Dev\\OpenCppCoverage\\CppCoverage\\\u00c9";
+		ASSERT_FALSE(Tools::TryToLowerAscii(nonAsciiStr));
+		ASSERT_EQ(boost::algorithm::to_lower_copy(nonAsciiStr), Tools::ToLowerCopy(nonAsciiStr));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(AsciiStringTest, Utf8)
+	{
+		ASSERT_EQ(longAscii, Tools::Utf8ToWString(Tools::ToUtf8String(longAscii)));
+
+		std::wstring nonAsciiStr = longAscii + L"\u00e9";
+		auto utf8Str = Tools::ToUtf8String(nonAsciiStr);
+		ASSERT_EQ(nonAsciiStr.size() + 1, utf8Str.size());
+		ASSERT_EQ(nonAsciiStr, Tools::Utf8ToWString(utf8Str));
+	}
+}
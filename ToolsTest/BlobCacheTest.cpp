@@ -0,0 +1,117 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/BlobCache.hpp"
+
+#include <fstream>
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ToolsTests
+{
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, WriteRead)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::BlobCache cache{ folder, 0 };
+
+		ASSERT_FALSE(cache.Read(L"blob"));
+		cache.Write(L"blob", "content");
+		ASSERT_TRUE(cache.Contains(L"blob"));
+		ASSERT_EQ(std::string{ "content" }, *cache.Read(L"blob"));
+		ASSERT_EQ(cache.GetPath(L"blob"), *cache.Find(L"blob"));
+
+		auto statistics = cache.GetStatistics();
+		ASSERT_EQ(2u, statistics.hitCount_);
+		ASSERT_EQ(1u, statistics.missCount_);
+		ASSERT_EQ(1u, statistics.writeCount_);
+		ASSERT_EQ(0u, statistics.evictionCount_);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, Publish)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::BlobCache cache{ folder, 0 };
+
+		auto temporaryPath = cache.GetTemporaryPath(L"blob");
+		ASSERT_NE(cache.GetPath(L"blob"), temporaryPath);
+		cache.Write(L"other", [](std::ostream& ostr) { ostr << "content"; });
+		fs::copy_file(cache.GetPath(L"other"), temporaryPath);
+		ASSERT_FALSE(cache.Contains(L"blob"));
+
+		cache.Publish(L"blob", temporaryPath);
+		ASSERT_EQ(std::string{ "content" }, *cache.Read(L"blob"));
+		ASSERT_FALSE(fs::exists(temporaryPath));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, PublishOpenBlob)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::BlobCache cache{ folder, 0 };
+
+		cache.Write(L"blob", "content");
+		std::ifstream openBlob{ cache.GetPath(L"blob") };
+		auto temporaryPath = cache.GetTemporaryPath(L"blob");
+		fs::copy_file(cache.GetPath(L"blob"), temporaryPath);
+
+		ASSERT_NO_THROW(cache.Publish(L"blob", temporaryPath));
+		ASSERT_FALSE(fs::exists(temporaryPath));
+		ASSERT_EQ(std::string{ "content" }, *cache.Read(L"blob"));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, WriteFailure)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::BlobCache cache{ folder, 0 };
+
+		ASSERT_THROW(cache.Write(L"blob", [](std::ostream&) { throw std::runtime_error("write"); }),
+		             std::runtime_error);
+		ASSERT_FALSE(cache.Contains(L"blob"));
+		ASSERT_FALSE(fs::exists(cache.GetTemporaryPath(L"blob")));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, EvictLeastRecentlyUsed)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::BlobCache cache{ folder, 25 };
+		const std::string content(10, 'a');
+
+		cache.Write(L"blob1", content);
+		cache.Write(L"blob2", content);
+		fs::last_write_time(cache.GetPath(L"blob2"), fs::last_write_time(cache.GetPath(L"blob2")) - std::chrono::hours{ 2 });
+		fs::last_write_time(cache.GetPath(L"blob1"), fs::last_write_time(cache.GetPath(L"blob1")) - std::chrono::hours{ 1 });
+		cache.Write(L"blob3", content);
+
+		ASSERT_TRUE(cache.Contains(L"blob1"));
+		ASSERT_FALSE(cache.Contains(L"blob2"));
+		ASSERT_TRUE(cache.Contains(L"blob3"));
+		ASSERT_EQ(1u, cache.GetStatistics().evictionCount_);
+	}
+
+	//---------------------------------------------------------------------
+	TEST(BlobCacheTest, GetKey)
+	{
+		ASSERT_EQ(Tools::BlobCache::GetKey("content"), Tools::BlobCache::GetKey("content"));
+		ASSERT_NE(Tools::BlobCache::GetKey("content"), Tools::BlobCache::GetKey("content2"));
+	}
+}
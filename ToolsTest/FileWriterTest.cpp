@@ -0,0 +1,69 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/FileWriter.hpp"
+#include "Tools/ToolsException.hpp"
+#include <fstream>
+#include <sstream>
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ToolsTests
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		std::string ReadFile(const fs::path& path)
+		{
+			std::ifstream ifs(path.string(), std::ios::binary);
+			std::ostringstream ostr;
+
+			ostr << ifs.rdbuf();
+			return ostr.str();
+		}
+	}
+
+	//---------------------------------------------------------------------
+	TEST(FileWriterTest, Write)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::FileWriter fileWriter{ 10 };
+		const int fileCount = 20;
+
+		for (int i = 0; i < fileCount; ++i)
+			fileWriter.Write(folder.GetPath() / std::to_string(i), "content" + std::to_string(i));
+		fileWriter.Flush();
+
+		for (int i = 0; i < fileCount; ++i)
+			ASSERT_EQ("content" + std::to_string(i), ReadFile(folder.GetPath() / std::to_string(i)));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(FileWriterTest, WriteError)
+	{
+		TestHelper::TemporaryPath folder{ TestHelper::TemporaryPathOption::CreateAsFolder };
+		Tools::FileWriter fileWriter;
+
+		fileWriter.Write(folder.GetPath() / "Missing" / "File", "content");
+		fileWriter.Write(folder.GetPath() / "File", "content");
+		ASSERT_THROW(fileWriter.Flush(), Tools::ToolsException);
+		ASSERT_EQ("content", ReadFile(folder.GetPath() / "File"));
+		ASSERT_NO_THROW(fileWriter.Flush());
+	}
+}
@@ -0,0 +1,95 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <sstream>
+#include <boost/make_shared.hpp>
+
+#include "Tools/Log.hpp"
+
+namespace logging = boost::log;
+
+namespace ToolsTests
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		class LogTest : public ::testing::Test
+		{
+		  public:
+			//-----------------------------------------------------------------
+			void SetUp() override
+			{
+				Tools::InitLoggerOstream(ostr_);
+			}
+
+			//-----------------------------------------------------------------
+			void TearDown() override
+			{
+				Tools::EnableLogger(true);
+				Tools::SetLoggerMinSeverity(logging::trivial::trace);
+			}
+
+			//-----------------------------------------------------------------
+			std::wstring BuildMessage(const std::wstring& message)
+			{
+				++buildMessageCount_;
+				return message;
+			}
+
+			boost::shared_ptr<std::ostringstream> ostr_ = boost::make_shared<std::ostringstream>();
+			int buildMessageCount_ = 0;
+		};
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(LogTest, IsLogSeverityEnabled)
+	{
+		Tools::SetLoggerMinSeverity(logging::trivial::info);
+		ASSERT_FALSE(Tools::IsLogSeverityEnabled(logging::trivial::debug));
+		ASSERT_TRUE(Tools::IsLogSeverityEnabled(logging::trivial::info));
+		ASSERT_TRUE(Tools::IsLogSeverityEnabled(logging::trivial::error));
+
+		Tools::EnableLogger(false);
+		ASSERT_FALSE(Tools::IsLogSeverityEnabled(logging::trivial::error));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(LogTest, MessageBuiltOnlyWhenEnabled)
+	{
+		Tools::SetLoggerMinSeverity(logging::trivial::info);
+		LOG_DEBUG << BuildMessage(L"Debug");
+		ASSERT_EQ(0, buildMessageCount_);
+
+		LOG_INFO << BuildMessage(L"Info");
+		ASSERT_EQ(1, buildMessageCount_);
+		ASSERT_NE(std::string::npos, ostr_->str().find("Info"));
+		ASSERT_EQ(std::string::npos, ostr_->str().find("Debug"));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST_F(LogTest, DanglingElse)
+	{
+		bool isElseExecuted = false;
+
+		if (buildMessageCount_ != 0)
+			LOG_INFO << BuildMessage(L"Info");
+		else
+			isElseExecuted = true;
+		ASSERT_TRUE(isElseExecuted);
+	}
+}
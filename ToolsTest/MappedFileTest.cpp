@@ -46,6 +46,13 @@ namespace ToolsTests
 				lines.push_back(line);
 			return lines;
 		}
+
+		//---------------------------------------------------------------------
+		std::vector<std::string> GetLines(const Tools::MappedFile& file)
+		{
+			const auto& lines = file.GetLines();
+			return std::vector<std::string>(lines.begin(), lines.end());
+		}
 	}
 
 	//---------------------------------------------------------------------
@@ -54,7 +61,7 @@ namespace ToolsTests
 		auto path = CreateFile({ "\r\n", "abc\r\n", "123\n" });
 		auto file = Tools::MappedFile::TryCreate(path->GetPath());
 		auto expectedLines = GetLines(*path);
-		ASSERT_EQ(expectedLines, file->GetLines());
+		ASSERT_EQ(expectedLines, GetLines(*file));
 	}
 
 	//---------------------------------------------------------------------
@@ -77,7 +84,7 @@ namespace ToolsTests
 		auto file = Tools::MappedFile::TryCreate(__FILE__);
 
 		ASSERT_LT(0, static_cast<int>(lines.size()));
-		ASSERT_EQ(lines, file->GetLines());
+		ASSERT_EQ(lines, GetLines(*file));
 	}
 
 	//---------------------------------------------------------------------
@@ -88,6 +95,17 @@ namespace ToolsTests
 		auto file = Tools::MappedFile::TryCreate(*path);
 
 		ASSERT_TRUE(file);
-		ASSERT_EQ(expectedLines, file->GetLines());
+		ASSERT_EQ(expectedLines, GetLines(*file));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(MappedFileTest, Binary)
+	{
+		auto path = CreateFile({ "abc\n", std::string{ "\0\1", 2 } });
+		auto file = Tools::MappedFile::TryCreateBinary(*path);
+
+		ASSERT_TRUE(file);
+		ASSERT_TRUE(file->GetLines().empty());
+		ASSERT_EQ(std::string("abc\n\0\1", 6), file->GetContent());
 	}
 }
\ No newline at end of file
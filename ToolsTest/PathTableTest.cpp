@@ -0,0 +1,58 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/PathTable.hpp"
+
+namespace ToolsTests
+{
+	//---------------------------------------------------------------------
+	TEST(PathTableTest, Intern)
+	{
+		Tools::PathTable pathTable;
+
+		ASSERT_EQ(0, pathTable.Intern(L"b"));
+		ASSERT_EQ(1, pathTable.Intern(L"a"));
+		ASSERT_EQ(0, pathTable.Intern(L"b"));
+		ASSERT_EQ(2, pathTable.GetCount());
+		ASSERT_EQ(std::filesystem::path{ L"a" }, pathTable.GetPath(1));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PathTableTest, InternNormalizedPath)
+	{
+		Tools::PathTable pathTable;
+
+		ASSERT_EQ(0, pathTable.Intern(L"a/b"));
+		ASSERT_EQ(0, pathTable.Intern(L"a\\b"));
+		ASSERT_EQ(0, pathTable.Intern(L"a\\.\\c\\..\\b"));
+		ASSERT_EQ(0, pathTable.GetId(L"a\\b"));
+		ASSERT_EQ(1, pathTable.GetCount());
+		ASSERT_EQ(std::filesystem::path{ L"a/b" }, pathTable.GetPath(0));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PathTableTest, GetSortedIds)
+	{
+		Tools::PathTable pathTable;
+
+		pathTable.Intern(L"c");
+		pathTable.Intern(L"a");
+		pathTable.Intern(L"b");
+
+		ASSERT_EQ((std::vector<size_t>{ 1, 2, 0 }), pathTable.GetSortedIds());
+	}
+}
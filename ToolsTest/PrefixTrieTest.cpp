@@ -0,0 +1,90 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/PrefixTrie.hpp"
+
+#include <boost/optional/optional_io.hpp>
+
+namespace ToolsTests
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		boost::optional<size_t> Find(const Tools::PrefixTrie& trie, const std::wstring& str)
+		{
+			return trie.FindSmallestPrefixValue(str.begin(), str.end());
+		}
+
+		//---------------------------------------------------------------------
+		void Add(Tools::PrefixTrie& trie, const std::wstring& key, size_t value)
+		{
+			trie.Add(key.begin(), key.end(), value);
+		}
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PrefixTrieTest, Find)
+	{
+		Tools::PrefixTrie trie;
+
+		Add(trie, L"abc", 0);
+		Add(trie, L"de", 1);
+
+		ASSERT_EQ(0u, Find(trie, L"abcd"));
+		ASSERT_EQ(0u, Find(trie, L"abc"));
+		ASSERT_EQ(1u, Find(trie, L"de"));
+		ASSERT_FALSE(Find(trie, L"ab"));
+		ASSERT_FALSE(Find(trie, L"xabc"));
+		ASSERT_FALSE(Find(trie, L""));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PrefixTrieTest, SmallestValue)
+	{
+		Tools::PrefixTrie trie;
+
+		Add(trie, L"abc", 0);
+		Add(trie, L"a", 1);
+		Add(trie, L"abc", 2);
+
+		ASSERT_EQ(0u, Find(trie, L"abcd"));
+		ASSERT_EQ(1u, Find(trie, L"ab"));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PrefixTrieTest, EmptyKey)
+	{
+		Tools::PrefixTrie trie;
+
+		Add(trie, L"", 3);
+		ASSERT_EQ(3u, Find(trie, L"abc"));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(PrefixTrieTest, KeyEnd)
+	{
+		Tools::PrefixTrie trie;
+		const std::wstring str = L"ab-c";
+
+		Add(trie, L"a", 0);
+		Add(trie, L"ab", 1);
+		auto isKeyEnd = [&](std::wstring::const_iterator keyEnd) {
+			return keyEnd == str.end() || *keyEnd == L'-';
+		};
+		ASSERT_EQ(1u, trie.FindSmallestPrefixValue(str.begin(), str.end(), isKeyEnd));
+	}
+}
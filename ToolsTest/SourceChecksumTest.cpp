@@ -0,0 +1,38 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/SourceChecksum.hpp"
+
+namespace ToolsTests
+{
+	//-------------------------------------------------------------------------
+	TEST(SourceChecksumTest, Compute)
+	{
+		auto checksum = Tools::ComputeSourceChecksum(Tools::SourceChecksum::Type::Md5, "abc");
+
+		ASSERT_TRUE(checksum);
+		ASSERT_EQ(Tools::SourceChecksum::Type::Md5, checksum->type_);
+		ASSERT_EQ("\x90\x01\x50\x98\x3c\xd2\x4f\xb0\xd6\x96\x3f\x7d\x28\xe1\x7f\x72", checksum->bytes_);
+		ASSERT_EQ(32, Tools::ComputeSourceChecksum(Tools::SourceChecksum::Type::Sha256, "abc")->bytes_.size());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(SourceChecksumTest, NoChecksum)
+	{
+		ASSERT_FALSE(Tools::ComputeSourceChecksum(Tools::SourceChecksum::Type::None, "abc"));
+	}
+}
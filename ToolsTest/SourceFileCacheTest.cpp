@@ -0,0 +1,160 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+#include "Tools/SourceFileCache.hpp"
+#include "Tools/MappedFile.hpp"
+#include <fstream>
+
+#include "TestHelper/TemporaryPath.hpp"
+
+namespace fs = std::filesystem;
+
+namespace ToolsTests
+{
+	namespace
+	{
+		//---------------------------------------------------------------------
+		void WriteFile(const fs::path& path, const std::string& content)
+		{
+			std::ofstream ofs(path.string(), std::ios::binary);
+			ofs.write(content.c_str(), content.size());
+		}
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, SameFile)
+	{
+		TestHelper::TemporaryPath path;
+		WriteFile(path, "line1\nline2\n");
+
+		Tools::SourceFileCache cache;
+		auto file = cache.TryGet(path);
+		ASSERT_NE(nullptr, file);
+		ASSERT_EQ(2, file->GetLines().size());
+		ASSERT_EQ(file, cache.TryGet(path));
+		ASSERT_EQ(1, cache.GetMappedFileCount());
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, ModifiedFile)
+	{
+		TestHelper::TemporaryPath path;
+		WriteFile(path, "line1\n");
+
+		Tools::SourceFileCache cache;
+		auto file = cache.TryGet(path);
+		ASSERT_NE(nullptr, file);
+
+		fs::last_write_time(path, fs::last_write_time(path) + std::chrono::hours{ 1 });
+		auto modifiedFile = cache.TryGet(path);
+		ASSERT_NE(nullptr, modifiedFile);
+		ASSERT_NE(file, modifiedFile);
+		ASSERT_EQ(modifiedFile, cache.TryGet(path));
+		ASSERT_EQ(2, cache.GetMappedFileCount());
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, MissingOrEmptyFile)
+	{
+		TestHelper::TemporaryPath emptyFile{ TestHelper::TemporaryPathOption::CreateAsFile };
+		Tools::SourceFileCache cache;
+
+		ASSERT_EQ(nullptr, cache.TryGet("MissingFile"));
+		ASSERT_EQ(nullptr, cache.TryGet(emptyFile));
+		ASSERT_EQ(0, cache.GetMappedFileCount());
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, MaxMappedSize)
+	{
+		TestHelper::TemporaryPath path1;
+		TestHelper::TemporaryPath path2;
+		WriteFile(path1, "line1\n");
+		WriteFile(path2, "line2\n");
+
+		Tools::SourceFileCache cache{ 8 };
+		auto file1 = cache.TryGet(path1);
+		cache.TryGet(path2);
+
+		// path1 is released by the cache but still mapped by file1.
+		ASSERT_NE(nullptr, file1);
+		ASSERT_EQ("line1", file1->GetLines().at(0));
+		ASSERT_NE(file1, cache.TryGet(path1));
+		ASSERT_EQ(3, cache.GetMappedFileCount());
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, LeastRecentlyUsed)
+	{
+		TestHelper::TemporaryPath path1;
+		TestHelper::TemporaryPath path2;
+		TestHelper::TemporaryPath path3;
+		WriteFile(path1, "line1\n");
+		WriteFile(path2, "line2\n");
+		WriteFile(path3, "line3\n");
+
+		Tools::SourceFileCache cache{ 12 };
+		auto file1 = cache.TryGet(path1);
+		cache.TryGet(path2);
+		ASSERT_EQ(file1, cache.TryGet(path1));
+
+		// path2 is the least recently used.
+		cache.TryGet(path3);
+		ASSERT_EQ(file1, cache.TryGet(path1));
+		ASSERT_EQ(3, cache.GetMappedFileCount());
+		cache.TryGet(path2);
+		ASSERT_EQ(4, cache.GetMappedFileCount());
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, LocalCopy)
+	{
+		TestHelper::TemporaryPath localPath;
+		WriteFile(localPath, "line1\n");
+
+		Tools::SourceFileCache cache;
+		ASSERT_FALSE(cache.Exists("MissingFile"));
+
+		cache.SetLocalCopy("MissingFile", localPath);
+		ASSERT_TRUE(cache.Exists("MissingFile"));
+		ASSERT_EQ(localPath.GetPath(), cache.GetLocalPath("MissingFile"));
+		auto file = cache.TryGet("MissingFile");
+		ASSERT_NE(nullptr, file);
+		ASSERT_EQ("line1", file->GetLines().at(0));
+	}
+
+	//---------------------------------------------------------------------
+	TEST(SourceFileCacheTest, Checksum)
+	{
+		TestHelper::TemporaryPath path1;
+		TestHelper::TemporaryPath path2;
+		WriteFile(path1, "line1\n");
+		WriteFile(path2, "line2\n");
+
+		Tools::SourceFileCache cache;
+		auto checksum = Tools::ComputeSourceChecksum(Tools::SourceChecksum::Type::Sha256, "line1\n");
+		ASSERT_TRUE(checksum);
+		cache.SetChecksum(path1, *checksum);
+		cache.SetChecksum(path2, *checksum);
+		ASSERT_EQ(*checksum, cache.GetChecksum(path1));
+		ASSERT_FALSE(cache.GetChecksum("MissingFile"));
+
+		ASSERT_NE(nullptr, cache.TryGet(path1));
+		ASSERT_NE(nullptr, cache.TryGet(path2));
+		ASSERT_EQ(1, cache.GetChecksumMismatchCount());
+	}
+}
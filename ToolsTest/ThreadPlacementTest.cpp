@@ -0,0 +1,90 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2019 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include "Tools/ThreadPlacement.hpp"
+#include "Tools/ThreadPool.hpp"
+
+namespace ToolsTests
+{
+	namespace
+	{
+		using Affinity = Tools::ProcessorGroupAffinity;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, SingleCore)
+	{
+		Tools::ThreadPlacement threadPlacement{{{0, 0x3}}};
+
+		ASSERT_EQ((Affinity{0, 0x1}), threadPlacement.GetDebugLoopAffinity());
+		ASSERT_EQ((Affinity{0, 0x3}), threadPlacement.GetWorkerAffinity(0));
+		ASSERT_EQ(2u, threadPlacement.GetWorkerProcessorCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, SeveralCores)
+	{
+		Tools::ThreadPlacement threadPlacement{{{0, 0x3}, {0, 0xC}, {0, 0x30}}};
+
+		ASSERT_EQ((Affinity{0, 0x10}), threadPlacement.GetDebugLoopAffinity());
+		ASSERT_EQ(4u, threadPlacement.GetWorkerProcessorCount());
+		for (size_t i = 0; i < 8; ++i)
+			ASSERT_EQ((Affinity{0, 0xF}), threadPlacement.GetWorkerAffinity(i));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, SeveralGroups)
+	{
+		Tools::ThreadPlacement threadPlacement{{{0, 0x1}, {0, 0x2}, {1, 0x1}, {1, 0x2}}};
+
+		ASSERT_EQ((Affinity{1, 0x2}), threadPlacement.GetDebugLoopAffinity());
+		ASSERT_EQ(3u, threadPlacement.GetWorkerProcessorCount());
+		ASSERT_EQ((Affinity{0, 0x3}), threadPlacement.GetWorkerAffinity(0));
+		ASSERT_EQ((Affinity{0, 0x3}), threadPlacement.GetWorkerAffinity(1));
+		ASSERT_EQ((Affinity{1, 0x1}), threadPlacement.GetWorkerAffinity(2));
+		ASSERT_EQ((Affinity{0, 0x3}), threadPlacement.GetWorkerAffinity(3));
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, NoCore)
+	{
+		ASSERT_ANY_THROW(Tools::ThreadPlacement{{}});
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, CreateFromSystem)
+	{
+		auto threadPlacement = Tools::ThreadPlacement::CreateFromSystem();
+
+		ASSERT_NE(0u, threadPlacement->GetDebugLoopAffinity().mask_);
+		ASSERT_LT(0u, threadPlacement->GetWorkerProcessorCount());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPlacementTest, ThreadPool)
+	{
+		std::shared_ptr<const Tools::ThreadPlacement> threadPlacement =
+			std::make_shared<Tools::ThreadPlacement>(std::vector<Affinity>{{0, 0x1}, {0, 0x2}, {0, 0x4}});
+		Tools::ThreadPool threadPool{0, threadPlacement};
+		std::atomic<int> count{0};
+
+		ASSERT_EQ(3u, threadPool.GetThreadCount());
+		Tools::ParallelFor(100, 1, [&](size_t) { ++count; }, threadPool);
+		ASSERT_EQ(100, count);
+	}
+}
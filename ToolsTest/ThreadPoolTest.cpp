@@ -0,0 +1,110 @@
+// OpenCppCoverage is an open source code coverage for C++.
+// Copyright (C) 2017 OpenCppCoverage
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+#include "stdafx.h"
+
+#include <numeric>
+#include <stdexcept>
+
+#include "Tools/ThreadPool.hpp"
+
+namespace ToolsTests
+{
+	namespace
+	{
+		const size_t ThreadCount = 4;
+		const size_t ItemCount = 10000;
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, ParallelFor)
+	{
+		Tools::ThreadPool threadPool{ThreadCount};
+		std::vector<int> values(ItemCount);
+
+		Tools::ParallelFor(values.size(), 1, [&](size_t i) { values[i] = static_cast<int>(i); }, threadPool);
+		for (size_t i = 0; i < values.size(); ++i)
+			ASSERT_EQ(static_cast<int>(i), values[i]);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, SingleThread)
+	{
+		Tools::ThreadPool threadPool{1};
+		std::atomic<int> count{0};
+
+		ASSERT_EQ(1u, threadPool.GetThreadCount());
+		Tools::ParallelFor(ItemCount, 1, [&](size_t) { ++count; }, threadPool);
+		ASSERT_EQ(static_cast<int>(ItemCount), count);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, Exception)
+	{
+		Tools::ThreadPool threadPool{ThreadCount};
+		Tools::TaskGroup taskGroup{threadPool};
+
+		taskGroup.Run([]() { throw std::runtime_error("Error"); });
+		ASSERT_THROW(taskGroup.Wait(), std::runtime_error);
+		ASSERT_TRUE(taskGroup.IsCanceled());
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, Cancel)
+	{
+		Tools::ThreadPool threadPool{1};
+		Tools::TaskGroup taskGroup{threadPool};
+		bool isRun = false;
+
+		taskGroup.Run([&]() { isRun = true; });
+		taskGroup.Cancel();
+		taskGroup.Wait();
+		ASSERT_FALSE(isRun);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, NestedTaskGroups)
+	{
+		Tools::ThreadPool threadPool{ThreadCount};
+		std::atomic<int> count{0};
+
+		// Each outer task waits for its own group: the waiting threads must
+		// run the inner tasks.
+		Tools::ParallelFor(ThreadCount * 4, 1, [&](size_t) {
+			Tools::TaskGroup taskGroup{threadPool};
+
+			for (int i = 0; i < 10; ++i)
+				taskGroup.Run([&]() { ++count; });
+			taskGroup.Wait();
+		}, threadPool);
+		ASSERT_EQ(static_cast<int>(ThreadCount * 4 * 10), count);
+	}
+
+	//-------------------------------------------------------------------------
+	TEST(ThreadPoolTest, ScratchArenas)
+	{
+		Tools::ThreadPool threadPool{ThreadCount};
+		Tools::ScratchArenas<std::vector<size_t>> arenas{threadPool};
+
+		Tools::ParallelFor(ItemCount, 1, [&](size_t i) { arenas.Get().push_back(i); }, threadPool);
+
+		size_t itemCount = 0;
+		for (const auto& arena : arenas.GetAll())
+			itemCount += arena.size();
+		ASSERT_EQ(ItemCount, itemCount);
+		ASSERT_EQ(ThreadCount, arenas.GetAll().size());
+	}
+}